@@ -42,6 +42,23 @@ struct MultiplyVoidOutputFunction {
   }
 };
 
+template <typename T>
+struct MultiplyBatchFunction {
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  call(TInput& result, const TInput& a, const TInput& b) {
+    result = functions::multiply(a, b);
+  }
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(int32_t size, TInput* result, const TInput* a, const TInput* b) {
+    for (auto i = 0; i < size; ++i) {
+      result[i] = functions::multiply(a[i], b[i]);
+    }
+  }
+};
+
 template <typename T>
 struct MultiplyNullableOutputFunction {
   template <typename TInput>
@@ -87,6 +104,8 @@ class SimpleArithmeticBenchmark
   explicit SimpleArithmeticBenchmark() : FunctionBenchmarkBase() {
     registerFunction<MultiplyVoidOutputFunction, double, double, double>(
         {"multiply"});
+    registerFunction<MultiplyBatchFunction, double, double, double>(
+        {"multiply_batch"});
     registerFunction<MultiplyNullableOutputFunction, double, double, double>(
         {"multiply_nullable_output"});
     registerFunction<MultiplyNullOutputFunction, double, double, double>(
@@ -204,6 +223,14 @@ BENCHMARK(multiplyOutputVoidSmall) {
   benchmark->runSmall("multiply(a, b)");
 }
 
+BENCHMARK(multiplyBatchSmall) {
+  benchmark->runSmall("multiply_batch(a, b)");
+}
+
+BENCHMARK(multiplyBatchConstantSmall) {
+  benchmark->runSmall("multiply_batch(a, constant)");
+}
+
 BENCHMARK(multiplyOutputNullableSmall) {
   benchmark->runSmall("multiply_nullable_output(a, b)");
 }
@@ -257,6 +284,14 @@ BENCHMARK(multiplyOutputVoidMedium) {
   benchmark->runMedium("multiply(a, b)");
 }
 
+BENCHMARK(multiplyBatchMedium) {
+  benchmark->runMedium("multiply_batch(a, b)");
+}
+
+BENCHMARK(multiplyBatchConstantMedium) {
+  benchmark->runMedium("multiply_batch(a, constant)");
+}
+
 BENCHMARK(multiplyOutputNullableMedium) {
   benchmark->runMedium("multiply_nullable_output(a, b)");
 }
@@ -310,6 +345,14 @@ BENCHMARK(multiplyOutputVoidLarge) {
   benchmark->runLarge("multiply(a, b)");
 }
 
+BENCHMARK(multiplyBatchLarge) {
+  benchmark->runLarge("multiply_batch(a, b)");
+}
+
+BENCHMARK(multiplyBatchConstantLarge) {
+  benchmark->runLarge("multiply_batch(a, constant)");
+}
+
 BENCHMARK(multiplyOutputNullableLarge) {
   benchmark->runLarge("multiply_nullable_output(a, b)");
 }
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <fstream>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/memory/MmapAllocator.h"
+#include "velox/connectors/hive/HiveConnector.h"
+#include "velox/dwio/common/Options.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/parquet/RegisterParquetReader.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/Split.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/SqlQueryBuilder.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
+#include "velox/parse/TypeResolver.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::dwio::common;
+
+/// Runs a SQL query over local Parquet or DWRF files and prints the execution
+/// time and the plan with its statistics. The data is laid out as for the
+/// TPC-H benchmark: a sub-directory of --data_path per table. See
+/// SqlQueryBuilder for the supported SQL. Example:
+///
+///   velox_sql_query_runner --data_path=/data/tpch --query="SELECT
+///     l_returnflag, sum(l_quantity) FROM lineitem GROUP BY 1"
+
+namespace {
+static bool notEmpty(const char* /*flagName*/, const std::string& value) {
+  return !value.empty();
+}
+
+static bool validateDataFormat(const char* flagname, const std::string& value) {
+  if ((value.compare("parquet") == 0) || (value.compare("dwrf") == 0)) {
+    return true;
+  }
+  std::cout
+      << fmt::format(
+             "Invalid value for --{}: {}. Allowed values are [\"parquet\", \"dwrf\"]",
+             flagname,
+             value)
+      << std::endl;
+  return false;
+}
+
+void printResults(const std::vector<RowVectorPtr>& results) {
+  std::cout << "Results:" << std::endl;
+  bool printType = true;
+  for (const auto& vector : results) {
+    // Print RowType only once.
+    if (printType) {
+      std::cout << vector->type()->asRow().toString() << std::endl;
+      printType = false;
+    }
+    for (vector_size_t i = 0; i < vector->size(); ++i) {
+      std::cout << vector->toString(i) << std::endl;
+    }
+  }
+}
+} // namespace
+
+DEFINE_string(data_path, "", "Root path of the data, a directory per table");
+DEFINE_string(query, "", "The SQL query to run");
+DEFINE_string(query_file, "", "A file with the SQL query to run");
+DEFINE_bool(
+    include_custom_stats,
+    false,
+    "Include custom statistics along with execution statistics");
+DEFINE_bool(include_results, false, "Include results in the output");
+DEFINE_int32(num_drivers, 4, "Number of drivers");
+DEFINE_string(data_format, "parquet", "Data format");
+DEFINE_int32(num_splits_per_file, 10, "Number of splits per file");
+DEFINE_int32(
+    cache_gb,
+    0,
+    "GB of process memory for cache and query.. if "
+    "non-0, uses mmap to allocator and in-process data cache.");
+DEFINE_int32(num_repeats, 1, "Number of times to run the query");
+
+DEFINE_validator(data_path, &notEmpty);
+DEFINE_validator(data_format, &validateDataFormat);
+
+class SqlQueryRunner {
+ public:
+  void initialize() {
+    if (FLAGS_cache_gb) {
+      int64_t memoryBytes = FLAGS_cache_gb * (1LL << 30);
+      memory::MmapAllocatorOptions options;
+      options.capacity = memoryBytes;
+      options.useMmapArena = true;
+      options.mmapArenaCapacityRatio = 1;
+
+      auto allocator = std::make_shared<memory::MmapAllocator>(options);
+      allocator_ = std::make_shared<cache::AsyncDataCache>(
+          allocator, memoryBytes, nullptr);
+      memory::MappedMemory::setDefaultInstance(allocator_.get());
+    }
+    functions::prestosql::registerAllScalarFunctions();
+    aggregate::prestosql::registerAllAggregateFunctions();
+    window::prestosql::registerAllWindowFunctions();
+    parse::registerTypeResolver();
+    filesystems::registerLocalFileSystem();
+    parquet::registerParquetReaderFactory(parquet::ParquetReaderType::NATIVE);
+    dwrf::registerDwrfReaderFactory();
+    ioExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(8);
+
+    auto hiveConnector =
+        connector::getConnectorFactory(
+            connector::hive::HiveConnectorFactory::kHiveConnectorName)
+            ->newConnector(kHiveConnectorId, nullptr, ioExecutor_.get());
+    connector::registerConnector(hiveConnector);
+  }
+
+  std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> run(
+      const SqlPlan& sqlPlan) {
+    CursorParameters params;
+    params.maxDrivers = FLAGS_num_drivers;
+    params.planNode = sqlPlan.plan;
+    const int numSplitsPerFile = FLAGS_num_splits_per_file;
+
+    bool noMoreSplits = false;
+    auto addSplits = [&](exec::Task* task) {
+      if (!noMoreSplits) {
+        for (const auto& entry : sqlPlan.dataFiles) {
+          for (const auto& path : entry.second) {
+            auto const splits = HiveConnectorTestBase::makeHiveConnectorSplits(
+                path, numSplitsPerFile, sqlPlan.dataFileFormat);
+            for (const auto& split : splits) {
+              task->addSplit(entry.first, exec::Split(split));
+            }
+          }
+          task->noMoreSplits(entry.first);
+        }
+      }
+      noMoreSplits = true;
+    };
+    return readCursor(params, addSplits);
+  }
+
+  std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
+  std::shared_ptr<cache::AsyncDataCache> allocator_;
+};
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, false);
+  std::string sql = FLAGS_query;
+  if (!FLAGS_query_file.empty()) {
+    std::ifstream in(FLAGS_query_file);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    sql = buffer.str();
+    if (!in) {
+      LOG(ERROR) << "Failed to read " << FLAGS_query_file;
+      exit(1);
+    }
+  }
+  if (sql.empty()) {
+    LOG(ERROR) << "Specify the query with --query or --query_file";
+    exit(1);
+  }
+
+  SqlQueryRunner runner;
+  runner.initialize();
+  SqlQueryBuilder queryBuilder(toFileFormat(FLAGS_data_format));
+  queryBuilder.initialize(FLAGS_data_path);
+
+  SqlPlan queryPlan;
+  try {
+    queryPlan = queryBuilder.getQueryPlan(sql);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to plan the query: " << e.what();
+    exit(1);
+  }
+  std::cout << queryPlan.plan->toString(true, true) << std::endl;
+
+  for (auto repeat = 0; repeat < FLAGS_num_repeats; ++repeat) {
+    std::unique_ptr<TaskCursor> cursor;
+    std::vector<RowVectorPtr> results;
+    try {
+      std::tie(cursor, results) = runner.run(queryPlan);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Query terminated with: " << e.what();
+      exit(1);
+    }
+    auto task = cursor->task();
+    VELOX_CHECK(waitForTaskCompletion(task.get()));
+    if (FLAGS_include_results && repeat == 0) {
+      printResults(results);
+      std::cout << std::endl;
+    }
+    const auto stats = task->taskStats();
+    std::cout << fmt::format(
+                     "Run {}, execution time: {}",
+                     repeat,
+                     succinctMillis(
+                         stats.executionEndTimeMs - stats.executionStartTimeMs))
+              << std::endl;
+    if (repeat + 1 == FLAGS_num_repeats) {
+      std::cout << printPlanWithStats(
+                       *queryPlan.plan, stats, FLAGS_include_custom_stats)
+                << std::endl;
+    }
+  }
+  return 0;
+}
@@ -15,8 +15,11 @@
  */
 
 #include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/json.h>
 #include <folly/init/Init.h>
 #include <gflags/gflags.h>
+#include <fstream>
 
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/file/FileSystems.h"
@@ -97,6 +100,22 @@ DEFINE_int32(
     "GB of process memory for cache and query.. if "
     "non-0, uses mmap to allocator and in-process data cache.");
 DEFINE_int32(num_repeats, 1, "Number of times to run each query");
+DEFINE_string(
+    num_drivers_list,
+    "",
+    "Comma separated numbers of drivers, e.g. 1,4,16. If set, "
+    "--run_query_verbose runs the query once for each and --num_drivers is "
+    "ignored");
+DEFINE_string(
+    stats_json_path,
+    "",
+    "If set, --run_query_verbose writes the per operator stats of each run "
+    "to this file as JSON");
+DEFINE_bool(
+    cold_cache,
+    false,
+    "Clear the data cache before each run, so that all data is read from "
+    "the files. Applies with --cache_gb");
 
 DEFINE_validator(data_path, &notEmpty);
 DEFINE_validator(data_format, &validateDataFormat);
@@ -136,12 +155,16 @@ class TpchBenchmark {
   }
 
   std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> run(
-      const TpchPlan& tpchPlan) {
+      const TpchPlan& tpchPlan,
+      int32_t numDrivers = FLAGS_num_drivers) {
     int32_t repeat = 0;
     try {
       for (;;) {
+        if (FLAGS_cold_cache && allocator_) {
+          allocator_->clear();
+        }
         CursorParameters params;
-        params.maxDrivers = FLAGS_num_drivers;
+        params.maxDrivers = numDrivers;
         params.planNode = tpchPlan.plan;
         const int numSplitsPerFile = FLAGS_num_splits_per_file;
 
@@ -175,7 +198,7 @@ class TpchBenchmark {
   }
 
   std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
-  std::shared_ptr<memory::MappedMemory> allocator_;
+  std::shared_ptr<cache::AsyncDataCache> allocator_;
 };
 
 TpchBenchmark benchmark;
@@ -186,11 +209,21 @@ BENCHMARK(q1) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q2) {
+  const auto planContext = queryBuilder->getQueryPlan(2);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q3) {
   const auto planContext = queryBuilder->getQueryPlan(3);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q4) {
+  const auto planContext = queryBuilder->getQueryPlan(4);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q5) {
   const auto planContext = queryBuilder->getQueryPlan(5);
   benchmark.run(planContext);
@@ -221,6 +254,11 @@ BENCHMARK(q10) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q11) {
+  const auto planContext = queryBuilder->getQueryPlan(11);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q12) {
   const auto planContext = queryBuilder->getQueryPlan(12);
   benchmark.run(planContext);
@@ -261,6 +299,11 @@ BENCHMARK(q19) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q20) {
+  const auto planContext = queryBuilder->getQueryPlan(20);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q21) {
   const auto planContext = queryBuilder->getQueryPlan(21);
   benchmark.run(planContext);
@@ -279,9 +322,18 @@ int main(int argc, char** argv) {
   queryBuilder->initialize(FLAGS_data_path);
   if (FLAGS_run_query_verbose == -1) {
     folly::runBenchmarks();
+    return 0;
+  }
+  std::vector<int32_t> driverCounts;
+  if (FLAGS_num_drivers_list.empty()) {
+    driverCounts.push_back(FLAGS_num_drivers);
   } else {
-    const auto queryPlan = queryBuilder->getQueryPlan(FLAGS_run_query_verbose);
-    const auto [cursor, actualResults] = benchmark.run(queryPlan);
+    folly::split(',', FLAGS_num_drivers_list, driverCounts);
+  }
+  const auto queryPlan = queryBuilder->getQueryPlan(FLAGS_run_query_verbose);
+  folly::dynamic runs = folly::dynamic::array;
+  for (auto numDrivers : driverCounts) {
+    const auto [cursor, actualResults] = benchmark.run(queryPlan, numDrivers);
     if (!cursor) {
       LOG(ERROR) << "Query terminated with error. Exiting";
       exit(1);
@@ -293,10 +345,12 @@ int main(int argc, char** argv) {
       std::cout << std::endl;
     }
     const auto stats = task->taskStats();
+    const auto executionTimeMs =
+        stats.executionEndTimeMs - stats.executionStartTimeMs;
     std::cout << fmt::format(
-                     "Execution time: {}",
-                     succinctMillis(
-                         stats.executionEndTimeMs - stats.executionStartTimeMs))
+                     "Drivers: {}, execution time: {}",
+                     numDrivers,
+                     succinctMillis(executionTimeMs))
               << std::endl;
     std::cout << fmt::format(
                      "Splits total: {}, finished: {}",
@@ -306,5 +360,23 @@ int main(int argc, char** argv) {
     std::cout << printPlanWithStats(
                      *queryPlan.plan, stats, FLAGS_include_custom_stats)
               << std::endl;
+
+    folly::dynamic run = folly::dynamic::object;
+    run["query"] = FLAGS_run_query_verbose;
+    run["dataFormat"] = FLAGS_data_format;
+    run["numDrivers"] = numDrivers;
+    run["coldCache"] = FLAGS_cold_cache;
+    run["executionTimeMs"] = executionTimeMs;
+    run["operators"] = toPlanStatsJson(stats);
+    runs.push_back(std::move(run));
+  }
+  if (!FLAGS_stats_json_path.empty()) {
+    std::ofstream out(FLAGS_stats_json_path);
+    out << folly::toPrettyJson(runs) << std::endl;
+    if (!out) {
+      LOG(ERROR) << "Failed to write " << FLAGS_stats_json_path;
+      exit(1);
+    }
   }
+  return 0;
 }
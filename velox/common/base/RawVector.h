@@ -64,6 +64,9 @@ class raw_vector {
   }
 
   void operator=(raw_vector<T>&& other) noexcept {
+    if (data_) {
+      freeData(data_);
+    }
     data_ = other.data_;
     size_ = other.size_;
     capacity_ = other.capacity_;
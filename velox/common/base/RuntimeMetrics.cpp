@@ -15,18 +15,30 @@
  */
 
 #include <folly/ThreadLocal.h>
+#include <cmath>
 
+#include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/base/SuccinctPrinter.h"
 
 namespace facebook::velox {
 
+void RuntimeMetric::addToBucket(int64_t value, int64_t n) {
+  const size_t bucket =
+      value <= 0 ? 0 : 64 - bits::countLeadingZeros<uint64_t>(value);
+  if (bucket >= buckets.size()) {
+    buckets.resize(bucket + 1);
+  }
+  buckets[bucket] += n;
+}
+
 void RuntimeMetric::addValue(int64_t value) {
   sum += value;
   count++;
   min = std::min(min, value);
   max = std::max(max, value);
+  addToBucket(value, 1);
 }
 
 void RuntimeMetric::merge(const RuntimeMetric& other) {
@@ -35,6 +47,33 @@ void RuntimeMetric::merge(const RuntimeMetric& other) {
   count += other.count;
   min = std::min(min, other.min);
   max = std::max(max, other.max);
+  if (other.buckets.size() > buckets.size()) {
+    buckets.resize(other.buckets.size());
+  }
+  for (auto i = 0; i < other.buckets.size(); ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
+int64_t RuntimeMetric::percentile(double pct) const {
+  VELOX_CHECK(pct > 0 && pct <= 100, "Percentile out of range: {}", pct);
+  if (count == 0) {
+    return 0;
+  }
+  // Rank of the value, counting from 1.
+  const auto rank = static_cast<int64_t>(std::ceil(count * pct / 100));
+  int64_t numBelow = 0;
+  for (auto i = 0; i < buckets.size(); ++i) {
+    numBelow += buckets[i];
+    if (numBelow >= rank) {
+      const int64_t upper = i == 0 ? 0
+          : i == 64                ? std::numeric_limits<int64_t>::max()
+                                   : (1ULL << i) - 1;
+      return std::max(min, std::min(max, upper));
+    }
+  }
+  // Values were set without addValue().
+  return max;
 }
 
 void RuntimeMetric::printMetric(std::stringstream& stream) const {
@@ -43,6 +82,10 @@ void RuntimeMetric::printMetric(std::stringstream& stream) const {
       stream << " sum: " << succinctNanos(sum) << ", count: " << count
              << ", min: " << succinctNanos(min)
              << ", max: " << succinctNanos(max);
+      if (count > 1) {
+        stream << ", p50: " << succinctNanos(percentile(50))
+               << ", p99: " << succinctNanos(percentile(99));
+      }
       break;
     case RuntimeCounter::Unit::kBytes:
       stream << " sum: " << succinctBytes(sum) << ", count: " << count
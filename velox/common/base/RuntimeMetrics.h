@@ -20,6 +20,7 @@
 #include <folly/CppAttributes.h>
 #include <limits>
 #include <sstream>
+#include <vector>
 
 namespace facebook::velox {
 
@@ -39,6 +40,10 @@ struct RuntimeMetric {
   int64_t count{0};
   int64_t min{std::numeric_limits<int64_t>::max()};
   int64_t max{std::numeric_limits<int64_t>::min()};
+  // Histogram of the values in power of 2 buckets. Bucket 0 counts the values
+  // <= 0 and bucket i > 0 the values in [2^(i-1), 2^i). Has as many buckets
+  // as needed for the largest value.
+  std::vector<int64_t> buckets;
 
   explicit RuntimeMetric(
       RuntimeCounter::Unit _unit = RuntimeCounter::Unit::kNone)
@@ -47,10 +52,17 @@ struct RuntimeMetric {
   explicit RuntimeMetric(
       int64_t value,
       RuntimeCounter::Unit _unit = RuntimeCounter::Unit::kNone)
-      : unit(_unit), sum{value}, count{1}, min{value}, max{value} {}
+      : unit(_unit), sum{value}, count{1}, min{value}, max{value} {
+    addToBucket(value, 1);
+  }
 
   void addValue(int64_t value);
 
+  // Returns an estimate of the 'pct' percentile, 0 < 'pct' <= 100, of the
+  // added values. This is the upper end of the bucket that has the value,
+  // bounded by 'min' and 'max'. Returns 0 if there are no values.
+  int64_t percentile(double pct) const;
+
   void printMetric(std::stringstream& stream) const;
 
   void merge(const RuntimeMetric& other);
@@ -59,6 +71,9 @@ struct RuntimeMetric {
     return fmt::format(
         "sum:{}, count:{}, min:{}, max:{}", sum, count, min, max);
   }
+
+ private:
+  void addToBucket(int64_t value, int64_t n);
 };
 
 /// Simple interface to implement writing of runtime stats to Velox Operator
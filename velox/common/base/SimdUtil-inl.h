@@ -861,6 +861,42 @@ uint8_t gather8Bits(
   return detail::gather8BitsImpl(bits, vindex, numIndices, arch);
 }
 
+template <typename A>
+void gatherBits(
+    const void* bits,
+    folly::Range<const int32_t*> indices,
+    uint64_t* result,
+    const A& arch) {
+  constexpr int32_t kStep = xsimd::batch<int32_t, A>::size;
+  const int32_t numIndices = indices.size();
+  for (int32_t i = 0; i < numIndices; i += 64) {
+    const auto numBits = std::min<int32_t>(64, numIndices - i);
+    uint64_t word = 0;
+    int32_t j = 0;
+    for (; j + kStep <= numBits; j += kStep) {
+      word |= static_cast<uint64_t>(
+                  gather8Bits(bits, indices.data() + i + j, kStep, arch))
+          << j;
+    }
+    if (j < numBits) {
+      // The indices of the last partial batch are copied so as not to read
+      // past the end of 'indices'.
+      alignas(A::alignment()) int32_t tail[kStep] = {};
+      std::copy(
+          indices.data() + i + j,
+          indices.data() + i + numBits,
+          std::begin(tail));
+      word |= static_cast<uint64_t>(gather8Bits(
+                  bits,
+                  xsimd::batch<int32_t, A>::load_aligned(tail),
+                  numBits - j,
+                  arch))
+          << j;
+    }
+    result[i / 64] = word;
+  }
+}
+
 namespace detail {
 
 template <typename A>
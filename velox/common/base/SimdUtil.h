@@ -21,6 +21,7 @@
 #include "velox/common/base/Exceptions.h"
 
 #include <folly/Likely.h>
+#include <folly/Range.h>
 #include <xsimd/xsimd.hpp>
 
 namespace facebook::velox::simd {
@@ -267,6 +268,17 @@ uint8_t gather8Bits(
       bits, loadGatherIndices<int32_t>(indices, arch), numIndices, arch);
 }
 
+// Sets bit i of 'result' to the bit at offset 'indices[i]' in 'bits', a word
+// of 'result' at a time. The bits of the last word of 'result' past
+// 'indices.size()' are set to 0. Reads up to 3 bytes past the byte of the
+// largest index, like gather8Bits.
+template <typename A = xsimd::default_arch>
+void gatherBits(
+    const void* bits,
+    folly::Range<const int32_t*> indices,
+    uint64_t* result,
+    const A& arch = {});
+
 namespace detail {
 template <typename T, typename A, size_t kSizeT = sizeof(T)>
 struct BitMask;
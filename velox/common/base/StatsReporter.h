@@ -18,6 +18,7 @@
 
 #include <folly/Singleton.h>
 #include <memory>
+#include <vector>
 
 /// StatsReporter designed to assist in reporting various stats of the
 /// application that uses velox library. The library itself does not implement
@@ -71,6 +72,20 @@ class BaseStatsReporter {
 
   virtual void addStatValue(folly::StringPiece key, size_t value = 1) const = 0;
 
+  // Registers 'key' as a histogram with buckets of 'bucketWidth' between 'min'
+  // and 'max' that exports the percentiles in 'pcts'. Reporters without
+  // histograms ignore this.
+  virtual void addHistogramExportPercentile(
+      folly::StringPiece /*key*/,
+      int64_t /*bucketWidth*/,
+      int64_t /*min*/,
+      int64_t /*max*/,
+      const std::vector<int32_t>& /*pcts*/) const {}
+
+  // Adds 'value' to the histogram 'key'.
+  virtual void addHistogramValue(folly::StringPiece /*key*/, int64_t /*value*/)
+      const {}
+
   static bool registered;
 };
 
@@ -114,4 +129,27 @@ class DummyStatsReporter : public BaseStatsReporter {
     }                                                          \
   }
 
+#define REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(k, w, mn, mx, ...)  \
+  {                                                                \
+    if (::facebook::velox::BaseStatsReporter::registered) {        \
+      auto reporter = folly::Singleton<                            \
+          facebook::velox::BaseStatsReporter>::try_get_fast();     \
+      if (LIKELY(reporter != nullptr)) {                           \
+        reporter->addHistogramExportPercentile(                    \
+            (k), (w), (mn), (mx), std::vector<int32_t>{__VA_ARGS__});  \
+      }                                                            \
+    }                                                              \
+  }
+
+#define REPORT_ADD_HISTOGRAM_VALUE(k, v)                       \
+  {                                                            \
+    if (::facebook::velox::BaseStatsReporter::registered) {    \
+      auto reporter = folly::Singleton<                        \
+          facebook::velox::BaseStatsReporter>::try_get_fast(); \
+      if (LIKELY(reporter != nullptr)) {                       \
+        reporter->addHistogramValue((k), (v));                 \
+      }                                                        \
+    }                                                          \
+  }
+
 } // namespace facebook::velox
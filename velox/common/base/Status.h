@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace facebook::velox {
+
+/// Outcome of an operation that can fail on bad input, returned instead of
+/// throwing. Meant for per-row work in expression evaluation, e.g. simple
+/// functions, where the caller records a failed row as an error or a null
+/// without the cost of an exception. An OK status does not allocate.
+class Status {
+ public:
+  /// Constructs an OK status.
+  Status() = default;
+
+  static Status OK() {
+    return Status();
+  }
+
+  /// Returns a failure caused by the input, e.g. a malformed string. It is
+  /// raised as a VeloxUserError with 'message' if an error must be thrown.
+  static Status userError(std::string message) {
+    return Status(std::make_shared<const std::string>(std::move(message)));
+  }
+
+  bool ok() const {
+    return message_ == nullptr;
+  }
+
+  /// Returns the message of a failed status or an empty string if ok().
+  const std::string& message() const {
+    static const std::string kEmpty;
+    return message_ ? *message_ : kEmpty;
+  }
+
+ private:
+  explicit Status(std::shared_ptr<const std::string> message)
+      : message_(std::move(message)) {}
+
+  std::shared_ptr<const std::string> message_;
+};
+
+} // namespace facebook::velox
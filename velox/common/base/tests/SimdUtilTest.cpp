@@ -199,6 +199,29 @@ TEST_F(SimdUtilTest, gatherBits) {
     EXPECT_EQ(bits::isBitSet(&bits, i), bits::isBitSet(data, vindex.get(i)));
   }
   EXPECT_FALSE(bits::isBitSet(&bits, N - 1));
+
+  // Gathers a range of indices a word at a time.
+  std::vector<uint64_t> source(16);
+  for (auto i = 0; i < source.size(); ++i) {
+    source[i] = folly::Random::rand64();
+  }
+  for (auto size : {1, 7, 64, 65, 200}) {
+    std::vector<int32_t> rangeIndices(size);
+    for (auto i = 0; i < size; ++i) {
+      rangeIndices[i] = (i * 37 + size) % (source.size() * 64 - 32);
+    }
+    std::vector<uint64_t> result(bits::nwords(size), ~0UL);
+    simd::gatherBits(source.data(), rangeIndices, result.data());
+    for (auto i = 0; i < size; ++i) {
+      EXPECT_EQ(
+          bits::isBitSet(result.data(), i),
+          bits::isBitSet(source.data(), rangeIndices[i]))
+          << size << " " << i;
+    }
+    for (auto i = size; i < result.size() * 64; ++i) {
+      EXPECT_FALSE(bits::isBitSet(result.data(), i));
+    }
+  }
 }
 
 namespace {
@@ -32,6 +32,9 @@ class TestReporter : public BaseStatsReporter {
  public:
   mutable std::unordered_map<std::string, size_t> counterMap;
   mutable std::unordered_map<std::string, StatType> counterTypeMap;
+  mutable std::unordered_map<std::string, std::vector<int32_t>>
+      histogramPercentilesMap;
+  mutable std::unordered_map<std::string, std::vector<int64_t>> histogramMap;
 
   void addStatExportType(const char* key, StatType statType) const override {
     counterTypeMap[key] = statType;
@@ -53,6 +56,19 @@ class TestReporter : public BaseStatsReporter {
   void addStatValue(folly::StringPiece key, size_t value) const override {
     counterMap[key.str()] += value;
   }
+
+  void addHistogramExportPercentile(
+      folly::StringPiece key,
+      int64_t /*bucketWidth*/,
+      int64_t /*min*/,
+      int64_t /*max*/,
+      const std::vector<int32_t>& pcts) const override {
+    histogramPercentilesMap[key.str()] = pcts;
+  }
+
+  void addHistogramValue(folly::StringPiece key, int64_t value) const override {
+    histogramMap[key.str()].push_back(value);
+  }
 };
 
 TEST_F(StatsReporterTest, trivialReporter) {
@@ -82,6 +98,22 @@ TEST_F(StatsReporterTest, trivialReporter) {
   EXPECT_EQ(1101, reporter->counterMap["key3"]);
 };
 
+TEST_F(StatsReporterTest, histogram) {
+  auto reporter = std::dynamic_pointer_cast<TestReporter>(
+      folly::Singleton<BaseStatsReporter>::try_get());
+
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE("hist1", 10, 0, 100, 50, 99);
+  EXPECT_EQ(
+      std::vector<int32_t>({50, 99}),
+      reporter->histogramPercentilesMap["hist1"]);
+
+  REPORT_ADD_HISTOGRAM_VALUE("hist1", 5);
+  REPORT_ADD_HISTOGRAM_VALUE("hist1", 70);
+  EXPECT_EQ(std::vector<int64_t>({5, 70}), reporter->histogramMap["hist1"]);
+  EXPECT_TRUE(
+      reporter->histogramMap.find("hist2") == reporter->histogramMap.end());
+}
+
 // Registering to folly Singleton with intended reporter type
 folly::Singleton<BaseStatsReporter> reporter([]() {
   return new TestReporter();
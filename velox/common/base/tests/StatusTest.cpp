@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/base/Status.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+
+TEST(StatusTest, basic) {
+  Status status;
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ("", status.message());
+  EXPECT_TRUE(Status::OK().ok());
+
+  status = Status::userError("Invalid input");
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ("Invalid input", status.message());
+
+  auto copy = status;
+  EXPECT_FALSE(copy.ok());
+  EXPECT_EQ("Invalid input", copy.message());
+}
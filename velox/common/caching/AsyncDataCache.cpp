@@ -20,6 +20,8 @@
 #include "velox/common/caching/SsdCache.h"
 
 #include <folly/executors/QueuedImmediateExecutor.h>
+#include <algorithm>
+#include <thread>
 #include "velox/common/caching/FileIds.h"
 
 namespace facebook::velox::cache {
@@ -57,6 +59,14 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
     auto ssdCache = shard_->cache()->ssdCache();
     assert(ssdCache); // for lint only.
     if (ssdCache->groupStats().shouldSaveToSsd(groupId_, trackingId_)) {
+      if (ssdCache->isWriteThrough()) {
+        CachePin pin;
+        ++numPins_;
+        pin.setEntry(this);
+        if (ssdCache->writeThrough(std::move(pin))) {
+          return;
+        }
+      }
       ssdSaveable_ = true;
       shard_->cache()->possibleSsdSave(size_);
     }
@@ -124,6 +134,7 @@ void AsyncDataCacheEntry::initialize(FileCacheKey key) {
 void AsyncDataCacheEntry::makeEvictable() {
   accessStats_.lastUse = 0;
   accessStats_.numUses = 0;
+  isProtected_ = false;
 }
 
 std::string AsyncDataCacheEntry::toString() const {
@@ -147,10 +158,73 @@ std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntryWithSize(
   return newEntry;
 }
 
+void CacheShard::setHitSlotLocked(
+    RawFileCacheKey key,
+    AsyncDataCacheEntry* entry) {
+  auto& slot = hitSlot(key);
+  const auto version = slot.version.load(std::memory_order_relaxed);
+  slot.version.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.fileNum.store(key.fileNum, std::memory_order_relaxed);
+  slot.offset.store(key.offset, std::memory_order_relaxed);
+  slot.entry.store(entry, std::memory_order_relaxed);
+  slot.version.store(version + 2, std::memory_order_release);
+}
+
+void CacheShard::clearHitSlotLocked(
+    RawFileCacheKey key,
+    AsyncDataCacheEntry* entry) {
+  if (hitSlot(key).entry.load(std::memory_order_relaxed) == entry) {
+    setHitSlotLocked(key, nullptr);
+  }
+}
+
+CachePin CacheShard::findPinnedShared(RawFileCacheKey key, uint64_t size) {
+  auto& slot = hitSlot(key);
+  const auto version = slot.version.load(std::memory_order_acquire);
+  if (version & 1) {
+    return CachePin();
+  }
+  auto* entry = slot.entry.load(std::memory_order_relaxed);
+  const auto fileNum = slot.fileNum.load(std::memory_order_relaxed);
+  const auto offset = slot.offset.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.version.load(std::memory_order_relaxed) != version ||
+      entry == nullptr || fileNum != key.fileNum || offset != key.offset) {
+    return CachePin();
+  }
+  // Only add to a positive pin count. Going from 0 to 1 or to exclusive
+  // requires 'mutex_', so that an entry with pins can't be evicted or reused
+  // while we pin it.
+  auto numPins = entry->numPins_.load();
+  do {
+    if (numPins <= 0) {
+      return CachePin();
+    }
+  } while (!entry->numPins_.compare_exchange_weak(numPins, numPins + 1));
+  CachePin pin;
+  pin.setEntry(entry);
+  // The entry may have been superseded or reused for another key between
+  // reading the slot and pinning. Any such change updates the slot first.
+  if (slot.version.load(std::memory_order_acquire) != version ||
+      entry->size() < size) {
+    return CachePin();
+  }
+  entry->touch();
+  protect(*entry);
+  ++numHit_;
+  ++numLockFreeHit_;
+  return pin;
+}
+
 CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
     folly::SemiFuture<bool>* wait) {
+  auto pin = findPinnedShared(key, size);
+  if (!pin.empty()) {
+    return pin;
+  }
   AsyncDataCacheEntry* entryToInit = nullptr;
   {
     std::lock_guard<std::mutex> l(mutex_);
@@ -174,9 +248,10 @@ CachePin CacheShard::findOrCreate(
           found->setPrefetch(false);
         } else {
           ++numHit_;
+          protect(*found);
         }
         ++found->numPins_;
-        CachePin pin;
+        setHitSlotLocked(key, found);
         pin.setEntry(found);
         return pin;
       }
@@ -187,12 +262,15 @@ CachePin CacheShard::findOrCreate(
                              << found->size() << " requested size " << size;
       // The old entry is superseded. Possible readers of the old
       // entry still retain a valid read pin.
+      clearHitSlotLocked(key, found);
       found->key_.fileNum.clear();
     }
     auto newEntry = getFreeEntryWithSize(size);
     // Initialize the members that must be set inside 'mutex_'.
     newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
     newEntry->promise_ = nullptr;
+    newEntry->isProtected_ = false;
+    newEntry->readPct_ = 100;
     entryToInit = newEntry.get();
     entryMap_[key] = newEntry.get();
     if (emptySlots_.empty()) {
@@ -304,10 +382,11 @@ std::unique_ptr<folly::SharedPromise<bool>> CacheShard::removeEntry(
 
 void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
   if (entry->key_.fileNum.hasValue()) {
-    auto removeIter = entryMap_.find(
-        RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
+    const RawFileCacheKey key{entry->key_.fileNum.id(), entry->key_.offset};
+    auto removeIter = entryMap_.find(key);
     VELOX_CHECK(removeIter != entryMap_.end());
     entryMap_.erase(removeIter);
+    clearHitSlotLocked(key, entry);
     entry->key_.fileNum.clear();
     entry->setSsdFile(nullptr, 0);
     if (entry->isPrefetch()) {
@@ -325,7 +404,7 @@ void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
   }
 }
 
-void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
+uint64_t CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   int64_t tinyFreed = 0;
   int64_t largeFreed = 0;
   int32_t evictSaveableSkipped = 0;
@@ -337,13 +416,23 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
     std::lock_guard<std::mutex> l(mutex_);
     int size = entries_.size();
     if (!size) {
-      return;
+      return 0;
     }
     int32_t counter = 0;
     int32_t numChecked = 0;
     auto entryIndex = (clockHand_ % size);
     auto iter = entries_.begin() + entryIndex;
-    while (++counter <= size) {
+    // Under the segmented policy, the first sweep spares the protected
+    // entries. If this frees nothing, a second sweep demotes the protected
+    // entries that would otherwise be evicted, so that they are evicted by a
+    // later call unless hit again.
+    const int32_t numSweeps =
+        policy_ == CacheEvictionPolicy::kSegmented && !evictAllUnpinned ? 2
+                                                                         : 1;
+    while (++counter <= size * numSweeps) {
+      if (counter > size && largeFreed + tinyFreed > 0) {
+        break;
+      }
       if (++iter == entries_.end()) {
         iter = entries_.begin();
         entryIndex = 0;
@@ -368,7 +457,15 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
       int32_t score = 0;
       if (candidate->numPins_ == 0 &&
           (!candidate->key_.fileNum.hasValue() || evictAllUnpinned ||
-           (score = candidate->score(now)) >= evictionThreshold_)) {
+           (score = evictionScore(*candidate, now)) >= evictionThreshold_)) {
+        if (candidate->isProtected_ && !evictAllUnpinned &&
+            candidate->key_.fileNum.hasValue()) {
+          if (counter > size) {
+            candidate->isProtected_ = false;
+            ++numDemoted_;
+          }
+          continue;
+        }
         if (skipSsdSaveable && candidate->ssdSaveable_ && !evictAllUnpinned) {
           ++evictSaveableSkipped;
           continue;
@@ -404,6 +501,22 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   } else if (evictSaveableSkipped) {
     ++cache_->numSkippedSaves();
   }
+  return largeFreed + tinyFreed;
+}
+
+int32_t CacheShard::evictionScore(
+    const AsyncDataCacheEntry& entry,
+    AccessTime now) const {
+  const auto score = entry.score(now);
+  if (policy_ == CacheEvictionPolicy::kClock || entry.isProtected_) {
+    return score;
+  }
+  const int64_t scaled = static_cast<int64_t>(score) * kProbationScoreScale *
+      100 / std::max(entry.readPct_, kMinScoreReadPct);
+  return std::clamp<int64_t>(
+      scaled,
+      std::numeric_limits<int32_t>::min(),
+      std::numeric_limits<int32_t>::max());
 }
 
 void CacheShard::calibrateThreshold() {
@@ -415,7 +528,14 @@ void CacheShard::calibrateThreshold() {
   evictionThreshold_ = percentile<int32_t>(
       [&]() -> int32_t {
         AsyncDataCacheEntry* element = iter->get();
-        int32_t score = element ? element->score(now) : 0;
+        // Under the segmented policy, the threshold is set by the unpinned
+        // probationary entries, so that the first sweep of evict() finds
+        // some of them evictable.
+        int32_t score = element &&
+                (policy_ == CacheEvictionPolicy::kClock ||
+                 (!element->isProtected_ && element->numPins_ == 0))
+            ? evictionScore(*element, now)
+            : 0;
         if (entryIndex + step >= entries_.size()) {
           entryIndex = (entryIndex + step) % entries_.size();
           iter = entries_.begin() + entryIndex;
@@ -440,6 +560,9 @@ void CacheShard::updateStats(CacheStats& stats) {
     } else if (entry->isShared()) {
       ++stats.numShared;
     }
+    if (entry->isProtected_) {
+      ++stats.numProtected;
+    }
     if (entry->isPrefetch_) {
       ++stats.numPrefetch;
       stats.prefetchBytes += entry->size();
@@ -451,14 +574,28 @@ void CacheShard::updateStats(CacheStats& stats) {
     stats.largePadding += entry->data_.byteSize() - entry->size_;
   }
   stats.numHit += numHit_;
+  stats.numLockFreeHit += numLockFreeHit_;
   stats.numNew += numNew_;
   stats.numEvict += numEvict_;
   stats.numEvictChecks += numEvictChecks_;
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
+  stats.numDemoted += numDemoted_;
   stats.allocClocks += allocClocks_;
 }
 
+void CacheShard::addResidentFiles(ResidentFiles& files) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& entry : entries_) {
+    if (!entry || !entry->key_.fileNum.hasValue() || entry->isExclusive()) {
+      continue;
+    }
+    auto& file = files[entry->key_.fileNum.id()];
+    file.groupId = entry->groupId_;
+    file.ramBytes += entry->size_;
+  }
+}
+
 void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
   std::lock_guard<std::mutex> l(mutex_);
   // Do not add more than 70% of entries to a write batch.If SSD save
@@ -485,27 +622,40 @@ void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
 AsyncDataCache::AsyncDataCache(
     const std::shared_ptr<MappedMemory>& mappedMemory,
     uint64_t maxBytes,
-    std::unique_ptr<SsdCache> ssdCache)
+    std::unique_ptr<SsdCache> ssdCache,
+    int32_t numShards,
+    CacheEvictionPolicy evictionPolicy)
     : mappedMemory_(mappedMemory),
       ssdCache_(std::move(ssdCache)),
+      evictionPolicy_(evictionPolicy),
       cachedPages_(0),
       maxBytes_(maxBytes) {
-  for (auto i = 0; i < kNumShards; ++i) {
-    shards_.push_back(std::make_unique<CacheShard>(this));
+  VELOX_CHECK_GE(numShards, 0);
+  numShards = numShards == 0 ? defaultNumShards()
+                             : bits::nextPowerOfTwo(numShards);
+  shardMask_ = numShards - 1;
+  for (auto i = 0; i < numShards; ++i) {
+    shards_.push_back(std::make_unique<CacheShard>(this, evictionPolicy_));
   }
 }
 
+// static
+int32_t AsyncDataCache::defaultNumShards() {
+  return std::clamp<int32_t>(
+      bits::nextPowerOfTwo(std::thread::hardware_concurrency()),
+      kMinShards,
+      kMaxShards);
+}
+
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
     folly::SemiFuture<bool>* wait) {
-  int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+  return shard(key).findOrCreate(key, size, wait);
 }
 
 bool AsyncDataCache::exists(RawFileCacheKey key) const {
-  int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->exists(key);
+  return shard(key).exists(key);
 }
 
 bool AsyncDataCache::makeSpace(
@@ -523,7 +673,8 @@ bool AsyncDataCache::makeSpace(
   // serialize with a mutex because memory arbitration must not be
   // called from inside a global mutex.
 
-  constexpr int32_t kMaxAttempts = kNumShards * 4;
+  const int32_t numShards = shards_.size();
+  const int32_t maxAttempts = numShards * 4;
   // If requesting less than kSmallSizePages try up to 4x more if
   // first try failed.
   constexpr int32_t kSmallSizePages = 2048; // 8MB
@@ -541,7 +692,7 @@ bool AsyncDataCache::makeSpace(
     rank = ++numThreadsInAllocate_;
     isCounted = true;
   }
-  for (auto nthAttempt = 0; nthAttempt < kMaxAttempts; ++nthAttempt) {
+  for (auto nthAttempt = 0; nthAttempt < maxAttempts; ++nthAttempt) {
     if (mappedMemory_->numAllocated() + numPages <
         maxBytes_ / MappedMemory::kPageSize) {
       try {
@@ -563,7 +714,7 @@ bool AsyncDataCache::makeSpace(
                 << "cach write to unpin memory";
       std::this_thread::sleep_for(std::chrono::milliseconds(500)); // NOLINT
     }
-    if (nthAttempt > kMaxAttempts / 2) {
+    if (nthAttempt > maxAttempts / 2) {
       if (!isCounted) {
         rank = ++numThreadsInAllocate_;
         isCounted = true;
@@ -576,9 +727,9 @@ bool AsyncDataCache::makeSpace(
     // Evict from next shard. If we have gone through all shards once
     // and still have not made the allocation, we go to desperate mode
     // with 'evictAllUnpinned' set to true.
-    shards_[shardCounter_ & (kShardMask)]->evict(
+    shards_[shardCounter_ & shardMask_]->evict(
         numPages * sizeMultiplier * MappedMemory::kPageSize,
-        nthAttempt >= kNumShards);
+        nthAttempt >= numShards);
     if (numPages < kSmallSizePages && sizeMultiplier < 4) {
       sizeMultiplier *= 2;
     }
@@ -674,15 +825,50 @@ CacheStats AsyncDataCache::refreshStats() const {
   for (auto& shard : shards_) {
     shard->updateStats(stats);
   }
+  stats.numShrinks = numShrinks_;
+  stats.shrunkBytes = shrunkBytes_;
   return stats;
 }
 
+ResidentFiles AsyncDataCache::residentFiles() const {
+  ResidentFiles files;
+  for (auto& shard : shards_) {
+    shard->addResidentFiles(files);
+  }
+  if (ssdCache_) {
+    ssdCache_->addResidentFiles(files);
+  }
+  return files;
+}
+
 void AsyncDataCache::clear() {
   for (auto& shard : shards_) {
     shard->evict(std::numeric_limits<int32_t>::max(), true);
   }
 }
 
+uint64_t AsyncDataCache::shrink(uint64_t targetBytes) {
+  ++numShrinks_;
+  // Save the entries that qualify for SSD before evicting them. Evictions skip
+  // the saveable entries while the write is in progress unless evicting all
+  // unpinned entries.
+  if (ssdCache_ && ssdSaveable_ > 0 && ssdCache_->startWrite()) {
+    saveToSsd();
+  }
+  uint64_t freedBytes = 0;
+  // Evict by score first and then anything unpinned if that is not enough.
+  for (auto evictAllUnpinned : {false, true}) {
+    for (auto& shard : shards_) {
+      if (freedBytes >= targetBytes) {
+        break;
+      }
+      freedBytes += shard->evict(targetBytes - freedBytes, evictAllUnpinned);
+    }
+  }
+  shrunkBytes_ += freedBytes;
+  return freedBytes;
+}
+
 std::string AsyncDataCache::toString() const {
   auto stats = refreshStats();
   std::stringstream out;
@@ -691,7 +877,8 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
+      << stats.numEvict << " shrink " << stats.numShrinks << " protected "
+      << stats.numProtected << " demoted " << stats.numDemoted << "\n"
       << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <deque>
 
 #include <fmt/format.h>
@@ -53,8 +54,9 @@ inline AccessTime accessTime() {
 }
 
 struct AccessStats {
-  AccessTime lastUse{0};
-  int32_t numUses{0};
+  // Updated without synchronization by lock-free cache hits.
+  tsan_atomic<AccessTime> lastUse{0};
+  tsan_atomic<int32_t> numUses{0};
 
   // Retention score. A higher number means less worth retaining. This
   // works well with a typical formula of time over use count going to
@@ -84,6 +86,21 @@ struct AccessStats {
   }
 };
 
+// Selects how a CacheShard picks entries to evict.
+enum class CacheEvictionPolicy {
+  // Clock sweep evicting entries whose access score is above a sampled
+  // threshold, regardless of how many times they have been hit.
+  kClock,
+  // Segmented LRU on top of the clock sweep. New entries are
+  // probationary and become protected on their first hit. Probationary
+  // entries age faster, the more so the smaller the fraction of their
+  // stream the scans read, and are evicted before any protected entry.
+  // Protected entries are demoted to probationary when the sweep finds
+  // nothing else to evict. This keeps a one-time scan larger than the
+  // cache from flushing out the data that is accessed repeatedly.
+  kSegmented,
+};
+
 // Owning reference to a file id and an offset.
 struct FileCacheKey {
   StringIdLease fileNum;
@@ -236,6 +253,20 @@ class AsyncDataCacheEntry {
     groupId_ = groupId;
   }
 
+  // Sets the percentage of the references to the entry's stream that are
+  // actually read, see ScanTracker::readPct(). This is set while the entry
+  // is exclusive and ranks probationary entries under
+  // CacheEvictionPolicy::kSegmented.
+  void setReadPct(int32_t readPct) {
+    readPct_ = readPct;
+  }
+
+  // True if the entry has been hit after its first use and is retained
+  // ahead of probationary entries under CacheEvictionPolicy::kSegmented.
+  bool isProtected() const {
+    return isProtected_;
+  }
+
   /// Sets access stats so that this is immediately evictable.
   void makeEvictable();
 
@@ -276,7 +307,8 @@ class AsyncDataCacheEntry {
   std::unique_ptr<folly::SharedPromise<bool>> promise_;
   int32_t size_{0};
 
-  // Setting this from 0 to 1 or to kExclusive requires owning shard_->mutex_.
+  // Setting this from 0 to 1 or to kExclusive requires owning
+  // shard_->mutex_. Incrementing a positive count does not.
   std::atomic<int32_t> numPins_{0};
 
   AccessStats accessStats_;
@@ -297,6 +329,14 @@ class AsyncDataCacheEntry {
   // Tracking id. Used for deciding if this should be written to SSD.
   TrackingId trackingId_;
 
+  // Percentage of the references to the stream of 'this' that are read. 100
+  // if not known.
+  int32_t readPct_{100};
+
+  // Set on a hit under CacheEvictionPolicy::kSegmented. Cleared when
+  // demoted by eviction. Also set by lock-free hits.
+  tsan_atomic<bool> isProtected_{false};
+
   // SSD file from which this was loaded or nullptr if not backed by
   // SsdFile. Used to avoid re-adding items that already come from
   // SSD. The exact file and offset are needed to include uses in RAM
@@ -389,6 +429,7 @@ class CachePin {
 
   AsyncDataCacheEntry* entry_{nullptr};
 
+  friend class AsyncDataCacheEntry;
   friend class CacheShard;
 };
 
@@ -454,6 +495,21 @@ class CoalescedLoad {
   std::vector<int32_t> sizes_;
 };
 
+// Bytes of a file that are resident in the cache. See
+// AsyncDataCache::residentFiles().
+struct ResidentFileBytes {
+  // Group of the file, as given by the reader that loaded its data. 0 if only
+  // on SSD.
+  uint64_t groupId{0};
+  // Bytes in memory.
+  int64_t ramBytes{0};
+  // Bytes on SSD.
+  int64_t ssdBytes{0};
+};
+
+// Resident bytes by file id. The ids map to file names through fileIds().
+using ResidentFiles = folly::F14FastMap<uint64_t, ResidentFileBytes>;
+
 // Struct for CacheShard stats. Stats from all shards are added into
 // this struct to provide a snapshot of state.
 struct CacheStats {
@@ -481,6 +537,9 @@ struct CacheStats {
   // Number of hits (saved IO). The first hit to a prefetched entry does not
   // count.
   int64_t numHit{};
+  // Number of hits served without taking the shard mutex. Included in
+  // 'numHit'.
+  int64_t numLockFreeHit{};
   // Number of new entries created.
   int64_t numNew{};
   // Number of times a valid entry was removed in order to make space.
@@ -496,6 +555,16 @@ struct CacheStats {
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // Number of times the cache was asked to shrink to make memory available
+  // for other uses, e.g. queries.
+  int64_t numShrinks{};
+  // Total bytes freed by shrinking.
+  int64_t shrunkBytes{};
+  // Number of entries in the protected segment under
+  // CacheEvictionPolicy::kSegmented.
+  int32_t numProtected{};
+  // Number of times a protected entry was demoted to probationary.
+  int64_t numDemoted{};
 };
 // Collection of cache entries whose key hashes to the same shard of
 // the hash number space.  The cache population is divided into shards
@@ -503,9 +572,11 @@ struct CacheStats {
 // and other housekeeping.
 class CacheShard {
  public:
-  explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache) : cache_(cache) {}
+  CacheShard(AsyncDataCache* FOLLY_NONNULL cache, CacheEvictionPolicy policy)
+      : cache_(cache), policy_(policy) {}
 
-  // See AsyncDataCache::findOrCreate.
+  // See AsyncDataCache::findOrCreate. A hit on an entry which is pinned in
+  // shared mode is served without taking 'mutex_'.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
@@ -525,8 +596,8 @@ class CacheShard {
   // not pinned. This favors first removing older and less frequently
   // used entries. If 'evictAllUnpinned' is true, anything that is
   // not pinned is evicted at first sight. This is for out of memory
-  // emergencies.
-  void evict(uint64_t bytesToFree, bool evictAllUnpinned);
+  // emergencies. Returns the number of bytes freed.
+  uint64_t evict(uint64_t bytesToFree, bool evictAllUnpinned);
 
   // Removes 'entry' from 'this'. Removes a possible promise from the entry
   // inside the shard mutex and returns it so that it can be realized outside of
@@ -537,6 +608,9 @@ class CacheShard {
   // Adds the stats of 'this' to 'stats'.
   void updateStats(CacheStats& stats);
 
+  // Adds the bytes of the entries of 'this' to their files in 'files'.
+  void addResidentFiles(ResidentFiles& files) const;
+
   // Appends a batch of non-saved SSD saveable entries in 'this' to
   // 'pins'. This may have to be called several times since this keeps
   // limits on the batch to write at one time. The saveable entries
@@ -551,8 +625,66 @@ class CacheShard {
  private:
   static constexpr int32_t kNoThreshold = std::numeric_limits<int32_t>::max();
 
+  // Multiplier of the score of probationary entries under
+  // CacheEvictionPolicy::kSegmented.
+  static constexpr int32_t kProbationScoreScale = 4;
+
+  // Lower bound of the read percentage used for scaling probationary
+  // scores. Keeps an entry of a stream that is never read from getting an
+  // unbounded score.
+  static constexpr int32_t kMinScoreReadPct = 10;
+
+  // Number of slots in 'hitSlots_'. Must be power of 2.
+  static constexpr int32_t kNumHitSlots = 1024;
+
+  // A direct mapped cache of the key to entry mapping of recently hit
+  // entries, read without 'mutex_'. This is a seqlock: 'version' is odd while
+  // the slot is being updated. The slots are only updated inside 'mutex_'.
+  struct HitSlot {
+    std::atomic<uint64_t> version{0};
+    std::atomic<uint64_t> fileNum{0};
+    std::atomic<uint64_t> offset{0};
+    std::atomic<AsyncDataCacheEntry*> entry{nullptr};
+  };
+
+  HitSlot& hitSlot(RawFileCacheKey key) {
+    return hitSlots_[(std::hash<RawFileCacheKey>()(key) >> 32) &
+                     (kNumHitSlots - 1)];
+  }
+
+  // Sets the slot of 'key' to 'entry' or clears the slot if 'entry' is
+  // nullptr.
+  void setHitSlotLocked(RawFileCacheKey key, AsyncDataCacheEntry* entry);
+
+  // Clears the slot of 'key' if it refers to 'entry'.
+  void clearHitSlotLocked(RawFileCacheKey key, AsyncDataCacheEntry* entry);
+
+  // Returns a shared pin on the entry for 'key' if the entry is in
+  // 'hitSlots_', is at least 'size' bytes and is already pinned in shared
+  // mode. Returns an empty pin otherwise, in which case the caller must look
+  // up 'key' inside 'mutex_'. Does not take 'mutex_'. The entries are never
+  // freed while the shard exists, so a stale slot can at worst point to an
+  // entry that has been reused for another key, which is detected by
+  // rechecking the slot version after pinning.
+  CachePin findPinnedShared(RawFileCacheKey key, uint64_t size);
+
   void calibrateThreshold();
 
+  // Returns the score of 'entry' for eviction. This is the access score
+  // under CacheEvictionPolicy::kClock. Under kSegmented, the score of a
+  // probationary entry is scaled up by kProbationScoreScale and by the
+  // inverse of its read percentage.
+  int32_t evictionScore(const AsyncDataCacheEntry& entry, AccessTime now)
+      const;
+
+  // Moves 'entry' to the protected segment if the eviction policy is
+  // segmented.
+  void protect(AsyncDataCacheEntry& entry) {
+    if (policy_ == CacheEvictionPolicy::kSegmented) {
+      entry.isProtected_ = true;
+    }
+  }
+
   void removeEntryLocked(AsyncDataCacheEntry* entry);
 
   // Returns an unused entry if found. 'size' is a hint for selecting an entry
@@ -571,6 +703,7 @@ class CacheShard {
   // few around to avoid allocating one inside 'mutex_'.
   std::vector<std::unique_ptr<AsyncDataCacheEntry>> freeEntries_;
   AsyncDataCache* const cache_;
+  const CacheEvictionPolicy policy_;
   // Index in 'entries_' for the next eviction candidate.
   uint32_t clockHand_{};
   // Number of gets  since last stats sampling.
@@ -578,7 +711,7 @@ class CacheShard {
   // Maximum retainable entry score(). Anything above this is evictable.
   int32_t evictionThreshold_{kNoThreshold};
   // Cumulative count of cache hits.
-  uint64_t numHit_{};
+  std::atomic<uint64_t> numHit_{};
   // Cumulative count of hits on entries held in exclusive mode.
   uint64_t numWaitExclusive_{};
   // Cumulative count of new entry creation.
@@ -591,17 +724,42 @@ class CacheShard {
   // Sum of evict scores. This divided by 'numEvict_' correlates to
   // time data stays in cache.
   uint64_t sumEvictScore_{};
+  // Count of protected entries demoted to probationary.
+  uint64_t numDemoted_{};
   // Tracker of time spent in allocating/freeing MappedMemory space
   // for backing cached data.
   std::atomic<uint64_t> allocClocks_;
+  // Cumulative count of cache hits served without taking 'mutex_'.
+  std::atomic<uint64_t> numLockFreeHit_{};
+  std::array<HitSlot, kNumHitSlots> hitSlots_;
 };
 
 class AsyncDataCache : public memory::MappedMemory {
  public:
+  // 'numShards' is the number of CacheShards the entries are divided
+  // into to reduce contention. It is rounded up to a power of 2. 0
+  // means a shard count scaled with the number of cores,
+  // see defaultNumShards(). 'evictionPolicy' selects how the shards
+  // pick entries to evict.
   AsyncDataCache(
       const std::shared_ptr<memory::MappedMemory>& mappedMemory,
       uint64_t maxBytes,
-      std::unique_ptr<SsdCache> ssdCache = nullptr);
+      std::unique_ptr<SsdCache> ssdCache = nullptr,
+      int32_t numShards = 0,
+      CacheEvictionPolicy evictionPolicy = CacheEvictionPolicy::kClock);
+
+  // Returns the number of shards used when the constructor is given
+  // 0. This is the number of cores rounded up to a power of 2 and
+  // limited to [kMinShards, kMaxShards].
+  static int32_t defaultNumShards();
+
+  int32_t numShards() const {
+    return shards_.size();
+  }
+
+  CacheEvictionPolicy evictionPolicy() const {
+    return evictionPolicy_;
+  }
 
   // Finds or creates a cache entry corresponding to 'key'. The entry
   // is returned in 'pin'. If the entry is new, it is pinned in
@@ -670,6 +828,12 @@ class AsyncDataCache : public memory::MappedMemory {
 
   CacheStats refreshStats() const;
 
+  // Returns the files with data in memory or on SSD. A scheduler can prefer
+  // to run the splits of these files on this worker. Takes the mutex of each
+  // shard and SSD file in turn, so this is meant to be called every few
+  // seconds, not per split.
+  ResidentFiles residentFiles() const;
+
   std::string toString() const override;
 
   memory::MachinePageCount incrementCachedPages(int64_t pages) {
@@ -733,6 +897,21 @@ class AsyncDataCache : public memory::MappedMemory {
   // Drops all unpinned entries. Pins stay valid.
   void clear();
 
+  // Frees at least 'targetBytes' of cached data unless there is not
+  // that much unpinned data. This is called under memory pressure,
+  // e.g. by a memory arbitrator that needs the memory for queries, so
+  // that the cache can use all free memory when queries don't. The
+  // entries that qualify for SSD are first written to 'ssdCache_' so
+  // that they can be read back from SSD after being evicted. The
+  // entries being written stay in memory until the write is done and
+  // can be freed by a later shrink. Returns the number of bytes freed.
+  uint64_t shrink(uint64_t targetBytes);
+
+  // Returns the memory used by the cached data.
+  uint64_t cachedBytes() const {
+    return cachedPages_ * memory::MappedMemory::kPageSize;
+  }
+
   // Saves all entries with 'ssdSaveable_' to 'ssdCache_'.
   void saveToSsd();
 
@@ -745,8 +924,12 @@ class AsyncDataCache : public memory::MappedMemory {
   }
 
  private:
-  static constexpr int32_t kNumShards = 4; // Must be power of 2.
-  static constexpr int32_t kShardMask = kNumShards - 1;
+  static constexpr int32_t kMinShards = 4;
+  static constexpr int32_t kMaxShards = 64;
+
+  CacheShard& shard(RawFileCacheKey key) const {
+    return *shards_[std::hash<RawFileCacheKey>()(key) & shardMask_];
+  }
 
   // Waits a pseudorandom delay times 'counter'.
   void backoff(int32_t counter);
@@ -764,7 +947,10 @@ class AsyncDataCache : public memory::MappedMemory {
 
   std::shared_ptr<memory::MappedMemory> mappedMemory_;
   std::unique_ptr<SsdCache> ssdCache_;
+  const CacheEvictionPolicy evictionPolicy_;
   std::vector<std::unique_ptr<CacheShard>> shards_;
+  // The number of shards is a power of 2. This is the number of shards - 1.
+  uint64_t shardMask_;
   std::atomic<int32_t> shardCounter_{0};
   std::atomic<memory::MachinePageCount> cachedPages_{0};
   // Number of pages that are allocated and not yet loaded or loaded
@@ -797,6 +983,10 @@ class AsyncDataCache : public memory::MappedMemory {
   // Counter of threads competing for allocation in makeSpace(). Used
   // for setting staggered backoff. Mutexes are not allowed for this.
   std::atomic<int32_t> numThreadsInAllocate_{0};
+
+  // Count of shrink() calls and the bytes they freed.
+  std::atomic<uint64_t> numShrinks_{0};
+  std::atomic<uint64_t> shrunkBytes_{0};
 };
 
 // Samples a set of values T from 'numSamples' calls of
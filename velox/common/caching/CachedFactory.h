@@ -125,6 +125,11 @@ struct DefaultSizer {
 // If it is not thread-safe it must do its own internal locking.
 // Sizer takes a Value and returns how much cache space it will occupy. The
 // DefaultSizer says each value occupies 1 space.
+//
+// If 'isExpired' is given, a cached value for which it returns true is
+// generated again. An expired value that is still in use elsewhere is
+// returned as is until it is released, so that its users keep a valid
+// pointer.
 template <
     typename Key,
     typename Value,
@@ -140,8 +145,11 @@ class CachedFactory {
   // true, but performance will suffer.
   CachedFactory(
       std::unique_ptr<SimpleLRUCache<Key, Value, Comparator, Hash>> cache,
-      std::unique_ptr<Generator> generator)
-      : cache_(std::move(cache)), generator_(std::move(generator)) {}
+      std::unique_ptr<Generator> generator,
+      std::function<bool(const Value&)> isExpired = nullptr)
+      : cache_(std::move(cache)),
+        generator_(std::move(generator)),
+        isExpired_(std::move(isExpired)) {}
 
   // Returns the generator's output on the given key. If the output is
   // in the cache, returns immediately. Otherwise, blocks until the output
@@ -183,8 +191,13 @@ class CachedFactory {
   CachedFactory& operator=(const CachedFactory&) = delete;
 
  private:
+  // Returns the pinned value for 'key' or nullptr if there is none or it has
+  // expired. Must be called with 'cacheMu_' held.
+  Value* getCached(const Key& key);
+
   std::unique_ptr<SimpleLRUCache<Key, Value, Comparator, Hash>> cache_;
   std::unique_ptr<Generator> generator_;
+  const std::function<bool(const Value&)> isExpired_;
   folly::F14FastSet<Key, Hash, Comparator> pending_;
 
   std::mutex cacheMu_;
@@ -294,7 +307,7 @@ CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::generate(
   std::unique_lock<std::mutex> pending_lock(pendingMu_);
   {
     std::lock_guard<std::mutex> cache_lock(cacheMu_);
-    Value* value = cache_->get(key);
+    Value* value = getCached(key);
     if (value) {
       return CachedPtr<Key, Value, Comparator, Hash>(
           /*wasCached=*/true,
@@ -309,7 +322,7 @@ CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::generate(
     // Will normally hit the cache now.
     {
       std::lock_guard<std::mutex> cache_lock(cacheMu_);
-      Value* value = cache_->get(key);
+      Value* value = getCached(key);
       if (value) {
         return CachedPtr<Key, Value, Comparator, Hash>(
             /*wasCached=*/false,
@@ -379,7 +392,7 @@ void CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::
         std::vector<Key>* missing) {
   std::lock_guard<std::mutex> cache_lock(cacheMu_);
   for (const Key& key : keys) {
-    Value* value = cache_->get(key);
+    Value* value = getCached(key);
     if (value) {
       cached->emplace_back(
           key,
@@ -395,4 +408,25 @@ void CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::
   }
 }
 
+template <
+    typename Key,
+    typename Value,
+    typename Generator,
+    typename Sizer,
+    typename Comparator,
+    typename Hash>
+Value* CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::getCached(
+    const Key& key) {
+  Value* value = cache_->get(key);
+  if (value && isExpired_ && isExpired_(*value)) {
+    cache_->release(key);
+    if (cache_->erase(key)) {
+      return nullptr;
+    }
+    // In use elsewhere.
+    value = cache_->get(key);
+  }
+  return value;
+}
+
 } // namespace facebook::velox
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -90,6 +91,10 @@ class SimpleLRUCache {
   // happen (namely, memory leaks).
   void release(const Key& key);
 
+  // Removes 'key' and frees its value. Returns false and leaves the cache
+  // unchanged if 'key' is pinned or not present.
+  bool erase(const Key& key);
+
   // Total size of elements in the cache (NOT the maximum size/limit).
   int64_t currentSize() const {
     return curSize_;
@@ -212,6 +217,22 @@ inline void SimpleLRUCache<Key, Value, Comparator, Hash>::release(
   }
 }
 
+template <typename Key, typename Value, typename Comparator, typename Hash>
+inline bool SimpleLRUCache<Key, Value, Comparator, Hash>::erase(
+    const Key& key) {
+  auto it = keys_.find(key);
+  if (it == keys_.end() || it->second->pinCount > 0) {
+    return false;
+  }
+  Element* e = it->second;
+  keys_.erase(it);
+  elements_.erase(std::find(elements_.begin(), elements_.end(), e));
+  curSize_ -= e->size;
+  delete e->value;
+  delete e;
+  return true;
+}
+
 template <typename Key, typename Value, typename Comparator, typename Hash>
 inline int64_t SimpleLRUCache<Key, Value, Comparator, Hash>::free(
     int64_t size) {
@@ -27,11 +27,13 @@ SsdCache::SsdCache(
     uint64_t maxBytes,
     int32_t numShards,
     folly::Executor* executor,
-    int64_t checkpointIntervalBytes)
+    int64_t checkpointIntervalBytes,
+    int64_t maxWriteThroughBytes)
     : filePrefix_(filePrefix),
       numShards_(numShards),
       groupStats_(std::make_unique<FileGroupStats>()),
-      executor_(executor) {
+      executor_(executor),
+      maxWriteThroughBytes_(maxWriteThroughBytes) {
   files_.reserve(numShards_);
   // Cache size must be a multiple of this so that each shard has the same max
   // size.
@@ -105,10 +107,61 @@ void SsdCache::write(std::vector<CachePin> pins) {
             "SSDCA: Wrote {}MB, {} MB/s",
             bytes >> 20,
             static_cast<float>(bytes) / (getCurrentTimeMicro() - start));
+        flushWriteThrough();
       }
     });
   }
-  writesInProgress_.fetch_sub(numNoStore);
+  if (writesInProgress_.fetch_sub(numNoStore) == numNoStore) {
+    flushWriteThrough();
+  }
+}
+
+bool SsdCache::writeThrough(CachePin pin) {
+  VELOX_CHECK(isWriteThrough());
+  {
+    std::lock_guard<std::mutex> l(writeThroughMutex_);
+    const auto size = pin.checkedEntry()->size();
+    if (writeThroughBytes_ + size > maxWriteThroughBytes_) {
+      return false;
+    }
+    writeThroughBytes_ += size;
+    writeThroughPins_.push_back(std::move(pin));
+  }
+  flushWriteThrough();
+  return true;
+}
+
+void SsdCache::flushWriteThrough() {
+  if (!isWriteThrough()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(writeThroughMutex_);
+    if (writeThroughPins_.empty()) {
+      return;
+    }
+  }
+  if (!startWrite()) {
+    return;
+  }
+  std::vector<CachePin> pins;
+  {
+    std::lock_guard<std::mutex> l(writeThroughMutex_);
+    pins = std::move(writeThroughPins_);
+    writeThroughPins_.clear();
+    writeThroughBytes_ = 0;
+  }
+  // Entries that got on SSD since being queued, e.g. by a concurrent
+  // write of the same key, are not written again.
+  pins.erase(
+      std::remove_if(
+          pins.begin(),
+          pins.end(),
+          [](const CachePin& pin) {
+            return pin.checkedEntry()->ssdFile() != nullptr;
+          }),
+      pins.end());
+  write(std::move(pins));
 }
 
 SsdCacheStats SsdCache::stats() const {
@@ -119,6 +172,12 @@ SsdCacheStats SsdCache::stats() const {
   return stats;
 }
 
+void SsdCache::addResidentFiles(ResidentFiles& files) const {
+  for (auto& file : files_) {
+    file->addResidentFiles(files);
+  }
+}
+
 void SsdCache::clear() {
   for (auto& file : files_) {
     file->clear();
@@ -144,10 +203,27 @@ void SsdCache::deleteFiles() {
 }
 
 void SsdCache::shutdown() {
+  // Writes the entries queued for write-through before stopping.
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> l(writeThroughMutex_);
+      if (writeThroughPins_.empty()) {
+        break;
+      }
+    }
+    flushWriteThrough();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // NOLINT
+  }
   isShutdown_ = true;
   while (writesInProgress_) {
     std::this_thread::sleep_for(std::chrono::milliseconds(100)); // NOLINT
   }
+  {
+    // Entries queued after the loop above are not written.
+    std::lock_guard<std::mutex> l(writeThroughMutex_);
+    writeThroughPins_.clear();
+    writeThroughBytes_ = 0;
+  }
   for (auto& file : files_) {
     file->checkpoint(true);
   }
@@ -31,13 +31,16 @@ class SsdCache {
   //  256M with 2 shards each of 128M (2 regions). If
   //  'checkpointIntervalBytes' is non-0, the cache makes a durable
   //  checkpointed state that survives restart after each
-  //  'checkpointIntervalBytes' written.
+  //  'checkpointIntervalBytes' written. If 'maxWriteThroughBytes' is
+  //  non-0, entries loaded from storage are written to SSD as soon
+  //  as they are loaded, see writeThrough().
   SsdCache(
       std::string_view filePrefix,
       uint64_t maxBytes,
       int32_t numShards,
       folly::Executor* executor,
-      int64_t checkpointIntervalBytes = 0);
+      int64_t checkpointIntervalBytes = 0,
+      int64_t maxWriteThroughBytes = 0);
 
   // Returns the shard corresponding to 'fileId'. 'fileId' is a
   //  file id from e.g. FileCacheKey.
@@ -64,9 +67,24 @@ class SsdCache {
   // it must have returned true.
   void write(std::vector<CachePin> pins);
 
+  bool isWriteThrough() const {
+    return maxWriteThroughBytes_ > 0;
+  }
+
+  // Queues 'pin' of an entry just loaded from storage for writing to
+  // SSD. The queued entries are written as soon as no other write is
+  // in progress, so that entries that are evicted from RAM soon after
+  // loading, e.g. by large scans, still get on SSD. The pins keep the
+  // entries in RAM until written, up to 'maxWriteThroughBytes'. Returns
+  // false if the queue is full.
+  bool writeThrough(CachePin pin);
+
   // Returns  stats aggregated from all shards.
   SsdCacheStats stats() const;
 
+  // Adds the bytes of the cached entries to their files in 'files'.
+  void addResidentFiles(ResidentFiles& files) const;
+
   FileGroupStats& groupStats() const {
     return *groupStats_;
   }
@@ -86,6 +104,10 @@ class SsdCache {
   std::string toString() const;
 
  private:
+  // Writes the entries queued by writeThrough() if no other write is in
+  // progress.
+  void flushWriteThrough();
+
   const std::string filePrefix_;
   const int32_t numShards_;
   std::vector<std::unique_ptr<SsdFile>> files_;
@@ -97,6 +119,13 @@ class SsdCache {
   std::unique_ptr<FileGroupStats> groupStats_;
   folly::Executor* executor_;
   std::atomic<bool> isShutdown_{false};
+
+  const int64_t maxWriteThroughBytes_;
+
+  // Serializes access to 'writeThroughPins_' and 'writeThroughBytes_'.
+  std::mutex writeThroughMutex_;
+  std::vector<CachePin> writeThroughPins_;
+  int64_t writeThroughBytes_{0};
 };
 
 } // namespace facebook::velox::cache
@@ -23,6 +23,8 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <cstring>
 #include <numeric>
 
 #include <fstream>
@@ -194,7 +196,9 @@ CoalesceIoStats SsdFile::load(
         entry->size(),
         "IOERR SSd cache entry shorter than requested range");
     payloadTotal += entry->size();
-    regionRead(regionIndex(ssdPins[i].run().offset()), runSize);
+    const auto offset = ssdPins[i].run().offset();
+    tracker_.regionRead(
+        regionIndex(offset), (offset % kRegionSize) / kHeatBucketSize, runSize);
     ++stats_.entriesRead;
     stats_.bytesRead += entry->size();
   }
@@ -287,13 +291,114 @@ bool SsdFile::growOrEvictLocked() {
     suspended_ = true;
     return false;
   }
+  auto hotRanges = readHotRangesLocked(candidates);
   logEviction(candidates);
   clearRegionEntriesLocked(candidates);
   writableRegions_ = std::move(candidates);
   suspended_ = false;
+  writeHotRangesLocked(hotRanges);
   return true;
 }
 
+std::vector<SsdFile::HotRange> SsdFile::readHotRangesLocked(
+    const std::vector<int32_t>& regions) {
+  // Index of a bucket in the file to the index of its range in 'ranges'.
+  folly::F14FastMap<int64_t, int32_t> bucketToRange;
+  std::vector<HotRange> ranges;
+  for (auto region : regions) {
+    const auto heat = tracker_.regionHeat(region);
+    for (auto bucket : tracker_.hotBuckets(region, kHotBucketRatio)) {
+      bucketToRange[region * SsdFileTracker::kNumHeatBuckets + bucket] =
+          ranges.size();
+      ranges.emplace_back();
+      ranges.back().heat = heat[bucket];
+    }
+  }
+  if (ranges.empty()) {
+    return ranges;
+  }
+  for (auto& [key, run] : entries_) {
+    auto it = bucketToRange.find(run.offset() / kHeatBucketSize);
+    if (it != bucketToRange.end()) {
+      ranges[it->second].entries.emplace_back(key, run);
+    }
+  }
+  std::sort(
+      ranges.begin(), ranges.end(), [](const auto& left, const auto& right) {
+        return left.heat > right.heat;
+      });
+
+  std::vector<HotRange> hotRanges;
+  uint64_t bytesLeft = kMaxRelocateBytes;
+  for (auto& range : ranges) {
+    if (range.entries.empty()) {
+      continue;
+    }
+    uint64_t begin = std::numeric_limits<uint64_t>::max();
+    uint64_t end = 0;
+    for (auto& [key, run] : range.entries) {
+      begin = std::min<uint64_t>(begin, run.offset());
+      end = std::max<uint64_t>(end, run.offset() + run.size());
+    }
+    // The region is a multiple of the alignment, so that the aligned range
+    // stays inside the region.
+    range.offset = begin - begin % kRelocateAlignment;
+    range.size = bits::roundUp(end, kRelocateAlignment) - range.offset;
+    if (range.size > bytesLeft) {
+      continue;
+    }
+    range.data.reset(
+        static_cast<char*>(aligned_alloc(kRelocateAlignment, range.size)));
+    if (!range.data) {
+      break;
+    }
+    auto rc = pread(fd_, range.data.get(), range.size, range.offset);
+    if (rc != range.size) {
+      LOG(ERROR) << "Failed to read hot entries from SSD " << errno;
+      continue;
+    }
+    bytesLeft -= range.size;
+    hotRanges.push_back(std::move(range));
+  }
+  return hotRanges;
+}
+
+void SsdFile::writeHotRangesLocked(std::vector<HotRange>& ranges) {
+  for (auto& range : ranges) {
+    std::optional<int32_t> region;
+    uint64_t regionOffset = 0;
+    for (auto writable : writableRegions_) {
+      regionOffset = bits::roundUp(regionSize_[writable], kRelocateAlignment);
+      if (regionOffset + range.size <= kRegionSize) {
+        region = writable;
+        break;
+      }
+    }
+    if (!region.has_value()) {
+      return;
+    }
+    const uint64_t offset = region.value() * kRegionSize + regionOffset;
+    auto rc = pwrite(fd_, range.data.get(), range.size, offset);
+    if (rc != range.size) {
+      LOG(ERROR) << "Failed to write hot entries to SSD " << errno;
+      return;
+    }
+    regionSize_[region.value()] = regionOffset + range.size;
+    for (auto& [key, run] : range.entries) {
+      SsdRun newRun(offset + run.offset() - range.offset, run.size());
+      if (checkpointIntervalBytes_) {
+        pendingLogEntries_.emplace_back(key, newRun);
+      }
+      entries_[std::move(key)] = newRun;
+      ++stats_.entriesRelocated;
+      stats_.bytesRelocated += run.size();
+    }
+    // The new location inherits the reads of the range.
+    tracker_.regionRead(
+        region.value(), regionOffset / kHeatBucketSize, range.heat);
+  }
+}
+
 void SsdFile::clearRegionEntriesLocked(
     const std::vector<int32_t>& regionIndices) {
   // Remove all 'entries_' where the dependent points one of 'regionIndices'.
@@ -307,6 +412,21 @@ void SsdFile::clearRegionEntriesLocked(
       ++it;
     }
   }
+  // The pending entries in the regions must not be logged after the eviction.
+  if (!pendingLogEntries_.empty()) {
+    pendingLogEntries_.erase(
+        std::remove_if(
+            pendingLogEntries_.begin(),
+            pendingLogEntries_.end(),
+            [&](const auto& pending) {
+              return std::find(
+                         regionIndices.begin(),
+                         regionIndices.end(),
+                         regionIndex(pending.second.offset())) !=
+                  regionIndices.end();
+            }),
+        pendingLogEntries_.end());
+  }
   for (auto region : regionIndices) {
     // While the region is being filled it may get score from
     // hits. When it is full, it will get a score boost to be a little
@@ -364,6 +484,9 @@ void SsdFile::write(std::vector<CachePin>& pins) {
         auto size = entry->size();
         FileCacheKey key = {
             entry->key().fileNum, static_cast<uint64_t>(entry->offset())};
+        if (checkpointIntervalBytes_) {
+          pendingLogEntries_.emplace_back(key, SsdRun(offset, size));
+        }
         entries_[std::move(key)] = SsdRun(offset, size);
         if (FLAGS_ssd_verify_write) {
           verifyWrite(*entry, SsdRun(offset, size));
@@ -431,6 +554,10 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   stats.bytesWritten += stats_.bytesWritten;
   stats.entriesRead += stats_.entriesRead;
   stats.bytesRead += stats_.bytesRead;
+  stats.numCheckpoints += stats_.numCheckpoints;
+  stats.numLogCheckpoints += stats_.numLogCheckpoints;
+  stats.entriesRelocated += stats_.entriesRelocated;
+  stats.bytesRelocated += stats_.bytesRelocated;
   stats.entriesCached += entries_.size();
   for (auto& regionSize : regionSize_) {
     stats.bytesCached += regionSize;
@@ -440,9 +567,22 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   }
 }
 
+std::vector<uint64_t> SsdFile::regionHeat(int32_t region) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return tracker_.regionHeat(region);
+}
+
+void SsdFile::addResidentFiles(ResidentFiles& files) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& [key, run] : entries_) {
+    files[key.fileNum.id()].ssdBytes += run.size();
+  }
+}
+
 void SsdFile::clear() {
   std::lock_guard<std::mutex> l(mutex_);
   entries_.clear();
+  pendingLogEntries_.clear();
   std::fill(regionSize_.begin(), regionSize_.end(), 0);
   writableRegions_.resize(numRegions_);
   std::iota(writableRegions_.begin(), writableRegions_.end(), 0);
@@ -465,6 +605,8 @@ void SsdFile::logEviction(const std::vector<int32_t>& regions) {
         evictLogFd_, regions.data(), regions.size() * sizeof(regions[0]));
     if (rc != regions.size() * sizeof(regions[0])) {
       checkpointError(rc, "Failed to log eviction");
+    } else {
+      logBytes_ += rc;
     }
   }
 }
@@ -484,6 +626,10 @@ void SsdFile::deleteCheckpoint(bool keepLog) {
     }
   }
   checkpointDeleted_ = true;
+  hasCheckpoint_ = false;
+  logBytes_ = 0;
+  pendingLogEntries_.clear();
+  loggedFileNums_.clear();
   auto logPath = fileName_ + kLogExtension;
   int32_t logRc = 0;
   if (!keepLog) {
@@ -523,6 +669,19 @@ void SsdFile::checkpoint(bool force) {
   }
   checkpointDeleted_ = false;
   bytesAfterCheckpoint_ = 0;
+  if (!force && hasCheckpoint_ &&
+      logBytes_ + pendingLogEntries_.size() * kLogEntryBytes <
+          entries_.size() * kCheckpointEntryBytes) {
+    try {
+      checkpointLogLocked();
+    } catch (const std::exception& e) {
+      try {
+        checkpointError(-1, e.what());
+      } catch (const std::exception& inner) {
+      }
+    }
+    return;
+  }
   try {
     // We schedule the potentially ;long fsync of the cache file on
     // another thread of the cache write executor, if available. If
@@ -584,7 +743,11 @@ void SsdFile::checkpoint(bool force) {
       checkRc(-1, "Writing checkpoint file");
     }
     state.close();
+    // The map has the pending entries, so that the log starts empty.
     ftruncate(evictLogFd_, 0);
+    logBytes_ = 0;
+    pendingLogEntries_.clear();
+    loggedFileNums_.clear();
     checkRc(fsync(evictLogFd_), "Sync of evict log");
     auto syncRc = sync->move();
     checkRc(*syncRc, fmt::format("Error in cache file fsync {}", *syncRc));
@@ -598,7 +761,8 @@ void SsdFile::checkpoint(bool force) {
       checkRc(fsync(fd), "Sync checkpoint file");
       close(fd);
     }
-
+    hasCheckpoint_ = true;
+    ++stats_.numCheckpoints;
   } catch (const std::exception& e) {
     try {
       checkpointError(-1, e.what());
@@ -608,6 +772,47 @@ void SsdFile::checkpoint(bool force) {
   }
 }
 
+void SsdFile::checkpointLogLocked() {
+  // The entries may only be logged after their data is on the device.
+  if (fsync(fd_) < 0) {
+    throw std::runtime_error(
+        fmt::format("Error in cache file fsync {}", errno));
+  }
+  std::string records;
+  records.reserve(pendingLogEntries_.size() * kLogEntryBytes);
+  auto append = [&](const auto& value) {
+    records.append(asChar(&value), sizeof(value));
+  };
+  for (auto& [key, run] : pendingLogEntries_) {
+    const uint64_t fileNum = key.fileNum.id();
+    if (loggedFileNums_.insert(fileNum).second) {
+      append(kLogFileTag);
+      append(fileNum);
+      const auto name = fileIds().string(fileNum);
+      const int32_t length = name.size();
+      append(length);
+      records.append(name);
+    }
+    append(kLogEntryTag);
+    append(fileNum);
+    append(key.offset);
+    append(run.bits());
+  }
+  pendingLogEntries_.clear();
+  if (!records.empty()) {
+    const auto rc = ::write(evictLogFd_, records.data(), records.size());
+    if (rc != records.size()) {
+      throw std::runtime_error(
+          fmt::format("Failed to append to checkpoint log with rc {}", rc));
+    }
+    logBytes_ += rc;
+  }
+  if (fsync(evictLogFd_) < 0) {
+    throw std::runtime_error("Sync of checkpoint log");
+  }
+  ++stats_.numLogCheckpoints;
+}
+
 void SsdFile::initializeCheckpoint() {
   if (!checkpointIntervalBytes_) {
     return;
@@ -619,7 +824,8 @@ void SsdFile::initializeCheckpoint() {
     LOG(INFO) << "Starting shard " << shardId_ << " without checkpoint";
   }
   auto logPath = fileName_ + kLogExtension;
-  evictLogFd_ = open(logPath.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  evictLogFd_ = open(
+      logPath.c_str(), O_CREAT | O_RDWR | O_APPEND, S_IRUSR | S_IWUSR);
   if (evictLogFd_ < 0) {
     // Failure to open the log at startup is a process terminating error.
     LOG(ERROR) << "Could not open evict log " << logPath << " rc "
@@ -631,6 +837,10 @@ void SsdFile::initializeCheckpoint() {
     if (hasCheckpoint) {
       state.exceptions(std::ifstream::failbit);
       readCheckpoint(state);
+      hasCheckpoint_ = true;
+    } else {
+      // A log without a checkpoint has nothing to apply to.
+      ftruncate(evictLogFd_, 0);
     }
   } catch (const std::exception& e) {
     try {
@@ -676,14 +886,6 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     auto lease = StringIdLease(fileIds(), name);
     idMap[id] = std::move(lease);
   }
-  auto logSize = lseek(evictLogFd_, 0, SEEK_END);
-  std::vector<uint32_t> evicted(logSize / sizeof(uint32_t));
-  auto rc = ::pread(evictLogFd_, evicted.data(), logSize, 0);
-  VELOX_CHECK_EQ(logSize, rc, "Failed to read eviction log");
-  std::unordered_set<uint32_t> evictedMap;
-  for (auto region : evicted) {
-    evictedMap.insert(region);
-  }
   for (;;) {
     uint64_t fileNum = readNumber<uint64_t>(state);
     if (fileNum == kCheckpointEndMarker) {
@@ -691,23 +893,29 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     }
     uint64_t offset = readNumber<uint64_t>(state);
     auto run = SsdRun(readNumber<uint64_t>(state));
-    // Check that the recovered entry does not fall in an evicted region.
-    if (evictedMap.find(regionIndex(run.offset())) == evictedMap.end()) {
-      // The file may have a different id on restore.
-      auto it = idMap.find(fileNum);
-      VELOX_CHECK(it != idMap.end());
-      FileCacheKey key{it->second, offset};
-      entries_[std::move(key)] = run;
-    }
+    // The file may have a different id on restore.
+    auto it = idMap.find(fileNum);
+    VELOX_CHECK(it != idMap.end());
+    FileCacheKey key{it->second, offset};
+    entries_[std::move(key)] = run;
   }
+  std::unordered_set<int32_t> evictedRegions;
+  readLog(idMap, evictedRegions);
   // The state is successfully read. Install the access frequency scores and
   // evicted regions.
   VELOX_CHECK_EQ(scores.size(), tracker_.regionScores().size());
-  // Set the writable regions by deduplicated evicted regions.
+  // Set the writable regions by deduplicated evicted regions. A region
+  // evicted after the checkpoint may have been partly refilled, so the
+  // region sizes are set from the recovered entries.
   writableRegions_.clear();
-  for (auto region : evictedMap) {
+  for (auto region : evictedRegions) {
     writableRegions_.push_back(region);
   }
+  for (auto& [key, run] : entries_) {
+    const auto region = regionIndex(run.offset());
+    regionSize_[region] = std::max<uint32_t>(
+        regionSize_[region], run.offset() + run.size() - region * kRegionSize);
+  }
   tracker_.setRegionScores(scores);
   LOG(INFO) << fmt::format(
       "Starting shard {} from checkpoint with {} entries, {} regions with {} free.",
@@ -717,4 +925,111 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
       writableRegions_.size());
 }
 
+void SsdFile::readLog(
+    std::unordered_map<uint64_t, StringIdLease>& idMap,
+    std::unordered_set<int32_t>& evictedRegions) {
+  const auto logSize = lseek(evictLogFd_, 0, SEEK_END);
+  std::string log(logSize, '\0');
+  auto rc = ::pread(evictLogFd_, log.data(), logSize, 0);
+  VELOX_CHECK_EQ(logSize, rc, "Failed to read eviction log");
+  logBytes_ = logSize;
+
+  struct LogEntry {
+    // Index of the record in the log.
+    int32_t index;
+    FileCacheKey key;
+    SsdRun run;
+  };
+  std::vector<LogEntry> logEntries;
+  // Index of the last record evicting each region.
+  std::unordered_map<int32_t, int32_t> lastEvictions;
+  int64_t position = 0;
+  int64_t validBytes = logSize;
+  auto read = [&](auto& value) {
+    if (position + sizeof(value) > logSize) {
+      return false;
+    }
+    memcpy(&value, log.data() + position, sizeof(value));
+    position += sizeof(value);
+    return true;
+  };
+  for (int32_t index = 0; position < logSize; ++index) {
+    // The appends are synced, so that only a crash during an append leaves a
+    // partial record at the end. The records before this are valid.
+    const auto recordStart = position;
+    int32_t tag;
+    uint64_t fileNum;
+    if (!read(tag)) {
+      validBytes = recordStart;
+      break;
+    }
+    if (tag >= 0) {
+      lastEvictions[tag] = index;
+      continue;
+    }
+    if (!read(fileNum)) {
+      validBytes = recordStart;
+      break;
+    }
+    if (tag == kLogFileTag) {
+      int32_t length;
+      if (!read(length) || position + length > logSize) {
+        validBytes = recordStart;
+        break;
+      }
+      idMap[fileNum] = StringIdLease(
+          fileIds(), std::string_view(log.data() + position, length));
+      position += length;
+      continue;
+    }
+    VELOX_CHECK_EQ(kLogEntryTag, tag, "Bad record in checkpoint log");
+    uint64_t offset;
+    uint64_t bits;
+    if (!read(offset) || !read(bits)) {
+      validBytes = recordStart;
+      break;
+    }
+    auto it = idMap.find(fileNum);
+    VELOX_CHECK(it != idMap.end());
+    SsdRun run(bits);
+    if (run.offset() + run.size() > fileSize_) {
+      continue;
+    }
+    logEntries.push_back(
+        LogEntry{index, FileCacheKey{it->second, offset}, run});
+  }
+  if (validBytes < logSize) {
+    LOG(WARNING) << "Dropping partial record at the end of checkpoint log of "
+                 << "shard " << shardId_;
+    // The next appends go after the valid records.
+    VELOX_CHECK_EQ(0, ftruncate(evictLogFd_, validBytes));
+    logBytes_ = validBytes;
+  }
+
+  // The entries of the checkpoint in a region evicted after the checkpoint
+  // are gone. The logged entries are valid if written after the last
+  // eviction of their region.
+  for (auto& pair : lastEvictions) {
+    evictedRegions.insert(pair.first);
+  }
+  if (!evictedRegions.empty()) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (evictedRegions.count(regionIndex(it->second.offset()))) {
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (auto& entry : logEntries) {
+    const auto region = regionIndex(entry.run.offset());
+    auto it = lastEvictions.find(region);
+    if (it == lastEvictions.end() || it->second < entry.index) {
+      entries_[std::move(entry.key)] = entry.run;
+      // The region may have been added after the checkpoint.
+      numRegions_ = std::max(numRegions_, region + 1);
+    }
+  }
+}
+
 } // namespace facebook::velox::cache
@@ -21,6 +21,8 @@
 #include "velox/common/file/File.h"
 
 #include <gflags/gflags.h>
+#include <unordered_map>
+#include <unordered_set>
 
 DECLARE_bool(ssd_odirect);
 DECLARE_bool(ssd_verify_write);
@@ -134,6 +136,10 @@ struct SsdCacheStats {
     entriesCached = tsanAtomicValue(other.entriesCached);
     bytesCached = tsanAtomicValue(other.bytesCached);
     numPins = tsanAtomicValue(other.numPins);
+    numCheckpoints = tsanAtomicValue(other.numCheckpoints);
+    numLogCheckpoints = tsanAtomicValue(other.numLogCheckpoints);
+    entriesRelocated = tsanAtomicValue(other.entriesRelocated);
+    bytesRelocated = tsanAtomicValue(other.bytesRelocated);
   }
 
   tsan_atomic<uint64_t> entriesWritten{0};
@@ -143,6 +149,14 @@ struct SsdCacheStats {
   tsan_atomic<uint64_t> entriesCached{0};
   tsan_atomic<uint64_t> bytesCached{0};
   tsan_atomic<int32_t> numPins{0};
+  // Number of full checkpoints that rewrote the entry map.
+  tsan_atomic<uint64_t> numCheckpoints{0};
+  // Number of incremental checkpoints that appended to the log.
+  tsan_atomic<uint64_t> numLogCheckpoints{0};
+  // Entries copied out of regions being evicted because they were in a hot
+  // part of the region.
+  tsan_atomic<uint64_t> entriesRelocated{0};
+  tsan_atomic<uint64_t> bytesRelocated{0};
 };
 
 // A shard of SsdCache. Corresponds to one file on SSD.  The data
@@ -152,7 +166,10 @@ struct SsdCacheStats {
 // count. Cache replacement takes place region by region, preferring
 // regions with a smaller read count. Entries do not span
 // regions. Otherwise entries are consecutive byte ranges inside
-// their region.
+// their region. Before a region is evicted, the entries in the parts
+// of the region that get most of its reads are copied to the space
+// that the eviction frees, so that a few hot entries in an otherwise
+// cold region stay cached.
 class SsdFile {
  public:
   static constexpr uint64_t kRegionSize = 1 << 26; // 64MB
@@ -207,6 +224,10 @@ class SsdFile {
     tracker_.regionRead(region, size);
   }
 
+  // Returns the reads of each of the SsdFileTracker::kNumHeatBuckets
+  // parts of 'region'. The counts decay over time like the region scores.
+  std::vector<uint64_t> regionHeat(int32_t region) const;
+
   int32_t maxRegions() const {
     return maxRegions_;
   }
@@ -218,6 +239,9 @@ class SsdFile {
   // Adds 'stats_' to 'stats'.
   void updateStats(SsdCacheStats& stats) const;
 
+  // Adds the sizes of 'entries_' to their files in 'files'.
+  void addResidentFiles(ResidentFiles& files) const;
+
   // Resets this' to a post-construction empty state. See SsdCache::clear().
   void clear();
 
@@ -228,6 +252,13 @@ class SsdFile {
   // checkpoint is serialized on 'mutex_'. If 'force' is false,
   // rechecks that at least 'checkpointIntervalBytes_' have been
   // written since last checkpoint and silently returns if not.
+  //
+  // A full checkpoint rewrites the whole entry map and truncates the
+  // log. Unless 'force' is true, a full checkpoint is only made if
+  // the log has grown larger than the map would be. Otherwise this
+  // makes an incremental checkpoint: syncs the cache file and then
+  // appends the entries written since the previous checkpoint to the
+  // log. Recovery replays the log on top of the last full checkpoint.
   void checkpoint(bool force = false);
 
  private:
@@ -239,6 +270,43 @@ class SsdFile {
   static constexpr int64_t kCheckpointMapMarker = 0xfffffffffffffffe;
   // Magic number at end of completed checkpoint file.
   static constexpr int64_t kCheckpointEndMarker = 0xcbedf11e;
+  // Bytes per entry in a checkpoint file: file id, offset and SsdRun.
+  static constexpr int32_t kCheckpointEntryBytes = 3 * sizeof(uint64_t);
+
+  // The log consists of int32_t record tags, each followed by the
+  // record. A non-negative tag is the index of an evicted region and
+  // has no other data. kLogFileTag is followed by a file id, the
+  // length of the file name and the name. This maps the file id for the
+  // following entry records. kLogEntryTag is followed by the file id,
+  // the offset in the file and the SsdRun of an entry written after
+  // the last full checkpoint.
+  static constexpr int32_t kLogFileTag = -1;
+  static constexpr int32_t kLogEntryTag = -2;
+  static constexpr int32_t kLogEntryBytes =
+      sizeof(int32_t) + kCheckpointEntryBytes;
+
+  // Size of the part of a region with a separate read count.
+  static constexpr uint64_t kHeatBucketSize =
+      kRegionSize / SsdFileTracker::kNumHeatBuckets;
+  // A heat bucket with this many times the reads of the average bucket of
+  // its region is copied out of the region before evicting the region.
+  static constexpr int32_t kHotBucketRatio = 4;
+  // Maximum bytes copied out of the regions evicted at one time.
+  static constexpr uint64_t kMaxRelocateBytes = kRegionSize / 4;
+  // Alignment of the offset and size of the copied ranges.
+  static constexpr uint64_t kRelocateAlignment = 4096;
+
+  // Consecutive data read from a hot part of a region that is being
+  // evicted, with the entries it contains.
+  struct HotRange {
+    // Offset of 'data' in the file.
+    uint64_t offset{0};
+    uint64_t size{0};
+    // Reads of the heat bucket of the range.
+    uint64_t heat{0};
+    std::unique_ptr<char, decltype(&free)> data{nullptr, &free};
+    std::vector<std::pair<FileCacheKey, SsdRun>> entries;
+  };
 
   // Increments the pin count of the region of 'offset'. Caller must hold
   // 'mutex_'.
@@ -263,6 +331,15 @@ class SsdFile {
   // added to 'writableRegions_'. Returns true if regions could be cleared.
   bool growOrEvictLocked();
 
+  // Reads the entries in the hot parts of 'regions', up to
+  // kMaxRelocateBytes, hottest first.
+  std::vector<HotRange> readHotRangesLocked(
+      const std::vector<int32_t>& regions);
+
+  // Writes 'ranges' to 'writableRegions_' and points their entries to the
+  // new location. Ranges that do not fit are dropped.
+  void writeHotRangesLocked(std::vector<HotRange>& ranges);
+
   // Reads the backing file with ReadFile::preadv().
   void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
 
@@ -278,6 +355,16 @@ class SsdFile {
   // deletes the checkpoint and leaves the log truncated open.
   void readCheckpoint(std::ifstream& state);
 
+  // Replays the log on top of the entries read from the checkpoint.
+  // 'idMap' maps the file ids in the checkpoint to the files. Sets
+  // 'evictedRegions' to the regions evicted after the checkpoint.
+  void readLog(
+      std::unordered_map<uint64_t, StringIdLease>& idMap,
+      std::unordered_set<int32_t>& evictedRegions);
+
+  // Makes an incremental checkpoint. See checkpoint(). Throws on error.
+  void checkpointLogLocked();
+
   // Logs an error message, deletes the checkpoint and stop making new
   // checkpoints.
   void checkpointError(int32_t rc, const std::string& error);
@@ -363,6 +450,20 @@ class SsdFile {
 
   // True if there was an error with checkpoint and the checkpoint was deleted.
   bool checkpointDeleted_{false};
+
+  // True if there is a full checkpoint that the log applies to.
+  bool hasCheckpoint_{false};
+
+  // Size of the log.
+  uint64_t logBytes_{0};
+
+  // Entries written since the last checkpoint. These are added to the
+  // log by the next incremental checkpoint, after the cache file is
+  // synced.
+  std::vector<std::pair<FileCacheKey, SsdRun>> pendingLogEntries_;
+
+  // Files that have a kLogFileTag record in the log.
+  std::unordered_set<uint64_t> loggedFileNums_;
 };
 
 } // namespace facebook::velox::cache
@@ -26,7 +26,41 @@ void SsdFileTracker::fileTouched(int32_t totalEntries) {
     for (auto& score : regionScores_) {
       score = (score * 15) / 16;
     }
+    for (auto& heat : heat_) {
+      heat = (heat * 15) / 16;
+    }
+  }
+}
+
+std::vector<uint64_t> SsdFileTracker::regionHeat(int32_t region) const {
+  std::vector<uint64_t> heat(kNumHeatBuckets);
+  for (auto i = 0; i < kNumHeatBuckets; ++i) {
+    heat[i] = tsanAtomicValue(heat_[region * kNumHeatBuckets + i]);
+  }
+  return heat;
+}
+
+std::vector<int32_t> SsdFileTracker::hotBuckets(
+    int32_t region,
+    int32_t minRatio) const {
+  const auto heat = regionHeat(region);
+  uint64_t total = 0;
+  for (auto bucketHeat : heat) {
+    total += bucketHeat;
+  }
+  std::vector<int32_t> buckets;
+  if (!total) {
+    return buckets;
+  }
+  for (auto i = 0; i < kNumHeatBuckets; ++i) {
+    if (heat[i] * kNumHeatBuckets >= total * minRatio) {
+      buckets.push_back(i);
+    }
   }
+  std::sort(buckets.begin(), buckets.end(), [&](int32_t left, int32_t right) {
+    return heat[left] > heat[right];
+  });
+  return buckets;
 }
 
 void SsdFileTracker::regionFilled(int32_t region) {
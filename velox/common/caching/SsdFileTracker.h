@@ -25,22 +25,45 @@
 namespace facebook::velox::cache {
 
 // Tracks reads on an SsdFile. Reads are counted for fixed size regions and
-// periodically decayed. Not thread safe, synchronization is the caller's
-// responsibility.
+// periodically decayed. Each region is further divided into
+// kNumHeatBuckets equal parts whose reads are counted separately, so
+// that the hot parts of an otherwise cold region can be found. Not
+// thread safe, synchronization is the caller's responsibility.
 class SsdFileTracker {
  public:
+  // Number of parts of a region with a separate read count.
+  static constexpr int32_t kNumHeatBuckets = 16;
+
   void resize(int32_t numRegions) {
     resizeTsanAtomic(regionScores_, numRegions);
+    resizeTsanAtomic(heat_, numRegions * kNumHeatBuckets);
   }
 
   void regionRead(int32_t region, int32_t bytes) {
     regionScores_[region] += bytes;
   }
 
+  // Records a read of 'bytes' from heat bucket 'bucket' of 'region'.
+  void regionRead(int32_t region, int32_t bucket, uint64_t bytes) {
+    regionScores_[region] += bytes;
+    heat_[region * kNumHeatBuckets + bucket] += bytes;
+  }
+
   void regionCleared(int32_t region) {
     regionScores_[region] = 0;
+    for (auto i = 0; i < kNumHeatBuckets; ++i) {
+      heat_[region * kNumHeatBuckets + i] = 0;
+    }
   }
 
+  // Returns the decayed read counts of the heat buckets of 'region'.
+  std::vector<uint64_t> regionHeat(int32_t region) const;
+
+  // Returns the heat buckets of 'region' with at least 'minRatio' times
+  // the reads of an average bucket of the region, hottest first. A region
+  // with no reads has no hot buckets.
+  std::vector<int32_t> hotBuckets(int32_t region, int32_t minRatio) const;
+
   // Marks that a region has been filled and transits from writable to
   // evictable. Set its score to be at least the best score +
   // a small margin so that it gets time to live. Otherwise it has had
@@ -89,6 +112,10 @@ class SsdFileTracker {
 
   std::vector<tsan_atomic<uint64_t>> regionScores_;
 
+  // Reads per heat bucket, kNumHeatBuckets consecutive buckets per region.
+  // Decayed together with 'regionScores_'.
+  std::vector<tsan_atomic<uint64_t>> heat_;
+
   // Count of lookups. The scores are decayed every time the count goes
   // over kDecayInterval or half count of cache entries, whichever comes first.
   uint64_t numTouches_{0};
@@ -16,6 +16,7 @@
 
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
+#include "velox/common/memory/MemoryArbitrator.h"
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
@@ -56,7 +57,10 @@ class AsyncDataCacheTest : public testing::Test {
     }
   }
 
-  void initializeCache(uint64_t maxBytes, int64_t ssdBytes = 0) {
+  void initializeCache(
+      uint64_t maxBytes,
+      int64_t ssdBytes = 0,
+      int64_t maxWriteThroughBytes = 0) {
     std::unique_ptr<SsdCache> ssdCache;
     if (ssdBytes) {
       // tmpfs does not support O_DIRECT, so turn this off for testing.
@@ -72,7 +76,8 @@ class AsyncDataCacheTest : public testing::Test {
           ssdBytes,
           4,
           executor(),
-          ssdBytes / 20);
+          ssdBytes / 20,
+          maxWriteThroughBytes);
     }
     memory::MmapAllocatorOptions options;
     options.capacity = maxBytes;
@@ -583,6 +588,248 @@ TEST_F(AsyncDataCacheTest, outOfCapacity) {
   EXPECT_EQ(4092, cache_->numAllocated());
 }
 
+TEST_F(AsyncDataCacheTest, numShards) {
+  memory::MmapAllocatorOptions options;
+  options.capacity = 16 << 20;
+  auto mappedMemory = std::make_shared<memory::MmapAllocator>(options);
+  EXPECT_EQ(
+      AsyncDataCache::defaultNumShards(),
+      AsyncDataCache(mappedMemory, 16 << 20).numShards());
+  EXPECT_EQ(4, AsyncDataCache(mappedMemory, 16 << 20, nullptr, 3).numShards());
+  EXPECT_EQ(
+      32, AsyncDataCache(mappedMemory, 16 << 20, nullptr, 32).numShards());
+  const auto numShards = AsyncDataCache::defaultNumShards();
+  EXPECT_LE(4, numShards);
+  EXPECT_GE(64, numShards);
+  EXPECT_EQ(numShards, bits::nextPowerOfTwo(numShards));
+}
+
+TEST_F(AsyncDataCacheTest, segmentedEviction) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 1 << 20;
+  constexpr int32_t kNumHot = 4;
+  memory::MmapAllocatorOptions options;
+  options.capacity = kMaxBytes;
+  auto mappedMemory = std::make_shared<memory::MmapAllocator>(options);
+  const auto fileNum = filenames_[0].id();
+
+  // Loads 'kNumHot' entries which are hit repeatedly and then scans through
+  // 4x the cache size of entries that are used once. Returns how many of the
+  // hot entries are still cached.
+  auto numHotRetained = [&](CacheEvictionPolicy policy) {
+    cache_ = std::make_shared<AsyncDataCache>(
+        mappedMemory, kMaxBytes, nullptr, 1, policy);
+    EXPECT_EQ(policy, cache_->evictionPolicy());
+    for (auto i = 0; i < kNumHot; ++i) {
+      auto pin = newEntry(i * kSize, kSize);
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+    for (auto hit = 0; hit < 2; ++hit) {
+      for (auto i = 0; i < kNumHot; ++i) {
+        auto pin = cache_->findOrCreate({fileNum, i * kSize}, kSize);
+        EXPECT_TRUE(pin.checkedEntry()->isShared());
+        EXPECT_EQ(
+            hit > 0 && policy == CacheEvictionPolicy::kSegmented,
+            pin.checkedEntry()->isProtected());
+      }
+    }
+    for (auto i = kNumHot; i < kNumHot + 64; ++i) {
+      auto pin = newEntry(i * kSize, kSize);
+      EXPECT_FALSE(pin.empty());
+      pin.checkedEntry()->setReadPct(10);
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+    int32_t numRetained = 0;
+    for (auto i = 0; i < kNumHot; ++i) {
+      numRetained += cache_->exists({fileNum, i * kSize});
+    }
+    return numRetained;
+  };
+
+  EXPECT_GT(kNumHot, numHotRetained(CacheEvictionPolicy::kClock));
+  EXPECT_EQ(kNumHot, numHotRetained(CacheEvictionPolicy::kSegmented));
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(kNumHot, stats.numProtected);
+
+  // The protected entries go when the cache must free all unpinned memory.
+  cache_->shrink(kMaxBytes);
+  EXPECT_EQ(0, cache_->cachedBytes());
+  EXPECT_EQ(0, cache_->refreshStats().numProtected);
+}
+
+TEST_F(AsyncDataCacheTest, lockFreeHit) {
+  constexpr int32_t kSize = 16 << 10;
+  initializeCache(16 << 20);
+  const RawFileCacheKey key{filenames_[0].id(), 0};
+  auto pin = newEntry(0, kSize);
+  pin.checkedEntry()->setExclusiveToShared();
+
+  // The first hit takes the shard mutex and is not counted since the entry is
+  // prefetched. The next hits on the pinned entry don't take the mutex.
+  auto hitPin = cache_->findOrCreate(key, kSize);
+  ASSERT_EQ(pin.entry(), hitPin.entry());
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(0, stats.numLockFreeHit);
+  for (auto i = 0; i < 10; ++i) {
+    ASSERT_EQ(pin.entry(), cache_->findOrCreate(key, kSize).entry());
+  }
+  stats = cache_->refreshStats();
+  EXPECT_EQ(10, stats.numLockFreeHit);
+  EXPECT_EQ(10, stats.numHit);
+  EXPECT_EQ(2, pin.entry()->numPins());
+
+  // A hit on an unpinned entry takes the mutex.
+  hitPin.clear();
+  pin.clear();
+  pin = cache_->findOrCreate(key, kSize);
+  ASSERT_FALSE(pin.empty());
+  stats = cache_->refreshStats();
+  EXPECT_EQ(10, stats.numLockFreeHit);
+  EXPECT_EQ(11, stats.numHit);
+
+  // A request for a larger entry supersedes the pinned entry.
+  auto largerPin = cache_->findOrCreate(key, kSize * 2);
+  ASSERT_FALSE(largerPin.empty());
+  EXPECT_NE(pin.entry(), largerPin.entry());
+  EXPECT_TRUE(largerPin.entry()->isExclusive());
+  largerPin.checkedEntry()->setExclusiveToShared();
+  EXPECT_EQ(largerPin.entry(), cache_->findOrCreate(key, kSize).entry());
+  EXPECT_EQ(largerPin.entry(), cache_->findOrCreate(key, kSize).entry());
+  stats = cache_->refreshStats();
+  EXPECT_EQ(11, stats.numLockFreeHit);
+}
+
+TEST_F(AsyncDataCacheTest, lockFreeHitWithEviction) {
+  constexpr int32_t kSize = 16 << 10;
+  constexpr int32_t kNumKeys = 8;
+  initializeCache(16 << 20);
+  const auto fileNum = filenames_[0].id();
+  std::atomic<bool> stop{false};
+  std::thread evictThread([&]() {
+    while (!stop) {
+      cache_->clear();
+      std::this_thread::yield();
+    }
+  });
+  runThreads(16, [&](int32_t threadIndex) {
+    std::vector<CachePin> pins;
+    for (auto i = 0; i < 20'000; ++i) {
+      const uint64_t offset = ((i + threadIndex) % kNumKeys) * kSize;
+      auto pin = cache_->findOrCreate({fileNum, offset}, kSize);
+      if (pin.empty()) {
+        continue;
+      }
+      auto* entry = pin.checkedEntry();
+      if (entry->isExclusive()) {
+        entry->setExclusiveToShared();
+      }
+      ASSERT_EQ(fileNum, entry->key().fileNum.id());
+      ASSERT_EQ(offset, entry->offset());
+      ASSERT_LE(kSize, entry->size());
+      // Keep a few pins so that some hits find pinned entries.
+      pins.push_back(std::move(pin));
+      if (pins.size() > 4) {
+        pins.erase(pins.begin());
+      }
+    }
+  });
+  stop = true;
+  evictThread.join();
+  EXPECT_LT(0, cache_->refreshStats().numLockFreeHit);
+}
+
+TEST_F(AsyncDataCacheTest, residentFiles) {
+  constexpr int32_t kSize = 64 << 10;
+  initializeCache(16 << 20);
+  EXPECT_TRUE(cache_->residentFiles().empty());
+  for (auto i = 0; i < 4; ++i) {
+    auto pin = newEntry(i * kSize, kSize);
+    ASSERT_FALSE(pin.empty());
+    pin.checkedEntry()->setGroupId(11);
+    pin.checkedEntry()->setExclusiveToShared();
+  }
+  // An entry that is still loading is not counted.
+  auto loading = newEntry(4 * kSize, kSize);
+
+  auto files = cache_->residentFiles();
+  ASSERT_EQ(1, files.size());
+  const auto& file = files.at(filenames_[0].id());
+  EXPECT_EQ(11, file.groupId);
+  EXPECT_EQ(4 * kSize, file.ramBytes);
+  EXPECT_EQ(0, file.ssdBytes);
+  EXPECT_EQ("testing_file_0", fileIds().string(filenames_[0].id()));
+
+  loading.clear();
+  cache_->clear();
+  EXPECT_TRUE(cache_->residentFiles().empty());
+}
+
+TEST_F(AsyncDataCacheTest, shrink) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  constexpr int32_t kNumEntries = 64;
+  initializeCache(kMaxBytes);
+  CachePin pinned;
+  for (auto i = 0; i < kNumEntries; ++i) {
+    auto pin = newEntry(i * kSize, kSize);
+    ASSERT_FALSE(pin.empty());
+    pin.checkedEntry()->setExclusiveToShared();
+    if (i == 0) {
+      pinned = std::move(pin);
+    }
+  }
+  ASSERT_EQ(kNumEntries * kSize, cache_->cachedBytes());
+
+  auto freed = cache_->shrink(kSize * 4);
+  EXPECT_LE(kSize * 4, freed);
+  EXPECT_EQ(kNumEntries * kSize - freed, cache_->cachedBytes());
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(1, stats.numShrinks);
+  EXPECT_EQ(freed, stats.shrunkBytes);
+
+  // The pinned entry stays.
+  const auto remaining = cache_->cachedBytes();
+  EXPECT_EQ(remaining - kSize, cache_->shrink(kMaxBytes));
+  EXPECT_EQ(kSize, cache_->cachedBytes());
+  stats = cache_->refreshStats();
+  EXPECT_EQ(2, stats.numShrinks);
+  EXPECT_EQ(kNumEntries * kSize - kSize, stats.shrunkBytes);
+  EXPECT_EQ(0, cache_->shrink(kMaxBytes));
+  pinned.clear();
+  EXPECT_EQ(kSize, cache_->shrink(kMaxBytes));
+  EXPECT_EQ(0, cache_->cachedBytes());
+}
+
+TEST_F(AsyncDataCacheTest, shrinkForQueries) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 1 << 20;
+  initializeCache(kMaxBytes);
+  for (auto i = 0; i < 12; ++i) {
+    auto pin = newEntry(i * kSize, kSize);
+    ASSERT_FALSE(pin.empty());
+    pin.checkedEntry()->setExclusiveToShared();
+  }
+  ASSERT_EQ(12 * kSize, cache_->cachedBytes());
+
+  // The cache uses the capacity left over by the queries and yields it when a
+  // query needs it.
+  memory::MemoryArbitrator::Config config;
+  config.capacity = kMaxBytes;
+  config.minGrowBytes = kSize;
+  memory::MemoryArbitrator arbitrator(config);
+  arbitrator.setCache(
+      [&]() { return cache_->cachedBytes(); },
+      [&](int64_t targetBytes) { return cache_->shrink(targetBytes); });
+  auto query = memory::MemoryUsageTracker::create();
+  arbitrator.addQuery(query);
+  query->addChild()->update(8 * kSize);
+  EXPECT_EQ(8 * kSize, query->maxTotalBytes());
+  EXPECT_GE(8 * kSize, cache_->cachedBytes());
+  EXPECT_EQ(1, arbitrator.stats().numCacheShrinks);
+  EXPECT_LE(4 * kSize, arbitrator.stats().cacheShrunkBytes);
+  EXPECT_EQ(1, cache_->refreshStats().numShrinks);
+}
+
 namespace {
 // Cuts off the last 1/10th of file at 'path'.
 void corruptFile(const std::string& path) {
@@ -671,3 +918,35 @@ TEST_F(AsyncDataCacheTest, ssd) {
   // since one of the shards was deliberately corrupted, is a safe bet.
   ASSERT_LT(kSsdBytes / 2, stats2.bytesRead);
 }
+
+TEST_F(AsyncDataCacheTest, ssdWriteThrough) {
+  constexpr uint64_t kRamBytes = 32 << 20;
+  constexpr uint64_t kSsdBytes = 256UL << 20;
+  constexpr uint64_t kLoadBytes = 4 << 20;
+  initializeCache(kRamBytes, kSsdBytes);
+  cache_->setVerifyHook(
+      [&](const AsyncDataCacheEntry& entry) { checkContents(entry); });
+
+  // The loaded entries are too few to start a save from RAM.
+  loadLoop(0, kLoadBytes);
+  cache_->ssdCache()->shutdown();
+  ASSERT_EQ(0, cache_->ssdCache()->stats().bytesWritten);
+
+  // With write-through, the entries are written as they are loaded.
+  initializeCache(kRamBytes, kSsdBytes, 8 << 20);
+  cache_->setVerifyHook(
+      [&](const AsyncDataCacheEntry& entry) { checkContents(entry); });
+  loadLoop(0, kLoadBytes);
+  cache_->ssdCache()->shutdown();
+  auto stats = cache_->ssdCache()->stats();
+  ASSERT_LT(kLoadBytes / 2, stats.bytesWritten);
+  ASSERT_EQ(0, stats.numPins);
+  auto ramStats = cache_->refreshStats();
+  ASSERT_EQ(0, ramStats.numShared);
+  ASSERT_EQ(0, ramStats.numExclusive);
+
+  // The entries are read back from SSD after clearing RAM.
+  cache_->clear();
+  loadLoop(0, kLoadBytes);
+  ASSERT_LT(kLoadBytes / 2, cache_->ssdCache()->stats().bytesRead);
+}
@@ -224,3 +224,35 @@ TEST(CachedFactoryTest, retrievedCached) {
   }
   ASSERT_EQ(*generated, 5);
 }
+
+TEST(CachedFactoryTest, expiration) {
+  auto generator = std::make_unique<DoublerGenerator>();
+  auto* generated = &generator->generated_;
+  bool expired = false;
+  CachedFactory<int, int, DoublerGenerator> factory(
+      std::make_unique<SimpleLRUCache<int, int>>(1000),
+      std::move(generator),
+      [&](const int& /*value*/) { return expired; });
+  factory.generate(1);
+  ASSERT_TRUE(factory.generate(1).wasCached());
+  ASSERT_EQ(*generated, 1);
+
+  expired = true;
+  {
+    // An expired value in use elsewhere is returned until it is released.
+    auto first = factory.generate(1);
+    ASSERT_FALSE(first.wasCached());
+    ASSERT_EQ(*generated, 2);
+    auto second = factory.generate(1);
+    ASSERT_TRUE(second.wasCached());
+    ASSERT_EQ(*generated, 2);
+  }
+  ASSERT_FALSE(factory.generate(1).wasCached());
+  ASSERT_EQ(*generated, 3);
+
+  expired = false;
+  auto value = factory.generate(1);
+  ASSERT_TRUE(value.wasCached());
+  ASSERT_EQ(*value, 2);
+  ASSERT_EQ(*generated, 3);
+}
@@ -158,3 +158,21 @@ TEST(SimpleLRUCache, insertLargerThanCacheFails) {
   ASSERT_FALSE(cache.add(123, value, 11));
   delete value;
 }
+
+TEST(SimpleLRUCache, erase) {
+  SimpleLRUCache<int, int> cache(1000);
+  ASSERT_TRUE(cache.add(1, new int(11), 10));
+  ASSERT_TRUE(cache.addPinned(2, new int(22), 20));
+  ASSERT_EQ(cache.currentSize(), 30);
+
+  ASSERT_TRUE(cache.erase(1));
+  ASSERT_EQ(cache.get(1), nullptr);
+  ASSERT_FALSE(cache.erase(1));
+  ASSERT_EQ(cache.currentSize(), 20);
+
+  // A pinned value stays.
+  ASSERT_FALSE(cache.erase(2));
+  cache.release(2);
+  ASSERT_TRUE(cache.erase(2));
+  ASSERT_EQ(cache.currentSize(), 0);
+}
@@ -47,7 +47,10 @@ class SsdFileTest : public testing::Test {
     }
   }
 
-  void initializeCache(int64_t maxBytes, int64_t ssdBytes = 0) {
+  void initializeCache(
+      int64_t maxBytes,
+      int64_t ssdBytes = 0,
+      int64_t checkpointIntervalBytes = 0) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_ssd_odirect = false;
     cache_ = std::make_shared<AsyncDataCache>(
@@ -56,10 +59,17 @@ class SsdFileTest : public testing::Test {
     fileName_ = StringIdLease(fileIds(), "fileInStorage");
 
     tempDirectory_ = exec::test::TempDirectoryPath::create();
+    openFile(ssdBytes, checkpointIntervalBytes);
+  }
+
+  // Opens the SsdFile in 'tempDirectory_'. Recovers the state from a
+  // checkpoint if there is one and 'checkpointIntervalBytes' is non-0.
+  void openFile(int64_t ssdBytes, int64_t checkpointIntervalBytes = 0) {
     ssdFile_ = std::make_unique<SsdFile>(
         fmt::format("{}/ssdtest", tempDirectory_->path),
         0,
-        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize);
+        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize,
+        checkpointIntervalBytes);
   }
 
   static void initializeContents(
@@ -295,3 +305,105 @@ TEST_F(SsdFileTest, writeAndRead) {
     }
   }
 }
+
+TEST_F(SsdFileTest, checkpointLog) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  constexpr int32_t kEntrySize = 64 << 10;
+  initializeCache(128 * kMB, kSsdSize, kMB);
+  std::vector<TestEntry> allEntries;
+  auto write = [&](uint64_t startOffset, int64_t bytes) {
+    auto pins = makePins(
+        fileName_.id(), startOffset, kEntrySize, kEntrySize, bytes);
+    ssdFile_->write(pins);
+    for (auto& pin : pins) {
+      ASSERT_EQ(ssdFile_.get(), pin.entry()->ssdFile());
+      allEntries.emplace_back(
+          pin.entry()->key(), pin.entry()->ssdOffset(), pin.entry()->size());
+    }
+  };
+
+  // The first checkpoint is full since there is no checkpoint for a log.
+  write(0, 16 * kMB);
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(1, stats.numCheckpoints);
+  ssdFile_->checkpoint(true);
+  stats = SsdCacheStats();
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(2, stats.numCheckpoints);
+  EXPECT_EQ(0, stats.numLogCheckpoints);
+
+  // The writes after the full checkpoint are small compared to the
+  // checkpointed map and are appended to the log.
+  for (auto i = 0; i < 4; ++i) {
+    write(16 * kMB + i * 2 * kMB, 2 * kMB);
+  }
+  stats = SsdCacheStats();
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(2, stats.numCheckpoints);
+  EXPECT_EQ(4, stats.numLogCheckpoints);
+
+  // The entries of the checkpoint and the log are recovered on restart.
+  cache_->clear();
+  openFile(kSsdSize, kMB);
+  stats = SsdCacheStats();
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(allEntries.size(), stats.entriesCached);
+  for (auto& entry : allEntries) {
+    auto pin =
+        ssdFile_->find(RawFileCacheKey{fileName_.id(), entry.key.offset});
+    ASSERT_FALSE(pin.empty());
+    EXPECT_EQ(entry.ssdOffset, pin.run().offset());
+    EXPECT_EQ(entry.size, pin.run().size());
+  }
+  readAndCheckPins(
+      makePins(fileName_.id(), 16 * kMB, kEntrySize, kEntrySize, 8 * kMB));
+
+  // New writes do not overwrite the recovered entries.
+  write(24 * kMB, 2 * kMB);
+  EXPECT_LE(
+      allEntries[allEntries.size() - 33].ssdOffset + kEntrySize,
+      allEntries.back().ssdOffset);
+}
+
+TEST_F(SsdFileTest, relocateHotEntries) {
+  constexpr int64_t kSsdSize = 2 * SsdFile::kRegionSize;
+  constexpr int32_t kEntrySize = 1 << 20;
+  initializeCache(128 * kMB, kSsdSize);
+  auto write = [&](uint64_t startOffset, int64_t bytes) {
+    auto pins = makePins(
+        fileName_.id(), startOffset, kEntrySize, kEntrySize, bytes);
+    ssdFile_->write(pins);
+  };
+  auto read = [&](uint64_t startOffset, int64_t bytes) {
+    cache_->clear();
+    readAndCheckPins(
+        makePins(fileName_.id(), startOffset, kEntrySize, kEntrySize, bytes));
+  };
+
+  // Fills both regions. The first region is cold except for its first 4
+  // entries.
+  write(0, 64 * kMB);
+  write(64 * kMB, 64 * kMB);
+  read(0, 4 * kMB);
+  read(64 * kMB, 64 * kMB);
+  auto heat = ssdFile_->regionHeat(0);
+  EXPECT_EQ(4 * kMB, heat[0]);
+  EXPECT_EQ(0, heat[1]);
+
+  // A new write evicts the first region. The hot entries are copied to the
+  // space freed by the eviction.
+  write(128 * kMB, 8 * kMB);
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(4, stats.entriesRelocated);
+  EXPECT_EQ(4 * kMB, stats.bytesRelocated);
+  for (auto i = 0; i < 64; ++i) {
+    EXPECT_EQ(
+        i < 4,
+        !ssdFile_->find(RawFileCacheKey{fileName_.id(), i * kMB}).empty());
+  }
+  EXPECT_EQ(4 * kMB, ssdFile_->regionHeat(0)[0]);
+  read(0, 4 * kMB);
+  read(128 * kMB, 8 * kMB);
+}
@@ -49,3 +49,30 @@ TEST(SsdFileTrackerTest, tracker) {
   std::vector<int32_t> expected{0, 1, 4, 5, 6, 7, 8, 9};
   EXPECT_EQ(candidates, expected);
 }
+
+TEST(SsdFileTrackerTest, heat) {
+  constexpr int32_t kNumRegions = 4;
+  SsdFileTracker tracker;
+  tracker.resize(kNumRegions);
+  EXPECT_TRUE(tracker.hotBuckets(1, 4).empty());
+  for (auto bucket = 0; bucket < SsdFileTracker::kNumHeatBuckets; ++bucket) {
+    tracker.regionRead(1, bucket, 1000);
+  }
+  tracker.regionRead(1, 3, 100000);
+  tracker.regionRead(1, 7, 50000);
+  EXPECT_EQ(16 * 1000 + 150000, tsanAtomicValue(tracker.regionScores()[1]));
+  auto heat = tracker.regionHeat(1);
+  ASSERT_EQ(SsdFileTracker::kNumHeatBuckets, heat.size());
+  EXPECT_EQ(1000, heat[0]);
+  EXPECT_EQ(101000, heat[3]);
+  EXPECT_EQ(51000, heat[7]);
+
+  // The buckets with at least 4x the average reads, hottest first.
+  EXPECT_EQ(std::vector<int32_t>({3, 7}), tracker.hotBuckets(1, 4));
+  EXPECT_EQ(std::vector<int32_t>({3}), tracker.hotBuckets(1, 8));
+  EXPECT_TRUE(tracker.hotBuckets(0, 4).empty());
+
+  tracker.regionCleared(1);
+  EXPECT_EQ(0, tsanAtomicValue(tracker.regionScores()[1]));
+  EXPECT_TRUE(tracker.hotBuckets(1, 1).empty());
+}
@@ -73,8 +73,23 @@ uint64_t InMemoryWriteFile::size() const {
   return file_->size();
 }
 
-LocalReadFile::LocalReadFile(std::string_view path) : path_(path) {
-  fd_ = open(path_.c_str(), O_RDONLY);
+namespace {
+int32_t directIoFlag(bool directIo) {
+#ifdef O_DIRECT
+  return directIo ? O_DIRECT : 0;
+#else
+  VELOX_CHECK(!directIo, "O_DIRECT is not supported");
+  return 0;
+#endif
+}
+} // namespace
+
+LocalReadFile::LocalReadFile(
+    std::string_view path,
+    bool directIo,
+    folly::Executor* executor)
+    : path_(path), directIo_(directIo), executor_(executor) {
+  fd_ = open(path_.c_str(), O_RDONLY | directIoFlag(directIo_));
   VELOX_CHECK_GE(
       fd_,
       0,
@@ -93,7 +108,11 @@ LocalReadFile::LocalReadFile(std::string_view path) : path_(path) {
   size_ = rc;
 }
 
-LocalReadFile::LocalReadFile(int32_t fd) : fd_(fd) {}
+LocalReadFile::LocalReadFile(
+    int32_t fd,
+    bool directIo,
+    folly::Executor* executor)
+    : fd_(fd), directIo_(directIo), executor_(executor) {}
 
 LocalReadFile::~LocalReadFile() {
   const int ret = close(fd_);
@@ -106,6 +125,13 @@ LocalReadFile::~LocalReadFile() {
 void LocalReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   bytesRead_ += length;
+  if (directIo_ &&
+      (offset | length | reinterpret_cast<uintptr_t>(pos)) %
+              kDirectIoAlignment !=
+          0) {
+    preadDirect(offset, length, {folly::Range<char*>(pos, length)});
+    return;
+  }
   auto bytesRead = ::pread(fd_, pos, length, offset);
   VELOX_CHECK_EQ(
       bytesRead,
@@ -127,6 +153,13 @@ uint64_t LocalReadFile::preadv(
   // Dropped bytes sized so that a typical dropped range of 50K is not
   // too many iovecs.
   static thread_local std::vector<char> droppedBytes(16 * 1024);
+  if (directIo_) {
+    uint64_t length = 0;
+    for (auto& range : buffers) {
+      length += range.size();
+    }
+    return preadDirect(offset, length, buffers);
+  }
   std::vector<struct iovec> iovecs;
   iovecs.reserve(buffers.size());
   for (auto& range : buffers) {
@@ -144,6 +177,46 @@ uint64_t LocalReadFile::preadv(
   return folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
 }
 
+uint64_t LocalReadFile::preadDirect(
+    uint64_t offset,
+    uint64_t length,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  const uint64_t begin = offset - offset % kDirectIoAlignment;
+  const uint64_t end = (offset + length + kDirectIoAlignment - 1) /
+      kDirectIoAlignment * kDirectIoAlignment;
+  std::unique_ptr<char, decltype(&free)> buffer(
+      static_cast<char*>(aligned_alloc(kDirectIoAlignment, end - begin)),
+      &free);
+  VELOX_CHECK_NOT_NULL(buffer.get(), "Failed to allocate {}", end - begin);
+  // The read may stop at the end of the file, which need not be aligned.
+  const auto bytesRead = ::pread(fd_, buffer.get(), end - begin, begin);
+  VELOX_CHECK_GE(
+      bytesRead,
+      static_cast<int64_t>(offset + length - begin),
+      "pread failure in LocalReadFile::preadDirect, {}",
+      folly::errnoStr(errno));
+  auto source = buffer.get() + (offset - begin);
+  for (auto& range : buffers) {
+    if (range.data()) {
+      memcpy(range.data(), source, range.size());
+    }
+    source += range.size();
+  }
+  return length;
+}
+
+folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (!executor_) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  return folly::via(
+             executor_,
+             [this, offset, buffers]() { return preadv(offset, buffers); })
+      .semi();
+}
+
 uint64_t LocalReadFile::size() const {
   return size_;
 }
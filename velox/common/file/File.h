@@ -33,6 +33,7 @@
 #include <string>
 #include <string_view>
 
+#include <folly/Executor.h>
 #include <folly/Range.h>
 #include <folly/futures/Future.h>
 
@@ -201,11 +202,26 @@ class InMemoryWriteFile final : public WriteFile {
 // internal arenaing), as local disk writes are expected to be cheap. Local
 // files match against any filepath starting with '/'.
 
+//
+// With 'directIo', the file is read with O_DIRECT, bypassing the OS page
+// cache. This avoids caching the data twice when the reader caches it, e.g. in
+// AsyncDataCache. Reads are then widened to kDirectIoAlignment boundaries
+// with a bounce buffer if the offsets, sizes or buffers are not aligned. If
+// 'executor' is set, preadvAsync() reads on 'executor'.
 class LocalReadFile final : public ReadFile {
  public:
-  explicit LocalReadFile(std::string_view path);
+  static constexpr uint64_t kDirectIoAlignment = 4096;
+
+  explicit LocalReadFile(
+      std::string_view path,
+      bool directIo = false,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
-  explicit LocalReadFile(int32_t fd);
+  // Reads from 'fd'. 'directIo' must be true if 'fd' is opened with O_DIRECT.
+  explicit LocalReadFile(
+      int32_t fd,
+      bool directIo = false,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
   ~LocalReadFile();
 
@@ -218,10 +234,19 @@ class LocalReadFile final : public ReadFile {
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final {
+    return executor_ != nullptr;
+  }
+
   uint64_t memoryUsage() const final;
 
+  // Direct reads of nearby ranges are better done in one IO.
   bool shouldCoalesce() const final {
-    return false;
+    return directIo_;
   }
 
   std::string getName() const override {
@@ -239,9 +264,19 @@ class LocalReadFile final : public ReadFile {
   void preadInternal(uint64_t offset, uint64_t length, char* FOLLY_NONNULL pos)
       const;
 
+  // Reads [offset, offset + length) with O_DIRECT into an aligned buffer and
+  // copies it into 'buffers'. Ranges of 'buffers' with nullptr data are
+  // skipped.
+  uint64_t preadDirect(
+      uint64_t offset,
+      uint64_t length,
+      const std::vector<folly::Range<char*>>& buffers) const;
+
   std::string path_;
   int32_t fd_;
   long size_;
+  const bool directIo_;
+  folly::Executor* const FOLLY_NULLABLE executor_;
 };
 
 class LocalWriteFile final : public WriteFile {
@@ -20,9 +20,16 @@
 #include "velox/common/file/File.h"
 #include "velox/core/Context.h"
 
+#include <gflags/gflags.h>
+
 #include <cstdio>
 #include <filesystem>
 
+DEFINE_bool(
+    local_file_direct_io,
+    false,
+    "Read local files with O_DIRECT, bypassing the OS page cache");
+
 namespace facebook::velox::filesystems {
 
 namespace {
@@ -84,7 +91,8 @@ class LocalFileSystem : public FileSystem {
   }
 
   std::unique_ptr<ReadFile> openFileForRead(std::string_view path) override {
-    return std::make_unique<LocalReadFile>(extractPath(path));
+    return std::make_unique<LocalReadFile>(
+        extractPath(path), FLAGS_local_file_direct_io);
   }
 
   std::unique_ptr<WriteFile> openFileForWrite(std::string_view path) override {
@@ -46,7 +46,7 @@ DECLARE_int32(measurement_size);
 
 namespace facebook::velox {
 
-enum class Mode { Pread = 0, Preadv = 1, Multiple = 2 };
+enum class Mode { Pread = 0, Preadv = 1, Multiple = 2, PreadvAsync = 3 };
 
 // Struct to read data into. If we read contiguous and then copy to
 // non-contiguous buffers, we read to 'buffer' and copy to
@@ -81,7 +81,10 @@ class ReadBenchmark {
         LOG(ERROR) << "Could not open " << FLAGS_path;
         exit(1);
       }
-      readFile_ = std::make_unique<LocalReadFile>(fd_);
+      // Unaligned reads go through an aligned buffer. preadvAsync() reads on
+      // 'executor_'.
+      readFile_ =
+          std::make_unique<LocalReadFile>(fd_, o_direct != 0, executor_.get());
 
     } else {
       filesystems::registerLocalFileSystem();
@@ -142,6 +145,9 @@ class ReadBenchmark {
     clearCache();
     std::vector<folly::Promise<bool>> promises;
     std::vector<folly::SemiFuture<bool>> futures;
+    // Buffers and results of Mode::PreadvAsync.
+    std::vector<std::unique_ptr<char[]>> asyncBuffers;
+    std::vector<folly::SemiFuture<uint64_t>> asyncReads;
     uint64_t usec = 0;
     std::string label;
     {
@@ -227,6 +233,22 @@ class ReadBenchmark {
 
             break;
           }
+          case Mode::PreadvAsync: {
+            // All reads are issued before waiting for any. The reads are
+            // concurrent if the file has an asynchronous preadvAsync().
+            label = "preadvAsync";
+            asyncBuffers.push_back(std::make_unique<char[]>(rangeSize));
+            std::vector<folly::Range<char*>> ranges;
+            for (auto start = 0; start < rangeSize; start += size + gap) {
+              ranges.push_back(
+                  folly::Range<char*>(asyncBuffers.back().get() + start, size));
+              if (gap && start + gap < rangeSize) {
+                ranges.push_back(folly::Range<char*>(nullptr, gap));
+              }
+            }
+            asyncReads.push_back(readFile_->preadvAsync(offset, ranges));
+            break;
+          }
           case Mode::Multiple: {
             label = "multiple pread";
             if (parallel) {
@@ -264,6 +286,9 @@ class ReadBenchmark {
           std::move(futures[i]).via(&exec).wait();
         }
       }
+      for (auto& read : asyncReads) {
+        std::move(read).get();
+      }
     }
     std::cout << fmt::format(
                      "{} MB/s {} {}",
@@ -286,6 +311,7 @@ class ReadBenchmark {
     randomReads(size, gap, count, repeats, Mode::Pread, false);
     randomReads(size, gap, count, repeats, Mode::Preadv, false);
     randomReads(size, gap, count, repeats, Mode::Multiple, false);
+    randomReads(size, gap, count, repeats, Mode::PreadvAsync, false);
     randomReads(size, gap, count, repeats, Mode::Pread, true);
     randomReads(size, gap, count, repeats, Mode::Preadv, true);
     randomReads(size, gap, count, repeats, Mode::Multiple, true);
@@ -15,6 +15,7 @@
  */
 
 #include <fcntl.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
@@ -98,6 +99,41 @@ TEST(LocalFile, writeAndRead) {
   readData(&readFile);
 }
 
+TEST(LocalFile, directIoAndAsync) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  folly::CPUThreadPoolExecutor executor(2);
+  for (auto directIo : {false, true}) {
+    SCOPED_TRACE(directIo);
+    std::unique_ptr<LocalReadFile> readFile;
+    try {
+      readFile =
+          std::make_unique<LocalReadFile>(filename, directIo, &executor);
+    } catch (const VeloxException& e) {
+      // E.g. tmpfs does not support O_DIRECT.
+      GTEST_SKIP() << "Cannot open with O_DIRECT: " << e.message();
+    }
+    // The reads are not aligned for O_DIRECT.
+    readData(readFile.get());
+
+    ASSERT_TRUE(readFile->hasPreadvAsync());
+    char head[7];
+    char tail[3];
+    std::vector<folly::Range<char*>> buffers = {
+        folly::Range<char*>(head, sizeof(head)),
+        folly::Range<char*>(nullptr, kOneMB),
+        folly::Range<char*>(tail, sizeof(tail))};
+    ASSERT_EQ(kOneMB + 10, readFile->preadvAsync(3, buffers).get());
+    ASSERT_EQ(std::string_view(head, sizeof(head)), "aabbbbb");
+    ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ddd");
+  }
+}
+
 TEST(LocalFile, viaRegistry) {
   filesystems::registerLocalFileSystem();
   auto tempFile = ::exec::test::TempFilePath::create();
@@ -15,9 +15,11 @@
  */
 #include "velox/common/hyperloglog/DenseHll.h"
 
+#include <array>
 #include <exception>
 #include <sstream>
 #include "velox/common/base/IOUtils.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/hyperloglog/BiasCorrection.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -205,12 +207,16 @@ struct DenseHllView {
 int64_t cardinalityImpl(const DenseHllView& hll) {
   auto numBuckets = 1 << hll.indexBitLength;
 
-  int32_t baselineCount = 0;
-  for (int i = 0; i < numBuckets; i++) {
-    if (hll.getDelta(i) == 0) {
-      baselineCount++;
-    }
+  // Counts the buckets by delta. The harmonic mean then needs one term per
+  // delta instead of one division per bucket. The terms are powers of 2, so
+  // that the sum is exact in either order.
+  std::array<int32_t, kMaxDelta + 1> deltaCounts{};
+  const auto* deltas = reinterpret_cast<const uint8_t*>(hll.deltas);
+  for (auto i = 0; i < numBuckets / 2; ++i) {
+    ++deltaCounts[deltas[i] & kBucketMask];
+    ++deltaCounts[deltas[i] >> kBitsPerBucket];
   }
+  const int32_t baselineCount = deltaCounts[0];
 
   // If baseline is zero, then baselineCount is the number of buckets with value
   // 0.
@@ -220,9 +226,16 @@ int64_t cardinalityImpl(const DenseHllView& hll) {
   }
 
   double sum = 0;
-  for (int i = 0; i < numBuckets; i++) {
-    int value = hll.getValue(i);
-    sum += 1.0 / (1L << value);
+  for (auto delta = 0; delta <= kMaxDelta; ++delta) {
+    sum += deltaCounts[delta] * (1.0 / (1L << (hll.baseline + delta)));
+  }
+  // Buckets with an overflow were counted with the maximum delta.
+  for (auto i = 0; i < hll.overflows; ++i) {
+    const auto bucket = hll.overflowBuckets[i];
+    if (hll.getDelta(bucket) == kMaxDelta) {
+      sum += 1.0 / (1L << hll.getValue(bucket)) -
+          1.0 / (1L << (hll.baseline + kMaxDelta));
+    }
   }
 
   double estimate = (alpha(hll.indexBitLength) * numBuckets * numBuckets) / sum;
@@ -231,6 +244,76 @@ int64_t cardinalityImpl(const DenseHllView& hll) {
   return std::round(estimate);
 }
 
+// Returns the larger of 'delta' lowered by 'shift' and 'otherDelta' lowered
+// by 'otherShift'.
+uint8_t mergeDelta(
+    uint8_t delta,
+    uint8_t shift,
+    uint8_t otherDelta,
+    uint8_t otherShift) {
+  return std::max(
+      delta > shift ? delta - shift : 0,
+      otherDelta > otherShift ? otherDelta - otherShift : 0);
+}
+
+// Merges the deltas of two HLLs without overflows into 'deltas'. 'deltas' are
+// relative to 'baseline' and 'otherDeltas' to 'otherBaseline'. The merged
+// deltas are relative to the larger baseline, e.g. the deltas of the HLL with
+// the smaller baseline are lowered by the difference, saturating at 0. No
+// merged delta is above kMaxDelta, so that the merge needs no overflows.
+// Returns the number of merged deltas that are 0.
+int32_t mergeDeltas(
+    int8_t baseline,
+    int8_t* deltas,
+    int8_t otherBaseline,
+    const int8_t* otherDeltas,
+    int32_t numBytes) {
+  using Batch = xsimd::batch<uint8_t>;
+  const auto newBaseline = std::max(baseline, otherBaseline);
+  const uint8_t shift = std::min<int32_t>(newBaseline - baseline, kMaxDelta);
+  const uint8_t otherShift =
+      std::min<int32_t>(newBaseline - otherBaseline, kMaxDelta);
+  auto* bytes = reinterpret_cast<uint8_t*>(deltas);
+  auto* otherBytes = reinterpret_cast<const uint8_t*>(otherDeltas);
+
+  // The high deltas are kept in place, where the shifts apply to them as
+  // multiples of 16.
+  const auto lowMask = Batch::broadcast(kBucketMask);
+  const auto highMask = Batch::broadcast(kBucketMask << kBitsPerBucket);
+  const auto lowShift = Batch::broadcast(shift);
+  const auto highShift = Batch::broadcast(shift << kBitsPerBucket);
+  const auto otherLowShift = Batch::broadcast(otherShift);
+  const auto otherHighShift = Batch::broadcast(otherShift << kBitsPerBucket);
+  const auto zero = Batch::broadcast(0);
+  int32_t baselineCount = 0;
+  int32_t i = 0;
+  for (; i + Batch::size <= numBytes; i += Batch::size) {
+    auto slots = Batch::load_unaligned(bytes + i);
+    auto otherSlots = Batch::load_unaligned(otherBytes + i);
+    auto low = xsimd::max(
+        xsimd::ssub(slots & lowMask, lowShift),
+        xsimd::ssub(otherSlots & lowMask, otherLowShift));
+    auto high = xsimd::max(
+        xsimd::ssub(slots & highMask, highShift),
+        xsimd::ssub(otherSlots & highMask, otherHighShift));
+    (low | high).store_unaligned(bytes + i);
+    baselineCount += __builtin_popcount(simd::toBitMask(low == zero)) +
+        __builtin_popcount(simd::toBitMask(high == zero));
+  }
+  for (; i < numBytes; ++i) {
+    const uint8_t low = mergeDelta(
+        bytes[i] & kBucketMask, shift, otherBytes[i] & kBucketMask, otherShift);
+    const uint8_t high = mergeDelta(
+        bytes[i] >> kBitsPerBucket,
+        shift,
+        otherBytes[i] >> kBitsPerBucket,
+        otherShift);
+    bytes[i] = (high << kBitsPerBucket) | low;
+    baselineCount += (low == 0) + (high == 0);
+  }
+  return baselineCount;
+}
+
 DenseHllView deserialize(const char* serialized) {
   common::InputByteStream stream(serialized);
 
@@ -568,6 +651,14 @@ void DenseHll::mergeWith(
     int16_t otherOverflows,
     const uint16_t* otherOverflowBuckets,
     const int8_t* otherOverflowValues) {
+  if (overflows_ == 0 && otherOverflows == 0) {
+    baselineCount_ = mergeDeltas(
+        baseline_, deltas_.data(), otherBaseline, otherDeltas, deltas_.size());
+    baseline_ = std::max(baseline_, otherBaseline);
+    adjustBaselineIfNeeded();
+    return;
+  }
+
   int8_t newBaseline = std::max(baseline_, otherBaseline);
   int32_t baselineCount = 0;
 
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/common/hyperloglog/SparseHll.h"
+
+#include <algorithm>
+
 #include "velox/common/base/IOUtils.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -88,6 +91,33 @@ bool SparseHll::insertHash(uint64_t hash) {
   return entries_.size() >= softNumEntriesLimit_;
 }
 
+bool SparseHll::insertHashes(uint64_t* hashes, int32_t numHashes) {
+  if (numHashes == 0) {
+    return entries_.size() >= softNumEntriesLimit_;
+  }
+  // Encoded entries sort by index and then by value. The last entry of each
+  // index has the largest value.
+  auto* entries = reinterpret_cast<uint32_t*>(hashes);
+  for (auto i = 0; i < numHashes; ++i) {
+    const auto hash = hashes[i];
+    entries[i] = encode(
+        computeIndex(hash, kIndexBitLength),
+        computeValue(hash, kIndexBitLength));
+  }
+  std::sort(entries, entries + numHashes);
+  int32_t numEntries = 0;
+  for (auto i = 0; i < numHashes; ++i) {
+    if (numEntries > 0 &&
+        decodeIndex(entries[numEntries - 1]) == decodeIndex(entries[i])) {
+      entries[numEntries - 1] = entries[i];
+    } else {
+      entries[numEntries++] = entries[i];
+    }
+  }
+  mergeWith(numEntries, entries);
+  return entries_.size() >= softNumEntriesLimit_;
+}
+
 int64_t SparseHll::cardinality() const {
   // Estimate the cardinality using linear counting over the theoretical
   // 2^kIndexBitLength buckets available due to the fact that we're
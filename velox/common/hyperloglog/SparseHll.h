@@ -35,6 +35,13 @@ class SparseHll {
   /// Returns true if soft memory limit has been reached. False, otherwise.
   bool insertHash(uint64_t hash);
 
+  /// Inserts 'numHashes' hashes at once. Sorts the new entries and merges
+  /// them with the existing ones in one pass instead of inserting each in the
+  /// middle of the sorted entries. 'hashes' is used as scratch space. Returns
+  /// true if soft memory limit has been reached. The limit is checked only
+  /// after all the hashes are inserted.
+  bool insertHashes(uint64_t* hashes, int32_t numHashes);
+
   int64_t cardinality() const;
 
   /// Returns cardinality estimate from the specified serialized digest.
@@ -219,6 +219,30 @@ TEST_P(DenseHllTest, mergeWith) {
   testMergeWith(indexBitLength, sequence(0, 2'000'000), sequence(0, 2'000'000));
 }
 
+TEST_P(DenseHllTest, mergeMany) {
+  int8_t indexBitLength = GetParam();
+
+  // Merges many small HLLs with different baselines into one, like the final
+  // step of approx_distinct over many partial results.
+  DenseHll merged{indexBitLength, &allocator_};
+  DenseHll expected{indexBitLength, &allocator_};
+  for (auto i = 0; i < 200; ++i) {
+    DenseHll partial{indexBitLength, &allocator_};
+    for (auto value : sequence(i * 1'000, i * 1'000 + (i % 7 + 1) * 300)) {
+      auto hash = hashOne(value);
+      partial.insertHash(hash);
+      expected.insertHash(hash);
+    }
+    if (i % 2 == 0) {
+      merged.mergeWith(partial);
+    } else {
+      merged.mergeWith(serialize(partial).data());
+    }
+    ASSERT_EQ(serialize(expected), serialize(merged));
+  }
+  ASSERT_EQ(expected.cardinality(), merged.cardinality());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     DenseHllTest,
     DenseHllTest,
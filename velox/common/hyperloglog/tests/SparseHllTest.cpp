@@ -163,6 +163,39 @@ TEST_F(SparseHllTest, mergeWith) {
   testMergeWith(sequence(0, 100), sequence(0, 100));
 }
 
+TEST_F(SparseHllTest, insertHashes) {
+  SparseHll expected{&allocator_};
+  SparseHll batched{&allocator_};
+  // Batches with duplicates, overlapping the entries that are already there.
+  for (auto batch = 0; batch < 10; ++batch) {
+    std::vector<uint64_t> hashes;
+    for (auto i = 0; i < 300; ++i) {
+      auto hash = hashOne((batch * 100 + i * 7) % 2'000);
+      hashes.push_back(hash);
+      expected.insertHash(hash);
+    }
+    batched.insertHashes(hashes.data(), hashes.size());
+    batched.verify();
+    ASSERT_EQ(serialize(11, expected), serialize(11, batched));
+  }
+  ASSERT_EQ(expected.cardinality(), batched.cardinality());
+
+  // The soft memory limit is checked after the whole batch.
+  SparseHll limited{&allocator_};
+  limited.setSoftMemoryLimit(4 * 100);
+  std::vector<uint64_t> hashes;
+  for (auto i = 0; i < 50; ++i) {
+    hashes.push_back(hashOne(i));
+  }
+  ASSERT_FALSE(limited.insertHashes(hashes.data(), hashes.size()));
+  hashes.clear();
+  for (auto i = 50; i < 150; ++i) {
+    hashes.push_back(hashOne(i));
+  }
+  ASSERT_TRUE(limited.insertHashes(hashes.data(), hashes.size()));
+  ASSERT_EQ(150, limited.cardinality());
+}
+
 class SparseHllToDenseTest : public ::testing::TestWithParam<int8_t> {
  protected:
   std::string serialize(DenseHll& denseHll) {
@@ -109,9 +109,19 @@ class ByteStream {
 
   void operator=(const ByteStream& other) = delete;
 
-  void resetInput(std::vector<ByteRange>&& ranges) {
+  // Sets the ranges to read. 'owner' is the IOBuf chain holding the memory of
+  // 'ranges', if they come from one. Readers can keep a reference to it to
+  // use the data in place after 'this' is reset or destroyed.
+  void resetInput(
+      std::vector<ByteRange>&& ranges,
+      std::shared_ptr<folly::IOBuf> owner = nullptr) {
     ranges_ = std::move(ranges);
     current_ = &ranges_[0];
+    inputOwner_ = std::move(owner);
+  }
+
+  const std::shared_ptr<folly::IOBuf>& inputOwner() const {
+    return inputOwner_;
   }
 
   void setRange(ByteRange range) {
@@ -375,6 +385,9 @@ class ByteStream {
   // and the last may be partly full. The position in the last range
   // is not necessarily the the end if there has been a seek.
   int32_t lastRangeEnd_{0};
+
+  // Holds the memory of 'ranges_' when reading from an IOBuf chain.
+  std::shared_ptr<folly::IOBuf> inputOwner_;
 };
 
 template <>
@@ -238,28 +238,35 @@ HashStringAllocator::allocateFromFreeList(
   if (!numFree_) {
     return nullptr;
   }
-  VELOX_CHECK(!free_.empty());
   preferredSize = std::max(kMinAlloc, preferredSize);
-  int32_t counter = 0;
-  Header* largest = nullptr;
+  const auto index = freeListIndex(preferredSize);
   Header* found = nullptr;
-  for (auto* item = free_.next(); item != &free_; item = item->next()) {
-    auto header = headerOf(item);
-    VELOX_CHECK(header->isFree());
-    auto size = header->size();
-    if (size >= preferredSize) {
-      found = header;
-      break;
-    }
-    if (!largest || size > largest->size()) {
-      largest = header;
-    }
-    if (!mustHaveSize && ++counter > kMaxCheckedForFit) {
-      break;
+  // The list for 'preferredSize' may also have smaller blocks. Checks a few of
+  // these and then takes the first block from a list of larger blocks, all of
+  // which fit.
+  const uint32_t largerLists = freeNonEmpty_ & ~bits::lowMask(index + 1);
+  if (freeNonEmpty_ & (1U << index)) {
+    int32_t counter = 0;
+    auto& list = free_[index];
+    for (auto* item = list.next(); item != &list; item = item->next()) {
+      auto header = headerOf(item);
+      VELOX_CHECK(header->isFree());
+      if (header->size() >= preferredSize) {
+        found = header;
+        break;
+      }
+      if (largerLists && ++counter > kMaxCheckedForFit) {
+        break;
+      }
     }
   }
-  if (!mustHaveSize && !found) {
-    found = largest;
+  if (!found && largerLists) {
+    found = headerOf(free_[__builtin_ctz(largerLists)].next());
+  }
+  if (!found && !mustHaveSize) {
+    // Returns the first block of the list of the largest blocks.
+    VELOX_CHECK_NE(freeNonEmpty_, 0);
+    found = headerOf(free_[31 - __builtin_clz(freeNonEmpty_)].next());
   }
   if (!found) {
     return nullptr;
@@ -303,14 +310,16 @@ void HashStringAllocator::free(Header* _header) {
       }
     }
     if (header->isPreviousFree()) {
+      // The merged block may belong to a different free list.
       auto previousFree = getPreviousFree(header);
+      removeFromFreeList(previousFree);
       previousFree->setSize(
           previousFree->size() + header->size() + sizeof(Header));
       header = previousFree;
     } else {
       ++numFree_;
-      free_.insert(reinterpret_cast<CompactDoubleList*>(header->begin()));
     }
+    insertIntoFreeList(header);
     markAsFree(header);
     header = continued;
   } while (header);
@@ -438,9 +447,14 @@ void HashStringAllocator::checkConsistency() const {
   VELOX_CHECK(freeBytes == freeBytes_);
   uint64_t numInFreeList = 0;
   uint64_t bytesInFreeList = 0;
-  for (auto free = free_.next(); free != &free_; free = free->next()) {
-    ++numInFreeList;
-    bytesInFreeList += headerOf(free)->size() + sizeof(Header);
+  for (auto i = 0; i < kNumFreeLists; ++i) {
+    auto& list = free_[i];
+    VELOX_CHECK_EQ(!list.empty(), (freeNonEmpty_ & (1U << i)) != 0);
+    for (auto free = list.next(); free != &list; free = free->next()) {
+      ++numInFreeList;
+      VELOX_CHECK_EQ(freeListIndex(headerOf(free)->size()), i);
+      bytesInFreeList += headerOf(free)->size() + sizeof(Header);
+    }
   }
   VELOX_CHECK(numInFreeList == numFree_);
   VELOX_CHECK(bytesInFreeList == freeBytes_);
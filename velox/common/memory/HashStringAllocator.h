@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <array>
+
 #include "velox/common/base/CheckedArithmetic.h"
 #include "velox/common/memory/AllocationPool.h"
 #include "velox/common/memory/ByteStream.h"
@@ -36,6 +38,11 @@ namespace facebook::velox {
 // below is free. In this case the uint32_t below the header has the size of the
 // previous free block. The last word of a MappedMemory::PageRun backing a
 // HashStringAllocator is set to kArenaEnd.
+//
+// Free blocks are kept in segregated free lists, one per power of two of the
+// block size. A bitmap of non-empty lists finds a list with blocks of at least
+// a given size in constant time, so that allocation does not scan blocks which
+// are too small.
 class HashStringAllocator : public StreamArena {
  public:
   // The minimum allocation must have space after the header for the
@@ -265,7 +272,10 @@ class HashStringAllocator : public StreamArena {
   void clear() {
     numFree_ = 0;
     freeBytes_ = 0;
-    new (&free_) CompactDoubleList();
+    for (auto& list : free_) {
+      new (&list) CompactDoubleList();
+    }
+    freeNonEmpty_ = 0;
     pool_.clear();
   }
 
@@ -285,6 +295,17 @@ class HashStringAllocator : public StreamArena {
   static constexpr int32_t kUnitSize = 16 * memory::MappedMemory::kPageSize;
   static constexpr int32_t kMinContiguous = 48;
 
+  // Number of free lists. List i has the free blocks with sizes in [2^(i +
+  // 4), 2^(i + 5)). The last covers the sizes up to Header::kSizeMask.
+  static constexpr int32_t kNumFreeLists = 26;
+
+  // Returns the index of the free list for a block of 'size' bytes.
+  static int32_t freeListIndex(int32_t size) {
+    return std::min<int32_t>(
+        kNumFreeLists - 1,
+        std::max<int32_t>(0, 63 - __builtin_clzll(size) - 4));
+  }
+
   // Adds 'bytes' worth of contiguous space to the free list. This
   // grows the footprint in MappedMemory but does not allocate
   // anything yet. Throws if fails to grow. The caller typically knows
@@ -293,10 +314,24 @@ class HashStringAllocator : public StreamArena {
   // starting to process a batch of input.
   void newSlab(int32_t size);
 
+  // Removes 'header' from its free list. Does not update 'numFree_' or
+  // 'freeBytes_'.
   void removeFromFreeList(Header* FOLLY_NONNULL header) {
     VELOX_CHECK(header->isFree());
     header->clearFree();
     reinterpret_cast<CompactDoubleList*>(header->begin())->remove();
+    const auto index = freeListIndex(header->size());
+    if (free_[index].empty()) {
+      freeNonEmpty_ &= ~(1U << index);
+    }
+  }
+
+  // Adds 'header' to the free list for its size. Does not set the free flag
+  // or update 'numFree_' or 'freeBytes_'.
+  void insertIntoFreeList(Header* FOLLY_NONNULL header) {
+    const auto index = freeListIndex(header->size());
+    free_[index].insert(reinterpret_cast<CompactDoubleList*>(header->begin()));
+    freeNonEmpty_ |= 1U << index;
   }
 
   /// Allocates a block of specified size. If exactSize is false, the block may
@@ -320,10 +355,13 @@ class HashStringAllocator : public StreamArena {
   // blocks would be below minimum size.
   void freeRestOfBlock(Header* FOLLY_NONNULL header, int32_t keepBytes);
 
-  // Circular list of free blocks.
-  CompactDoubleList free_;
+  // Circular lists of free blocks, one per size range. See freeListIndex().
+  std::array<CompactDoubleList, kNumFreeLists> free_;
+
+  // Has a set bit for each non-empty list in 'free_'.
+  uint32_t freeNonEmpty_{0};
 
-  // Count of elements in 'free_'. This is 0 when free_.next() == &free_.
+  // Count of elements in 'free_'. This is 0 when all lists are empty.
   uint64_t numFree_ = 0;
 
   // Sum of the size of blocks in 'free_', excluding headers.
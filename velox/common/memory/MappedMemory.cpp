@@ -513,6 +513,9 @@ Stats Stats::operator-(const Stats& other) const {
     result.sizes[i] = sizes[i] - other.sizes[i];
   }
   result.numAdvise = numAdvise - other.numAdvise;
+  result.numCrossNodeAllocations =
+      numCrossNodeAllocations - other.numCrossNodeAllocations;
+  result.hugePageBytes = hugePageBytes - other.hugePageBytes;
   return result;
 }
 
@@ -525,10 +528,13 @@ std::string Stats::toString() const {
     totalBytes += sizes[i].totalBytes;
   }
   out << fmt::format(
-      "Alloc: {}MB {} Gigaclocks, {}MB advised\n",
+      "Alloc: {}MB {} Gigaclocks, {}MB advised, {} cross node, "
+      "{}MB huge pages\n",
       totalBytes >> 20,
       totalClocks >> 30,
-      numAdvise >> 8);
+      numAdvise >> 8,
+      numCrossNodeAllocations,
+      hugePageBytes >> 20);
 
   // Sort the size classes by decreasing clocks.
   std::vector<int32_t> indices(sizes.size());
@@ -138,6 +138,14 @@ struct Stats {
 
   /// Cumulative count of pages advised away, if the allocator exposes this.
   int64_t numAdvise{0};
+
+  /// Cumulative count of allocations which took pages from a NUMA node other
+  /// than the node of the calling thread, if the allocator is NUMA aware.
+  int64_t numCrossNodeAllocations{0};
+
+  /// Bytes of live allocations backed by huge pages, if the allocator
+  /// advises large allocations to use huge pages.
+  int64_t hugePageBytes{0};
 };
 
 class ScopedMappedMemory;
@@ -23,6 +23,13 @@ DEFINE_bool(
     false,
     "If true, use MmapMemoryAllocator to allocate memory for MemoryPool");
 
+DEFINE_int64(
+    velox_memory_pool_reservation_quantum,
+    0,
+    "If not 0, MemoryPools reserve memory from their trackers and memory "
+    "managers in multiples of this many bytes and serve smaller allocations "
+    "from the reservation");
+
 namespace facebook {
 namespace velox {
 namespace memory {
@@ -21,6 +21,7 @@
 #include <limits>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <fmt/format.h>
@@ -33,6 +34,7 @@
 #include "folly/Likely.h"
 #include "folly/Random.h"
 #include "folly/SharedMutex.h"
+#include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CheckedArithmetic.h"
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/base/SuccinctPrinter.h"
@@ -41,6 +43,7 @@
 #include "velox/common/memory/MemoryUsageTracker.h"
 
 DECLARE_int32(memory_usage_aggregation_interval_millis);
+DECLARE_int64(velox_memory_pool_reservation_quantum);
 
 namespace facebook {
 namespace velox {
@@ -338,6 +341,9 @@ class MemoryPoolImpl : public MemoryPool {
       int64_t cap = kMaxMemory);
 
   ~MemoryPoolImpl() {
+    if (quantumReservedBytes_ > quantumUsedBytes_) {
+      releaseImpl(quantumReservedBytes_ - quantumUsedBytes_);
+    }
     if (const auto& tracker = getMemoryUsageTracker()) {
       auto remainingBytes = tracker->getCurrentUserBytes();
       VELOX_CHECK_EQ(
@@ -417,6 +423,11 @@ class MemoryPoolImpl : public MemoryPool {
   int64_t getSubtreeMaxBytes() const;
 
   // TODO: consider returning bool instead.
+  // If FLAGS_velox_memory_pool_reservation_quantum is set, the pool reserves
+  // memory from its tracker and memory manager in multiples of the quantum
+  // and serves the allocations within the reservation without updating
+  // either. The caps are enforced at reservation time. The usage reported by
+  // the pool includes up to a quantum of unused reservation.
   void reserve(int64_t size) override;
   void release(int64_t size) override;
 
@@ -466,6 +477,11 @@ class MemoryPoolImpl : public MemoryPool {
     return allocator_.realloc(p, size, newSize);
   }
 
+  // Updates the tracker, memory manager and local usage by 'size' and
+  // enforces the caps.
+  void reserveImpl(int64_t size);
+  void releaseImpl(int64_t size);
+
   void accessSubtreeMemoryUsage(
       std::function<void(const MemoryUsage&)> visitor) const;
   void updateSubtreeMemoryUsage(std::function<void(MemoryUsage&)> visitor);
@@ -480,6 +496,16 @@ class MemoryPoolImpl : public MemoryPool {
   int64_t cap_;
   std::atomic_bool capped_{false};
 
+  // The granularity of the reservations made by reserve(), 0 if each call is
+  // reserved individually.
+  const int64_t reservationQuantum_;
+  // Serializes access to 'quantumReservedBytes_' and 'quantumUsedBytes_'.
+  std::mutex reservationMutex_;
+  // The bytes reserved in multiples of 'reservationQuantum_' and the part of
+  // these used by the allocations.
+  int64_t quantumReservedBytes_{0};
+  int64_t quantumUsedBytes_{0};
+
   Allocator& allocator_;
 };
 
@@ -581,8 +607,10 @@ MemoryPoolImpl<Allocator, ALIGNMENT>::MemoryPoolImpl(
       memoryManager_{memoryManager},
       localMemoryUsage_{},
       cap_{cap},
+      reservationQuantum_{FLAGS_velox_memory_pool_reservation_quantum},
       allocator_{memoryManager_.getAllocator()} {
   VELOX_USER_CHECK_GT(cap, 0);
+  VELOX_USER_CHECK_GE(reservationQuantum_, 0);
 }
 
 template <typename Allocator, uint16_t ALIGNMENT>
@@ -780,6 +808,57 @@ void MemoryPoolImpl<Allocator, ALIGNMENT>::updateSubtreeMemoryUsage(
 
 template <typename Allocator, uint16_t ALIGNMENT>
 void MemoryPoolImpl<Allocator, ALIGNMENT>::reserve(int64_t size) {
+  if (!reservationQuantum_) {
+    reserveImpl(size);
+    return;
+  }
+  int64_t increment;
+  {
+    std::lock_guard<std::mutex> l(reservationMutex_);
+    if (quantumUsedBytes_ + size <= quantumReservedBytes_) {
+      quantumUsedBytes_ += size;
+      return;
+    }
+    // Reserves whole quanta but not beyond 'cap_' so that a pool with a cap
+    // smaller than the quantum can still be used up to its cap.
+    const int64_t neededBytes =
+        quantumUsedBytes_ + size - quantumReservedBytes_;
+    increment = std::max(
+        neededBytes,
+        std::min(
+            bits::roundUp(neededBytes, reservationQuantum_),
+            cap_ - getAggregateBytes()));
+  }
+  reserveImpl(increment);
+  std::lock_guard<std::mutex> l(reservationMutex_);
+  quantumReservedBytes_ += increment;
+  quantumUsedBytes_ += size;
+}
+
+template <typename Allocator, uint16_t ALIGNMENT>
+void MemoryPoolImpl<Allocator, ALIGNMENT>::release(int64_t size) {
+  if (!reservationQuantum_) {
+    releaseImpl(size);
+    return;
+  }
+  int64_t freeable = 0;
+  {
+    std::lock_guard<std::mutex> l(reservationMutex_);
+    quantumUsedBytes_ -= size;
+    // Keeps up to a quantum of unused reservation for the next allocations.
+    if (quantumReservedBytes_ - quantumUsedBytes_ > reservationQuantum_) {
+      freeable = quantumReservedBytes_ -
+          bits::roundUp(quantumUsedBytes_, reservationQuantum_);
+      quantumReservedBytes_ -= freeable;
+    }
+  }
+  if (freeable) {
+    releaseImpl(freeable);
+  }
+}
+
+template <typename Allocator, uint16_t ALIGNMENT>
+void MemoryPoolImpl<Allocator, ALIGNMENT>::reserveImpl(int64_t size) {
   if (memoryUsageTracker_) {
     memoryUsageTracker_->update(size);
   }
@@ -793,7 +872,7 @@ void MemoryPoolImpl<Allocator, ALIGNMENT>::reserve(int64_t size) {
     // would have more accurate aggregates in intermediate states. However, this
     // is low-pri because we can only have inflated aggregates, and be on the
     // more conservative side.
-    release(size);
+    releaseImpl(size);
     if (!success) {
       VELOX_MEM_MANAGER_CAP_EXCEEDED(memoryManager_.getMemoryQuota());
     }
@@ -809,7 +888,7 @@ void MemoryPoolImpl<Allocator, ALIGNMENT>::reserve(int64_t size) {
 }
 
 template <typename Allocator, uint16_t ALIGNMENT>
-void MemoryPoolImpl<Allocator, ALIGNMENT>::release(int64_t size) {
+void MemoryPoolImpl<Allocator, ALIGNMENT>::releaseImpl(int64_t size) {
   memoryManager_.release(size);
   localMemoryUsage_.incrementCurrentBytes(-size);
   if (memoryUsageTracker_) {
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+#include <algorithm>
+
+#include "velox/common/base/SuccinctPrinter.h"
+
+namespace facebook::velox::memory {
+namespace {
+void setCapacity(MemoryUsageTracker& tracker, int64_t capacity) {
+  tracker.updateConfig(
+      MemoryUsageConfigBuilder().maxTotalMemory(capacity).build());
+}
+} // namespace
+
+MemoryArbitrator::MemoryArbitrator(const Config& config)
+    : capacity_(config.capacity),
+      initQueryCapacity_(config.initQueryCapacity),
+      minGrowBytes_(config.minGrowBytes),
+      freeCapacity_(config.capacity) {
+  VELOX_CHECK_GE(capacity_, 0);
+  VELOX_CHECK_GE(initQueryCapacity_, 0);
+  VELOX_CHECK_GE(minGrowBytes_, 0);
+}
+
+MemoryArbitrator::~MemoryArbitrator() {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& entry : queries_) {
+    if (auto tracker = entry.second.tracker.lock()) {
+      tracker->setGrowCallback(nullptr);
+    }
+  }
+}
+
+void MemoryArbitrator::addQuery(
+    const std::shared_ptr<MemoryUsageTracker>& tracker,
+    Reclaimer reclaimer) {
+  VELOX_CHECK_NOT_NULL(tracker);
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = queries_.find(tracker.get());
+  if (it != queries_.end()) {
+    // A tracker destroyed without removeQuery() may leave an entry behind
+    // with the address of a new tracker.
+    VELOX_CHECK(
+        it->second.tracker.expired(),
+        "Query is already added to the memory arbitrator");
+    freeCapacity_ += it->second.capacity;
+    queries_.erase(it);
+  }
+  const int64_t maxCapacity = tracker->maxTotalBytes();
+  const int64_t capacity =
+      std::min({initQueryCapacity_, maxCapacity, availableCapacityLocked()});
+  freeCapacity_ -= capacity;
+  queries_.emplace(
+      tracker.get(),
+      Query{tracker, maxCapacity, capacity, std::move(reclaimer)});
+  setCapacity(*tracker, capacity);
+  tracker->setGrowCallback([this](
+                               MemoryUsageTracker::UsageType type,
+                               int64_t /*size*/,
+                               MemoryUsageTracker& tracker) {
+    // Only the total cap is arbitrated. The user memory cap of a query stays
+    // a hard limit.
+    if (type == MemoryUsageTracker::UsageType::kUserMem &&
+        tracker.getCurrentUserBytes() > tracker.getUserMemoryCap()) {
+      return false;
+    }
+    return growCapacity(tracker);
+  });
+}
+
+void MemoryArbitrator::setCache(
+    std::function<int64_t()> usedBytes,
+    Reclaimer shrink) {
+  VELOX_CHECK_NOT_NULL(usedBytes);
+  VELOX_CHECK_NOT_NULL(shrink);
+  std::lock_guard<std::mutex> l(mutex_);
+  cacheUsedBytes_ = std::move(usedBytes);
+  cacheShrink_ = std::move(shrink);
+}
+
+void MemoryArbitrator::removeQuery(MemoryUsageTracker& tracker) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = queries_.find(&tracker);
+  VELOX_CHECK(
+      it != queries_.end(), "Query is not added to the memory arbitrator");
+  freeCapacity_ += it->second.capacity;
+  queries_.erase(it);
+  tracker.setGrowCallback(nullptr);
+}
+
+bool MemoryArbitrator::growCapacity(MemoryUsageTracker& tracker) {
+  int64_t neededBytes;
+  Reclaimer cacheShrink;
+  std::vector<std::pair<int64_t, Reclaimer>> victims;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numRequests;
+    if (growCapacityLocked(tracker, neededBytes)) {
+      return true;
+    }
+    if (neededBytes == 0) {
+      ++stats_.numFailures;
+      return false;
+    }
+    cacheShrink = cacheShrink_;
+    for (auto& entry : queries_) {
+      auto& query = entry.second;
+      if (entry.first == &tracker || query.reclaimer == nullptr) {
+        continue;
+      }
+      if (auto other = query.tracker.lock()) {
+        victims.emplace_back(other->totalReservedBytes(), query.reclaimer);
+      }
+    }
+  }
+
+  // Shrinks the cache and then asks the queries using the most memory to free
+  // memory first. The cache and the reclaimers run outside of 'mutex_' as they
+  // may take locks which are held by threads allocating memory and hence
+  // waiting for the arbitrator.
+  int64_t cacheShrunkBytes = 0;
+  if (cacheShrink != nullptr) {
+    cacheShrunkBytes = cacheShrink(neededBytes);
+  }
+  std::sort(
+      victims.begin(), victims.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+      });
+  int64_t reclaimedBytes = 0;
+  int32_t numReclaims = 0;
+  for (auto& victim : victims) {
+    const int64_t targetBytes = neededBytes - cacheShrunkBytes - reclaimedBytes;
+    if (targetBytes <= 0) {
+      break;
+    }
+    reclaimedBytes += victim.second(targetBytes);
+    ++numReclaims;
+  }
+
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cacheShrink != nullptr) {
+    ++stats_.numCacheShrinks;
+    stats_.cacheShrunkBytes += cacheShrunkBytes;
+  }
+  stats_.numReclaims += numReclaims;
+  stats_.reclaimedBytes += reclaimedBytes;
+  if (growCapacityLocked(tracker, neededBytes)) {
+    return true;
+  }
+  ++stats_.numFailures;
+  return false;
+}
+
+bool MemoryArbitrator::growCapacityLocked(
+    MemoryUsageTracker& tracker,
+    int64_t& neededBytes) {
+  neededBytes = 0;
+  auto it = queries_.find(&tracker);
+  if (it == queries_.end()) {
+    return false;
+  }
+  auto& query = it->second;
+  const int64_t usage = tracker.totalReservedBytes();
+  if (usage <= query.capacity) {
+    // Another thread has grown the cap while this one was waiting.
+    return true;
+  }
+  if (usage > query.maxCapacity) {
+    return false;
+  }
+  const int64_t minBytes = usage - query.capacity;
+  const int64_t growBytes = std::min(
+      std::max(minBytes, minGrowBytes_), query.maxCapacity - query.capacity);
+  int64_t availableBytes = availableCapacityLocked();
+  if (availableBytes < growBytes) {
+    shrinkCapacityLocked(&tracker, growBytes - availableBytes);
+    availableBytes = availableCapacityLocked();
+  }
+  if (availableBytes < minBytes) {
+    neededBytes = minBytes - availableBytes;
+    return false;
+  }
+  const int64_t bytes = std::min(growBytes, availableBytes);
+  freeCapacity_ -= bytes;
+  query.capacity += bytes;
+  setCapacity(tracker, query.capacity);
+  return true;
+}
+
+int64_t MemoryArbitrator::availableCapacityLocked() const {
+  if (cacheUsedBytes_ == nullptr) {
+    return freeCapacity_;
+  }
+  return std::max<int64_t>(0, freeCapacity_ - cacheUsedBytes_());
+}
+
+void MemoryArbitrator::shrinkCapacityLocked(
+    const MemoryUsageTracker* requestor,
+    int64_t targetBytes) {
+  std::vector<std::pair<int64_t, std::shared_ptr<MemoryUsageTracker>>>
+      candidates;
+  for (auto it = queries_.begin(); it != queries_.end();) {
+    auto tracker = it->second.tracker.lock();
+    if (tracker == nullptr) {
+      // The tracker is gone without removeQuery(), take back its capacity.
+      freeCapacity_ += it->second.capacity;
+      it = queries_.erase(it);
+      continue;
+    }
+    if (tracker.get() != requestor) {
+      const int64_t unusedBytes =
+          it->second.capacity - tracker->totalReservedBytes();
+      if (unusedBytes > 0) {
+        candidates.emplace_back(unusedBytes, std::move(tracker));
+      }
+    }
+    ++it;
+  }
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+  int64_t freedBytes = 0;
+  for (auto& candidate : candidates) {
+    if (freedBytes >= targetBytes) {
+      break;
+    }
+    auto& tracker = candidate.second;
+    auto& query = queries_.at(tracker.get());
+    // The query may allocate concurrently. An allocation which exceeds the
+    // lowered cap comes back to the arbitrator through the grow callback.
+    const int64_t capacity =
+        std::max<int64_t>(0, tracker->totalReservedBytes());
+    if (capacity >= query.capacity) {
+      continue;
+    }
+    const int64_t bytes = query.capacity - capacity;
+    setCapacity(*tracker, capacity);
+    query.capacity = capacity;
+    freeCapacity_ += bytes;
+    freedBytes += bytes;
+    ++stats_.numShrinks;
+    stats_.shrunkBytes += bytes;
+  }
+}
+
+int64_t MemoryArbitrator::freeCapacity() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return freeCapacity_;
+}
+
+MemoryArbitrator::Stats MemoryArbitrator::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+std::string MemoryArbitrator::toString() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return fmt::format(
+      "MemoryArbitrator[capacity {} free {} queries {} requests {} "
+      "failures {} shrunk {} reclaimed {}]",
+      succinctBytes(capacity_),
+      succinctBytes(freeCapacity_),
+      queries_.size(),
+      stats_.numRequests,
+      stats_.numFailures,
+      succinctBytes(stats_.shrunkBytes),
+      succinctBytes(stats_.reclaimedBytes));
+}
+
+} // namespace facebook::velox::memory
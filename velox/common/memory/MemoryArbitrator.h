@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+
+namespace facebook::velox::memory {
+
+/// Shares a fixed memory capacity among the root memory usage trackers of the
+/// queries running in a process. Instead of giving each query a static cap,
+/// a query starts with a small cap which the arbitrator grows on demand from
+/// the GrowCallback of the query's tracker. If there is not enough free
+/// capacity, the arbitrator first takes back the unused capacity of the other
+/// queries by lowering their caps to their current usage, then shrinks the
+/// cache set by setCache() and finally asks the other queries to free memory
+/// through their reclaimers, e.g. by spilling.
+///
+/// The capacity of a query whose tracker is destroyed without removeQuery() is
+/// taken back on the next arbitration. The arbitrator resets the grow callbacks
+/// of the remaining queries on destruction.
+class MemoryArbitrator {
+ public:
+  /// Invoked by the arbitrator to ask a query to free at least 'targetBytes'.
+  /// Returns the number of bytes freed before returning. A reclaimer which
+  /// frees memory asynchronously, e.g. by asking its operators to spill on
+  /// their next input, returns 0 and the freed memory is taken back by the
+  /// following arbitrations. The reclaimer is called from a thread of another
+  /// query and must not throw.
+  using Reclaimer = std::function<int64_t(int64_t targetBytes)>;
+
+  struct Config {
+    /// The total bytes shared by all the added queries.
+    int64_t capacity;
+
+    /// The cap a query starts with when added.
+    int64_t initQueryCapacity{0};
+
+    /// The minimum number of bytes to grow the cap of a query by. This avoids
+    /// an arbitration on every reservation of a growing query.
+    int64_t minGrowBytes{8 << 20};
+  };
+
+  struct Stats {
+    /// The number of cap growth requests.
+    int64_t numRequests{0};
+    /// The number of requests which could not get enough capacity.
+    int64_t numFailures{0};
+    /// The number of times the cap of a query was lowered to its usage.
+    int64_t numShrinks{0};
+    /// The unused capacity taken back from the queries by lowering their caps.
+    int64_t shrunkBytes{0};
+    /// The number of reclaimer calls.
+    int64_t numReclaims{0};
+    /// The bytes reported as freed by the reclaimers.
+    int64_t reclaimedBytes{0};
+    /// The number of times the cache was asked to shrink.
+    int64_t numCacheShrinks{0};
+    /// The bytes reported as freed by the cache.
+    int64_t cacheShrunkBytes{0};
+  };
+
+  explicit MemoryArbitrator(const Config& config);
+
+  ~MemoryArbitrator();
+
+  /// Adds a query with root memory usage tracker 'tracker'. The tracker's
+  /// current total cap bounds the cap the arbitrator grows it to and the
+  /// tracker's cap is set to Config::initQueryCapacity or less if there is not
+  /// enough free capacity. The arbitrator installs itself as the tracker's
+  /// GrowCallback. 'reclaimer' is optional and is called when another query
+  /// needs memory.
+  void addQuery(
+      const std::shared_ptr<MemoryUsageTracker>& tracker,
+      Reclaimer reclaimer = nullptr);
+
+  /// Sets a cache which shares 'capacity' with the queries, e.g. an
+  /// AsyncDataCache. 'usedBytes' returns the memory held by the cache. The
+  /// cache may use all the capacity not assigned to the queries and 'shrink'
+  /// is called to free cache memory when a query needs it. 'shrink' is called
+  /// before the reclaimers of the other queries and must not throw.
+  void setCache(std::function<int64_t()> usedBytes, Reclaimer shrink);
+
+  /// Removes a query added by addQuery() and returns its cap to the free
+  /// capacity. This is called after the query has finished using 'tracker'.
+  void removeQuery(MemoryUsageTracker& tracker);
+
+  /// Invoked from the GrowCallback of a query whose usage exceeds its total
+  /// cap. Raises the cap of 'tracker' to at least its current usage and
+  /// returns true, or returns false if the capacity could not be found.
+  bool growCapacity(MemoryUsageTracker& tracker);
+
+  int64_t capacity() const {
+    return capacity_;
+  }
+
+  /// Returns the capacity not assigned to any query. This includes the memory
+  /// used by the cache.
+  int64_t freeCapacity() const;
+
+  Stats stats() const;
+
+  std::string toString() const;
+
+ private:
+  struct Query {
+    std::weak_ptr<MemoryUsageTracker> tracker;
+    // The upper bound of the cap of the query.
+    int64_t maxCapacity;
+    // The cap assigned to the query.
+    int64_t capacity;
+    Reclaimer reclaimer;
+  };
+
+  // Returns the free capacity not used by the cache.
+  int64_t availableCapacityLocked() const;
+
+  // Tries to raise the cap of 'tracker' from the free capacity, after taking
+  // back the unused capacity of the other queries if needed. Returns false
+  // if there is not enough capacity; 'neededBytes' is set to the shortfall.
+  bool growCapacityLocked(MemoryUsageTracker& tracker, int64_t& neededBytes);
+
+  // Lowers the caps of the queries other than 'requestor' to their current
+  // usage, the ones with the most unused capacity first, until at least
+  // 'targetBytes' are freed or there are no more queries to shrink.
+  void shrinkCapacityLocked(
+      const MemoryUsageTracker* requestor,
+      int64_t targetBytes);
+
+  const int64_t capacity_;
+  const int64_t initQueryCapacity_;
+  const int64_t minGrowBytes_;
+
+  mutable std::mutex mutex_;
+  int64_t freeCapacity_;
+  std::unordered_map<MemoryUsageTracker*, Query> queries_;
+  std::function<int64_t()> cacheUsedBytes_;
+  Reclaimer cacheShrink_;
+  Stats stats_;
+};
+
+} // namespace facebook::velox::memory
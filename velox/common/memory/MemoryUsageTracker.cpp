@@ -156,7 +156,8 @@ void MemoryUsageTracker::incrementUsage(UsageType type, int64_t size) {
       checkNonNegativeSizes("after exceeding cap");
       auto errorMessage = fmt::format(
           MEM_CAP_EXCEEDED_ERROR_FORMAT,
-          succinctBytes(std::min(total(maxMemory_), usage(maxMemory_, type))),
+          succinctBytes(
+              std::min<int64_t>(total(maxMemory_), usage(maxMemory_, type))),
           succinctBytes(size));
       if (makeMemoryCapExceededMessage_) {
         errorMessage += ". " + makeMemoryCapExceededMessage_(*this);
@@ -216,6 +216,9 @@ class MemoryUsageTracker
     return user(maxMemory_);
   }
 
+  // Updates the limits to enforce. The limits may be changed while other
+  // threads update the usage, e.g. by a MemoryArbitrator lowering the cap of
+  // a query to hand its unused capacity to another query.
   void updateConfig(const MemoryUsageConfig& config) {
     if (config.maxUserMemory.has_value()) {
       usage(maxMemory_, UsageType::kUserMem) = config.maxUserMemory.value();
@@ -375,7 +378,7 @@ class MemoryUsageTracker
   std::array<std::atomic<int64_t>, 3> currentUsageInBytes_{};
   std::array<std::atomic<int64_t>, 3> peakUsageInBytes_{};
   // The memory limit to enforce.
-  std::array<int64_t, 3> maxMemory_;
+  std::array<std::atomic<int64_t>, 3> maxMemory_;
   std::array<std::atomic<int64_t>, 3> numAllocs_{};
   std::array<std::atomic<int64_t>, 3> cumulativeBytes_{};
 
@@ -19,10 +19,49 @@
 #include "velox/common/testutil/TestValue.h"
 
 #include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 using facebook::velox::common::testutil::TestValue;
 
 namespace facebook::velox::memory {
+namespace {
+thread_local int32_t threadNumaNodeOverride = -1;
+
+int32_t currentNumaNode() {
+#ifdef __linux__
+  unsigned cpu;
+  unsigned node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+// Sets the preferred NUMA node of the pages in the range. Pages which are
+// already backed by memory keep their placement.
+void preferNumaNode(void* address, size_t bytes, int32_t node) {
+#ifdef __linux__
+  // MPOL_PREFERRED from linux/mempolicy.h. A preferred node, unlike a bound
+  // one, falls back to other nodes when the node is out of memory.
+  constexpr int32_t kMpolPreferred = 1;
+  uint64_t nodeMask = 1UL << node;
+  if (syscall(
+          SYS_mbind,
+          address,
+          bytes,
+          kMpolPreferred,
+          &nodeMask,
+          sizeof(nodeMask) * 8,
+          0) != 0) {
+    LOG(WARNING) << "mbind to NUMA node " << node << " failed with " << errno;
+  }
+#endif
+}
+} // namespace
 
 MmapAllocator::MmapAllocator(const MmapAllocatorOptions& options)
     : MappedMemory(),
@@ -31,9 +70,26 @@ MmapAllocator::MmapAllocator(const MmapAllocatorOptions& options)
       capacity_(bits::roundUp(
           options.capacity / kPageSize,
           64 * sizeClassSizes_.back())),
-      useMmapArena_(options.useMmapArena) {
-  for (int size : sizeClassSizes_) {
-    sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
+      numNumaNodes_(options.numNumaNodes),
+      useMmapArena_(options.useMmapArena),
+      hugePageThresholdBytes_(options.hugePageThresholdBytes) {
+  VELOX_CHECK_GT(numNumaNodes_, 0);
+  VELOX_CHECK_GE(hugePageThresholdBytes_, 0);
+  VELOX_CHECK_LT(numNumaNodes_, 64);
+  if (numNumaNodes_ == 1) {
+    for (int size : sizeClassSizes_) {
+      sizeClasses_.push_back(
+          std::make_unique<SizeClass>(capacity_ / size, size));
+    }
+  } else {
+    const auto nodeCapacity =
+        bits::roundUp(capacity_ / numNumaNodes_, 64 * sizeClassSizes_.back());
+    for (auto node = 0; node < numNumaNodes_; ++node) {
+      for (int size : sizeClassSizes_) {
+        sizeClasses_.push_back(
+            std::make_unique<SizeClass>(nodeCapacity / size, size, node));
+      }
+    }
   }
 
   if (useMmapArena_) {
@@ -42,7 +98,8 @@ MmapAllocator::MmapAllocator(const MmapAllocatorOptions& options)
     managedArenas_ = std::make_unique<ManagedMmapArenas>(
         arenaSizeBytes < MmapArena::kMinCapacityBytes
             ? MmapArena::kMinCapacityBytes
-            : arenaSizeBytes);
+            : arenaSizeBytes,
+        options.sharedArenaName);
   }
 }
 
@@ -74,14 +131,19 @@ bool MmapAllocator::allocateNonContiguous(
     }
   }
   MachinePageCount newMapsNeeded = 0;
+  const auto node = threadNumaNode();
   for (int i = 0; i < mix.numSizes; ++i) {
     bool success;
     stats_.recordAllocate(
         sizeClassSizes_[mix.sizeIndices[i]] * kPageSize,
         mix.sizeCounts[i],
         [&]() {
-          success = sizeClasses_[mix.sizeIndices[i]]->allocate(
-              mix.sizeCounts[i], newMapsNeeded, out);
+          success = allocateFromNodes(
+              node,
+              mix.sizeIndices[i],
+              mix.sizeCounts[i],
+              newMapsNeeded,
+              out);
         });
     if (TestValue::enabled()) {
       // NOTE: the test callback might overwrite 'success' to inject an
@@ -117,6 +179,42 @@ bool MmapAllocator::allocateNonContiguous(
   return false;
 }
 
+bool MmapAllocator::allocateFromNodes(
+    int32_t node,
+    int32_t sizeIndex,
+    ClassPageCount numPages,
+    MachinePageCount& numUnmapped,
+    Allocation& out) {
+  const auto unitSize = sizeClassSizes_[sizeIndex];
+  for (auto i = 0; i < numNumaNodes_; ++i) {
+    const auto previousPages = out.numPages();
+    if (sizeClass((node + i) % numNumaNodes_, sizeIndex)
+            .allocate(numPages, numUnmapped, out)) {
+      if (i > 0) {
+        ++numCrossNodeAllocations_;
+      }
+      return true;
+    }
+    // A failed allocation may have added some pages to 'out'. These are
+    // freed with 'out'.
+    numPages -= (out.numPages() - previousPages) / unitSize;
+  }
+  return false;
+}
+
+void MmapAllocator::setThreadNumaNode(int32_t node) {
+  threadNumaNodeOverride = node;
+}
+
+int32_t MmapAllocator::threadNumaNode() const {
+  if (numNumaNodes_ == 1) {
+    return 0;
+  }
+  const auto node = threadNumaNodeOverride >= 0 ? threadNumaNodeOverride
+                                                : currentNumaNode();
+  return node % numNumaNodes_;
+}
+
 bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
   std::lock_guard<std::mutex> l(sizeClassBalanceMutex_);
   if (injectedFailure_ == Failure::kMadvise) {
@@ -165,7 +263,8 @@ MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
       // Increment the free time only if the allocation contained
       // pages in the class. Note that size class indices in the
       // allocator are not necessarily the same as in the stats.
-      auto sizeIndex = Stats::sizeIndex(sizeClassSizes_[i] * kPageSize);
+      auto sizeIndex = Stats::sizeIndex(
+          sizeClassSizes_[i % sizeClassSizes_.size()] * kPageSize);
       stats_.sizes[sizeIndex].freeClocks += clocks;
     }
     numFreed += pages;
@@ -201,6 +300,7 @@ bool MmapAllocator::allocateContiguousImpl(
   }
   int64_t numLargeCollateralPages = allocation.numPages();
   if (numLargeCollateralPages) {
+    hugePageBytes_ -= hugePageBytes(allocation.data(), allocation.size());
     if (useMmapArena_) {
       std::lock_guard<std::mutex> l(arenaMutex_);
       managedArenas_->free(allocation.data(), allocation.size());
@@ -283,13 +383,7 @@ bool MmapAllocator::allocateContiguousImpl(
       std::lock_guard<std::mutex> l(arenaMutex_);
       data = managedArenas_->allocate(numPages * kPageSize);
     } else {
-      data = mmap(
-          nullptr,
-          numPages * kPageSize,
-          PROT_READ | PROT_WRITE,
-          MAP_PRIVATE | MAP_ANONYMOUS,
-          -1,
-          0);
+      data = mapContiguous(numPages * kPageSize);
     }
   }
   if (!data) {
@@ -298,13 +392,76 @@ bool MmapAllocator::allocateContiguousImpl(
     rollbackAllocation(numToMap);
     return false;
   }
+  adviseHugePages(data, numPages * kPageSize);
 
   allocation.reset(this, data, numPages * kPageSize);
   return true;
 }
 
+void* FOLLY_NULLABLE MmapAllocator::mapContiguous(uint64_t bytes) {
+  const bool huge =
+      hugePageThresholdBytes_ && bytes >= hugePageThresholdBytes_;
+  // Maps an extra huge page to find an aligned start and unmaps the extra.
+  const uint64_t mapBytes = huge ? bytes + kHugePageSize : bytes;
+  void* data = mmap(
+      nullptr,
+      mapBytes,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  if (!huge) {
+    return data;
+  }
+  auto* start = reinterpret_cast<char*>(data);
+  auto* aligned = reinterpret_cast<char*>(
+      bits::roundUp(reinterpret_cast<uint64_t>(start), kHugePageSize));
+  if (aligned > start) {
+    munmap(start, aligned - start);
+  }
+  const auto tail = (start + mapBytes) - (aligned + bytes);
+  if (tail > 0) {
+    munmap(aligned + bytes, tail);
+  }
+  return aligned;
+}
+
+void MmapAllocator::adviseHugePages(void* FOLLY_NONNULL data, uint64_t bytes) {
+  const auto numHugeBytes = hugePageBytes(data, bytes);
+  if (!numHugeBytes) {
+    return;
+  }
+#ifdef MADV_HUGEPAGE
+  auto* start = reinterpret_cast<char*>(bits::roundUp(
+      reinterpret_cast<uint64_t>(data), static_cast<uint64_t>(kHugePageSize)));
+  if (madvise(start, numHugeBytes, MADV_HUGEPAGE) != 0) {
+    LOG(WARNING) << "madvise MADV_HUGEPAGE failed with " << errno;
+  }
+#endif
+  hugePageBytes_ += numHugeBytes;
+}
+
+int64_t MmapAllocator::hugePageBytes(
+    const void* FOLLY_NONNULL data,
+    uint64_t bytes) const {
+  if (!hugePageThresholdBytes_ || bytes < hugePageThresholdBytes_) {
+    return 0;
+  }
+  const auto begin = bits::roundUp(
+      reinterpret_cast<uint64_t>(data), static_cast<uint64_t>(kHugePageSize));
+  const auto end = reinterpret_cast<uint64_t>(data) + bytes;
+  if (end <= begin) {
+    return 0;
+  }
+  return (end - begin) - (end - begin) % kHugePageSize;
+}
+
 void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
   if (allocation.data() && allocation.size()) {
+    hugePageBytes_ -= hugePageBytes(allocation.data(), allocation.size());
     if (useMmapArena_) {
       std::lock_guard<std::mutex> l(arenaMutex_);
       managedArenas_->free(allocation.data(), allocation.size());
@@ -338,7 +495,10 @@ MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   return numAway;
 }
 
-MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
+MmapAllocator::SizeClass::SizeClass(
+    size_t capacity,
+    MachinePageCount unitSize,
+    int32_t numaNode)
     : capacity_(capacity),
       unitSize_(unitSize),
       byteSize_(capacity_ * unitSize_ * kPageSize),
@@ -364,6 +524,9 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
         errno);
   }
   address_ = reinterpret_cast<uint8_t*>(ptr);
+  if (numaNode >= 0) {
+    preferNumaNode(address_, byteSize_, numaNode);
+  }
 }
 
 MmapAllocator::SizeClass::~SizeClass() {
@@ -763,7 +926,8 @@ std::string MmapAllocator::toString() const {
   std::stringstream out;
   out << "[Memory capacity " << capacity_ << " free "
       << static_cast<int64_t>(capacity_ - numAllocated_) << " mapped "
-      << numMapped_ << std::endl;
+      << numMapped_ << " cross node allocations " << numCrossNodeAllocations_
+      << " huge page bytes " << hugePageBytes_ << std::endl;
   for (auto& sizeClass : sizeClasses_) {
     out << sizeClass->toString() << std::endl;
   }
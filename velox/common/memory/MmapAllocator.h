@@ -46,6 +46,22 @@ struct MmapAllocatorOptions {
   // Used to determine MmapArena capacity. The ratio represents system memory
   // capacity to single MmapArena capacity ratio.
   int32_t mmapArenaCapacityRatio = 10;
+
+  // If not empty and 'useMmapArena' is set, the MmapArenas are backed by
+  // shared memory objects named '<sharedArenaName>.<n>' which co-located
+  // processes can map read-only with SharedArenaView.
+  std::string sharedArenaName;
+
+  // Number of NUMA nodes. If > 1, each node has its own size classes whose
+  // memory is preferably placed on the node and an allocation takes pages
+  // from the size classes of the node of the calling thread. Each node gets
+  // an equal share of 'capacity'. Must be less than 64.
+  int32_t numNumaNodes = 1;
+
+  // If not 0, contiguous allocations of at least this many bytes are aligned
+  // to and advised to use transparent huge pages. This reduces TLB misses for
+  // randomly accessed large allocations like hash tables.
+  int64_t hugePageThresholdBytes = 0;
 };
 
 // Implementation of MappedMemory with mmap and madvise. Each size
@@ -128,9 +144,27 @@ class MmapAllocator : public MappedMemory {
   Stats stats() const override {
     auto stats = stats_;
     stats.numAdvise = numAdvisedPages_;
+    stats.numCrossNodeAllocations = numCrossNodeAllocations_;
+    stats.hugePageBytes = hugePageBytes_;
     return stats;
   }
 
+  // Size of a transparent huge page.
+  static constexpr int64_t kHugePageSize = 2 << 20;
+
+  int32_t numNumaNodes() const {
+    return numNumaNodes_;
+  }
+
+  // Sets the NUMA node the calling thread allocates from, e.g. for a thread
+  // bound to the CPUs of a node. A negative 'node' reverts to the node of the
+  // CPU the thread runs on.
+  static void setThreadNumaNode(int32_t node);
+
+  // Returns the NUMA node the calling thread allocates from, modulo
+  // 'numNumaNodes_'.
+  int32_t threadNumaNode() const;
+
  private:
   static constexpr uint64_t kAllSet = 0xffffffffffffffff;
 
@@ -138,7 +172,12 @@ class MmapAllocator : public MappedMemory {
   // 'unitSize_' machine pages.
   class SizeClass {
    public:
-    SizeClass(size_t capacity, MachinePageCount unitSize);
+    // If 'numaNode' is not negative, the memory of 'this' is preferably
+    // placed on that node.
+    SizeClass(
+        size_t capacity,
+        MachinePageCount unitSize,
+        int32_t numaNode = -1);
 
     ~SizeClass();
 
@@ -300,6 +339,19 @@ class MmapAllocator : public MappedMemory {
 
   void freeContiguousImpl(ContiguousAllocation& allocation);
 
+  // Maps 'bytes' of anonymous memory. If 'bytes' is at least
+  // 'hugePageThresholdBytes_', the memory starts at a huge page boundary and
+  // is advised to be backed by huge pages. Returns nullptr on failure.
+  void* FOLLY_NULLABLE mapContiguous(uint64_t bytes);
+
+  // Advises the memory at 'data' to be backed by huge pages if 'bytes' is at
+  // least 'hugePageThresholdBytes_' and updates 'hugePageBytes_'.
+  void adviseHugePages(void* FOLLY_NONNULL data, uint64_t bytes);
+
+  // Returns the bytes of whole huge pages in the contiguous allocation of
+  // 'bytes' at 'data' if the allocation is eligible for huge pages.
+  int64_t hugePageBytes(const void* FOLLY_NONNULL data, uint64_t bytes) const;
+
   // Ensures that there are at least 'newMappedNeeded' pages that are
   // not backing any existing allocation. If capacity_ - numMapped_ <
   // newMappedNeeded, advises away enough pages backing freed slots in
@@ -319,6 +371,21 @@ class MmapAllocator : public MappedMemory {
   // advises them away. Returns the number of pages advised away.
   MachinePageCount adviseAway(MachinePageCount target);
 
+  // Returns the size class of 'node' for the size at 'sizeIndex' in
+  // 'sizeClassSizes_'.
+  SizeClass& sizeClass(int32_t node, int32_t sizeIndex) {
+    return *sizeClasses_[node * sizeClassSizes_.size() + sizeIndex];
+  }
+
+  // Allocates 'numPages' pages of the size at 'sizeIndex', from the size
+  // class of 'node' first and from the other nodes if 'node' is full.
+  bool allocateFromNodes(
+      int32_t node,
+      int32_t sizeIndex,
+      ClassPageCount numPages,
+      MachinePageCount& numUnmapped,
+      Allocation& out);
+
   // Serializes moving capacity between size classes
   std::mutex sizeClassBalanceMutex_;
 
@@ -340,12 +407,17 @@ class MmapAllocator : public MappedMemory {
   std::atomic<MachinePageCount> numExternalMapped_{0};
   MachinePageCount capacity_ = 0;
 
+  const int32_t numNumaNodes_;
+
+  // The size classes of each NUMA node, in the order of 'sizeClassSizes_'
+  // for each node.
   std::vector<std::unique_ptr<SizeClass>> sizeClasses_;
 
   // Statistics.
   std::atomic<uint64_t> numAllocations_ = 0;
   std::atomic<uint64_t> numAllocatedPages_ = 0;
   std::atomic<uint64_t> numAdvisedPages_ = 0;
+  std::atomic<uint64_t> numCrossNodeAllocations_ = 0;
 
   // Allocations that are larger than largest size classes will be delegated to
   // ManagedMmapArenas, to avoid calling mmap on every allocation.
@@ -357,6 +429,12 @@ class MmapAllocator : public MappedMemory {
   // issued for each such allocation.
   bool useMmapArena_;
 
+  const int64_t hugePageThresholdBytes_;
+
+  // Bytes of whole huge pages in the live contiguous allocations advised to
+  // use huge pages.
+  std::atomic<int64_t> hugePageBytes_{0};
+
   Failure injectedFailure_{Failure::kNone};
   Stats stats_;
 };
@@ -15,7 +15,10 @@
  */
 
 #include "velox/common/memory/MmapArena.h"
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "velox/common/base/BitUtil.h"
 
 namespace facebook::velox::memory {
@@ -24,19 +27,44 @@ uint64_t MmapArena::roundBytes(uint64_t bytes) {
   return bits::nextPowerOfTwo(bytes);
 }
 
-MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
+MmapArena::MmapArena(size_t capacityBytes, std::string sharedName)
+    : byteSize_(capacityBytes), sharedName_(std::move(sharedName)) {
   VELOX_CHECK(
       byteSize_ % kMinGrainSizeBytes == 0,
       "Arena must have a multiple of ",
       kMinGrainSizeBytes,
       " bytes capacity.");
-  void* ptr = mmap(
-      nullptr,
-      capacityBytes,
-      PROT_READ | PROT_WRITE,
-      MAP_PRIVATE | MAP_ANONYMOUS,
-      -1,
-      0);
+  void* ptr;
+  if (sharedName_.empty()) {
+    ptr = mmap(
+        nullptr,
+        capacityBytes,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+  } else {
+    auto fd = shm_open(sharedName_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      VELOX_FAIL(
+          "Could not create shared memory {} with errno {}",
+          sharedName_,
+          errno);
+    }
+    if (ftruncate(fd, capacityBytes) != 0) {
+      auto error = errno;
+      close(fd);
+      shm_unlink(sharedName_.c_str());
+      VELOX_FAIL(
+          "Could not size shared memory {} with errno {}", sharedName_, error);
+    }
+    ptr = mmap(
+        nullptr, capacityBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+      shm_unlink(sharedName_.c_str());
+    }
+  }
   if (ptr == MAP_FAILED || !ptr) {
     VELOX_FAIL(
         "Could not allocate working memory"
@@ -50,6 +78,9 @@ MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
 
 MmapArena::~MmapArena() {
   munmap(address_, byteSize_);
+  if (!sharedName_.empty()) {
+    shm_unlink(sharedName_.c_str());
+  }
 }
 
 void* FOLLY_NULLABLE MmapArena::allocate(uint64_t bytes) {
@@ -85,7 +116,8 @@ void MmapArena::free(void* FOLLY_NONNULL address, uint64_t bytes) {
   }
   bytes = roundBytes(bytes);
 
-  madvise(address, bytes, MADV_DONTNEED);
+  // Shared memory pages stay in the shared memory object unless removed.
+  madvise(address, bytes, sharedName_.empty() ? MADV_DONTNEED : MADV_REMOVE);
   freeBytes_ += bytes;
   auto curAddr = reinterpret_cast<uint64_t>(address);
 
@@ -264,13 +296,49 @@ bool MmapArena::checkConsistency() const {
   return numErrors == 0;
 }
 
-ManagedMmapArenas::ManagedMmapArenas(uint64_t singleArenaCapacity)
-    : singleArenaCapacity_(singleArenaCapacity) {
-  auto arena = std::make_shared<MmapArena>(singleArenaCapacity);
+SharedArenaView::SharedArenaView(const std::string& name) {
+  auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    VELOX_FAIL("Could not open shared memory {} with errno {}", name, errno);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    auto error = errno;
+    close(fd);
+    VELOX_FAIL("Could not stat shared memory {} with errno {}", name, error);
+  }
+  byteSize_ = st.st_size;
+  void* ptr = mmap(nullptr, byteSize_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    VELOX_FAIL("Could not map shared memory {} with errno {}", name, errno);
+  }
+  address_ = reinterpret_cast<const char*>(ptr);
+}
+
+SharedArenaView::~SharedArenaView() {
+  munmap(const_cast<char*>(address_), byteSize_);
+}
+
+ManagedMmapArenas::ManagedMmapArenas(
+    uint64_t singleArenaCapacity,
+    std::string sharedNamePrefix)
+    : singleArenaCapacity_(singleArenaCapacity),
+      sharedNamePrefix_(std::move(sharedNamePrefix)) {
+  auto arena = makeArena();
   arenas_.emplace(reinterpret_cast<uint64_t>(arena->address()), arena);
   currentArena_ = arena;
 }
 
+std::shared_ptr<MmapArena> ManagedMmapArenas::makeArena() {
+  const auto id = nextArenaId_++;
+  if (sharedNamePrefix_.empty()) {
+    return std::make_shared<MmapArena>(singleArenaCapacity_);
+  }
+  return std::make_shared<MmapArena>(
+      singleArenaCapacity_, fmt::format("{}.{}", sharedNamePrefix_, id));
+}
+
 void* FOLLY_NULLABLE ManagedMmapArenas::allocate(uint64_t bytes) {
   auto* result = currentArena_->allocate(bytes);
   if (result) {
@@ -280,7 +348,7 @@ void* FOLLY_NULLABLE ManagedMmapArenas::allocate(uint64_t bytes) {
   // If first allocation fails we create a new MmapArena for another attempt. If
   // it ever fails again then it means requested bytes is larger than a single
   // MmapArena's capacity. No further attempts will happen.
-  auto newArena = std::make_shared<MmapArena>(singleArenaCapacity_);
+  auto newArena = makeArena();
   arenas_.emplace(reinterpret_cast<uint64_t>(newArena->address()), newArena);
   currentArena_ = newArena;
   return currentArena_->allocate(bytes);
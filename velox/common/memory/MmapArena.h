@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <string>
 #include <unordered_set>
 #include "velox/common/memory/MappedMemory.h"
 
@@ -35,7 +36,12 @@ class MmapArena {
   // MmapArena capacity should be multiple of kMinGrainSizeBytes.
   static constexpr uint64_t kMinGrainSizeBytes = 1024 * 1024; // 1M
 
-  MmapArena(size_t capacityBytes);
+  // If 'sharedName' is not empty, the arena is backed by a POSIX shared memory
+  // object of that name instead of anonymous memory, so that other processes
+  // on the host can map it read-only with SharedArenaView. The name must start
+  // with '/' and not exist. The object is unlinked when the arena is
+  // destroyed.
+  MmapArena(size_t capacityBytes, std::string sharedName = "");
   ~MmapArena();
 
   void* FOLLY_NULLABLE allocate(uint64_t bytes);
@@ -48,6 +54,10 @@ class MmapArena {
     return byteSize_;
   }
 
+  const std::string& sharedName() const {
+    return sharedName_;
+  }
+
   const std::map<uint64_t, uint64_t>& freeList() const {
     return freeList_;
   }
@@ -103,6 +113,10 @@ class MmapArena {
   // Total capacity size of this arena
   const uint64_t byteSize_;
 
+  // Name of the shared memory object backing this arena or empty if the
+  // arena is anonymous memory.
+  const std::string sharedName_;
+
   std::atomic<uint64_t> freeBytes_;
 
   // A sorted list with each entry mapping from free block address to size of
@@ -114,12 +128,46 @@ class MmapArena {
   std::map<uint64_t, std::unordered_set<uint64_t>> freeLookup_;
 };
 
+/// A read-only mapping of a shared MmapArena created by another process. The
+/// view sees the arena's memory at a different address, so that data in
+/// the arena must be located by offsets from the start of the arena rather
+/// than by pointers. The view stays valid after the creating arena is
+/// destroyed but then no longer receives updates.
+class SharedArenaView {
+ public:
+  // Maps the shared memory object 'name' of a MmapArena. Throws if there is
+  // no such object.
+  explicit SharedArenaView(const std::string& name);
+
+  ~SharedArenaView();
+
+  SharedArenaView(const SharedArenaView&) = delete;
+  SharedArenaView& operator=(const SharedArenaView&) = delete;
+
+  const char* FOLLY_NONNULL address() const {
+    return address_;
+  }
+
+  uint64_t byteSize() const {
+    return byteSize_;
+  }
+
+ private:
+  const char* FOLLY_NONNULL address_;
+  uint64_t byteSize_;
+};
+
 /// A class that manages a set of MmapArenas. It is able to adapt itself by
 /// growing the number of its managed MmapArena's when extreme memory
 /// fragmentation happens.
 class ManagedMmapArenas {
  public:
-  ManagedMmapArenas(uint64_t singleArenaCapacity);
+  // If 'sharedNamePrefix' is not empty, the arenas are backed by shared
+  // memory objects named '<sharedNamePrefix>.<n>' where n is the sequence
+  // number of the arena.
+  ManagedMmapArenas(
+      uint64_t singleArenaCapacity,
+      std::string sharedNamePrefix = "");
 
   void* FOLLY_NULLABLE allocate(uint64_t bytes);
 
@@ -139,6 +187,15 @@ class ManagedMmapArenas {
 
   /// Capacity in bytes for a single MmapArena managed by this.
   const uint64_t singleArenaCapacity_;
+
+  /// Prefix of the shared memory object names of the arenas, empty if the
+  /// arenas are not shared.
+  const std::string sharedNamePrefix_;
+
+  /// Sequence number of the next arena.
+  int32_t nextArenaId_{0};
+
+  std::shared_ptr<MmapArena> makeArena();
 };
 
 } // namespace facebook::velox::memory
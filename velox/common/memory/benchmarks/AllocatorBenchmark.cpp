@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <folly/memory/Malloc.h>
+
+#include <iostream>
+#include <map>
+#include <thread>
+
+#include "velox/common/memory/AllocationPool.h"
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/common/memory/MmapAllocator.h"
+
+DEFINE_string(
+    threads,
+    "1,4,16",
+    "Comma separated numbers of threads that allocate at the same time");
+DEFINE_string(
+    sizes,
+    "64,1024,16384,262144,2097152",
+    "Comma separated allocation sizes in bytes. Each allocation is of a random "
+    "size between half of the size and the size");
+DEFINE_int64(num_ops, 1'000'000, "Allocations per benchmark run");
+DEFINE_int64(
+    live_mb_per_thread,
+    64,
+    "MB of allocations each thread keeps live while allocating");
+DEFINE_int32(
+    numa_nodes,
+    1,
+    "NUMA nodes of the MmapAllocator. Threads are assigned to these round "
+    "robin");
+DEFINE_int64(capacity_mb, 16 << 10, "Capacity of the MmapAllocator in MB");
+
+using namespace facebook::velox;
+using namespace facebook::velox::memory;
+
+// Measures allocate and free throughput of the Velox allocators and of the
+// process malloc, which is jemalloc if the binary links it. Each benchmark
+// runs 'num_ops' allocations of one size class, split between a number of
+// threads. Each thread keeps a window of live allocations and frees the oldest
+// before each allocation, so that allocations of different sizes and threads
+// interleave. Folly reports the time per allocation. After the benchmarks,
+// prints the bytes each allocator retains per live byte at the end of the
+// run on the most threads, which measures fragmentation.
+namespace {
+// Adapts an allocator to the benchmark. 'thread' is the index of the calling
+// thread, for allocators that are not thread safe and have an instance per
+// thread.
+class BenchmarkAllocator {
+ public:
+  virtual ~BenchmarkAllocator() = default;
+
+  // Called on each thread before its first allocation.
+  virtual void initThread(int32_t /*thread*/) {}
+
+  virtual void* allocate(int32_t thread, int64_t size) = 0;
+
+  virtual void free(int32_t thread, void* p, int64_t size) = 0;
+
+  // Returns the bytes the allocator holds, or -1 if not known.
+  virtual int64_t retainedBytes() const {
+    return -1;
+  }
+};
+
+class MallocBenchmarkAllocator : public BenchmarkAllocator {
+ public:
+  void* allocate(int32_t /*thread*/, int64_t size) override {
+    return ::malloc(size);
+  }
+
+  void free(int32_t /*thread*/, void* p, int64_t /*size*/) override {
+    ::free(p);
+  }
+};
+
+std::unique_ptr<MmapAllocator> makeMmapAllocator() {
+  MmapAllocatorOptions options;
+  options.capacity = FLAGS_capacity_mb << 20;
+  options.numNumaNodes = FLAGS_numa_nodes;
+  return std::make_unique<MmapAllocator>(options);
+}
+
+// Allocates from the size classes of an MmapAllocator. Sizes below a page
+// take a page, since a size of at most kMaxMallocBytes would otherwise go to
+// malloc.
+class MmapBenchmarkAllocator : public BenchmarkAllocator {
+ public:
+  void initThread(int32_t thread) override {
+    if (FLAGS_numa_nodes > 1) {
+      MmapAllocator::setThreadNumaNode(thread % FLAGS_numa_nodes);
+    }
+  }
+
+  void* allocate(int32_t /*thread*/, int64_t size) override {
+    return allocator_->allocateBytes(size, 0);
+  }
+
+  void free(int32_t /*thread*/, void* p, int64_t size) override {
+    allocator_->freeBytes(p, size, 0);
+  }
+
+  int64_t retainedBytes() const override {
+    return allocator_->numMapped() * MappedMemory::kPageSize;
+  }
+
+ private:
+  const std::unique_ptr<MmapAllocator> allocator_{makeMmapAllocator()};
+};
+
+// Allocates from a leaf MemoryPool shared by all threads.
+class MemoryPoolBenchmarkAllocator : public BenchmarkAllocator {
+ public:
+  void* allocate(int32_t /*thread*/, int64_t size) override {
+    return pool_->allocate(size);
+  }
+
+  void free(int32_t /*thread*/, void* p, int64_t size) override {
+    pool_->free(p, size);
+  }
+
+ private:
+  const std::shared_ptr<MemoryPool> pool_{getDefaultMemoryPool()};
+};
+
+// Allocates from a HashStringAllocator per thread over a shared
+// MmapAllocator.
+class HashStringBenchmarkAllocator : public BenchmarkAllocator {
+ public:
+  explicit HashStringBenchmarkAllocator(int32_t numThreads) {
+    for (auto i = 0; i < numThreads; ++i) {
+      allocators_.push_back(
+          std::make_unique<HashStringAllocator>(mappedMemory_.get()));
+    }
+  }
+
+  void initThread(int32_t thread) override {
+    if (FLAGS_numa_nodes > 1) {
+      MmapAllocator::setThreadNumaNode(thread % FLAGS_numa_nodes);
+    }
+  }
+
+  void* allocate(int32_t thread, int64_t size) override {
+    return allocators_[thread]->allocate(size)->begin();
+  }
+
+  void free(int32_t thread, void* p, int64_t /*size*/) override {
+    allocators_[thread]->free(HashStringAllocator::headerOf(p));
+  }
+
+  int64_t retainedBytes() const override {
+    int64_t bytes = 0;
+    for (auto& allocator : allocators_) {
+      bytes += allocator->retainedSize();
+    }
+    return bytes;
+  }
+
+ private:
+  const std::unique_ptr<MmapAllocator> mappedMemory_{makeMmapAllocator()};
+  std::vector<std::unique_ptr<HashStringAllocator>> allocators_;
+};
+
+// Allocates from an AllocationPool per thread over a shared MmapAllocator.
+// An AllocationPool does not free single allocations, so free() is a no-op
+// and each pool is cleared after every 2 * 'live_mb_per_thread' MB
+// allocated, like an arena that is reset between batches.
+class AllocationPoolBenchmarkAllocator : public BenchmarkAllocator {
+ public:
+  explicit AllocationPoolBenchmarkAllocator(int32_t numThreads)
+      : bytesSinceClear_(numThreads, 0) {
+    for (auto i = 0; i < numThreads; ++i) {
+      pools_.push_back(std::make_unique<AllocationPool>(mappedMemory_.get()));
+    }
+  }
+
+  void initThread(int32_t thread) override {
+    if (FLAGS_numa_nodes > 1) {
+      MmapAllocator::setThreadNumaNode(thread % FLAGS_numa_nodes);
+    }
+  }
+
+  void* allocate(int32_t thread, int64_t size) override {
+    if (bytesSinceClear_[thread] > 2 * (FLAGS_live_mb_per_thread << 20)) {
+      pools_[thread]->clear();
+      bytesSinceClear_[thread] = 0;
+    }
+    bytesSinceClear_[thread] += size;
+    return pools_[thread]->allocateFixed(size);
+  }
+
+  void free(int32_t /*thread*/, void* /*p*/, int64_t /*size*/) override {}
+
+  int64_t retainedBytes() const override {
+    int64_t bytes = 0;
+    for (auto& pool : pools_) {
+      bytes += pool->allocatedBytes();
+    }
+    return bytes;
+  }
+
+ private:
+  const std::unique_ptr<MmapAllocator> mappedMemory_{makeMmapAllocator()};
+  std::vector<std::unique_ptr<AllocationPool>> pools_;
+  std::vector<int64_t> bytesSinceClear_;
+};
+
+enum class AllocatorKind {
+  kMalloc,
+  kMmap,
+  kMemoryPool,
+  kHashString,
+  kAllocationPool
+};
+
+std::string kindName(AllocatorKind kind) {
+  switch (kind) {
+    case AllocatorKind::kMalloc:
+      return folly::usingJEMalloc() ? "jemalloc" : "malloc";
+    case AllocatorKind::kMmap:
+      return "mmap";
+    case AllocatorKind::kMemoryPool:
+      return "memoryPool";
+    case AllocatorKind::kHashString:
+      return "hashString";
+    case AllocatorKind::kAllocationPool:
+      return "allocationPool";
+  }
+  VELOX_UNREACHABLE();
+}
+
+std::unique_ptr<BenchmarkAllocator> makeAllocator(
+    AllocatorKind kind,
+    int32_t numThreads) {
+  switch (kind) {
+    case AllocatorKind::kMalloc:
+      return std::make_unique<MallocBenchmarkAllocator>();
+    case AllocatorKind::kMmap:
+      return std::make_unique<MmapBenchmarkAllocator>();
+    case AllocatorKind::kMemoryPool:
+      return std::make_unique<MemoryPoolBenchmarkAllocator>();
+    case AllocatorKind::kHashString:
+      return std::make_unique<HashStringBenchmarkAllocator>(numThreads);
+    case AllocatorKind::kAllocationPool:
+      return std::make_unique<AllocationPoolBenchmarkAllocator>(numThreads);
+  }
+  VELOX_UNREACHABLE();
+}
+
+struct RunStats {
+  // Bytes of the allocations live at the end of the run.
+  int64_t liveBytes{0};
+  // Bytes the allocator holds at the end of the run, -1 if not known.
+  int64_t retainedBytes{-1};
+};
+
+// Makes 'numOps' allocations of sizes in [size / 2, size] from 'allocator',
+// split between 'numThreads' threads. Each allocation writes its first byte.
+RunStats runChurn(
+    BenchmarkAllocator& allocator,
+    int64_t size,
+    int32_t numThreads,
+    int64_t numOps) {
+  struct Live {
+    void* data;
+    int64_t size;
+  };
+  const auto windowSize = std::max<int64_t>(
+      16, std::min<int64_t>(4096, (FLAGS_live_mb_per_thread << 20) / size));
+  std::vector<std::vector<Live>> windows(numThreads);
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads);
+  for (auto thread = 0; thread < numThreads; ++thread) {
+    threads.emplace_back([&, thread]() {
+      allocator.initThread(thread);
+      folly::Random::DefaultGenerator rng(thread);
+      auto& window = windows[thread];
+      window.resize(windowSize, Live{nullptr, 0});
+      const auto threadOps = numOps / numThreads;
+      for (int64_t i = 0; i < threadOps; ++i) {
+        auto& slot = window[i % windowSize];
+        if (slot.data) {
+          allocator.free(thread, slot.data, slot.size);
+        }
+        slot.size = size / 2 + folly::Random::rand64(size / 2 + 1, rng);
+        slot.data = allocator.allocate(thread, slot.size);
+        VELOX_CHECK_NOT_NULL(slot.data);
+        *reinterpret_cast<char*>(slot.data) = 1;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  RunStats stats;
+  stats.retainedBytes = allocator.retainedBytes();
+  for (auto thread = 0; thread < numThreads; ++thread) {
+    for (auto& slot : windows[thread]) {
+      if (slot.data) {
+        stats.liveBytes += slot.size;
+        allocator.free(thread, slot.data, slot.size);
+      }
+    }
+  }
+  return stats;
+}
+
+std::vector<int64_t> parseList(const std::string& list) {
+  std::vector<folly::StringPiece> items;
+  folly::split(',', list, items);
+  std::vector<int64_t> numbers;
+  for (auto item : items) {
+    numbers.push_back(folly::to<int64_t>(item));
+  }
+  return numbers;
+}
+
+const std::vector<AllocatorKind> kAllocatorKinds = {
+    AllocatorKind::kMalloc,
+    AllocatorKind::kMmap,
+    AllocatorKind::kMemoryPool,
+    AllocatorKind::kHashString,
+    AllocatorKind::kAllocationPool};
+
+// The stats of the run on the most threads by allocator and size.
+std::map<std::string, RunStats> runStats;
+
+// Adds the benchmarks for all allocators, sizes and numbers of threads.
+void addBenchmarks() {
+  const auto sizes = parseList(FLAGS_sizes);
+  const auto numThreads = parseList(FLAGS_threads);
+  const auto maxThreads =
+      *std::max_element(numThreads.begin(), numThreads.end());
+  for (auto kind : kAllocatorKinds) {
+    for (auto size : sizes) {
+      for (auto threads : numThreads) {
+        auto name = fmt::format("{}_{}B_{}t", kindName(kind), size, threads);
+        folly::addBenchmark(
+            __FILE__,
+            name,
+            [kind, size, threads, maxThreads, name](unsigned iterations) {
+              std::unique_ptr<BenchmarkAllocator> allocator;
+              BENCHMARK_SUSPEND {
+                allocator = makeAllocator(kind, threads);
+              }
+              RunStats stats;
+              for (unsigned i = 0; i < iterations; ++i) {
+                stats = runChurn(*allocator, size, threads, FLAGS_num_ops);
+              }
+              if (threads == maxThreads) {
+                runStats[fmt::format("{}_{}B", kindName(kind), size)] = stats;
+              }
+              BENCHMARK_SUSPEND {
+                allocator.reset();
+              }
+              return iterations * FLAGS_num_ops;
+            });
+      }
+    }
+  }
+}
+
+// Prints the bytes retained per live byte at the end of each run on the most
+// threads. 1 is no overhead. Allocators that do not report retained bytes are
+// left out.
+void printStats() {
+  std::cout << "Retained bytes per live byte:" << std::endl;
+  for (auto& [name, stats] : runStats) {
+    if (stats.retainedBytes < 0 || stats.liveBytes == 0) {
+      continue;
+    }
+    std::cout << fmt::format(
+                     "{:<32} live {:>12} retained {:>12} ratio {:.2f}",
+                     name,
+                     stats.liveBytes,
+                     stats.retainedBytes,
+                     stats.retainedBytes / static_cast<double>(stats.liveBytes))
+              << std::endl;
+  }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  addBenchmarks();
+  folly::runBenchmarks();
+  printStats();
+  return 0;
+}
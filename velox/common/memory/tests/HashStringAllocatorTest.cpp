@@ -108,6 +108,37 @@ TEST_F(HashStringAllocatorTest, allocate) {
   EXPECT_LE(instance_->retainedSize() - instance_->freeSpace(), 200);
 }
 
+TEST_F(HashStringAllocatorTest, reuseFreeBlocks) {
+  // Interleaves small and large blocks so that the freed blocks of each size
+  // do not merge.
+  std::vector<HashStringAllocator::Header*> small;
+  std::vector<HashStringAllocator::Header*> large;
+  for (auto i = 0; i < 1'000; ++i) {
+    small.push_back(allocate(20));
+    large.push_back(allocate(1'000));
+  }
+  const auto retainedSize = instance_->retainedSize();
+  for (auto i = 0; i < 1'000; i += 2) {
+    instance_->free(small[i]);
+    instance_->free(large[i + 1]);
+  }
+  instance_->checkConsistency();
+
+  // The large blocks are found among the many small free blocks of another
+  // size class.
+  for (auto i = 0; i < 1'000; i += 2) {
+    large[i + 1] = allocate(1'000);
+    EXPECT_GE(large[i + 1]->size(), 1'000);
+  }
+  instance_->checkConsistency();
+  EXPECT_EQ(retainedSize, instance_->retainedSize());
+  for (auto i = 0; i < 1'000; i += 2) {
+    small[i] = allocate(20);
+  }
+  instance_->checkConsistency();
+  EXPECT_EQ(retainedSize, instance_->retainedSize());
+}
+
 TEST_F(HashStringAllocatorTest, multipart) {
   constexpr int32_t kNumSamples = 10'000;
   std::vector<Multipart> data(kNumSamples);
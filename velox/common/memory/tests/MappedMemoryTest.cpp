@@ -21,6 +21,7 @@
 #include "velox/common/testutil/TestValue.h"
 
 #include <thread>
+#include <unistd.h>
 
 #include <folly/Random.h>
 #include <folly/Range.h>
@@ -784,6 +785,69 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
     MappedMemoryTest,
     testing::Values(true, false));
 
+TEST(MmapAllocatorTest, numaNodes) {
+  constexpr int64_t kNodeBytes = 128 << 20;
+  MmapAllocatorOptions options;
+  options.capacity = 2 * kNodeBytes;
+  options.numNumaNodes = 2;
+  MmapAllocator allocator(options);
+  EXPECT_EQ(2, allocator.numNumaNodes());
+  MmapAllocator::setThreadNumaNode(3);
+  EXPECT_EQ(1, allocator.threadNumaNode());
+
+  // The first allocation fills the size classes of the thread's node and the
+  // second one takes pages from the other node.
+  MappedMemory::Allocation local(&allocator);
+  ASSERT_TRUE(allocator.allocateNonContiguous(
+      kNodeBytes / MappedMemory::kPageSize, local));
+  EXPECT_EQ(0, allocator.stats().numCrossNodeAllocations);
+  MappedMemory::Allocation remote(&allocator);
+  ASSERT_TRUE(allocator.allocateNonContiguous(
+      kNodeBytes / 2 / MappedMemory::kPageSize, remote));
+  EXPECT_EQ(1, allocator.stats().numCrossNodeAllocations);
+  EXPECT_TRUE(allocator.checkConsistency());
+
+  // The capacity is shared by the nodes.
+  MappedMemory::Allocation tooLarge(&allocator);
+  EXPECT_FALSE(allocator.allocateNonContiguous(
+      kNodeBytes / MappedMemory::kPageSize, tooLarge));
+  MmapAllocator::setThreadNumaNode(-1);
+}
+
+TEST(MmapAllocatorTest, hugePages) {
+  constexpr int64_t kHugePageSize = MmapAllocator::kHugePageSize;
+  MmapAllocatorOptions options;
+  options.capacity = 256 << 20;
+  options.hugePageThresholdBytes = 4 * kHugePageSize;
+  MmapAllocator allocator(options);
+
+  // Allocations under the threshold are not advised.
+  MappedMemory::ContiguousAllocation small;
+  ASSERT_TRUE(allocator.allocateContiguous(
+      2 * kHugePageSize / MappedMemory::kPageSize, nullptr, small));
+  EXPECT_EQ(0, allocator.stats().hugePageBytes);
+
+  // A large allocation starts at a huge page boundary. The partial huge page
+  // at the end is not counted.
+  MappedMemory::ContiguousAllocation large;
+  ASSERT_TRUE(allocator.allocateContiguous(
+      (6 * kHugePageSize + (1 << 20)) / MappedMemory::kPageSize,
+      nullptr,
+      large));
+  EXPECT_EQ(0, reinterpret_cast<uint64_t>(large.data()) % kHugePageSize);
+  EXPECT_EQ(6 * kHugePageSize, allocator.stats().hugePageBytes);
+  memset(large.data(), 1, large.size());
+
+  // Reallocating 'large' as collateral takes back its huge pages.
+  ASSERT_TRUE(allocator.allocateContiguous(
+      8 * kHugePageSize / MappedMemory::kPageSize, nullptr, large));
+  EXPECT_EQ(8 * kHugePageSize, allocator.stats().hugePageBytes);
+  allocator.freeContiguous(large);
+  allocator.freeContiguous(small);
+  EXPECT_EQ(0, allocator.stats().hugePageBytes);
+  EXPECT_EQ(0, allocator.numAllocated());
+}
+
 class MmapArenaTest : public testing::Test {
  public:
   // 32 MB arena space
@@ -920,4 +984,34 @@ TEST_F(MmapArenaTest, managedMmapArenas) {
     EXPECT_EQ(managedArenas->arenas().size(), 2);
   }
 }
+
+TEST_F(MmapArenaTest, sharedArena) {
+  const std::string name = fmt::format("/velox_arena_test.{}", getpid());
+  {
+    MmapArena arena(kArenaCapacityBytes, name);
+    EXPECT_EQ(name, arena.sharedName());
+    // The name of a live arena can't be reused.
+    EXPECT_THROW(MmapArena(kArenaCapacityBytes, name), VeloxRuntimeError);
+
+    auto* data = reinterpret_cast<char*>(allocateAndPad(&arena, 1 << 20));
+    SharedArenaView view(name);
+    EXPECT_EQ(kArenaCapacityBytes, view.byteSize());
+    const auto offset = data - reinterpret_cast<char*>(arena.address());
+    EXPECT_EQ(0, memcmp(data, view.address() + offset, 1 << 20));
+
+    // The view sees later writes.
+    data[100] = 11;
+    EXPECT_EQ(11, view.address()[offset + 100]);
+    unpadAndFree(&arena, data, 1 << 20);
+    EXPECT_TRUE(arena.checkConsistency());
+  }
+  // The shared memory is unlinked with the arena.
+  EXPECT_THROW(SharedArenaView view(name), VeloxRuntimeError);
+
+  ManagedMmapArenas managedArenas(kArenaCapacityBytes, name);
+  managedArenas.allocate(kArenaCapacityBytes);
+  managedArenas.allocate(kArenaCapacityBytes);
+  EXPECT_EQ(2, managedArenas.arenas().size());
+  EXPECT_EQ(kArenaCapacityBytes, SharedArenaView(name + ".1").byteSize());
+}
 } // namespace facebook::velox::memory
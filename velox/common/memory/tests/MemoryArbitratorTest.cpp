@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+using namespace ::testing;
+using namespace ::facebook::velox::memory;
+using namespace ::facebook::velox;
+
+namespace {
+constexpr int64_t kMB = 1 << 20;
+
+MemoryArbitrator::Config arbitratorConfig() {
+  MemoryArbitrator::Config config;
+  config.capacity = 128 * kMB;
+  config.initQueryCapacity = 0;
+  config.minGrowBytes = 8 * kMB;
+  return config;
+}
+} // namespace
+
+TEST(MemoryArbitratorTest, growAndRemove) {
+  MemoryArbitrator arbitrator(arbitratorConfig());
+  auto query1 = MemoryUsageTracker::create();
+  auto child1 = query1->addChild();
+  arbitrator.addQuery(query1);
+  EXPECT_EQ(0, query1->maxTotalBytes());
+
+  // The cap grows by at least 'minGrowBytes'.
+  child1->update(4 * kMB);
+  EXPECT_EQ(8 * kMB, query1->maxTotalBytes());
+  child1->update(4 * kMB);
+  EXPECT_EQ(8 * kMB, query1->maxTotalBytes());
+  child1->update(112 * kMB);
+  EXPECT_EQ(120 * kMB, query1->maxTotalBytes());
+  EXPECT_EQ(8 * kMB, arbitrator.freeCapacity());
+
+  // The other query has no unused capacity and can't free any memory.
+  auto query2 = MemoryUsageTracker::create();
+  auto child2 = query2->addChild();
+  arbitrator.addQuery(query2);
+  EXPECT_THROW(child2->update(16 * kMB), VeloxRuntimeError);
+  EXPECT_EQ(0, query2->getCurrentTotalBytes());
+  EXPECT_EQ(0, query2->maxTotalBytes());
+
+  // Removing a query returns its capacity.
+  child1->update(-120 * kMB);
+  arbitrator.removeQuery(*query1);
+  EXPECT_EQ(128 * kMB, arbitrator.freeCapacity());
+  child2->update(16 * kMB);
+  EXPECT_EQ(16 * kMB, query2->maxTotalBytes());
+  EXPECT_EQ(112 * kMB, arbitrator.freeCapacity());
+
+  const auto stats = arbitrator.stats();
+  EXPECT_EQ(4, stats.numRequests);
+  EXPECT_EQ(1, stats.numFailures);
+  EXPECT_EQ(0, stats.numShrinks);
+  EXPECT_EQ(0, stats.numReclaims);
+  child2->update(-16 * kMB);
+  arbitrator.removeQuery(*query2);
+  EXPECT_EQ(128 * kMB, arbitrator.freeCapacity());
+}
+
+TEST(MemoryArbitratorTest, shrinkUnusedCapacity) {
+  MemoryArbitrator arbitrator(arbitratorConfig());
+  auto query1 = MemoryUsageTracker::create();
+  auto child1 = query1->addChild();
+  arbitrator.addQuery(query1);
+  auto query2 = MemoryUsageTracker::create();
+  auto child2 = query2->addChild();
+  arbitrator.addQuery(query2);
+
+  // The first query keeps its cap after freeing most of its memory.
+  child1->update(64 * kMB);
+  child1->update(-48 * kMB);
+  EXPECT_EQ(64 * kMB, query1->maxTotalBytes());
+  EXPECT_EQ(16 * kMB, query1->getCurrentTotalBytes());
+
+  // The second query takes the unused capacity of the first one.
+  child2->update(96 * kMB);
+  EXPECT_EQ(96 * kMB, query2->maxTotalBytes());
+  EXPECT_EQ(16 * kMB, query1->maxTotalBytes());
+  EXPECT_EQ(16 * kMB, arbitrator.freeCapacity());
+  auto stats = arbitrator.stats();
+  EXPECT_EQ(1, stats.numShrinks);
+  EXPECT_EQ(48 * kMB, stats.shrunkBytes);
+
+  // The first query grows from the free capacity again.
+  child1->update(8 * kMB);
+  EXPECT_EQ(24 * kMB, query1->maxTotalBytes());
+  EXPECT_EQ(8 * kMB, arbitrator.freeCapacity());
+  stats = arbitrator.stats();
+  EXPECT_EQ(3, stats.numRequests);
+  EXPECT_EQ(0, stats.numFailures);
+}
+
+TEST(MemoryArbitratorTest, reclaim) {
+  MemoryArbitrator arbitrator(arbitratorConfig());
+  auto query1 = MemoryUsageTracker::create();
+  auto child1 = query1->addChild();
+  int64_t reclaimTarget = 0;
+  arbitrator.addQuery(query1, [&](int64_t targetBytes) {
+    reclaimTarget = targetBytes;
+    child1->update(-32 * kMB);
+    return 32 * kMB;
+  });
+  auto query2 = MemoryUsageTracker::create();
+  auto child2 = query2->addChild();
+  int32_t numQuery2Reclaims = 0;
+  arbitrator.addQuery(query2, [&](int64_t /*targetBytes*/) {
+    ++numQuery2Reclaims;
+    return 0;
+  });
+
+  child1->update(96 * kMB);
+  EXPECT_EQ(96 * kMB, query1->maxTotalBytes());
+
+  // The first query frees memory for the second one. The requestor isn't asked
+  // to free memory.
+  child2->update(64 * kMB);
+  EXPECT_EQ(32 * kMB, reclaimTarget);
+  EXPECT_EQ(0, numQuery2Reclaims);
+  EXPECT_EQ(64 * kMB, query1->getCurrentTotalBytes());
+  EXPECT_EQ(64 * kMB, query1->maxTotalBytes());
+  EXPECT_EQ(64 * kMB, query2->maxTotalBytes());
+  EXPECT_EQ(0, arbitrator.freeCapacity());
+  const auto stats = arbitrator.stats();
+  EXPECT_EQ(1, stats.numReclaims);
+  EXPECT_EQ(32 * kMB, stats.reclaimedBytes);
+  EXPECT_EQ(1, stats.numShrinks);
+  EXPECT_EQ(0, stats.numFailures);
+}
+
+TEST(MemoryArbitratorTest, maxQueryCapacity) {
+  MemoryArbitrator arbitrator(arbitratorConfig());
+  auto query = MemoryUsageTracker::create(
+      MemoryUsageConfigBuilder().maxTotalMemory(32 * kMB).build());
+  auto child = query->addChild();
+  arbitrator.addQuery(query);
+
+  child->update(16 * kMB);
+  EXPECT_EQ(16 * kMB, query->maxTotalBytes());
+  // The cap doesn't grow beyond the cap the query was added with.
+  EXPECT_THROW(child->update(24 * kMB), VeloxRuntimeError);
+  EXPECT_EQ(16 * kMB, query->maxTotalBytes());
+  child->update(8 * kMB);
+  EXPECT_EQ(24 * kMB, query->maxTotalBytes());
+  EXPECT_EQ(1, arbitrator.stats().numFailures);
+}
+
+TEST(MemoryArbitratorTest, destroyedTracker) {
+  MemoryArbitrator arbitrator(arbitratorConfig());
+  {
+    auto query = MemoryUsageTracker::create();
+    arbitrator.addQuery(query);
+    query->addChild()->update(64 * kMB);
+  }
+  EXPECT_EQ(64 * kMB, arbitrator.freeCapacity());
+
+  // The capacity of the destroyed query is taken back when needed.
+  auto query = MemoryUsageTracker::create();
+  auto child = query->addChild();
+  arbitrator.addQuery(query);
+  child->update(128 * kMB);
+  EXPECT_EQ(128 * kMB, query->maxTotalBytes());
+  EXPECT_EQ(0, arbitrator.freeCapacity());
+}
+
+TEST(MemoryArbitratorTest, initQueryCapacity) {
+  auto config = arbitratorConfig();
+  config.initQueryCapacity = 96 * kMB;
+  auto query1 = MemoryUsageTracker::create();
+  auto query2 = MemoryUsageTracker::create();
+  {
+    MemoryArbitrator arbitrator(config);
+    arbitrator.addQuery(query1);
+    arbitrator.addQuery(query2);
+    EXPECT_EQ(96 * kMB, query1->maxTotalBytes());
+    EXPECT_EQ(32 * kMB, query2->maxTotalBytes());
+    EXPECT_EQ(0, arbitrator.freeCapacity());
+  }
+  // The caps are hard limits after the arbitrator is gone.
+  EXPECT_THROW(query2->addChild()->update(64 * kMB), VeloxRuntimeError);
+}
@@ -283,6 +283,37 @@ TEST(MemoryPoolTest, ReserveTest) {
   ASSERT_EQ(child->getCurrentBytes(), 0);
 }
 
+TEST(MemoryPoolTest, reservationQuantum) {
+  MemoryManager<MemoryAllocator> manager{8 * GB};
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_memory_pool_reservation_quantum = MB;
+  auto child = manager.getRoot().addChild("quantum", 3 * MB + 512 * KB);
+
+  // Small allocations are served from the first quantum.
+  std::vector<std::pair<void*, int64_t>> allocations;
+  for (auto i = 0; i < 100; ++i) {
+    allocations.emplace_back(child->allocate(100), 100);
+  }
+  EXPECT_EQ(MB, child->getCurrentBytes());
+  EXPECT_EQ(MB, manager.getTotalBytes());
+
+  // The reservation grows by whole quanta up to the cap.
+  allocations.emplace_back(child->allocate(2 * MB), 2 * MB);
+  EXPECT_EQ(3 * MB, manager.getTotalBytes());
+  allocations.emplace_back(child->allocate(MB), MB);
+  EXPECT_EQ(3 * MB + 512 * KB, manager.getTotalBytes());
+  VELOX_ASSERT_THROW(child->allocate(MB), "Exceeded memory cap");
+  EXPECT_EQ(3 * MB + 512 * KB, manager.getTotalBytes());
+
+  // Up to a quantum of unused reservation is kept after frees.
+  for (auto& [data, size] : allocations) {
+    child->free(data, size);
+  }
+  EXPECT_EQ(MB, manager.getTotalBytes());
+  child.reset();
+  EXPECT_EQ(0, manager.getTotalBytes());
+}
+
 MachinePageCount numPagesNeeded(
     const MappedMemory* mappedMemory,
     MachinePageCount numPages) {
@@ -32,6 +32,8 @@ DECLARE_bool(avx2); // Enables use of AVX2 when available NOLINT
 
 DECLARE_bool(bmi2); // Enables use of BMI2 when available NOLINT
 
+DECLARE_bool(avx512vbmi); // Enables use of AVX-512 VBMI when available NOLINT
+
 namespace facebook {
 namespace velox {
 namespace process {
@@ -106,6 +108,8 @@ uint64_t threadCpuNanos() {
 namespace {
 bool bmi2CpuFlag = folly::CpuId().bmi2();
 bool avx2CpuFlag = folly::CpuId().avx2();
+bool avx512VbmiCpuFlag = folly::CpuId().avx512f() &&
+    folly::CpuId().avx512bw() && folly::CpuId().avx512vbmi();
 } // namespace
 
 bool hasAvx2() {
@@ -124,6 +128,16 @@ bool hasBmi2() {
 #endif
 }
 
+bool hasAvx512Vbmi() {
+  // The AVX-512 code is compiled with function target attributes, so that it
+  // does not depend on the flags of the build.
+#ifdef __x86_64__
+  return avx512VbmiCpuFlag && FLAGS_avx512vbmi;
+#else
+  return false;
+#endif
+}
+
 } // namespace process
 } // namespace velox
 } // namespace facebook
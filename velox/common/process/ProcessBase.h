@@ -63,6 +63,10 @@ bool hasAvx2();
 // flag.
 bool hasBmi2();
 
+// True if the machine has Intel AVX-512 F, BW and VBMI instructions and these
+// are not disabled by flag.
+bool hasAvx512Vbmi();
+
 } // namespace process
 } // namespace velox
 } // namespace facebook
@@ -60,28 +60,33 @@ class CpuWallTimer {
 // Keeps track of elapsed CPU and wall time from construction time.
 // Composes delta CpuWallTiming upon destruction and passes it to the user
 // callback, where it can be added to the user's CpuWallTiming using
-// CpuWallTiming::add().
+// CpuWallTiming::add(). If the timer measures one in 'weight' calls, the
+// elapsed times are multiplied by 'weight', so that the sum of the timings
+// estimates the time of all calls. The count is always 1.
 template <typename F>
 class DeltaCpuWallTimer {
  public:
-  explicit DeltaCpuWallTimer(F&& func)
+  explicit DeltaCpuWallTimer(F&& func, uint32_t weight = 1)
       : cpuTimeStart_(process::threadCpuNanos()),
         wallTimeStart_(std::chrono::steady_clock::now()),
+        weight_(weight),
         func_(std::move(func)) {}
 
   ~DeltaCpuWallTimer() {
     const CpuWallTiming deltaTiming{
         1,
-        uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                     std::chrono::steady_clock::now() - wallTimeStart_)
-                     .count()),
-        process::threadCpuNanos() - cpuTimeStart_};
+        weight_ *
+            uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - wallTimeStart_)
+                         .count()),
+        weight_ * (process::threadCpuNanos() - cpuTimeStart_)};
     func_(deltaTiming);
   }
 
  private:
   const uint64_t cpuTimeStart_;
   const std::chrono::steady_clock::time_point wallTimeStart_;
+  const uint64_t weight_;
   F func_;
 };
 
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/future/VeloxPromise.h"
@@ -34,6 +35,7 @@ class ExprSet;
 }
 namespace facebook::velox::connector {
 class ConnectorCommitInfo;
+class DataSource;
 class WriteProtocol;
 
 // A split represents a chunk of data that a connector should load and return
@@ -45,6 +47,18 @@ struct ConnectorSplit {
   // async prefetch for the split.
   bool cancelled{false};
 
+  // A DataSource that opens this split ahead of its turn. Set by the
+  // TableScan that preloads the split while it is still queued in the Task.
+  // The prepared DataSource is handed over with
+  // DataSource::setFromDataSource().
+  std::shared_ptr<AsyncSource<std::shared_ptr<DataSource>>> dataSource;
+
+  // Worker on which this should preferably run, e.g. one that reports the
+  // file of the split in AsyncDataCache::residentFiles(). This is a soft
+  // affinity for the scheduler, which may run the split anywhere. Empty if
+  // there is no preference.
+  std::string preferredHost;
+
   explicit ConnectorSplit(const std::string& _connectorId)
       : connectorId(_connectorId) {}
 
@@ -106,6 +120,18 @@ class DataSink {
   virtual void close() = 0;
 };
 
+/// An aggregate that a DataSource may compute from file metadata. See
+/// DataSource::aggregateFromMetadata().
+struct MetadataAggregate {
+  enum class Kind { kCount, kMin, kMax, kSum };
+
+  Kind kind;
+
+  /// The column of the output type of the DataSource to aggregate. Not set
+  /// for count(*).
+  std::optional<column_index_t> channel;
+};
+
 class DataSource {
  public:
   static constexpr int64_t kUnknownRowSize = -1;
@@ -151,6 +177,27 @@ class DataSource {
   virtual int64_t estimatedRowSize() {
     return kUnknownRowSize;
   }
+
+  // Takes over the split that 'source' was given with addSplit(), so that
+  // 'this' continues with the reader 'source' opened ahead of time. Called
+  // instead of addSplit() for preloaded splits. Only supported if the
+  // Connector supportsSplitPreload().
+  virtual void setFromDataSource(std::shared_ptr<DataSource> /*source*/) {
+    VELOX_UNSUPPORTED("setFromDataSource");
+  }
+
+  // Computes 'aggregates' over the rows of the split that can be covered by
+  // file metadata, e.g. the stripes or row groups whose statistics show that
+  // all rows pass the pushed down filters. next() then skips these rows and
+  // returns the rest of the split, which the caller aggregates as usual.
+  // Returns one row with a column per aggregate: count is BIGINT, sum is
+  // BIGINT or DOUBLE, min and max are of the type of the column and null if
+  // no non-null value was covered. Returns nullptr if the aggregates cannot
+  // be computed this way. Called after addSplit() and before next().
+  virtual RowVectorPtr aggregateFromMetadata(
+      const std::vector<MetadataAggregate>& /*aggregates*/) {
+    return nullptr;
+  }
 };
 
 // Exposes expression evaluation functionality of the engine to the connector.
@@ -258,6 +305,34 @@ class Connector {
     return false;
   }
 
+  // Returns true if the DataSources of this connector can open a split before
+  // its turn and hand it over with DataSource::setFromDataSource(). The
+  // preloading runs on executor().
+  virtual bool supportsSplitPreload() const {
+    return false;
+  }
+
+  // Returns the executor for background work of the DataSources, e.g.
+  // prefetch and split preload. nullptr if there is none.
+  virtual folly::Executor* FOLLY_NULLABLE executor() const {
+    return nullptr;
+  }
+
+  // Returns false if no row of 'split' can pass the filters of 'tableHandle',
+  // e.g. because of the partition values of the split. Called by
+  // Task::addSplit before the split is queued, so that a pruned split is
+  // never opened or given to a TableScan. 'columnHandles' are the
+  // assignments of the scan. Must be thread safe. The default keeps all
+  // splits.
+  virtual bool testSplit(
+      const std::shared_ptr<ConnectorTableHandle>& /*tableHandle*/,
+      const std::unordered_map<
+          std::string,
+          std::shared_ptr<ColumnHandle>>& /*columnHandles*/,
+      const std::shared_ptr<ConnectorSplit>& /*split*/) {
+    return true;
+  }
+
   virtual std::shared_ptr<DataSource> createDataSource(
       const RowTypePtr& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
@@ -16,6 +16,7 @@
 
 #include "velox/connectors/hive/FileHandle.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
 
 #include <atomic>
 
@@ -43,6 +44,7 @@ std::unique_ptr<FileHandle> FileHandleGenerator::operator()(
                          ->openFileForRead(filename);
   fileHandle->uuid = StringIdLease(fileIds(), filename);
   fileHandle->groupId = StringIdLease(fileIds(), groupName(filename));
+  fileHandle->openTimeMs = getCurrentTimeMs();
   VLOG(1) << "Generating file handle for: " << filename
           << " uuid: " << fileHandle->uuid.id();
   // TODO: build the hash map/etc per file type -- presumably after reading
@@ -51,4 +53,14 @@ std::unique_ptr<FileHandle> FileHandleGenerator::operator()(
   return fileHandle;
 }
 
+std::function<bool(const FileHandle&)> fileHandleExpiration(
+    uint64_t expirationMs) {
+  if (expirationMs == 0) {
+    return nullptr;
+  }
+  return [expirationMs](const FileHandle& fileHandle) {
+    return getCurrentTimeMs() - fileHandle.openTimeMs >= expirationMs;
+  };
+}
+
 } // namespace facebook::velox
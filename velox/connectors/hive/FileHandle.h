@@ -51,6 +51,10 @@ struct FileHandle {
   // example to decide placing on SSD.
   StringIdLease groupId;
 
+  // Time of opening 'file'. A cached handle older than the expiration of the
+  // FileHandleFactory is opened again, so that a replaced file is seen.
+  uint64_t openTimeMs{0};
+
   // We'll want to have a hash map here to record the identifier->byte range
   // mappings. Different formats may have different identifiers, so we may need
   // a union of maps. For example in orc you need 3 integers (I think, to be
@@ -85,4 +89,9 @@ using FileHandleFactory = CachedFactory<
 
 using FileHandleCachedPtr = CachedPtr<std::string, FileHandle>;
 
+// Returns a predicate for FileHandleFactory that expires handles opened more
+// than 'expirationMs' ago. nullptr if 'expirationMs' is 0.
+std::function<bool(const FileHandle&)> fileHandleExpiration(
+    uint64_t expirationMs);
+
 } // namespace facebook::velox
@@ -37,6 +37,26 @@ DEFINE_int32(
     1024,
     "Amount of space for the file handle cache in mb.");
 
+DEFINE_int32(
+    file_handle_expiration_ms,
+    0,
+    "Cached file handles opened longer ago than this are opened again on "
+    "their next use. 0 keeps them until they are evicted.");
+
+DEFINE_int32(
+    hive_max_rows_to_scan,
+    0,
+    "If positive, a scan with selective filters reads up to this many rows "
+    "per batch, so that the columns without filters are read once per window "
+    "of rows with passing values. 0 reads batches of the requested size.");
+
+DEFINE_bool(
+    hive_column_io_stats,
+    false,
+    "If true, table scans report the bytes read from RAM cache, SSD cache and "
+    "storage and the bytes prefetched for each top level column of the files "
+    "as runtime stats named like '<stat>.<column>'.");
+
 namespace facebook::velox::connector::hive {
 namespace {
 static const char* kPath = "$path";
@@ -139,11 +159,42 @@ static void makeFieldSpecs(
   }
 }
 
+// Adds a projected spec for each subscript of a map column in
+// 'requiredSubfields', e.g. c0['a'], so that flat map readers read only these
+// keys. Nested subfields of the map values are read in full.
+void addMapSubscriptSpecs(
+    const std::vector<const common::Subfield*>& requiredSubfields,
+    const RowTypePtr& rowType,
+    common::ScanSpec* spec) {
+  for (const auto* subfield : requiredSubfields) {
+    const auto& path = subfield->path();
+    if (path.size() < 2 || !path[1]->isSubscript()) {
+      continue;
+    }
+    auto& name =
+        static_cast<const common::Subfield::NestedField*>(path[0].get())
+            ->name();
+    auto index = rowType->getChildIdxIfExists(name);
+    if (!index.has_value() || !rowType->childAt(index.value())->isMap()) {
+      continue;
+    }
+    std::vector<std::unique_ptr<common::Subfield::PathElement>> keyPath;
+    keyPath.push_back(path[0]->clone());
+    keyPath.push_back(path[1]->clone());
+    auto keySpec =
+        spec->getOrCreateChild(common::Subfield(std::move(keyPath)));
+    keySpec->setProjectOut(true);
+    keySpec->setExtractValues(true);
+  }
+}
+
 std::shared_ptr<common::ScanSpec> makeScanSpec(
     const SubfieldFilters& filters,
-    const RowTypePtr& rowType) {
+    const RowTypePtr& rowType,
+    const std::vector<const common::Subfield*>& requiredSubfields) {
   auto spec = std::make_shared<common::ScanSpec>("root");
   makeFieldSpecs("", 0, rowType, spec.get());
+  addMapSubscriptSpecs(requiredSubfields, rowType, spec.get());
 
   for (auto& pair : filters) {
     // SelectiveColumnReader doesn't support constant columns with filters,
@@ -198,6 +249,7 @@ HiveDataSource::HiveDataSource(
 
   std::vector<std::string> columnNames;
   columnNames.reserve(outputType->size());
+  std::vector<const common::Subfield*> requiredSubfields;
   for (auto& outputName : outputType->names()) {
     auto it = columnHandles.find(outputName);
     VELOX_CHECK(
@@ -207,6 +259,9 @@ HiveDataSource::HiveDataSource(
 
     const auto& handle = static_cast<HiveColumnHandle&>(*it->second);
     columnNames.emplace_back(handle.name());
+    for (const auto& subfield : handle.requiredSubfields()) {
+      requiredSubfields.push_back(&subfield);
+    }
   }
 
   auto hiveTableHandle =
@@ -220,8 +275,9 @@ HiveDataSource::HiveDataSource(
 
   auto outputTypes = outputType_->children();
   readerOutputType_ = ROW(std::move(columnNames), std::move(outputTypes));
-  scanSpec_ =
-      makeScanSpec(hiveTableHandle->subfieldFilters(), readerOutputType_);
+  scanSpec_ = makeScanSpec(
+      hiveTableHandle->subfieldFilters(), readerOutputType_, requiredSubfields);
+  scanSpec_->setMaxRowsToScan(std::max(0, FLAGS_hive_max_rows_to_scan));
 
   const auto& remainingFilter = hiveTableHandle->remainingFilter();
   if (remainingFilter) {
@@ -309,6 +365,44 @@ velox::variant convertFromString(const std::optional<std::string>& value) {
   return velox::variant(ToKind);
 }
 
+// Returns false if the partition key 'value' of 'type' does not pass
+// 'filter'. Types without a test are assumed to pass.
+bool testPartitionValue(
+    const common::Filter& filter,
+    const TypePtr& type,
+    const std::optional<std::string>& value) {
+  if (!value.has_value()) {
+    return filter.testNull();
+  }
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+      return filter.testBool(
+          convertFromString<TypeKind::BOOLEAN>(value).value<bool>());
+    case TypeKind::TINYINT:
+      return filter.testInt64(
+          convertFromString<TypeKind::TINYINT>(value).value<int8_t>());
+    case TypeKind::SMALLINT:
+      return filter.testInt64(
+          convertFromString<TypeKind::SMALLINT>(value).value<int16_t>());
+    case TypeKind::INTEGER:
+      return filter.testInt64(
+          convertFromString<TypeKind::INTEGER>(value).value<int32_t>());
+    case TypeKind::BIGINT:
+      return filter.testInt64(
+          convertFromString<TypeKind::BIGINT>(value).value<int64_t>());
+    case TypeKind::REAL:
+      return filter.testFloat(
+          convertFromString<TypeKind::REAL>(value).value<float>());
+    case TypeKind::DOUBLE:
+      return filter.testDouble(
+          convertFromString<TypeKind::DOUBLE>(value).value<double>());
+    case TypeKind::VARCHAR:
+      return filter.testBytes(value->data(), value->size());
+    default:
+      return true;
+  }
+}
+
 } // namespace
 
 void HiveDataSource::addDynamicFilter(
@@ -365,6 +459,8 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
     readerOpts_.setFileFormat(split_->fileFormat);
   }
 
+  // The splits of a file share its parsed footer.
+  readerOpts_.setFileId(fileHandle_->uuid.id());
   reader_ = dwio::common::getReaderFactory(readerOpts_.getFileFormat())
                 ->createReader(std::move(input), readerOpts_);
 
@@ -433,16 +529,267 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
     }
   }
 
-  std::shared_ptr<dwio::common::ColumnSelector> cs;
-  if (columnNames.empty()) {
-    static const RowTypePtr kEmpty{ROW({}, {})};
-    cs = std::make_shared<dwio::common::ColumnSelector>(kEmpty);
-  } else {
-    cs = std::make_shared<dwio::common::ColumnSelector>(fileType, columnNames);
+  // Consecutive files of a table usually have the same schema. The readers
+  // copy the selector, so the one of the previous file can be used again.
+  if (!columnSelector_ || columnNames != selectedColumnNames_ ||
+      *fileType != *selectorFileType_) {
+    if (columnNames.empty()) {
+      static const RowTypePtr kEmpty{ROW({}, {})};
+      columnSelector_ = std::make_shared<dwio::common::ColumnSelector>(kEmpty);
+    } else {
+      columnSelector_ =
+          std::make_shared<dwio::common::ColumnSelector>(fileType, columnNames);
+    }
+    selectorFileType_ = fileType;
+    selectedColumnNames_ = std::move(columnNames);
   }
 
   rowReader_ = reader_->createRowReader(
-      rowReaderOpts_.select(cs).range(split_->start, split_->length));
+      rowReaderOpts_.select(columnSelector_)
+          .range(split_->start, split_->length));
+  rowReader_->setScratch(std::move(columnReaderScratch_));
+  // Issues the IO for the first stripe now. If the split is preloaded, this
+  // overlaps the reads with the processing of the previous split.
+  rowReader_->prefetchFirstStripe();
+}
+
+namespace {
+bool isIntegerKind(TypeKind kind) {
+  return kind == TypeKind::BIGINT || kind == TypeKind::INTEGER ||
+      kind == TypeKind::SMALLINT || kind == TypeKind::TINYINT;
+}
+
+// Returns true if the statistics of 'unit' show that all its rows pass the
+// filters in 'scanSpec'.
+bool allRowsPass(
+    const common::ScanSpec& scanSpec,
+    const RowType& fileType,
+    const dwio::common::UnitStatistics& unit) {
+  for (const auto& child : scanSpec.children()) {
+    if (!child->hasFilter()) {
+      continue;
+    }
+    auto index = fileType.getChildIdxIfExists(child->fieldName());
+    // Filters on subfields and constant columns are not covered.
+    if (!child->filter() || child->isConstant() || !index.has_value()) {
+      return false;
+    }
+    auto* stats = unit.columns[index.value()].get();
+    if (!stats ||
+        !common::testFilterAllRows(
+            child->filter(), stats, unit.numRows, fileType.childAt(*index))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Partial result of a MetadataAggregate. 'value' is the min, max or sum.
+struct MetadataAccumulator {
+  int64_t count{0};
+  std::optional<int64_t> value;
+};
+
+// Adds the statistics of 'unit' to 'accumulators'. 'fileColumns' has the
+// column of each aggregate in the file schema, std::nullopt for count(*).
+// Returns false if the statistics cannot answer some aggregate.
+bool addUnitStatistics(
+    const std::vector<MetadataAggregate>& aggregates,
+    const std::vector<std::optional<uint32_t>>& fileColumns,
+    const dwio::common::UnitStatistics& unit,
+    std::vector<MetadataAccumulator>& accumulators) {
+  for (auto i = 0; i < aggregates.size(); ++i) {
+    auto& accumulator = accumulators[i];
+    if (!fileColumns[i].has_value()) {
+      accumulator.count += unit.numRows;
+      continue;
+    }
+    auto* stats = unit.columns[fileColumns[i].value()].get();
+    if (!stats || !stats->getNumberOfValues().has_value()) {
+      return false;
+    }
+    const auto numValues = stats->getNumberOfValues().value();
+    if (aggregates[i].kind == MetadataAggregate::Kind::kCount) {
+      accumulator.count += numValues;
+      continue;
+    }
+    if (numValues == 0) {
+      continue;
+    }
+    auto* intStats =
+        dynamic_cast<const dwio::common::IntegerColumnStatistics*>(stats);
+    if (!intStats) {
+      return false;
+    }
+    std::optional<int64_t> value;
+    switch (aggregates[i].kind) {
+      case MetadataAggregate::Kind::kMin:
+        value = intStats->getMinimum();
+        if (value.has_value() && accumulator.value.has_value()) {
+          value = std::min(value.value(), accumulator.value.value());
+        }
+        break;
+      case MetadataAggregate::Kind::kMax:
+        value = intStats->getMaximum();
+        if (value.has_value() && accumulator.value.has_value()) {
+          value = std::max(value.value(), accumulator.value.value());
+        }
+        break;
+      case MetadataAggregate::Kind::kSum: {
+        value = intStats->getSum();
+        int64_t sum;
+        if (value.has_value() && accumulator.value.has_value()) {
+          if (__builtin_add_overflow(
+                  value.value(), accumulator.value.value(), &sum)) {
+            return false;
+          }
+          value = sum;
+        }
+        break;
+      }
+      default:
+        VELOX_UNREACHABLE();
+    }
+    if (!value.has_value()) {
+      return false;
+    }
+    accumulator.value = value;
+  }
+  return true;
+}
+
+template <typename T>
+void setValue(BaseVector& vector, int64_t value) {
+  vector.asFlatVector<T>()->set(0, static_cast<T>(value));
+}
+
+void setIntegerValue(BaseVector& vector, int64_t value) {
+  switch (vector.typeKind()) {
+    case TypeKind::BIGINT:
+      return setValue<int64_t>(vector, value);
+    case TypeKind::INTEGER:
+      return setValue<int32_t>(vector, value);
+    case TypeKind::SMALLINT:
+      return setValue<int16_t>(vector, value);
+    case TypeKind::TINYINT:
+      return setValue<int8_t>(vector, value);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+} // namespace
+
+RowVectorPtr HiveDataSource::aggregateFromMetadata(
+    const std::vector<MetadataAggregate>& aggregates) {
+  VELOX_CHECK(split_ != nullptr, "No split to process. Call addSplit first.");
+  if (remainingFilterExprSet_) {
+    return nullptr;
+  }
+  const auto& fileType = reader_->rowType();
+  std::vector<std::optional<uint32_t>> fileColumns;
+  std::vector<TypePtr> types;
+  for (const auto& aggregate : aggregates) {
+    if (!aggregate.channel.has_value()) {
+      VELOX_CHECK(
+          aggregate.kind == MetadataAggregate::Kind::kCount,
+          "Only count may have no column");
+      fileColumns.push_back(std::nullopt);
+      types.push_back(BIGINT());
+      continue;
+    }
+    const auto& name = readerOutputType_->nameOf(aggregate.channel.value());
+    const auto& type = readerOutputType_->childAt(aggregate.channel.value());
+    auto index = fileType->getChildIdxIfExists(name);
+    if (!index.has_value() || split_->partitionKeys.count(name)) {
+      return nullptr;
+    }
+    if (aggregate.kind != MetadataAggregate::Kind::kCount &&
+        !isIntegerKind(type->kind())) {
+      return nullptr;
+    }
+    fileColumns.push_back(index.value());
+    types.push_back(
+        aggregate.kind == MetadataAggregate::Kind::kMin ||
+                aggregate.kind == MetadataAggregate::Kind::kMax
+            ? type
+            : BIGINT());
+  }
+
+  // An empty split has no rows that pass the filters.
+  std::vector<MetadataAccumulator> accumulators(aggregates.size());
+  if (!emptySplit_) {
+    auto units = rowReader_->unitStatistics();
+    std::vector<uint32_t> coveredUnits;
+    for (auto i = 0; i < units.size(); ++i) {
+      if (!allRowsPass(*scanSpec_, *fileType, units[i])) {
+        continue;
+      }
+      auto newAccumulators = accumulators;
+      if (addUnitStatistics(
+              aggregates, fileColumns, units[i], newAccumulators)) {
+        accumulators = std::move(newAccumulators);
+        coveredUnits.push_back(i);
+        completedRows_ += units[i].numRows;
+      }
+    }
+    rowReader_->skipUnits(coveredUnits);
+  }
+
+  std::vector<VectorPtr> columns;
+  for (auto i = 0; i < aggregates.size(); ++i) {
+    auto column = BaseVector::create(types[i], 1, pool_);
+    if (aggregates[i].kind == MetadataAggregate::Kind::kCount) {
+      column->asFlatVector<int64_t>()->set(0, accumulators[i].count);
+    } else if (!accumulators[i].value.has_value()) {
+      column->setNull(0, true);
+    } else {
+      setIntegerValue(*column, accumulators[i].value.value());
+    }
+    columns.push_back(std::move(column));
+  }
+  std::vector<std::string> names(aggregates.size());
+  return std::make_shared<RowVector>(
+      pool_,
+      ROW(std::move(names), std::move(types)),
+      BufferPtr(nullptr),
+      1,
+      std::move(columns));
+}
+
+void HiveDataSource::setFromDataSource(std::shared_ptr<DataSource> source) {
+  auto* hiveSource = dynamic_cast<HiveDataSource*>(source.get());
+  VELOX_CHECK_NOT_NULL(hiveSource, "Bad DataSource type");
+  VELOX_CHECK_NULL(split_, "Previous split has not been processed yet.");
+  split_ = std::move(hiveSource->split_);
+  VELOX_CHECK_NOT_NULL(split_, "DataSource has no split");
+  emptySplit_ = hiveSource->emptySplit_;
+  runtimeStats_.skippedSplits += hiveSource->runtimeStats_.skippedSplits;
+  runtimeStats_.skippedSplitBytes +=
+      hiveSource->runtimeStats_.skippedSplitBytes;
+  if (readerOpts_.getFileFormat() == dwio::common::FileFormat::UNKNOWN) {
+    readerOpts_.setFileFormat(split_->fileFormat);
+  }
+
+  // The reader of 'source' reads with the ScanSpec of 'source'. Dynamic
+  // filters and filter order of the splits read so far are carried over.
+  hiveSource->scanSpec_->moveAdaptationFrom(*scanSpec_);
+  scanSpec_ = std::move(hiveSource->scanSpec_);
+  rowReaderOpts_.setScanSpec(scanSpec_);
+
+  // The buffered input of 'source' accounts its IO in the stats of 'source'.
+  hiveSource->ioStats_->merge(*ioStats_);
+  ioStats_ = std::move(hiveSource->ioStats_);
+  fileHandle_ = std::move(hiveSource->fileHandle_);
+  reader_ = std::move(hiveSource->reader_);
+  rowReader_ = std::move(hiveSource->rowReader_);
+  if (rowReader_) {
+    rowReader_->setScratch(std::move(columnReaderScratch_));
+  }
+  if (hiveSource->columnSelector_) {
+    columnSelector_ = std::move(hiveSource->columnSelector_);
+    selectorFileType_ = std::move(hiveSource->selectorFileType_);
+    selectedColumnNames_ = std::move(hiveSource->selectedColumnNames_);
+  }
 }
 
 std::optional<RowVectorPtr> HiveDataSource::next(
@@ -516,10 +863,43 @@ std::optional<RowVectorPtr> HiveDataSource::next(
   return nullptr;
 }
 
+void HiveDataSource::updateColumnIo() {
+  if (!FLAGS_hive_column_io_stats || !reader_) {
+    return;
+  }
+  auto columnIo = ioStats_->takeColumnIo();
+  if (columnIo.empty()) {
+    return;
+  }
+  const auto& fileType = reader_->typeWithId();
+  const auto& rowType = fileType->type->asRow();
+  for (const auto& [nodeId, io] : columnIo) {
+    // The file schema has the top level columns as children of the root. The
+    // other nodes of a column have ids in the range of its child.
+    std::string name = "other";
+    for (auto i = 0; i < fileType->size(); ++i) {
+      const auto& child = fileType->childAt(i);
+      if (nodeId >= static_cast<int32_t>(child->id) &&
+          nodeId <= static_cast<int32_t>(child->maxId)) {
+        name = rowType.nameOf(i);
+        break;
+      }
+    }
+    auto& total = columnIo_[name];
+    for (auto i = 0; i < io.size(); ++i) {
+      total[i] += io[i];
+    }
+  }
+}
+
 void HiveDataSource::resetSplit() {
+  updateColumnIo();
   split_.reset();
   // Make sure to destroy Reader and RowReader in the opposite order of
   // creation, e.g. destroy RowReader first, then destroy Reader.
+  if (rowReader_) {
+    columnReaderScratch_ = rowReader_->releaseScratch();
+  }
   rowReader_.reset();
   reader_.reset();
 }
@@ -561,6 +941,12 @@ void HiveDataSource::setPartitionValue(
 
 std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
   auto res = runtimeStats_.toMap();
+  // Prefetched bytes not read by this scan, approximately. Data prefetched by
+  // another query may be first used here.
+  const int64_t prefetchUnusedBytes = std::max<int64_t>(
+      0,
+      static_cast<int64_t>(ioStats_->prefetch().bytes()) -
+          static_cast<int64_t>(ioStats_->prefetchUsed().bytes()));
   res.insert(
       {{"numPrefetch", RuntimeCounter(ioStats_->prefetch().count())},
        {"prefetchBytes",
@@ -576,7 +962,28 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
        {"numRamRead", RuntimeCounter(ioStats_->ramHit().count())},
        {"ramReadBytes",
         RuntimeCounter(
-            ioStats_->ramHit().bytes(), RuntimeCounter::Unit::kBytes)}});
+            ioStats_->ramHit().bytes(), RuntimeCounter::Unit::kBytes)},
+       {"overreadBytes",
+        RuntimeCounter(
+            ioStats_->rawOverreadBytes(), RuntimeCounter::Unit::kBytes)},
+       {"prefetchUnusedBytes",
+        RuntimeCounter(prefetchUnusedBytes, RuntimeCounter::Unit::kBytes)}});
+
+  updateColumnIo();
+  static const char* kColumnIoNames[] = {
+      "ramReadBytes", "localReadBytes", "storageReadBytes", "prefetchBytes"};
+  static_assert(
+      sizeof(kColumnIoNames) / sizeof(kColumnIoNames[0]) ==
+      static_cast<int32_t>(dwio::common::ColumnIoKind::kNumKinds));
+  for (const auto& [column, io] : columnIo_) {
+    for (auto i = 0; i < io.size(); ++i) {
+      if (io[i] > 0) {
+        res.insert(
+            {fmt::format("{}.{}", kColumnIoNames[i], column),
+             RuntimeCounter(io[i], RuntimeCounter::Unit::kBytes)});
+      }
+    }
+  }
   return res;
 }
 
@@ -591,6 +998,70 @@ int64_t HiveDataSource::estimatedRowSize() {
   return kUnknownRowSize;
 }
 
+bool HiveConnector::testSplit(
+    const std::shared_ptr<ConnectorTableHandle>& tableHandle,
+    const std::unordered_map<
+        std::string,
+        std::shared_ptr<connector::ColumnHandle>>& columnHandles,
+    const std::shared_ptr<ConnectorSplit>& split) {
+  auto hiveTableHandle =
+      std::dynamic_pointer_cast<HiveTableHandle>(tableHandle);
+  auto hiveSplit = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
+  if (!hiveTableHandle || !hiveSplit ||
+      hiveTableHandle->subfieldFilters().empty()) {
+    return true;
+  }
+  // The partition key columns keyed on their names in the table.
+  std::unordered_map<std::string, HiveColumnHandle*> partitionKeys;
+  for (const auto& [_, columnHandle] : columnHandles) {
+    auto handle = dynamic_cast<HiveColumnHandle*>(columnHandle.get());
+    if (handle && handle->isPartitionKey()) {
+      partitionKeys[handle->name()] = handle;
+    }
+  }
+
+  // The filters on the columns of the file.
+  auto fileSpec = std::make_shared<common::ScanSpec>("root");
+  for (const auto& [subfield, filter] : hiveTableHandle->subfieldFilters()) {
+    const auto name = subfield.toString();
+    if (name == kPath || name == kBucket) {
+      continue;
+    }
+    auto keyIt = partitionKeys.find(name);
+    if (keyIt == partitionKeys.end()) {
+      fileSpec->getOrCreateChild(subfield)->setFilter(filter->clone());
+      continue;
+    }
+    auto valueIt = hiveSplit->partitionKeys.find(name);
+    if (valueIt != hiveSplit->partitionKeys.end() &&
+        !testPartitionValue(
+            *filter, keyIt->second->dataType(), valueIt->second)) {
+      VLOG(1) << "Pruning " << hiveSplit->filePath
+              << " based on partition value of " << name;
+      return false;
+    }
+  }
+
+  const auto& properties = connectorProperties();
+  if (fileSpec->children().empty() || !properties ||
+      !HiveConfig::pruneSplitsWithFileStats(properties.get())) {
+    return true;
+  }
+  auto fileHandle = fileHandleFactory_.generate(hiveSplit->filePath);
+  dwio::common::ReaderOptions readerOptions(pool_.get());
+  readerOptions.setFileFormat(hiveSplit->fileFormat);
+  // Shares the parsed footer with the readers of the splits.
+  readerOptions.setFileId(fileHandle->uuid.id());
+  auto reader =
+      dwio::common::getReaderFactory(hiveSplit->fileFormat)
+          ->createReader(
+              std::make_unique<dwio::common::BufferedInput>(
+                  fileHandle->file, *pool_),
+              readerOptions);
+  return reader->numberOfRows() != 0 &&
+      testFilters(fileSpec.get(), reader.get(), hiveSplit->filePath);
+}
+
 HiveConnector::HiveConnector(
     const std::string& id,
     std::shared_ptr<const Config> properties,
@@ -599,7 +1070,8 @@ HiveConnector::HiveConnector(
       fileHandleFactory_(
           std::make_unique<SimpleLRUCache<std::string, FileHandle>>(
               FLAGS_file_handle_cache_mb << 20),
-          std::make_unique<FileHandleGenerator>(std::move(properties))),
+          std::make_unique<FileHandleGenerator>(std::move(properties)),
+          fileHandleExpiration(FLAGS_file_handle_expiration_ms)),
       executor_(executor) {}
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<HiveConnectorFactory>())
@@ -38,11 +38,19 @@ class HiveColumnHandle : public ColumnHandle {
  public:
   enum class ColumnType { kPartitionKey, kRegular, kSynthesized };
 
+  /// 'requiredSubfields' lists the subfields of the column that are used by
+  /// the query, starting with 'name'. If these are subscripts of a map column,
+  /// e.g. c0['a'], only these keys are read from flat maps. Empty means the
+  /// whole column is used.
   HiveColumnHandle(
       const std::string& name,
       ColumnType columnType,
-      TypePtr dataType)
-      : name_(name), columnType_(columnType), dataType_(std::move(dataType)) {}
+      TypePtr dataType,
+      std::vector<common::Subfield> requiredSubfields = {})
+      : name_(name),
+        columnType_(columnType),
+        dataType_(std::move(dataType)),
+        requiredSubfields_(std::move(requiredSubfields)) {}
 
   const std::string& name() const {
     return name_;
@@ -60,10 +68,15 @@ class HiveColumnHandle : public ColumnHandle {
     return columnType_ == ColumnType::kPartitionKey;
   }
 
+  const std::vector<common::Subfield>& requiredSubfields() const {
+    return requiredSubfields_;
+  }
+
  private:
   const std::string name_;
   const ColumnType columnType_;
   const TypePtr dataType_;
+  const std::vector<common::Subfield> requiredSubfields_;
 };
 
 using SubfieldFilters =
@@ -139,6 +152,15 @@ class HiveDataSource : public DataSource {
 
   int64_t estimatedRowSize() override;
 
+  void setFromDataSource(std::shared_ptr<DataSource> source) override;
+
+  // Supports count over any column and min, max and sum over integer columns
+  // of the file. Uses the DWRF file statistics if the split covers the whole
+  // file and the Parquet row group statistics otherwise. Returns nullptr if
+  // there is a remaining filter.
+  RowVectorPtr aggregateFromMetadata(
+      const std::vector<MetadataAggregate>& aggregates) override;
+
  private:
   // Evaluates remainingFilter_ on the specified vector. Returns number of rows
   // passed. Populates filterEvalCtx_.selectedIndices and selectedBits if only
@@ -162,6 +184,11 @@ class HiveDataSource : public DataSource {
   /// Clear split_, reader_ and rowReader_ after split has been fully processed.
   void resetSplit();
 
+  // Adds the IO per node of the file schema in 'ioStats_' to 'columnIo_' with
+  // the top level column names of 'reader_'. Nothing if
+  // FLAGS_hive_column_io_stats is false.
+  void updateColumnIo();
+
   const RowTypePtr outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
@@ -180,8 +207,21 @@ class HiveDataSource : public DataSource {
   RowTypePtr readerOutputType_;
   bool emptySplit_;
 
+  // The column selector of the last file and the file schema and columns it
+  // was made for.
+  std::shared_ptr<dwio::common::ColumnSelector> columnSelector_;
+  RowTypePtr selectorFileType_;
+  std::vector<std::string> selectedColumnNames_;
+
+  // Buffers of the column readers of the previous split for the readers of
+  // the next one.
+  std::shared_ptr<dwio::common::ColumnReaderScratch> columnReaderScratch_;
+
   dwio::common::RuntimeStatistics runtimeStats_;
 
+  // IO per top level column of the files read so far.
+  std::unordered_map<std::string, dwio::common::ColumnIo> columnIo_;
+
   VectorPtr output_;
   FileHandleCachedPtr fileHandle_;
   ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator_;
@@ -193,7 +233,7 @@ class HiveDataSource : public DataSource {
   exec::FilterEvalCtx filterEvalCtx_;
 
   memory::MappedMemory* const FOLLY_NONNULL mappedMemory_;
-  const std::string& scanId_;
+  const std::string scanId_;
   folly::Executor* FOLLY_NULLABLE executor_;
 };
 
@@ -208,6 +248,35 @@ class HiveConfig {
   static bool isImmutablePartitions(const Config* FOLLY_NONNULL baseConfig) {
     return baseConfig->get<bool>(kImmutablePartitions, true);
   }
+
+  /// Maximum number of partition files a data sink keeps open. The least
+  /// recently written file is closed to open another one.
+  static constexpr const char* FOLLY_NONNULL kMaxOpenPartitionWriters =
+      "hive.max-open-partition-writers";
+
+  static uint32_t maxOpenPartitionWriters(
+      const Config* FOLLY_NONNULL baseConfig) {
+    return baseConfig->get<uint32_t>(kMaxOpenPartitionWriters, 100);
+  }
+
+  /// A file is closed once this many bytes have been written to it and the
+  /// following rows go to a new file. 0 means no limit.
+  static constexpr const char* FOLLY_NONNULL kMaxTargetFileSize =
+      "hive.max-target-file-size";
+
+  static uint64_t maxTargetFileSize(const Config* FOLLY_NONNULL baseConfig) {
+    return baseConfig->get<uint64_t>(kMaxTargetFileSize, 0);
+  }
+
+  /// If true, a split added to a Task is dropped if the statistics of its
+  /// file show that no row passes the filters. Reads the footer of the file
+  /// on the thread adding the split, unless the footer is cached.
+  static constexpr const char* FOLLY_NONNULL kPruneSplitsWithFileStats =
+      "hive.prune-splits-with-file-stats";
+
+  static bool pruneSplitsWithFileStats(const Config* FOLLY_NONNULL baseConfig) {
+    return baseConfig->get<bool>(kPruneSplitsWithFileStats, false);
+  }
 };
 
 class HiveConnector final : public Connector {
@@ -221,6 +290,10 @@ class HiveConnector final : public Connector {
     return true;
   }
 
+  bool supportsSplitPreload() const override {
+    return true;
+  }
+
   std::shared_ptr<DataSource> createDataSource(
       const RowTypePtr& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
@@ -250,15 +323,31 @@ class HiveConnector final : public Connector {
     VELOX_CHECK_NOT_NULL(
         hiveInsertHandle, "Hive connector expecting hive write handle!");
     return std::make_shared<HiveDataSink>(
-        inputType, hiveInsertHandle, connectorQueryCtx, writeProtocol);
+        inputType,
+        hiveInsertHandle,
+        connectorQueryCtx,
+        writeProtocol,
+        connectorProperties());
   }
 
-  folly::Executor* FOLLY_NULLABLE executor() {
+  folly::Executor* FOLLY_NULLABLE executor() const override {
     return executor_;
   }
 
+  // Tests the filters on partition keys against the partition values of the
+  // split. With the kPruneSplitsWithFileStats config, also tests the other
+  // filters against the file statistics, reading the footer unless cached.
+  bool testSplit(
+      const std::shared_ptr<ConnectorTableHandle>& tableHandle,
+      const std::unordered_map<
+          std::string,
+          std::shared_ptr<connector::ColumnHandle>>& columnHandles,
+      const std::shared_ptr<ConnectorSplit>& split) override;
+
  private:
   FileHandleFactory fileHandleFactory_;
+  // Used for reading the footers of the files for testSplit.
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
   folly::Executor* FOLLY_NULLABLE executor_;
 };
 
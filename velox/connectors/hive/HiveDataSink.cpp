@@ -17,26 +17,72 @@
 #include "velox/connectors/hive/HiveDataSink.h"
 
 #include "velox/common/base/Fs.h"
+#include "velox/common/file/FileSystems.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveWriteProtocol.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/vector/DecodedVector.h"
 
 using namespace facebook::velox::dwrf;
 using WriterConfig = facebook::velox::dwrf::Config;
 
 namespace facebook::velox::connector::hive {
+namespace {
+// Name of the partition of rows with a null partition key.
+constexpr const char* kDefaultPartitionValue = "__HIVE_DEFAULT_PARTITION__";
+
+// Escapes the characters of a partition key or value that can not appear in
+// a path like Hive does, e.g. '/' as %2F.
+std::string escapePathName(const std::string& name) {
+  std::string escaped;
+  for (auto c : name) {
+    if (static_cast<uint8_t>(c) < ' ' || c == '"' || c == '#' || c == '%' ||
+        c == '\'' || c == '*' || c == '/' || c == ':' || c == '=' ||
+        c == '?' || c == '\\' || c == '{' || c == '[' || c == ']' ||
+        c == '^') {
+      escaped += fmt::format("%{:02X}", static_cast<uint8_t>(c));
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+} // namespace
 
 HiveDataSink::HiveDataSink(
     RowTypePtr inputType,
     std::shared_ptr<const HiveInsertTableHandle> insertTableHandle,
     const ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx,
-    std::shared_ptr<WriteProtocol> writeProtocol)
+    std::shared_ptr<WriteProtocol> writeProtocol,
+    std::shared_ptr<const Config> connectorProperties)
     : inputType_(std::move(inputType)),
       insertTableHandle_(std::move(insertTableHandle)),
       connectorQueryCtx_(connectorQueryCtx),
-      writeProtocol_(std::move(writeProtocol)) {
+      writeProtocol_(std::move(writeProtocol)),
+      connectorProperties_(std::move(connectorProperties)),
+      maxOpenWriters_(
+          HiveConfig::maxOpenPartitionWriters(connectorQueryCtx_->config())),
+      maxFileSize_(
+          HiveConfig::maxTargetFileSize(connectorQueryCtx_->config())) {
   VELOX_CHECK_NOT_NULL(
       writeProtocol_, "Write protocol could not be nullptr for HiveDataSink.");
+  VELOX_USER_CHECK_GT(
+      maxOpenWriters_, 0, "{} must be positive", kMaxOpenPartitionWriters);
+  std::vector<std::string> dataNames;
+  std::vector<TypePtr> dataTypes;
+  const auto& inputColumns = insertTableHandle_->inputColumns();
+  for (column_index_t i = 0; i < inputType_->size(); ++i) {
+    if (i < inputColumns.size() && inputColumns[i]->isPartitionKey()) {
+      partitionChannels_.push_back(i);
+    } else {
+      dataChannels_.push_back(i);
+      dataNames.push_back(inputType_->nameOf(i));
+      dataTypes.push_back(inputType_->childAt(i));
+    }
+  }
+  dataType_ = partitionChannels_.empty()
+      ? inputType_
+      : ROW(std::move(dataNames), std::move(dataTypes));
 }
 
 std::shared_ptr<ConnectorCommitInfo> HiveDataSink::getConnectorCommitInfo()
@@ -45,28 +91,138 @@ std::shared_ptr<ConnectorCommitInfo> HiveDataSink::getConnectorCommitInfo()
 }
 
 void HiveDataSink::appendData(VectorPtr input) {
-  // For the time being the hive data sink supports one file
-  // To extend it we can create a new writer for every
-  // partition
-  if (writers_.empty()) {
-    writers_.emplace_back(createWriter());
+  if (partitionChannels_.empty()) {
+    write("", input);
+    return;
+  }
+  auto rowVector = std::dynamic_pointer_cast<RowVector>(input);
+  VELOX_CHECK_NOT_NULL(rowVector, "Hive data sink expects a RowVector");
+  appendPartitioned(rowVector);
+}
+
+void HiveDataSink::appendPartitioned(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  SelectivityVector allRows(numRows);
+  std::vector<DecodedVector> decodedKeys(partitionChannels_.size());
+  for (auto i = 0; i < partitionChannels_.size(); ++i) {
+    decodedKeys[i].decode(*input->childAt(partitionChannels_[i]), allRows);
+  }
+
+  // The rows of each partition. The rows of a partition are written together,
+  // so that each writer is used once per batch.
+  std::unordered_map<std::string, int32_t> batchPartitions;
+  std::vector<const std::string*> partitionNames;
+  std::vector<std::vector<vector_size_t>> partitionRows;
+  std::string name;
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    name.clear();
+    for (auto i = 0; i < partitionChannels_.size(); ++i) {
+      auto& decoded = decodedKeys[i];
+      if (i > 0) {
+        name += '/';
+      }
+      name += escapePathName(inputType_->nameOf(partitionChannels_[i]));
+      name += '=';
+      name += decoded.isNullAt(row)
+          ? kDefaultPartitionValue
+          : escapePathName(decoded.base()->toString(decoded.index(row)));
+    }
+    auto it = batchPartitions.emplace(name, partitionRows.size()).first;
+    if (it->second == partitionRows.size()) {
+      partitionNames.push_back(&it->first);
+      partitionRows.emplace_back();
+    }
+    partitionRows[it->second].push_back(row);
+  }
+
+  auto* pool = connectorQueryCtx_->memoryPool();
+  for (auto i = 0; i < partitionRows.size(); ++i) {
+    const auto& rows = partitionRows[i];
+    const vector_size_t size = rows.size();
+    auto indices = allocateIndices(size, pool);
+    std::copy(rows.begin(), rows.end(), indices->asMutable<vector_size_t>());
+    std::vector<VectorPtr> children;
+    children.reserve(dataChannels_.size());
+    for (auto channel : dataChannels_) {
+      children.push_back(BaseVector::wrapInDictionary(
+          nullptr, indices, size, input->childAt(channel)));
+    }
+    write(
+        *partitionNames[i],
+        std::make_shared<RowVector>(
+            pool, dataType_, nullptr, size, std::move(children)));
   }
-  writers_[0]->write(input);
+}
+
+void HiveDataSink::write(
+    const std::string& partitionName,
+    const VectorPtr& data) {
+  const auto index = writerIndex(partitionName);
+  auto& partitionWriter = writers_[index];
+  partitionWriter.writer->write(data);
+  if (maxFileSize_ == 0) {
+    return;
+  }
+  // The flushed stripes plus the estimated size of the buffered one.
+  const auto& context = partitionWriter.writer->getContext();
+  const auto fileSize = partitionWriter.sink->size() +
+      context.getEstimatedStripeSize(context.stripeRawSize);
+  if (fileSize < maxFileSize_) {
+    return;
+  }
+  // The next rows of the partition go to a new file.
+  partitionWriter.writer->close();
+  partitionWriters_.erase(partitionWriter.partitionName);
+  if (index != writers_.size() - 1) {
+    partitionWriter = std::move(writers_.back());
+    partitionWriters_[partitionWriter.partitionName] = index;
+  }
+  writers_.pop_back();
+}
+
+int32_t HiveDataSink::writerIndex(const std::string& partitionName) {
+  ++numWrites_;
+  auto it = partitionWriters_.find(partitionName);
+  if (it != partitionWriters_.end()) {
+    writers_[it->second].lastWrite = numWrites_;
+    return it->second;
+  }
+
+  int32_t index = writers_.size();
+  if (writers_.size() >= maxOpenWriters_) {
+    index = 0;
+    for (auto i = 1; i < writers_.size(); ++i) {
+      if (writers_[i].lastWrite < writers_[index].lastWrite) {
+        index = i;
+      }
+    }
+    writers_[index].writer->close();
+    partitionWriters_.erase(writers_[index].partitionName);
+  } else {
+    writers_.emplace_back();
+  }
+  auto& partitionWriter = writers_[index];
+  partitionWriter.partitionName = partitionName;
+  createWriter(partitionWriter);
+  partitionWriter.lastWrite = numWrites_;
+  partitionWriters_[partitionName] = index;
+  return index;
 }
 
 void HiveDataSink::close() {
-  for (const auto& writer : writers_) {
-    writer->close();
+  for (const auto& partitionWriter : writers_) {
+    partitionWriter.writer->close();
   }
 }
 
-std::unique_ptr<velox::dwrf::Writer> HiveDataSink::createWriter() {
+void HiveDataSink::createWriter(PartitionWriter& partitionWriter) {
+  const auto& partitionName = partitionWriter.partitionName;
   auto config = std::make_shared<WriterConfig>();
   // TODO: Wire up serde properties to writer configs.
 
   facebook::velox::dwrf::WriterOptions options;
   options.config = config;
-  options.schema = inputType_;
+  options.schema = dataType_;
   // Without explicitly setting flush policy, the default memory based flush
   // policy is used.
 
@@ -77,12 +233,40 @@ std::unique_ptr<velox::dwrf::Writer> HiveDataSink::createWriter() {
   VELOX_CHECK_NOT_NULL(
       hiveWriterParameters,
       "Hive data sink expects write parameters for Hive.");
+  // A partition that gets another file after its writer was closed needs
+  // another file name.
+  const auto fileNumber = numPartitionFiles_[partitionName]++;
+  if (!partitionName.empty() || fileNumber > 0) {
+    const auto suffix =
+        fileNumber == 0 ? std::string() : fmt::format("_{}", fileNumber);
+    hiveWriterParameters = std::make_shared<const HiveWriterParameters>(
+        hiveWriterParameters->updateMode(),
+        hiveWriterParameters->targetFileName() + suffix,
+        (fs::path(hiveWriterParameters->targetDirectory()) / partitionName)
+            .string(),
+        hiveWriterParameters->writeFileName() + suffix,
+        (fs::path(hiveWriterParameters->writeDirectory()) / partitionName)
+            .string());
+  }
   writerParameters_.emplace_back(hiveWriterParameters);
 
-  auto writePath = fs::path(hiveWriterParameters->writeDirectory()) /
-      hiveWriterParameters->writeFileName();
-  auto sink = dwio::common::DataSink::create(writePath);
-  return std::make_unique<Writer>(
+  const auto writePath = (fs::path(hiveWriterParameters->writeDirectory()) /
+                          hiveWriterParameters->writeFileName())
+                             .string();
+  std::unique_ptr<dwio::common::DataSink> sink;
+  if (writePath.find("://") != std::string::npos &&
+      writePath.rfind("file:", 0) != 0) {
+    // Remote storage like S3 is written through the WriteFile of its file
+    // system, which may upload in the background while the writer encodes.
+    auto fileSystem =
+        filesystems::getFileSystem(writePath, connectorProperties_);
+    sink = std::make_unique<dwio::common::WriteFileDataSink>(
+        fileSystem->openFileForWrite(writePath), writePath);
+  } else {
+    sink = dwio::common::DataSink::create(writePath);
+  }
+  partitionWriter.sink = sink.get();
+  partitionWriter.writer = std::make_unique<Writer>(
       options, std::move(sink), *connectorQueryCtx_->memoryPool());
 }
 
@@ -21,6 +21,10 @@ namespace facebook::velox::dwrf {
 class Writer;
 }
 
+namespace facebook::velox::dwio::common {
+class DataSink;
+}
+
 namespace facebook::velox::connector::hive {
 class HiveColumnHandle;
 class HiveWriterParameters;
@@ -114,13 +118,21 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
   const std::shared_ptr<const LocationHandle> locationHandle_;
 };
 
+/// Writes the input to a file per partition of a partitioned table or to a
+/// single file otherwise. The rows of each partition are written to a
+/// subdirectory like ds=2023-01-01/country=US without the partition key
+/// columns. At most HiveConfig::maxOpenPartitionWriters() files are open at a
+/// time. When a new partition is seen beyond that, the least recently written
+/// file is closed and the partition gets a new file if it has more rows later.
+/// A file that reaches HiveConfig::maxTargetFileSize() is closed as well.
 class HiveDataSink : public DataSink {
  public:
   explicit HiveDataSink(
       RowTypePtr inputType,
       std::shared_ptr<const HiveInsertTableHandle> insertTableHandle,
       const ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx,
-      std::shared_ptr<WriteProtocol> writeProtocol);
+      std::shared_ptr<WriteProtocol> writeProtocol,
+      std::shared_ptr<const Config> connectorProperties = nullptr);
 
   std::shared_ptr<ConnectorCommitInfo> getConnectorCommitInfo() const override;
 
@@ -129,16 +141,57 @@ class HiveDataSink : public DataSink {
   void close() override;
 
  private:
-  std::unique_ptr<dwrf::Writer> createWriter();
+  // A writer for one partition, or the only writer of an unpartitioned table.
+  struct PartitionWriter {
+    std::string partitionName;
+    std::unique_ptr<dwrf::Writer> writer;
+    // The sink of 'writer', for the size of the file.
+    dwio::common::DataSink* sink{nullptr};
+    // Value of 'numWrites_' at the last write to 'writer'.
+    uint64_t lastWrite{0};
+  };
+
+  // Writes 'data' to the file of 'partitionName', which is empty for an
+  // unpartitioned table. Closes the file if it reaches 'maxFileSize_'.
+  void write(const std::string& partitionName, const VectorPtr& data);
+
+  // Returns the index in 'writers_' of the writer for 'partitionName'. Opens a
+  // new writer if there is none. If 'maxOpenWriters_' are open, closes the
+  // least recently written one first.
+  int32_t writerIndex(const std::string& partitionName);
+
+  // Sets the writer and sink of 'partitionWriter' to a new file of its
+  // partition.
+  void createWriter(PartitionWriter& partitionWriter);
+
+  // Splits 'input' by partition and writes the rows of each partition to its
+  // writer.
+  void appendPartitioned(const RowVectorPtr& input);
 
   const RowTypePtr inputType_;
   const std::shared_ptr<const HiveInsertTableHandle> insertTableHandle_;
   const ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx_;
   const std::shared_ptr<WriteProtocol> writeProtocol_;
-  // Parameters used by writers, and thus are tracked in the same order
-  // as the writers_ vector
+  // Used to open the file system of remote write paths like s3://.
+  const std::shared_ptr<const Config> connectorProperties_;
+  // Channels of the partition keys and the other columns in 'inputType_'.
+  std::vector<column_index_t> partitionChannels_;
+  std::vector<column_index_t> dataChannels_;
+  // Type of the data written to the files. 'inputType_' without the partition
+  // keys.
+  RowTypePtr dataType_;
+  const uint32_t maxOpenWriters_;
+  const uint64_t maxFileSize_;
+  // Parameters of all files written, including the files of the writers that
+  // have been closed.
   std::vector<std::shared_ptr<const HiveWriterParameters>> writerParameters_;
-  std::vector<std::unique_ptr<dwrf::Writer>> writers_;
+  // The open writers.
+  std::vector<PartitionWriter> writers_;
+  // Index in 'writers_' of the open writer of each partition.
+  std::unordered_map<std::string, int32_t> partitionWriters_;
+  // Number of files created for each partition so far.
+  std::unordered_map<std::string, int32_t> numPartitionFiles_;
+  uint64_t numWrites_{0};
 };
 
 } // namespace facebook::velox::connector::hive
@@ -15,6 +15,8 @@
  */
 #include "velox/connectors/hive/HivePartitionFunction.h"
 
+#include <type_traits>
+
 namespace facebook::velox::connector::hive {
 
 namespace {
@@ -29,6 +31,27 @@ void hashTyped(
       TypeTraits<kind>::name);
 }
 
+template <typename Func>
+void mixHashes(
+    vector_size_t size,
+    bool mix,
+    Func&& hashAt,
+    std::vector<uint32_t>& hashes) {
+  auto* rawHashes = hashes.data();
+  if (mix) {
+    for (auto i = 0; i < size; ++i) {
+      rawHashes[i] = rawHashes[i] * 31 + hashAt(i);
+    }
+  } else {
+    for (auto i = 0; i < size; ++i) {
+      rawHashes[i] = hashAt(i);
+    }
+  }
+}
+
+// Hashes 'values' one column at a time. A constant is hashed once, a flat
+// column is read straight from its values and a dictionary over a smaller
+// flat base hashes each base value once.
 template <typename T, typename Func>
 void abstractHashTyped(
     const DecodedVector& values,
@@ -36,11 +59,59 @@ void abstractHashTyped(
     bool mix,
     Func&& hashOne,
     std::vector<uint32_t>& hashes) {
-  for (auto i = 0; i < size; ++i) {
+  if (values.isConstantMapping()) {
     const uint32_t hash =
-        (values.isNullAt(i)) ? 0 : hashOne(values.valueAt<T>(i));
-    hashes[i] = mix ? hashes[i] * 31 + hash : hash;
+        values.isNullAt(0) ? 0 : hashOne(values.valueAt<T>(0));
+    mixHashes(size, mix, [&](auto /*row*/) { return hash; }, hashes);
+    return;
+  }
+
+  // Flat bool values are bits and go through valueAt.
+  if constexpr (!std::is_same_v<T, bool>) {
+    const auto* rawValues = values.data<T>();
+    if (values.isIdentityMapping()) {
+      if (!values.mayHaveNulls()) {
+        mixHashes(
+            size,
+            mix,
+            [&](auto row) -> uint32_t { return hashOne(rawValues[row]); },
+            hashes);
+      } else {
+        mixHashes(
+            size,
+            mix,
+            [&](auto row) -> uint32_t {
+              return values.isNullAt(row) ? 0 : hashOne(rawValues[row]);
+            },
+            hashes);
+      }
+      return;
+    }
+
+    const auto* base = values.base();
+    if (base->isFlatEncoding() && base->size() < size) {
+      std::vector<uint32_t> baseHashes(base->size());
+      for (auto i = 0; i < base->size(); ++i) {
+        baseHashes[i] = base->isNullAt(i) ? 0 : hashOne(rawValues[i]);
+      }
+      mixHashes(
+          size,
+          mix,
+          [&](auto row) -> uint32_t {
+            return values.isNullAt(row) ? 0 : baseHashes[values.index(row)];
+          },
+          hashes);
+      return;
+    }
   }
+
+  mixHashes(
+      size,
+      mix,
+      [&](auto row) -> uint32_t {
+        return values.isNullAt(row) ? 0 : hashOne(values.valueAt<T>(row));
+      },
+      hashes);
 }
 
 template <>
@@ -217,6 +288,8 @@ HivePartitionFunction::HivePartitionFunction(
     std::vector<column_index_t> keyChannels,
     const std::vector<VectorPtr>& constValues)
     : numBuckets_{numBuckets},
+      bucketMultiplier_{
+          std::numeric_limits<uint64_t>::max() / numBuckets + 1},
       bucketToPartition_{bucketToPartition},
       keyChannels_{std::move(keyChannels)} {
   decodedVectors_.resize(keyChannels_.size());
@@ -256,9 +329,13 @@ void HivePartitionFunction::partition(
 
   static const int32_t kInt32Max = std::numeric_limits<int32_t>::max();
 
+  // Computes (hash & kInt32Max) % numBuckets_ as in Lemire et al., "Faster
+  // Remainder by Direct Computation".
   for (auto i = 0; i < numRows; ++i) {
-    partitions[i] =
-        bucketToPartition_[((hashes_[i] & kInt32Max) % numBuckets_)];
+    const uint64_t fraction = bucketMultiplier_ * (hashes_[i] & kInt32Max);
+    const auto bucket = static_cast<uint32_t>(
+        (static_cast<__uint128_t>(fraction) * numBuckets_) >> 64);
+    partitions[i] = bucketToPartition_[bucket];
   }
 }
 
@@ -38,6 +38,10 @@ class HivePartitionFunction : public core::PartitionFunction {
   void precompute(const BaseVector& value, size_t column_index_t);
 
   const int numBuckets_;
+  // Multiplier for computing the bucket of a non-negative 32-bit hash modulo
+  // 'numBuckets_' with two multiplies instead of a division. The result is
+  // exact for all 32-bit hashes.
+  const uint64_t bucketMultiplier_;
   const std::vector<int> bucketToPartition_;
   const std::vector<column_index_t> keyChannels_;
 
@@ -40,11 +40,9 @@ HiveNoCommitWriteProtocol::getWriterParameters(
   VELOX_CHECK_NOT_NULL(
       hiveTableWriteHandle,
       "This write protocol cannot be used for non-Hive connector");
-  VELOX_USER_CHECK(
-      !hiveTableWriteHandle->isPartitioned(),
-      "Getting write parameters for partitioned Hive tables is not implemented yet.");
   VELOX_USER_CHECK(
       hiveTableWriteHandle->isCreateTable() ||
+          hiveTableWriteHandle->isPartitioned() ||
           !HiveConfig::isImmutablePartitions(connectorQueryCtx->config()),
       "Unpartitioned Hive tables are immutable");
 
@@ -73,11 +71,9 @@ HiveTaskCommitWriteProtocol::getWriterParameters(
   VELOX_CHECK_NOT_NULL(
       hiveTableWriteHandle,
       "This write protocol cannot be used for non-Hive connector");
-  VELOX_USER_CHECK(
-      !hiveTableWriteHandle->isPartitioned(),
-      "Getting write parameters for partitioned Hive tables is not implemented yet.");
   VELOX_USER_CHECK(
       hiveTableWriteHandle->isCreateTable() ||
+          hiveTableWriteHandle->isPartitioned() ||
           !HiveConfig::isImmutablePartitions(connectorQueryCtx->config()),
       "Unpartitioned Hive tables are immutable");
 
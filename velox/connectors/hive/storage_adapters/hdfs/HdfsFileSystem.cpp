@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsFileSystem.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <hdfs/hdfs.h>
 #include "velox/common/file/FileSystems.h"
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsReadFile.h"
@@ -31,14 +33,36 @@ class HdfsFileSystem::Impl {
     auto builder = hdfsNewBuilder();
     hdfsBuilderSetNameNode(builder, endpointInfo.host.c_str());
     hdfsBuilderSetNameNodePort(builder, endpointInfo.port);
+    // Short-circuit reads read the blocks on the local datanode directly from
+    // its disks through the domain socket.
+    if (auto shortCircuit = config->get("hive.hdfs.short-circuit-read")) {
+      hdfsBuilderConfSetStr(
+          builder, "dfs.client.read.shortcircuit", shortCircuit->c_str());
+    }
+    if (auto socketPath = config->get("hive.hdfs.domain-socket-path")) {
+      hdfsBuilderConfSetStr(
+          builder, "dfs.domain.socket.path", socketPath->c_str());
+    }
     hdfsClient_ = hdfsBuilderConnect(builder);
     VELOX_CHECK_NOT_NULL(
         hdfsClient_,
         "Unable to connect to HDFS, got error: {}.",
         hdfsGetLastError())
+
+    const auto numReadThreads =
+        config->get<int32_t>("hive.hdfs.read-threads", 16);
+    if (numReadThreads > 0) {
+      readExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          numReadThreads,
+          std::make_shared<folly::NamedThreadFactory>("HdfsRead"));
+    }
+    hedgeThreshold_ = std::chrono::milliseconds(
+        config->get<int64_t>("hive.hdfs.hedged-read-threshold-ms", 0));
   }
 
   ~Impl() {
+    // Pending reads use the client.
+    readExecutor_.reset();
     LOG(INFO) << "Disconnecting HDFS file system";
     int disconnectResult = hdfsDisconnect(hdfsClient_);
     if (disconnectResult != 0) {
@@ -64,8 +88,21 @@ class HdfsFileSystem::Impl {
     return hdfsClient_;
   }
 
+  // Executor for asynchronous and hedged reads. nullptr if
+  // hive.hdfs.read-threads is 0.
+  folly::Executor* readExecutor() const {
+    return readExecutor_.get();
+  }
+
+  std::chrono::milliseconds hedgeThreshold() const {
+    return hedgeThreshold_;
+  }
+
  private:
   hdfsFS hdfsClient_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> readExecutor_;
+  // A read that takes longer than this is started again. 0 disables hedging.
+  std::chrono::milliseconds hedgeThreshold_;
 };
 
 HdfsFileSystem::HdfsFileSystem(const std::shared_ptr<const Config>& config)
@@ -86,7 +123,11 @@ std::unique_ptr<ReadFile> HdfsFileSystem::openFileForRead(
     path.remove_prefix(index);
   }
 
-  return std::make_unique<HdfsReadFile>(impl_->hdfsClient(), path);
+  return std::make_unique<HdfsReadFile>(
+      impl_->hdfsClient(),
+      path,
+      impl_->readExecutor(),
+      impl_->hedgeThreshold());
 }
 
 std::unique_ptr<WriteFile> HdfsFileSystem::openFileForWrite(
@@ -15,13 +15,63 @@
  */
 
 #include "HdfsReadFile.h"
+#include <folly/ScopeGuard.h>
+#include <folly/futures/Future.h>
 #include <folly/synchronization/CallOnce.h>
 #include <hdfs/hdfs.h>
 
 namespace facebook::velox {
+namespace {
+void seekToPosition(
+    hdfsFS hdfs,
+    hdfsFile file,
+    const std::string& path,
+    uint64_t offset) {
+  auto seekStatus = hdfsSeek(hdfs, file, offset);
+  VELOX_CHECK_EQ(
+      seekStatus,
+      0,
+      "Cannot seek through HDFS file: {}, error: {}",
+      path,
+      std::string(hdfsGetLastError()));
+}
+
+// Opens 'path' and reads 'length' bytes at 'offset' into 'pos'. Does not refer
+// to the HdfsReadFile, so that a hedged read can outlive it.
+void readRange(
+    hdfsFS hdfs,
+    const std::string& path,
+    uint64_t offset,
+    uint64_t length,
+    char* pos) {
+  auto file = hdfsOpenFile(hdfs, path.data(), O_RDONLY, 0, 0, 0);
+  VELOX_CHECK_NOT_NULL(
+      file, "Unable to open file {}. got error: {}", path, hdfsGetLastError());
+  SCOPE_EXIT {
+    if (hdfsCloseFile(hdfs, file) == -1) {
+      LOG(ERROR) << "Unable to close file, errno: " << errno;
+    }
+  };
+  seekToPosition(hdfs, file, path, offset);
+  uint64_t totalBytesRead = 0;
+  while (totalBytesRead < length) {
+    auto bytesRead = hdfsRead(hdfs, file, pos, length - totalBytesRead);
+    VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
+    totalBytesRead += bytesRead;
+    pos += bytesRead;
+  }
+}
+} // namespace
 
-HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
-    : hdfsClient_(hdfs), filePath_(path) {
+HdfsReadFile::HdfsReadFile(
+    hdfsFS hdfs,
+    const std::string_view path,
+    folly::Executor* executor,
+    std::chrono::milliseconds hedgeThreshold)
+    : hdfsClient_(hdfs),
+      filePath_(path),
+      executor_(executor),
+      hedgeThreshold_(hedgeThreshold) {
   fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
   VELOX_CHECK_NOT_NULL(
       fileInfo_,
@@ -33,34 +83,68 @@ HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
 void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   checkFileReadParameters(offset, length);
-  auto file = hdfsOpenFile(hdfsClient_, filePath_.data(), O_RDONLY, 0, 0, 0);
-  VELOX_CHECK_NOT_NULL(
-      file,
-      "Unable to open file {}. got error: {}",
-      filePath_,
-      hdfsGetLastError());
-  seekToPosition(file, offset);
-  uint64_t totalBytesRead = 0;
-  while (totalBytesRead < length) {
-    auto bytesRead = hdfsRead(hdfsClient_, file, pos, length - totalBytesRead);
-    VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
-    totalBytesRead += bytesRead;
-    pos += bytesRead;
+  if (executor_ && hedgeThreshold_.count() > 0) {
+    hedgedPread(offset, length, pos);
+    return;
   }
+  readRange(hdfsClient_, filePath_, offset, length, pos);
+}
 
-  if (hdfsCloseFile(hdfsClient_, file) == -1) {
-    LOG(ERROR) << "Unable to close file, errno: " << errno;
+void HdfsReadFile::hedgedPread(uint64_t offset, uint64_t length, char* pos)
+    const {
+  // Each read goes to its own buffer since the slower read can not be
+  // cancelled and keeps writing after the faster one has returned.
+  auto startRead = [&]() {
+    return folly::via(
+               executor_,
+               [hdfs = hdfsClient_, path = filePath_, offset, length]() {
+                 auto buffer = std::make_shared<std::string>(length, 0);
+                 readRange(hdfs, path, offset, length, buffer->data());
+                 return buffer;
+               })
+        .semi();
+  };
+  std::vector<folly::SemiFuture<std::shared_ptr<std::string>>> reads;
+  reads.push_back(startRead());
+  reads.back().wait(hedgeThreshold_);
+  if (!reads.back().isReady()) {
+    reads.push_back(startRead());
   }
+  auto buffer =
+      folly::collectAnyWithoutException(std::move(reads)).get().second;
+  memcpy(pos, buffer->data(), length);
 }
 
-void HdfsReadFile::seekToPosition(hdfsFile file, uint64_t offset) const {
-  auto seekStatus = hdfsSeek(hdfsClient_, file, offset);
-  VELOX_CHECK_EQ(
-      seekStatus,
-      0,
-      "Cannot seek through HDFS file: {}, error: {}",
-      filePath_,
-      std::string(hdfsGetLastError()));
+folly::SemiFuture<uint64_t> HdfsReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (!executor_) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  // The ranges are read without hedging. A hedged read would block a thread
+  // of 'executor_' while waiting for another read on the same executor.
+  return folly::via(
+             executor_,
+             [hdfs = hdfsClient_,
+              path = filePath_,
+              fileSize = size(),
+              offset,
+              buffers]() {
+               uint64_t numRead = 0;
+               auto position = offset;
+               for (auto& range : buffers) {
+                 auto copySize = position >= fileSize
+                     ? 0
+                     : std::min<uint64_t>(range.size(), fileSize - position);
+                 if (range.data() && copySize > 0) {
+                   readRange(hdfs, path, position, copySize, range.data());
+                 }
+                 position += copySize;
+                 numRead += copySize;
+               }
+               return numRead;
+             })
+      .semi();
 }
 
 std::string_view
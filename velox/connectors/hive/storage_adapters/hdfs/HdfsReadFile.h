@@ -14,20 +14,39 @@
  * limitations under the License.
  */
 
+#include <folly/Executor.h>
 #include <hdfs/hdfs.h>
+#include <chrono>
 #include "velox/common/file/File.h"
 
 namespace facebook::velox {
 
+/// If 'executor' is set, preadvAsync reads on it. If 'hedgeThreshold' is also
+/// non-zero, a synchronous read that has not finished after 'hedgeThreshold'
+/// is started a second time on a newly opened file and the first of the two
+/// reads to succeed is used. This cuts the tail latency caused by a slow
+/// datanode.
 class HdfsReadFile final : public ReadFile {
  public:
-  explicit HdfsReadFile(hdfsFS hdfs, std::string_view path);
+  explicit HdfsReadFile(
+      hdfsFS hdfs,
+      std::string_view path,
+      folly::Executor* executor = nullptr,
+      std::chrono::milliseconds hedgeThreshold = {});
 
   std::string_view pread(uint64_t offset, uint64_t length, void* buf)
       const final;
 
   std::string pread(uint64_t offset, uint64_t length) const final;
 
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final {
+    return executor_ != nullptr;
+  }
+
   uint64_t size() const final;
 
   uint64_t memoryUsage() const final;
@@ -44,10 +63,14 @@ class HdfsReadFile final : public ReadFile {
 
  private:
   void preadInternal(uint64_t offset, uint64_t length, char* pos) const;
-  void seekToPosition(hdfsFile file, uint64_t offset) const;
+  // Reads like preadInternal but starts a second read if the first one takes
+  // longer than 'hedgeThreshold_'.
+  void hedgedPread(uint64_t offset, uint64_t length, char* pos) const;
   void checkFileReadParameters(uint64_t offset, uint64_t length) const;
   hdfsFS hdfsClient_;
   hdfsFileInfo* fileInfo_;
   std::string filePath_;
+  folly::Executor* const executor_;
+  const std::chrono::milliseconds hedgeThreshold_;
 };
 } // namespace facebook::velox
@@ -17,6 +17,7 @@
 #include <boost/format.hpp>
 #include <connectors/hive/storage_adapters/hdfs/HdfsReadFile.h>
 #include <connectors/hive/storage_adapters/hdfs/HdfsWriteFile.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gmock/gmock-matchers.h>
 #include <hdfs/hdfs.h>
 #include <atomic>
@@ -175,6 +176,29 @@ TEST_F(HdfsFileSystemTest, read) {
   readData(&readFile);
 }
 
+TEST_F(HdfsFileSystemTest, hedgedAndAsyncRead) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, 7878);
+  auto hdfs = hdfsBuilderConnect(builder);
+  folly::CPUThreadPoolExecutor executor(4);
+  // A threshold of 1ms starts a second read for most of the reads.
+  HdfsReadFile readFile(
+      hdfs, destinationPath, &executor, std::chrono::milliseconds(1));
+  readData(&readFile);
+
+  ASSERT_TRUE(readFile.hasPreadvAsync());
+  char head[10];
+  char tail[5];
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(nullptr, kOneMB),
+      folly::Range<char*>(tail, sizeof(tail))};
+  ASSERT_EQ(15 + kOneMB, readFile.preadvAsync(0, buffers).get());
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbb");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ddddd");
+}
+
 TEST_F(HdfsFileSystemTest, viaFileSystem) {
   facebook::velox::filesystems::registerHdfsFileSystem();
   auto memConfig = std::make_shared<const core::MemConfig>(configurationValues);
@@ -20,7 +20,10 @@
 #include "velox/core/Context.h"
 
 #include <fmt/format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <glog/logging.h>
+#include <deque>
 #include <memory>
 #include <stdexcept>
 
@@ -31,8 +34,13 @@
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
 #include <aws/identity-management/auth/STSAssumeRoleCredentialsProvider.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
+#include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 
 namespace facebook::velox {
 namespace {
@@ -59,10 +67,37 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, int64_t nbytes) {
   return [=]() { return Aws::New<StringViewStream>("", data, nbytes); };
 }
 
+// Reads the 'length' bytes at 'offset' of the object into 'position', which
+// has space for at least 'length' bytes.
+void getObjectRange(
+    Aws::S3::S3Client* client,
+    const std::string& bucket,
+    const std::string& key,
+    uint64_t offset,
+    uint64_t length,
+    char* position) {
+  Aws::S3::Model::GetObjectRequest request;
+  request.SetBucket(awsString(bucket));
+  request.SetKey(awsString(key));
+  std::stringstream ss;
+  ss << "bytes=" << offset << "-" << offset + length - 1;
+  request.SetRange(awsString(ss.str()));
+  request.SetResponseStreamFactory(AwsWriteableStreamFactory(position, length));
+  auto outcome = client->GetObject(request);
+  VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket, key);
+}
+
 class S3ReadFile final : public ReadFile {
  public:
-  S3ReadFile(const std::string& path, Aws::S3::S3Client* client)
-      : client_(client) {
+  // Reads of more than 'readPartSize' bytes are split into parts that are
+  // fetched in parallel on 'executor'. Reads are not split if 'executor' is
+  // nullptr or 'readPartSize' is 0.
+  S3ReadFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      folly::Executor* executor,
+      uint64_t readPartSize)
+      : client_(client), executor_(executor), readPartSize_(readPartSize) {
     bucketAndKeyFromS3Path(path, bucket_, key_);
   }
 
@@ -111,19 +146,60 @@ class S3ReadFile final : public ReadFile {
     for (const auto range : buffers) {
       length += range.size();
     }
+    if (buffers.size() == 1 && buffers[0].data()) {
+      preadInternal(offset, length, buffers[0].data());
+      return length;
+    }
     // TODO: allocate from a memory pool
     std::string result(length, 0);
     preadInternal(offset, length, static_cast<char*>(result.data()));
-    size_t resultOffset = 0;
-    for (auto range : buffers) {
-      if (range.data()) {
-        memcpy(range.data(), &(result.data()[resultOffset]), range.size());
-      }
-      resultOffset += range.size();
-    }
+    copyToBuffers(result, buffers);
     return length;
   }
 
+  // Issues the GetObject requests of all parts of the read on 'executor_' and
+  // returns without waiting for them.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
+    if (!executor_) {
+      return ReadFile::preadvAsync(offset, buffers);
+    }
+    size_t length = 0;
+    for (const auto range : buffers) {
+      length += range.size();
+    }
+    std::shared_ptr<std::string> result;
+    char* position;
+    if (buffers.size() == 1 && buffers[0].data()) {
+      position = buffers[0].data();
+    } else {
+      result = std::make_shared<std::string>(length, 0);
+      position = result->data();
+    }
+    std::vector<folly::SemiFuture<folly::Unit>> parts;
+    for (uint64_t partOffset = 0; partOffset < length;
+         partOffset += partSize()) {
+      auto partLength = std::min<uint64_t>(partSize(), length - partOffset);
+      parts.push_back(startPart(
+          offset + partOffset, partLength, position + partOffset, result));
+    }
+    return folly::collectAll(std::move(parts))
+        .deferValue([result, buffers, length](auto&& partResults) {
+          for (auto& partResult : partResults) {
+            partResult.throwIfFailed();
+          }
+          if (result) {
+            copyToBuffers(*result, buffers);
+          }
+          return static_cast<uint64_t>(length);
+        });
+  }
+
+  bool hasPreadvAsync() const override {
+    return executor_ != nullptr;
+  }
+
   uint64_t size() const override {
     return length_;
   }
@@ -147,28 +223,275 @@ class S3ReadFile final : public ReadFile {
   }
 
  private:
+  // Copies the consecutive bytes of 'data' into 'buffers', skipping the gaps.
+  static void copyToBuffers(
+      const std::string& data,
+      const std::vector<folly::Range<char*>>& buffers) {
+    size_t dataOffset = 0;
+    for (auto range : buffers) {
+      if (range.data()) {
+        memcpy(range.data(), data.data() + dataOffset, range.size());
+      }
+      dataOffset += range.size();
+    }
+  }
+
+  uint64_t partSize() const {
+    return executor_ && readPartSize_ ? readPartSize_
+                                      : std::numeric_limits<uint64_t>::max();
+  }
+
+  // Returns a future that is realized when the part at 'offset' has been read
+  // into 'position'. 'buffer' is kept alive until then if 'position' points
+  // into it. Does not refer to 'this', which may be destroyed first.
+  folly::SemiFuture<folly::Unit> startPart(
+      uint64_t offset,
+      uint64_t length,
+      char* position,
+      std::shared_ptr<std::string> buffer) const {
+    return folly::via(
+               executor_,
+               [client = client_,
+                bucket = bucket_,
+                key = key_,
+                offset,
+                length,
+                position,
+                buffer = std::move(buffer)]() {
+                 getObjectRange(client, bucket, key, offset, length, position);
+               })
+        .semi();
+  }
+
   // The assumption here is that "position" has space for at least "length"
-  // bytes.
+  // bytes. Reads of more than 'readPartSize_' bytes are split into parts. All
+  // but the first part are read on 'executor_' while the first part is read on
+  // the calling thread.
   void preadInternal(uint64_t offset, uint64_t length, char* position) const {
-    // Read the desired range of bytes.
-    Aws::S3::Model::GetObjectRequest request;
-    Aws::S3::Model::GetObjectResult result;
+    const auto firstPartSize = std::min<uint64_t>(length, partSize());
+    std::vector<folly::SemiFuture<folly::Unit>> parts;
+    for (auto partOffset = firstPartSize; partOffset < length;
+         partOffset += partSize()) {
+      auto partLength = std::min<uint64_t>(partSize(), length - partOffset);
+      parts.push_back(startPart(
+          offset + partOffset, partLength, position + partOffset, nullptr));
+    }
+    std::exception_ptr error;
+    try {
+      getObjectRange(client_, bucket_, key_, offset, firstPartSize, position);
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+    // All parts must finish before an error is rethrown since they refer to
+    // 'position'.
+    if (!parts.empty()) {
+      auto results = folly::collectAll(std::move(parts)).get();
+      for (auto& result : results) {
+        result.throwIfFailed();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  Aws::S3::S3Client* client_;
+  folly::Executor* const executor_;
+  const uint64_t readPartSize_;
+  std::string bucket_;
+  std::string key_;
+  int64_t length_ = -1;
+};
+
+// Writes an S3 object as a multipart upload. The appended data is buffered
+// into parts of 'partSize' bytes. Each full part is uploaded on 'executor'
+// while the next one is filled, so that the writer producing the data does not
+// wait for the upload. At most 'maxPendingParts' uploads are in flight, which
+// bounds the buffered data to 'maxPendingParts' + 1 parts. An object smaller
+// than one part is written with a single PutObject on close().
+class S3WriteFile final : public WriteFile {
+ public:
+  // Parts other than the last must have at least this many bytes.
+  static constexpr uint64_t kMinPartSize = 5 << 20;
+
+  S3WriteFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      folly::Executor* executor,
+      uint64_t partSize,
+      int32_t maxPendingParts)
+      : client_(client),
+        executor_(executor),
+        partSize_(partSize),
+        maxPendingParts_(maxPendingParts) {
+    VELOX_USER_CHECK_GE(
+        partSize_, kMinPartSize, "S3 upload parts must be at least 5MB");
+    VELOX_CHECK_GT(maxPendingParts_, 0);
+    bucketAndKeyFromS3Path(path, bucket_, key_);
+  }
+
+  ~S3WriteFile() override {
+    if (!closed_ && !uploadId_.empty()) {
+      abortUpload();
+    }
+  }
 
+  void append(std::string_view data) override {
+    VELOX_CHECK(!closed_, "Cannot append to closed S3 file");
+    size_ += data.size();
+    while (!data.empty()) {
+      const auto copySize =
+          std::min<uint64_t>(data.size(), partSize_ - currentPart_.size());
+      currentPart_.append(data.data(), copySize);
+      data.remove_prefix(copySize);
+      if (currentPart_.size() == partSize_) {
+        uploadPart();
+      }
+    }
+  }
+
+  // Waits for the uploads in flight. The data of a part that is not full stays
+  // buffered since S3 does not accept parts smaller than kMinPartSize before
+  // the last one.
+  void flush() override {
+    waitForUploads(0);
+  }
+
+  void close() override {
+    if (closed_) {
+      return;
+    }
+    if (uploadId_.empty()) {
+      putObject();
+    } else {
+      if (!currentPart_.empty()) {
+        uploadPart();
+      }
+      waitForUploads(0);
+      completeUpload();
+    }
+    closed_ = true;
+  }
+
+  uint64_t size() const override {
+    return size_;
+  }
+
+ private:
+  // Starts the upload of 'currentPart_' as the next part. Waits for the
+  // oldest upload first if 'maxPendingParts_' are in flight.
+  void uploadPart() {
+    if (uploadId_.empty()) {
+      createUpload();
+    }
+    waitForUploads(maxPendingParts_ - 1);
+    auto upload = [client = client_,
+                   bucket = bucket_,
+                   key = key_,
+                   uploadId = uploadId_,
+                   partNumber = ++numParts_,
+                   part = std::make_shared<std::string>(
+                       std::move(currentPart_))]() {
+      Aws::S3::Model::UploadPartRequest request;
+      request.SetBucket(awsString(bucket));
+      request.SetKey(awsString(key));
+      request.SetUploadId(uploadId);
+      request.SetPartNumber(partNumber);
+      request.SetContentLength(part->size());
+      request.SetBody(
+          std::make_shared<StringViewStream>(part->data(), part->size()));
+      auto outcome = client->UploadPart(request);
+      VELOX_CHECK_AWS_OUTCOME(
+          outcome, "Failed to upload S3 object part", bucket, key);
+      return outcome.GetResult().GetETag();
+    };
+    currentPart_.clear();
+    if (executor_) {
+      pendingParts_.push_back(folly::via(executor_, std::move(upload)).semi());
+    } else {
+      pendingParts_.push_back(folly::makeSemiFutureWith(std::move(upload)));
+    }
+  }
+
+  // Waits until at most 'maxPending' uploads are in flight. The parts finish
+  // in the order they were started.
+  void waitForUploads(int32_t maxPending) {
+    while (pendingParts_.size() > static_cast<size_t>(maxPending)) {
+      auto eTag = std::move(pendingParts_.front()).get();
+      pendingParts_.pop_front();
+      Aws::S3::Model::CompletedPart part;
+      part.SetPartNumber(completedParts_.size() + 1);
+      part.SetETag(std::move(eTag));
+      completedParts_.push_back(std::move(part));
+    }
+  }
+
+  void createUpload() {
+    Aws::S3::Model::CreateMultipartUploadRequest request;
     request.SetBucket(awsString(bucket_));
     request.SetKey(awsString(key_));
-    std::stringstream ss;
-    ss << "bytes=" << offset << "-" << offset + length - 1;
-    request.SetRange(awsString(ss.str()));
-    request.SetResponseStreamFactory(
-        AwsWriteableStreamFactory(position, length));
-    auto outcome = client_->GetObject(request);
-    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
+    auto outcome = client_->CreateMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to create S3 multipart upload", bucket_, key_);
+    uploadId_ = outcome.GetResult().GetUploadId();
+  }
+
+  void completeUpload() {
+    Aws::S3::Model::CompletedMultipartUpload upload;
+    upload.SetParts(completedParts_);
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetMultipartUpload(std::move(upload));
+    auto outcome = client_->CompleteMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to complete S3 multipart upload", bucket_, key_);
+  }
+
+  // Discards the parts of an upload that failed or was not closed. The
+  // uploads in flight must finish first.
+  void abortUpload() {
+    for (auto& pending : pendingParts_) {
+      std::move(pending).wait();
+    }
+    pendingParts_.clear();
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    auto outcome = client_->AbortMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+      LOG(WARNING) << "Failed to abort S3 multipart upload of "
+                   << s3URI(bucket_, key_);
+    }
+  }
+
+  void putObject() {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetContentLength(currentPart_.size());
+    request.SetBody(std::make_shared<StringViewStream>(
+        currentPart_.data(), currentPart_.size()));
+    auto outcome = client_->PutObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to put S3 object", bucket_, key_);
+    currentPart_.clear();
   }
 
   Aws::S3::S3Client* client_;
+  folly::Executor* const executor_;
+  const uint64_t partSize_;
+  const int32_t maxPendingParts_;
   std::string bucket_;
   std::string key_;
-  int64_t length_ = -1;
+  Aws::String uploadId_;
+  std::string currentPart_;
+  int32_t numParts_{0};
+  std::deque<folly::SemiFuture<Aws::String>> pendingParts_;
+  Aws::Vector<Aws::S3::Model::CompletedPart> completedParts_;
+  uint64_t size_{0};
+  bool closed_{false};
 };
 } // namespace
 
@@ -222,6 +545,28 @@ class S3Config {
         "hive.s3.iam-role-session-name", std::string("velox-session"));
   }
 
+  // Maximum number of concurrent connections to S3. This is also the number
+  // of threads that read the parts of large reads in parallel.
+  int32_t maxConnections() const {
+    return config_->get<int32_t>("hive.s3.max-connections", 32);
+  }
+
+  // Reads larger than this are split into parts of this size that are read in
+  // parallel. 0 disables the splitting.
+  uint64_t readPartSize() const {
+    return config_->get<uint64_t>("hive.s3.read-part-size", 8 << 20);
+  }
+
+  // Size of the parts of multipart uploads. At least 5MB.
+  uint64_t uploadPartSize() const {
+    return config_->get<uint64_t>("hive.s3.upload-part-size", 16 << 20);
+  }
+
+  // Maximum number of parts of a file that are uploaded concurrently.
+  int32_t maxPendingUploadParts() const {
+    return config_->get<int32_t>("hive.s3.max-pending-upload-parts", 4);
+  }
+
  private:
   const Config* FOLLY_NONNULL config_;
 };
@@ -238,6 +583,9 @@ class S3FileSystem::Impl {
   }
 
   ~Impl() {
+    // Pending reads use the client, so they must finish before the SDK is shut
+    // down.
+    ioExecutor_.reset();
     const size_t newCount = --initCounter_;
     if (newCount == 0) {
       Aws::SDKOptions awsOptions;
@@ -314,6 +662,7 @@ class S3FileSystem::Impl {
     Aws::Client::ClientConfiguration clientConfig;
 
     clientConfig.endpointOverride = s3Config_.endpoint();
+    clientConfig.maxConnections = s3Config_.maxConnections();
 
     if (s3Config_.useSSL()) {
       clientConfig.scheme = Aws::Http::Scheme::HTTPS;
@@ -328,6 +677,12 @@ class S3FileSystem::Impl {
         clientConfig,
         Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
         s3Config_.useVirtualAddressing());
+
+    if (s3Config_.maxConnections() > 1 && !ioExecutor_) {
+      ioExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          s3Config_.maxConnections(),
+          std::make_shared<folly::NamedThreadFactory>("S3Read"));
+    }
   }
 
   // Make it clear that the S3FileSystem instance owns the S3Client.
@@ -337,9 +692,23 @@ class S3FileSystem::Impl {
     return client_.get();
   }
 
+  // Executor for the parallel parts of reads. nullptr if reads are not split.
+  folly::Executor* ioExecutor() const {
+    return ioExecutor_.get();
+  }
+
+  uint64_t readPartSize() const {
+    return s3Config_.readPartSize();
+  }
+
+  const S3Config& s3Config() const {
+    return s3Config_;
+  }
+
  private:
   const S3Config s3Config_;
   std::shared_ptr<Aws::S3::S3Client> client_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> ioExecutor_;
   static std::atomic<size_t> initCounter_;
 };
 
@@ -357,14 +726,21 @@ void S3FileSystem::initializeClient() {
 
 std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(std::string_view path) {
   const std::string file = s3Path(path);
-  auto s3file = std::make_unique<S3ReadFile>(file, impl_->s3Client());
+  auto s3file = std::make_unique<S3ReadFile>(
+      file, impl_->s3Client(), impl_->ioExecutor(), impl_->readPartSize());
   s3file->initialize();
   return s3file;
 }
 
 std::unique_ptr<WriteFile> S3FileSystem::openFileForWrite(
     std::string_view path) {
-  VELOX_NYI();
+  const std::string file = s3Path(path);
+  return std::make_unique<S3WriteFile>(
+      file,
+      impl_->s3Client(),
+      impl_->ioExecutor(),
+      impl_->s3Config().uploadPartSize(),
+      impl_->s3Config().maxPendingUploadParts());
 }
 
 std::string S3FileSystem::name() const {
@@ -152,6 +152,73 @@ TEST_F(S3FileSystemTest, fileHandle) {
   readData(fileHandle->file.get());
 }
 
+TEST_F(S3FileSystemTest, parallelRead) {
+  const char* bucketName = "data4";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  // The reads of more than 100000 bytes are split into parallel parts.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.read-part-size", "100000"}, {"hive.s3.max-connections", "4"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  readData(readFile.get());
+
+  ASSERT_TRUE(readFile->hasPreadvAsync());
+  std::string data(10 + kOneMB - 3, 0);
+  char tail[5];
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(data.data(), data.size()),
+      folly::Range<char*>(nullptr, 3),
+      folly::Range<char*>(tail, sizeof(tail))};
+  ASSERT_EQ(15 + kOneMB, readFile->preadvAsync(0, buffers).get());
+  ASSERT_EQ(data.substr(0, 10), "aaaaabbbbb");
+  ASSERT_EQ(data.substr(10), std::string(kOneMB - 3, 'c'));
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ddddd");
+}
+
+TEST_F(S3FileSystemTest, writeAndReadBack) {
+  const char* bucketName = "data5";
+  addBucket(bucketName);
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.upload-part-size", std::to_string(5 * kOneMB)},
+       {"hive.s3.max-pending-upload-parts", "2"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+
+  // A file smaller than a part is written with a single request.
+  const std::string smallFile = s3URI(bucketName, "small.txt");
+  {
+    auto writeFile = s3fs.openFileForWrite(smallFile);
+    writeData(writeFile.get());
+    writeFile->close();
+  }
+  readData(s3fs.openFileForRead(smallFile).get());
+
+  // A larger file is uploaded as 3 parts of which 2 are in flight at a time.
+  const std::string largeFile = s3URI(bucketName, "large.txt");
+  std::string expected;
+  {
+    auto writeFile = s3fs.openFileForWrite(largeFile);
+    for (auto i = 0; i < 12; ++i) {
+      std::string data(kOneMB, 'a' + i);
+      writeFile->append(data);
+      expected += data;
+    }
+    writeFile->close();
+    ASSERT_EQ(expected.size(), writeFile->size());
+  }
+  auto readFile = s3fs.openFileForRead(largeFile);
+  ASSERT_EQ(expected.size(), readFile->size());
+  ASSERT_EQ(expected, readFile->pread(0, expected.size()));
+}
+
 TEST_F(S3FileSystemTest, invalidCredentialsConfig) {
   {
     const std::unordered_map<std::string, std::string> config(
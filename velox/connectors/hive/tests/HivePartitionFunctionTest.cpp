@@ -277,3 +277,33 @@ TEST_F(HivePartitionFunctionTest, date) {
   assertPartitionsWithConstChannel(values, 500);
   assertPartitionsWithConstChannel(values, 997);
 }
+
+TEST_F(HivePartitionFunctionTest, dictionaryOverSmallBase) {
+  // A dictionary over a base smaller than itself hashes each base value once.
+  // The partitions must match those of the flattened values.
+  auto base = makeNullableFlatVector<int64_t>(
+      {1,
+       std::nullopt,
+       -7,
+       1'000'000'007,
+       std::numeric_limits<int64_t>::min()});
+  const vector_size_t size = 1'000;
+  auto indices = makeIndices(size, [](auto row) { return (row * 7) % 5; });
+  auto nulls = makeNulls(size, [](auto row) { return row % 11 == 0; });
+  auto dictionary = BaseVector::wrapInDictionary(nulls, indices, size, base);
+  auto flat = flatten(dictionary);
+
+  for (auto bucketCount : {1, 2, 500, 997, 4096}) {
+    std::vector<int> bucketToPartition(bucketCount);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    std::vector<column_index_t> keyChannels{0, 1};
+    std::vector<uint32_t> expected;
+    std::vector<uint32_t> partitions;
+    connector::hive::HivePartitionFunction partitionFunction(
+        bucketCount, bucketToPartition, keyChannels);
+    partitionFunction.partition(*makeRowVector({flat, flat}), expected);
+    partitionFunction.partition(
+        *makeRowVector({dictionary, dictionary}), partitions);
+    EXPECT_EQ(expected, partitions) << "bucketCount " << bucketCount;
+  }
+}
@@ -63,8 +63,9 @@ TpchDataSource::TpchDataSource(
     const std::unordered_map<
         std::string,
         std::shared_ptr<connector::ColumnHandle>>& columnHandles,
-    velox::memory::MemoryPool* FOLLY_NONNULL pool)
-    : pool_(pool) {
+    velox::memory::MemoryPool* FOLLY_NONNULL pool,
+    folly::Executor* FOLLY_NULLABLE executor)
+    : pool_(pool), executor_(executor) {
   auto tpchTableHandle =
       std::dynamic_pointer_cast<TpchTableHandle>(tableHandle);
   VELOX_CHECK_NOT_NULL(
@@ -105,6 +106,13 @@ TpchDataSource::TpchDataSource(
   outputType_ = outputType;
 }
 
+TpchDataSource::~TpchDataSource() {
+  // The batches are generated from 'pool_', which must outlive them.
+  for (auto& batch : pendingBatches_) {
+    batch.wait();
+  }
+}
+
 RowVectorPtr TpchDataSource::projectOutputColumns(RowVectorPtr inputVector) {
   std::vector<VectorPtr> children;
   children.reserve(outputColumnMappings_.size());
@@ -138,9 +146,12 @@ void TpchDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 
 std::optional<RowVectorPtr> TpchDataSource::next(
     uint64_t size,
-    velox::ContinueFuture& /*future*/) {
+    velox::ContinueFuture& future) {
   VELOX_CHECK_NOT_NULL(
       currentSplit_, "No split to process. Call addSplit() first.");
+  if (executor_) {
+    return nextPending(size, future);
+  }
 
   size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
   auto outputVector =
@@ -162,6 +173,57 @@ std::optional<RowVectorPtr> TpchDataSource::next(
   return projectOutputColumns(outputVector);
 }
 
+std::optional<RowVectorPtr> TpchDataSource::nextPending(
+    uint64_t size,
+    velox::ContinueFuture& future) {
+  // The generation of a batch depends only on its offset, so the next batches
+  // can be generated in parallel. splitOffset_ is the start of the next batch
+  // to schedule.
+  while (pendingBatches_.size() < kMaxPendingBatches &&
+         splitOffset_ < splitEnd_) {
+    const size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
+    pendingBatches_.push_back(folly::via(
+        executor_,
+        [table = tpchTable_,
+         maxRows,
+         offset = splitOffset_,
+         scaleFactor = scaleFactor_,
+         pool = pool_]() {
+          return getTpchData(table, maxRows, offset, scaleFactor, pool);
+        }));
+    splitOffset_ += maxRows;
+  }
+
+  if (pendingBatches_.empty()) {
+    currentSplit_ = nullptr;
+    return nullptr;
+  }
+
+  auto& batch = pendingBatches_.front();
+  if (!batch.isReady()) {
+    auto [promise, readyFuture] =
+        makeVeloxContinuePromiseContract("TpchDataSource::next");
+    batch = std::move(batch).thenTry(
+        [promise = std::move(promise)](
+            folly::Try<RowVectorPtr>&& data) mutable {
+          promise.setValue();
+          return std::move(data).value();
+        });
+    future = std::move(readyFuture);
+    return std::nullopt;
+  }
+
+  auto outputVector = std::move(batch).get();
+  pendingBatches_.pop_front();
+  if (!outputVector || outputVector->size() == 0) {
+    // The batches past the end of the table are empty.
+    return next(size, future);
+  }
+  completedRows_ += outputVector->size();
+  completedBytes_ += outputVector->retainedSize();
+  return projectOutputColumns(outputVector);
+}
+
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<TpchConnectorFactory>())
 
 } // namespace facebook::velox::connector::tpch
@@ -15,6 +15,10 @@
  */
 #pragma once
 
+#include <deque>
+
+#include <folly/futures/Future.h>
+
 #include "velox/connectors/Connector.h"
 #include "velox/connectors/tpch/TpchConnectorSplit.h"
 #include "velox/tpch/gen/TpchGen.h"
@@ -67,15 +71,23 @@ class TpchTableHandle : public ConnectorTableHandle {
   double scaleFactor_;
 };
 
+// Generates the rows of a split. If there is an executor, this generates the
+// next batches on the executor while the previous ones are processed.
 class TpchDataSource : public DataSource {
  public:
+  // Number of batches generated ahead of next() if there is an executor.
+  static constexpr int32_t kMaxPendingBatches = 4;
+
   TpchDataSource(
       const std::shared_ptr<const RowType>& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
       const std::unordered_map<
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
-      velox::memory::MemoryPool* FOLLY_NONNULL pool);
+      velox::memory::MemoryPool* FOLLY_NONNULL pool,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
+
+  ~TpchDataSource() override;
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -104,6 +116,12 @@ class TpchDataSource : public DataSource {
  private:
   RowVectorPtr projectOutputColumns(RowVectorPtr vector);
 
+  // Returns the next batch of at most 'size' rows generated on 'executor_'.
+  // Returns std::nullopt and sets 'future' if the batch is not ready.
+  std::optional<RowVectorPtr> nextPending(
+      uint64_t size,
+      velox::ContinueFuture& future);
+
   velox::tpch::Table tpchTable_;
   double scaleFactor_{1.0};
   size_t tpchTableRowCount_{0};
@@ -124,6 +142,10 @@ class TpchDataSource : public DataSource {
   size_t completedBytes_{0};
 
   memory::MemoryPool* FOLLY_NONNULL pool_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+
+  // Batches of the current split being generated on 'executor_', in order.
+  std::deque<folly::Future<RowVectorPtr>> pendingBatches_;
 };
 
 class TpchConnector final : public Connector {
@@ -131,8 +153,8 @@ class TpchConnector final : public Connector {
   TpchConnector(
       const std::string& id,
       std::shared_ptr<const Config> properties,
-      folly::Executor* FOLLY_NULLABLE /*executor*/)
-      : Connector(id, properties) {}
+      folly::Executor* FOLLY_NULLABLE executor)
+      : Connector(id, properties), executor_(executor) {}
 
   std::shared_ptr<DataSource> createDataSource(
       const std::shared_ptr<const RowType>& outputType,
@@ -145,7 +167,8 @@ class TpchConnector final : public Connector {
         outputType,
         tableHandle,
         columnHandles,
-        connectorQueryCtx->memoryPool());
+        connectorQueryCtx->memoryPool(),
+        executor_);
   }
 
   std::shared_ptr<DataSink> createDataSink(
@@ -156,6 +179,9 @@ class TpchConnector final : public Connector {
       std::shared_ptr<WriteProtocol> /*writeProtocol*/) override final {
     VELOX_NYI("TpchConnector does not support data sink.");
   }
+
+ private:
+  folly::Executor* FOLLY_NULLABLE const executor_;
 };
 
 class TpchConnectorFactory : public ConnectorFactory {
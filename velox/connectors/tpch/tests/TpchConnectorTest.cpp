@@ -269,6 +269,49 @@ TEST_F(TpchConnectorTest, join) {
   test::assertEqualVectors(expected, output);
 }
 
+// Generates the batches of a split on an executor and checks that they come
+// in the same order as when generated by the Driver.
+TEST_F(TpchConnectorTest, parallelGeneration) {
+  const std::string kParallelConnectorId = "test-tpch-parallel";
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  connector::registerConnector(
+      connector::getConnectorFactory(
+          connector::tpch::TpchConnectorFactory::kTpchConnectorName)
+          ->newConnector(kParallelConnectorId, nullptr, executor.get()));
+
+  for (auto table : {Table::TBL_ORDERS, Table::TBL_LINEITEM}) {
+    auto schema = tpch::getTableSchema(table);
+    auto makePlan = [&](const std::string& connectorId) {
+      std::unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
+          assignments;
+      for (const auto& name : schema->names()) {
+        assignments[name] = std::make_shared<TpchColumnHandle>(name);
+      }
+      return PlanBuilder()
+          .tableScan(
+              schema,
+              std::make_shared<TpchTableHandle>(connectorId, table, 0.01),
+              assignments)
+          .planNode();
+    };
+    // 3 parts, the last of which ends past the end of the table.
+    auto makeSplits = [](const std::string& connectorId) {
+      std::vector<exec::Split> splits;
+      for (auto i = 0; i < 3; ++i) {
+        splits.emplace_back(
+            std::make_shared<TpchConnectorSplit>(connectorId, 3, i));
+      }
+      return splits;
+    };
+    auto expected =
+        getResults(makePlan(kTpchConnectorId), makeSplits(kTpchConnectorId));
+    auto output = getResults(
+        makePlan(kParallelConnectorId), makeSplits(kParallelConnectorId));
+    test::assertEqualVectors(expected, output);
+  }
+  connector::unregisterConnector(kParallelConnectorId);
+}
+
 TEST_F(TpchConnectorTest, orderDateCount) {
   auto plan = PlanBuilder()
                   .tableScan(Table::TBL_ORDERS, {"o_orderdate"}, 0.01)
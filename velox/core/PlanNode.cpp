@@ -62,6 +62,10 @@ AggregationNode::AggregationNode(
     const std::vector<std::string>& aggregateNames,
     const std::vector<CallTypedExprPtr>& aggregates,
     const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+    const std::vector<bool>& distinctAggregates,
+    const std::vector<std::vector<FieldAccessTypedExprPtr>>&
+        aggregateSortingKeys,
+    const std::vector<std::vector<SortOrder>>& aggregateSortingOrders,
     bool ignoreNullKeys,
     PlanNodePtr source)
     : PlanNode(id),
@@ -71,6 +75,9 @@ AggregationNode::AggregationNode(
       aggregateNames_(aggregateNames),
       aggregates_(aggregates),
       aggregateMasks_(aggregateMasks),
+      distinctAggregates_(distinctAggregates),
+      aggregateSortingKeys_(aggregateSortingKeys),
+      aggregateSortingOrders_(aggregateSortingOrders),
       ignoreNullKeys_(ignoreNullKeys),
       sources_{source},
       outputType_(getAggregationOutputType(
@@ -98,9 +105,55 @@ AggregationNode::AggregationNode(
         "Pre-grouped key must be one of the grouping keys: {}.",
         key->name());
   }
+
+  VELOX_CHECK_LE(distinctAggregates_.size(), aggregates_.size());
+  for (auto i = 0; i < distinctAggregates_.size(); ++i) {
+    if (!distinctAggregates_[i]) {
+      continue;
+    }
+    VELOX_USER_CHECK(
+        step_ == Step::kSingle,
+        "Distinct aggregates are only supported in single aggregation: {}",
+        aggregates_[i]->toString());
+    VELOX_USER_CHECK_EQ(
+        aggregates_[i]->inputs().size(),
+        1,
+        "Distinct aggregates must have a single argument: {}",
+        aggregates_[i]->toString());
+  }
+
+  VELOX_CHECK_LE(aggregateSortingKeys_.size(), aggregates_.size());
+  VELOX_CHECK_EQ(aggregateSortingKeys_.size(), aggregateSortingOrders_.size());
+  for (auto i = 0; i < aggregateSortingKeys_.size(); ++i) {
+    VELOX_CHECK_EQ(
+        aggregateSortingKeys_[i].size(), aggregateSortingOrders_[i].size());
+    if (aggregateSortingKeys_[i].empty()) {
+      continue;
+    }
+    VELOX_USER_CHECK(
+        step_ == Step::kSingle,
+        "Sorted aggregates are only supported in single aggregation: {}",
+        aggregates_[i]->toString());
+    VELOX_USER_CHECK(
+        !isDistinctAggregate(i),
+        "Sorted aggregates can not be distinct: {}",
+        aggregates_[i]->toString());
+  }
 }
 
 namespace {
+void addSortingKeys(
+    std::stringstream& stream,
+    const std::vector<FieldAccessTypedExprPtr>& sortingKeys,
+    const std::vector<SortOrder>& sortingOrders) {
+  for (auto i = 0; i < sortingKeys.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << sortingKeys[i]->name() << " " << sortingOrders[i].toString();
+  }
+}
+
 void addFields(
     std::stringstream& stream,
     const std::vector<FieldAccessTypedExprPtr>& keys) {
@@ -146,6 +199,14 @@ void AggregationNode::addDetails(std::stringstream& stream) const {
       stream << ", ";
     }
     stream << aggregateNames_[i] << " := " << aggregates_[i]->toString();
+    if (isDistinctAggregate(i)) {
+      stream << " distinct";
+    }
+    if (isSortedAggregate(i)) {
+      stream << " order by: ";
+      addSortingKeys(
+          stream, aggregateSortingKeys_[i], aggregateSortingOrders_[i]);
+    }
     if (aggregateMasks_.size() > i && aggregateMasks_[i]) {
       stream << " mask: " << aggregateMasks_[i]->name();
     }
@@ -415,17 +476,68 @@ void AbstractJoinNode::addDetails(std::stringstream& stream) const {
   }
 }
 
+HashJoinNode::HashJoinNode(
+    const PlanNodeId& id,
+    JoinType joinType,
+    const std::vector<FieldAccessTypedExprPtr>& leftKeys,
+    const std::vector<FieldAccessTypedExprPtr>& rightKeys,
+    TypedExprPtr filter,
+    PlanNodePtr left,
+    PlanNodePtr right,
+    const RowTypePtr outputType,
+    bool shareBuild)
+    : AbstractJoinNode(
+          id,
+          joinType,
+          leftKeys,
+          rightKeys,
+          filter,
+          left,
+          right,
+          outputType),
+      shareBuild_(shareBuild) {
+  // Right, full and right semi joins set the probed flags in the table.
+  VELOX_CHECK(
+      !shareBuild_ || isInnerJoin() || isLeftJoin() || isLeftSemiFilterJoin() ||
+          isLeftSemiProjectJoin(),
+      "Shared hash join build is not supported for {} join",
+      joinTypeName(joinType));
+}
+
+void HashJoinNode::addDetails(std::stringstream& stream) const {
+  AbstractJoinNode::addDetails(stream);
+  if (shareBuild_) {
+    stream << ", shared build";
+  }
+}
+
 CrossJoinNode::CrossJoinNode(
     const PlanNodeId& id,
     PlanNodePtr left,
     PlanNodePtr right,
     RowTypePtr outputType)
+    : CrossJoinNode(
+          id,
+          nullptr,
+          std::move(left),
+          std::move(right),
+          std::move(outputType)) {}
+
+CrossJoinNode::CrossJoinNode(
+    const PlanNodeId& id,
+    TypedExprPtr filter,
+    PlanNodePtr left,
+    PlanNodePtr right,
+    RowTypePtr outputType)
     : PlanNode(id),
+      filter_(std::move(filter)),
       sources_({std::move(left), std::move(right)}),
       outputType_(std::move(outputType)) {}
 
-void CrossJoinNode::addDetails(std::stringstream& /* stream */) const {
-  // Nothing to add.
+void CrossJoinNode::addDetails(std::stringstream& stream) const {
+  if (filter_) {
+    stream << "filter: " << filter_->toString();
+  }
 }
 
 AssignUniqueIdNode::AssignUniqueIdNode(
@@ -527,12 +639,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
+    bool inputsSorted,
     PlanNodePtr source)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -548,20 +662,6 @@ WindowNode::WindowNode(
       "Number of sorting keys must be equal to the number of sorting orders");
 }
 
-namespace {
-void addSortingKeys(
-    std::stringstream& stream,
-    const std::vector<FieldAccessTypedExprPtr>& sortingKeys,
-    const std::vector<SortOrder>& sortingOrders) {
-  for (auto i = 0; i < sortingKeys.size(); ++i) {
-    if (i > 0) {
-      stream << ", ";
-    }
-    stream << sortingKeys[i]->name() << " " << sortingOrders[i].toString();
-  }
-}
-} // namespace
-
 void LocalMergeNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
@@ -604,6 +704,10 @@ void PartitionedOutputNode::addDetails(std::stringstream& stream) const {
   if (replicateNullsAndAny_) {
     stream << " replicate nulls and any";
   }
+
+  if (rebalanceSkew_) {
+    stream << " rebalance skew";
+  }
 }
 
 void TopNNode::addDetails(std::stringstream& stream) const {
@@ -633,6 +737,10 @@ void OrderByNode::addDetails(std::stringstream& stream) const {
 }
 
 void WindowNode::addDetails(std::stringstream& stream) const {
+  if (inputsSorted_) {
+    stream << "STREAMING ";
+  }
+
   stream << "partition by [";
   if (!partitionKeys_.empty()) {
     addFields(stream, partitionKeys_);
@@ -654,6 +762,65 @@ void WindowNode::addDetails(std::stringstream& stream) const {
   }
 }
 
+namespace {
+RowTypePtr getTopNRowNumberOutputType(
+    const RowTypePtr& inputType,
+    const std::optional<std::string>& rowNumberColumnName) {
+  if (!rowNumberColumnName.has_value()) {
+    return inputType;
+  }
+
+  std::vector<std::string> names = inputType->names();
+  std::vector<TypePtr> types = inputType->children();
+
+  names.push_back(rowNumberColumnName.value());
+  types.push_back(BIGINT());
+  return ROW(std::move(names), std::move(types));
+}
+} // namespace
+
+TopNRowNumberNode::TopNRowNumberNode(
+    PlanNodeId id,
+    std::vector<FieldAccessTypedExprPtr> partitionKeys,
+    std::vector<FieldAccessTypedExprPtr> sortingKeys,
+    std::vector<SortOrder> sortingOrders,
+    const std::optional<std::string>& rowNumberColumnName,
+    int32_t limit,
+    PlanNodePtr source)
+    : PlanNode(std::move(id)),
+      partitionKeys_(std::move(partitionKeys)),
+      sortingKeys_(std::move(sortingKeys)),
+      sortingOrders_(std::move(sortingOrders)),
+      limit_(limit),
+      sources_{std::move(source)},
+      outputType_(getTopNRowNumberOutputType(
+          sources_[0]->outputType(),
+          rowNumberColumnName)) {
+  VELOX_CHECK_EQ(
+      sortingKeys_.size(),
+      sortingOrders_.size(),
+      "Number of sorting keys must be equal to the number of sorting orders");
+  VELOX_CHECK_GT(limit_, 0, "TopNRowNumber limit must be greater than zero");
+}
+
+void TopNRowNumberNode::addDetails(std::stringstream& stream) const {
+  stream << "partition by [";
+  if (!partitionKeys_.empty()) {
+    addFields(stream, partitionKeys_);
+  }
+  stream << "] ";
+
+  stream << "order by [";
+  addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  stream << "] ";
+
+  if (generateRowNumber()) {
+    stream << outputType_->names().back() << " := row_number() ";
+  }
+
+  stream << "limit " << limit_;
+}
+
 void PlanNode::toString(
     std::stringstream& stream,
     bool detailed,
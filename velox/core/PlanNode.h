@@ -493,6 +493,47 @@ class AggregationNode : public PlanNode {
       const std::vector<CallTypedExprPtr>& aggregates,
       const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
       bool ignoreNullKeys,
+      PlanNodePtr source)
+      : AggregationNode(
+            id,
+            step,
+            groupingKeys,
+            preGroupedKeys,
+            aggregateNames,
+            aggregates,
+            aggregateMasks,
+            {},
+            {},
+            {},
+            ignoreNullKeys,
+            std::move(source)) {}
+
+  /**
+   * @param distinctAggregates Flags aligned with 'aggregates' telling which
+   * aggregates apply to the distinct values of their single argument, e.g.
+   * count(DISTINCT a). Can be empty or shorter than 'aggregates' if the
+   * remaining aggregates are not distinct. Distinct aggregates are only
+   * supported in single aggregation.
+   * @param aggregateSortingKeys Lists of sorting keys aligned with
+   * 'aggregates'. An aggregate with a non-empty list receives the input rows
+   * of each group in the order of these keys, e.g. array_agg(a ORDER BY b).
+   * Can be empty or shorter than 'aggregates'. Sorted aggregates are only
+   * supported in single aggregation.
+   * @param aggregateSortingOrders Sort orders for 'aggregateSortingKeys'.
+   */
+  AggregationNode(
+      const PlanNodeId& id,
+      Step step,
+      const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+      const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+      const std::vector<std::string>& aggregateNames,
+      const std::vector<CallTypedExprPtr>& aggregates,
+      const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+      const std::vector<bool>& distinctAggregates,
+      const std::vector<std::vector<FieldAccessTypedExprPtr>>&
+          aggregateSortingKeys,
+      const std::vector<std::vector<SortOrder>>& aggregateSortingOrders,
+      bool ignoreNullKeys,
       PlanNodePtr source);
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -527,6 +568,28 @@ class AggregationNode : public PlanNode {
     return aggregateMasks_;
   }
 
+  /// Returns true if the aggregate at 'index' applies to the distinct values
+  /// of its argument.
+  bool isDistinctAggregate(size_t index) const {
+    return index < distinctAggregates_.size() && distinctAggregates_[index];
+  }
+
+  /// Returns true if the aggregate at 'index' receives its input sorted in
+  /// each group. See aggregateSortingKeys() and aggregateSortingOrders().
+  bool isSortedAggregate(size_t index) const {
+    return index < aggregateSortingKeys_.size() &&
+        !aggregateSortingKeys_[index].empty();
+  }
+
+  const std::vector<std::vector<FieldAccessTypedExprPtr>>&
+  aggregateSortingKeys() const {
+    return aggregateSortingKeys_;
+  }
+
+  const std::vector<std::vector<SortOrder>>& aggregateSortingOrders() const {
+    return aggregateSortingOrders_;
+  }
+
   bool ignoreNullKeys() const {
     return ignoreNullKeys_;
   }
@@ -554,6 +617,9 @@ class AggregationNode : public PlanNode {
   // Keeps mask/'no mask' for every aggregation. Mask, if given, is a reference
   // to a boolean projection column, used to mask out rows for the aggregation.
   const std::vector<FieldAccessTypedExprPtr> aggregateMasks_;
+  const std::vector<bool> distinctAggregates_;
+  const std::vector<std::vector<FieldAccessTypedExprPtr>> aggregateSortingKeys_;
+  const std::vector<std::vector<SortOrder>> aggregateSortingOrders_;
   const bool ignoreNullKeys_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
@@ -854,16 +920,24 @@ class PartitionedOutputNode : public PlanNode {
       bool replicateNullsAndAny,
       PartitionFunctionFactory partitionFunctionFactory,
       RowTypePtr outputType,
-      PlanNodePtr source)
+      PlanNodePtr source,
+      bool rebalanceSkew = false)
       : PlanNode(id),
         sources_{{std::move(source)}},
         keys_(keys),
         numPartitions_(numPartitions),
         broadcast_(broadcast),
         replicateNullsAndAny_(replicateNullsAndAny),
+        rebalanceSkew_(rebalanceSkew),
         partitionFunctionFactory_(std::move(partitionFunctionFactory)),
         outputType_(std::move(outputType)) {
     VELOX_CHECK(numPartitions > 0, "numPartitions must be greater than zero");
+    if (rebalanceSkew) {
+      VELOX_CHECK(
+          !keys_.empty() && !replicateNullsAndAny,
+          "Skew rebalancing requires hash partitioning without replicating "
+          "nulls and any");
+    }
     if (numPartitions == 1) {
       VELOX_CHECK(
           keys_.empty(),
@@ -943,6 +1017,15 @@ class PartitionedOutputNode : public PlanNode {
     return replicateNullsAndAny_;
   }
 
+  /// Returns true if the rows of partitions that receive much more data than
+  /// the average may be spread over several destinations. Rows with the same
+  /// keys can then reach different destinations, so this is only valid if the
+  /// consumers do not need all of them together, e.g. they run a partial
+  /// aggregation or probe a broadcast join build side.
+  bool isRebalanceSkew() const {
+    return rebalanceSkew_;
+  }
+
   const PartitionFunctionFactory& partitionFunctionFactory() const {
     return partitionFunctionFactory_;
   }
@@ -959,6 +1042,7 @@ class PartitionedOutputNode : public PlanNode {
   const int numPartitions_;
   const bool broadcast_;
   const bool replicateNullsAndAny_;
+  const bool rebalanceSkew_;
   const PartitionFunctionFactory partitionFunctionFactory_;
   const RowTypePtr outputType_;
 };
@@ -1165,9 +1249,10 @@ class AbstractJoinNode : public PlanNode {
     return filter_;
   }
 
- private:
+ protected:
   void addDetails(std::stringstream& stream) const override;
 
+ private:
   const JoinType joinType_;
   const std::vector<FieldAccessTypedExprPtr> leftKeys_;
   const std::vector<FieldAccessTypedExprPtr> rightKeys_;
@@ -1193,20 +1278,24 @@ class HashJoinNode : public AbstractJoinNode {
       TypedExprPtr filter,
       PlanNodePtr left,
       PlanNodePtr right,
-      const RowTypePtr outputType)
-      : AbstractJoinNode(
-            id,
-            joinType,
-            leftKeys,
-            rightKeys,
-            filter,
-            left,
-            right,
-            outputType) {}
+      const RowTypePtr outputType,
+      bool shareBuild = false);
 
   std::string_view name() const override {
     return "HashJoin";
   }
+
+  /// True if the build side is the same in all Tasks of the stage, e.g. a
+  /// broadcast, so that the Tasks on a worker share one hash table. See
+  /// exec::HashTableCache.
+  bool isShareBuild() const {
+    return shareBuild_;
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const bool shareBuild_;
 };
 
 /// Represents inner/outer/semi/anti merge joins. Translates to an
@@ -1249,6 +1338,16 @@ class CrossJoinNode : public PlanNode {
       PlanNodePtr right,
       RowTypePtr outputType);
 
+  /// @param filter Optional filter to apply to the cross product of the
+  /// inputs, e.g. the range condition of an inequality join. Can refer to
+  /// columns from both sides of the join.
+  CrossJoinNode(
+      const PlanNodeId& id,
+      TypedExprPtr filter,
+      PlanNodePtr left,
+      PlanNodePtr right,
+      RowTypePtr outputType);
+
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
   }
@@ -1257,6 +1356,10 @@ class CrossJoinNode : public PlanNode {
     return outputType_;
   }
 
+  const TypedExprPtr& filter() const {
+    return filter_;
+  }
+
   std::string_view name() const override {
     return "CrossJoin";
   }
@@ -1264,6 +1367,7 @@ class CrossJoinNode : public PlanNode {
  private:
   void addDetails(std::stringstream& stream) const override;
 
+  const TypedExprPtr filter_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
 };
@@ -1590,6 +1694,8 @@ class AssignUniqueIdNode : public PlanNode {
 /// ORDER BY value) or ROWS (position based).
 /// The frame bound types are CURRENT_ROW, (expression or UNBOUNDED)
 /// ROWS_PRECEDING and (expression or UNBOUNDED) ROWS_FOLLOWING.
+/// In RANGE mode, an expression bound is an offset from the single ORDER BY
+/// value of the row, e.g. an INTERVAL DAY TO SECOND for a TIMESTAMP key.
 /// The WindowNode has one passthrough output column for each input
 /// column followed by the results of the window functions.
 class WindowNode : public PlanNode {
@@ -1621,6 +1727,11 @@ class WindowNode : public PlanNode {
   /// @param windowColumnNames specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @param inputsSorted specifies that the input is already sorted on the
+  /// partition keys followed by the sorting keys. This enables a streaming
+  /// window algorithm which only holds one partition in memory. The caller
+  /// is responsible that input data is indeed sorted. If that's not the case,
+  /// the query may return incorrect results.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -1628,6 +1739,7 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
+      bool inputsSorted,
       PlanNodePtr source);
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -1656,6 +1768,10 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
   std::string_view name() const override {
     return "Window";
   }
@@ -1670,6 +1786,77 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
+  const std::vector<PlanNodePtr> sources_;
+
+  const RowTypePtr outputType_;
+};
+
+/// Optimized version of a WindowNode with a single row_number function and a
+/// filter on the row number, e.g. WHERE row_number() OVER (PARTITION BY k
+/// ORDER BY ts DESC) <= 3. Keeps only the first 'limit' rows of each partition
+/// in the order of the sorting keys. The plan producer is responsible for
+/// replacing the window and the filter with this node.
+class TopNRowNumberNode : public PlanNode {
+ public:
+  /// @param rowNumberColumnName Optional name of the BIGINT column with the
+  /// row number of each row in its partition. If not set, the row number is
+  /// not output.
+  /// @param limit Number of rows to keep from each partition.
+  TopNRowNumberNode(
+      PlanNodeId id,
+      std::vector<FieldAccessTypedExprPtr> partitionKeys,
+      std::vector<FieldAccessTypedExprPtr> sortingKeys,
+      std::vector<SortOrder> sortingOrders,
+      const std::optional<std::string>& rowNumberColumnName,
+      int32_t limit,
+      PlanNodePtr source);
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  /// The input columns followed by the row number column if
+  /// 'rowNumberColumnName' is set.
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& partitionKeys() const {
+    return partitionKeys_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& sortingKeys() const {
+    return sortingKeys_;
+  }
+
+  const std::vector<SortOrder>& sortingOrders() const {
+    return sortingOrders_;
+  }
+
+  bool generateRowNumber() const {
+    return outputType_->size() > sources_[0]->outputType()->size();
+  }
+
+  int32_t limit() const {
+    return limit_;
+  }
+
+  std::string_view name() const override {
+    return "TopNRowNumber";
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<FieldAccessTypedExprPtr> partitionKeys_;
+
+  const std::vector<FieldAccessTypedExprPtr> sortingKeys_;
+  const std::vector<SortOrder> sortingOrders_;
+
+  const int32_t limit_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
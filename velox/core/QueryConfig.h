@@ -61,11 +61,60 @@ class QueryConfig {
   static constexpr const char* kExprTrackCpuUsage =
       "expression.track_cpu_usage";
 
+  // Whether to evaluate top level arithmetic, comparison and logical
+  // expressions over fixed width columns with a fused program instead of the
+  // interpreter. See FusedExpr. False by default.
+  static constexpr const char* kExprFusedEvalEnabled =
+      "expression.fused_eval_enabled";
+
+  // Whether to simplify expressions before compiling them, e.g. 'not(not(a))'
+  // into 'a' or 'coalesce(a, a)' into 'a'. See ExprRewriter. False by
+  // default.
+  static constexpr const char* kExprRewriteEnabled =
+      "expression.rewrite_enabled";
+
+  // If at most this fraction of the rows of a batch pass the filter of a
+  // FilterProject, the passing rows of the input columns are copied into
+  // flat vectors and the projections are evaluated on these. The output is
+  // then flat instead of wrapped in dictionaries. Only done if the copied
+  // columns are not of complex types. 0 by default, i.e. never.
+  static constexpr const char* kFilterProjectMaxCompactSelectivity =
+      "filter_project.max_compact_selectivity";
+
+  // Comma separated names of deterministic functions whose results are cached
+  // by argument values across batches. For expensive functions of arguments
+  // with few distinct values, e.g. parsing of user agents. See
+  // ExprValueCache.
+  static constexpr const char* kExprCachedFunctions =
+      "expression.cached_functions";
+
+  // Maximum number of distinct arguments cached for each call of a function
+  // in kExprCachedFunctions.
+  static constexpr const char* kExprValueCacheMaxEntries =
+      "expression.value_cache_max_entries";
+
   // Whether to track CPU usage for stages of individual operators. True by
   // default. Can be expensive when processing small batches, e.g. < 10K rows.
   static constexpr const char* kOperatorTrackCpuUsage =
       "driver.track_operator_cpu_usage";
 
+  // If greater than 1 and CPU usage is tracked, times one in this many calls
+  // to each stage of an operator, chosen at random, and counts the other calls
+  // without timing them. The timed calls count for all calls, so that the
+  // timings in OperatorStats estimate the full time. 1 by default, i.e. all
+  // calls are timed.
+  static constexpr const char* kOperatorCpuUsageSampleRate =
+      "driver.operator_cpu_usage_sample_rate";
+
+  // If greater than 0, a Driver running on an executor yields its thread after
+  // running for this many milliseconds and goes to the end of the executor
+  // queue. 0 by default, i.e. Drivers run until they block or finish.
+  static constexpr const char* kDriverTimeSliceMs = "driver.time_slice_ms";
+
+  // If true, the Drivers record the intervals they run, wait in the executor
+  // queue and are blocked into TaskStats::traceEvents. See toChromeTrace().
+  static constexpr const char* kDriverTraceEvents = "driver.trace_events";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -94,6 +143,35 @@ class QueryConfig {
   static constexpr const char* kPartialAggregationGoodPct =
       "partial_aggregation_reduction_ratio_threshold";
 
+  /// Number of input rows a partial aggregation must see before it may decide
+  /// to stop building groups because its reduction is poor.
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  /// Number of distinct groups as percentage of the input rows above which a
+  /// partial aggregation stops building groups and converts each input row to
+  /// an intermediate result.
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
+  /// If true, the drivers of a final or single aggregation aggregate their
+  /// input into separate hash tables which are merged in parallel by hash
+  /// partition after all input is received. This allows running the
+  /// aggregation without a local exchange in front of it.
+  static constexpr const char* kAggregationParallelMergeEnabled =
+      "aggregation_parallel_merge_enabled";
+
+  /// If true, a final order by runs on multiple drivers. Each driver sorts its
+  /// share of the input and the last driver to finish input merges the sorted
+  /// rows of all drivers. Doesn't apply if order by spilling is enabled.
+  static constexpr const char* kOrderByParallelSortEnabled =
+      "order_by_parallel_sort_enabled";
+
+  /// The max number of threads computing the window functions of a window
+  /// operator. If more than 1, the complete window partitions are split
+  /// between up to this many threads of the query executor.
+  static constexpr const char* kWindowParallelism = "window_parallelism";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
@@ -102,6 +180,42 @@ class QueryConfig {
   static constexpr const char* kPreferredOutputBatchSize =
       "preferred_output_batch_size";
 
+  /// Preferred size in bytes of the batches returned by operators from
+  /// Operator::getOutput. Used by operators which can estimate the size of the
+  /// rows they produce, e.g. HashProbe. The batches have at most
+  /// 'preferred_output_batch_size' rows.
+  static constexpr const char* kPreferredOutputBatchBytes =
+      "preferred_output_batch_bytes";
+
+  /// If greater than 0, the vectors produced by filters and local exchanges
+  /// are copied together until they have this many rows, unless they have
+  /// this many rows by themselves. Disabled by default.
+  static constexpr const char* kCoalesceBatchesMinRows =
+      "coalesce_batches_min_rows";
+
+  /// Maximum number of queued splits that a TableScan opens ahead of the
+  /// split it is reading. The file footer and the first stripe of these
+  /// splits are read on the connector's executor. 0 disables split preload.
+  static constexpr const char* kMaxSplitPreloadPerDriver =
+      "max_split_preload_per_driver";
+
+  /// If true, TableScan reads each batch and loads its lazy vectors on the
+  /// connector's executor and blocks its Driver on the result, so that the
+  /// Driver thread runs other Drivers while the batch waits for IO. Lazy
+  /// vectors are then loaded for all rows instead of the rows passing the
+  /// downstream filters.
+  static constexpr const char* kTableScanAsyncLoad = "table_scan_async_load";
+
+  /// The codec for compressing the pages of PartitionedOutput: "none", "lz4"
+  /// or "zstd". The Exchange operators of the query use the same codec.
+  static constexpr const char* kExchangeCompressionCodec =
+      "exchange-compression-codec";
+
+  /// If true, PartitionedOutput writes columns of constant and dictionary
+  /// vectors as RLE and DICTIONARY blocks instead of flattening them.
+  static constexpr const char* kExchangePreserveEncodings =
+      "exchange-preserve-encodings";
+
   static constexpr const char* kHashAdaptivityEnabled =
       "driver.hash_adaptivity_enabled";
 
@@ -110,6 +224,24 @@ class QueryConfig {
 
   static constexpr const char* kCreateEmptyFiles = "driver.create_empty_files";
 
+  /// If true, a hash join build side whose table is in kHash mode produces a
+  /// Bloom filter on each integer join key and pushes it down into the probe
+  /// side scan as a dynamic filter.
+  static constexpr const char* kHashJoinBloomFilterEnabled =
+      "hash_join_bloom_filter_enabled";
+
+  /// The max number of distinct build side keys for which a hash join
+  /// produces Bloom filter dynamic filters. The filter takes ~2 bytes per key.
+  static constexpr const char* kHashJoinBloomFilterMaxEntries =
+      "hash_join_bloom_filter_max_entries";
+
+  /// Number of high bits of the hash table bucket index used to
+  /// radix-partition the probe rows of a hash join before probing a large
+  /// table. Each partition is probed separately so that its random accesses
+  /// stay within a cache-sized slice of the table. 0 disables partitioning.
+  static constexpr const char* kHashJoinProbePartitionBits =
+      "hash_join_probe_partition_bits";
+
   /// Global enable spilling flag.
   static constexpr const char* kSpillEnabled = "spill_enabled";
 
@@ -126,21 +258,45 @@ class QueryConfig {
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// Window spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
+
+  /// TopN spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNSpillEnabled = "topn_spill_enabled";
+
   /// The max memory that a final aggregation can use before spilling. If it 0,
   /// then there is no limit.
   static constexpr const char* kAggregationSpillMemoryThreshold =
       "aggregation_spill_memory_threshold";
 
   /// The max memory that a hash join can use before spilling. If it 0, then
-  /// there is no limit.
+  /// there is no limit. Also applies to the build side of a cross join.
   static constexpr const char* kJoinSpillMemoryThreshold =
       "join_spill_memory_threshold";
 
+  /// The min percentage of the sampled rows of a hash join build spill
+  /// partition that have the same key for the partition to be considered
+  /// skewed. Recursive spilling can't split a partition dominated by a hot
+  /// key, so the hash build keeps the skewed partitions in memory and spills
+  /// the other partitions first. If it is 0, then there is no skew detection.
+  static constexpr const char* kJoinSpillSkewedKeyPct =
+      "join_spill_skewed_key_pct";
+
   /// The max memory that an order by can use before spilling. If it 0, then
   /// there is no limit.
   static constexpr const char* kOrderBySpillMemoryThreshold =
       "order_by_spill_memory_threshold";
 
+  /// The max memory that a window can use before spilling. If it 0, then
+  /// there is no limit.
+  static constexpr const char* kWindowSpillMemoryThreshold =
+      "window_spill_memory_threshold";
+
+  /// The max memory that a top n can use before spilling. If it 0, then there
+  /// is no limit.
+  static constexpr const char* kTopNSpillMemoryThreshold =
+      "topn_spill_memory_threshold";
+
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
   /// The max allowed spilling level with zero being the initial spilling level.
@@ -172,6 +328,11 @@ class QueryConfig {
   static constexpr const char* kSpillableReservationGrowthPct =
       "spillable-reservation-growth-pct";
 
+  /// The codec for compressing spill files: "none", "lz4", "zstd", "snappy"
+  /// or "zlib".
+  static constexpr const char* kSpillCompressionCodec =
+      "spill-compression-codec";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
@@ -192,16 +353,54 @@ class QueryConfig {
     return get<double>(kPartialAggregationGoodPct, kDefault);
   }
 
+  int64_t abandonPartialAggregationMinRows() const {
+    static constexpr int64_t kDefault = 100'000;
+    return get<int64_t>(kAbandonPartialAggregationMinRows, kDefault);
+  }
+
+  int32_t abandonPartialAggregationMinPct() const {
+    static constexpr int32_t kDefault = 80;
+    return get<int32_t>(kAbandonPartialAggregationMinPct, kDefault);
+  }
+
+  bool aggregationParallelMergeEnabled() const {
+    return get<bool>(kAggregationParallelMergeEnabled, false);
+  }
+
+  bool orderByParallelSortEnabled() const {
+    return get<bool>(kOrderByParallelSortEnabled, false);
+  }
+
+  int32_t windowParallelism() const {
+    static constexpr int32_t kDefault = 1;
+    return get<int32_t>(kWindowParallelism, kDefault);
+  }
+
   uint64_t joinSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kJoinSpillMemoryThreshold, kDefault);
   }
 
+  int32_t joinSpillSkewedKeyPct() const {
+    static constexpr int32_t kDefault = 50;
+    return get<int32_t>(kJoinSpillSkewedKeyPct, kDefault);
+  }
+
   uint64_t orderBySpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kOrderBySpillMemoryThreshold, kDefault);
   }
 
+  uint64_t windowSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kWindowSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t topNSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kTopNSpillMemoryThreshold, kDefault);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -220,10 +419,48 @@ class QueryConfig {
     return get<uint32_t>(kPreferredOutputBatchSize, 1024);
   }
 
+  uint64_t preferredOutputBatchBytes() const {
+    static constexpr uint64_t kDefault = 10UL << 20;
+    return get<uint64_t>(kPreferredOutputBatchBytes, kDefault);
+  }
+
+  uint32_t coalesceBatchesMinRows() const {
+    return get<uint32_t>(kCoalesceBatchesMinRows, 0);
+  }
+
+  int32_t maxSplitPreloadPerDriver() const {
+    return get<int32_t>(kMaxSplitPreloadPerDriver, 2);
+  }
+
+  bool tableScanAsyncLoad() const {
+    return get<bool>(kTableScanAsyncLoad, false);
+  }
+
+  std::string exchangeCompressionCodec() const {
+    return get<std::string>(kExchangeCompressionCodec, "none");
+  }
+
+  bool exchangePreserveEncodings() const {
+    return get<bool>(kExchangePreserveEncodings, false);
+  }
+
   bool hashAdaptivityEnabled() const {
     return get<bool>(kHashAdaptivityEnabled, true);
   }
 
+  bool hashJoinBloomFilterEnabled() const {
+    return get<bool>(kHashJoinBloomFilterEnabled, false);
+  }
+
+  uint64_t hashJoinBloomFilterMaxEntries() const {
+    static constexpr uint64_t kDefault = 4UL << 20;
+    return get<uint64_t>(kHashJoinBloomFilterMaxEntries, kDefault);
+  }
+
+  uint8_t hashJoinProbePartitionBits() const {
+    return get<uint8_t>(kHashJoinProbePartitionBits, 0);
+  }
+
   uint32_t writeStrideSize() const {
     static constexpr uint32_t kDefault = 100'000;
     return kDefault;
@@ -308,6 +545,18 @@ class QueryConfig {
     return get<bool>(kOrderBySpillEnabled, true);
   }
 
+  /// Returns 'is window spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool windowSpillEnabled() const {
+    return get<bool>(kWindowSpillEnabled, true);
+  }
+
+  /// Returns 'is topn spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool topNSpillEnabled() const {
+    return get<bool>(kTopNSpillEnabled, true);
+  }
+
   // Returns a percentage of aggregation or join input batches that
   // will be forced to spill for testing. 0 means no extra spilling.
   int32_t testingSpillPct() const {
@@ -335,6 +584,10 @@ class QueryConfig {
     return std::min(kMaxBits, get<int32_t>(kSpillPartitionBits, kDefaultBits));
   }
 
+  std::string spillCompressionCodec() const {
+    return get<std::string>(kSpillCompressionCodec, "none");
+  }
+
   uint64_t maxSpillFileSize() const {
     constexpr uint64_t kDefaultMaxFileSize = 0;
     return get<uint64_t>(kMaxSpillFileSize, kDefaultMaxFileSize);
@@ -358,10 +611,43 @@ class QueryConfig {
     return get<bool>(kExprTrackCpuUsage, false);
   }
 
+  bool exprFusedEvalEnabled() const {
+    return get<bool>(kExprFusedEvalEnabled, false);
+  }
+
+  bool exprRewriteEnabled() const {
+    return get<bool>(kExprRewriteEnabled, false);
+  }
+
+  double filterProjectMaxCompactSelectivity() const {
+    return get<double>(kFilterProjectMaxCompactSelectivity, 0);
+  }
+
+  std::string exprCachedFunctions() const {
+    return get<std::string>(kExprCachedFunctions, "");
+  }
+
+  int32_t exprValueCacheMaxEntries() const {
+    static constexpr int32_t kDefault = 10'000;
+    return get<int32_t>(kExprValueCacheMaxEntries, kDefault);
+  }
+
   bool operatorTrackCpuUsage() const {
     return get<bool>(kOperatorTrackCpuUsage, true);
   }
 
+  uint32_t operatorCpuUsageSampleRate() const {
+    return std::max<uint32_t>(1, get<uint32_t>(kOperatorCpuUsageSampleRate, 1));
+  }
+
+  uint32_t driverTimeSliceMs() const {
+    return get<uint32_t>(kDriverTimeSliceMs, 0);
+  }
+
+  bool driverTraceEvents() const {
+    return get<bool>(kDriverTraceEvents, false);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return configManager_->get<T>(key, defaultValue);
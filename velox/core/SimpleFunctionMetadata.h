@@ -19,6 +19,7 @@
 
 #include "folly/Likely.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/Status.h"
 #include "velox/core/CoreTypeSystem.h"
 #include "velox/core/Metaprogramming.h"
 #include "velox/core/QueryConfig.h"
@@ -483,6 +484,9 @@ class UDFHolder final
     : public core::SimpleFunctionMetadata<Fun, TReturn, TArgs...> {
   Fun instance_;
 
+  // The failed Status returned by the last call(), until taken.
+  Status status_;
+
  public:
   using udf_struct_t = Fun;
   using Metadata = core::SimpleFunctionMetadata<Fun, TReturn, TArgs...>;
@@ -513,6 +517,7 @@ class UDFHolder final
   DECLARE_METHOD_RESOLVER(callNullable_method_resolver, callNullable);
   DECLARE_METHOD_RESOLVER(callNullFree_method_resolver, callNullFree);
   DECLARE_METHOD_RESOLVER(callAscii_method_resolver, callAscii);
+  DECLARE_METHOD_RESOLVER(callBatch_method_resolver, callBatch);
   DECLARE_METHOD_RESOLVER(initialize_method_resolver, initialize);
 
   // Check which flavor of the call() method is provided by the UDF object. UDFs
@@ -523,11 +528,14 @@ class UDFHolder final
   // - bool|void callNullFree(...)
   //
   // Each of these methods can return either bool or void. Returning void means
-  // that the UDF is assumed never to return null values.
+  // that the UDF is assumed never to return null values. call() can also
+  // return Status, in which case a failed status makes the row an error
+  // without throwing an exception.
   //
   // Optionally, UDFs can also provide the following methods:
   //
   // - bool|void callAscii(...)
+  // - void callBatch(size, result*, args*...)
   // - void initialize(...)
 
   // call():
@@ -543,11 +551,18 @@ class UDFHolder final
       void,
       exec_return_type,
       const exec_arg_type<TArgs>&...>::value;
-  static constexpr bool udf_has_call =
-      udf_has_call_return_bool | udf_has_call_return_void;
+  static constexpr bool udf_has_call_return_status = util::has_method<
+      Fun,
+      call_method_resolver,
+      Status,
+      exec_return_type,
+      const exec_arg_type<TArgs>&...>::value;
+  static constexpr bool udf_has_call = udf_has_call_return_bool |
+      udf_has_call_return_void | udf_has_call_return_status;
   static_assert(
-      !(udf_has_call_return_bool && udf_has_call_return_void),
-      "Provided call() methods need to return either void OR bool.");
+      (udf_has_call_return_bool + udf_has_call_return_void +
+       udf_has_call_return_status) <= 1,
+      "Provided call() methods need to return either void, bool OR Status.");
 
   // callNullable():
   static constexpr bool udf_has_callNullable_return_bool = util::has_method<
@@ -612,6 +627,17 @@ class UDFHolder final
         (udf_has_callAscii_return_void && udf_has_call_return_bool)),
       "The return type for callAscii() must match the return type for call().");
 
+  // callBatch(): computes 'size' consecutive non-null results from arrays of
+  // 'size' non-null arguments each. May throw, in which case the rows are
+  // evaluated again one by one through call().
+  static constexpr bool udf_has_callBatch = util::has_method<
+      Fun,
+      callBatch_method_resolver,
+      void,
+      int32_t,
+      exec_return_type*,
+      const exec_arg_type<TArgs>*...>::value;
+
   // initialize():
   static constexpr bool udf_has_initialize = util::has_method<
       Fun,
@@ -620,6 +646,11 @@ class UDFHolder final
       const core::QueryConfig&,
       const exec_arg_type<TArgs>*...>::value;
 
+  static_assert(
+      !(udf_has_call_return_status &&
+        (udf_has_callNullable || udf_has_callNullFree || udf_has_callAscii)),
+      "call() returning Status cannot be combined with other call methods.");
+
   static_assert(
       udf_has_call || udf_has_callNullable || udf_has_callNullFree,
       "UDF must implement at least one of `call`, `callNullable`, or `callNullFree`");
@@ -638,11 +669,11 @@ class UDFHolder final
   static constexpr bool is_default_null_behavior = !udf_has_callNullable;
 
   // If any of the the provided "call" flavors can produce null (in case any of
-  // them return bool). This is only false if all the call methods provided for
-  // a function return void.
+  // them return bool or Status). This is only false if all the call methods
+  // provided for a function return void.
   static constexpr bool can_produce_null_output = udf_has_call_return_bool |
-      udf_has_callNullable_return_bool | udf_has_callNullFree_return_bool |
-      udf_has_callAscii_return_bool;
+      udf_has_call_return_status | udf_has_callNullable_return_bool |
+      udf_has_callNullFree_return_bool | udf_has_callAscii_return_bool;
 
   // This is true when callNullFree is implemented, but not call or
   // callNullable. In this case if any input is NULL or any complex type in
@@ -737,7 +768,31 @@ class UDFHolder final
     }
   }
 
-  // Helper functions to handle void vs bool return type.
+  FOLLY_ALWAYS_INLINE void callBatch(
+      int32_t size,
+      exec_return_type* result,
+      const exec_arg_type<TArgs>*... args) {
+    if constexpr (udf_has_callBatch) {
+      instance_.callBatch(size, result, args...);
+    } else {
+      VELOX_UNREACHABLE(
+          "callBatch should never be called if the UDF does not "
+          "implement callBatch.");
+    }
+  }
+
+  /// True if the last call() returned a failed Status, i.e. the null result
+  /// it reported is an error.
+  bool hasFailedStatus() const {
+    return !status_.ok();
+  }
+
+  /// Returns the failed Status of the last call() and resets it.
+  Status takeStatus() {
+    return std::exchange(status_, Status());
+  }
+
+  // Helper functions to handle void vs bool vs Status return type.
 
   FOLLY_ALWAYS_INLINE bool callImpl(
       typename Exec::template resolver<TReturn>::out_type& out,
@@ -745,6 +800,13 @@ class UDFHolder final
     static_assert(udf_has_call);
     if constexpr (udf_has_call_return_bool) {
       return instance_.call(out, args...);
+    } else if constexpr (udf_has_call_return_status) {
+      auto status = instance_.call(out, args...);
+      if (LIKELY(status.ok())) {
+        return true;
+      }
+      status_ = std::move(status);
+      return false;
     } else {
       instance_.call(out, args...);
       return true;
@@ -16,6 +16,14 @@
 
 #include "velox/dwio/common/BitPackDecoder.h"
 
+#include "velox/common/process/ProcessBase.h"
+
+#include <folly/lang/Bits.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
 namespace facebook::velox::dwio::common {
 
 using int128_t = __int128_t;
@@ -327,4 +335,191 @@ template void unpack(
     const char* bufferEnd,
     int16_t* result);
 
+namespace {
+// Returns the 'width' bits starting 'bit' bits from the most significant bit
+// of 'input'. Reads 8 bytes from 'input' + 'bit' / 8, and one more if the
+// field does not fit in these.
+inline uint64_t loadBigEndianField(
+    const uint8_t* FOLLY_NONNULL input,
+    uint64_t bit,
+    uint8_t width) {
+  auto bytes = input + bit / 8;
+  const auto offset = bit % 8;
+  uint64_t word = folly::Endian::big(folly::loadUnaligned<uint64_t>(bytes))
+      << offset;
+  if (offset + width > 64) {
+    word |= bytes[8] >> (8 - offset);
+  }
+  return word >> (64 - width);
+}
+
+// Unpacks the 8 fields of 'width' bits in the 'width' bytes at 'input'.
+inline void unpackBigEndian8(
+    const uint8_t* FOLLY_NONNULL input,
+    uint8_t width,
+    uint64_t* FOLLY_NONNULL result) {
+  for (auto i = 0; i < 8; ++i) {
+    result[i] = loadBigEndianField(input, i * width, width);
+  }
+}
+
+#ifdef __x86_64__
+
+#define VELOX_AVX512_VBMI \
+  __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+
+// Returns the mask for loading the first 'numBytes' of 64 bytes.
+inline __mmask64 firstBytes(int32_t numBytes) {
+  return numBytes == 64 ? ~0ULL : (1ULL << numBytes) - 1;
+}
+
+// Unpacks 16 fields per loop with one 32 bit lane per field. Each lane gets
+// the 4 bytes starting at the first byte of its field, which hold the field
+// for widths up to 25.
+VELOX_AVX512_VBMI uint64_t unpack32Lanes(
+    const uint8_t* FOLLY_NONNULL& input,
+    uint64_t numValues,
+    uint8_t width,
+    uint32_t* FOLLY_NONNULL& result) {
+  alignas(64) uint8_t indices[64];
+  alignas(64) uint32_t shifts[16];
+  for (auto i = 0; i < 16; ++i) {
+    for (auto byte = 0; byte < 4; ++byte) {
+      indices[i * 4 + byte] = i * width / 8 + byte;
+    }
+    shifts[i] = i * width % 8;
+  }
+  const auto permute = _mm512_load_si512(indices);
+  const auto shift = _mm512_load_si512(shifts);
+  const auto mask = _mm512_set1_epi32(bits::lowMask(width));
+  const auto loadMask = firstBytes(2 * width);
+  const auto numUnpacked = numValues & ~15ULL;
+  for (uint64_t i = 0; i < numUnpacked; i += 16) {
+    auto fields = _mm512_permutexvar_epi8(
+        permute, _mm512_maskz_loadu_epi8(loadMask, input));
+    fields = _mm512_and_si512(_mm512_srlv_epi32(fields, shift), mask);
+    _mm512_storeu_si512(result, fields);
+    input += 2 * width;
+    result += 16;
+  }
+  return numUnpacked;
+}
+
+// Unpacks 16 fields per loop with one 64 bit lane per field, for widths over
+// 25. The lanes are narrowed to 32 bits for storing.
+VELOX_AVX512_VBMI uint64_t unpack64Lanes(
+    const uint8_t* FOLLY_NONNULL& input,
+    uint64_t numValues,
+    uint8_t width,
+    uint32_t* FOLLY_NONNULL& result) {
+  alignas(64) uint8_t indices[2][64];
+  alignas(64) uint64_t shifts[2][8];
+  for (auto i = 0; i < 16; ++i) {
+    for (auto byte = 0; byte < 8; ++byte) {
+      // The bytes past the end of the field are not used.
+      indices[i / 8][i % 8 * 8 + byte] = std::min(i * width / 8 + byte, 63);
+    }
+    shifts[i / 8][i % 8] = i * width % 8;
+  }
+  const __m512i permute[2] = {
+      _mm512_load_si512(indices[0]), _mm512_load_si512(indices[1])};
+  const __m512i shift[2] = {
+      _mm512_load_si512(shifts[0]), _mm512_load_si512(shifts[1])};
+  const auto mask = _mm256_set1_epi32(bits::lowMask(width));
+  const auto loadMask = firstBytes(2 * width);
+  const auto numUnpacked = numValues & ~15ULL;
+  for (uint64_t i = 0; i < numUnpacked; i += 16) {
+    const auto bytes = _mm512_maskz_loadu_epi8(loadMask, input);
+    for (auto half = 0; half < 2; ++half) {
+      auto fields = _mm512_srlv_epi64(
+          _mm512_permutexvar_epi8(permute[half], bytes), shift[half]);
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(result + half * 8),
+          _mm256_and_si256(_mm512_cvtepi64_epi32(fields), mask));
+    }
+    input += 2 * width;
+    result += 16;
+  }
+  return numUnpacked;
+}
+
+// Unpacks 8 big endian fields per loop with one 64 bit lane per field. The
+// bytes of each lane are reversed, so that the field starts at the most
+// significant bit plus the bit offset of the field. Supports widths up to 56.
+VELOX_AVX512_VBMI uint64_t unpackBigEndian64Lanes(
+    const uint8_t* FOLLY_NONNULL input,
+    uint64_t numValues,
+    uint8_t width,
+    uint64_t* FOLLY_NONNULL result) {
+  alignas(64) uint8_t indices[64];
+  alignas(64) uint64_t shifts[8];
+  for (auto i = 0; i < 8; ++i) {
+    for (auto byte = 0; byte < 8; ++byte) {
+      indices[i * 8 + 7 - byte] = i * width / 8 + byte;
+    }
+    shifts[i] = i * width % 8;
+  }
+  const auto permute = _mm512_load_si512(indices);
+  const auto shift = _mm512_load_si512(shifts);
+  const auto rightShift = _mm_cvtsi32_si128(64 - width);
+  const auto loadMask = firstBytes(width);
+  for (uint64_t i = 0; i < numValues; i += 8) {
+    auto fields = _mm512_permutexvar_epi8(
+        permute, _mm512_maskz_loadu_epi8(loadMask, input));
+    fields = _mm512_srl_epi64(_mm512_sllv_epi64(fields, shift), rightShift);
+    _mm512_storeu_si512(result + i, fields);
+    input += width;
+  }
+  return numValues;
+}
+
+#undef VELOX_AVX512_VBMI
+
+#endif
+} // namespace
+
+template <>
+uint64_t unpackAvx512<uint32_t>(
+    const uint8_t*& inputBits,
+    uint64_t numValues,
+    uint8_t bitWidth,
+    uint32_t*& result) {
+#ifdef __x86_64__
+  if (process::hasAvx512Vbmi()) {
+    return bitWidth <= 25
+        ? unpack32Lanes(inputBits, numValues, bitWidth, result)
+        : unpack64Lanes(inputBits, numValues, bitWidth, result);
+  }
+#endif
+  return 0;
+}
+
+uint64_t unpackBigEndian(
+    const uint8_t* input,
+    uint64_t numValues,
+    uint8_t bitWidth,
+    uint64_t* result) {
+  VELOX_CHECK(bitWidth >= 1 && bitWidth <= 64);
+  VELOX_CHECK_EQ(numValues % 8, 0);
+  const uint64_t numBytes = numValues / 8 * bitWidth;
+#ifdef __x86_64__
+  if (bitWidth <= 56 && process::hasAvx512Vbmi()) {
+    unpackBigEndian64Lanes(input, numValues, bitWidth, result);
+    return numBytes;
+  }
+#endif
+  // A group of 8 fields is 'bitWidth' bytes. The groups that have less than
+  // 9 bytes after them are unpacked from a padded copy.
+  uint64_t i = 0;
+  for (; i < numValues && (i + 8) * bitWidth / 8 + 9 <= numBytes; i += 8) {
+    unpackBigEndian8(input + i * bitWidth / 8, bitWidth, result + i);
+  }
+  for (; i < numValues; i += 8) {
+    uint8_t padded[64 + 9] = {};
+    memcpy(padded, input + i * bitWidth / 8, bitWidth);
+    unpackBigEndian8(padded, bitWidth, result + i);
+  }
+  return numBytes;
+}
+
 } // namespace facebook::velox::dwio::common
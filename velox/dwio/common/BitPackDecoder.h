@@ -97,6 +97,35 @@ void unpack(
     const char* FOLLY_NULLABLE bufferEnd,
     T* FOLLY_NONNULL result);
 
+/// Unpacks a prefix of the 'numValues' bit fields of 'bitWidth' bits at
+/// 'inputBits' into 'result' with AVX-512 VBMI. The prefix is a multiple of 16
+/// values. Advances 'inputBits' and 'result' past the unpacked values and
+/// returns their number, which is 0 if the machine has no AVX-512 VBMI.
+template <typename T>
+uint64_t unpackAvx512(
+    const uint8_t* FOLLY_NONNULL& inputBits,
+    uint64_t numValues,
+    uint8_t bitWidth,
+    T* FOLLY_NONNULL& result);
+
+template <>
+uint64_t unpackAvx512<uint32_t>(
+    const uint8_t* FOLLY_NONNULL& inputBits,
+    uint64_t numValues,
+    uint8_t bitWidth,
+    uint32_t* FOLLY_NONNULL& result);
+
+/// Unpacks 'numValues' big endian bit fields of 'bitWidth' bits from 'input'
+/// into 'result'. This is the bit packing of ORC RLEv2, where the first field
+/// starts at the most significant bit of the first byte. 'numValues' must be a
+/// multiple of 8, so that whole bytes are consumed. Returns the number of
+/// bytes consumed. Uses AVX-512 VBMI when available.
+uint64_t unpackBigEndian(
+    const uint8_t* FOLLY_NONNULL input,
+    uint64_t numValues,
+    uint8_t bitWidth,
+    uint64_t* FOLLY_NONNULL result);
+
 /// Unpack numValues number of input values from inputBuffer. The results
 /// will be written to result. numValues must be a multiple of 8. The
 /// caller needs to make sure the inputBufferLen contains at least numValues
@@ -703,6 +732,15 @@ inline void unpack<uint32_t>(
   VELOX_CHECK((numValues & 0x7) == 0);
   VELOX_CHECK(inputBufferLen * 8 >= bitWidth * numValues);
 
+  if (numValues >= 16) {
+    auto numUnpacked = unpackAvx512(inputBits, numValues, bitWidth, result);
+    if (numUnpacked == numValues) {
+      return;
+    }
+    numValues -= numUnpacked;
+    inputBufferLen -= numUnpacked * bitWidth / 8;
+  }
+
 #if XSIMD_WITH_AVX2
 
   switch (bitWidth) {
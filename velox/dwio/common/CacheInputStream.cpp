@@ -36,7 +36,8 @@ CacheInputStream::CacheInputStream(
     std::shared_ptr<ScanTracker> tracker,
     TrackingId trackingId,
     uint64_t groupId,
-    int32_t loadQuantum)
+    int32_t loadQuantum,
+    int32_t nodeId)
     : bufferedInput_(bufferedInput),
       cache_(bufferedInput_->cache()),
       ioStats_(ioStats),
@@ -46,6 +47,7 @@ CacheInputStream::CacheInputStream(
       tracker_(std::move(tracker)),
       trackingId_(trackingId),
       groupId_(groupId),
+      nodeId_(nodeId),
       loadQuantum_(loadQuantum) {}
 
 bool CacheInputStream::Next(const void** buffer, int32_t* size) {
@@ -133,6 +135,27 @@ size_t CacheInputStream::positionSize() {
   return 1;
 }
 
+namespace {
+// Keeps a cache entry pinned for the lifetime of a BufferView.
+struct CachePinReleaser {
+  void addRef() const {}
+  void release() const {}
+
+  const cache::CachePin pin;
+};
+} // namespace
+
+BufferPtr CacheInputStream::pinnedBuffer() {
+  if (!run_ || pin_.empty()) {
+    return nullptr;
+  }
+  if (!pinnedBuffer_ || pinnedBuffer_->as<uint8_t>() != run_) {
+    pinnedBuffer_ = BufferView<CachePinReleaser>::create(
+        run_, runSize_, CachePinReleaser{pin_});
+  }
+  return pinnedBuffer_;
+}
+
 void CacheInputStream::setRemainingBytes(uint64_t remainingBytes) {
   VELOX_CHECK_GE(region_.length, position_ + remainingBytes);
   window_ = Region{static_cast<uint64_t>(position_), remainingBytes};
@@ -176,6 +199,7 @@ void CacheInputStream::loadSync(Region region) {
     if (noRetention_ && !pin_.empty()) {
       pin_.checkedEntry()->makeEvictable();
     }
+    pinnedBuffer_ = nullptr;
     pin_.clear();
     pin_ = cache_->findOrCreate(key, region.length, &wait);
     if (pin_.empty()) {
@@ -195,6 +219,9 @@ void CacheInputStream::loadSync(Region region) {
       // missed, fall back to remote fetching.
       entry->setGroupId(groupId_);
       entry->setTrackingId(trackingId_);
+      if (tracker_) {
+        entry->setReadPct(tracker_->readPct(trackingId_));
+      }
       if (loadFromSsd(region, *entry)) {
         return;
       }
@@ -205,12 +232,18 @@ void CacheInputStream::loadSync(Region region) {
         input_->read(ranges, region.offset, LogType::FILE);
       }
       ioStats_->read().increment(region.length);
+      ioStats_->incColumnIo(
+          nodeId_, ColumnIoKind::kStorageRead, region.length);
       ioStats_->queryThreadIoLatency().increment(usec);
+      ioStats_->recordStorageRead(region.length, usec);
       entry->setExclusiveToShared();
     } else {
       // Hit memory cache.
       if (!entry->getAndClearFirstUseFlag()) {
         ioStats_->ramHit().increment(entry->size());
+        ioStats_->incColumnIo(nodeId_, ColumnIoKind::kRamHit, entry->size());
+      } else {
+        ioStats_->prefetchUsed().increment(entry->size());
       }
       return;
     }
@@ -268,6 +301,7 @@ bool CacheInputStream::loadFromSsd(
   }
   pin_ = std::move(pins[0]);
   ioStats_->ssdRead().increment(entry.size());
+  ioStats_->incColumnIo(nodeId_, ColumnIoKind::kSsdRead, entry.size());
   ioStats_->queryThreadIoLatency().increment(usec);
   entry.setExclusiveToShared();
   return true;
@@ -326,6 +360,7 @@ void CacheInputStream::loadPosition() {
       }
     }
   } else {
+    pinnedBuffer_ = nullptr;
     pin_.clear();
     loadPosition();
   }
@@ -38,7 +38,8 @@ class CacheInputStream : public SeekableInputStream {
       std::shared_ptr<cache::ScanTracker> tracker,
       cache::TrackingId trackingId,
       uint64_t groupId,
-      int32_t loadQuantum);
+      int32_t loadQuantum,
+      int32_t nodeId = -1);
 
   bool Next(const void** data, int* size) override;
   void BackUp(int count) override;
@@ -48,6 +49,10 @@ class CacheInputStream : public SeekableInputStream {
   std::string getName() const override;
   size_t positionSize() override;
 
+  /// Returns a view over the run of the cache entry returned by the last
+  /// Next(). The view holds a pin on the entry.
+  BufferPtr pinnedBuffer() override;
+
   /// Returns a copy of 'this', ranging over the same bytes. The clone
   /// is initially positioned at the position of 'this' and can be
   /// moved independently within 'region_'.  This is used for first
@@ -68,7 +73,8 @@ class CacheInputStream : public SeekableInputStream {
         tracker_,
         trackingId_,
         groupId_,
-        loadQuantum_);
+        loadQuantum_,
+        nodeId_);
     copy->position_ = position_;
     return copy;
   }
@@ -117,6 +123,9 @@ class CacheInputStream : public SeekableInputStream {
   std::shared_ptr<cache::ScanTracker> tracker_;
   const cache::TrackingId trackingId_;
   const uint64_t groupId_;
+  // The node of the file schema the IO of 'this' is attributed to, -1 if
+  // none.
+  const int32_t nodeId_;
 
   // Maximum number of bytes read from 'input' at a time. This gives the maximum
   // pin_.entry()->size().
@@ -125,6 +134,10 @@ class CacheInputStream : public SeekableInputStream {
   // Handle of cache entry.
   cache::CachePin pin_;
 
+  // View over 'run_' given out by pinnedBuffer(). Holds a pin on the entry of
+  // 'pin_'. Cleared when 'pin_' changes.
+  BufferPtr pinnedBuffer_;
+
   // Offset of current run from start of 'entry_->data()'
   uint64_t offsetOfRun_;
 
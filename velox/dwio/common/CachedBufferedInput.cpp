@@ -16,6 +16,7 @@
 
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DEFINE_int32(
@@ -23,6 +24,11 @@ DEFINE_int32(
     80,
     "Minimum percentage of actual uses over references to a column for prefetching. No prefetch if > 100");
 
+DEFINE_bool(
+    cache_adaptive_io,
+    true,
+    "Adapt the coalescing distance and the prefetch threshold to the latency and bandwidth observed on storage reads");
+
 namespace facebook::velox::dwio::common {
 
 using cache::CachePin;
@@ -43,12 +49,15 @@ std::unique_ptr<SeekableInputStream> CachedBufferedInput::enqueue(
   }
 
   TrackingId id;
+  int32_t nodeId = -1;
   if (si) {
     id = TrackingId(si->getId());
+    nodeId = si->nodeId();
   }
   VELOX_CHECK_LE(region.offset + region.length, fileSize_);
   requests_.emplace_back(
       RawFileCacheKey{fileNum_, region.offset}, region.length, id);
+  requests_.back().nodeId = nodeId;
   if (tracker_) {
     tracker_->recordReference(id, region.length, fileNum_, groupId_);
   }
@@ -61,7 +70,8 @@ std::unique_ptr<SeekableInputStream> CachedBufferedInput::enqueue(
       tracker_,
       id,
       groupId_,
-      loadQuantum_);
+      loadQuantum_,
+      nodeId);
   requests_.back().stream = stream.get();
   return stream;
 }
@@ -100,14 +110,26 @@ bool CachedBufferedInput::shouldPreload(int32_t numPages) {
 
 namespace {
 
-bool isPrefetchPct(int32_t pct) {
-  return pct >= FLAGS_cache_prefetch_min_pct;
+// Bounds for the coalescing distance derived from storage latency.
+constexpr int32_t kMinAdaptiveCoalesceDistance = 16 << 10;
+constexpr int32_t kMaxAdaptiveCoalesceDistance = 16 << 20;
+
+// Prefetch thresholds are lowered for storage with latency above this.
+constexpr double kPrefetchReferenceLatencyUs = 1'000;
+
+std::optional<StorageReadModel> storageReadModel(
+    const IoStatistics* ioStats) {
+  if (!FLAGS_cache_adaptive_io || !ioStats) {
+    return std::nullopt;
+  }
+  return ioStats->storageReadModel();
 }
 
 std::vector<CacheRequest*> makeRequestParts(
     CacheRequest& request,
     const cache::TrackingData& trackingData,
     int32_t loadQuantum,
+    int32_t prefetchMinPct,
     std::vector<std::unique_ptr<CacheRequest>>& extraRequests) {
   if (request.size <= loadQuantum) {
     return {&request};
@@ -123,7 +145,7 @@ std::vector<CacheRequest*> makeRequestParts(
   auto readDensity =
       (100 * trackingData.readBytes) / (1 + trackingData.referencedBytes);
   bool prefetch = trackingData.referencedBytes > 0 &&
-      (isPrefetchPct(readPct) && readDensity >= 80);
+      (readPct >= prefetchMinPct && readDensity >= 80);
   std::vector<CacheRequest*> parts;
   for (uint64_t offset = 0; offset < request.size; offset += loadQuantum) {
     int32_t size = std::min<int32_t>(loadQuantum, request.size - offset);
@@ -133,6 +155,8 @@ std::vector<CacheRequest*> makeRequestParts(
         request.trackingId));
     parts.push_back(extraRequests.back().get());
     parts.back()->coalesces = prefetch;
+    parts.back()->readPct = request.readPct;
+    parts.back()->nodeId = request.nodeId;
     if (prefetchOne) {
       break;
     }
@@ -150,9 +174,37 @@ int32_t adjustedReadPct(const cache::TrackingData& trackingData) {
 }
 } // namespace
 
+int32_t CachedBufferedInput::coalesceDistance() const {
+  auto model = storageReadModel(ioStats_.get());
+  if (!model.has_value()) {
+    return maxCoalesceDistance_;
+  }
+  // Reading a gap is cheaper than a separate read while its transfer time is
+  // under the latency of a read.
+  return std::clamp<double>(
+      model->latencyUs * model->bytesPerUs,
+      kMinAdaptiveCoalesceDistance,
+      kMaxAdaptiveCoalesceDistance);
+}
+
+int32_t CachedBufferedInput::prefetchMinPct() const {
+  auto model = storageReadModel(ioStats_.get());
+  if (!model.has_value() || model->latencyUs <= kPrefetchReferenceLatencyUs) {
+    return FLAGS_cache_prefetch_min_pct;
+  }
+  // A miss costs more with more latency, so less frequently read columns
+  // are worth prefetching. The threshold goes down to a quarter of the
+  // flag.
+  const double scale =
+      std::max(0.25, kPrefetchReferenceLatencyUs / model->latencyUs);
+  return FLAGS_cache_prefetch_min_pct * scale;
+}
+
 void CachedBufferedInput::load(const LogType) {
   // 'requests_ is cleared on exit.
   auto requests = std::move(requests_);
+  const auto minPct = prefetchMinPct();
+  const auto distance = coalesceDistance();
   cache::SsdFile* FOLLY_NULLABLE ssdFile = nullptr;
   auto ssdCache = cache_->ssdCache();
   if (ssdCache) {
@@ -176,11 +228,15 @@ void CachedBufferedInput::load(const LogType) {
           request.trackingId.id() == StreamIdentifier::sequentialFile().id_;
       if (!prefetchAnyway && tracker_) {
         trackingData = tracker_->trackingData(request.trackingId);
+        if (trackingData.numReferences) {
+          request.readPct =
+              (100 * trackingData.numReads) / trackingData.numReferences;
+        }
       }
       if (prefetchAnyway || adjustedReadPct(trackingData) >= readPct) {
         request.processed = true;
         auto parts = makeRequestParts(
-            request, trackingData, loadQuantum_, extraRequests);
+            request, trackingData, loadQuantum_, minPct, extraRequests);
         for (auto part : parts) {
           if (cache_->exists(part->key)) {
             continue;
@@ -202,19 +258,20 @@ void CachedBufferedInput::load(const LogType) {
         }
       }
     }
-    makeLoads(std::move(storageLoad), isPrefetchPct(readPct));
-    makeLoads(std::move(ssdLoad), isPrefetchPct(readPct));
+    makeLoads(std::move(storageLoad), readPct >= minPct, distance);
+    makeLoads(std::move(ssdLoad), readPct >= minPct, distance);
   }
 }
 
 void CachedBufferedInput::makeLoads(
     std::vector<CacheRequest*> requests,
-    bool prefetch) {
+    bool prefetch,
+    int32_t coalesceDistance) {
   if (requests.empty() || (requests.size() < 2 && !prefetch)) {
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance_;
+  int32_t maxDistance = isSsd ? 20000 : coalesceDistance;
   std::sort(
       requests.begin(),
       requests.end(),
@@ -252,7 +309,7 @@ void CachedBufferedInput::makeLoads(
           uint64_t /*offset*/,
           const std::vector<CacheRequest*>& ranges) {
         ++numNewLoads;
-        readRegion(ranges, prefetch);
+        readRegion(ranges, prefetch, maxDistance);
       });
   if (prefetch && executor_) {
     std::vector<int32_t> doneIndices;
@@ -328,6 +385,28 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
     }
   }
 
+  // Attributes the loaded entries, given by their indices in 'requests_', to
+  // the columns of their requests.
+  void updateColumnStats(
+      const std::vector<int32_t>& loaded,
+      bool isPrefetch,
+      bool isSsd) {
+    if (!ioStats_) {
+      return;
+    }
+    for (auto index : loaded) {
+      const auto& request = requests_[index];
+      ioStats_->incColumnIo(
+          request.nodeId,
+          isSsd ? ColumnIoKind::kSsdRead : ColumnIoKind::kStorageRead,
+          request.size);
+      if (isPrefetch) {
+        ioStats_->incColumnIo(
+            request.nodeId, ColumnIoKind::kPrefetch, request.size);
+      }
+    }
+  }
+
   static std::vector<RawFileCacheKey> makeKeys(
       std::vector<CacheRequest*>& requests) {
     std::vector<RawFileCacheKey> keys;
@@ -369,14 +448,20 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<CachePin> pins;
+    std::vector<int32_t> loaded;
     pins.reserve(keys_.size());
     cache_.makePins(
         keys_,
         [&](int32_t index) { return sizes_[index]; },
-        [&](int32_t /*index*/, CachePin pin) {
+        [&](int32_t index, CachePin pin) {
+          loaded.push_back(index);
           if (isPrefetch) {
             pin.checkedEntry()->setPrefetch(true);
           }
+          // The group and stream decide whether the entry is saved to SSD.
+          pin.checkedEntry()->setGroupId(groupId_);
+          pin.checkedEntry()->setTrackingId(requests_[index].trackingId);
+          pin.checkedEntry()->setReadPct(requests_[index].readPct);
           pins.push_back(std::move(pin));
         });
     if (pins.empty()) {
@@ -392,9 +477,21 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
-          input_->read(buffers, offset, LogType::FILE);
+          uint64_t usec = 0;
+          {
+            MicrosecondTimer timer(&usec);
+            input_->read(buffers, offset, LogType::FILE);
+          }
+          if (ioStats_) {
+            uint64_t bytes = 0;
+            for (auto& buffer : buffers) {
+              bytes += buffer.size();
+            }
+            ioStats_->recordStorageRead(bytes, usec);
+          }
         });
     updateStats(stats, isPrefetch, false);
+    updateColumnStats(loaded, isPrefetch, false);
     return pins;
   }
 
@@ -415,13 +512,16 @@ class SsdLoad : public DwioCoalescedLoadBase {
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<SsdPin> ssdPins;
     std::vector<CachePin> pins;
+    std::vector<int32_t> loaded;
     cache_.makePins(
         keys_,
         [&](int32_t index) { return sizes_[index]; },
         [&](int32_t index, CachePin pin) {
+          loaded.push_back(index);
           if (isPrefetch) {
             pin.checkedEntry()->setPrefetch(true);
           }
+          pin.checkedEntry()->setReadPct(requests_[index].readPct);
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
         });
@@ -431,6 +531,7 @@ class SsdLoad : public DwioCoalescedLoadBase {
     assert(!ssdPins.empty()); // for lint.
     auto stats = ssdPins[0].file()->load(ssdPins, pins);
     updateStats(stats, isPrefetch, true);
+    updateColumnStats(loaded, isPrefetch, true);
     return pins;
   }
 };
@@ -439,7 +540,8 @@ class SsdLoad : public DwioCoalescedLoadBase {
 
 void CachedBufferedInput::readRegion(
     std::vector<CacheRequest*> requests,
-    bool prefetch) {
+    bool prefetch,
+    int32_t coalesceDistance) {
   if (requests.empty() || (requests.size() == 1 && !prefetch)) {
     return;
   }
@@ -448,7 +550,7 @@ void CachedBufferedInput::readRegion(
     load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
-        *cache_, input_, ioStats_, groupId_, requests, maxCoalesceDistance_);
+        *cache_, input_, ioStats_, groupId_, requests, coalesceDistance);
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
@@ -51,6 +51,13 @@ struct CacheRequest {
   // for sparsely accessed large columns where hitting one piece
   // should not load the adjacent pieces.
   bool coalesces{true};
+
+  // Percentage of the references to the stream that are read, see
+  // ScanTracker::readPct(). Informs the eviction of the loaded entry.
+  int32_t readPct{100};
+
+  // The node of the file schema the IO is attributed to, -1 if none.
+  int32_t nodeId{-1};
   const SeekableInputStream* FOLLY_NONNULL stream;
 };
 
@@ -161,16 +168,32 @@ class CachedBufferedInput : public BufferedInput {
       const SeekableInputStream* FOLLY_NONNULL stream);
 
  private:
-  // Sorts requests and makes CoalescedLoads for nearby requests. If 'prefetch'
-  // is true, starts background loading.
-  void makeLoads(std::vector<CacheRequest*> requests, bool prefetch);
+  // Returns the largest gap between storage reads that is read rather than
+  // skipped. Derived from the latency and bandwidth of the storage reads in
+  // 'ioStats_' when there are enough of them, 'maxCoalesceDistance_'
+  // otherwise.
+  int32_t coalesceDistance() const;
+
+  // Returns the minimum percentage of references that read a stream for
+  // prefetching it. Lower than the default for high latency storage.
+  int32_t prefetchMinPct() const;
+
+  // Sorts requests and makes CoalescedLoads for requests at most
+  // 'coalesceDistance' apart. If 'prefetch' is true, starts background
+  // loading.
+  void makeLoads(
+      std::vector<CacheRequest*> requests,
+      bool prefetch,
+      int32_t coalesceDistance);
 
   // Makes a CoalescedLoad for 'requests' to be read together, coalescing
   // IO is appropriate. If 'prefetch' is set, schedules the CoalescedLoad
   // on 'executor_'. Links the CoalescedLoad  to all CacheInputStreams that it
   // concerns.
-
-  void readRegion(std::vector<CacheRequest*> requests, bool prefetch);
+  void readRegion(
+      std::vector<CacheRequest*> requests,
+      bool prefetch,
+      int32_t coalesceDistance);
 
   cache::AsyncDataCache* FOLLY_NONNULL cache_;
   const uint64_t fileNum_;
@@ -77,6 +77,14 @@ void LocalFileSink::write(std::vector<DataBuffer<char>>& buffers) {
   });
 }
 
+void WriteFileDataSink::write(std::vector<DataBuffer<char>>& buffers) {
+  writeImpl(buffers, [&](auto& buffer) {
+    const auto size = buffer.size();
+    writeFile_->append(std::string_view(buffer.data(), size));
+    return size;
+  });
+}
+
 static std::vector<DataSink::Factory>& factories() {
   static std::vector<DataSink::Factory> factories;
   return factories;
@@ -18,6 +18,7 @@
 
 #include <chrono>
 
+#include "velox/common/file/File.h"
 #include "velox/dwio/common/Closeable.h"
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/IoStatistics.h"
@@ -163,6 +164,35 @@ class LocalFileSink : public DataSink {
 using FileSink = LocalFileSink;
 #endif
 
+/// Writes to a WriteFile of a file system, e.g. S3. The file may upload the
+/// data in the background. close() returns after all data has been written.
+class WriteFileDataSink : public DataSink {
+ public:
+  WriteFileDataSink(
+      std::unique_ptr<WriteFile> writeFile,
+      const std::string& name,
+      const MetricsLogPtr& metricLogger = MetricsLog::voidLog(),
+      IoStatistics* stats = nullptr)
+      : DataSink{name, metricLogger, stats},
+        writeFile_{std::move(writeFile)} {}
+
+  ~WriteFileDataSink() override {
+    destroy();
+  }
+
+  using DataSink::write;
+
+  void write(std::vector<DataBuffer<char>>& buffers) override;
+
+ protected:
+  void doClose() override {
+    writeFile_->close();
+  }
+
+ private:
+  std::unique_ptr<WriteFile> writeFile_;
+};
+
 class MemorySink : public DataSink {
  public:
   MemorySink(
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    file_metadata_cache_mb,
+    64,
+    "Size of the process wide cache of parsed file footers. 0 disables it.");
+
+namespace facebook::velox::dwio::common {
+
+// static
+FileMetadataCache& FileMetadataCache::instance() {
+  static FileMetadataCache cache(
+      static_cast<int64_t>(FLAGS_file_metadata_cache_mb) << 20);
+  return cache;
+}
+
+std::shared_ptr<const void> FileMetadataCache::findInternal(
+    const FileMetadataKey& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* entry = cache_.get(key);
+  if (!entry) {
+    return nullptr;
+  }
+  // The shared_ptr keeps the metadata alive after eviction, so the entry
+  // does not stay pinned.
+  auto metadata = entry->metadata;
+  cache_.release(key);
+  return metadata;
+}
+
+void FileMetadataCache::insert(
+    const FileMetadataKey& key,
+    std::shared_ptr<const void> metadata,
+    int64_t bytes) {
+  auto entry = std::make_unique<Entry>(Entry{std::move(metadata)});
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cache_.add(key, entry.get(), bytes)) {
+    entry.release();
+  }
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include <folly/hash/Hash.h>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/dwio/common/Options.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Identifies the parsed metadata of a file. 'fileId' is the id of the file
+/// path, e.g. FileHandle::uuid. The size distinguishes a file that is
+/// rewritten at the same path while its id is held. The format selects the
+/// type of the metadata.
+struct FileMetadataKey {
+  uint64_t fileId;
+  uint64_t fileSize;
+  FileFormat format;
+
+  bool operator==(const FileMetadataKey& other) const {
+    return fileId == other.fileId && fileSize == other.fileSize &&
+        format == other.format;
+  }
+};
+
+struct FileMetadataKeyHasher {
+  size_t operator()(const FileMetadataKey& key) const {
+    return folly::hash::hash_combine(
+        key.fileId, key.fileSize, static_cast<int32_t>(key.format));
+  }
+};
+
+/// Process wide LRU cache of parsed file footers, so that the readers of the
+/// splits of one file parse its footer once. The metadata is immutable and
+/// shared by the readers. It must not reference memory of a query, e.g. a
+/// MemoryPool. Thread safe.
+class FileMetadataCache {
+ public:
+  explicit FileMetadataCache(int64_t maxBytes) : cache_(maxBytes) {}
+
+  /// Returns the cache with a capacity of --file_metadata_cache_mb.
+  static FileMetadataCache& instance();
+
+  /// Returns the metadata for 'key' or nullptr if not cached. 'T' is the type
+  /// inserted for the format of 'key'.
+  template <typename T>
+  std::shared_ptr<const T> find(const FileMetadataKey& key) {
+    return std::static_pointer_cast<const T>(findInternal(key));
+  }
+
+  /// Adds 'metadata' for 'key'. 'bytes' is the memory used by 'metadata'.
+  /// Does nothing if 'key' is cached or 'metadata' does not fit.
+  void insert(
+      const FileMetadataKey& key,
+      std::shared_ptr<const void> metadata,
+      int64_t bytes);
+
+  /// Bytes of metadata in the cache.
+  int64_t currentBytes() {
+    std::lock_guard<std::mutex> l(mutex_);
+    return cache_.currentSize();
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<const void> metadata;
+  };
+
+  std::shared_ptr<const void> findInternal(const FileMetadataKey& key);
+
+  std::mutex mutex_;
+  SimpleLRUCache<
+      FileMetadataKey,
+      Entry,
+      std::equal_to<FileMetadataKey>,
+      FileMetadataKeyHasher>
+      cache_;
+};
+
+} // namespace facebook::velox::dwio::common
@@ -15,6 +15,7 @@
  */
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <atomic>
 #include <utility>
 
@@ -86,6 +87,77 @@ IoStatistics::operationStats() const {
   return operationStats_;
 }
 
+namespace {
+// Reads needed before the fitted model is used.
+constexpr int32_t kMinStorageReads = 8;
+// The sums are halved at this many reads.
+constexpr int32_t kMaxStorageReads = 1'000;
+} // namespace
+
+void IoStatistics::incColumnIo(
+    int32_t nodeId,
+    ColumnIoKind kind,
+    uint64_t bytes) {
+  if (nodeId < 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(columnIoMutex_);
+  columnIo_[nodeId][static_cast<int32_t>(kind)] += bytes;
+}
+
+std::unordered_map<int32_t, ColumnIo> IoStatistics::takeColumnIo() {
+  std::unordered_map<int32_t, ColumnIo> result;
+  std::lock_guard<std::mutex> l(columnIoMutex_);
+  result.swap(columnIo_);
+  return result;
+}
+
+void IoStatistics::recordStorageRead(uint64_t bytes, uint64_t micros) {
+  const double x = bytes;
+  const double y = micros;
+  std::lock_guard<std::mutex> l(storageReadsMutex_);
+  auto& sums = storageReads_;
+  if (sums.count >= kMaxStorageReads) {
+    sums.count /= 2;
+    sums.bytes /= 2;
+    sums.micros /= 2;
+    sums.bytesSquared /= 2;
+    sums.bytesMicros /= 2;
+  }
+  sums.count += 1;
+  sums.bytes += x;
+  sums.micros += y;
+  sums.bytesSquared += x * x;
+  sums.bytesMicros += x * y;
+}
+
+std::optional<StorageReadModel> IoStatistics::storageReadModel() const {
+  StorageReadSums sums;
+  {
+    std::lock_guard<std::mutex> l(storageReadsMutex_);
+    sums = storageReads_;
+  }
+  if (sums.count < kMinStorageReads) {
+    return std::nullopt;
+  }
+  const double meanBytes = sums.bytes / sums.count;
+  const double meanMicros = sums.micros / sums.count;
+  const double variance =
+      sums.bytesSquared / sums.count - meanBytes * meanBytes;
+  // Sizes within 10% of each other do not separate latency from bandwidth.
+  if (variance <= 0.01 * meanBytes * meanBytes) {
+    return std::nullopt;
+  }
+  const double covariance =
+      sums.bytesMicros / sums.count - meanBytes * meanMicros;
+  const double microsPerByte = covariance / variance;
+  if (microsPerByte <= 0) {
+    return std::nullopt;
+  }
+  const double latency = meanMicros - microsPerByte * meanBytes;
+  return StorageReadModel{std::max(latency, 0.0), 1 / microsPerByte};
+}
+
 void IoStatistics::merge(const IoStatistics& other) {
   rawBytesRead_ += other.rawBytesRead_;
   rawBytesWritten_ += other.rawBytesWritten_;
@@ -95,11 +167,39 @@ void IoStatistics::merge(const IoStatistics& other) {
   read_.merge(other.read_);
   ramHit_.merge(other.ramHit_);
   ssdRead_.merge(other.ssdRead_);
+  prefetchUsed_.merge(other.prefetchUsed_);
   queryThreadIoLatency_.merge(other.queryThreadIoLatency_);
-  std::lock_guard<std::mutex> l(operationStatsMutex_);
-  for (auto& item : other.operationStats_) {
-    operationStats_[item.first].merge(item.second);
+  {
+    std::unordered_map<int32_t, ColumnIo> otherColumnIo;
+    {
+      std::lock_guard<std::mutex> l(other.columnIoMutex_);
+      otherColumnIo = other.columnIo_;
+    }
+    std::lock_guard<std::mutex> l(columnIoMutex_);
+    for (const auto& [nodeId, io] : otherColumnIo) {
+      auto& total = columnIo_[nodeId];
+      for (auto i = 0; i < io.size(); ++i) {
+        total[i] += io[i];
+      }
+    }
+  }
+  {
+    std::lock_guard<std::mutex> l(operationStatsMutex_);
+    for (auto& item : other.operationStats_) {
+      operationStats_[item.first].merge(item.second);
+    }
+  }
+  StorageReadSums otherReads;
+  {
+    std::lock_guard<std::mutex> l(other.storageReadsMutex_);
+    otherReads = other.storageReads_;
   }
+  std::lock_guard<std::mutex> l(storageReadsMutex_);
+  storageReads_.count += otherReads.count;
+  storageReads_.bytes += otherReads.bytes;
+  storageReads_.micros += otherReads.micros;
+  storageReads_.bytesSquared += otherReads.bytesSquared;
+  storageReads_.bytesMicros += otherReads.bytesMicros;
 }
 
 void OperationCounters::merge(const OperationCounters& other) {
@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -63,6 +65,31 @@ class IoCounter {
   std::atomic<uint64_t> bytes_{0};
 };
 
+/// Sources of the bytes read for a column.
+enum class ColumnIoKind {
+  // Hits in RAM cache, as in IoStatistics::ramHit().
+  kRamHit,
+  // Read from SSD cache.
+  kSsdRead,
+  // Read from storage.
+  kStorageRead,
+  // Read by prefetch, from SSD or storage. Also counted in kSsdRead or
+  // kStorageRead.
+  kPrefetch,
+  kNumKinds
+};
+
+/// Bytes of each ColumnIoKind for one column.
+using ColumnIo =
+    std::array<uint64_t, static_cast<int32_t>(ColumnIoKind::kNumKinds)>;
+
+/// Time of a storage read as a fixed latency plus the transfer time at a
+/// bandwidth.
+struct StorageReadModel {
+  double latencyUs;
+  double bytesPerUs;
+};
+
 class IoStatistics {
  public:
   uint64_t rawBytesRead() const;
@@ -93,6 +120,19 @@ class IoStatistics {
     return ramHit_;
   }
 
+  IoCounter& prefetchUsed() {
+    return prefetchUsed_;
+  }
+
+  /// Adds 'bytes' of 'kind' to the IO of node 'nodeId' of the file schema.
+  /// Does nothing if 'nodeId' is negative, i.e. the stream is not of a known
+  /// node.
+  void incColumnIo(int32_t nodeId, ColumnIoKind kind, uint64_t bytes);
+
+  /// Returns the IO per node of the file schema added since the previous
+  /// call and clears it.
+  std::unordered_map<int32_t, ColumnIo> takeColumnIo();
+
   IoCounter& queryThreadIoLatency() {
     return queryThreadIoLatency_;
   }
@@ -108,6 +148,14 @@ class IoStatistics {
 
   std::unordered_map<std::string, OperationCounters> operationStats() const;
 
+  /// Records a read of 'bytes' from storage that took 'micros'.
+  void recordStorageRead(uint64_t bytes, uint64_t micros);
+
+  /// Returns the latency and bandwidth fitted over the recent storage reads.
+  /// std::nullopt if there are too few reads or their sizes are too uniform
+  /// to tell latency from transfer time.
+  std::optional<StorageReadModel> storageReadModel() const;
+
   void merge(const IoStatistics& other);
 
   folly::dynamic getOperationStatsSnapshot() const;
@@ -132,12 +180,32 @@ class IoStatistics {
   // reads.
   IoCounter ssdRead_;
 
+  // First uses of prefetched data. Prefetched bytes that are not in this
+  // were not read by the query, or were first read by another query.
+  IoCounter prefetchUsed_;
+
+  // IO of the streams of each node of the file schema.
+  std::unordered_map<int32_t, ColumnIo> columnIo_;
+  mutable std::mutex columnIoMutex_;
+
   // Time spent by a query processing thread waiting for synchronously
   // issued IO or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
 
   std::unordered_map<std::string, OperationCounters> operationStats_;
   mutable std::mutex operationStatsMutex_;
+
+  // Sums for a least squares fit of read time over read size. Halved when
+  // 'count' reaches a limit, so that older reads weigh less.
+  struct StorageReadSums {
+    double count{0};
+    double bytes{0};
+    double micros{0};
+    double bytesSquared{0};
+    double bytesMicros{0};
+  };
+  StorageReadSums storageReads_;
+  mutable std::mutex storageReadsMutex_;
 };
 
 } // namespace facebook::velox::dwio::common
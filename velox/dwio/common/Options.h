@@ -17,6 +17,7 @@
 #pragma once
 
 #include <limits>
+#include <optional>
 #include <unordered_set>
 
 #include <folly/Executor.h>
@@ -89,6 +90,7 @@ class RowReaderOptions {
   bool preloadStripe;
   bool projectSelectedType;
   bool returnFlatVector_ = false;
+  bool returnDictionaryVectors_ = false;
   ErrorTolerance errorTolerance_;
   std::shared_ptr<ColumnSelector> selector_;
   std::shared_ptr<velox::common::ScanSpec> scanSpec_ = nullptr;
@@ -111,7 +113,10 @@ class RowReaderOptions {
     selector_ = other.selector_;
     scanSpec_ = other.scanSpec_;
     returnFlatVector_ = other.returnFlatVector_;
+    returnDictionaryVectors_ = other.returnDictionaryVectors_;
     flatmapNodeIdAsStruct_ = other.flatmapNodeIdAsStruct_;
+    decodingExecutor_ = other.decodingExecutor_;
+    ioExecutor_ = other.ioExecutor_;
   }
 
   RowReaderOptions() noexcept
@@ -202,6 +207,17 @@ class RowReaderOptions {
     returnFlatVector_ = value;
   }
 
+  // For dictionary encoded integer columns without a filter, request that
+  // values are returned as a DictionaryVector over the dictionary of the
+  // column chunk instead of a flat vector. Only used by Parquet.
+  bool getReturnDictionaryVectors() const {
+    return returnDictionaryVectors_;
+  }
+
+  void setReturnDictionaryVectors(bool value) {
+    returnDictionaryVectors_ = value;
+  }
+
   /**
    * Request that the selected type be projected.
    */
@@ -320,6 +336,7 @@ class ReaderOptions {
   int32_t maxCoalesceDistance_{kDefaultCoalesceDistance};
   SerDeOptions serDeOptions;
   std::shared_ptr<encryption::DecrypterFactory> decrypterFactory_;
+  std::optional<uint64_t> fileId_;
 
  public:
   static constexpr int32_t kDefaultLoadQuantum = 8 << 20; // 8MB
@@ -350,6 +367,7 @@ class ReaderOptions {
     prefetchMode = other.prefetchMode;
     serDeOptions = other.serDeOptions;
     decrypterFactory_ = other.decrypterFactory_;
+    fileId_ = other.fileId_;
     return *this;
   }
 
@@ -443,6 +461,16 @@ class ReaderOptions {
     return *this;
   }
 
+  /**
+   * Set the id of the file path, e.g. FileHandle::uuid. If set, the parsed
+   * footer of the file is shared with other readers of the file through the
+   * FileMetadataCache.
+   */
+  ReaderOptions& setFileId(uint64_t fileId) {
+    fileId_ = fileId;
+    return *this;
+  }
+
   /**
    * Get the desired tail location.
    * @return if not set, return the maximum long.
@@ -500,6 +528,10 @@ class ReaderOptions {
       const {
     return decrypterFactory_;
   }
+
+  const std::optional<uint64_t>& fileId() const {
+    return fileId_;
+  }
 };
 
 } // namespace common
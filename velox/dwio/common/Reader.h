@@ -30,6 +30,19 @@
 
 namespace facebook::velox::dwio::common {
 
+struct ColumnReaderScratch;
+
+/**
+ * The number of rows and the statistics of the top level columns of a part of
+ * a file, e.g. a stripe or a row group. 'columns' is indexed by the position
+ * of the column in the file schema and has a nullptr for columns without
+ * statistics.
+ */
+struct UnitStatistics {
+  uint64_t numRows;
+  std::vector<std::unique_ptr<ColumnStatistics>> columns;
+};
+
 /**
  * Abstract row reader interface.
  *
@@ -69,6 +82,47 @@ class RowReader {
    * @return Estimate of the row size or std::nullopt if cannot estimate.
    */
   virtual std::optional<size_t> estimatedRowSize() const = 0;
+
+  /**
+   * Starts the IO for the first stripe of the range, so that the data is in
+   * flight before the first call to next(). No-op if the format has no
+   * such prefetch.
+   */
+  virtual void prefetchFirstStripe() {}
+
+  /**
+   * Returns the scratch memory of the column readers, so that a reader of the
+   * next split can use it. nullptr if the format has no such reuse. 'this'
+   * must not be read after this.
+   */
+  virtual std::shared_ptr<ColumnReaderScratch> releaseScratch() {
+    return nullptr;
+  }
+
+  /**
+   * Gives the column readers of 'this' the buffers in 'scratch' from
+   * releaseScratch() of a previous reader. No-op if 'scratch' is nullptr.
+   */
+  virtual void setScratch(std::shared_ptr<ColumnReaderScratch> /*scratch*/) {}
+
+  /**
+   * Returns the statistics of the parts of the range that next() has yet to
+   * read, in reading order. The parts are stripes or row groups, or coarser
+   * if the format keeps statistics only for the whole file. Returns an empty
+   * vector if there are no statistics or next() has been called.
+   */
+  virtual std::vector<UnitStatistics> unitStatistics() const {
+    return {};
+  }
+
+  /**
+   * Skips the parts at 'indices' of the result of unitStatistics(), so that
+   * next() does not return their rows. 'indices' is ascending. Must be
+   * called before next().
+   */
+  virtual void skipUnits(const std::vector<uint32_t>& /*indices*/) {
+    VELOX_UNSUPPORTED("skipUnits");
+  }
 };
 
 /**
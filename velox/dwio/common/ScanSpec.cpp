@@ -40,6 +40,33 @@ ScanSpec* ScanSpec::getOrCreateChild(const Subfield& subfield) {
   return container;
 }
 
+void ScanSpec::moveAdaptationFrom(ScanSpec& other) {
+  for (auto& child : children_) {
+    auto otherChild = other.childByName(child->fieldName_);
+    if (!otherChild || child->isConstant() || otherChild->isConstant()) {
+      continue;
+    }
+    child->filter_ = std::move(otherChild->filter_);
+    child->selectivity_ = otherChild->selectivity_;
+  }
+  numRowsScanned_ = other.numRowsScanned_;
+  numRowsPassed_ = other.numRowsPassed_;
+  resetCachedValues();
+}
+
+uint64_t ScanSpec::rowsToScan(uint64_t numRows) const {
+  if (maxRowsToScan_ <= numRows || numRowsScanned_ == 0) {
+    return numRows;
+  }
+  // The window is at most 'maxRowsToScan_', also while no row has passed.
+  const double passRate =
+      static_cast<double>(numRowsPassed_) / numRowsScanned_;
+  if (passRate * maxRowsToScan_ <= numRows) {
+    return maxRowsToScan_;
+  }
+  return std::max<uint64_t>(numRows, numRows / passRate);
+}
+
 uint64_t ScanSpec::newRead() {
   if (!numReads_) {
     reorder();
@@ -302,6 +329,49 @@ bool testFilter(
   return true;
 }
 
+bool testFilterAllRows(
+    common::Filter* filter,
+    dwio::common::ColumnStatistics* stats,
+    uint64_t totalRows,
+    const TypePtr& type) {
+  if (!stats->getNumberOfValues().has_value()) {
+    return false;
+  }
+  const auto numValues = stats->getNumberOfValues().value();
+  if (numValues < totalRows && !filter->testNull()) {
+    return false;
+  }
+  switch (filter->kind()) {
+    case common::FilterKind::kAlwaysTrue:
+      return true;
+    case common::FilterKind::kIsNull:
+      return numValues == 0;
+    case common::FilterKind::kIsNotNull:
+      return numValues == totalRows;
+    case common::FilterKind::kBigintRange:
+      break;
+    default:
+      // Floating point ranges are not contiguous due to NaN. Other filters
+      // are not tested.
+      return false;
+  }
+  if (numValues == 0) {
+    return true;
+  }
+  if (type->kind() != TypeKind::BIGINT && type->kind() != TypeKind::INTEGER &&
+      type->kind() != TypeKind::SMALLINT && type->kind() != TypeKind::TINYINT) {
+    return false;
+  }
+  auto intStats = dynamic_cast<dwio::common::IntegerColumnStatistics*>(stats);
+  if (!intStats || !intStats->getMinimum().has_value() ||
+      !intStats->getMaximum().has_value()) {
+    return false;
+  }
+  // A range passes all values between two passing values.
+  return filter->testInt64(intStats->getMinimum().value()) &&
+      filter->testInt64(intStats->getMaximum().value());
+}
+
 ScanSpec& ScanSpec::getChildByChannel(column_index_t channel) {
   for (auto& child : children_) {
     if (child->channel_ == channel) {
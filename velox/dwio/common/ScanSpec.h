@@ -40,13 +40,23 @@ class ScanSpec {
  public:
   static constexpr column_index_t kNoChannel = ~0;
 
+  // A subscript element makes a spec for the value of one key of a map. The
+  // key is 'fieldName_' and for an integer key also 'subscript_'.
   explicit ScanSpec(const Subfield::PathElement& element) {
     if (element.kind() == kNestedField) {
       auto field = reinterpret_cast<const Subfield::NestedField*>(&element);
       fieldName_ = field->name();
-
+    } else if (element.kind() == kStringSubscript) {
+      fieldName_ =
+          reinterpret_cast<const Subfield::StringSubscript*>(&element)->index();
+      isSubscript_ = true;
+    } else if (element.kind() == kLongSubscript) {
+      subscript_ =
+          reinterpret_cast<const Subfield::LongSubscript*>(&element)->index();
+      fieldName_ = std::to_string(subscript_);
+      isSubscript_ = true;
     } else {
-      VELOX_CHECK(false, "Only nested fields are supported");
+      VELOX_CHECK(false, "Only nested fields and subscripts are supported");
     }
   }
 
@@ -103,6 +113,14 @@ class ScanSpec {
     subscript_ = subscript;
   }
 
+  // True if 'this' was made for a map subscript, e.g. c0['a'] or c0[2]. The
+  // map readers that support these read only the keys with such specs if one
+  // of them is projected out and apply their filters to the value of the key.
+  // A map row without the key has a null value for the filter.
+  bool isSubscript() const {
+    return isSubscript_;
+  }
+
   // True if the value is returned from scan. Fields can have
   // 'extractValues_' set and not be projected out if these are only
   // used in filter functions. A runtime pushdown of a filter function
@@ -248,10 +266,40 @@ class ScanSpec {
     reorder();
   }
 
+  // Takes the filters and filter statistics of the top level fields from
+  // 'other', a ScanSpec made for the same columns. Used when a reader made
+  // with 'this' continues the scan of 'other', so that dynamic filters and
+  // the adapted filter order carry over. Fields that are constant in either
+  // spec are skipped, their filters were applied when the split was added.
+  void moveAdaptationFrom(ScanSpec& other);
+
   void setEnableFilterReorder(bool enableFilterReorder) {
     enableFilterReorder_ = enableFilterReorder;
   }
 
+  // Sets the maximum number of rows a reader may scan in one call to produce
+  // a batch when the filters of 'this' pass few rows. The reader then scans
+  // enough rows for about the requested batch size to pass, so that the
+  // projected columns without filters, which are read for the passing rows
+  // only, are accessed once per window of rows instead of once per scanned
+  // batch. The windows do not cross row groups. 0 means the reader scans the
+  // requested number of rows.
+  void setMaxRowsToScan(uint64_t maxRowsToScan) {
+    maxRowsToScan_ = maxRowsToScan;
+  }
+
+  // Records that a read of the struct described by 'this' scanned
+  // 'numScanned' rows, of which 'numPassed' passed the filters.
+  void addScanResult(uint64_t numScanned, uint64_t numPassed) {
+    numRowsScanned_ += numScanned;
+    numRowsPassed_ += numPassed;
+  }
+
+  // Returns the number of rows to scan for about 'numRows' rows to pass the
+  // filters, going by the scan results so far. This is between 'numRows' and
+  // the maximum set by setMaxRowsToScan().
+  uint64_t rowsToScan(uint64_t numRows) const;
+
   // Returns the child which produces values for 'channel'. Throws if not found.
   ScanSpec& getChildByChannel(column_index_t channel);
 
@@ -271,6 +319,7 @@ class ScanSpec {
   // map with numeric key, this is the subscript as defined for array
   // or map.
   int64_t subscript_ = -1;
+  bool isSubscript_ = false;
   // Column name if this is a struct mamber. String key if this
   // describes an operation on a map value.
   std::string fieldName_;
@@ -305,6 +354,12 @@ class ScanSpec {
 
   std::vector<std::shared_ptr<ScanSpec>> children_;
   mutable std::optional<bool> hasFilter_;
+
+  // See setMaxRowsToScan().
+  uint64_t maxRowsToScan_ = 0;
+  // Rows scanned and rows passing the filters, see addScanResult().
+  uint64_t numRowsScanned_ = 0;
+  uint64_t numRowsPassed_ = 0;
   ValueHook* valueHook_ = nullptr;
 };
 
@@ -316,6 +371,14 @@ bool testFilter(
     uint64_t totalRows,
     const TypePtr& type);
 
+// Returns true if all of the 'totalRows' rows described by 'stats' pass
+// 'filter'. False if some row may not pass or 'stats' does not tell.
+bool testFilterAllRows(
+    common::Filter* filter,
+    dwio::common::ColumnStatistics* stats,
+    uint64_t totalRows,
+    const TypePtr& type);
+
 } // namespace common
 } // namespace velox
 } // namespace facebook
@@ -18,6 +18,7 @@
 
 #include <vector>
 
+#include "velox/buffer/Buffer.h"
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/wrap/zero-copy-stream-wrapper.h"
@@ -57,6 +58,14 @@ class SeekableInputStream : public google::protobuf::io::ZeroCopyInputStream {
   // ORC/DWRF stream address.
   virtual size_t positionSize() = 0;
 
+  // Returns a Buffer over the bytes returned by the last Next(). The bytes
+  // stay valid for as long as the Buffer is referenced, so that vectors can
+  // refer to them without a copy. Returns nullptr if the bytes are valid only
+  // until the next call on 'this'.
+  virtual BufferPtr pinnedBuffer() {
+    return nullptr;
+  }
+
   void readFully(char* buffer, size_t bufferSize);
 };
 
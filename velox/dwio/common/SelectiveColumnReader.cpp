@@ -65,6 +65,51 @@ const std::vector<SelectiveColumnReader*>& SelectiveColumnReader::children()
   return empty;
 }
 
+void SelectiveColumnReader::moveScratchTo(ColumnReaderScratch& scratch) {
+  scratch.type = type_;
+  scratch.outputRows = std::move(outputRows_);
+  scratch.valueRows = std::move(valueRows_);
+  scratch.outerNonNullRows = std::move(outerNonNullRows_);
+  scratch.innerNonNullRows = std::move(innerNonNullRows_);
+  scratch.values = std::move(values_);
+  scratch.resultNulls = std::move(resultNulls_);
+  rawValues_ = nullptr;
+  rawResultNulls_ = nullptr;
+  auto& readerChildren = children();
+  scratch.children.resize(readerChildren.size());
+  for (auto i = 0; i < readerChildren.size(); ++i) {
+    readerChildren[i]->moveScratchTo(scratch.children[i]);
+  }
+}
+
+void SelectiveColumnReader::takeScratchFrom(ColumnReaderScratch& scratch) {
+  if (!type_ || !scratch.type || !type_->equivalent(*scratch.type)) {
+    return;
+  }
+  outputRows_ = std::move(scratch.outputRows);
+  outputRows_.clear();
+  valueRows_ = std::move(scratch.valueRows);
+  valueRows_.clear();
+  outerNonNullRows_ = std::move(scratch.outerNonNullRows);
+  outerNonNullRows_.clear();
+  innerNonNullRows_ = std::move(scratch.innerNonNullRows);
+  innerNonNullRows_.clear();
+  if (!values_ && scratch.values && scratch.values->unique()) {
+    values_ = std::move(scratch.values);
+    rawValues_ = values_->asMutable<char>();
+  }
+  if (!resultNulls_ && scratch.resultNulls && scratch.resultNulls->unique()) {
+    resultNulls_ = std::move(scratch.resultNulls);
+    rawResultNulls_ = resultNulls_->asMutable<uint64_t>();
+  }
+  auto& readerChildren = children();
+  for (auto i = 0;
+       i < readerChildren.size() && i < scratch.children.size();
+       ++i) {
+    readerChildren[i]->takeScratchFrom(scratch.children[i]);
+  }
+}
+
 bool SelectiveColumnReader::rowGroupMatches(uint32_t rowGroupId) const {
   return formatData_->rowGroupMatches(rowGroupId, scanSpec_->filter());
 }
@@ -116,6 +116,20 @@ struct ScanState {
   RawScanState rawState;
 };
 
+// Scratch memory of a SelectiveColumnReader and its children. Moved from the
+// reader tree of a stripe or split to the tree of the next one, so that the
+// new readers do not allocate their buffers again.
+struct ColumnReaderScratch {
+  TypePtr type;
+  raw_vector<vector_size_t> outputRows;
+  raw_vector<vector_size_t> valueRows;
+  raw_vector<int32_t> outerNonNullRows;
+  raw_vector<int32_t> innerNonNullRows;
+  BufferPtr values;
+  BufferPtr resultNulls;
+  std::vector<ColumnReaderScratch> children;
+};
+
 class SelectiveColumnReader {
  public:
   static constexpr uint64_t kStringBufferSize = 16 * 1024;
@@ -135,6 +149,14 @@ class SelectiveColumnReader {
   /// Returns list of child readers, empty for leaf readers.
   virtual const std::vector<SelectiveColumnReader*>& children() const;
 
+  /// Moves the scratch memory of 'this' and its children to 'scratch'.
+  void moveScratchTo(ColumnReaderScratch& scratch);
+
+  /// Takes the scratch memory of the readers in 'scratch' that read the same
+  /// type as the reader at the same position in the tree of 'this'. The
+  /// buffers that are referenced outside of 'scratch' stay there.
+  void takeScratchFrom(ColumnReaderScratch& scratch);
+
   /**
    * Read the next group of values into a RowVector.
    * @param numValues the number of values to read
@@ -16,6 +16,8 @@
 
 #include "velox/dwio/common/SelectiveStructColumnReader.h"
 
+#include <folly/futures/Future.h>
+
 #include "velox/dwio/common/ColumnLoader.h"
 
 namespace facebook::velox::dwio::common {
@@ -128,6 +130,7 @@ void SelectiveStructColumnReaderBase::read(
     filterNulls<int32_t>(
         rows, kind == velox::common::FilterKind::kIsNull, false);
     if (outputRows_.empty()) {
+      scanSpec_->addScanResult(rows.size(), 0);
       recordParentNullsInChildren(offset, rows);
       return;
     }
@@ -135,6 +138,7 @@ void SelectiveStructColumnReaderBase::read(
   }
 
   assert(!children_.empty());
+  parallelChildren_.clear();
   for (size_t i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
     if (childSpec->isConstant()) {
@@ -142,6 +146,10 @@ void SelectiveStructColumnReaderBase::read(
     }
     auto fieldIndex = childSpec->subscript();
     auto reader = children_.at(fieldIndex);
+    if (decodingExecutor_ && !childSpec->hasFilter()) {
+      parallelChildren_.push_back(reader);
+      continue;
+    }
     if (reader->isTopLevel() && childSpec->projectOut() &&
         !childSpec->hasFilter() && !childSpec->extractValues()) {
       // Will make a LazyVector.
@@ -169,17 +177,46 @@ void SelectiveStructColumnReaderBase::read(
       reader->read(offset, activeRows, structNulls);
     }
   }
+  if (!parallelChildren_.empty() && !activeRows.empty()) {
+    readChildrenInParallel(offset, activeRows, structNulls);
+  }
   // If this adds nulls, the field readers will miss a value for each null added
   // here.
   recordParentNullsInChildren(offset, rows);
 
   if (hasFilter) {
     setOutputRows(activeRows);
+    scanSpec_->addScanResult(rows.size(), activeRows.size());
   }
   lazyVectorReadOffset_ = offset;
   readOffset_ = offset + rows.back() + 1;
 }
 
+void SelectiveStructColumnReaderBase::readChildrenInParallel(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  if (parallelChildren_.size() == 1) {
+    advanceFieldReader(parallelChildren_[0], offset);
+    parallelChildren_[0]->read(offset, rows, incomingNulls);
+    return;
+  }
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(parallelChildren_.size());
+  for (auto* reader : parallelChildren_) {
+    futures.push_back(folly::via(decodingExecutor_, [&, reader]() {
+      advanceFieldReader(reader, offset);
+      reader->read(offset, rows, incomingNulls);
+    }));
+  }
+  // All reads must finish before an error is rethrown since they refer to
+  // 'rows'.
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (auto& result : results) {
+    result.throwIfFailed();
+  }
+}
+
 void SelectiveStructColumnReaderBase::recordParentNullsInChildren(
     vector_size_t offset,
     RowSet rows) {
@@ -262,6 +299,8 @@ void SelectiveStructColumnReaderBase::getValues(
     resultRow->clearNulls(0, rows.size());
   }
   bool lazyPrepared = false;
+  // The values of the children read in parallel are also copied in parallel.
+  std::vector<folly::Future<folly::Unit>> futures;
   auto& childSpecs = scanSpec_->children();
   for (auto i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
@@ -273,6 +312,10 @@ void SelectiveStructColumnReaderBase::getValues(
     if (childSpec->isConstant()) {
       resultRow->childAt(channel) = BaseVector::wrapInConstant(
           rows.size(), 0, childSpec->constantValue());
+    } else if (decodingExecutor_ && !childSpec->hasFilter()) {
+      futures.push_back(folly::via(decodingExecutor_, [&, index, channel]() {
+        children_[index]->getValues(rows, &resultRow->childAt(channel));
+      }));
     } else {
       if (!childSpec->extractValues() && !childSpec->hasFilter() &&
           children_[index]->isTopLevel()) {
@@ -293,6 +336,12 @@ void SelectiveStructColumnReaderBase::getValues(
       }
     }
   }
+  if (!futures.empty()) {
+    auto results = folly::collectAll(std::move(futures)).get();
+    for (auto& result : results) {
+      result.throwIfFailed();
+    }
+  }
 }
 
 } // namespace facebook::velox::dwio::common
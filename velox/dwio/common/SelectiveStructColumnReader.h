@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+
 #include "velox/dwio/common/SelectiveColumnReaderInternal.h"
 
 namespace facebook::velox::dwio::common {
@@ -99,6 +101,14 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
     return debugString_;
   }
 
+  /// Sets an executor on which the child columns without filters are read
+  /// and copied into the result in parallel, after the filter columns have
+  /// produced the rows passing. These columns are then not returned as
+  /// LazyVectors.
+  void setDecodingExecutor(folly::Executor* executor) {
+    decodingExecutor_ = executor;
+  }
+
  protected:
   SelectiveStructColumnReaderBase(
       const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
@@ -116,6 +126,13 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // know how much to skip when seeking forward within the row group.
   void recordParentNullsInChildren(vector_size_t offset, RowSet rows);
 
+  // Reads the children in 'parallelChildren_' for 'rows' on
+  // 'decodingExecutor_'.
+  void readChildrenInParallel(
+      vector_size_t offset,
+      RowSet rows,
+      const uint64_t* incomingNulls);
+
   const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
 
   std::vector<SelectiveColumnReader*> children_;
@@ -135,6 +152,12 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // and query. Set at construction, which takes place on first
   // use. If no ExceptionContext is in effect, this is "".
   const std::string debugString_;
+
+  folly::Executor* decodingExecutor_{nullptr};
+
+  // Child readers without filter, read after the filters when
+  // 'decodingExecutor_' is set.
+  std::vector<SelectiveColumnReader*> parallelChildren_;
 };
 
 struct SelectiveStructColumnReader : SelectiveStructColumnReaderBase {
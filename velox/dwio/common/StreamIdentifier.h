@@ -31,6 +31,8 @@ class StreamIdentifier {
 
   explicit StreamIdentifier(int32_t id) : id_(id) {}
 
+  StreamIdentifier(int32_t id, int32_t nodeId) : id_(id), nodeId_(nodeId) {}
+
   virtual ~StreamIdentifier() = default;
 
   virtual int32_t getId() const {
@@ -49,6 +51,12 @@ class StreamIdentifier {
     return fmt::format("[id={}]", id_);
   }
 
+  /// Returns the node of the file schema the stream belongs to, -1 if not
+  /// known. Used for attributing IO to columns.
+  int32_t nodeId() const {
+    return nodeId_;
+  }
+
   /// Returns a special value indicating a stream to be read load quantum by
   /// load quantum
   static StreamIdentifier sequentialFile() {
@@ -57,6 +65,7 @@ class StreamIdentifier {
   }
 
   int32_t id_;
+  int32_t nodeId_{-1};
 };
 
 struct StreamIdentifierHash {
@@ -19,8 +19,11 @@
 #include "velox/dwio/parquet/reader/RleBpDataDecoder.h"
 
 #include <folly/Random.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+DECLARE_bool(avx512vbmi);
+
 using namespace facebook::velox::dwio::common;
 using namespace facebook::velox;
 
@@ -172,3 +175,40 @@ TEST_F(BitPackDecoderTest, uint32AllRows) {
     testUnpack<uint32_t>(width);
   }
 }
+
+TEST_F(BitPackDecoderTest, uint32AllRowsWithoutAvx512) {
+  FLAGS_avx512vbmi = false;
+  for (auto width = 1; width <= 32; ++width) {
+    testUnpack<uint32_t>(width);
+  }
+  FLAGS_avx512vbmi = true;
+}
+
+TEST_F(BitPackDecoderTest, bigEndian) {
+  constexpr int32_t kNumValues = 1'000;
+  for (auto avx512 : {true, false}) {
+    FLAGS_avx512vbmi = avx512;
+    for (auto width = 1; width <= 64; ++width) {
+      SCOPED_TRACE(fmt::format("width {} avx512 {}", width, avx512));
+      // The fields are packed starting at the most significant bit.
+      std::vector<uint8_t> packed(kNumValues * width / 8);
+      for (auto i = 0; i < kNumValues; ++i) {
+        for (auto bit = 0; bit < width; ++bit) {
+          if (randomInts_[i] >> (width - 1 - bit) & 1) {
+            const uint64_t position = i * width + bit;
+            packed[position / 8] |= 0x80 >> (position % 8);
+          }
+        }
+      }
+      std::vector<uint64_t> result(kNumValues);
+      EXPECT_EQ(
+          packed.size(),
+          unpackBigEndian(packed.data(), kNumValues, width, result.data()));
+      const auto mask = width == 64 ? ~0ULL : bits::lowMask(width);
+      for (auto i = 0; i < kNumValues; ++i) {
+        ASSERT_EQ(randomInts_[i] & mask, result[i]) << "at " << i;
+      }
+    }
+  }
+  FLAGS_avx512vbmi = true;
+}
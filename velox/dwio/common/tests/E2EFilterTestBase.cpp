@@ -246,6 +246,7 @@ void E2EFilterTestBase::testFilterSpecs(
   auto filters =
       filterGenerator_->makeSubfieldFilters(filterSpecs, batches, hitRows);
   auto spec = filterGenerator_->makeScanSpec(std::move(filters));
+  spec->setMaxRowsToScan(maxRowsToScan_);
   uint64_t timeWithFilter = 0;
   readWithFilter(spec, batches, hitRows, timeWithFilter, false);
 
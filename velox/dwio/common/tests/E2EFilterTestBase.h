@@ -288,6 +288,8 @@ class E2EFilterTestBase : public testing::Test {
   std::vector<int32_t> readSizes_;
   int32_t batchCount_ = kBatchCount;
   int32_t batchSize_ = kBatchSize;
+  // Passed to ScanSpec::setMaxRowsToScan() of the filtered reads.
+  uint64_t maxRowsToScan_{0};
 };
 
 } // namespace facebook::velox::dwio::common
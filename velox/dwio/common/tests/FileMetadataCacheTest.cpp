@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::dwio::common;
+
+TEST(FileMetadataCacheTest, findAndEvict) {
+  FileMetadataCache cache(100);
+  const FileMetadataKey key{1, 1000, FileFormat::DWRF};
+  EXPECT_EQ(nullptr, cache.find<std::string>(key));
+
+  cache.insert(key, std::make_shared<std::string>("footer"), 60);
+  auto footer = cache.find<std::string>(key);
+  ASSERT_NE(nullptr, footer);
+  EXPECT_EQ("footer", *footer);
+  EXPECT_EQ(60, cache.currentBytes());
+
+  // A different size or format is a different file.
+  EXPECT_EQ(nullptr, cache.find<std::string>({1, 1001, FileFormat::DWRF}));
+  EXPECT_EQ(nullptr, cache.find<std::string>({1, 1000, FileFormat::PARQUET}));
+
+  // A second insert of a key keeps the first value.
+  cache.insert(key, std::make_shared<std::string>("other"), 10);
+  EXPECT_EQ(footer, cache.find<std::string>(key));
+
+  // Making room evicts the first entry, which stays alive for its users.
+  const FileMetadataKey secondKey{2, 1000, FileFormat::DWRF};
+  cache.insert(secondKey, std::make_shared<std::string>("second"), 50);
+  EXPECT_EQ(nullptr, cache.find<std::string>(key));
+  EXPECT_EQ("footer", *footer);
+  EXPECT_EQ("second", *cache.find<std::string>(secondKey));
+
+  // Metadata larger than the cache is not cached.
+  const FileMetadataKey largeKey{3, 1000, FileFormat::DWRF};
+  cache.insert(largeKey, std::make_shared<std::string>(), 200);
+  EXPECT_EQ(nullptr, cache.find<std::string>(largeKey));
+}
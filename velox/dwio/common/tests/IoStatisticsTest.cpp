@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/IoStatistics.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::dwio::common;
+
+TEST(IoStatisticsTest, storageReadModel) {
+  IoStatistics stats;
+  EXPECT_FALSE(stats.storageReadModel().has_value());
+
+  // 20ms latency and 100 bytes per microsecond, e.g. an object store.
+  for (auto i = 0; i < 100; ++i) {
+    const uint64_t bytes = (1 + i % 10) * 100'000;
+    stats.recordStorageRead(bytes, 20'000 + bytes / 100);
+  }
+  auto model = stats.storageReadModel();
+  ASSERT_TRUE(model.has_value());
+  EXPECT_NEAR(20'000, model->latencyUs, 1);
+  EXPECT_NEAR(100, model->bytesPerUs, 0.01);
+
+  // Reads of one size do not separate latency from bandwidth.
+  IoStatistics uniform;
+  for (auto i = 0; i < 100; ++i) {
+    uniform.recordStorageRead(1'000'000, 30'000);
+  }
+  EXPECT_FALSE(uniform.storageReadModel().has_value());
+
+  // Merged statistics fit the reads of both.
+  uniform.merge(stats);
+  model = uniform.storageReadModel();
+  ASSERT_TRUE(model.has_value());
+  EXPECT_GT(model->latencyUs, 0);
+}
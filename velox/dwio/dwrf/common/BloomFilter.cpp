@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+#include <folly/Bits.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+namespace {
+
+constexpr uint64_t kMurmurC1 = 0x87c37b91114253d5ULL;
+constexpr uint64_t kMurmurC2 = 0x4cf5ad432745937fULL;
+constexpr uint64_t kMurmurSeed = 104729;
+
+inline uint64_t rotateLeft(uint64_t value, int32_t shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+inline uint64_t fmix64(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Arithmetic right shift, as '>>' on a Java long.
+inline uint64_t shiftRight(uint64_t value, int32_t shift) {
+  return static_cast<uint64_t>(static_cast<int64_t>(value) >> shift);
+}
+
+} // namespace
+
+BloomFilter::BloomFilter(uint64_t expectedEntries, double fpp) {
+  DWIO_ENSURE(fpp > 0.0 && fpp < 1.0, "Invalid bloom filter fpp ", fpp);
+  const auto entries =
+      static_cast<double>(std::max<uint64_t>(1, expectedEntries));
+  const auto bits = static_cast<uint64_t>(
+      -entries * std::log(fpp) / (std::log(2.0) * std::log(2.0)));
+  // Rounds up to whole words the same way as ORC, which adds a word when
+  // 'bits' is already a multiple of 64.
+  numBits_ = bits + (64 - bits % 64);
+  numHashFunctions_ = std::max<int32_t>(
+      1, static_cast<int32_t>(std::round(numBits_ / entries * std::log(2.0))));
+  bitset_.resize(numBits_ / 64);
+}
+
+BloomFilter::BloomFilter(const proto::BloomFilter& filter)
+    : numHashFunctions_(filter.numhashfunctions()) {
+  if (filter.bitset_size() > 0) {
+    bitset_.assign(filter.bitset().begin(), filter.bitset().end());
+  } else {
+    const auto& bytes = filter.utf8bitset();
+    DWIO_ENSURE_EQ(bytes.size() % sizeof(uint64_t), 0);
+    bitset_.resize(bytes.size() / sizeof(uint64_t));
+    for (auto i = 0; i < bitset_.size(); ++i) {
+      bitset_[i] = folly::Endian::little(
+          folly::loadUnaligned<uint64_t>(bytes.data() + i * sizeof(uint64_t)));
+    }
+  }
+  DWIO_ENSURE(!bitset_.empty(), "Empty bloom filter");
+  DWIO_ENSURE_GT(numHashFunctions_, 0);
+  numBits_ = bitset_.size() * 64;
+}
+
+void BloomFilter::reset() {
+  std::fill(bitset_.begin(), bitset_.end(), 0);
+}
+
+void BloomFilter::serialize(proto::BloomFilter& filter) const {
+  filter.set_numhashfunctions(numHashFunctions_);
+  auto* bitset = filter.mutable_bitset();
+  bitset->Reserve(bitset_.size());
+  for (auto word : bitset_) {
+    bitset->Add(word);
+  }
+}
+
+void BloomFilter::addHash(uint64_t hash) {
+  const auto hash1 = static_cast<uint32_t>(hash);
+  const auto hash2 = static_cast<uint32_t>(hash >> 32);
+  for (int32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto combined = static_cast<int32_t>(hash1 + i * hash2);
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    const uint64_t bit = combined % numBits_;
+    bitset_[bit / 64] |= 1ULL << (bit % 64);
+  }
+}
+
+bool BloomFilter::testHash(uint64_t hash) const {
+  const auto hash1 = static_cast<uint32_t>(hash);
+  const auto hash2 = static_cast<uint32_t>(hash >> 32);
+  for (int32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto combined = static_cast<int32_t>(hash1 + i * hash2);
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    const uint64_t bit = combined % numBits_;
+    if ((bitset_[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// static
+uint64_t BloomFilter::getLongHash(int64_t value) {
+  auto key = static_cast<uint64_t>(value);
+  key = (~key) + (key << 21);
+  key = key ^ shiftRight(key, 24);
+  key = (key + (key << 3)) + (key << 8);
+  key = key ^ shiftRight(key, 14);
+  key = (key + (key << 2)) + (key << 4);
+  key = key ^ shiftRight(key, 28);
+  key = key + (key << 31);
+  return key;
+}
+
+// static
+uint64_t BloomFilter::murmur3Hash64(const char* data, size_t length) {
+  uint64_t hash = kMurmurSeed;
+  const auto numBlocks = length / 8;
+  for (auto i = 0; i < numBlocks; ++i) {
+    auto k =
+        folly::Endian::little(folly::loadUnaligned<uint64_t>(data + i * 8));
+    k *= kMurmurC1;
+    k = rotateLeft(k, 31);
+    k *= kMurmurC2;
+    hash ^= k;
+    hash = rotateLeft(hash, 27) * 5 + 0x52dce729;
+  }
+  const auto* tail = reinterpret_cast<const uint8_t*>(data + numBlocks * 8);
+  const auto tailLength = length - numBlocks * 8;
+  if (tailLength > 0) {
+    uint64_t k = 0;
+    for (auto i = 0; i < tailLength; ++i) {
+      k ^= static_cast<uint64_t>(tail[i]) << (i * 8);
+    }
+    k *= kMurmurC1;
+    k = rotateLeft(k, 31);
+    k *= kMurmurC2;
+    hash ^= k;
+  }
+  hash ^= length;
+  return fmix64(hash);
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
+
+namespace facebook::velox::dwrf {
+
+/// Bloom filter over the values of one row index stride of a column. Uses the
+/// sizing, bit layout and hash functions of the ORC writers, so that filters
+/// written by ORC and DWRF writers are tested the same way. Integers of all
+/// widths are hashed as 64 bit values and strings by their UTF-8 bytes.
+class BloomFilter {
+ public:
+  /// Sizes the filter for 'expectedEntries' distinct values with a false
+  /// positive probability of 'fpp'.
+  BloomFilter(uint64_t expectedEntries, double fpp);
+
+  /// Reads a filter from the 'bitset' or 'utf8bitset' field of 'filter'.
+  explicit BloomFilter(const proto::BloomFilter& filter);
+
+  void addLong(int64_t value) {
+    addHash(getLongHash(value));
+  }
+
+  void addBytes(const char* data, size_t length) {
+    addHash(murmur3Hash64(data, length));
+  }
+
+  /// Returns false if 'value' was certainly not added to 'this'.
+  bool testLong(int64_t value) const {
+    return testHash(getLongHash(value));
+  }
+
+  /// Returns false if the string was certainly not added to 'this'.
+  bool testBytes(const char* data, size_t length) const {
+    return testHash(murmur3Hash64(data, length));
+  }
+
+  /// Clears all bits for the next stride.
+  void reset();
+
+  /// Writes 'this' into the 'bitset' field of 'filter'.
+  void serialize(proto::BloomFilter& filter) const;
+
+  uint64_t numBits() const {
+    return numBits_;
+  }
+
+  int32_t numHashFunctions() const {
+    return numHashFunctions_;
+  }
+
+  /// Thomas Wang's 64 bit integer hash, as used for integers by ORC.
+  static uint64_t getLongHash(int64_t key);
+
+  /// 64 bit Murmur3 with the seed used for strings by ORC.
+  static uint64_t murmur3Hash64(const char* data, size_t length);
+
+ private:
+  void addHash(uint64_t hash);
+
+  bool testHash(uint64_t hash) const;
+
+  uint64_t numBits_;
+  int32_t numHashFunctions_;
+  std::vector<uint64_t> bitset_;
+};
+
+} // namespace facebook::velox::dwrf
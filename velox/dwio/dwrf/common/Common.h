@@ -165,7 +165,8 @@ class DwrfStreamIdentifier : public dwio::common::StreamIdentifier {
       uint32_t column,
       StreamKind kind)
       : StreamIdentifier(
-            velox::cache::TrackingId((node << kNodeShift) | kind).id()),
+            velox::cache::TrackingId((node << kNodeShift) | kind).id(),
+            node),
         column_{column},
         kind_(kind),
         encodingKey_{node, sequence} {}
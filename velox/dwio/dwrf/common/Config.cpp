@@ -21,6 +21,25 @@
 
 namespace facebook::velox::dwrf {
 
+namespace {
+
+std::vector<uint32_t> parseColumnList(const std::string& val) {
+  std::vector<uint32_t> result;
+  if (!val.empty()) {
+    std::vector<folly::StringPiece> pieces;
+    folly::split(',', val, pieces, true);
+    for (auto& p : pieces) {
+      const auto& trimmedCol = folly::trimWhitespace(p);
+      if (!trimmedCol.empty()) {
+        result.push_back(folly::to<uint32_t>(trimmedCol));
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 Config::Entry<WriterVersion> Config::WRITER_VERSION(
     "orc.writer.version",
     WriterVersion_CURRENT);
@@ -105,6 +124,13 @@ Config::Entry<uint32_t> Config::ENTROPY_STRING_THRESHOLD{
     "hive.exec.orc.entropy.string.threshold",
     20};
 
+// Number of values sampled from the first write of the first stripe to decide
+// if a string column is dictionary encoded before building its dictionary. 0
+// disables the sampling.
+Config::Entry<uint32_t> Config::DICTIONARY_STRING_SAMPLE_ROWS{
+    "hive.exec.orc.dictionary.string.sample.rows",
+    0};
+
 Config::Entry<uint32_t> Config::STRING_STATS_LIMIT(
     "hive.orc.string.stats.limit",
     64);
@@ -128,18 +154,7 @@ Config::Entry<const std::vector<uint32_t>> Config::MAP_FLAT_COLS(
     {},
     [](const std::vector<uint32_t>& val) { return folly::join(",", val); },
     [](const std::string& /* key */, const std::string& val) {
-      std::vector<uint32_t> result;
-      if (!val.empty()) {
-        std::vector<folly::StringPiece> pieces;
-        folly::split(',', val, pieces, true);
-        for (auto& p : pieces) {
-          const auto& trimmedCol = folly::trimWhitespace(p);
-          if (!trimmedCol.empty()) {
-            result.push_back(folly::to<uint32_t>(trimmedCol));
-          }
-        }
-      }
-      return result;
+      return parseColumnList(val);
     });
 
 Config::Entry<const std::vector<std::vector<std::string>>>
@@ -209,4 +224,14 @@ Config::Entry<uint64_t> Config::RAW_DATA_SIZE_PER_BATCH(
     50UL * 1024 * 1024);
 
 Config::Entry<bool> Config::MAP_STATISTICS("orc.map.statistics", false);
+
+Config::Entry<const std::vector<uint32_t>> Config::BLOOM_FILTER_COLUMNS(
+    "orc.bloom.filter.columns",
+    {},
+    [](const std::vector<uint32_t>& val) { return folly::join(",", val); },
+    [](const std::string& /* key */, const std::string& val) {
+      return parseColumnList(val);
+    });
+
+Config::Entry<double> Config::BLOOM_FILTER_FPP("orc.bloom.filter.fpp", 0.05);
 } // namespace facebook::velox::dwrf
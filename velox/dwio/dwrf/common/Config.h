@@ -51,6 +51,7 @@ class Config : public common::ConfigBase<Config> {
   static Entry<uint32_t> ENTROPY_STRING_MIN_SAMPLES;
   static Entry<float> ENTROPY_STRING_DICT_SAMPLE_FRACTION;
   static Entry<uint32_t> ENTROPY_STRING_THRESHOLD;
+  static Entry<uint32_t> DICTIONARY_STRING_SAMPLE_ROWS;
   static Entry<uint32_t> STRING_STATS_LIMIT;
   static Entry<bool> FLATTEN_MAP;
   static Entry<bool> MAP_FLAT_DISABLE_DICT_ENCODING;
@@ -74,6 +75,11 @@ class Config : public common::ConfigBase<Config> {
   // to write oversized stripes.
   static Entry<uint64_t> RAW_DATA_SIZE_PER_BATCH;
   static Entry<bool> MAP_STATISTICS;
+  // Top level columns for which a bloom filter is written per row index
+  // stride. Applies to integer and string columns.
+  static Entry<const std::vector<uint32_t>> BLOOM_FILTER_COLUMNS;
+  // False positive probability of the bloom filters.
+  static Entry<double> BLOOM_FILTER_FPP;
 
   static std::shared_ptr<Config> fromMap(
       const std::map<std::string, std::string>& map) {
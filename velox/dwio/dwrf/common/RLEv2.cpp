@@ -15,13 +15,71 @@
  */
 
 #include "velox/dwio/dwrf/common/RLEv2.h"
+#include "velox/common/process/ProcessBase.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
 
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
 namespace facebook::velox::dwrf {
 
 using memory::MemoryPool;
 
+namespace {
+#ifdef __x86_64__
+// AVX-512 version of addDeltas() for a multiple of 8 values. Each vector of 8
+// deltas gets its prefix sums in 3 steps of adding the vector shifted by 1, 2
+// and 4 lanes.
+__attribute__((target("avx512f"))) int64_t addDeltas8(
+    int64_t* data,
+    uint64_t numValues,
+    int64_t previous,
+    bool negate) {
+  const auto zero = _mm512_setzero_si512();
+  const auto last = _mm512_set1_epi64(7);
+  auto carry = _mm512_set1_epi64(previous);
+  for (uint64_t i = 0; i < numValues; i += 8) {
+    auto sums = _mm512_loadu_si512(data + i);
+    if (negate) {
+      sums = _mm512_sub_epi64(zero, sums);
+    }
+    sums = _mm512_add_epi64(sums, _mm512_alignr_epi64(sums, zero, 7));
+    sums = _mm512_add_epi64(sums, _mm512_alignr_epi64(sums, zero, 6));
+    sums = _mm512_add_epi64(sums, _mm512_alignr_epi64(sums, zero, 4));
+    sums = _mm512_add_epi64(sums, carry);
+    _mm512_storeu_si512(data + i, sums);
+    carry = _mm512_permutexvar_epi64(last, sums);
+  }
+  return _mm_cvtsi128_si64(_mm512_castsi512_si128(carry));
+}
+#endif
+
+// Replaces each of the 'numValues' deltas at 'data' with 'previous' plus the
+// sum of the deltas up to it, or minus the sum if 'negate'. Returns the last
+// value.
+int64_t
+addDeltas(int64_t* data, uint64_t numValues, int64_t previous, bool negate) {
+  uint64_t i = 0;
+#ifdef __x86_64__
+  if (numValues >= 8 && process::hasAvx512Vbmi()) {
+    i = numValues & ~7ULL;
+    previous = addDeltas8(data, i, previous, negate);
+  }
+#endif
+  // The values wrap around like the stored longs.
+  auto unsignedPrevious = static_cast<uint64_t>(previous);
+  for (; i < numValues; ++i) {
+    const auto delta = static_cast<uint64_t>(data[i]);
+    unsignedPrevious = negate ? unsignedPrevious - delta
+                              : unsignedPrevious + delta;
+    data[i] = static_cast<int64_t>(unsignedPrevious);
+  }
+  return static_cast<int64_t>(unsignedPrevious);
+}
+} // namespace
+
 struct FixedBitSizes {
   enum FBS {
     ONE = 0,
@@ -550,7 +608,9 @@ uint64_t RleDecoderV2<isSigned>::nextDelta(
     uint64_t remaining = (offset + nRead) - pos;
     runRead += readLongs(data, pos, remaining, bitSize, nulls);
 
-    if (deltaBase < 0) {
+    if (!nulls) {
+      prevValue = addDeltas(data + pos, remaining, prevValue, deltaBase < 0);
+    } else if (deltaBase < 0) {
       for (; pos < offset + nRead; ++pos) {
         // skip null positions
         if (nulls && bits::isBitNull(nulls, pos)) {
@@ -19,6 +19,7 @@
 #include "velox/common/base/Nulls.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/Adaptor.h"
+#include "velox/dwio/common/BitPackDecoder.h"
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/exception/Exception.h"
@@ -114,9 +115,27 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
       uint64_t fb,
       const uint64_t* nulls = nullptr) {
     uint64_t ret = 0;
+    uint64_t i = offset;
+    if (!nulls && bitsLeft == 0) {
+      // The fields start at a byte boundary. The groups of 8 fields in the
+      // current buffer are unpacked in bulk. Each group ends at a byte
+      // boundary.
+      auto& bufferStart = dwio::common::IntDecoder<isSigned>::bufferStart;
+      const uint64_t numGroups = std::min<uint64_t>(
+          len / 8,
+          (dwio::common::IntDecoder<isSigned>::bufferEnd - bufferStart) / fb);
+      if (numGroups > 0) {
+        bufferStart += dwio::common::unpackBigEndian(
+            reinterpret_cast<const uint8_t*>(bufferStart),
+            numGroups * 8,
+            fb,
+            reinterpret_cast<uint64_t*>(data + offset));
+        i += numGroups * 8;
+        ret += numGroups * 8;
+      }
+    }
 
-    // TODO: unroll to improve performance
-    for (uint64_t i = offset; i < (offset + len); i++) {
+    for (; i < (offset + len); i++) {
       // skip null positions
       if (nulls && bits::isBitNull(nulls, i)) {
         continue;
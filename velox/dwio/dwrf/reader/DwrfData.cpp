@@ -17,9 +17,69 @@
 #include "velox/dwio/dwrf/reader/DwrfData.h"
 
 #include "velox/dwio/common/BufferUtil.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 
 namespace facebook::velox::dwrf {
 
+namespace {
+
+bool hasBloomFilterType(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the values of an equality or IN filter, which are the only ones
+// tested against the bloom filters. Returns false for other filters.
+bool bloomFilterValues(
+    const common::Filter& filter,
+    std::vector<int64_t>& longs,
+    std::vector<std::string_view>& strings) {
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto& range = static_cast<const common::BigintRange&>(filter);
+      if (!range.isSingleValue()) {
+        return false;
+      }
+      longs.push_back(range.lower());
+      return true;
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      longs = static_cast<const common::BigintValuesUsingHashTable&>(filter)
+                  .values();
+      return true;
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      longs = static_cast<const common::BigintValuesUsingBitmask&>(filter)
+                  .values();
+      return true;
+    case common::FilterKind::kBytesRange: {
+      auto& range = static_cast<const common::BytesRange&>(filter);
+      if (!range.isSingleValue()) {
+        return false;
+      }
+      strings.push_back(range.lower());
+      return true;
+    }
+    case common::FilterKind::kBytesValues:
+      for (auto& value :
+           static_cast<const common::BytesValues&>(filter).values()) {
+        strings.push_back(value);
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
 DwrfData::DwrfData(
     std::shared_ptr<const dwio::common::TypeWithId> nodeType,
     StripeStreams& stripe,
@@ -42,6 +102,10 @@ DwrfData::DwrfData(
   // time pushdown.
   indexStream_ = stripe.getStream(
       encodingKey.forKind(proto::Stream_Kind_ROW_INDEX), false);
+  if (hasBloomFilterType(nodeType_->type->kind())) {
+    bloomFilterStream_ = stripe.getStream(
+        encodingKey.forKind(proto::Stream_Kind_BLOOM_FILTER_UTF8), false);
+  }
 }
 
 uint64_t DwrfData::skipNulls(uint64_t numValues, bool /*nullsOnly*/) {
@@ -142,6 +206,19 @@ std::vector<uint32_t> DwrfData::filterRowGroups(
   ensureRowGroupIndex();
   auto filter = scanSpec.filter();
 
+  // Equality and IN filters that do not pass nulls are also tested against
+  // the bloom filters of the strides.
+  std::vector<int64_t> longs;
+  std::vector<std::string_view> strings;
+  if ((bloomFilters_ || bloomFilterStream_) && !filter->testNull() &&
+      bloomFilterValues(*filter, longs, strings)) {
+    if (bloomFilterStream_) {
+      bloomFilters_ = ProtoUtils::readProto<proto::BloomFilterIndex>(
+          std::move(bloomFilterStream_));
+    }
+  }
+  const bool useBloomFilters = !longs.empty() || !strings.empty();
+
   std::vector<uint32_t> stridesToSkip;
   auto dwrfContext = reinterpret_cast<const StatsContext*>(&writerContext);
   for (auto i = 0; i < index_->entry_size(); i++) {
@@ -151,6 +228,21 @@ std::vector<uint32_t> DwrfData::filterRowGroups(
     if (!testFilter(filter, columnStats.get(), rowGroupSize, nodeType_->type)) {
       VLOG(1) << "Drop stride " << i << " on " << scanSpec.toString();
       stridesToSkip.push_back(i); // Skipping stride based on column stats.
+    } else if (useBloomFilters && i < bloomFilters_->bloomfilter_size()) {
+      BloomFilter bloomFilter(bloomFilters_->bloomfilter(i));
+      const bool mayMatch =
+          std::any_of(
+              longs.begin(),
+              longs.end(),
+              [&](auto value) { return bloomFilter.testLong(value); }) ||
+          std::any_of(strings.begin(), strings.end(), [&](auto value) {
+            return bloomFilter.testBytes(value.data(), value.size());
+          });
+      if (!mayMatch) {
+        VLOG(1) << "Drop stride " << i << " on bloom filter of "
+                << scanSpec.toString();
+        stridesToSkip.push_back(i);
+      }
     }
   }
   return stridesToSkip;
@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/common/SelectiveStructColumnReader.h"
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/dwio/common/exception/Exception.h"
 
@@ -259,8 +260,12 @@ uint64_t DwrfRowReader::next(uint64_t size, VectorPtr& result) {
       checkSkipStrides(context, strideSize);
     }
 
-    uint64_t rowsToRead = std::min(
-        static_cast<uint64_t>(size), rowsInCurrentStripe - currentRowInStripe);
+    // With selective filters, scans more rows so that about 'size' pass.
+    const uint64_t rowsToScan = selectiveColumnReader_
+        ? selectiveColumnReader_->scanSpec()->rowsToScan(size)
+        : size;
+    uint64_t rowsToRead =
+        std::min(rowsToScan, rowsInCurrentStripe - currentRowInStripe);
 
     if (rowsToRead > 0) {
       // don't allow read to cross stride
@@ -295,6 +300,38 @@ uint64_t DwrfRowReader::next(uint64_t size, VectorPtr& result) {
   }
 }
 
+std::vector<dwio::common::UnitStatistics> DwrfRowReader::unitStatistics()
+    const {
+  auto& footer = getReader().getFooter();
+  const uint32_t numStripes = footer.stripesSize();
+  if (firstStripe != 0 || lastStripe != numStripes ||
+      currentStripe != firstStripe || currentRowInStripe != 0 ||
+      footer.statisticsSize() == 0) {
+    return {};
+  }
+  const auto& schema = getReader().getSchemaWithId();
+  std::vector<dwio::common::UnitStatistics> units(1);
+  units[0].numRows = footer.numberOfRows();
+  for (auto i = 0; i < schema->size(); ++i) {
+    auto nodeId = schema->childAt(i)->id;
+    units[0].columns.push_back(
+        nodeId < static_cast<uint32_t>(footer.statisticsSize())
+            ? getReader().getColumnStatistics(nodeId)
+            : nullptr);
+  }
+  return units;
+}
+
+void DwrfRowReader::skipUnits(const std::vector<uint32_t>& indices) {
+  if (indices.empty()) {
+    return;
+  }
+  DWIO_ENSURE(
+      indices.size() == 1 && indices[0] == 0 && currentRowInStripe == 0,
+      "Bad units to skip");
+  currentStripe = lastStripe;
+}
+
 void DwrfRowReader::resetFilterCaches() {
   if (selectiveColumnReader_) {
     selectiveColumnReader_->resetFilterCaches();
@@ -304,6 +341,26 @@ void DwrfRowReader::resetFilterCaches() {
   // For columnReader_, this is no-op.
 }
 
+std::shared_ptr<dwio::common::ColumnReaderScratch>
+DwrfRowReader::releaseScratch() {
+  if (selectiveColumnReader_) {
+    if (!scratch_) {
+      scratch_ = std::make_shared<dwio::common::ColumnReaderScratch>();
+    }
+    selectiveColumnReader_->moveScratchTo(*scratch_);
+  }
+  return std::move(scratch_);
+}
+
+void DwrfRowReader::setScratch(
+    std::shared_ptr<dwio::common::ColumnReaderScratch> scratch) {
+  scratch_ = std::move(scratch);
+  // The readers of the first stripe exist if it was prefetched.
+  if (scratch_ && selectiveColumnReader_) {
+    selectiveColumnReader_->takeScratchFrom(*scratch_);
+  }
+}
+
 void DwrfRowReader::startNextStripe() {
   if (newStripeLoaded || currentStripe >= lastStripe) {
     return;
@@ -330,9 +387,25 @@ void DwrfRowReader::startNextStripe() {
   auto flatMapContext = FlatMapContext::nonFlatMapContext();
 
   if (scanSpec) {
+    if (selectiveColumnReader_) {
+      if (!scratch_) {
+        scratch_ = std::make_shared<dwio::common::ColumnReaderScratch>();
+      }
+      selectiveColumnReader_->moveScratchTo(*scratch_);
+    }
     selectiveColumnReader_ = SelectiveDwrfReader::build(
         requestedType, dataType, stripeStreams, scanSpec, flatMapContext);
+    if (scratch_) {
+      selectiveColumnReader_->takeScratchFrom(*scratch_);
+    }
     selectiveColumnReader_->setIsTopLevel();
+    if (auto& executor = options_.getDecodingExecutor()) {
+      if (auto structReader = dynamic_cast<
+              dwio::common::SelectiveStructColumnReaderBase*>(
+              selectiveColumnReader_.get())) {
+        structReader->setDecodingExecutor(executor.get());
+      }
+    }
   } else {
     columnReader_ = ColumnReader::build(
         requestedType, dataType, stripeStreams, flatMapContext);
@@ -478,7 +551,8 @@ DwrfReader::DwrfReader(
           std::move(input),
           options.getDecrypterFactory(),
           options.getFileFormat() == FileFormat::ORC ? FileFormat::ORC
-                                                     : FileFormat::DWRF)),
+                                                     : FileFormat::DWRF,
+          options.fileId())),
       options_(options) {}
 
 std::unique_ptr<StripeInformation> DwrfReader::getStripe(
@@ -91,6 +91,22 @@ class DwrfRowReader : public StrideIndexProvider,
 
   void resetFilterCaches() override;
 
+  void prefetchFirstStripe() override {
+    startNextStripe();
+  }
+
+  std::shared_ptr<dwio::common::ColumnReaderScratch> releaseScratch()
+      override;
+
+  void setScratch(
+      std::shared_ptr<dwio::common::ColumnReaderScratch> scratch) override;
+
+  // DWRF keeps column statistics for the whole file only. Returns a single
+  // unit if 'this' reads all stripes and has not started.
+  std::vector<dwio::common::UnitStatistics> unitStatistics() const override;
+
+  void skipUnits(const std::vector<uint32_t>& indices) override;
+
   // Returns the skipped strides for 'stripe'. Used for testing.
   std::optional<std::vector<uint32_t>> stridesToSkip(uint32_t stripe) const {
     auto it = stripeStridesToSkip_.find(stripe);
@@ -122,6 +138,9 @@ class DwrfRowReader : public StrideIndexProvider,
 
   std::unique_ptr<ColumnReader> columnReader_;
   std::unique_ptr<dwio::common::SelectiveColumnReader> selectiveColumnReader_;
+  // Buffers of the column readers of the previous stripe or split for the
+  // readers of the next stripe.
+  std::shared_ptr<dwio::common::ColumnReaderScratch> scratch_;
   std::vector<uint32_t> stridesToSkip_;
   // Record of strides to skip in each visited stripe. Used for diagnostics.
   std::unordered_map<uint32_t, std::vector<uint32_t>> stripeStridesToSkip_;
@@ -18,6 +18,7 @@
 
 #include <fmt/format.h>
 
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/exception/Exception.h"
 
 namespace facebook::velox::dwrf {
@@ -84,11 +85,13 @@ ReaderBase::ReaderBase(
     MemoryPool& pool,
     std::unique_ptr<dwio::common::BufferedInput> input,
     std::shared_ptr<DecrypterFactory> decryptorFactory,
-    FileFormat fileFormat)
+    FileFormat fileFormat,
+    std::optional<uint64_t> fileId)
     : pool_{pool},
       arena_(std::make_unique<google::protobuf::Arena>()),
       decryptorFactory_(decryptorFactory),
-      input_(std::move(input)) {
+      input_(std::move(input)),
+      fileId_(fileId) {
   // read last bytes into buffer to get PostScript
   // If file is small, load the entire file.
   // TODO: make a config
@@ -100,8 +103,79 @@ ReaderBase::ReaderBase(
       preloadFile ? fileLength_ : std::min(fileLength_, DIRECTORY_SIZE_GUESS);
   DWIO_ENSURE_GE(readSize, 4, "File size too small");
 
-  input_->enqueue({fileLength_ - readSize, readSize});
-  input_->load(preloadFile ? LogType::FILE : LogType::FOOTER);
+  std::optional<dwio::common::FileMetadataKey> cacheKey;
+  if (fileId.has_value()) {
+    cacheKey = {fileId.value(), fileLength_, fileFormat};
+    tail_ =
+        dwio::common::FileMetadataCache::instance().find<FileTail>(*cacheKey);
+  }
+  if (tail_) {
+    // The small files are still loaded whole, the stripes are read from the
+    // same buffer.
+    if (preloadFile) {
+      input_->enqueue({0, fileLength_});
+      input_->load(LogType::FILE);
+    }
+  } else {
+    input_->enqueue({fileLength_ - readSize, readSize});
+    input_->load(preloadFile ? LogType::FILE : LogType::FOOTER);
+    auto tail = readFileTail(fileFormat, readSize);
+    if (cacheKey.has_value()) {
+      const auto bytes = tail->arena->SpaceUsed() + tail->psLength;
+      dwio::common::FileMetadataCache::instance().insert(
+          *cacheKey, tail, bytes);
+    }
+    tail_ = std::move(tail);
+  }
+  postScript_ = tail_->postScript.get();
+  footer_ = tail_->footer.get();
+  schema_ = tail_->schema;
+  psLength_ = tail_->psLength;
+
+  const uint64_t footerSize = postScript_->footerLength();
+  const uint64_t cacheSize =
+      postScript_->hasCacheSize() ? postScript_->cacheSize() : 0;
+  const uint64_t tailSize = 1 + psLength_ + footerSize + cacheSize;
+
+  // load stripe index/footer cache
+  if (cacheSize > 0) {
+    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
+    if (input_->shouldPrefetchStripes()) {
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(),
+          *footer_,
+          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
+      input_->load(LogType::FOOTER);
+    } else {
+      auto cacheBuffer =
+          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
+          ->readFully(cacheBuffer->data(), cacheSize);
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
+    }
+  }
+  if (!cache_ && input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripesSize();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
+           stripe.footerLength()});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+std::shared_ptr<FileTail> ReaderBase::readFileTail(
+    FileFormat fileFormat,
+    uint64_t readSize) {
+  auto tail = std::make_shared<FileTail>();
+  tail->arena = std::make_unique<google::protobuf::Arena>();
 
   // TODO: read footer from spectrum
   {
@@ -110,27 +184,28 @@ ReaderBase::ReaderBase(
     auto lastByteStream = input_->read(fileLength_ - 1, 1, LogType::FOOTER);
     DWIO_ENSURE(lastByteStream->Next(&buf, &ignored), "failed to read");
     // Make sure 'lastByteStream' is live while dereferencing 'buf'.
-    psLength_ = *static_cast<const char*>(buf) & 0xff;
+    tail->psLength = *static_cast<const char*>(buf) & 0xff;
   }
+  const auto psLength = tail->psLength;
   DWIO_ENSURE_LE(
-      psLength_ + 4, // 1 byte for post script len, 3 byte "ORC" header.
+      psLength + 4, // 1 byte for post script len, 3 byte "ORC" header.
       fileLength_,
       "Corrupted file, Post script size is invalid");
 
   if (fileFormat == FileFormat::DWRF) {
     auto postScript = ProtoUtils::readProto<proto::PostScript>(
-        input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(std::move(postScript));
+        input_->read(fileLength_ - psLength - 1, psLength, LogType::FOOTER));
+    tail->postScript = std::make_unique<PostScript>(std::move(postScript));
   } else {
     auto postScript = ProtoUtils::readProto<proto::orc::PostScript>(
-        input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(std::move(postScript));
+        input_->read(fileLength_ - psLength - 1, psLength, LogType::FOOTER));
+    tail->postScript = std::make_unique<PostScript>(std::move(postScript));
   }
+  const auto& postScript = *tail->postScript;
 
-  uint64_t footerSize = postScript_->footerLength();
-  uint64_t cacheSize =
-      postScript_->hasCacheSize() ? postScript_->cacheSize() : 0;
-  uint64_t tailSize = 1 + psLength_ + footerSize + cacheSize;
+  uint64_t footerSize = postScript.footerLength();
+  uint64_t cacheSize = postScript.hasCacheSize() ? postScript.cacheSize() : 0;
+  uint64_t tailSize = 1 + psLength + footerSize + cacheSize;
 
   // There are cases in warehouse, where RC/text files are stored
   // in ORC partition. This causes the Reader to SIGSEGV. The following
@@ -142,70 +217,42 @@ ReaderBase::ReaderBase(
   DWIO_ENSURE_LE(tailSize, fileLength_, "Corrupted file, tail size is invalid");
 
   DWIO_ENSURE(
-      (format() == DwrfFormat::kDwrf)
-          ? proto::CompressionKind_IsValid(postScript_->compression())
-          : proto::orc::CompressionKind_IsValid(postScript_->compression()),
+      (postScript.format() == DwrfFormat::kDwrf)
+          ? proto::CompressionKind_IsValid(postScript.compression())
+          : proto::orc::CompressionKind_IsValid(postScript.compression()),
       "Corrupted File, invalid compression kind ",
-      postScript_->compression());
+      postScript.compression());
 
   if (tailSize > readSize) {
     input_->enqueue({fileLength_ - tailSize, tailSize});
     input_->load(LogType::FOOTER);
   }
 
+  // The footer is decompressed with the settings of the PostScript, which
+  // are read through 'postScript_'.
+  postScript_ = tail->postScript.get();
   auto footerStream = input_->read(
-      fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
+      fileLength_ - psLength - footerSize - 1, footerSize, LogType::FOOTER);
   if (fileFormat == FileFormat::DWRF) {
-    auto footer =
-        google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+    auto footer = google::protobuf::Arena::CreateMessage<proto::Footer>(
+        tail->arena.get());
     ProtoUtils::readProtoInto<proto::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
-    footer_ = std::make_unique<FooterWrapper>(footer);
+    tail->footer = std::make_unique<FooterWrapper>(footer);
   } else {
     auto footer = google::protobuf::Arena::CreateMessage<proto::orc::Footer>(
-        arena_.get());
+        tail->arena.get());
     ProtoUtils::readProtoInto<proto::orc::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
-    footer_ = std::make_unique<FooterWrapper>(footer);
+    tail->footer = std::make_unique<FooterWrapper>(footer);
   }
 
-  schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
-  DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
-
-  // load stripe index/footer cache
-  if (cacheSize > 0) {
-    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
-    if (input_->shouldPrefetchStripes()) {
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(),
-          *footer_,
-          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
-      input_->load(LogType::FOOTER);
-    } else {
-      auto cacheBuffer =
-          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
-      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
-          ->readFully(cacheBuffer->data(), cacheSize);
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
-    }
-  }
-  if (!cache_ && input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripesSize();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
-           stripe.footerLength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
-    }
-  }
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+  tail->schema =
+      std::dynamic_pointer_cast<const RowType>(convertType(*tail->footer));
+  DWIO_ENSURE_NOT_NULL(tail->schema, "invalid schema");
+  return tail;
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
@@ -59,6 +59,17 @@ class FooterStatisticsImpl : public dwio::common::Statistics {
   }
 };
 
+// The parsed PostScript and Footer of a file. Immutable. Shared by the
+// readers of a file through the FileMetadataCache.
+struct FileTail {
+  // Holds the Footer. nullptr if the Footer is owned elsewhere.
+  std::unique_ptr<google::protobuf::Arena> arena;
+  std::unique_ptr<PostScript> postScript;
+  std::unique_ptr<FooterWrapper> footer;
+  RowTypePtr schema;
+  uint64_t psLength{0};
+};
+
 class ReaderBase {
  public:
   // create reader base from buffered input
@@ -67,7 +78,8 @@ class ReaderBase {
       std::unique_ptr<dwio::common::BufferedInput> input,
       std::shared_ptr<dwio::common::encryption::DecrypterFactory>
           decryptorFactory = nullptr,
-      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF);
+      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF,
+      std::optional<uint64_t> fileId = std::nullopt);
 
   ReaderBase(
       memory::MemoryPool& pool,
@@ -83,15 +95,20 @@ class ReaderBase {
       std::unique_ptr<StripeMetadataCache> cache,
       std::unique_ptr<encryption::DecryptionHandler> handler = nullptr)
       : pool_{pool},
-        postScript_{std::move(ps)},
-        footer_{std::make_unique<FooterWrapper>(footer)},
         cache_{std::move(cache)},
         handler_{std::move(handler)},
         input_{std::move(input)},
-        schema_{
-            std::dynamic_pointer_cast<const RowType>(convertType(*footer_))},
         fileLength_{0},
         psLength_{0} {
+    auto tail = std::make_shared<FileTail>();
+    tail->postScript = std::move(ps);
+    tail->footer = std::make_unique<FooterWrapper>(footer);
+    tail->schema =
+        std::dynamic_pointer_cast<const RowType>(convertType(*tail->footer));
+    postScript_ = tail->postScript.get();
+    footer_ = tail->footer.get();
+    schema_ = tail->schema;
+    tail_ = std::move(tail);
     DWIO_ENSURE(footer_->getDwrfPtr()->GetArena());
     DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
     if (!handler_) {
@@ -144,6 +161,11 @@ class ReaderBase {
     return fileLength_;
   }
 
+  // The id given in ReaderOptions::setFileId(), if any.
+  const std::optional<uint64_t>& fileId() const {
+    return fileId_;
+  }
+
   std::vector<uint64_t> getRowsPerStripe() const;
 
   uint64_t getPostScriptLength() const {
@@ -225,10 +247,18 @@ class ReaderBase {
       const FooterWrapper& footer,
       uint32_t index = 0);
 
+  // Reads and parses the PostScript and Footer. The last 'readSize' bytes of
+  // the file are loaded in 'input_'.
+  std::shared_ptr<FileTail> readFileTail(
+      dwio::common::FileFormat fileFormat,
+      uint64_t readSize);
+
   memory::MemoryPool& pool_;
+  // Holds the stripe footers of 'this'. The file footer is in 'tail_'.
   std::unique_ptr<google::protobuf::Arena> arena_;
-  std::unique_ptr<PostScript> postScript_;
-  std::unique_ptr<FooterWrapper> footer_ = nullptr;
+  std::shared_ptr<const FileTail> tail_;
+  const PostScript* postScript_{nullptr};
+  const FooterWrapper* footer_{nullptr};
   std::unique_ptr<StripeMetadataCache> cache_;
   // Keeps factory alive for possibly async prefetch.
   std::shared_ptr<dwio::common::encryption::DecrypterFactory> decryptorFactory_;
@@ -240,6 +270,7 @@ class ReaderBase {
   mutable std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
   uint64_t fileLength_;
   uint64_t psLength_;
+  std::optional<uint64_t> fileId_;
 };
 
 } // namespace facebook::velox::dwrf
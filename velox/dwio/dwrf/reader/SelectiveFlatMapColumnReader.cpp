@@ -62,25 +62,51 @@ struct KeyNode {
   uint32_t sequence;
   std::unique_ptr<dwio::common::SelectiveColumnReader> reader;
   std::unique_ptr<BooleanRleDecoder> inMap;
+  // False if the key is read only for a filter on its value and is not in the
+  // result map.
+  bool projected;
 
   KeyNode(
       const dwio::common::flatmap::KeyValue<T>& key,
       uint32_t sequence,
       std::unique_ptr<dwio::common::SelectiveColumnReader> reader,
-      std::unique_ptr<BooleanRleDecoder> inMap)
+      std::unique_ptr<BooleanRleDecoder> inMap,
+      bool projected = true)
       : key(key),
         sequence(sequence),
         reader(std::move(reader)),
-        inMap(std::move(inMap)) {}
+        inMap(std::move(inMap)),
+        projected(projected) {}
 };
 
+// Returns true if a map row without the key of 'spec' passes the filters of
+// 'spec'. The value of the key is then null.
+bool missingKeyPasses(const common::ScanSpec& spec) {
+  if (!spec.filter()) {
+    return !spec.hasFilter();
+  }
+  for (auto& child : spec.children()) {
+    if (child->hasFilter()) {
+      return false;
+    }
+  }
+  return spec.filter()->testNull();
+}
+
+// Makes a KeyNode for each key of the flat map that is read. If 'asStruct' is
+// false and 'scanSpec' has subscript children of which one is projected out,
+// only the keys of the subscript children are read and the keys of the
+// children that are not projected out only have their filters applied. Sets
+// 'missingKeyFails' if a subscript child has a filter which fails on rows
+// without its key and the key is not in the stripe.
 template <typename T>
 std::vector<KeyNode<T>> getKeyNodes(
     const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
     const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
     DwrfParams& params,
     common::ScanSpec& scanSpec,
-    bool asStruct) {
+    bool asStruct,
+    bool* missingKeyFails = nullptr) {
   using namespace dwio::common::flatmap;
 
   std::vector<KeyNode<T>> keyNodes;
@@ -104,6 +130,30 @@ std::vector<KeyNode<T>> getKeyNodes(
     }
   }
 
+  // The specs of subscripts like c0['a'] keyed on the key as string.
+  std::unordered_map<std::string, common::ScanSpec*> subscriptSpecs;
+  bool pruneKeys = false;
+  if (!asStruct) {
+    for (auto& c : scanSpec.children()) {
+      if (c->isSubscript()) {
+        subscriptSpecs[c->fieldName()] = c.get();
+        pruneKeys |= c->projectOut();
+      }
+    }
+  }
+  auto addElementFields = [&](common::ScanSpec* childSpec) {
+    if (!elementsSpec) {
+      return;
+    }
+    for (auto& elementsChild : elementsSpec->children()) {
+      auto c = childSpec->getOrCreateChild(
+          common::Subfield(elementsChild->fieldName()));
+      c->setProjectOut(true);
+      c->setExtractValues(true);
+      c->setChannel(elementsChild->channel());
+    }
+  };
+
   std::unordered_map<KeyValue<T>, common::ScanSpec*, KeyValueHash<T>>
       childSpecs;
   if (asStruct) {
@@ -133,25 +183,30 @@ std::vector<KeyNode<T>> getKeyNodes(
           return;
         }
         common::ScanSpec* childSpec;
+        bool projected = true;
         if (auto it = childSpecs.find(key); it != childSpecs.end()) {
           childSpec = it->second;
         } else if (asStruct) {
           // Column not selected in 'scanSpec', skipping it.
           return;
+        } else if (auto subscriptIt = subscriptSpecs.find(toString(key.get()));
+                   subscriptIt != subscriptSpecs.end()) {
+          childSpec = subscriptIt->second;
+          subscriptSpecs.erase(subscriptIt);
+          projected = !pruneKeys || childSpec->projectOut();
+          childSpec->setExtractValues(projected);
+          if (projected) {
+            addElementFields(childSpec);
+          }
+        } else if (pruneKeys) {
+          // Key not selected by a subscript, skipping it.
+          return;
         } else {
           childSpec =
               scanSpec.getOrCreateChild(common::Subfield(toString(key.get())));
           childSpec->setProjectOut(true);
           childSpec->setExtractValues(true);
-          if (elementsSpec) {
-            for (auto& elementsChild : elementsSpec->children()) {
-              auto c = childSpec->getOrCreateChild(
-                  common::Subfield(elementsChild->fieldName()));
-              c->setProjectOut(true);
-              c->setExtractValues(true);
-              c->setChannel(elementsChild->channel());
-            }
-          }
+          addElementFields(childSpec);
           childSpecs[key] = childSpec;
         }
         auto inMap =
@@ -163,10 +218,24 @@ std::vector<KeyNode<T>> getKeyNodes(
         auto reader = SelectiveDwrfReader::build(
             requestedValueType, dataValueType, childParams, *childSpec);
         keyNodes.emplace_back(
-            key, sequence, std::move(reader), std::move(inMapDecoder));
+            key,
+            sequence,
+            std::move(reader),
+            std::move(inMapDecoder),
+            projected);
         processed.insert(sequence);
       });
 
+  // The subscripts left have keys which are not in the stripe.
+  if (missingKeyFails) {
+    *missingKeyFails = false;
+    for (auto& [_, spec] : subscriptSpecs) {
+      if (!missingKeyPasses(*spec)) {
+        *missingKeyFails = true;
+      }
+    }
+  }
+
   VLOG(1) << "[Flat-Map] Initialized a flat-map column reader for node "
           << dataType->id << ", keys=" << keyNodes.size()
           << ", streams=" << streams;
@@ -220,16 +289,23 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
         // Copy the scan spec because we need to remove the children.
         structScanSpec_(scanSpec) {
     scanSpec_ = &structScanSpec_;
-    keyNodes_ =
-        getKeyNodes<T>(requestedType, dataType, params, structScanSpec_, false);
+    keyNodes_ = getKeyNodes<T>(
+        requestedType,
+        dataType,
+        params,
+        structScanSpec_,
+        false,
+        &missingKeyFails_);
     std::sort(keyNodes_.begin(), keyNodes_.end(), [](auto& x, auto& y) {
       return x.sequence < y.sequence;
     });
     childValues_.resize(keyNodes_.size());
     copyRanges_.resize(keyNodes_.size());
     children_.resize(keyNodes_.size());
+    hasKeyFilters_ = missingKeyFails_;
     for (int i = 0; i < keyNodes_.size(); ++i) {
       children_[i] = keyNodes_[i].reader.get();
+      hasKeyFilters_ |= children_[i]->scanSpec()->hasFilter();
     }
     if (auto type = requestedType_->type->childAt(1); type->isRow()) {
       for (auto& vec : childValues_) {
@@ -248,19 +324,45 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
     prepareRead<char>(offset, rows, incomingNulls);
     auto* mapNulls =
         nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+    // The keys with filters are read first. The other keys are read for the
+    // rows that pass.
+    RowSet activeRows = rows;
+    if (hasKeyFilters_) {
+      if (missingKeyFails_) {
+        activeRows = RowSet();
+      }
+      for (auto* reader : children_) {
+        if (activeRows.empty()) {
+          break;
+        }
+        if (reader->scanSpec()->hasFilter()) {
+          advanceFieldReader(reader, offset);
+          reader->read(offset, activeRows, mapNulls);
+          activeRows = reader->outputRows();
+        }
+      }
+    }
     for (auto* reader : children_) {
-      advanceFieldReader(reader, offset);
-      reader->read(offset, rows, mapNulls);
+      if (!activeRows.empty() &&
+          !(hasKeyFilters_ && reader->scanSpec()->hasFilter())) {
+        advanceFieldReader(reader, offset);
+        reader->read(offset, activeRows, mapNulls);
+      }
       reader->addParentNulls(offset, mapNulls, rows);
     }
+    if (hasKeyFilters_) {
+      setOutputRows(activeRows);
+    }
     lazyVectorReadOffset_ = offset;
     readOffset_ = offset + rows.back() + 1;
   }
 
   void getValues(RowSet rows, VectorPtr* result) override {
     for (int k = 0; k < children_.size(); ++k) {
-      children_[k]->getValues(rows, &childValues_[k]);
       copyRanges_[k].clear();
+      if (keyNodes_[k].projected) {
+        children_[k]->getValues(rows, &childValues_[k]);
+      }
     }
     auto offsets =
         AlignedBuffer::allocate<vector_size_t>(rows.size(), &memoryPool_);
@@ -275,6 +377,9 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
       }
       int currentRowSize = 0;
       for (int k = 0; k < children_.size(); ++k) {
+        if (!keyNodes_[k].projected) {
+          continue;
+        }
         auto& data = static_cast<const DwrfData&>(children_[k]->formatData());
         auto* inMap = data.inMap();
         if (inMap && bits::isBitNull(inMap, rows[i])) {
@@ -311,7 +416,7 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
     if constexpr (std::is_same_v<T, StringView>) {
       strKeySize = 0;
       for (int k = 0; k < children_.size(); ++k) {
-        if (!keyNodes_[k].key.get().isInline()) {
+        if (keyNodes_[k].projected && !keyNodes_[k].key.get().isInline()) {
           strKeySize += keyNodes_[k].key.get().size();
         }
       }
@@ -322,7 +427,7 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
         strKeySize = 0;
         for (int k = 0; k < children_.size(); ++k) {
           auto& s = keyNodes_[k].key.get();
-          if (!s.isInline()) {
+          if (keyNodes_[k].projected && !s.isInline()) {
             memcpy(&rawStrKeyBuffer[strKeySize], s.data(), s.size());
             strKeySize += s.size();
           }
@@ -331,6 +436,9 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
       }
     }
     for (int k = 0; k < children_.size(); ++k) {
+      if (!keyNodes_[k].projected) {
+        continue;
+      }
       [[maybe_unused]] StringView strKey;
       if constexpr (std::is_same_v<T, StringView>) {
         strKey = keyNodes_[k].key.get();
@@ -362,6 +470,12 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
  private:
   common::ScanSpec structScanSpec_;
   std::vector<KeyNode<T>> keyNodes_;
+  // True if a subscript filter fails on all rows because its key is not in
+  // the stripe.
+  bool missingKeyFails_{false};
+  // True if some keys have filters. The other keys are read for the rows that
+  // pass these.
+  bool hasKeyFilters_{false};
   std::vector<VectorPtr> childValues_;
   std::vector<std::vector<BaseVector::CopyRange>> copyRanges_;
 };
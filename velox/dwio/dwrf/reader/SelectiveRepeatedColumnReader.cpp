@@ -92,6 +92,15 @@ SelectiveMapColumnReader::SelectiveMapColumnReader(
   scanSpec_->children()[0]->setExtractValues(true);
   scanSpec_->children()[1]->setProjectOut(true);
   scanSpec_->children()[1]->setExtractValues(true);
+  // Projected subscripts only prune flat maps, this reads all keys. Filters on
+  // subscripts are applied only by flat map readers.
+  for (auto& child : scanSpec_->children()) {
+    if (child->isSubscript() && child->hasFilter()) {
+      VELOX_UNSUPPORTED(
+          "Filter on map subscript {} requires a flat map column",
+          child->fieldName());
+    }
+  }
 
   const auto& cs = stripe.getColumnSelector();
   auto& keyType = requestedType_->childAt(0);
@@ -28,9 +28,11 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
     common::ScanSpec& scanSpec)
     : SelectiveColumnReader(nodeType, params, scanSpec, nodeType->type),
       lastStrideIndex_(-1),
-      provider_(params.stripeStreams().getStrideIndexProvider()) {
+      provider_(params.stripeStreams().getStrideIndexProvider()),
+      dictionaryCache_(params.stripeStreams().getStripeDictionaryCache()),
+      encodingKey_{nodeType_->id, params.flatMapContext().sequence} {
   auto& stripe = params.stripeStreams();
-  EncodingKey encodingKey{nodeType_->id, params.flatMapContext().sequence};
+  const auto& encodingKey = encodingKey_;
   RleVersion rleVersion =
       convertRleVersion(stripe.getEncoding(encodingKey).kind());
   scanState_.dictionary.numValues =
@@ -96,10 +98,11 @@ uint64_t SelectiveStringDictionaryColumnReader::skip(uint64_t numValues) {
 void SelectiveStringDictionaryColumnReader::loadDictionary(
     SeekableInputStream& data,
     IntDecoder</*isSigned*/ false>& lengthDecoder,
-    DictionaryValues& values) {
+    DictionaryValues& values,
+    memory::MemoryPool& pool) {
   // read lengths from length reader
   dwio::common::ensureCapacity<StringView>(
-      values.values, values.numValues, &memoryPool_);
+      values.values, values.numValues, &pool);
   // The lengths are read in the low addresses of the string views array.
   int64_t* int64Values = values.values->asMutable<int64_t>();
   lengthDecoder.next(int64Values, values.numValues, nullptr);
@@ -108,7 +111,7 @@ void SelectiveStringDictionaryColumnReader::loadDictionary(
     stringsBytes += int64Values[i];
   }
   // read bytes from underlying string
-  values.strings = AlignedBuffer::allocate<char>(stringsBytes, &memoryPool_);
+  values.strings = AlignedBuffer::allocate<char>(stringsBytes, &pool);
   data.readFully(values.strings->asMutable<char>(), stringsBytes);
   // fill the values with StringViews over the strings. 'strings' will
   // exist even if 'stringsBytes' is 0, which can happen if the only
@@ -143,7 +146,10 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
     strideDictLengthDecoder_->seekToRowGroup(pp);
 
     loadDictionary(
-        *strideDictStream_, *strideDictLengthDecoder_, scanState_.dictionary2);
+        *strideDictStream_,
+        *strideDictLengthDecoder_,
+        scanState_.dictionary2,
+        memoryPool_);
   }
   lastStrideIndex_ = nextStride;
   dictionaryValues_ = nullptr;
@@ -151,10 +157,27 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
   scanState_.filterCache.resize(
       scanState_.dictionary.numValues + scanState_.dictionary2.numValues);
   scanState_.updateRawState();
-  simd::memset(
-      scanState_.filterCache.data() + scanState_.dictionary.numValues,
-      FilterResult::kUnknown,
-      scanState_.dictionary2.numValues);
+  initFilterCache(scanState_.dictionary2, scanState_.dictionary.numValues);
+}
+
+void SelectiveStringDictionaryColumnReader::initFilterCache(
+    const DictionaryValues& values,
+    int32_t offset) {
+  auto cache = scanState_.filterCache.data() + offset;
+  auto* filter = scanSpec_->filter();
+  if (!filter || values.numValues == 0 ||
+      (filter->kind() != common::FilterKind::kBytesRange &&
+       filter->kind() != common::FilterKind::kBytesValues)) {
+    simd::memset(cache, FilterResult::kUnknown, values.numValues);
+    return;
+  }
+  std::vector<uint64_t> passed(bits::nwords(values.numValues));
+  filter->testStringViews(
+      values.values->as<StringView>(), values.numValues, passed.data());
+  for (auto i = 0; i < values.numValues; ++i) {
+    cache[i] = bits::isBitSet(passed.data(), i) ? FilterResult::kSuccess
+                                                : FilterResult::kFailure;
+  }
 }
 
 void SelectiveStringDictionaryColumnReader::makeDictionaryBaseVector() {
@@ -285,13 +308,23 @@ void SelectiveStringDictionaryColumnReader::ensureInitialized() {
 
   Timer timer;
 
-  loadDictionary(*blobStream_, *lengthDecoder_, scanState_.dictionary);
+  if (dictionaryCache_) {
+    auto buffers = dictionaryCache_->getSharedDictionary(
+        encodingKey_, 0, [&](memory::MemoryPool* pool) {
+          loadDictionary(
+              *blobStream_, *lengthDecoder_, scanState_.dictionary, *pool);
+          return std::vector<BufferPtr>{
+              scanState_.dictionary.values, scanState_.dictionary.strings};
+        });
+    scanState_.dictionary.values = buffers[0];
+    scanState_.dictionary.strings = buffers[1];
+  } else {
+    loadDictionary(
+        *blobStream_, *lengthDecoder_, scanState_.dictionary, memoryPool_);
+  }
 
   scanState_.filterCache.resize(scanState_.dictionary.numValues);
-  simd::memset(
-      scanState_.filterCache.data(),
-      FilterResult::kUnknown,
-      scanState_.dictionary.numValues);
+  initFilterCache(scanState_.dictionary, 0);
 
   // handle in dictionary stream
   if (inDictionaryReader_) {
@@ -73,12 +73,21 @@ class SelectiveStringDictionaryColumnReader
       RowSet rows,
       ExtractValues extractValues);
 
-  // Fills 'values' from 'data' and 'lengthDecoder'. The count of
-  // values is in 'values.numValues'.
+  // Fills 'values' from 'data' and 'lengthDecoder' with buffers from 'pool'.
+  // The count of values is in 'values.numValues'.
   void loadDictionary(
       dwio::common::SeekableInputStream& data,
       dwio::common::IntDecoder</*isSigned*/ false>& lengthDecoder,
-      dwio::common::DictionaryValues& values);
+      dwio::common::DictionaryValues& values,
+      memory::MemoryPool& pool);
+
+  // Initializes the filter cache entries of 'values' starting at 'offset'.
+  // For a string range or IN-list filter, all 'values' are tested at once.
+  // Otherwise the entries are decided when first referenced.
+  void initFilterCache(
+      const dwio::common::DictionaryValues& values,
+      int32_t offset);
+
   void ensureInitialized();
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ false>> dictIndex_;
   std::unique_ptr<ByteRleDecoder> inDictionaryReader_;
@@ -94,6 +103,11 @@ class SelectiveStringDictionaryColumnReader
 
   const StrideIndexProvider& provider_;
 
+  // The stripe dictionary may come from the readers of the same stripe in
+  // other queries.
+  std::shared_ptr<StripeDictionaryCache> dictionaryCache_;
+  const EncodingKey encodingKey_;
+
   // lazy load the dictionary
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ false>> lengthDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> blobStream_;
@@ -18,6 +18,13 @@
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/dwrf/common/DecoderUtil.h"
 
+#include <gflags/gflags.h>
+
+DEFINE_bool(
+    dwrf_reference_cached_strings,
+    true,
+    "Let strings read from uncompressed DWRF streams in the data cache refer to the pinned cache entries instead of copying them");
+
 namespace facebook::velox::dwrf {
 
 SelectiveStringDirectColumnReader::SelectiveStringDirectColumnReader(
@@ -39,6 +46,25 @@ SelectiveStringDirectColumnReader::SelectiveStringDirectColumnReader(
       dwio::common::INT_BYTE_SIZE);
   blobStream_ =
       stripe.getStream(encodingKey.forKind(proto::Stream_Kind_DATA), true);
+  mayUseStreamBuffer_ = FLAGS_dwrf_reference_cached_strings;
+}
+
+bool SelectiveStringDirectColumnReader::pinStreamBuffer() {
+  if (!mayUseStreamBuffer_ || !bufferStart_) {
+    return false;
+  }
+  if (bufferEnd_ != streamBufferEnd_) {
+    // 'bufferStart_' and 'bufferEnd_' are from the last Next() of the stream.
+    streamBuffer_ = blobStream_->pinnedBuffer();
+    streamBufferEnd_ = bufferEnd_;
+  }
+  if (!streamBuffer_) {
+    return false;
+  }
+  if (streamBuffers_.empty() || streamBuffers_.back() != streamBuffer_) {
+    streamBuffers_.push_back(streamBuffer_);
+  }
+  return true;
 }
 
 uint64_t SelectiveStringDirectColumnReader::skip(uint64_t numValues) {
@@ -75,9 +101,10 @@ void SelectiveStringDirectColumnReader::extractCrossBuffers(
         reinterpret_cast<StringView*>(rawValues_)[index] =
             StringView(value.data(), size);
       } else {
-        auto copy = copyStringValue(value);
+        auto data = inPinnedStreamBuffer(value) ? value.data()
+                                                : copyStringValue(value);
         reinterpret_cast<StringView*>(rawValues_)[index] =
-            StringView(copy, size);
+            StringView(data, size);
       }
     }
   }
@@ -177,6 +204,12 @@ inline bool SelectiveStringDirectColumnReader::try8Consecutive(
           reinterpret_cast<char*>(result + resultIndex + 1) + length) = 0;
       continue;
     }
+    if (pinStreamBuffer()) {
+      // The stream buffer outlives the result, so the value is not copied.
+      *reinterpret_cast<const char**>(result + resultIndex + 2) = data;
+      data += length;
+      continue;
+    }
     if (!rawStringBuffer_ || rawUsed + length > rawStringSize_) {
       // Slow path if no space in raw strings
       return false;
@@ -234,6 +267,22 @@ void SelectiveStringDirectColumnReader::extractSparse(
       });
 }
 
+void SelectiveStringDirectColumnReader::filterExtracted(
+    RowSet rows,
+    const common::Filter& filter,
+    bool keepValues) {
+  VELOX_DCHECK_EQ(numValues_, rows.size());
+  auto values = reinterpret_cast<StringView*>(rawValues_);
+  passed_.resize(bits::nwords(rows.size()));
+  filter.testStringViews(values, rows.size(), passed_.data());
+  int32_t numPassed = 0;
+  bits::forEachSetBit(passed_.data(), 0, rows.size(), [&](int32_t i) {
+    addOutputRow(rows[i]);
+    values[numPassed++] = values[i];
+  });
+  numValues_ = keepValues ? numPassed : 0;
+}
+
 template <bool hasNulls>
 void SelectiveStringDirectColumnReader::skipInDecode(
     int32_t numValues,
@@ -319,8 +368,27 @@ void SelectiveStringDirectColumnReader::readWithVisitor(
       std::is_same_v<
           typename TVisitor::Extract,
           dwio::common::ExtractToReader<SelectiveStringDirectColumnReader>>;
+  // String ranges and IN-lists are evaluated on the extracted StringViews
+  // in a batch, so that most values are decided by their length and prefix.
+  constexpr bool isBatchFilter =
+      (std::is_same_v<typename TVisitor::FilterType, common::BytesRange> ||
+       std::is_same_v<typename TVisitor::FilterType, common::BytesValues>) &&
+      (std::is_same_v<typename TVisitor::Extract, dwio::common::DropValues> ||
+       std::is_same_v<
+           typename TVisitor::Extract,
+           dwio::common::ExtractToReader<SelectiveStringDirectColumnReader>>);
   auto nulls = nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
 
+  if (process::hasAvx2() && isBatchFilter && !nullsInReadRange_) {
+    extractSparse(rows.data(), rows.size());
+    filterExtracted(
+        rows,
+        visitor.filter(),
+        !std::is_same_v<typename TVisitor::Extract, dwio::common::DropValues>);
+    readOffset_ += numRows;
+    return;
+  }
+
   if (process::hasAvx2() && isExtract) {
     if (nullsInReadRange_) {
       if (TVisitor::dense) {
@@ -420,6 +488,7 @@ void SelectiveStringDirectColumnReader::read(
     RowSet rows,
     const uint64_t* incomingNulls) {
   prepareRead<folly::StringPiece>(offset, rows, incomingNulls);
+  streamBuffers_.clear();
   bool isDense = rows.back() == rows.size() - 1;
 
   auto end = rows.back() + 1;
@@ -51,10 +51,39 @@ class SelectiveStringDirectColumnReader
     rawStringBuffer_ = nullptr;
     rawStringSize_ = 0;
     rawStringUsed_ = 0;
+    // The stream buffers go first, so that the last string buffer stays the
+    // writable one.
+    stringBuffers_.insert(
+        stringBuffers_.begin(),
+        std::make_move_iterator(streamBuffers_.begin()),
+        std::make_move_iterator(streamBuffers_.end()));
+    streamBuffers_.clear();
     getFlatValues<StringView, StringView>(rows, result, type_);
   }
 
+  // Adds 'value' to the values of 'this'. A value longer than the inline size
+  // of StringView that is in a pinned stream buffer is referenced in place.
+  void addValue(folly::StringPiece value) {
+    if (value.size() > StringView::kInlineSize &&
+        inPinnedStreamBuffer(value)) {
+      reinterpret_cast<StringView*>(rawValues_)[numValues_++] =
+          StringView(value.data(), value.size());
+      return;
+    }
+    SelectiveColumnReader::addValue(value);
+  }
+
  private:
+  // Returns true if the bytes between 'bufferStart_' and 'bufferEnd_' stay
+  // valid after 'blobStream_' moves on, so that values can refer to them in
+  // place. If so, makes the result of the next getValues() hold the bytes.
+  bool pinStreamBuffer();
+
+  bool inPinnedStreamBuffer(folly::StringPiece value) {
+    return value.begin() >= bufferStart_ && value.end() <= bufferEnd_ &&
+        pinStreamBuffer();
+  }
+
   template <bool hasNulls>
   void skipInDecode(int32_t numValues, int32_t current, const uint64_t* nulls);
 
@@ -94,6 +123,13 @@ class SelectiveStringDirectColumnReader
   template <bool scatter, bool skip>
   bool try8Consecutive(int32_t start, const int32_t* rows, int32_t row);
 
+  // Tests the values extracted for 'rows' with 'filter' in a batch and keeps
+  // the passing rows and, if 'keepValues', their values.
+  void filterExtracted(
+      RowSet rows,
+      const common::Filter& filter,
+      bool keepValues);
+
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ false>> lengthDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> blobStream_;
   const char* bufferStart_ = nullptr;
@@ -105,6 +141,16 @@ class SelectiveStringDirectColumnReader
   // Storage for a string straddling a buffer boundary. Needed for calling
   // the filter.
   std::string tempString_;
+
+  // The pinned buffer of 'blobStream_' covering 'bufferEnd_' when
+  // 'bufferEnd_' was 'streamBufferEnd_'. nullptr if the stream's buffers are
+  // not pinned.
+  BufferPtr streamBuffer_;
+  const char* streamBufferEnd_{nullptr};
+  // The stream buffers referenced by the values since the last getValues().
+  std::vector<BufferPtr> streamBuffers_;
+  // Bits of the values passing the filter in filterExtracted().
+  std::vector<uint64_t> passed_;
 };
 
 } // namespace facebook::velox::dwrf
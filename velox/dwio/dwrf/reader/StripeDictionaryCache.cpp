@@ -16,15 +16,77 @@
 
 #include "velox/dwio/dwrf/reader/StripeDictionaryCache.h"
 
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    dwrf_dictionary_cache_mb,
+    128,
+    "Size of the process wide cache of decoded DWRF stripe dictionaries, "
+    "shared by the readers of files with a file id. 0 disables it.");
+
 namespace facebook::velox::dwrf {
+
+SharedDictionaryCache::SharedDictionaryCache(int64_t maxBytes)
+    : maxBytes_{maxBytes},
+      pool_{memory::getDefaultMemoryPool()},
+      cache_(maxBytes) {}
+
+// static
+SharedDictionaryCache& SharedDictionaryCache::instance() {
+  static SharedDictionaryCache cache(
+      static_cast<int64_t>(FLAGS_dwrf_dictionary_cache_mb) << 20);
+  return cache;
+}
+
+std::vector<BufferPtr> SharedDictionaryCache::find(
+    const SharedDictionaryKey& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* entry = cache_.get(key);
+  if (!entry) {
+    return {};
+  }
+  // The readers hold references to the buffers, so the entry does not stay
+  // pinned.
+  auto buffers = entry->buffers;
+  cache_.release(key);
+  return buffers;
+}
+
+void SharedDictionaryCache::insert(
+    const SharedDictionaryKey& key,
+    std::vector<BufferPtr> buffers) {
+  int64_t bytes = 0;
+  for (auto& buffer : buffers) {
+    bytes += buffer ? buffer->capacity() : 0;
+  }
+  auto entry = std::make_unique<Entry>(Entry{std::move(buffers)});
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cache_.add(key, entry.get(), bytes)) {
+    entry.release();
+  }
+}
+
 StripeDictionaryCache::DictionaryEntry::DictionaryEntry(
-    folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen)
-    : dictGen_{std::move(dictGen)} {}
+    folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen,
+    int32_t valueWidth)
+    : dictGen_{std::move(dictGen)}, valueWidth_{valueWidth} {}
 
 BufferPtr StripeDictionaryCache::DictionaryEntry::getDictionaryBuffer(
-    velox::memory::MemoryPool* pool) {
+    velox::memory::MemoryPool* pool,
+    const std::optional<SharedDictionaryKey>& sharedKey) {
   if (!dictionaryBuffer_) {
-    dictionaryBuffer_ = dictGen_(pool);
+    if (sharedKey.has_value()) {
+      auto& cache = SharedDictionaryCache::instance();
+      auto buffers = cache.find(*sharedKey);
+      if (buffers.empty()) {
+        dictionaryBuffer_ = dictGen_(&cache.pool());
+        cache.insert(*sharedKey, {dictionaryBuffer_});
+      } else {
+        dictionaryBuffer_ = buffers[0];
+      }
+    } else {
+      dictionaryBuffer_ = dictGen_(pool);
+    }
     dictGen_ = nullptr;
   }
   return dictionaryBuffer_;
@@ -36,13 +98,54 @@ StripeDictionaryCache::StripeDictionaryCache(velox::memory::MemoryPool* pool)
 // It might be more elegant to pass in a StripeStream here instead.
 void StripeDictionaryCache::registerIntDictionary(
     const EncodingKey& ek,
-    folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen) {
+    folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen,
+    int32_t valueWidth) {
   intDictionaryFactories_.emplace(
-      ek, std::make_unique<DictionaryEntry>(std::move(dictGen)));
+      ek, std::make_unique<DictionaryEntry>(std::move(dictGen), valueWidth));
 }
 
 BufferPtr StripeDictionaryCache::getIntDictionary(const EncodingKey& ek) {
-  return intDictionaryFactories_.at(ek)->getDictionaryBuffer(pool_);
+  auto& entry = *intDictionaryFactories_.at(ek);
+  return entry.getDictionaryBuffer(pool_, sharedKey(ek, entry.valueWidth()));
+}
+
+void StripeDictionaryCache::setFileStripe(
+    uint64_t fileId,
+    uint64_t fileSize,
+    uint32_t stripe) {
+  if (!SharedDictionaryCache::instance().enabled()) {
+    return;
+  }
+  fileId_ = fileId;
+  fileSize_ = fileSize;
+  stripe_ = stripe;
+}
+
+std::vector<BufferPtr> StripeDictionaryCache::getSharedDictionary(
+    const EncodingKey& ek,
+    int32_t valueWidth,
+    const std::function<std::vector<BufferPtr>(memory::MemoryPool*)>& load) {
+  auto key = sharedKey(ek, valueWidth);
+  if (!key.has_value()) {
+    return load(pool_);
+  }
+  auto& cache = SharedDictionaryCache::instance();
+  auto buffers = cache.find(*key);
+  if (buffers.empty()) {
+    buffers = load(&cache.pool());
+    cache.insert(*key, buffers);
+  }
+  return buffers;
+}
+
+std::optional<SharedDictionaryKey> StripeDictionaryCache::sharedKey(
+    const EncodingKey& ek,
+    int32_t valueWidth) const {
+  if (!fileId_.has_value()) {
+    return std::nullopt;
+  }
+  return SharedDictionaryKey{
+      fileId_.value(), fileSize_, stripe_, ek, valueWidth};
 }
 
 } // namespace facebook::velox::dwrf
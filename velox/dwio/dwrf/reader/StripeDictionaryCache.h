@@ -16,42 +16,159 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <folly/Function.h>
+#include <folly/hash/Hash.h>
 
 #include "velox/common/base/GTestMacros.h"
+#include "velox/common/caching/SimpleLRUCache.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/vector/BaseVector.h"
 
 namespace facebook::velox::dwrf {
+
+/// Identifies a decoded dictionary of a stripe. 'fileId' and 'fileSize' are
+/// as in dwio::common::FileMetadataKey. 'valueWidth' is the width of the
+/// values of an integer dictionary, which depends on the reader, or 0 for a
+/// string dictionary.
+struct SharedDictionaryKey {
+  uint64_t fileId;
+  uint64_t fileSize;
+  uint32_t stripe;
+  EncodingKey encodingKey;
+  int32_t valueWidth;
+
+  bool operator==(const SharedDictionaryKey& other) const {
+    return fileId == other.fileId && fileSize == other.fileSize &&
+        stripe == other.stripe && encodingKey == other.encodingKey &&
+        valueWidth == other.valueWidth;
+  }
+};
+
+struct SharedDictionaryKeyHasher {
+  size_t operator()(const SharedDictionaryKey& key) const {
+    return folly::hash::hash_combine(
+        key.fileId,
+        key.fileSize,
+        key.stripe,
+        key.encodingKey.hash(),
+        key.valueWidth);
+  }
+};
+
+/// Process wide LRU cache of decoded stripe dictionaries, so that the readers
+/// of a stripe in different queries decode its dictionaries once. The cached
+/// buffers are allocated from the pool of the cache and are read only. Thread
+/// safe.
+class SharedDictionaryCache {
+ public:
+  explicit SharedDictionaryCache(int64_t maxBytes);
+
+  /// Returns the cache with a capacity of --dwrf_dictionary_cache_mb.
+  static SharedDictionaryCache& instance();
+
+  /// Returns the buffers of the dictionary of 'key' or an empty vector if not
+  /// cached.
+  std::vector<BufferPtr> find(const SharedDictionaryKey& key);
+
+  /// Adds the buffers of a dictionary. Does nothing if 'key' is cached or the
+  /// buffers do not fit.
+  void insert(const SharedDictionaryKey& key, std::vector<BufferPtr> buffers);
+
+  /// The pool for the buffers of the cached dictionaries.
+  memory::MemoryPool& pool() {
+    return *pool_;
+  }
+
+  bool enabled() const {
+    return maxBytes_ > 0;
+  }
+
+  int64_t currentBytes() {
+    std::lock_guard<std::mutex> l(mutex_);
+    return cache_.currentSize();
+  }
+
+ private:
+  struct Entry {
+    std::vector<BufferPtr> buffers;
+  };
+
+  const int64_t maxBytes_;
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  std::mutex mutex_;
+  SimpleLRUCache<
+      SharedDictionaryKey,
+      Entry,
+      std::equal_to<SharedDictionaryKey>,
+      SharedDictionaryKeyHasher>
+      cache_;
+};
+
 class StripeDictionaryCache {
   // This could be potentially made an interface to be shared for
   // string dictionaries. However, we will need a union return type
   // in that case.
   class DictionaryEntry {
    public:
-    explicit DictionaryEntry(
-        folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen);
+    DictionaryEntry(
+        folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen,
+        int32_t valueWidth);
 
-    BufferPtr getDictionaryBuffer(velox::memory::MemoryPool* pool);
+    // Returns the dictionary made with 'pool'. If 'sharedKey' is set, the
+    // dictionary comes from SharedDictionaryCache.
+    BufferPtr getDictionaryBuffer(
+        velox::memory::MemoryPool* pool,
+        const std::optional<SharedDictionaryKey>& sharedKey);
+
+    int32_t valueWidth() const {
+      return valueWidth_;
+    }
 
    private:
     folly::Function<BufferPtr(velox::memory::MemoryPool*)> dictGen_;
+    const int32_t valueWidth_;
     BufferPtr dictionaryBuffer_;
   };
 
  public:
   explicit StripeDictionaryCache(velox::memory::MemoryPool* pool);
 
+  /// 'valueWidth' is the width of the values made by 'dictGen'.
   void registerIntDictionary(
       const EncodingKey& ek,
-      folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen);
+      folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen,
+      int32_t valueWidth = sizeof(int64_t));
 
   BufferPtr getIntDictionary(const EncodingKey& ek);
 
+  /// Makes the dictionaries of 'this' be shared through SharedDictionaryCache
+  /// with the readers of 'stripe' of the file with 'fileId' and 'fileSize'.
+  /// Does nothing if the shared cache is disabled.
+  void setFileStripe(uint64_t fileId, uint64_t fileSize, uint32_t stripe);
+
+  /// Returns the buffers of the dictionary of 'ek' from SharedDictionaryCache
+  /// or calls 'load' and caches the result. 'load' allocates the buffers from
+  /// the pool it is given, which is the pool of the shared cache or the
+  /// reader's pool if the dictionaries of 'this' are not shared.
+  std::vector<BufferPtr> getSharedDictionary(
+      const EncodingKey& ek,
+      int32_t valueWidth,
+      const std::function<std::vector<BufferPtr>(memory::MemoryPool*)>& load);
+
  private:
+  std::optional<SharedDictionaryKey> sharedKey(
+      const EncodingKey& ek,
+      int32_t valueWidth) const;
+
   // This is typically the reader's memory pool.
   memory::MemoryPool* pool_;
+  // Set if the dictionaries are shared with other readers of the stripe.
+  std::optional<uint64_t> fileId_;
+  uint64_t fileSize_{0};
+  uint32_t stripe_{0};
   std::unordered_map<
       EncodingKey,
       std::unique_ptr<DictionaryEntry>,
@@ -129,7 +129,8 @@ StripeStreamsBase::getIntDictionaryInitializerForNode(
        dictionarySize](velox::memory::MemoryPool* pool) mutable {
         return VELOX_WIDTH_DISPATCH(
             dictionaryWidth, readDict, dictReader.get(), dictionarySize, pool);
-      });
+      },
+      dictionaryWidth);
   return [&dictCache = *stripeDictionaryCache_, localEk]() {
     // If this is not flat map or if dictionary is not shared, return as is
     return dictCache.getIntDictionary(localEk);
@@ -238,6 +238,16 @@ class StripeStreamsImpl : public StripeStreamsBase {
         stripeIndex_{stripeIndex},
         readPlanLoaded_{false} {
     loadStreams();
+    // The decoded dictionaries of files with an id are shared with the
+    // readers of the same stripe. Decrypted values are not shared.
+    const auto& readerBase = reader_.getReader();
+    if (readerBase.fileId().has_value() &&
+        !readerBase.getDecryptionHandler().isEncrypted()) {
+      stripeDictionaryCache_->setFileStripe(
+          readerBase.fileId().value(),
+          readerBase.getFileLength(),
+          stripeIndex_);
+    }
   }
 
   ~StripeStreamsImpl() override = default;
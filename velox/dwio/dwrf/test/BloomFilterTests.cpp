@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+using namespace facebook::velox::dwrf;
+
+TEST(BloomFilterTests, sizing) {
+  // Same number of bits and hash functions as the ORC writers.
+  BloomFilter filter(10'000, 0.05);
+  EXPECT_EQ(filter.numBits(), 62400);
+  EXPECT_EQ(filter.numHashFunctions(), 4);
+
+  BloomFilter small(0, 0.05);
+  EXPECT_EQ(small.numBits(), 64);
+  EXPECT_EQ(small.numHashFunctions(), 44);
+}
+
+TEST(BloomFilterTests, longs) {
+  constexpr int32_t kNumValues = 10'000;
+  BloomFilter filter(kNumValues, 0.05);
+  for (int64_t i = 0; i < kNumValues; ++i) {
+    filter.addLong(i * 7);
+  }
+  for (int64_t i = 0; i < kNumValues; ++i) {
+    EXPECT_TRUE(filter.testLong(i * 7));
+  }
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < kNumValues; ++i) {
+    numFalsePositives += filter.testLong(-1 - i * 7);
+  }
+  EXPECT_LT(numFalsePositives, kNumValues / 10);
+
+  filter.reset();
+  EXPECT_FALSE(filter.testLong(7));
+}
+
+TEST(BloomFilterTests, strings) {
+  constexpr int32_t kNumValues = 1'000;
+  BloomFilter filter(kNumValues, 0.05);
+  std::vector<std::string> values;
+  for (auto i = 0; i < kNumValues; ++i) {
+    // Sizes cover the tail of the 8 byte blocks of the hash.
+    values.push_back(std::string(i % 20, 'x') + std::to_string(i));
+    filter.addBytes(values.back().data(), values.back().size());
+  }
+  for (auto& value : values) {
+    EXPECT_TRUE(filter.testBytes(value.data(), value.size()));
+  }
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < kNumValues; ++i) {
+    auto value = std::string(i % 20, 'y') + std::to_string(i);
+    numFalsePositives += filter.testBytes(value.data(), value.size());
+  }
+  EXPECT_LT(numFalsePositives, kNumValues / 10);
+}
+
+TEST(BloomFilterTests, serialize) {
+  BloomFilter filter(100, 0.01);
+  for (auto i = 0; i < 100; ++i) {
+    filter.addLong(i);
+  }
+  proto::BloomFilter proto;
+  filter.serialize(proto);
+  EXPECT_EQ(proto.bitset_size() * 64, filter.numBits());
+  EXPECT_EQ(proto.numhashfunctions(), filter.numHashFunctions());
+
+  BloomFilter copy(proto);
+  EXPECT_EQ(copy.numBits(), filter.numBits());
+  for (auto i = 0; i < 100; ++i) {
+    EXPECT_TRUE(copy.testLong(i));
+  }
+
+  // ORC writers put the same words as little endian bytes in 'utf8bitset'.
+  proto::BloomFilter utf8Proto;
+  utf8Proto.set_numhashfunctions(proto.numhashfunctions());
+  std::string bytes(proto.bitset_size() * sizeof(uint64_t), '\0');
+  for (auto i = 0; i < proto.bitset_size(); ++i) {
+    auto word = proto.bitset(i);
+    for (auto j = 0; j < sizeof(uint64_t); ++j) {
+      bytes[i * sizeof(uint64_t) + j] = static_cast<char>(word >> (j * 8));
+    }
+  }
+  utf8Proto.set_utf8bitset(bytes);
+  BloomFilter utf8Copy(utf8Proto);
+  for (auto i = 0; i < 100; ++i) {
+    EXPECT_TRUE(utf8Copy.testLong(i));
+  }
+}
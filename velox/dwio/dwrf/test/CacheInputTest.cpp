@@ -504,6 +504,47 @@ TEST_F(CacheTest, window) {
   EXPECT_FALSE(clone->Next(&buffer, &size));
 }
 
+TEST_F(CacheTest, pinnedBuffer) {
+  initializeCache(64 << 20);
+  uint64_t fileId;
+  uint64_t groupId;
+  auto file = inputByPath("test_for_pinned_buffer", fileId, groupId);
+  auto input = std::make_unique<CachedBufferedInput>(
+      file,
+      *pool_,
+      MetricsLog::voidLog(),
+      fileId,
+      cache_.get(),
+      nullptr,
+      groupId,
+      ioStats_,
+      executor_.get(),
+      dwio::common::ReaderOptions::kDefaultLoadQuantum,
+      512 << 10);
+  auto stream = input->read(1 << 20, 100'000, LogType::TEST);
+  const void* data;
+  int32_t size;
+  ASSERT_TRUE(stream->Next(&data, &size));
+  auto pinned = stream->pinnedBuffer();
+  ASSERT_TRUE(pinned != nullptr);
+  EXPECT_FALSE(pinned->isMutable());
+  auto start = reinterpret_cast<const char*>(data);
+  EXPECT_LE(pinned->as<char>(), start);
+  EXPECT_GE(pinned->as<char>() + pinned->size(), start + size);
+  // The next buffer of the same run is covered by the same view.
+  stream->BackUp(size / 2);
+  ASSERT_TRUE(stream->Next(&data, &size));
+  EXPECT_EQ(pinned, stream->pinnedBuffer());
+
+  // The bytes stay valid after the stream and the input are gone.
+  std::string expected(reinterpret_cast<const char*>(data), size);
+  stream.reset();
+  input.reset();
+  EXPECT_EQ(
+      expected,
+      std::string(reinterpret_cast<const char*>(data), expected.size()));
+}
+
 TEST_F(CacheTest, bufferedInput) {
   // Size 160 MB. Frequent evictions and not everything fits in prefetch window.
   initializeCache(160 << 20);
@@ -531,6 +572,14 @@ TEST_F(CacheTest, ssd) {
   EXPECT_EQ(0, ioStats_->ramHit().bytes());
   // Expect some extra reading from coalescing.
   EXPECT_LT(0, ioStats_->rawOverreadBytes());
+  // All the reads are attributed to the nodes of the streams.
+  auto columnIo = ioStats_->takeColumnIo();
+  EXPECT_EQ(30, columnIo.size());
+  for (const auto& [nodeId, io] : columnIo) {
+    EXPECT_LT(0, io[static_cast<int32_t>(ColumnIoKind::kStorageRead)]);
+    EXPECT_EQ(0, io[static_cast<int32_t>(ColumnIoKind::kRamHit)]);
+  }
+  EXPECT_TRUE(ioStats_->takeColumnIo().empty());
   auto fullStripeBytes = ioStats_->rawBytesRead();
   auto bytes = ioStats_->rawBytesRead();
   cache_->clear();
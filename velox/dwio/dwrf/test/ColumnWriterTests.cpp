@@ -4021,6 +4021,59 @@ TEST(ColumnWriterTests, StringColumnWriterAbandonLowValueDictionaries) {
   }
 }
 
+TEST(ColumnWriterTests, StringColumnWriterSampledEncoding) {
+  auto pool = getDefaultMemoryPool();
+  VectorMaker maker{pool.get()};
+  auto type = VARCHAR();
+  auto typeWithId = TypeWithId::create(type, 1);
+  auto config = std::make_shared<Config>();
+  config->set(Config::DICTIONARY_STRING_SAMPLE_ROWS, 100U);
+  constexpr size_t kSize = 1'000;
+
+  auto testEncoding = [&](int32_t numDistinct, bool dictionary) {
+    SCOPED_TRACE(numDistinct);
+    std::vector<std::string> data;
+    for (auto i = 0; i < kSize; ++i) {
+      data.push_back(fmt::format("value {}", i % numDistinct));
+    }
+    auto vector = maker.flatVector(data);
+    WriterContext context{config, getDefaultMemoryPool()};
+    auto writer = BaseColumnWriter::create(context, *typeWithId);
+    for (auto stripe = 0; stripe < 2; ++stripe) {
+      writer->write(vector, common::Ranges::of(0, kSize));
+      writer->createIndexEntry();
+      // The sample decides the encoding, the flush does not change it.
+      EXPECT_FALSE(writer->tryAbandonDictionaries(false));
+      proto::StripeFooter sf;
+      writer->flush([&sf](auto /* unused */) -> proto::ColumnEncoding& {
+        return *sf.add_encoding();
+      });
+      ASSERT_EQ(
+          dictionary ? proto::ColumnEncoding_Kind_DICTIONARY
+                     : proto::ColumnEncoding_Kind_DIRECT,
+          sf.encoding(0).kind());
+
+      TestStripeStreams streams(context, sf, ROW({"foo"}, {type}));
+      auto reqType = TypeWithId::create(ROW({"foo"}, {type}))->childAt(0);
+      auto reader = ColumnReader::build(reqType, reqType, streams);
+      if (dictionary) {
+        EXPECT_CALL(streams.getMockStrideIndexProvider(), getStrideIndex())
+            .WillRepeatedly(Return(0));
+      }
+      VectorPtr result;
+      reader->next(kSize, result);
+      for (auto i = 0; i < kSize; ++i) {
+        ASSERT_TRUE(vector->equalValueAt(result.get(), i, i));
+      }
+      context.nextStripe();
+      writer->reset();
+    }
+  };
+
+  testEncoding(kSize, false);
+  testEncoding(10, true);
+}
+
 TEST(ColumnWriterTests, IntDictWriterDirectValueOverflow) {
   auto config = std::make_shared<Config>();
   auto pool = getDefaultMemoryPool();
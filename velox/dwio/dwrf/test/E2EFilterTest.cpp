@@ -19,7 +19,9 @@
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
 #include "velox/dwio/dwrf/writer/FlushPolicy.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 
 using namespace facebook::velox::dwio::common;
@@ -89,6 +91,7 @@ class E2EFilterTest : public E2EFilterTestBase {
     if (!flatmapNodeIdsAsStruct_.empty()) {
       opts.setFlatmapNodeIdsAsStruct(flatmapNodeIdsAsStruct_);
     }
+    opts.setDecodingExecutor(decodingExecutor_);
   }
 
   std::unique_ptr<dwio::common::Reader> makeReader(
@@ -98,6 +101,7 @@ class E2EFilterTest : public E2EFilterTestBase {
   }
 
   std::unordered_set<std::string> flatMapColumns_;
+  std::shared_ptr<folly::Executor> decodingExecutor_;
 
  private:
   WriterOptions createWriterOptions(const TypePtr& type) {
@@ -266,6 +270,25 @@ TEST_F(E2EFilterTest, stringDictionary) {
       true);
 }
 
+TEST_F(E2EFilterTest, parallelDecoding) {
+  decodingExecutor_ = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "string_val_2:string",
+      [&]() {
+        makeStringDistribution("string_val", 100, true, false);
+        makeStringUnique("string_val_2");
+      },
+      false,
+      {"int_val", "long_val", "string_val"},
+      20,
+      true);
+}
+
 TEST_F(E2EFilterTest, timestamp) {
   testWithTypes(
       "timestamp_val:timestamp,"
@@ -319,6 +342,22 @@ TEST_F(E2EFilterTest, nullCompactRanges) {
       false);
 }
 
+TEST_F(E2EFilterTest, maxRowsToScan) {
+  // Selective filters make batches of up to a row group of scanned rows.
+  maxRowsToScan_ = 100'000;
+  testWithTypes(
+      "long_val:bigint,"
+      "string_val:string,"
+      "outer_struct: struct<nested1:bigint, "
+      "inner_struct: struct<nested2: bigint>>",
+      [&]() {},
+      true,
+      {"long_val", "string_val"},
+      20,
+      true,
+      false);
+}
+
 TEST_F(E2EFilterTest, lazyStruct) {
   testWithTypes(
       "long_val:bigint,"
@@ -382,6 +421,70 @@ TEST_F(E2EFilterTest, flatMap) {
       kColumns, customize, false, {"long_val"}, numCombinations, true);
 }
 
+TEST_F(E2EFilterTest, flatMapSubscripts) {
+  constexpr int32_t kSize = 1'000;
+  test::VectorMaker vectorMaker(pool_.get());
+  auto batch = vectorMaker.rowVector(
+      {"c0", "c1"},
+      {vectorMaker.flatVector<int64_t>(kSize, [](auto row) { return row; }),
+       vectorMaker.mapVector<int64_t, int64_t>(
+           kSize,
+           [](vector_size_t row) { return 2 + row % 2; },
+           [](vector_size_t /*row*/, vector_size_t index) { return 1 + index; },
+           [](vector_size_t row, vector_size_t index) {
+             return index == 1 ? row % 10 : row;
+           })});
+  flatMapColumns_ = {"c1"};
+  writeToMemory(batch->type(), {batch}, false);
+
+  // Reads c1[1] and keeps the rows where c1[2] is between 5 and 9. c1[2] and
+  // c1[3] are not in the result.
+  auto spec = std::make_shared<ScanSpec>("root");
+  for (auto i = 0; i < 2; ++i) {
+    auto child = spec->getOrCreateChild(Subfield(fmt::format("c{}", i)));
+    child->setProjectOut(true);
+    child->setChannel(i);
+  }
+  spec->getOrCreateChild(Subfield("c1[1]"))->setProjectOut(true);
+  spec->getOrCreateChild(Subfield("c1[2]"))
+      ->setFilter(std::make_unique<BigintRange>(5, 9, false));
+
+  dwio::common::ReaderOptions readerOpts;
+  dwio::common::RowReaderOptions rowReaderOpts;
+  std::string_view data(sinkPtr_->getData(), sinkPtr_->size());
+  auto input = std::make_unique<BufferedInput>(
+      std::make_shared<InMemoryReadFile>(data), readerOpts.getMemoryPool());
+  auto reader = makeReader(readerOpts, std::move(input));
+  setUpRowReaderOptions(rowReaderOpts, spec);
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+
+  auto result = BaseVector::create(batch->type(), 0, pool_.get());
+  std::vector<int64_t> expected;
+  for (auto row = 0; row < kSize; ++row) {
+    if (row % 10 >= 5) {
+      expected.push_back(row);
+    }
+  }
+  int32_t numRead = 0;
+  while (rowReader->next(100, result)) {
+    auto rowVector = result->as<RowVector>();
+    auto c0 =
+        rowVector->childAt(0)->loadedVector()->as<SimpleVector<int64_t>>();
+    auto c1 = rowVector->childAt(1)->loadedVector()->as<MapVector>();
+    auto keys = c1->mapKeys()->as<SimpleVector<int64_t>>();
+    auto values = c1->mapValues()->as<SimpleVector<int64_t>>();
+    for (auto i = 0; i < rowVector->size(); ++i) {
+      ASSERT_LT(numRead, expected.size());
+      auto row = expected[numRead++];
+      ASSERT_EQ(row, c0->valueAt(i));
+      ASSERT_EQ(1, c1->sizeAt(i));
+      ASSERT_EQ(1, keys->valueAt(c1->offsetAt(i)));
+      ASSERT_EQ(row, values->valueAt(c1->offsetAt(i)));
+    }
+  }
+  EXPECT_EQ(expected.size(), numRead);
+}
+
 // Define main so that gflags get processed.
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/encryption/TestProvider.h"
@@ -1170,6 +1171,56 @@ TEST(E2EWriterTests, fuzzSimple) {
   }
 }
 
+TEST(E2EWriterTests, parallelFlush) {
+  auto pool = memory::getDefaultMemoryPool();
+  auto type = ROW({
+      {"int_val", INTEGER()},
+      {"long_val", BIGINT()},
+      {"double_val", DOUBLE()},
+      {"string_val", VARCHAR()},
+      {"map_val", MAP(INTEGER(), VARCHAR())},
+  });
+  VectorFuzzer fuzzer(
+      {.vectorSize = 1'000, .nullRatio = 0.05, .stringLength = 20},
+      pool.get(),
+      folly::Random::rand32());
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    batches.push_back(fuzzer.fuzzInputRow(type));
+  }
+
+  auto writeFile = [&](std::shared_ptr<folly::Executor> executor) {
+    auto config = std::make_shared<Config>();
+    config->set(Config::COMPRESSION, CompressionKind::CompressionKind_ZSTD);
+    config->set(Config::STRIPE_SIZE, static_cast<uint64_t>(64 * 1024));
+    auto sink = std::make_unique<MemorySink>(*pool, 16 * 1024 * 1024);
+    auto sinkPtr = sink.get();
+    WriterOptions options;
+    options.config = config;
+    options.schema = type;
+    options.flushExecutor = std::move(executor);
+    Writer writer{options, std::move(sink), *pool};
+    for (auto& batch : batches) {
+      writer.write(batch);
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  };
+
+  // The columns flushed in parallel produce the same file as a serial flush.
+  auto serial = writeFile(nullptr);
+  auto parallel = writeFile(std::make_shared<folly::CPUThreadPoolExecutor>(4));
+  EXPECT_EQ(serial, parallel);
+
+  ReaderOptions readerOpts;
+  DwrfReader reader(
+      readerOpts,
+      std::make_unique<BufferedInput>(
+          std::make_shared<InMemoryReadFile>(parallel),
+          readerOpts.getMemoryPool()));
+  EXPECT_GT(reader.getNumberOfStripes(), 1);
+}
+
 TEST(E2EWriterTests, fuzzComplex) {
   auto pool = memory::getDefaultMemoryPool();
   auto type = ROW({
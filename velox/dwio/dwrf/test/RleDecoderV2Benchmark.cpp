@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/dwrf/common/DecoderUtil.h"
+
+DECLARE_bool(avx512vbmi);
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+
+namespace {
+constexpr int32_t kNumValues = 100'000;
+constexpr int32_t kRunLength = 512;
+
+// RLEv2 data with DIRECT and DELTA runs for each bit width.
+std::vector<unsigned char> directRuns[65];
+std::vector<unsigned char> deltaRuns[65];
+
+uint8_t encodeBitWidth(int32_t width) {
+  if (width <= 24) {
+    return width - 1;
+  }
+  return width <= 32 ? 24 + (width - 26) / 2 : 28 + (width - 40) / 8;
+}
+
+void appendPacked(
+    int32_t numValues,
+    int32_t width,
+    std::vector<unsigned char>& out) {
+  const auto start = out.size();
+  out.resize(start + (numValues * width + 7) / 8);
+  for (auto i = start; i < out.size(); ++i) {
+    out[i] = folly::Random::rand32();
+  }
+}
+
+void makeRuns(int32_t width) {
+  for (auto i = 0; i < kNumValues; i += kRunLength) {
+    auto& direct = directRuns[width];
+    direct.push_back(
+        0x40 | encodeBitWidth(width) << 1 | (kRunLength - 1) >> 8);
+    direct.push_back((kRunLength - 1) & 0xff);
+    appendPacked(kRunLength, width, direct);
+
+    // Increasing values from 0 with a delta base of 1.
+    auto& delta = deltaRuns[width];
+    delta.push_back(
+        0xc0 | encodeBitWidth(width) << 1 | (kRunLength - 1) >> 8);
+    delta.push_back((kRunLength - 1) & 0xff);
+    delta.push_back(0);
+    delta.push_back(2);
+    appendPacked(kRunLength - 2, width, delta);
+  }
+}
+
+int64_t decode(const std::vector<unsigned char>& data, bool avx512) {
+  FLAGS_avx512vbmi = avx512;
+  auto pool = memory::getDefaultMemoryPool();
+  auto decoder = createRleDecoder<false>(
+      std::make_unique<dwio::common::SeekableArrayInputStream>(
+          data.data(), data.size()),
+      RleVersion_2,
+      *pool,
+      true,
+      dwio::common::LONG_BYTE_SIZE);
+  std::vector<int64_t> values(kRunLength * 2);
+  int64_t sum = 0;
+  for (auto i = 0; i < kNumValues; i += values.size()) {
+    decoder->next(values.data(), values.size(), nullptr);
+    sum += values.back();
+  }
+  FLAGS_avx512vbmi = true;
+  return sum;
+}
+
+#define DECODE_BENCHMARKS(width)                                               \
+  BENCHMARK(direct##width##Scalar) {                                           \
+    folly::doNotOptimizeAway(decode(directRuns[width], false));                \
+  }                                                                            \
+  BENCHMARK_RELATIVE(direct##width##Avx512) {                                  \
+    folly::doNotOptimizeAway(decode(directRuns[width], true));                 \
+  }                                                                            \
+  BENCHMARK(delta##width##Scalar) {                                            \
+    folly::doNotOptimizeAway(decode(deltaRuns[width], false));                 \
+  }                                                                            \
+  BENCHMARK_RELATIVE(delta##width##Avx512) {                                   \
+    folly::doNotOptimizeAway(decode(deltaRuns[width], true));                  \
+  }
+
+DECODE_BENCHMARKS(2)
+DECODE_BENCHMARKS(7)
+DECODE_BENCHMARKS(13)
+DECODE_BENCHMARKS(24)
+DECODE_BENCHMARKS(32)
+DECODE_BENCHMARKS(48)
+} // namespace
+
+int32_t main(int32_t argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  for (auto width : {2, 7, 13, 24, 32, 48}) {
+    makeRuns(width);
+  }
+  folly::runBenchmarks();
+  return 0;
+}
@@ -131,6 +131,17 @@ TEST(TestEntropyEncodingSelector, NoHeuristic) {
   }
 }
 
+TEST(TestEntropyEncodingSelector, mayUseDictionary) {
+  auto pool = getDefaultMemoryPool();
+  EntropyEncodingSelector selector{*pool, 0.8f, 0.9f, 0, 0.01, 0};
+  EXPECT_TRUE(selector.mayUseDictionary(10, 100));
+  EXPECT_TRUE(selector.mayUseDictionary(70, 100));
+  EXPECT_FALSE(selector.mayUseDictionary(90, 100));
+  // Estimates can be over the number of samples.
+  EXPECT_FALSE(selector.mayUseDictionary(103, 100));
+  EXPECT_ANY_THROW(selector.mayUseDictionary(0, 0));
+}
+
 TEST(TestEntropyEncodingSelector, NoSampling) {
   class TestCase : public EntropyEncodingSelectorTest {
    public:
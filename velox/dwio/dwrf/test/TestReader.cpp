@@ -1401,6 +1401,38 @@ TEST(TestReader, testOrcReaderSimple) {
   EXPECT_EQ(rowNumber, 32768);
 }
 
+TEST(TestReader, sharedFileTail) {
+  const std::string simpleTest(
+      getExampleFilePath("TestStringDictionary.testRowIndex.orc"));
+  ReaderOptions readerOpts;
+  readerOpts.setFileFormat(dwio::common::FileFormat::ORC);
+  auto makeReader = [&]() {
+    return DwrfReader::create(
+        createFileBufferedInput(simpleTest, readerOpts.getMemoryPool()),
+        readerOpts);
+  };
+
+  // Without a file id, each reader parses the footer.
+  auto first = makeReader();
+  auto second = makeReader();
+  EXPECT_NE(&first->getFooter(), &second->getFooter());
+
+  // With a file id, the readers share the footer of the first.
+  readerOpts.setFileId(std::hash<std::string>()(simpleTest));
+  auto cached = makeReader();
+  auto reused = makeReader();
+  EXPECT_EQ(&cached->getFooter(), &reused->getFooter());
+  EXPECT_EQ(cached->rowType(), reused->rowType());
+
+  VectorPtr batch;
+  size_t numRows = 0;
+  auto rowReader = reused->createRowReader(RowReaderOptions());
+  while (rowReader->next(500, batch)) {
+    numRows += batch->size();
+  }
+  EXPECT_EQ(32768, numRows);
+}
+
 TEST(TestReader, testFooterWrapper) {
   proto::Footer impl;
   FooterWrapper wrapper(&impl);
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <folly/Random.h>
 #include <gtest/gtest.h>
 
 #include "velox/common/base/Nulls.h"
@@ -73,6 +74,119 @@ void checkResults(
   }
 }
 
+namespace {
+// Returns the encoding of 'width' in the header of an RLEv2 run.
+uint8_t encodeBitWidth(int32_t width) {
+  if (width <= 24) {
+    return width - 1;
+  }
+  switch (width) {
+    case 26:
+      return 24;
+    case 28:
+      return 25;
+    case 30:
+      return 26;
+    case 32:
+      return 27;
+    case 40:
+      return 28;
+    case 48:
+      return 29;
+    case 56:
+      return 30;
+    default:
+      return 31;
+  }
+}
+
+void appendVsLong(int64_t value, std::vector<unsigned char>& out) {
+  uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ (value >> 63);
+  while (zigzag >= 0x80) {
+    out.push_back(0x80 | (zigzag & 0x7f));
+    zigzag >>= 7;
+  }
+  out.push_back(zigzag);
+}
+
+// Appends 'values' packed big endian in 'width' bits to 'out'.
+void appendPacked(
+    const std::vector<uint64_t>& values,
+    int32_t width,
+    std::vector<unsigned char>& out) {
+  const auto start = out.size();
+  out.resize(start + (values.size() * width + 7) / 8, 0);
+  for (auto i = 0; i < values.size(); ++i) {
+    for (auto bit = 0; bit < width; ++bit) {
+      if (values[i] >> (width - 1 - bit) & 1) {
+        const uint64_t position = i * width + bit;
+        out[start + position / 8] |= 0x80 >> (position % 8);
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(RLEv2, directAllWidths) {
+  constexpr int32_t kRunLength = 512;
+  for (auto width : {1, 2, 3, 7, 8, 13, 17, 24, 26, 30, 32, 40, 48, 56, 64}) {
+    std::vector<unsigned char> bytes;
+    std::vector<int64_t> expected;
+    // Two runs, so that the second starts after a whole number of bytes.
+    for (auto run = 0; run < 2; ++run) {
+      bytes.push_back(
+          0x40 | encodeBitWidth(width) << 1 | (kRunLength - 1) >> 8);
+      bytes.push_back((kRunLength - 1) & 0xff);
+      std::vector<uint64_t> zigzag;
+      for (auto i = 0; i < kRunLength; ++i) {
+        zigzag.push_back(
+            folly::Random::rand64() &
+            (width == 64 ? ~0ULL : bits::lowMask(width)));
+        expected.push_back((zigzag.back() >> 1) ^ -(zigzag.back() & 1));
+      }
+      appendPacked(zigzag, width, bytes);
+    }
+    // Batches that do not end at a group of 8 values use the bit by bit path
+    // for the rest of the run.
+    for (auto batch : {1, 100, 1'024}) {
+      SCOPED_TRACE(fmt::format("width {} batch {}", width, batch));
+      checkResults(
+          expected,
+          decodeRLEv2(bytes.data(), bytes.size(), batch, expected.size()),
+          batch);
+    }
+  }
+}
+
+TEST(RLEv2, deltaAllWidths) {
+  constexpr int32_t kRunLength = 300;
+  // A width of 1 is not encodable, the encoding 0 means a fixed delta.
+  for (auto width : {2, 5, 16, 24, 32, 48}) {
+    for (auto deltaBase : {-3, 7}) {
+      std::vector<unsigned char> bytes;
+      bytes.push_back(
+          0xc0 | encodeBitWidth(width) << 1 | (kRunLength - 1) >> 8);
+      bytes.push_back((kRunLength - 1) & 0xff);
+      appendVsLong(1'000, bytes);
+      appendVsLong(deltaBase, bytes);
+      std::vector<int64_t> expected = {1'000, 1'000 + deltaBase};
+      std::vector<uint64_t> deltas;
+      for (auto i = 2; i < kRunLength; ++i) {
+        deltas.push_back(folly::Random::rand64() & bits::lowMask(width));
+        expected.push_back(
+            deltaBase < 0 ? expected.back() - deltas.back()
+                          : expected.back() + deltas.back());
+      }
+      appendPacked(deltas, width, bytes);
+      SCOPED_TRACE(fmt::format("width {} deltaBase {}", width, deltaBase));
+      checkResults(
+          expected,
+          decodeRLEv2(bytes.data(), bytes.size(), kRunLength, kRunLength),
+          kRunLength);
+    }
+  }
+}
+
 TEST(RLEv2, basicDelta0) {
   const size_t count = 20;
   std::vector<int64_t> values;
@@ -125,4 +125,48 @@ TEST(TestStripeDictionaryCache, GetDictionaryBuffer) {
     EXPECT_ANY_THROW(cache.getIntDictionary({2, 0}));
   }
 }
+
+TEST(TestStripeDictionaryCache, SharedDictionary) {
+  auto& pool = memory::getProcessDefaultMemoryManager().getRoot();
+  auto makeCache = [&](uint64_t fileId, uint32_t stripe) {
+    auto cache = std::make_unique<StripeDictionaryCache>(&pool);
+    cache->setFileStripe(fileId, 1000, stripe);
+    cache->registerIntDictionary({9, 0}, genConsecutiveRangeBuffer(0, 100));
+    return cache;
+  };
+  // Readers of the same stripe get the same buffer.
+  auto first = makeCache(1, 0)->getIntDictionary({9, 0});
+  verifyRange(first, 0, 100);
+  EXPECT_EQ(first.get(), makeCache(1, 0)->getIntDictionary({9, 0}).get());
+
+  // Another stripe or file has its own dictionary.
+  EXPECT_NE(first.get(), makeCache(1, 1)->getIntDictionary({9, 0}).get());
+  EXPECT_NE(first.get(), makeCache(2, 0)->getIntDictionary({9, 0}).get());
+
+  // A dictionary registered at another width is not shared.
+  StripeDictionaryCache narrow{&pool};
+  narrow.setFileStripe(1, 1000, 0);
+  narrow.registerIntDictionary(
+      {9, 0}, genConsecutiveRangeBuffer(0, 100), sizeof(int32_t));
+  EXPECT_NE(first.get(), narrow.getIntDictionary({9, 0}).get());
+
+  // Without a file the dictionary is not shared.
+  StripeDictionaryCache local{&pool};
+  local.registerIntDictionary({9, 0}, genConsecutiveRangeBuffer(0, 100));
+  EXPECT_NE(first.get(), local.getIntDictionary({9, 0}).get());
+
+  int32_t numLoads = 0;
+  auto loadStrings = [&](memory::MemoryPool* pool) {
+    ++numLoads;
+    return std::vector<BufferPtr>{
+        AlignedBuffer::allocate<StringView>(10, pool),
+        AlignedBuffer::allocate<char>(100, pool)};
+  };
+  auto strings = makeCache(3, 0)->getSharedDictionary({4, 0}, 0, loadStrings);
+  auto sharedStrings =
+      makeCache(3, 0)->getSharedDictionary({4, 0}, 0, loadStrings);
+  EXPECT_EQ(1, numLoads);
+  EXPECT_EQ(strings[1].get(), sharedStrings[1].get());
+  EXPECT_LT(0, SharedDictionaryCache::instance().currentBytes());
+}
 } // namespace facebook::velox::dwrf
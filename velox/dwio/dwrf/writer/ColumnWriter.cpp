@@ -15,7 +15,12 @@
  */
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
+#include <folly/futures/Future.h>
 #include <velox/dwio/common/exception/Exception.h>
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+#include "velox/common/hyperloglog/DenseHll.h"
+#include "velox/common/memory/HashStringAllocator.h"
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
@@ -300,6 +305,7 @@ class IntegerColumnWriter : public BaseColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     BaseColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
     // through abandonDictionary, so we already have the stream initialization
@@ -510,6 +516,9 @@ uint64_t IntegerColumnWriter<T>::writeDict(
     T value = decodedVector.valueAt<T>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(value));
     statsBuilder.addValues(value);
+    if (bloomFilter_) {
+      bloomFilter_->addLong(value);
+    }
   };
 
   uint64_t nullCount = 0;
@@ -552,6 +561,13 @@ uint64_t IntegerColumnWriter<T>::writeDirect(
       dynamic_cast<IntegerStatisticsBuilder&>(*indexStatsBuilder_),
       slice,
       ranges);
+  if (bloomFilter_) {
+    for (auto& pos : ranges) {
+      if (!nulls || !bits::isBitNull(nulls, pos)) {
+        bloomFilter_->addLong(vals[pos]);
+      }
+    }
+  }
   auto rawSize = count * sizeof(T) + (ranges.size() - count) * NULL_SIZE;
   indexStatsBuilder_->increaseRawSize(rawSize);
   return rawSize;
@@ -804,6 +820,7 @@ class StringColumnWriter : public BaseColumnWriter {
             getConfig(Config::ENTROPY_STRING_DICT_SAMPLE_FRACTION),
             getConfig(Config::ENTROPY_STRING_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
+        sampleRows_{getConfig(Config::DICTIONARY_STRING_SAMPLE_ROWS)},
         useDictionaryEncoding_{useDictionaryEncoding()},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE(firstStripe_);
@@ -894,6 +911,7 @@ class StringColumnWriter : public BaseColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     BaseColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
     // through abandonDictionary, so we already have the stream initialization
@@ -1057,6 +1075,14 @@ class StringColumnWriter : public BaseColumnWriter {
   void populateDictionaryEncodingStreams();
   void convertToDirectEncoding();
 
+  // Estimates the number of distinct values in a sample of 'sampleRows_'
+  // values spread over 'ranges' and returns false if these have too few
+  // repeats for dictionary encoding. Returns std::nullopt if there are too few
+  // non-null values in 'ranges' for a decision.
+  std::optional<bool> sampleUseDictionary(
+      const DecodedVector& decodedVector,
+      const common::Ranges& ranges) const;
+
   // Could be RLE encoded raw data or dictionary encoded values.
   std::unique_ptr<IntEncoder<false>> data_;
   // Direct-encoded data in case dictionary encoding is not optimal.
@@ -1078,6 +1104,11 @@ class StringColumnWriter : public BaseColumnWriter {
   size_t finalDictionarySize_;
   EntropyEncodingSelector encodingSelector_;
   const bool sort_;
+  // Number of values sampled for deciding the encoding before building the
+  // dictionary. 0 if the decision is made only at flush.
+  const uint32_t sampleRows_;
+  // True once the sample has been taken.
+  bool sampled_{false};
   // This value could change if we are writing with low memory mode or if we
   // determine with the first stripe that the data is not fit for dictionary
   // encoding.
@@ -1092,6 +1123,17 @@ uint64_t StringColumnWriter::write(
   auto localDecoded = decode(slice, ranges);
   auto& decodedVector = localDecoded.get();
 
+  // Values with too few repeats go direct without building the dictionary.
+  // The decision is kept for the next stripes.
+  if (useDictionaryEncoding_ && firstStripe_ && sampleRows_ > 0 && !sampled_) {
+    if (auto useDictionary = sampleUseDictionary(decodedVector, ranges)) {
+      sampled_ = true;
+      if (!useDictionary.value()) {
+        tryAbandonDictionaries(true);
+      }
+    }
+  }
+
   if (useDictionaryEncoding_) {
     return writeDict(decodedVector, ranges);
   } else {
@@ -1099,6 +1141,34 @@ uint64_t StringColumnWriter::write(
   }
 }
 
+std::optional<bool> StringColumnWriter::sampleUseDictionary(
+    const DecodedVector& decodedVector,
+    const common::Ranges& ranges) const {
+  if (ranges.size() < sampleRows_) {
+    return std::nullopt;
+  }
+  // 2^11 buckets have a standard error of about 2%.
+  constexpr int8_t kIndexBitLength = 11;
+  HashStringAllocator allocator(memory::MappedMemory::getInstance());
+  common::hll::DenseHll hll(kIndexBitLength, &allocator);
+  const auto step = ranges.size() / sampleRows_;
+  uint64_t numSamples = 0;
+  size_t i = 0;
+  for (auto& pos : ranges) {
+    if (i++ % step != 0 || decodedVector.isNullAt(pos)) {
+      continue;
+    }
+    auto value = decodedVector.valueAt<StringView>(pos);
+    hll.insertHash(XXH64(value.data(), value.size(), 0));
+    ++numSamples;
+  }
+  // Mostly null values are not a representative sample.
+  if (numSamples < sampleRows_ / 2 || numSamples == 0) {
+    return std::nullopt;
+  }
+  return encodingSelector_.mayUseDictionary(hll.cardinality(), numSamples);
+}
+
 uint64_t StringColumnWriter::writeDict(
     DecodedVector& decodedVector,
     const common::Ranges& ranges) {
@@ -1113,6 +1183,9 @@ uint64_t StringColumnWriter::writeDict(
     auto sp = decodedVector.valueAt<StringView>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(sp, strideIndex));
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), sp.size());
+    }
     rawSize += sp.size();
   };
 
@@ -1158,6 +1231,9 @@ uint64_t StringColumnWriter::writeDirect(
     auto size = sp.size();
     dataDirect_->write(sp.data(), size);
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), size);
+    }
     rawSize += size;
     lengths.unsafeAppend(size);
   };
@@ -1513,6 +1589,9 @@ uint64_t BinaryColumnWriter::write(
       lengths.unsafeAppend(size);
       data_.write(data[pos].data(), size);
       statsBuilder.addValues(size);
+      if (bloomFilter_) {
+        bloomFilter_->addBytes(data[pos].data(), size);
+      }
       rawSize += size;
     };
 
@@ -1541,6 +1620,9 @@ uint64_t BinaryColumnWriter::write(
       lengths.unsafeAppend(size);
       data_.write(val.data(), size);
       statsBuilder.addValues(size);
+      if (bloomFilter_) {
+        bloomFilter_->addBytes(val.data(), size);
+      }
       rawSize += size;
     };
 
@@ -1588,18 +1670,56 @@ class StructColumnWriter : public BaseColumnWriter {
       std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
       std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
     BaseColumnWriter::flush(encodingFactory, encodingOverride);
+    if (isRoot() && context_.flushExecutor() && children_.size() > 1) {
+      flushChildrenInParallel(encodingFactory);
+      return;
+    }
     for (auto& c : children_) {
       c->flush(encodingFactory);
     }
   }
 
  private:
+  // Flushes the top level columns on the flush executor of the context. The
+  // encodings are staged per column and added to the footer in column order
+  // afterwards, so that the file is the same as with a serial flush.
+  void flushChildrenInParallel(
+      const std::function<proto::ColumnEncoding&(uint32_t)>& encodingFactory);
+
   uint64_t writeChildrenAndStats(
       const RowVector* rowSlice,
       const common::Ranges& ranges,
       uint64_t nullCount);
 };
 
+void StructColumnWriter::flushChildrenInParallel(
+    const std::function<proto::ColumnEncoding&(uint32_t)>& encodingFactory) {
+  // Deques keep the references returned by the factories valid.
+  std::vector<std::deque<std::pair<uint32_t, proto::ColumnEncoding>>>
+      encodings(children_.size());
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(children_.size());
+  for (auto i = 0; i < children_.size(); ++i) {
+    futures.push_back(folly::via(context_.flushExecutor(), [&, i]() {
+      children_[i]->flush([&staged = encodings[i]](uint32_t nodeId)
+                              -> proto::ColumnEncoding& {
+        return staged.emplace_back(nodeId, proto::ColumnEncoding()).second;
+      });
+    }));
+  }
+  // Waits for all columns before rethrowing the first error, since the tasks
+  // refer to 'encodings'.
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (auto& result : results) {
+    result.throwIfFailed();
+  }
+  for (auto& staged : encodings) {
+    for (auto& [nodeId, encoding] : staged) {
+      encodingFactory(nodeId).Swap(&encoding);
+    }
+  }
+}
+
 uint64_t StructColumnWriter::writeChildrenAndStats(
     const RowVector* rowSlice,
     const common::Ranges& ranges,
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/common/base/GTestMacros.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/ByteRLE.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/IntEncoder.h"
@@ -82,6 +83,7 @@ class BaseColumnWriter : public ColumnWriter {
     fileStatsBuilder_->merge(*indexStatsBuilder_);
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     recordPosition();
     for (auto& child : children_) {
       child->createIndexEntry();
@@ -115,6 +117,11 @@ class BaseColumnWriter : public ColumnWriter {
     setEncoding(encoding);
     encodingOverride(encoding);
     indexBuilder_->flush();
+    if (bloomFilter_) {
+      bloomFilterIndex_.SerializeToZeroCopyStream(bloomFilterOut_.get());
+      bloomFilterOut_->flush();
+      bloomFilterIndex_.Clear();
+    }
   }
 
   uint64_t writeFileStats(std::function<proto::ColumnStatistics&(uint32_t)>
@@ -169,6 +176,44 @@ class BaseColumnWriter : public ColumnWriter {
     auto options = StatisticsBuilderOptions::fromConfig(context.getConfigs());
     indexStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
     fileStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
+    if (needsBloomFilter()) {
+      bloomFilter_ = std::make_unique<BloomFilter>(
+          getConfig(Config::ROW_INDEX_STRIDE),
+          getConfig(Config::BLOOM_FILTER_FPP));
+      bloomFilterOut_ = newStream(StreamKind::StreamKind_BLOOM_FILTER_UTF8);
+    }
+  }
+
+  // Returns true if 'this' writes a bloom filter per stride. These are
+  // written for the integer and string columns in BLOOM_FILTER_COLUMNS that
+  // are direct children of the root node.
+  bool needsBloomFilter() const {
+    if (!isIndexEnabled() || sequence_ != 0 || type_.parent == nullptr ||
+        type_.parent->id != 0) {
+      return false;
+    }
+    switch (type_.type->kind()) {
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        break;
+      default:
+        return false;
+    }
+    const auto& columns = getConfig(Config::BLOOM_FILTER_COLUMNS);
+    return std::find(columns.begin(), columns.end(), type_.column) !=
+        columns.end();
+  }
+
+  // Adds the bloom filter of the current stride to the bloom filter index and
+  // clears it for the next stride.
+  void addBloomFilterEntry() {
+    if (bloomFilter_) {
+      bloomFilter_->serialize(*bloomFilterIndex_.add_bloomfilter());
+      bloomFilter_->reset();
+    }
   }
 
   uint64_t writeNulls(const VectorPtr& slice, const common::Ranges& ranges) {
@@ -262,6 +307,12 @@ class BaseColumnWriter : public ColumnWriter {
 
   std::unique_ptr<ByteRleEncoder> present_;
   bool hasNull_ = false;
+
+  // Bloom filter of the values of the current stride and the filters of the
+  // completed strides of the stripe. Set if needsBloomFilter().
+  std::unique_ptr<BloomFilter> bloomFilter_;
+  proto::BloomFilterIndex bloomFilterIndex_;
+  std::unique_ptr<BufferedOutputStream> bloomFilterOut_;
   // callback used to inject the logic that captures positions for flat map
   // in_map stream
   const std::function<void(IndexBuilder&)> onRecordPosition_;
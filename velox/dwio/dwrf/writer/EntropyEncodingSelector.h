@@ -76,6 +76,17 @@ class EntropyEncodingSelector {
         : true;
   }
 
+  // Returns false if a sample of 'numSamples' values of which an estimated
+  // 'numDistinct' are distinct has too few repeats for dictionary encoding.
+  // Used for deciding the encoding before a dictionary is built. 'numDistinct'
+  // may exceed 'numSamples' since it is an estimate.
+  bool mayUseDictionary(uint64_t numDistinct, uint64_t numSamples) const {
+    DWIO_ENSURE(numSamples, "No samples provided to encoding selector!");
+    float repeatedValuesFraction =
+        1.0f - std::min(1.0f, static_cast<float>(numDistinct) / numSamples);
+    return repeatedValuesFraction >= 1.0 - dictionaryKeySizeThreshold_;
+  }
+
  private:
   bool useDictionaryEncodingEntropyHeuristic(
       const StringDictionaryEncoder& dictEncoder) const {
@@ -124,6 +124,9 @@ struct WriterOptions {
       WriterContext& context,
       const velox::dwio::common::TypeWithId& type)>
       columnWriterFactory;
+  // If set, the top level columns of each stripe are encoded and compressed
+  // in parallel on this executor at flush time.
+  std::shared_ptr<folly::Executor> flushExecutor;
 };
 
 class Writer : public WriterBase {
@@ -142,6 +145,7 @@ class Writer : public WriterBase {
                                       options.encrypterFactory.get())
                                 : nullptr);
     initContext(options.config, std::move(pool), std::move(handler));
+    getContext().setFlushExecutor(options.flushExecutor);
     if (!options.flushPolicyFactory) {
       auto& context = getContext();
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
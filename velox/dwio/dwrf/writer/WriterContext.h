@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <mutex>
+
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/dwio/dwrf/common/Compression.h"
@@ -74,8 +77,9 @@ class WriterContext : public CompressionBufferPool {
       outputStreamPool_->setMemoryUsageTracker(tracker->addChild());
       generalPool_->setMemoryUsageTracker(tracker->addChild());
     }
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(
+        std::make_unique<dwio::common::DataBuffer<char>>(
+            *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE));
   }
 
   bool hasStream(const DwrfStreamIdentifier& stream) const {
@@ -298,18 +302,37 @@ class WriterContext : public CompressionBufferPool {
     }
   }
 
+  // Compression buffers are handed out to one stream at a time. Streams
+  // flushed in parallel get a buffer each, which is kept for later flushes.
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::lock_guard<std::mutex> l(compressionBufferMutex_);
+    if (compressionBuffers_.empty()) {
+      compressionBuffers_.push_back(
+          std::make_unique<dwio::common::DataBuffer<char>>(
+              *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE));
+    }
+    auto buffer = std::move(compressionBuffers_.back());
+    compressionBuffers_.pop_back();
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(compressionBufferMutex_);
+    compressionBuffers_.push_back(std::move(buffer));
+  }
+
+  /// Sets the executor on which the columns of a stripe are flushed in
+  /// parallel. If null, the columns are flushed on the writing thread.
+  void setFlushExecutor(std::shared_ptr<folly::Executor> executor) {
+    flushExecutor_ = std::move(executor);
+  }
+
+  folly::Executor* flushExecutor() const {
+    return flushExecutor_.get();
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
@@ -463,7 +486,10 @@ class WriterContext : public CompressionBufferPool {
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
+  std::mutex compressionBufferMutex_;
+  std::shared_ptr<folly::Executor> flushExecutor_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
   // Reusable SelectivityVector
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+namespace facebook::velox::parquet {
+namespace {
+// The salts of the 8 bits set per value from the Parquet spec.
+constexpr uint32_t kSalts[8] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+
+// Upper bound for the size of a serialized BloomFilterHeader.
+constexpr uint64_t kMaxHeaderSize = 64;
+
+// The maximum number of values of a filter to look up. Larger lists are
+// unlikely to be selective.
+constexpr int32_t kMaxValues = 1'000;
+
+std::string readAll(
+    const dwio::common::BufferedInput& input,
+    uint64_t offset,
+    uint64_t length) {
+  auto stream = input.read(offset, length, dwio::common::LogType::STRIPE_INDEX);
+  std::string bytes;
+  const void* buffer;
+  int32_t size;
+  while (bytes.size() < length && stream->Next(&buffer, &size)) {
+    bytes.append(reinterpret_cast<const char*>(buffer), size);
+  }
+  VELOX_CHECK_GE(bytes.size(), length, "Short read of Parquet bloom filter");
+  bytes.resize(length);
+  return bytes;
+}
+} // namespace
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(std::string bitset)
+    : bitset_(std::move(bitset)), numBlocks_(bitset_.size() / kBytesPerBlock) {
+  VELOX_CHECK(
+      numBlocks_ > 0 && bitset_.size() % kBytesPerBlock == 0,
+      "Bad Parquet bloom filter size {}",
+      bitset_.size());
+}
+
+// static
+std::unique_ptr<SplitBlockBloomFilter> SplitBlockBloomFilter::read(
+    const dwio::common::BufferedInput& input,
+    uint64_t offset) {
+  const uint64_t fileSize = input.getReadFile()->size();
+  VELOX_CHECK_LT(offset, fileSize, "Bad Parquet bloom filter offset");
+  auto headerBytes =
+      readAll(input, offset, std::min(kMaxHeaderSize, fileSize - offset));
+  auto transport = std::make_shared<thrift::ThriftBufferedTransport>(
+      headerBytes.data(), headerBytes.size());
+  auto protocol = std::make_unique<apache::thrift::protocol::TCompactProtocolT<
+      thrift::ThriftBufferedTransport>>(transport);
+  thrift::BloomFilterHeader header;
+  const uint64_t headerSize = header.read(protocol.get());
+  if (!header.algorithm.__isset.BLOCK || !header.hash.__isset.XXHASH ||
+      !header.compression.__isset.UNCOMPRESSED || header.numBytes <= 0 ||
+      header.numBytes % kBytesPerBlock != 0) {
+    return nullptr;
+  }
+  VELOX_CHECK_LE(
+      offset + headerSize + header.numBytes,
+      fileSize,
+      "Parquet bloom filter past end of file");
+  return std::make_unique<SplitBlockBloomFilter>(
+      readAll(input, offset + headerSize, header.numBytes));
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hash(const void* data, int32_t size) {
+  return XXH64(data, size, 0);
+}
+
+bool SplitBlockBloomFilter::mayContain(uint64_t hash) const {
+  const uint32_t blockIndex = ((hash >> 32) * numBlocks_) >> 32;
+  const uint32_t key = hash;
+  auto block = reinterpret_cast<const uint32_t*>(
+      bitset_.data() + blockIndex * kBytesPerBlock);
+  for (auto i = 0; i < 8; ++i) {
+    const uint32_t mask = 1U << ((key * kSalts[i]) >> 27);
+    if ((block[i] & mask) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SplitBlockBloomFilter::mayContainInteger(
+    int64_t value,
+    thrift::Type::type physicalType) const {
+  if (physicalType == thrift::Type::INT32) {
+    if (value < std::numeric_limits<int32_t>::min() ||
+        value > std::numeric_limits<int32_t>::max()) {
+      return false;
+    }
+    const int32_t narrow = value;
+    return mayContain(hash(&narrow, sizeof(narrow)));
+  }
+  return mayContain(hash(&value, sizeof(value)));
+}
+
+bool SplitBlockBloomFilter::mayMatch(
+    const common::Filter& filter,
+    thrift::Type::type physicalType) const {
+  const bool isInteger = physicalType == thrift::Type::INT32 ||
+      physicalType == thrift::Type::INT64;
+  const bool isBytes = physicalType == thrift::Type::BYTE_ARRAY ||
+      physicalType == thrift::Type::FIXED_LEN_BYTE_ARRAY;
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      const auto& range = static_cast<const common::BigintRange&>(filter);
+      if (!isInteger || !range.isSingleValue()) {
+        return true;
+      }
+      return mayContainInteger(range.lower(), physicalType);
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable: {
+      const auto& values =
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values();
+      if (!isInteger || values.size() > kMaxValues) {
+        return true;
+      }
+      return std::any_of(values.begin(), values.end(), [&](auto value) {
+        return mayContainInteger(value, physicalType);
+      });
+    }
+    case common::FilterKind::kBigintValuesUsingBitmask: {
+      if (!isInteger) {
+        return true;
+      }
+      const auto values =
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values();
+      if (values.size() > kMaxValues) {
+        return true;
+      }
+      return std::any_of(values.begin(), values.end(), [&](auto value) {
+        return mayContainInteger(value, physicalType);
+      });
+    }
+    case common::FilterKind::kBytesRange: {
+      const auto& range = static_cast<const common::BytesRange&>(filter);
+      if (!isBytes || !range.isSingleValue()) {
+        return true;
+      }
+      return mayContain(hash(range.lower().data(), range.lower().size()));
+    }
+    case common::FilterKind::kBytesValues: {
+      const auto& values =
+          static_cast<const common::BytesValues&>(filter).values();
+      if (!isBytes || values.size() > kMaxValues) {
+        return true;
+      }
+      return std::any_of(values.begin(), values.end(), [&](const auto& value) {
+        return mayContain(hash(value.data(), value.size()));
+      });
+    }
+    default:
+      return true;
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::parquet {
+
+/// The split block bloom filter of a Parquet column chunk. The filter is an
+/// array of 32 byte blocks. A value sets one bit in each of the 8 words of
+/// the block selected by the high half of its xxHash64.
+class SplitBlockBloomFilter {
+ public:
+  static constexpr int32_t kBytesPerBlock = 32;
+
+  /// 'bitset' is the bitset following the BloomFilterHeader.
+  explicit SplitBlockBloomFilter(std::string bitset);
+
+  /// Reads the bloom filter at file offset 'offset' through 'input', so that
+  /// the bytes are cached if 'input' uses the AsyncDataCache. Returns nullptr
+  /// if the filter uses an algorithm, hash or compression other than the
+  /// ones in the Parquet spec.
+  static std::unique_ptr<SplitBlockBloomFilter> read(
+      const dwio::common::BufferedInput& input,
+      uint64_t offset);
+
+  /// Returns the hash of a value in its PLAIN encoding, without the length for
+  /// BYTE_ARRAY.
+  static uint64_t hash(const void* FOLLY_NONNULL data, int32_t size);
+
+  /// Returns false if no value with 'hash' was inserted.
+  bool mayContain(uint64_t hash) const;
+
+  /// Returns false if the filter shows that no non-null value of a column of
+  /// 'physicalType' passes 'filter'. Only filters with a list of values or a
+  /// single value are tested, all others return true.
+  bool mayMatch(const common::Filter& filter, thrift::Type::type physicalType)
+      const;
+
+ private:
+  // Returns true if 'value' may be in a column of 'physicalType'.
+  bool mayContainInteger(int64_t value, thrift::Type::type physicalType) const;
+
+  const std::string bitset_;
+  const uint32_t numBlocks_;
+};
+
+} // namespace facebook::velox::parquet
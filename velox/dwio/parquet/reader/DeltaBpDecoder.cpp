@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+
+#include "velox/dwio/common/BufferUtil.h"
+
+namespace facebook::velox::parquet {
+namespace {
+// Decodes the lengths of DELTA_LENGTH_BYTE_ARRAY data into 'lengths' and
+// returns the start of the concatenated string bytes. Checks that the strings
+// fit within 'end'.
+const char* readLengths(
+    const char* start,
+    const char* end,
+    raw_vector<int32_t>& lengths) {
+  DeltaBpDecoder decoder(start, end);
+  lengths.resize(decoder.numValues());
+  decoder.readValues(lengths.data());
+  int64_t totalLength = 0;
+  for (auto length : lengths) {
+    VELOX_CHECK_GE(length, 0, "Negative length in DELTA_LENGTH_BYTE_ARRAY");
+    totalLength += length;
+  }
+  VELOX_CHECK_LE(
+      totalLength,
+      end - decoder.bufferStart(),
+      "DELTA_LENGTH_BYTE_ARRAY strings past end of data");
+  return decoder.bufferStart();
+}
+
+int32_t checkedSize(int64_t size) {
+  VELOX_CHECK_LE(
+      size,
+      std::numeric_limits<int32_t>::max(),
+      "Decoded Parquet page is too large");
+  return size;
+}
+} // namespace
+
+int32_t deltaLengthByteArrayToPlain(
+    const char* start,
+    const char* end,
+    memory::MemoryPool& pool,
+    BufferPtr& plain) {
+  raw_vector<int32_t> lengths;
+  auto data = readLengths(start, end, lengths);
+  int64_t size = lengths.size() * sizeof(int32_t);
+  for (auto length : lengths) {
+    size += length;
+  }
+  dwio::common::ensureCapacity<char>(plain, checkedSize(size), &pool);
+  auto output = plain->asMutable<char>();
+  for (auto length : lengths) {
+    memcpy(output, &length, sizeof(int32_t));
+    output += sizeof(int32_t);
+    memcpy(output, data, length);
+    output += length;
+    data += length;
+  }
+  return size;
+}
+
+int32_t deltaByteArrayToPlain(
+    const char* start,
+    const char* end,
+    int32_t fixedLength,
+    memory::MemoryPool& pool,
+    BufferPtr& plain) {
+  DeltaBpDecoder prefixDecoder(start, end);
+  raw_vector<int32_t> prefixLengths(prefixDecoder.numValues());
+  prefixDecoder.readValues(prefixLengths.data());
+  raw_vector<int32_t> suffixLengths;
+  auto suffixes = readLengths(prefixDecoder.bufferStart(), end, suffixLengths);
+  VELOX_CHECK_EQ(
+      prefixLengths.size(),
+      suffixLengths.size(),
+      "DELTA_BYTE_ARRAY prefix and suffix counts differ");
+
+  // Each prefix is at most the length of the previous value.
+  int64_t size = fixedLength > 0 ? 0 : prefixLengths.size() * sizeof(int32_t);
+  int32_t previousLength = 0;
+  for (auto i = 0; i < prefixLengths.size(); ++i) {
+    VELOX_CHECK(
+        prefixLengths[i] >= 0 && prefixLengths[i] <= previousLength,
+        "Bad prefix length in DELTA_BYTE_ARRAY");
+    previousLength = prefixLengths[i] + suffixLengths[i];
+    VELOX_CHECK(
+        fixedLength <= 0 || previousLength == fixedLength,
+        "Bad value length in DELTA_BYTE_ARRAY of fixed length {}",
+        fixedLength);
+    size += previousLength;
+  }
+  dwio::common::ensureCapacity<char>(plain, checkedSize(size), &pool);
+
+  auto output = plain->asMutable<char>();
+  const char* previous = nullptr;
+  for (auto i = 0; i < prefixLengths.size(); ++i) {
+    if (fixedLength <= 0) {
+      const int32_t length = prefixLengths[i] + suffixLengths[i];
+      memcpy(output, &length, sizeof(int32_t));
+      output += sizeof(int32_t);
+    }
+    // The previous value ends at 'output', so the ranges do not overlap.
+    if (prefixLengths[i] > 0) {
+      memcpy(output, previous, prefixLengths[i]);
+    }
+    memcpy(output + prefixLengths[i], suffixes, suffixLengths[i]);
+    suffixes += suffixLengths[i];
+    previous = output;
+    output += prefixLengths[i] + suffixLengths[i];
+  }
+  return size;
+}
+
+} // namespace facebook::velox::parquet
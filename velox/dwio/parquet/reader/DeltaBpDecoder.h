@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/RawVector.h"
+#include "velox/dwio/common/BitPackDecoder.h"
+#include "velox/vector/BaseVector.h"
+
+#include <folly/Varint.h>
+
+namespace facebook::velox::parquet {
+
+/// Decodes DELTA_BINARY_PACKED data. The values are stored as a header with
+/// the first value followed by blocks of deltas. Each block has a minimum
+/// delta and is divided into miniblocks which bit pack the deltas minus the
+/// minimum with a bit width of their own.
+class DeltaBpDecoder {
+ public:
+  DeltaBpDecoder(const char* FOLLY_NONNULL start, const char* FOLLY_NONNULL end)
+      : bufferStart_(start), bufferEnd_(end) {
+    blockSize_ = readUnsigned();
+    numMiniblocks_ = readUnsigned();
+    numValues_ = readUnsigned();
+    firstValue_ = readSigned();
+    VELOX_CHECK(
+        blockSize_ > 0 && blockSize_ % 128 == 0,
+        "Bad DELTA_BINARY_PACKED block size {}",
+        blockSize_);
+    VELOX_CHECK(
+        numMiniblocks_ > 0 && blockSize_ % numMiniblocks_ == 0,
+        "Bad DELTA_BINARY_PACKED miniblock count {}",
+        numMiniblocks_);
+    valuesPerMiniblock_ = blockSize_ / numMiniblocks_;
+    VELOX_CHECK_EQ(
+        valuesPerMiniblock_ % 32,
+        0,
+        "Bad DELTA_BINARY_PACKED miniblock size");
+  }
+
+  /// Returns the number of values in the encoded data.
+  int64_t numValues() const {
+    return numValues_;
+  }
+
+  /// Decodes all the values into 'result', which must have space for
+  /// numValues() elements. Arithmetic wraps around at the width of 'T', as
+  /// the format requires for INT32 columns.
+  template <typename T>
+  void readValues(T* FOLLY_NONNULL result) {
+    static_assert(std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>);
+    if (numValues_ == 0) {
+      return;
+    }
+    uint64_t value = firstValue_;
+    result[0] = static_cast<T>(value);
+    int64_t numRead = 1;
+    while (numRead < numValues_) {
+      const uint64_t minDelta = readSigned();
+      VELOX_CHECK_LE(
+          numMiniblocks_,
+          bufferEnd_ - bufferStart_,
+          "DELTA_BINARY_PACKED block past end of data");
+      auto bitWidths = reinterpret_cast<const uint8_t*>(bufferStart_);
+      bufferStart_ += numMiniblocks_;
+      // The bit widths of the miniblocks after the last value are arbitrary
+      // and the miniblocks themselves may be left out.
+      for (auto i = 0; i < numMiniblocks_ && numRead < numValues_; ++i) {
+        const auto numDeltas =
+            std::min<int64_t>(valuesPerMiniblock_, numValues_ - numRead);
+        if (bitWidths[i] <= 32) {
+          unpackMiniblock(bitWidths[i], narrowDeltas_);
+          value = addDeltas(
+              narrowDeltas_.data(),
+              numDeltas,
+              minDelta,
+              value,
+              result + numRead);
+        } else {
+          unpackMiniblock(bitWidths[i], wideDeltas_);
+          value = addDeltas(
+              wideDeltas_.data(), numDeltas, minDelta, value, result + numRead);
+        }
+        numRead += numDeltas;
+      }
+    }
+  }
+
+  /// Returns the first byte after the miniblock holding the last value. This
+  /// is the start of the string bytes for DELTA_LENGTH_BYTE_ARRAY. Valid after
+  /// readValues().
+  const char* FOLLY_NONNULL bufferStart() const {
+    return bufferStart_;
+  }
+
+ private:
+  uint64_t readUnsigned() {
+    folly::ByteRange range(
+        reinterpret_cast<const unsigned char*>(bufferStart_),
+        reinterpret_cast<const unsigned char*>(bufferEnd_));
+    // decodeVarint() advances the begin of 'range'.
+    auto value = folly::decodeVarint(range);
+    bufferStart_ = reinterpret_cast<const char*>(range.begin());
+    return value;
+  }
+
+  int64_t readSigned() {
+    return folly::decodeZigZag(readUnsigned());
+  }
+
+  // Unpacks the next miniblock of 'bitWidth' into 'deltas'. The miniblock is
+  // padded to 'valuesPerMiniblock_' values.
+  template <typename U>
+  void unpackMiniblock(uint8_t bitWidth, raw_vector<U>& deltas) {
+    VELOX_CHECK_LE(bitWidth, 64, "Bad DELTA_BINARY_PACKED bit width");
+    deltas.resize(valuesPerMiniblock_);
+    if (bitWidth == 0) {
+      std::fill(deltas.begin(), deltas.end(), 0);
+      return;
+    }
+    const uint64_t numBytes = valuesPerMiniblock_ * bitWidth / 8;
+    VELOX_CHECK_LE(
+        numBytes,
+        bufferEnd_ - bufferStart_,
+        "DELTA_BINARY_PACKED miniblock past end of data");
+    auto input = reinterpret_cast<const uint8_t*>(bufferStart_);
+    if constexpr (std::is_same_v<U, uint32_t>) {
+      auto output = deltas.data();
+      dwio::common::unpack<uint32_t>(
+          input, numBytes, valuesPerMiniblock_, bitWidth, output);
+    } else {
+      // Deltas wider than 32 bits only occur with values spanning most of
+      // the int64 range. The bits of a field are gathered a byte at a time.
+      uint64_t bit = 0;
+      for (auto i = 0; i < valuesPerMiniblock_; ++i) {
+        uint64_t delta = 0;
+        for (auto filled = 0; filled < bitWidth;) {
+          const auto numBits =
+              std::min<int32_t>(8 - bit % 8, bitWidth - filled);
+          delta |= static_cast<uint64_t>(
+                       (input[bit / 8] >> (bit % 8)) & bits::lowMask(numBits))
+              << filled;
+          filled += numBits;
+          bit += numBits;
+        }
+        deltas[i] = delta;
+      }
+    }
+    bufferStart_ += numBytes;
+  }
+
+  // Adds 'minDelta' and 'numDeltas' of 'deltas' to 'value' in turn and
+  // writes the running sum to 'result'. Returns the last value.
+  template <typename U, typename T>
+  static uint64_t addDeltas(
+      const U* FOLLY_NONNULL deltas,
+      int32_t numDeltas,
+      uint64_t minDelta,
+      uint64_t value,
+      T* FOLLY_NONNULL result) {
+    for (auto i = 0; i < numDeltas; ++i) {
+      value += deltas[i] + minDelta;
+      result[i] = static_cast<T>(value);
+    }
+    return value;
+  }
+
+  const char* FOLLY_NONNULL bufferStart_;
+  const char* FOLLY_NONNULL const bufferEnd_;
+  int64_t blockSize_;
+  int64_t numMiniblocks_;
+  int64_t valuesPerMiniblock_;
+  int64_t numValues_;
+  int64_t firstValue_;
+  raw_vector<uint32_t> narrowDeltas_;
+  raw_vector<uint64_t> wideDeltas_;
+};
+
+/// Decodes the DELTA_LENGTH_BYTE_ARRAY data from 'start' to 'end' into the
+/// layout of PLAIN BYTE_ARRAY data, i.e. each value preceded by its 4 byte
+/// length, in 'plain'. Returns the number of bytes in 'plain'.
+int32_t deltaLengthByteArrayToPlain(
+    const char* FOLLY_NONNULL start,
+    const char* FOLLY_NONNULL end,
+    memory::MemoryPool& pool,
+    BufferPtr& plain);
+
+/// Decodes the DELTA_BYTE_ARRAY data from 'start' to 'end' into 'plain'. The
+/// values are laid out as PLAIN BYTE_ARRAY data or, if 'fixedLength' is
+/// positive, as PLAIN FIXED_LEN_BYTE_ARRAY data of 'fixedLength' bytes per
+/// value. Returns the number of bytes in 'plain'.
+int32_t deltaByteArrayToPlain(
+    const char* FOLLY_NONNULL start,
+    const char* FOLLY_NONNULL end,
+    int32_t fixedLength,
+    memory::MemoryPool& pool,
+    BufferPtr& plain);
+
+} // namespace facebook::velox::parquet
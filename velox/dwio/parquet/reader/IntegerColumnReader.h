@@ -32,7 +32,8 @@ class IntegerColumnReader : public dwio::common::SelectiveIntegerColumnReader {
             std::move(requestedType),
             params,
             scanSpec,
-            dataType->type) {}
+            dataType->type),
+        returnDictionary_(canReturnDictionary(params, dataType)) {}
 
   bool hasBulkPath() const override {
     return !this->type()->isLongDecimal() &&
@@ -58,6 +59,9 @@ class IntegerColumnReader : public dwio::common::SelectiveIntegerColumnReader {
       RowSet rows,
       const uint64_t* /*incomingNulls*/) override {
     auto& data = formatData_->as<ParquetData>();
+    keepDictionaryIndices_ = returnDictionary_ && !scanSpec_->filter() &&
+        scanSpec_->keepValues() && !scanSpec_->valueHook();
+    data.setKeepDictionaryIndices(keepDictionaryIndices_);
     VELOX_WIDTH_DISPATCH(
         parquetSizeOfIntKind(type_->kind()),
         prepareRead,
@@ -72,6 +76,88 @@ class IntegerColumnReader : public dwio::common::SelectiveIntegerColumnReader {
     formatData_->as<ParquetData>().readWithVisitor(visitor);
     readOffset_ += rows.back() + 1;
   }
+
+  void getValues(RowSet rows, VectorPtr* result) override {
+    if (!keepDictionaryIndices_ || !scanState_.dictionary.values) {
+      SelectiveIntegerColumnReader::getValues(rows, result);
+      return;
+    }
+    if (type_->kind() == TypeKind::BIGINT) {
+      getDictionaryValues<int64_t>(rows, result);
+    } else {
+      getDictionaryValues<int32_t>(rows, result);
+    }
+  }
+
+  void dedictionarize() override {
+    if (!keepDictionaryIndices_) {
+      return;
+    }
+    if (type_->kind() == TypeKind::BIGINT) {
+      translateIndices<int64_t>();
+    } else {
+      translateIndices<int32_t>();
+    }
+  }
+
+ private:
+  // True if the column chunks may be returned as DictionaryVectors. The
+  // dictionary values must have the width and type of the requested type.
+  static bool canReturnDictionary(
+      const ParquetParams& params,
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType) {
+    if (!params.returnDictionaryVectors()) {
+      return false;
+    }
+    auto parquetType = std::static_pointer_cast<const ParquetTypeWithId>(
+                           dataType)
+                           ->parquetType_;
+    switch (dataType->type->kind()) {
+      case TypeKind::BIGINT:
+        return parquetType == thrift::Type::INT64;
+      case TypeKind::INTEGER:
+        return parquetType == thrift::Type::INT32;
+      default:
+        return false;
+    }
+  }
+
+  template <typename T>
+  void getDictionaryValues(RowSet rows, VectorPtr* result) {
+    auto dictionaryValues = formatData_->as<ParquetData>().dictionaryValues();
+    compactScalarValues<int32_t, int32_t>(rows, false);
+    *result = std::make_shared<DictionaryVector<T>>(
+        &memoryPool_,
+        !anyNulls_               ? nullptr
+            : returnReaderNulls_ ? nullsInReadRange_
+                                 : resultNulls_,
+        numValues_,
+        dictionaryValues,
+        values_);
+  }
+
+  // Replaces the dictionary indices in 'values_' with the values when a read
+  // continues from dictionary encoded pages to direct ones.
+  template <typename T>
+  void translateIndices() {
+    auto dictionary = scanState_.dictionary.values->as<T>();
+    auto indices = values_->as<int32_t>();
+    auto values = values_->asMutable<T>();
+    // Loops from the end so as not to overwrite indices with wider values.
+    for (auto i = numValues_ - 1; i >= 0; --i) {
+      if (anyNulls_ && bits::isBitNull(rawResultNulls_, i)) {
+        values[i] = 0;
+        continue;
+      }
+      values[i] = dictionary[indices[i]];
+    }
+  }
+
+  const bool returnDictionary_;
+
+  // True if the current read produces dictionary indices for dictionary
+  // encoded pages.
+  bool keepDictionaryIndices_{false};
 };
 
 } // namespace facebook::velox::parquet
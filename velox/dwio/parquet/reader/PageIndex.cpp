@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/parquet/reader/Statistics.h"
+
+namespace facebook::velox::parquet {
+namespace {
+// Returns true if some row of the 'index'th page may pass 'filter'.
+bool pageMatches(
+    const thrift::ColumnIndex& columnIndex,
+    int32_t index,
+    common::Filter* filter,
+    const TypePtr& type,
+    int64_t numRows) {
+  if (columnIndex.null_pages[index]) {
+    return filter->testNull();
+  }
+  const auto& min = columnIndex.min_values[index];
+  const auto& max = columnIndex.max_values[index];
+  if (min.empty() || max.empty()) {
+    return true;
+  }
+  thrift::Statistics stats;
+  stats.__set_min_value(min);
+  stats.__set_max_value(max);
+  if (columnIndex.__isset.null_counts) {
+    stats.__set_null_count(columnIndex.null_counts[index]);
+  }
+  auto columnStats = buildColumnStatisticsFromThrift(stats, *type, numRows);
+  return testFilter(filter, columnStats.get(), numRows, type);
+}
+} // namespace
+
+std::vector<IndexedPage> makeIndexedPages(
+    const thrift::OffsetIndex& offsetIndex,
+    const thrift::ColumnIndex* columnIndex,
+    common::Filter* filter,
+    const TypePtr& type,
+    int64_t chunkOffset,
+    int64_t numRows) {
+  const auto& locations = offsetIndex.page_locations;
+  const auto numPages = locations.size();
+  if (columnIndex &&
+      (columnIndex->null_pages.size() != numPages ||
+       columnIndex->min_values.size() != numPages ||
+       columnIndex->max_values.size() != numPages ||
+       (columnIndex->__isset.null_counts &&
+        columnIndex->null_counts.size() != numPages))) {
+    // A malformed ColumnIndex is ignored.
+    columnIndex = nullptr;
+  }
+  std::vector<IndexedPage> pages;
+  pages.reserve(numPages);
+  for (auto i = 0; i < numPages; ++i) {
+    const auto& location = locations[i];
+    VELOX_CHECK_GE(location.offset, chunkOffset, "Bad Parquet OffsetIndex");
+    VELOX_CHECK(
+        i == 0 ? location.first_row_index == 0
+               : location.first_row_index > locations[i - 1].first_row_index,
+        "Bad Parquet OffsetIndex");
+    IndexedPage page{location.offset - chunkOffset, location.first_row_index};
+    if (columnIndex && filter) {
+      const auto pageEnd =
+          i + 1 < numPages ? locations[i + 1].first_row_index : numRows;
+      page.filteredOut = !pageMatches(
+          *columnIndex, i, filter, type, pageEnd - location.first_row_index);
+    }
+    pages.push_back(page);
+  }
+  return pages;
+}
+
+} // namespace facebook::velox::parquet
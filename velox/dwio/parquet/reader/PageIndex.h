@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/type/Filter.h"
+#include "velox/type/Type.h"
+
+namespace facebook::velox::parquet {
+
+/// A data page of a column chunk as described by the OffsetIndex of the
+/// chunk.
+struct IndexedPage {
+  /// Offset of the page header from the start of the column chunk stream.
+  int64_t offset;
+
+  /// Row number of the first row of the page in the row group.
+  int64_t firstRow;
+
+  /// True if no row of the page can pass the filter on the column according
+  /// to the ColumnIndex.
+  bool filteredOut{false};
+};
+
+/// Returns the data pages of a column chunk from its 'offsetIndex'.
+/// 'chunkOffset' is the file offset where the chunk's stream starts. If
+/// 'columnIndex' and 'filter' are given, the pages whose min, max and null
+/// count show that no row passes 'filter' are marked filtered out. 'type' is
+/// the type of the column and 'numRows' the number of rows in the row group.
+std::vector<IndexedPage> makeIndexedPages(
+    const thrift::OffsetIndex& offsetIndex,
+    const thrift::ColumnIndex* FOLLY_NULLABLE columnIndex,
+    common::Filter* FOLLY_NULLABLE filter,
+    const TypePtr& type,
+    int64_t chunkOffset,
+    int64_t numRows);
+
+} // namespace facebook::velox::parquet
@@ -17,6 +17,7 @@
 #include "velox/dwio/parquet/reader/PageReader.h"
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/common/ColumnVisitors.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
 #include "velox/dwio/parquet/reader/NestedStructureDecoder.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 #include "velox/vector/FlatVector.h"
@@ -37,6 +38,9 @@ void PageReader::seekToPage(int64_t row) {
   // 'rowOfPage_' is the row number of the first row of the next page.
   rowOfPage_ += numRowsInPage_;
   for (;;) {
+    if (row != kRepDefOnly) {
+      seekToIndexedPage(row);
+    }
     auto dataStart = pageStart_;
     if (chunkSize_ <= pageStart_) {
       // This may happen if seeking to exactly end of row group.
@@ -75,6 +79,62 @@ void PageReader::seekToPage(int64_t row) {
   }
 }
 
+void PageReader::seekToIndexedPage(int64_t row) {
+  // The dictionary page precedes the first data page and is read before
+  // jumping ahead.
+  if (indexedPages_.empty() || pageStart_ < indexedPages_[0].offset) {
+    return;
+  }
+  auto it = std::upper_bound(
+      indexedPages_.begin(),
+      indexedPages_.end(),
+      row,
+      [](int64_t row, const IndexedPage& page) { return row < page.firstRow; });
+  VELOX_CHECK(it != indexedPages_.begin());
+  --it;
+  if (it->offset <= pageStart_) {
+    return;
+  }
+  std::vector<uint64_t> start = {static_cast<uint64_t>(it->offset)};
+  dwio::common::PositionProvider position(start);
+  inputStream_->seekToPosition(position);
+  bufferStart_ = bufferEnd_ = nullptr;
+  pageStart_ = it->offset;
+  rowOfPage_ = it->firstRow;
+  numRowsInPage_ = 0;
+}
+
+bool PageReader::skipFilteredPages(int64_t& row) {
+  if (indexedPages_.empty()) {
+    return true;
+  }
+  auto rowLess = [](int64_t row, const IndexedPage& page) {
+    return row < page.firstRow;
+  };
+  auto page = std::upper_bound(
+      indexedPages_.begin(), indexedPages_.end(), row, rowLess);
+  VELOX_CHECK(page != indexedPages_.begin());
+  --page;
+  while (page->filteredOut) {
+    ++page;
+    auto begin = visitorRows_ + currentVisitorRow_;
+    auto end = visitorRows_ + numVisitorRows_;
+    auto firstLeft = page == indexedPages_.end()
+        ? end
+        : std::lower_bound(begin, end, page->firstRow - visitBase_);
+    VELOX_DCHECK(firstLeft != begin);
+    currentVisitorRow_ = firstLeft - visitorRows_;
+    firstUnvisited_ = visitBase_ + visitorRows_[currentVisitorRow_ - 1] + 1;
+    if (currentVisitorRow_ == numVisitorRows_) {
+      return false;
+    }
+    row = visitBase_ + visitorRows_[currentVisitorRow_];
+    page = std::upper_bound(page, indexedPages_.end(), row, rowLess);
+    --page;
+  }
+  return true;
+}
+
 PageHeader PageReader::readPageHeader(int64_t remainingSize) {
   // Note that sizeof(PageHeader) may be longer than actually read
   std::shared_ptr<thrift::ThriftBufferedTransport> transport;
@@ -523,15 +583,40 @@ void PageReader::prepareDictionary(const PageHeader& pageHeader) {
   }
 }
 
-void PageReader::makeFilterCache(dwio::common::ScanState& state) {
+void PageReader::makeFilterCache(
+    dwio::common::ScanState& state,
+    const common::Filter* filter) {
   VELOX_CHECK(
       !state.dictionary2.values, "Parquet supports only one dictionary");
   state.filterCache.resize(state.dictionary.numValues);
-  simd::memset(
-      state.filterCache.data(),
-      dwio::common::FilterResult::kUnknown,
-      state.filterCache.size());
   state.rawState.filterCache = state.filterCache.data();
+  const auto kind = type_->type->kind();
+  if (!filter || !filter->isDeterministic() ||
+      (kind != TypeKind::VARCHAR && kind != TypeKind::VARBINARY)) {
+    simd::memset(
+        state.filterCache.data(),
+        dwio::common::FilterResult::kUnknown,
+        state.filterCache.size());
+    return;
+  }
+  // A string dictionary is usually much smaller than the column chunk, so the
+  // filter is evaluated once per entry instead of once per row.
+  auto values = state.dictionary.values->as<StringView>();
+  bool anyPassed = false;
+  for (auto i = 0; i < state.dictionary.numValues; ++i) {
+    const bool passed = filter->testBytes(values[i].data(), values[i].size());
+    state.filterCache[i] = passed ? dwio::common::FilterResult::kSuccess
+                                  : dwio::common::FilterResult::kFailure;
+    anyPassed |= passed;
+  }
+  noDictionaryMatch_ = !anyPassed && !filter->testNull();
+}
+
+void PageReader::dropVisitorRows() {
+  currentVisitorRow_ = numVisitorRows_;
+  if (numVisitorRows_ > 0) {
+    firstUnvisited_ = visitBase_ + visitorRows_[numVisitorRows_ - 1] + 1;
+  }
 }
 
 namespace {
@@ -691,7 +776,69 @@ void PageReader::makeDecoder() {
         }
       }
       break;
-    case Encoding::DELTA_BINARY_PACKED:
+    case Encoding::DELTA_BINARY_PACKED: {
+      // The values are decoded into PLAIN layout for the whole page so that
+      // the fast paths of DirectDecoder apply.
+      VELOX_CHECK(
+          parquetType == thrift::Type::INT32 ||
+              parquetType == thrift::Type::INT64,
+          "DELTA_BINARY_PACKED is only valid for INT32 and INT64");
+      DeltaBpDecoder decoder(pageData_, pageData_ + encodedDataSize_);
+      auto typeBytes = parquetTypeBytes(parquetType);
+      auto numBytes = decoder.numValues() * typeBytes;
+      dwio::common::ensureCapacity<char>(decodedData_, numBytes, &pool_);
+      if (parquetType == thrift::Type::INT32) {
+        decoder.readValues(decodedData_->asMutable<int32_t>());
+      } else {
+        decoder.readValues(decodedData_->asMutable<int64_t>());
+      }
+      directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
+          std::make_unique<dwio::common::SeekableArrayInputStream>(
+              decodedData_->as<char>(), numBytes),
+          false,
+          typeBytes);
+      break;
+    }
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY: {
+      VELOX_CHECK(
+          parquetType == thrift::Type::BYTE_ARRAY,
+          "DELTA_LENGTH_BYTE_ARRAY is only valid for BYTE_ARRAY");
+      auto numBytes = deltaLengthByteArrayToPlain(
+          pageData_, pageData_ + encodedDataSize_, pool_, decodedData_);
+      stringDecoder_ = std::make_unique<StringDecoder>(
+          decodedData_->as<char>(), decodedData_->as<char>() + numBytes);
+      break;
+    }
+    case Encoding::DELTA_BYTE_ARRAY:
+      switch (parquetType) {
+        case thrift::Type::BYTE_ARRAY: {
+          auto numBytes = deltaByteArrayToPlain(
+              pageData_, pageData_ + encodedDataSize_, 0, pool_, decodedData_);
+          stringDecoder_ = std::make_unique<StringDecoder>(
+              decodedData_->as<char>(), decodedData_->as<char>() + numBytes);
+          break;
+        }
+        case thrift::Type::FIXED_LEN_BYTE_ARRAY: {
+          auto numBytes = deltaByteArrayToPlain(
+              pageData_,
+              pageData_ + encodedDataSize_,
+              type_->typeLength_,
+              pool_,
+              decodedData_);
+          directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
+              std::make_unique<dwio::common::SeekableArrayInputStream>(
+                  decodedData_->as<char>(), numBytes),
+              false,
+              type_->typeLength_,
+              true);
+          break;
+        }
+        default:
+          VELOX_FAIL(
+              "DELTA_BYTE_ARRAY is only valid for BYTE_ARRAY and "
+              "FIXED_LEN_BYTE_ARRAY");
+      }
+      break;
     default:
       VELOX_UNSUPPORTED("Encoding not supported yet");
   }
@@ -828,11 +975,18 @@ bool PageReader::rowsForPage(
   if (currentVisitorRow_ == numVisitorRows_) {
     return false;
   }
+  if (hasFilter && noDictionaryMatch_ && allPagesDictionary_) {
+    dropVisitorRows();
+    return false;
+  }
   int32_t numToVisit;
   // Check if the first row to go to is in the current page. If not, seek to the
   // page that contains the row.
-  auto rowZero = visitBase_ + visitorRows_[currentVisitorRow_];
+  int64_t rowZero = visitBase_ + visitorRows_[currentVisitorRow_];
   if (rowZero >= rowOfPage_ + numRowsInPage_) {
+    if (hasFilter && !skipFilteredPages(rowZero)) {
+      return false;
+    }
     seekToPage(rowZero);
     if (hasChunkRepDefs_) {
       numLeafNullsConsumed_ = rowOfPage_;
@@ -843,10 +997,14 @@ bool PageReader::rowsForPage(
     if (scanState.dictionary.values != dictionary_.values) {
       scanState.dictionary = dictionary_;
       if (hasFilter) {
-        makeFilterCache(scanState);
+        makeFilterCache(scanState, reader.scanSpec()->filter());
       }
       scanState.updateRawState();
     }
+    if (hasFilter && noDictionaryMatch_ && allPagesDictionary_) {
+      dropVisitorRows();
+      return false;
+    }
   } else {
     if (scanState.dictionary.values) {
       // If there are previous pages in the current read, nulls read
@@ -921,13 +1079,34 @@ bool PageReader::rowsForPage(
 
 const VectorPtr& PageReader::dictionaryValues() {
   if (!dictionaryValues_) {
-    dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
-        &pool_,
-        VARCHAR(),
-        nullptr,
-        dictionary_.numValues,
-        dictionary_.values,
-        std::vector<BufferPtr>{dictionary_.strings});
+    switch (type_->type->kind()) {
+      case TypeKind::BIGINT:
+        dictionaryValues_ = std::make_shared<FlatVector<int64_t>>(
+            &pool_,
+            BIGINT(),
+            nullptr,
+            dictionary_.numValues,
+            dictionary_.values,
+            std::vector<BufferPtr>{});
+        break;
+      case TypeKind::INTEGER:
+        dictionaryValues_ = std::make_shared<FlatVector<int32_t>>(
+            &pool_,
+            INTEGER(),
+            nullptr,
+            dictionary_.numValues,
+            dictionary_.values,
+            std::vector<BufferPtr>{});
+        break;
+      default:
+        dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
+            &pool_,
+            VARCHAR(),
+            nullptr,
+            dictionary_.numValues,
+            dictionary_.values,
+            std::vector<BufferPtr>{dictionary_.strings});
+    }
   }
   return dictionaryValues_;
 }
@@ -20,6 +20,7 @@
 #include "velox/dwio/common/BitConcatenation.h"
 #include "velox/dwio/common/DirectDecoder.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/reader/RleBpDataDecoder.h"
 #include "velox/dwio/parquet/reader/StringDecoder.h"
@@ -90,7 +91,8 @@ class PageReader {
   /// are no nulls, buffer may be set to nullptr.
   void readNullsOnly(int64_t numValues, BufferPtr& buffer);
 
-  // Returns the current string dictionary as a FlatVector<StringView>.
+  // Returns the current dictionary as a FlatVector. String dictionaries are
+  // returned as FlatVector<StringView>.
   const VectorPtr& dictionaryValues();
 
   // True if the current page holds dictionary indices.
@@ -104,6 +106,30 @@ class PageReader {
     dictionaryValues_.reset();
   }
 
+  /// Sets the data pages of the column chunk from its page index. Seeks then
+  /// go directly to the page with the target row instead of reading the
+  /// headers of the pages in between, and reads with a filter skip the
+  /// pages which are filtered out. Only used for top level columns.
+  void setIndexedPages(std::vector<IndexedPage> pages) {
+    VELOX_CHECK(isTopLevel_);
+    indexedPages_ = std::move(pages);
+  }
+
+  /// If true, dictionary encoded pages read into an integer column without a
+  /// filter produce the dictionary indices instead of the values. The reader
+  /// then makes a DictionaryVector over dictionaryValues().
+  void setKeepDictionaryIndices(bool value) {
+    keepDictionaryIndices_ = value;
+  }
+
+  /// Declares that all the data pages of the column chunk are dictionary
+  /// encoded. Reads with a filter then skip the whole chunk if no dictionary
+  /// entry passes the filter. Only used for top level columns.
+  void setAllPagesDictionary() {
+    VELOX_CHECK(isTopLevel_);
+    allPagesDictionary_ = true;
+  }
+
   /// Returns the range of repdefs for the top level rows covered by the last
   /// decoderepDefs().
   std::pair<int32_t, int32_t> repDefRange() const {
@@ -128,13 +154,32 @@ class PageReader {
   // current page.
   int32_t skipNulls(int32_t numRows);
 
-  // Initializes a filter result cache for the dictionary in 'state'.
-  void makeFilterCache(dwio::common::ScanState& state);
+  // Initializes a filter result cache for the dictionary in 'state'. The
+  // results for a string dictionary are computed here with 'filter', so
+  // that the decoder filters on dictionary indices alone, and
+  // 'noDictionaryMatch_' is set if no entry passes.
+  void makeFilterCache(
+      dwio::common::ScanState& state,
+      const common::Filter* FOLLY_NULLABLE filter);
+
+  // Drops all the rows left to visit. Used when no row of the column chunk
+  // passes the filter.
+  void dropVisitorRows();
 
   // Makes a decoder based on 'encoding_' for bytes from ''pageData_' to
   // 'pageData_' + 'encodedDataSize_'.
   void makedecoder();
 
+  // Repositions the input at the start of the page containing 'row' if it is
+  // after the current position according to 'indexedPages_'.
+  void seekToIndexedPage(int64_t row);
+
+  // Drops the rows to visit which are on pages that are filtered out in
+  // 'indexedPages_', starting at 'row', the first row to visit. Updates 'row'
+  // to the first row to visit after the dropped ones. Returns false if no rows
+  // to visit are left.
+  bool skipFilteredPages(int64_t& row);
+
   // Reads and skips pages until finding a data page that contains
   // 'row'. Reads and sets 'rowOfPage_' and 'numRowsInPage_' and
   // initializes a decoder for the found page. row kRepDefOnly means
@@ -224,6 +269,17 @@ class PageReader {
       folly::Range<const vector_size_t*>& rows,
       const uint64_t* FOLLY_NULLABLE& nulls);
 
+  // True if 'Visitor' may produce dictionary indices instead of values when
+  // 'keepDictionaryIndices_' is set.
+  template <typename Visitor>
+  static constexpr bool kMayKeepDictionaryIndices =
+      std::is_same_v<typename Visitor::FilterType, common::AlwaysTrue> &&
+      std::is_same_v<
+          typename Visitor::Extract,
+          dwio::common::ExtractToReader> &&
+      (std::is_same_v<typename Visitor::DataType, int32_t> ||
+       std::is_same_v<typename Visitor::DataType, int64_t>);
+
   // Calls the visitor, specialized on the data type since not all visitors
   // apply to all types.
   template <
@@ -241,6 +297,14 @@ class PageReader {
           (this->type_->type->isShortDecimal() ? isDictionary() : true);
 
       if (isDictionary()) {
+        if constexpr (kMayKeepDictionaryIndices<Visitor>) {
+          if (keepDictionaryIndices_) {
+            // The string dictionary visitor produces the indices.
+            auto dictVisitor = visitor.toStringDictionaryColumnVisitor();
+            dictionaryIdDecoder_->readWithVisitor<true>(nulls, dictVisitor);
+            return;
+          }
+        }
         auto dictVisitor = visitor.toDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<true>(nulls, dictVisitor);
       } else {
@@ -249,6 +313,13 @@ class PageReader {
       }
     } else {
       if (isDictionary()) {
+        if constexpr (kMayKeepDictionaryIndices<Visitor>) {
+          if (keepDictionaryIndices_) {
+            auto dictVisitor = visitor.toStringDictionaryColumnVisitor();
+            dictionaryIdDecoder_->readWithVisitor<false>(nullptr, dictVisitor);
+            return;
+          }
+        }
         auto dictVisitor = visitor.toDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<false>(nullptr, dictVisitor);
       } else {
@@ -373,10 +444,26 @@ class PageReader {
   // Uncompressed data for the page. Rep-def-data in V1, data alone in V2.
   BufferPtr uncompressedData_;
 
+  // Values of a delta encoded page decoded into the layout of PLAIN data.
+  BufferPtr decodedData_;
+
   // First byte of uncompressed encoded data. Contains the encoded data as a
   // contiguous run of bytes.
   const char* FOLLY_NULLABLE pageData_{nullptr};
 
+  // The data pages of the column chunk from the page index. Empty if the
+  // chunk has no page index.
+  std::vector<IndexedPage> indexedPages_;
+
+  // See setKeepDictionaryIndices().
+  bool keepDictionaryIndices_{false};
+
+  // True if all data pages of the column chunk are dictionary encoded.
+  bool allPagesDictionary_{false};
+
+  // True if no entry of a string dictionary passes the filter of the reader.
+  bool noDictionaryMatch_{false};
+
   // Dictionary contents.
   dwio::common::DictionaryValues dictionary_;
   thrift::Encoding::type dictionaryEncoding_;
@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/parquet/reader/ParquetData.h"
+#include "velox/dwio/parquet/reader/BloomFilter.h"
 #include "velox/dwio/parquet/reader/Statistics.h"
 
 namespace facebook::velox::parquet {
@@ -23,10 +24,60 @@ using thrift::RowGroup;
 
 std::unique_ptr<dwio::common::FormatData> ParquetParams::toFormatData(
     const std::shared_ptr<const dwio::common::TypeWithId>& type,
-    const common::ScanSpec& /*scanSpec*/) {
-  return std::make_unique<ParquetData>(type, metaData_.row_groups, pool());
+    const common::ScanSpec& scanSpec) {
+  return std::make_unique<ParquetData>(
+      type, metaData_.row_groups, scanSpec, pool(), input_);
 }
 
+namespace {
+// Reads the thrift struct 'T' from all of 'stream'.
+template <typename T>
+T readThrift(dwio::common::SeekableInputStream& stream) {
+  std::string bytes;
+  const void* buffer;
+  int32_t size;
+  while (stream.Next(&buffer, &size)) {
+    bytes.append(reinterpret_cast<const char*>(buffer), size);
+  }
+  auto transport = std::make_shared<thrift::ThriftBufferedTransport>(
+      bytes.data(), bytes.size());
+  auto protocol = std::make_unique<apache::thrift::protocol::TCompactProtocolT<
+      thrift::ThriftBufferedTransport>>(transport);
+  T result;
+  result.read(protocol.get());
+  return result;
+}
+
+uint64_t chunkReadOffset(const thrift::ColumnMetaData& metaData) {
+  uint64_t offset = metaData.data_page_offset;
+  if (metaData.__isset.dictionary_page_offset &&
+      metaData.dictionary_page_offset >= 4) {
+    // this assumes the data pages follow the dict pages directly.
+    offset = metaData.dictionary_page_offset;
+  }
+  return offset;
+}
+
+// True if the encoding stats of the column chunk show that all its data pages
+// are dictionary encoded.
+bool allPagesDictionary(const thrift::ColumnMetaData& metaData) {
+  if (!metaData.__isset.encoding_stats) {
+    return false;
+  }
+  for (const auto& stats : metaData.encoding_stats) {
+    if (stats.page_type == thrift::PageType::DICTIONARY_PAGE ||
+        stats.count == 0) {
+      continue;
+    }
+    if (stats.encoding != thrift::Encoding::PLAIN_DICTIONARY &&
+        stats.encoding != thrift::Encoding::RLE_DICTIONARY) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
 std::vector<uint32_t> ParquetData::filterRowGroups(
     const common::ScanSpec& scanSpec,
     uint64_t /*rowsPerRowGroup*/,
@@ -61,9 +112,28 @@ bool ParquetData::rowGroupMatches(
         rowGroup.columns[column].meta_data.statistics,
         *type,
         rowGroup.num_rows);
-    return testFilter(filter, columnStats.get(), rowGroup.num_rows, type);
+    if (!testFilter(filter, columnStats.get(), rowGroup.num_rows, type)) {
+      return false;
+    }
   }
-  return true;
+  return bloomFilterMatches(rowGroupId, *filter);
+}
+
+bool ParquetData::bloomFilterMatches(
+    uint32_t rowGroupId,
+    const common::Filter& filter) {
+  auto& chunk = rowGroups_[rowGroupId].columns[type_->column];
+  if (!input_ || !type_->parquetType_.has_value() || filter.testNull() ||
+      !chunk.__isset.meta_data ||
+      !chunk.meta_data.__isset.bloom_filter_offset) {
+    return true;
+  }
+  // The filter is read through 'input_' so that it is cached with the rest
+  // of the file if 'input_' uses the AsyncDataCache.
+  auto bloomFilter = SplitBlockBloomFilter::read(
+      *input_, chunk.meta_data.bloom_filter_offset);
+  return !bloomFilter ||
+      bloomFilter->mayMatch(filter, type_->parquetType_.value());
 }
 
 void ParquetData::enqueueRowGroup(
@@ -81,20 +151,53 @@ void ParquetData::enqueueRowGroup(
       type_->column);
   auto& metaData = chunk.meta_data;
 
-  uint64_t chunkReadOffset = metaData.data_page_offset;
-  if (metaData.__isset.dictionary_page_offset &&
-      metaData.dictionary_page_offset >= 4) {
-    // this assumes the data pages follow the dict pages directly.
-    chunkReadOffset = metaData.dictionary_page_offset;
-  }
-  VELOX_CHECK_GE(chunkReadOffset, 0);
-
+  uint64_t readOffset = chunkReadOffset(metaData);
   uint64_t readSize = (metaData.codec == thrift::CompressionCodec::UNCOMPRESSED)
       ? metaData.total_uncompressed_size
       : metaData.total_compressed_size;
 
-  auto id = dwio::common::StreamIdentifier(type_->column);
-  streams_[index] = input.enqueue({chunkReadOffset, readSize}, &id);
+  auto id = dwio::common::StreamIdentifier(type_->column, type_->id);
+  streams_[index] = input.enqueue({readOffset, readSize}, &id);
+
+  // The page index is only used for columns where a page boundary is a row
+  // boundary. The ColumnIndex is only needed for filtering.
+  offsetIndexStreams_.resize(rowGroups_.size());
+  columnIndexStreams_.resize(rowGroups_.size());
+  if (maxRepeat_ > 0 || maxDefine_ > 1 || !chunk.__isset.offset_index_offset ||
+      chunk.offset_index_length <= 0) {
+    return;
+  }
+  offsetIndexStreams_[index] = input.enqueue(
+      {static_cast<uint64_t>(chunk.offset_index_offset),
+       static_cast<uint64_t>(chunk.offset_index_length)});
+  if (scanSpec_.filter() && chunk.__isset.column_index_offset &&
+      chunk.column_index_length > 0) {
+    columnIndexStreams_[index] = input.enqueue(
+        {static_cast<uint64_t>(chunk.column_index_offset),
+         static_cast<uint64_t>(chunk.column_index_length)});
+  }
+}
+
+void ParquetData::setIndexedPages(uint32_t index) {
+  if (index >= offsetIndexStreams_.size() || !offsetIndexStreams_[index]) {
+    return;
+  }
+  auto offsetIndex =
+      readThrift<thrift::OffsetIndex>(*offsetIndexStreams_[index]);
+  offsetIndexStreams_[index].reset();
+  std::optional<thrift::ColumnIndex> columnIndex;
+  if (columnIndexStreams_[index]) {
+    columnIndex = readThrift<thrift::ColumnIndex>(*columnIndexStreams_[index]);
+    columnIndexStreams_[index].reset();
+  }
+  const auto& rowGroup = rowGroups_[index];
+  reader_->setIndexedPages(makeIndexedPages(
+      offsetIndex,
+      columnIndex.has_value() ? &columnIndex.value() : nullptr,
+      scanSpec_.filter(),
+      type_->type,
+      chunkReadOffset(rowGroup.columns[type_->column].meta_data),
+      rowGroup.num_rows));
 }
 
 dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
@@ -108,6 +211,11 @@ dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
       type_,
       metadata.codec,
       metadata.total_compressed_size);
+  reader_->setKeepDictionaryIndices(keepDictionaryIndices_);
+  setIndexedPages(index);
+  if (maxRepeat_ == 0 && maxDefine_ <= 1 && allPagesDictionary(metadata)) {
+    reader_->setAllPagesDictionary();
+  }
   return dwio::common::PositionProvider(empty);
 }
 
@@ -28,14 +28,31 @@
 namespace facebook::velox::parquet {
 class ParquetParams : public dwio::common::FormatParams {
  public:
-  ParquetParams(memory::MemoryPool& pool, const thrift::FileMetaData& metaData)
-      : FormatParams(pool), metaData_(metaData) {}
+  /// 'input' is used to read the bloom filters of the column chunks when
+  /// filtering row groups. If null, the bloom filters are not used.
+  ParquetParams(
+      memory::MemoryPool& pool,
+      const thrift::FileMetaData& metaData,
+      const dwio::common::BufferedInput* FOLLY_NULLABLE input = nullptr)
+      : FormatParams(pool), metaData_(metaData), input_(input) {}
   std::unique_ptr<dwio::common::FormatData> toFormatData(
       const std::shared_ptr<const dwio::common::TypeWithId>& type,
       const common::ScanSpec& scanSpec) override;
 
+  /// If true, dictionary encoded integer columns read without a filter
+  /// produce DictionaryVectors. See RowReaderOptions.
+  void setReturnDictionaryVectors(bool value) {
+    returnDictionaryVectors_ = value;
+  }
+
+  bool returnDictionaryVectors() const {
+    return returnDictionaryVectors_;
+  }
+
  private:
   const thrift::FileMetaData& metaData_;
+  bool returnDictionaryVectors_{false};
+  const dwio::common::BufferedInput* FOLLY_NULLABLE const input_;
 };
 
 /// Format-specific data created for each leaf column of a Parquet rowgroup.
@@ -44,15 +61,20 @@ class ParquetData : public dwio::common::FormatData {
   ParquetData(
       const std::shared_ptr<const dwio::common::TypeWithId>& type,
       const std::vector<thrift::RowGroup>& rowGroups,
-      memory::MemoryPool& pool)
+      const common::ScanSpec& scanSpec,
+      memory::MemoryPool& pool,
+      const dwio::common::BufferedInput* FOLLY_NULLABLE input = nullptr)
       : pool_(pool),
         type_(std::static_pointer_cast<const ParquetTypeWithId>(type)),
         rowGroups_(rowGroups),
+        scanSpec_(scanSpec),
+        input_(input),
         maxDefine_(type_->maxDefine_),
         maxRepeat_(type_->maxRepeat_),
         rowsInRowGroup_(-1) {}
 
-  /// Prepares to read data for 'index'th row group.
+  /// Prepares to read data for 'index'th row group. For a top level column,
+  /// this also reads the page index of the column chunk if the file has one.
   void enqueueRowGroup(uint32_t index, dwio::common::BufferedInput& input);
 
   /// Positions 'this' at 'index'th row group. enqueueRowGroup must be called
@@ -61,7 +83,7 @@ class ParquetData : public dwio::common::FormatData {
   dwio::common::PositionProvider seekToRowGroup(uint32_t index) override;
 
   /// True if 'filter' may have hits for the column of 'this' according to the
-  /// stats in 'rowGroup'.
+  /// stats and the bloom filter of the column chunk in 'rowGroup'.
   bool rowGroupMatches(
       uint32_t rowGroupId,
       common::Filter* FOLLY_NULLABLE filter) override;
@@ -71,6 +93,16 @@ class ParquetData : public dwio::common::FormatData {
       uint64_t rowsPerRowGroup,
       const dwio::common::StatsContext& writerContext) override;
 
+  /// If true, the reads of dictionary encoded pages without a filter produce
+  /// dictionary indices instead of values. See
+  /// PageReader::setKeepDictionaryIndices().
+  void setKeepDictionaryIndices(bool value) {
+    keepDictionaryIndices_ = value;
+    if (reader_) {
+      reader_->setKeepDictionaryIndices(value);
+    }
+  }
+
   PageReader* FOLLY_NONNULL reader() const {
     return reader_.get();
   }
@@ -177,16 +209,34 @@ class ParquetData : public dwio::common::FormatData {
   }
 
  protected:
+  // Sets the pages of the column chunk of 'index'th row group in 'reader_'
+  // from the page index streams enqueued by enqueueRowGroup(), if any.
+  void setIndexedPages(uint32_t index);
+
+  // Returns false if the bloom filter of the column chunk of 'rowGroupId'th
+  // row group shows that no value passes 'filter'.
+  bool bloomFilterMatches(uint32_t rowGroupId, const common::Filter& filter);
+
   memory::MemoryPool& pool_;
   std::shared_ptr<const ParquetTypeWithId> type_;
   const std::vector<thrift::RowGroup>& rowGroups_;
+  const common::ScanSpec& scanSpec_;
+  const dwio::common::BufferedInput* FOLLY_NULLABLE const input_;
   // Streams for this column in each of 'rowGroups_'. Will be created on or
   // ahead of first use, not at construction.
   std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams_;
 
+  // Streams for the OffsetIndex and ColumnIndex of the column chunk in each
+  // of 'rowGroups_'. Null if the chunk has no such index or it is not used.
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      offsetIndexStreams_;
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      columnIndexStreams_;
+
   const uint32_t maxDefine_;
   const uint32_t maxRepeat_;
   int64_t rowsInRowGroup_;
+  bool keepDictionaryIndices_{false};
   std::unique_ptr<PageReader> reader_;
 
   // Nulls derived from leaf repdefs for non-leaf readers.
@@ -16,8 +16,10 @@
 
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/MetricsLog.h"
 #include "velox/dwio/common/TypeUtils.h"
+#include "velox/dwio/parquet/reader/Statistics.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 
@@ -33,11 +35,24 @@ ReaderBase::ReaderBase(
   VELOX_CHECK_GT(fileLength_, 0, "Parquet file is empty");
   VELOX_CHECK_GE(fileLength_, 12, "Parquet file is too small");
 
-  loadFileMetaData();
+  std::optional<dwio::common::FileMetadataKey> cacheKey;
+  if (options.fileId().has_value()) {
+    cacheKey = {
+        options.fileId().value(),
+        fileLength_,
+        dwio::common::FileFormat::PARQUET};
+    fileMetaData_ =
+        dwio::common::FileMetadataCache::instance().find<thrift::FileMetaData>(
+            *cacheKey);
+  }
+  if (!fileMetaData_) {
+    loadFileMetaData(cacheKey);
+  }
   initializeSchema();
 }
 
-void ReaderBase::loadFileMetaData() {
+void ReaderBase::loadFileMetaData(
+    const std::optional<dwio::common::FileMetadataKey>& cacheKey) {
   bool preloadFile_ = fileLength_ <= FILE_PRELOAD_THRESHOLD;
   uint64_t readSize =
       preloadFile_ ? fileLength_ : std::min(fileLength_, DIRECTORY_SIZE_GUESS);
@@ -78,8 +93,14 @@ void ReaderBase::loadFileMetaData() {
   auto thriftProtocol =
       std::make_unique<apache::thrift::protocol::TCompactProtocolT<
           thrift::ThriftBufferedTransport>>(thriftTransport);
-  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
-  fileMetaData_->read(thriftProtocol.get());
+  auto fileMetaData = std::make_shared<thrift::FileMetaData>();
+  fileMetaData->read(thriftProtocol.get());
+  if (cacheKey.has_value()) {
+    // The serialized size stands in for the size of the parsed footer.
+    dwio::common::FileMetadataCache::instance().insert(
+        *cacheKey, fileMetaData, footerLength);
+  }
+  fileMetaData_ = std::move(fileMetaData);
 }
 
 void ReaderBase::initializeSchema() {
@@ -488,7 +509,9 @@ ParquetRowReader::ParquetRowReader(
   if (rowGroups_.empty()) {
     return; // TODO
   }
-  ParquetParams params(pool_, readerBase_->fileMetaData());
+  ParquetParams params(
+      pool_, readerBase_->fileMetaData(), &readerBase_->bufferedInput());
+  params.setReturnDictionaryVectors(options_.getReturnDictionaryVectors());
 
   columnReader_ = ParquetColumnReader::build(
       readerBase_->schemaWithId(), // Id is schema id
@@ -533,8 +556,10 @@ uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
     }
   }
 
+  // With selective filters, scans more rows so that about 'size' pass.
   uint64_t rowsToRead = std::min(
-      static_cast<uint64_t>(size), rowsInCurrentRowGroup_ - currentRowInGroup_);
+      columnReader_->scanSpec()->rowsToScan(size),
+      rowsInCurrentRowGroup_ - currentRowInGroup_);
 
   if (rowsToRead > 0) {
     columnReader_->next(rowsToRead, result, nullptr);
@@ -544,6 +569,41 @@ uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
   return rowsToRead;
 }
 
+std::vector<dwio::common::UnitStatistics> ParquetRowReader::unitStatistics()
+    const {
+  if (currentRowGroupIdsIdx_ != 0) {
+    return {};
+  }
+  const auto& schema = *readerBase_->schemaWithId();
+  std::vector<dwio::common::UnitStatistics> units(rowGroupIds_.size());
+  for (auto i = 0; i < rowGroupIds_.size(); ++i) {
+    const auto& rowGroup = rowGroups_[rowGroupIds_[i]];
+    units[i].numRows = rowGroup.num_rows;
+    for (auto j = 0; j < schema.size(); ++j) {
+      const auto& child =
+          static_cast<const ParquetTypeWithId&>(*schema.childAt(j));
+      std::unique_ptr<dwio::common::ColumnStatistics> stats;
+      if (child.isLeaf()) {
+        const auto& chunk = rowGroup.columns[child.column];
+        if (chunk.__isset.meta_data && chunk.meta_data.__isset.statistics) {
+          stats = buildColumnStatisticsFromThrift(
+              chunk.meta_data.statistics, *child.type, rowGroup.num_rows);
+        }
+      }
+      units[i].columns.push_back(std::move(stats));
+    }
+  }
+  return units;
+}
+
+void ParquetRowReader::skipUnits(const std::vector<uint32_t>& indices) {
+  VELOX_CHECK_EQ(currentRowGroupIdsIdx_, 0, "skipUnits() after next()");
+  for (auto i = indices.size(); i-- > 0;) {
+    VELOX_CHECK_LT(indices[i], rowGroupIds_.size());
+    rowGroupIds_.erase(rowGroupIds_.begin() + indices[i]);
+  }
+}
+
 bool ParquetRowReader::advanceToNextRowGroup() {
   if (currentRowGroupIdsIdx_ == rowGroupIds_.size()) {
     return false;
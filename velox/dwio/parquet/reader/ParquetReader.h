@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
@@ -84,8 +85,10 @@ class ReaderBase {
       const dwio::common::TypeWithId& type) const;
 
  private:
-  // Reads and parses file footer.
-  void loadFileMetaData();
+  // Reads and parses file footer. Adds the footer to the FileMetadataCache
+  // under 'cacheKey' if set.
+  void loadFileMetaData(
+      const std::optional<dwio::common::FileMetadataKey>& cacheKey);
 
   void initializeSchema();
 
@@ -106,7 +109,8 @@ class ReaderBase {
   const dwio::common::ReaderOptions& options_;
   std::unique_ptr<velox::dwio::common::BufferedInput> input_;
   uint64_t fileLength_;
-  std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  // Shared with the other readers of the file through the FileMetadataCache.
+  std::shared_ptr<const thrift::FileMetaData> fileMetaData_;
   RowTypePtr schema_;
   std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
 
@@ -134,6 +138,11 @@ class ParquetRowReader : public dwio::common::RowReader {
 
   std::optional<size_t> estimatedRowSize() const override;
 
+  // Returns the statistics of the row groups left after filterRowGroups().
+  std::vector<dwio::common::UnitStatistics> unitStatistics() const override;
+
+  void skipUnits(const std::vector<uint32_t>& indices) override;
+
   const dwio::common::RowReaderOptions& getOptions() {
     return options_;
   }
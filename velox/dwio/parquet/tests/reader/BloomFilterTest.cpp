@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+constexpr uint32_t kSalts[8] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+
+// Builds the bitset of a split block bloom filter the way a writer does.
+class BitsetBuilder {
+ public:
+  explicit BitsetBuilder(int32_t numBlocks)
+      : bitset_(numBlocks * SplitBlockBloomFilter::kBytesPerBlock, 0),
+        numBlocks_(numBlocks) {}
+
+  void insert(const void* data, int32_t size) {
+    const auto hash = SplitBlockBloomFilter::hash(data, size);
+    const uint32_t blockIndex = ((hash >> 32) * numBlocks_) >> 32;
+    const uint32_t key = hash;
+    auto block = reinterpret_cast<uint32_t*>(
+        bitset_.data() + blockIndex * SplitBlockBloomFilter::kBytesPerBlock);
+    for (auto i = 0; i < 8; ++i) {
+      block[i] |= 1U << ((key * kSalts[i]) >> 27);
+    }
+  }
+
+  const std::string& bitset() const {
+    return bitset_;
+  }
+
+ private:
+  std::string bitset_;
+  const uint32_t numBlocks_;
+};
+} // namespace
+
+TEST(BloomFilterTest, integers) {
+  BitsetBuilder int32Builder(32);
+  BitsetBuilder int64Builder(32);
+  for (int64_t i = 0; i < 1'000; i += 10) {
+    const int32_t narrow = i;
+    int32Builder.insert(&narrow, sizeof(narrow));
+    int64Builder.insert(&i, sizeof(i));
+  }
+  SplitBlockBloomFilter int32Filter(int32Builder.bitset());
+  SplitBlockBloomFilter int64Filter(int64Builder.bitset());
+
+  for (int64_t i = 0; i < 1'000; i += 10) {
+    common::BigintRange equal(i, i, false);
+    EXPECT_TRUE(int32Filter.mayMatch(equal, thrift::Type::INT32));
+    EXPECT_TRUE(int64Filter.mayMatch(equal, thrift::Type::INT64));
+  }
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 1; i < 1'000; i += 10) {
+    common::BigintRange equal(i, i, false);
+    numFalsePositives += int32Filter.mayMatch(equal, thrift::Type::INT32);
+    numFalsePositives += int64Filter.mayMatch(equal, thrift::Type::INT64);
+  }
+  EXPECT_LT(numFalsePositives, 10);
+
+  // A value out of the INT32 range is not in an INT32 column.
+  common::BigintRange large(1L << 40, 1L << 40, false);
+  EXPECT_FALSE(int32Filter.mayMatch(large, thrift::Type::INT32));
+
+  // Ranges are not tested against the bloom filter.
+  common::BigintRange range(1, 9, false);
+  EXPECT_TRUE(int64Filter.mayMatch(range, thrift::Type::INT64));
+
+  auto values = common::createBigintValues({1, 2, 3, 30}, false);
+  EXPECT_TRUE(int64Filter.mayMatch(*values, thrift::Type::INT64));
+  values = common::createBigintValues({1'001, 2'001, 3'001, 4'001}, false);
+  EXPECT_FALSE(int64Filter.mayMatch(*values, thrift::Type::INT64));
+}
+
+TEST(BloomFilterTest, strings) {
+  BitsetBuilder builder(64);
+  for (auto i = 0; i < 500; ++i) {
+    auto value = fmt::format("value-{}", i * 2);
+    builder.insert(value.data(), value.size());
+  }
+  SplitBlockBloomFilter filter(builder.bitset());
+
+  common::BytesValues present({"value-0", "value-998", "other"}, false);
+  EXPECT_TRUE(filter.mayMatch(present, thrift::Type::BYTE_ARRAY));
+  common::BytesValues absent({"value-1", "value-999", "other"}, false);
+  EXPECT_FALSE(filter.mayMatch(absent, thrift::Type::BYTE_ARRAY));
+
+  common::BytesRange equal(
+      "value-1", false, false, "value-1", false, false, false);
+  EXPECT_FALSE(filter.mayMatch(equal, thrift::Type::BYTE_ARRAY));
+
+  // A filter on another physical type is not tested.
+  EXPECT_TRUE(filter.mayMatch(absent, thrift::Type::INT64));
+}
+
+TEST(BloomFilterTest, badSize) {
+  EXPECT_THROW(SplitBlockBloomFilter(std::string(33, 0)), VeloxRuntimeError);
+  EXPECT_THROW(SplitBlockBloomFilter(std::string()), VeloxRuntimeError);
+}
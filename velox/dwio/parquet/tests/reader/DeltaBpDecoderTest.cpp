@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+constexpr int32_t kBlockSize = 128;
+constexpr int32_t kNumMiniblocks = 4;
+constexpr int32_t kMiniblockSize = kBlockSize / kNumMiniblocks;
+
+void appendVarint(uint64_t value, std::string& out) {
+  uint8_t buffer[folly::kMaxVarintLength64];
+  auto size = folly::encodeVarint(value, buffer);
+  out.append(reinterpret_cast<const char*>(buffer), size);
+}
+
+// Encodes 'values' as DELTA_BINARY_PACKED and appends them to 'out'. Only the
+// miniblocks holding values are written.
+void encodeDeltas(const std::vector<int64_t>& values, std::string& out) {
+  appendVarint(kBlockSize, out);
+  appendVarint(kNumMiniblocks, out);
+  appendVarint(values.size(), out);
+  appendVarint(folly::encodeZigZag(values.empty() ? 0 : values[0]), out);
+  for (auto start = 1; start < values.size(); start += kBlockSize) {
+    auto end = std::min<int32_t>(start + kBlockSize, values.size());
+    std::vector<uint64_t> deltas;
+    int64_t minDelta = std::numeric_limits<int64_t>::max();
+    for (auto i = start; i < end; ++i) {
+      const int64_t delta = static_cast<uint64_t>(values[i]) - values[i - 1];
+      deltas.push_back(delta);
+      minDelta = std::min(minDelta, delta);
+    }
+    appendVarint(folly::encodeZigZag(minDelta), out);
+    std::vector<uint8_t> bitWidths(kNumMiniblocks, 0);
+    for (auto i = 0; i < deltas.size(); ++i) {
+      deltas[i] -= minDelta;
+      auto& width = bitWidths[i / kMiniblockSize];
+      width = std::max<uint8_t>(width, 64 - __builtin_clzll(deltas[i] | 1));
+    }
+    out.append(reinterpret_cast<const char*>(bitWidths.data()), kNumMiniblocks);
+    deltas.resize(bits::roundUp(deltas.size(), kMiniblockSize), 0);
+    for (auto miniblock = 0; miniblock * kMiniblockSize < deltas.size();
+         ++miniblock) {
+      const auto width = bitWidths[miniblock];
+      std::string packed(kMiniblockSize * width / 8, 0);
+      for (auto i = 0; i < kMiniblockSize; ++i) {
+        auto delta = deltas[miniblock * kMiniblockSize + i];
+        for (auto bit = 0; bit < width; ++bit) {
+          if (delta & (1UL << bit)) {
+            const auto position = i * width + bit;
+            packed[position / 8] |= 1 << (position % 8);
+          }
+        }
+      }
+      out.append(packed);
+    }
+  }
+}
+
+// Encodes 'values' as DELTA_LENGTH_BYTE_ARRAY and appends them to 'out'.
+void encodeLengths(const std::vector<std::string>& values, std::string& out) {
+  std::vector<int64_t> lengths;
+  for (const auto& value : values) {
+    lengths.push_back(value.size());
+  }
+  encodeDeltas(lengths, out);
+  for (const auto& value : values) {
+    out.append(value);
+  }
+}
+
+std::vector<std::string> readPlainStrings(
+    const BufferPtr& plain,
+    int32_t size) {
+  std::vector<std::string> values;
+  auto data = plain->as<char>();
+  for (auto offset = 0; offset < size;) {
+    int32_t length;
+    memcpy(&length, data + offset, sizeof(int32_t));
+    values.emplace_back(data + offset + sizeof(int32_t), length);
+    offset += length + sizeof(int32_t);
+  }
+  return values;
+}
+} // namespace
+
+class DeltaBpDecoderTest : public testing::Test {
+ protected:
+  template <typename T>
+  void testRoundTrip(const std::vector<int64_t>& values) {
+    std::string encoded;
+    encodeDeltas(values, encoded);
+    // A trailing byte checks that the end of the data is found.
+    encoded.push_back('x');
+    DeltaBpDecoder decoder(encoded.data(), encoded.data() + encoded.size());
+    ASSERT_EQ(values.size(), decoder.numValues());
+    std::vector<T> result(values.size());
+    decoder.readValues(result.data());
+    for (auto i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(static_cast<T>(values[i]), result[i]) << "at " << i;
+    }
+    ASSERT_EQ(encoded.data() + encoded.size() - 1, decoder.bufferStart());
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+};
+
+TEST_F(DeltaBpDecoderTest, specExamples) {
+  // 1, 2, 3, 4, 5 has a single delta of 1 and bit width 0.
+  const std::string increasing = {
+      '\x80', '\x01', '\x04', '\x05', '\x02', '\x02', 0, 0, 0, 0};
+  DeltaBpDecoder decoder(
+      increasing.data(), increasing.data() + increasing.size());
+  std::vector<int32_t> values(decoder.numValues());
+  decoder.readValues(values.data());
+  EXPECT_EQ((std::vector<int32_t>{1, 2, 3, 4, 5}), values);
+
+  // 7, 5, 3, 1, 2, 3, 4, 5 has a min delta of -2 and deltas of 0 and 3.
+  const std::string mixed = {
+      '\x80', '\x01', '\x04', '\x08', '\x0e', '\x03', 2, 0, 0, 0,
+      '\xc0', '\x3f', 0,      0,      0,      0,      0, 0};
+  DeltaBpDecoder mixedDecoder(mixed.data(), mixed.data() + mixed.size());
+  values.resize(mixedDecoder.numValues());
+  mixedDecoder.readValues(values.data());
+  EXPECT_EQ((std::vector<int32_t>{7, 5, 3, 1, 2, 3, 4, 5}), values);
+  EXPECT_EQ(mixed.data() + mixed.size(), mixedDecoder.bufferStart());
+}
+
+TEST_F(DeltaBpDecoderTest, integers) {
+  std::mt19937 rng(1);
+  for (auto numValues : {0, 1, 2, 31, 32, 33, 129, 1'000}) {
+    SCOPED_TRACE(numValues);
+    std::vector<int64_t> sorted(numValues);
+    std::vector<int64_t> small(numValues);
+    std::vector<int64_t> wide(numValues);
+    for (auto i = 0; i < numValues; ++i) {
+      sorted[i] = 1'600'000'000'000 + i * 1'000 + rng() % 10;
+      small[i] = static_cast<int32_t>(rng()) % 1'000;
+      wide[i] =
+          static_cast<int64_t>((static_cast<uint64_t>(rng()) << 32) | rng());
+    }
+    testRoundTrip<int64_t>(sorted);
+    testRoundTrip<int64_t>(wide);
+    testRoundTrip<int32_t>(small);
+  }
+  // Deltas between the ends of the INT32 range need more than 32 bits.
+  testRoundTrip<int32_t>(
+      {std::numeric_limits<int32_t>::max(),
+       std::numeric_limits<int32_t>::min(),
+       std::numeric_limits<int32_t>::max()});
+}
+
+TEST_F(DeltaBpDecoderTest, deltaLengthByteArray) {
+  std::vector<std::string> values;
+  for (auto i = 0; i < 300; ++i) {
+    values.push_back(std::string(i % 17, 'a' + i % 26));
+  }
+  std::string encoded;
+  encodeLengths(values, encoded);
+  BufferPtr plain;
+  auto size = deltaLengthByteArrayToPlain(
+      encoded.data(), encoded.data() + encoded.size(), *pool_, plain);
+  EXPECT_EQ(values, readPlainStrings(plain, size));
+
+  // Truncated string bytes are an error.
+  EXPECT_THROW(
+      deltaLengthByteArrayToPlain(
+          encoded.data(), encoded.data() + encoded.size() - 1, *pool_, plain),
+      VeloxRuntimeError);
+}
+
+TEST_F(DeltaBpDecoderTest, deltaByteArray) {
+  std::vector<std::string> values;
+  for (auto i = 0; i < 300; ++i) {
+    values.push_back(fmt::format("key-{:08}", i * 7));
+  }
+  std::vector<int64_t> prefixLengths;
+  std::vector<std::string> suffixes;
+  std::string previous;
+  for (const auto& value : values) {
+    int64_t prefix = 0;
+    while (prefix < previous.size() && prefix < value.size() &&
+           previous[prefix] == value[prefix]) {
+      ++prefix;
+    }
+    prefixLengths.push_back(prefix);
+    suffixes.push_back(value.substr(prefix));
+    previous = value;
+  }
+  std::string encoded;
+  encodeDeltas(prefixLengths, encoded);
+  encodeLengths(suffixes, encoded);
+
+  BufferPtr plain;
+  auto size = deltaByteArrayToPlain(
+      encoded.data(), encoded.data() + encoded.size(), 0, *pool_, plain);
+  EXPECT_EQ(values, readPlainStrings(plain, size));
+
+  // The same values as FIXED_LEN_BYTE_ARRAY have no lengths.
+  size = deltaByteArrayToPlain(
+      encoded.data(), encoded.data() + encoded.size(), 12, *pool_, plain);
+  ASSERT_EQ(values.size() * 12, size);
+  for (auto i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], std::string(plain->as<char>() + i * 12, 12));
+  }
+  EXPECT_THROW(
+      deltaByteArrayToPlain(
+          encoded.data(), encoded.data() + encoded.size(), 10, *pool_, plain),
+      VeloxRuntimeError);
+}
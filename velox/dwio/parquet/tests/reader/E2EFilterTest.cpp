@@ -16,6 +16,7 @@
 
 #include "velox/dwio/common/tests/E2EFilterTestBase.h"
 #include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/writer/NativeWriter.h"
 #include "velox/dwio/parquet/writer/Writer.h"
 
 #include <folly/init/Init.h>
@@ -60,6 +61,23 @@ class E2EFilterTest : public E2EFilterTestBase {
     auto sink = std::make_unique<MemorySink>(*pool_, 200 * 1024 * 1024);
     sinkPtr_ = sink.get();
 
+    if (useNativeWriter_) {
+      NativeWriterOptions options;
+      options.rowsInRowGroup = rowGroupSize_;
+      options.dataPageSize = 4 * 1024;
+      // Columns of unique values switch to PLAIN within the row group.
+      options.dictionaryPageSizeLimit = 16 * 1024;
+      NativeWriter writer(
+          std::move(sink),
+          *pool_,
+          asRowType(batches[0]->type()),
+          options);
+      for (auto& batch : batches) {
+        writer.write(batch);
+      }
+      writer.close();
+      return;
+    }
     writer_ = std::make_unique<facebook::velox::parquet::Writer>(
         std::move(sink), *pool_, rowGroupSize_, writerProperties_);
     for (auto& batch : batches) {
@@ -68,6 +86,13 @@ class E2EFilterTest : public E2EFilterTestBase {
     writer_->close();
   }
 
+  void setUpRowReaderOptions(
+      dwio::common::RowReaderOptions& opts,
+      const std::shared_ptr<ScanSpec>& spec) override {
+    E2EFilterTestBase::setUpRowReaderOptions(opts, spec);
+    opts.setReturnDictionaryVectors(returnDictionaryVectors_);
+  }
+
   std::unique_ptr<dwio::common::Reader> makeReader(
       const dwio::common::ReaderOptions& opts,
       std::unique_ptr<dwio::common::BufferedInput> input) override {
@@ -77,6 +102,8 @@ class E2EFilterTest : public E2EFilterTestBase {
   std::unique_ptr<facebook::velox::parquet::Writer> writer_;
   std::shared_ptr<::parquet::WriterProperties> writerProperties_;
   int32_t rowGroupSize_{10000};
+  bool returnDictionaryVectors_{false};
+  bool useNativeWriter_{false};
 };
 
 TEST_F(E2EFilterTest, writerMagic) {
@@ -206,6 +233,44 @@ TEST_F(E2EFilterTest, integerDictionary) {
       20);
 }
 
+TEST_F(E2EFilterTest, integerDictionaryVectors) {
+  // A small dictionary page limit makes the chunks of 'int_val' fall back to
+  // direct pages, so that reads go from dictionary indices to values.
+  writerProperties_ = ::parquet::WriterProperties::Builder()
+                          .data_pagesize(4 * 1024)
+                          ->dictionary_pagesize_limit(2 * 1024)
+                          ->build();
+  returnDictionaryVectors_ = true;
+
+  testWithTypes(
+      "int_val:int,"
+      "long_val:bigint",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            "long_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true); // keepNulls
+
+        makeIntDistribution<int32_t>(
+            "int_val",
+            10, // min
+            1000000, // max
+            1, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            100000000, // rareMax
+            true); // keepNulls
+      },
+      true,
+      {"int_val", "long_val"},
+      20);
+}
+
 TEST_F(E2EFilterTest, floatAndDoubleDirect) {
   writerProperties_ = ::parquet::WriterProperties::Builder()
                           .disable_dictionary()
@@ -424,6 +489,53 @@ TEST_F(E2EFilterTest, stringDictionary) {
       20);
 }
 
+TEST_F(E2EFilterTest, stringDictionaryNoMatch) {
+  rowType_ = test::DataSetBuilder::makeRowType(
+      "string_val:string,"
+      "long_val:bigint",
+      false);
+  filterGenerator_ = std::make_unique<FilterGenerator>(rowType_, 1);
+  auto batches = makeDataset(
+      [&]() { makeStringDistribution("string_val", 20, true, false); }, false);
+  writeToMemory(rowType_, batches, false);
+
+  // No dictionary entry passes, so no row is returned whether or not the
+  // column chunks are skipped.
+  SubfieldFilters filters;
+  filters[Subfield("string_val")] = std::make_unique<BytesValues>(
+      std::vector<std::string>{"no such value", "nor this one"}, false);
+  auto spec = filterGenerator_->makeScanSpec(std::move(filters));
+  uint64_t time = 0;
+  readWithFilter(spec, batches, {}, time, false);
+}
+
+TEST_F(E2EFilterTest, nativeWriter) {
+  useNativeWriter_ = true;
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "string_val_2:string",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            "long_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true); // keepNulls
+        makeStringDistribution("string_val", 100, true, false);
+        makeStringUnique("string_val_2");
+      },
+      false,
+      {"short_val", "int_val", "long_val", "string_val", "string_val_2"},
+      20);
+}
+
 TEST_F(E2EFilterTest, dedictionarize) {
   writerProperties_ = ::parquet::WriterProperties::Builder()
                           .max_row_group_length(10000000)
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+constexpr int64_t kChunkOffset = 1'000;
+
+std::string int64Bytes(int64_t value) {
+  return std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Makes an OffsetIndex of pages of 100 rows and 1000 bytes each.
+thrift::OffsetIndex makeOffsetIndex(int32_t numPages) {
+  thrift::OffsetIndex index;
+  for (auto i = 0; i < numPages; ++i) {
+    thrift::PageLocation location;
+    location.__set_offset(kChunkOffset + i * 1'000);
+    location.__set_compressed_page_size(1'000);
+    location.__set_first_row_index(i * 100);
+    index.page_locations.push_back(location);
+  }
+  return index;
+}
+
+// Makes a ColumnIndex where page 'i' has values from i * 100 to i * 100 + 99
+// and 'nullCounts[i]' nulls. A page with 100 nulls is a null page.
+thrift::ColumnIndex makeColumnIndex(const std::vector<int64_t>& nullCounts) {
+  thrift::ColumnIndex index;
+  for (auto i = 0; i < nullCounts.size(); ++i) {
+    const bool allNull = nullCounts[i] == 100;
+    index.null_pages.push_back(allNull);
+    index.min_values.push_back(allNull ? "" : int64Bytes(i * 100));
+    index.max_values.push_back(allNull ? "" : int64Bytes(i * 100 + 99));
+  }
+  index.__set_null_counts(nullCounts);
+  return index;
+}
+
+std::vector<bool> filteredOut(const std::vector<IndexedPage>& pages) {
+  std::vector<bool> result;
+  for (const auto& page : pages) {
+    result.push_back(page.filteredOut);
+  }
+  return result;
+}
+} // namespace
+
+TEST(PageIndexTest, locations) {
+  auto pages = makeIndexedPages(
+      makeOffsetIndex(3), nullptr, nullptr, BIGINT(), kChunkOffset, 300);
+  ASSERT_EQ(3, pages.size());
+  for (auto i = 0; i < pages.size(); ++i) {
+    EXPECT_EQ(i * 1'000, pages[i].offset);
+    EXPECT_EQ(i * 100, pages[i].firstRow);
+    EXPECT_FALSE(pages[i].filteredOut);
+  }
+
+  auto badIndex = makeOffsetIndex(3);
+  badIndex.page_locations[2].first_row_index = 100;
+  EXPECT_THROW(
+      makeIndexedPages(badIndex, nullptr, nullptr, BIGINT(), kChunkOffset, 300),
+      VeloxRuntimeError);
+}
+
+TEST(PageIndexTest, filter) {
+  auto offsetIndex = makeOffsetIndex(4);
+  auto columnIndex = makeColumnIndex({0, 10, 100, 0});
+
+  common::BigintRange range(150, 320, false);
+  EXPECT_EQ(
+      (std::vector<bool>{true, false, true, false}),
+      filteredOut(makeIndexedPages(
+          offsetIndex, &columnIndex, &range, BIGINT(), kChunkOffset, 400)));
+
+  // The null page and the page with nulls may pass a filter allowing nulls.
+  common::BigintRange nullAllowed(350, 360, true);
+  EXPECT_EQ(
+      (std::vector<bool>{true, false, false, false}),
+      filteredOut(makeIndexedPages(
+          offsetIndex,
+          &columnIndex,
+          &nullAllowed,
+          BIGINT(),
+          kChunkOffset,
+          400)));
+
+  common::IsNull isNull;
+  EXPECT_EQ(
+      (std::vector<bool>{true, false, false, true}),
+      filteredOut(makeIndexedPages(
+          offsetIndex, &columnIndex, &isNull, BIGINT(), kChunkOffset, 400)));
+
+  // A ColumnIndex with the wrong number of pages is ignored.
+  columnIndex.min_values.pop_back();
+  EXPECT_EQ(
+      (std::vector<bool>{false, false, false, false}),
+      filteredOut(makeIndexedPages(
+          offsetIndex, &columnIndex, &range, BIGINT(), kChunkOffset, 400)));
+}
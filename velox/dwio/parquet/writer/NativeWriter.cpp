@@ -0,0 +1,734 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+#include <folly/Varint.h>
+#include <folly/container/F14Map.h>
+#include <snappy.h>
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <thrift/transport/TBufferTransports.h> //@manual
+#include <zlib.h>
+#include <zstd.h>
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/RawVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::parquet {
+
+using thrift::Encoding;
+
+namespace {
+
+constexpr char kMagic[] = "PAR1";
+constexpr int32_t kMagicSize = 4;
+
+// Serializes 'object' with the compact protocol and appends it to 'out'.
+// Returns the number of bytes appended.
+template <typename T>
+int64_t appendThrift(const T& object, dwio::common::DataBuffer<char>& out) {
+  auto buffer = std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+  apache::thrift::protocol::TCompactProtocolT<
+      apache::thrift::transport::TMemoryBuffer>
+      protocol(buffer);
+  object.write(&protocol);
+  uint8_t* data;
+  uint32_t size;
+  buffer->getBuffer(&data, &size);
+  out.extendAppend(out.size(), reinterpret_cast<const char*>(data), size);
+  return size;
+}
+
+void appendVarint(uint64_t value, std::string& out) {
+  uint8_t buffer[folly::kMaxVarintLength64];
+  auto size = folly::encodeVarint(value, buffer);
+  out.append(reinterpret_cast<const char*>(buffer), size);
+}
+
+// Returns the number of values from 'begin' equal to values[begin].
+int32_t runLength(const int32_t* values, int32_t begin, int32_t end) {
+  auto i = begin + 1;
+  while (i < end && values[i] == values[begin]) {
+    ++i;
+  }
+  return i - begin;
+}
+
+// Appends the RLE/bit-packed hybrid encoding of 'numValues' 'values' of
+// 'bitWidth' bits to 'out'. Runs of at least 8 equal values are RLE encoded,
+// the rest is bit-packed in groups of 8 values.
+void encodeRleBp(
+    const int32_t* values,
+    int32_t numValues,
+    int32_t bitWidth,
+    std::string& out) {
+  VELOX_DCHECK(bitWidth > 0 && bitWidth <= 32);
+  const int32_t valueBytes = bits::roundUp(bitWidth, 8) / 8;
+  int32_t i = 0;
+  while (i < numValues) {
+    const auto run = runLength(values, i, numValues);
+    if (run >= 8) {
+      appendVarint(static_cast<uint64_t>(run) << 1, out);
+      out.append(reinterpret_cast<const char*>(&values[i]), valueBytes);
+      i += run;
+      continue;
+    }
+    // A bit-packed run ends at the next RLE run. The last group is padded
+    // with zeros if it is at the end of the values.
+    const auto begin = i;
+    int32_t numGroups = 0;
+    do {
+      i += 8;
+      ++numGroups;
+    } while (i < numValues && numGroups < 63 &&
+             runLength(values, i, numValues) < 8);
+    i = std::min(i, numValues);
+    appendVarint((numGroups << 1) | 1, out);
+    auto offset = out.size();
+    out.resize(offset + numGroups * bitWidth);
+    auto packed = reinterpret_cast<uint8_t*>(out.data()) + offset;
+    uint64_t buffer = 0;
+    int32_t numBits = 0;
+    for (auto j = begin; j < begin + numGroups * 8; ++j) {
+      const uint64_t value = j < numValues ? static_cast<uint32_t>(values[j])
+                                           : 0;
+      buffer |= value << numBits;
+      numBits += bitWidth;
+      while (numBits >= 8) {
+        *packed++ = buffer;
+        buffer >>= 8;
+        numBits -= 8;
+      }
+    }
+  }
+}
+
+// Returns 'data' compressed with 'codec'. Returns 'data' itself if
+// uncompressed.
+std::string_view compress(
+    thrift::CompressionCodec::type codec,
+    std::string_view data,
+    std::string& buffer) {
+  switch (codec) {
+    case thrift::CompressionCodec::UNCOMPRESSED:
+      return data;
+    case thrift::CompressionCodec::SNAPPY: {
+      buffer.resize(snappy::MaxCompressedLength(data.size()));
+      size_t size;
+      snappy::RawCompress(data.data(), data.size(), buffer.data(), &size);
+      return std::string_view(buffer.data(), size);
+    }
+    case thrift::CompressionCodec::ZSTD: {
+      buffer.resize(ZSTD_compressBound(data.size()));
+      auto size = ZSTD_compress(
+          buffer.data(), buffer.size(), data.data(), data.size(), 1);
+      VELOX_CHECK(
+          !ZSTD_isError(size),
+          "ZSTD returned an error: {}",
+          ZSTD_getErrorName(size));
+      return std::string_view(buffer.data(), size);
+    }
+    case thrift::CompressionCodec::GZIP: {
+      z_stream stream;
+      memset(&stream, 0, sizeof(stream));
+      // 16 added to the window bits writes a gzip header.
+      constexpr int kGzipWindowBits = 15 + 16;
+      auto ret = deflateInit2(
+          &stream,
+          Z_DEFAULT_COMPRESSION,
+          Z_DEFLATED,
+          kGzipWindowBits,
+          8,
+          Z_DEFAULT_STRATEGY);
+      VELOX_CHECK_EQ(ret, Z_OK, "zlib deflateInit failed");
+      buffer.resize(deflateBound(&stream, data.size()));
+      stream.next_in =
+          const_cast<Bytef*>(reinterpret_cast<const Bytef*>(data.data()));
+      stream.avail_in = data.size();
+      stream.next_out = reinterpret_cast<Bytef*>(buffer.data());
+      stream.avail_out = buffer.size();
+      ret = deflate(&stream, Z_FINISH);
+      deflateEnd(&stream);
+      VELOX_CHECK_EQ(ret, Z_STREAM_END, "zlib deflate failed");
+      return std::string_view(buffer.data(), stream.total_out);
+    }
+    default:
+      VELOX_USER_FAIL(
+          "Unsupported Parquet compression type {}", static_cast<int>(codec));
+  }
+}
+
+thrift::SchemaElement makeSchemaElement(
+    const std::string& name,
+    const TypePtr& type) {
+  thrift::SchemaElement element;
+  element.__set_name(name);
+  element.__set_repetition_type(thrift::FieldRepetitionType::OPTIONAL);
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+      element.__set_type(thrift::Type::INT32);
+      element.__set_converted_type(thrift::ConvertedType::INT_8);
+      break;
+    case TypeKind::SMALLINT:
+      element.__set_type(thrift::Type::INT32);
+      element.__set_converted_type(thrift::ConvertedType::INT_16);
+      break;
+    case TypeKind::INTEGER:
+      element.__set_type(thrift::Type::INT32);
+      break;
+    case TypeKind::DATE:
+      element.__set_type(thrift::Type::INT32);
+      element.__set_converted_type(thrift::ConvertedType::DATE);
+      break;
+    case TypeKind::BIGINT:
+      element.__set_type(thrift::Type::INT64);
+      break;
+    case TypeKind::REAL:
+      element.__set_type(thrift::Type::FLOAT);
+      break;
+    case TypeKind::DOUBLE:
+      element.__set_type(thrift::Type::DOUBLE);
+      break;
+    case TypeKind::VARCHAR:
+      element.__set_type(thrift::Type::BYTE_ARRAY);
+      element.__set_converted_type(thrift::ConvertedType::UTF8);
+      break;
+    case TypeKind::VARBINARY:
+      element.__set_type(thrift::Type::BYTE_ARRAY);
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Type {} of column {} is not supported by the native Parquet writer",
+          type->toString(),
+          name);
+  }
+  return element;
+}
+
+// Converts a Velox value to the value written to Parquet.
+template <typename TValue, typename TInput>
+TValue toParquetValue(const TInput& value) {
+  return value;
+}
+
+template <>
+int32_t toParquetValue(const Date& value) {
+  return value.days();
+}
+
+// The dictionary key of a value. Floating point values are keyed by their bits
+// so that NaNs and negative zeros keep their own entries.
+template <typename TValue>
+struct DictionaryKey {
+  using type = TValue;
+};
+
+template <>
+struct DictionaryKey<float> {
+  using type = uint32_t;
+};
+
+template <>
+struct DictionaryKey<double> {
+  using type = uint64_t;
+};
+
+template <>
+struct DictionaryKey<StringView> {
+  using type = std::string;
+};
+
+} // namespace
+
+/// Encodes the values of one column into the column chunk of the current row
+/// group.
+class ColumnChunkWriter {
+ public:
+  virtual ~ColumnChunkWriter() = default;
+
+  /// Appends all the rows of 'vector'.
+  virtual void append(const BaseVector& vector) = 0;
+
+  /// Returns the bytes buffered for the current column chunk.
+  virtual int64_t bufferedBytes() const = 0;
+
+  /// Appends the column chunk to 'out', which starts at 'fileOffset' in the
+  /// file, and returns its metadata. Starts a new column chunk.
+  virtual thrift::ColumnChunk finish(
+      int64_t fileOffset,
+      dwio::common::DataBuffer<char>& out) = 0;
+};
+
+namespace {
+
+template <typename TInput, typename TValue>
+class TypedColumnChunkWriter : public ColumnChunkWriter {
+ public:
+  using Key = typename DictionaryKey<TValue>::type;
+  static constexpr bool kIsString = std::is_same_v<TValue, StringView>;
+  // Min and max values for the statistics.
+  using Stat = std::conditional_t<kIsString, std::string, TValue>;
+
+  TypedColumnChunkWriter(
+      std::string name,
+      thrift::Type::type parquetType,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool)
+      : name_(std::move(name)),
+        parquetType_(parquetType),
+        options_(options),
+        pages_(pool),
+        useDictionary_(options.enableDictionary) {}
+
+  void append(const BaseVector& vector) override {
+    decoded_.decode(vector);
+    // The dictionary ids of the distinct values of a dictionary encoded
+    // input are looked up once.
+    bool cacheIds = useDictionary_ && !decoded_.isIdentityMapping();
+    if (cacheIds) {
+      baseIds_.resize(decoded_.base()->size());
+      std::fill(baseIds_.begin(), baseIds_.end(), -1);
+    }
+    const auto size = vector.size();
+    for (vector_size_t i = 0; i < size; ++i) {
+      ++numValues_;
+      if (decoded_.isNullAt(i)) {
+        defineLevels_.push_back(0);
+        ++nullCount_;
+      } else {
+        defineLevels_.push_back(1);
+        if (useDictionary_) {
+          int32_t id;
+          if (cacheIds) {
+            auto& cachedId = baseIds_[decoded_.index(i)];
+            if (cachedId < 0) {
+              cachedId = dictionaryId(valueAt(i));
+            }
+            id = cachedId;
+          } else {
+            id = dictionaryId(valueAt(i));
+          }
+          indices_.push_back(id);
+          if (dictionaryPlain_.size() > options_.dictionaryPageSizeLimit) {
+            // The rest of the chunk is PLAIN encoded.
+            flushPage();
+            useDictionary_ = false;
+            cacheIds = false;
+          }
+        } else {
+          auto value = valueAt(i);
+          appendPlain(value, plain_);
+          updateStats(value);
+        }
+      }
+      if (pageBytes() >= options_.dataPageSize) {
+        flushPage();
+      }
+    }
+  }
+
+  int64_t bufferedBytes() const override {
+    return pages_.size() + dictionaryPlain_.size() + pageBytes();
+  }
+
+  thrift::ColumnChunk finish(
+      int64_t fileOffset,
+      dwio::common::DataBuffer<char>& out) override {
+    flushPage();
+    thrift::ColumnMetaData metaData;
+    std::vector<thrift::PageEncodingStats> encodingStats;
+    std::vector<Encoding::type> encodings = {Encoding::RLE};
+    int64_t offset = fileOffset;
+    if (numDictionaryPages_ > 0) {
+      thrift::DictionaryPageHeader dictionaryHeader;
+      dictionaryHeader.__set_num_values(dictionary_.size());
+      dictionaryHeader.__set_encoding(Encoding::PLAIN);
+      thrift::PageHeader header;
+      header.__set_type(thrift::PageType::DICTIONARY_PAGE);
+      header.__set_dictionary_page_header(dictionaryHeader);
+      metaData.__set_dictionary_page_offset(offset);
+      offset += appendPage(header, dictionaryPlain_, out);
+      encodingStats.push_back(makeEncodingStats(
+          thrift::PageType::DICTIONARY_PAGE, Encoding::PLAIN, 1));
+      encodingStats.push_back(makeEncodingStats(
+          thrift::PageType::DATA_PAGE,
+          Encoding::RLE_DICTIONARY,
+          numDictionaryPages_));
+      encodings.push_back(Encoding::PLAIN);
+      encodings.push_back(Encoding::RLE_DICTIONARY);
+    }
+    if (numPlainPages_ > 0) {
+      encodingStats.push_back(makeEncodingStats(
+          thrift::PageType::DATA_PAGE, Encoding::PLAIN, numPlainPages_));
+      if (numDictionaryPages_ == 0) {
+        encodings.push_back(Encoding::PLAIN);
+      }
+    }
+    metaData.__set_data_page_offset(offset);
+    out.extendAppend(out.size(), pages_.data(), pages_.size());
+
+    metaData.__set_type(parquetType_);
+    metaData.__set_encodings(encodings);
+    metaData.__set_path_in_schema({name_});
+    metaData.__set_codec(options_.compression);
+    metaData.__set_num_values(numValues_);
+    metaData.__set_total_uncompressed_size(uncompressedBytes_);
+    metaData.__set_total_compressed_size(compressedBytes_);
+    metaData.__set_statistics(makeStatistics());
+    metaData.__set_encoding_stats(encodingStats);
+
+    thrift::ColumnChunk chunk;
+    chunk.__set_file_offset(fileOffset);
+    chunk.__set_meta_data(metaData);
+    reset();
+    return chunk;
+  }
+
+ private:
+  TValue valueAt(vector_size_t row) const {
+    return toParquetValue<TValue>(decoded_.valueAt<TInput>(row));
+  }
+
+  static void appendPlain(const TValue& value, std::string& out) {
+    if constexpr (kIsString) {
+      const int32_t length = value.size();
+      out.append(reinterpret_cast<const char*>(&length), sizeof(int32_t));
+      out.append(value.data(), value.size());
+    } else {
+      out.append(reinterpret_cast<const char*>(&value), sizeof(TValue));
+    }
+  }
+
+  static Key toKey(const TValue& value) {
+    if constexpr (kIsString) {
+      return std::string(value.data(), value.size());
+    } else {
+      Key key;
+      static_assert(sizeof(Key) == sizeof(TValue));
+      memcpy(&key, &value, sizeof(Key));
+      return key;
+    }
+  }
+
+  // Returns the id of 'value' in the dictionary of the column chunk, adding
+  // it if new.
+  int32_t dictionaryId(const TValue& value) {
+    auto result = dictionary_.emplace(toKey(value), dictionary_.size());
+    if (result.second) {
+      appendPlain(value, dictionaryPlain_);
+      updateStats(value);
+    }
+    return result.first->second;
+  }
+
+  void updateStats(const TValue& value) {
+    if constexpr (std::is_floating_point_v<TValue>) {
+      if (std::isnan(value)) {
+        return;
+      }
+    }
+    Stat stat;
+    if constexpr (kIsString) {
+      stat = std::string(value.data(), value.size());
+    } else {
+      stat = value;
+    }
+    if (!min_.has_value() || stat < min_.value()) {
+      min_ = stat;
+    }
+    if (!max_.has_value() || max_.value() < stat) {
+      max_ = std::move(stat);
+    }
+  }
+
+  thrift::Statistics makeStatistics() const {
+    thrift::Statistics statistics;
+    statistics.__set_null_count(nullCount_);
+    if (min_.has_value()) {
+      statistics.__set_min_value(statToBytes(min_.value()));
+      statistics.__set_max_value(statToBytes(max_.value()));
+    }
+    return statistics;
+  }
+
+  static std::string statToBytes(const Stat& stat) {
+    if constexpr (kIsString) {
+      return stat;
+    } else {
+      return std::string(reinterpret_cast<const char*>(&stat), sizeof(Stat));
+    }
+  }
+
+  static thrift::PageEncodingStats makeEncodingStats(
+      thrift::PageType::type pageType,
+      Encoding::type encoding,
+      int32_t count) {
+    thrift::PageEncodingStats stats;
+    stats.__set_page_type(pageType);
+    stats.__set_encoding(encoding);
+    stats.__set_count(count);
+    return stats;
+  }
+
+  int64_t pageBytes() const {
+    return plain_.size() + indices_.size() * sizeof(int32_t);
+  }
+
+  // Encodes the values since the last page into a data page.
+  void flushPage() {
+    if (defineLevels_.empty()) {
+      return;
+    }
+    pageBody_.clear();
+    pageBody_.resize(sizeof(int32_t));
+    encodeRleBp(defineLevels_.data(), defineLevels_.size(), 1, pageBody_);
+    const int32_t levelsSize = pageBody_.size() - sizeof(int32_t);
+    memcpy(pageBody_.data(), &levelsSize, sizeof(int32_t));
+    thrift::DataPageHeader dataHeader;
+    dataHeader.__set_num_values(defineLevels_.size());
+    dataHeader.__set_definition_level_encoding(Encoding::RLE);
+    dataHeader.__set_repetition_level_encoding(Encoding::RLE);
+    if (useDictionary_) {
+      int32_t bitWidth = 1;
+      while ((1UL << bitWidth) < dictionary_.size()) {
+        ++bitWidth;
+      }
+      pageBody_.push_back(bitWidth);
+      encodeRleBp(indices_.data(), indices_.size(), bitWidth, pageBody_);
+      dataHeader.__set_encoding(Encoding::RLE_DICTIONARY);
+      ++numDictionaryPages_;
+    } else {
+      pageBody_.append(plain_);
+      dataHeader.__set_encoding(Encoding::PLAIN);
+      ++numPlainPages_;
+    }
+    thrift::PageHeader header;
+    header.__set_type(thrift::PageType::DATA_PAGE);
+    header.__set_data_page_header(dataHeader);
+    appendPage(header, pageBody_, pages_);
+    defineLevels_.clear();
+    indices_.clear();
+    plain_.clear();
+  }
+
+  // Appends a page with 'header' and 'body' to 'out' and returns its size.
+  int64_t appendPage(
+      thrift::PageHeader& header,
+      std::string_view body,
+      dwio::common::DataBuffer<char>& out) {
+    auto compressed = compress(options_.compression, body, compressed_);
+    header.__set_uncompressed_page_size(body.size());
+    header.__set_compressed_page_size(compressed.size());
+    const auto headerSize = appendThrift(header, out);
+    out.extendAppend(out.size(), compressed.data(), compressed.size());
+    uncompressedBytes_ += headerSize + body.size();
+    compressedBytes_ += headerSize + compressed.size();
+    return headerSize + compressed.size();
+  }
+
+  void reset() {
+    pages_.resize(0);
+    dictionary_.clear();
+    dictionaryPlain_.clear();
+    useDictionary_ = options_.enableDictionary;
+    numDictionaryPages_ = 0;
+    numPlainPages_ = 0;
+    numValues_ = 0;
+    nullCount_ = 0;
+    uncompressedBytes_ = 0;
+    compressedBytes_ = 0;
+    min_.reset();
+    max_.reset();
+  }
+
+  const std::string name_;
+  const thrift::Type::type parquetType_;
+  const NativeWriterOptions& options_;
+  DecodedVector decoded_;
+
+  // Dictionary ids of the values of the base vector of 'decoded_'. -1 for
+  // values not looked up yet.
+  std::vector<int32_t> baseIds_;
+
+  // The definition levels, dictionary ids and PLAIN values of the current
+  // page.
+  raw_vector<int32_t> defineLevels_;
+  raw_vector<int32_t> indices_;
+  std::string plain_;
+
+  // Buffers for encoding and compressing a page.
+  std::string pageBody_;
+  std::string compressed_;
+
+  // The data pages of the column chunk.
+  dwio::common::DataBuffer<char> pages_;
+
+  // The dictionary of the column chunk and its PLAIN encoding.
+  folly::F14FastMap<Key, int32_t> dictionary_;
+  std::string dictionaryPlain_;
+
+  // True while the column chunk is dictionary encoded.
+  bool useDictionary_;
+  int32_t numDictionaryPages_{0};
+  int32_t numPlainPages_{0};
+
+  int64_t numValues_{0};
+  int64_t nullCount_{0};
+  int64_t uncompressedBytes_{0};
+  int64_t compressedBytes_{0};
+  std::optional<Stat> min_;
+  std::optional<Stat> max_;
+};
+
+std::unique_ptr<ColumnChunkWriter> makeColumnChunkWriter(
+    const thrift::SchemaElement& element,
+    const TypePtr& type,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool) {
+  const auto& name = element.name;
+  const auto parquetType = element.type;
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+      return std::make_unique<TypedColumnChunkWriter<int8_t, int32_t>>(
+          name, parquetType, options, pool);
+    case TypeKind::SMALLINT:
+      return std::make_unique<TypedColumnChunkWriter<int16_t, int32_t>>(
+          name, parquetType, options, pool);
+    case TypeKind::INTEGER:
+      return std::make_unique<TypedColumnChunkWriter<int32_t, int32_t>>(
+          name, parquetType, options, pool);
+    case TypeKind::DATE:
+      return std::make_unique<TypedColumnChunkWriter<Date, int32_t>>(
+          name, parquetType, options, pool);
+    case TypeKind::BIGINT:
+      return std::make_unique<TypedColumnChunkWriter<int64_t, int64_t>>(
+          name, parquetType, options, pool);
+    case TypeKind::REAL:
+      return std::make_unique<TypedColumnChunkWriter<float, float>>(
+          name, parquetType, options, pool);
+    case TypeKind::DOUBLE:
+      return std::make_unique<TypedColumnChunkWriter<double, double>>(
+          name, parquetType, options, pool);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<TypedColumnChunkWriter<StringView, StringView>>(
+          name, parquetType, options, pool);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+} // namespace
+
+NativeWriter::NativeWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    memory::MemoryPool& pool,
+    RowTypePtr type,
+    NativeWriterOptions options)
+    : pool_(pool),
+      type_(std::move(type)),
+      options_(std::move(options)),
+      sink_(std::move(sink)) {
+  VELOX_USER_CHECK_GT(type_->size(), 0, "Parquet files need a column");
+  thrift::SchemaElement root;
+  root.__set_name("schema");
+  root.__set_repetition_type(thrift::FieldRepetitionType::REQUIRED);
+  root.__set_num_children(type_->size());
+  metaData_.schema.push_back(root);
+  for (auto i = 0; i < type_->size(); ++i) {
+    auto element = makeSchemaElement(type_->nameOf(i), type_->childAt(i));
+    columns_.push_back(
+        makeColumnChunkWriter(element, type_->childAt(i), options_, pool_));
+    metaData_.schema.push_back(std::move(element));
+  }
+  metaData_.__set_version(1);
+  metaData_.__set_created_by("velox");
+
+  dwio::common::DataBuffer<char> magic(pool_);
+  magic.append(0, kMagic, kMagicSize);
+  sink_->write(std::move(magic));
+  fileOffset_ = kMagicSize;
+}
+
+NativeWriter::~NativeWriter() = default;
+
+void NativeWriter::write(const RowVectorPtr& data) {
+  VELOX_CHECK(!closed_, "Writing to a closed Parquet writer");
+  VELOX_CHECK(
+      data->type()->equivalent(*type_),
+      "Type {} of the data does not match the type {} of the writer",
+      data->type()->toString(),
+      type_->toString());
+  for (auto i = 0; i < columns_.size(); ++i) {
+    columns_[i]->append(*data->childAt(i));
+  }
+  numRowGroupRows_ += data->size();
+  if (numRowGroupRows_ >= options_.rowsInRowGroup) {
+    flushRowGroup();
+    return;
+  }
+  int64_t bytes = 0;
+  for (auto& column : columns_) {
+    bytes += column->bufferedBytes();
+  }
+  if (bytes >= options_.bytesInRowGroup) {
+    flushRowGroup();
+  }
+}
+
+void NativeWriter::newRowGroup() {
+  flushRowGroup();
+}
+
+void NativeWriter::flushRowGroup() {
+  if (numRowGroupRows_ == 0) {
+    return;
+  }
+  thrift::RowGroup rowGroup;
+  dwio::common::DataBuffer<char> buffer(pool_);
+  int64_t totalBytes = 0;
+  for (auto& column : columns_) {
+    auto chunk = column->finish(fileOffset_ + buffer.size(), buffer);
+    totalBytes += chunk.meta_data.total_uncompressed_size;
+    rowGroup.columns.push_back(std::move(chunk));
+  }
+  rowGroup.__set_num_rows(numRowGroupRows_);
+  rowGroup.__set_total_byte_size(totalBytes);
+  rowGroup.__set_file_offset(fileOffset_);
+  rowGroup.__set_total_compressed_size(buffer.size());
+  metaData_.row_groups.push_back(std::move(rowGroup));
+  metaData_.num_rows += numRowGroupRows_;
+  numRowGroupRows_ = 0;
+  fileOffset_ += buffer.size();
+  sink_->write(std::move(buffer));
+}
+
+void NativeWriter::close() {
+  if (closed_) {
+    return;
+  }
+  flushRowGroup();
+  dwio::common::DataBuffer<char> footer(pool_);
+  const int32_t footerSize = appendThrift(metaData_, footer);
+  footer.extendAppend(
+      footer.size(), reinterpret_cast<const char*>(&footerSize), 4);
+  footer.extendAppend(footer.size(), kMagic, kMagicSize);
+  sink_->write(std::move(footer));
+  sink_->close();
+  closed_ = true;
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet {
+
+class ColumnChunkWriter;
+
+struct NativeWriterOptions {
+  /// A new row group is started after this many top level rows.
+  int64_t rowsInRowGroup{1'000'000};
+
+  /// A new row group is started when the buffered column chunks reach this
+  /// many bytes.
+  int64_t bytesInRowGroup{128 << 20};
+
+  /// The target size of the encoded values of a data page.
+  int32_t dataPageSize{1 << 20};
+
+  /// Column chunks are dictionary encoded until their dictionary reaches this
+  /// many bytes. The following pages are PLAIN encoded.
+  int32_t dictionaryPageSizeLimit{1 << 20};
+
+  bool enableDictionary{true};
+
+  /// One of UNCOMPRESSED, SNAPPY, ZSTD or GZIP.
+  thrift::CompressionCodec::type compression{
+      thrift::CompressionCodec::UNCOMPRESSED};
+};
+
+/// Writes Velox vectors into a DataSink as Parquet without converting them to
+/// Arrow. The values are read through DecodedVector, so that the distinct
+/// values of dictionary encoded input are looked up in the dictionary of the
+/// column chunk once per batch. Supports top level columns of TINYINT,
+/// SMALLINT, INTEGER, BIGINT, DATE, REAL, DOUBLE, VARCHAR and VARBINARY. Each
+/// row group is written to the sink as soon as it is complete. See Writer for
+/// the other types.
+class NativeWriter {
+ public:
+  /// Constructs a writer for 'type' with output to 'sink'. 'pool' is used for
+  /// the buffered column chunks.
+  NativeWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      memory::MemoryPool& pool,
+      RowTypePtr type,
+      NativeWriterOptions options = {});
+
+  ~NativeWriter();
+
+  /// Appends 'data' into the writer.
+  void write(const RowVectorPtr& data);
+
+  /// Forces a row group boundary before the data added by next write().
+  void newRowGroup();
+
+  /// Closes 'this'. Writes the last row group and the footer to the sink and
+  /// closes it. After close, data can no longer be added.
+  void close();
+
+ private:
+  // Writes the buffered column chunks as a row group, if there are any rows.
+  void flushRowGroup();
+
+  memory::MemoryPool& pool_;
+  const RowTypePtr type_;
+  const NativeWriterOptions options_;
+  std::unique_ptr<dwio::common::DataSink> sink_;
+  std::vector<std::unique_ptr<ColumnChunkWriter>> columns_;
+  thrift::FileMetaData metaData_;
+
+  // Bytes written to 'sink_' so far.
+  int64_t fileOffset_{0};
+
+  // Rows buffered in 'columns_'.
+  int64_t numRowGroupRows_{0};
+  bool closed_{false};
+};
+
+} // namespace facebook::velox::parquet
@@ -71,7 +71,9 @@ class Aggregate {
     return true;
   }
 
-  void setAllocator(HashStringAllocator* allocator) {
+  // setAllocator() and setOffsets() are virtual so that an aggregate wrapping
+  // another one can place the wrapped accumulator in its own part of the row.
+  virtual void setAllocator(HashStringAllocator* allocator) {
     allocator_ = allocator;
   }
 
@@ -83,7 +85,7 @@ class Aggregate {
   // the row. Only applies to accumulators that store variable size data out of
   // line. Fixed length accumulators do not use this. 0 if the row does not have
   // a size field.
-  void setOffsets(
+  virtual void setOffsets(
       int32_t offset,
       int32_t nullByte,
       uint8_t nullMask,
@@ -175,6 +177,61 @@ class Aggregate {
       const std::vector<VectorPtr>& args,
       bool mayPushdown) = 0;
 
+  // Returns true if raw input added to a single group accumulator can be
+  // removed from it with removeSingleGroupRawInput(). This is used to
+  // compute aggregates over sliding window frames incrementally.
+  virtual bool supportsRemoveRawInput() const {
+    return false;
+  }
+
+  // Removes raw input data previously added by addSingleGroupRawInput() from
+  // the single group accumulator. Null values are skipped like on addition.
+  // The caller reinitializes the group instead of removing its last non-null
+  // input, so the null flag of the group does not need to be restored.
+  // @param group Pointer to the start of the group row.
+  // @param rows Rows of the 'args' to remove from the accumulator. 'rows' is
+  // guaranteed to have at least one active row.
+  // @param args Raw input to remove from the accumulator.
+  virtual void removeSingleGroupRawInput(
+      char* /*group*/,
+      const SelectivityVector& /*rows*/,
+      const std::vector<VectorPtr>& /*args*/) {
+    VELOX_UNSUPPORTED("Aggregate does not support removing raw input");
+  }
+
+  // Returns true if raw input can be added with addRawInputColumnar(). This
+  // is used for low cardinality grouping, where each group has a dense
+  // ordinal and the accumulators of all groups fit in a small array.
+  virtual bool supportsColumnarInput() const {
+    return false;
+  }
+
+  // Updates accumulators kept by 'this' in arrays indexed by group ordinal
+  // from raw input data. The updates are applied to the group rows by the
+  // next flushColumnar(), which must be called before the accumulators of
+  // the groups are read, spilled or cleared. Updates through addRawInput()
+  // may be mixed with columnar updates between flushes.
+  // @param ordinals Group ordinals aligned with the 'args'. These are less
+  // than 'numOrdinals'.
+  // @param numOrdinals Upper bound of the ordinals.
+  // @param rows Rows of the 'args' to add to the accumulators. 'rows' is
+  // guaranteed to have at least one active row.
+  // @param args Raw input. May be empty for count(*).
+  virtual void addRawInputColumnar(
+      const uint64_t* /*ordinals*/,
+      int32_t /*numOrdinals*/,
+      const SelectivityVector& /*rows*/,
+      const std::vector<VectorPtr>& /*args*/) {
+    VELOX_UNSUPPORTED("Aggregate does not support columnar raw input");
+  }
+
+  // Combines the columnar accumulators updated since the last flush into
+  // the accumulators of the group rows and resets them.
+  // @param groups Pointers to the start of the group rows by group ordinal.
+  // Each ordinal given to addRawInputColumnar() since the last flush has a
+  // row.
+  virtual void flushColumnar(char* const* /*groups*/) {}
+
   // Extracts final results (used for final and single aggregations).
   // @param groups Pointers to the start of the group rows.
   // @param numGroups Number of groups to extract results from.
@@ -195,6 +252,39 @@ class Aggregate {
   virtual void
   extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result) = 0;
 
+  // Returns true if the accumulators are spilled with extractSpillState() and
+  // read back with addSingleGroupSpillState() instead of as intermediate
+  // results. This is for aggregates with variable width accumulators, e.g.
+  // array_agg, whose intermediate results are large complex vectors that are
+  // costly to build and to merge back.
+  virtual bool supportsSpillState() const {
+    return false;
+  }
+
+  // Extracts the accumulators as VARBINARY values in an aggregate specific
+  // format, e.g. the serialized values of a ValueList.
+  // @param groups Pointers to the start of the group rows.
+  // @param numGroups Number of groups to extract the state of.
+  // @param result The flat VARBINARY vector to store the states in.
+  virtual void extractSpillState(
+      char** /*groups*/,
+      int32_t /*numGroups*/,
+      VectorPtr* /*result*/) {
+    VELOX_UNSUPPORTED("Aggregate does not support spill state");
+  }
+
+  // Merges the states produced by extractSpillState() into the single group
+  // accumulator.
+  // @param group Pointer to the start of the group row.
+  // @param rows Rows of 'state' to merge.
+  // @param state VARBINARY states produced by extractSpillState().
+  virtual void addSingleGroupSpillState(
+      char* /*group*/,
+      const SelectivityVector& /*rows*/,
+      const VectorPtr& /*state*/) {
+    VELOX_UNSUPPORTED("Aggregate does not support spill state");
+  }
+
   // Frees any out of line storage for the accumulator in
   // 'groups'. No-op for fixed length accumulators.
   virtual void destroy(folly::Range<char**> /*groups*/) {}
@@ -28,7 +28,10 @@ namespace {
 // A generic way to compute any aggregation used as a window function.
 // Creates an Aggregate function object for the window function invocation.
 // At each row, computes the aggregation across all rows from the frameStart
-// to frameEnd boundaries at that row using singleGroup.
+// to frameEnd boundaries at that row using singleGroup. Frames with a fixed
+// start are aggregated incrementally. Sliding frames are aggregated
+// incrementally too if the aggregate supports removing input. Otherwise,
+// large frames are aggregated with a segment tree over the partition.
 class AggregateWindowFunction : public exec::WindowFunction {
  public:
   AggregateWindowFunction(
@@ -37,7 +40,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
       const TypePtr& resultType,
       velox::memory::MemoryPool* pool,
       HashStringAllocator* stringAllocator)
-      : WindowFunction(resultType, pool, stringAllocator) {
+      : WindowFunction(resultType, pool, stringAllocator), name_(name) {
     argTypes_.reserve(args.size());
     argIndices_.reserve(args.size());
     argVectors_.reserve(args.size());
@@ -80,6 +83,8 @@ class AggregateWindowFunction : public exec::WindowFunction {
         exec::RowContainer::nullMask(kNullOffset),
         /* needed for out of line allocations */ kRowSizeOffset);
     singleGroupRowSize_ += aggregate_->accumulatorFixedWidthSize();
+    groupStride_ = bits::roundUp(
+        singleGroupRowSize_, aggregate_->accumulatorAlignmentSize());
 
     // Construct the single row in the MemoryPool.
     singleGroupRowBufferPtr_ =
@@ -89,6 +94,13 @@ class AggregateWindowFunction : public exec::WindowFunction {
     // Constructing a vector of a single result value used for copying from
     // the aggregate to the final result.
     aggregateResultVector_ = BaseVector::create(resultType, 1, pool_);
+
+    // Computes the aggregate result for empty frames.
+    auto singleGroup = std::vector<vector_size_t>{0};
+    aggregate_->initializeNewGroups(&rawSingleGroupRow_, singleGroup);
+    aggregateInitialized_ = true;
+    emptyFrameResult_ = BaseVector::create(resultType, 1, pool_);
+    aggregate_->extractValues(&rawSingleGroupRow_, 1, &emptyFrameResult_);
   }
 
   ~AggregateWindowFunction() {
@@ -104,6 +116,8 @@ class AggregateWindowFunction : public exec::WindowFunction {
     partition_ = partition;
 
     previousFrameMetadata_.reset();
+    slidingAggregation_ = false;
+    segmentTreeBuilt_ = false;
   }
 
   void apply(
@@ -137,6 +151,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
         aggregate_->clear();
         aggregate_->initializeNewGroups(&rawSingleGroupRow_, singleGroup);
         aggregateInitialized_ = true;
+        slidingAggregation_ = false;
       }
 
       fillArgVectors(startRow, frameMetadata.lastRow);
@@ -147,6 +162,23 @@ class AggregateWindowFunction : public exec::WindowFunction {
           rawFrameEnds,
           resultOffset,
           result);
+    } else if (frameMetadata.lastRow < frameMetadata.firstRow) {
+      // All the frames are empty.
+      for (auto i = 0; i < numRows; i++) {
+        result->copy(emptyFrameResult_.get(), resultOffset + i, 0, 1);
+      }
+    } else if (
+        frameMetadata.slidingFrames && aggregate_->supportsRemoveRawInput()) {
+      slidingAggregation(
+          numRows,
+          frameMetadata,
+          rawFrameStarts,
+          rawFrameEnds,
+          resultOffset,
+          result);
+    } else if (useSegmentTree(frameMetadata, numRows)) {
+      segmentTreeAggregation(
+          numRows, rawFrameStarts, rawFrameEnds, resultOffset, result);
     } else {
       fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
       simpleAggregation(
@@ -163,12 +195,16 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
  private:
   struct FrameMetadata {
-    // Min frame start row required for aggregation.
+    // Min frame start row of the non-empty frames required for aggregation.
     vector_size_t firstRow;
 
-    // Max frame end required for the aggregation.
+    // Max frame end of the non-empty frames required for the aggregation.
+    // This is less than firstRow if all the frames are empty.
     vector_size_t lastRow;
 
+    // Total number of rows in the frames of the block.
+    int64_t numFrameRows;
+
     // If all the rows in the block have the same start row, and the
     // end frame rows are non-decreasing, then the aggregation can be done
     // incrementally. With incremental aggregation new frame rows are
@@ -177,25 +213,44 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
     // Resume incremental aggregation from the prior block.
     bool usePreviousAggregate;
+
+    // If both the frame starts and the frame ends are non-decreasing, then
+    // the frames slide over the partition. Aggregates which support removing
+    // input can be computed by adding the rows entering the frame and
+    // removing the rows leaving it.
+    bool slidingFrames;
   };
 
   FrameMetadata analyzeFrameValues(
       const vector_size_t* rawFrameStarts,
       const vector_size_t* rawFrameEnds,
       vector_size_t numRows) {
-    vector_size_t firstRow = rawFrameStarts[0];
-    vector_size_t fixedFrameStartRow = firstRow;
-    vector_size_t lastRow = rawFrameEnds[0];
+    vector_size_t firstRow = std::numeric_limits<vector_size_t>::max();
+    vector_size_t fixedFrameStartRow = rawFrameStarts[0];
+    vector_size_t lastRow = -1;
+    int64_t numFrameRows = 0;
 
     bool incrementalAggregation = true;
-    for (int i = 1; i < numRows; i++) {
-      firstRow = std::min(firstRow, rawFrameStarts[i]);
-      lastRow = std::max(lastRow, rawFrameEnds[i]);
+    bool slidingFrames = true;
+    for (int i = 0; i < numRows; i++) {
+      if (rawFrameStarts[i] <= rawFrameEnds[i]) {
+        firstRow = std::min(firstRow, rawFrameStarts[i]);
+        lastRow = std::max(lastRow, rawFrameEnds[i]);
+        numFrameRows += rawFrameEnds[i] + 1 - rawFrameStarts[i];
+      } else {
+        incrementalAggregation = false;
+      }
+      if (i == 0) {
+        continue;
+      }
       // Incremental aggregation can be done if :
       // i) All rows have the same frameStart value.
       // ii) The frame end values are non-decreasing.
+      // iii) No frame is empty.
       incrementalAggregation &= (rawFrameStarts[i] == fixedFrameStartRow);
       incrementalAggregation &= rawFrameEnds[i] >= rawFrameEnds[i - 1];
+      slidingFrames &= rawFrameStarts[i] >= rawFrameStarts[i - 1];
+      slidingFrames &= rawFrameEnds[i] >= rawFrameEnds[i - 1];
     }
 
     bool usePreviousAggregate = false;
@@ -212,7 +267,13 @@ class AggregateWindowFunction : public exec::WindowFunction {
       }
     }
 
-    return {firstRow, lastRow, incrementalAggregation, usePreviousAggregate};
+    return {
+        firstRow,
+        lastRow,
+        numFrameRows,
+        incrementalAggregation,
+        usePreviousAggregate,
+        slidingFrames};
   }
 
   void fillArgVectors(vector_size_t firstRow, vector_size_t lastRow) {
@@ -270,6 +331,243 @@ class AggregateWindowFunction : public exec::WindowFunction {
     }
   }
 
+  // Returns the number of rows in [startRow, endRow) of 'argVectors_' with
+  // no null argument. The aggregates which support removing input ignore
+  // the other rows.
+  vector_size_t countNonNullRows(vector_size_t startRow, vector_size_t endRow) {
+    vector_size_t numNonNullRows = 0;
+    for (auto row = startRow; row < endRow; row++) {
+      bool hasNull = false;
+      for (auto i = 0; i < argVectors_.size(); i++) {
+        auto index = argIndices_[i] == kConstantChannel ? 0 : row;
+        if (argVectors_[i]->isNullAt(index)) {
+          hasNull = true;
+          break;
+        }
+      }
+      numNonNullRows += !hasNull;
+    }
+    return numNonNullRows;
+  }
+
+  // Reinitializes the single group for a sliding aggregation over the empty
+  // frame at 'frameStart'.
+  void resetSlidingAggregation(vector_size_t frameStart) {
+    auto singleGroup = std::vector<vector_size_t>{0};
+    aggregate_->clear();
+    aggregate_->initializeNewGroups(&rawSingleGroupRow_, singleGroup);
+    aggregateInitialized_ = true;
+    slidingAggregation_ = true;
+    slidingFrameStart_ = frameStart;
+    slidingFrameEnd_ = frameStart - 1;
+    numSlidingFrameValues_ = 0;
+  }
+
+  // Computes the aggregate for frames with non-decreasing frame starts and
+  // ends. The single group holds the aggregate of the rows from
+  // 'slidingFrameStart_' to 'slidingFrameEnd_' of the partition. For each
+  // row the rows which left the frame are removed, and the rows which
+  // entered the frame are added. So every partition row is added and removed
+  // at most once instead of once per frame it is in.
+  void slidingAggregation(
+      vector_size_t numRows,
+      const FrameMetadata& frameMetadata,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    // The sliding aggregation of the previous block can be resumed if the
+    // frames keep sliding.
+    if (!slidingAggregation_ || rawFrameStarts[0] < slidingFrameStart_ ||
+        rawFrameEnds[0] < slidingFrameEnd_) {
+      resetSlidingAggregation(frameMetadata.firstRow);
+    }
+
+    // The argument vectors start at the first row which may be removed.
+    const auto argsStart = std::min(slidingFrameStart_, frameMetadata.firstRow);
+    fillArgVectors(argsStart, frameMetadata.lastRow);
+
+    SelectivityVector rows(frameMetadata.lastRow + 1 - argsStart);
+    auto selectRows = [&](vector_size_t startRow, vector_size_t endRow) {
+      rows.clearAll();
+      rows.setValidRange(startRow - argsStart, endRow - argsStart, true);
+      rows.updateBounds();
+      return countNonNullRows(startRow - argsStart, endRow - argsStart);
+    };
+
+    for (auto i = 0; i < numRows; i++) {
+      const auto frameStart = rawFrameStarts[i];
+      const auto frameEnd = rawFrameEnds[i];
+      if (frameStart > frameEnd) {
+        result->copy(emptyFrameResult_.get(), resultOffset + i, 0, 1);
+        continue;
+      }
+
+      if (frameStart > slidingFrameEnd_) {
+        // No row of the previous frame is in the current frame.
+        resetSlidingAggregation(frameStart);
+      } else if (frameStart > slidingFrameStart_) {
+        // The rows are removed before adding the new ones to keep the
+        // intermediate values of the accumulator small.
+        auto numRemovedValues = selectRows(slidingFrameStart_, frameStart);
+        if (numRemovedValues == numSlidingFrameValues_) {
+          // The accumulator is reinitialized instead of removing its last
+          // values so that it has the null state of an empty aggregation.
+          // The remaining rows of the frame only have null arguments.
+          const auto frameEndWithoutValues = slidingFrameEnd_;
+          resetSlidingAggregation(frameStart);
+          slidingFrameEnd_ = frameEndWithoutValues;
+        } else if (numRemovedValues > 0) {
+          aggregate_->removeSingleGroupRawInput(
+              rawSingleGroupRow_, rows, argVectors_);
+          numSlidingFrameValues_ -= numRemovedValues;
+        }
+        slidingFrameStart_ = frameStart;
+      }
+
+      if (frameEnd > slidingFrameEnd_) {
+        auto numAddedValues = selectRows(slidingFrameEnd_ + 1, frameEnd + 1);
+        if (numAddedValues > 0) {
+          aggregate_->addSingleGroupRawInput(
+              rawSingleGroupRow_, rows, argVectors_, false);
+          numSlidingFrameValues_ += numAddedValues;
+        }
+        slidingFrameEnd_ = frameEnd;
+      }
+
+      BaseVector::prepareForReuse(aggregateResultVector_, 1);
+      aggregate_->extractValues(
+          &rawSingleGroupRow_, 1, &aggregateResultVector_);
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    }
+  }
+
+  // A segment tree is used for aggregates which cannot remove input when the
+  // frames are large enough for the tree to pay off. It is only used for
+  // fixed size accumulators, which don't need to be destroyed.
+  bool useSegmentTree(const FrameMetadata& frameMetadata, vector_size_t numRows)
+      const {
+    return aggregate_->isFixedSize() &&
+        frameMetadata.numFrameRows > numRows * kMinSegmentTreeFrameSize;
+  }
+
+  // Builds a segment tree over all the rows of the partition. Node i of the
+  // tree aggregates the nodes 2 * i and 2 * i + 1. The leaves at nodes
+  // numRows to 2 * numRows - 1 hold the rows of the partition. The nodes
+  // are combined level by level by merging the accumulators of the children
+  // into their parents.
+  void buildSegmentTree() {
+    const auto numLeaves = partition_->numRows();
+    const auto numNodes = 2 * numLeaves;
+    if (!segmentTreeBuffer_ ||
+        segmentTreeBuffer_->capacity() < numNodes * groupStride_) {
+      segmentTreeBuffer_ =
+          AlignedBuffer::allocate<char>(numNodes * groupStride_, pool_);
+    }
+    auto* rawNodes = segmentTreeBuffer_->asMutable<char>();
+    segmentTree_.resize(numNodes);
+    for (auto i = 0; i < numNodes; i++) {
+      segmentTree_[i] = rawNodes + i * groupStride_;
+    }
+    std::vector<vector_size_t> nodeIndices(numNodes);
+    std::iota(nodeIndices.begin(), nodeIndices.end(), 0);
+    aggregate_->initializeNewGroups(segmentTree_.data(), nodeIndices);
+
+    fillArgVectors(0, numLeaves - 1);
+    aggregate_->addRawInput(
+        segmentTree_.data() + numLeaves,
+        SelectivityVector(numLeaves),
+        argVectors_,
+        false);
+
+    if (!intermediateVector_) {
+      intermediateVector_ = BaseVector::create(
+          Aggregate::intermediateType(name_, argTypes_), 0, pool_);
+    }
+    // Nodes lo to hi only have children after hi, which are complete.
+    std::vector<char*> parents;
+    for (auto hi = numLeaves - 1; hi >= 1;) {
+      const auto lo = hi / 2 + 1;
+      const auto numChildren = 2 * (hi + 1 - lo);
+      BaseVector::prepareForReuse(intermediateVector_, numChildren);
+      aggregate_->extractAccumulators(
+          segmentTree_.data() + 2 * lo, numChildren, &intermediateVector_);
+      parents.resize(numChildren);
+      for (auto i = 0; i < numChildren; i++) {
+        parents[i] = segmentTree_[(2 * lo + i) / 2];
+      }
+      aggregate_->addIntermediateResults(
+          parents.data(),
+          SelectivityVector(numChildren),
+          {intermediateVector_},
+          false);
+      hi = lo - 1;
+    }
+    segmentTreeBuilt_ = true;
+  }
+
+  // Computes the aggregate of each frame by merging the O(log(numRows))
+  // segment tree nodes covering it into a result group for the frame.
+  void segmentTreeAggregation(
+      vector_size_t numRows,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    if (!segmentTreeBuilt_) {
+      buildSegmentTree();
+    }
+
+    if (!resultGroupsBuffer_ ||
+        resultGroupsBuffer_->capacity() < numRows * groupStride_) {
+      resultGroupsBuffer_ =
+          AlignedBuffer::allocate<char>(numRows * groupStride_, pool_);
+    }
+    auto* rawResultGroups = resultGroupsBuffer_->asMutable<char>();
+    std::vector<char*> resultGroups(numRows);
+    for (auto i = 0; i < numRows; i++) {
+      resultGroups[i] = rawResultGroups + i * groupStride_;
+    }
+    std::vector<vector_size_t> groupIndices(numRows);
+    std::iota(groupIndices.begin(), groupIndices.end(), 0);
+    aggregate_->initializeNewGroups(resultGroups.data(), groupIndices);
+
+    // The nodes covering the frames and the result group for each node.
+    std::vector<char*> nodes;
+    std::vector<char*> nodeGroups;
+    const auto numLeaves = partition_->numRows();
+    for (auto i = 0; i < numRows; i++) {
+      auto left = rawFrameStarts[i] + numLeaves;
+      auto right = rawFrameEnds[i] + numLeaves + 1;
+      for (; left < right; left /= 2, right /= 2) {
+        if (left & 1) {
+          nodes.push_back(segmentTree_[left++]);
+          nodeGroups.push_back(resultGroups[i]);
+        }
+        if (right & 1) {
+          nodes.push_back(segmentTree_[--right]);
+          nodeGroups.push_back(resultGroups[i]);
+        }
+      }
+    }
+
+    if (!nodes.empty()) {
+      BaseVector::prepareForReuse(intermediateVector_, nodes.size());
+      aggregate_->extractAccumulators(
+          nodes.data(), nodes.size(), &intermediateVector_);
+      aggregate_->addIntermediateResults(
+          nodeGroups.data(),
+          SelectivityVector(nodes.size()),
+          {intermediateVector_},
+          false);
+    }
+
+    BaseVector::prepareForReuse(aggregateResultVector_, numRows);
+    aggregate_->extractValues(
+        resultGroups.data(), numRows, &aggregateResultVector_);
+    result->copy(aggregateResultVector_.get(), resultOffset, 0, numRows);
+  }
+
   void simpleAggregation(
       vector_size_t numRows,
       vector_size_t minFrame,
@@ -281,13 +579,17 @@ class AggregateWindowFunction : public exec::WindowFunction {
     SelectivityVector rows;
     rows.resize(maxFrame + 1 - minFrame);
     static auto kSingleGroup = std::vector<vector_size_t>{0};
+    slidingAggregation_ = false;
     for (int i = 0; i < numRows; i++) {
+      if (frameStartsVector[i] > frameEndsVector[i]) {
+        result->copy(emptyFrameResult_.get(), resultOffset + i, 0, 1);
+        continue;
+      }
       // This is a very naive algorithm.
       // It evaluates the entire aggregation for each row by iterating over
       // input rows from frameStart to frameEnd in the SelectivityVector.
-      // TODO : Try to re-use previous computations by advancing and retracting
-      // the aggregation based on the frame changes with each row. This would
-      // require adding new APIs to the Aggregate framework.
+      // It is used for small frames only. Larger frames are computed with
+      // slidingAggregation() or segmentTreeAggregation().
       aggregate_->clear();
       aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
       aggregateInitialized_ = true;
@@ -299,6 +601,12 @@ class AggregateWindowFunction : public exec::WindowFunction {
     }
   }
 
+  // Minimum average number of rows in the frames of a block for using a
+  // segment tree.
+  static constexpr int64_t kMinSegmentTreeFrameSize = 16;
+
+  const std::string name_;
+
   // Aggregate function object required for this window function evaluation.
   std::unique_ptr<exec::Aggregate> aggregate_;
 
@@ -322,13 +630,39 @@ class AggregateWindowFunction : public exec::WindowFunction {
   char* rawSingleGroupRow_;
   vector_size_t singleGroupRowSize_;
 
+  // Distance between consecutive group rows of the segment tree and its
+  // result groups, which have the same layout as the single group row.
+  vector_size_t groupStride_;
+
   // Used for per-row aggregate computations.
   // This vector is used to copy from the aggregate to the result.
   VectorPtr aggregateResultVector_;
 
+  // The result of the aggregate over an empty frame.
+  VectorPtr emptyFrameResult_;
+
   // Stores metadata about the previous output block of the partition
   // to optimize aggregate computation and reading argument vectors.
   std::optional<FrameMetadata> previousFrameMetadata_;
+
+  // True if the single group holds the sliding aggregation of the rows from
+  // 'slidingFrameStart_' to 'slidingFrameEnd_' of the partition, and
+  // 'numSlidingFrameValues_' of these rows have no null argument.
+  bool slidingAggregation_{false};
+  vector_size_t slidingFrameStart_;
+  vector_size_t slidingFrameEnd_;
+  vector_size_t numSlidingFrameValues_;
+
+  // The group rows of the segment tree nodes of the current partition.
+  bool segmentTreeBuilt_{false};
+  BufferPtr segmentTreeBuffer_;
+  std::vector<char*> segmentTree_;
+
+  // The group rows for the segment tree aggregation results of a block.
+  BufferPtr resultGroupsBuffer_;
+
+  // Accumulators of segment tree nodes extracted to be merged.
+  VectorPtr intermediateVector_;
 };
 
 } // namespace
@@ -349,6 +683,7 @@ void registerAggregateWindowFunction(const std::string& name) {
         [name](
             const std::vector<exec::WindowFunctionArg>& args,
             const TypePtr& resultType,
+            bool /*ignoreNulls*/,
             velox::memory::MemoryPool* pool,
             HashStringAllocator* stringAllocator)
             -> std::unique_ptr<exec::WindowFunction> {
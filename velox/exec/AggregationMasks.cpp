@@ -19,52 +19,79 @@
 namespace facebook::velox::exec {
 
 AggregationMasks::AggregationMasks(
-    std::vector<std::optional<column_index_t>> maskChannels)
-    : maskChannels_{std::move(maskChannels)} {
-  for (const auto& maskChannel : maskChannels_) {
-    if (maskChannel.has_value()) {
-      maskedRows_.insert({maskChannel.value(), SelectivityVector::empty()});
+    std::vector<std::optional<column_index_t>> maskChannels) {
+  maskIndices_.reserve(maskChannels.size());
+  for (const auto& maskChannel : maskChannels) {
+    if (!maskChannel.has_value()) {
+      maskIndices_.push_back(std::nullopt);
+      continue;
     }
+    auto it = std::find_if(masks_.begin(), masks_.end(), [&](const auto& mask) {
+      return mask.channel == maskChannel.value();
+    });
+    if (it == masks_.end()) {
+      masks_.push_back({maskChannel.value(), SelectivityVector::empty()});
+      it = masks_.end() - 1;
+    }
+    maskIndices_.push_back(it - masks_.begin());
   }
 }
 
 void AggregationMasks::addInput(
     const RowVectorPtr& input,
     const SelectivityVector& rows) {
-  for (auto& entry : maskedRows_) {
-    SelectivityVector& maskedRows = entry.second;
-    maskedRows = rows;
+  for (auto& mask : masks_) {
+    computeMask(input, rows, mask);
+  }
+}
 
-    // Get the projection column vector that would be our mask.
-    const auto& maskVector = input->childAt(entry.first);
+void AggregationMasks::computeMask(
+    const RowVectorPtr& input,
+    const SelectivityVector& rows,
+    Mask& mask) {
+  // Get the projection column vector that would be our mask.
+  const auto& maskVector = input->childAt(mask.channel);
 
-    // Get decoded vector and update the masked selectivity vector.
-    decodedMask_.decode(*maskVector, rows);
-    if (decodedMask_.isConstantMapping()) {
-      if (decodedMask_.isNullAt(rows.begin()) ||
-          !decodedMask_.valueAt<bool>(rows.begin())) {
-        maskedRows.setValidRange(rows.begin(), rows.end(), false);
-        maskedRows.updateBounds();
-      }
-    } else {
-      rows.applyToSelected([&](vector_size_t i) {
-        if (decodedMask_.isNullAt(i) || !decodedMask_.valueAt<bool>(i)) {
-          maskedRows.setValid(i, false);
-        }
-      });
-      maskedRows.updateBounds();
+  // Get decoded vector and update the masked selectivity vector.
+  decodedMask_.decode(*maskVector, rows);
+  auto& maskedRows = mask.rows;
+  if (decodedMask_.isConstantMapping()) {
+    mask.allSelected = !decodedMask_.isNullAt(rows.begin()) &&
+        decodedMask_.valueAt<bool>(rows.begin());
+    if (!mask.allSelected) {
+      maskedRows.resize(rows.size());
+      maskedRows.clearAll();
     }
+    return;
   }
+
+  maskedRows = rows;
+  if (decodedMask_.isIdentityMapping()) {
+    // The values and nulls of a flat mask are combined with the rows a word
+    // at a time.
+    maskedRows.deselectNulls(
+        decodedMask_.data<uint64_t>(), rows.begin(), rows.end());
+    if (auto* rawNulls = decodedMask_.nulls()) {
+      maskedRows.deselectNulls(rawNulls, rows.begin(), rows.end());
+    }
+  } else {
+    rows.applyToSelected([&](vector_size_t i) {
+      if (decodedMask_.isNullAt(i) || !decodedMask_.valueAt<bool>(i)) {
+        maskedRows.setValid(i, false);
+      }
+    });
+    maskedRows.updateBounds();
+  }
+  mask.allSelected = maskedRows.countSelected() == rows.countSelected();
 }
 
 const SelectivityVector* FOLLY_NULLABLE
 AggregationMasks::activeRows(int32_t aggregationIndex) const {
-  if (maskChannels_[aggregationIndex].has_value()) {
-    auto it = maskedRows_.find(maskChannels_[aggregationIndex].value());
-    VELOX_CHECK(it != maskedRows_.end());
-    return &it->second;
+  const auto& maskIndex = maskIndices_[aggregationIndex];
+  if (!maskIndex.has_value()) {
+    return nullptr;
   }
-
-  return nullptr;
+  const auto& mask = masks_[maskIndex.value()];
+  return mask.allSelected ? nullptr : &mask.rows;
 }
 } // namespace facebook::velox::exec
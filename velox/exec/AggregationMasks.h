@@ -28,17 +28,40 @@ class AggregationMasks {
       std::vector<std::optional<column_index_t>> maskChannels);
 
   /// Process the input batch and prepare selectivity vectors for each mask by
-  /// removing masked rows.
+  /// removing masked rows. Each distinct mask channel is processed once,
+  /// regardless of the number of aggregations that use it.
   void addInput(const RowVectorPtr& input, const SelectivityVector& rows);
 
-  // Return prepared selectivity vector for a given aggregation. Must be called
-  // after calling addInput().
+  /// Return prepared selectivity vector for a given aggregation. Must be
+  /// called after calling addInput(). Returns nullptr if the aggregation has
+  /// no mask or if its mask is true for all 'rows' of addInput(). The
+  /// aggregation then uses 'rows'.
   const SelectivityVector* FOLLY_NULLABLE
   activeRows(int32_t aggregationIndex) const;
 
  private:
-  std::vector<std::optional<column_index_t>> maskChannels_;
-  std::unordered_map<column_index_t, SelectivityVector> maskedRows_;
+  struct Mask {
+    column_index_t channel;
+
+    // The rows of the last addInput() for which the mask is true.
+    SelectivityVector rows;
+
+    // True if the mask is true for all the rows of the last addInput().
+    bool allSelected{false};
+  };
+
+  // Sets 'mask' for 'rows' of 'input'.
+  void computeMask(
+      const RowVectorPtr& input,
+      const SelectivityVector& rows,
+      Mask& mask);
+
+  // Index into 'masks_' for each aggregation. Aggregations without masks use
+  // std::nullopt.
+  std::vector<std::optional<int32_t>> maskIndices_;
+
+  // One entry per distinct mask channel.
+  std::vector<Mask> masks_;
   DecodedVector decodedMask_;
 };
 } // namespace facebook::velox::exec
@@ -16,6 +16,7 @@
 #include "velox/exec/AssignUniqueId.h"
 
 #include <algorithm>
+#include <numeric>
 #include <utility>
 
 namespace facebook::velox::exec {
@@ -82,25 +83,29 @@ void AssignUniqueId::generateIdColumn(vector_size_t size) {
   auto rawResults =
       result->asUnchecked<FlatVector<int64_t>>()->mutableRawValues();
 
+  // Fills the ids in contiguous ranges, one per reservation of row ids. A
+  // batch touches the shared counter only when the current reservation is
+  // used up, which is at most once for batches under kRowIdsPerRequest rows.
   vector_size_t start = 0;
   while (start < size) {
     if (rowIdCounter_ >= maxRowIdCounterValue_) {
       requestRowIds();
     }
 
-    auto batchSize =
-        std::min(maxRowIdCounterValue_ - rowIdCounter_ + 1, kRowIdsPerRequest);
-    auto end = (int32_t)std::min((int64_t)size, start + batchSize);
-    VELOX_CHECK_EQ((rowIdCounter_ + end - 1) & uniqueValueMask_, 0);
+    const auto numIds =
+        std::min<int64_t>(maxRowIdCounterValue_ - rowIdCounter_, size - start);
+    const vector_size_t end = start + numIds;
     std::iota(
         rawResults + start, rawResults + end, uniqueValueMask_ | rowIdCounter_);
-    rowIdCounter_ += end;
+    rowIdCounter_ += numIds;
     start = end;
   }
 }
 
 void AssignUniqueId::requestRowIds() {
   rowIdCounter_ = rowIdPool_->fetch_add(kRowIdsPerRequest);
+  VELOX_CHECK_LT(
+      rowIdCounter_, kMaxRowId, "Ran out of row ids for AssignUniqueId");
   maxRowIdCounterValue_ =
       std::min(rowIdCounter_ + kRowIdsPerRequest, kMaxRowId);
 }
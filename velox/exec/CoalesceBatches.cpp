@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/CoalesceBatches.h"
+
+namespace facebook::velox::exec {
+
+CoalesceBatches::CoalesceBatches(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    RowTypePtr outputType,
+    const core::PlanNodeId& planNodeId)
+    : Operator(
+          driverCtx,
+          std::move(outputType),
+          operatorId,
+          planNodeId,
+          "CoalesceBatches"),
+      minRows_(driverCtx->queryConfig().coalesceBatchesMinRows()),
+      maxBytes_(driverCtx->queryConfig().preferredOutputBatchBytes()) {
+  isIdentityProjection_ = true;
+
+  const auto numColumns = outputType_->size();
+  identityProjections_.reserve(numColumns);
+  for (column_index_t i = 0; i < numColumns; ++i) {
+    identityProjections_.emplace_back(i, i);
+  }
+}
+
+void CoalesceBatches::addInput(RowVectorPtr input) {
+  const auto numInput = input->size();
+  if (buffered_ == nullptr && numInput >= minRows_) {
+    input_ = std::move(input);
+    return;
+  }
+
+  // Lazy vectors may not be loadable after the next input, so they are loaded
+  // before the copy.
+  for (auto& child : input->children()) {
+    child = BaseVector::loadedVectorShared(child);
+  }
+  if (buffered_ == nullptr) {
+    buffered_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(outputType_, 0, pool()));
+    bufferedBytes_ = 0;
+  }
+  const auto offset = buffered_->size();
+  buffered_->resize(offset + numInput);
+  buffered_->copy(input.get(), offset, 0, numInput);
+  bufferedBytes_ += input->estimateFlatSize();
+}
+
+RowVectorPtr CoalesceBatches::getOutput() {
+  if (input_ != nullptr) {
+    return std::move(input_);
+  }
+  if (isBufferFull() || (noMoreInput_ && buffered_ != nullptr)) {
+    return std::move(buffered_);
+  }
+  return nullptr;
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+/// Copies small input vectors together until they have at least
+/// QueryConfig::coalesceBatchesMinRows() rows or preferredOutputBatchBytes()
+/// bytes, so that the operators after a selective filter or a local exchange
+/// with many partitions get fewer, larger vectors. Input vectors that are
+/// large enough by themselves are passed through without copy when nothing is
+/// buffered. Added by the LocalPlanner after these operators and reports its
+/// stats under the plan node of the operator before it.
+class CoalesceBatches : public Operator {
+ public:
+  CoalesceBatches(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      RowTypePtr outputType,
+      const core::PlanNodeId& planNodeId);
+
+  bool preservesOrder() const override {
+    return true;
+  }
+
+  bool needsInput() const override {
+    return !noMoreInput_ && input_ == nullptr && !isBufferFull();
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  bool isFinished() override {
+    return noMoreInput_ && input_ == nullptr && buffered_ == nullptr;
+  }
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+ private:
+  bool isBufferFull() const {
+    return buffered_ != nullptr &&
+        (buffered_->size() >= minRows_ || bufferedBytes_ >= maxBytes_);
+  }
+
+  const vector_size_t minRows_;
+  const uint64_t maxBytes_;
+
+  // Copies of the small input vectors received since the last output.
+  RowVectorPtr buffered_;
+  uint64_t bufferedBytes_{0};
+};
+} // namespace facebook::velox::exec
@@ -18,7 +18,7 @@
 
 namespace facebook::velox::exec {
 
-void CrossJoinBridge::setData(std::vector<VectorPtr> data) {
+void CrossJoinBridge::setData(CrossJoinBuildData data) {
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
@@ -29,7 +29,7 @@ void CrossJoinBridge::setData(std::vector<VectorPtr> data) {
   notify(std::move(promises));
 }
 
-std::optional<std::vector<VectorPtr>> CrossJoinBridge::dataOrFuture(
+std::optional<CrossJoinBuildData> CrossJoinBridge::dataOrFuture(
     ContinueFuture* future) {
   std::lock_guard<std::mutex> l(mutex_);
   VELOX_CHECK(!cancelled_, "Getting data after the build side is aborted");
@@ -50,18 +50,73 @@ CrossJoinBuild::CrossJoinBuild(
           nullptr,
           operatorId,
           joinNode->id(),
-          "CrossJoinBuild") {}
+          "CrossJoinBuild"),
+      // Cross join build uses the join spill config.
+      spillConfig_(
+          operatorCtx_->makeSpillConfig(Spiller::Type::kHashJoinBuild)),
+      spillMemoryThreshold_(
+          driverCtx->queryConfig().joinSpillMemoryThreshold()) {}
 
 void CrossJoinBuild::addInput(RowVectorPtr input) {
-  if (input->size() > 0) {
-    // Load lazy vectors before storing.
-    for (auto& child : input->children()) {
-      child->loadedVector();
+  if (input->size() == 0) {
+    return;
+  }
+
+  // Load lazy vectors before storing.
+  for (auto& child : input->children()) {
+    child->loadedVector();
+  }
+
+  if (spillFileList_ != nullptr) {
+    spill(input);
+    return;
+  }
+
+  dataBytes_ += input->uniqueRetainedSize();
+  data_.emplace_back(std::move(input));
+
+  if (shouldSpill()) {
+    for (const auto& vector : data_) {
+      spill(std::static_pointer_cast<RowVector>(vector));
     }
-    data_.emplace_back(std::move(input));
+    data_.clear();
+    dataBytes_ = 0;
   }
 }
 
+bool CrossJoinBuild::shouldSpill() {
+  if (!spillConfig_.has_value()) {
+    return false;
+  }
+
+  // Test-only spill path.
+  const auto testSpillPct = spillConfig_->testSpillPct;
+  if (testSpillPct != 0 &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          testSpillPct) {
+    return true;
+  }
+
+  return spillMemoryThreshold_ != 0 && dataBytes_ > spillMemoryThreshold_;
+}
+
+void CrossJoinBuild::spill(const RowVectorPtr& input) {
+  if (spillFileList_ == nullptr) {
+    spillFileList_ = std::make_unique<SpillFileList>(
+        asRowType(input->type()),
+        0,
+        std::vector<CompareFlags>{},
+        spillConfig_->filePath,
+        spillConfig_->maxFileSize,
+        *pool(),
+        *operatorCtx_->mappedMemory());
+  }
+
+  IndexRange range{0, input->size()};
+  spillFileList_->write(input, folly::Range<IndexRange*>(&range, 1));
+  numSpilledRows_ += input->size();
+}
+
 BlockingReason CrossJoinBuild::isBlocked(ContinueFuture* future) {
   if (!future_.valid()) {
     return BlockingReason::kNotBlocked;
@@ -72,6 +127,18 @@ BlockingReason CrossJoinBuild::isBlocked(ContinueFuture* future) {
 
 void CrossJoinBuild::noMoreInput() {
   Operator::noMoreInput();
+  if (spillFileList_ != nullptr) {
+    {
+      auto lockedStats = stats_.wlock();
+      lockedStats->spilledBytes = spillFileList_->spilledBytes();
+      lockedStats->spilledRows = numSpilledRows_;
+      lockedStats->spilledPartitions = 1;
+      lockedStats->spilledFiles = spillFileList_->spilledFiles();
+    }
+    spillFiles_ = spillFileList_->files();
+    spillFileList_.reset();
+  }
+
   std::vector<ContinuePromise> promises;
   std::vector<std::shared_ptr<Driver>> peers;
   // The last Driver to hit CrossJoinBuild::finish gathers the data from
@@ -89,6 +156,9 @@ void CrossJoinBuild::noMoreInput() {
     auto* build = dynamic_cast<CrossJoinBuild*>(op);
     VELOX_CHECK(build);
     data_.insert(data_.begin(), build->data_.begin(), build->data_.end());
+    for (auto& file : build->spillFiles_) {
+      spillFiles_.push_back(std::move(file));
+    }
   }
 
   // Realize the promises so that the other Drivers (which were not
@@ -101,7 +171,11 @@ void CrossJoinBuild::noMoreInput() {
   operatorCtx_->task()
       ->getCrossJoinBridge(
           operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-      ->setData(std::move(data_));
+      ->setData(CrossJoinBuildData{
+          std::move(data_),
+          spillFiles_.empty()
+              ? nullptr
+              : std::make_shared<const SpillFiles>(std::move(spillFiles_))});
 }
 
 bool CrossJoinBuild::isFinished() {
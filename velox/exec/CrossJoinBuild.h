@@ -17,17 +17,32 @@
 
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
 
 namespace facebook::velox::exec {
 
+/// Build side data of a cross join. The vectors that didn't fit in memory are
+/// spilled to 'spillFiles' and are read back for each batch of probe input.
+struct CrossJoinBuildData {
+  std::vector<VectorPtr> vectors;
+
+  /// Null if nothing was spilled. Shared by all probe Drivers that read the
+  /// files concurrently.
+  std::shared_ptr<const SpillFiles> spillFiles;
+
+  bool empty() const {
+    return vectors.empty() && spillFiles == nullptr;
+  }
+};
+
 class CrossJoinBridge : public JoinBridge {
  public:
-  void setData(std::vector<VectorPtr> data);
+  void setData(CrossJoinBuildData data);
 
-  std::optional<std::vector<VectorPtr>> dataOrFuture(ContinueFuture* future);
+  std::optional<CrossJoinBuildData> dataOrFuture(ContinueFuture* future);
 
  private:
-  std::optional<std::vector<VectorPtr>> data_;
+  std::optional<CrossJoinBuildData> data_;
 };
 
 class CrossJoinBuild : public Operator {
@@ -55,12 +70,40 @@ class CrossJoinBuild : public Operator {
 
   void close() override {
     data_.clear();
+    spillFileList_.reset();
+    spillFiles_.clear();
     Operator::close();
   }
 
  private:
+  // Returns true if 'data_' needs to be spilled. Uses the join spill memory
+  // threshold.
+  bool shouldSpill();
+
+  // Writes 'input' to 'spillFileList_'.
+  void spill(const RowVectorPtr& input);
+
+  const std::optional<Spiller::Config> spillConfig_;
+
+  const uint64_t spillMemoryThreshold_;
+
   std::vector<VectorPtr> data_;
 
+  // Bytes retained by 'data_'.
+  uint64_t dataBytes_{0};
+
+  // Set when 'data_' is spilled for the first time. All subsequent input is
+  // spilled as well.
+  std::unique_ptr<SpillFileList> spillFileList_;
+
+  // Files of 'spillFileList_' after no more input.
+  SpillFiles spillFiles_;
+
+  uint64_t numSpilledRows_{0};
+
+  // Counts input batches for the test-only spill path.
+  uint32_t spillTestCounter_{0};
+
   // Future for synchronizing with other Drivers of the same pipeline. All build
   // Drivers must be completed before making data available for the probe side.
   ContinueFuture future_{ContinueFuture::makeEmpty()};
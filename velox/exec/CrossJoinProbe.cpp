@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/CrossJoinProbe.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -29,17 +30,12 @@ CrossJoinProbe::CrossJoinProbe(
           joinNode->id(),
           "CrossJoinProbe"),
       outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()} {
-  bool isIdentityProjection = true;
-
   auto probeType = joinNode->sources()[0]->outputType();
   for (auto i = 0; i < probeType->size(); ++i) {
     auto name = probeType->nameOf(i);
     auto outIndex = outputType_->getChildIdxIfExists(name);
     if (outIndex.has_value()) {
       identityProjections_.emplace_back(i, outIndex.value());
-      if (outIndex != i) {
-        isIdentityProjection = false;
-      }
     }
   }
 
@@ -51,9 +47,52 @@ CrossJoinProbe::CrossJoinProbe(
     }
   }
 
-  if (isIdentityProjection && buildProjections_.empty()) {
-    isIdentityProjection_ = true;
+  // NOTE: the output is never 'input_' as is. getOutput() joins 'input_' with
+  // each build side vector in turn and needs 'input_' until the last one.
+
+  if (joinNode->filter()) {
+    initializeFilter(joinNode->filter(), probeType, buildType);
+  }
+}
+
+void CrossJoinProbe::initializeFilter(
+    const core::TypedExprPtr& filter,
+    const RowTypePtr& probeType,
+    const RowTypePtr& buildType) {
+  std::vector<core::TypedExprPtr> filters = {filter};
+  filter_ =
+      std::make_unique<ExprSet>(std::move(filters), operatorCtx_->execCtx());
+
+  column_index_t filterChannel = 0;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  auto numFields = filter_->expr(0)->distinctFields().size();
+  names.reserve(numFields);
+  types.reserve(numFields);
+  for (const auto& field : filter_->expr(0)->distinctFields()) {
+    const auto& name = field->field();
+    auto channel = probeType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      auto channelValue = channel.value();
+      filterProbeInputs_.emplace_back(channelValue, filterChannel++);
+      names.emplace_back(probeType->nameOf(channelValue));
+      types.emplace_back(probeType->childAt(channelValue));
+      continue;
+    }
+    channel = buildType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      auto channelValue = channel.value();
+      filterBuildInputs_.emplace_back(channelValue, filterChannel++);
+      names.emplace_back(buildType->nameOf(channelValue));
+      types.emplace_back(buildType->childAt(channelValue));
+      continue;
+    }
+    VELOX_FAIL(
+        "Cross join filter field not found in either probe or build input: {}",
+        field->toString());
   }
+
+  filterInputType_ = ROW(std::move(names), std::move(types));
 }
 
 BlockingReason CrossJoinProbe::isBlocked(ContinueFuture* future) {
@@ -91,67 +130,145 @@ void CrossJoinProbe::addInput(RowVectorPtr input) {
   input_ = std::move(input);
 }
 
-RowVectorPtr CrossJoinProbe::getOutput() {
-  if (!input_) {
-    return nullptr;
+bool CrossJoinProbe::nextBuildBlock() {
+  const auto& vectors = buildData_->vectors;
+  if (buildIndex_ < vectors.size()) {
+    buildBlock_ = std::static_pointer_cast<RowVector>(vectors[buildIndex_++]);
+    return true;
   }
 
-  const auto inputSize = input_->size();
+  const auto& spillFiles = buildData_->spillFiles;
+  while (spillFiles != nullptr) {
+    if (spillReader_ == nullptr) {
+      if (spillFileIndex_ == spillFiles->size()) {
+        break;
+      }
+      spillReader_ = (*spillFiles)[spillFileIndex_++]->createReader(*pool());
+    }
 
-  auto buildSize = buildData_.value()[buildIndex_]->size();
-  vector_size_t probeCnt;
-  if (buildSize > outputBatchSize_) {
-    probeCnt = 1;
-  } else {
-    probeCnt = std::min(
-        (vector_size_t)outputBatchSize_ / buildSize, inputSize - probeRow_);
+    RowVectorPtr batch;
+    if (!spillReader_->nextBatch(batch)) {
+      spillReader_.reset();
+      continue;
+    }
+    if (batch->size() > 0) {
+      buildBlock_ = std::move(batch);
+      return true;
+    }
   }
 
-  auto size = probeCnt * buildSize;
-  BufferPtr indices = allocateIndices(size, pool());
-  auto* rawIndices = indices->asMutable<vector_size_t>();
-  for (auto i = 0; i < probeCnt; ++i) {
-    std::fill(
-        rawIndices + i * buildSize,
-        rawIndices + (i + 1) * buildSize,
-        probeRow_ + i);
-  }
-  auto output = fillOutput(size, indices);
+  // Start over for the next batch of probe input.
+  buildIndex_ = 0;
+  spillFileIndex_ = 0;
+  return false;
+}
 
-  BufferPtr buildIndices = nullptr;
-  if (probeCnt > 1) {
-    buildIndices = allocateIndices(size, pool());
-    auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
-    for (auto i = 0; i < probeCnt; ++i) {
-      std::iota(
-          rawBuildIndices + i * buildSize,
-          rawBuildIndices + (i + 1) * buildSize,
-          0);
-    }
+vector_size_t CrossJoinProbe::applyFilter(
+    vector_size_t size,
+    const BufferPtr& probeIndices,
+    const BufferPtr& buildIndices) {
+  std::vector<VectorPtr> filterColumns(filterInputType_->size());
+  for (const auto& projection : filterProbeInputs_) {
+    filterColumns[projection.outputChannel] = wrapChild(
+        size, probeIndices, input_->childAt(projection.inputChannel));
+  }
+  for (const auto& projection : filterBuildInputs_) {
+    filterColumns[projection.outputChannel] = wrapChild(
+        size, buildIndices, buildBlock_->childAt(projection.inputChannel));
   }
+  auto filterInput = std::make_shared<RowVector>(
+      pool(), filterInputType_, nullptr, size, std::move(filterColumns));
 
-  auto buildRowVector =
-      buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
-  for (const auto& projection : buildProjections_) {
-    VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
+  filterRows_.resize(size);
+  filterRows_.setAll();
+  EvalCtx evalCtx(operatorCtx_->execCtx(), filter_.get(), filterInput.get());
+  filter_->eval(0, 1, true, filterRows_, evalCtx, filterResult_);
+  decodedFilterResult_.decode(*filterResult_[0], filterRows_);
 
-    if (buildIndices) {
-      buildVector = BaseVector::wrapInDictionary(
-          BufferPtr(nullptr), buildIndices, size, buildVector);
+  auto* rawProbeIndices = probeIndices->asMutable<vector_size_t>();
+  auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+  vector_size_t numPassed = 0;
+  for (auto i = 0; i < size; ++i) {
+    if (!decodedFilterResult_.isNullAt(i) &&
+        decodedFilterResult_.valueAt<bool>(i)) {
+      rawProbeIndices[numPassed] = rawProbeIndices[i];
+      rawBuildIndices[numPassed] = rawBuildIndices[i];
+      ++numPassed;
     }
-    output->childAt(projection.outputChannel) = buildVector;
   }
+  return numPassed;
+}
 
-  probeRow_ += probeCnt;
-  if (probeRow_ == inputSize) {
-    probeRow_ = 0;
-    ++buildIndex_;
-    if (buildIndex_ == buildData_->size()) {
-      buildIndex_ = 0;
+RowVectorPtr CrossJoinProbe::getOutput() {
+  while (input_) {
+    if (!buildBlock_ && !nextBuildBlock()) {
+      // Joined 'input_' with all build side vectors.
       input_.reset();
+      break;
+    }
+
+    const auto inputSize = input_->size();
+    const auto buildSize = buildBlock_->size();
+    vector_size_t probeCnt;
+    if (buildSize > outputBatchSize_) {
+      probeCnt = 1;
+    } else {
+      probeCnt = std::min(
+          (vector_size_t)outputBatchSize_ / buildSize, inputSize - probeRow_);
+    }
+
+    auto size = probeCnt * buildSize;
+    BufferPtr indices = allocateIndices(size, pool());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < probeCnt; ++i) {
+      std::fill(
+          rawIndices + i * buildSize,
+          rawIndices + (i + 1) * buildSize,
+          probeRow_ + i);
+    }
+
+    BufferPtr buildIndices = nullptr;
+    if (probeCnt > 1 || filter_) {
+      buildIndices = allocateIndices(size, pool());
+      auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+      for (auto i = 0; i < probeCnt; ++i) {
+        std::iota(
+            rawBuildIndices + i * buildSize,
+            rawBuildIndices + (i + 1) * buildSize,
+            0);
+      }
+    }
+
+    if (filter_) {
+      size = applyFilter(size, indices, buildIndices);
+    }
+
+    RowVectorPtr output;
+    if (size > 0) {
+      output = fillOutput(size, indices);
+      for (const auto& projection : buildProjections_) {
+        VectorPtr buildVector = buildBlock_->childAt(projection.inputChannel);
+
+        if (buildIndices) {
+          buildVector = BaseVector::wrapInDictionary(
+              BufferPtr(nullptr), buildIndices, size, buildVector);
+        }
+        output->childAt(projection.outputChannel) = buildVector;
+      }
+    }
+
+    probeRow_ += probeCnt;
+    if (probeRow_ == inputSize) {
+      probeRow_ = 0;
+      buildBlock_ = nullptr;
+    }
+
+    if (output != nullptr) {
+      return output;
     }
+    // No rows passed the filter. Continue with the next set of rows.
   }
-  return output;
+  return nullptr;
 }
 
 bool CrossJoinProbe::isFinished() {
@@ -159,6 +276,8 @@ bool CrossJoinProbe::isFinished() {
 }
 
 void CrossJoinProbe::close() {
+  spillReader_.reset();
+  buildBlock_.reset();
   buildData_.reset();
   Operator::close();
 }
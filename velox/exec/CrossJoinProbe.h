@@ -41,20 +41,66 @@ class CrossJoinProbe : public Operator {
   void close() override;
 
  private:
+  // Sets up 'filter_' and related member variables.
+  void initializeFilter(
+      const core::TypedExprPtr& filter,
+      const RowTypePtr& probeType,
+      const RowTypePtr& buildType);
+
+  // Sets 'buildBlock_' to the next build side vector to join with 'input_'.
+  // Goes over the in-memory vectors first, then reads the spilled vectors
+  // back from disk. Returns false if there are no more build side vectors.
+  bool nextBuildBlock();
+
+  // Evaluates 'filter_' on the 'size' rows of the cross product identified by
+  // 'probeIndices' and 'buildIndices'. Keeps the passing rows at the start of
+  // the index buffers and returns their number.
+  vector_size_t applyFilter(
+      vector_size_t size,
+      const BufferPtr& probeIndices,
+      const BufferPtr& buildIndices);
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
   std::vector<IdentityProjection> buildProjections_;
 
-  std::optional<std::vector<VectorPtr>> buildData_;
+  std::optional<CrossJoinBuildData> buildData_;
 
-  // Index into buildData_ for the build side vector to process on next call to
-  // getOutput().
+  // Index into buildData_->vectors for the build side vector to process after
+  // 'buildBlock_'.
   size_t buildIndex_{0};
 
+  // Index into buildData_->spillFiles for the spill file to read after the
+  // one read by 'spillReader_'.
+  size_t spillFileIndex_{0};
+
+  // Reads the current spill file.
+  std::unique_ptr<BatchStream> spillReader_;
+
+  // Build side vector being joined with 'input_'.
+  RowVectorPtr buildBlock_;
+
   // Input row to process on next call to getOutput().
   vector_size_t probeRow_{0};
 
   bool buildSideEmpty_{false};
+
+  /// Join filter.
+  std::unique_ptr<ExprSet> filter_;
+
+  /// Join filter input type.
+  RowTypePtr filterInputType_;
+
+  /// Maps probe-side input channels to channels in 'filterInputType_'.
+  std::vector<IdentityProjection> filterProbeInputs_;
+
+  /// Maps build-side input channels to channels in 'filterInputType_'.
+  std::vector<IdentityProjection> filterBuildInputs_;
+
+  /// Reusable memory for filter evaluation.
+  SelectivityVector filterRows_;
+  std::vector<VectorPtr> filterResult_;
+  DecodedVector decodedFilterResult_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/DistinctAggregate.h"
+
+#include <folly/container/F14Set.h>
+
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+
+// The distinct values of a group. Non-inline strings are copied into the
+// HashStringAllocator of the group rows.
+template <typename T>
+struct DistinctValues {
+  using Set = folly::F14FastSet<
+      T,
+      std::hash<T>,
+      std::equal_to<T>,
+      AlignedStlAllocator<T, 16>>;
+
+  explicit DistinctValues(HashStringAllocator* allocator)
+      : values(AlignedStlAllocator<T, 16>(allocator)) {}
+
+  vector_size_t size() const {
+    return values.size() + (hasNull ? 1 : 0);
+  }
+
+  Set values;
+  bool hasNull{false};
+};
+
+template <typename T>
+class DistinctAggregate : public Aggregate {
+ public:
+  DistinctAggregate(std::unique_ptr<Aggregate> aggregate, TypePtr inputType)
+      : Aggregate(aggregate->resultType()),
+        aggregate_(std::move(aggregate)),
+        inputType_(std::move(inputType)),
+        aggregateOffset_(bits::roundUp(
+            sizeof(DistinctValues<T>),
+            aggregate_->accumulatorAlignmentSize())) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return aggregateOffset_ + aggregate_->accumulatorFixedWidthSize();
+  }
+
+  int32_t accumulatorAlignmentSize() const override {
+    return aggregate_->accumulatorAlignmentSize();
+  }
+
+  bool accumulatorUsesExternalMemory() const override {
+    return aggregate_->accumulatorUsesExternalMemory();
+  }
+
+  bool isFixedSize() const override {
+    return false;
+  }
+
+  void setAllocator(HashStringAllocator* allocator) override {
+    Aggregate::setAllocator(allocator);
+    aggregate_->setAllocator(allocator);
+  }
+
+  void setOffsets(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      int32_t rowSizeOffset) override {
+    Aggregate::setOffsets(offset, nullByte, nullMask, rowSizeOffset);
+    // The accumulator of 'aggregate_' follows the distinct values. The null
+    // flag is only used by 'aggregate_'.
+    aggregate_->setOffsets(
+        offset + aggregateOffset_, nullByte, nullMask, rowSizeOffset);
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    for (auto index : indices) {
+      new (groups[index] + offset_) DistinctValues<T>(allocator_);
+    }
+    aggregate_->initializeNewGroups(groups, indices);
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedValues_.decode(*args[0], rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      addValue(groups[row], decodedValues_, row);
+    });
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedValues_.decode(*args[0], rows);
+    rows.applyToSelected(
+        [&](vector_size_t row) { addValue(group, decodedValues_, row); });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addArrays(rows, args[0], [&](vector_size_t row) { return groups[row]; });
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addArrays(rows, args[0], [&](vector_size_t /*row*/) { return group; });
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto arrays = (*result)->as<ArrayVector>();
+    VELOX_CHECK_NOT_NULL(arrays);
+    arrays->resize(numGroups);
+    auto elements = arrays->elements()->asFlatVector<T>();
+    VELOX_CHECK_NOT_NULL(elements);
+    elements->resize(countValues(groups, numGroups));
+    vector_size_t offset = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      auto distinct = value<DistinctValues<T>>(groups[i]);
+      arrays->setNull(i, false);
+      arrays->setOffsetAndSize(i, offset, distinct->size());
+      offset = copyValues<true>(*distinct, *elements, offset);
+    }
+  }
+
+  // Adds the distinct values of each group to 'aggregate_' and extracts its
+  // results.
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    const auto numValues = countValues(groups, numGroups);
+    if (numValues > 0) {
+      auto values =
+          BaseVector::create(inputType_, numValues, (*result)->pool());
+      auto flatValues = values->asFlatVector<T>();
+      valueGroups_.resize(numValues);
+      vector_size_t offset = 0;
+      for (auto i = 0; i < numGroups; ++i) {
+        auto distinct = value<DistinctValues<T>>(groups[i]);
+        std::fill_n(valueGroups_.begin() + offset, distinct->size(), groups[i]);
+        offset = copyValues<false>(*distinct, *flatValues, offset);
+      }
+      aggregate_->addRawInput(
+          valueGroups_.data(), SelectivityVector(numValues), {values}, false);
+    }
+    aggregate_->extractValues(groups, numGroups, result);
+  }
+
+  void destroy(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      auto distinct = value<DistinctValues<T>>(group);
+      if constexpr (std::is_same_v<T, StringView>) {
+        for (const auto& string : distinct->values) {
+          if (!string.isInline()) {
+            allocator_->free(HashStringAllocator::headerOf(string.data()));
+          }
+        }
+      }
+      std::destroy_at(distinct);
+    }
+    aggregate_->destroy(groups);
+  }
+
+ private:
+  void addValue(char* group, const DecodedVector& decoded, vector_size_t row) {
+    auto distinct = value<DistinctValues<T>>(group);
+    if (decoded.isNullAt(row)) {
+      distinct->hasNull = true;
+      return;
+    }
+    auto tracker = trackRowSize(group);
+    auto input = decoded.valueAt<T>(row);
+    if constexpr (std::is_same_v<T, StringView>) {
+      if (!input.isInline() && distinct->values.count(input) == 0) {
+        auto header = allocator_->allocate(input.size());
+        memcpy(header->begin(), input.data(), input.size());
+        input = StringView(header->begin(), input.size());
+      }
+    }
+    distinct->values.insert(input);
+  }
+
+  // Adds the elements of the arrays in 'arg' to the groups given by
+  // 'groupAt' for each row.
+  template <typename GroupAt>
+  void addArrays(
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      GroupAt groupAt) {
+    decodedValues_.decode(*arg, rows);
+    auto arrays = decodedValues_.base()->template as<ArrayVector>();
+    VELOX_CHECK_NOT_NULL(arrays);
+    decodedElements_.decode(*arrays->elements());
+    rows.applyToSelected([&](vector_size_t row) {
+      if (decodedValues_.isNullAt(row)) {
+        return;
+      }
+      auto group = groupAt(row);
+      const auto index = decodedValues_.index(row);
+      const auto offset = arrays->offsetAt(index);
+      const auto size = arrays->sizeAt(index);
+      for (auto i = offset; i < offset + size; ++i) {
+        addValue(group, decodedElements_, i);
+      }
+    });
+  }
+
+  vector_size_t countValues(char** groups, int32_t numGroups) const {
+    vector_size_t numValues = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      numValues += value<DistinctValues<T>>(groups[i])->size();
+    }
+    return numValues;
+  }
+
+  // Copies the values of 'distinct' to 'vector' starting at 'offset' and
+  // returns the offset after the last copied value. Strings are referenced
+  // without copy if 'copyStrings' is false.
+  template <bool copyStrings>
+  static vector_size_t copyValues(
+      const DistinctValues<T>& distinct,
+      FlatVector<T>& vector,
+      vector_size_t offset) {
+    for (const auto& element : distinct.values) {
+      if constexpr (std::is_same_v<T, StringView> && !copyStrings) {
+        vector.setNoCopy(offset++, element);
+      } else {
+        vector.set(offset++, element);
+      }
+    }
+    if (distinct.hasNull) {
+      vector.setNull(offset++, true);
+    }
+    return offset;
+  }
+
+  const std::unique_ptr<Aggregate> aggregate_;
+  const TypePtr inputType_;
+
+  // Offset of the accumulator of 'aggregate_' from the distinct values.
+  const int32_t aggregateOffset_;
+
+  DecodedVector decodedValues_;
+  DecodedVector decodedElements_;
+
+  // Group of each value given to 'aggregate_' in extractValues().
+  std::vector<char*> valueGroups_;
+};
+
+template <typename T>
+std::unique_ptr<Aggregate> makeDistinct(
+    std::unique_ptr<Aggregate> aggregate,
+    const TypePtr& inputType) {
+  return std::make_unique<DistinctAggregate<T>>(
+      std::move(aggregate), inputType);
+}
+
+} // namespace
+
+std::unique_ptr<Aggregate> makeDistinctAggregate(
+    std::unique_ptr<Aggregate> aggregate,
+    const TypePtr& inputType) {
+  switch (inputType->kind()) {
+    case TypeKind::BOOLEAN:
+      return makeDistinct<bool>(std::move(aggregate), inputType);
+    case TypeKind::TINYINT:
+      return makeDistinct<int8_t>(std::move(aggregate), inputType);
+    case TypeKind::SMALLINT:
+      return makeDistinct<int16_t>(std::move(aggregate), inputType);
+    case TypeKind::INTEGER:
+      return makeDistinct<int32_t>(std::move(aggregate), inputType);
+    case TypeKind::BIGINT:
+      return makeDistinct<int64_t>(std::move(aggregate), inputType);
+    case TypeKind::REAL:
+      return makeDistinct<float>(std::move(aggregate), inputType);
+    case TypeKind::DOUBLE:
+      return makeDistinct<double>(std::move(aggregate), inputType);
+    case TypeKind::TIMESTAMP:
+      return makeDistinct<Timestamp>(std::move(aggregate), inputType);
+    case TypeKind::DATE:
+      return makeDistinct<Date>(std::move(aggregate), inputType);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return makeDistinct<StringView>(std::move(aggregate), inputType);
+    default:
+      VELOX_UNSUPPORTED(
+          "Distinct aggregation is not supported for {}",
+          inputType->toString());
+  }
+}
+
+TypePtr distinctAggregateIntermediateType(const TypePtr& inputType) {
+  return ARRAY(inputType);
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/Aggregate.h"
+
+namespace facebook::velox::exec {
+
+/// Returns an aggregate that applies 'aggregate' to the distinct values of
+/// its single argument of type 'inputType' in each group, e.g. for
+/// count(DISTINCT x). Each group keeps a hash set of the values it has seen
+/// in memory from the HashStringAllocator of the group rows. A null input is
+/// kept as one more distinct value. The values are added to 'aggregate' when
+/// the final results are extracted. The intermediate results are arrays of
+/// the distinct values, see distinctAggregateIntermediateType(), so that
+/// the distinct aggregate can be spilled and merged. Supports the
+/// primitive types except decimals.
+std::unique_ptr<Aggregate> makeDistinctAggregate(
+    std::unique_ptr<Aggregate> aggregate,
+    const TypePtr& inputType);
+
+/// Returns the type of the intermediate results of a distinct aggregate over
+/// 'inputType'.
+TypePtr distinctAggregateIntermediateType(const TypePtr& inputType);
+
+} // namespace facebook::velox::exec
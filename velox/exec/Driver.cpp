@@ -79,7 +79,13 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
 
         std::lock_guard<std::mutex> l(task->mutex());
         if (!driver->state().isTerminated) {
-          state->operator_->recordBlockingTime(state->sinceMicros_);
+          state->operator_->recordBlockingTime(
+              state->sinceMicros_, state->reason_);
+          driver->recordTraceEvent(
+              DriverTraceEvent::Kind::kBlocked,
+              state->sinceMicros_,
+              getCurrentTimeMicro(),
+              state->reason_);
         }
         VELOX_CHECK(!driver->state().isSuspended);
         VELOX_CHECK(driver->state().hasBlockingFuture);
@@ -161,6 +167,9 @@ Driver::Driver(
   // Operators need access to their Driver for adaptation.
   ctx_->driver = this;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  cpuUsageSampleRate_ = ctx_->queryConfig().operatorCpuUsageSampleRate();
+  timeSliceMicros_ = ctx_->queryConfig().driverTimeSliceMs() * 1'000UL;
+  traceEvents_ = ctx_->queryConfig().driverTraceEvents();
 }
 
 namespace {
@@ -252,8 +261,13 @@ void Driver::enqueueInternal() {
 StopReason Driver::runInternal(
     std::shared_ptr<Driver>& self,
     std::shared_ptr<BlockingState>& blockingState,
-    RowVectorPtr& result) {
-  auto queuedTime = (getCurrentTimeMicro() - queueTimeStartMicros_) * 1'000;
+    RowVectorPtr& result,
+    bool timeSliced) {
+  const auto startMicros = getCurrentTimeMicro();
+  auto queuedTime = (startMicros - queueTimeStartMicros_) * 1'000;
+  const uint64_t sliceEndMicros = timeSliced && timeSliceMicros_ > 0
+      ? startMicros + timeSliceMicros_
+      : std::numeric_limits<uint64_t>::max();
   // Update the next operator's queueTime.
   auto stop = closed_ ? StopReason::kTerminate : task()->enter(state_);
   if (stop != StopReason::kNone) {
@@ -309,6 +323,11 @@ StopReason Driver::runInternal(
           guard.notThrown();
           return stop;
         }
+        if (sliceEndMicros != std::numeric_limits<uint64_t>::max() &&
+            getCurrentTimeMicro() >= sliceEndMicros) {
+          guard.notThrown();
+          return StopReason::kYield;
+        }
 
         auto op = operators_[i].get();
         // In case we are blocked, this index will point to the operator, whose
@@ -463,7 +482,16 @@ StopReason Driver::runInternal(
 void Driver::run(std::shared_ptr<Driver> self) {
   std::shared_ptr<BlockingState> blockingState;
   RowVectorPtr nullResult;
-  auto reason = self->runInternal(self, blockingState, nullResult);
+  const auto queuedMicros = self->queueTimeStartMicros_;
+  const auto startMicros = getCurrentTimeMicro();
+  auto reason = self->runInternal(self, blockingState, nullResult, true);
+  if (self->traceEvents_) {
+    const auto endMicros = getCurrentTimeMicro();
+    self->recordTraceEvent(
+        DriverTraceEvent::Kind::kQueued, queuedMicros, startMicros);
+    self->recordTraceEvent(
+        DriverTraceEvent::Kind::kRun, startMicros, endMicros);
+  }
 
   // When Driver runs on an executor, the last operator (sink) must not produce
   // any results.
@@ -657,6 +685,23 @@ SuspendedSection::~SuspendedSection() {
   }
 }
 
+void Driver::recordTraceEvent(
+    DriverTraceEvent::Kind kind,
+    uint64_t startMicros,
+    uint64_t endMicros,
+    BlockingReason reason) {
+  if (!traceEvents_) {
+    return;
+  }
+  ctx_->task->addTraceEvent(
+      {kind,
+       reason,
+       ctx_->pipelineId,
+       ctx_->driverId,
+       startMicros,
+       endMicros});
+}
+
 std::string Driver::label() const {
   return fmt::format("<Driver {}:{}>", task()->taskId(), ctx_->driverId);
 }
@@ -681,6 +726,10 @@ std::string blockingReasonToString(BlockingReason reason) {
       return "kWaitForConnector";
     case BlockingReason::kWaitForSpill:
       return "kWaitForSpill";
+    case BlockingReason::kWaitForAggregationMerge:
+      return "kWaitForAggregationMerge";
+    case BlockingReason::kWaitForSortMerge:
+      return "kWaitForSortMerge";
   }
   VELOX_UNREACHABLE();
   return "";
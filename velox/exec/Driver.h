@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/Random.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/portability/SysSyscall.h>
@@ -138,10 +139,36 @@ enum class BlockingReason {
   /// Build operator is blocked waiting for all its peers to stop to run group
   /// spill on all of them.
   kWaitForSpill,
+  /// Aggregation operator is blocked waiting for all its peers to finish input
+  /// before merging their groups in parallel.
+  kWaitForAggregationMerge,
+  /// OrderBy operator is blocked waiting for the last of its peers to finish
+  /// input and take over its sorted rows for the final merge.
+  kWaitForSortMerge,
 };
 
 std::string blockingReasonToString(BlockingReason reason);
 
+/// Interval in the life of a Driver, recorded if
+/// QueryConfig::kDriverTraceEvents is set.
+struct DriverTraceEvent {
+  enum class Kind {
+    /// On a thread, running the operators.
+    kRun,
+    /// In the executor queue, waiting for a thread.
+    kQueued,
+    /// Off thread, waiting for 'reason'.
+    kBlocked,
+  };
+
+  Kind kind;
+  BlockingReason reason{BlockingReason::kNotBlocked};
+  int32_t pipelineId;
+  int32_t driverId;
+  uint64_t startMicros;
+  uint64_t endMicros;
+};
+
 class BlockingState {
  public:
   BlockingState(
@@ -250,6 +277,13 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   void initializeOperatorStats(std::vector<OperatorStats>& stats);
 
+  /// Adds an interval of 'this' to the trace events of the Task if enabled.
+  void recordTraceEvent(
+      DriverTraceEvent::Kind kind,
+      uint64_t startMicros,
+      uint64_t endMicros,
+      BlockingReason reason = BlockingReason::kNotBlocked);
+
   void addStatsToTask();
 
   // Returns true if all operators between the source and 'aggregation' are
@@ -295,10 +329,14 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   static void run(std::shared_ptr<Driver> self);
 
+  // Runs the operators until they block, finish or are stopped by the Task.
+  // If 'timeSliced' is true, also stops with kYield after
+  // 'timeSliceMicros_'.
   StopReason runInternal(
       std::shared_ptr<Driver>& self,
       std::shared_ptr<BlockingState>& blockingState,
-      RowVectorPtr& result);
+      RowVectorPtr& result,
+      bool timeSliced = false);
 
   void close();
 
@@ -309,12 +347,20 @@ class Driver : public std::enable_shared_from_this<Driver> {
   /// If 'trackOperatorCpuUsage_' is true, returns initialized timer object to
   /// track cpu and wall time of an operation. Returns null otherwise.
   /// The delta CpuWallTiming object would be passes to 'func' upon destruction
-  /// of the timer.
+  /// of the timer. If 'cpuUsageSampleRate_' is greater than 1, times one in
+  /// that many calls at random. For the other calls, passes a timing with
+  /// only the count to 'func' and returns null.
   template <typename F>
   std::unique_ptr<DeltaCpuWallTimer<F>> createDeltaCpuWallTimer(F&& func) {
-    return trackOperatorCpuUsage_
-        ? std::make_unique<DeltaCpuWallTimer<F>>(std::move(func))
-        : nullptr;
+    if (!trackOperatorCpuUsage_) {
+      return nullptr;
+    }
+    if (cpuUsageSampleRate_ > 1 && !folly::Random::oneIn(cpuUsageSampleRate_)) {
+      func(CpuWallTiming{1, 0, 0});
+      return nullptr;
+    }
+    return std::make_unique<DeltaCpuWallTimer<F>>(
+        std::move(func), cpuUsageSampleRate_);
   }
 
   std::unique_ptr<DriverCtx> ctx_;
@@ -334,6 +380,14 @@ class Driver : public std::enable_shared_from_this<Driver> {
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 
   bool trackOperatorCpuUsage_;
+
+  // One in this many calls are timed if 'trackOperatorCpuUsage_' is true.
+  uint32_t cpuUsageSampleRate_;
+
+  // Wall time after which a Driver on an executor yields. 0 if it does not.
+  uint64_t timeSliceMicros_;
+
+  bool traceEvents_;
 };
 
 using OperatorSupplier = std::function<std::unique_ptr<Operator>(
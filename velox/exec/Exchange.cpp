@@ -16,11 +16,33 @@
 #include "velox/exec/Exchange.h"
 #include <velox/common/base/Exceptions.h>
 #include <velox/common/memory/Memory.h>
+#include <optional>
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
 
+serializer::presto::PrestoVectorSerde::PrestoOptions exchangeSerdeOptions(
+    const core::QueryConfig& config) {
+  static const std::unordered_map<std::string, folly::io::CodecType> kTypes{
+      {"none", folly::io::CodecType::NO_COMPRESSION},
+      {"lz4", folly::io::CodecType::LZ4},
+      {"zstd", folly::io::CodecType::ZSTD},
+  };
+  const auto name = config.exchangeCompressionCodec();
+  auto it = kTypes.find(name);
+  VELOX_USER_CHECK(
+      it != kTypes.end(), "Unknown exchange compression codec: {}", name);
+  VELOX_USER_CHECK(
+      folly::io::hasCodec(it->second),
+      "Exchange compression codec {} is not available",
+      name);
+  serializer::presto::PrestoVectorSerde::PrestoOptions options(
+      false, it->second);
+  options.preserveEncodings = config.exchangePreserveEncodings();
+  return options;
+}
+
 SerializedPage::SerializedPage(
     std::unique_ptr<folly::IOBuf> iobuf,
     memory::MemoryPool* pool,
@@ -53,21 +75,13 @@ SerializedPage::~SerializedPage() {
 }
 
 void SerializedPage::prepareStreamForDeserialize(ByteStream* input) {
-  input->resetInput(std::move(ranges_));
-}
-
-std::shared_ptr<ExchangeSource> ExchangeSource::create(
-    const std::string& taskId,
-    int destination,
-    std::shared_ptr<ExchangeQueue> queue,
-    memory::MemoryPool* FOLLY_NONNULL pool) {
-  for (auto& factory : factories()) {
-    auto result = factory(taskId, destination, queue, pool);
-    if (result) {
-      return result;
-    }
+  // A destruction callback may free the memory behind 'iobuf_', so the data
+  // can only be used past the lifetime of 'this' without one.
+  std::shared_ptr<folly::IOBuf> owner;
+  if (!onDestructionCb_) {
+    owner = iobuf_->clone();
   }
-  VELOX_FAIL("No ExchangeSource factory matches {}", taskId);
+  input->resetInput(std::move(ranges_), std::move(owner));
 }
 
 // static
@@ -77,14 +91,20 @@ std::vector<ExchangeSource::Factory>& ExchangeSource::factories() {
 }
 
 namespace {
+// Reads the pages of a task in this process from its output buffers in the
+// PartitionedOutputBufferManager. The pages share the IOBufs of the producer,
+// so that no data is copied. 'localTaskId' is the id of the producing task,
+// which may differ from 'taskId' if this is given as a results URI.
 class LocalExchangeSource : public ExchangeSource {
  public:
   LocalExchangeSource(
       const std::string& taskId,
+      const std::string& localTaskId,
       int destination,
       std::shared_ptr<ExchangeQueue> queue,
       memory::MemoryPool* FOLLY_NONNULL pool)
-      : ExchangeSource(taskId, destination, queue, pool) {}
+      : ExchangeSource(taskId, destination, queue, pool),
+        localTaskId_(localTaskId) {}
 
   bool shouldRequestLocked() override {
     if (atEnd_) {
@@ -100,9 +120,9 @@ class LocalExchangeSource : public ExchangeSource {
     auto requestedSequence = sequence_;
     auto self = shared_from_this();
     buffers->getData(
-        taskId_,
+        localTaskId_,
         destination_,
-        kMaxBytes,
+        maxBytes_,
         sequence_,
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
@@ -126,7 +146,9 @@ class LocalExchangeSource : public ExchangeSource {
               // Keep looping, there could be extra end markers.
               continue;
             }
-            inputPage->unshare();
+            // The page is a clone of the producer's IOBuf chain. It is not
+            // unshared or coalesced since the deserializer reads the ranges
+            // of the chain in place.
             pages.push_back(
                 std::make_unique<SerializedPage>(std::move(inputPage), pool_));
             inputPage = nullptr;
@@ -146,20 +168,20 @@ class LocalExchangeSource : public ExchangeSource {
           }
           // Outside of queue mutex.
           if (atEnd_) {
-            buffers->deleteResults(taskId_, destination_);
+            buffers->deleteResults(localTaskId_, destination_);
           } else {
-            buffers->acknowledge(taskId_, destination_, ackSequence);
+            buffers->acknowledge(localTaskId_, destination_, ackSequence);
           }
         });
   }
 
   void close() override {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
-    buffers->deleteResults(taskId_, destination_);
+    buffers->deleteResults(localTaskId_, destination_);
   }
 
  private:
-  static constexpr uint64_t kMaxBytes = 32 * 1024 * 1024; // 32 MB
+  const std::string localTaskId_;
 };
 
 std::unique_ptr<ExchangeSource> createLocalExchangeSource(
@@ -169,13 +191,57 @@ std::unique_ptr<ExchangeSource> createLocalExchangeSource(
     memory::MemoryPool* FOLLY_NONNULL pool) {
   if (strncmp(taskId.c_str(), "local://", 8) == 0) {
     return std::make_unique<LocalExchangeSource>(
-        taskId, destination, std::move(queue), pool);
+        taskId, taskId, destination, std::move(queue), pool);
   }
   return nullptr;
 }
 
+// Returns the id of the task whose results are at 'taskId' if the task runs
+// in this process. 'taskId' is either the id of the task or an URI of its
+// results of the form <scheme>://<host>/v1/task/<id>[/results/...].
+std::optional<std::string> localTaskId(const std::string& taskId) {
+  auto buffers = PartitionedOutputBufferManager::getInstance().lock();
+  if (!buffers) {
+    return std::nullopt;
+  }
+  if (buffers->hasTask(taskId)) {
+    return taskId;
+  }
+  static const std::string kTaskPath = "/v1/task/";
+  auto start = taskId.find(kTaskPath);
+  if (start == std::string::npos) {
+    return std::nullopt;
+  }
+  start += kTaskPath.size();
+  auto id = taskId.substr(start, taskId.find('/', start) - start);
+  if (!id.empty() && buffers->hasTask(id)) {
+    return id;
+  }
+  return std::nullopt;
+}
+
 } // namespace
 
+std::shared_ptr<ExchangeSource> ExchangeSource::create(
+    const std::string& taskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* FOLLY_NONNULL pool) {
+  // The results of a task in this process are read from its output buffers
+  // instead of going through the network.
+  if (auto id = localTaskId(taskId)) {
+    return std::make_shared<LocalExchangeSource>(
+        taskId, id.value(), destination, std::move(queue), pool);
+  }
+  for (auto& factory : factories()) {
+    auto result = factory(taskId, destination, queue, pool);
+    if (result) {
+      return result;
+    }
+  }
+  VELOX_FAIL("No ExchangeSource factory matches {}", taskId);
+}
+
 void ExchangeClient::initialize(memory::MemoryPool* FOLLY_NONNULL pool) {
   pool_ = pool;
 }
@@ -197,10 +263,12 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
     if (closed_) {
       toClose = std::move(source);
     } else {
+      const auto outstandingCredits = outstandingCreditsLocked();
       sources_.push_back(source);
       queue_->addSource();
       if (source->shouldRequestLocked()) {
         toRequest = source;
+        setCreditsLocked(outstandingCredits, {toRequest});
       }
     }
   }
@@ -256,11 +324,13 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
     }
     // There is space for more data, send requests to sources with no pending
     // request.
+    const auto outstandingCredits = outstandingCreditsLocked();
     for (auto& source : sources_) {
       if (source->shouldRequestLocked()) {
         toRequest.push_back(source);
       }
     }
+    setCreditsLocked(outstandingCredits, toRequest);
   }
 
   // Outside of lock
@@ -270,6 +340,36 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
   return page;
 }
 
+int64_t ExchangeClient::outstandingCreditsLocked() const {
+  int64_t credits = 0;
+  for (const auto& source : sources_) {
+    if (source->isRequestPendingLocked()) {
+      credits += source->maxBytes();
+    }
+  }
+  return credits;
+}
+
+void ExchangeClient::setCreditsLocked(
+    int64_t outstandingCredits,
+    const std::vector<std::shared_ptr<ExchangeSource>>& sources) {
+  if (sources.empty()) {
+    return;
+  }
+  int64_t available = maxQueuedBytes_ - queue_->totalBytes();
+  if (pool_ && pool_->cap() < memory::kMaxMemory) {
+    available = std::min(available, pool_->cap() - pool_->getCurrentBytes());
+  }
+  available -= outstandingCredits;
+  const auto credit = std::clamp<int64_t>(
+      available / static_cast<int64_t>(sources.size()),
+      kMinCredit,
+      ExchangeSource::kDefaultMaxBytes);
+  for (const auto& source : sources) {
+    source->setMaxBytesLocked(credit);
+  }
+}
+
 ExchangeClient::~ExchangeClient() {
   close();
 }
@@ -373,7 +473,11 @@ RowVectorPtr Exchange::getOutput() {
   }
 
   VectorStreamGroup::read(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+      inputStream_.get(),
+      operatorCtx_->pool(),
+      outputType_,
+      &result_,
+      &serdeOptions_);
 
   {
     auto lockedStats = stats_.wlock();
@@ -20,9 +20,15 @@
 #include <memory>
 #include "velox/common/memory/ByteStream.h"
 #include "velox/exec/Operator.h"
+#include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
 
+// Returns the serde options for the pages of the Exchange and
+// PartitionedOutput operators of a query with 'config'.
+serializer::presto::PrestoVectorSerde::PrestoOptions exchangeSerdeOptions(
+    const core::QueryConfig& config);
+
 // Corresponds to Presto SerializedPage, i.e. a container for
 // serialize vectors in Presto wire format.
 class SerializedPage {
@@ -30,7 +36,8 @@ class SerializedPage {
   static constexpr int kSerializedPageOwner = -11;
 
   // Construct from IOBuf chain. The external memory usage of 'iobuf' will be
-  // tracked if 'pool' is not null.
+  // tracked if 'pool' is not null. The chain may be shared and have any number
+  // of buffers, it is not coalesced.
   //
   // TODO: consider to enforce setting memory pool if possible.
   explicit SerializedPage(
@@ -46,7 +53,8 @@ class SerializedPage {
   }
 
   // Makes 'input' ready for deserializing 'this' with
-  // VectorStreamGroup::read().
+  // VectorStreamGroup::read(). Without a destruction callback, 'input' shares
+  // ownership of the data, so that the deserialized vectors may reference it.
   void prepareStreamForDeserialize(ByteStream* FOLLY_NONNULL input);
 
   std::unique_ptr<folly::IOBuf> getIOBuf() const {
@@ -246,10 +254,28 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   virtual bool shouldRequestLocked() = 0;
 
   // Requests the producer to generate more data. Call only if shouldRequest()
-  // was true. The object handles its own lifetime by acquiring a
-  // shared_from_this() pointer if needed.
+  // was true. The response should hold at most maxBytes() of pages. The object
+  // handles its own lifetime by acquiring a shared_from_this() pointer if
+  // needed.
   virtual void request() = 0;
 
+  // Returns true if the last request() has not received its response. Called
+  // while holding a lock over queue_->mutex().
+  bool isRequestPendingLocked() const {
+    return requestPending_;
+  }
+
+  // Returns the byte credit of the next request().
+  int64_t maxBytes() const {
+    return maxBytes_;
+  }
+
+  // Sets the byte credit of the next request(). Called by the ExchangeClient
+  // while holding a lock over queue_->mutex().
+  void setMaxBytesLocked(int64_t maxBytes) {
+    maxBytes_ = maxBytes;
+  }
+
   // Close the exchange source. May be called before all data
   // has been received and proessed. This can happen in case
   // of an error or an operator like Limit aborting the query
@@ -272,6 +298,8 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
 
   static std::vector<Factory>& factories();
 
+  static constexpr int64_t kDefaultMaxBytes = 32 << 20; // 32 MB.
+
   // ID of the task producing data
   const std::string taskId_;
   // Destination number of 'this' on producer
@@ -280,6 +308,8 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   std::shared_ptr<ExchangeQueue> queue_;
   std::atomic<bool> requestPending_{false};
   bool atEnd_ = false;
+  // Maximum bytes of pages to fetch in the next request().
+  int64_t maxBytes_{kDefaultMaxBytes};
 
  protected:
   memory::MemoryPool* FOLLY_NONNULL pool_;
@@ -293,13 +323,21 @@ struct RemoteConnectorSplit : public connector::ConnectorSplit {
 };
 
 // Handle for a set of producers. This may be shared by multiple Exchanges, one
-// per consumer thread.
+// per consumer thread. The bytes a source may fetch per request are limited by
+// a credit. When the queue drains below its minimum, the room left below
+// twice the minimum or the free memory of a capped pool, less the credits of
+// pending requests, is split evenly between the sources that are requested, so
+// that one fast source cannot fill the queue.
 class ExchangeClient {
  public:
   static constexpr int32_t kDefaultMinSize = 32 << 20; // 32 MB.
 
+  // Minimum credit of a request, so that each request can return a page.
+  static constexpr int64_t kMinCredit = 1 << 20; // 1 MB.
+
   explicit ExchangeClient(int destination, int64_t minSize = kDefaultMinSize)
       : destination_(destination),
+        maxQueuedBytes_(2 * minSize),
         queue_(std::make_shared<ExchangeQueue>(minSize)) {
     VELOX_CHECK(
         destination >= 0,
@@ -337,7 +375,19 @@ class ExchangeClient {
   std::string toString();
 
  private:
+  // Returns the sum of the credits of the sources with a pending request.
+  int64_t outstandingCreditsLocked() const;
+
+  // Sets the credits of 'sources', which are about to be requested.
+  // 'outstandingCredits' is the value of outstandingCreditsLocked() before
+  // 'sources' were marked as pending.
+  void setCreditsLocked(
+      int64_t outstandingCredits,
+      const std::vector<std::shared_ptr<ExchangeSource>>& sources);
+
   const int destination_;
+  // Upper bound for the bytes in 'queue_' and the credits of pending requests.
+  const int64_t maxQueuedBytes_;
   std::shared_ptr<ExchangeQueue> queue_;
   std::unordered_set<std::string> taskIds_;
   std::vector<std::shared_ptr<ExchangeSource>> sources_;
@@ -359,6 +409,8 @@ class Exchange : public SourceOperator {
             exchangeNode->id(),
             "Exchange"),
         planNodeId_(exchangeNode->id()),
+        serdeOptions_(
+            exchangeSerdeOptions(ctx->task->queryCtx()->queryConfig())),
         exchangeClient_(std::move(exchangeClient)) {
     if (operatorCtx_->driverCtx()->driverId == 0) {
       // As all Exchange operators share the same ExchangeClient, we only
@@ -404,6 +456,7 @@ class Exchange : public SourceOperator {
   /// there are more splits available or no-more-splits signal has arrived.
   ContinueFuture splitFuture_{ContinueFuture::makeEmpty()};
 
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
   RowVectorPtr result_;
   std::shared_ptr<ExchangeClient> exchangeClient_;
   std::unique_ptr<SerializedPage> currentPage_;
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/FairShareExecutor.h"
+
+#include <glog/logging.h>
+
+#include <chrono>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+
+void FairShareExecutor::Group::add(folly::Func func) {
+  executor_->add(this, std::move(func));
+}
+
+uint64_t FairShareExecutor::Group::runTimeNanos() const {
+  std::lock_guard<std::mutex> l(executor_->mutex_);
+  return runTimeNanos_;
+}
+
+FairShareExecutor::FairShareExecutor(int32_t numThreads) {
+  VELOX_CHECK_GT(numThreads, 0);
+  threads_.reserve(numThreads);
+  for (auto i = 0; i < numThreads; ++i) {
+    threads_.emplace_back([this]() { run(); });
+  }
+}
+
+FairShareExecutor::~FairShareExecutor() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stop_ = true;
+  }
+  wakeup_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+std::shared_ptr<FairShareExecutor::Group> FairShareExecutor::addGroup(
+    std::string name,
+    int32_t weight) {
+  VELOX_CHECK_GT(weight, 0);
+  std::shared_ptr<Group> group(new Group(this, std::move(name), weight));
+  std::lock_guard<std::mutex> l(mutex_);
+  groups_.push_back(group);
+  return group;
+}
+
+void FairShareExecutor::add(Group* group, folly::Func func) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (group->queue_.empty()) {
+      auto next = nextGroupLocked();
+      if (next != nullptr) {
+        group->virtualTimeNanos_ =
+            std::max(group->virtualTimeNanos_, next->virtualTimeNanos_);
+      }
+    }
+    group->queue_.push_back(std::move(func));
+  }
+  wakeup_.notify_one();
+}
+
+std::shared_ptr<FairShareExecutor::Group> FairShareExecutor::nextGroupLocked()
+    const {
+  std::shared_ptr<Group> next;
+  for (const auto& group : groups_) {
+    if (!group->queue_.empty() &&
+        (next == nullptr ||
+         group->virtualTimeNanos_ < next->virtualTimeNanos_)) {
+      next = group;
+    }
+  }
+  return next;
+}
+
+void FairShareExecutor::run() {
+  for (;;) {
+    std::shared_ptr<Group> group;
+    folly::Func func;
+    {
+      std::unique_lock<std::mutex> l(mutex_);
+      wakeup_.wait(l, [&]() {
+        group = nextGroupLocked();
+        return group != nullptr || stop_;
+      });
+      if (group == nullptr) {
+        return;
+      }
+      func = std::move(group->queue_.front());
+      group->queue_.pop_front();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      func();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Uncaught exception in FairShareExecutor group "
+                 << group->name() << ": " << e.what();
+    }
+    const uint64_t elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    std::lock_guard<std::mutex> l(mutex_);
+    group->runTimeNanos_ += elapsed;
+    group->virtualTimeNanos_ += elapsed / group->weight_;
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/Executor.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// Thread pool shared by groups of queries, e.g. resource groups or single
+/// Tasks, that divides the thread time between the groups in proportion to
+/// their weights. Each group is a folly::Executor to set as the executor of
+/// the QueryCtx of its queries. A thread takes the next function from the
+/// group with work queued that has had the least thread time divided by
+/// weight. Drivers that yield after a time slice, see
+/// QueryConfig::kDriverTimeSliceMs, go back to their group queue, so that a
+/// group with running Drivers cannot hold all threads.
+class FairShareExecutor {
+ public:
+  class Group : public folly::Executor {
+   public:
+    void add(folly::Func func) override;
+
+    const std::string& name() const {
+      return name_;
+    }
+
+    int32_t weight() const {
+      return weight_;
+    }
+
+    /// Thread time spent running the functions of 'this' so far.
+    uint64_t runTimeNanos() const;
+
+   private:
+    friend class FairShareExecutor;
+
+    Group(FairShareExecutor* executor, std::string name, int32_t weight)
+        : executor_(executor), name_(std::move(name)), weight_(weight) {}
+
+    FairShareExecutor* const executor_;
+    const std::string name_;
+    const int32_t weight_;
+
+    // Members below are guarded by 'executor_->mutex_'.
+    std::deque<folly::Func> queue_;
+
+    // Run time divided by weight. A group that gets work after being idle
+    // starts at the minimum of the groups with work, so that it does not get
+    // all threads for the time it was idle.
+    uint64_t virtualTimeNanos_{0};
+    uint64_t runTimeNanos_{0};
+  };
+
+  explicit FairShareExecutor(int32_t numThreads);
+
+  /// Runs the queued functions of all groups and joins the threads.
+  ~FairShareExecutor();
+
+  /// Adds a group that gets 'weight' shares of the threads when it has work.
+  /// The group must not be used after 'this' is destroyed.
+  std::shared_ptr<Group> addGroup(std::string name, int32_t weight = 1);
+
+ private:
+  void add(Group* group, folly::Func func);
+
+  // Returns the group with the lowest virtual time among the groups with
+  // work, or nullptr if none has work. Called under 'mutex_'.
+  std::shared_ptr<Group> nextGroupLocked() const;
+
+  void run();
+
+  mutable std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::vector<std::shared_ptr<Group>> groups_;
+  bool stop_{false};
+  std::vector<std::thread> threads_;
+};
+
+} // namespace facebook::velox::exec
@@ -15,7 +15,9 @@
  */
 #include "velox/exec/FilterProject.h"
 #include "velox/core/Expressions.h"
+#include "velox/expression/ConjunctExpr.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/ExprProfiler.h"
 #include "velox/expression/FieldReference.h"
 
 namespace facebook::velox::exec {
@@ -52,7 +54,10 @@ FilterProject::FilterProject(
           operatorId,
           project ? project->id() : filter->id(),
           "FilterProject"),
-      hasFilter_(filter != nullptr) {
+      hasFilter_(filter != nullptr),
+      maxCompactSelectivity_(driverCtx->queryConfig()
+                                 .filterProjectMaxCompactSelectivity()),
+      trackExprCpuUsage_(driverCtx->queryConfig().exprTrackCpuUsage()) {
   std::vector<core::TypedExprPtr> allExprs;
   if (hasFilter_) {
     allExprs.push_back(filter->filter());
@@ -75,11 +80,38 @@ FilterProject::FilterProject(
     isIdentityProjection_ = true;
   }
   numExprs_ = allExprs.size();
+  if (auto& task = operatorCtx_->task()) {
+    // The constants are folded by the first driver of the plan node.
+    allExprs =
+        task->foldedExprs(planNodeId(), allExprs, operatorCtx_->execCtx());
+  }
   exprs_ = makeExprSetFromFlag(std::move(allExprs), operatorCtx_->execCtx());
 
+  auto inputType = project ? project->sources()[0]->outputType()
+                           : filter->sources()[0]->outputType();
+  if (hasFilter_ && maxCompactSelectivity_ > 0) {
+    std::vector<bool> referenced(inputType->size());
+    for (auto field : exprs_->distinctFields()) {
+      referenced[inputType->getChildIdx(field->name())] = true;
+    }
+    for (auto& identity : identityProjections_) {
+      referenced[identity.inputChannel] = true;
+    }
+    for (column_index_t i = 0; i < referenced.size(); ++i) {
+      if (!referenced[i]) {
+        continue;
+      }
+      if (!inputType->childAt(i)->isPrimitiveType()) {
+        // Copying complex types costs more than wrapping them.
+        maxCompactSelectivity_ = 0;
+        compactChannels_.clear();
+        break;
+      }
+      compactChannels_.push_back(i);
+    }
+  }
+
   if (numExprs_ > 0 && !identityProjections_.empty()) {
-    auto inputType = project ? project->sources()[0]->outputType()
-                             : filter->sources()[0]->outputType();
     std::unordered_set<uint32_t> distinctFieldIndices;
     for (auto field : exprs_->distinctFields()) {
       auto fieldIndex = inputType->getChildIdx(field->name());
@@ -92,6 +124,31 @@ FilterProject::FilterProject(
       }
     }
   }
+
+  auto conjunct = hasFilter_
+      ? std::dynamic_pointer_cast<ConjunctExpr>(exprs_->expr(0))
+      : nullptr;
+  if (conjunct && conjunct->isAnd() &&
+      !dynamic_cast<ExprSetSimplified*>(exprs_.get())) {
+    std::unordered_set<std::string> projectedFields;
+    for (auto i = 1; i < numExprs_; ++i) {
+      for (auto* field : exprs_->expr(i)->distinctFields()) {
+        projectedFields.insert(field->field());
+      }
+    }
+    for (const auto& identity : identityProjections_) {
+      projectedFields.insert(inputType->nameOf(identity.inputChannel));
+    }
+    std::unordered_set<std::string> sharedFields;
+    for (auto* field : conjunct->distinctFields()) {
+      if (projectedFields.count(field->field())) {
+        sharedFields.insert(field->field());
+      }
+    }
+    conjunct->setPreloadFields(sharedFields);
+    exprs_->setPreloadMultiplyReferencedFields(false);
+    loadAfterFilter_ = true;
+  }
 }
 
 void FilterProject::addInput(RowVectorPtr input) {
@@ -103,6 +160,9 @@ void FilterProject::addInput(RowVectorPtr input) {
       if (result && result.unique() && result->isFlatEncoding()) {
         BaseVector::prepareForReuse(result, 0);
       } else {
+        // The expressions allocate their results from the vector pool of the
+        // operator, which gets the result back once the consumer releases it.
+        recycleWhenReleased(std::move(result));
         result.reset();
       }
     }
@@ -121,7 +181,23 @@ bool FilterProject::allInputProcessed() {
 }
 
 bool FilterProject::isFinished() {
-  return noMoreInput_ && allInputProcessed();
+  if (noMoreInput_ && allInputProcessed()) {
+    addExprRuntimeStats();
+    return true;
+  }
+  return false;
+}
+
+void FilterProject::addExprRuntimeStats() {
+  if (!trackExprCpuUsage_ || exprRuntimeStatsAdded_) {
+    return;
+  }
+  exprRuntimeStatsAdded_ = true;
+  auto lockedStats = stats_.wlock();
+  for (const auto& [name, counter] :
+       ExprProfiler::toRuntimeStats(exprs_->stats())) {
+    lockedStats->addRuntimeStat(name, counter);
+  }
 }
 
 RowVectorPtr FilterProject::getOutput() {
@@ -138,8 +214,10 @@ RowVectorPtr FilterProject::getOutput() {
 
   // Pre-load lazy vectors which are referenced by both expressions and identity
   // projections.
-  for (auto fieldIdx : multiplyReferencedFieldIndices_) {
-    evalCtx.ensureFieldLoaded(fieldIdx, *rows);
+  if (!loadAfterFilter_) {
+    for (auto fieldIdx : multiplyReferencedFieldIndices_) {
+      evalCtx.ensureFieldLoaded(fieldIdx, *rows);
+    }
   }
 
   if (!hasFilter_) {
@@ -170,12 +248,31 @@ RowVectorPtr FilterProject::getOutput() {
   }
 
   bool allRowsSelected = (numOut == size);
+  if (!allRowsSelected) {
+    rows->setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
+  }
+  if (loadAfterFilter_) {
+    loadProjectedFields(evalCtx, *rows);
+  }
+
+  if (!allRowsSelected && numOut <= size * maxCompactSelectivity_) {
+    compactInput(*rows, numOut);
+    numProcessedInputRows_ = numOut;
+    if (!isIdentityProjection_) {
+      LocalSelectivityVector localCompactedRows(
+          *operatorCtx_->execCtx(), numOut);
+      auto* compactedRows = localCompactedRows.get();
+      compactedRows->setAll();
+      EvalCtx compactedCtx(operatorCtx_->execCtx(), exprs_.get(), input_.get());
+      // The shared subexpressions of the filter refer to the rows before
+      // compaction.
+      exprs_->eval(1, numExprs_, true, *compactedRows, compactedCtx, results_);
+    }
+    return fillOutput(numOut, nullptr);
+  }
 
   // evaluate projections (if present)
   if (!isIdentityProjection_) {
-    if (!allRowsSelected) {
-      rows->setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
-    }
     project(*rows, evalCtx);
   }
 
@@ -188,6 +285,45 @@ void FilterProject::project(const SelectivityVector& rows, EvalCtx& evalCtx) {
       hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results_);
 }
 
+void FilterProject::compactInput(
+    const SelectivityVector& rows,
+    vector_size_t numOut) {
+  const auto* indices = filterEvalCtx_.selectedIndices->as<vector_size_t>();
+  LocalSelectivityVector localAllRows(*operatorCtx_->execCtx(), numOut);
+  auto* allRows = localAllRows.get();
+  allRows->setAll();
+
+  std::vector<VectorPtr> children(input_->childrenSize());
+  for (auto channel : compactChannels_) {
+    auto child = input_->childAt(channel);
+    LazyVector::ensureLoadedRows(child, rows);
+    child = BaseVector::loadedVectorShared(child);
+    auto& compacted = children[channel];
+    compacted = BaseVector::create(child->type(), numOut, pool());
+    compacted->copy(child.get(), *allRows, indices);
+  }
+  for (auto i = 0; i < children.size(); ++i) {
+    if (!children[i]) {
+      children[i] = BaseVector::createNullConstant(
+          input_->type()->childAt(i), numOut, pool());
+    }
+  }
+  addRuntimeStat("compactedInputRows", RuntimeCounter(numOut));
+  input_ = std::make_shared<RowVector>(
+      pool(), input_->type(), nullptr, numOut, std::move(children));
+}
+
+void FilterProject::loadProjectedFields(
+    EvalCtx& evalCtx,
+    const SelectivityVector& rows) {
+  for (auto fieldIdx : multiplyReferencedFieldIndices_) {
+    evalCtx.ensureFieldLoaded(fieldIdx, rows);
+  }
+  for (auto* field : exprs_->multiplyReferencedFields()) {
+    evalCtx.ensureFieldLoaded(field->index(evalCtx), rows);
+  }
+}
+
 vector_size_t FilterProject::filter(
     EvalCtx& evalCtx,
     const SelectivityVector& allRows) {
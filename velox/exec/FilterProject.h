@@ -73,6 +73,19 @@ class FilterProject : public Operator {
   // pre-condition: !isIdentityProjection_
   void project(const SelectivityVector& rows, EvalCtx& evalCtx);
 
+  // Replaces 'input_' with a batch of the 'numOut' rows in 'rows'. The
+  // columns in 'compactChannels_' are copied, the others are set to null.
+  void compactInput(const SelectivityVector& rows, vector_size_t numOut);
+
+  // Loads the fields referenced by both identity projections and expressions
+  // and the fields referenced by several expressions for the rows that passed
+  // the filter. Used if 'loadAfterFilter_' is true.
+  void loadProjectedFields(EvalCtx& evalCtx, const SelectivityVector& rows);
+
+  // Adds the stats of 'exprs_' by function name to the runtime stats once all
+  // input is processed, if 'trackExprCpuUsage_' is true.
+  void addExprRuntimeStats();
+
   // If true exprs_[0] is a filter and the other expressions are projections
   const bool hasFilter_{false};
   std::unique_ptr<ExprSet> exprs_;
@@ -82,6 +95,21 @@ class FilterProject : public Operator {
 
   vector_size_t numProcessedInputRows_{0};
 
+  // Fraction of passing rows at or below which the passing rows are copied
+  // into a new input batch instead of wrapping the results in dictionaries. 0
+  // if this is never done. See
+  // QueryConfig::kFilterProjectMaxCompactSelectivity.
+  double maxCompactSelectivity_{0};
+
+  // QueryConfig::exprTrackCpuUsage(). Enables reporting the expression stats
+  // in the runtime stats of the operator.
+  const bool trackExprCpuUsage_;
+
+  bool exprRuntimeStatsAdded_{false};
+
+  // Input channels referenced by the expressions or identity projections.
+  std::vector<column_index_t> compactChannels_;
+
   // Indices for fields/input columns that are both an identity projection and
   // are referenced by either a filter or project expression. This is used to
   // identify fields that need to be preloaded before evaluating filters or
@@ -91,5 +119,12 @@ class FilterProject : public Operator {
   // will load c1 only for rows where f(c0) is true. However, c1 identity
   // projection needs all rows.
   std::vector<column_index_t> multiplyReferencedFieldIndices_;
+
+  // True if the filter is an AND. The AND then loads the fields the
+  // projections also read for its active rows before evaluating the first
+  // conjunct that reads them, and the other fields that are preloaded above
+  // are loaded after the filter, so that lazy columns are not loaded for the
+  // rows the filter drops.
+  bool loadAfterFilter_{false};
 };
 } // namespace facebook::velox::exec
@@ -17,31 +17,23 @@
 
 namespace facebook::velox::exec {
 
-GroupId::GroupId(
-    int32_t operatorId,
-    DriverCtx* driverCtx,
-    const std::shared_ptr<const core::GroupIdNode>& groupIdNode)
-    : Operator(
-          driverCtx,
-          groupIdNode->outputType(),
-          operatorId,
-          groupIdNode->id(),
-          "GroupId") {
-  const auto& inputType = groupIdNode->sources()[0]->outputType();
+GroupIdProjection::GroupIdProjection(const core::GroupIdNode& groupIdNode)
+    : outputType_(groupIdNode.outputType()) {
+  const auto& inputType = groupIdNode.sources()[0]->outputType();
 
   std::unordered_map<std::string, column_index_t>
       inputToOutputGroupingKeyMapping;
-  for (const auto& groupingKeyInfo : groupIdNode->groupingKeyInfos()) {
+  for (const auto& groupingKeyInfo : groupIdNode.groupingKeyInfos()) {
     inputToOutputGroupingKeyMapping[groupingKeyInfo.input->name()] =
         outputType_->getChildIdx(groupingKeyInfo.output);
   }
 
-  auto numGroupingSets = groupIdNode->groupingSets().size();
+  auto numGroupingSets = groupIdNode.groupingSets().size();
   groupingKeyMappings_.reserve(numGroupingSets);
 
-  auto numGroupingKeys = groupIdNode->numGroupingKeys();
+  auto numGroupingKeys = groupIdNode.numGroupingKeys();
 
-  for (const auto& groupingSet : groupIdNode->groupingSets()) {
+  for (const auto& groupingSet : groupIdNode.groupingSets()) {
     std::vector<column_index_t> mappings(numGroupingKeys, kMissingGroupingKey);
     for (const auto& groupingKey : groupingSet) {
       auto outputChannel =
@@ -53,7 +45,7 @@ GroupId::GroupId(
     groupingKeyMappings_.emplace_back(std::move(mappings));
   }
 
-  const auto& aggregationInputs = groupIdNode->aggregationInputs();
+  const auto& aggregationInputs = groupIdNode.aggregationInputs();
   aggregationInputs_.reserve(aggregationInputs.size());
   for (auto i = 0; i < aggregationInputs.size(); ++i) {
     const auto& input = aggregationInputs[i];
@@ -61,30 +53,15 @@ GroupId::GroupId(
   }
 }
 
-bool GroupId::needsInput() const {
-  return !noMoreInput_ && input_ == nullptr;
-}
-
-void GroupId::addInput(RowVectorPtr input) {
-  // Load Lazy vectors.
-  for (auto& child : input->children()) {
-    child->loadedVector();
-  }
-
-  input_ = std::move(input);
-}
-
-RowVectorPtr GroupId::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
-
-  // Make a copy of input for the grouping set at 'groupingSetIndex_'.
-  auto numInput = input_->size();
+RowVectorPtr GroupIdProjection::project(
+    const RowVectorPtr& input,
+    int32_t groupingSetIndex,
+    memory::MemoryPool* pool) const {
+  auto numInput = input->size();
 
   std::vector<VectorPtr> outputColumns(outputType_->size());
 
-  const auto& mapping = groupingKeyMappings_[groupingSetIndex_];
+  const auto& mapping = groupingKeyMappings_[groupingSetIndex];
   auto numGroupingKeys = mapping.size();
 
   // Fill in grouping keys.
@@ -92,29 +69,65 @@ RowVectorPtr GroupId::getOutput() {
     if (mapping[i] == kMissingGroupingKey) {
       // Add null column.
       outputColumns[i] = BaseVector::createNullConstant(
-          outputType_->childAt(i), numInput, pool());
+          outputType_->childAt(i), numInput, pool);
     } else {
-      outputColumns[i] = input_->childAt(mapping[i]);
+      outputColumns[i] = input->childAt(mapping[i]);
     }
   }
 
   // Fill in aggregation inputs.
   for (auto i = 0; i < aggregationInputs_.size(); ++i) {
-    outputColumns[numGroupingKeys + i] = input_->childAt(aggregationInputs_[i]);
+    outputColumns[numGroupingKeys + i] = input->childAt(aggregationInputs_[i]);
   }
 
   // Add groupId column.
   outputColumns[outputType_->size() - 1] =
-      BaseVector::createConstant((int64_t)groupingSetIndex_, numInput, pool());
+      BaseVector::createConstant((int64_t)groupingSetIndex, numInput, pool);
+
+  return std::make_shared<RowVector>(
+      pool, outputType_, nullptr, numInput, std::move(outputColumns));
+}
+
+GroupId::GroupId(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::GroupIdNode>& groupIdNode)
+    : Operator(
+          driverCtx,
+          groupIdNode->outputType(),
+          operatorId,
+          groupIdNode->id(),
+          "GroupId"),
+      projection_(*groupIdNode) {}
+
+bool GroupId::needsInput() const {
+  return !noMoreInput_ && input_ == nullptr;
+}
+
+void GroupId::addInput(RowVectorPtr input) {
+  // Load Lazy vectors.
+  for (auto& child : input->children()) {
+    child->loadedVector();
+  }
+
+  input_ = std::move(input);
+}
+
+RowVectorPtr GroupId::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  // Wrap input for the grouping set at 'groupingSetIndex_'.
+  auto output = projection_.project(input_, groupingSetIndex_, pool());
 
   ++groupingSetIndex_;
-  if (groupingSetIndex_ == groupingKeyMappings_.size()) {
+  if (groupingSetIndex_ == projection_.numGroupingSets()) {
     groupingSetIndex_ = 0;
     input_ = nullptr;
   }
 
-  return std::make_shared<RowVector>(
-      pool(), outputType_, nullptr, numInput, std::move(outputColumns));
+  return output;
 }
 
 } // namespace facebook::velox::exec
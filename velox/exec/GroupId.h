@@ -19,6 +19,46 @@
 
 namespace facebook::velox::exec {
 
+/// Projects the input of a GroupIdNode to its output for one grouping set at a
+/// time. The grouping keys in the set and the aggregation inputs are the input
+/// vectors themselves, the grouping keys not in the set are null constants and
+/// the group id is a constant. Nothing is copied. Used by GroupId and by
+/// HashAggregation when it aggregates the grouping sets of a GroupIdNode
+/// directly.
+class GroupIdProjection {
+ public:
+  explicit GroupIdProjection(const core::GroupIdNode& groupIdNode);
+
+  int32_t numGroupingSets() const {
+    return groupingKeyMappings_.size();
+  }
+
+  /// Returns the output for 'input' and the grouping set at
+  /// 'groupingSetIndex'.
+  RowVectorPtr project(
+      const RowVectorPtr& input,
+      int32_t groupingSetIndex,
+      memory::MemoryPool* pool) const;
+
+ private:
+  static constexpr column_index_t kMissingGroupingKey =
+      std::numeric_limits<column_index_t>::max();
+
+  const RowTypePtr outputType_;
+
+  /// A grouping set contains a subset of all the grouping keys. This list
+  /// contains one entry per grouping set and identifies the grouping keys that
+  /// are part of the set as indices of the input columns. The position in the
+  /// list identifies the grouping key column in the output. Positions with
+  /// kMissingGroupingKey correspond to grouping keys which are not included in
+  /// the set.
+  std::vector<std::vector<column_index_t>> groupingKeyMappings_;
+
+  /// A list of input column indices corresponding to aggregation inputs. The
+  /// position in the list identifies the column in the output.
+  std::vector<column_index_t> aggregationInputs_;
+};
+
 class GroupId : public Operator {
  public:
   GroupId(
@@ -41,28 +81,14 @@ class GroupId : public Operator {
   }
 
  private:
-  static constexpr column_index_t kMissingGroupingKey =
-      std::numeric_limits<column_index_t>::max();
-
   bool finished_{false};
 
-  /// A grouping set contains a subset of all the grouping keys. This list
-  /// contains one entry per grouping set and identifies the grouping keys that
-  /// are part of the set as indices of the input columns. The position in the
-  /// list identifies the grouping key column in the output. Positions with
-  /// kMissingGroupingKey correspond to grouping keys which are not included in
-  /// the set.
-  std::vector<std::vector<column_index_t>> groupingKeyMappings_;
-
-  /// A list of input column indices corresponding to aggregation inputs. The
-  /// position in the list identifies the column in the output.
-  std::vector<column_index_t> aggregationInputs_;
+  const GroupIdProjection projection_;
 
   /// 'getOutput()' returns 'input_' for one grouping set at a time.
   /// 'groupingSetIndex_' contains the index of the grouping set to output in
   /// the next 'getOutput' call. This index is used to generate groupId column
-  /// and lookup the input-to-output column mappings in the
-  /// groupingKeyMappings_.
+  /// and lookup the input-to-output column mappings in 'projection_'.
   int32_t groupingSetIndex_{0};
 };
 } // namespace facebook::velox::exec
@@ -134,6 +134,20 @@ void GroupingSet::addInput(const RowVectorPtr& input, bool mayPushdown) {
         break;
       }
     }
+    // If the first group of 'input' does not continue the last group of the
+    // previous input, the groups in the table are complete. Flush them before
+    // adding any row, so that the table holds at most the groups of one batch
+    // also when the pre-grouped keys change between batches. Distinct
+    // aggregations produce their new groups right after each input instead.
+    const bool startsNewGroup = !aggregates_.empty() && table_ &&
+        table_->numDistinct() > 0 && !equalsLastPreGroupedKeys(input);
+    savePreGroupedKeys(input);
+    if (startsNewGroup) {
+      remainingInput_ = input;
+      firstRemainingRow_ = 0;
+      remainingMayPushdown_ = mayPushdown;
+      return;
+    }
   }
 
   activeRows_.resize(numRows);
@@ -142,6 +156,31 @@ void GroupingSet::addInput(const RowVectorPtr& input, bool mayPushdown) {
   addInputForActiveRows(input, mayPushdown);
 }
 
+bool GroupingSet::equalsLastPreGroupedKeys(const RowVectorPtr& input) const {
+  if (lastPreGroupedKeys_.empty()) {
+    return false;
+  }
+  for (auto i = 0; i < preGroupedKeyChannels_.size(); ++i) {
+    const auto& child = input->childAt(preGroupedKeyChannels_[i]);
+    if (!child->equalValueAt(lastPreGroupedKeys_[i].get(), 0, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GroupingSet::savePreGroupedKeys(const RowVectorPtr& input) {
+  const auto lastRow = input->size() - 1;
+  for (auto i = 0; i < preGroupedKeyChannels_.size(); ++i) {
+    const auto& child = input->childAt(preGroupedKeyChannels_[i]);
+    if (lastPreGroupedKeys_.size() <= i) {
+      lastPreGroupedKeys_.push_back(
+          BaseVector::create(child->type(), 1, &pool_));
+    }
+    lastPreGroupedKeys_[i]->copy(child.get(), 0, lastRow, 1);
+  }
+}
+
 void GroupingSet::noMoreInput() {
   noMoreInput_ = true;
 
@@ -190,6 +229,7 @@ void GroupingSet::addInputForActiveRows(
 
   if (rehash) {
     if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+      flushColumnarAccumulators();
       table_->decideHashMode(input->size());
     }
     addInputForActiveRows(input, mayPushdown);
@@ -208,6 +248,10 @@ void GroupingSet::addInputForActiveRows(
 
   table_->groupProbe(*lookup_);
   masks_.addInput(input, activeRows_);
+  // In kArray mode the hashes are the dense array indices of the groups.
+  const bool mayUseColumnar = isRawInput_ &&
+      table_->hashMode() == BaseHashTable::HashMode::kArray &&
+      table_->capacity() <= kMaxColumnarCapacity;
 
   for (auto i = 0; i < aggregates_.size(); ++i) {
     if (!lookup_->newGroups.empty()) {
@@ -227,7 +271,12 @@ void GroupingSet::addInputForActiveRows(
     // this.
     const bool canPushdown = (&rows == &activeRows_) && mayPushdown &&
         mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
-    if (isRawInput_) {
+    if (mayUseColumnar && !canPushdown &&
+        aggregates_[i]->supportsColumnarInput()) {
+      aggregates_[i]->addRawInputColumnar(
+          lookup_->hashes.data(), table_->capacity(), rows, tempVectors_);
+      hasColumnarUpdates_ = true;
+    } else if (isRawInput_) {
       aggregates_[i]->addRawInput(
           lookup_->hits.data(), rows, tempVectors_, canPushdown);
     } else {
@@ -238,6 +287,17 @@ void GroupingSet::addInputForActiveRows(
   tempVectors_.clear();
 }
 
+void GroupingSet::flushColumnarAccumulators() {
+  if (!hasColumnarUpdates_) {
+    return;
+  }
+  hasColumnarUpdates_ = false;
+  auto groups = table_->arrayTable();
+  for (auto& aggregate : aggregates_) {
+    aggregate->flushColumnar(groups);
+  }
+}
+
 void GroupingSet::addRemainingInput() {
   activeRows_.resize(remainingInput_->size());
   activeRows_.clearAll();
@@ -406,6 +466,7 @@ bool GroupingSet::getOutput(
   if (isGlobal_) {
     return getGlobalAggregationOutput(batchSize, isPartial_, iterator, result);
   }
+  flushColumnarAccumulators();
   if (spiller_) {
     return getOutputWithSpill(batchSize, result);
   }
@@ -423,13 +484,35 @@ bool GroupingSet::getOutput(
     }
     return false;
   }
-  extractGroups(folly::Range<char**>(groups, numGroups), result);
+  extractGroups(folly::Range<char**>(groups, numGroups), result, isPartial_);
+  return true;
+}
+
+bool GroupingSet::getIntermediateOutput(
+    int32_t batchSize,
+    RowContainerIterator& iterator,
+    const RowVectorPtr& result) {
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK_NULL(spiller_);
+  flushColumnarAccumulators();
+  std::vector<char*> groups(batchSize);
+  const int32_t numGroups =
+      table_ ? table_->rows()->listRows(&iterator, batchSize, groups.data())
+             : 0;
+  if (numGroups == 0) {
+    if (table_) {
+      table_->clear();
+    }
+    return false;
+  }
+  extractGroups(folly::Range<char**>(groups.data(), numGroups), result, true);
   return true;
 }
 
 void GroupingSet::extractGroups(
     folly::Range<char**> groups,
-    const RowVectorPtr& result) {
+    const RowVectorPtr& result,
+    bool isPartial) {
   result->resize(groups.size());
   if (groups.empty()) {
     return;
@@ -442,7 +525,7 @@ void GroupingSet::extractGroups(
   }
   for (int32_t i = 0; i < aggregates_.size(); ++i) {
     auto& aggregateVector = result->childAt(i + totalKeys);
-    if (isPartial_) {
+    if (isPartial) {
       aggregates_[i]->extractAccumulators(
           groups.data(), groups.size(), &aggregateVector);
     } else {
@@ -454,10 +537,75 @@ void GroupingSet::extractGroups(
 
 void GroupingSet::resetPartial() {
   if (table_ != nullptr) {
+    flushColumnarAccumulators();
     table_->clear();
   }
 }
 
+void GroupingSet::toIntermediate(
+    const RowVectorPtr& input,
+    const RowVectorPtr& result) {
+  VELOX_CHECK(isPartial_);
+  VELOX_CHECK(isRawInput_);
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK_NOT_NULL(table_);
+  VELOX_CHECK_EQ(numRows(), 0, "Hash table must be flushed first");
+
+  const auto numRows = input->size();
+  result->resize(numRows);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    result->childAt(i) =
+        BaseVector::loadedVectorShared(input->childAt(keyChannels_[i]));
+  }
+
+  if (intermediateRows_ == nullptr) {
+    // NOTE: this resets the accumulator offsets of 'aggregates_' which is safe
+    // as the rows of 'table_' are not used any more.
+    std::vector<TypePtr> keyTypes;
+    for (auto& hasher : table_->hashers()) {
+      keyTypes.push_back(hasher->type());
+    }
+    intermediateRows_ = std::make_unique<RowContainer>(
+        keyTypes,
+        !ignoreNullKeys_,
+        aggregates_,
+        std::vector<TypePtr>(),
+        false,
+        false,
+        false,
+        false,
+        mappedMemory_,
+        ContainerRowSerde::instance());
+  }
+  intermediateGroups_.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    intermediateGroups_[i] = intermediateRows_->newRow();
+  }
+  intermediateRowNumbers_.resize(numRows);
+  std::iota(intermediateRowNumbers_.begin(), intermediateRowNumbers_.end(), 0);
+
+  activeRows_.resize(numRows);
+  activeRows_.setAll();
+  masks_.addInput(input, activeRows_);
+  const auto numKeys = keyChannels_.size();
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    auto& aggregate = aggregates_[i];
+    aggregate->initializeNewGroups(
+        intermediateGroups_.data(), intermediateRowNumbers_);
+    const auto& rows = getSelectivityVector(i);
+    if (rows.hasSelections()) {
+      populateTempVectors(i, input);
+      aggregate->addRawInput(
+          intermediateGroups_.data(), rows, tempVectors_, false);
+    }
+    aggregate->extractAccumulators(
+        intermediateGroups_.data(), numRows, &result->childAt(i + numKeys));
+  }
+  tempVectors_.clear();
+  intermediateRows_->eraseRows(
+      folly::Range<char**>(intermediateGroups_.data(), numRows));
+}
+
 uint64_t GroupingSet::allocatedBytes() const {
   if (table_) {
     return table_->allocatedBytes();
@@ -552,11 +700,15 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
 }
 
 void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
+  flushColumnarAccumulators();
   if (!spiller_) {
     auto rows = table_->rows();
     auto types = rows->keyTypes();
-    types.insert(
-        types.end(), intermediateTypes_.begin(), intermediateTypes_.end());
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      types.push_back(
+          aggregates_[i]->supportsSpillState() ? VARBINARY()
+                                               : intermediateTypes_[i]);
+    }
     std::vector<std::string> names;
     for (auto i = 0; i < types.size(); ++i) {
       names.push_back(fmt::format("s{}", i));
@@ -576,7 +728,8 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->maxFileSize,
         spillConfig_->minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->compressionType);
   }
   spiller_->spill(targetRows, targetBytes);
 }
@@ -615,7 +768,8 @@ bool GroupingSet::getOutputWithSpill(
     extractGroups(
         folly::Range<char**>(
             nonSpilledRows_.value().data() + nonSpilledIndex_, numGroups),
-        result);
+        result,
+        isPartial_);
     nonSpilledIndex_ += numGroups;
     return true;
   }
@@ -675,7 +829,8 @@ void GroupingSet::extractSpillResult(const RowVectorPtr& result) {
     mergeRows_->listRows(
         &iter, rows.size(), RowContainer::kUnlimited, rows.data());
   }
-  extractGroups(folly::Range<char**>(rows.data(), rows.size()), result);
+  extractGroups(
+      folly::Range<char**>(rows.data(), rows.size()), result, isPartial_);
   mergeRows_->clear();
 }
 
@@ -688,8 +843,13 @@ void GroupingSet::updateRow(SpillMergeStream& input, char* FOLLY_NONNULL row) {
   mergeSelection_.updateBounds();
   for (auto i = 0; i < aggregates_.size(); ++i) {
     mergeArgs_[0] = input.current().childAt(i + keyChannels_.size());
-    aggregates_[i]->addSingleGroupIntermediateResults(
-        row, mergeSelection_, mergeArgs_, false);
+    if (aggregates_[i]->supportsSpillState()) {
+      aggregates_[i]->addSingleGroupSpillState(
+          row, mergeSelection_, mergeArgs_[0]);
+    } else {
+      aggregates_[i]->addSingleGroupIntermediateResults(
+          row, mergeSelection_, mergeArgs_, false);
+    }
   }
   mergeSelection_.setValid(input.currentIndex(), false);
 }
@@ -62,10 +62,25 @@ class GroupingSet {
       RowContainerIterator& iterator,
       RowVectorPtr& result);
 
+  /// Extracts up to 'batchSize' groups into 'result' with the accumulators in
+  /// the intermediate format. Returns false after all groups have been
+  /// extracted. Used to merge the groups of several grouping sets, which is not
+  /// supported with spilling.
+  bool getIntermediateOutput(
+      int32_t batchSize,
+      RowContainerIterator& iterator,
+      const RowVectorPtr& result);
+
   uint64_t allocatedBytes() const;
 
   void resetPartial();
 
+  /// Converts each row of 'input' to a row of intermediate results in 'result'
+  /// without grouping. The grouping keys are passed through as is. Used by a
+  /// partial aggregation which has stopped grouping because of poor reduction.
+  /// The hash table must be empty, i.e. flushed by resetPartial().
+  void toIntermediate(const RowVectorPtr& input, const RowVectorPtr& result);
+
   const HashLookup& hashLookup() const;
 
   /// Spills content until under 'targetRows' and under 'targetBytes'
@@ -92,6 +107,14 @@ class GroupingSet {
 
   void addRemainingInput();
 
+  // Returns true if the first row of 'input' has the pre-grouped keys saved
+  // by savePreGroupedKeys().
+  bool equalsLastPreGroupedKeys(const RowVectorPtr& input) const;
+
+  // Saves the pre-grouped keys of the last row of 'input' into
+  // 'lastPreGroupedKeys_'.
+  void savePreGroupedKeys(const RowVectorPtr& input);
+
   void initializeGlobalAggregation();
 
   void destroyGlobalAggregations();
@@ -106,6 +129,11 @@ class GroupingSet {
 
   void createHashTable();
 
+  // Applies the updates kept by the aggregates in columnar accumulators to
+  // the group rows. Must be called before the group rows are read, spilled
+  // or cleared and before the hash mode of 'table_' changes.
+  void flushColumnarAccumulators();
+
   void populateTempVectors(int32_t aggregateIndex, const RowVectorPtr& input);
 
   // If the given aggregation has mask, the method returns reference to the
@@ -119,9 +147,12 @@ class GroupingSet {
   void ensureInputFits(const RowVectorPtr& input);
 
   // Copies the grouping keys and aggregates for 'groups' into 'result' If
-  // partial output, extracts the intermediate type for aggregates, final result
+  // 'isPartial', extracts the intermediate type for aggregates, final result
   // otherwise.
-  void extractGroups(folly::Range<char**> groups, const RowVectorPtr& result);
+  void extractGroups(
+      folly::Range<char**> groups,
+      const RowVectorPtr& result,
+      bool isPartial);
 
   // Produces output in if spilling has occurred. First produces data
   // from non-spilled partitions, then merges spill runs and unspilled data
@@ -196,6 +227,15 @@ class GroupingSet {
   // Place for the arguments of the aggregate being updated.
   std::vector<VectorPtr> tempVectors_;
   std::unique_ptr<BaseHashTable> table_;
+
+  // Raw input is added to the aggregates that support it with
+  // addRawInputColumnar() while 'table_' is in kArray mode with at most this
+  // many entries. This bounds the size of the columnar accumulators.
+  static constexpr uint64_t kMaxColumnarCapacity = 64 << 10;
+
+  // True if some aggregate has columnar updates that are not yet flushed to
+  // the group rows.
+  bool hasColumnarUpdates_{false};
   std::unique_ptr<HashLookup> lookup_;
   SelectivityVector activeRows_;
 
@@ -215,6 +255,10 @@ class GroupingSet {
   /// First row in remainingInput_ that needs to be processed.
   vector_size_t firstRemainingRow_;
 
+  // Single row vectors with the pre-grouped keys of the last row of the
+  // previous input, in the order of 'preGroupedKeyChannels_'.
+  std::vector<VectorPtr> lastPreGroupedKeys_;
+
   // The value of mayPushdown flag specified in addInput() for the
   // 'remainingInput_'.
   bool remainingMayPushdown_;
@@ -258,6 +302,12 @@ class GroupingSet {
   // Counts input batches and triggers spilling if folly hash of this % 100 <=
   // 'testSpillPct_';.
   uint64_t spillTestCounter_{0};
+
+  // Accumulators for the rows converted by toIntermediate(). Erased after each
+  // batch.
+  std::unique_ptr<RowContainer> intermediateRows_;
+  std::vector<char*> intermediateGroups_;
+  std::vector<vector_size_t> intermediateRowNumbers_;
 };
 
 } // namespace facebook::velox::exec
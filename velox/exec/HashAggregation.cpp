@@ -15,8 +15,12 @@
  */
 #include "velox/exec/HashAggregation.h"
 #include <optional>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/DistinctAggregate.h"
+#include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/SortedAggregate.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -24,7 +28,8 @@ namespace facebook::velox::exec {
 HashAggregation::HashAggregation(
     int32_t operatorId,
     DriverCtx* driverCtx,
-    const std::shared_ptr<const core::AggregationNode>& aggregationNode)
+    const std::shared_ptr<const core::AggregationNode>& aggregationNode,
+    const std::shared_ptr<const core::GroupIdNode>& groupIdNode)
     : Operator(
           driverCtx,
           aggregationNode->outputType(),
@@ -42,19 +47,75 @@ HashAggregation::HashAggregation(
           driverCtx->queryConfig().partialAggregationGoodPct()),
       maxExtendedPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxExtendedPartialAggregationMemoryUsage()),
+      mayAbandonPartialAggregation_(
+          aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+          !isDistinct_ && !isGlobal_ &&
+          aggregationNode->preGroupedKeys().empty() &&
+          !aggregationNode->ignoreNullKeys() && groupIdNode == nullptr),
+      abandonPartialAggregationMinRows_(
+          driverCtx->queryConfig().abandonPartialAggregationMinRows()),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
       spillConfig_(
           isSpillAllowed(aggregationNode)
               ? operatorCtx_->makeSpillConfig(Spiller::Type::kAggregate)
               : std::nullopt),
+      aggregationNode_(aggregationNode),
+      parallelMerge_(
+          driverCtx->queryConfig().aggregationParallelMergeEnabled() &&
+          !isPartialOutput_ && !isDistinct_ && !isGlobal_ &&
+          aggregationNode->preGroupedKeys().empty() &&
+          !spillConfig_.has_value() && groupIdNode == nullptr),
       maxPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxPartialAggregationMemoryUsage()) {
   VELOX_CHECK_NOT_NULL(memoryTracker_, "Memory usage tracker is not set");
-  auto inputType = aggregationNode->sources()[0]->outputType();
+  if (groupIdNode != nullptr) {
+    VELOX_CHECK(
+        canFuseGroupId(
+            *groupIdNode, *aggregationNode, driverCtx->queryConfig()));
+    VELOX_CHECK(!spillConfig_.has_value());
+    groupIdProjection_.emplace(*groupIdNode);
+    for (auto i = 0; i < groupIdProjection_->numGroupingSets(); ++i) {
+      groupingSets_.push_back(createGroupingSet());
+    }
+  } else {
+    groupingSet_ = createGroupingSet();
+  }
+}
+
+// static
+bool HashAggregation::canFuseGroupId(
+    const core::GroupIdNode& groupIdNode,
+    const core::AggregationNode& aggregationNode,
+    const core::QueryConfig& queryConfig) {
+  if (!isRawInput(aggregationNode.step()) ||
+      aggregationNode.aggregates().empty() ||
+      !aggregationNode.preGroupedKeys().empty() ||
+      aggregationNode.sources()[0].get() != &groupIdNode) {
+    return false;
+  }
+  // The grouping sets have a GroupingSet each and are not spilled.
+  if (queryConfig.spillEnabled() && queryConfig.aggregationSpillEnabled()) {
+    return false;
+  }
+  // Without the group id as grouping key, the groups of different grouping
+  // sets with the same keys would be combined.
+  const auto& groupIdName = groupIdNode.outputType()->names().back();
+  for (const auto& key : aggregationNode.groupingKeys()) {
+    if (key->name() == groupIdName) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::unique_ptr<GroupingSet> HashAggregation::createGroupingSet() {
+  auto inputType = aggregationNode_->sources()[0]->outputType();
 
-  auto numHashers = aggregationNode->groupingKeys().size();
+  auto numHashers = aggregationNode_->groupingKeys().size();
   std::vector<std::unique_ptr<VectorHasher>> hashers;
   hashers.reserve(numHashers);
-  for (const auto& key : aggregationNode->groupingKeys()) {
+  for (const auto& key : aggregationNode_->groupingKeys()) {
     auto channel = exprToChannel(key.get(), inputType);
     VELOX_CHECK_NE(
         channel,
@@ -64,23 +125,23 @@ HashAggregation::HashAggregation(
   }
 
   std::vector<column_index_t> preGroupedChannels;
-  preGroupedChannels.reserve(aggregationNode->preGroupedKeys().size());
-  for (const auto& key : aggregationNode->preGroupedKeys()) {
+  preGroupedChannels.reserve(aggregationNode_->preGroupedKeys().size());
+  for (const auto& key : aggregationNode_->preGroupedKeys()) {
     auto channel = exprToChannel(key.get(), inputType);
     preGroupedChannels.push_back(channel);
   }
 
-  auto numAggregates = aggregationNode->aggregates().size();
+  auto numAggregates = aggregationNode_->aggregates().size();
   std::vector<std::unique_ptr<Aggregate>> aggregates;
   aggregates.reserve(numAggregates);
   std::vector<std::optional<column_index_t>> aggrMaskChannels;
   aggrMaskChannels.reserve(numAggregates);
-  auto numMasks = aggregationNode->aggregateMasks().size();
+  auto numMasks = aggregationNode_->aggregateMasks().size();
   std::vector<std::vector<column_index_t>> args;
   std::vector<std::vector<VectorPtr>> constantLists;
   std::vector<TypePtr> intermediateTypes;
   for (auto i = 0; i < numAggregates; i++) {
-    const auto& aggregate = aggregationNode->aggregates()[i];
+    const auto& aggregate = aggregationNode_->aggregates()[i];
 
     std::vector<column_index_t> channels;
     std::vector<VectorPtr> constants;
@@ -101,7 +162,23 @@ HashAggregation::HashAggregation(
         constants.push_back(nullptr);
       }
     }
-    if (isRawInput(aggregationNode->step())) {
+    // The sorting keys of a sorted aggregate follow its arguments.
+    const bool isSortedAggregate = aggregationNode_->isSortedAggregate(i);
+    std::vector<TypePtr> inputTypes = argTypes;
+    if (isSortedAggregate) {
+      for (const auto& key : aggregationNode_->aggregateSortingKeys()[i]) {
+        inputTypes.push_back(key->type());
+        channels.push_back(exprToChannel(key.get(), inputType));
+        constants.push_back(nullptr);
+      }
+    }
+    const bool isDistinctAggregate = aggregationNode_->isDistinctAggregate(i);
+    if (isDistinctAggregate) {
+      intermediateTypes.push_back(
+          distinctAggregateIntermediateType(argTypes[0]));
+    } else if (isSortedAggregate) {
+      intermediateTypes.push_back(sortedAggregateIntermediateType(inputTypes));
+    } else if (isRawInput(aggregationNode_->step())) {
       intermediateTypes.push_back(
           Aggregate::intermediateType(aggregate->name(), argTypes));
     } else {
@@ -115,7 +192,7 @@ HashAggregation::HashAggregation(
     // Setup aggregation mask: convert the Variable Reference name to the
     // channel (projection) index, if there is a mask.
     if (i < numMasks) {
-      const auto& aggrMask = aggregationNode->aggregateMasks()[i];
+      const auto& aggrMask = aggregationNode_->aggregateMasks()[i];
       if (aggrMask == nullptr) {
         aggrMaskChannels.emplace_back(std::nullopt);
       } else {
@@ -128,7 +205,16 @@ HashAggregation::HashAggregation(
 
     const auto& resultType = outputType_->childAt(numHashers + i);
     aggregates.push_back(Aggregate::create(
-        aggregate->name(), aggregationNode->step(), argTypes, resultType));
+        aggregate->name(), aggregationNode_->step(), argTypes, resultType));
+    if (isDistinctAggregate) {
+      aggregates.back() =
+          makeDistinctAggregate(std::move(aggregates.back()), argTypes[0]);
+    } else if (isSortedAggregate) {
+      aggregates.back() = makeSortedAggregate(
+          std::move(aggregates.back()),
+          inputTypes,
+          aggregationNode_->aggregateSortingOrders()[i]);
+    }
     args.push_back(channels);
     constantLists.push_back(constants);
   }
@@ -142,7 +228,7 @@ HashAggregation::HashAggregation(
         "Unexpected result type for an aggregation: {}, expected {}, step {}",
         aggResultType->toString(),
         expectedType->toString(),
-        core::AggregationNode::stepName(aggregationNode->step()));
+        core::AggregationNode::stepName(aggregationNode_->step()));
   }
 
   if (isDistinct_) {
@@ -151,7 +237,18 @@ HashAggregation::HashAggregation(
     }
   }
 
-  groupingSet_ = std::make_unique<GroupingSet>(
+  if (parallelMerge_) {
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < numHashers; ++i) {
+      types.push_back(outputType_->childAt(i));
+    }
+    types.insert(
+        types.end(), intermediateTypes.begin(), intermediateTypes.end());
+    intermediateType_ = ROW(
+        std::vector<std::string>(outputType_->names()), std::move(types));
+  }
+
+  return std::make_unique<GroupingSet>(
       std::move(hashers),
       std::move(preGroupedChannels),
       std::move(aggregates),
@@ -159,9 +256,9 @@ HashAggregation::HashAggregation(
       std::move(args),
       std::move(constantLists),
       std::move(intermediateTypes),
-      aggregationNode->ignoreNullKeys(),
+      aggregationNode_->ignoreNullKeys(),
       isPartialOutput_,
-      isRawInput(aggregationNode->step()),
+      isRawInput(aggregationNode_->step()),
       spillConfig_.has_value() ? &spillConfig_.value() : nullptr,
       operatorCtx_.get());
 }
@@ -172,13 +269,23 @@ bool HashAggregation::isSpillAllowed(
 }
 
 void HashAggregation::addInput(RowVectorPtr input) {
-  if (!pushdownChecked_) {
-    mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
-    pushdownChecked_ = true;
+  if (abandonedPartialAggregation_) {
+    // Converted to intermediate results in getOutput().
+    input_ = input;
+    return;
+  }
+  if (groupIdProjection_) {
+    addGroupIdInput(input);
+  } else {
+    if (!pushdownChecked_) {
+      mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
+      pushdownChecked_ = true;
+    }
+    groupingSet_->addInput(input, mayPushdown_);
   }
-  groupingSet_->addInput(input, mayPushdown_);
   numInputRows_ += input->size();
-  {
+  setMemoryBreakdown("groupingSet", allocatedBytes());
+  if (groupingSet_) {
     auto spillStats = groupingSet_->spilledStats();
     auto lockedStats = stats_.wlock();
     lockedStats->spilledBytes = spillStats.spilledBytes;
@@ -191,8 +298,15 @@ void HashAggregation::addInput(RowVectorPtr input) {
   // aggregation as the final aggregator will handle it the same way as the
   // partial aggregator. Hence, we have to use more memory anyway.
   if (isPartialOutput_ && !isGlobal_ &&
-      groupingSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_) {
+      allocatedBytes() > maxPartialAggregationMemoryUsage_) {
+    partialFull_ = true;
+  }
+
+  if (shouldAbandonPartialAggregation()) {
+    // Flush the groups so far. The following inputs bypass the hash table.
+    abandonedPartialAggregation_ = true;
     partialFull_ = true;
+    addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
   }
 
   if (isDistinct_) {
@@ -205,15 +319,240 @@ void HashAggregation::addInput(RowVectorPtr input) {
   }
 }
 
-void HashAggregation::prepareOutput(vector_size_t size) {
-  if (output_) {
-    VectorPtr output = std::move(output_);
-    BaseVector::prepareForReuse(output, size);
-    output_ = std::static_pointer_cast<RowVector>(output);
+void HashAggregation::addGroupIdInput(const RowVectorPtr& input) {
+  // Load Lazy vectors. These are shared by the inputs of all grouping sets. No
+  // aggregation is pushed down into them.
+  for (auto& child : input->children()) {
+    child->loadedVector();
+  }
+  for (auto i = 0; i < groupingSets_.size(); ++i) {
+    groupingSets_[i]->addInput(
+        groupIdProjection_->project(input, i, pool()), false);
+  }
+}
+
+uint64_t HashAggregation::allocatedBytes() const {
+  if (groupingSet_) {
+    return groupingSet_->allocatedBytes();
+  }
+  uint64_t bytes = 0;
+  for (const auto& groupingSet : groupingSets_) {
+    bytes += groupingSet->allocatedBytes();
+  }
+  return bytes;
+}
+
+void HashAggregation::noMoreInput() {
+  if (groupingSet_) {
+    groupingSet_->noMoreInput();
+  }
+  for (auto& groupingSet : groupingSets_) {
+    groupingSet->noMoreInput();
+  }
+  Operator::noMoreInput();
+  if (parallelMerge_) {
+    startParallelMerge();
+  }
+}
+
+void HashAggregation::startParallelMerge() {
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last Driver to finish input partitions the groups of all Drivers. At
+  // this point all Drivers are continued and each merges its partition.
+  // allPeersFinished is true only for the last Driver of the pipeline.
+  mergePending_ = true;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+
+  if (peers.empty()) {
+    // A single Driver has all the groups.
+    mergePending_ = false;
   } else {
-    output_ = std::static_pointer_cast<RowVector>(
-        BaseVector::create(outputType_, size, pool()));
+    std::vector<HashAggregation*> aggregations{this};
+    for (auto& peer : peers) {
+      auto* aggregation =
+          dynamic_cast<HashAggregation*>(peer->findOperator(planNodeId()));
+      VELOX_CHECK_NOT_NULL(aggregation);
+      aggregations.push_back(aggregation);
+    }
+    partitionAllGroups(aggregations);
+  }
+
+  // Realize the promises so that the other Drivers (which were not
+  // the last to finish) can continue from the barrier and merge.
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void HashAggregation::partitionAllGroups(
+    const std::vector<HashAggregation*>& aggregations) {
+  const int32_t numPartitions = aggregations.size();
+  auto* executor = operatorCtx_->task()->queryCtx()->executor();
+  std::vector<std::shared_ptr<AsyncSource<GroupPartitions>>> steps;
+  for (auto* aggregation : aggregations) {
+    steps.push_back(std::make_shared<AsyncSource<GroupPartitions>>(
+        [aggregation, numPartitions]() {
+          return std::make_unique<GroupPartitions>(
+              aggregation->partitionGroups(numPartitions));
+        }));
+    if (executor != nullptr) {
+      executor->add([step = steps.back()]() { step->prepare(); });
+    }
+  }
+
+  // All steps must be synced also in case of error because they reference the
+  // grouping sets of the peers.
+  std::vector<std::unique_ptr<GroupPartitions>> allPartitions;
+  std::exception_ptr error;
+  for (auto& step : steps) {
+    try {
+      allPartitions.push_back(step->move());
+      VELOX_CHECK_NOT_NULL(allPartitions.back());
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  for (auto i = 0; i < numPartitions; ++i) {
+    auto& mergeInputs = aggregations[i]->mergeInputs_;
+    for (auto& partitions : allPartitions) {
+      auto& partition = (*partitions)[i];
+      mergeInputs.insert(
+          mergeInputs.end(),
+          std::make_move_iterator(partition.begin()),
+          std::make_move_iterator(partition.end()));
+    }
+  }
+}
+
+HashAggregation::GroupPartitions HashAggregation::partitionGroups(
+    int32_t numPartitions) {
+  const auto numKeys = aggregationNode_->groupingKeys().size();
+  std::vector<column_index_t> keyChannels(numKeys);
+  std::iota(keyChannels.begin(), keyChannels.end(), 0);
+  HashPartitionFunction partitionFunction(
+      numPartitions, intermediateType_, keyChannels);
+
+  GroupPartitions partitions(numPartitions);
+  std::vector<uint32_t> partitionIds;
+  std::vector<vector_size_t> partitionSizes(numPartitions);
+  std::vector<BufferPtr> indices(numPartitions);
+  std::vector<vector_size_t*> rawIndices(numPartitions);
+  RowContainerIterator iterator;
+  for (;;) {
+    auto groups = std::static_pointer_cast<RowVector>(
+        BaseVector::create(intermediateType_, outputBatchSize_, pool()));
+    if (!groupingSet_->getIntermediateOutput(
+            outputBatchSize_, iterator, groups)) {
+      break;
+    }
+    const auto numGroups = groups->size();
+    partitionFunction.partition(*groups, partitionIds);
+    std::fill(partitionSizes.begin(), partitionSizes.end(), 0);
+    for (auto i = 0; i < numPartitions; ++i) {
+      indices[i] = allocateIndices(numGroups, pool());
+      rawIndices[i] = indices[i]->asMutable<vector_size_t>();
+    }
+    for (auto row = 0; row < numGroups; ++row) {
+      const auto partition = partitionIds[row];
+      rawIndices[partition][partitionSizes[partition]++] = row;
+    }
+    for (auto i = 0; i < numPartitions; ++i) {
+      if (partitionSizes[i] == 0) {
+        continue;
+      }
+      indices[i]->setSize(partitionSizes[i] * sizeof(vector_size_t));
+      partitions[i].push_back(
+          wrap(partitionSizes[i], std::move(indices[i]), groups));
+    }
+  }
+  return partitions;
+}
+
+void HashAggregation::mergePartition() {
+  const auto numKeys = aggregationNode_->groupingKeys().size();
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  for (auto i = 0; i < numKeys; ++i) {
+    hashers.push_back(VectorHasher::create(intermediateType_->childAt(i), i));
+  }
+
+  const auto numAggregates = aggregationNode_->aggregates().size();
+  std::vector<std::unique_ptr<Aggregate>> aggregates;
+  std::vector<std::optional<column_index_t>> aggrMaskChannels;
+  std::vector<std::vector<column_index_t>> args;
+  std::vector<std::vector<VectorPtr>> constantLists;
+  std::vector<TypePtr> intermediateTypes;
+  for (auto i = 0; i < numAggregates; ++i) {
+    const auto& aggregate = aggregationNode_->aggregates()[i];
+    std::vector<TypePtr> argTypes;
+    for (auto& arg : aggregate->inputs()) {
+      argTypes.push_back(arg->type());
+    }
+    aggregates.push_back(Aggregate::create(
+        aggregate->name(),
+        aggregationNode_->step(),
+        argTypes,
+        outputType_->childAt(numKeys + i)));
+    aggrMaskChannels.emplace_back(std::nullopt);
+    args.push_back({static_cast<column_index_t>(numKeys + i)});
+    constantLists.push_back({nullptr});
+    intermediateTypes.push_back(intermediateType_->childAt(numKeys + i));
+  }
+
+  // The merged groups have intermediate results. No raw input is left.
+  groupingSet_ = std::make_unique<GroupingSet>(
+      std::move(hashers),
+      std::vector<column_index_t>{},
+      std::move(aggregates),
+      std::move(aggrMaskChannels),
+      std::move(args),
+      std::move(constantLists),
+      std::move(intermediateTypes),
+      aggregationNode_->ignoreNullKeys(),
+      false,
+      false,
+      nullptr,
+      operatorCtx_.get());
+  for (const auto& input : mergeInputs_) {
+    groupingSet_->addInput(input, false);
   }
+  mergeInputs_.clear();
+  groupingSet_->noMoreInput();
+  mergePending_ = false;
+}
+
+bool HashAggregation::shouldAbandonPartialAggregation() const {
+  return mayAbandonPartialAggregation_ && !abandonedPartialAggregation_ &&
+      numInputRows_ >= abandonPartialAggregationMinRows_ &&
+      100 * groupingSet_->numRows() >
+          abandonPartialAggregationMinPct_ * numInputRows_;
+}
+
+RowVectorPtr HashAggregation::getAbandonedPartialOutput() {
+  if (input_ == nullptr) {
+    if (noMoreInput_) {
+      finished_ = true;
+    }
+    return nullptr;
+  }
+  prepareOutput(input_->size());
+  groupingSet_->toIntermediate(input_, output_);
+  // Drop reference to input_ to make it singly-referenced at the producer and
+  // allow for memory reuse.
+  input_ = nullptr;
+  return output_;
+}
+
+void HashAggregation::prepareOutput(vector_size_t size) {
+  prepareOutputForReuse(output_, size);
 }
 
 void HashAggregation::resetPartialOutputIfNeed() {
@@ -230,11 +569,16 @@ void HashAggregation::resetPartialOutputIfNeed() {
     lockedStats->addRuntimeStat(
         "partialAggregationPct", RuntimeCounter(aggregationPct));
   }
-  groupingSet_->resetPartial();
+  if (groupingSet_) {
+    groupingSet_->resetPartial();
+  }
+  for (auto& groupingSet : groupingSets_) {
+    groupingSet->resetPartial();
+  }
   partialFull_ = false;
   numOutputRows_ = 0;
   numInputRows_ = 0;
-  if (!finished_) {
+  if (!finished_ && !abandonedPartialAggregation_) {
     maybeIncreasePartialAggregationMemoryUsage(aggregationPct);
   }
 }
@@ -257,7 +601,7 @@ void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
   // can allocate that much memory in next run.
   const int64_t memoryToReserve = std::max<int64_t>(
       0,
-      extendedPartialAggregationMemoryUsage - groupingSet_->allocatedBytes());
+      extendedPartialAggregationMemoryUsage - allocatedBytes());
   if (!memoryTracker_->maybeReserve(memoryToReserve)) {
     return;
   }
@@ -276,6 +620,18 @@ RowVectorPtr HashAggregation::getOutput() {
     return nullptr;
   }
 
+  if (abandonedPartialAggregation_ && !partialFull_) {
+    return getAbandonedPartialOutput();
+  }
+
+  if (mergePending_) {
+    mergePartition();
+  }
+
+  if (groupIdProjection_) {
+    return getGroupIdOutput();
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -330,6 +686,32 @@ RowVectorPtr HashAggregation::getOutput() {
   return output_;
 }
 
+RowVectorPtr HashAggregation::getGroupIdOutput() {
+  // Produce results after no-more-input or when the partial aggregation
+  // reached its memory limit.
+  if (!noMoreInput_ && !partialFull_) {
+    return nullptr;
+  }
+
+  while (outputGroupingSet_ < groupingSets_.size()) {
+    prepareOutput(outputBatchSize_);
+    if (groupingSets_[outputGroupingSet_]->getOutput(
+            outputBatchSize_, resultIterator_, output_)) {
+      numOutputRows_ += output_->size();
+      return output_;
+    }
+    resultIterator_.reset();
+    ++outputGroupingSet_;
+  }
+
+  outputGroupingSet_ = 0;
+  if (noMoreInput_) {
+    finished_ = true;
+  }
+  resetPartialOutputIfNeed();
+  return nullptr;
+}
+
 bool HashAggregation::isFinished() {
   return finished_;
 }
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/exec/GroupId.h"
 #include "velox/exec/GroupingSet.h"
 #include "velox/exec/Operator.h"
 
@@ -22,26 +23,43 @@ namespace facebook::velox::exec {
 
 class HashAggregation : public Operator {
  public:
+  /// If 'groupIdNode' is set, it is the source of 'aggregationNode' and 'this'
+  /// aggregates the input of 'groupIdNode' instead. The input is added to one
+  /// GroupingSet per grouping set of 'groupIdNode', so that each input batch
+  /// is added once instead of being repeated for each grouping set by a
+  /// GroupId operator, and each grouping set has a hash table of its own
+  /// groups. See canFuseGroupId().
   HashAggregation(
       int32_t operatorId,
       DriverCtx* driverCtx,
-      const std::shared_ptr<const core::AggregationNode>& aggregationNode);
+      const std::shared_ptr<const core::AggregationNode>& aggregationNode,
+      const std::shared_ptr<const core::GroupIdNode>& groupIdNode = nullptr);
+
+  /// Returns true if 'aggregationNode' over 'groupIdNode' can run as a single
+  /// HashAggregation operator. This is the case for partial and single
+  /// aggregations which group on the group id column and do not spill.
+  static bool canFuseGroupId(
+      const core::GroupIdNode& groupIdNode,
+      const core::AggregationNode& aggregationNode,
+      const core::QueryConfig& queryConfig);
 
   void addInput(RowVectorPtr input) override;
 
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ &&
+        !(abandonedPartialAggregation_ && input_ != nullptr);
   }
 
-  void noMoreInput() override {
-    groupingSet_->noMoreInput();
-    Operator::noMoreInput();
-  }
+  void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
+  BlockingReason isBlocked(ContinueFuture* future) override {
+    if (!future_.valid()) {
+      return BlockingReason::kNotBlocked;
+    }
+    *future = std::move(future_);
+    return BlockingReason::kWaitForAggregationMerge;
   }
 
   bool isFinished() override;
@@ -49,6 +67,7 @@ class HashAggregation : public Operator {
   void close() override {
     Operator::close();
     groupingSet_.reset();
+    groupingSets_.clear();
   }
 
  private:
@@ -60,8 +79,42 @@ class HashAggregation : public Operator {
   bool isSpillAllowed(
       const std::shared_ptr<const core::AggregationNode>& node) const;
 
+  // Creates a GroupingSet for the grouping keys and aggregates of
+  // 'aggregationNode_'.
+  std::unique_ptr<GroupingSet> createGroupingSet();
+
+  // Returns the bytes allocated by 'groupingSet_' or 'groupingSets_'.
+  uint64_t allocatedBytes() const;
+
+  // Adds 'input' to each of 'groupingSets_' for the grouping set of
+  // 'groupIdProjection_' with the same index.
+  void addGroupIdInput(const RowVectorPtr& input);
+
+  // Returns the groups of 'groupingSets_' one grouping set after the other.
+  RowVectorPtr getGroupIdOutput();
+
   void prepareOutput(vector_size_t size);
 
+  // The groups of one driver in intermediate format, split by hash partition.
+  using GroupPartitions = std::vector<std::vector<RowVectorPtr>>;
+
+  // Waits for all peer drivers to finish input. The last driver to finish
+  // splits the groups of all drivers by hash partition in parallel and gives
+  // each driver one partition to merge.
+  void startParallelMerge();
+
+  // Splits the groups of 'aggregations' into one partition per aggregation in
+  // parallel and sets the 'mergeInputs_' of each aggregation.
+  void partitionAllGroups(const std::vector<HashAggregation*>& aggregations);
+
+  // Extracts the groups of 'groupingSet_' in intermediate format and splits
+  // them into 'numPartitions' by the hash of the grouping keys.
+  GroupPartitions partitionGroups(int32_t numPartitions);
+
+  // Replaces 'groupingSet_' with one which aggregates the intermediate results
+  // in 'mergeInputs_'.
+  void mergePartition();
+
   // Invoked to reset partial aggregation state if it was full and has been
   // flushed.
   void resetPartialOutputIfNeed();
@@ -72,6 +125,16 @@ class HashAggregation : public Operator {
   // measure of the effectiveness of the partial aggregation.
   void maybeIncreasePartialAggregationMemoryUsage(double aggregationPct);
 
+  // Returns true if this partial aggregation produces almost as many groups as
+  // it gets input rows after 'abandonPartialAggregationMinRows_' input rows.
+  // Such an aggregation flushes its groups and then converts each input row to
+  // an intermediate result without grouping.
+  bool shouldAbandonPartialAggregation() const;
+
+  // Returns 'input_' converted to intermediate results after the partial
+  // aggregation has been abandoned.
+  RowVectorPtr getAbandonedPartialOutput();
+
   // Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -81,12 +144,31 @@ class HashAggregation : public Operator {
   const std::shared_ptr<memory::MemoryUsageTracker> memoryTracker_;
   const double partialAggregationGoodPct_;
   const int64_t maxExtendedPartialAggregationMemoryUsage_;
+  // True if this is a partial aggregation which may be abandoned on poor
+  // reduction.
+  const bool mayAbandonPartialAggregation_;
+  const int64_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
   const std::optional<Spiller::Config> spillConfig_;
+  const std::shared_ptr<const core::AggregationNode> aggregationNode_;
+  // True if the drivers of this aggregation merge their groups in parallel
+  // after all input is received.
+  const bool parallelMerge_;
 
   int64_t maxPartialAggregationMemoryUsage_;
   std::unique_ptr<GroupingSet> groupingSet_;
 
+  // Set if 'this' aggregates the input of a GroupIdNode. 'groupingSets_' then
+  // has one GroupingSet per grouping set of the GroupIdNode and
+  // 'groupingSet_' is not set.
+  std::optional<GroupIdProjection> groupIdProjection_;
+  std::vector<std::unique_ptr<GroupingSet>> groupingSets_;
+
+  // Index in 'groupingSets_' of the GroupingSet that produces output.
+  int32_t outputGroupingSet_{0};
+
   bool partialFull_ = false;
+  bool abandonedPartialAggregation_ = false;
   bool newDistincts_ = false;
   bool finished_ = false;
   RowContainerIterator resultIterator_;
@@ -102,6 +184,20 @@ class HashAggregation : public Operator {
 
   /// Possibly reusable output vector.
   RowVectorPtr output_;
+
+  // The type of the groups in intermediate format: the grouping keys followed
+  // by the accumulators.
+  RowTypePtr intermediateType_;
+
+  // True from no more input until the merge of this driver's partition of the
+  // groups of all drivers.
+  bool mergePending_ = false;
+
+  // The groups of all drivers in this driver's partition. Set by the last
+  // driver to finish input.
+  std::vector<RowVectorPtr> mergeInputs_;
+
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
 };
 
 } // namespace facebook::velox::exec
@@ -62,10 +62,22 @@ HashBuild::HashBuild(
           spillEnabled() ? operatorCtx_->task()->getSpillOperatorGroupLocked(
                                operatorCtx_->driverCtx()->splitGroupId,
                                planNodeId())
-                         : nullptr) {
+                         : nullptr),
+      spillSkewedKeyPct_(driverCtx->queryConfig().joinSpillSkewedKeyPct()) {
   VELOX_CHECK_NOT_NULL(joinBridge_);
   joinBridge_->addBuilder();
 
+  if (joinNode_->isShareBuild()) {
+    auto task = operatorCtx_->task();
+    const auto& queryId = task->queryCtx()->queryId();
+    // The Tasks of different queries must not share a table.
+    if (!queryId.empty()) {
+      sharedTable_ = HashTableCache::instance().get(
+          fmt::format("{}/{}", queryId, planNodeId()), task->taskId());
+      sharedTableBuilder_ = sharedTable_->builderTaskId == task->taskId();
+    }
+  }
+
   auto outputType = joinNode_->sources()[1]->outputType();
 
   auto numKeys = joinNode_->rightKeys().size();
@@ -203,7 +215,8 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionType);
 
   const int32_t numPartitions = spiller_->hashBits().numPartitions();
   spillInputIndicesBuffers_.resize(numPartitions);
@@ -278,6 +291,11 @@ void HashBuild::removeInputRowsForAntiJoinFilter() {
 void HashBuild::addInput(RowVectorPtr input) {
   checkRunning();
 
+  if (sharedTable_ != nullptr && !sharedTableBuilder_) {
+    // Another Task builds the table from the same input.
+    return;
+  }
+
   if (!ensureInputFits(input)) {
     VELOX_CHECK_NOT_NULL(input_);
     VELOX_CHECK(future_.valid());
@@ -360,6 +378,7 @@ void HashBuild::addInput(RowVectorPtr input) {
       rows->store(*decoders_[i], rowIndex, newRow, i + hashers.size());
     }
   });
+  setRowContainerMemoryBreakdown(*rows);
 }
 
 bool HashBuild::ensureInputFits(RowVectorPtr& input) {
@@ -600,7 +619,15 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
     spillers.push_back(build->spiller_.get());
     build->addAndClearSpillTarget(targetRows, targetBytes);
   }
-  VELOX_CHECK_GT(targetRows, 0);
+  // The spill is requested from outside of the group, e.g. to free memory for
+  // another query. There is no reservation shortfall to cover, so we spill the
+  // largest spillable partition if there is any.
+  const bool externalRequest = targetRows == 0;
+  if (externalRequest) {
+    VELOX_CHECK_EQ(targetBytes, 0);
+    targetRows = 1;
+    targetBytes = 1;
+  }
   VELOX_CHECK_GT(targetBytes, 0);
 
   std::vector<Spiller::SpillableStats> spillableStats(
@@ -609,7 +636,28 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
     spiller->fillSpillRuns(spillableStats);
   }
 
-  // Sort the partitions based on the amount of spillable data.
+  // A partition is skewed if most of its sampled rows have the same key.
+  // Spilling such a partition doesn't help as the restored partition can't be
+  // split by the recursive spilling and needs to be built in memory at the
+  // end. Hence, we keep the skewed partitions in memory and spill the other
+  // ones first.
+  constexpr int64_t kMinSkewSampleRows = 128;
+  std::vector<bool> skewed(spillableStats.size(), false);
+  int32_t numSkewed = 0;
+  if (spillSkewedKeyPct_ > 0) {
+    for (auto i = 0; i < spillableStats.size(); ++i) {
+      const auto& stats = spillableStats[i];
+      if (stats.numSampledRows >= kMinSkewSampleRows &&
+          stats.numHotKeyRows * 100 >=
+              stats.numSampledRows * spillSkewedKeyPct_) {
+        skewed[i] = true;
+        ++numSkewed;
+      }
+    }
+  }
+
+  // Sort the partitions based on the amount of spillable data with the skewed
+  // partitions at the end.
   SpillPartitionNumSet partitionsToSpill;
   std::vector<int32_t> partitionIndices(spillableStats.size());
   std::iota(partitionIndices.begin(), partitionIndices.end(), 0);
@@ -617,22 +665,34 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
       partitionIndices.begin(),
       partitionIndices.end(),
       [&](int32_t lhs, int32_t rhs) {
+        if (skewed[lhs] != skewed[rhs]) {
+          return skewed[rhs];
+        }
         return spillableStats[lhs].numBytes > spillableStats[rhs].numBytes;
       });
   int64_t numRows = 0;
   int64_t numBytes = 0;
+  int32_t numSkewedSpilled = 0;
   for (auto partitionNum : partitionIndices) {
     if (spillableStats[partitionNum].numBytes == 0) {
-      break;
+      continue;
     }
     partitionsToSpill.insert(partitionNum);
+    numSkewedSpilled += skewed[partitionNum];
     numRows += spillableStats[partitionNum].numRows;
     numBytes += spillableStats[partitionNum].numBytes;
     if (numRows >= targetRows && numBytes >= targetBytes) {
       break;
     }
   }
+  if (partitionsToSpill.empty() && externalRequest) {
+    return;
+  }
   VELOX_CHECK(!partitionsToSpill.empty());
+  if (numSkewed > numSkewedSpilled) {
+    stats_.wlock()->addRuntimeStat(
+        "skewedSpillPartitions", RuntimeCounter(numSkewed - numSkewedSpilled));
+  }
 
   // TODO: consider to offload the partition spill processing to an executor to
   // run in parallel.
@@ -664,6 +724,13 @@ void HashBuild::noMoreInputInternal() {
     spillGroup_->operatorStopped(*this);
   }
 
+  if (sharedTable_ != nullptr && !sharedTableBuilder_ &&
+      !HashTableCache::instance().isReadyOrFuture(sharedTable_, &future_)) {
+    waitForSharedTable_ = true;
+    setState(State::kWaitForBuild);
+    return;
+  }
+
   if (!finishHashBuild()) {
     return;
   }
@@ -691,7 +758,14 @@ bool HashBuild::finishHashBuild() {
   otherTables.reserve(peers.size());
   SpillPartitionSet spillPartitions;
   Spiller::Stats spillStats;
-  if (joinHasNullKeys_ && isNullAwareAntiJoin(joinType_)) {
+  if (sharedTable_ != nullptr && !sharedTableBuilder_) {
+    joinBridge_->setHashTable(
+        HashTableCache::instance().table(sharedTable_),
+        {},
+        sharedTable_->hasNullKeys,
+        sharedTable_->keyFilters);
+    stats_.wlock()->addRuntimeStat("sharedHashTableReused", RuntimeCounter(1));
+  } else if (joinHasNullKeys_ && isNullAwareAntiJoin(joinType_)) {
     joinBridge_->setAntiJoinHasNullKeys();
   } else {
     for (auto& peer : peers) {
@@ -740,10 +814,23 @@ bool HashBuild::finishHashBuild() {
           hasOthers ? operatorCtx_->task()->queryCtx()->executor() : nullptr);
 
       addRuntimeStats();
+      auto keyFilters = makeKeyFilters(!spillPartitions.empty());
+      std::shared_ptr<BaseHashTable> table = std::move(table_);
+      if (sharedTable_ != nullptr) {
+        auto& cache = HashTableCache::instance();
+        cache.setTable(
+            sharedTable_,
+            table,
+            joinHasNullKeys_,
+            keyFilters,
+            operatorCtx_->task());
+        table = cache.table(sharedTable_);
+      }
       if (joinBridge_->setHashTable(
-              std::move(table_),
+              std::move(table),
               std::move(spillPartitions),
-              joinHasNullKeys_)) {
+              joinHasNullKeys_,
+              std::move(keyFilters))) {
         spillGroup_->restart();
       }
     }
@@ -844,6 +931,121 @@ void HashBuild::addRuntimeStats() {
   }
 }
 
+namespace {
+// Adds the non-null values of the integer key 'column' of 'rows' to
+// 'bloomFilter' and updates 'min' and 'max'.
+template <typename T>
+void addKeysToBloomFilter(
+    char* const* rows,
+    int32_t numRows,
+    RowColumn column,
+    BloomFilter<>& bloomFilter,
+    int64_t& min,
+    int64_t& max) {
+  for (auto i = 0; i < numRows; ++i) {
+    if (RowContainer::isNullAt(rows[i], column.nullByte(), column.nullMask())) {
+      continue;
+    }
+    const int64_t value =
+        *reinterpret_cast<const T*>(rows[i] + column.offset());
+    bloomFilter.insert(value);
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+}
+} // namespace
+
+std::vector<std::shared_ptr<common::Filter>> HashBuild::makeKeyFilters(
+    bool hasSpillData) const {
+  const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+  if (!queryConfig.hashJoinBloomFilterEnabled() || hasSpillData ||
+      isInputFromSpill() ||
+      table_->hashMode() != BaseHashTable::HashMode::kHash) {
+    return {};
+  }
+  // The same join types for which HashProbe pushes down exact filters.
+  if (!isInnerJoin(joinType_) && !isLeftSemiFilterJoin(joinType_) &&
+      !isRightSemiFilterJoin(joinType_) && !isRightSemiProjectJoin(joinType_)) {
+    return {};
+  }
+  const auto numDistinct = table_->numDistinct();
+  if (numDistinct == 0 ||
+      numDistinct > queryConfig.hashJoinBloomFilterMaxEntries()) {
+    return {};
+  }
+
+  struct KeyBloomFilter {
+    int32_t keyIndex;
+    TypeKind kind;
+    std::shared_ptr<BloomFilter<>> bloomFilter;
+    int64_t min{std::numeric_limits<int64_t>::max()};
+    int64_t max{std::numeric_limits<int64_t>::min()};
+  };
+  std::vector<KeyBloomFilter> keyBloomFilters;
+  const auto& hashers = table_->hashers();
+  for (auto i = 0; i < hashers.size(); ++i) {
+    switch (hashers[i]->typeKind()) {
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT: {
+        auto bloomFilter = std::make_shared<BloomFilter<>>();
+        bloomFilter->reset(numDistinct);
+        keyBloomFilters.push_back(
+            {i, hashers[i]->typeKind(), std::move(bloomFilter)});
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  if (keyBloomFilters.empty()) {
+    return {};
+  }
+
+  constexpr int32_t kBatchSize = 1'024;
+  std::vector<char*> rows(kBatchSize);
+  BaseHashTable::RowsIterator iter;
+  while (auto numRows = table_->listAllRows(
+             &iter, kBatchSize, RowContainer::kUnlimited, rows.data())) {
+    for (auto& key : keyBloomFilters) {
+      const auto column = table_->rows()->columnAt(key.keyIndex);
+      switch (key.kind) {
+        case TypeKind::TINYINT:
+          addKeysToBloomFilter<int8_t>(
+              rows.data(), numRows, column, *key.bloomFilter, key.min, key.max);
+          break;
+        case TypeKind::SMALLINT:
+          addKeysToBloomFilter<int16_t>(
+              rows.data(), numRows, column, *key.bloomFilter, key.min, key.max);
+          break;
+        case TypeKind::INTEGER:
+          addKeysToBloomFilter<int32_t>(
+              rows.data(), numRows, column, *key.bloomFilter, key.min, key.max);
+          break;
+        case TypeKind::BIGINT:
+          addKeysToBloomFilter<int64_t>(
+              rows.data(), numRows, column, *key.bloomFilter, key.min, key.max);
+          break;
+        default:
+          VELOX_UNREACHABLE();
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<common::Filter>> keyFilters(hashers.size());
+  for (auto& key : keyBloomFilters) {
+    if (key.min > key.max) {
+      // All keys are null.
+      continue;
+    }
+    keyFilters[key.keyIndex] =
+        std::make_shared<common::BigintValuesUsingBloomFilter>(
+            key.min, key.max, std::move(key.bloomFilter), false);
+  }
+  return keyFilters;
+}
+
 BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
   switch (state_) {
     case State::kRunning:
@@ -861,6 +1063,14 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
       }
       break;
     case State::kWaitForBuild:
+      if (waitForSharedTable_) {
+        if (!future_.valid()) {
+          waitForSharedTable_ = false;
+          setRunning();
+          noMoreInputInternal();
+        }
+        break;
+      }
       FOLLY_FALLTHROUGH;
     case State::kWaitForProbe:
       if (!future_.valid()) {
@@ -879,6 +1089,14 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
   return fromStateToBlockingReason(state_);
 }
 
+void HashBuild::close() {
+  if (sharedTableBuilder_) {
+    // Lets the other Tasks fail instead of waiting if this did not finish the
+    // table.
+    HashTableCache::instance().abandon(sharedTable_);
+  }
+}
+
 bool HashBuild::isFinished() {
   return state_ == State::kFinish;
 }
@@ -17,6 +17,7 @@
 
 #include "velox/exec/HashJoinBridge.h"
 #include "velox/exec/HashTable.h"
+#include "velox/exec/HashTableCache.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Spill.h"
 #include "velox/exec/SpillOperatorGroup.h"
@@ -77,7 +78,7 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
-  void close() override {}
+  void close() override;
 
  private:
   void setState(State state);
@@ -109,9 +110,11 @@ class HashBuild final : public Operator {
   // Checks if the spilling is allowed for this hash join. As for now, we don't
   // allow spilling for null-aware anti-join with filter set. It requires to
   // cross join the null-key probe rows with all the build-side rows for filter
-  // evaluation which is not supported under spilling.
+  // evaluation which is not supported under spilling. A shared table is not
+  // spilled either since it must be complete for the other Tasks.
   bool isSpillAllowed() const {
-    return !isNullAwareAntiJoinWithFilter(joinNode_);
+    return !isNullAwareAntiJoinWithFilter(joinNode_) &&
+        !joinNode_->isShareBuild();
   }
 
   bool spillEnabled() const {
@@ -232,6 +235,14 @@ class HashBuild final : public Operator {
 
   void addRuntimeStats();
 
+  // Invoked by the last build driver after the join table is complete to
+  // make approximate filters on the join keys for pushdown into the probe
+  // side. Returns one Bloom filter per integer join key, or an empty vector if
+  // the table is not in kHash mode, is too large, is restored from spill or
+  // the join type does not allow dropping the probe rows without a match.
+  std::vector<std::shared_ptr<common::Filter>> makeKeyFilters(
+      bool hasSpillData) const;
+
   // Invoked to check if it needs to trigger spilling for test purpose only.
   bool testingTriggerSpill();
 
@@ -248,6 +259,11 @@ class HashBuild final : public Operator {
 
   const std::shared_ptr<SpillOperatorGroup> spillGroup_;
 
+  // The min percentage of the sampled rows of a spill partition with the same
+  // key for the partition to be kept in memory as skewed. See
+  // core::QueryConfig::kJoinSpillSkewedKeyPct.
+  const int32_t spillSkewedKeyPct_;
+
   State state_{State::kRunning};
 
   // The row type used for hash table build and disk spilling.
@@ -312,6 +328,17 @@ class HashBuild final : public Operator {
   std::vector<column_index_t> keyFilterChannels_;
   // Indices of dependent columns used by the filter in 'decoders_'.
   std::vector<column_index_t> dependentFilterChannels_;
+
+  // The table shared by the Tasks of the stage on this worker if the join
+  // shares its build. See core::HashJoinNode::isShareBuild().
+  std::shared_ptr<HashTableCache::Entry> sharedTable_;
+
+  // True if this Task builds 'sharedTable_'. The other Tasks drop their input
+  // and wait for the table.
+  bool sharedTableBuilder_{false};
+
+  // True while in kWaitForBuild for another Task to build 'sharedTable_'.
+  bool waitForSharedTable_{false};
 };
 
 inline std::ostream& operator<<(std::ostream& os, HashBuild::State state) {
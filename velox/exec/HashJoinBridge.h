@@ -37,11 +37,14 @@ class HashJoinBridge : public JoinBridge {
   /// 'spillPartitionSet' contains the spilled partitions while building
   /// 'table'. The function returns true if there is spill data to restore
   /// after HashProbe operators process 'table', otherwise false. This only
-  /// applies if the disk spilling is enabled.
+  /// applies if the disk spilling is enabled. 'keyFilters' is either empty or
+  /// has one, possibly null, filter per join key that the build side produced
+  /// for pushdown into the probe side.
   bool setHashTable(
-      std::unique_ptr<BaseHashTable> table,
+      std::shared_ptr<BaseHashTable> table,
       SpillPartitionSet spillPartitionSet,
-      bool hasNullKeys);
+      bool hasNullKeys,
+      std::vector<std::shared_ptr<common::Filter>> keyFilters = {});
 
   void setAntiJoinHasNullKeys();
 
@@ -51,16 +54,20 @@ class HashJoinBridge : public JoinBridge {
   /// a build side entry with a null in a join key makes the join return
   /// nothing. In this case, HashBuild operators finishes early without
   /// processing all the input and without finishing building the hash table.
+  /// 'keyFilters' are the approximate filters on the join keys produced by
+  /// HashBuild, e.g. Bloom filters for tables in kHash mode.
   struct HashBuildResult {
     HashBuildResult(
         std::shared_ptr<BaseHashTable> _table,
         std::optional<SpillPartitionId> _restoredPartitionId,
         SpillPartitionIdSet _spillPartitionIds,
-        bool _hasNullKeys)
+        bool _hasNullKeys,
+        std::vector<std::shared_ptr<common::Filter>> _keyFilters = {})
         : hasNullKeys(_hasNullKeys),
           table(std::move(_table)),
           restoredPartitionId(std::move(_restoredPartitionId)),
-          spillPartitionIds(std::move(_spillPartitionIds)) {}
+          spillPartitionIds(std::move(_spillPartitionIds)),
+          keyFilters(std::move(_keyFilters)) {}
 
     HashBuildResult() : hasNullKeys(true) {}
 
@@ -68,6 +75,7 @@ class HashJoinBridge : public JoinBridge {
     std::shared_ptr<BaseHashTable> table;
     std::optional<SpillPartitionId> restoredPartitionId;
     SpillPartitionIdSet spillPartitionIds;
+    std::vector<std::shared_ptr<common::Filter>> keyFilters;
   };
 
   /// Invoked by HashProbe operator to get the table to probe which is built by
@@ -74,6 +74,31 @@ void extractColumns(
   }
 }
 
+// Wraps the probe side column 'child' in a dictionary over 'mapping'. If
+// 'child' is a dictionary that adds no nulls, e.g. the output of a previous
+// HashProbe in a chain of joins, the indices are composed and the result
+// wraps the base of 'child', so that the chain does not add a level of
+// wrapping per join.
+VectorPtr wrapProbeChild(
+    vector_size_t size,
+    const BufferPtr& mapping,
+    const VectorPtr& child,
+    memory::MemoryPool* pool) {
+  if (!mapping || child->encoding() != VectorEncoding::Simple::DICTIONARY ||
+      child->rawNulls() != nullptr) {
+    return wrapChild(size, mapping, child);
+  }
+  auto indices = allocateIndices(size, pool);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  const auto* rawMapping = mapping->as<vector_size_t>();
+  const auto* childIndices = child->wrapInfo()->as<vector_size_t>();
+  for (auto i = 0; i < size; ++i) {
+    rawIndices[i] = childIndices[rawMapping[i]];
+  }
+  return BaseVector::wrapInDictionary(
+      nullptr, std::move(indices), size, child->valueVector());
+}
+
 folly::Range<vector_size_t*> initializeRowNumberMapping(
     BufferPtr& mapping,
     vector_size_t size,
@@ -123,6 +148,7 @@ HashProbe::HashProbe(
           joinNode->id(),
           "HashProbe"),
       outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
+      outputBatchBytes_{driverCtx->queryConfig().preferredOutputBatchBytes()},
       joinNode_(std::move(joinNode)),
       joinType_{joinNode_->joinType()},
       joinBridge_(operatorCtx_->task()->getHashJoinBridgeLocked(
@@ -147,6 +173,8 @@ HashProbe::HashProbe(
         std::make_unique<VectorHasher>(probeType_->childAt(channel), channel));
   }
   lookup_ = std::make_unique<HashLookup>(hashers_);
+  lookup_->probePartitionBits =
+      driverCtx->queryConfig().hashJoinProbePartitionBits();
   auto buildType = joinNode_->sources()[1]->outputType();
   auto tableType = makeTableType(buildType.get(), joinNode_->rightKeys());
   if (joinNode_->filter()) {
@@ -262,7 +290,8 @@ void HashProbe::maybeSetupSpillInput(
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionType);
   // Set the spill partitions to the corresponding ones at the build side. The
   // hash probe operator itself won't trigger any spilling.
   spiller_->setPartitionsSpilled(toPartitionNumSet(spillInputPartitionIds_));
@@ -317,24 +346,32 @@ void HashProbe::asyncWaitForHashTable() {
   } else if (
       (isInnerJoin(joinType_) || isLeftSemiFilterJoin(joinType_) ||
        isRightSemiFilterJoin(joinType_) || isRightSemiProjectJoin(joinType_)) &&
-      table_->hashMode() != BaseHashTable::HashMode::kHash && !isSpillInput() &&
-      !hasMoreSpillData()) {
+      (table_->hashMode() != BaseHashTable::HashMode::kHash ||
+       !hashBuildResult->keyFilters.empty()) &&
+      !isSpillInput() && !hasMoreSpillData()) {
     // Find out whether there are any upstream operators that can accept
     // dynamic filters on all or a subset of the join keys. Create dynamic
-    // filters to push down.
+    // filters to push down. In kHash mode the hashers do not have the key
+    // values and we push down the Bloom filters made by HashBuild instead.
     //
     // NOTE: this optimization is not applied in the following cases: (1) if the
     // probe input is read from spilled data and there is no upstream operators
     // involved; (2) if there is spill data to restore, then we can't filter
     // probe inputs solely based on the current table's join keys.
     const auto& buildHashers = table_->hashers();
+    const auto& keyFilters = hashBuildResult->keyFilters;
     auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
         this, keyChannels_);
     for (auto i = 0; i < keyChannels_.size(); i++) {
-      if (channels.find(keyChannels_[i]) != channels.end()) {
+      if (channels.find(keyChannels_[i]) == channels.end()) {
+        continue;
+      }
+      if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
         if (auto filter = buildHashers[i]->getFilter(false)) {
           dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
         }
+      } else if (keyFilters[i] != nullptr) {
+        dynamicFilters_.emplace(keyChannels_[i], keyFilters[i]);
       }
     }
   }
@@ -494,9 +531,12 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the pushed down filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      dynamicFilters_.begin()->second->kind() !=
+          common::FilterKind::kBigintValuesUsingBloomFilter) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -631,16 +671,9 @@ void HashProbe::addInput(RowVectorPtr input) {
 void HashProbe::prepareOutput(vector_size_t size) {
   // Try to re-use memory for the output vectors that contain build-side data.
   // We expect output vectors containing probe-side data to be null (reset in
-  // clearIdentityProjectedOutput). BaseVector::prepareForReuse keeps null
-  // children unmodified and makes non-null (build side) children reusable.
-  if (output_) {
-    VectorPtr output = std::move(output_);
-    BaseVector::prepareForReuse(output, size);
-    output_ = std::static_pointer_cast<RowVector>(output);
-  } else {
-    output_ = std::static_pointer_cast<RowVector>(
-        BaseVector::create(outputType_, size, pool()));
-  }
+  // clearIdentityProjectedOutput). prepareOutputForReuse keeps null children
+  // unmodified and makes non-null (build side) children reusable.
+  prepareOutputForReuse(output_, size);
 }
 
 void HashProbe::fillOutput(vector_size_t size) {
@@ -653,7 +686,7 @@ void HashProbe::fillOutput(vector_size_t size) {
     auto inputChild = input_->childAt(projection.inputChannel);
 
     output_->childAt(projection.outputChannel) =
-        wrapChild(size, outputRowMapping_, inputChild);
+        wrapProbeChild(size, outputRowMapping_, inputChild, pool());
   }
 
   if (isLeftSemiProjectJoin(joinType_)) {
@@ -696,20 +729,20 @@ RowVectorPtr HashProbe::getBuildSideOutput() {
     numOut = table_->listProbedRows(
         &lastProbeIterator_,
         outputBatchSize_,
-        RowContainer::kUnlimited,
+        outputBatchBytes_,
         outputTableRows_.data());
   } else if (isRightSemiProjectJoin(joinType_)) {
     numOut = table_->listAllRows(
         &lastProbeIterator_,
         outputBatchSize_,
-        RowContainer::kUnlimited,
+        outputBatchBytes_,
         outputTableRows_.data());
   } else {
     // Must be a right join or full join.
     numOut = table_->listNotProbedRows(
         &lastProbeIterator_,
         outputBatchSize_,
-        RowContainer::kUnlimited,
+        outputBatchBytes_,
         outputTableRows_.data());
   }
   if (!numOut) {
@@ -890,13 +923,33 @@ RowVectorPtr HashProbe::getOutput() {
           ++numOut;
         }
       }
+    } else if (isLeftSemiFilterJoin(joinType_) && !filter_) {
+      // The build side has no duplicate keys, so a probe row is returned once
+      // if it has a hit. There are no build side columns to extract. Only the
+      // rows in the lookup have their hits set.
+      for (auto row : lookup_->rows) {
+        if (lookup_->hits[row]) {
+          mapping[numOut] = row;
+          ++numOut;
+        }
+      }
+    } else if (isLeftSemiProjectJoin(joinType_) && !filter_) {
+      // Every probe row is returned once with its hit, if any, which sets the
+      // 'match' column.
+      std::iota(mapping.begin(), mapping.end(), 0);
+      std::copy(
+          lookup_->hits.begin(),
+          lookup_->hits.begin() + inputSize,
+          outputTableRows_.begin());
+      numOut = inputSize;
     } else {
       numOut = table_->listJoinResults(
           results_,
           isLeftJoin(joinType_) || isFullJoin(joinType_) ||
               isAntiJoins(joinType_) || isLeftSemiProjectJoin(joinType_),
           mapping,
-          folly::Range(outputTableRows_.data(), outputTableRows_.size()));
+          folly::Range(outputTableRows_.data(), outputTableRows_.size()),
+          outputBatchBytes_);
     }
 
     if (!numOut) {
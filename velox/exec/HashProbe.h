@@ -254,9 +254,13 @@ class HashProbe : public Operator {
         spillInputPartitionIds_.empty();
   }
 
-  // TODO: Define batch size as bytes based on RowContainer row sizes.
+  // Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
+  // Preferred size of the output batch. The size is estimated from the sizes
+  // of the build side rows in the RowContainer, including their strings.
+  const uint64_t outputBatchBytes_;
+
   const std::shared_ptr<const core::HashJoinNode> joinNode_;
 
   const core::JoinType joinType_;
@@ -15,12 +15,14 @@
  */
 
 #include "velox/exec/HashTable.h"
+#include <folly/Portability.h>
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/process/ProcessBase.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/HashBitRange.h"
 #include "velox/vector/VectorTypeUtils.h"
 
 using facebook::velox::common::testutil::TestValue;
@@ -28,7 +30,18 @@ using facebook::velox::common::testutil::TestValue;
 namespace facebook::velox::exec {
 namespace {
 constexpr int32_t kMinTableSizeForParallelJoinBuild = 1000;
-}
+
+// Log2 of the minimum number of slots covered by one partition of a
+// radix-partitioned join probe. 64K slots take 448KB of pointers and tags,
+// which is the order of a per-core L2 cache.
+constexpr int32_t kMinProbePartitionSizeBits = 16;
+
+// Max number of bits for radix-partitioning a join probe.
+constexpr int32_t kMaxProbePartitionBits = 8;
+
+// loadRow() and storeRow() keep the low bytes of a row pointer.
+static_assert(folly::kIsLittleEndian);
+} // namespace
 
 // static
 std::string BaseHashTable::modeString(HashMode mode) {
@@ -100,6 +113,19 @@ class ProbeState {
     return row_;
   }
 
+  // Prefetches the tags and the row pointers of the first tag group that
+  // 'hash' maps to. The 16 packed row pointers take 96 bytes at a 32 byte
+  // aligned offset, which spans 2 cache lines.
+  static inline void
+  prefetch(uint8_t* tags, char** table, uint64_t sizeMask, uint64_t hash) {
+    auto tagIndex = tagsByteOffset(hash, sizeMask);
+    auto rows = reinterpret_cast<char*>(table) +
+        static_cast<int64_t>(tagIndex) * BaseHashTable::kRowPointerBytes;
+    __builtin_prefetch(tags + tagIndex);
+    __builtin_prefetch(rows);
+    __builtin_prefetch(rows + 64);
+  }
+
   // Use one instruction to load 16 tags
   // Use another instruction to make 16 copies of the tag being searched for
   inline void
@@ -268,6 +294,37 @@ class ProbeState {
   uint8_t indexInTags_ = kNotSet;
 };
 
+namespace {
+// Number of probe positions between the row being probed and the row whose
+// buckets get prefetched. Covers the memory latency for the 4 interleaved
+// probes of a loop iteration.
+constexpr int32_t kPrefetchDistance = 16;
+
+// Min number of slots for prefetching buckets ahead of probing. Smaller tables
+// are expected to be cache resident.
+constexpr uint64_t kMinSizeForPrefetch = 256 << 10;
+
+// Prefetches the buckets of the 4 rows 'kPrefetchDistance' positions after
+// 'probeIndex' in 'rows' if these are within 'numProbes'.
+inline void prefetchAhead(
+    const vector_size_t* rows,
+    int32_t probeIndex,
+    int32_t numProbes,
+    const uint64_t* hashes,
+    uint8_t* tags,
+    char** table,
+    uint64_t sizeMask) {
+  const auto prefetchIndex = probeIndex + kPrefetchDistance;
+  if (prefetchIndex + 4 > numProbes) {
+    return;
+  }
+  for (auto i = 0; i < 4; ++i) {
+    ProbeState::prefetch(
+        tags, table, sizeMask, hashes[rows[prefetchIndex + i]]);
+  }
+}
+} // namespace
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::storeKeys(
     HashLookup& lookup,
@@ -283,10 +340,12 @@ void HashTable<ignoreNullKeys>::storeRowPointer(
     int32_t index,
     uint64_t hash,
     char* row) {
-  if (hashMode_ != HashMode::kArray) {
-    tags_[index] = hashTag(hash);
+  if (hashMode_ == HashMode::kArray) {
+    table_[index] = row;
+    return;
   }
-  table_[index] = row;
+  tags_[index] = hashTag(hash);
+  storeRow(table_, index, row);
 }
 
 template <bool ignoreNullKeys>
@@ -432,7 +491,18 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
   auto rows = lookup.rows.data();
+  const bool prefetch = size_ >= kMinSizeForPrefetch;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      prefetchAhead(
+          rows,
+          probeIndex,
+          numProbes,
+          lookup.hashes.data(),
+          tags_,
+          table_,
+          sizeMask_);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -521,17 +591,28 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   }
   if (hashMode_ == HashMode::kNormalizedKey) {
     populateNormalizedKeys(lookup, sizeBits_);
-    joinNormalizedKeyProbe(lookup);
+    joinNormalizedKeyProbe(lookup, partitionProbeRows(lookup));
     return;
   }
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
-  const vector_size_t* rows = lookup.rows.data();
+  const vector_size_t* rows = partitionProbeRows(lookup);
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
   ProbeState state4;
+  const bool prefetch = size_ >= kMinSizeForPrefetch;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      prefetchAhead(
+          rows,
+          probeIndex,
+          numProbes,
+          lookup.hashes.data(),
+          tags_,
+          table_,
+          sizeMask_);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -558,10 +639,41 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
 }
 
 template <bool ignoreNullKeys>
-void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
+const vector_size_t* HashTable<ignoreNullKeys>::partitionProbeRows(
+    HashLookup& lookup) {
+  const int32_t numBits = std::min<int32_t>(
+      std::min<int32_t>(lookup.probePartitionBits, kMaxProbePartitionBits),
+      sizeBits_ - kMinProbePartitionSizeBits);
+  if (numBits <= 0) {
+    return lookup.rows.data();
+  }
+  // The bucket index is the low 'sizeBits_' bits of the hash. Partition on
+  // the highest of these so that a partition is a contiguous range of slots.
+  const HashBitRange partitionBits(sizeBits_ - numBits, sizeBits_);
+  const auto numPartitions = partitionBits.numPartitions();
+  std::array<int32_t, (1 << kMaxProbePartitionBits) + 1> offsets;
+  std::fill(offsets.begin(), offsets.begin() + numPartitions + 1, 0);
+  const uint64_t* hashes = lookup.hashes.data();
+  for (auto row : lookup.rows) {
+    ++offsets[partitionBits.partition(hashes[row]) + 1];
+  }
+  for (auto i = 1; i <= numPartitions; ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+  lookup.partitionedRows.resize(lookup.rows.size());
+  vector_size_t* partitionedRows = lookup.partitionedRows.data();
+  for (auto row : lookup.rows) {
+    partitionedRows[offsets[partitionBits.partition(hashes[row])]++] = row;
+  }
+  return partitionedRows;
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(
+    HashLookup& lookup,
+    const vector_size_t* rows) {
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
-  const vector_size_t* rows = lookup.rows.data();
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
@@ -569,7 +681,12 @@ void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
   const uint64_t* keys = lookup.normalizedKeys.data();
   const uint64_t* hashes = lookup.hashes.data();
   char** hits = lookup.hits.data();
+  const bool prefetch = size_ >= kMinSizeForPrefetch;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      prefetchAhead(
+          rows, probeIndex, numProbes, hashes, tags_, table_, sizeMask_);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, hashes[row], row);
     row = rows[probeIndex + 1];
@@ -609,18 +726,19 @@ void HashTable<ignoreNullKeys>::allocateTables(uint64_t size) {
   sizeMask_ = size_ - 1;
   sizeBits_ = __builtin_popcountll(sizeMask_);
   constexpr auto kPageSize = memory::MappedMemory::kPageSize;
-  // The total size is 9 bytes per slot, 8 in the pointers table and 1 in the
-  // tags table.
-  auto numPages = bits::roundUp(size * 9, kPageSize) / kPageSize;
+  // The total size is 7 bytes per slot, 6 in the packed pointers table and 1
+  // in the tags table.
+  auto numPages =
+      bits::roundUp(size * (kRowPointerBytes + 1), kPageSize) / kPageSize;
   if (!rows_->mappedMemory()->allocateContiguous(
           numPages, nullptr, tableAllocation_)) {
     VELOX_FAIL("Could not allocate join/group by hash table");
   }
   table_ = tableAllocation_.data<char*>();
-  tags_ = reinterpret_cast<uint8_t*>(table_ + size);
+  tags_ = tableAllocation_.data<uint8_t>() + size * kRowPointerBytes;
   memset(tags_, 0, size_);
   // Not strictly necessary to clear 'table_' but more debuggable.
-  memset(table_, 0, size_ * sizeof(char*));
+  memset(table_, 0, size_ * kRowPointerBytes);
 }
 
 template <bool ignoreNullKeys>
@@ -630,7 +748,12 @@ void HashTable<ignoreNullKeys>::clear() {
     memset(tags_, 0, size_);
   }
   if (table_) {
-    memset(table_, 0, sizeof(char*) * size_);
+    memset(
+        table_,
+        0,
+        size_ *
+            (hashMode_ == HashMode::kArray ? sizeof(char*)
+                                           : kRowPointerBytes));
   }
   numDistinct_ = 0;
 }
@@ -1347,10 +1470,19 @@ std::string HashTable<ignoreNullKeys>::toString() {
   int32_t occupied = 0;
   if (table_ && tableAllocation_.data() && tableAllocation_.size()) {
     // 'size_' and 'table_' may not be set if initializing.
-    uint64_t size =
-        std::min<uint64_t>(tableAllocation_.size() / sizeof(char*), size_);
-    for (int32_t i = 0; i < size; ++i) {
-      occupied += table_[i] != nullptr;
+    if (hashMode_ == HashMode::kArray) {
+      uint64_t size =
+          std::min<uint64_t>(tableAllocation_.size() / sizeof(char*), size_);
+      for (int32_t i = 0; i < size; ++i) {
+        occupied += table_[i] != nullptr;
+      }
+    } else {
+      uint64_t size = std::min<uint64_t>(
+          tableAllocation_.size() / (kRowPointerBytes + 1), size_);
+      for (int32_t i = 0; i < size; ++i) {
+        occupied += tags_[i] != ProbeState::kEmptyTag &&
+            tags_[i] != ProbeState::kTombstoneTag;
+      }
     }
   }
   out << "[HashTable  size: " << size_ << " occupied: " << occupied
@@ -1432,13 +1564,16 @@ int32_t HashTable<ignoreNullKeys>::listJoinResults(
     JoinResultIterator& iter,
     bool includeMisses,
     folly::Range<vector_size_t*> inputRows,
-    folly::Range<char**> hits) {
+    folly::Range<char**> hits,
+    uint64_t maxBytes) {
   VELOX_CHECK_LE(inputRows.size(), hits.size());
   if (!hasDuplicates_) {
-    return listJoinResultsNoDuplicates(iter, includeMisses, inputRows, hits);
+    return listJoinResultsNoDuplicates(
+        iter, includeMisses, inputRows, hits, maxBytes);
   }
   int numOut = 0;
   auto maxOut = inputRows.size();
+  uint64_t totalBytes = 0;
   while (iter.lastRowIndex < iter.rows->size()) {
     if (!iter.nextHit) {
       auto row = (*iter.rows)[iter.lastRowIndex];
@@ -1467,12 +1602,13 @@ int32_t HashTable<ignoreNullKeys>::listJoinResults(
       }
       inputRows[numOut] = (*iter.rows)[iter.lastRowIndex]; // NOLINT
       hits[numOut] = iter.nextHit;
+      totalBytes += joinResultSize(iter.nextHit);
       ++numOut;
       iter.nextHit = next;
       if (!iter.nextHit) {
         ++iter.lastRowIndex;
       }
-      if (numOut >= maxOut) {
+      if (numOut >= maxOut || totalBytes > maxBytes) {
         return numOut;
       }
     }
@@ -1485,11 +1621,14 @@ int32_t HashTable<ignoreNullKeys>::listJoinResultsNoDuplicates(
     JoinResultIterator& iter,
     bool includeMisses,
     folly::Range<vector_size_t*> inputRows,
-    folly::Range<char**> hits) {
+    folly::Range<char**> hits,
+    uint64_t maxBytes) {
   int32_t numOut = 0;
   auto maxOut = inputRows.size();
   int32_t i = iter.lastRowIndex;
   auto numRows = iter.rows->size();
+  const bool checkBytes = maxBytes != RowContainer::kUnlimited;
+  uint64_t totalBytes = 0;
 
   constexpr int32_t kWidth = xsimd::batch<int64_t>::size;
   auto sourceHits = reinterpret_cast<int64_t*>(iter.hits->data());
@@ -1498,33 +1637,43 @@ int32_t HashTable<ignoreNullKeys>::listJoinResultsNoDuplicates(
   auto resultHits = reinterpret_cast<int64_t*>(hits.data());
   auto resultRows = inputRows.data();
   int32_t outLimit = maxOut - kWidth;
-  for (; i + kWidth <= numRows && numOut < outLimit; i += kWidth) {
+  for (; i + kWidth <= numRows && numOut < outLimit && totalBytes <= maxBytes;
+       i += kWidth) {
     auto indices = simd::loadGatherIndices<int64_t, int32_t>(sourceRows + i);
     auto hitWords = simd::gather(sourceHits, indices);
     auto misses = includeMisses ? 0 : simd::toBitMask(hitWords == 0);
     if (misses == 0xf) {
       continue;
     }
+    const auto firstOut = numOut;
     if (!misses) {
       hitWords.store_unaligned(resultHits + numOut);
       indices.store_unaligned(resultRows + numOut);
       numOut += kWidth;
-      continue;
+    } else {
+      auto matches = misses ^ bits::lowMask(kWidth);
+      simd::filter<int64_t>(hitWords, matches, xsimd::default_arch{})
+          .store_unaligned(resultHits + numOut);
+      simd::filter<int32_t>(indices, matches, xsimd::default_arch{})
+          .store_unaligned(resultRows + numOut);
+      numOut += __builtin_popcount(matches);
+    }
+    if (checkBytes) {
+      for (auto j = firstOut; j < numOut; ++j) {
+        totalBytes += joinResultSize(hits[j]);
+      }
     }
-    auto matches = misses ^ bits::lowMask(kWidth);
-    simd::filter<int64_t>(hitWords, matches, xsimd::default_arch{})
-        .store_unaligned(resultHits + numOut);
-    simd::filter<int32_t>(indices, matches, xsimd::default_arch{})
-        .store_unaligned(resultRows + numOut);
-    numOut += __builtin_popcount(matches);
-  }
-  for (; i < numRows; ++i) {
+  }
+  for (; i < numRows && totalBytes <= maxBytes; ++i) {
     auto row = sourceRows[i];
     if (includeMisses || sourceHits[row]) {
       resultHits[numOut] = sourceHits[row];
       resultRows[numOut] = row;
+      if (checkBytes) {
+        totalBytes += joinResultSize(hits[numOut]);
+      }
       ++numOut;
-      if (numOut >= maxOut) {
+      if (numOut >= maxOut || totalBytes > maxBytes) {
         ++i;
         break;
       }
@@ -46,6 +46,15 @@ struct HashLookup {
   // corresponding group row.
   raw_vector<char*> hits;
   std::vector<vector_size_t> newGroups;
+
+  // Number of high bits of the hash table bucket index used to
+  // radix-partition 'rows' before a join probe. Probing one partition at a
+  // time confines the random accesses to a cache-sized slice of the table.
+  // 0 means probing in the order of 'rows'.
+  uint8_t probePartitionBits{0};
+  // Permutation of 'rows' grouped by partition. Only used in a join probe if
+  // 'probePartitionBits' is set.
+  raw_vector<vector_size_t> partitionedRows;
 };
 
 class BaseHashTable {
@@ -63,6 +72,12 @@ class BaseHashTable {
   // 2M entries, i.e. 16MB is the largest array based hash table.
   static constexpr uint64_t kArrayHashMaxSize = 2L << 20;
 
+  /// Bytes per row pointer in kHash and kNormalizedKey mode tables. Row
+  /// pointers are user space addresses, which fit in 48 bits on x86-64 and
+  /// aarch64, so the high 2 bytes are not stored. kArray mode tables keep full
+  /// pointers since they are handed out by arrayTable().
+  static constexpr int32_t kRowPointerBytes = 6;
+
   /// Specifies the hash mode of a table.
   enum class HashMode { kHash, kArray, kNormalizedKey };
 
@@ -123,8 +138,9 @@ class BaseHashTable {
 
   /// Fills 'hits' with consecutive hash join results. The corresponding element
   /// of 'inputRows' is set to the corresponding row number in probe keys.
-  /// Returns the number of hits produced. If this s less than hits.size() then
-  /// all the hits have been produced.
+  /// Returns the number of hits produced. Stops after the total size of the
+  /// hit rows exceeds 'maxBytes'. All the hits have been produced when
+  /// iter.atEnd() is true.
   /// Adds input rows without a match to 'inputRows' with corresponding hit
   /// set to nullptr if 'includeMisses' is true. Otherwise, skips input rows
   /// without a match. 'includeMisses' is set to true when listing results for
@@ -133,7 +149,8 @@ class BaseHashTable {
       JoinResultIterator& iter,
       bool includeMisses,
       folly::Range<vector_size_t*> inputRows,
-      folly::Range<char**> hits) = 0;
+      folly::Range<char**> hits,
+      uint64_t maxBytes) = 0;
 
   /// Returns rows with 'probed' flag unset. Used by the right/full join.
   virtual int32_t listNotProbedRows(
@@ -188,6 +205,12 @@ class BaseHashTable {
   /// VectorHashers of 'this'.
   virtual HashMode hashMode() const = 0;
 
+  /// Returns the rows of the groups by array index in kArray hash mode. After
+  /// groupProbe() in kArray mode, the hashes of the HashLookup are the array
+  /// indices of the groups of the probed rows. The array has capacity()
+  /// entries and is valid until the next change of the hash mode or size.
+  virtual char* FOLLY_NULLABLE const* FOLLY_NONNULL arrayTable() const = 0;
+
   /// Disables use of array or normalized key hash modes.
   void forceGenericHashMode() {
     setHashMode(HashMode::kHash, 0);
@@ -261,10 +284,33 @@ class BaseHashTable {
 #endif
   }
 
-  /// Loads the payload row pointer corresponding to the tag at 'index'.
+  /// Loads the payload row pointer corresponding to the tag at 'index'. Reads
+  /// only the 'kRowPointerBytes' of the slot and not the neighboring slot,
+  /// which may be written by another thread in a parallel join build.
   static char* FOLLY_NULLABLE
   loadRow(char* FOLLY_NULLABLE* FOLLY_NULLABLE table, int32_t index) {
-    return table[index];
+    uint64_t row = 0;
+    memcpy(
+        &row,
+        reinterpret_cast<const char*>(table) +
+            static_cast<int64_t>(index) * kRowPointerBytes,
+        kRowPointerBytes);
+    return reinterpret_cast<char*>(row);
+  }
+
+  /// Stores the low 'kRowPointerBytes' of 'row' into slot 'index' of 'table'.
+  static void storeRow(
+      char* FOLLY_NULLABLE* FOLLY_NULLABLE table,
+      int32_t index,
+      char* FOLLY_NULLABLE row) {
+    const auto bits = reinterpret_cast<uint64_t>(row);
+    VELOX_DCHECK_EQ(
+        bits >> (8 * kRowPointerBytes), 0, "Row address over 48 bits");
+    memcpy(
+        reinterpret_cast<char*>(table) +
+            static_cast<int64_t>(index) * kRowPointerBytes,
+        &bits,
+        kRowPointerBytes);
   }
 
  protected:
@@ -343,7 +389,8 @@ class HashTable : public BaseHashTable {
       JoinResultIterator& iter,
       bool includeMisses,
       folly::Range<vector_size_t*> inputRows,
-      folly::Range<char**> hits) override;
+      folly::Range<char**> hits,
+      uint64_t maxBytes) override;
 
   int32_t listNotProbedRows(
       RowsIterator* FOLLY_NULLABLE iter,
@@ -391,6 +438,11 @@ class HashTable : public BaseHashTable {
     return hashMode_;
   }
 
+  char* FOLLY_NULLABLE const* FOLLY_NONNULL arrayTable() const override {
+    VELOX_CHECK_EQ(hashMode_, HashMode::kArray);
+    return table_;
+  }
+
   void decideHashMode(int32_t numNew) override;
 
   void erase(folly::Range<char**> rows) override;
@@ -412,8 +464,8 @@ class HashTable : public BaseHashTable {
   uint64_t hashTableSizeIncrease(int32_t numNewDistinct) const override {
     if (numDistinct_ + numNewDistinct > rehashSize()) {
       // If rehashed, the table adds size_ entries (i.e. doubles),
-      // adding one pointer and one tag byte for each new position.
-      return size_ * (sizeof(void*) + 1);
+      // adding one packed pointer and one tag byte for each new position.
+      return size_ * (kRowPointerBytes + 1);
     }
     return 0;
   }
@@ -464,7 +516,14 @@ class HashTable : public BaseHashTable {
       JoinResultIterator& iter,
       bool includeMisses,
       folly::Range<vector_size_t*> inputRows,
-      folly::Range<char**> hits);
+      folly::Range<char**> hits,
+      uint64_t maxBytes);
+
+  // Returns the size of the build side row 'hit' of a join result, 0 for a
+  // miss.
+  uint64_t joinResultSize(const char* FOLLY_NULLABLE hit) const {
+    return hit == nullptr ? 0 : rows_->rowSize(hit);
+  }
 
   /// Tries to use as many range hashers as can in a normalized key situation.
   void enableRangeWhereCan(
@@ -584,8 +643,16 @@ class HashTable : public BaseHashTable {
   template <bool isJoin>
   void fullProbe(HashLookup& lookup, ProbeState& state, bool extraCheck);
 
-  // Shortcut for probe with normalized keys.
-  void joinNormalizedKeyProbe(HashLookup& lookup);
+  // Shortcut for probe with normalized keys. 'rows' is either 'lookup.rows'
+  // or a permutation of it.
+  void joinNormalizedKeyProbe(HashLookup& lookup, const vector_size_t* rows);
+
+  // Returns the rows of 'lookup' in the order to probe them in. If
+  // 'lookup.probePartitionBits' is set and the table is large enough, the
+  // rows are radix-partitioned on the high bits of their bucket index, with
+  // each partition covering at least 64K slots. Otherwise returns
+  // 'lookup.rows'.
+  const vector_size_t* FOLLY_NONNULL partitionProbeRows(HashLookup& lookup);
 
   // Adds a row to a hash join table in kArray hash mode. Returns true
   // if a new entry was made and false if the row was added to an
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/HashTableCache.h"
+
+namespace facebook::velox::exec {
+
+// static
+HashTableCache& HashTableCache::instance() {
+  static HashTableCache cache;
+  return cache;
+}
+
+std::shared_ptr<HashTableCache::Entry> HashTableCache::get(
+    const std::string& key,
+    const std::string& taskId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& weakEntry = entries_[key];
+  if (auto entry = weakEntry.lock()) {
+    return entry;
+  }
+  // Drops the entries that are no longer used.
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.expired() && it->first != key) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  auto entry = std::make_shared<Entry>(taskId);
+  entries_[key] = entry;
+  return entry;
+}
+
+void HashTableCache::setTable(
+    const std::shared_ptr<Entry>& entry,
+    std::shared_ptr<BaseHashTable> table,
+    bool hasNullKeys,
+    std::vector<std::shared_ptr<common::Filter>> keyFilters,
+    std::shared_ptr<Task> builder) {
+  VELOX_CHECK_NOT_NULL(table);
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(!entry->ready);
+    entry->ready = true;
+    entry->table = std::move(table);
+    entry->hasNullKeys = hasNullKeys;
+    entry->keyFilters = std::move(keyFilters);
+    entry->builder = std::move(builder);
+    promises = std::move(entry->promises);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void HashTableCache::abandon(const std::shared_ptr<Entry>& entry) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (entry->ready) {
+      return;
+    }
+    entry->ready = true;
+    promises = std::move(entry->promises);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+bool HashTableCache::isReadyOrFuture(
+    const std::shared_ptr<Entry>& entry,
+    ContinueFuture* future) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (entry->ready) {
+    return true;
+  }
+  auto [promise, semiFuture] =
+      makeVeloxContinuePromiseContract("HashTableCache::isReadyOrFuture");
+  entry->promises.push_back(std::move(promise));
+  *future = std::move(semiFuture);
+  return false;
+}
+
+std::shared_ptr<BaseHashTable> HashTableCache::table(
+    const std::shared_ptr<Entry>& entry) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(entry->ready);
+  VELOX_CHECK_NOT_NULL(
+      entry->table,
+      "The Task {} building the shared hash table failed",
+      entry->builderTaskId);
+  // Aliases 'entry' so that the entry and its builder live as long as the
+  // table is used.
+  return std::shared_ptr<BaseHashTable>(entry, entry->table.get());
+}
+
+size_t HashTableCache::size() {
+  std::lock_guard<std::mutex> l(mutex_);
+  size_t numEntries = 0;
+  for (const auto& [key, entry] : entries_) {
+    numEntries += !entry.expired();
+  }
+  return numEntries;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include "velox/common/future/VeloxPromise.h"
+#include "velox/exec/HashTable.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::exec {
+
+class Task;
+
+/// Worker-wide cache of the hash tables of broadcast joins, so that the Tasks
+/// of the same stage on a worker build the table of a join once and probe it
+/// together. The first Task to ask for a table builds it. The others drop
+/// their build input and wait for this table. An entry lives while some Task
+/// holds the table and is then built again by the next Task asking for it.
+class HashTableCache {
+ public:
+  struct Entry {
+    /// The Task that builds the table.
+    const std::string builderTaskId;
+
+    /// Members below are guarded by the mutex of the cache.
+
+    /// Keeps the memory of 'table' alive. Declared before 'table' so that it
+    /// is destroyed after it.
+    std::shared_ptr<Task> builder;
+    bool ready{false};
+    std::shared_ptr<BaseHashTable> table;
+    bool hasNullKeys{false};
+    std::vector<std::shared_ptr<common::Filter>> keyFilters;
+
+    std::vector<ContinuePromise> promises;
+
+    explicit Entry(std::string _builderTaskId)
+        : builderTaskId(std::move(_builderTaskId)) {}
+  };
+
+  static HashTableCache& instance();
+
+  /// Returns the entry for 'key', typically query id and join plan node id.
+  /// Makes an entry with 'taskId' as the builder if there is none.
+  std::shared_ptr<Entry> get(const std::string& key, const std::string& taskId);
+
+  /// Sets the table of 'entry' and continues the waiting Tasks. 'table' is
+  /// returned to the Tasks of the entry with a reference to 'entry', so that
+  /// 'builder' stays alive while any Task uses the table.
+  void setTable(
+      const std::shared_ptr<Entry>& entry,
+      std::shared_ptr<BaseHashTable> table,
+      bool hasNullKeys,
+      std::vector<std::shared_ptr<common::Filter>> keyFilters,
+      std::shared_ptr<Task> builder);
+
+  /// Continues the waiting Tasks without a table if the builder failed. They
+  /// then fail too.
+  void abandon(const std::shared_ptr<Entry>& entry);
+
+  /// Returns true if the table of 'entry' is set or abandoned and otherwise
+  /// sets 'future' to wait for it.
+  bool isReadyOrFuture(
+      const std::shared_ptr<Entry>& entry,
+      ContinueFuture* FOLLY_NONNULL future);
+
+  /// Returns the table of a ready 'entry' with a reference to 'entry', so that
+  /// it can be handed to HashJoinBridge. Throws if the entry was abandoned.
+  std::shared_ptr<BaseHashTable> table(const std::shared_ptr<Entry>& entry);
+
+  /// Number of entries in use.
+  size_t size();
+
+ private:
+  std::mutex mutex_;
+  folly::F14FastMap<std::string, std::weak_ptr<Entry>> entries_;
+};
+
+} // namespace facebook::velox::exec
@@ -29,28 +29,33 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
-  std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  if (bufferedBytes_.fetch_add(added) + added < maxBufferSize_) {
+    return false;
   }
 
-  return false;
+  std::lock_guard<std::mutex> l(mutex_);
+  hasPromises_ = true;
+  // A consumer may have freed memory since the increase.
+  if (bufferedBytes_ < maxBufferSize_) {
+    return false;
+  }
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 std::vector<ContinuePromise> LocalExchangeMemoryManager::decreaseMemoryUsage(
     int64_t removed) {
   std::vector<ContinuePromise> promises;
-  {
-    std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
-
-    if (bufferedBytes_ < maxBufferSize_) {
-      promises = std::move(promises_);
-    }
+  if (bufferedBytes_.fetch_sub(removed) - removed >= maxBufferSize_ ||
+      !hasPromises_) {
+    return promises;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (bufferedBytes_ < maxBufferSize_) {
+    promises = std::move(promises_);
+    promises_.clear();
+    hasPromises_ = false;
   }
   return promises;
 }
@@ -85,15 +90,19 @@ void LocalExchangeQueue::noMoreProducers() {
 BlockingReason LocalExchangeQueue::enqueue(
     RowVectorPtr input,
     ContinueFuture* future) {
-  auto inputBytes = input->retainedSize();
+  auto inputBytes = input->uniqueRetainedSize();
 
-  std::vector<ContinuePromise> consumerPromises;
+  std::optional<ContinuePromise> consumerPromise;
   bool isClosed = queue_.withWLock([&](auto& queue) {
     if (closed_) {
       return true;
     }
     queue.push(std::move(input));
-    consumerPromises = std::move(consumerPromises_);
+    if (!consumerPromises_.empty()) {
+      // One vector is enough for one consumer.
+      consumerPromise = std::move(consumerPromises_.back());
+      consumerPromises_.pop_back();
+    }
     return false;
   });
 
@@ -101,7 +110,9 @@ BlockingReason LocalExchangeQueue::enqueue(
     return BlockingReason::kNotBlocked;
   }
 
-  notify(consumerPromises);
+  if (consumerPromise.has_value()) {
+    consumerPromise->setValue();
+  }
 
   if (memoryManager_->increaseMemoryUsage(future, inputBytes)) {
     return BlockingReason::kWaitForConsumer;
@@ -132,7 +143,6 @@ BlockingReason LocalExchangeQueue::next(
     memory::MemoryPool* pool,
     RowVectorPtr* data) {
   std::vector<ContinuePromise> producerPromises;
-  std::vector<ContinuePromise> memoryPromises;
   auto blockingReason = queue_.withWLock([&](auto& queue) {
     *data = nullptr;
     if (queue.empty()) {
@@ -149,16 +159,17 @@ BlockingReason LocalExchangeQueue::next(
     *data = queue.front();
     queue.pop();
 
-    memoryPromises =
-        memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
-
     if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
       producerPromises = std::move(producerPromises_);
     }
 
     return BlockingReason::kNotBlocked;
   });
-  notify(memoryPromises);
+  if (*data) {
+    auto memoryPromises =
+        memoryManager_->decreaseMemoryUsage((*data)->uniqueRetainedSize());
+    notify(memoryPromises);
+  }
   notify(producerPromises);
   return blockingReason;
 }
@@ -200,7 +211,7 @@ void LocalExchangeQueue::close() {
   queue_.withWLock([&](auto& queue) {
     uint64_t freedBytes = 0;
     while (!queue.empty()) {
-      freedBytes += queue.front()->retainedSize();
+      freedBytes += queue.front()->uniqueRetainedSize();
       queue.pop();
     }
 
@@ -354,6 +365,20 @@ void LocalPartition::addInput(RowVectorPtr input) {
     partitionFunction_->partition(*input_, partitions_);
 
     auto numInput = input_->size();
+    // A batch that goes to one partition as a whole, e.g. from scaled
+    // writers, is enqueued without wrapping.
+    if (numInput > 0 &&
+        std::all_of(partitions_.begin(), partitions_.end(), [&](auto p) {
+          return p == partitions_[0];
+        })) {
+      auto reason = queues_[partitions_[0]]->enqueue(input_, &futures_[0]);
+      if (reason != BlockingReason::kNotBlocked) {
+        blockingReasons_[0] = reason;
+        numBlockedPartitions_ = 1;
+      }
+      return;
+    }
+
     auto indexBuffers = allocateIndexBuffers(numPartitions_, numInput, pool());
     auto rawIndices = getRawIndices(indexBuffers);
 
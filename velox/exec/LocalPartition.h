@@ -21,7 +21,9 @@
 namespace facebook::velox::exec {
 
 /// Keeps track of the total size in bytes of the data buffered in all
-/// LocalExchangeQueues.
+/// LocalExchangeQueues. The size is an atomic, so that the many producers and
+/// consumers of a local exchange take the mutex only when producers block or
+/// may need to be unblocked.
 class LocalExchangeMemoryManager {
  public:
   explicit LocalExchangeMemoryManager(int64_t maxBufferSize)
@@ -38,8 +40,12 @@ class LocalExchangeMemoryManager {
 
  private:
   const int64_t maxBufferSize_;
+  std::atomic<int64_t> bufferedBytes_{0};
+  // True if 'promises_' may be non-empty. Set before a producer checks the
+  // size under 'mutex_' and read after a consumer decreases the size, so that
+  // either the producer sees the decrease or the consumer sees the flag.
+  std::atomic<bool> hasPromises_{false};
   std::mutex mutex_;
-  int64_t bufferedBytes_{0};
   std::vector<ContinuePromise> promises_;
 };
 
@@ -48,7 +54,9 @@ class LocalExchangeMemoryManager {
 /// producer must be registered with a call to 'addProducer'. 'noMoreProducers'
 /// must be called after all producers have been registered. A producer calls
 /// 'enqueue' multiple time to put the data and calls 'noMoreData' when done.
-/// Consumers call 'next' repeatedly to fetch the data.
+/// Consumers call 'next' repeatedly to fetch the data. Each enqueued vector
+/// wakes up one waiting consumer, not all of them. The memory accounting is
+/// done outside of the queue lock.
 class LocalExchangeQueue {
  public:
   LocalExchangeQueue(
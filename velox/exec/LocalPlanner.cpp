@@ -17,6 +17,7 @@
 #include "velox/core/PlanFragment.h"
 #include "velox/exec/AssignUniqueId.h"
 #include "velox/exec/CallbackSink.h"
+#include "velox/exec/CoalesceBatches.h"
 #include "velox/exec/CrossJoinBuild.h"
 #include "velox/exec/CrossJoinProbe.h"
 #include "velox/exec/EnforceSingleRow.h"
@@ -35,6 +36,7 @@
 #include "velox/exec/TableScan.h"
 #include "velox/exec/TableWriter.h"
 #include "velox/exec/TopN.h"
+#include "velox/exec/TopNRowNumber.h"
 #include "velox/exec/Unnest.h"
 #include "velox/exec/Values.h"
 #include "velox/exec/Window.h"
@@ -165,7 +167,9 @@ uint32_t maxDriversForConsumer(
   return std::numeric_limits<uint32_t>::max();
 }
 
-uint32_t maxDrivers(const DriverFactory& driverFactory) {
+uint32_t maxDrivers(
+    const DriverFactory& driverFactory,
+    const core::QueryConfig& queryConfig) {
   uint32_t count = maxDriversForConsumer(driverFactory.consumerNode);
   if (count == 1) {
     return count;
@@ -191,8 +195,9 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
     } else if (
         auto orderBy =
             std::dynamic_pointer_cast<const core::OrderByNode>(node)) {
-      // final orderby must run single-threaded
-      if (!orderBy->isPartial()) {
+      // final orderby must run single-threaded unless it sorts in parallel
+      if (!orderBy->isPartial() &&
+          !OrderBy::isParallelSort(*orderBy, queryConfig)) {
         return 1;
       }
     } else if (
@@ -243,6 +248,7 @@ void LocalPlanner::plan(
     const core::PlanFragment& planFragment,
     ConsumerSupplier consumerSupplier,
     std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    const core::QueryConfig& queryConfig,
     uint32_t maxDrivers) {
   detail::plan(
       planFragment.planNode,
@@ -254,7 +260,7 @@ void LocalPlanner::plan(
   (*driverFactories)[0]->outputDriver = true;
 
   for (auto& factory : *driverFactories) {
-    factory->maxDrivers = detail::maxDrivers(*factory);
+    factory->maxDrivers = detail::maxDrivers(*factory, queryConfig);
     factory->numDrivers = std::min(factory->maxDrivers, maxDrivers);
     // For grouped/bucketed execution we would have separate groups of drivers
     // dealing with separate split groups (one driver can access splits from
@@ -276,7 +282,22 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
   std::vector<std::unique_ptr<Operator>> operators;
   operators.reserve(planNodes.size());
 
+  const bool coalesceBatches = ctx->queryConfig().coalesceBatchesMinRows() > 0;
+  // Plan node of the last operator if its output is to be coalesced.
+  core::PlanNodePtr coalesceNode;
+  auto addCoalesceBatches = [&]() {
+    if (coalesceNode) {
+      operators.push_back(std::make_unique<CoalesceBatches>(
+          operators.size(),
+          ctx.get(),
+          coalesceNode->outputType(),
+          coalesceNode->id()));
+      coalesceNode = nullptr;
+    }
+  };
+
   for (int32_t i = 0; i < planNodes.size(); i++) {
+    addCoalesceBatches();
     // Id of the Operator being made. This is not the same as 'i'
     // because some PlanNodes may get fused.
     auto id = operators.size();
@@ -289,12 +310,18 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
                 std::dynamic_pointer_cast<const core::ProjectNode>(next)) {
           operators.push_back(std::make_unique<FilterProject>(
               id, ctx.get(), filterNode, projectNode));
+          if (coalesceBatches) {
+            coalesceNode = projectNode;
+          }
           i++;
           continue;
         }
       }
       operators.push_back(
           std::make_unique<FilterProject>(id, ctx.get(), filterNode, nullptr));
+      if (coalesceBatches) {
+        coalesceNode = filterNode;
+      }
     } else if (
         auto projectNode =
             std::dynamic_pointer_cast<const core::ProjectNode>(planNode)) {
@@ -355,6 +382,19 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     } else if (
         auto groupIdNode =
             std::dynamic_pointer_cast<const core::GroupIdNode>(planNode)) {
+      if (i < planNodes.size() - 1) {
+        auto next = planNodes[i + 1];
+        if (auto aggregationNode =
+                std::dynamic_pointer_cast<const core::AggregationNode>(next)) {
+          if (HashAggregation::canFuseGroupId(
+                  *groupIdNode, *aggregationNode, ctx->queryConfig())) {
+            operators.push_back(std::make_unique<HashAggregation>(
+                id, ctx.get(), aggregationNode, groupIdNode));
+            i++;
+            continue;
+          }
+        }
+      }
       operators.push_back(
           std::make_unique<GroupId>(id, ctx.get(), groupIdNode));
     } else if (
@@ -374,6 +414,12 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         auto windowNode =
             std::dynamic_pointer_cast<const core::WindowNode>(planNode)) {
       operators.push_back(std::make_unique<Window>(id, ctx.get(), windowNode));
+    } else if (
+        auto topNRowNumberNode =
+            std::dynamic_pointer_cast<const core::TopNRowNumberNode>(
+                planNode)) {
+      operators.push_back(
+          std::make_unique<TopNRowNumber>(id, ctx.get(), topNRowNumberNode));
     } else if (
         auto localMerge =
             std::dynamic_pointer_cast<const core::LocalMergeNode>(planNode)) {
@@ -396,6 +442,9 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
           localPartitionNode->outputType(),
           localPartitionNode->id(),
           ctx->partitionId));
+      if (coalesceBatches) {
+        coalesceNode = localPartitionNode;
+      }
     } else if (
         auto unnest =
             std::dynamic_pointer_cast<const core::UnnestNode>(planNode)) {
@@ -422,6 +471,7 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
       operators.push_back(std::move(extended));
     }
   }
+  addCoalesceBatches();
   if (consumerSupplier) {
     operators.push_back(consumerSupplier(operators.size(), ctx.get()));
   }
@@ -15,8 +15,10 @@
  */
 
 #include "velox/exec/Merge.h"
+#include <folly/lang/Bits.h>
 #include "velox/common/testutil/TestValue.h"
 #include "velox/exec/Task.h"
+#include "velox/vector/DecodedVector.h"
 
 using facebook::velox::common::testutil::TestValue;
 
@@ -146,30 +148,38 @@ RowVectorPtr Merge::getOutput() {
       return std::move(output_);
     }
 
-    if (stream->setOutputRow(outputSize_)) {
-      // The stream is at end of input batch. Need to copy out the rows before
-      // fetching next batch in 'pop'.
-      stream->copyToOutput(output_);
-    }
+    // The rows of 'stream' that are not greater than the lowest row of the
+    // other streams are taken without calling next().
+    const bool takeRun = stream == lastStream_;
+    lastStream_ = stream;
+    auto runnerUp = takeRun ? treeOfLosers_->runnerUp() : nullptr;
+    do {
+      if (stream->setOutputRow(outputSize_)) {
+        // The stream is at end of input batch. Need to copy out the rows
+        // before fetching next batch in 'pop'.
+        stream->copyToOutput(output_);
+      }
 
-    ++outputSize_;
+      ++outputSize_;
 
-    // Advance the stream.
-    stream->pop(sourceBlockingFutures_);
+      // Advance the stream.
+      stream->pop(sourceBlockingFutures_);
 
-    if (outputSize_ == outputBatchSize_) {
-      // Copy out data from all sources.
-      for (auto& s : streams_) {
-        s->copyToOutput(output_);
-      }
+      if (outputSize_ == outputBatchSize_) {
+        // Copy out data from all sources.
+        for (auto& s : streams_) {
+          s->copyToOutput(output_);
+        }
 
-      outputSize_ = 0;
-      return std::move(output_);
-    }
+        outputSize_ = 0;
+        return std::move(output_);
+      }
 
-    if (!sourceBlockingFutures_.empty()) {
-      return nullptr;
-    }
+      if (!sourceBlockingFutures_.empty()) {
+        return nullptr;
+      }
+    } while (takeRun && stream->hasData() &&
+             (!runnerUp || !(*runnerUp < *stream)));
   }
 }
 
@@ -181,6 +191,14 @@ void Merge::close() {
 
 bool SourceStream::operator<(const MergeStream& other) const {
   const auto& otherCursor = static_cast<const SourceStream&>(other);
+  if (!normalizedKeys_.empty() && !otherCursor.normalizedKeys_.empty()) {
+    const auto left = normalizedKeys_[currentSourceRow_];
+    const auto right =
+        otherCursor.normalizedKeys_[otherCursor.currentSourceRow_];
+    if (left != right || normalizedKeysExact_) {
+      return left < right;
+    }
+  }
   for (auto i = 0; i < sortingKeys_.size(); ++i) {
     const auto& [_, compareFlags] = sortingKeys_[i];
     VELOX_DCHECK(
@@ -256,10 +274,80 @@ bool SourceStream::fetchMoreData(std::vector<ContinueFuture>& futures) {
     for (const auto& key : sortingKeys_) {
       keyColumns_.push_back(data_->childAt(key.first).get());
     }
+    normalizeKeys();
   }
   return false;
 }
 
+namespace {
+// Flips the sign bit so that the keys compare as unsigned.
+template <typename T>
+void normalizeIntegers(
+    const DecodedVector& decoded,
+    bool ascending,
+    std::vector<uint64_t>& keys) {
+  for (auto i = 0; i < keys.size(); ++i) {
+    const uint64_t key =
+        static_cast<uint64_t>(static_cast<int64_t>(decoded.valueAt<T>(i))) ^
+        (1ULL << 63);
+    keys[i] = ascending ? key : ~key;
+  }
+}
+
+// Takes the first 8 bytes as a big endian number, padded with zeros.
+void normalizeStrings(
+    const DecodedVector& decoded,
+    bool ascending,
+    std::vector<uint64_t>& keys) {
+  for (auto i = 0; i < keys.size(); ++i) {
+    const auto value = decoded.valueAt<StringView>(i);
+    uint64_t prefix = 0;
+    memcpy(&prefix, value.data(), std::min<int32_t>(value.size(), 8));
+    prefix = folly::Endian::big(prefix);
+    keys[i] = ascending ? prefix : ~prefix;
+  }
+}
+} // namespace
+
+void SourceStream::normalizeKeys() {
+  normalizedKeys_.clear();
+  if (sortingKeys_.size() != 1) {
+    return;
+  }
+  const auto& [channel, compareFlags] = sortingKeys_[0];
+  const auto& key = data_->childAt(channel);
+  SelectivityVector rows(data_->size());
+  DecodedVector decoded(*key, rows);
+  if (decoded.mayHaveNulls()) {
+    return;
+  }
+  normalizedKeys_.resize(data_->size());
+  normalizedKeysExact_ = true;
+  const auto ascending = compareFlags.ascending;
+  switch (key->typeKind()) {
+    case TypeKind::BIGINT:
+      normalizeIntegers<int64_t>(decoded, ascending, normalizedKeys_);
+      break;
+    case TypeKind::INTEGER:
+      normalizeIntegers<int32_t>(decoded, ascending, normalizedKeys_);
+      break;
+    case TypeKind::SMALLINT:
+      normalizeIntegers<int16_t>(decoded, ascending, normalizedKeys_);
+      break;
+    case TypeKind::TINYINT:
+      normalizeIntegers<int8_t>(decoded, ascending, normalizedKeys_);
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      normalizeStrings(decoded, ascending, normalizedKeys_);
+      normalizedKeysExact_ = false;
+      break;
+    default:
+      normalizedKeys_.clear();
+      break;
+  }
+}
+
 LocalMerge::LocalMerge(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -297,7 +385,9 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange"),
+      serdeOptions_(
+          exchangeSerdeOptions(driverCtx->task->queryCtx()->queryConfig())) {}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
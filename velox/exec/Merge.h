@@ -74,6 +74,12 @@ class Merge : public SourceOperator {
   /// Used to merge data from two or more sources.
   std::unique_ptr<TreeOfLosers<SourceStream>> treeOfLosers_;
 
+  /// The stream returned by the previous 'treeOfLosers_->next()'. A stream
+  /// that wins twice in a row is likely to have a run of rows ahead of the
+  /// other streams. These are then taken without going through the tree for
+  /// each row, see TreeOfLosers::runnerUp().
+  SourceStream* lastStream_{nullptr};
+
   RowVectorPtr output_;
 
   /// Number of rows accumulated in 'output_' so far.
@@ -140,6 +146,9 @@ class SourceStream final : public MergeStream {
  private:
   bool fetchMoreData(std::vector<ContinueFuture>& futures);
 
+  /// Sets 'normalizedKeys_' for the rows of 'data_'.
+  void normalizeKeys();
+
   MergeSource* source_;
 
   const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys_;
@@ -151,6 +160,15 @@ class SourceStream final : public MergeStream {
   /// order as 'sortingKeys_'.
   std::vector<BaseVector*> keyColumns_;
 
+  /// Order preserving 64 bit prefixes of the sorting key for the rows of
+  /// 'data_'. Rows with different prefixes compare by the prefix alone. Set
+  /// if there is a single BIGINT, INTEGER, SMALLINT, TINYINT, VARCHAR or
+  /// VARBINARY key without nulls in 'data_', empty otherwise.
+  std::vector<uint64_t> normalizedKeys_;
+
+  /// True if equal 'normalizedKeys_' mean equal keys, i.e. for integers.
+  bool normalizedKeysExact_{false};
+
   /// Index of the current row.
   vector_size_t currentSourceRow_{0};
 
@@ -195,10 +213,16 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  const serializer::presto::PrestoVectorSerde::PrestoOptions& serdeOptions()
+      const {
+    return serdeOptions_;
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
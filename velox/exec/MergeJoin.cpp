@@ -34,8 +34,16 @@ MergeJoin::MergeJoin(
       joinType_{joinNode->joinType()},
       numKeys_{joinNode->leftKeys().size()} {
   VELOX_USER_CHECK(
-      joinNode->isInnerJoin() || joinNode->isLeftJoin(),
-      "Merge join supports only inner and left joins. Other join types are not supported yet.");
+      joinNode->isInnerJoin() || joinNode->isLeftJoin() ||
+          joinNode->isRightJoin() || joinNode->isFullJoin() ||
+          joinNode->isLeftSemiFilterJoin() || joinNode->isAntiJoin(),
+      "Merge join supports only inner, left, right, full, left semi and anti joins: {}",
+      core::joinTypeName(joinType_));
+  VELOX_USER_CHECK(
+      joinNode->filter() == nullptr || joinNode->isInnerJoin() ||
+          joinNode->isLeftJoin(),
+      "Merge join supports filters only for inner and left joins: {}",
+      core::joinTypeName(joinType_));
 
   leftKeys_.reserve(numKeys_);
   rightKeys_.reserve(numKeys_);
@@ -226,6 +234,27 @@ void MergeJoin::addOutputRowForLeftJoin(
   ++outputSize_;
 }
 
+void MergeJoin::addOutputRowForRightJoin(
+    const RowVectorPtr& right,
+    vector_size_t rightIndex) {
+  for (const auto& projection : leftProjections_) {
+    const auto& target = output_->childAt(projection.outputChannel);
+    target->setNull(outputSize_, true);
+  }
+
+  copyRow(right, rightIndex, output_, outputSize_, rightProjections_);
+
+  ++outputSize_;
+}
+
+void MergeJoin::addOutputRowForLeftSemiJoin(
+    const RowVectorPtr& left,
+    vector_size_t leftIndex) {
+  copyRow(left, leftIndex, output_, outputSize_, leftProjections_);
+
+  ++outputSize_;
+}
+
 void MergeJoin::addOutputRow(
     const RowVectorPtr& left,
     vector_size_t leftIndex,
@@ -300,6 +329,13 @@ void MergeJoin::prepareOutput() {
 }
 
 bool MergeJoin::addToOutput() {
+  if (isAntiJoin(joinType_)) {
+    // Left-side rows with a match on the right side are not returned.
+    leftMatch_.reset();
+    rightMatch_.reset();
+    return false;
+  }
+
   prepareOutput();
 
   size_t firstLeftBatch;
@@ -319,6 +355,17 @@ bool MergeJoin::addToOutput() {
     auto leftEnd = l == numLefts - 1 ? leftMatch_->endIndex : left->size();
 
     for (auto i = leftStart; i < leftEnd; ++i) {
+      if (isLeftSemiFilterJoin(joinType_)) {
+        // Each left-side row with a match is returned exactly once.
+        if (outputSize_ == outputBatchSize_) {
+          leftMatch_->setCursor(l, i);
+          rightMatch_->setCursor(0, rightMatch_->startIndex);
+          return true;
+        }
+        addOutputRowForLeftSemiJoin(left, i);
+        continue;
+      }
+
       auto firstRightBatch =
           (l == firstLeftBatch && i == leftStart && rightMatch_->cursor)
           ? rightMatch_->cursor->batchIndex
@@ -376,6 +423,26 @@ vector_size_t firstNonNull(
 }
 } // namespace
 
+vector_size_t MergeJoin::firstRightRow(vector_size_t start) const {
+  if (isRightOuter()) {
+    // Right-side rows with null keys don't match any left-side row, but still
+    // need to be returned.
+    return start;
+  }
+  return firstNonNull(rightInput_, rightKeys_, start);
+}
+
+int32_t MergeJoin::compareForMatch() const {
+  if (isRightOuter()) {
+    for (auto key : rightKeys_) {
+      if (rightInput_->childAt(key)->isNullAt(rightIndex_)) {
+        return 1;
+      }
+    }
+  }
+  return compare();
+}
+
 RowVectorPtr MergeJoin::getOutput() {
   // Make sure to have is-blocked or needs-input as true if returning null
   // output. Otherwise, Driver assumes the operator is finished.
@@ -415,7 +482,7 @@ RowVectorPtr MergeJoin::getOutput() {
         }
 
         if (rightInput_) {
-          rightIndex_ = firstNonNull(rightInput_, rightKeys_);
+          rightIndex_ = firstRightRow(0);
           if (rightIndex_ == rightInput_->size()) {
             // Ran out of rows on the right side.
             rightInput_ = nullptr;
@@ -474,8 +541,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
         return nullptr;
       }
       if (rightMatch_->inputs.back() == rightInput_) {
-        rightIndex_ =
-            firstNonNull(rightInput_, rightKeys_, rightMatch_->endIndex);
+        rightIndex_ = firstRightRow(rightMatch_->endIndex);
         if (rightIndex_ == rightInput_->size()) {
           rightInput_ = nullptr;
         }
@@ -500,50 +566,68 @@ RowVectorPtr MergeJoin::doGetOutput() {
   }
 
   if (!input_ || !rightInput_) {
-    if (isLeftJoin(joinType_)) {
-      if (input_ && noMoreRightInput_) {
-        prepareOutput();
-        while (true) {
-          if (outputSize_ == outputBatchSize_) {
-            return std::move(output_);
-          }
+    if (isLeftOuter() && input_ && noMoreRightInput_) {
+      prepareOutput();
+      while (true) {
+        if (outputSize_ == outputBatchSize_) {
+          return std::move(output_);
+        }
 
-          addOutputRowForLeftJoin(input_, index_);
+        addOutputRowForLeftJoin(input_, index_);
 
-          ++index_;
-          if (index_ == input_->size()) {
-            // Ran out of rows on the left side.
-            input_ = nullptr;
-            return nullptr;
-          }
+        ++index_;
+        if (index_ == input_->size()) {
+          // Ran out of rows on the left side.
+          input_ = nullptr;
+          return nullptr;
         }
       }
+    }
 
-      if (noMoreInput_ && output_) {
-        output_->resize(outputSize_);
-        return std::move(output_);
-      }
-    } else {
-      if (noMoreInput_ || noMoreRightInput_) {
-        if (output_) {
-          output_->resize(outputSize_);
+    if (isRightOuter() && rightInput_ && noMoreInput_) {
+      prepareOutput();
+      while (true) {
+        if (outputSize_ == outputBatchSize_) {
           return std::move(output_);
         }
-        input_ = nullptr;
+
+        addOutputRowForRightJoin(rightInput_, rightIndex_);
+
+        ++rightIndex_;
+        if (rightIndex_ == rightInput_->size()) {
+          // Ran out of rows on the right side.
+          rightInput_ = nullptr;
+          return nullptr;
+        }
       }
     }
 
+    const bool noMoreLeftRows = noMoreInput_ && !input_;
+    const bool noMoreRightRows = noMoreRightInput_ && !rightInput_;
+
+    // Left-side rows can no longer produce any output once the right side
+    // has run out unless these rows are returned as misses.
+    if (noMoreRightRows && !isLeftOuter()) {
+      input_ = nullptr;
+    }
+
+    if ((noMoreLeftRows || (noMoreRightRows && !isLeftOuter())) &&
+        (noMoreRightRows || !isRightOuter()) && output_) {
+      output_->resize(outputSize_);
+      return std::move(output_);
+    }
+
     return nullptr;
   }
 
   // Look for a new match starting with index_ row on the left and rightIndex_
   // row on the right.
-  auto compareResult = compare();
+  auto compareResult = compareForMatch();
 
   for (;;) {
     // Catch up input_ with rightInput_.
     while (compareResult < 0) {
-      if (isLeftJoin(joinType_)) {
+      if (isLeftOuter()) {
         prepareOutput();
 
         if (outputSize_ == outputBatchSize_) {
@@ -559,18 +643,28 @@ RowVectorPtr MergeJoin::doGetOutput() {
         input_ = nullptr;
         return nullptr;
       }
-      compareResult = compare();
+      compareResult = compareForMatch();
     }
 
     // Catch up rightInput_ with input_.
     while (compareResult > 0) {
-      rightIndex_ = firstNonNull(rightInput_, rightKeys_, rightIndex_ + 1);
+      if (isRightOuter()) {
+        prepareOutput();
+
+        if (outputSize_ == outputBatchSize_) {
+          return std::move(output_);
+        }
+
+        addOutputRowForRightJoin(rightInput_, rightIndex_);
+      }
+
+      rightIndex_ = firstRightRow(rightIndex_ + 1);
       if (rightIndex_ == rightInput_->size()) {
         // Ran out of rows on the right side.
         rightInput_ = nullptr;
         return nullptr;
       }
-      compareResult = compare();
+      compareResult = compareForMatch();
     }
 
     if (compareResult == 0) {
@@ -615,7 +709,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
       }
 
       index_ = endIndex;
-      rightIndex_ = firstNonNull(rightInput_, rightKeys_, endRightIndex);
+      rightIndex_ = firstRightRow(endRightIndex);
       if (rightIndex_ == rightInput_->size()) {
         // Ran out of rows on the right side.
         rightInput_ = nullptr;
@@ -629,7 +723,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
         return nullptr;
       }
 
-      compareResult = compare();
+      compareResult = compareForMatch();
     }
   }
 
@@ -720,7 +814,15 @@ void MergeJoin::evaluateFilter(const SelectivityVector& rows) {
 }
 
 bool MergeJoin::isFinished() {
-  return noMoreInput_ && input_ == nullptr;
+  if (!noMoreInput_ || input_ != nullptr || leftMatch_ || output_) {
+    return false;
+  }
+
+  if (isRightOuter()) {
+    // Remaining rows on the right side still need to be returned as misses.
+    return noMoreRightInput_ && rightInput_ == nullptr;
+  }
+  return true;
 }
 
 } // namespace facebook::velox::exec
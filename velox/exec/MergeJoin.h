@@ -65,6 +65,30 @@ class MergeJoin : public Operator {
         leftKeys_, input_, index_, rightKeys_, rightInput_, rightIndex_);
   }
 
+  // Same as compare(), but for right and full joins orders a right-side row
+  // with a null key before the left-side row. Such a row doesn't match any
+  // row on the left and is returned as a miss.
+  int32_t compareForMatch() const;
+
+  // Returns the first row in rightInput_ at or after 'start' that needs to be
+  // processed. Skips rows with null keys unless these need to be returned as
+  // misses.
+  vector_size_t firstRightRow(vector_size_t start) const;
+
+  // True if left-side rows with no match on the right side are returned: left
+  // and full joins return these with nulls for the right-side columns, anti
+  // joins return these as is.
+  bool isLeftOuter() const {
+    return isLeftJoin(joinType_) || isFullJoin(joinType_) ||
+        isAntiJoin(joinType_);
+  }
+
+  // True if right-side rows with no match on the left side are returned with
+  // nulls for the left-side columns.
+  bool isRightOuter() const {
+    return isRightJoin(joinType_) || isFullJoin(joinType_);
+  }
+
   // Compare two rows on the left: index_ and index.
   int32_t compareLeft(vector_size_t index) const {
     return compare(leftKeys_, input_, index_, leftKeys_, input_, index);
@@ -157,7 +181,9 @@ class MergeJoin : public Operator {
   // rows were added. Fills up output starting from leftMatchCursor_ and
   // rightMatchCursor_ positions if these are set. Clears leftMatch_ and
   // rightMatch_ if all rows were added. Updates leftMatchCursor_ and
-  // rightMatchCursor_ if output_ filled up before all rows were added.
+  // rightMatchCursor_ if output_ filled up before all rows were added. Left
+  // semi joins add each left-side row of the match once. Anti joins add
+  // nothing.
   bool addToOutput();
 
   // Adds one row of output by copying values from left and right batches at the
@@ -180,6 +206,19 @@ class MergeJoin : public Operator {
       const RowVectorPtr& left,
       vector_size_t leftIndex);
 
+  /// Adds one row of output for a right-side row with no left-side match.
+  /// Copies values from the 'rightIndex' row of 'right' and fills in nulls
+  /// for columns that correspond to the left side.
+  void addOutputRowForRightJoin(
+      const RowVectorPtr& right,
+      vector_size_t rightIndex);
+
+  /// Adds one row of output for a left-side row with a right-side match in a
+  /// left semi join. Copies values from the 'leftIndex' row of 'left'.
+  void addOutputRowForLeftSemiJoin(
+      const RowVectorPtr& left,
+      vector_size_t leftIndex);
+
   /// Evaluates join filter on 'filterInput_' and returns 'output' that contains
   /// a subset of rows on which the filter passed. Returns nullptr if no rows
   /// passed the filter.
@@ -18,6 +18,7 @@
 #include "velox/common/process/ProcessBase.h"
 #include "velox/exec/Driver.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/RowContainer.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
 
@@ -110,6 +111,16 @@ std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
         return std::nullopt;
       }
       break;
+    case Spiller::Type::kWindow:
+      if (!queryConfig.windowSpillEnabled()) {
+        return std::nullopt;
+      }
+      break;
+    case Spiller::Type::kTopN:
+      if (!queryConfig.topNSpillEnabled()) {
+        return std::nullopt;
+      }
+      break;
     case Spiller::Type::kHashJoinBuild:
       FOLLY_FALLTHROUGH;
     case Spiller::Type::kHashJoinProbe:
@@ -137,7 +148,8 @@ std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
           queryConfig.spillStartPartitionBit() +
               queryConfig.spillPartitionBits()),
       queryConfig.maxSpillLevel(),
-      queryConfig.testingSpillPct());
+      queryConfig.testingSpillPct(),
+      spillCompressionType(queryConfig.spillCompressionCodec()));
 }
 
 Operator::Operator(
@@ -289,6 +301,69 @@ RowVectorPtr Operator::fillOutput(vector_size_t size, BufferPtr mapping) {
       std::move(columns));
 }
 
+void Operator::prepareOutputForReuse(
+    RowVectorPtr& output,
+    vector_size_t size) {
+  recycleReleasedVectors();
+  auto& vectorPool = operatorCtx_->vectorPool();
+  if (output == nullptr || !output.unique()) {
+    if (output != nullptr) {
+      for (const auto& child : output->children()) {
+        recycleWhenReleased(child);
+      }
+    }
+    std::vector<VectorPtr> children(outputType_->size());
+    for (auto i = 0; i < children.size(); ++i) {
+      children[i] = vectorPool.get(outputType_->childAt(i), size);
+    }
+    output = std::make_shared<RowVector>(
+        pool(), outputType_, BufferPtr(nullptr), size, std::move(children));
+    return;
+  }
+
+  // Null children are left null, e.g. HashProbe sets the probe side columns
+  // for each batch.
+  for (auto i = 0; i < output->childrenSize(); ++i) {
+    auto& child = output->childAt(i);
+    if (child != nullptr && !child.unique()) {
+      recycleWhenReleased(std::move(child));
+      child = vectorPool.get(outputType_->childAt(i), size);
+    }
+  }
+  VectorPtr vector = std::move(output);
+  BaseVector::prepareForReuse(vector, size);
+  output = std::static_pointer_cast<RowVector>(vector);
+}
+
+void Operator::recycleWhenReleased(VectorPtr vector) {
+  if (vector == nullptr || !vector->isFlatEncoding()) {
+    return;
+  }
+  recycleReleasedVectors();
+  if (vector.unique()) {
+    operatorCtx_->vectorPool().release(vector);
+    return;
+  }
+  if (recyclePending_.size() >= kMaxRecyclePending) {
+    // The oldest vectors are the least likely to be released soon.
+    recyclePending_.erase(recyclePending_.begin());
+  }
+  recyclePending_.push_back(std::move(vector));
+}
+
+void Operator::recycleReleasedVectors() {
+  auto& vectorPool = operatorCtx_->vectorPool();
+  auto it = std::remove_if(
+      recyclePending_.begin(), recyclePending_.end(), [&](auto& vector) {
+        if (!vector.unique()) {
+          return false;
+        }
+        vectorPool.release(vector);
+        return true;
+      });
+  recyclePending_.erase(it, recyclePending_.end());
+}
+
 OperatorStats Operator::stats(bool clear) {
   if (!clear) {
     return *stats_.rlock();
@@ -300,12 +375,27 @@ OperatorStats Operator::stats(bool clear) {
   return ret;
 }
 
-void Operator::recordBlockingTime(uint64_t start) {
+void Operator::recordBlockingTime(uint64_t start, BlockingReason reason) {
   uint64_t now =
       std::chrono::duration_cast<std::chrono::microseconds>(
           std::chrono::high_resolution_clock::now().time_since_epoch())
           .count();
-  stats_.wlock()->blockedWallNanos += (now - start) * 1000;
+  const auto blockedNanos = (now - start) * 1000;
+  auto lockedStats = stats_.wlock();
+  lockedStats->blockedWallNanos += blockedNanos;
+  // kWaitForExchange -> waitForExchangeWallNanos.
+  auto name = blockingReasonToString(reason).substr(1);
+  name[0] = std::tolower(name[0]);
+  lockedStats->addRuntimeStat(
+      name + "WallNanos",
+      RuntimeCounter(blockedNanos, RuntimeCounter::Unit::kNanos));
+}
+
+void Operator::setRowContainerMemoryBreakdown(const RowContainer& rows) {
+  const int64_t stringBytes = rows.stringAllocator().retainedSize();
+  auto breakdown = memoryBreakdown_.wlock();
+  (*breakdown)["rowContainer"] = rows.allocatedBytes() - stringBytes;
+  (*breakdown)["hashStringAllocator"] = stringBytes;
 }
 
 std::string Operator::toString() const {
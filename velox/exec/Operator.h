@@ -25,6 +25,8 @@
 
 namespace facebook::velox::exec {
 
+class RowContainer;
+
 // Represents a column that is copied from input to output, possibly
 // with cardinality change, i.e. values removed or duplicated.
 struct IdentityProjection {
@@ -201,6 +203,12 @@ class OperatorCtx {
 
   core::ExecCtx* FOLLY_NONNULL execCtx() const;
 
+  /// Returns the pool of recyclable vectors of the operator. This is the pool
+  /// which the expressions evaluated by the operator allocate from.
+  VectorPool& vectorPool() const {
+    return execCtx()->vectorPool();
+  }
+
   /// Makes an extract of QueryCtx for use in a connector. 'planNodeId'
   /// is the id of the calling TableScan. This and the task id identify
   /// the scan for column access tracking.
@@ -389,7 +397,9 @@ class Operator : public BaseRuntimeStatWriter {
     return stats_;
   }
 
-  void recordBlockingTime(uint64_t start);
+  // Adds the time since 'start' to the blocked time and to the runtime stat of
+  // 'reason', e.g. waitForExchangeWallNanos.
+  void recordBlockingTime(uint64_t start, BlockingReason reason);
 
   virtual std::string toString() const;
 
@@ -409,6 +419,12 @@ class Operator : public BaseRuntimeStatWriter {
     return operatorCtx_->operatorType();
   }
 
+  /// Returns the bytes held by the data structures of 'this' by name, as last
+  /// reported by the operator. Can be called from any thread.
+  std::unordered_map<std::string, int64_t> memoryBreakdown() const {
+    return *memoryBreakdown_.rlock();
+  }
+
   // Registers 'translator' for mapping user defined PlanNode subclass instances
   // to user-defined Operators.
   static void registerOperator(std::unique_ptr<PlanNodeTranslator> translator);
@@ -444,6 +460,26 @@ class Operator : public BaseRuntimeStatWriter {
   // 'identityProjections_' and 'resultProjections_'.
   RowVectorPtr fillOutput(vector_size_t size, BufferPtr mapping);
 
+  // Prepares 'output' to receive 'size' rows of 'outputType_'. Reuses
+  // 'output' and its children if the consumer has released them. Children
+  // still referenced by the consumer are replaced with vectors from the
+  // vector pool of the operator and go back to the pool once released. A new
+  // 'output' is made if the consumer still references the previous one.
+  void prepareOutputForReuse(RowVectorPtr& output, vector_size_t size);
+
+  // Returns 'vector' to the vector pool of the operator once nothing else
+  // references it. Only flat vectors are kept.
+  void recycleWhenReleased(VectorPtr vector);
+
+  // Records 'bytes' as the memory held by the data structure 'name' of 'this'.
+  void setMemoryBreakdown(const std::string& name, int64_t bytes) {
+    (*memoryBreakdown_.wlock())[name] = bytes;
+  }
+
+  // Records the memory held by the rows of 'rows' and by its string
+  // allocator.
+  void setRowContainerMemoryBreakdown(const RowContainer& rows);
+
   std::unique_ptr<OperatorCtx> operatorCtx_;
   folly::Synchronized<OperatorStats> stats_;
   const RowTypePtr outputType_;
@@ -466,6 +502,21 @@ class Operator : public BaseRuntimeStatWriter {
 
   std::unordered_map<column_index_t, std::shared_ptr<common::Filter>>
       dynamicFilters_;
+
+  folly::Synchronized<std::unordered_map<std::string, int64_t>>
+      memoryBreakdown_;
+
+ private:
+  // The maximum number of vectors waiting to be released by the consumers.
+  static constexpr int32_t kMaxRecyclePending = 64;
+
+  // Moves the vectors of 'recyclePending_' which are no longer referenced by
+  // the consumers to the vector pool.
+  void recycleReleasedVectors();
+
+  // Vectors handed out to the consumers which go back to the vector pool
+  // once released. See recycleWhenReleased().
+  std::vector<VectorPtr> recyclePending_;
 };
 
 /// Given a row type returns indices for the specified subset of columns.
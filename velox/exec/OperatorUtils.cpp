@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/OperatorUtils.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/vector/ConstantVector.h"
@@ -348,12 +349,26 @@ void addOperatorRuntimeStats(
     const std::string& name,
     const RuntimeCounter& value,
     std::unordered_map<std::string, RuntimeMetric>& stats) {
-  if (UNLIKELY(stats.count(name) == 0)) {
+  const bool isNew = stats.count(name) == 0;
+  if (UNLIKELY(isNew)) {
     stats.insert(std::pair(name, RuntimeMetric(value.unit)));
   } else {
     VELOX_CHECK_EQ(stats.at(name).unit, value.unit);
   }
   stats.at(name).addValue(value.value);
+
+  // Latencies, e.g. IO and exchange waits, are also exported as histograms
+  // across all operators of the process.
+  if (value.unit == RuntimeCounter::Unit::kNanos &&
+      BaseStatsReporter::registered) {
+    const auto key = fmt::format("velox.{}", name);
+    if (UNLIKELY(isNew)) {
+      // Buckets of 1ms up to 10s.
+      REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+          key, 1'000'000, 0, 10'000'000'000, 50, 90, 99);
+    }
+    REPORT_ADD_HISTOGRAM_VALUE(key, value.value);
+  }
 }
 
 } // namespace facebook::velox::exec
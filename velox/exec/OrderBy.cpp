@@ -15,6 +15,7 @@
  */
 #include "velox/exec/OrderBy.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
@@ -38,6 +39,7 @@ OrderBy::OrderBy(
           "OrderBy"),
       mappedMemory_(operatorCtx_->mappedMemory()),
       numSortKeys_(orderByNode->sortingKeys().size()),
+      parallelSort_(isParallelSort(*orderByNode, driverCtx->queryConfig())),
       spillMemoryThreshold_(operatorCtx_->driverCtx()
                                 ->queryConfig()
                                 .orderBySpillMemoryThreshold()),
@@ -98,6 +100,14 @@ OrderBy::OrderBy(
       data_->estimatedNumRowsPerBatch(kBatchSizeInBytes));
 }
 
+// static
+bool OrderBy::isParallelSort(
+    const core::OrderByNode& orderByNode,
+    const core::QueryConfig& queryConfig) {
+  return !orderByNode.isPartial() && queryConfig.orderByParallelSortEnabled() &&
+      !(queryConfig.spillEnabled() && queryConfig.orderBySpillEnabled());
+}
+
 void OrderBy::addInput(RowVectorPtr input) {
   ensureInputFits(input);
 
@@ -115,6 +125,7 @@ void OrderBy::addInput(RowVectorPtr input) {
   }
 
   numRows_ += allRows.size();
+  setRowContainerMemoryBreakdown(*data_);
   if (spiller_ != nullptr) {
     const auto spillStats = spiller_->stats();
     auto lockedStats = stats_.wlock();
@@ -223,7 +234,8 @@ void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig.maxFileSize,
         spillConfig.minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig.executor);
+        spillConfig.executor,
+        spillConfig.compressionType);
     VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
   }
   spiller_->spill(targetRows, targetBytes);
@@ -233,7 +245,7 @@ void OrderBy::noMoreInput() {
   Operator::noMoreInput();
 
   // No data.
-  if (numRows_ == 0) {
+  if (numRows_ == 0 && !parallelSort_) {
     finished_ = true;
     return;
   }
@@ -245,18 +257,10 @@ void OrderBy::noMoreInput() {
     returningRows_.resize(numRows_);
     RowContainerIterator iter;
     data_->listRows(&iter, numRows_, returningRows_.data());
-    std::sort(
-        returningRows_.begin(),
-        returningRows_.end(),
-        [this](const char* leftRow, const char* rightRow) {
-          for (vector_size_t index = 0; index < numSortKeys_; ++index) {
-            if (auto result = data_->compare(
-                    leftRow, rightRow, index, keyCompareFlags_[index])) {
-              return result < 0;
-            }
-          }
-          return false;
-        });
+    PrefixSort::sort(
+        data_.get(),
+        keyCompareFlags_,
+        folly::Range<char**>(returningRows_.data(), returningRows_.size()));
 
   } else {
     // Finish spill, and we shouldn't get any rows from non-spilled partition as
@@ -269,6 +273,76 @@ void OrderBy::noMoreInput() {
     spillSources_.resize(outputBatchSize_);
     spillSourceRows_.resize(outputBatchSize_);
   }
+
+  if (parallelSort_) {
+    startMerge();
+  }
+}
+
+void OrderBy::startMerge() {
+  VELOX_CHECK_NULL(spiller_);
+
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last Driver to finish input takes over the sorted rows of all the
+  // Drivers. allPeersFinished is true only for the last Driver of the
+  // pipeline.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+
+  std::vector<OrderBy*> sources;
+  if (numRows_ > 0) {
+    sources.push_back(this);
+  }
+  for (auto& peer : peers) {
+    auto* orderBy = dynamic_cast<OrderBy*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(orderBy);
+    if (orderBy->numRows_ > 0) {
+      sources.push_back(orderBy);
+    }
+    // The rows of the peer are returned by this Driver.
+    orderBy->finished_ = true;
+  }
+
+  // All the RowContainers have the same row layout, so 'data_' can compare and
+  // extract the rows of the peers.
+  std::vector<std::unique_ptr<SortedRowStream>> streams;
+  size_t numRows = 0;
+  for (auto* source : sources) {
+    numRows += source->numRows_;
+    if (source == this) {
+      if (sources.size() > 1) {
+        streams.push_back(std::make_unique<SortedRowStream>(
+            data_.get(), std::move(returningRows_), keyCompareFlags_));
+      }
+      continue;
+    }
+    peerData_.push_back(std::move(source->data_));
+    if (sources.size() == 1) {
+      returningRows_ = std::move(source->returningRows_);
+    } else {
+      streams.push_back(std::make_unique<SortedRowStream>(
+          data_.get(), std::move(source->returningRows_), keyCompareFlags_));
+    }
+  }
+  numRows_ = numRows;
+  if (numRows_ == 0) {
+    finished_ = true;
+  } else if (!streams.empty()) {
+    sortMerge_ =
+        std::make_unique<TreeOfLosers<SortedRowStream>>(std::move(streams));
+    returningRows_.clear();
+    returningRows_.resize(outputBatchSize_);
+  }
+
+  // Realize the promises so that the other Drivers (which were not
+  // the last to finish) can continue from the barrier and finish.
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
 }
 
 RowVectorPtr OrderBy::getOutput() {
@@ -279,6 +353,8 @@ RowVectorPtr OrderBy::getOutput() {
 
   if (spiller_ != nullptr) {
     getOutputWithSpill();
+  } else if (sortMerge_ != nullptr) {
+    getOutputWithMerge();
   } else {
     getOutputWithoutSpill();
   }
@@ -355,6 +431,27 @@ void OrderBy::getOutputWithSpill() {
   numRowsReturned_ += output_->size();
 }
 
+void OrderBy::getOutputWithMerge() {
+  VELOX_DCHECK(!finished_);
+  VELOX_DCHECK_EQ(returningRows_.size(), outputBatchSize_);
+
+  const auto numOutput = output_->size();
+  for (auto i = 0; i < numOutput; ++i) {
+    SortedRowStream* stream = sortMerge_->next();
+    VELOX_CHECK_NOT_NULL(stream);
+    returningRows_[i] = stream->current();
+    stream->pop();
+  }
+  for (const auto& columnProjection : columnMap_) {
+    data_->extractColumn(
+        returningRows_.data(),
+        numOutput,
+        columnProjection.inputChannel,
+        output_->childAt(columnProjection.outputChannel));
+  }
+  numRowsReturned_ += numOutput;
+}
+
 void OrderBy::prepareOutput() {
   VELOX_CHECK_GT(numRows_, numRowsReturned_);
 
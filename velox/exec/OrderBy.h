@@ -22,12 +22,61 @@
 
 namespace facebook::velox::exec {
 
+/// A sorted run of the rows of a RowContainer. Used by a parallel OrderBy
+/// to merge the sorted rows of all its drivers without copying them out of
+/// their RowContainers.
+class SortedRowStream : public MergeStream {
+ public:
+  SortedRowStream(
+      RowContainer* FOLLY_NONNULL container,
+      std::vector<char*> rows,
+      const std::vector<CompareFlags>& compareFlags)
+      : container_(container),
+        rows_(std::move(rows)),
+        compareFlags_(compareFlags) {}
+
+  bool hasData() const override {
+    return index_ < rows_.size();
+  }
+
+  bool operator<(const MergeStream& other) const override {
+    return compare(other) < 0;
+  }
+
+  // The RowContainers of all the streams of a merge have the same row layout
+  // so that the rows of 'other' can be compared by 'container_'.
+  int32_t compare(const MergeStream& other) const override {
+    return container_->compareRows(
+        current(),
+        static_cast<const SortedRowStream&>(other).current(),
+        compareFlags_);
+  }
+
+  char* FOLLY_NONNULL current() const {
+    return rows_[index_];
+  }
+
+  void pop() {
+    ++index_;
+  }
+
+ private:
+  RowContainer* const FOLLY_NONNULL container_;
+  const std::vector<char*> rows_;
+  const std::vector<CompareFlags>& compareFlags_;
+  size_t index_{0};
+};
+
 /// OrderBy operator implementation: OrderBy stores all its inputs in a
 /// RowContainer as the inputs are added. Until all inputs are available,
 /// it blocks the pipeline. Once all inputs are available, it sorts pointers
 /// to the rows using the RowContainer's compare() function. And finally it
 /// constructs and returns the sorted output RowVector using the data in the
 /// RowContainer.
+/// With parallel sort, a final OrderBy runs on multiple drivers. Each driver
+/// sorts its share of the input and the last driver to finish input takes
+/// over the RowContainers of the other drivers and merges their sorted rows
+/// into the output.
 /// Limitations:
 /// * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 /// output.
@@ -38,6 +87,12 @@ class OrderBy : public Operator {
       DriverCtx* FOLLY_NONNULL driverCtx,
       const std::shared_ptr<const core::OrderByNode>& orderByNode);
 
+  /// Returns true if 'orderByNode' is a final order by which sorts in
+  /// parallel on multiple drivers with 'queryConfig'.
+  static bool isParallelSort(
+      const core::OrderByNode& orderByNode,
+      const core::QueryConfig& queryConfig);
+
   bool needsInput() const override {
     return !finished_;
   }
@@ -48,7 +103,11 @@ class OrderBy : public Operator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* FOLLY_NULLABLE /*future*/) override {
+  BlockingReason isBlocked(ContinueFuture* FOLLY_NONNULL future) override {
+    if (future_.valid()) {
+      *future = std::move(future_);
+      return BlockingReason::kWaitForSortMerge;
+    }
     return BlockingReason::kNotBlocked;
   }
 
@@ -70,6 +129,13 @@ class OrderBy : public Operator {
 
   void getOutputWithoutSpill();
   void getOutputWithSpill();
+  void getOutputWithMerge();
+
+  // Invoked by a parallel sort after sorting the rows of this driver. The last
+  // driver to finish input takes over the sorted rows of all the drivers and
+  // sets up 'sortMerge_' to merge them. The other drivers wait for the last
+  // one and finish without output.
+  void startMerge();
 
   // Spills content until under 'targetRows' and under 'targetBytes' of out of
   // line data are left. If 'targetRows' is 0, spills everything and physically
@@ -82,6 +148,9 @@ class OrderBy : public Operator {
 
   const int32_t numSortKeys_;
 
+  // True if this is a final order by which runs on multiple drivers.
+  const bool parallelSort_;
+
   // The maximum memory usage that an order by can hold before spilling.
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
@@ -131,6 +200,16 @@ class OrderBy : public Operator {
   std::vector<const RowVector*> spillSources_;
   std::vector<vector_size_t> spillSourceRows_;
 
+  // The RowContainers taken over from the peer drivers by a parallel sort.
+  std::vector<std::unique_ptr<RowContainer>> peerData_;
+
+  // Set by the last driver of a parallel sort to merge the sorted rows of all
+  // the drivers.
+  std::unique_ptr<TreeOfLosers<SortedRowStream>> sortMerge_;
+
+  // Future for synchronizing with the peer drivers of a parallel sort.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+
   bool finished_ = false;
 };
 } // namespace facebook::velox::exec
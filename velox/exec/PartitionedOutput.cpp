@@ -37,14 +37,15 @@ BlockingReason Destination::advance(
     return flush(bufferManager, future);
   }
   auto firstRow = row_;
+  vector_size_t numRows = 0;
   for (; row_ < rows_.size(); ++row_) {
     // TODO Add support for serializing partial ranges if
     //  the full range is too big
     for (vector_size_t i = 0; i < rows_[row_].size; i++) {
       bytesInCurrent_ += sizes[rows_[row_].begin + i];
     }
-    if (bytesInCurrent_ >= adjustedMaxBytes ||
-        row_ - firstRow >= targetNumRows_) {
+    numRows += rows_[row_].size;
+    if (bytesInCurrent_ >= adjustedMaxBytes || numRows > targetNumRows_) {
       serialize(output, firstRow, row_ + 1);
       if (row_ == rows_.size() - 1) {
         *atEnd = true;
@@ -69,7 +70,7 @@ void Destination::serialize(
     for (vector_size_t i = begin; i < end; i++) {
       numRows += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
+    current_->createStreamTree(rowType, numRows, &serdeOptions_);
   }
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
@@ -112,6 +113,7 @@ PartitionedOutput::PartitionedOutput(
       keyChannels_(toChannels(planNode->inputType(), planNode->keys())),
       numDestinations_(planNode->numPartitions()),
       replicateNullsAndAny_(planNode->isReplicateNullsAndAny()),
+      rebalanceSkew_(planNode->isRebalanceSkew()),
       partitionFunction_(
           numDestinations_ == 1
               ? nullptr
@@ -124,7 +126,9 @@ PartitionedOutput::PartitionedOutput(
       maxBufferedBytes_(ctx->task->queryCtx()
                             ->queryConfig()
                             .maxPartitionedOutputBufferSize()),
-      mappedMemory_{operatorCtx_->mappedMemory()} {
+      mappedMemory_{operatorCtx_->mappedMemory()},
+      serdeOptions_(
+          exchangeSerdeOptions(ctx->task->queryCtx()->queryConfig())) {
   if (numDestinations_ == 1 || planNode->isBroadcast()) {
     VELOX_CHECK(keyChannels_.empty());
     VELOX_CHECK_NULL(partitionFunction_);
@@ -156,8 +160,8 @@ void PartitionedOutput::initializeDestinations() {
   if (destinations_.empty()) {
     auto taskId = operatorCtx_->taskId();
     for (int i = 0; i < numDestinations_; ++i) {
-      destinations_.push_back(
-          std::make_unique<Destination>(taskId, i, mappedMemory_));
+      destinations_.push_back(std::make_unique<Destination>(
+          taskId, i, mappedMemory_, serdeOptions_));
     }
   }
 }
@@ -237,13 +241,91 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
         }
       }
     } else {
-      for (vector_size_t i = 0; i < numInput; ++i) {
-        destinations_[partitions_[i]]->addRow(i);
+      if (rebalanceSkew_) {
+        rebalanceSkewedPartitions();
       }
+      addPartitionedRows();
     }
   }
 }
 
+void PartitionedOutput::rebalanceSkewedPartitions() {
+  const auto numInput = input_->size();
+  if (partitionBytes_.empty()) {
+    partitionBytes_.resize(numDestinations_, 0);
+    partitionFanout_.resize(numDestinations_, 1);
+    nextFanoutDestination_.resize(numDestinations_, 0);
+  }
+  for (vector_size_t i = 0; i < numInput; ++i) {
+    partitionBytes_[partitions_[i]] += rowSize_[i];
+    totalPartitionBytes_ += rowSize_[i];
+  }
+  if (totalPartitionBytes_ < kMinSkewBytes) {
+    return;
+  }
+
+  const int64_t averageBytes =
+      std::max<int64_t>(1, totalPartitionBytes_ / numDestinations_);
+  int64_t numNewSkewed = 0;
+  for (auto i = 0; i < numDestinations_; ++i) {
+    if (partitionBytes_[i] <= kSkewFactor * averageBytes) {
+      continue;
+    }
+    // Spreads the partition so that each of its destinations gets about the
+    // average. The fanout only grows, so that the spread stays stable.
+    const int32_t fanout =
+        std::min<int64_t>(numDestinations_, partitionBytes_[i] / averageBytes);
+    if (fanout > partitionFanout_[i]) {
+      numNewSkewed += partitionFanout_[i] == 1;
+      partitionFanout_[i] = fanout;
+    }
+  }
+  if (numNewSkewed > 0) {
+    addRuntimeStat("skewedPartitions", RuntimeCounter(numNewSkewed));
+  }
+
+  int64_t numRebalancedRows = 0;
+  for (vector_size_t i = 0; i < numInput; ++i) {
+    const auto partition = partitions_[i];
+    const auto fanout = partitionFanout_[partition];
+    if (fanout == 1) {
+      continue;
+    }
+    auto& position = nextFanoutDestination_[partition];
+    partitions_[i] = (partition + position) % numDestinations_;
+    position = position + 1 == fanout ? 0 : position + 1;
+    ++numRebalancedRows;
+  }
+  if (numRebalancedRows > 0) {
+    addRuntimeStat("rebalancedRows", RuntimeCounter(numRebalancedRows));
+  }
+}
+
+void PartitionedOutput::addPartitionedRows() {
+  const auto numInput = input_->size();
+  partitionEnds_.assign(numDestinations_, 0);
+  for (vector_size_t i = 0; i < numInput; ++i) {
+    ++partitionEnds_[partitions_[i]];
+  }
+  // Sets each entry to the start of its partition. The scatter below moves it
+  // to the end.
+  vector_size_t end = 0;
+  for (auto& count : partitionEnds_) {
+    end += count;
+    count = end - count;
+  }
+  partitionedRows_.resize(numInput);
+  for (vector_size_t i = 0; i < numInput; ++i) {
+    partitionedRows_[partitionEnds_[partitions_[i]]++] = i;
+  }
+  vector_size_t begin = 0;
+  for (auto i = 0; i < numDestinations_; ++i) {
+    destinations_[i]->addRows(folly::Range<const vector_size_t*>(
+        partitionedRows_.data() + begin, partitionEnds_[i] - begin));
+    begin = partitionEnds_[i];
+  }
+}
+
 void PartitionedOutput::collectNullRows() {
   auto size = input_->size();
   rows_.resize(size);
@@ -18,6 +18,7 @@
 #include <folly/Random.h>
 #include "velox/exec/Operator.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/serializers/PrestoSerializer.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
@@ -27,8 +28,13 @@ class Destination {
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MappedMemory* FOLLY_NONNULL memory)
-      : taskId_(taskId), destination_(destination), memory_(memory) {
+      memory::MappedMemory* FOLLY_NONNULL memory,
+      const serializer::presto::PrestoVectorSerde::PrestoOptions&
+          serdeOptions = {})
+      : taskId_(taskId),
+        destination_(destination),
+        memory_(memory),
+        serdeOptions_(serdeOptions) {
     setTargetSizePct();
   }
 
@@ -46,6 +52,18 @@ class Destination {
     rows_.push_back(rows);
   }
 
+  // Adds 'rows', which are in ascending order. Runs of consecutive rows are
+  // added as one range, so that they are serialized together.
+  void addRows(folly::Range<const vector_size_t*> rows) {
+    for (auto row : rows) {
+      if (!rows_.empty() && rows_.back().begin + rows_.back().size == row) {
+        ++rows_.back().size;
+      } else {
+        rows_.push_back(IndexRange{row, 1});
+      }
+    }
+  }
+
   BlockingReason advance(
       uint64_t maxBytes,
       const std::vector<vector_size_t>& sizes,
@@ -90,6 +108,9 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MappedMemory* FOLLY_NONNULL const memory_;
+  // Per destination, so that the pages of each destination adapt their
+  // compression on their own.
+  serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
   uint64_t bytesInCurrent_{0};
   std::vector<IndexRange> rows_;
 
@@ -126,6 +147,14 @@ class PartitionedOutput : public Operator {
   // network MTU of 64K.
   static constexpr uint64_t kMinDestinationSize = 60 * 1024;
 
+  // With skew rebalancing, a partition is spread over several destinations
+  // once it has received more than this many times the average bytes per
+  // destination.
+  static constexpr int32_t kSkewFactor = 2;
+
+  // Skew is not acted upon before this many bytes have been partitioned.
+  static constexpr int64_t kMinSkewBytes = 1 << 20;
+
   PartitionedOutput(
       int32_t operatorId,
       DriverCtx* FOLLY_NONNULL ctx,
@@ -171,9 +200,20 @@ class PartitionedOutput : public Operator {
   /// Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
+  /// Adds the rows of each partition in 'partitions_' to its destination. The
+  /// rows are counting sorted by partition, so that each destination gets its
+  /// rows with one call.
+  void addPartitionedRows();
+
+  /// Updates the bytes per partition with the rows in 'partitions_' and sends
+  /// the rows of skewed partitions round-robin to the destinations following
+  /// the partition's own.
+  void rebalanceSkewedPartitions();
+
   const std::vector<column_index_t> keyChannels_;
   const int numDestinations_;
   const bool replicateNullsAndAny_;
+  const bool rebalanceSkew_;
   std::unique_ptr<core::PartitionFunction> partitionFunction_;
   // Empty if column order in the output is exactly the same as in input.
   const std::vector<column_index_t> outputChannels_;
@@ -191,12 +231,26 @@ class PartitionedOutput : public Operator {
   std::weak_ptr<exec::PartitionedOutputBufferManager> bufferManager_;
   const int64_t maxBufferedBytes_;
   memory::MappedMemory* FOLLY_NONNULL mappedMemory_;
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
   RowVectorPtr output_;
 
   // Reusable memory.
   SelectivityVector rows_;
   SelectivityVector nullRows_;
   std::vector<uint32_t> partitions_;
+  // Row numbers of the input sorted by partition and the end of the rows of
+  // each partition in it.
+  std::vector<vector_size_t> partitionedRows_;
+  std::vector<vector_size_t> partitionEnds_;
+
+  // Estimated bytes of the rows of each partition so far, with skew
+  // rebalancing.
+  std::vector<int64_t> partitionBytes_;
+  int64_t totalPartitionBytes_{0};
+  // Number of destinations the rows of each partition are spread over and
+  // the position of the next row in this round-robin.
+  std::vector<int32_t> partitionFanout_;
+  std::vector<int32_t> nextFanoutDestination_;
   std::vector<DecodedVector> decodedVectors_;
 };
 
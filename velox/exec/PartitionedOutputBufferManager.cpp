@@ -487,6 +487,10 @@ uint64_t PartitionedOutputBufferManager::numBuffers() const {
   return buffers_.lock()->size();
 }
 
+bool PartitionedOutputBufferManager::hasTask(const std::string& taskId) const {
+  return buffers_.lock()->count(taskId) > 0;
+}
+
 BlockingReason PartitionedOutputBufferManager::enqueue(
     const std::string& taskId,
     int destination,
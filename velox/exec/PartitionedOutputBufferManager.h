@@ -248,6 +248,10 @@ class PartitionedOutputBufferManager {
 
   uint64_t numBuffers() const;
 
+  // Returns true if the output buffers of 'taskId' are in 'this', i.e. the
+  // task runs in this process and has not been removed.
+  bool hasTask(const std::string& taskId) const;
+
   // Returns a new stream listener if a listener factory has been set.
   std::unique_ptr<OutputStreamListener> newListener() const {
     return listenerFactory_ ? listenerFactory_() : nullptr;
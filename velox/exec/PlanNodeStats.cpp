@@ -142,11 +142,15 @@ folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats) {
       stat["outputVectors"] = operatorStat.second->outputVectors;
       stat["outputBytes"] = operatorStat.second->outputBytes;
       stat["cpuWallTiming"] = operatorStat.second->cpuWallTiming.toString();
+      stat["cpuNanos"] = operatorStat.second->cpuWallTiming.cpuNanos;
+      stat["wallNanos"] = operatorStat.second->cpuWallTiming.wallNanos;
       stat["blockedWallNanos"] = operatorStat.second->blockedWallNanos;
       stat["peakMemoryBytes"] = operatorStat.second->peakMemoryBytes;
       stat["numMemoryAllocations"] = operatorStat.second->numMemoryAllocations;
       stat["numDrivers"] = operatorStat.second->numDrivers;
       stat["numSplits"] = operatorStat.second->numSplits;
+      stat["spilledBytes"] = operatorStat.second->spilledBytes;
+      stat["spilledRows"] = operatorStat.second->spilledRows;
 
       folly::dynamic cs = folly::dynamic::object;
       for (const auto& cstat : operatorStat.second->customStats) {
@@ -160,6 +164,40 @@ folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats) {
   return jsonStats;
 }
 
+folly::dynamic toChromeTrace(const TaskStats& stats) {
+  folly::dynamic events = folly::dynamic::array;
+  for (const auto& event : stats.traceEvents) {
+    folly::dynamic traceEvent = folly::dynamic::object;
+    switch (event.kind) {
+      case DriverTraceEvent::Kind::kRun:
+        traceEvent["name"] = "run";
+        traceEvent["cat"] = "run";
+        break;
+      case DriverTraceEvent::Kind::kQueued:
+        traceEvent["name"] = "queued";
+        traceEvent["cat"] = "queued";
+        break;
+      case DriverTraceEvent::Kind::kBlocked:
+        traceEvent["name"] = blockingReasonToString(event.reason);
+        traceEvent["cat"] = "blocked";
+        break;
+    }
+    // Complete events with a duration.
+    traceEvent["ph"] = "X";
+    traceEvent["ts"] = event.startMicros;
+    traceEvent["dur"] = event.endMicros > event.startMicros
+        ? event.endMicros - event.startMicros
+        : 0;
+    traceEvent["pid"] = event.pipelineId;
+    traceEvent["tid"] = event.driverId;
+    events.push_back(traceEvent);
+  }
+  folly::dynamic trace = folly::dynamic::object;
+  trace["traceEvents"] = events;
+  trace["displayTimeUnit"] = "ms";
+  return trace;
+}
+
 namespace {
 void printCustomStats(
     const std::unordered_map<std::string, RuntimeMetric>& stats,
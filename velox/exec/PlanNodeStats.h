@@ -129,6 +129,13 @@ std::unordered_map<core::PlanNodeId, PlanNodeStats> toPlanStats(
 
 folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats);
 
+/// Returns the TaskStats::traceEvents in the Chrome trace event format, to be
+/// written as JSON with folly::toJson() and opened in chrome://tracing or
+/// Perfetto. Each pipeline is a process and each Driver a thread. Shows
+/// whether the Drivers spend their time running, waiting for a thread of the
+/// executor or blocked, and on what.
+folly::dynamic toChromeTrace(const TaskStats& stats);
+
 /// Returns human-friendly representation of the plan augmented with runtime
 /// statistics. The result has the same plan representation as in
 /// PlanNode::toString(true, true), but each plan node includes an additional
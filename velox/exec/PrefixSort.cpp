@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/PrefixSort.h"
+
+namespace facebook::velox::exec {
+namespace {
+// Returns the number of bytes of the normalized encoding of a non-null value
+// of 'kind', or 0 if 'kind' can't be encoded.
+int32_t encodedSize(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+      return 4;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+      return 8;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return StringView::kPrefixSize;
+    default:
+      return 0;
+  }
+}
+
+bool isStringKind(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+template <typename T>
+inline T valueAt(const char* row, int32_t offset) {
+  return *reinterpret_cast<const T*>(row + offset);
+}
+
+// Writes the 'size' low bytes of 'value' to 'out' with the most significant
+// byte first so that memcmp on the result orders as the unsigned value.
+inline void writeBigEndian(uint64_t value, int32_t size, char* out) {
+  for (auto i = size - 1; i >= 0; --i) {
+    out[i] = static_cast<char>(value & 0xff);
+    value >>= 8;
+  }
+}
+
+// Maps a signed integer to an unsigned one with the same order.
+template <typename T>
+inline uint64_t encodeSigned(T value) {
+  using U = std::make_unsigned_t<T>;
+  return static_cast<U>(value) ^ (static_cast<U>(1) << (sizeof(T) * 8 - 1));
+}
+
+// Maps a floating point value to an unsigned integer with the same order as
+// RowContainer::comparePrimitiveAsc(): -0.0 equals 0.0 and all NaNs are equal
+// and larger than any other value.
+template <typename T, typename U>
+inline uint64_t encodeFloat(T value) {
+  if (std::isnan(value)) {
+    value = std::numeric_limits<T>::quiet_NaN();
+  } else if (value == 0) {
+    value = 0;
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(T));
+  constexpr U kSignBit = static_cast<U>(1) << (sizeof(U) * 8 - 1);
+  return (bits & kSignBit) ? ~bits : bits | kSignBit;
+}
+
+void encodeValue(TypeKind kind, const char* row, int32_t offset, char* out) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      out[0] = valueAt<bool>(row, offset) ? 1 : 0;
+      break;
+    case TypeKind::TINYINT:
+      writeBigEndian(encodeSigned(valueAt<int8_t>(row, offset)), 1, out);
+      break;
+    case TypeKind::SMALLINT:
+      writeBigEndian(encodeSigned(valueAt<int16_t>(row, offset)), 2, out);
+      break;
+    case TypeKind::INTEGER:
+      writeBigEndian(encodeSigned(valueAt<int32_t>(row, offset)), 4, out);
+      break;
+    case TypeKind::BIGINT:
+      writeBigEndian(encodeSigned(valueAt<int64_t>(row, offset)), 8, out);
+      break;
+    case TypeKind::REAL:
+      writeBigEndian(
+          encodeFloat<float, uint32_t>(valueAt<float>(row, offset)), 4, out);
+      break;
+    case TypeKind::DOUBLE:
+      writeBigEndian(
+          encodeFloat<double, uint64_t>(valueAt<double>(row, offset)), 8, out);
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY: {
+      // The inline prefix of a StringView is zero padded, so a shorter string
+      // never encodes larger than a longer one it is a prefix of.
+      const auto prefix = valueAt<StringView>(row, offset).prefixAsInt();
+      memcpy(out, &prefix, StringView::kPrefixSize);
+      break;
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+struct PrefixEntry {
+  char prefix[PrefixSort::kMaxPrefixBytes];
+  char* row;
+};
+} // namespace
+
+// static
+std::pair<int32_t, int32_t> PrefixSort::prefixLayout(
+    const std::vector<TypePtr>& keyTypes) {
+  int32_t numKeys = 0;
+  int32_t numBytes = 0;
+  for (const auto& type : keyTypes) {
+    const auto size = encodedSize(type->kind());
+    // One byte for the null flag.
+    if (size == 0 || numBytes + 1 + size > kMaxPrefixBytes) {
+      break;
+    }
+    ++numKeys;
+    numBytes += 1 + size;
+    if (isStringKind(type->kind())) {
+      break;
+    }
+  }
+  return {numKeys, numBytes};
+}
+
+// static
+void PrefixSort::sort(
+    RowContainer* rowContainer,
+    const std::vector<CompareFlags>& compareFlags,
+    folly::Range<char**> rows) {
+  const auto& keyTypes = rowContainer->keyTypes();
+  const int32_t numKeys = keyTypes.size();
+  VELOX_DCHECK(compareFlags.empty() || compareFlags.size() == numKeys);
+  auto flagsAt = [&](int32_t key) {
+    return compareFlags.empty() ? CompareFlags() : compareFlags[key];
+  };
+
+  const auto layout = prefixLayout(keyTypes);
+  const int32_t numPrefixKeys = layout.first;
+  const int32_t prefixBytes = layout.second;
+  // The first key which is not fully encoded in the prefix.
+  int32_t tieBreakKey = numPrefixKeys;
+  if (numPrefixKeys > 0 && isStringKind(keyTypes[numPrefixKeys - 1]->kind())) {
+    --tieBreakKey;
+  }
+  auto compareFrom = [&](const char* left, const char* right, int32_t key) {
+    for (; key < numKeys; ++key) {
+      if (auto result = rowContainer->compare(left, right, key, flagsAt(key))) {
+        return result;
+      }
+    }
+    return 0;
+  };
+
+  if (numPrefixKeys == 0) {
+    std::sort(
+        rows.begin(), rows.end(), [&](const char* left, const char* right) {
+          return compareFrom(left, right, 0) < 0;
+        });
+    return;
+  }
+
+  std::vector<PrefixEntry> entries(rows.size());
+  for (auto i = 0; i < rows.size(); ++i) {
+    auto& entry = entries[i];
+    entry.row = rows[i];
+    char* out = entry.prefix;
+    for (auto key = 0; key < numPrefixKeys; ++key) {
+      const auto kind = keyTypes[key]->kind();
+      const auto size = encodedSize(kind);
+      const auto flags = flagsAt(key);
+      const auto column = rowContainer->columnAt(key);
+      const bool isNull = RowContainer::isNullAt(
+          rows[i], column.nullByte(), column.nullMask());
+      // Nulls sort before or after all the values depending on 'nullsFirst'
+      // but not on the sort direction.
+      out[0] = isNull == flags.nullsFirst ? 0 : 1;
+      if (isNull) {
+        memset(out + 1, 0, size);
+      } else {
+        encodeValue(kind, rows[i], column.offset(), out + 1);
+        if (!flags.ascending) {
+          for (auto j = 1; j <= size; ++j) {
+            out[j] = ~out[j];
+          }
+        }
+      }
+      out += 1 + size;
+    }
+  }
+
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [&](const PrefixEntry& left, const PrefixEntry& right) {
+        if (auto result = memcmp(left.prefix, right.prefix, prefixBytes)) {
+          return result < 0;
+        }
+        return compareFrom(left.row, right.row, tieBreakKey) < 0;
+      });
+  for (auto i = 0; i < rows.size(); ++i) {
+    rows[i] = entries[i].row;
+  }
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Sorts pointers to the rows of a RowContainer on the container keys using
+/// normalized key prefixes. The leading keys are encoded into a fixed-width,
+/// order-preserving binary prefix per row which takes the null ordering and
+/// the sort direction into account, so most comparisons are a single memcmp
+/// instead of a type-dispatched compare per key. The rows with equal prefixes
+/// are ordered by comparing the keys which are not fully encoded in the
+/// prefix using RowContainer::compare().
+///
+/// BOOLEAN, TINYINT, SMALLINT, INTEGER, BIGINT, REAL and DOUBLE keys are
+/// fully encoded. A VARCHAR or VARBINARY key contributes its first 4 bytes and
+/// ends the prefix. The prefix ends at the first key of any other type.
+class PrefixSort {
+ public:
+  /// The max number of bytes of the normalized prefix of a row.
+  static constexpr int32_t kMaxPrefixBytes = 24;
+
+  /// Sorts 'rows' of 'rowContainer' on its keys with 'compareFlags'. If
+  /// 'compareFlags' is empty, the default CompareFlags are used for each key.
+  static void sort(
+      RowContainer* FOLLY_NONNULL rowContainer,
+      const std::vector<CompareFlags>& compareFlags,
+      folly::Range<char**> rows);
+
+  /// Returns the number of the leading keys of 'keyTypes' which are encoded
+  /// in the normalized prefix and the total prefix size in bytes.
+  static std::pair<int32_t, int32_t> prefixLayout(
+      const std::vector<TypePtr>& keyTypes);
+};
+} // namespace facebook::velox::exec
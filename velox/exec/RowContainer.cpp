@@ -43,6 +43,28 @@ setBit(char* bits, uint32_t idx) {
   auto bitsAs8Bit = reinterpret_cast<uint8_t*>(bits);
   bitsAs8Bit[idx / 8] |= (1 << (idx % 8));
 }
+
+// Returns true if the serialization 'value' of a complex type is inline or
+// out of line in a single piece.
+bool isContiguous(StringView value) {
+  return value.isInline() ||
+      reinterpret_cast<const HashStringAllocator::Header*>(value.data())[-1]
+              .size() >= value.size();
+}
+
+// Returns true if 'type' has a REAL or DOUBLE at any level. NaNs of these do
+// not compare equal to themselves, so that equal bytes are not equal values.
+bool hasFloatingPoint(const Type& type) {
+  if (type.kind() == TypeKind::REAL || type.kind() == TypeKind::DOUBLE) {
+    return true;
+  }
+  for (auto i = 0; i < type.size(); ++i) {
+    if (hasFloatingPoint(*type.childAt(i))) {
+      return true;
+    }
+  }
+  return false;
+}
 } // namespace
 
 RowContainer::RowContainer(
@@ -427,6 +449,18 @@ int32_t RowContainer::compareComplexType(
     CompareFlags flags) {
   VELOX_DCHECK(!flags.stopAtNull, "not supported compare flag");
 
+  // The serialization of a value is deterministic, so that values with the
+  // same bytes are equal. This is the common case when comparing keys of rows
+  // in the same hash table slot.
+  auto leftValue = valueAt<StringView>(left, offset);
+  auto rightValue = valueAt<StringView>(right, offset);
+  if (leftValue.size() == rightValue.size() && isContiguous(leftValue) &&
+      isContiguous(rightValue) &&
+      memcmp(leftValue.data(), rightValue.data(), leftValue.size()) == 0 &&
+      !hasFloatingPoint(*type)) {
+    return 0;
+  }
+
   ByteStream leftStream;
   ByteStream rightStream;
   prepareRead(left, offset, leftStream);
@@ -516,6 +550,113 @@ void RowContainer::clear() {
   firstFreeRow_ = nullptr;
 }
 
+namespace {
+// The header of a row block written by RowContainer::writeRowBlock().
+struct RowBlockHeader {
+  int32_t fixedRowSize;
+  // The distance between consecutive rows.
+  int32_t rowStride;
+  int64_t numRows;
+  // The size of the block including the header. A multiple of 8.
+  int64_t size;
+};
+
+static_assert(sizeof(StringView) == 16);
+
+// Sets the data pointer of a non-inlined StringView without reading the
+// data.
+void setStringViewData(StringView& view, const char* data) {
+  memcpy(
+      reinterpret_cast<char*>(&view) + sizeof(StringView) - sizeof(data),
+      &data,
+      sizeof(data));
+}
+} // namespace
+
+uint64_t RowContainer::writeRowBlock(
+    folly::Range<char**> rows,
+    WriteFile& file) const {
+  VELOX_CHECK(
+      !usesExternalMemory_,
+      "Row blocks can't have accumulators which use external memory");
+  const int32_t rowStride = bits::roundUp(fixedRowSize_, sizeof(int64_t));
+  const uint64_t fixedBytes =
+      sizeof(RowBlockHeader) + rows.size() * rowStride;
+  std::string block(fixedBytes, 0);
+  std::string variableBytes;
+  std::string storage;
+  for (auto i = 0; i < rows.size(); ++i) {
+    char* row = block.data() + sizeof(RowBlockHeader) + i * rowStride;
+    memcpy(row, rows[i], fixedRowSize_);
+    if (nextOffset_) {
+      *reinterpret_cast<char**>(row + nextOffset_) = nullptr;
+    }
+    forEachNonInlineString(row, [&](StringView& view) {
+      // Each value is preceded by a Header so that it reads as a single block
+      // of a HashStringAllocator, e.g. for deserializing complex types.
+      auto value = HashStringAllocator::contiguousString(view, storage);
+      HashStringAllocator::Header header(value.size());
+      const auto headerOffset = variableBytes.size();
+      variableBytes.resize(bits::roundUp(
+          headerOffset + sizeof(header) + value.size(), sizeof(header)));
+      memcpy(&variableBytes[headerOffset], &header, sizeof(header));
+      memcpy(
+          &variableBytes[headerOffset + sizeof(header)],
+          value.data(),
+          value.size());
+      setStringViewData(
+          view,
+          reinterpret_cast<const char*>(
+              fixedBytes + headerOffset + sizeof(header)));
+    });
+  }
+  variableBytes.resize(
+      bits::roundUp(fixedBytes + variableBytes.size(), sizeof(int64_t)) -
+      fixedBytes);
+
+  RowBlockHeader header;
+  header.fixedRowSize = fixedRowSize_;
+  header.rowStride = rowStride;
+  header.numRows = rows.size();
+  header.size = fixedBytes + variableBytes.size();
+  memcpy(block.data(), &header, sizeof(header));
+  file.append(block);
+  file.append(variableBytes);
+  return header.size;
+}
+
+void RowContainer::readRowBlocks(
+    char* data,
+    uint64_t size,
+    std::vector<char*>& rows) const {
+  VELOX_CHECK_EQ(
+      reinterpret_cast<uintptr_t>(data) % sizeof(int64_t),
+      0,
+      "Row blocks must be 8 byte aligned");
+  uint64_t offset = 0;
+  while (offset < size) {
+    VELOX_CHECK_LE(
+        offset + sizeof(RowBlockHeader), size, "Truncated row block");
+    char* block = data + offset;
+    RowBlockHeader header;
+    memcpy(&header, block, sizeof(header));
+    VELOX_CHECK_EQ(
+        header.fixedRowSize,
+        fixedRowSize_,
+        "Row block was written by a container with a different layout");
+    VELOX_CHECK_LE(offset + header.size, size, "Truncated row block");
+    for (auto i = 0; i < header.numRows; ++i) {
+      char* row = block + sizeof(RowBlockHeader) + i * header.rowStride;
+      forEachNonInlineString(row, [&](StringView& view) {
+        setStringViewData(
+            view, block + reinterpret_cast<uintptr_t>(view.data()));
+      });
+      rows.push_back(row);
+    }
+    offset += header.size;
+  }
+}
+
 void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
   for (auto i = 0; i < numRows; i++) {
     // Row may be null in case of a FULL join.
@@ -532,6 +532,25 @@ class RowContainer {
   // Resets the state to be as after construction. Frees memory for payload.
   void clear();
 
+  // Appends 'rows' to 'file' as a row block. A row block has a header, the
+  // fixed-width part of each row and then the variable-width values. The
+  // StringViews of the variable-width values are stored as offsets from the
+  // start of the block, so that readRowBlocks() can use the rows in place
+  // after fixing up the offsets. Normalized keys and next row pointers are
+  // not kept. The rows must not have accumulators which use external memory.
+  // Returns the number of bytes written.
+  uint64_t writeRowBlock(folly::Range<char**> rows, WriteFile& file) const;
+
+  // Fixes up in place the row blocks in the 'size' bytes at 'data', which
+  // were written by writeRowBlock() of a container with the same layout as
+  // 'this', and appends the rows to 'rows'. The rows can be read with the
+  // extract, compare and hash functions and the accumulators of 'this'.
+  // 'data' must be 8 byte aligned and outlive the use of the rows.
+  void readRowBlocks(
+      char* FOLLY_NONNULL data,
+      uint64_t size,
+      std::vector<char*>& rows) const;
+
   int32_t compareRows(
       const char* FOLLY_NONNULL left,
       const char* FOLLY_NONNULL right,
@@ -1023,6 +1042,32 @@ class RowContainer {
   // Free any aggregates associated with the 'rows'.
   void freeAggregates(folly::Range<char**> rows);
 
+  // Calls 'func' with the StringView of each non-null, variable-width value
+  // of 'row' which is not inlined.
+  template <typename Func>
+  void forEachNonInlineString(char* FOLLY_NONNULL row, Func func) const {
+    for (auto i = 0; i < typeKinds_.size(); ++i) {
+      if (!isVariableWidth(typeKinds_[i])) {
+        continue;
+      }
+      const auto column = rowColumns_[i];
+      if (column.nullMask() &&
+          isNullAt(row, column.nullByte(), column.nullMask())) {
+        continue;
+      }
+      auto* view = reinterpret_cast<StringView*>(row + column.offset());
+      if (!view->isInline()) {
+        func(*view);
+      }
+    }
+  }
+
+  static bool isVariableWidth(TypeKind kind) {
+    return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY ||
+        kind == TypeKind::ARRAY || kind == TypeKind::MAP ||
+        kind == TypeKind::ROW;
+  }
+
   const std::vector<TypePtr> keyTypes_;
   const bool nullableKeys_;
 
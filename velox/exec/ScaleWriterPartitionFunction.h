@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/core/PlanNode.h"
+
+namespace facebook::velox::exec {
+
+/// Sends whole batches round-robin to a number of partitions that grows with
+/// the data. Starts with one partition and adds the next one each time
+/// 'minBytesPerPartition' times the number of used partitions have been sent.
+/// Used in front of TableWriter, so that small writes produce few files while
+/// large writes use all writer drivers.
+class ScaleWriterPartitionFunction : public core::PartitionFunction {
+ public:
+  ScaleWriterPartitionFunction(int numPartitions, uint64_t minBytesPerPartition)
+      : numPartitions_{numPartitions},
+        minBytesPerPartition_{minBytesPerPartition} {}
+
+  ~ScaleWriterPartitionFunction() override = default;
+
+  void partition(const RowVector& input, std::vector<uint32_t>& partitions)
+      override {
+    const auto size = input.size();
+    partitions.resize(size);
+    std::fill(partitions.begin(), partitions.end(), counter_ % numActive_);
+    ++counter_;
+    bytes_ += input.estimateFlatSize();
+    if (numActive_ < numPartitions_ &&
+        bytes_ >= minBytesPerPartition_ * numActive_) {
+      ++numActive_;
+    }
+  }
+
+ private:
+  const int numPartitions_;
+  const uint64_t minBytesPerPartition_;
+  int numActive_{1};
+  uint32_t counter_{0};
+  uint64_t bytes_{0};
+};
+} // namespace facebook::velox::exec
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/SortedAggregate.h"
+
+#include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+
+// The input rows of a group, linked through the next pointers of the rows.
+struct RowList {
+  char* first{nullptr};
+  char* last{nullptr};
+  vector_size_t size{0};
+};
+
+class SortedAggregate : public Aggregate {
+ public:
+  SortedAggregate(
+      std::unique_ptr<Aggregate> aggregate,
+      const std::vector<TypePtr>& inputTypes,
+      const std::vector<CompareFlags>& sortingFlags)
+      : Aggregate(aggregate->resultType()),
+        aggregate_(std::move(aggregate)),
+        inputTypes_(inputTypes),
+        sortingFlags_(sortingFlags),
+        numArgs_(inputTypes.size() - sortingFlags.size()),
+        aggregateOffset_(bits::roundUp(
+            sizeof(RowList),
+            aggregate_->accumulatorAlignmentSize())) {
+    VELOX_CHECK_GT(inputTypes_.size(), sortingFlags_.size());
+    VELOX_CHECK(!sortingFlags_.empty());
+  }
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return aggregateOffset_ + aggregate_->accumulatorFixedWidthSize();
+  }
+
+  int32_t accumulatorAlignmentSize() const override {
+    return aggregate_->accumulatorAlignmentSize();
+  }
+
+  // The input rows are in 'inputs_' and must be freed in destroy().
+  bool accumulatorUsesExternalMemory() const override {
+    return true;
+  }
+
+  bool isFixedSize() const override {
+    return aggregate_->isFixedSize();
+  }
+
+  void setAllocator(HashStringAllocator* allocator) override {
+    Aggregate::setAllocator(allocator);
+    aggregate_->setAllocator(allocator);
+    inputs_ = std::make_unique<RowContainer>(
+        inputTypes_,
+        true, // nullableKeys
+        noAggregates_,
+        std::vector<TypePtr>{},
+        true, // hasNext
+        false, // isJoinBuild
+        false, // hasProbedFlag
+        false, // hasNormalizedKey
+        allocator->mappedMemory(),
+        ContainerRowSerde::instance());
+  }
+
+  void setOffsets(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      int32_t rowSizeOffset) override {
+    Aggregate::setOffsets(offset, nullByte, nullMask, rowSizeOffset);
+    // The accumulator of 'aggregate_' follows the row list. The null flag is
+    // only used by 'aggregate_'.
+    aggregate_->setOffsets(
+        offset + aggregateOffset_, nullByte, nullMask, rowSizeOffset);
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    for (auto index : indices) {
+      new (groups[index] + offset_) RowList();
+    }
+    aggregate_->initializeNewGroups(groups, indices);
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeInputs(rows, args);
+    rows.applyToSelected([&](vector_size_t row) {
+      addRow(groups[row], decodedInputs_, row);
+    });
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeInputs(rows, args);
+    rows.applyToSelected(
+        [&](vector_size_t row) { addRow(group, decodedInputs_, row); });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addArrays(rows, args[0], [&](vector_size_t row) { return groups[row]; });
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addArrays(rows, args[0], [&](vector_size_t /*row*/) { return group; });
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto arrays = (*result)->as<ArrayVector>();
+    VELOX_CHECK_NOT_NULL(arrays);
+    arrays->resize(numGroups);
+    collectRows(groups, numGroups, false);
+    auto elements = arrays->elements()->as<RowVector>();
+    VELOX_CHECK_NOT_NULL(elements);
+    elements->resize(groupRows_.size());
+    vector_size_t offset = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      const auto size = value<RowList>(groups[i])->size;
+      arrays->setNull(i, false);
+      arrays->setOffsetAndSize(i, offset, size);
+      offset += size;
+    }
+    for (auto column = 0; column < inputTypes_.size(); ++column) {
+      inputs_->extractColumn(
+          groupRows_.data(),
+          groupRows_.size(),
+          column,
+          elements->childAt(column));
+    }
+  }
+
+  // Sorts the rows of each group, adds them to 'aggregate_' in order and
+  // extracts its results.
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    collectRows(groups, numGroups, true);
+    const vector_size_t numRows = groupRows_.size();
+    if (numRows > 0) {
+      auto pool = (*result)->pool();
+      std::vector<VectorPtr> args(numArgs_);
+      for (auto i = 0; i < numArgs_; ++i) {
+        args[i] = BaseVector::create(inputTypes_[i], numRows, pool);
+        inputs_->extractColumn(groupRows_.data(), numRows, i, args[i]);
+      }
+      aggregate_->addRawInput(
+          rowGroups_.data(), SelectivityVector(numRows), args, false);
+    }
+    aggregate_->extractValues(groups, numGroups, result);
+  }
+
+  void destroy(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      auto list = value<RowList>(group);
+      groupRows_.clear();
+      for (auto row = list->first; row; row = nextRow(row)) {
+        groupRows_.push_back(row);
+      }
+      inputs_->eraseRows(
+          folly::Range<char**>(groupRows_.data(), groupRows_.size()));
+      std::destroy_at(list);
+    }
+    aggregate_->destroy(groups);
+  }
+
+ private:
+  char*& nextRow(char* row) const {
+    return *reinterpret_cast<char**>(row + inputs_->nextOffset());
+  }
+
+  void decodeInputs(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) {
+    decodedInputs_.resize(args.size());
+    for (auto i = 0; i < args.size(); ++i) {
+      decodedInputs_[i].decode(*args[i], rows);
+    }
+  }
+
+  // Appends a row with the values at 'index' in 'decoded' to the rows of
+  // 'group'.
+  void addRow(
+      char* group,
+      const std::vector<DecodedVector>& decoded,
+      vector_size_t index) {
+    auto row = inputs_->newRow();
+    for (auto i = 0; i < decoded.size(); ++i) {
+      inputs_->store(decoded[i], index, row, i);
+    }
+    nextRow(row) = nullptr;
+    auto list = value<RowList>(group);
+    if (list->last) {
+      nextRow(list->last) = row;
+    } else {
+      list->first = row;
+    }
+    list->last = row;
+    ++list->size;
+  }
+
+  // Adds the rows in the arrays of 'arg' to the groups given by 'groupAt'
+  // for each row.
+  template <typename GroupAt>
+  void addArrays(
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      GroupAt groupAt) {
+    decodedArrays_.decode(*arg, rows);
+    auto arrays = decodedArrays_.base()->template as<ArrayVector>();
+    VELOX_CHECK_NOT_NULL(arrays);
+    auto elements = arrays->elements()->template as<RowVector>();
+    VELOX_CHECK_NOT_NULL(elements);
+    decodedInputs_.resize(inputTypes_.size());
+    for (auto i = 0; i < inputTypes_.size(); ++i) {
+      decodedInputs_[i].decode(*elements->childAt(i));
+    }
+    rows.applyToSelected([&](vector_size_t row) {
+      if (decodedArrays_.isNullAt(row)) {
+        return;
+      }
+      auto group = groupAt(row);
+      const auto index = decodedArrays_.index(row);
+      const auto offset = arrays->offsetAt(index);
+      const auto size = arrays->sizeAt(index);
+      for (auto i = offset; i < offset + size; ++i) {
+        addRow(group, decodedInputs_, i);
+      }
+    });
+  }
+
+  // Fills 'groupRows_' with the rows of 'groups' and 'rowGroups_' with the
+  // group of each row. Sorts the rows within each group if 'sort' is true.
+  void collectRows(char** groups, int32_t numGroups, bool sort) {
+    groupRows_.clear();
+    rowGroups_.clear();
+    for (auto i = 0; i < numGroups; ++i) {
+      const auto start = groupRows_.size();
+      for (auto row = value<RowList>(groups[i])->first; row;
+           row = nextRow(row)) {
+        groupRows_.push_back(row);
+      }
+      rowGroups_.resize(groupRows_.size(), groups[i]);
+      if (sort) {
+        std::stable_sort(
+            groupRows_.begin() + start,
+            groupRows_.end(),
+            [&](const char* left, const char* right) {
+              return compareRows(left, right) < 0;
+            });
+      }
+    }
+  }
+
+  int32_t compareRows(const char* left, const char* right) const {
+    for (auto i = 0; i < sortingFlags_.size(); ++i) {
+      auto result =
+          inputs_->compare(left, right, numArgs_ + i, sortingFlags_[i]);
+      if (result != 0) {
+        return result;
+      }
+    }
+    return 0;
+  }
+
+  const std::unique_ptr<Aggregate> aggregate_;
+
+  // Types of the arguments of 'aggregate_' followed by the sorting keys.
+  const std::vector<TypePtr> inputTypes_;
+  const std::vector<CompareFlags> sortingFlags_;
+  const column_index_t numArgs_;
+
+  // Offset of the accumulator of 'aggregate_' from the row list.
+  const int32_t aggregateOffset_;
+
+  const std::vector<std::unique_ptr<Aggregate>> noAggregates_;
+
+  // The input rows of all groups. Created in setAllocator().
+  std::unique_ptr<RowContainer> inputs_;
+
+  std::vector<DecodedVector> decodedInputs_;
+  DecodedVector decodedArrays_;
+
+  // Rows of the groups being extracted and the group of each row.
+  std::vector<char*> groupRows_;
+  std::vector<char*> rowGroups_;
+};
+
+} // namespace
+
+std::unique_ptr<Aggregate> makeSortedAggregate(
+    std::unique_ptr<Aggregate> aggregate,
+    const std::vector<TypePtr>& inputTypes,
+    const std::vector<core::SortOrder>& sortingOrders) {
+  std::vector<CompareFlags> sortingFlags;
+  sortingFlags.reserve(sortingOrders.size());
+  for (const auto& order : sortingOrders) {
+    sortingFlags.push_back(
+        {order.isNullsFirst(), order.isAscending(), false, false});
+  }
+  return std::make_unique<SortedAggregate>(
+      std::move(aggregate), inputTypes, sortingFlags);
+}
+
+TypePtr sortedAggregateIntermediateType(
+    const std::vector<TypePtr>& inputTypes) {
+  std::vector<std::string> names;
+  for (auto i = 0; i < inputTypes.size(); ++i) {
+    names.push_back(fmt::format("c{}", i));
+  }
+  return ARRAY(ROW(std::move(names), std::vector<TypePtr>(inputTypes)));
+}
+
+} // namespace facebook::velox::exec
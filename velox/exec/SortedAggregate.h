@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "velox/exec/Aggregate.h"
+
+namespace facebook::velox::exec {
+
+/// Returns an aggregate that applies 'aggregate' to the input rows of each
+/// group sorted by sorting keys, e.g. for array_agg(x ORDER BY y).
+/// 'inputTypes' are the types of the arguments of 'aggregate' followed by
+/// the types of the sorting keys and 'sortingOrders' give the order for each
+/// sorting key. The input rows are buffered in a RowContainer, where the
+/// rows of each group form a linked list, and are sorted within the group
+/// when the final results are extracted. The intermediate results are arrays
+/// of the buffered rows, see sortedAggregateIntermediateType(), so that the
+/// sorted aggregate can be spilled and merged.
+std::unique_ptr<Aggregate> makeSortedAggregate(
+    std::unique_ptr<Aggregate> aggregate,
+    const std::vector<TypePtr>& inputTypes,
+    const std::vector<core::SortOrder>& sortingOrders);
+
+/// Returns the type of the intermediate results of a sorted aggregate over
+/// 'inputTypes'.
+TypePtr sortedAggregateIntermediateType(const std::vector<TypePtr>& inputTypes);
+
+} // namespace facebook::velox::exec
@@ -15,10 +15,30 @@
  */
 
 #include "velox/exec/Spill.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <folly/String.h>
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/serializers/PrestoSerializer.h"
 
+DEFINE_int64(
+    spill_memory_tier_mb,
+    0,
+    "Memory in MB for spill files of the process held in memory. A spill file "
+    "moves to disk when its writes do not fit. 0 writes all to disk.");
+
+DEFINE_int64(
+    spill_max_pending_write_mb,
+    0,
+    "If not 0, spill files are written on the spill executor and a spilling "
+    "operator continues while up to this many MB of serialized spill data per "
+    "partition are waiting to be written. 0 writes on the spilling thread.");
+
 namespace facebook::velox::exec {
 
 // Spilling currently uses the default PrestoSerializer which by default
@@ -31,7 +51,61 @@ static const serializer::presto::PrestoVectorSerde::PrestoOptions
 
 std::atomic<int32_t> SpillFile::ordinalCounter_;
 
+namespace {
+// The header of a compressed frame of a spill file.
+struct FrameHeader {
+  uint32_t uncompressedSize;
+  uint32_t compressedSize;
+};
+} // namespace
+
+// static
+SpillMemoryTier& SpillMemoryTier::instance() {
+  static SpillMemoryTier tier;
+  return tier;
+}
+
+bool SpillMemoryTier::tryReserve(uint64_t bytes) {
+  const uint64_t capacity = FLAGS_spill_memory_tier_mb << 20;
+  auto used = usedBytes_.load();
+  do {
+    if (used + bytes > capacity) {
+      return false;
+    }
+  } while (!usedBytes_.compare_exchange_weak(used, used + bytes));
+  return true;
+}
+
+folly::io::CodecType spillCompressionType(const std::string& name) {
+  static const std::unordered_map<std::string, folly::io::CodecType> kTypes{
+      {"none", folly::io::CodecType::NO_COMPRESSION},
+      {"lz4", folly::io::CodecType::LZ4},
+      {"zstd", folly::io::CodecType::ZSTD},
+      {"snappy", folly::io::CodecType::SNAPPY},
+      {"zlib", folly::io::CodecType::ZLIB},
+  };
+  auto it = kTypes.find(name);
+  VELOX_USER_CHECK(
+      it != kTypes.end(), "Unknown spill compression codec: {}", name);
+  VELOX_USER_CHECK(
+      folly::io::hasCodec(it->second),
+      "Spill compression codec {} is not available",
+      name);
+  return it->second;
+}
+
+std::unique_ptr<folly::io::Codec> makeSpillCodec(folly::io::CodecType type) {
+  if (type == folly::io::CodecType::NO_COMPRESSION) {
+    return nullptr;
+  }
+  return folly::io::getCodec(type);
+}
+
 void SpillInput::next(bool /*throwIfPastEnd*/) {
+  if (codec_ != nullptr) {
+    nextFrame();
+    return;
+  }
   int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
   VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
   setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
@@ -39,6 +113,30 @@ void SpillInput::next(bool /*throwIfPastEnd*/) {
   offset_ += readBytes;
 }
 
+void SpillInput::nextFrame() {
+  VELOX_CHECK_LE(
+      offset_ + sizeof(FrameHeader), size_, "Reading past end of spill file");
+  FrameHeader header;
+  input_->pread(offset_, sizeof(header), &header);
+  offset_ += sizeof(header);
+  VELOX_CHECK_LE(
+      offset_ + header.compressedSize, size_, "Truncated spill file frame");
+  if (buffer_->capacity() < header.compressedSize) {
+    AlignedBuffer::reallocate<char>(&buffer_, header.compressedSize);
+  }
+  input_->pread(offset_, header.compressedSize, buffer_->asMutable<char>());
+  offset_ += header.compressedSize;
+  auto compressed =
+      folly::IOBuf::wrapBuffer(buffer_->as<char>(), header.compressedSize);
+  uncompressed_ =
+      codec_->uncompress(compressed.get(), header.uncompressedSize);
+  uncompressed_->coalesce();
+  setRange(
+      {uncompressed_->writableData(),
+       static_cast<int32_t>(uncompressed_->length()),
+       0});
+}
+
 void SpillMergeStream::pop() {
   if (++index_ >= size_) {
     setNextBatch();
@@ -46,6 +144,10 @@ void SpillMergeStream::pop() {
 }
 
 SpillFile::~SpillFile() {
+  if (inMemory_) {
+    SpillMemoryTier::instance().release(reservedBytes_);
+    return;
+  }
   try {
     auto fs = filesystems::getFileSystem(path_, nullptr);
     fs->remove(path_);
@@ -56,22 +158,101 @@ SpillFile::~SpillFile() {
 
 WriteFile& SpillFile::output() {
   if (!output_) {
-    auto fs = filesystems::getFileSystem(path_, nullptr);
-    output_ = fs->openFileForWrite(path_);
+    if (SpillMemoryTier::instance().enabled()) {
+      inMemory_ = true;
+      output_ = std::make_unique<InMemoryWriteFile>(&content_);
+    } else {
+      auto fs = filesystems::getFileSystem(path_, nullptr);
+      output_ = fs->openFileForWrite(path_);
+    }
   }
   return *output_;
 }
 
+void SpillFile::prepareWrite(uint64_t bytes) {
+  output();
+  if (!inMemory_) {
+    return;
+  }
+  if (SpillMemoryTier::instance().tryReserve(bytes)) {
+    reservedBytes_ += bytes;
+    return;
+  }
+  moveToDisk();
+}
+
+void SpillFile::moveToDisk() {
+  VELOX_CHECK(inMemory_);
+  VELOX_CHECK_NOT_NULL(output_, "Only a spill file being written moves");
+  auto fs = filesystems::getFileSystem(path_, nullptr);
+  auto file = fs->openFileForWrite(path_);
+  file->append(content_);
+  output_ = std::move(file);
+  inMemory_ = false;
+  std::string().swap(content_);
+  SpillMemoryTier::instance().release(reservedBytes_);
+  reservedBytes_ = 0;
+}
+
+std::unique_ptr<ReadFile> SpillFile::openForRead() const {
+  if (inMemory_) {
+    return std::make_unique<InMemoryReadFile>(std::string_view(content_));
+  }
+  auto fs = filesystems::getFileSystem(path_, nullptr);
+  return fs->openFileForRead(path_);
+}
+
+namespace {
+constexpr uint64_t kMaxReadBufferSize =
+    (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
+
+// Reads the content of a finished spill file with its own file handle and
+// read buffer.
+class SpillFileReader : public BatchStream {
+ public:
+  SpillFileReader(
+      RowTypePtr type,
+      std::unique_ptr<SpillInput> input,
+      memory::MemoryPool& pool)
+      : type_(std::move(type)), input_(std::move(input)), pool_(pool) {}
+
+  bool nextBatch(RowVectorPtr& batch) override {
+    if (input_->atEnd()) {
+      return false;
+    }
+    VectorStreamGroup::read(
+        input_.get(), &pool_, type_, &batch, &kDefaultSerdeOptions);
+    return true;
+  }
+
+ private:
+  const RowTypePtr type_;
+  const std::unique_ptr<SpillInput> input_;
+  memory::MemoryPool& pool_;
+};
+} // namespace
+
 void SpillFile::startRead() {
-  constexpr uint64_t kMaxReadBufferSize =
-      (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
   VELOX_CHECK(!output_);
   VELOX_CHECK(!input_);
-  auto fs = filesystems::getFileSystem(path_, nullptr);
-  auto file = fs->openFileForRead(path_);
+  auto file = openForRead();
   auto buffer = AlignedBuffer::allocate<char>(
       std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  input_ = std::make_unique<SpillInput>(
+      std::move(file), std::move(buffer), compressionType_);
+}
+
+std::unique_ptr<BatchStream> SpillFile::createReader(
+    memory::MemoryPool& pool) const {
+  VELOX_CHECK(!output_, "Spill file must be finished before reading");
+  auto file = openForRead();
+  auto buffer = AlignedBuffer::allocate<char>(
+      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool);
+  return std::make_unique<SpillFileReader>(
+      type_,
+      std::make_unique<SpillInput>(
+          std::move(file), std::move(buffer), compressionType_),
+      pool);
 }
 
 bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
@@ -83,7 +264,40 @@ bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
   return true;
 }
 
-WriteFile& SpillFileList::currentOutput() {
+MappedSpillFile::MappedSpillFile(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  VELOX_CHECK_GE(
+      fd, 0, "Cannot open spill file {}: {}", path, folly::errnoStr(errno));
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    const auto error = errno;
+    close(fd);
+    VELOX_FAIL("Cannot stat spill file {}: {}", path, folly::errnoStr(error));
+  }
+  size_ = info.st_size;
+  if (size_ > 0) {
+    void* data =
+        mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    const auto error = errno;
+    close(fd);
+    VELOX_CHECK(
+        data != MAP_FAILED,
+        "Cannot map spill file {}: {}",
+        path,
+        folly::errnoStr(error));
+    data_ = reinterpret_cast<char*>(data);
+  } else {
+    close(fd);
+  }
+}
+
+MappedSpillFile::~MappedSpillFile() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+SpillFile& SpillFileList::currentFile() {
   if (files_.empty() || !files_.back()->isWritable() ||
       files_.back()->size() > targetFileSize_) {
     if (!files_.empty() && files_.back()->isWritable()) {
@@ -94,9 +308,10 @@ WriteFile& SpillFileList::currentOutput() {
         numSortingKeys_,
         sortCompareFlags_,
         fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        pool_,
+        compressionType_));
   }
-  return files_.back()->output();
+  return *files_.back();
 }
 
 void SpillFileList::flush() {
@@ -106,12 +321,123 @@ void SpillFileList::flush() {
     batch_->flush(&out);
     batch_.reset();
     auto iobuf = out.getIOBuf();
-    auto& file = currentOutput();
-    for (auto& range : *iobuf) {
-      file.append(std::string_view(
-          reinterpret_cast<const char*>(range.data()), range.size()));
+    uncompressedBytes_ += iobuf->computeChainDataLength();
+    if (codec_ != nullptr) {
+      // Each flush is written as a frame of a FrameHeader followed by the
+      // compressed bytes, so that SpillInput can uncompress a frame at a time.
+      FrameHeader header;
+      header.uncompressedSize = iobuf->computeChainDataLength();
+      auto compressed = codec_->compress(iobuf.get());
+      header.compressedSize = compressed->computeChainDataLength();
+      iobuf = folly::IOBuf::copyBuffer(&header, sizeof(header));
+      iobuf->prependChain(std::move(compressed));
+    }
+    if (writeExecutor_ != nullptr) {
+      enqueueWrite(std::move(iobuf));
+      return;
+    }
+    std::lock_guard<std::mutex> l(writeMutex_);
+    writeData(*iobuf);
+  }
+}
+
+void SpillFileList::writeData(const folly::IOBuf& data) {
+  auto& spillFile = currentFile();
+  spillFile.prepareWrite(data.computeChainDataLength());
+  auto& file = spillFile.output();
+  for (auto& range : data) {
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(range.data()), range.size()));
+  }
+}
+
+void SpillFileList::finishCurrentFile() {
+  if (!files_.empty() && files_.back()->isWritable()) {
+    files_.back()->finishWrite();
+  }
+}
+
+void SpillFileList::enqueueWrite(std::unique_ptr<folly::IOBuf> data) {
+  checkWriteError();
+  bool overBudget;
+  {
+    std::lock_guard<std::mutex> l(queueMutex_);
+    pendingBytes_ += data ? data->computeChainDataLength() : 0;
+    pendingWrites_.push_back(std::move(data));
+    overBudget = pendingBytes_ > maxPendingWriteBytes_;
+    if (!overBudget) {
+      ++numWriteTasks_;
     }
   }
+  if (overBudget) {
+    // Writes the queue here. If a background write is in progress, this
+    // waits for it and writes the rest.
+    drainWrites();
+    checkWriteError();
+    return;
+  }
+  writeExecutor_->add([this]() {
+    drainWrites();
+    std::lock_guard<std::mutex> l(queueMutex_);
+    if (--numWriteTasks_ == 0) {
+      writeTasksDone_.notify_all();
+    }
+  });
+}
+
+void SpillFileList::drainWrites() {
+  std::lock_guard<std::mutex> writeLock(writeMutex_);
+  for (;;) {
+    std::unique_ptr<folly::IOBuf> data;
+    {
+      std::lock_guard<std::mutex> l(queueMutex_);
+      if (pendingWrites_.empty()) {
+        return;
+      }
+      data = std::move(pendingWrites_.front());
+      pendingWrites_.pop_front();
+    }
+    const auto bytes = data ? data->computeChainDataLength() : 0;
+    std::exception_ptr error;
+    try {
+      if (data) {
+        writeData(*data);
+      } else {
+        finishCurrentFile();
+      }
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> l(queueMutex_);
+    pendingBytes_ -= bytes;
+    if (error && !writeError_) {
+      writeError_ = error;
+    }
+  }
+}
+
+void SpillFileList::checkWriteError() {
+  std::lock_guard<std::mutex> l(queueMutex_);
+  if (writeError_) {
+    std::rethrow_exception(writeError_);
+  }
+}
+
+SpillFileList::~SpillFileList() {
+  std::unique_lock<std::mutex> l(queueMutex_);
+  writeTasksDone_.wait(l, [&]() { return numWriteTasks_ == 0; });
+}
+
+SpillFiles SpillFileList::files() {
+  finishFile();
+  if (writeExecutor_ != nullptr) {
+    drainWrites();
+    checkWriteError();
+  }
+  std::lock_guard<std::mutex> l(writeMutex_);
+  VELOX_CHECK(!files_.empty());
+  recordRuntimeStats();
+  return std::move(files_);
 }
 
 void SpillFileList::write(
@@ -131,15 +457,16 @@ void SpillFileList::write(
 
 void SpillFileList::finishFile() {
   flush();
-  if (files_.empty()) {
+  if (writeExecutor_ != nullptr) {
+    enqueueWrite(nullptr);
     return;
   }
-  if (files_.back()->isWritable()) {
-    files_.back()->finishWrite();
-  }
+  std::lock_guard<std::mutex> l(writeMutex_);
+  finishCurrentFile();
 }
 
 uint64_t SpillFileList::spilledBytes() const {
+  std::lock_guard<std::mutex> l(writeMutex_);
   uint64_t bytes = 0;
   for (auto& file : files_) {
     bytes += file->size();
@@ -152,10 +479,16 @@ void SpillFileList::recordRuntimeStats() {
     addThreadLocalRuntimeStat(
         "spillFileSize",
         RuntimeCounter(file->size(), RuntimeCounter::Unit::kBytes));
+    if (file->inMemory()) {
+      addThreadLocalRuntimeStat(
+          "spillInMemoryFileSize",
+          RuntimeCounter(file->size(), RuntimeCounter::Unit::kBytes));
+    }
   }
 }
 
 std::vector<std::string> SpillFileList::testingSpilledFilePaths() const {
+  std::lock_guard<std::mutex> l(writeMutex_);
   std::vector<std::string> spilledFiles;
   for (auto& file : files_) {
     spilledFiles.push_back(file->testingFilePath());
@@ -183,7 +516,9 @@ void SpillState::appendToPartition(
         fmt::format("{}-spill-{}", path_, partition),
         targetFileSize_,
         pool_,
-        mappedMemory_);
+        mappedMemory_,
+        compressionType_,
+        writeExecutor_);
   }
 
   IndexRange range{0, rows->size()};
@@ -231,6 +566,16 @@ uint64_t SpillState::spilledBytes() const {
   return bytes;
 }
 
+uint64_t SpillState::spilledUncompressedBytes() const {
+  uint64_t bytes = 0;
+  for (auto& list : files_) {
+    if (list) {
+      bytes += list->spilledUncompressedBytes();
+    }
+  }
+  return bytes;
+}
+
 uint32_t SpillState::spilledPartitions() const {
   return spilledPartitionSet_.size();
 }
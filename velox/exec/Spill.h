@@ -16,7 +16,13 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <folly/compression/Compression.h>
 #include <folly/container/F14Set.h>
+#include <gflags/gflags.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 #include "velox/common/file/File.h"
 #include "velox/exec/TreeOfLosers.h"
@@ -25,16 +31,65 @@
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/VectorStream.h"
 
+DECLARE_int64(spill_memory_tier_mb);
+DECLARE_int64(spill_max_pending_write_mb);
+
 namespace facebook::velox::exec {
 
+/// Process wide budget for spill files that are held in memory instead of on
+/// disk. A spill file is written in memory while the in-memory spill files of
+/// the process fit in --spill_memory_tier_mb. When a write to it does not fit,
+/// the file is moved to its path on disk and written there from then on. The
+/// memory of a file is released when the file is destructed after reading.
+/// In-memory files have the compression of the spill files.
+class SpillMemoryTier {
+ public:
+  static SpillMemoryTier& instance();
+
+  /// True if new spill files start in memory.
+  bool enabled() const {
+    return FLAGS_spill_memory_tier_mb > 0;
+  }
+
+  /// Adds 'bytes' to the used bytes and returns true if these fit in the
+  /// budget. Returns false and leaves the used bytes unchanged otherwise.
+  bool tryReserve(uint64_t bytes);
+
+  void release(uint64_t bytes) {
+    usedBytes_ -= bytes;
+  }
+
+  uint64_t usedBytes() const {
+    return usedBytes_;
+  }
+
+ private:
+  std::atomic<uint64_t> usedBytes_{0};
+};
+
+/// Returns the codec type for compressing spill files named by 'name', one
+/// of "none", "lz4", "zstd", "snappy" or "zlib".
+folly::io::CodecType spillCompressionType(const std::string& name);
+
+/// Returns a codec of 'type' or nullptr for NO_COMPRESSION. A codec is used
+/// by one thread at a time.
+std::unique_ptr<folly::io::Codec> makeSpillCodec(folly::io::CodecType type);
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
+  // Reads from 'input' using 'buffer' for buffering reads. If
+  // 'compressionType' is not NO_COMPRESSION, 'input' consists of compressed
+  // frames, see SpillFileList::flush().
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      folly::io::CodecType compressionType =
+          folly::io::CodecType::NO_COMPRESSION)
       : input_(std::move(input)),
         buffer_(std::move(buffer)),
-        size_(input_->size()) {
+        size_(input_->size()),
+        codec_(makeSpillCodec(compressionType)) {
     next(true);
   }
 
@@ -46,11 +101,17 @@ class SpillInput : public ByteStream {
   }
 
  private:
+  // Reads and uncompresses the frame at 'offset_'.
+  void nextFrame();
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
   const uint64_t size_;
+  const std::unique_ptr<folly::io::Codec> codec_;
   // Offset of first byte not in 'buffer_'
   uint64_t offset_ = 0;
+  // The uncompressed content of the current frame if 'codec_' is set.
+  std::unique_ptr<folly::IOBuf> uncompressed_;
 };
 
 /// Represents a spill file that is first in write mode and then
@@ -63,11 +124,14 @@ class SpillFile {
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      folly::io::CodecType compressionType =
+          folly::io::CodecType::NO_COMPRESSION)
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         pool_(pool),
+        compressionType_(compressionType),
         ordinal_(ordinalCounter_++),
         path_(fmt::format("{}-{}", path, ordinal_)) {
     // NOTE: if the spilling operator has specified the sort comparison flags,
@@ -91,9 +155,19 @@ class SpillFile {
   /// this, then calls output() and writes serialized data to the file
   /// and calls finishWrite when the file has reached its final
   /// size. For sorted spilling, the data in one file is expected to be
-  // sorted.
+  // sorted. The file is in memory if SpillMemoryTier is enabled.
   WriteFile& output();
 
+  /// Called before writing 'bytes' to output(). Moves 'this' to disk if it is
+  /// in memory and 'bytes' do not fit in SpillMemoryTier. The WriteFile
+  /// returned by a previous output() is invalid after this.
+  void prepareWrite(uint64_t bytes);
+
+  /// True if the content of 'this' is held in memory, see SpillMemoryTier.
+  bool inMemory() const {
+    return inMemory_;
+  }
+
   bool isWritable() const {
     return output_ != nullptr;
   }
@@ -111,6 +185,13 @@ class SpillFile {
 
   bool nextBatch(RowVectorPtr& rowVector);
 
+  /// Returns a stream that reads the content from the start. The stream has
+  /// its own file handle and a read buffer allocated from 'pool'. Unlike
+  /// startRead(), this may be called any number of times and from different
+  /// threads after finishWrite(). Used for spilled data that is read more
+  /// than once, e.g. the build side of a block nested loop join.
+  std::unique_ptr<BatchStream> createReader(memory::MemoryPool& pool) const;
+
   /// Returns the file size in bytes. During the writing phase this is
   /// the current size of the file, during reading this is the final
   // size.
@@ -121,6 +202,10 @@ class SpillFile {
     return fileSize_;
   }
 
+  folly::io::CodecType compressionType() const {
+    return compressionType_;
+  }
+
   std::string label() const {
     return fmt::format("{}", ordinal_);
   }
@@ -130,6 +215,13 @@ class SpillFile {
   }
 
  private:
+  // Opens the content for reading, from memory or from the file at 'path_'.
+  std::unique_ptr<ReadFile> openForRead() const;
+
+  // Writes the in-memory content to the file at 'path_' and continues writing
+  // there.
+  void moveToDisk();
+
   static std::atomic<int32_t> ordinalCounter_;
 
   // Type of 'rowVector_'. Needed for setting up writing.
@@ -137,6 +229,7 @@ class SpillFile {
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   memory::MemoryPool& pool_;
+  const folly::io::CodecType compressionType_;
 
   // Ordinal number used for making a label for debugging.
   const int32_t ordinal_;
@@ -146,10 +239,44 @@ class SpillFile {
   uint64_t fileSize_ = 0;
   std::unique_ptr<WriteFile> output_;
   std::unique_ptr<SpillInput> input_;
+
+  // True if the content is in 'content_' instead of the file at 'path_'.
+  bool inMemory_{false};
+  std::string content_;
+  // Bytes of 'content_' reserved from SpillMemoryTier.
+  uint64_t reservedBytes_{0};
 };
 
 using SpillFiles = std::vector<std::unique_ptr<SpillFile>>;
 
+/// A finished local spill file mapped privately into memory, e.g. a file of
+/// row blocks written by RowContainer::writeRowBlock(). The mapping is
+/// copy-on-write, so that the reader can fix up pointers in place without
+/// changing the file.
+class MappedSpillFile {
+ public:
+  explicit MappedSpillFile(const std::string& path);
+
+  ~MappedSpillFile();
+
+  MappedSpillFile(const MappedSpillFile&) = delete;
+  MappedSpillFile& operator=(const MappedSpillFile&) = delete;
+
+  /// Returns the page aligned start of the mapping. nullptr if the file is
+  /// empty.
+  char* FOLLY_NULLABLE data() const {
+    return data_;
+  }
+
+  uint64_t size() const {
+    return size_;
+  }
+
+ private:
+  char* FOLLY_NULLABLE data_{nullptr};
+  uint64_t size_{0};
+};
+
 /// Sequence of files for one partition of the spilled data. If data is
 /// sorted, each file is sorted. The globally sorted order is produced
 /// by merging the constituent files.
@@ -164,6 +291,15 @@ class SpillFileList {
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
+  ///
+  /// If 'compressionType' is not NO_COMPRESSION, the serialized data is
+  /// compressed with the codec of the type.
+  ///
+  /// If 'writeExecutor' is set and --spill_max_pending_write_mb is not 0,
+  /// write() and finishFile() serialize the data and return, and the data is
+  /// written to the files on 'writeExecutor'. The caller writes the queued
+  /// data itself, or waits for the write in progress, if the queued data
+  /// exceeds the flag.
   SpillFileList(
       RowTypePtr type,
       int32_t numSortingKeys,
@@ -171,14 +307,22 @@ class SpillFileList {
       const std::string& path,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      folly::io::CodecType compressionType =
+          folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* FOLLY_NULLABLE writeExecutor = nullptr)
       : type_(type),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         path_(path),
         targetFileSize_(targetFileSize),
         pool_(pool),
-        mappedMemory_(mappedMemory) {
+        mappedMemory_(mappedMemory),
+        compressionType_(compressionType),
+        codec_(makeSpillCodec(compressionType)),
+        writeExecutor_(
+            FLAGS_spill_max_pending_write_mb > 0 ? writeExecutor : nullptr),
+        maxPendingWriteBytes_(FLAGS_spill_max_pending_write_mb << 20) {
     // NOTE: if the associated spilling operator has specified the sort
     // comparison flags, then it must match the number of sorting keys.
     VELOX_CHECK(
@@ -186,6 +330,9 @@ class SpillFileList {
         sortCompareFlags_.size() == numSortingKeys_);
   }
 
+  /// Waits for the background writes that are running.
+  ~SpillFileList();
+
   /// Adds 'rows' for the positions in 'indices' into 'this'. The indices
   /// must produce a view where the rows are sorted if sorting is desired.
   /// Consecutive calls must have sorted data so that the first row of the
@@ -198,16 +345,19 @@ class SpillFileList {
   /// start a new one.
   void finishFile();
 
-  SpillFiles files() {
-    VELOX_CHECK(!files_.empty());
-    finishFile();
-    recordRuntimeStats();
-    return std::move(files_);
-  }
+  /// Finishes writing and returns the files. Throws the error of a failed
+  /// background write.
+  SpillFiles files();
 
   uint64_t spilledBytes() const;
 
+  /// Returns the serialized bytes written to 'this' before compression.
+  uint64_t spilledUncompressedBytes() const {
+    return uncompressedBytes_;
+  }
+
   uint64_t spilledFiles() const {
+    std::lock_guard<std::mutex> l(writeMutex_);
     return files_.size();
   }
 
@@ -215,11 +365,29 @@ class SpillFileList {
 
  private:
   // Returns the current file to write to and creates one if needed.
-  WriteFile& currentOutput();
+  SpillFile& currentFile();
 
-  // Writes data from 'batch_' to the current output file.
+  // Writes data from 'batch_' to the current output file, or queues it for
+  // writing if writes are asynchronous.
   void flush();
 
+  // Appends 'data' to the current output file. Called with 'writeMutex_'.
+  void writeData(const folly::IOBuf& data);
+
+  // Finishes the current output file. Called with 'writeMutex_'.
+  void finishCurrentFile();
+
+  // Queues 'data' for writing on 'writeExecutor_', nullptr for finishing the
+  // current file. Writes the queue on the calling thread if it has more than
+  // 'maxPendingWriteBytes_'.
+  void enqueueWrite(std::unique_ptr<folly::IOBuf> data);
+
+  // Writes the queued data in order until the queue is empty.
+  void drainWrites();
+
+  // Throws the error of a failed background write, if any.
+  void checkWriteError();
+
   // Invoked by 'files()' to record stats when finish writing all the spill
   // files.
   void recordRuntimeStats();
@@ -231,8 +399,32 @@ class SpillFileList {
   const uint64_t targetFileSize_;
   memory::MemoryPool& pool_;
   memory::MappedMemory& mappedMemory_;
+  const folly::io::CodecType compressionType_;
+  const std::unique_ptr<folly::io::Codec> codec_;
+  // The serialized bytes written to 'this' before compression.
+  uint64_t uncompressedBytes_{0};
   std::unique_ptr<VectorStreamGroup> batch_;
+
+  // Set if writes are asynchronous.
+  folly::Executor* const FOLLY_NULLABLE writeExecutor_;
+  const uint64_t maxPendingWriteBytes_;
+
+  // Serializes the writes to 'files_' and the access to 'files_' while
+  // writes are asynchronous.
+  mutable std::mutex writeMutex_;
   SpillFiles files_;
+
+  // Guards the members below.
+  std::mutex queueMutex_;
+  // The data to write in order. nullptr finishes the current file.
+  std::deque<std::unique_ptr<folly::IOBuf>> pendingWrites_;
+  // Bytes in 'pendingWrites_' and in the write in progress.
+  uint64_t pendingBytes_{0};
+  // Number of drainWrites() scheduled on 'writeExecutor_' and not finished.
+  int32_t numWriteTasks_{0};
+  std::condition_variable writeTasksDone_;
+  // The first error of a write.
+  std::exception_ptr writeError_;
 };
 
 // A source of sorted spilled RowVectors coming either from a file or memory.
@@ -551,7 +743,9 @@ class SpillState {
   // on which the data is sorted, 0 if only hash partitioning is used.
   // 'targetFileSize' is the target size of a single
   // file.  'pool' and 'mappedMemory' own
-  // the memory for state and results.
+  // the memory for state and results. 'compressionType' is the codec for
+  // compressing the spill files. 'writeExecutor' is for writing the files
+  // asynchronously, see SpillFileList.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
@@ -559,12 +753,17 @@ class SpillState {
       const std::vector<CompareFlags>& sortCompareFlags,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      folly::io::CodecType compressionType =
+          folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* FOLLY_NULLABLE writeExecutor = nullptr)
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         targetFileSize_(targetFileSize),
+        compressionType_(compressionType),
+        writeExecutor_(writeExecutor),
         pool_(pool),
         mappedMemory_(mappedMemory),
         files_(maxPartitions_) {}
@@ -632,6 +831,9 @@ class SpillState {
 
   uint64_t spilledBytes() const;
 
+  /// Returns the serialized bytes of the spilled data before compression.
+  uint64_t spilledUncompressedBytes() const;
+
   /// Return the number of spilled partitions.
   uint32_t spilledPartitions() const;
 
@@ -650,6 +852,8 @@ class SpillState {
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   const uint64_t targetFileSize_;
+  const folly::io::CodecType compressionType_;
+  folly::Executor* const FOLLY_NULLABLE writeExecutor_;
 
   memory::MemoryPool& pool_;
   memory::MappedMemory& mappedMemory_;
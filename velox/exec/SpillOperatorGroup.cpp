@@ -67,6 +67,10 @@ void SpillOperatorGroup::operatorStopped(const Operator& op) {
     stoppedOperators_.insert(&op);
     VELOX_CHECK_LE(stoppedOperators_.size(), operators_.size());
     if (stoppedOperators_.size() == operators_.size()) {
+      // An external spill request is pending if all the operators stop before
+      // reaching the spill barrier.
+      VELOX_CHECK_EQ(numWaitingOperators_, 0);
+      needSpill_ = false;
       state_ = State::kStopped;
       checkStoppedStateLocked();
       return;
@@ -126,6 +130,15 @@ bool SpillOperatorGroup::requestSpill(Operator& op, ContinueFuture& future) {
   return false;
 }
 
+bool SpillOperatorGroup::requestExternalSpill() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (state_ != State::kRunning || numActiveOperatorsLocked() == 0) {
+    return false;
+  }
+  needSpill_ = true;
+  return true;
+}
+
 bool SpillOperatorGroup::waitSpill(Operator& op, ContinueFuture& future) {
   std::vector<ContinuePromise> promises;
   {
@@ -110,6 +110,14 @@ class SpillOperatorGroup {
   /// spill for the group.
   bool waitSpill(Operator& op, ContinueFuture& future);
 
+  /// Invoked from outside of the group's drivers, e.g. by a memory arbitrator
+  /// reclaiming memory for another query, to request a new spill operation on
+  /// the group. The spill runs once all the active operators reach the spill
+  /// barrier through waitSpill(). The function returns false if the group is
+  /// not running. The request is dropped if all the operators stop before
+  /// reaching the barrier.
+  bool requestExternalSpill();
+
  private:
   void checkStoppedStateLocked() const;
 
@@ -16,8 +16,10 @@
 
 #include "velox/exec/Spiller.h"
 #include <folly/ScopeGuard.h>
+#include <folly/container/F14Map.h>
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/PrefixSort.h"
 
 using facebook::velox::common::testutil::TestValue;
 
@@ -36,7 +38,8 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    folly::io::CodecType compressionType)
     : Spiller(
           type,
           container,
@@ -49,8 +52,9 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
-  VELOX_CHECK_EQ(type_, Type::kOrderBy);
+          executor,
+          compressionType) {
+  VELOX_CHECK(type_ == Type::kOrderBy || type_ == Type::kTopN);
 }
 
 Spiller::Spiller(
@@ -61,7 +65,8 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* FOLLY_NULLABLE executor)
+    folly::Executor* FOLLY_NULLABLE executor,
+    folly::io::CodecType compressionType)
     : Spiller(
           type,
           nullptr,
@@ -74,7 +79,8 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
+          executor,
+          compressionType) {
   VELOX_CHECK_EQ(type_, Type::kHashJoinProbe);
 }
 
@@ -90,11 +96,46 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    folly::io::CodecType compressionType)
+    : Spiller(
+          type,
+          container,
+          eraser,
+          std::move(rowType),
+          bits,
+          container == nullptr ? 0 : container->keyTypes().size(),
+          numSortingKeys,
+          sortCompareFlags,
+          path,
+          targetFileSize,
+          minSpillRunSize,
+          pool,
+          executor,
+          compressionType) {
+  VELOX_CHECK_NE(type_, Type::kWindow);
+}
+
+Spiller::Spiller(
+    Type type,
+    RowContainer* container,
+    RowContainer::Eraser eraser,
+    RowTypePtr rowType,
+    HashBitRange bits,
+    int32_t numPartitionKeys,
+    int32_t numSortingKeys,
+    const std::vector<CompareFlags>& sortCompareFlags,
+    const std::string& path,
+    uint64_t targetFileSize,
+    uint64_t minSpillRunSize,
+    memory::MemoryPool& pool,
+    folly::Executor* executor,
+    folly::io::CodecType compressionType)
     : type_(type),
       container_(container),
       eraser_(eraser),
       bits_(bits),
+      numPartitionKeys_(numPartitionKeys),
       rowType_(std::move(rowType)),
       minSpillRunSize_(minSpillRunSize),
       state_(
@@ -104,15 +145,22 @@ Spiller::Spiller(
           sortCompareFlags,
           targetFileSize,
           pool,
-          spillMappedMemory()),
+          spillMappedMemory(),
+          compressionType,
+          executor),
       pool_(pool),
       executor_(executor) {
   TestValue::adjust(
       "facebook::velox::exec::Spiller", const_cast<HashBitRange*>(&bits_));
 
   VELOX_CHECK_EQ(container_ == nullptr, type_ == Type::kHashJoinProbe);
-  // kOrderBy spiller type must only have one partition.
-  VELOX_CHECK((type_ != Type::kOrderBy) || (state_.maxPartitions() == 1));
+  // kOrderBy and kTopN spiller types must only have one partition.
+  VELOX_CHECK(
+      (type_ != Type::kOrderBy && type_ != Type::kTopN) ||
+      (state_.maxPartitions() == 1));
+  VELOX_CHECK_LE(
+      numPartitionKeys_,
+      container_ == nullptr ? 0 : container_->keyTypes().size());
   spillRuns_.reserve(state_.maxPartitions());
   for (int i = 0; i < state_.maxPartitions(); ++i) {
     spillRuns_.emplace_back(spillMappedMemory());
@@ -135,8 +183,13 @@ void Spiller::extractSpill(folly::Range<char**> rows, RowVectorPtr& resultPtr) {
   auto& aggregates = container_->aggregates();
   auto numKeys = types.size();
   for (auto i = 0; i < aggregates.size(); ++i) {
-    aggregates[i]->extractAccumulators(
-        rows.data(), rows.size(), &result->childAt(i + numKeys));
+    if (aggregates[i]->supportsSpillState()) {
+      aggregates[i]->extractSpillState(
+          rows.data(), rows.size(), &result->childAt(i + numKeys));
+    } else {
+      aggregates[i]->extractAccumulators(
+          rows.data(), rows.size(), &result->childAt(i + numKeys));
+    }
   }
 }
 
@@ -242,13 +295,10 @@ std::unique_ptr<SpillMergeStream> Spiller::spillMergeStreamOverRows(
 void Spiller::ensureSorted(SpillRun& run) {
   // The spill data of a hash join doesn't need to be sorted.
   if (!run.sorted && needSort()) {
-    std::sort(
-        run.rows.begin(),
-        run.rows.end(),
-        [&](const char* left, const char* right) {
-          return container_->compareRows(
-                     left, right, state_.sortCompareFlags()) < 0;
-        });
+    PrefixSort::sort(
+        container_,
+        state_.sortCompareFlags(),
+        folly::Range<char**>(run.rows.data(), run.rows.size()));
     run.sorted = true;
   }
 }
@@ -540,7 +590,7 @@ void Spiller::fillSpillRuns(SpillRows* rowsFromNonSpillingPartitions) {
         &iterator, rows.size(), RowContainer::kUnlimited, rows.data());
     // Calculate hashes for this batch of spill candidates.
     auto rowSet = folly::Range<char**>(rows.data(), numRows);
-    for (auto i = 0; i < container_->keyTypes().size(); ++i) {
+    for (auto i = 0; i < numPartitionKeys_; ++i) {
       container_->hash(i, rowSet, i > 0, hashes.data());
     }
 
@@ -548,7 +598,9 @@ void Spiller::fillSpillRuns(SpillRows* rowsFromNonSpillingPartitions) {
     for (auto i = 0; i < numRows; ++i) {
       // TODO: consider to cache the hash bits in row container so we only need
       // to calculate them once.
-      const auto partition = (type_ == Type::kOrderBy)
+      const auto partition =
+          (type_ == Type::kOrderBy || type_ == Type::kTopN ||
+           numPartitionKeys_ == 0)
           ? 0
           : bits_.partition(hashes[i], state_.maxPartitions());
       VELOX_DCHECK_GE(partition, 0);
@@ -626,6 +678,10 @@ std::string Spiller::typeName(Type type) {
       return "HASH_JOIN_PROBE";
     case Type::kAggregate:
       return "AGGREGATE";
+    case Type::kWindow:
+      return "WINDOW";
+    case Type::kTopN:
+      return "TOP_N";
     default:
       VELOX_UNREACHABLE("Unknown type: {}", static_cast<int>(type));
       return fmt::format("UNKNOWN TYPE: {}", static_cast<int>(type));
@@ -646,9 +702,34 @@ void Spiller::fillSpillRuns(std::vector<SpillableStats>& statsList) {
     const auto& spillRun = spillRuns_[partitionNum];
     statsList[partitionNum].numBytes += spillRun.numBytes;
     statsList[partitionNum].numRows += spillRun.rows.size();
+    if (type_ == Type::kHashJoinBuild && !spillRun.rows.empty()) {
+      sampleHotKeys(spillRun, statsList[partitionNum]);
+    }
   }
 }
 
+void Spiller::sampleHotKeys(const SpillRun& run, SpillableStats& stats) {
+  const int32_t numSamples =
+      std::min<int32_t>(kMaxKeySampleRows, run.rows.size());
+  const auto step = run.rows.size() / numSamples;
+  std::vector<char*> rows(numSamples);
+  for (auto i = 0; i < numSamples; ++i) {
+    rows[i] = run.rows[i * step];
+  }
+  std::vector<uint64_t> hashes(numSamples);
+  const auto rowSet = folly::Range<char**>(rows.data(), numSamples);
+  for (auto i = 0; i < numPartitionKeys_; ++i) {
+    container_->hash(i, rowSet, i > 0, hashes.data());
+  }
+  folly::F14FastMap<uint64_t, int32_t> keyCounts;
+  int32_t maxCount = 0;
+  for (auto hash : hashes) {
+    maxCount = std::max(maxCount, ++keyCounts[hash]);
+  }
+  stats.numSampledRows += numSamples;
+  stats.numHotKeyRows += maxCount;
+}
+
 // static
 memory::MappedMemory& Spiller::spillMappedMemory() {
   // Return the top level instance. Since this too may be full,
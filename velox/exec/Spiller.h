@@ -33,8 +33,12 @@ class Spiller {
     kHashJoinProbe = 2,
     // Used for order by.
     kOrderBy = 3,
+    // Used for window.
+    kWindow = 4,
+    // Used for top n.
+    kTopN = 5,
   };
-  static constexpr int kNumTypes = 4;
+  static constexpr int kNumTypes = 6;
   static std::string typeName(Type);
 
   // Specifies the config for spilling.
@@ -47,7 +51,9 @@ class Spiller {
         int32_t _spillableReservationGrowthPct,
         const HashBitRange& _hashBitRange,
         int32_t _maxSpillLevel,
-        int32_t _testSpillPct)
+        int32_t _testSpillPct,
+        folly::io::CodecType _compressionType =
+            folly::io::CodecType::NO_COMPRESSION)
         : filePath(_filePath),
           maxFileSize(
               _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
@@ -57,7 +63,8 @@ class Spiller {
           spillableReservationGrowthPct(_spillableReservationGrowthPct),
           hashBitRange(_hashBitRange),
           maxSpillLevel(_maxSpillLevel),
-          testSpillPct(_testSpillPct) {}
+          testSpillPct(_testSpillPct),
+          compressionType(_compressionType) {}
 
     /// Returns the spilling level with given 'startBitOffset'.
     ///
@@ -85,6 +92,8 @@ class Spiller {
     uint64_t minSpillRunSize;
 
     // Executor for spilling. If nullptr spilling writes on the Driver's thread.
+    // With --spill_max_pending_write_mb, the spill files are also written on
+    // it in the background, see SpillFileList.
     folly::Executor* FOLLY_NULLABLE executor; // Not owned.
 
     // The spillable memory reservation growth percentage of the current
@@ -104,12 +113,16 @@ class Spiller {
     // Percentage of input batches to be spilled for testing. 0 means no
     // spilling for test.
     int32_t testSpillPct;
+
+    // The codec for compressing the spill files.
+    folly::io::CodecType compressionType;
   };
 
   using SpillRows = std::vector<char*, memory::StlMappedMemoryAllocator<char*>>;
 
   // The constructor without specifying hash bits which will only use one
-  // partition by default. It is only used by kOrderBy spiller type as for now.
+  // partition by default. It is only used by kOrderBy and kTopN spiller types
+  // as for now.
   Spiller(
       Type type,
       RowContainer* FOLLY_NONNULL container,
@@ -121,7 +134,9 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionType =
+          folly::io::CodecType::NO_COMPRESSION);
 
   Spiller(
       Type type,
@@ -131,7 +146,9 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionType =
+          folly::io::CodecType::NO_COMPRESSION);
 
   Spiller(
       Type type,
@@ -145,7 +162,30 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionType =
+          folly::io::CodecType::NO_COMPRESSION);
+
+  /// Same as above but only hashes the leading 'numPartitionKeys' key columns
+  /// of 'container' to pick the spill partition of a row. It is used by
+  /// kWindow spiller type which sorts on the partition and the order by keys
+  /// but must keep all the rows of a window partition in one spill partition.
+  Spiller(
+      Type type,
+      RowContainer* FOLLY_NULLABLE container,
+      RowContainer::Eraser eraser,
+      RowTypePtr rowType,
+      HashBitRange bits,
+      int32_t numPartitionKeys,
+      int32_t numSortingKeys,
+      const std::vector<CompareFlags>& sortCompareFlags,
+      const std::string& path,
+      uint64_t targetFileSize,
+      uint64_t minSpillRunSize,
+      memory::MemoryPool& pool,
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionType =
+          folly::io::CodecType::NO_COMPRESSION);
 
   /// Spills rows from 'this' until there are under 'targetRows' rows
   /// and 'targetBytes' of allocated variable length space in use. spill()
@@ -180,14 +220,25 @@ class Spiller {
   struct SpillableStats {
     int64_t numRows = 0;
     int64_t numBytes = 0;
+    /// The number of rows sampled for the key frequency and the number of the
+    /// sampled rows which have the most frequent key. Only set for
+    /// kHashJoinBuild to detect the partitions which are dominated by a few
+    /// hot keys and can't be split by recursive spilling.
+    int64_t numSampledRows = 0;
+    int64_t numHotKeyRows = 0;
 
     inline SpillableStats& operator+=(const SpillableStats& other) {
       this->numRows += other.numRows;
       this->numBytes += other.numBytes;
+      this->numSampledRows += other.numSampledRows;
+      this->numHotKeyRows += other.numHotKeyRows;
       return *this;
     }
   };
 
+  /// The max number of rows sampled from a partition for the key frequency.
+  static constexpr int32_t kMaxKeySampleRows = 1'024;
+
   /// Invoked to fill spill runs on all partitions and accumulate the spillable
   /// stats in 'statsList' by partition number.
   void fillSpillRuns(std::vector<SpillableStats>& statsList);
@@ -255,7 +306,11 @@ class Spiller {
 
   /// Define the spiller stats.
   struct Stats {
+    /// The bytes written to the spill files. These are compressed bytes if
+    /// the spill files are compressed.
     uint64_t spilledBytes{0};
+    /// The serialized bytes of the spilled data before compression.
+    uint64_t spilledUncompressedBytes{0};
     uint64_t spilledRows{0};
     /// NOTE: when we sum up the stats from a group of spill operators, it is
     /// the total number of spilled partitions X number of operators.
@@ -276,6 +331,7 @@ class Spiller {
 
     Stats& operator+=(const Stats& other) {
       spilledBytes += other.spilledBytes;
+      spilledUncompressedBytes += other.spilledUncompressedBytes;
       spilledRows += other.spilledRows;
       spilledPartitions += other.spilledPartitions;
       spilledFiles += other.spilledFiles;
@@ -284,11 +340,13 @@ class Spiller {
   };
 
   Stats stats() const {
-    return Stats{
+    Stats stats{
         state_.spilledBytes(),
         spilledRows_,
         state_.spilledPartitions(),
         spilledFiles()};
+    stats.spilledUncompressedBytes = state_.spilledUncompressedBytes();
+    return stats;
   }
 
   /// Return the number of spilled files we have.
@@ -378,6 +436,11 @@ class Spiller {
   // happen when finish spill to collect non-spilling rows.
   int32_t pickNextPartitionToSpill();
 
+  // Samples up to 'kMaxKeySampleRows' rows evenly from 'run' and adds the
+  // number of sampled rows and the number of sampled rows with the most
+  // frequent key hash to 'stats'.
+  void sampleHotKeys(const SpillRun& run, SpillableStats& stats);
+
   // Clears pending spill state.
   void clearSpillRuns();
 
@@ -410,6 +473,9 @@ class Spiller {
   RowContainer* const FOLLY_NULLABLE container_; // Not owned.
   const RowContainer::Eraser eraser_;
   const HashBitRange bits_;
+  // The number of leading key columns of 'container_' to hash for spill
+  // partitioning.
+  const int32_t numPartitionKeys_;
   const RowTypePtr rowType_;
   const uint64_t minSpillRunSize_;
 
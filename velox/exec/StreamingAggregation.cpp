@@ -15,7 +15,9 @@
  */
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/DistinctAggregate.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/SortedAggregate.h"
 
 namespace facebook::velox::exec {
 
@@ -69,6 +71,15 @@ StreamingAggregation::StreamingAggregation(
         constants.push_back(nullptr);
       }
     }
+    // The sorting keys of a sorted aggregate follow its arguments.
+    std::vector<TypePtr> inputTypes = argTypes;
+    if (aggregationNode->isSortedAggregate(i)) {
+      for (const auto& key : aggregationNode->aggregateSortingKeys()[i]) {
+        inputTypes.push_back(key->type());
+        channels.push_back(exprToChannel(key.get(), inputType));
+        constants.push_back(nullptr);
+      }
+    }
 
     const auto& mask = aggregationNode->aggregateMasks()[i];
     if (mask == nullptr) {
@@ -80,6 +91,15 @@ StreamingAggregation::StreamingAggregation(
     const auto& aggResultType = outputType_->childAt(numKeys + i);
     aggregates_.push_back(Aggregate::create(
         aggregate->name(), aggregationNode->step(), argTypes, aggResultType));
+    if (aggregationNode->isDistinctAggregate(i)) {
+      aggregates_.back() =
+          makeDistinctAggregate(std::move(aggregates_.back()), argTypes[0]);
+    } else if (aggregationNode->isSortedAggregate(i)) {
+      aggregates_.back() = makeSortedAggregate(
+          std::move(aggregates_.back()),
+          inputTypes,
+          aggregationNode->aggregateSortingOrders()[i]);
+    }
     args_.push_back(channels);
     constantArgs_.push_back(constants);
   }
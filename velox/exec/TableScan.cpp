@@ -34,6 +34,17 @@ TableScan::TableScan(
       columnHandles_(tableScanNode->assignments()),
       driverCtx_(driverCtx) {
   connector_ = connector::getConnector(tableHandle_->connectorId());
+  asyncLoad_ = connector_->executor() != nullptr &&
+      driverCtx_->queryConfig().tableScanAsyncLoad();
+  if (connector_->supportsSplitPreload() && connector_->executor()) {
+    maxPreloadedSplits_ = driverCtx_->queryConfig().maxSplitPreloadPerDriver();
+    if (maxPreloadedSplits_ > 0) {
+      splitPreloader_ =
+          [this](std::shared_ptr<connector::ConnectorSplit> split) {
+            preload(std::move(split));
+          };
+    }
+  }
 }
 
 RowVectorPtr TableScan::getOutput() {
@@ -45,7 +56,13 @@ RowVectorPtr TableScan::getOutput() {
     if (needNewSplit_) {
       exec::Split split;
       blockingReason_ = driverCtx_->task->getSplitOrFuture(
-          driverCtx_->splitGroupId, planNodeId(), split, blockingFuture_);
+          driverCtx_->splitGroupId,
+          planNodeId(),
+          split,
+          blockingFuture_,
+          maxPreloadedSplits_,
+          splitPreloader_,
+          driverCtx_->driverId);
       if (blockingReason_ != BlockingReason::kNotBlocked) {
         return nullptr;
       }
@@ -79,8 +96,10 @@ RowVectorPtr TableScan::getOutput() {
           "Got splits with different connector IDs");
 
       if (!dataSource_) {
-        connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
-            connectorSplit->connectorId, planNodeId());
+        if (!connectorQueryCtx_) {
+          connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
+              connectorSplit->connectorId, planNodeId());
+        }
         dataSource_ = connector_->createDataSource(
             outputType_,
             tableHandle_,
@@ -96,7 +115,19 @@ RowVectorPtr TableScan::getOutput() {
           "Split {} Task {}",
           connectorSplit->toString(),
           operatorCtx_->task()->taskId());
-      dataSource_->addSplit(connectorSplit);
+      std::unique_ptr<std::shared_ptr<connector::DataSource>> preloaded;
+      if (connectorSplit->dataSource) {
+        // Waits for the preload if it is in progress and otherwise opens the
+        // split here. nullptr if the preload was cancelled.
+        preloaded = connectorSplit->dataSource->move();
+        connectorSplit->dataSource.reset();
+      }
+      if (preloaded) {
+        dataSource_->setFromDataSource(std::move(*preloaded));
+        stats_.wlock()->addRuntimeStat("preloadedSplits", RuntimeCounter(1));
+      } else {
+        dataSource_->addSplit(connectorSplit);
+      }
       ++stats_.wlock()->numSplits;
       setBatchSize();
     }
@@ -108,7 +139,9 @@ RowVectorPtr TableScan::getOutput() {
          },
          &debugString_});
 
-    auto dataOptional = dataSource_->next(readBatchSize_, blockingFuture_);
+    auto dataOptional = asyncLoad_
+        ? nextAsync()
+        : dataSource_->next(readBatchSize_, blockingFuture_);
     if (!dataOptional.has_value()) {
       blockingReason_ = BlockingReason::kWaitForConnector;
       return nullptr;
@@ -157,6 +190,75 @@ void TableScan::setBatchSize() {
   readBatchSize_ = std::min<int64_t>(100, 10 * kMB / estimate);
 }
 
+void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
+  if (!connectorQueryCtx_) {
+    connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
+        split->connectorId, planNodeId());
+  }
+  // The DataSource is made on the Driver thread so that its expressions are
+  // compiled here. Only the opening of the file runs on the executor. The
+  // AsyncSource does not hold the split, which holds the AsyncSource.
+  std::shared_ptr<connector::DataSource> dataSource =
+      connector_->createDataSource(
+          outputType_, tableHandle_, columnHandles_, connectorQueryCtx_.get());
+  split->dataSource =
+      std::make_shared<AsyncSource<std::shared_ptr<connector::DataSource>>>(
+          [dataSource, weakSplit = std::weak_ptr(split)]() mutable
+          -> std::unique_ptr<std::shared_ptr<connector::DataSource>> {
+            auto split = weakSplit.lock();
+            if (!split || split->cancelled) {
+              return nullptr;
+            }
+            dataSource->addSplit(split);
+            return std::make_unique<std::shared_ptr<connector::DataSource>>(
+                std::move(dataSource));
+          });
+  // The Task owns the memory pools of the reader, so it must outlive the
+  // preparation.
+  connector_->executor()->add(
+      [task = operatorCtx_->task(), source = split->dataSource]() mutable {
+        source->prepare();
+        source.reset();
+      });
+}
+
+std::optional<RowVectorPtr> TableScan::nextAsync() {
+  if (pendingBatch_ != nullptr) {
+    auto batch = std::move(pendingBatch_);
+    if (batch->error) {
+      std::rethrow_exception(batch->error);
+    }
+    if (!batch->data.has_value()) {
+      blockingFuture_ = std::move(batch->future);
+    }
+    return std::move(batch->data);
+  }
+
+  pendingBatch_ = std::make_shared<PendingBatch>();
+  auto contract = makeVeloxContinuePromiseContract("TableScan::nextAsync");
+  blockingFuture_ = std::move(contract.second);
+  // The Task owns the memory pools of the DataSource, so it must outlive the
+  // read.
+  connector_->executor()->add([task = operatorCtx_->task(),
+                               dataSource = dataSource_,
+                               batch = pendingBatch_,
+                               size = readBatchSize_,
+                               promise = std::move(contract.first)]() mutable {
+    try {
+      batch->data = dataSource->next(size, batch->future);
+      if (batch->data.has_value() && batch->data.value() != nullptr) {
+        for (auto& child : batch->data.value()->children()) {
+          child = BaseVector::loadedVectorShared(child);
+        }
+      }
+    } catch (const std::exception&) {
+      batch->error = std::current_exception();
+    }
+    promise.setValue();
+  });
+  return std::nullopt;
+}
+
 void TableScan::addDynamicFilter(
     column_index_t outputChannel,
     const std::shared_ptr<common::Filter>& filter) {
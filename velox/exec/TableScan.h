@@ -53,6 +53,25 @@ class TableScan : public SourceOperator {
   // Adjust batch size according to split information.
   void setBatchSize();
 
+  // Makes a DataSource for 'split' and schedules the opening of the split on
+  // the connector's executor. Called by the Task for queued splits while
+  // 'this' is reading the previous split.
+  void preload(std::shared_ptr<connector::ConnectorSplit> split);
+
+  // Result of a DataSource::next() on the connector's executor.
+  struct PendingBatch {
+    std::optional<RowVectorPtr> data;
+    ContinueFuture future{ContinueFuture::makeEmpty()};
+    std::exception_ptr error;
+  };
+
+  // Returns the batch read by the previous call and otherwise schedules the
+  // read of the next batch of 'dataSource_' and the loading of its lazy
+  // vectors on the connector's executor. Returns std::nullopt and sets
+  // 'blockingFuture_' while the read is in progress or if the DataSource is
+  // blocked.
+  std::optional<RowVectorPtr> nextAsync();
+
   const std::shared_ptr<connector::ConnectorTableHandle> tableHandle_;
   const std::
       unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
@@ -70,6 +89,19 @@ class TableScan : public SourceOperator {
       pendingDynamicFilters_;
   int32_t readBatchSize_{kDefaultBatchSize};
 
+  // Number of queued splits to preload. 0 if the connector does not support
+  // split preload.
+  int32_t maxPreloadedSplits_{0};
+  std::function<void(std::shared_ptr<connector::ConnectorSplit>)>
+      splitPreloader_{nullptr};
+
+  // True if batches are read by nextAsync().
+  bool asyncLoad_{false};
+
+  // The batch being read on the connector's executor. Set from the executor
+  // before the Driver is continued.
+  std::shared_ptr<PendingBatch> pendingBatch_;
+
   // String shown in ExceptionContext inside DataSource and LazyVector loading.
   std::string debugString_;
 };
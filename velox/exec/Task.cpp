@@ -23,6 +23,7 @@
 #include "velox/common/time/Timer.h"
 #include "velox/exec/CrossJoinBuild.h"
 #include "velox/exec/Exchange.h"
+#include "velox/expression/ExprCompiler.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/LocalPlanner.h"
 #include "velox/exec/Merge.h"
@@ -126,6 +127,32 @@ std::unordered_set<core::PlanNodeId> collectSplitPlanNodeIds(
   return sourceIds;
 }
 
+void collectTableScanNodes(
+    const core::PlanNodePtr& planNode,
+    std::unordered_map<
+        core::PlanNodeId,
+        std::shared_ptr<const core::TableScanNode>>& tableScans) {
+  if (auto tableScan =
+          std::dynamic_pointer_cast<const core::TableScanNode>(planNode)) {
+    tableScans[tableScan->id()] = tableScan;
+  }
+  for (const auto& child : planNode->sources()) {
+    collectTableScanNodes(child, tableScans);
+  }
+}
+
+std::unordered_map<
+    core::PlanNodeId,
+    std::shared_ptr<const core::TableScanNode>>
+collectTableScanNodes(const core::PlanNodePtr& planNode) {
+  std::unordered_map<
+      core::PlanNodeId,
+      std::shared_ptr<const core::TableScanNode>>
+      tableScans;
+  collectTableScanNodes(planNode, tableScans);
+  return tableScans;
+}
+
 } // namespace
 
 Task::Task(
@@ -165,6 +192,7 @@ Task::Task(
       pool_(
           queryCtx_->pool()->addChild(fmt::format("task.{}", taskId_.c_str()))),
       splitPlanNodeIds_(collectSplitPlanNodeIds(planFragment_.planNode)),
+      tableScanNodes_(collectTableScanNodes(planFragment_.planNode)),
       consumerSupplier_(std::move(consumerSupplier)),
       onError_(onError),
       bufferManager_(PartitionedOutputBufferManager::getInstance()) {
@@ -204,6 +232,18 @@ Task::getOrAddNodePool(const core::PlanNodeId& planNodeId) {
   return nodePool;
 }
 
+std::vector<core::TypedExprPtr> Task::foldedExprs(
+    const core::PlanNodeId& planNodeId,
+    const std::vector<core::TypedExprPtr>& exprs,
+    core::ExecCtx* FOLLY_NONNULL execCtx) {
+  auto it = foldedExprs_.find(planNodeId);
+  if (it == foldedExprs_.end()) {
+    it = foldedExprs_.emplace(planNodeId, foldConstants(exprs, execCtx)).first;
+  }
+  VELOX_CHECK_EQ(it->second.size(), exprs.size());
+  return it->second;
+}
+
 velox::memory::MemoryPool* FOLLY_NONNULL Task::addOperatorPool(
     const core::PlanNodeId& planNodeId,
     int pipelineId,
@@ -228,7 +268,8 @@ bool Task::supportsSingleThreadedExecution() const {
     return false;
   }
 
-  LocalPlanner::plan(planFragment_, nullptr, &driverFactories, 1);
+  LocalPlanner::plan(
+      planFragment_, nullptr, &driverFactories, queryCtx_->queryConfig(), 1);
 
   for (const auto& factory : driverFactories) {
     if (!factory->supportsSingleThreadedExecution()) {
@@ -261,7 +302,12 @@ RowVectorPtr Task::next() {
         consumerSupplier_,
         "Single-threaded execution doesn't support delivering results to a callback");
 
-    LocalPlanner::plan(planFragment_, nullptr, &driverFactories_, 1);
+    LocalPlanner::plan(
+        planFragment_,
+        nullptr,
+        &driverFactories_,
+        queryCtx_->queryConfig(),
+        1);
 
     exchangeClients_.resize(driverFactories_.size());
 
@@ -371,6 +417,7 @@ void Task::start(
       self->planFragment_,
       self->consumerSupplier(),
       &self->driverFactories_,
+      self->queryCtx_->queryConfig(),
       maxDrivers);
 
   // Keep one exchange client per pipeline (NULL if not used).
@@ -721,6 +768,9 @@ bool Task::addSplitWithSequence(
 
 void Task::addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split) {
   checkPlanNodeIdForSplit(planNodeId);
+  if (pruneSplit(planNodeId, split)) {
+    return;
+  }
   bool isTaskRunning;
   std::unique_ptr<ContinuePromise> promise;
   {
@@ -754,6 +804,27 @@ void Task::addRemoteSplit(
   }
 }
 
+bool Task::pruneSplit(
+    const core::PlanNodeId& planNodeId,
+    const exec::Split& split) {
+  if (!split.hasConnectorSplit() || split.hasGroup()) {
+    return false;
+  }
+  auto it = tableScanNodes_.find(planNodeId);
+  if (it == tableScanNodes_.end()) {
+    return false;
+  }
+  const auto& tableHandle = it->second->tableHandle();
+  if (connector::getConnector(tableHandle->connectorId())
+          ->testSplit(
+              tableHandle, it->second->assignments(), split.connectorSplit)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  ++taskStats_.numPrunedSplits;
+  return true;
+}
+
 void Task::checkPlanNodeIdForSplit(const core::PlanNodeId& id) const {
   VELOX_USER_CHECK(
       splitPlanNodeIds_.find(id) != splitPlanNodeIds_.end(),
@@ -802,6 +873,15 @@ std::unique_ptr<ContinuePromise> Task::addSplitToStoreLocked(
   return nullptr;
 }
 
+static void movePromisesOut(
+    std::vector<ContinuePromise>& from,
+    std::vector<ContinuePromise>& to) {
+  for (auto& promise : from) {
+    to.push_back(std::move(promise));
+  }
+  from.clear();
+}
+
 void Task::noMoreSplitsForGroup(
     const core::PlanNodeId& planNodeId,
     int32_t splitGroupId) {
@@ -814,6 +894,9 @@ void Task::noMoreSplitsForGroup(
     auto& splitsStore = splitsState.groupSplitsStores[splitGroupId];
     splitsStore.noMoreSplits = true;
     promises = std::move(splitsStore.splitPromises);
+    if (splitsStore.splits.empty()) {
+      movePromisesOut(splitsStore.parkedPromises, promises);
+    }
 
     // There were no splits in this group, hence, no active drivers. Mark the
     // group complete.
@@ -843,7 +926,10 @@ void Task::noMoreSplits(const core::PlanNodeId& planNodeId) {
       // Mark all split stores as 'no more splits'.
       for (auto& it : splitsState.groupSplitsStores) {
         it.second.noMoreSplits = true;
-        splitPromises = std::move(it.second.splitPromises);
+        movePromisesOut(it.second.splitPromises, splitPromises);
+        if (it.second.splits.empty()) {
+          movePromisesOut(it.second.parkedPromises, splitPromises);
+        }
       }
     } else if (isUngroupedExecution()) {
       // During ungrouped execution, in the unlikely case there are no split
@@ -918,24 +1004,67 @@ BlockingReason Task::getSplitOrFuture(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId,
     exec::Split& split,
-    ContinueFuture& future) {
-  std::lock_guard<std::mutex> l(mutex_);
+    ContinueFuture& future,
+    int32_t maxPreloadSplits,
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    uint32_t driverId) {
+  std::vector<ContinuePromise> parkedPromises;
+  BlockingReason reason;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
 
-  auto& splitsState = splitsStates_[planNodeId];
+    auto& splitsState = splitsStates_[planNodeId];
+    const auto groupId = isUngroupedExecution() ? 0 : splitGroupId;
+    auto& splitsStore = splitsState.groupSplitsStores[groupId];
+    const bool drained = splitsStore.noMoreSplits && splitsStore.splits.empty();
+    if (driverId >= splitsState.maxActiveDrivers && !drained) {
+      auto [parkedPromise, parkedFuture] = makeVeloxContinuePromiseContract(
+          fmt::format("Task::getSplitOrFuture parked {}", taskId_));
+      future = std::move(parkedFuture);
+      splitsStore.parkedPromises.push_back(std::move(parkedPromise));
+      return BlockingReason::kWaitForSplit;
+    }
 
-  if (isUngroupedExecution()) {
-    return getSplitOrFutureLocked(
-        splitsState.groupSplitsStores[0], split, future);
-  } else {
-    return getSplitOrFutureLocked(
-        splitsState.groupSplitsStores[splitGroupId], split, future);
+    reason = getSplitOrFutureLocked(
+        splitsStore, split, future, maxPreloadSplits, preload);
+    // The parked Drivers finish when there are no splits left.
+    if (splitsStore.noMoreSplits && splitsStore.splits.empty()) {
+      movePromisesOut(splitsStore.parkedPromises, parkedPromises);
+    }
+  }
+  for (auto& promise : parkedPromises) {
+    promise.setValue();
+  }
+  return reason;
+}
+
+void Task::setMaxActiveDrivers(
+    const core::PlanNodeId& planNodeId,
+    uint32_t maxDrivers) {
+  checkPlanNodeIdForSplit(planNodeId);
+  VELOX_CHECK_GT(maxDrivers, 0, "At least one Driver must read splits");
+  std::vector<ContinuePromise> parkedPromises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& splitsState = splitsStates_[planNodeId];
+    splitsState.maxActiveDrivers = maxDrivers;
+    // The parked Drivers check the new limit and park again if above it.
+    for (auto& [groupId, splitsStore] : splitsState.groupSplitsStores) {
+      movePromisesOut(splitsStore.parkedPromises, parkedPromises);
+    }
+  }
+  for (auto& promise : parkedPromises) {
+    promise.setValue();
   }
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
     SplitsStore& splitsStore,
     exec::Split& split,
-    ContinueFuture& future) {
+    ContinueFuture& future,
+    int32_t maxPreloadSplits,
+    const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+        preload) {
   if (splitsStore.splits.empty()) {
     if (splitsStore.noMoreSplits) {
       return BlockingReason::kNotBlocked;
@@ -948,6 +1077,16 @@ BlockingReason Task::getSplitOrFutureLocked(
   }
 
   split = getSplitLocked(splitsStore);
+  if (preload) {
+    const auto numPreload =
+        std::min<int32_t>(maxPreloadSplits, splitsStore.splits.size());
+    for (auto i = 0; i < numPreload; ++i) {
+      auto& connectorSplit = splitsStore.splits[i].connectorSplit;
+      if (connectorSplit && !connectorSplit->dataSource) {
+        preload(connectorSplit);
+      }
+    }
+  }
   return BlockingReason::kNotBlocked;
 }
 
@@ -974,6 +1113,11 @@ void Task::splitFinished() {
   }
 }
 
+void Task::addTraceEvent(const DriverTraceEvent& event) {
+  std::lock_guard<std::mutex> l(traceMutex_);
+  traceEvents_.push_back(event);
+}
+
 void Task::multipleSplitsFinished(int32_t numSplits) {
   std::lock_guard<std::mutex> l(mutex_);
   taskStats_.numFinishedSplits += numSplits;
@@ -1236,15 +1380,6 @@ std::string Task::shortId(const std::string& id) {
 }
 
 /// Moves split promises from one vector to another.
-static void movePromisesOut(
-    std::vector<ContinuePromise>& from,
-    std::vector<ContinuePromise>& to) {
-  for (auto& promise : from) {
-    to.push_back(std::move(promise));
-  }
-  from.clear();
-}
-
 ContinueFuture Task::terminate(TaskState terminalState) {
   std::vector<std::shared_ptr<Driver>> offThreadDrivers;
   TaskCompletionNotifier completionNotifier;
@@ -1336,6 +1471,13 @@ ContinueFuture Task::terminate(TaskState terminalState) {
       auto& splitState = pair.second;
       for (auto& it : pair.second.groupSplitsStores) {
         movePromisesOut(it.second.splitPromises, splitPromises);
+        movePromisesOut(it.second.parkedPromises, splitPromises);
+        // Stops the preloading of the splits that will not be read.
+        for (auto& split : it.second.splits) {
+          if (split.hasConnectorSplit()) {
+            split.connectorSplit->cancelled = true;
+          }
+        }
       }
 
       // Process remaining remote splits.
@@ -1418,6 +1560,10 @@ TaskStats Task::taskStats() const {
   // 'taskStats_' contains task stats plus stats for the completed drivers
   // (their operators).
   TaskStats taskStats = taskStats_;
+  {
+    std::lock_guard<std::mutex> traceLock(traceMutex_);
+    taskStats.traceEvents = traceEvents_;
+  }
 
   taskStats.numTotalDrivers = drivers_.size();
 
@@ -1447,6 +1593,81 @@ TaskStats Task::taskStats() const {
   return taskStats;
 }
 
+namespace {
+int64_t reservedBytes(memory::MemoryPool& pool) {
+  auto tracker = pool.getMemoryUsageTracker();
+  return tracker != nullptr ? tracker->totalReservedBytes() : 0;
+}
+} // namespace
+
+TaskMemorySnapshot Task::memorySnapshot() const {
+  TaskMemorySnapshot snapshot;
+  snapshot.taskId = taskId_;
+  snapshot.currentBytes = pool_->getCurrentBytes();
+  snapshot.peakBytes = pool_->getMaxBytes();
+  snapshot.reservedBytes = reservedBytes(*pool_);
+
+  std::lock_guard<std::mutex> l(mutex_);
+  snapshot.pipelines.resize(driverFactories_.size());
+  for (auto i = 0; i < snapshot.pipelines.size(); ++i) {
+    snapshot.pipelines[i].pipelineId = i;
+  }
+  for (const auto& driver : drivers_) {
+    // Finished drivers are null.
+    if (driver == nullptr) {
+      continue;
+    }
+    auto* driverCtx = driver->driverCtx();
+    VELOX_CHECK_LT(driverCtx->pipelineId, snapshot.pipelines.size());
+    auto& pipeline = snapshot.pipelines[driverCtx->pipelineId];
+    DriverMemorySnapshot driverSnapshot;
+    driverSnapshot.driverId = driverCtx->driverId;
+    for (auto* op : driver->operators()) {
+      OperatorMemorySnapshot opSnapshot;
+      opSnapshot.operatorId = op->operatorId();
+      opSnapshot.operatorType = op->operatorType();
+      opSnapshot.planNodeId = op->planNodeId();
+      auto* pool = op->pool();
+      opSnapshot.currentBytes = pool->getCurrentBytes();
+      opSnapshot.peakBytes = pool->getMaxBytes();
+      opSnapshot.reservedBytes = reservedBytes(*pool);
+      opSnapshot.breakdown = op->memoryBreakdown();
+      driverSnapshot.currentBytes += opSnapshot.currentBytes;
+      driverSnapshot.operators.push_back(std::move(opSnapshot));
+    }
+    pipeline.currentBytes += driverSnapshot.currentBytes;
+    pipeline.drivers.push_back(std::move(driverSnapshot));
+  }
+  return snapshot;
+}
+
+std::string TaskMemorySnapshot::toString() const {
+  std::stringstream out;
+  out << "Task " << taskId << ": current " << succinctBytes(currentBytes)
+      << " peak " << succinctBytes(peakBytes) << " reserved "
+      << succinctBytes(reservedBytes) << "\n";
+  for (const auto& pipeline : pipelines) {
+    out << "  Pipeline " << pipeline.pipelineId << ": current "
+        << succinctBytes(pipeline.currentBytes) << "\n";
+    for (const auto& driver : pipeline.drivers) {
+      out << "    Driver " << driver.driverId << ": current "
+          << succinctBytes(driver.currentBytes) << "\n";
+      for (const auto& op : driver.operators) {
+        out << "      " << op.operatorType << "(" << op.operatorId
+            << ") node " << op.planNodeId << ": current "
+            << succinctBytes(op.currentBytes) << " peak "
+            << succinctBytes(op.peakBytes) << " reserved "
+            << succinctBytes(op.reservedBytes);
+        for (const auto& [name, bytes] : op.breakdown) {
+          out << " " << name << " " << succinctBytes(bytes);
+        }
+        out << "\n";
+      }
+    }
+  }
+  return out.str();
+}
+
 uint64_t Task::timeSinceStartMs() const {
   std::lock_guard<std::mutex> l(mutex_);
   if (taskStats_.executionStartTimeMs == 0UL) {
@@ -1984,6 +2205,22 @@ std::string getQueryMemoryUsageString(memory::MemoryPool* queryPool) {
 }
 } // namespace
 
+uint32_t Task::requestSpill() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!isRunningLocked()) {
+    return 0;
+  }
+  uint32_t numGroups = 0;
+  for (auto& splitGroupEntry : splitGroupStates_) {
+    for (auto& groupEntry : splitGroupEntry.second.spillOperatorGroups) {
+      if (groupEntry.second->requestExternalSpill()) {
+        ++numGroups;
+      }
+    }
+  }
+  return numGroups;
+}
+
 std::shared_ptr<SpillOperatorGroup> Task::getSpillOperatorGroupLocked(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId) {
@@ -98,6 +98,11 @@ class Task : public std::enable_shared_from_this<Task> {
     return queryCtx_;
   }
 
+  /// Returns the current memory usage of 'this' broken down by pipeline,
+  /// driver and operator. Can be called while the task is running. Drivers
+  /// which have finished are not included.
+  TaskMemorySnapshot memorySnapshot() const;
+
   /// Returns MemoryPool used to allocate memory during execution. This instance
   /// is a child of the MemoryPool passed in the constructor.
   memory::MemoryPool* FOLLY_NONNULL pool() const {
@@ -196,6 +201,12 @@ class Task : public std::enable_shared_from_this<Task> {
   /// received after a call with noMoreBuffers == true are ignored.
   void updateBroadcastOutputBuffers(int numBuffers, bool noMoreBuffers);
 
+  /// Asks the spillable operators of this task to spill on their next input to
+  /// free memory, e.g. for a memory arbitrator reclaiming memory for another
+  /// query. The spill runs asynchronously on the task's drivers. Returns the
+  /// number of spill operator groups asked to spill.
+  uint32_t requestSpill();
+
   /// Returns true if state is 'running'.
   bool isRunning() const;
 
@@ -278,6 +289,17 @@ class Task : public std::enable_shared_from_this<Task> {
       int pipelineId,
       const std::string& operatorType);
 
+  /// Returns 'exprs' of the plan node 'planNodeId' with their constant
+  /// subexpressions folded, see exec::foldConstants(). The first call for a
+  /// plan node folds with 'execCtx', the later calls from the operators of the
+  /// other drivers of the node return the same expressions, so that constants
+  /// are evaluated once per task instead of once per driver. Not thread safe,
+  /// e.g. must be called from the Operator's constructor.
+  std::vector<core::TypedExprPtr> foldedExprs(
+      const core::PlanNodeId& planNodeId,
+      const std::vector<core::TypedExprPtr>& exprs,
+      core::ExecCtx* FOLLY_NONNULL execCtx);
+
   /// Creates new instance of MappedMemory, stores it in the task to ensure
   /// lifetime and returns a raw pointer. Not thread safe, e.g. must be called
   /// from the Operator's constructor.
@@ -296,15 +318,37 @@ class Task : public std::enable_shared_from_this<Task> {
   // specified ID. If there are no splits and no-more-splits signal has been
   // received, sets split to null and returns kNotBlocked. Otherwise, returns
   // kWaitForSplit and sets a future that will complete when split becomes
-  // available or no-more-splits signal is received.
+  // available or no-more-splits signal is received. If a split is returned,
+  // calls 'preload' on up to 'maxPreloadSplits' of the next queued splits
+  // that are not yet preloaded. If 'driverId' is at or above the limit set by
+  // setMaxActiveDrivers(), returns kWaitForSplit until the limit is raised or
+  // no splits are left.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
       exec::Split& split,
-      ContinueFuture& future);
+      ContinueFuture& future,
+      int32_t maxPreloadSplits = 0,
+      std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload =
+          nullptr,
+      uint32_t driverId = 0);
+
+  /// Lets only the Drivers with ids below 'maxDrivers' take splits of the
+  /// source 'planNodeId'. The other Drivers finish their current split and
+  /// wait until the limit is raised or there are no splits left, and then
+  /// finish. Lets a scheduler scale a running pipeline between 1 and the
+  /// number of Drivers it was started with depending on the load, e.g. start
+  /// a scan with many Drivers and retire some when the executor is
+  /// oversubscribed. May be called before start().
+  void setMaxActiveDrivers(
+      const core::PlanNodeId& planNodeId,
+      uint32_t maxDrivers);
 
   void splitFinished();
 
+  /// Appends 'event' to TaskStats::traceEvents.
+  void addTraceEvent(const DriverTraceEvent& event);
+
   void multipleSplitsFinished(int32_t numSplits);
 
   /// Adds a MergeSource for the specified splitGroupId and planNodeId.
@@ -557,7 +601,10 @@ class Task : public std::enable_shared_from_this<Task> {
   BlockingReason getSplitOrFutureLocked(
       SplitsStore& splitsStore,
       exec::Split& split,
-      ContinueFuture& future);
+      ContinueFuture& future,
+      int32_t maxPreloadSplits,
+      const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+          preload);
 
   /// Returns next split from the store. The caller must ensure the store is not
   /// empty.
@@ -620,6 +667,11 @@ class Task : public std::enable_shared_from_this<Task> {
   /// that's not the case.
   void checkPlanNodeIdForSplit(const core::PlanNodeId& id) const;
 
+  /// Returns true if 'split' for the table scan 'planNodeId' has no rows that
+  /// pass the filters of the scan according to Connector::testSplit. Splits
+  /// of split groups are not pruned.
+  bool pruneSplit(const core::PlanNodeId& planNodeId, const exec::Split& split);
+
   // Sets this to a terminal requested state and frees all resources
   // of Drivers that are not presently on thread. Unblocks all waiting
   // Drivers, e.g.  Drivers waiting for free space in outgoing buffers
@@ -750,6 +802,12 @@ class Task : public std::enable_shared_from_this<Task> {
   // NOTE: ''childPools_' holds the ownerships of node memory pools.
   std::unordered_map<core::PlanNodeId, memory::MemoryPool*> nodePools_;
 
+  // The expressions of plan nodes with folded constants. The vectors of the
+  // constants come from the pool of the first operator of the node, which
+  // 'childPools_' keeps alive.
+  std::unordered_map<core::PlanNodeId, std::vector<core::TypedExprPtr>>
+      foldedExprs_;
+
   // Keep operator MappedMemory instances alive for the duration of the task to
   // allow for sharing data without copy.
   std::vector<std::shared_ptr<memory::MappedMemory>> childMappedMemories_;
@@ -758,6 +816,13 @@ class Task : public std::enable_shared_from_this<Task> {
   // node IDs specified in split management methods.
   const std::unordered_set<core::PlanNodeId> splitPlanNodeIds_;
 
+  // The table scans of the plan keyed on plan node ID. Used for pruning the
+  // splits they are given.
+  const std::unordered_map<
+      core::PlanNodeId,
+      std::shared_ptr<const core::TableScanNode>>
+      tableScanNodes_;
+
   // True if produces output via PartitionedOutputBufferManager.
   bool hasPartitionedOutput_ = false;
   // Set to true by PartitionedOutputBufferManager when all output is
@@ -838,6 +903,11 @@ class Task : public std::enable_shared_from_this<Task> {
 
   TaskStats taskStats_;
 
+  /// Trace events of the Drivers. Guarded by 'traceMutex_' instead of
+  /// 'mutex_' since blocked intervals are added under 'mutex_'.
+  mutable std::mutex traceMutex_;
+  std::vector<DriverTraceEvent> traceEvents_;
+
   /// Stores inter-operator state (exchange, bridges) per split group.
   /// During ungrouped execution we use the [0] entry in this vector.
   std::unordered_map<uint32_t, SplitGroupState> splitGroupStates_;
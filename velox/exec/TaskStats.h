@@ -16,6 +16,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -49,6 +50,9 @@ struct TaskStats {
   int32_t numFinishedSplits{0};
   int32_t numRunningSplits{0};
   int32_t numQueuedSplits{0};
+  /// Splits dropped by Connector::testSplit when added. These are not counted
+  /// in the other split counts.
+  int32_t numPrunedSplits{0};
   std::unordered_set<int32_t> completedSplitGroups;
 
   /// The subscript is given by each Operator's
@@ -85,6 +89,57 @@ struct TaskStats {
   uint64_t numRunningDrivers{0};
   /// Drivers blocked for various reasons. Based on enum BlockingReason.
   std::unordered_map<BlockingReason, uint64_t> numBlockedDrivers;
+
+  /// Run, queued and blocked intervals of the Drivers in the order they
+  /// ended. Empty unless QueryConfig::kDriverTraceEvents is set.
+  std::vector<DriverTraceEvent> traceEvents;
+};
+
+/// Live memory usage of an operator. See Task::memorySnapshot().
+struct OperatorMemorySnapshot {
+  int32_t operatorId;
+  std::string operatorType;
+  std::string planNodeId;
+
+  /// Bytes currently allocated from the memory pool of the operator.
+  int64_t currentBytes{0};
+
+  /// Peak bytes allocated from the memory pool of the operator.
+  int64_t peakBytes{0};
+
+  /// Bytes reserved in the memory usage tracker of the operator, including
+  /// the unused part of the reservation.
+  int64_t reservedBytes{0};
+
+  /// The memory held by the data structures of the operator, e.g. its
+  /// RowContainer and HashStringAllocator, as last reported by the operator.
+  std::unordered_map<std::string, int64_t> breakdown;
+};
+
+/// Live memory usage of the operators of a Driver.
+struct DriverMemorySnapshot {
+  int32_t driverId;
+  int64_t currentBytes{0};
+  std::vector<OperatorMemorySnapshot> operators;
+};
+
+/// Live memory usage of the running Drivers of a pipeline.
+struct PipelineMemorySnapshot {
+  int32_t pipelineId;
+  int64_t currentBytes{0};
+  std::vector<DriverMemorySnapshot> drivers;
+};
+
+/// Live memory usage of a Task broken down by pipeline, driver and operator.
+struct TaskMemorySnapshot {
+  std::string taskId;
+  int64_t currentBytes{0};
+  int64_t peakBytes{0};
+  int64_t reservedBytes{0};
+  /// The subscript is the pipeline id.
+  std::vector<PipelineMemorySnapshot> pipelines;
+
+  std::string toString() const;
 };
 
 } // namespace facebook::velox::exec
@@ -48,6 +48,10 @@ struct SplitsStore {
   bool noMoreSplits{false};
   /// Blocking promises given out when out of splits to distribute.
   std::vector<ContinuePromise> splitPromises;
+  /// Blocking promises given out to Drivers above the active Driver limit of
+  /// the plan node. Fulfilled when the limit changes and when no splits are
+  /// left.
+  std::vector<ContinuePromise> parkedPromises;
 };
 
 /// Structure contains the current info on splits for a particular plan node.
@@ -58,6 +62,10 @@ struct SplitsState {
   /// Keep the max added split's sequence id to deduplicate incoming splits.
   long maxSequenceId{std::numeric_limits<long>::min()};
 
+  /// Drivers with ids at or above this do not get splits. See
+  /// Task::setMaxActiveDrivers().
+  uint32_t maxActiveDrivers{std::numeric_limits<uint32_t>::max()};
+
   /// Map split group id -> split store.
   std::unordered_map<uint32_t, SplitsStore> groupSplitsStores;
 
@@ -15,9 +15,77 @@
  */
 #include "velox/exec/TopN.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+
+namespace {
+// Returns the projections from the output columns to the columns stored in the
+// row container. The sorting key columns are stored first so that they can be
+// used by the sorted spilling.
+std::vector<IdentityProjection> makeColumnMap(
+    const RowTypePtr& type,
+    const core::TopNNode& topNNode) {
+  std::vector<IdentityProjection> columnMap;
+  std::unordered_set<column_index_t> keyChannelSet;
+  const auto& sortingKeys = topNNode.sortingKeys();
+  for (int i = 0; i < sortingKeys.size(); ++i) {
+    const auto channel = exprToChannel(sortingKeys[i].get(), type);
+    VELOX_CHECK(
+        channel != kConstantChannel,
+        "TopN doesn't allow constant comparison keys");
+    columnMap.emplace_back(i, channel);
+    keyChannelSet.emplace(channel);
+  }
+  for (column_index_t outputChannel = 0, nextInputChannel = sortingKeys.size();
+       outputChannel < type->size();
+       ++outputChannel) {
+    if (keyChannelSet.count(outputChannel) == 0) {
+      columnMap.emplace_back(nextInputChannel++, outputChannel);
+    }
+  }
+  return columnMap;
+}
+
+RowTypePtr makeStoreType(
+    const RowTypePtr& type,
+    const std::vector<IdentityProjection>& columnMap) {
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (const auto& projection : columnMap) {
+    names.push_back(type->nameOf(projection.outputChannel));
+    types.push_back(type->childAt(projection.outputChannel));
+  }
+  return ROW(std::move(names), std::move(types));
+}
+
+std::vector<CompareFlags> makeCompareFlags(const core::TopNNode& topNNode) {
+  std::vector<CompareFlags> compareFlags;
+  for (const auto& sortOrder : topNNode.sortingOrders()) {
+    compareFlags.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false});
+  }
+  return compareFlags;
+}
+
+std::vector<std::pair<column_index_t, CompareFlags>> makeKeyInfo(
+    const std::vector<IdentityProjection>& columnMap,
+    const std::vector<CompareFlags>& compareFlags) {
+  std::vector<std::pair<column_index_t, CompareFlags>> keyInfo;
+  for (auto i = 0; i < compareFlags.size(); ++i) {
+    keyInfo.emplace_back(columnMap[i].outputChannel, compareFlags[i]);
+  }
+  return keyInfo;
+}
+
+std::vector<TypePtr>
+columnTypes(const RowTypePtr& type, column_index_t begin, column_index_t end) {
+  return {type->children().begin() + begin, type->children().begin() + end};
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -29,35 +97,33 @@ TopN::TopN(
           topNNode->id(),
           "TopN"),
       count_(topNNode->count()),
+      mappedMemory_(operatorCtx_->mappedMemory()),
+      spillMemoryThreshold_(
+          operatorCtx_->driverCtx()->queryConfig().topNSpillMemoryThreshold()),
+      spillConfig_(operatorCtx_->makeSpillConfig(Spiller::Type::kTopN)),
+      columnMap_(makeColumnMap(outputType_, *topNNode)),
+      keyCompareFlags_(makeCompareFlags(*topNNode)),
+      internalStoreType_(makeStoreType(outputType_, columnMap_)),
       data_(std::make_unique<RowContainer>(
-          outputType_->children(),
-          operatorCtx_->mappedMemory())),
-      comparator_(
-          outputType_,
-          topNNode->sortingKeys(),
-          topNNode->sortingOrders(),
-          data_.get()),
+          columnTypes(internalStoreType_, 0, keyCompareFlags_.size()),
+          columnTypes(
+              internalStoreType_,
+              keyCompareFlags_.size(),
+              internalStoreType_->size()),
+          mappedMemory_)),
+      comparator_(makeKeyInfo(columnMap_, keyCompareFlags_), data_.get()),
       topRows_(comparator_),
+      thresholdData_(std::make_unique<RowContainer>(
+          columnTypes(internalStoreType_, 0, keyCompareFlags_.size()),
+          mappedMemory_)),
+      thresholdComparator_(
+          makeKeyInfo(columnMap_, keyCompareFlags_),
+          thresholdData_.get()),
       decodedVectors_(outputType_->children().size()) {}
 
-TopN::Comparator::Comparator(
-    const RowTypePtr& type,
-    const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-        sortingKeys,
-    const std::vector<core::SortOrder>& sortingOrders,
-    RowContainer* rowContainer)
-    : rowContainer_(rowContainer) {
-  auto numKeys = sortingKeys.size();
-  for (int i = 0; i < numKeys; ++i) {
-    auto channel = exprToChannel(sortingKeys[i].get(), type);
-    VELOX_CHECK(
-        channel != kConstantChannel,
-        "TopN doesn't allow constant comparison keys");
-    keyInfo_.push_back(std::make_pair(channel, sortingOrders[i]));
-  }
-}
-
 void TopN::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   SelectivityVector allRows(input->size());
 
   // TODO Decode keys first, then decode the rest only for passing positions
@@ -68,6 +134,10 @@ void TopN::addInput(RowVectorPtr input) {
   for (int row = 0; row < input->size(); ++row) {
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
+      if (thresholdRow_ != nullptr &&
+          thresholdComparator_(thresholdRow_, decodedVectors_, row)) {
+        continue;
+      }
       newRow = data_->newRow();
     } else {
       char* topRow = topRows_.top();
@@ -80,40 +150,230 @@ void TopN::addInput(RowVectorPtr input) {
       newRow = data_->initializeRow(topRow, true /* reuse */);
     }
 
-    for (int col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedVectors_[col], row, newRow, col);
+    for (const auto& projection : columnMap_) {
+      data_->store(
+          decodedVectors_[projection.outputChannel],
+          row,
+          newRow,
+          projection.inputChannel);
     }
 
     topRows_.push(newRow);
   }
 }
 
+void TopN::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    spill();
+    return;
+  }
+
+  auto tracker = mappedMemory_->tracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->getCurrentUserBytes();
+  if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
+    spill();
+    return;
+  }
+
+  // The heap never holds more than 'count_' rows, so a full heap only replaces
+  // rows and needs no new row space.
+  const int64_t numNewRows =
+      std::min<int64_t>(input->size(), std::max<int64_t>(0, count_ - numRows));
+  if (freeRows >= numNewRows &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(numNewRows, outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  spill();
+}
+
+void TopN::spill() {
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK(mappedMemory_->tracker() != nullptr);
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kTopN,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        keyCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionType);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  if (topRows_.size() == count_) {
+    updateThreshold();
+  }
+  spiller_->spill(0, 0);
+  topRows_ = std::priority_queue<char*, std::vector<char*>, Comparator>(
+      comparator_);
+  updateSpillStats();
+}
+
+void TopN::updateThreshold() {
+  char* topRow = topRows_.top();
+  if (thresholdRow_ == nullptr) {
+    thresholdRow_ = thresholdData_->newRow();
+  } else {
+    thresholdRow_ = thresholdData_->initializeRow(thresholdRow_, true);
+  }
+  const SelectivityVector row(1);
+  for (auto i = 0; i < keyCompareFlags_.size(); ++i) {
+    auto key = BaseVector::create(internalStoreType_->childAt(i), 1, pool());
+    data_->extractColumn(&topRow, 1, i, key);
+    DecodedVector decoded(*key, row);
+    thresholdData_->store(decoded, 0, thresholdRow_, i);
+  }
+}
+
+void TopN::updateSpillStats() {
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
+}
+
 RowVectorPtr TopN::getOutput() {
   if (finished_ || !noMoreInput_) {
     return nullptr;
   }
 
+  const auto numRows =
+      spiller_ == nullptr ? rows_.size() : numSpilledRowsToReturn_;
   uint32_t numRowsToReturn =
-      std::min(kMaxNumRowsToReturn, rows_.size() - numRowsReturned_);
+      std::min<uint32_t>(kMaxNumRowsToReturn, numRows - numRowsReturned_);
   VELOX_CHECK(numRowsToReturn > 0);
 
-  auto result = std::dynamic_pointer_cast<RowVector>(
+  RowVectorPtr result;
+  if (spiller_ != nullptr) {
+    result = getOutputWithSpill(numRowsToReturn);
+  } else {
+    result = std::dynamic_pointer_cast<RowVector>(BaseVector::create(
+        outputType_, numRowsToReturn, operatorCtx_->pool()));
+    for (const auto& projection : columnMap_) {
+      data_->extractColumn(
+          rows_.data() + numRowsReturned_,
+          numRowsToReturn,
+          projection.inputChannel,
+          result->childAt(projection.outputChannel));
+    }
+  }
+  numRowsReturned_ += numRowsToReturn;
+  finished_ = (numRowsReturned_ == numRows);
+  return result;
+}
+
+RowVectorPtr TopN::getOutputWithSpill(vector_size_t numRowsToReturn) {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  auto result = std::static_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numRowsToReturn, operatorCtx_->pool()));
 
-  for (int i = 0; i < outputType_->size(); ++i) {
-    data_->extractColumn(
-        rows_.data() + numRowsReturned_,
-        numRowsToReturn,
-        i,
-        result->childAt(i));
+  int32_t outputRow = 0;
+  int32_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < numRowsToReturn) {
+    SpillMergeStream* stream = spillMerge_->next();
+    VELOX_CHECK_NOT_NULL(stream);
+
+    spillSources_[outputSize] = &stream->current();
+    spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
+    ++outputSize;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherCopy(
+          result.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+
+    // Advance the stream.
+    stream->pop();
+  }
+
+  if (FOLLY_LIKELY(outputSize != 0)) {
+    gatherCopy(
+        result.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
   }
-  numRowsReturned_ += numRowsToReturn;
-  finished_ = (numRowsReturned_ == rows_.size());
   return result;
 }
 
 void TopN::noMoreInput() {
   Operator::noMoreInput();
+  if (spiller_ != nullptr) {
+    // There is only one partition, so there are no rows from non-spilled
+    // partitions. The rows left in the heap are merged from 'data_' with the
+    // spilled runs.
+    VELOX_CHECK(spiller_->finishSpill().empty());
+    updateSpillStats();
+    numSpilledRowsToReturn_ = std::min<uint64_t>(
+        count_, spiller_->stats().spilledRows + data_->numRows());
+    if (numSpilledRowsToReturn_ == 0) {
+      finished_ = true;
+      return;
+    }
+    spillMerge_ = spiller_->startMerge(0);
+    spillSources_.resize(kMaxNumRowsToReturn);
+    spillSourceRows_.resize(kMaxNumRowsToReturn);
+    return;
+  }
   if (topRows_.empty()) {
     finished_ = true;
     return;
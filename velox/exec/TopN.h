@@ -17,9 +17,16 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+/// TopN keeps the 'count' smallest rows of its input in a heap of rows stored
+/// in a RowContainer. If spilling is enabled and the heap does not fit in
+/// memory, the heap is spilled as a sorted run and the operator continues with
+/// an empty heap. The output is then produced by merging the spilled runs. A
+/// spilled full heap provides a threshold row: later input rows that sort
+/// after it can't be in the result and are dropped without being stored.
 class TopN : public Operator {
  public:
   TopN(
@@ -47,24 +54,21 @@ class TopN : public Operator {
   static constexpr size_t kMaxNumRowsToReturn = 1024;
   class Comparator {
    public:
+    // 'keyInfo' is the channel of each key in the input vectors and its
+    // compare flags. The key columns are the first columns of 'rowContainer'.
     Comparator(
-        const RowTypePtr& outputType,
-        const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-            sortingKeys,
-        const std::vector<core::SortOrder>& sortingOrders,
-        RowContainer* rowContainer);
+        std::vector<std::pair<column_index_t, CompareFlags>> keyInfo,
+        RowContainer* rowContainer)
+        : keyInfo_(std::move(keyInfo)), rowContainer_(rowContainer) {}
 
     // Returns true if lhs < rhs, false otherwise.
     bool operator()(const char* lhs, const char* rhs) {
       if (lhs == rhs) {
         return false;
       }
-      for (auto& key : keyInfo_) {
-        if (auto result = rowContainer_->compare(
-                lhs,
-                rhs,
-                key.first,
-                {key.second.isNullsFirst(), key.second.isAscending(), false})) {
+      for (auto i = 0; i < keyInfo_.size(); ++i) {
+        if (auto result =
+                rowContainer_->compare(lhs, rhs, i, keyInfo_[i].second)) {
           return result < 0;
         }
       }
@@ -76,13 +80,13 @@ class TopN : public Operator {
         const char* lhs,
         const std::vector<DecodedVector>& decodedVectors,
         vector_size_t index) {
-      for (auto& key : keyInfo_) {
+      for (auto i = 0; i < keyInfo_.size(); ++i) {
         if (auto result = rowContainer_->compare(
                 lhs,
-                rowContainer_->columnAt(key.first),
-                decodedVectors[key.first],
+                rowContainer_->columnAt(i),
+                decodedVectors[keyInfo_[i].first],
                 index,
-                {key.second.isNullsFirst(), key.second.isAscending(), false})) {
+                keyInfo_[i].second)) {
           return result < 0;
         }
       }
@@ -90,15 +94,53 @@ class TopN : public Operator {
     }
 
    private:
-    std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+    std::vector<std::pair<column_index_t, CompareFlags>> keyInfo_;
     RowContainer* rowContainer_;
   };
 
+  // Checks if the heap will fit in the existing memory after adding 'input'
+  // and increases reservation if not. If reservation cannot be increased,
+  // spills the heap.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills all rows of the heap as one sorted run and resets the heap. If the
+  // heap is full, its top becomes the new threshold row.
+  void spill();
+
+  // Copies the sort keys of the top of the full heap into 'thresholdRow_'.
+  void updateThreshold();
+
+  void updateSpillStats();
+
+  RowVectorPtr getOutputWithSpill(vector_size_t numRowsToReturn);
+
   const int32_t count_;
 
+  memory::MappedMemory* const mappedMemory_;
+
+  // The maximum memory usage that a top n can hold before spilling. If it is
+  // zero, then there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
+  // The map from column channel in the input and output to the corresponding
+  // one stored in 'data_'. The sorting key columns are stored first.
+  std::vector<IdentityProjection> columnMap_;
+
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  // The row type used to store input data in row container and for spilling
+  // internally.
+  RowTypePtr internalStoreType_;
+
   bool finished_ = false;
   uint32_t numRowsReturned_ = 0;
 
+  // The number of rows to return after the spilled runs are merged.
+  uint32_t numSpilledRowsToReturn_ = 0;
+
   // As the inputs are added to TopN operator, we use topRows_ (a priority
   // queue) to keep track of the pointers to rows stored in the
   // RowContainer (data_). We only update the RowContainer if a row is a
@@ -113,6 +155,25 @@ class TopN : public Operator {
   std::priority_queue<char*, std::vector<char*>, Comparator> topRows_;
   std::vector<char*> rows_;
 
+  // Holds the sort keys of the top of the last spilled full heap. Input rows
+  // which are greater than 'thresholdRow_' are not in the result.
+  std::unique_ptr<RowContainer> thresholdData_;
+  Comparator thresholdComparator_;
+  char* thresholdRow_ = nullptr;
+
   std::vector<DecodedVector> decodedVectors_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_';.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Record the source rows to copy to the output in order.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/TopNRowNumber.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+column_index_t keyChannel(
+    const core::FieldAccessTypedExprPtr& key,
+    const RowTypePtr& inputType) {
+  const auto channel = exprToChannel(key.get(), inputType);
+  VELOX_CHECK(
+      channel != kConstantChannel,
+      "TopNRowNumber doesn't allow constant partition or sort keys");
+  return channel;
+}
+
+std::vector<TypePtr>
+columnTypes(const RowTypePtr& type, column_index_t begin, column_index_t end) {
+  return {type->children().begin() + begin, type->children().begin() + end};
+}
+
+// The spilled rows are merged on the keys of 'data_', so that spilling needs at
+// least one key.
+bool hasKeys(const core::TopNRowNumberNode& node) {
+  return !node.partitionKeys().empty() || !node.sortingKeys().empty();
+}
+} // namespace
+
+TopNRowNumber::TopNRowNumber(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::TopNRowNumberNode>& node)
+    : Operator(
+          driverCtx,
+          node->outputType(),
+          operatorId,
+          node->id(),
+          "TopNRowNumber"),
+      limit_(node->limit()),
+      generateRowNumber_(node->generateRowNumber()),
+      numPartitionKeys_(node->partitionKeys().size()),
+      mappedMemory_(operatorCtx_->mappedMemory()),
+      spillMemoryThreshold_(
+          operatorCtx_->driverCtx()->queryConfig().topNSpillMemoryThreshold()),
+      spillConfig_(
+          hasKeys(*node)
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kTopN)
+              : std::nullopt),
+      comparator_(&sortKeyInfo_, numPartitionKeys_, nullptr) {
+  const auto& inputType = node->sources()[0]->outputType();
+
+  // Store the partition keys followed by the sort keys first in 'data_'. The
+  // sort keys which are also partition keys are left out as they are the same
+  // for all the rows of a partition.
+  std::vector<bool> isStored(inputType->size(), false);
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  for (const auto& key : node->partitionKeys()) {
+    const auto channel = keyChannel(key, inputType);
+    VELOX_USER_CHECK(
+        !isStored[channel],
+        "TopNRowNumber partition keys must be unique: {}",
+        key->name());
+    isStored[channel] = true;
+    columnMap_.emplace_back(columnMap_.size(), channel);
+    hashers.push_back(
+        VectorHasher::create(inputType->childAt(channel), channel));
+    spillCompareFlags_.push_back(CompareFlags());
+  }
+  const auto& sortingOrders = node->sortingOrders();
+  for (auto i = 0; i < node->sortingKeys().size(); ++i) {
+    const auto channel = keyChannel(node->sortingKeys()[i], inputType);
+    if (isStored[channel]) {
+      continue;
+    }
+    isStored[channel] = true;
+    const CompareFlags flags{
+        sortingOrders[i].isNullsFirst(),
+        sortingOrders[i].isAscending(),
+        false,
+        false};
+    sortKeyInfo_.emplace_back(channel, flags);
+    columnMap_.emplace_back(columnMap_.size(), channel);
+    spillCompareFlags_.push_back(flags);
+  }
+  const auto numKeys = columnMap_.size();
+  for (column_index_t channel = 0; channel < inputType->size(); ++channel) {
+    if (!isStored[channel]) {
+      columnMap_.emplace_back(columnMap_.size(), channel);
+    }
+  }
+
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (const auto& projection : columnMap_) {
+    names.push_back(inputType->nameOf(projection.outputChannel));
+    types.push_back(inputType->childAt(projection.outputChannel));
+  }
+  internalStoreType_ = ROW(std::move(names), std::move(types));
+  data_ = std::make_unique<RowContainer>(
+      columnTypes(internalStoreType_, 0, numKeys),
+      columnTypes(internalStoreType_, numKeys, internalStoreType_->size()),
+      mappedMemory_);
+  comparator_ = Comparator(&sortKeyInfo_, numPartitionKeys_, data_.get());
+  decodedVectors_.resize(inputType->size());
+
+  if (hashers.empty()) {
+    // All the rows are in a single partition.
+    partitions_.emplace_back(comparator_);
+    return;
+  }
+  static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+  table_ = std::make_unique<HashTable<false>>(
+      std::move(hashers),
+      kNoAggregates,
+      std::vector<TypePtr>{BIGINT()},
+      false, // allowDuplicates
+      false, // isJoinBuild
+      false, // hasProbedFlag
+      mappedMemory_);
+  table_->forceGenericHashMode();
+  lookup_ = std::make_unique<HashLookup>(table_->hashers());
+  partitionIndexOffset_ =
+      table_->rows()->columnAt(numPartitionKeys_).offset();
+}
+
+void TopNRowNumber::probePartitions(const RowVectorPtr& input) {
+  const SelectivityVector rows(input->size());
+  auto& hashers = lookup_->hashers;
+  lookup_->reset(input->size());
+  for (auto i = 0; i < hashers.size(); ++i) {
+    hashers[i]->decode(*input->childAt(hashers[i]->channel()), rows);
+    hashers[i]->hash(rows, i > 0, lookup_->hashes);
+  }
+  std::iota(lookup_->rows.begin(), lookup_->rows.end(), 0);
+  table_->groupProbe(*lookup_);
+
+  for (auto row : lookup_->newGroups) {
+    RowContainer::valueAt<int64_t>(
+        lookup_->hits[row], partitionIndexOffset_) = partitions_.size();
+    partitions_.emplace_back(comparator_);
+  }
+}
+
+TopNRowNumber::TopRows& TopNRowNumber::partitionOf(vector_size_t row) {
+  if (table_ == nullptr) {
+    return partitions_[0];
+  }
+  return partitions_[RowContainer::valueAt<int64_t>(
+      lookup_->hits[row], partitionIndexOffset_)];
+}
+
+void TopNRowNumber::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
+  if (table_ != nullptr) {
+    probePartitions(input);
+  }
+
+  SelectivityVector allRows(input->size());
+  for (int col = 0; col < input->childrenSize(); ++col) {
+    decodedVectors_[col].decode(*input->childAt(col), allRows);
+  }
+
+  for (vector_size_t row = 0; row < input->size(); ++row) {
+    auto& topRows = partitionOf(row);
+    char* newRow = nullptr;
+    if (topRows.size() < limit_) {
+      newRow = data_->newRow();
+    } else {
+      char* topRow = topRows.top();
+      if (comparator_(topRow, decodedVectors_, row)) {
+        continue;
+      }
+      topRows.pop();
+      // Reuse the topRow's memory.
+      newRow = data_->initializeRow(topRow, true /* reuse */);
+    }
+
+    for (const auto& projection : columnMap_) {
+      data_->store(
+          decodedVectors_[projection.outputChannel],
+          row,
+          newRow,
+          projection.inputChannel);
+    }
+    topRows.push(newRow);
+  }
+}
+
+void TopNRowNumber::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    spill();
+    return;
+  }
+
+  auto tracker = mappedMemory_->tracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->getCurrentUserBytes();
+  if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
+    spill();
+    return;
+  }
+
+  // Each input row may start a new partition, so that the number of new rows
+  // is bounded only by the input size.
+  const int64_t numNewRows = input->size();
+  const int64_t tableIncrementBytes =
+      table_ == nullptr ? 0 : table_->hashTableSizeIncrease(numNewRows);
+  if (freeRows >= numNewRows && tableIncrementBytes == 0 &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes = tableIncrementBytes +
+      data_->sizeIncrement(numNewRows, outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  spill();
+}
+
+void TopNRowNumber::spill() {
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK(mappedMemory_->tracker() != nullptr);
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kTopN,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        spillCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionType);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(0, 0);
+
+  // The partitions start over with empty heaps.
+  partitions_.clear();
+  if (table_ != nullptr) {
+    table_->clear();
+  } else {
+    partitions_.emplace_back(comparator_);
+  }
+  updateSpillStats();
+}
+
+void TopNRowNumber::updateSpillStats() {
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
+}
+
+void TopNRowNumber::noMoreInput() {
+  Operator::noMoreInput();
+  if (spiller_ != nullptr) {
+    // There is only one partition, so there are no rows from non-spilled
+    // partitions. The rows left in the heaps are merged from 'data_' with the
+    // spilled runs.
+    VELOX_CHECK(spiller_->finishSpill().empty());
+    updateSpillStats();
+    partitions_.clear();
+    spillMerge_ = spiller_->startMerge(0);
+    spillPartitionKeys_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(internalStoreType_, 1, pool()));
+    spillSources_.resize(kMaxNumRowsToReturn);
+    spillSourceRows_.resize(kMaxNumRowsToReturn);
+    return;
+  }
+
+  // The rows of each partition are output in order.
+  for (auto& topRows : partitions_) {
+    const auto numPartitionRows = topRows.size();
+    const auto begin = rows_.size();
+    rows_.resize(begin + numPartitionRows);
+    for (auto i = rows_.size(); i > begin; --i) {
+      rows_[i - 1] = topRows.top();
+      topRows.pop();
+    }
+    if (generateRowNumber_) {
+      for (auto i = 0; i < numPartitionRows; ++i) {
+        rowNumbers_.push_back(i + 1);
+      }
+    }
+  }
+  partitions_.clear();
+  finished_ = rows_.empty();
+}
+
+RowVectorPtr TopNRowNumber::getOutput() {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  if (spiller_ != nullptr) {
+    return getOutputWithSpill();
+  }
+
+  const vector_size_t numRows = std::min<vector_size_t>(
+      kMaxNumRowsToReturn, rows_.size() - numRowsReturned_);
+  auto result = std::static_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numRows, operatorCtx_->pool()));
+  for (const auto& projection : columnMap_) {
+    data_->extractColumn(
+        rows_.data() + numRowsReturned_,
+        numRows,
+        projection.inputChannel,
+        result->childAt(projection.outputChannel));
+  }
+  if (generateRowNumber_) {
+    auto* rowNumbers = result->children().back()->asFlatVector<int64_t>();
+    std::copy_n(
+        rowNumbers_.data() + numRowsReturned_,
+        numRows,
+        rowNumbers->mutableRawValues());
+  }
+  numRowsReturned_ += numRows;
+  finished_ = (numRowsReturned_ == rows_.size());
+  return result;
+}
+
+bool TopNRowNumber::isInSpillPartition(const SpillMergeStream& stream) const {
+  if (numSpillPartitionRows_ == 0) {
+    // No partition has been read back yet.
+    return false;
+  }
+  const auto index = stream.currentIndex();
+  for (auto i = 0; i < numPartitionKeys_; ++i) {
+    if (!stream.current().childAt(i)->equalValueAt(
+            spillPartitionKeys_->childAt(i).get(), index, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RowVectorPtr TopNRowNumber::getOutputWithSpill() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  auto result = std::static_pointer_cast<RowVector>(BaseVector::create(
+      outputType_, kMaxNumRowsToReturn, operatorCtx_->pool()));
+  auto* rowNumbers = generateRowNumber_
+      ? result->children().back()->asFlatVector<int64_t>()
+      : nullptr;
+
+  // The merged rows are sorted on the partition keys followed by the sort
+  // keys. The first 'limit_' rows of each partition are output.
+  vector_size_t outputRow = 0;
+  vector_size_t numSourceRows = 0;
+  auto gatherSourceRows = [&]() {
+    gatherCopy(
+        result.get(),
+        outputRow,
+        numSourceRows,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+    outputRow += numSourceRows;
+    numSourceRows = 0;
+  };
+  while (outputRow + numSourceRows < kMaxNumRowsToReturn) {
+    SpillMergeStream* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      finished_ = true;
+      break;
+    }
+
+    bool isEndOfBatch = false;
+    const auto index = stream->currentIndex(&isEndOfBatch);
+    if (!isInSpillPartition(*stream)) {
+      for (auto i = 0; i < numPartitionKeys_; ++i) {
+        spillPartitionKeys_->childAt(i)->copy(
+            stream->current().childAt(i).get(), 0, index, 1);
+      }
+      numSpillPartitionRows_ = 0;
+    }
+    if (numSpillPartitionRows_ < limit_) {
+      ++numSpillPartitionRows_;
+      if (rowNumbers != nullptr) {
+        rowNumbers->set(outputRow + numSourceRows, numSpillPartitionRows_);
+      }
+      spillSources_[numSourceRows] = &stream->current();
+      spillSourceRows_[numSourceRows] = index;
+      ++numSourceRows;
+    }
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherSourceRows();
+    }
+
+    // Advance the stream.
+    stream->pop();
+  }
+  gatherSourceRows();
+
+  if (outputRow == 0) {
+    return nullptr;
+  }
+  result->resize(outputRow);
+  return result;
+}
+
+} // namespace facebook::velox::exec
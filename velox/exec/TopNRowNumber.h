@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/HashTable.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
+
+namespace facebook::velox::exec {
+
+/// TopNRowNumber keeps the first 'limit' rows of each window partition in the
+/// order of the sorting keys and optionally outputs their row numbers. This is
+/// a window with a single row_number function and a filter on it, without
+/// holding all the input rows. The partitions are the groups of a hash table
+/// on the partition keys. Each group has a heap of its rows stored in a
+/// RowContainer, like TopN.
+///
+/// If spilling is enabled and the heaps don't fit in memory, all the kept rows
+/// are spilled as one run sorted on the partition keys followed by the sorting
+/// keys and the operator continues with empty heaps. The output is then
+/// produced by merging the spilled runs and taking the first 'limit' rows of
+/// each partition.
+class TopNRowNumber : public Operator {
+ public:
+  TopNRowNumber(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::TopNRowNumberNode>& node);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  void noMoreInput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+ private:
+  static constexpr vector_size_t kMaxNumRowsToReturn = 1024;
+
+  // Compares the rows of 'data_' on the sorting keys.
+  class Comparator {
+   public:
+    // 'keyInfo' is the channel of each sorting key in the input vectors and
+    // its compare flags. The sorting keys are the columns of 'rowContainer'
+    // starting at 'firstKeyColumn'.
+    Comparator(
+        const std::vector<std::pair<column_index_t, CompareFlags>>* keyInfo,
+        column_index_t firstKeyColumn,
+        const RowContainer* rowContainer)
+        : keyInfo_(keyInfo),
+          firstKeyColumn_(firstKeyColumn),
+          rowContainer_(rowContainer) {}
+
+    // Returns true if lhs < rhs, false otherwise.
+    bool operator()(const char* lhs, const char* rhs) const {
+      if (lhs == rhs) {
+        return false;
+      }
+      for (auto i = 0; i < keyInfo_->size(); ++i) {
+        if (auto result = rowContainer_->compare(
+                lhs, rhs, firstKeyColumn_ + i, (*keyInfo_)[i].second)) {
+          return result < 0;
+        }
+      }
+      return false;
+    }
+
+    // Returns true if lhs < decodeVectors[index], false otherwise.
+    bool operator()(
+        const char* lhs,
+        const std::vector<DecodedVector>& decodedVectors,
+        vector_size_t index) const {
+      for (auto i = 0; i < keyInfo_->size(); ++i) {
+        const auto& [channel, flags] = (*keyInfo_)[i];
+        if (auto result = rowContainer_->compare(
+                lhs,
+                rowContainer_->columnAt(firstKeyColumn_ + i),
+                decodedVectors[channel],
+                index,
+                flags)) {
+          return result < 0;
+        }
+      }
+      return false;
+    }
+
+   private:
+    const std::vector<std::pair<column_index_t, CompareFlags>>* keyInfo_;
+    column_index_t firstKeyColumn_;
+    const RowContainer* rowContainer_;
+  };
+
+  // The kept rows of a partition. The top is the last in the sorting order.
+  using TopRows = std::priority_queue<char*, std::vector<char*>, Comparator>;
+
+  // Returns the heap of the partition of 'row' of the input passed to the
+  // last groupProbe().
+  TopRows& partitionOf(vector_size_t row);
+
+  // Finds or creates the partitions of the rows of 'input'.
+  void probePartitions(const RowVectorPtr& input);
+
+  // Checks if the heaps will fit in the existing memory after adding 'input'
+  // and increases reservation if not. If reservation cannot be increased,
+  // spills the heaps.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills all the kept rows as one sorted run and resets the partitions.
+  void spill();
+
+  void updateSpillStats();
+
+  RowVectorPtr getOutputWithSpill();
+
+  // Returns true if the current row of 'stream' has the same partition keys
+  // as 'spillPartitionKeys_'.
+  bool isInSpillPartition(const SpillMergeStream& stream) const;
+
+  const int32_t limit_;
+
+  const bool generateRowNumber_;
+
+  const column_index_t numPartitionKeys_;
+
+  memory::MappedMemory* const mappedMemory_;
+
+  // The maximum memory usage that the operator can hold before spilling. If
+  // it is zero, then there is no such limit. Shared with TopN.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
+  // The map from column channel in the input to the corresponding one stored
+  // in 'data_'. The partition keys are stored first, followed by the sorting
+  // keys, so that 'data_' can be spilled in output order.
+  std::vector<IdentityProjection> columnMap_;
+
+  // The channel of each sorting key in the input and its compare flags.
+  std::vector<std::pair<column_index_t, CompareFlags>> sortKeyInfo_;
+
+  // Compare flags of the keys of 'data_' for the sort of spilled rows.
+  std::vector<CompareFlags> spillCompareFlags_;
+
+  // The row type of 'data_' which is used as the spill row type.
+  RowTypePtr internalStoreType_;
+
+  // The kept input rows.
+  std::unique_ptr<RowContainer> data_;
+  Comparator comparator_;
+
+  // Hash table on the partition keys. Each group has the index of its heap in
+  // 'partitions_' as a BIGINT dependent. Null if there are no partition keys.
+  std::unique_ptr<HashTable<false>> table_;
+  std::unique_ptr<HashLookup> lookup_;
+
+  // Offset of the heap index in the rows of 'table_'.
+  int32_t partitionIndexOffset_{0};
+
+  // The heap of each partition.
+  std::vector<TopRows> partitions_;
+
+  std::vector<DecodedVector> decodedVectors_;
+
+  bool finished_ = false;
+
+  // The rows to output and their row numbers after all the input is received
+  // if there is no spilling. The rows of each partition are consecutive.
+  std::vector<char*> rows_;
+  std::vector<int64_t> rowNumbers_;
+  vector_size_t numRowsReturned_ = 0;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_';.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Single row vector with the partition keys of the partition being read
+  // back from the spilled data and the number of its rows which are output.
+  RowVectorPtr spillPartitionKeys_;
+  int64_t numSpillPartitionRows_{0};
+
+  // Record the source rows to copy to the output in order.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+};
+} // namespace facebook::velox::exec
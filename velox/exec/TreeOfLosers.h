@@ -148,6 +148,33 @@ class TreeOfLosers {
         : std::make_pair(streams_[lastIndex_].get(), result.second);
   }
 
+  // Returns the stream with the lowest first element other than the
+  // stream returned by the last next(), or nullptr if no other stream
+  // has data. The caller may pop values off the stream returned by
+  // next() for as long as they are not greater than the first value
+  // of the returned stream without calling next() in between. This
+  // takes one comparison per value instead of one per level of the
+  // tree when merging runs of values from the same stream.
+  Stream* runnerUp() {
+    if (lastIndex_ == kEmpty) {
+      return nullptr;
+    }
+    // The losers on the path of the winner are the winners of the
+    // subtrees next to the path.
+    TIndex best = kEmpty;
+    for (auto node = parent(firstStream_ + lastIndex_);; node = parent(node)) {
+      const auto candidate = values_[node];
+      if (candidate != kEmpty &&
+          (best == kEmpty || *streams_[candidate] < *streams_[best])) {
+        best = candidate;
+      }
+      if (node == 0) {
+        break;
+      }
+    }
+    return best == kEmpty ? nullptr : streams_[best].get();
+  }
+
  private:
   static constexpr TIndex kEmpty = std::numeric_limits<TIndex>::max();
 
@@ -30,6 +30,7 @@ Unnest::Unnest(
           operatorId,
           unnestNode->id(),
           "Unnest"),
+      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
       withOrdinality_(unnestNode->withOrdinality()) {
   const auto& inputType = unnestNode->sources()[0]->outputType();
   const auto& unnestVariables = unnestNode->unnestVariables();
@@ -41,6 +42,8 @@ Unnest::Unnest(
   }
 
   unnestDecoded_.resize(unnestVariables.size());
+  rawSizes_.resize(unnestVariables.size());
+  rawOffsets_.resize(unnestVariables.size());
 
   if (withOrdinality_) {
     VELOX_CHECK_EQ(
@@ -58,69 +61,139 @@ Unnest::Unnest(
 
 void Unnest::addInput(RowVectorPtr input) {
   input_ = std::move(input);
-}
-
-RowVectorPtr Unnest::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
+  nextInputRow_ = 0;
+  nextElement_ = 0;
 
-  auto size = input_->size();
+  const auto size = input_->size();
   inputRows_.resize(size);
 
-  // The max number of elements at each row across all unnested columns.
-  auto maxSizes = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
-  auto rawMaxSizes = maxSizes->asMutable<int64_t>();
-
-  std::vector<const vector_size_t*> rawSizes;
-  std::vector<const vector_size_t*> rawOffsets;
-  std::vector<const vector_size_t*> rawIndices;
-
-  rawSizes.resize(unnestChannels_.size());
-  rawOffsets.resize(unnestChannels_.size());
-  rawIndices.resize(unnestChannels_.size());
+  maxSizes_ = allocateIndices(size, pool());
+  rawMaxSizes_ = maxSizes_->asMutable<vector_size_t>();
 
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     const auto& unnestVector = input_->childAt(unnestChannels_[channel]);
-    unnestDecoded_[channel].decode(*unnestVector, inputRows_);
-
     auto& currentDecoded = unnestDecoded_[channel];
-    rawIndices[channel] = currentDecoded.indices();
+    currentDecoded.decode(*unnestVector, inputRows_);
 
-    const ArrayVector* unnestBaseArray;
-    const MapVector* unnestBaseMap;
     if (unnestVector->typeKind() == TypeKind::ARRAY) {
-      unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      rawSizes[channel] = unnestBaseArray->rawSizes();
-      rawOffsets[channel] = unnestBaseArray->rawOffsets();
+      auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
+      rawSizes_[channel] = unnestBaseArray->rawSizes();
+      rawOffsets_[channel] = unnestBaseArray->rawOffsets();
     } else {
       VELOX_CHECK(unnestVector->typeKind() == TypeKind::MAP);
-      unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      rawSizes[channel] = unnestBaseMap->rawSizes();
-      rawOffsets[channel] = unnestBaseMap->rawOffsets();
+      auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
+      rawSizes_[channel] = unnestBaseMap->rawSizes();
+      rawOffsets_[channel] = unnestBaseMap->rawOffsets();
     }
 
     // Count max number of elements per row.
-    auto currentSizes = rawSizes[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentIndices = currentDecoded.indices();
     for (auto row = 0; row < size; ++row) {
       if (!currentDecoded.isNullAt(row)) {
         auto unnestSize = currentSizes[currentIndices[row]];
-        if (rawMaxSizes[row] < unnestSize) {
-          rawMaxSizes[row] = unnestSize;
+        if (rawMaxSizes_[row] < unnestSize) {
+          rawMaxSizes_[row] = unnestSize;
         }
       }
     }
   }
+}
 
-  // Calculate the number of rows in the unnest result.
-  int numElements = 0;
-  for (auto row = 0; row < size; ++row) {
-    numElements += rawMaxSizes[row];
+vector_size_t Unnest::nextRowRanges(std::vector<RowRange>& ranges) {
+  ranges.clear();
+  const auto size = input_->size();
+  vector_size_t numElements = 0;
+  while (nextInputRow_ < size && numElements < outputBatchSize_) {
+    const auto maxSize = rawMaxSizes_[nextInputRow_];
+    const auto end =
+        std::min(maxSize, nextElement_ + (outputBatchSize_ - numElements));
+    if (end > nextElement_) {
+      ranges.push_back({nextInputRow_, nextElement_, end});
+      numElements += end - nextElement_;
+    }
+    if (end < maxSize) {
+      nextElement_ = end;
+    } else {
+      ++nextInputRow_;
+      nextElement_ = 0;
+    }
   }
+  return numElements;
+}
+
+VectorPtr Unnest::unnestColumn(
+    column_index_t channel,
+    const std::vector<RowRange>& ranges,
+    vector_size_t numElements,
+    const VectorPtr& elements) {
+  const auto& currentDecoded = unnestDecoded_[channel];
+  const auto* currentSizes = rawSizes_[channel];
+  const auto* currentOffsets = rawOffsets_[channel];
+  const auto* currentIndices = currentDecoded.indices();
+
+  BufferPtr elementIndices = allocateIndices(numElements, pool());
+  auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
+
+  BufferPtr nulls;
+  uint64_t* rawNulls = nullptr;
+
+  // Make dictionary index for elements column since they may be out of order.
+  // Rows shorter than the longest unnested array or map at the same input row
+  // are padded with nulls.
+  vector_size_t index = 0;
+  for (const auto& range : ranges) {
+    vector_size_t offset = 0;
+    vector_size_t unnestSize = 0;
+    if (!currentDecoded.isNullAt(range.row)) {
+      offset = currentOffsets[currentIndices[range.row]];
+      unnestSize = currentSizes[currentIndices[range.row]];
+    }
+    const auto nonNullEnd = std::min(range.end, unnestSize);
+    for (auto i = range.begin; i < nonNullEnd; ++i) {
+      rawElementIndices[index++] = offset + i;
+    }
+    for (auto i = std::max(range.begin, nonNullEnd); i < range.end; ++i) {
+      if (!rawNulls) {
+        nulls =
+            AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
+        rawNulls = nulls->asMutable<uint64_t>();
+      }
+      rawElementIndices[index] = 0;
+      bits::setNull(rawNulls, index++, true);
+    }
+  }
+
+  // Consecutive elements without padding are a zero-copy slice of 'elements'.
+  if (!rawNulls) {
+    const auto first = rawElementIndices[0];
+    bool consecutive = true;
+    for (auto i = 1; i < numElements; ++i) {
+      if (rawElementIndices[i] != first + i) {
+        consecutive = false;
+        break;
+      }
+    }
+    if (consecutive) {
+      if (first == 0 && numElements == elements->size()) {
+        return elements;
+      }
+      return elements->slice(first, numElements);
+    }
+  }
+
+  return wrapChild(numElements, elementIndices, elements, nulls);
+}
 
+RowVectorPtr Unnest::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  std::vector<RowRange> ranges;
+  const auto numElements = nextRowRanges(ranges);
   if (numElements == 0) {
-    // All arrays/maps are null or empty.
+    // All remaining arrays/maps are null or empty.
     input_ = nullptr;
     return nullptr;
   }
@@ -130,10 +203,12 @@ RowVectorPtr Unnest::getOutput() {
   auto repeatedIndices = allocateIndices(numElements, pool());
   auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
   vector_size_t index = 0;
-  for (auto row = 0; row < size; ++row) {
-    for (auto i = 0; i < rawMaxSizes[row]; i++) {
-      rawRepeatedIndices[index++] = row;
-    }
+  for (const auto& range : ranges) {
+    std::fill(
+        rawRepeatedIndices + index,
+        rawRepeatedIndices + index + range.end - range.begin,
+        range.row);
+    index += range.end - range.begin;
   }
 
   // Wrap "replicated" columns in a dictionary using 'repeatedIndices'.
@@ -146,71 +221,18 @@ RowVectorPtr Unnest::getOutput() {
   // Create unnest columns.
   vector_size_t outputsIndex = identityProjections_.size();
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
-    auto& currentDecoded = unnestDecoded_[channel];
-    auto currentSizes = rawSizes[channel];
-    auto currentOffsets = rawOffsets[channel];
-    auto currentIndices = rawIndices[channel];
-
-    BufferPtr elementIndices = allocateIndices(numElements, pool());
-    auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
-
-    auto nulls =
-        AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
-    auto rawNulls = nulls->asMutable<uint64_t>();
-
-    // Make dictionary index for elements column since they may be out of order.
-    index = 0;
-    bool identityMapping = true;
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-
-      if (!currentDecoded.isNullAt(row)) {
-        auto offset = currentOffsets[currentIndices[row]];
-        auto unnestSize = currentSizes[currentIndices[row]];
-
-        if (index != offset || unnestSize < maxSize) {
-          identityMapping = false;
-        }
-
-        for (auto i = 0; i < unnestSize; i++) {
-          rawElementIndices[index++] = offset + i;
-        }
-
-        for (auto i = unnestSize; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
-        }
-      } else if (maxSize > 0) {
-        identityMapping = false;
-
-        for (auto i = 0; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
-        }
-      }
-    }
-
-    if (currentDecoded.base()->typeKind() == TypeKind::ARRAY) {
-      // Construct unnest column using Array elements wrapped using above
-      // created dictionary.
-      auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseArray->elements()
-          : wrapChild(
-                numElements,
-                elementIndices,
-                unnestBaseArray->elements(),
-                nulls);
+    auto base = unnestDecoded_[channel].base();
+    if (base->typeKind() == TypeKind::ARRAY) {
+      // Construct unnest column using Array elements.
+      outputs[outputsIndex++] = unnestColumn(
+          channel, ranges, numElements, base->as<ArrayVector>()->elements());
     } else {
-      // Construct two unnest columns for Map keys and values vectors wrapped
-      // using above created dictionary.
-      auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapKeys()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapKeys(), nulls);
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapValues()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapValues(), nulls);
+      // Construct two unnest columns for Map keys and values vectors.
+      auto unnestBaseMap = base->as<MapVector>();
+      outputs[outputsIndex++] = unnestColumn(
+          channel, ranges, numElements, unnestBaseMap->mapKeys());
+      outputs[outputsIndex++] = unnestColumn(
+          channel, ranges, numElements, unnestBaseMap->mapValues());
     }
   }
 
@@ -221,17 +243,21 @@ RowVectorPtr Unnest::getOutput() {
     // Set the ordinality at each result row to be the index of the element in
     // the original array (or map) plus one.
     auto rawOrdinality = ordinalityVector->mutableRawValues();
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-      std::iota(rawOrdinality, rawOrdinality + maxSize, 1);
-      rawOrdinality += maxSize;
+    for (const auto& range : ranges) {
+      std::iota(
+          rawOrdinality,
+          rawOrdinality + range.end - range.begin,
+          static_cast<int64_t>(range.begin) + 1);
+      rawOrdinality += range.end - range.begin;
     }
 
     // Ordinality column is always at the end.
     outputs.back() = std::move(ordinalityVector);
   }
 
-  input_ = nullptr;
+  if (nextInputRow_ >= input_->size()) {
+    input_ = nullptr;
+  }
   return std::make_shared<RowVector>(
       pool(), outputType_, BufferPtr(nullptr), numElements, std::move(outputs));
 }
@@ -29,7 +29,7 @@ class Unnest : public Operator {
   }
 
   bool needsInput() const override {
-    return true;
+    return !input_;
   }
 
   void addInput(RowVectorPtr input) override;
@@ -39,11 +39,50 @@ class Unnest : public Operator {
   bool isFinished() override;
 
  private:
+  // Range of elements of one input row that go into the next output batch.
+  struct RowRange {
+    vector_size_t row;
+    vector_size_t begin;
+    vector_size_t end;
+  };
+
+  // Fills 'ranges' with the rows of 'input_' and their elements that make up
+  // the next output batch of at most 'outputBatchSize_' rows and returns the
+  // number of these elements. Advances 'nextInputRow_' and 'nextElement_' past
+  // them.
+  vector_size_t nextRowRanges(std::vector<RowRange>& ranges);
+
+  // Returns the unnested elements of 'channel' for 'ranges'. These are a slice
+  // of the elements, keys or values vector of the base array or map if
+  // 'ranges' cover consecutive elements and a dictionary over it otherwise.
+  VectorPtr unnestColumn(
+      column_index_t channel,
+      const std::vector<RowRange>& ranges,
+      vector_size_t numElements,
+      const VectorPtr& elements);
+
+  const vector_size_t outputBatchSize_;
+
   std::vector<column_index_t> unnestChannels_;
 
   SelectivityVector inputRows_;
   std::vector<DecodedVector> unnestDecoded_;
 
+  // Sizes and offsets of the base arrays or maps of 'unnestDecoded_'.
+  std::vector<const vector_size_t*> rawSizes_;
+  std::vector<const vector_size_t*> rawOffsets_;
+
+  // The max number of elements at each row of 'input_' across all unnested
+  // columns.
+  BufferPtr maxSizes_;
+  vector_size_t* rawMaxSizes_{nullptr};
+
+  // The first row of 'input_' and the first element of that row that have
+  // not been returned yet. Large arrays or maps are split across output
+  // batches.
+  vector_size_t nextInputRow_{0};
+  vector_size_t nextElement_{0};
+
   const bool withOrdinality_;
 };
 } // namespace facebook::velox::exec
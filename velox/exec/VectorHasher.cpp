@@ -46,6 +46,9 @@ namespace facebook::velox::exec {
       case TypeKind::INTERVAL_DAY_TIME: {                                \
         return TEMPLATE_FUNC<TypeKind::INTERVAL_DAY_TIME>(__VA_ARGS__);  \
       }                                                                  \
+      case TypeKind::TIMESTAMP: {                                        \
+        return TEMPLATE_FUNC<TypeKind::TIMESTAMP>(__VA_ARGS__);          \
+      }                                                                  \
       case TypeKind::VARCHAR:                                            \
       case TypeKind::VARBINARY: {                                        \
         return TEMPLATE_FUNC<TypeKind::VARCHAR>(__VA_ARGS__);            \
@@ -689,6 +692,11 @@ void extendRange(
     case TypeKind::VARBINARY:
       extendRange<int64_t>(reserve, min, max);
       break;
+    case TypeKind::TIMESTAMP:
+      // The lowest int64_t is reserved for timestamps that have no id.
+      extendRange<int64_t>(reserve, min, max);
+      min = std::max(min, std::numeric_limits<int64_t>::min() + 1);
+      break;
 
     default:
       VELOX_FAIL("Unsupported VectorHasher typeKind {}", kind);
@@ -305,6 +305,7 @@ class VectorHasher {
       case TypeKind::VARBINARY:
       case TypeKind::DATE:
       case TypeKind::INTERVAL_DAY_TIME:
+      case TypeKind::TIMESTAMP:
         return true;
       default:
         return false;
@@ -335,11 +336,25 @@ class VectorHasher {
     return size == 0 ? word : word + (1L << (size * 8));
   }
 
+  // Id of timestamps that do not fit int64_t nanoseconds, roughly before 1677
+  // and after 2262. These have no value id.
+  static constexpr int64_t kUnmappableTimestamp =
+      std::numeric_limits<int64_t>::min();
+
   template <typename T>
   inline int64_t toInt64(T value) const {
     return value;
   }
 
+  // True if a value of type T that maps to 'int64Value' has no value id.
+  template <typename T>
+  static inline bool isUnmappable(int64_t int64Value) {
+    if constexpr (std::is_same_v<T, Timestamp>) {
+      return int64Value == kUnmappableTimestamp;
+    }
+    return false;
+  }
+
   // Sets the data statistics from 'other'. Does not set the mapping mode.
   void copyStatsFrom(const VectorHasher& other);
 
@@ -418,6 +433,11 @@ class VectorHasher {
   template <typename T>
   void analyzeValue(T value) {
     auto normalized = toInt64(value);
+    if (isUnmappable<T>(normalized)) {
+      rangeOverflow_ = true;
+      distinctOverflow_ = true;
+      return;
+    }
     if (!rangeOverflow_) {
       updateRange(normalized);
     }
@@ -474,6 +494,9 @@ class VectorHasher {
   template <typename T>
   uint64_t valueId(T value) {
     auto int64Value = toInt64(value);
+    if (isUnmappable<T>(int64Value)) {
+      return kUnmappable;
+    }
     if (isRange_) {
       if (int64Value > max_ || int64Value < min_) {
         return kUnmappable;
@@ -481,7 +504,7 @@ class VectorHasher {
       return int64Value - min_ + 1;
     }
 
-    UniqueValue unique(value);
+    UniqueValue unique(int64Value);
     unique.setId(uniqueValues_.size() + 1);
     auto pair = uniqueValues_.insert(unique);
     if (!pair.second) {
@@ -497,13 +520,16 @@ class VectorHasher {
   template <typename T>
   uint64_t lookupValueId(T value) const {
     auto int64Value = toInt64(value);
+    if (isUnmappable<T>(int64Value)) {
+      return kUnmappable;
+    }
     if (isRange_) {
       if (int64Value > max_ || int64Value < min_) {
         return kUnmappable;
       }
       return int64Value - min_ + 1;
     }
-    UniqueValue unique(value);
+    UniqueValue unique(int64Value);
     auto iter = uniqueValues_.find(unique);
     if (iter != uniqueValues_.end()) {
       return iter->id();
@@ -590,6 +616,18 @@ inline int64_t VectorHasher::toInt64(IntervalDayTime value) const {
   return value.milliseconds();
 }
 
+// Maps a timestamp to its nanoseconds since the epoch, so that timestamp keys
+// take 8 bytes in normalized keys and hash table arrays instead of 16.
+template <>
+inline int64_t VectorHasher::toInt64(Timestamp value) const {
+  int64_t nanos;
+  if (__builtin_mul_overflow(value.getSeconds(), 1'000'000'000, &nanos) ||
+      __builtin_add_overflow(nanos, value.getNanos(), &nanos)) {
+    return kUnmappableTimestamp;
+  }
+  return nanos;
+}
+
 template <>
 bool VectorHasher::makeValueIdsForRows<TypeKind::VARCHAR>(
     char** groups,
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/Window.h"
+#include "velox/common/base/AsyncSource.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
@@ -41,6 +42,10 @@ void initKeyInfo(
   }
 }
 
+CompareFlags fromSortOrderToCompareFlags(const core::SortOrder& sortOrder) {
+  return {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false};
+}
+
 }; // namespace
 
 Window::Window(
@@ -53,14 +58,20 @@ Window::Window(
           operatorId,
           windowNode->id(),
           "Window"),
+      inputsSorted_(windowNode->inputsSorted()),
       outputBatchSizeInBytes_(
           driverCtx->queryConfig().preferredOutputBatchSize()),
       numInputColumns_(windowNode->sources()[0]->outputType()->size()),
-      data_(std::make_unique<RowContainer>(
-          windowNode->sources()[0]->outputType()->children(),
-          operatorCtx_->mappedMemory())),
-      decodedInputVectors_(numInputColumns_),
-      stringAllocator_(operatorCtx_->mappedMemory()) {
+      spillMemoryThreshold_(operatorCtx_->driverCtx()
+                                ->queryConfig()
+                                .windowSpillMemoryThreshold()),
+      // A window partition must fit in memory, so there is nothing to gain
+      // from spilling a window without partition keys or a streaming window.
+      spillConfig_(
+          windowNode->partitionKeys().empty() || inputsSorted_
+              ? std::nullopt
+              : operatorCtx_->makeSpillConfig(Spiller::Type::kWindow)),
+      decodedInputVectors_(numInputColumns_) {
   auto inputType = windowNode->sources()[0]->outputType();
   initKeyInfo(inputType, windowNode->partitionKeys(), {}, partitionKeyInfo_);
   initKeyInfo(
@@ -68,24 +79,93 @@ Window::Window(
       windowNode->sortingKeys(),
       windowNode->sortingOrders(),
       sortKeyInfo_);
+
+  // Store the partition keys followed by the sort keys first in 'data_'. Keys
+  // which appear more than once are only stored and compared the first time.
+  // The key infos are changed to refer to the columns of 'data_'.
+  std::vector<bool> isStored(numInputColumns_, false);
+  inputColumnIndices_.resize(numInputColumns_);
+  auto storeKeys =
+      [&](std::vector<std::pair<column_index_t, core::SortOrder>>& keyInfo) {
+        std::vector<std::pair<column_index_t, core::SortOrder>> columnKeyInfo;
+        for (const auto& [channel, sortOrder] : keyInfo) {
+          if (isStored[channel]) {
+            continue;
+          }
+          isStored[channel] = true;
+          inputColumnIndices_[channel] = storedChannels_.size();
+          columnKeyInfo.emplace_back(storedChannels_.size(), sortOrder);
+          storedChannels_.push_back(channel);
+        }
+        keyInfo = std::move(columnKeyInfo);
+      };
+  storeKeys(partitionKeyInfo_);
+  storeKeys(sortKeyInfo_);
+  const auto numKeys = storedChannels_.size();
+  for (column_index_t channel = 0; channel < numInputColumns_; ++channel) {
+    if (!isStored[channel]) {
+      inputColumnIndices_[channel] = storedChannels_.size();
+      storedChannels_.push_back(channel);
+    }
+  }
+
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 0; i < storedChannels_.size(); ++i) {
+    const auto channel = storedChannels_[i];
+    if (i < numKeys) {
+      keyTypes.push_back(inputType->childAt(channel));
+    } else {
+      dependentTypes.push_back(inputType->childAt(channel));
+    }
+    names.push_back(inputType->nameOf(channel));
+    types.push_back(inputType->childAt(channel));
+  }
+  data_ = std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, operatorCtx_->mappedMemory());
+  spillType_ = ROW(std::move(names), std::move(types));
+
   allKeyInfo_.reserve(partitionKeyInfo_.size() + sortKeyInfo_.size());
   allKeyInfo_.insert(
       allKeyInfo_.cend(), partitionKeyInfo_.begin(), partitionKeyInfo_.end());
   allKeyInfo_.insert(
       allKeyInfo_.cend(), sortKeyInfo_.begin(), sortKeyInfo_.end());
+  keyCompareFlags_.reserve(allKeyInfo_.size());
+  for (const auto& keyInfo : allKeyInfo_) {
+    keyCompareFlags_.push_back(fromSortOrderToCompareFlags(keyInfo.second));
+  }
 
   std::vector<exec::RowColumn> inputColumns;
   for (int i = 0; i < inputType->children().size(); i++) {
-    inputColumns.push_back(data_->columnAt(i));
+    inputColumns.push_back(data_->columnAt(inputColumnIndices_[i]));
+  }
+  // The partitions are computed in parallel only if there is an executor to
+  // run the evaluators on.
+  const auto numEvaluators =
+      operatorCtx_->task()->queryCtx()->executor() == nullptr
+      ? 1
+      : std::max<int32_t>(1, driverCtx->queryConfig().windowParallelism());
+  for (auto i = 0; i < numEvaluators; ++i) {
+    auto evaluator = std::make_unique<WindowEvaluator>();
+    evaluator->stringAllocator =
+        std::make_unique<HashStringAllocator>(operatorCtx_->mappedMemory());
+    // The WindowPartition is structured over all the input columns data.
+    // Individual functions access its input argument column values from it.
+    // The RowColumns are copied by the WindowPartition, so its fine to use
+    // a local variable here.
+    evaluator->windowPartition =
+        std::make_unique<WindowPartition>(inputColumns, inputType->children());
+    evaluators_.push_back(std::move(evaluator));
   }
-  // The WindowPartition is structured over all the input columns data.
-  // Individual functions access its input argument column values from it.
-  // The RowColumns are copied by the WindowPartition, so its fine to use
-  // a local variable here.
-  windowPartition_ =
-      std::make_unique<WindowPartition>(inputColumns, inputType->children());
 
   createWindowFunctions(windowNode, inputType);
+
+  if (inputsSorted_) {
+    // The output starts before all the input is received in streaming mode.
+    createPeerAndFrameBuffers();
+  }
 }
 
 void Window::createWindowFunctions(
@@ -130,12 +210,15 @@ void Window::createWindowFunctions(
       }
     }
 
-    windowFunctions_.push_back(WindowFunction::create(
-        windowNodeFunction.functionCall->name(),
-        functionArgs,
-        windowNodeFunction.functionCall->type(),
-        operatorCtx_->pool(),
-        &stringAllocator_));
+    for (auto& evaluator : evaluators_) {
+      evaluator->windowFunctions.push_back(WindowFunction::create(
+          windowNodeFunction.functionCall->name(),
+          functionArgs,
+          windowNodeFunction.functionCall->type(),
+          windowNodeFunction.ignoreNulls,
+          operatorCtx_->pool(),
+          evaluator->stringAllocator.get()));
+    }
 
     windowFrames_.push_back(
         {windowNodeFunction.frame.type,
@@ -147,6 +230,8 @@ void Window::createWindowFunctions(
 }
 
 void Window::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   inputRows_.resize(input->size());
 
   for (auto col = 0; col < input->childrenSize(); ++col) {
@@ -156,12 +241,188 @@ void Window::addInput(RowVectorPtr input) {
   // Add all the rows into the RowContainer.
   for (auto row = 0; row < input->size(); ++row) {
     char* newRow = data_->newRow();
+    if (inputsSorted_) {
+      sortedRows_.push_back(newRow);
+    }
 
-    for (auto col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedInputVectors_[col], row, newRow, col);
+    for (auto col = 0; col < storedChannels_.size(); ++col) {
+      data_->store(
+          decodedInputVectors_[storedChannels_[col]], row, newRow, col);
     }
   }
+  const auto firstNewRow = numRows_;
   numRows_ += inputRows_.size();
+  if (inputsSorted_) {
+    updatePartitionStartRows(firstNewRow);
+  }
+  if (spiller_ != nullptr) {
+    updateSpillStats();
+  }
+}
+
+void Window::updatePartitionStartRows(vector_size_t firstNewRow) {
+  // The end of the last partition is moved to the end of the new rows.
+  if (partitionStartRows_.empty()) {
+    partitionStartRows_.push_back(0);
+  } else {
+    partitionStartRows_.pop_back();
+  }
+
+  // The input is ordered on the partition keys but not necessarily in the
+  // default sort order, so compare for equality.
+  auto isNewPartition = [&](const char* lhs, const char* rhs) -> bool {
+    for (const auto& key : partitionKeyInfo_) {
+      if (data_->compare(lhs, rhs, key.first, CompareFlags()) != 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (auto i = std::max<vector_size_t>(1, firstNewRow); i < sortedRows_.size();
+       ++i) {
+    if (isNewPartition(sortedRows_[i - 1], sortedRows_[i])) {
+      partitionStartRows_.push_back(i);
+    }
+  }
+  partitionStartRows_.push_back(sortedRows_.size());
+}
+
+vector_size_t Window::numOutputableRows() const {
+  if (!inputsSorted_ || noMoreInput_) {
+    return numRows_;
+  }
+  // The last partition might continue in the next input.
+  return partitionStartRows_.size() < 2
+      ? 0
+      : partitionStartRows_[partitionStartRows_.size() - 2];
+}
+
+void Window::eraseOutputPartitions() {
+  VELOX_CHECK(inputsSorted_);
+  data_->eraseRows(folly::Range<char**>(sortedRows_.data(), numProcessedRows_));
+  sortedRows_.erase(
+      sortedRows_.begin(), sortedRows_.begin() + numProcessedRows_);
+  numRows_ = sortedRows_.size();
+  numProcessedRows_ = 0;
+
+  // Only the incomplete last partition is left.
+  partitionStartRows_.clear();
+  partitionStartRows_.push_back(0);
+  partitionStartRows_.push_back(numRows_);
+  currentPartition_ = 0;
+}
+
+void Window::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
+    return;
+  }
+
+  auto tracker = operatorCtx_->mappedMemory()->tracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->getCurrentUserBytes();
+  if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
+    const int64_t bytesToSpill =
+        currentUsage * spillConfig.spillableReservationGrowthPct / 100;
+    auto rowsToSpill = std::max<int64_t>(
+        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
+    spill(
+        std::max<int64_t>(0, numRows - rowsToSpill),
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+void Window::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kWindow,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        spillConfig.hashBitRange,
+        partitionKeyInfo_.size(),
+        allKeyInfo_.size(),
+        keyCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionType);
+  }
+  spiller_->spill(targetRows, targetBytes);
+}
+
+void Window::updateSpillStats() {
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
 }
 
 inline bool Window::compareRowsWithKeys(
@@ -188,22 +449,23 @@ void Window::createPeerAndFrameBuffers() {
   // the input columns size. We need to also account for the output columns.
   numRowsPerOutput_ = data_->estimatedNumRowsPerBatch(outputBatchSizeInBytes_);
 
-  peerStartBuffer_ = AlignedBuffer::allocate<vector_size_t>(
-      numRowsPerOutput_, operatorCtx_->pool());
-  peerEndBuffer_ = AlignedBuffer::allocate<vector_size_t>(
-      numRowsPerOutput_, operatorCtx_->pool());
-
-  auto numFuncs = windowFunctions_.size();
-  frameStartBuffers_.reserve(numFuncs);
-  frameEndBuffers_.reserve(numFuncs);
-
-  for (auto i = 0; i < numFuncs; i++) {
-    BufferPtr frameStartBuffer = AlignedBuffer::allocate<vector_size_t>(
+  auto numFuncs = windowFrames_.size();
+  for (auto& evaluator : evaluators_) {
+    evaluator->peerStartBuffer = AlignedBuffer::allocate<vector_size_t>(
         numRowsPerOutput_, operatorCtx_->pool());
-    BufferPtr frameEndBuffer = AlignedBuffer::allocate<vector_size_t>(
+    evaluator->peerEndBuffer = AlignedBuffer::allocate<vector_size_t>(
         numRowsPerOutput_, operatorCtx_->pool());
-    frameStartBuffers_.push_back(frameStartBuffer);
-    frameEndBuffers_.push_back(frameEndBuffer);
+
+    evaluator->frameStartBuffers.reserve(numFuncs);
+    evaluator->frameEndBuffers.reserve(numFuncs);
+    for (auto i = 0; i < numFuncs; i++) {
+      BufferPtr frameStartBuffer = AlignedBuffer::allocate<vector_size_t>(
+          numRowsPerOutput_, operatorCtx_->pool());
+      BufferPtr frameEndBuffer = AlignedBuffer::allocate<vector_size_t>(
+          numRowsPerOutput_, operatorCtx_->pool());
+      evaluator->frameStartBuffers.push_back(frameStartBuffer);
+      evaluator->frameEndBuffers.push_back(frameEndBuffer);
+    }
   }
 }
 
@@ -262,6 +524,29 @@ void Window::noMoreInput() {
     return;
   }
 
+  if (inputsSorted_) {
+    // The rows are in order and the last partition is complete now.
+    return;
+  }
+
+  if (spiller_ != nullptr) {
+    // Spill the remaining rows so that all the rows of a window partition
+    // are read back in order from the same spill partition.
+    spiller_->spill(0, 0);
+    VELOX_CHECK(spiller_->finishSpill().empty());
+    updateSpillStats();
+
+    spillBatch_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(spillType_, kSpillBatchSize, pool()));
+    spillPartitionKeys_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(spillType_, 1, pool()));
+    spillSources_.resize(kSpillBatchSize);
+    spillSourceRows_.resize(kSpillBatchSize);
+    VELOX_CHECK(loadNextSpilledPartition());
+    createPeerAndFrameBuffers();
+    return;
+  }
+
   // At this point we have seen all the input rows. We can start
   // outputting rows now.
   // However, some preparation is needed. The rows should be
@@ -271,47 +556,497 @@ void Window::noMoreInput() {
   createPeerAndFrameBuffers();
 }
 
-void Window::callResetPartition(vector_size_t partitionNumber) {
+bool Window::loadNextSpilledPartition() {
+  VELOX_CHECK_NOT_NULL(spiller_);
+  data_->clear();
+  numRows_ = 0;
+  numProcessedRows_ = 0;
+
+  // Number of rows recorded in 'spillSources_' and 'spillSourceRows_' which
+  // are not yet copied into 'spillBatch_'.
+  vector_size_t numSourceRows = 0;
+  auto gatherSourceRows = [&]() {
+    gatherCopy(
+        spillBatch_.get(),
+        numSpillBatchRows_,
+        numSourceRows,
+        spillSources_,
+        spillSourceRows_);
+    numSpillBatchRows_ += numSourceRows;
+    numSourceRows = 0;
+  };
+
+  for (;;) {
+    if (spillMerge_ == nullptr) {
+      const auto numPartitions = spiller_->state().maxPartitions();
+      while (nextSpillPartition_ < numPartitions &&
+             !spiller_->isSpilled(nextSpillPartition_)) {
+        ++nextSpillPartition_;
+      }
+      if (nextSpillPartition_ == numPartitions) {
+        break;
+      }
+      spillMerge_ = spiller_->startMerge(nextSpillPartition_++);
+    }
+
+    auto* stream = spillStream_ != nullptr ? spillStream_ : spillMerge_->next();
+    spillStream_ = nullptr;
+    if (stream == nullptr) {
+      // A window partition never spans more than one spill partition.
+      spillMerge_ = nullptr;
+      if (numRows_ + numSpillBatchRows_ + numSourceRows > 0) {
+        break;
+      }
+      continue;
+    }
+
+    if (numRows_ + numSpillBatchRows_ + numSourceRows == 0) {
+      const auto index = stream->currentIndex();
+      for (auto i = 0; i < partitionKeyInfo_.size(); ++i) {
+        spillPartitionKeys_->childAt(i)->copy(
+            stream->current().childAt(i).get(), 0, index, 1);
+      }
+    } else if (!isInSpilledPartition(*stream)) {
+      // Keep the first row of the next window partition in 'stream'.
+      spillStream_ = stream;
+      break;
+    }
+
+    bool isEndOfBatch = false;
+    spillSources_[numSourceRows] = &stream->current();
+    spillSourceRows_[numSourceRows] = stream->currentIndex(&isEndOfBatch);
+    ++numSourceRows;
+    if (isEndOfBatch || numSpillBatchRows_ + numSourceRows == kSpillBatchSize) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherSourceRows();
+      if (numSpillBatchRows_ == kSpillBatchSize) {
+        storeSpillBatch();
+      }
+    }
+    stream->pop();
+  }
+  gatherSourceRows();
+  storeSpillBatch();
+
+  if (numRows_ == 0) {
+    return false;
+  }
+  sortPartitions();
+  return true;
+}
+
+bool Window::isInSpilledPartition(const SpillMergeStream& stream) const {
+  const auto index = stream.currentIndex();
+  for (auto i = 0; i < partitionKeyInfo_.size(); ++i) {
+    if (!stream.current().childAt(i)->equalValueAt(
+            spillPartitionKeys_->childAt(i).get(), index, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Window::storeSpillBatch() {
+  if (numSpillBatchRows_ == 0) {
+    return;
+  }
+  const SelectivityVector rows(numSpillBatchRows_);
+  for (auto col = 0; col < spillBatch_->childrenSize(); ++col) {
+    decodedInputVectors_[col].decode(*spillBatch_->childAt(col), rows);
+  }
+  for (auto row = 0; row < numSpillBatchRows_; ++row) {
+    char* newRow = data_->newRow();
+    for (auto col = 0; col < spillBatch_->childrenSize(); ++col) {
+      data_->store(decodedInputVectors_[col], row, newRow, col);
+    }
+  }
+  numRows_ += numSpillBatchRows_;
+  numSpillBatchRows_ = 0;
+
+  // Releases the string buffers of the spilled data referenced from the rows.
+  VectorPtr batch = std::move(spillBatch_);
+  BaseVector::prepareForReuse(batch, kSpillBatchSize);
+  spillBatch_ = std::static_pointer_cast<RowVector>(batch);
+  for (auto& child : spillBatch_->children()) {
+    child->resize(kSpillBatchSize);
+  }
+}
+
+void Window::callResetPartition(
+    WindowEvaluator& evaluator,
+    vector_size_t partitionNumber) {
   auto partitionSize = partitionStartRows_[partitionNumber + 1] -
       partitionStartRows_[partitionNumber];
   auto partition = folly::Range(
       sortedRows_.data() + partitionStartRows_[partitionNumber], partitionSize);
-  windowPartition_->resetPartition(partition);
-  for (int i = 0; i < windowFunctions_.size(); i++) {
-    windowFunctions_[i]->resetPartition(windowPartition_.get());
+  evaluator.windowPartition->resetPartition(partition);
+  evaluator.rangeFrameKeysLoaded = false;
+  for (auto& windowFunction : evaluator.windowFunctions) {
+    windowFunction->resetPartition(evaluator.windowPartition.get());
+  }
+}
+
+namespace {
+template <typename T>
+void computeKRowsFrameBounds(
+    const VectorPtr& offsets,
+    bool isKPreceding,
+    bool isStartBound,
+    vector_size_t startRow,
+    vector_size_t numRows,
+    vector_size_t numPartitionRows,
+    vector_size_t* rawFrameBounds) {
+  auto* flatOffsets = offsets->asFlatVector<T>();
+  for (auto i = 0; i < numRows; ++i) {
+    VELOX_USER_CHECK(
+        !flatOffsets->isNullAt(i), "Window frame offset must not be null");
+    const int64_t offset = flatOffsets->valueAt(i);
+    VELOX_USER_CHECK_GE(offset, 0, "Window frame offset must not be negative");
+    int64_t bound = startRow + i + (isKPreceding ? -offset : offset);
+    // Frame bounds outside of the partition are clamped so that a frame
+    // entirely before or after the partition has its start after its end.
+    if (isStartBound) {
+      bound = std::clamp<int64_t>(bound, 0, numPartitionRows);
+    } else {
+      bound = std::clamp<int64_t>(bound, -1, numPartitionRows - 1);
+    }
+    rawFrameBounds[i] = bound;
+  }
+}
+} // namespace
+
+void Window::updateKRowsFrameBounds(
+    const WindowEvaluator& evaluator,
+    bool isKPreceding,
+    bool isStartBound,
+    column_index_t frameChannel,
+    vector_size_t startRow,
+    vector_size_t numRows,
+    vector_size_t numPartitionRows,
+    vector_size_t* rawFrameBounds) {
+  const auto& offsetType = outputType_->childAt(frameChannel);
+  VectorPtr offsets = BaseVector::create(offsetType, numRows, pool());
+  evaluator.windowPartition->extractColumn(
+      frameChannel, startRow, numRows, 0, offsets);
+  switch (offsetType->kind()) {
+    case TypeKind::TINYINT:
+      computeKRowsFrameBounds<int8_t>(
+          offsets,
+          isKPreceding,
+          isStartBound,
+          startRow,
+          numRows,
+          numPartitionRows,
+          rawFrameBounds);
+      break;
+    case TypeKind::SMALLINT:
+      computeKRowsFrameBounds<int16_t>(
+          offsets,
+          isKPreceding,
+          isStartBound,
+          startRow,
+          numRows,
+          numPartitionRows,
+          rawFrameBounds);
+      break;
+    case TypeKind::INTEGER:
+      computeKRowsFrameBounds<int32_t>(
+          offsets,
+          isKPreceding,
+          isStartBound,
+          startRow,
+          numRows,
+          numPartitionRows,
+          rawFrameBounds);
+      break;
+    case TypeKind::BIGINT:
+      computeKRowsFrameBounds<int64_t>(
+          offsets,
+          isKPreceding,
+          isStartBound,
+          startRow,
+          numRows,
+          numPartitionRows,
+          rawFrameBounds);
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Unsupported window frame offset type: {}", offsetType->toString());
+  }
+}
+
+namespace {
+// Returns the frame offset of row 'index' of 'offsets' as 'TOffset'.
+template <typename TOffset>
+TOffset rangeFrameOffset(const BaseVector& offsets, vector_size_t index) {
+  VELOX_USER_CHECK(
+      !offsets.isNullAt(index), "Window frame offset must not be null");
+  TOffset offset;
+  switch (offsets.typeKind()) {
+    case TypeKind::TINYINT:
+      offset = offsets.asFlatVector<int8_t>()->valueAt(index);
+      break;
+    case TypeKind::SMALLINT:
+      offset = offsets.asFlatVector<int16_t>()->valueAt(index);
+      break;
+    case TypeKind::INTEGER:
+      offset = offsets.asFlatVector<int32_t>()->valueAt(index);
+      break;
+    case TypeKind::BIGINT:
+      offset = offsets.asFlatVector<int64_t>()->valueAt(index);
+      break;
+    case TypeKind::REAL:
+      VELOX_USER_CHECK(
+          std::is_floating_point_v<TOffset>,
+          "Window frame offset of integer ORDER BY key must be an integer");
+      offset = offsets.asFlatVector<float>()->valueAt(index);
+      break;
+    case TypeKind::DOUBLE:
+      VELOX_USER_CHECK(
+          std::is_floating_point_v<TOffset>,
+          "Window frame offset of integer ORDER BY key must be an integer");
+      offset = offsets.asFlatVector<double>()->valueAt(index);
+      break;
+    case TypeKind::INTERVAL_DAY_TIME:
+      offset = offsets.asFlatVector<IntervalDayTime>()
+                   ->valueAt(index)
+                   .milliseconds();
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Unsupported window frame offset type: {}",
+          offsets.type()->toString());
+  }
+  VELOX_USER_CHECK(!(offset < 0), "Window frame offset must not be negative");
+  return offset;
+}
+
+// Returns 'key' plus or minus 'offset'. Integer results saturate so that the
+// frames of keys near the ends of the range contain the rows up to the end.
+template <typename TKey, typename TOffset>
+auto addRangeFrameOffset(TKey key, TOffset offset, bool subtract) {
+  if constexpr (std::is_same_v<TKey, Timestamp>) {
+    // 'offset' is an INTERVAL DAY TO SECOND in milliseconds.
+    const int64_t millis = subtract ? -offset : offset;
+    int64_t seconds = key.getSeconds() + millis / 1'000;
+    int64_t nanos = key.getNanos() + (millis % 1'000) * 1'000'000;
+    if (nanos < 0) {
+      nanos += 1'000'000'000;
+      --seconds;
+    } else if (nanos >= 1'000'000'000) {
+      nanos -= 1'000'000'000;
+      ++seconds;
+    }
+    return Timestamp(seconds, nanos);
+  } else if constexpr (std::is_floating_point_v<TKey>) {
+    return subtract ? key - offset : key + offset;
+  } else {
+    int64_t result;
+    if (subtract ? __builtin_sub_overflow(key, offset, &result)
+                 : __builtin_add_overflow(key, offset, &result)) {
+      return subtract ? std::numeric_limits<int64_t>::min()
+                      : std::numeric_limits<int64_t>::max();
+    }
+    return result;
+  }
+}
+
+// Computes the RANGE frame bounds of 'numRows' rows starting at 'startRow' of
+// a partition sorted on 'keys'. The non-null keys are in [nonNullBegin,
+// nonNullEnd). The bound of each row is found by binary search for the key
+// of the row plus or minus its offset. Consecutive rows with the same offset
+// have non-decreasing bounds, so that the bounds of these are found by
+// advancing from the bound of the previous row instead.
+template <typename TKey, typename TOffset>
+void computeKRangeFrameBounds(
+    const BaseVector& keys,
+    const BaseVector& offsets,
+    bool ascending,
+    bool subtract,
+    bool isStartBound,
+    vector_size_t startRow,
+    vector_size_t numRows,
+    vector_size_t nonNullBegin,
+    vector_size_t nonNullEnd,
+    const vector_size_t* rawPeerBounds,
+    vector_size_t* rawFrameBounds) {
+  const auto* rawKeys = keys.asFlatVector<TKey>()->rawValues();
+  auto before = [&](auto left, auto right) {
+    return ascending ? left < right : left > right;
+  };
+  std::optional<TOffset> previousOffset;
+  // For a start bound the position of the first row not before the target,
+  // for an end bound the position of the first row after the target.
+  vector_size_t position = nonNullBegin;
+  for (auto i = 0; i < numRows; ++i) {
+    const auto row = startRow + i;
+    if (keys.isNullAt(row)) {
+      // The frame of a row with a null key is its peer group.
+      rawFrameBounds[i] = rawPeerBounds[i];
+      previousOffset.reset();
+      continue;
+    }
+    const auto offset = rangeFrameOffset<TOffset>(offsets, i);
+    const auto target = addRangeFrameOffset(rawKeys[row], offset, subtract);
+    if (previousOffset != offset) {
+      position = isStartBound
+          ? std::lower_bound(
+                rawKeys + nonNullBegin, rawKeys + nonNullEnd, target, before) -
+              rawKeys
+          : std::upper_bound(
+                rawKeys + nonNullBegin, rawKeys + nonNullEnd, target, before) -
+              rawKeys;
+      previousOffset = offset;
+    } else if (isStartBound) {
+      while (position < nonNullEnd && before(rawKeys[position], target)) {
+        ++position;
+      }
+    } else {
+      while (position < nonNullEnd && !before(target, rawKeys[position])) {
+        ++position;
+      }
+    }
+    rawFrameBounds[i] = isStartBound ? position : position - 1;
+  }
+}
+} // namespace
+
+void Window::loadRangeFrameKeys(WindowEvaluator& evaluator) {
+  if (evaluator.rangeFrameKeysLoaded) {
+    return;
+  }
+  VELOX_USER_CHECK_EQ(
+      sortKeyInfo_.size(),
+      1,
+      "k PRECEDING and k FOLLOWING in RANGE mode require a single ORDER BY "
+      "key");
+  const auto channel = storedChannels_[sortKeyInfo_[0].first];
+  const auto numRows = evaluator.windowPartition->numRows();
+  auto& keys = evaluator.rangeFrameKeys;
+  if (!keys) {
+    keys = BaseVector::create(outputType_->childAt(channel), numRows, pool());
+  } else {
+    keys->resize(numRows);
+  }
+  evaluator.windowPartition->extractColumn(channel, 0, numRows, 0, keys);
+  // Nulls sort first or last, so that the non-null keys are a single range.
+  auto& nonNullBegin = evaluator.rangeFrameNonNullBegin;
+  auto& nonNullEnd = evaluator.rangeFrameNonNullEnd;
+  nonNullBegin = 0;
+  nonNullEnd = numRows;
+  if (keys->mayHaveNulls()) {
+    while (nonNullBegin < numRows && keys->isNullAt(nonNullBegin)) {
+      ++nonNullBegin;
+    }
+    while (nonNullEnd > nonNullBegin && keys->isNullAt(nonNullEnd - 1)) {
+      --nonNullEnd;
+    }
+  }
+  evaluator.rangeFrameKeysLoaded = true;
+}
+
+void Window::updateKRangeFrameBounds(
+    WindowEvaluator& evaluator,
+    bool isKPreceding,
+    bool isStartBound,
+    column_index_t frameChannel,
+    vector_size_t startRow,
+    vector_size_t numRows,
+    const vector_size_t* rawPeerBounds,
+    vector_size_t* rawFrameBounds) {
+  loadRangeFrameKeys(evaluator);
+  const auto& offsetType = outputType_->childAt(frameChannel);
+  VectorPtr offsets = BaseVector::create(offsetType, numRows, pool());
+  evaluator.windowPartition->extractColumn(
+      frameChannel, startRow, numRows, 0, offsets);
+
+  const bool ascending = sortKeyInfo_[0].second.isAscending();
+  // The preceding rows have smaller keys in ascending order and larger keys
+  // in descending order.
+  const bool subtract = isKPreceding == ascending;
+  auto compute = [&](auto key, auto offset) {
+    computeKRangeFrameBounds<decltype(key), decltype(offset)>(
+        *evaluator.rangeFrameKeys,
+        *offsets,
+        ascending,
+        subtract,
+        isStartBound,
+        startRow,
+        numRows,
+        evaluator.rangeFrameNonNullBegin,
+        evaluator.rangeFrameNonNullEnd,
+        rawPeerBounds,
+        rawFrameBounds);
+  };
+  const auto& keyType = evaluator.rangeFrameKeys->type();
+  switch (keyType->kind()) {
+    case TypeKind::TINYINT:
+      compute(int8_t(), int64_t());
+      break;
+    case TypeKind::SMALLINT:
+      compute(int16_t(), int64_t());
+      break;
+    case TypeKind::INTEGER:
+      compute(int32_t(), int64_t());
+      break;
+    case TypeKind::BIGINT:
+      compute(int64_t(), int64_t());
+      break;
+    case TypeKind::REAL:
+      compute(float(), double());
+      break;
+    case TypeKind::DOUBLE:
+      compute(double(), double());
+      break;
+    case TypeKind::TIMESTAMP:
+      VELOX_USER_CHECK_EQ(
+          offsetType->kind(),
+          TypeKind::INTERVAL_DAY_TIME,
+          "Window frame offset of TIMESTAMP ORDER BY key must be an "
+          "INTERVAL DAY TO SECOND");
+      compute(Timestamp(), int64_t());
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Unsupported ORDER BY key type for RANGE frame with offsets: {}",
+          keyType->toString());
   }
 }
 
 void Window::callApplyForPartitionRows(
+    WindowEvaluator& evaluator,
+    vector_size_t partitionNumber,
     vector_size_t startRow,
     vector_size_t endRow,
     const std::vector<VectorPtr>& result,
     vector_size_t resultOffset) {
-  if (partitionStartRows_[currentPartition_] == startRow) {
-    callResetPartition(currentPartition_);
+  if (partitionStartRows_[partitionNumber] == startRow) {
+    callResetPartition(evaluator, partitionNumber);
   }
 
   vector_size_t numRows = endRow - startRow;
-  vector_size_t numFuncs = windowFunctions_.size();
+  vector_size_t numFuncs = evaluator.windowFunctions.size();
+  auto& frameStartBuffers = evaluator.frameStartBuffers;
+  auto& frameEndBuffers = evaluator.frameEndBuffers;
 
   // Size buffers for the call to WindowFunction::apply.
   auto bufferSize = numRows * sizeof(vector_size_t);
-  peerStartBuffer_->setSize(bufferSize);
-  peerEndBuffer_->setSize(bufferSize);
-  auto rawPeerStarts = peerStartBuffer_->asMutable<vector_size_t>();
-  auto rawPeerEnds = peerEndBuffer_->asMutable<vector_size_t>();
+  evaluator.peerStartBuffer->setSize(bufferSize);
+  evaluator.peerEndBuffer->setSize(bufferSize);
+  auto rawPeerStarts = evaluator.peerStartBuffer->asMutable<vector_size_t>();
+  auto rawPeerEnds = evaluator.peerEndBuffer->asMutable<vector_size_t>();
 
   std::vector<vector_size_t*> rawFrameStartBuffers;
   std::vector<vector_size_t*> rawFrameEndBuffers;
   rawFrameStartBuffers.reserve(numFuncs);
   rawFrameEndBuffers.reserve(numFuncs);
   for (auto w = 0; w < numFuncs; w++) {
-    frameStartBuffers_[w]->setSize(bufferSize);
-    frameEndBuffers_[w]->setSize(bufferSize);
+    frameStartBuffers[w]->setSize(bufferSize);
+    frameEndBuffers[w]->setSize(bufferSize);
 
-    auto rawFrameStartBuffer =
-        frameStartBuffers_[w]->asMutable<vector_size_t>();
-    auto rawFrameEndBuffer = frameEndBuffers_[w]->asMutable<vector_size_t>();
+    auto rawFrameStartBuffer = frameStartBuffers[w]->asMutable<vector_size_t>();
+    auto rawFrameEndBuffer = frameEndBuffers[w]->asMutable<vector_size_t>();
     rawFrameStartBuffers.push_back(rawFrameStartBuffer);
     rawFrameEndBuffers.push_back(rawFrameEndBuffer);
   }
@@ -319,40 +1054,43 @@ void Window::callApplyForPartitionRows(
   auto peerCompare = [&](const char* lhs, const char* rhs) -> bool {
     return compareRowsWithKeys(lhs, rhs, sortKeyInfo_);
   };
-  auto firstPartitionRow = partitionStartRows_[currentPartition_];
-  auto lastPartitionRow = partitionStartRows_[currentPartition_ + 1] - 1;
+  auto firstPartitionRow = partitionStartRows_[partitionNumber];
+  auto lastPartitionRow = partitionStartRows_[partitionNumber + 1] - 1;
+  auto& peerStartRow = evaluator.peerStartRow;
+  auto& peerEndRow = evaluator.peerEndRow;
   for (auto i = startRow, j = 0; i < endRow; i++, j++) {
     // When traversing input partition rows, the peers are the rows
     // with the same values for the ORDER BY clause. These rows
     // are equal in some ways and affect the results of ranking functions.
-    // This logic exploits the fact that all rows between the peerStartRow_
-    // and peerEndRow_ have the same values for peerStartRow_ and peerEndRow_.
+    // This logic exploits the fact that all rows between the peerStartRow
+    // and peerEndRow have the same values for peerStartRow and peerEndRow.
     // So we can compute them just once and reuse across the rows in that peer
-    // interval. Note: peerStartRow_ and peerEndRow_ can be maintained across
+    // interval. Note: peerStartRow and peerEndRow can be maintained across
     // getOutput calls.
 
     // Compute peerStart and peerEnd rows for the first row of the partition or
     // when past the previous peerGroup.
-    if (i == firstPartitionRow || i >= peerEndRow_) {
-      peerStartRow_ = i;
-      peerEndRow_ = i;
-      while (peerEndRow_ <= lastPartitionRow) {
-        if (peerCompare(sortedRows_[peerStartRow_], sortedRows_[peerEndRow_])) {
+    if (i == firstPartitionRow || i >= peerEndRow) {
+      peerStartRow = i;
+      peerEndRow = i;
+      while (peerEndRow <= lastPartitionRow) {
+        if (peerCompare(sortedRows_[peerStartRow], sortedRows_[peerEndRow])) {
           break;
         }
-        peerEndRow_++;
+        peerEndRow++;
       }
     }
 
     // Peer buffer values should be offsets from the start of the partition
     // as WindowFunction only sees one partition at a time.
-    rawPeerStarts[j] = peerStartRow_ - firstPartitionRow;
-    rawPeerEnds[j] = peerEndRow_ - 1 - firstPartitionRow;
+    rawPeerStarts[j] = peerStartRow - firstPartitionRow;
+    rawPeerEnds[j] = peerEndRow - 1 - firstPartitionRow;
   }
 
   auto updateFrameBounds = [&](vector_size_t* rawFrameBounds,
                                core::WindowNode::BoundType boundType,
                                core::WindowNode::WindowType type,
+                               const std::optional<column_index_t>& channel,
                                bool isStartBound) -> void {
     switch (boundType) {
       case core::WindowNode::BoundType::kUnboundedPreceding:
@@ -380,8 +1118,31 @@ void Window::callApplyForPartitionRows(
         break;
       }
       case core::WindowNode::BoundType::kPreceding:
-      case core::WindowNode::BoundType::kFollowing:
-        VELOX_NYI("Not supported");
+      case core::WindowNode::BoundType::kFollowing: {
+        VELOX_CHECK(channel.has_value());
+        if (type == core::WindowNode::WindowType::kRange) {
+          updateKRangeFrameBounds(
+              evaluator,
+              boundType == core::WindowNode::BoundType::kPreceding,
+              isStartBound,
+              channel.value(),
+              startRow - firstPartitionRow,
+              numRows,
+              isStartBound ? rawPeerStarts : rawPeerEnds,
+              rawFrameBounds);
+          break;
+        }
+        updateKRowsFrameBounds(
+            evaluator,
+            boundType == core::WindowNode::BoundType::kPreceding,
+            isStartBound,
+            channel.value(),
+            startRow - firstPartitionRow,
+            numRows,
+            lastPartitionRow + 1 - firstPartitionRow,
+            rawFrameBounds);
+        break;
+      }
       default:
         VELOX_USER_FAIL("Invalid frame bound type");
     }
@@ -392,32 +1153,32 @@ void Window::callApplyForPartitionRows(
         rawFrameStartBuffers[i],
         windowFrames_[i].startType,
         windowFrames_[i].type,
+        windowFrames_[i].startChannel,
         true);
     updateFrameBounds(
         rawFrameEndBuffers[i],
         windowFrames_[i].endType,
         windowFrames_[i].type,
+        windowFrames_[i].endChannel,
         false);
   }
 
   // Invoke the apply method for the WindowFunctions.
   for (auto w = 0; w < numFuncs; w++) {
-    windowFunctions_[w]->apply(
-        peerStartBuffer_,
-        peerEndBuffer_,
-        frameStartBuffers_[w],
-        frameEndBuffers_[w],
+    evaluator.windowFunctions[w]->apply(
+        evaluator.peerStartBuffer,
+        evaluator.peerEndBuffer,
+        frameStartBuffers[w],
+        frameEndBuffers[w],
         resultOffset,
         result[w]);
   }
-
-  numProcessedRows_ += numRows;
-  if (endRow == partitionStartRows_[currentPartition_ + 1]) {
-    currentPartition_++;
-  }
 }
 
 void Window::callApplyLoop(
+    WindowEvaluator& evaluator,
+    vector_size_t& partitionNumber,
+    vector_size_t& row,
     vector_size_t numOutputRows,
     const std::vector<VectorPtr>& windowOutputs) {
   // Compute outputs by traversing as many partitions as possible. This
@@ -427,39 +1188,174 @@ void Window::callApplyLoop(
   vector_size_t numOutputRowsLeft = numOutputRows;
   while (numOutputRowsLeft > 0) {
     auto rowsForCurrentPartition =
-        partitionStartRows_[currentPartition_ + 1] - numProcessedRows_;
+        partitionStartRows_[partitionNumber + 1] - row;
     if (rowsForCurrentPartition <= numOutputRowsLeft) {
       // Current partition can fit completely in the output buffer.
       // So output all its rows.
       callApplyForPartitionRows(
-          numProcessedRows_,
-          numProcessedRows_ + rowsForCurrentPartition,
+          evaluator,
+          partitionNumber,
+          row,
+          row + rowsForCurrentPartition,
           windowOutputs,
           resultIndex);
       resultIndex += rowsForCurrentPartition;
       numOutputRowsLeft -= rowsForCurrentPartition;
+      row += rowsForCurrentPartition;
+      partitionNumber++;
     } else {
       // Current partition can fit only partially in the output buffer.
       // Call apply for the rows that can fit in the buffer and break from
       // outputting.
       callApplyForPartitionRows(
-          numProcessedRows_,
-          numProcessedRows_ + numOutputRowsLeft,
+          evaluator,
+          partitionNumber,
+          row,
+          row + numOutputRowsLeft,
           windowOutputs,
           resultIndex);
+      row += numOutputRowsLeft;
       numOutputRowsLeft = 0;
       break;
     }
   }
 }
 
+std::vector<VectorPtr> Window::createWindowOutputs(vector_size_t numRows) {
+  std::vector<VectorPtr> windowOutputs;
+  windowOutputs.reserve(windowFrames_.size());
+  for (int i = numInputColumns_; i < outputType_->size(); i++) {
+    windowOutputs.push_back(
+        BaseVector::create(outputType_->childAt(i), numRows, pool()));
+  }
+  return windowOutputs;
+}
+
+void Window::computePartitionsInParallel() {
+  const int64_t numEvaluators = evaluators_.size();
+  if (numEvaluators == 1 ||
+      numProcessedRows_ != partitionStartRows_[currentPartition_]) {
+    return;
+  }
+
+  // Takes the complete partitions up to at least one per evaluator and at
+  // least an output batch of rows per evaluator.
+  const auto outputableRows = numOutputableRows();
+  const auto numPartitions = partitionStartRows_.size() - 1;
+  auto endPartition = currentPartition_;
+  while (endPartition < numPartitions &&
+         partitionStartRows_[endPartition + 1] <= outputableRows &&
+         (endPartition - currentPartition_ < numEvaluators ||
+          partitionStartRows_[endPartition] - numProcessedRows_ <
+              numEvaluators * numRowsPerOutput_)) {
+    ++endPartition;
+  }
+  if (endPartition - currentPartition_ < 2) {
+    return;
+  }
+
+  // Splits the partitions into consecutive ranges of about the same number of
+  // rows, one for each evaluator.
+  const int64_t numRows = partitionStartRows_[endPartition] - numProcessedRows_;
+  std::vector<vector_size_t> rangeStarts{currentPartition_};
+  for (auto partition = currentPartition_ + 1;
+       partition < endPartition && rangeStarts.size() < evaluators_.size();
+       ++partition) {
+    const int64_t rangeRows =
+        partitionStartRows_[partition] - numProcessedRows_;
+    const int64_t numRanges = rangeStarts.size();
+    if (rangeRows * numEvaluators >= numRows * numRanges) {
+      rangeStarts.push_back(partition);
+    }
+  }
+  rangeStarts.push_back(endPartition);
+
+  using Outputs = std::vector<std::vector<VectorPtr>>;
+  auto* executor = operatorCtx_->task()->queryCtx()->executor();
+  std::vector<std::shared_ptr<AsyncSource<Outputs>>> steps;
+  for (auto i = 0; i + 1 < rangeStarts.size(); ++i) {
+    steps.push_back(std::make_shared<AsyncSource<Outputs>>(
+        [this,
+         evaluator = evaluators_[i].get(),
+         rangeStart = rangeStarts[i],
+         rangeEnd = rangeStarts[i + 1]]() {
+          return std::make_unique<Outputs>(
+              computePartitions(*evaluator, rangeStart, rangeEnd));
+        }));
+    executor->add([step = steps.back()]() { step->prepare(); });
+  }
+
+  // All steps must be synced also in case of error because they reference the
+  // evaluators and the rows of 'this'.
+  std::vector<std::unique_ptr<Outputs>> allOutputs;
+  std::exception_ptr error;
+  for (auto& step : steps) {
+    try {
+      allOutputs.push_back(step->move());
+      VELOX_CHECK_NOT_NULL(allOutputs.back());
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  for (auto& outputs : allOutputs) {
+    parallelOutputs_.insert(
+        parallelOutputs_.end(),
+        std::make_move_iterator(outputs->begin()),
+        std::make_move_iterator(outputs->end()));
+  }
+}
+
+std::vector<std::vector<VectorPtr>> Window::computePartitions(
+    WindowEvaluator& evaluator,
+    vector_size_t firstPartition,
+    vector_size_t endPartition) {
+  std::vector<std::vector<VectorPtr>> outputs;
+  auto partitionNumber = firstPartition;
+  auto row = partitionStartRows_[firstPartition];
+  const auto endRow = partitionStartRows_[endPartition];
+  while (row < endRow) {
+    const auto numOutputRows = std::min(numRowsPerOutput_, endRow - row);
+    outputs.push_back(createWindowOutputs(numOutputRows));
+    callApplyLoop(
+        evaluator, partitionNumber, row, numOutputRows, outputs.back());
+  }
+  return outputs;
+}
+
 RowVectorPtr Window::getOutput() {
-  if (finished_ || !noMoreInput_) {
+  if (finished_ || (!noMoreInput_ && !inputsSorted_)) {
     return nullptr;
   }
 
-  auto numRowsLeft = numRows_ - numProcessedRows_;
-  auto numOutputRows = std::min(numRowsPerOutput_, numRowsLeft);
+  const auto outputableRows = numOutputableRows();
+  if (numProcessedRows_ == outputableRows) {
+    // Waits for the next partition to complete in streaming mode.
+    return nullptr;
+  }
+
+  if (parallelOutputs_.empty()) {
+    computePartitionsInParallel();
+  }
+
+  // Construct vectors for the window function output columns. These are
+  // already computed if the partitions are computed in parallel.
+  std::vector<VectorPtr> windowOutputs;
+  vector_size_t numOutputRows;
+  const bool computedInParallel = !parallelOutputs_.empty();
+  if (computedInParallel) {
+    windowOutputs = std::move(parallelOutputs_.front());
+    parallelOutputs_.pop_front();
+    numOutputRows = windowOutputs[0]->size();
+  } else {
+    auto numRowsLeft = outputableRows - numProcessedRows_;
+    numOutputRows = std::min(numRowsPerOutput_, numRowsLeft);
+    windowOutputs = createWindowOutputs(numOutputRows);
+  }
+
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
 
@@ -468,27 +1364,38 @@ RowVectorPtr Window::getOutput() {
     data_->extractColumn(
         sortedRows_.data() + numProcessedRows_,
         numOutputRows,
-        i,
+        inputColumnIndices_[i],
         result->childAt(i));
   }
 
-  // Construct vectors for the window function output columns.
-  std::vector<VectorPtr> windowOutputs;
-  windowOutputs.reserve(windowFunctions_.size());
-  for (int i = numInputColumns_; i < outputType_->size(); i++) {
-    auto output = BaseVector::create(
-        outputType_->childAt(i), numOutputRows, operatorCtx_->pool());
-    windowOutputs.emplace_back(std::move(output));
+  if (computedInParallel) {
+    numProcessedRows_ += numOutputRows;
+    while (currentPartition_ + 1 < partitionStartRows_.size() &&
+           partitionStartRows_[currentPartition_ + 1] <= numProcessedRows_) {
+      currentPartition_++;
+    }
+  } else {
+    // Compute the output values of window functions.
+    callApplyLoop(
+        *evaluators_[0],
+        currentPartition_,
+        numProcessedRows_,
+        numOutputRows,
+        windowOutputs);
   }
 
-  // Compute the output values of window functions.
-  callApplyLoop(numOutputRows, windowOutputs);
-
   for (int j = numInputColumns_; j < outputType_->size(); j++) {
     result->childAt(j) = windowOutputs[j - numInputColumns_];
   }
 
-  finished_ = (numProcessedRows_ == sortedRows_.size());
+  if (numProcessedRows_ == numRows_) {
+    // All the loaded rows are output. Continues with the next window partition
+    // if reading back spilled data.
+    finished_ = spiller_ == nullptr || !loadNextSpilledPartition();
+  } else if (numProcessedRows_ == outputableRows) {
+    // All the complete partitions are output in streaming mode.
+    eraseOutputPartitions();
+  }
   return result;
 }
 
@@ -15,8 +15,11 @@
  */
 #pragma once
 
+#include <deque>
+
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/exec/WindowPartition.h"
 
@@ -34,6 +37,26 @@ namespace facebook::velox::exec {
 ///
 /// We will revise this algorithm in the future using a HashTable based
 /// approach pending some profiling results.
+///
+/// If spilling is enabled and the window has partition keys, the input rows
+/// are spilled as sorted runs hash partitioned on the partition keys when the
+/// memory usage goes over the limit. After all the input has been received,
+/// the spill partitions are merged back one at a time and the rows are loaded
+/// into the RowContainer one window partition at a time. So only a single
+/// window partition needs to fit in memory.
+///
+/// If the WindowNode specifies that the input is already sorted on the
+/// partition and sort keys, the input rows are not sorted and each partition
+/// is computed and output as soon as the first row of the next partition
+/// arrives. Only the rows of the last, possibly incomplete, partition are kept
+/// in the RowContainer between the input batches.
+///
+/// If the 'window_parallelism' query config is more than 1, the complete
+/// window partitions which remain to be output are split into consecutive
+/// ranges which are evaluated concurrently on the query executor. Each range
+/// is evaluated by its own set of window functions. The results are kept until
+/// they are output in order. A single window partition is always evaluated by
+/// one thread.
 class Window : public Operator {
  public:
   Window(
@@ -46,7 +69,10 @@ class Window : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_;
+    // In streaming mode, the complete partitions are output before adding more
+    // input to bound the memory usage.
+    return !noMoreInput_ &&
+        (!inputsSorted_ || numProcessedRows_ == numOutputableRows());
   }
 
   void noMoreInput() override;
@@ -69,8 +95,57 @@ class Window : public Operator {
     const std::optional<column_index_t> endChannel;
   };
 
+  // The state for computing window functions over the rows of one partition
+  // at a time. There is one for each thread computing window partitions in
+  // parallel.
+  struct WindowEvaluator {
+    // HashStringAllocator required by functions that allocate out of line
+    // buffers.
+    std::unique_ptr<HashStringAllocator> stringAllocator;
+
+    // Vector of WindowFunction objects. WindowFunction is the base API
+    // implemented by all the window functions. The functions are ordered by
+    // their positions in the output columns.
+    std::vector<std::unique_ptr<exec::WindowFunction>> windowFunctions;
+
+    // Window partition object used to provide per-partition
+    // data to the window function.
+    std::unique_ptr<WindowPartition> windowPartition;
+
+    // The following 4 Buffers are used to pass peer and frame start and
+    // end values to the WindowFunction::apply method. These
+    // buffers can be allocated once and reused across all the getOutput
+    // calls.
+    // Only a single peer start and peer end buffer is needed across all
+    // functions (as the peer values are based on the ORDER BY clause).
+    BufferPtr peerStartBuffer;
+    BufferPtr peerEndBuffer;
+    // A separate BufferPtr is required for the frame indexes of each
+    // function. Each function has its own frame clause and style. So we
+    // have as many buffers as the number of functions.
+    std::vector<BufferPtr> frameStartBuffers;
+    std::vector<BufferPtr> frameEndBuffers;
+
+    // When traversing input partition rows, the peers are the rows
+    // with the same values for the ORDER BY clause. These rows
+    // are equal in some ways and affect the results of ranking functions.
+    // Since all rows between the peerStartRow and peerEndRow have the same
+    // values for peerStartRow and peerEndRow, we needn't compute
+    // them for each row independently. Since these rows might
+    // cross getOutput boundaries they are saved in the evaluator.
+    vector_size_t peerStartRow = 0;
+    vector_size_t peerEndRow = 0;
+
+    // The ORDER BY key of the current partition for RANGE frames with k
+    // PRECEDING or k FOLLOWING bounds and the range of its non-null values.
+    VectorPtr rangeFrameKeys;
+    bool rangeFrameKeysLoaded{false};
+    vector_size_t rangeFrameNonNullBegin{0};
+    vector_size_t rangeFrameNonNullEnd{0};
+  };
+
   // Helper function to create WindowFunction and frame objects
-  // for this operator.
+  // for this operator. Each of 'evaluators_' gets its own WindowFunctions.
   void createWindowFunctions(
       const std::shared_ptr<const core::WindowNode>& windowNode,
       const RowTypePtr& inputType);
@@ -95,20 +170,71 @@ class Window : public Operator {
   // ORDER BY clause.
   void sortPartitions();
 
+  // Updates 'partitionStartRows_' after adding the rows starting at
+  // 'firstNewRow' in 'sortedRows_' in streaming mode.
+  void updatePartitionStartRows(vector_size_t firstNewRow);
+
+  // Returns the number of rows from the start of 'sortedRows_' which are in
+  // complete partitions and can be output. In streaming mode, the last
+  // partition is not complete until all the input is received.
+  vector_size_t numOutputableRows() const;
+
+  // Erases the rows of the partitions which have been output from 'data_' in
+  // streaming mode. The rows of the incomplete last partition are kept.
+  void eraseOutputPartitions();
+
   // Helper function to call WindowFunction::resetPartition() for
-  // all WindowFunctions.
-  void callResetPartition(vector_size_t partitionNumber);
+  // all WindowFunctions of 'evaluator'.
+  void callResetPartition(
+      WindowEvaluator& evaluator,
+      vector_size_t partitionNumber);
 
   // Helper method to call WindowFunction::apply to all the rows
-  // of a partition between startRow and endRow. The outputs
+  // of partition 'partitionNumber' between startRow and endRow. The outputs
   // will be written to the vectors in windowFunctionOutputs
   // starting at offset resultIndex.
   void callApplyForPartitionRows(
+      WindowEvaluator& evaluator,
+      vector_size_t partitionNumber,
       vector_size_t startRow,
       vector_size_t endRow,
       const std::vector<VectorPtr>& result,
       vector_size_t resultOffset);
 
+  // Computes the ROWS frame bounds of a k PRECEDING or k FOLLOWING frame
+  // start or end for 'numRows' rows starting at 'startRow' of the current
+  // partition. The offsets k are read from input channel 'frameChannel'.
+  // The bounds are written to 'rawFrameBounds' as offsets from the start of
+  // the partition of 'numPartitionRows' rows.
+  void updateKRowsFrameBounds(
+      const WindowEvaluator& evaluator,
+      bool isKPreceding,
+      bool isStartBound,
+      column_index_t frameChannel,
+      vector_size_t startRow,
+      vector_size_t numRows,
+      vector_size_t numPartitionRows,
+      vector_size_t* rawFrameBounds);
+
+  // Computes the RANGE frame bounds of a k PRECEDING or k FOLLOWING frame
+  // start or end like updateKRowsFrameBounds(). The bound of a row is the
+  // first or last row of the partition whose ORDER BY key is within k of the
+  // key of the row. Rows with a null key have their peer group as frame, the
+  // peer starts or ends are given in 'rawPeerBounds'.
+  void updateKRangeFrameBounds(
+      WindowEvaluator& evaluator,
+      bool isKPreceding,
+      bool isStartBound,
+      column_index_t frameChannel,
+      vector_size_t startRow,
+      vector_size_t numRows,
+      const vector_size_t* rawPeerBounds,
+      vector_size_t* rawFrameBounds);
+
+  // Extracts the ORDER BY key of the current partition of 'evaluator' into
+  // its 'rangeFrameKeys' on first use in the partition.
+  void loadRangeFrameKeys(WindowEvaluator& evaluator);
+
   // Helper function to compare the rows at lhs and rhs pointers
   // using the keyInfo in keys. This can be used to compare the
   // rows for partitionKeys, orderByKeys or a combination of both.
@@ -118,31 +244,102 @@ class Window : public Operator {
       const std::vector<std::pair<column_index_t, core::SortOrder>>& keys);
 
   // Function to compute window function values for the current output
-  // buffer. The buffer has numOutputRows number of rows. windowOutputs
-  // has the vectors for window function columns.
+  // buffer. The buffer has numOutputRows number of rows starting at 'row' of
+  // partition 'partitionNumber' in 'sortedRows_'. windowOutputs has the
+  // vectors for window function columns. 'partitionNumber' and 'row' are
+  // advanced past the computed rows.
   void callApplyLoop(
+      WindowEvaluator& evaluator,
+      vector_size_t& partitionNumber,
+      vector_size_t& row,
       vector_size_t numOutputRows,
       const std::vector<VectorPtr>& windowOutputs);
 
+  // Returns vectors of 'numRows' rows for the window function columns.
+  std::vector<VectorPtr> createWindowOutputs(vector_size_t numRows);
+
+  // Computes the window function values of the complete partitions starting
+  // at 'currentPartition_' in parallel on the query executor and adds them to
+  // 'parallelOutputs_'. Does nothing if there are fewer than 2 such
+  // partitions or if the output is in the middle of a partition.
+  void computePartitionsInParallel();
+
+  // Computes the window function values of the partitions in
+  // ['firstPartition', 'endPartition') using 'evaluator'. Returns the values
+  // in batches of at most 'numRowsPerOutput_' rows.
+  std::vector<std::vector<VectorPtr>> computePartitions(
+      WindowEvaluator& evaluator,
+      vector_size_t firstPartition,
+      vector_size_t endPartition);
+
+  // Checks if input will fit in the existing memory and increases
+  // reservation if not. If reservation cannot be increased, spills enough to
+  // make 'input' fit.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills content until under 'targetRows' and under 'targetBytes' of out of
+  // line data are left. If 'targetRows' is 0, spills everything and physically
+  // frees the data in the 'data_'.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  void updateSpillStats();
+
+  // Clears 'data_' and loads the rows of the next window partition from the
+  // spilled data into it. Returns false if there is no more spilled data.
+  bool loadNextSpilledPartition();
+
+  // Returns true if the current row of 'stream' has the same partition keys
+  // as 'spillPartitionKeys_'.
+  bool isInSpilledPartition(const SpillMergeStream& stream) const;
+
+  // Stores the rows accumulated in 'spillBatch_' into 'data_'.
+  void storeSpillBatch();
+
+  // Number of rows read from the spilled data at a time before being stored
+  // in 'data_'.
+  static constexpr vector_size_t kSpillBatchSize = 1'024;
+
   bool finished_ = false;
+  // True if the input is sorted on the partition and sort keys.
+  const bool inputsSorted_;
   const vector_size_t outputBatchSizeInBytes_;
   const vector_size_t numInputColumns_;
 
+  // The maximum memory usage that a window can hold before spilling.
+  // If it is zero, then there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
   // The Window operator needs to see all the input rows before starting
   // any function computation. As the Window operators gets input rows
-  // we store the rows in the RowContainer (data_).
+  // we store the rows in the RowContainer (data_). The partition keys
+  // followed by the sort keys are stored as the keys of 'data_' so that
+  // the RowContainer can be sorted and spilled in window order. The other
+  // input columns are stored as dependents.
   std::unique_ptr<RowContainer> data_;
 
+  // The input channel stored in each column of 'data_'.
+  std::vector<column_index_t> storedChannels_;
+
+  // The column of 'data_' storing each input channel.
+  std::vector<column_index_t> inputColumnIndices_;
+
+  // The row type of 'data_' which is used as the spill row type.
+  RowTypePtr spillType_;
+
+  // Compare flags of the keys of 'data_' for the sort of spilled rows.
+  std::vector<CompareFlags> keyCompareFlags_;
+
   // The decodedInputVectors_ are reused across addInput() calls to decode
   // the partition and sort keys for the above RowContainer.
   std::vector<DecodedVector> decodedInputVectors_;
 
-  // HashStringAllocator required by functions that allocate out of line
-  // buffers.
-  HashStringAllocator stringAllocator_;
-
-  // The below 3 vectors represent the ChannelIndex of the partition keys,
-  // the order by keys and the concatenation of the 2. These keyInfo are
+  // The below 3 vectors represent the column index in 'data_' of the partition
+  // keys, the order by keys and the concatenation of the 2. The order by keys
+  // which are also partition keys are left out as they are the same for all
+  // the rows of a partition. These keyInfo are
   // used for sorting by those key combinations during the processing.
   // partitionKeyInfo_ is used to separate partitions in the rows.
   // sortKeyInfo_ is used to identify peer rows in a partition.
@@ -154,29 +351,27 @@ class Window : public Operator {
   std::vector<std::pair<column_index_t, core::SortOrder>> sortKeyInfo_;
   std::vector<std::pair<column_index_t, core::SortOrder>> allKeyInfo_;
 
-  // Vector of WindowFunction objects required by this operator.
-  // WindowFunction is the base API implemented by all the window functions.
-  // The functions are ordered by their positions in the output columns.
-  std::vector<std::unique_ptr<exec::WindowFunction>> windowFunctions_;
-  // Vector of WindowFrames corresponding to each windowFunction above.
+  // The evaluators of the window functions. The first one is used for the
+  // partitions which are not computed in parallel. There is more than one if
+  // the window partitions are computed in parallel.
+  std::vector<std::unique_ptr<WindowEvaluator>> evaluators_;
+  // Vector of WindowFrames corresponding to each window function.
   // It represents the frame spec for the function computation.
   std::vector<WindowFrame> windowFrames_;
 
   // This SelectivityVector is used across addInput calls for decoding.
   SelectivityVector inputRows_;
-  // Number of input rows.
+  // Number of input rows. When reading back spilled data, this is the number
+  // of rows of the window partition loaded in 'data_'.
   vector_size_t numRows_ = 0;
 
   // Vector of pointers to each input row in the data_ RowContainer.
   // The rows are sorted by partitionKeys + sortKeys. This total
   // ordering can be used to split partitions (with the correct
-  // order by) for the processing.
+  // order by) for the processing. In streaming mode, the rows are
+  // appended in the input order as they are added.
   std::vector<char*> sortedRows_;
 
-  // Window partition object used to provide per-partition
-  // data to the window function.
-  std::unique_ptr<WindowPartition> windowPartition_;
-
   // Number of rows that be fit into an output block.
   vector_size_t numRowsPerOutput_;
 
@@ -186,20 +381,6 @@ class Window : public Operator {
   // getOutput calls.
   std::vector<vector_size_t> partitionStartRows_;
 
-  // The following 4 Buffers are used to pass peer and frame start and
-  // end values to the WindowFunction::apply method. These
-  // buffers can be allocated once and reused across all the getOutput
-  // calls.
-  // Only a single peer start and peer end buffer is needed across all
-  // functions (as the peer values are based on the ORDER BY clause).
-  BufferPtr peerStartBuffer_;
-  BufferPtr peerEndBuffer_;
-  // A separate BufferPtr is required for the frame indexes of each
-  // function. Each function has its own frame clause and style. So we
-  // have as many buffers as the number of functions.
-  std::vector<BufferPtr> frameStartBuffers_;
-  std::vector<BufferPtr> frameEndBuffers_;
-
   // Number of rows output from the WindowOperator so far. The rows
   // are output in the same order of the pointers in sortedRows. This
   // value is updated as the WindowFunction::apply() function is
@@ -210,15 +391,38 @@ class Window : public Operator {
   // be tracked in the operator.
   vector_size_t currentPartition_;
 
-  // When traversing input partition rows, the peers are the rows
-  // with the same values for the ORDER BY clause. These rows
-  // are equal in some ways and affect the results of ranking functions.
-  // Since all rows between the peerStartRow_ and peerEndRow_ have the same
-  // values for peerStartRow_ and peerEndRow_, we needn't compute
-  // them for each row independently. Since these rows might
-  // cross getOutput boundaries they are saved in the operator.
-  vector_size_t peerStartRow_ = 0;
-  vector_size_t peerEndRow_ = 0;
+  // The window function values computed in parallel which are not yet
+  // output. Each entry has the values of the next rows to output starting at
+  // 'numProcessedRows_'.
+  std::deque<std::vector<VectorPtr>> parallelOutputs_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_';.
+  uint64_t spillTestCounter_{0};
+
+  // The next spill partition to read back after 'spillMerge_' is exhausted.
+  int32_t nextSpillPartition_{0};
+
+  // Merges the sorted spill runs of the spill partition being read back.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // If not null, the stream from 'spillMerge_' whose current row is the first
+  // row of the next window partition to load.
+  SpillMergeStream* spillStream_{nullptr};
+
+  // Single row vector with the partition keys of the window partition being
+  // loaded from the spilled data.
+  RowVectorPtr spillPartitionKeys_;
+
+  // Rows read from the spilled data which are not yet stored in 'data_'.
+  RowVectorPtr spillBatch_;
+  vector_size_t numSpillBatchRows_{0};
+
+  // Record the source rows to copy to 'spillBatch_' in order.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
 };
 
 } // namespace facebook::velox::exec
@@ -72,7 +72,9 @@ class WindowFunction {
   /// @param frameStarts  A buffer of the indexes of rows at which the
   /// frame for the current row starts.
   /// @param frameEnds  A buffer of the indexes of rows at which the frame
-  /// for the current row ends.
+  /// for the current row ends. The frame of a row is empty if its frame
+  /// start is greater than its frame end, e.g. for ROWS BETWEEN 2 PRECEDING
+  /// AND 1 PRECEDING at the first row of the partition.
   /// @param resultOffset  This function is invoked multiple times for a
   /// partition as output buffers are available for it. resultOffset
   /// is the offset in the result buffer corresponding to the current
@@ -95,6 +97,7 @@ class WindowFunction {
       const std::string& name,
       const std::vector<WindowFunctionArg>& args,
       const TypePtr& resultType,
+      bool ignoreNulls,
       memory::MemoryPool* pool,
       HashStringAllocator* stringAllocator);
 
@@ -110,9 +113,12 @@ class WindowFunction {
 /// operator. These indices are used to access data from the WindowPartition
 /// object.
 /// @param resultType  Type of the result of the function.
+/// @param ignoreNulls  True if the function call has the IGNORE NULLS clause.
+/// Functions that do not support it ignore it.
 using WindowFunctionFactory = std::function<std::unique_ptr<WindowFunction>(
     const std::vector<WindowFunctionArg>& args,
     const TypePtr& resultType,
+    bool ignoreNulls,
     memory::MemoryPool* pool,
     HashStringAllocator* stringAllocator)>;
 
@@ -53,4 +53,29 @@ void WindowPartition::extractColumn(
       result);
 }
 
+void WindowPartition::extractNulls(
+    int32_t columnIndex,
+    vector_size_t partitionOffset,
+    vector_size_t numRows,
+    const BufferPtr& nullsBuffer) const {
+  VELOX_CHECK_LE(partitionOffset + numRows, partition_.size());
+  VELOX_CHECK_GE(nullsBuffer->size(), bits::nbytes(numRows));
+
+  auto* rawNulls = nullsBuffer->asMutable<uint64_t>();
+  const auto& column = columns_[columnIndex];
+  const auto nullMask = column.nullMask();
+  if (!nullMask) {
+    bits::fillBits(rawNulls, 0, numRows, false);
+    return;
+  }
+  const auto nullByte = column.nullByte();
+  for (auto i = 0; i < numRows; ++i) {
+    bits::setBit(
+        rawNulls,
+        i,
+        RowContainer::isNullAt(
+            partition_[partitionOffset + i], nullByte, nullMask));
+  }
+}
+
 } // namespace facebook::velox::exec
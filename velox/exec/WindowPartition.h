@@ -55,6 +55,16 @@ class WindowPartition {
       vector_size_t resultOffset,
       const VectorPtr& result) const;
 
+  /// Sets the bits of 'nullsBuffer' for 'numRows' starting at position
+  /// 'partitionOffset' in the partition input data to the nulls of the column
+  /// at 'columnIndex'. Bit i is set if the value of row 'partitionOffset' + i
+  /// is null. 'nullsBuffer' must have space for 'numRows' bits.
+  void extractNulls(
+      int32_t columnIndex,
+      vector_size_t partitionOffset,
+      vector_size_t numRows,
+      const BufferPtr& nullsBuffer) const;
+
  private:
   // This is a copy of the input RowColumn objects that are used for
   // accessing the partition row columns. These RowColumn objects
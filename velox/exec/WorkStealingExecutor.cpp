@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/WorkStealingExecutor.h"
+
+#include <glog/logging.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+namespace {
+// The executor and queue of the current thread, if it is an executor thread.
+thread_local const WorkStealingExecutor* currentExecutor{nullptr};
+thread_local int32_t currentWorker{-1};
+
+void pinToCore(std::thread& thread, int32_t index) {
+#ifdef __linux__
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(index % std::thread::hardware_concurrency(), &cpus);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+#endif
+}
+} // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(
+    int32_t numThreads,
+    bool pinThreads) {
+  VELOX_CHECK_GT(numThreads, 0);
+  workers_.reserve(numThreads);
+  for (auto i = 0; i < numThreads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (auto i = 0; i < numThreads; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { run(i); });
+    if (pinThreads) {
+      pinToCore(workers_[i]->thread, i);
+    }
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  {
+    std::lock_guard<std::mutex> l(sleepMutex_);
+    stop_ = true;
+  }
+  wakeup_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void WorkStealingExecutor::add(folly::Func func) {
+  const bool isLocal = currentExecutor == this;
+  const auto index =
+      isLocal ? currentWorker : nextQueue_.fetch_add(1) % workers_.size();
+  auto& worker = *workers_[index];
+  size_t queueSize;
+  {
+    std::lock_guard<std::mutex> l(worker.mutex);
+    worker.queue.push_back(std::move(func));
+    queueSize = worker.queue.size();
+  }
+  ++numQueued_;
+  // The current thread runs a function it added to its empty queue next, so
+  // no other thread is woken up to take it away.
+  if ((!isLocal || queueSize > 1) && numSleeping_ > 0) {
+    // Taking the mutex makes sure that a thread that counted itself as
+    // sleeping is waiting before the notify.
+    std::lock_guard<std::mutex> l(sleepMutex_);
+    wakeup_.notify_one();
+  }
+}
+
+folly::Func WorkStealingExecutor::next(int32_t index) {
+  const auto numWorkers = workers_.size();
+  for (auto i = 0; i < numWorkers; ++i) {
+    auto& worker = *workers_[(index + i) % numWorkers];
+    std::lock_guard<std::mutex> l(worker.mutex);
+    if (!worker.queue.empty()) {
+      auto func = std::move(worker.queue.front());
+      worker.queue.pop_front();
+      --numQueued_;
+      if (i > 0) {
+        ++numStolen_;
+      }
+      return func;
+    }
+  }
+  return nullptr;
+}
+
+void WorkStealingExecutor::run(int32_t index) {
+  currentExecutor = this;
+  currentWorker = index;
+  for (;;) {
+    if (auto func = next(index)) {
+      try {
+        func();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Exception in WorkStealingExecutor: " << e.what();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> l(sleepMutex_);
+    ++numSleeping_;
+    wakeup_.wait(l, [&]() { return stop_ || numQueued_ > 0; });
+    --numSleeping_;
+    if (stop_ && numQueued_ == 0) {
+      return;
+    }
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// Executor with a run queue per thread for running Drivers, set as the
+/// executor of a QueryCtx. A function added from one of the threads of the
+/// executor goes to the queue of that thread, so that a Driver that yields and
+/// re-enqueues itself continues on the thread, and with 'pinThreads' on the
+/// core, it last ran on. Functions added from other threads are spread
+/// round-robin over the queues. A thread with an empty queue steals the oldest
+/// function from the queue of another thread before it goes to sleep.
+class WorkStealingExecutor : public folly::Executor {
+ public:
+  /// Starts 'numThreads' threads. If 'pinThreads' is true, thread i is bound
+  /// to core i modulo the number of cores. Pinning is a no-op outside Linux.
+  explicit WorkStealingExecutor(int32_t numThreads, bool pinThreads = false);
+
+  /// Runs the functions left in the queues and joins the threads.
+  ~WorkStealingExecutor() override;
+
+  void add(folly::Func func) override;
+
+  int32_t numThreads() const {
+    return workers_.size();
+  }
+
+  /// Number of functions that ran on another thread than the one whose queue
+  /// they were added to.
+  uint64_t numStolen() const {
+    return numStolen_;
+  }
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<folly::Func> queue;
+    std::thread thread;
+  };
+
+  // Returns the next function for the thread of 'workers_[index]' from its own
+  // queue or from another one. Returns an empty function if all are empty.
+  folly::Func next(int32_t index);
+
+  void run(int32_t index);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Queue for the next function added from outside of the executor threads.
+  std::atomic<uint32_t> nextQueue_{0};
+
+  // Number of functions in all queues. Incremented after a push and read
+  // before sleeping, so that a thread does not sleep with work queued.
+  std::atomic<int64_t> numQueued_{0};
+  // Number of threads waiting on 'wakeup_'. Incremented under 'sleepMutex_'.
+  std::atomic<int32_t> numSleeping_{0};
+  std::atomic<uint64_t> numStolen_{0};
+
+  std::mutex sleepMutex_;
+  std::condition_variable wakeup_;
+  bool stop_{false};
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/hash/Hash.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+DEFINE_int64(num_rows, 10'000'000, "Number of input rows of each benchmark");
+DEFINE_int32(batch_size, 10'000, "Number of rows per input batch");
+DEFINE_string(
+    cardinalities,
+    "10,10000,1000000,10000000",
+    "Comma separated numbers of groups. Numbers above num_rows are reduced to "
+    "num_rows, e.g. 100M groups need --num_rows=100000000");
+DEFINE_int64(
+    spill_threshold,
+    64 << 20,
+    "Memory in bytes after which the spilling aggregation spills");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+// Measures the throughput of HashAggregation in rows per second for grouping
+// keys of different types and numbers of groups. Each key shape is run as a
+// single aggregation, as a partial aggregation followed by a final
+// aggregation and as a single aggregation that spills. The numbers of groups
+// move the hash table through its modes: few groups of integers fit kArray,
+// more groups of small integers fit kNormalizedKey and strings or wide
+// ranges need kHash. After the benchmarks, prints the peak memory of the
+// final aggregation per group.
+namespace {
+enum class KeyShape {
+  // A BIGINT key.
+  kInt,
+  // Two INTEGER keys.
+  kMultiInt,
+  // A VARCHAR key of 18 bytes, which is not inlined in StringView.
+  kVarchar,
+  // A BIGINT and a VARCHAR key.
+  kMixed,
+};
+
+enum class Step { kSingle, kPartialFinal, kSpill };
+
+std::string shapeName(KeyShape shape) {
+  switch (shape) {
+    case KeyShape::kInt:
+      return "int";
+    case KeyShape::kMultiInt:
+      return "multiInt";
+    case KeyShape::kVarchar:
+      return "varchar";
+    case KeyShape::kMixed:
+      return "mixed";
+  }
+  VELOX_UNREACHABLE();
+}
+
+std::string stepName(Step step) {
+  switch (step) {
+    case Step::kSingle:
+      return "single";
+    case Step::kPartialFinal:
+      return "partialFinal";
+    case Step::kSpill:
+      return "spill";
+  }
+  VELOX_UNREACHABLE();
+}
+
+std::vector<std::string> keyNames(KeyShape shape) {
+  switch (shape) {
+    case KeyShape::kInt:
+    case KeyShape::kVarchar:
+      return {"k0"};
+    case KeyShape::kMultiInt:
+    case KeyShape::kMixed:
+      return {"k0", "k1"};
+  }
+  VELOX_UNREACHABLE();
+}
+
+// Statistics of the last run of a benchmark.
+struct RunStats {
+  int64_t numGroups{0};
+  uint64_t peakBytes{0};
+  uint64_t spilledBytes{0};
+};
+
+class AggregationBenchmark {
+ public:
+  // Aggregates the input for 'shape' and 'numGroups' with 'step' and returns
+  // the number of input rows.
+  int64_t run(KeyShape shape, int64_t numGroups, Step step) {
+    const auto& batches = input(shape, numGroups);
+    const auto keys = keyNames(shape);
+    const std::vector<std::string> aggregates = {
+        "sum(v)", "count(v)", "max(v)"};
+
+    core::PlanNodeId aggregationId;
+    PlanBuilder builder;
+    builder.values(batches);
+    if (step == Step::kPartialFinal) {
+      builder.partialAggregation(keys, aggregates).finalAggregation();
+    } else {
+      builder.singleAggregation(keys, aggregates);
+    }
+    builder.capturePlanNodeId(aggregationId);
+
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    std::shared_ptr<TempDirectoryPath> spillDirectory;
+    CursorParameters params;
+    params.planNode = builder.planNode();
+    params.queryCtx = queryCtx;
+    if (step == Step::kSpill) {
+      spillDirectory = TempDirectoryPath::create();
+      params.spillDirectory = spillDirectory->path;
+      queryCtx->setConfigOverridesUnsafe({
+          {core::QueryConfig::kSpillEnabled, "true"},
+          {core::QueryConfig::kAggregationSpillEnabled, "true"},
+          {core::QueryConfig::kAggregationSpillMemoryThreshold,
+           std::to_string(FLAGS_spill_threshold)},
+      });
+    }
+
+    TaskCursor cursor(params);
+    int64_t numOutputRows = 0;
+    while (cursor.moveNext()) {
+      numOutputRows += cursor.current()->size();
+    }
+    VELOX_CHECK_LE(numOutputRows, numGroups);
+
+    auto& stats = runStats_[benchmarkName(shape, numGroups, step)];
+    const auto planStats = toPlanStats(cursor.task()->taskStats());
+    const auto& aggregationStats = planStats.at(aggregationId);
+    stats.numGroups = numOutputRows;
+    stats.peakBytes = aggregationStats.peakMemoryBytes;
+    stats.spilledBytes = aggregationStats.spilledBytes;
+    return FLAGS_num_rows;
+  }
+
+  static std::string
+  benchmarkName(KeyShape shape, int64_t numGroups, Step step) {
+    return fmt::format(
+        "{}_{}_{}", shapeName(shape), numGroups, stepName(step));
+  }
+
+  // Prints the peak memory per group of each benchmark.
+  void printStats() const {
+    std::cout << fmt::format(
+                     "{:<36} {:>12} {:>14} {:>12} {:>14}",
+                     "benchmark",
+                     "groups",
+                     "peak bytes",
+                     "bytes/group",
+                     "spilled bytes")
+              << std::endl;
+    for (const auto& [name, stats] : runStats_) {
+      std::cout << fmt::format(
+                       "{:<36} {:>12} {:>14} {:>12.1f} {:>14}",
+                       name,
+                       stats.numGroups,
+                       stats.peakBytes,
+                       stats.numGroups
+                           ? static_cast<double>(stats.peakBytes) /
+                               stats.numGroups
+                           : 0,
+                       stats.spilledBytes)
+                << std::endl;
+    }
+  }
+
+ private:
+  // Returns the input for 'shape' and 'numGroups'. The benchmarks of a shape
+  // and number of groups run one after the other, so only the last input is
+  // kept.
+  const std::vector<RowVectorPtr>& input(KeyShape shape, int64_t numGroups) {
+    if (inputShape_ == shape && inputNumGroups_ == numGroups) {
+      return input_;
+    }
+    input_.clear();
+    inputShape_ = shape;
+    inputNumGroups_ = numGroups;
+
+    // The group of each row is a hash of the row number, so that the groups
+    // arrive in random order.
+    auto groupAt = [&](int64_t row) {
+      return static_cast<int64_t>(
+          folly::hash::twang_mix64(row) % static_cast<uint64_t>(numGroups));
+    };
+    std::string buffer;
+    auto stringKey = [&](int64_t group) {
+      buffer = fmt::format("group-{:012}", group);
+      return StringView(buffer);
+    };
+    for (int64_t start = 0; start < FLAGS_num_rows;
+         start += FLAGS_batch_size) {
+      const auto size =
+          std::min<int64_t>(FLAGS_batch_size, FLAGS_num_rows - start);
+      std::vector<VectorPtr> keys;
+      switch (shape) {
+        case KeyShape::kInt:
+          keys.push_back(vectorMaker_.flatVector<int64_t>(
+              size, [&](auto row) { return groupAt(start + row); }));
+          break;
+        case KeyShape::kMultiInt:
+          keys.push_back(vectorMaker_.flatVector<int32_t>(
+              size, [&](auto row) { return groupAt(start + row) % 1'000; }));
+          keys.push_back(vectorMaker_.flatVector<int32_t>(
+              size, [&](auto row) { return groupAt(start + row) / 1'000; }));
+          break;
+        case KeyShape::kVarchar:
+          keys.push_back(vectorMaker_.flatVector<StringView>(
+              size,
+              [&](auto row) { return stringKey(groupAt(start + row)); }));
+          break;
+        case KeyShape::kMixed:
+          keys.push_back(vectorMaker_.flatVector<int64_t>(
+              size, [&](auto row) { return groupAt(start + row) % 1'000; }));
+          keys.push_back(
+              vectorMaker_.flatVector<StringView>(size, [&](auto row) {
+                return stringKey(groupAt(start + row) / 1'000);
+              }));
+          break;
+      }
+      std::vector<std::string> names = {"k0", "k1"};
+      names.resize(keys.size());
+      names.push_back("v");
+      keys.push_back(vectorMaker_.flatVector<int64_t>(
+          size, [&](auto row) { return start + row; }));
+      input_.push_back(vectorMaker_.rowVector(names, keys));
+    }
+    return input_;
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  facebook::velox::test::VectorMaker vectorMaker_{pool_.get()};
+  std::shared_ptr<folly::Executor> executor_{
+      std::make_shared<folly::CPUThreadPoolExecutor>(
+          std::thread::hardware_concurrency())};
+
+  std::optional<KeyShape> inputShape_;
+  int64_t inputNumGroups_{0};
+  std::vector<RowVectorPtr> input_;
+
+  std::map<std::string, RunStats> runStats_;
+};
+
+std::unique_ptr<AggregationBenchmark> benchmark;
+
+// Adds the benchmarks for all key shapes, numbers of groups and steps. Folly
+// reports the time per input row and the rows per second.
+void addBenchmarks() {
+  std::vector<folly::StringPiece> cardinalities;
+  folly::split(',', FLAGS_cardinalities, cardinalities);
+  for (auto shape :
+       {KeyShape::kInt,
+        KeyShape::kMultiInt,
+        KeyShape::kVarchar,
+        KeyShape::kMixed}) {
+    for (auto cardinality : cardinalities) {
+      const auto numGroups =
+          std::min(folly::to<int64_t>(cardinality), FLAGS_num_rows);
+      for (auto step : {Step::kSingle, Step::kPartialFinal, Step::kSpill}) {
+        folly::addBenchmark(
+            __FILE__,
+            AggregationBenchmark::benchmarkName(shape, numGroups, step),
+            [shape, numGroups, step](unsigned iterations) {
+              unsigned numRows = 0;
+              for (unsigned i = 0; i < iterations; ++i) {
+                numRows += benchmark->run(shape, numGroups, step);
+              }
+              return numRows;
+            });
+      }
+    }
+  }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  aggregate::prestosql::registerAllAggregateFunctions();
+  benchmark = std::make_unique<AggregationBenchmark>();
+  addBenchmarks();
+  folly::runBenchmarks();
+  benchmark->printStats();
+  benchmark.reset();
+  return 0;
+}
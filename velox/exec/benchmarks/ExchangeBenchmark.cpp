@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/Exchange.h"
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/serializers/ColumnarSerializer.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+DEFINE_int32(num_batches, 200, "Number of batches sent by the producer");
+DEFINE_int32(batch_size, 10'000, "Number of rows per batch");
+DEFINE_bool(
+    columnar_serde,
+    false,
+    "Use ColumnarVectorSerde instead of PrestoVectorSerde");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+// Measures the throughput of PartitionedOutput to Exchange between local tasks,
+// including serialization, the exchange queues and deserialization. The pages
+// are read from the IOBuf chains of the producer without copying.
+namespace {
+class ExchangeBenchmark {
+ public:
+  ExchangeBenchmark() {
+    VectorFuzzer::Options options;
+    options.vectorSize = FLAGS_batch_size;
+    options.nullRatio = 0.05;
+    options.stringVariableLength = true;
+    options.stringLength = 30;
+    VectorFuzzer fuzzer(options, pool_.get(), 1);
+    rowType_ =
+        ROW({"c0", "c1", "c2", "c3"},
+            {BIGINT(), DOUBLE(), VARCHAR(), ARRAY(INTEGER())});
+    // Repeats a few distinct batches to keep the setup cheap.
+    std::vector<RowVectorPtr> distinct;
+    for (auto i = 0; i < 10; ++i) {
+      std::vector<VectorPtr> children;
+      for (const auto& type : rowType_->children()) {
+        children.push_back(fuzzer.fuzzFlat(type));
+      }
+      distinct.push_back(vectorMaker_.rowVector(rowType_->names(), children));
+    }
+    for (auto i = 0; i < FLAGS_num_batches; ++i) {
+      batches_.push_back(distinct[i % distinct.size()]);
+    }
+  }
+
+  // Sends the batches from a producer task to 'numDestinations' consumer tasks
+  // and returns the number of rows received.
+  int64_t run(int32_t numDestinations) {
+    const auto producerId =
+        fmt::format("local://exchange-benchmark-{}", numTasks_++);
+    auto producerPlan = numDestinations == 1
+        ? PlanBuilder().values(batches_).partitionedOutput({}, 1).planNode()
+        : PlanBuilder()
+              .values(batches_)
+              .partitionedOutput({"c0"}, numDestinations)
+              .planNode();
+    auto producer = std::make_shared<Task>(
+        producerId,
+        core::PlanFragment{producerPlan},
+        0,
+        std::make_shared<core::QueryCtx>(executor_.get()));
+    Task::start(producer, 1);
+
+    std::atomic<int64_t> numRows{0};
+    std::vector<std::thread> consumers;
+    for (auto destination = 0; destination < numDestinations; ++destination) {
+      consumers.emplace_back([&, destination]() {
+        core::PlanNodeId exchangeId;
+        CursorParameters params;
+        params.planNode = PlanBuilder()
+                              .exchange(rowType_)
+                              .capturePlanNodeId(exchangeId)
+                              .planNode();
+        params.destination = destination;
+        TaskCursor cursor(params);
+        cursor.task()->addSplit(
+            exchangeId,
+            Split(std::make_shared<RemoteConnectorSplit>(producerId)));
+        cursor.task()->noMoreSplits(exchangeId);
+        while (cursor.moveNext()) {
+          numRows += cursor.current()->size();
+        }
+      });
+    }
+    for (auto& consumer : consumers) {
+      consumer.join();
+    }
+    return numRows;
+  }
+
+ private:
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  facebook::velox::test::VectorMaker vectorMaker_{pool_.get()};
+  std::shared_ptr<folly::Executor> executor_{
+      std::make_shared<folly::CPUThreadPoolExecutor>(
+          std::thread::hardware_concurrency())};
+  RowTypePtr rowType_;
+  std::vector<RowVectorPtr> batches_;
+  int32_t numTasks_{0};
+};
+
+std::unique_ptr<ExchangeBenchmark> benchmark;
+
+void runExchange(int32_t numDestinations) {
+  const auto numRows = benchmark->run(numDestinations);
+  VELOX_CHECK_EQ(
+      static_cast<int64_t>(FLAGS_num_batches) * FLAGS_batch_size, numRows);
+}
+
+BENCHMARK(exchange1) {
+  runExchange(1);
+}
+
+BENCHMARK(exchange4) {
+  runExchange(4);
+}
+
+BENCHMARK(exchange16) {
+  runExchange(16);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  if (FLAGS_columnar_serde) {
+    serializer::columnar::ColumnarVectorSerde::registerVectorSerde();
+  } else {
+    serializer::presto::PrestoVectorSerde::registerVectorSerde();
+  }
+  exec::ExchangeSource::registerFactory();
+  benchmark = std::make_unique<ExchangeBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/HashTable.h"
+#include "velox/exec/VectorHasher.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+DEFINE_int32(build_size, 8 << 20, "Number of distinct build side keys");
+DEFINE_int32(probe_batch_size, 10'000, "Number of probe keys per batch");
+DEFINE_int32(num_probe_batches, 200, "Number of probe batches");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+// Measures the probe throughput of a join hash table much larger than the
+// last level cache, with and without radix-partitioning of the probe rows.
+// The keys are random 64-bit integers so that the table is in kHash mode.
+namespace {
+class HashJoinBenchmark {
+ public:
+  HashJoinBenchmark() {
+    makeBuildKeys();
+    makeTable();
+    makeProbeBatches();
+  }
+
+  // Probes all probe batches with 'probePartitionBits' and returns the number
+  // of hits.
+  int64_t run(uint8_t probePartitionBits) {
+    auto& hashers = table_->hashers();
+    HashLookup lookup(hashers);
+    lookup.probePartitionBits = probePartitionBits;
+    int64_t numHits = 0;
+    for (const auto& batch : probeBatches_) {
+      const SelectivityVector rows(batch->size());
+      lookup.reset(batch->size());
+      hashers[0]->decode(*batch, rows);
+      hashers[0]->hash(rows, false, lookup.hashes);
+      std::iota(lookup.rows.begin(), lookup.rows.end(), 0);
+      table_->joinProbe(lookup);
+      for (auto row : lookup.rows) {
+        numHits += lookup.hits[row] != nullptr;
+      }
+    }
+    return numHits;
+  }
+
+ private:
+  void makeBuildKeys() {
+    folly::Random::DefaultGenerator rng;
+    rng.seed(1);
+    buildKeys_.resize(FLAGS_build_size);
+    for (auto& key : buildKeys_) {
+      key = folly::Random::rand64(rng);
+    }
+  }
+
+  void makeTable() {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    hashers.push_back(std::make_unique<VectorHasher>(BIGINT(), 0));
+    table_ = HashTable<true>::createForJoin(
+        std::move(hashers),
+        {},
+        true,
+        false,
+        memory::MappedMemory::getInstance());
+
+    constexpr int32_t kBatchSize = 10'000;
+    auto rowContainer = table_->rows();
+    auto hasher = table_->hashers()[0].get();
+    const auto nextOffset = rowContainer->nextOffset();
+    raw_vector<uint64_t> valueIds(kBatchSize);
+    for (auto start = 0; start < buildKeys_.size(); start += kBatchSize) {
+      const auto size =
+          std::min<int32_t>(kBatchSize, buildKeys_.size() - start);
+      auto keys = vectorMaker_.flatVector<int64_t>(
+          size, [&](auto row) { return buildKeys_[start + row]; });
+      const SelectivityVector rows(size);
+      // Lets the hasher see the keys so that the table picks the hash mode.
+      hasher->decode(*keys, rows);
+      hasher->computeValueIds(rows, valueIds);
+      DecodedVector decoded(*keys, rows);
+      for (auto row = 0; row < size; ++row) {
+        char* newRow = rowContainer->newRow();
+        if (nextOffset) {
+          *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+        }
+        rowContainer->store(decoded, row, newRow, 0);
+      }
+    }
+    table_->prepareJoinTable({});
+    VELOX_CHECK_EQ(table_->hashMode(), BaseHashTable::HashMode::kHash);
+  }
+
+  // Makes probe batches where half the keys hit the table.
+  void makeProbeBatches() {
+    folly::Random::DefaultGenerator rng;
+    rng.seed(2);
+    for (auto i = 0; i < FLAGS_num_probe_batches; ++i) {
+      probeBatches_.push_back(vectorMaker_.flatVector<int64_t>(
+          FLAGS_probe_batch_size, [&](auto row) {
+            return row % 2 == 0
+                ? buildKeys_[folly::Random::rand32(rng) % buildKeys_.size()]
+                : static_cast<int64_t>(folly::Random::rand64(rng));
+          }));
+    }
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::vector<int64_t> buildKeys_;
+  std::unique_ptr<HashTable<true>> table_;
+  std::vector<VectorPtr> probeBatches_;
+};
+
+std::unique_ptr<HashJoinBenchmark> benchmark;
+
+void runProbe(uint8_t probePartitionBits) {
+  folly::doNotOptimizeAway(benchmark->run(probePartitionBits));
+}
+
+BENCHMARK(probeHash) {
+  runProbe(0);
+}
+
+BENCHMARK_RELATIVE(probeRadix2Bits) {
+  runProbe(2);
+}
+
+BENCHMARK_RELATIVE(probeRadix4Bits) {
+  runProbe(4);
+}
+
+BENCHMARK_RELATIVE(probeRadix6Bits) {
+  runProbe(6);
+}
+
+BENCHMARK_RELATIVE(probeRadix8Bits) {
+  runProbe(8);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<HashJoinBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -580,6 +580,223 @@ TEST_F(AggregationTest, rangeToDistinct) {
       " GROUP BY c0, c1, c2, c3, c4, c5");
 }
 
+TEST_F(AggregationTest, columnarAccumulators) {
+  // Low cardinality keys make an array mode hash table, where sum, min, max
+  // and count of raw input update columnar accumulators. The last batches
+  // have keys outside of the array range, so that the columnar updates are
+  // flushed to the group rows before the table is rehashed.
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 12; ++i) {
+    const int64_t keyRange = i < 9 ? 7 : 1'000'000;
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000,
+            [&](auto row) { return (row * 17 + i) % keyRange; },
+            nullEvery(31)),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return row * i - 500; }, nullEvery(7)),
+        makeFlatVector<double>(
+            1'000, [&](auto row) { return row * 0.1 + i; }, nullEvery(11)),
+        makeConstant<int32_t>(i, 1'000),
+    }));
+  }
+  createDuckDbTable(batches);
+
+  const std::vector<std::string> aggregates = {
+      "sum(c1)",
+      "min(c1)",
+      "max(c1)",
+      "count(c1)",
+      "sum(c2)",
+      "min(c2)",
+      "max(c2)",
+      "sum(c3)",
+      "max(c3)",
+      "count(1)"};
+  const std::string sql =
+      "SELECT c0, sum(c1), min(c1), max(c1), count(c1), sum(c2), min(c2), "
+      "max(c2), sum(c3), max(c3), count(1) FROM tmp GROUP BY c0";
+
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .singleAggregation({"c0"}, aggregates)
+                  .planNode();
+  assertQuery(plan, sql);
+
+  plan = PlanBuilder()
+             .values(std::vector<RowVectorPtr>(
+                 batches.begin(), batches.begin() + 9))
+             .partialAggregation({"c0"}, aggregates)
+             .finalAggregation()
+             .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0, sum(c1), min(c1), max(c1), count(c1), sum(c2), min(c2), "
+      "max(c2), sum(c3), max(c3), count(1) FROM tmp "
+      "WHERE c3 < 9 GROUP BY c0");
+}
+
+TEST_F(AggregationTest, distinctAggregates) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row % 17; }),
+        makeFlatVector<int32_t>(
+            1'000, [&](auto row) { return (row + i) % 53; }, nullEvery(7)),
+        makeFlatVector<StringView>(
+            1'000,
+            [&](auto row) {
+              return StringView(
+                  fmt::format("string value {}", (row * i) % 101));
+            },
+            nullEvery(11)),
+    }));
+  }
+  createDuckDbTable(batches);
+
+  const std::vector<std::string> aggregates = {
+      "count(DISTINCT c1)",
+      "sum(distinct c1)",
+      "count(c1)",
+      "count(DISTINCT c2)",
+      "max(DISTINCT c2)"};
+  const std::string sqlAggregates =
+      "count(DISTINCT c1), sum(DISTINCT c1), count(c1), count(DISTINCT c2), "
+      "max(DISTINCT c2)";
+
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .singleAggregation({"c0"}, aggregates)
+                  .planNode();
+  assertQuery(
+      plan, fmt::format("SELECT c0, {} FROM tmp GROUP BY c0", sqlAggregates));
+
+  plan = PlanBuilder()
+             .values(batches)
+             .singleAggregation({}, aggregates)
+             .planNode();
+  assertQuery(plan, fmt::format("SELECT {} FROM tmp", sqlAggregates));
+
+  // Sorted input goes to streaming aggregation.
+  plan = PlanBuilder()
+             .values(batches)
+             .orderBy({"c0"}, false)
+             .streamingAggregation(
+                 {"c0"},
+                 aggregates,
+                 {},
+                 core::AggregationNode::Step::kSingle,
+                 false)
+             .planNode();
+  assertQuery(
+      plan, fmt::format("SELECT c0, {} FROM tmp GROUP BY c0", sqlAggregates));
+
+  // The spilled distinct values are merged as arrays.
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  plan = PlanBuilder()
+             .values(batches)
+             .singleAggregation({"c0"}, aggregates)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .spillDirectory(tempDirectory->path)
+      .config(QueryConfig::kSpillEnabled, "true")
+      .config(QueryConfig::kAggregationSpillEnabled, "true")
+      .config(QueryConfig::kAggregationSpillMemoryThreshold, "1")
+      .assertResults(
+          fmt::format("SELECT c0, {} FROM tmp GROUP BY c0", sqlAggregates));
+
+  VELOX_ASSERT_THROW(
+      PlanBuilder()
+          .values(batches)
+          .partialAggregation({"c0"}, {"count(DISTINCT c1)"})
+          .planNode(),
+      "Distinct aggregates are only supported in single aggregation");
+}
+
+TEST_F(AggregationTest, sortedAggregates) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row % 17; }),
+        makeFlatVector<int32_t>(
+            1'000, [&](auto row) { return row * 7 + i; }, nullEvery(7)),
+        makeFlatVector<int64_t>(
+            1'000,
+            [&](auto row) { return (row * 5 + i) * 7'919 % 1'000'003; }),
+        makeFlatVector<int16_t>(
+            1'000, [&](auto row) { return row % 3; }, nullEvery(5)),
+    }));
+  }
+
+  // 'c2' is unique, so that the order of the rows in each group is defined.
+  // Sorting all the input before aggregating gives the expected results.
+  auto expectedResults = [&](const std::vector<std::string>& groupingKeys,
+                             const std::vector<std::string>& sortingKeys) {
+    auto keys = groupingKeys;
+    keys.insert(keys.end(), sortingKeys.begin(), sortingKeys.end());
+    return AssertQueryBuilder(PlanBuilder()
+                                  .values(batches)
+                                  .orderBy(keys, false)
+                                  .singleAggregation(
+                                      groupingKeys,
+                                      {"array_agg(c1)", "array_agg(c3)"})
+                                  .planNode())
+        .copyResults(pool());
+  };
+
+  std::vector<std::string> aggregates = {
+      "array_agg(c1 ORDER BY c2 DESC)", "array_agg(c3 order by c2 desc)"};
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .singleAggregation({"c0"}, aggregates)
+                  .planNode();
+  auto expected = expectedResults({"c0"}, {"c2 DESC"});
+  AssertQueryBuilder(plan).assertResults(expected);
+
+  // Sorted input goes to streaming aggregation.
+  plan = PlanBuilder()
+             .values(batches)
+             .orderBy({"c0"}, false)
+             .streamingAggregation(
+                 {"c0"},
+                 aggregates,
+                 {},
+                 core::AggregationNode::Step::kSingle,
+                 false)
+             .planNode();
+  AssertQueryBuilder(plan).assertResults(expected);
+
+  // The spilled rows are merged as arrays.
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  plan = PlanBuilder()
+             .values(batches)
+             .singleAggregation({"c0"}, aggregates)
+             .planNode();
+  AssertQueryBuilder(plan)
+      .spillDirectory(tempDirectory->path)
+      .config(QueryConfig::kSpillEnabled, "true")
+      .config(QueryConfig::kAggregationSpillEnabled, "true")
+      .config(QueryConfig::kAggregationSpillMemoryThreshold, "1")
+      .assertResults(expected);
+
+  plan = PlanBuilder()
+             .values(batches)
+             .singleAggregation(
+                 {},
+                 {"array_agg(c1 ORDER BY c3 NULLS FIRST, c2)",
+                  "array_agg(c3 ORDER BY c3 NULLS FIRST, c2)"})
+             .planNode();
+  AssertQueryBuilder(plan).assertResults(
+      expectedResults({}, {"c3 NULLS FIRST", "c2"}));
+
+  VELOX_ASSERT_THROW(
+      PlanBuilder()
+          .values(batches)
+          .partialAggregation({"c0"}, {"array_agg(c1 ORDER BY c2)"})
+          .planNode(),
+      "Sorted aggregates are only supported in single aggregation");
+}
+
 TEST_F(AggregationTest, allKeyTypes) {
   // Covers different key types. Unlike the integer/string tests, the
   // hash table begins life in the generic mode, not array or
@@ -685,6 +902,86 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
           .customStats.count("flushRowCount"));
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 10; }),
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row; }, nullEvery(7)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // Unique keys abandon the partial aggregation after the first 1'000 rows.
+  // Keys with good reduction keep aggregating.
+  for (const auto& [key, abandoned] :
+       std::vector<std::pair<std::string, bool>>{{"c0", true}, {"c1", false}}) {
+    SCOPED_TRACE(key);
+    core::PlanNodeId aggNodeId;
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .config(QueryConfig::kAbandonPartialAggregationMinRows, "1000")
+            .config(QueryConfig::kAbandonPartialAggregationMinPct, "80")
+            .plan(PlanBuilder()
+                      .values(vectors)
+                      .partialAggregation(
+                          {key}, {"sum(c2)", "count(c2)", "avg(c2)", "max(c2)"})
+                      .capturePlanNodeId(aggNodeId)
+                      .finalAggregation()
+                      .planNode())
+            .assertResults(fmt::format(
+                "SELECT {0}, sum(c2), count(c2), avg(c2), max(c2) FROM tmp "
+                "GROUP BY 1",
+                key));
+    EXPECT_EQ(
+        abandoned,
+        toPlanStats(task->taskStats())
+                .at(aggNodeId)
+                .customStats.count("abandonedPartialAggregation") == 1);
+  }
+}
+
+TEST_F(AggregationTest, parallelMerge) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (i * 1'000 + row) % 1'300; }),
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row; }, nullEvery(7)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // Each of the 4 drivers reads all of 'vectors' and there is no local
+  // exchange, so the same keys are in the hash tables of all drivers.
+  const std::string expectedSql =
+      "SELECT c0, sum(c1) * 4, count(1) * 4, max(c1) FROM tmp GROUP BY 1";
+  AssertQueryBuilder(
+      PlanBuilder()
+          .values(vectors, true)
+          .singleAggregation({"c0"}, {"sum(c1)", "count(1)", "max(c1)"})
+          .planNode(),
+      duckDbQueryRunner_)
+      .config(QueryConfig::kAggregationParallelMergeEnabled, "true")
+      .maxDrivers(4)
+      .assertResults(expectedSql);
+
+  AssertQueryBuilder(
+      PlanBuilder()
+          .values(vectors, true)
+          .partialAggregation({"c0"}, {"sum(c1)", "count(1)", "max(c1)"})
+          .finalAggregation()
+          .planNode(),
+      duckDbQueryRunner_)
+      .config(QueryConfig::kAggregationParallelMergeEnabled, "true")
+      .maxDrivers(4)
+      .assertResults(expectedSql);
+}
+
 TEST_F(AggregationTest, partialAggregationMemoryLimitIncrease) {
   constexpr int64_t kGB = 1 << 30;
   constexpr int64_t kB = 1 << 10;
@@ -1303,6 +1600,66 @@ TEST_F(AggregationTest, groupingSetsOutput) {
   assertEqualResults(orderResult.second, reversedOrderResult.second);
 }
 
+/// An aggregation over a GroupIdNode runs as one operator which aggregates each
+/// grouping set in a hash table of its own. Partial aggregation flushes all
+/// grouping sets.
+TEST_F(AggregationTest, groupingSetsFusedWithGroupId) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector(
+      {"k1", "k2", "k3", "a"},
+      {
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 11; }),
+          makeFlatVector<int64_t>(
+              size, [](auto row) { return row % 17; }, nullEvery(13)),
+          makeFlatVector<int32_t>(size, [](auto row) { return row % 3; }),
+          makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      });
+  createDuckDbTable({data, data});
+
+  core::PlanNodeId groupIdNodeId;
+  core::PlanNodeId aggNodeId;
+  auto plan = PlanBuilder()
+                  .values({data, data})
+                  .groupId(
+                      {{"k1", "k2", "k3"},
+                       {"k1", "k2"},
+                       {"k1", "k3"},
+                       {"k2", "k3"},
+                       {"k1"},
+                       {"k2"},
+                       {"k3"},
+                       {}},
+                      {"a"})
+                  .capturePlanNodeId(groupIdNodeId)
+                  .partialAggregation(
+                      {"k1", "k2", "k3", "group_id"},
+                      {"count(1) as count_1", "sum(a) as sum_a"})
+                  .capturePlanNodeId(aggNodeId)
+                  .finalAggregation()
+                  .project({"k1", "k2", "k3", "count_1", "sum_a"})
+                  .planNode();
+
+  const std::string duckDbSql =
+      "SELECT k1, k2, k3, count(1), sum(a) FROM tmp "
+      "GROUP BY CUBE (k1, k2, k3)";
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(QueryConfig::kMaxPartialAggregationMemory, "1000")
+                  .assertResults(duckDbSql);
+  auto planStats = toPlanStats(task->taskStats());
+  EXPECT_EQ(0, planStats.count(groupIdNodeId));
+  EXPECT_EQ(2'000, planStats.at(aggNodeId).inputRows);
+  EXPECT_GT(planStats.at(aggNodeId).customStats.at("flushRowCount").count, 1);
+
+  // A GroupId operator repeats the input for each grouping set if the
+  // aggregation may spill.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .config(QueryConfig::kSpillEnabled, "true")
+             .assertResults(duckDbSql);
+  planStats = toPlanStats(task->taskStats());
+  EXPECT_EQ(1, planStats.count(groupIdNodeId));
+  EXPECT_EQ(16'000, planStats.at(aggNodeId).inputRows);
+}
+
 TEST_F(AggregationTest, outputBatchSizeCheckWithSpill) {
   rowType_ = ROW({"c0", "c1", "c2"}, {INTEGER(), INTEGER(), INTEGER()});
   VectorFuzzer::Options options;
@@ -1406,5 +1763,96 @@ TEST_F(AggregationTest, preGroupedAggregationWithSpilling) {
   ASSERT_EQ(toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
 }
 
+TEST_F(AggregationTest, preGroupedKeysChangeBetweenBatches) {
+  // Each batch has a different value of the pre-grouped key.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 4; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(10, [&](auto /*row*/) { return i; }),
+         makeFlatVector<int64_t>(10, [](auto row) { return row % 3; }),
+         makeFlatVector<int64_t>(10, [](auto row) { return row; })}));
+  }
+  createDuckDbTable(vectors);
+  core::PlanNodeId aggrNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .aggregation(
+                        {"c0", "c1"},
+                        {"c0"},
+                        {"sum(c2)"},
+                        {},
+                        core::AggregationNode::Step::kSingle,
+                        false)
+                    .capturePlanNodeId(aggrNodeId)
+                    .planNode())
+          .assertResults("SELECT c0, c1, sum(c2) FROM tmp GROUP BY c0, c1");
+  // The groups of each value of the pre-grouped key are produced before the
+  // next batch is added.
+  EXPECT_EQ(toPlanStats(task->taskStats()).at(aggrNodeId).outputVectors, 4);
+}
+
 } // namespace
+TEST_F(AggregationTest, masks) {
+  // Masks with nulls, masks that are true for all or no rows and masks shared
+  // by several aggregates, as in pivot queries.
+  auto data = makeRowVector(
+      {"k", "v", "m0", "m1", "m2"},
+      {
+          makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; }),
+          makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+          makeFlatVector<bool>(
+              1'000, [](auto row) { return row % 3 == 0; }, nullEvery(5)),
+          makeFlatVector<bool>(1'000, [](auto /*row*/) { return true; }),
+          makeFlatVector<bool>(1'000, [](auto /*row*/) { return false; }),
+      });
+  createDuckDbTable({data});
+
+  std::vector<std::string> aggregates;
+  std::vector<std::string> masks;
+  std::vector<std::string> duckDbAggregates;
+  for (const auto& mask : {"m0", "m1", "m2", "m0", "m1"}) {
+    aggregates.push_back("sum(v)");
+    masks.push_back(mask);
+    duckDbAggregates.push_back(fmt::format("sum(v) FILTER (WHERE {})", mask));
+  }
+  aggregates.push_back("count(1)");
+  masks.push_back("");
+  duckDbAggregates.push_back("count(1)");
+
+  // The masks are flat without a filter. The filter wraps them in
+  // dictionaries.
+  for (const auto& filter : {"true", "k <> 3"}) {
+    SCOPED_TRACE(filter);
+    const auto duckDbSql = fmt::format(
+        "SELECT k, {} FROM tmp WHERE {} GROUP BY k",
+        folly::join(", ", duckDbAggregates),
+        filter);
+    auto plan = PlanBuilder()
+                    .values({data})
+                    .filter(filter)
+                    .singleAggregation({"k"}, aggregates, masks)
+                    .planNode();
+    assertQuery(plan, duckDbSql);
+
+    plan = PlanBuilder()
+               .values({data})
+               .filter(filter)
+               .partialAggregation({"k"}, aggregates, masks)
+               .finalAggregation()
+               .planNode();
+    assertQuery(plan, duckDbSql);
+  }
+
+  // A constant mask.
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .project({"k", "v", "true AS m1", "false AS m2"})
+                  .singleAggregation(
+                      {"k"}, {"sum(v)", "sum(v)", "count(1)"}, {"m1", "m2", ""})
+                  .planNode();
+  assertQuery(plan, "SELECT k, sum(v), null, count(1) FROM tmp GROUP BY k");
+}
+
 } // namespace facebook::velox::exec::test
@@ -103,6 +103,25 @@ TEST_F(AssignUniqueIdTest, exceedRequestLimit) {
   verifyUniqueId(plan, input);
 }
 
+TEST_F(AssignUniqueIdTest, batchesAcrossRequests) {
+  // The second batch starts in the first reservation of row ids and ends in
+  // the second one.
+  vector_size_t batchSize = 600'000;
+  std::vector<RowVectorPtr> input;
+  for (int i = 0; i < 2; ++i) {
+    input.push_back(makeRowVector(
+        {makeFlatVector<int32_t>(batchSize, [](auto row) { return row; })}));
+  }
+
+  auto plan = PlanBuilder()
+                  .values(input)
+                  .assignUniqueId()
+                  .capturePlanNodeId(uniqueNodeId_)
+                  .planNode();
+
+  verifyUniqueId(plan, input);
+}
+
 TEST_F(AssignUniqueIdTest, multiThread) {
   for (int i = 0; i < 3; i++) {
     vector_size_t batchSize = 1000;
@@ -13,8 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -258,3 +261,137 @@ TEST_F(CrossJoinTest, parallelism) {
 
   OperatorTestBase::assertQuery(params, "VALUES (30), (30), (30), (30), (30)");
 }
+
+TEST_F(CrossJoinTest, filter) {
+  auto leftVectors = {
+      makeRowVector({sequence<int32_t>(10)}),
+      makeRowVector({sequence<int32_t>(100, 10)}),
+      makeRowVector({sequence<int32_t>(1'000, 10 + 100)}),
+  };
+
+  auto rightVectors = {
+      makeRowVector({"u_c0"}, {sequence<int32_t>(10)}),
+      makeRowVector({"u_c0"}, {sequence<int32_t>(100, 10)}),
+      makeRowVector({"u_c0"}, {sequence<int32_t>(1'000, 10 + 100)}),
+  };
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  // Range join.
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .values({leftVectors})
+                .crossJoin(
+                    PlanBuilder(planNodeIdGenerator)
+                        .values({rightVectors})
+                        .planNode(),
+                    "c0 < u_c0 AND u_c0 < c0 + 3",
+                    {"c0", "u_c0"})
+                .planNode();
+
+  assertQuery(
+      op, "SELECT * FROM t, u WHERE t.c0 < u.u_c0 AND u.u_c0 < t.c0 + 3");
+
+  // Filter on a column not in the output.
+  planNodeIdGenerator->reset();
+  op = PlanBuilder(planNodeIdGenerator)
+           .values({leftVectors})
+           .crossJoin(
+               PlanBuilder(planNodeIdGenerator)
+                   .values({rightVectors})
+                   .planNode(),
+               "c0 + u_c0 = 100",
+               {"c0"})
+           .planNode();
+
+  assertQuery(op, "SELECT t.c0 FROM t, u WHERE t.c0 + u.u_c0 = 100");
+
+  // No rows pass the filter.
+  planNodeIdGenerator->reset();
+  op = PlanBuilder(planNodeIdGenerator)
+           .values({leftVectors})
+           .crossJoin(
+               PlanBuilder(planNodeIdGenerator)
+                   .values({rightVectors})
+                   .planNode(),
+               "c0 < 0",
+               {"c0", "u_c0"})
+           .planNode();
+
+  assertQueryReturnsEmptyResult(op);
+}
+
+TEST_F(CrossJoinTest, spill) {
+  std::vector<RowVectorPtr> leftVectors;
+  std::vector<RowVectorPtr> rightVectors;
+  for (auto i = 0; i < 5; ++i) {
+    leftVectors.push_back(makeRowVector({sequence<int32_t>(100, i * 100)}));
+    rightVectors.push_back(
+        makeRowVector({"u_c0"}, {sequence<int32_t>(50, i * 50)}));
+  }
+
+  // Each of the 2 build Drivers gets all of 'rightVectors'.
+  createDuckDbTable("t", leftVectors);
+  auto duplicateRightVectors = rightVectors;
+  duplicateRightVectors.insert(
+      duplicateRightVectors.end(), rightVectors.begin(), rightVectors.end());
+  createDuckDbTable("u", duplicateRightVectors);
+
+  struct {
+    // Spill memory threshold of the build side. Zero means no spilling.
+    std::string spillMemoryThreshold;
+    std::string filter;
+    std::string duckDbSql;
+
+    std::string debugString() const {
+      return fmt::format(
+          "spillMemoryThreshold: {}, filter: {}",
+          spillMemoryThreshold,
+          filter);
+    }
+  } testSettings[] = {
+      {"1", "", "SELECT * FROM t, u"},
+      {"1",
+       "u_c0 >= c0 AND u_c0 < c0 + 10",
+       "SELECT * FROM t, u WHERE u.u_c0 >= t.c0 AND u.u_c0 < t.c0 + 10"},
+      {"0",
+       "u_c0 >= c0 AND u_c0 < c0 + 10",
+       "SELECT * FROM t, u WHERE u.u_c0 >= t.c0 AND u.u_c0 < t.c0 + 10"}};
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+
+    auto spillDirectory = exec::test::TempDirectoryPath::create();
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId joinNodeId;
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .values(leftVectors)
+                  .crossJoin(
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(rightVectors, true)
+                          .planNode(),
+                      testData.filter,
+                      {"c0", "u_c0"})
+                  .capturePlanNodeId(joinNodeId)
+                  .planNode();
+
+    auto task = AssertQueryBuilder(op, duckDbQueryRunner_)
+                    .maxDrivers(2)
+                    .spillDirectory(spillDirectory->path)
+                    .config(core::QueryConfig::kSpillEnabled, "true")
+                    .config(core::QueryConfig::kJoinSpillEnabled, "true")
+                    .config(
+                        core::QueryConfig::kJoinSpillMemoryThreshold,
+                        testData.spillMemoryThreshold)
+                    .assertResults(testData.duckDbSql);
+
+    auto stats = toPlanStats(task->taskStats()).at(joinNodeId);
+    if (testData.spillMemoryThreshold == "0") {
+      ASSERT_EQ(0, stats.spilledBytes);
+    } else {
+      ASSERT_GT(stats.spilledBytes, 0);
+      ASSERT_EQ(2 * 5 * 50, stats.spilledRows);
+    }
+  }
+}
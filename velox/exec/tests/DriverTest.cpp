@@ -18,6 +18,7 @@
 #include <velox/exec/Driver.h>
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
@@ -431,11 +432,56 @@ TEST_F(DriverTest, slow) {
   // Check that the blocking of the CallbackSink at the end of the pipeline is
   // recorded.
   EXPECT_GT(stats[0].operatorStats.back().blockedWallNanos, 0);
+  EXPECT_LT(
+      0,
+      stats[0]
+          .operatorStats.back()
+          .runtimeStats.at("waitForConsumerWallNanos")
+          .count);
   EXPECT_TRUE(stateFutures_.at(0).isReady());
   // The future was realized by timeout.
   EXPECT_TRUE(stateFutures_.at(0).hasException());
 }
 
+TEST_F(DriverTest, traceEvents) {
+  CursorParameters params;
+  params.planNode = makeValuesFilterProject(
+      rowType_, "m1 % 10 > 0", "m1 % 3 + m2 % 5", 100, 1'000);
+  params.maxDrivers = 4;
+  params.queryCtx = std::make_shared<core::QueryCtx>(
+      driverExecutor_.get(),
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {core::QueryConfig::kDriverTraceEvents, "true"}}));
+  std::shared_ptr<Task> task;
+  {
+    TaskCursor cursor(params);
+    while (cursor.moveNext()) {
+    }
+    task = cursor.task();
+    ASSERT_TRUE(waitForTaskCompletion(task.get()));
+  }
+
+  const auto stats = task->taskStats();
+  ASSERT_FALSE(stats.traceEvents.empty());
+  std::unordered_set<int32_t> driverIds;
+  int32_t numRun = 0;
+  int32_t numQueued = 0;
+  for (const auto& event : stats.traceEvents) {
+    EXPECT_LE(event.startMicros, event.endMicros);
+    driverIds.insert(event.driverId);
+    numRun += event.kind == DriverTraceEvent::Kind::kRun;
+    numQueued += event.kind == DriverTraceEvent::Kind::kQueued;
+  }
+  EXPECT_EQ(4, driverIds.size());
+  EXPECT_LT(0, numRun);
+  EXPECT_EQ(numRun, numQueued);
+
+  const auto trace = toChromeTrace(stats);
+  ASSERT_EQ(stats.traceEvents.size(), trace["traceEvents"].size());
+  EXPECT_EQ("X", trace["traceEvents"][0]["ph"].asString());
+}
+
 TEST_F(DriverTest, pause) {
   CursorParameters params;
   int32_t hits;
@@ -473,6 +519,41 @@ TEST_F(DriverTest, pause) {
   EXPECT_EQ(operators[1].outputPositions, 10 * hits);
 }
 
+TEST_F(DriverTest, sampledCpuUsage) {
+  CursorParameters params;
+  int32_t hits;
+  params.planNode = makeValuesFilterProject(
+      rowType_,
+      "m1 % 10 > 0",
+      "m1 % 3 + m2 % 5",
+      1'000,
+      1'000,
+      [](int64_t num) { return num % 10 > 0; },
+      &hits);
+  params.maxDrivers = 1;
+  params.queryCtx = std::make_shared<core::QueryCtx>(
+      executor_.get(),
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {core::QueryConfig::kOperatorTrackCpuUsage, "true"},
+              {core::QueryConfig::kOperatorCpuUsageSampleRate, "16"}}));
+  int32_t numRead = 0;
+  readResults(params, ResultOperation::kRead, 1'000'000, &numRead);
+  EXPECT_EQ(numRead, hits);
+  auto stateFuture = tasks_[0]->stateChangeFuture(100'000'000);
+  auto& executor = folly::QueuedImmediateExecutor::instance();
+  std::move(stateFuture).via(&executor).wait();
+  EXPECT_TRUE(tasks_[0]->isFinished());
+
+  // All calls are counted, one in 16 is timed.
+  const auto taskStats = tasks_[0]->taskStats();
+  const auto& operators = taskStats.pipelineStats[0].operatorStats;
+  EXPECT_EQ(operators[1].addInputTiming.count, operators[1].inputVectors);
+  EXPECT_EQ(operators[1].inputVectors, 1'000);
+  EXPECT_GE(operators[1].getOutputTiming.count, 1'000);
+  EXPECT_GT(operators[1].addInputTiming.wallNanos, 0);
+}
+
 TEST_F(DriverTest, yield) {
   constexpr int32_t kNumTasks = 20;
   constexpr int32_t kThreadsPerTask = 5;
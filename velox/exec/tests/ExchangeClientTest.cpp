@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/Exchange.h"
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+// Source that records the credits of its requests and responds when told to.
+class TestExchangeSource : public ExchangeSource {
+ public:
+  TestExchangeSource(
+      const std::string& taskId,
+      int destination,
+      std::shared_ptr<ExchangeQueue> queue,
+      memory::MemoryPool* pool)
+      : ExchangeSource(taskId, destination, std::move(queue), pool) {}
+
+  bool shouldRequestLocked() override {
+    return !atEnd_ && !requestPending_.exchange(true);
+  }
+
+  void request() override {
+    credits.push_back(maxBytes());
+  }
+
+  void close() override {}
+
+  // Responds to the pending request with a page of 'bytes'.
+  void respond(int64_t bytes) {
+    auto iobuf = folly::IOBuf::create(bytes);
+    iobuf->append(bytes);
+    std::lock_guard<std::mutex> l(queue_->mutex());
+    VELOX_CHECK(requestPending_);
+    requestPending_ = false;
+    queue_->enqueue(std::make_unique<SerializedPage>(std::move(iobuf), pool_));
+  }
+
+  std::vector<int64_t> credits;
+};
+
+std::unordered_map<std::string, std::shared_ptr<TestExchangeSource>>&
+testSources() {
+  static std::unordered_map<std::string, std::shared_ptr<TestExchangeSource>>
+      sources;
+  return sources;
+}
+
+const bool kRegistered = ExchangeSource::registerFactory(
+    [](const std::string& taskId,
+       int destination,
+       std::shared_ptr<ExchangeQueue> queue,
+       memory::MemoryPool* pool) -> std::shared_ptr<ExchangeSource> {
+      if (taskId.find("test://") != 0) {
+        return nullptr;
+      }
+      auto source = std::make_shared<TestExchangeSource>(
+          taskId, destination, std::move(queue), pool);
+      testSources()[taskId] = source;
+      return source;
+    });
+} // namespace
+
+class ExchangeClientTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    testSources().clear();
+  }
+
+  TestExchangeSource& source(int32_t i) {
+    return *testSources().at(fmt::format("test://{}", i));
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+};
+
+TEST_F(ExchangeClientTest, credits) {
+  constexpr int64_t kMB = 1 << 20;
+  ExchangeClient client(0, 8 * kMB);
+  client.initialize(pool_.get());
+  for (auto i = 0; i < 4; ++i) {
+    client.addRemoteTaskId(fmt::format("test://{}", i));
+  }
+  client.noMoreRemoteTasks();
+
+  // The first source gets all the room of the queue, the others the minimum.
+  EXPECT_EQ(std::vector<int64_t>{16 * kMB}, source(0).credits);
+  for (auto i = 1; i < 4; ++i) {
+    EXPECT_EQ(
+        std::vector<int64_t>{ExchangeClient::kMinCredit}, source(i).credits);
+  }
+
+  for (auto i = 0; i < 4; ++i) {
+    source(i).respond(kMB);
+  }
+  bool atEnd;
+  ContinueFuture future;
+  auto page = client.next(&atEnd, &future);
+  ASSERT_NE(nullptr, page);
+  EXPECT_FALSE(atEnd);
+
+  // The room above the 3 MB left in the queue is split evenly.
+  for (auto i = 0; i < 4; ++i) {
+    EXPECT_EQ(13 * kMB / 4, source(i).credits.back());
+  }
+
+  // A page that fills the queue past its minimum does not trigger requests.
+  source(0).respond(8 * kMB);
+  page = client.next(&atEnd, &future);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(2, source(1).credits.size());
+  client.close();
+}
+
+TEST_F(ExchangeClientTest, poolCap) {
+  constexpr int64_t kMB = 1 << 20;
+  auto pool = pool_->addChild("exchange", 6 * kMB);
+  ExchangeClient client(0, 8 * kMB);
+  client.initialize(pool.get());
+  client.addRemoteTaskId("test://0");
+  client.addRemoteTaskId("test://1");
+  client.noMoreRemoteTasks();
+  EXPECT_EQ(std::vector<int64_t>{6 * kMB}, source(0).credits);
+  EXPECT_EQ(
+      std::vector<int64_t>{ExchangeClient::kMinCredit}, source(1).credits);
+
+  source(0).respond(2 * kMB);
+  source(1).respond(kMB);
+  bool atEnd;
+  ContinueFuture future;
+  auto page = client.next(&atEnd, &future);
+  ASSERT_NE(nullptr, page);
+
+  // 1 MB is queued and 2 MB held by 'page', which leaves 3 MB of the cap.
+  EXPECT_EQ(3 * kMB / 2, source(0).credits.back());
+  EXPECT_EQ(3 * kMB / 2, source(1).credits.back());
+  page.reset();
+  client.close();
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/FairShareExecutor.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+namespace {
+// Counts the functions added to an executor, e.g. Drivers enqueued after
+// yielding.
+class CountingExecutor : public folly::Executor {
+ public:
+  explicit CountingExecutor(int32_t numThreads) : executor_(numThreads) {}
+
+  void add(folly::Func func) override {
+    ++numAdded_;
+    executor_.add(std::move(func));
+  }
+
+  int64_t numAdded() const {
+    return numAdded_;
+  }
+
+ private:
+  folly::CPUThreadPoolExecutor executor_;
+  std::atomic<int64_t> numAdded_{0};
+};
+
+void spinFor(std::chrono::microseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+} // namespace
+
+class FairShareExecutorTest : public OperatorTestBase {
+ protected:
+  // Runs a query that produces its result at the end with 'timeSliceMs' and
+  // returns the number of times Drivers were added to the executor.
+  int64_t countEnqueues(uint32_t timeSliceMs) {
+    auto data = makeRowVector({makeFlatVector<int64_t>(
+        10'000, [](auto row) { return row % 17; })});
+    std::vector<RowVectorPtr> batches(200, data);
+    CountingExecutor executor(2);
+    CursorParameters params;
+    params.planNode = PlanBuilder()
+                          .values(batches, true)
+                          .project({"c0 * 2 + 1 AS c1"})
+                          .partialAggregation({}, {"sum(c1)"})
+                          .planNode();
+    params.maxDrivers = 2;
+    params.queryCtx = std::make_shared<core::QueryCtx>(&executor);
+    params.queryCtx->setConfigOverridesUnsafe(
+        {{core::QueryConfig::kDriverTimeSliceMs,
+          std::to_string(timeSliceMs)}});
+    {
+      TaskCursor cursor(params);
+      while (cursor.moveNext()) {
+      }
+      EXPECT_TRUE(waitForTaskCompletion(cursor.task().get()));
+    }
+    return executor.numAdded();
+  }
+};
+
+TEST_F(FairShareExecutorTest, timeSlice) {
+  // Without a time slice each Driver runs to completion.
+  const auto numUnsliced = countEnqueues(0);
+  // Running for 1ms at a time, the Drivers yield and are enqueued again.
+  const auto numSliced = countEnqueues(1);
+  EXPECT_LT(numUnsliced, numSliced);
+}
+
+TEST_F(FairShareExecutorTest, weights) {
+  FairShareExecutor executor(1);
+  auto gate = executor.addGroup("gate");
+  auto heavy = executor.addGroup("heavy", 3);
+  auto light = executor.addGroup("light", 1);
+
+  // Holds the only thread until both groups have their work queued.
+  std::atomic<bool> release{false};
+  gate->add([&]() {
+    while (!release) {
+      std::this_thread::yield();
+    }
+  });
+
+  constexpr int32_t kNumFuncs = 200;
+  std::atomic<int32_t> numHeavy{0};
+  std::atomic<int32_t> numLight{0};
+  std::atomic<int32_t> numLightAtHeavyEnd{-1};
+  for (auto i = 0; i < kNumFuncs; ++i) {
+    heavy->add([&]() {
+      spinFor(std::chrono::microseconds(100));
+      if (++numHeavy == kNumFuncs) {
+        numLightAtHeavyEnd = numLight.load();
+      }
+    });
+    light->add([&]() {
+      spinFor(std::chrono::microseconds(100));
+      ++numLight;
+    });
+  }
+  release = true;
+  while (numHeavy + numLight < 2 * kNumFuncs) {
+    std::this_thread::yield();
+  }
+
+  // The light group got about a third of the time of the heavy group while
+  // both had work.
+  EXPECT_LT(kNumFuncs / 6, numLightAtHeavyEnd);
+  EXPECT_GT(kNumFuncs / 2, numLightAtHeavyEnd);
+}
@@ -15,6 +15,7 @@
  */
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -209,6 +210,37 @@ TEST_F(FilterProjectTest, projectOverLazy) {
   assertQuery(plan, "SELECT c0 > 0 AND c1 > 0, c1 + 5.2 FROM tmp");
 }
 
+TEST_F(FilterProjectTest, recycleReleasedResults) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto plan = PlanBuilder()
+                  .values({data, data, data, data})
+                  .project({"c0 + 1"})
+                  .planFragment();
+  auto task = std::make_shared<exec::Task>(
+      "single.execution.task.0", plan, 0, std::make_shared<core::QueryCtx>());
+
+  // The first result is still referenced when the second one is produced.
+  auto first = task->next();
+  auto* firstValues = first->childAt(0)->values().get();
+  auto second = task->next();
+  ASSERT_NE(firstValues, second->childAt(0)->values().get());
+
+  // The released result goes back to the vector pool of the operator and is
+  // reused for the next batch.
+  first.reset();
+  auto third = task->next();
+  ASSERT_EQ(firstValues, third->childAt(0)->values().get());
+  ASSERT_EQ(2, third->childAt(0)->asFlatVector<int64_t>()->valueAt(1));
+  third.reset();
+  second.reset();
+
+  while (task->next() != nullptr) {
+  }
+  ASSERT_TRUE(waitForTaskCompletion(task.get()));
+}
+
 TEST_F(FilterProjectTest, filterProject) {
   std::vector<RowVectorPtr> vectors;
   for (int32_t i = 0; i < 10; ++i) {
@@ -333,3 +365,184 @@ TEST_F(FilterProjectTest, projectAndIdentityOverLazy) {
                   .planNode();
   assertQuery(plan, "SELECT c0 < 10 AND c1 < 10, c1 FROM tmp");
 }
+
+TEST_F(FilterProjectTest, loadLazyAfterConjuncts) {
+  // The columns that a filter and the projections read are loaded only for the
+  // rows that reach the conjunct that reads them.
+  const vector_size_t size = 1'000;
+  auto valueAt = [](auto row) -> int32_t { return row; };
+  auto vectors = makeRowVector({
+      makeFlatVector<int32_t>(size, valueAt),
+      makeFlatVector<int32_t>(size, valueAt),
+  });
+  createDuckDbTable({vectors});
+
+  auto numLoadedRows = std::make_shared<int64_t>(0);
+  auto makeInput = [&]() {
+    *numLoadedRows = 0;
+    return makeRowVector({
+        makeFlatVector<int32_t>(size, valueAt),
+        std::make_shared<LazyVector>(
+            pool(),
+            INTEGER(),
+            size,
+            std::make_unique<facebook::velox::test::SimpleVectorLoader>(
+                [=](RowSet rows) {
+                  *numLoadedRows += rows.size();
+                  return makeFlatVector<int32_t>(rows.back() + 1, valueAt);
+                })),
+    });
+  };
+
+  auto plan = PlanBuilder()
+                  .values({makeInput()})
+                  .filter("c0 % 10 = 0 AND c1 % 4 = 0")
+                  .project({"c1", "c1 + 1"})
+                  .planNode();
+  assertQuery(
+      plan, "SELECT c1, c1 + 1 FROM tmp WHERE c0 % 10 = 0 AND c1 % 4 = 0");
+  EXPECT_EQ(100, *numLoadedRows);
+
+  // The identity projections of a filter only read the rows that pass the
+  // first conjunct.
+  plan = PlanBuilder()
+             .values({makeInput()})
+             .filter("c0 % 10 = 0 AND c1 % 4 = 0")
+             .planNode();
+  assertQuery(plan, "SELECT * FROM tmp WHERE c0 % 10 = 0 AND c1 % 4 = 0");
+  EXPECT_EQ(100, *numLoadedRows);
+
+  // A column read inside a conditional is loaded for all the rows of the
+  // conjunct, since the projection needs it for all passing rows.
+  plan = PlanBuilder()
+             .values({makeInput()})
+             .filter("c0 % 10 = 0 AND (c0 % 20 = 0 OR c1 % 4 = 0)")
+             .project({"c1"})
+             .planNode();
+  assertQuery(
+      plan,
+      "SELECT c1 FROM tmp WHERE c0 % 10 = 0 AND (c0 % 20 = 0 OR c1 % 4 = 0)");
+  EXPECT_EQ(100, *numLoadedRows);
+}
+
+TEST_F(FilterProjectTest, coalesceBatches) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 100; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [&](auto row) { return i * 1'000 + row; })}));
+  }
+  createDuckDbTable(vectors);
+
+  auto coalesceStats = [&](const std::string& filter) {
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .filter(filter)
+                    .project({"c0", "c0 + 1 AS c1"})
+                    .planNode();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kCoalesceBatchesMinRows, "300")
+            .assertResults("SELECT c0, c0 + 1 FROM tmp WHERE " + filter);
+    auto planStats = toPlanStats(task->taskStats());
+    return std::move(
+        *planStats.at(plan->id()).operatorStats.at("CoalesceBatches"));
+  };
+
+  // The filter leaves 10 rows per vector. These are copied into 3 vectors of
+  // 300 rows and a last one of 100 rows.
+  auto stats = coalesceStats("c0 % 100 = 0");
+  EXPECT_EQ(1'000, stats.outputRows);
+  EXPECT_EQ(4, stats.outputVectors);
+
+  // Vectors of 500 rows are passed through.
+  stats = coalesceStats("c0 % 2 = 0");
+  EXPECT_EQ(50'000, stats.outputRows);
+  EXPECT_EQ(100, stats.outputVectors);
+}
+
+TEST_F(FilterProjectTest, compactInput) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(std::dynamic_pointer_cast<RowVector>(
+        BatchMaker::createBatch(rowType_, 1'000, *pool_)));
+  }
+  createDuckDbTable(vectors);
+
+  auto compactedRows = [&](const std::string& filter,
+                           const std::vector<std::string>& projections,
+                           const std::string& sql) {
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .filter(filter)
+                    .project(projections)
+                    .planNode();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(
+                core::QueryConfig::kFilterProjectMaxCompactSelectivity, "0.5")
+            .assertResults(sql);
+    auto& stats = toPlanStats(task->taskStats()).at(plan->id()).customStats;
+    auto it = stats.find("compactedInputRows");
+    return it == stats.end() ? 0 : it->second.sum;
+  };
+
+  // Few rows pass. The projections are evaluated on the copied rows.
+  EXPECT_LT(
+      0,
+      compactedRows(
+          "c1 % 10 = 0",
+          {"c0", "c0 + c1", "c3 * 2.0"},
+          "SELECT c0, c0 + c1, c3 * 2.0 FROM tmp WHERE c1 % 10 = 0"));
+  EXPECT_LT(
+      0,
+      compactedRows(
+          "c1 % 10 = 0 AND c0 > 0",
+          {"c0", "c1", "c2", "c3"},
+          "SELECT * FROM tmp WHERE c1 % 10 = 0 AND c0 > 0"));
+
+  // Most rows pass. The results are wrapped in dictionaries.
+  EXPECT_EQ(
+      0,
+      compactedRows(
+          "c1 % 10 > 0",
+          {"c0", "c0 + c1"},
+          "SELECT c0, c0 + c1 FROM tmp WHERE c1 % 10 > 0"));
+}
+
+TEST_F(FilterProjectTest, exprRuntimeStats) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(std::dynamic_pointer_cast<RowVector>(
+        BatchMaker::createBatch(rowType_, 1'000, *pool_)));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .filter("c1 % 10 > 0")
+                  .project({"c0 + c1"})
+                  .planNode();
+  const std::string sql = "SELECT c0 + c1 FROM tmp WHERE c1 % 10 > 0";
+
+  // The expression stats are reported by function name if expression cpu
+  // tracking is enabled.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(core::QueryConfig::kExprTrackCpuUsage, "true")
+                  .assertResults(sql);
+  auto planStats = toPlanStats(task->taskStats());
+  const auto& stats = planStats.at(plan->id()).customStats;
+  for (const auto& name : {"plus", "mod", "gt"}) {
+    SCOPED_TRACE(name);
+    const auto prefix = fmt::format("expr.{}.", name);
+    EXPECT_LT(0, stats.at(prefix + "processedRows").sum);
+    EXPECT_GE(10'000, stats.at(prefix + "processedRows").sum);
+    EXPECT_LT(0, stats.at(prefix + "cpuNanos").sum);
+    EXPECT_LT(0, stats.at(prefix + "outputBytes").sum);
+  }
+
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_).assertResults(sql);
+  planStats = toPlanStats(task->taskStats());
+  EXPECT_EQ(
+      0,
+      planStats.at(plan->id()).customStats.count("expr.plus.processedRows"));
+}
@@ -3154,6 +3154,86 @@ TEST_F(HashJoinTest, memory) {
   EXPECT_GT(7'500'000, tracker->getCumulativeBytes());
 }
 
+TEST_F(HashJoinTest, sharedBuild) {
+  auto probe = makeRowVector(
+      {"t0", "t1"},
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row % 300; }),
+       makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  auto build = makeRowVector(
+      {"u0", "u1"},
+      {makeFlatVector<int64_t>(100, [](auto row) { return row * 3; }),
+       makeFlatVector<int64_t>(100, [](auto row) { return -row; })});
+  // Enough probe batches for the first Task to wait for its consumer.
+  std::vector<RowVectorPtr> probeVectors(200, probe);
+
+  auto makePlan = [&](bool shareBuild, core::PlanNodeId& joinNodeId) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values(probeVectors)
+        .hashJoin(
+            {"t0"},
+            {"u0"},
+            PlanBuilder(planNodeIdGenerator).values({build}).planNode(),
+            "",
+            {"t0", "t1", "u1"},
+            core::JoinType::kInner,
+            shareBuild)
+        .capturePlanNodeId(joinNodeId)
+        .planNode();
+  };
+  core::PlanNodeId joinNodeId;
+  auto expected =
+      AssertQueryBuilder(makePlan(false, joinNodeId)).copyResults(pool());
+  auto plan = makePlan(true, joinNodeId);
+  ASSERT_NE(
+      plan->toString(true, false).find("shared build"), std::string::npos);
+
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      driverExecutor_.get(),
+      std::make_shared<core::MemConfig>(),
+      std::unordered_map<std::string, std::shared_ptr<Config>>{},
+      memory::MappedMemory::getInstance(),
+      nullptr,
+      nullptr,
+      "sharedBuild");
+  CursorParameters params;
+  params.planNode = plan;
+  params.queryCtx = queryCtx;
+  TaskCursor first(params);
+  ASSERT_TRUE(first.moveNext());
+  int64_t numRows = first.current()->size();
+
+  // The second Task of the query probes the table of the first.
+  auto second =
+      AssertQueryBuilder(plan).queryCtx(queryCtx).assertResults(expected);
+  auto secondStats = toPlanStats(second->taskStats());
+  EXPECT_EQ(
+      1,
+      secondStats.at(joinNodeId).customStats.at("sharedHashTableReused").sum);
+
+  while (first.moveNext()) {
+    numRows += first.current()->size();
+  }
+  EXPECT_EQ(expected->size(), numRows);
+  auto firstStats = toPlanStats(first.task()->taskStats());
+  EXPECT_EQ(
+      0, firstStats.at(joinNodeId).customStats.count("sharedHashTableReused"));
+
+  // Right joins set the probed flags of the table.
+  VELOX_ASSERT_THROW(
+      PlanBuilder()
+          .values({probe})
+          .hashJoin(
+              {"t0"},
+              {"u0"},
+              PlanBuilder().values({build}).planNode(),
+              "",
+              {"t0", "u1"},
+              core::JoinType::kRight,
+              true),
+      "Shared hash join build is not supported for RIGHT join");
+}
+
 TEST_F(HashJoinTest, lazyVectors) {
   // a dataset of multiple row groups with multiple columns. We create
   // different dictionary wrappings for different columns and load the
@@ -3806,6 +3886,100 @@ TEST_F(HashJoinTest, dynamicFilters) {
   }
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 5;
+  const int32_t numRowsProbe = 1'000;
+  // More distinct keys than VectorHasher::kMaxDistinct with a large range to
+  // make the join table use kHash mode.
+  const int32_t numRowsBuild = 120'000;
+
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<std::shared_ptr<TempFilePath>> tempFiles;
+  std::vector<exec::Split> probeSplits;
+  for (int32_t i = 0; i < numSplits; ++i) {
+    // Every 10th probe key has a match on the build side.
+    auto rowVector = makeRowVector({
+        makeFlatVector<int64_t>(
+            numRowsProbe,
+            [&](auto row) {
+              auto key = i * numRowsProbe + row;
+              return key % 10 == 0 ? key * 1'000'003 : key * 1'000'003 + 1;
+            }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    probeVectors.push_back(rowVector);
+    tempFiles.push_back(TempFilePath::create());
+    writeToFile(tempFiles.back()->path, rowVector);
+    probeSplits.push_back(
+        exec::Split(makeHiveConnectorSplit(tempFiles.back()->path)));
+  }
+
+  std::vector<RowVectorPtr> buildVectors;
+  for (int i = 0; i < 4; ++i) {
+    buildVectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            numRowsBuild / 4,
+            [i](auto row) {
+              return (row + i * numRowsBuild / 4) * 1'000'003L;
+            }),
+        makeFlatVector<int64_t>(numRowsBuild / 4, [](auto row) { return row; }),
+    }));
+  }
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto probeType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator)
+                       .values(buildVectors)
+                       .project({"c0 AS u_c0", "c1 AS u_c1"})
+                       .planNode();
+
+  for (bool bloomFilterEnabled : {false, true}) {
+    SCOPED_TRACE(fmt::format("bloomFilterEnabled: {}", bloomFilterEnabled));
+    core::PlanNodeId probeScanId;
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(probeType)
+                  .capturePlanNodeId(probeScanId)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      buildSide,
+                      "",
+                      {"c0", "c1", "u_c1"},
+                      core::JoinType::kInner)
+                  .planNode();
+
+    SplitInput splits;
+    splits.emplace(probeScanId, probeSplits);
+
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .planNode(std::move(op))
+        .inputSplits(splits)
+        .config(
+            core::QueryConfig::kHashJoinBloomFilterEnabled,
+            bloomFilterEnabled ? "true" : "false")
+        .referenceQuery(
+            "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0")
+        .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+          SCOPED_TRACE(fmt::format("hasSpill:{}", hasSpill));
+          if (hasSpill || !bloomFilterEnabled) {
+            ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(0, getFiltersAccepted(task, 0).sum);
+            ASSERT_EQ(getInputPositions(task, 1), numRowsProbe * numSplits);
+          } else {
+            ASSERT_EQ(1, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(1, getFiltersAccepted(task, 0).sum);
+            // The Bloom filter is approximate and cannot replace the join.
+            ASSERT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+            ASSERT_LT(getInputPositions(task, 1), numRowsProbe * numSplits);
+          }
+        })
+        .run();
+  }
+}
+
 // Verify the size of the join output vectors when projecting build-side
 // variable-width column.
 TEST_F(HashJoinTest, memoryUsage) {
@@ -3909,6 +4083,162 @@ TEST_F(HashJoinTest, smallOutputBatchSize) {
       .run();
 }
 
+TEST_F(HashJoinTest, chainedJoinsComposeDictionaries) {
+  auto probe = makeRowVector(
+      {"t0", "t1", "t2"},
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row % 300; }),
+       makeFlatVector<int64_t>(1'000, [](auto row) { return row % 70; }),
+       makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  auto build1 = makeRowVector(
+      {"u0", "u1"},
+      {makeFlatVector<int64_t>(100, [](auto row) { return row * 2; }),
+       makeFlatVector<int64_t>(100, [](auto row) { return -row; })});
+  auto build2 = makeRowVector(
+      {"v0", "v1"},
+      {makeFlatVector<int64_t>(20, [](auto row) { return row * 3; }),
+       makeFlatVector<int64_t>(20, [](auto row) { return row + 1; })});
+
+  createDuckDbTable("t", {probe});
+  createDuckDbTable("u", {build1});
+  createDuckDbTable("v", {build2});
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values({probe})
+          .hashJoin(
+              {"t0"},
+              {"u0"},
+              PlanBuilder(planNodeIdGenerator).values({build1}).planNode(),
+              "",
+              {"t1", "t2", "u1"})
+          .hashJoin(
+              {"t1"},
+              {"v0"},
+              PlanBuilder(planNodeIdGenerator).values({build2}).planNode(),
+              "",
+              {"t2", "u1", "v1"})
+          .planNode();
+
+  // The probe columns of the second join wrap the probe input of the first
+  // join with a single dictionary.
+  CursorParameters params;
+  params.planNode = plan;
+  auto [cursor, results] = readCursor(params, [](Task*) {});
+  ASSERT_FALSE(results.empty());
+  for (const auto& result : results) {
+    auto t2 = result->childAt(0);
+    ASSERT_EQ(t2->encoding(), VectorEncoding::Simple::DICTIONARY);
+    ASSERT_EQ(t2->valueVector()->encoding(), VectorEncoding::Simple::FLAT);
+  }
+
+  assertQuery(plan, "SELECT t2, u1, v1 FROM t, u, v WHERE t0 = u0 AND t1 = v0");
+}
+
+TEST_F(HashJoinTest, outputBatchBytes) {
+  // Build side rows have 1KB strings which are not inlined in the row
+  // container. The no-duplicates and the duplicates listing of join results
+  // both honor the output batch bytes.
+  for (const int32_t numBuildKeys : {1'000, 100}) {
+    SCOPED_TRACE(fmt::format("numBuildKeys: {}", numBuildKeys));
+    auto probeVectors = makeRowVector({makeFlatVector<int32_t>(
+        1'000, [](auto row) { return row % 1'000; })});
+    auto buildVectors = makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [&](auto row) { return row % numBuildKeys; }),
+        makeFlatVector<StringView>(
+            1'000,
+            [](auto row) {
+              return StringView(std::string(1'000, 'a' + row % 26));
+            }),
+    });
+    createDuckDbTable("t", {probeVectors});
+    createDuckDbTable("u", {buildVectors});
+
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId joinNodeId;
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values({probeVectors})
+                    .project({"c0 AS t_c0"})
+                    .hashJoin(
+                        {"t_c0"},
+                        {"c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values({buildVectors})
+                            .planNode(),
+                        "",
+                        {"t_c0", "c1"})
+                    .capturePlanNodeId(joinNodeId)
+                    .planNode();
+
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .planNode(std::move(plan))
+        .config(
+            core::QueryConfig::kPreferredOutputBatchBytes,
+            std::to_string(100'000))
+        .referenceQuery("SELECT t.c0, u.c1 FROM t, u WHERE t.c0 = u.c0")
+        .injectSpill(false)
+        .verifier([&](const std::shared_ptr<Task>& task, bool /*unused*/) {
+          // Each batch has about 100 rows of 1KB instead of all the rows.
+          EXPECT_LE(
+              1'000 * 10 / numBuildKeys,
+              toPlanStats(task->taskStats()).at(joinNodeId).outputVectors);
+        })
+        .run();
+  }
+}
+
+TEST_F(HashJoinTest, skewedBuildSpill) {
+  // 80% of the build rows have the same key which can't be split by spilling.
+  std::vector<RowVectorPtr> buildVectors;
+  for (auto i = 0; i < 5; ++i) {
+    buildVectors.push_back(makeRowVector(
+        {"u_k0", "u_v0"},
+        {makeFlatVector<int64_t>(
+             1'000,
+             [&](auto row) { return row % 5 == 0 ? i * 1'000 + row : 0; }),
+         makeFlatVector<int64_t>(1'000, [](auto row) { return row; })}));
+  }
+  std::vector<RowVectorPtr> probeVectors;
+  for (auto i = 0; i < 5; ++i) {
+    probeVectors.push_back(makeRowVector(
+        {"t_k0", "t_v0"},
+        {makeFlatVector<int64_t>(
+             1'000,
+             [&](auto row) { return row == 0 ? 0 : i * 1'000 + row; }),
+         makeFlatVector<int64_t>(1'000, [](auto row) { return row; })}));
+  }
+
+  HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+      .numDrivers(numDrivers_)
+      .probeKeys({"t_k0"})
+      .probeVectors(std::move(probeVectors))
+      .buildKeys({"u_k0"})
+      .buildVectors(std::move(buildVectors))
+      .referenceQuery(
+          "SELECT t_k0, t_v0, u_k0, u_v0 FROM t, u WHERE t.t_k0 = u.u_k0")
+      .maxSpillLevel(0)
+      .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+        if (!hasSpill) {
+          return;
+        }
+        // The skewed partition has been kept in memory while spilling the
+        // others.
+        int64_t numSkewed = 0;
+        for (auto& pipelineStat : task->taskStats().pipelineStats) {
+          for (auto& operatorStat : pipelineStat.operatorStats) {
+            if (operatorStat.operatorType == "HashBuild" &&
+                operatorStat.runtimeStats.count("skewedSpillPartitions") > 0) {
+              numSkewed +=
+                  operatorStat.runtimeStats["skewedSpillPartitions"].sum;
+            }
+          }
+        }
+        ASSERT_GT(numSkewed, 0);
+      })
+      .run();
+}
+
 TEST_F(HashJoinTest, spillFileSize) {
   const std::vector<uint64_t> maxSpillFileSizes({0, 1, 1'000'000'000});
   for (const auto spillFileSize : maxSpillFileSizes) {
@@ -352,6 +352,7 @@ class HashTableTest : public testing::TestWithParam<bool> {
 
   void testProbe() {
     auto lookup = std::make_unique<HashLookup>(topTable_->hashers());
+    lookup->probePartitionBits = probePartitionBits_;
     auto batchSize = batches_[0]->size();
     SelectivityVector rows(batchSize);
     auto mode = topTable_->hashMode();
@@ -455,6 +456,8 @@ class HashTableTest : public testing::TestWithParam<bool> {
   // Spacing between consecutive generated keys. Affects whether
   // Vectorhashers make ranges or ids of distinct values.
   int64_t keySpacing_ = 1;
+  // Number of bits for radix-partitioning the join probe rows.
+  uint8_t probePartitionBits_ = 0;
   std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
 };
 
@@ -507,6 +510,22 @@ TEST_P(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 100000, 9, type, 6);
 }
 
+TEST_P(HashTableTest, int2SparseNormalizedPartitionedProbe) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  probePartitionBits_ = 4;
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 100000, 2, type, 2);
+}
+
+TEST_P(HashTableTest, mixed6SparsePartitionedProbe) {
+  auto type =
+      ROW({"k1", "k2", "k3", "k4", "k5", "k6"},
+          {BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), VARCHAR()});
+  keySpacing_ = 1000;
+  probePartitionBits_ = 4;
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 9, type, 6);
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_P(HashTableTest, clear) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
@@ -733,3 +752,22 @@ TEST(HashTableTest, modeString) {
       "Unknown HashTable mode:100",
       BaseHashTable::modeString(static_cast<BaseHashTable::HashMode>(100)));
 }
+
+TEST(HashTableTest, packedRowPointers) {
+  constexpr int32_t kNumSlots = 16;
+  std::vector<char> rows(kNumSlots);
+  std::vector<char> table(kNumSlots * BaseHashTable::kRowPointerBytes, 0);
+  auto slots = reinterpret_cast<char**>(table.data());
+  for (auto i = 0; i < kNumSlots; i += 2) {
+    BaseHashTable::storeRow(slots, i, &rows[i]);
+  }
+  // Storing a slot does not overwrite its neighbors.
+  for (auto i = 0; i < kNumSlots; ++i) {
+    ASSERT_EQ(
+        i % 2 == 0 ? &rows[i] : nullptr, BaseHashTable::loadRow(slots, i));
+  }
+  BaseHashTable::storeRow(slots, 3, nullptr);
+  ASSERT_EQ(&rows[2], BaseHashTable::loadRow(slots, 2));
+  ASSERT_EQ(nullptr, BaseHashTable::loadRow(slots, 3));
+  ASSERT_EQ(&rows[4], BaseHashTable::loadRow(slots, 4));
+}
@@ -512,8 +512,10 @@ void makeAlternativePlans(
                           joinNode->joinType())
                       .planNode());
 
-  // Use OrderBy + MergeJoin (if join type is inner or left).
-  if (joinNode->isInnerJoin() || joinNode->isLeftJoin()) {
+  // Use OrderBy + MergeJoin (if join type is supported by merge join).
+  if (joinNode->isInnerJoin() || joinNode->isLeftJoin() ||
+      joinNode->isRightJoin() || joinNode->isFullJoin() ||
+      joinNode->isLeftSemiFilterJoin() || joinNode->isAntiJoin()) {
     planNodeIdGenerator->reset();
     plans.push_back(PlanBuilder(planNodeIdGenerator)
                         .values(probeInput)
@@ -509,3 +509,57 @@ TEST_F(LocalPartitionTest, unionAllLocalExchange) {
       "   SELECT * FROM (VALUES ('y')) as t2(c0)"
       ")");
 }
+
+TEST_F(LocalPartitionTest, memoryManagerConcurrency) {
+  constexpr int32_t kNumProducers = 8;
+  constexpr int32_t kNumConsumers = 2;
+  constexpr int32_t kNumIterations = 10'000;
+  constexpr int64_t kMaxBytes = 500;
+  exec::LocalExchangeMemoryManager memoryManager(kMaxBytes);
+
+  // Producers add 100 bytes per vector and wait while over the limit.
+  // Consumers remove 100 bytes per produced vector. A lost wakeup leaves a
+  // producer blocked after the consumers have freed all memory.
+  std::atomic<int32_t> numPending{0};
+  std::atomic<int32_t> numProducersDone{0};
+  std::atomic<int32_t> numBlocked{0};
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumProducers; ++i) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < kNumIterations; ++j) {
+        ContinueFuture future;
+        const bool blocked = memoryManager.increaseMemoryUsage(&future, 100);
+        ++numPending;
+        if (blocked) {
+          ++numBlocked;
+          future.wait(std::chrono::seconds(10));
+          EXPECT_TRUE(future.isReady());
+        }
+      }
+      ++numProducersDone;
+    });
+  }
+  for (auto i = 0; i < kNumConsumers; ++i) {
+    threads.emplace_back([&]() {
+      while (numProducersDone < kNumProducers || numPending > 0) {
+        auto pending = numPending.load();
+        if (pending == 0 ||
+            !numPending.compare_exchange_weak(pending, pending - 1)) {
+          std::this_thread::yield();
+          continue;
+        }
+        for (auto& promise : memoryManager.decreaseMemoryUsage(100)) {
+          promise.setValue();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_LT(0, numBlocked);
+
+  // All memory is freed.
+  ContinueFuture future;
+  EXPECT_FALSE(memoryManager.increaseMemoryUsage(&future, kMaxBytes - 1));
+}
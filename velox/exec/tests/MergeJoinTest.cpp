@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -180,6 +181,63 @@ class MergeJoinTest : public HiveConnectorTestBase {
     assertQuery(
         makeCursorParameters(plan, 10'000),
         "SELECT t.c0, t.c1, u.c1 FROM t LEFT JOIN u ON t.c0 = u.c0");
+
+    // Test RIGHT, FULL, LEFT SEMI and ANTI joins.
+    testJoinType(
+        left,
+        right,
+        core::JoinType::kRight,
+        {"c0", "c1", "u_c1"},
+        "SELECT t.c0, t.c1, u.c1 FROM t RIGHT JOIN u ON t.c0 = u.c0");
+
+    testJoinType(
+        left,
+        right,
+        core::JoinType::kFull,
+        {"c0", "c1", "u_c1"},
+        "SELECT t.c0, t.c1, u.c1 FROM t FULL OUTER JOIN u ON t.c0 = u.c0");
+
+    testJoinType(
+        left,
+        right,
+        core::JoinType::kLeftSemiFilter,
+        {"c0", "c1"},
+        "SELECT t.c0, t.c1 FROM t WHERE t.c0 IN (SELECT c0 FROM u)");
+
+    testJoinType(
+        left,
+        right,
+        core::JoinType::kAnti,
+        {"c0", "c1"},
+        "SELECT t.c0, t.c1 FROM t WHERE NOT EXISTS "
+        "(SELECT * FROM u WHERE u.c0 = t.c0)");
+  }
+
+  void testJoinType(
+      const std::vector<RowVectorPtr>& left,
+      const std::vector<RowVectorPtr>& right,
+      core::JoinType joinType,
+      const std::vector<std::string>& outputLayout,
+      const std::string& duckDbSql) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(left)
+                    .mergeJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(right)
+                            .project({"c1 as u_c1", "c0 as u_c0"})
+                            .planNode(),
+                        "",
+                        outputLayout,
+                        joinType)
+                    .planNode();
+
+    // Use very small, regular and very large output batch sizes.
+    for (auto outputBatchSize : {16, 1024, 10'000}) {
+      assertQuery(makeCursorParameters(plan, outputBatchSize), duckDbSql);
+    }
   }
 };
 
@@ -541,3 +599,82 @@ TEST_F(MergeJoinTest, nullKeys) {
   AssertQueryBuilder(plan, duckDbQueryRunner_)
       .assertResults("SELECT * FROM t LEFT JOIN u ON t.t0 = u.u0");
 }
+
+  // Right join.
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "",
+                 {"t0", "u0"},
+                 core::JoinType::kRight)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults("SELECT * FROM t RIGHT JOIN u ON t.t0 = u.u0");
+
+  // Full join.
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "",
+                 {"t0", "u0"},
+                 core::JoinType::kFull)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults("SELECT * FROM t FULL OUTER JOIN u ON t.t0 = u.u0");
+
+  // Left semi join.
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "",
+                 {"t0"},
+                 core::JoinType::kLeftSemiFilter)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults("SELECT t0 FROM t WHERE t0 IN (SELECT u0 FROM u)");
+
+  // Anti join.
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "",
+                 {"t0"},
+                 core::JoinType::kAnti)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults(
+          "SELECT t0 FROM t WHERE NOT EXISTS (SELECT * FROM u WHERE u0 = t0)");
+}
+
+TEST_F(MergeJoinTest, unsupportedFilter) {
+  auto left = makeRowVector({"t0"}, {makeFlatVector<int64_t>({1, 2, 5})});
+  auto right = makeRowVector({"u0"}, {makeFlatVector<int64_t>({1, 5})});
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values({left})
+          .mergeJoin(
+              {"t0"},
+              {"u0"},
+              PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+              "t0 > 1",
+              {"t0", "u0"},
+              core::JoinType::kFull)
+          .planNode();
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan).copyResults(pool()),
+      "Merge join supports filters only for inner and left joins");
+}
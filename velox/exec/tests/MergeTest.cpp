@@ -181,3 +181,52 @@ TEST_F(MergeTest, offByOne) {
       {{core::QueryConfig::kPreferredOutputBatchSize, "6"}});
   assertQueryOrdered(params, "VALUES (0), (1), (2), (3), (4), (5), (10)", {0});
 }
+
+/// Merges sources that alternate in runs of rows on keys without nulls. These
+/// are compared on normalized keys. The small output batches end in the middle
+/// of runs.
+TEST_F(MergeTest, runsWithNormalizedKeys) {
+  constexpr vector_size_t kBatchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 3; ++i) {
+    // Each source has every third run of 10 consecutive numbers.
+    auto c0 = makeFlatVector<int64_t>(kBatchSize, [&](auto row) {
+      return (row / 10 * 3 + i) * 10 + row % 10 - 10'000;
+    });
+    auto c1 = makeFlatVector<int32_t>(
+        kBatchSize, [&](auto row) { return (row * 7 + i) % 100; });
+    // The strings share prefixes longer than 8 bytes.
+    auto c2 = makeFlatVector<StringView>(kBatchSize, [&](auto row) {
+      return StringView(fmt::format(
+          "{}-common-prefix-{:05}", row % 3 == 0 ? "a" : "b", row * 3 + i));
+    });
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  for (uint32_t keyIndex = 0; keyIndex < 3; ++keyIndex) {
+    for (const auto& order : {"", " DESC"}) {
+      const auto orderBy = fmt::format("c{}{}", keyIndex, order);
+      SCOPED_TRACE(orderBy);
+      auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+      std::vector<std::shared_ptr<const core::PlanNode>> sources;
+      for (const auto& input : vectors) {
+        sources.push_back(PlanBuilder(planNodeIdGenerator)
+                              .values({input})
+                              .orderBy({orderBy}, true)
+                              .planNode());
+      }
+      CursorParameters params;
+      params.planNode = PlanBuilder(planNodeIdGenerator)
+                            .localMerge({orderBy}, std::move(sources))
+                            .planNode();
+      params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+      params.queryCtx->setConfigOverridesUnsafe(
+          {{core::QueryConfig::kPreferredOutputBatchSize, "37"}});
+      assertQueryOrdered(
+          params,
+          fmt::format("SELECT * FROM tmp ORDER BY {}", orderBy),
+          {keyIndex});
+    }
+  }
+}
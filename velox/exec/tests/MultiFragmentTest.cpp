@@ -19,6 +19,7 @@
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/Exchange.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -501,6 +502,73 @@ TEST_F(MultiFragmentTest, replicateNullsAndAny) {
   }
 }
 
+TEST_F(MultiFragmentTest, rebalanceSkew) {
+  // 90% of the rows have the key 0, so that one partition gets most of the
+  // data unless it is spread.
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 20; ++i) {
+    data.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             10'000,
+             [&](auto row) { return row % 10 == 0 ? i * 10'000 + row : 0; }),
+         makeFlatVector<double>(10'000, [](auto row) { return row * 0.1; })}));
+  }
+
+  std::vector<std::shared_ptr<Task>> tasks;
+  auto addTask = [&](std::shared_ptr<Task> task,
+                     const std::vector<std::string>& remoteTaskIds) {
+    tasks.emplace_back(task);
+    Task::start(task, 1);
+    if (!remoteTaskIds.empty()) {
+      addRemoteSplits(task, remoteTaskIds);
+    }
+  };
+
+  core::PlanNodeId partitionedOutputId;
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan = PlanBuilder()
+                      .values(data)
+                      .partitionedOutputRebalanced({"c0"}, 4)
+                      .capturePlanNodeId(partitionedOutputId)
+                      .planNode();
+  addTask(makeTask(leafTaskId, leafPlan, 0), {});
+
+  core::PlanNodeId exchangeId;
+  core::PlanNodePtr partialAggPlan;
+  std::vector<std::string> partialAggTaskIds;
+  for (int i = 0; i < 4; i++) {
+    partialAggPlan = PlanBuilder()
+                         .exchange(leafPlan->outputType())
+                         .capturePlanNodeId(exchangeId)
+                         .partialAggregation({}, {"count(1)"})
+                         .partitionedOutput({}, 1)
+                         .planNode();
+    partialAggTaskIds.push_back(makeTaskId("partial-agg", i));
+    addTask(
+        makeTask(partialAggTaskIds.back(), partialAggPlan, i), {leafTaskId});
+  }
+
+  auto op = PlanBuilder()
+                .exchange(partialAggPlan->outputType())
+                .finalAggregation({}, {"sum(a0)"}, {BIGINT()})
+                .planNode();
+  assertQuery(op, partialAggTaskIds, "SELECT 200000");
+
+  for (auto& task : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+  }
+
+  auto leafStats = toPlanStats(tasks[0]->taskStats()).at(partitionedOutputId);
+  EXPECT_EQ(1, leafStats.customStats.at("skewedPartitions").sum);
+  EXPECT_LT(0, leafStats.customStats.at("rebalancedRows").sum);
+
+  // Without rebalancing the destination of key 0 would get over 180'000 rows.
+  for (auto i = 1; i < tasks.size(); ++i) {
+    auto exchangeStats = toPlanStats(tasks[i]->taskStats()).at(exchangeId);
+    EXPECT_LT(exchangeStats.outputRows, 130'000) << tasks[i]->taskId();
+  }
+}
+
 // Test query finishing before all splits have been scheduled.
 TEST_F(MultiFragmentTest, limit) {
   auto data = makeRowVector({makeFlatVector<int32_t>(
@@ -935,3 +1003,23 @@ TEST_F(MultiFragmentTest, exchangeDestruction) {
   leafTask = nullptr;
   rootTask = nullptr;
 }
+
+TEST_F(MultiFragmentTest, localTaskByUri) {
+  setupSources(2, 1000);
+  // No exchange source factory handles http URIs in this test. The results
+  // of a task in this process are read from its output buffers.
+  const std::string leafTaskId = "20221014_000000_00000_local.1.0";
+  auto leafPlan = PlanBuilder()
+                      .values(vectors_)
+                      .partitionedOutput({}, 1, {"c0", "c1"})
+                      .planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  Task::start(leafTask, 1);
+
+  auto op = PlanBuilder().exchange(leafPlan->outputType()).planNode();
+  assertQuery(
+      op,
+      {fmt::format("http://127.0.0.1:8080/v1/task/{}/results", leafTaskId)},
+      "SELECT c0, c1 FROM tmp");
+  ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
+}
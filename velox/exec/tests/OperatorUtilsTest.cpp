@@ -277,3 +277,24 @@ TEST_F(OperatorUtilsTest, addOperatorRuntimeStats) {
   ASSERT_EQ(stats[statsName].max, 200);
   ASSERT_EQ(stats[statsName].min, 100);
 }
+
+TEST_F(OperatorUtilsTest, runtimeMetricPercentile) {
+  RuntimeMetric metric(RuntimeCounter::Unit::kNanos);
+  ASSERT_EQ(metric.percentile(50), 0);
+  for (auto i = 1; i <= 1'000; ++i) {
+    metric.addValue(i);
+  }
+  // The percentiles are the upper ends of the power of 2 buckets.
+  ASSERT_EQ(metric.percentile(1), 15);
+  ASSERT_EQ(metric.percentile(50), 511);
+  ASSERT_EQ(metric.percentile(99), 1'000);
+  ASSERT_EQ(metric.percentile(100), 1'000);
+
+  RuntimeMetric other(0, RuntimeCounter::Unit::kNanos);
+  other.addValue(0);
+  metric.merge(other);
+  ASSERT_EQ(metric.count, 1'002);
+  ASSERT_EQ(metric.min, 0);
+  ASSERT_EQ(metric.percentile(0.1), 0);
+  ASSERT_EQ(metric.percentile(50), 511);
+}
@@ -407,6 +407,46 @@ TEST_F(OrderByTest, outputBatchSize) {
   }
 }
 
+TEST_F(OrderByTest, parallelSort) {
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 5; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return (row * 7 + i) % 3'000; }),
+         makeFlatVector<StringView>(
+             1'000,
+             [&](auto row) {
+               return StringView(std::string(20, 'a' + (row + i) % 26));
+             },
+             nullEvery(11))}));
+  }
+  createDuckDbTable(batches);
+
+  core::PlanNodeId orderById;
+  auto plan = PlanBuilder()
+                  .values(batches, true)
+                  .orderBy({"c0 DESC NULLS FIRST", "c1"}, false)
+                  .capturePlanNodeId(orderById)
+                  .planNode();
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  queryCtx->setConfigOverridesUnsafe({
+      {core::QueryConfig::kOrderByParallelSortEnabled, "true"},
+  });
+  CursorParameters params;
+  params.planNode = plan;
+  params.queryCtx = queryCtx;
+  params.maxDrivers = 4;
+  // Each of the 4 drivers reads all the batches and sorts them. The last
+  // driver to finish merges the sorted rows of all the drivers.
+  auto task = assertQueryOrdered(
+      params,
+      "SELECT * FROM (SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+      "UNION ALL SELECT * FROM tmp UNION ALL SELECT * FROM tmp) "
+      "ORDER BY c0 DESC NULLS FIRST, c1 NULLS LAST",
+      {0, 1});
+  EXPECT_EQ(4, toPlanStats(task->taskStats()).at(orderById).numDrivers);
+}
+
 TEST_F(OrderByTest, spill) {
   const int kNumBatches = 3;
   const int kNumRows = 100'000;
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/tests/PerfFuzzer.h"
+
+#include <boost/random/uniform_int_distribution.hpp>
+#include <folly/FileUtil.h>
+#include <folly/json.h>
+#include <gflags/gflags.h>
+#include <map>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+DEFINE_int32(steps, 10, "Number of plans to generate and measure.");
+
+DEFINE_int32(
+    batch_size,
+    10'000,
+    "The number of elements on each generated vector.");
+
+DEFINE_int32(num_batches, 10, "The number of generated vectors.");
+
+DEFINE_int32(
+    repeats,
+    3,
+    "The number of times each plan is run. The lowest CPU time and peak "
+    "memory of the runs are kept.");
+
+DEFINE_string(
+    baseline,
+    "",
+    "Path of the JSON file with the baseline measurements. Written with "
+    "the results of this run if it does not exist. Compared against "
+    "otherwise.");
+
+DEFINE_bool(
+    update_baseline,
+    false,
+    "Overwrite --baseline with the results of this run.");
+
+DEFINE_double(
+    max_regression_pct,
+    20,
+    "A plan node regresses if its CPU time or peak memory exceeds the "
+    "baseline by more than this percentage.");
+
+DEFINE_int64(
+    min_cpu_nanos,
+    10'000'000,
+    "CPU time differences smaller than this are not regressions.");
+
+DEFINE_int64(
+    min_memory_bytes,
+    1 << 20,
+    "Peak memory differences smaller than this are not regressions.");
+
+namespace facebook::velox::exec::test {
+
+namespace {
+
+class PerfFuzzer {
+ public:
+  explicit PerfFuzzer(size_t seed);
+
+  int32_t go();
+
+ private:
+  // Lowest CPU time and peak memory of a plan node over --repeats runs.
+  struct Measurement {
+    std::string name;
+    uint64_t cpuNanos{0};
+    uint64_t peakMemoryBytes{0};
+  };
+
+  // Measurements keyed on <step>/<plan node id>.
+  using Measurements = std::map<std::string, Measurement>;
+
+  static VectorFuzzer::Options getFuzzerOptions() {
+    VectorFuzzer::Options opts;
+    opts.vectorSize = FLAGS_batch_size;
+    opts.stringVariableLength = true;
+    opts.stringLength = 20;
+    opts.nullRatio = 0.05;
+    return opts;
+  }
+
+  int32_t randInt(int32_t min, int32_t max) {
+    return boost::random::uniform_int_distribution<int32_t>(min, max)(rng_);
+  }
+
+  // Returns --num_batches of input with 1 to 3 key columns k0, k1... and a
+  // payload column p0.
+  std::vector<RowVectorPtr> generateInput(int32_t numKeys);
+
+  // Returns a random aggregation, hash join or order by over generated input.
+  core::PlanNodePtr makePlan();
+
+  // Runs 'plan' --repeats times and adds the stats of its plan nodes to
+  // 'measurements'.
+  void measure(
+      int32_t step,
+      const core::PlanNodePtr& plan,
+      Measurements& measurements);
+
+  // Returns the number of plan nodes in 'current' that regressed from
+  // 'baseline'.
+  int32_t compare(const Measurements& baseline, const Measurements& current);
+
+  static folly::dynamic toJson(const Measurements& measurements);
+
+  static Measurements fromJson(const folly::dynamic& json);
+
+  FuzzerGenerator rng_;
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  VectorFuzzer vectorFuzzer_;
+};
+
+PerfFuzzer::PerfFuzzer(size_t seed)
+    : vectorFuzzer_{getFuzzerOptions(), pool_.get()} {
+  rng_.seed(seed);
+  vectorFuzzer_.reSeed(seed);
+}
+
+std::vector<RowVectorPtr> PerfFuzzer::generateInput(int32_t numKeys) {
+  // A fixed list of types keeps the corpus stable when VectorFuzzer learns
+  // new types.
+  static const std::vector<TypePtr> kKeyTypes = {
+      BIGINT(), INTEGER(), SMALLINT(), VARCHAR(), DOUBLE()};
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 0; i < numKeys; ++i) {
+    names.push_back(fmt::format("k{}", i));
+    types.push_back(kKeyTypes[randInt(0, kKeyTypes.size() - 1)]);
+  }
+  names.push_back("p0");
+  types.push_back(BIGINT());
+
+  auto rowType = ROW(std::move(names), std::move(types));
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < FLAGS_num_batches; ++i) {
+    input.push_back(vectorFuzzer_.fuzzInputRow(rowType));
+  }
+  return input;
+}
+
+core::PlanNodePtr PerfFuzzer::makePlan() {
+  auto numKeys = randInt(1, 3);
+  auto input = generateInput(numKeys);
+  std::vector<std::string> keys;
+  for (auto i = 0; i < numKeys; ++i) {
+    keys.push_back(fmt::format("k{}", i));
+  }
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  switch (randInt(0, 2)) {
+    case 0:
+      return PlanBuilder(planNodeIdGenerator)
+          .values(input)
+          .singleAggregation(keys, {"count(1)", "sum(p0)"})
+          .planNode();
+    case 1: {
+      // Joins the input with itself.
+      std::vector<std::string> buildKeys;
+      std::vector<std::string> projections;
+      for (const auto& key : keys) {
+        buildKeys.push_back("b" + key);
+        projections.push_back(fmt::format("{} AS b{}", key, key));
+      }
+      projections.push_back("p0 AS bp0");
+      return PlanBuilder(planNodeIdGenerator)
+          .values(input)
+          .hashJoin(
+              keys,
+              buildKeys,
+              PlanBuilder(planNodeIdGenerator)
+                  .values(input)
+                  .project(projections)
+                  .planNode(),
+              "" /*filter*/,
+              {"p0", "bp0"})
+          .planNode();
+    }
+    default:
+      return PlanBuilder(planNodeIdGenerator)
+          .values(input)
+          .orderBy(keys, false)
+          .planNode();
+  }
+}
+
+void collectNodeNames(
+    const core::PlanNodePtr& node,
+    std::unordered_map<core::PlanNodeId, std::string>& names) {
+  names[node->id()] = node->name();
+  for (const auto& source : node->sources()) {
+    collectNodeNames(source, names);
+  }
+}
+
+void PerfFuzzer::measure(
+    int32_t step,
+    const core::PlanNodePtr& plan,
+    Measurements& measurements) {
+  std::unordered_map<core::PlanNodeId, std::string> names;
+  collectNodeNames(plan, names);
+
+  CursorParameters params;
+  params.planNode = plan;
+  for (auto repeat = 0; repeat < FLAGS_repeats; ++repeat) {
+    auto [cursor, results] = readCursor(params, [](Task* /*task*/) {});
+    auto task = cursor->task();
+    VELOX_CHECK(waitForTaskCompletion(task.get()));
+    for (const auto& [id, stats] : toPlanStats(task->taskStats())) {
+      auto key = fmt::format("{}/{}", step, id);
+      auto cpuNanos = stats.cpuWallTiming.cpuNanos;
+      auto it = measurements.find(key);
+      if (it == measurements.end()) {
+        measurements[key] = {names[id], cpuNanos, stats.peakMemoryBytes};
+      } else {
+        it->second.cpuNanos = std::min(it->second.cpuNanos, cpuNanos);
+        it->second.peakMemoryBytes =
+            std::min(it->second.peakMemoryBytes, stats.peakMemoryBytes);
+      }
+    }
+  }
+}
+
+bool regressed(uint64_t baseline, uint64_t current, int64_t minDifference) {
+  return current > baseline * (1 + FLAGS_max_regression_pct / 100) &&
+      current - baseline > minDifference;
+}
+
+int32_t PerfFuzzer::compare(
+    const Measurements& baseline,
+    const Measurements& current) {
+  int32_t numRegressions = 0;
+  for (const auto& [key, expected] : baseline) {
+    auto it = current.find(key);
+    if (it == current.end() || it->second.name != expected.name) {
+      LOG(WARNING) << "Plan node " << key << " (" << expected.name
+                   << ") is not in this run. Update the baseline if the "
+                   << "corpus changed.";
+      continue;
+    }
+    const auto& actual = it->second;
+    if (regressed(expected.cpuNanos, actual.cpuNanos, FLAGS_min_cpu_nanos)) {
+      LOG(ERROR) << "CPU time of " << key << " (" << expected.name
+                 << ") regressed from " << succinctNanos(expected.cpuNanos)
+                 << " to " << succinctNanos(actual.cpuNanos);
+      ++numRegressions;
+    }
+    if (regressed(
+            expected.peakMemoryBytes,
+            actual.peakMemoryBytes,
+            FLAGS_min_memory_bytes)) {
+      LOG(ERROR) << "Peak memory of " << key << " (" << expected.name
+                 << ") regressed from "
+                 << succinctBytes(expected.peakMemoryBytes) << " to "
+                 << succinctBytes(actual.peakMemoryBytes);
+      ++numRegressions;
+    }
+  }
+  return numRegressions;
+}
+
+folly::dynamic PerfFuzzer::toJson(const Measurements& measurements) {
+  folly::dynamic json = folly::dynamic::object;
+  for (const auto& [key, measurement] : measurements) {
+    json[key] = folly::dynamic::object("name", measurement.name)(
+        "cpuNanos", measurement.cpuNanos)(
+        "peakMemoryBytes", measurement.peakMemoryBytes);
+  }
+  return json;
+}
+
+PerfFuzzer::Measurements PerfFuzzer::fromJson(const folly::dynamic& json) {
+  Measurements measurements;
+  for (const auto& [key, value] : json.items()) {
+    measurements[key.asString()] = {
+        value["name"].asString(),
+        static_cast<uint64_t>(value["cpuNanos"].asInt()),
+        static_cast<uint64_t>(value["peakMemoryBytes"].asInt())};
+  }
+  return measurements;
+}
+
+int32_t PerfFuzzer::go() {
+  VELOX_CHECK_GT(FLAGS_steps, 0);
+  VELOX_CHECK_GT(FLAGS_repeats, 0);
+
+  Measurements current;
+  for (auto step = 0; step < FLAGS_steps; ++step) {
+    auto plan = makePlan();
+    LOG(INFO) << "Measuring plan " << step << ":" << std::endl
+              << plan->toString(true, true);
+    measure(step, plan, current);
+  }
+
+  for (const auto& [key, measurement] : current) {
+    LOG(INFO) << key << " (" << measurement.name
+              << "): CPU: " << succinctNanos(measurement.cpuNanos)
+              << ", peak memory: "
+              << succinctBytes(measurement.peakMemoryBytes);
+  }
+  if (FLAGS_baseline.empty()) {
+    return 0;
+  }
+
+  std::string baselineJson;
+  if (FLAGS_update_baseline ||
+      !folly::readFile(FLAGS_baseline.c_str(), baselineJson)) {
+    LOG(INFO) << "Writing baseline " << FLAGS_baseline;
+    VELOX_CHECK(
+        folly::writeFile(
+            folly::toPrettyJson(toJson(current)), FLAGS_baseline.c_str()),
+        "Cannot write baseline {}",
+        FLAGS_baseline);
+    return 0;
+  }
+
+  auto numRegressions =
+      compare(fromJson(folly::parseJson(baselineJson)), current);
+  LOG(INFO) << numRegressions << " regressions against " << FLAGS_baseline;
+  return numRegressions;
+}
+
+} // namespace
+
+int32_t perfFuzzer(size_t seed) {
+  return PerfFuzzer(seed).go();
+}
+} // namespace facebook::velox::exec::test
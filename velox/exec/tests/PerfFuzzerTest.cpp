@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/exec/tests/PerfFuzzer.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+
+DEFINE_int64(
+    seed,
+    1,
+    "Seed of the corpus of plans and input. Measurements are only comparable "
+    "with a baseline taken with the same seed and flags.");
+
+/// Measures a fixed corpus of aggregations, hash joins and order bys over
+/// VectorFuzzer input and compares the CPU time and peak memory of each plan
+/// node with a baseline from an earlier build. Exits with an error if any
+/// plan node regressed.
+///
+///  $ ./velox_perf_fuzzer_test --baseline=/tmp/perf_baseline.json
+///
+/// The first run writes the baseline. The next runs compare against it.
+/// --update_baseline overwrites it. See --max_regression_pct, --min_cpu_nanos
+/// and --min_memory_bytes for the thresholds.
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  facebook::velox::aggregate::prestosql::registerAllAggregateFunctions();
+  auto numRegressions = facebook::velox::exec::test::perfFuzzer(FLAGS_seed);
+  return numRegressions == 0 ? 0 : 1;
+}
@@ -321,6 +321,23 @@ TEST_F(PlanNodeToStringTest, crossJoin) {
   ASSERT_EQ(
       "-- CrossJoin[] -> t_c0:SMALLINT, t_c1:INTEGER, u_c1:INTEGER\n",
       plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .values({data_})
+             .project({"c0 as t_c0", "c1 as t_c1"})
+             .crossJoin(
+                 PlanBuilder()
+                     .values({data_})
+                     .project({"c0 as u_c0", "c1 as u_c1"})
+                     .planNode(),
+                 "t_c1 > u_c1",
+                 {"t_c0", "t_c1", "u_c1"})
+             .planNode();
+
+  ASSERT_EQ("-- CrossJoin\n", plan->toString());
+  ASSERT_EQ(
+      "-- CrossJoin[filter: gt(ROW[\"t_c1\"],ROW[\"u_c1\"])] -> t_c0:SMALLINT, t_c1:INTEGER, u_c1:INTEGER\n",
+      plan->toString(true, false));
 }
 
 TEST_F(PlanNodeToStringTest, orderBy) {
@@ -383,6 +400,27 @@ TEST_F(PlanNodeToStringTest, topN) {
       plan->toString(true, false));
 }
 
+TEST_F(PlanNodeToStringTest, topNRowNumber) {
+  auto plan = PlanBuilder()
+                  .values({data_})
+                  .topNRowNumber({"c0"}, {"c1 DESC"}, 5, true)
+                  .planNode();
+
+  ASSERT_EQ("-- TopNRowNumber\n", plan->toString());
+  ASSERT_EQ(
+      "-- TopNRowNumber[partition by [c0] order by [c1 DESC NULLS LAST] row_number := row_number() limit 5] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT, row_number:BIGINT\n",
+      plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRowNumber({}, {"c2"}, 3, false)
+             .planNode();
+
+  ASSERT_EQ(
+      "-- TopNRowNumber[partition by [] order by [c2 ASC NULLS LAST] limit 3] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
+      plan->toString(true, false));
+}
+
 TEST_F(PlanNodeToStringTest, enforceSingleRow) {
   auto plan = PlanBuilder().values({data_}).enforceSingleRow().planNode();
 
@@ -583,4 +621,17 @@ TEST_F(PlanNodeToStringTest, window) {
       "w0 := window1(ROW[\"c\"]) RANGE between CURRENT ROW and b FOLLOWING] "
       "-> a:VARCHAR, b:BIGINT, c:BIGINT, w0:BIGINT\n",
       plan->toString(true, false));
+
+  plan =
+      PlanBuilder()
+          .tableScan(ROW({"a", "b", "c"}, {VARCHAR(), BIGINT(), BIGINT()}))
+          .streamingWindow(
+              {"window1(c) over (partition by a order by b "
+               "rows between current row and unbounded following)"})
+          .planNode();
+  ASSERT_EQ(
+      "-- Window[STREAMING partition by [a] order by [b ASC NULLS LAST] "
+      "w0 := window1(ROW[\"c\"]) ROWS between CURRENT ROW and UNBOUNDED FOLLOWING] "
+      "-> a:VARCHAR, b:BIGINT, c:BIGINT, w0:BIGINT\n",
+      plan->toString(true, false));
 }
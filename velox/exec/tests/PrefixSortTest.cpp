@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/RowContainerTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class PrefixSortTest : public exec::test::RowContainerTestBase {
+ protected:
+  // Stores 'data' in a row container with all of its columns as keys. Sorts
+  // the rows with PrefixSort for all combinations of the sort direction and
+  // the null ordering and verifies the order with RowContainer::compareRows().
+  void testSort(const RowVectorPtr& data) {
+    const auto numKeys = data->childrenSize();
+    auto rowContainer =
+        makeRowContainer(data->type()->asRow().children(), {}, false);
+    const SelectivityVector allRows(data->size());
+    std::vector<char*> rows(data->size());
+    for (auto i = 0; i < data->size(); ++i) {
+      rows[i] = rowContainer->newRow();
+    }
+    for (auto column = 0; column < numKeys; ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto i = 0; i < data->size(); ++i) {
+        rowContainer->store(decoded, i, rows[i], column);
+      }
+    }
+
+    for (const bool ascending : {true, false}) {
+      for (const bool nullsFirst : {true, false}) {
+        SCOPED_TRACE(fmt::format(
+            "ascending: {}, nullsFirst: {}", ascending, nullsFirst));
+        std::vector<CompareFlags> flags(
+            numKeys, CompareFlags{nullsFirst, ascending, false, false});
+        auto sorted = rows;
+        PrefixSort::sort(
+            rowContainer.get(),
+            flags,
+            folly::Range<char**>(sorted.data(), sorted.size()));
+        for (auto i = 1; i < sorted.size(); ++i) {
+          ASSERT_LE(
+              rowContainer->compareRows(sorted[i - 1], sorted[i], flags), 0)
+              << "at row " << i;
+        }
+        std::sort(sorted.begin(), sorted.end());
+        auto expected = rows;
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(sorted, expected);
+      }
+    }
+  }
+};
+
+TEST_F(PrefixSortTest, prefixLayout) {
+  EXPECT_EQ(PrefixSort::prefixLayout({BIGINT()}), std::make_pair(1, 9));
+  EXPECT_EQ(
+      PrefixSort::prefixLayout({INTEGER(), DOUBLE(), SMALLINT()}),
+      std::make_pair(3, 3 + 5 + 9));
+  // The prefix ends at the first string key.
+  EXPECT_EQ(
+      PrefixSort::prefixLayout({TINYINT(), VARCHAR(), BIGINT()}),
+      std::make_pair(2, 2 + 5));
+  // The prefix ends when the next key doesn't fit.
+  EXPECT_EQ(
+      PrefixSort::prefixLayout({BIGINT(), BIGINT(), BIGINT()}),
+      std::make_pair(2, 18));
+  EXPECT_EQ(
+      PrefixSort::prefixLayout({ARRAY(BIGINT()), BIGINT()}),
+      std::make_pair(0, 0));
+}
+
+TEST_F(PrefixSortTest, fixedWidthKeys) {
+  const vector_size_t size = 1'000;
+  testSort(makeRowVector({
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return (row % 7 - 3) * 1'000'000'000L; },
+          nullEvery(11)),
+      makeFlatVector<int32_t>(
+          size, [](auto row) { return row % 5 - 2; }, nullEvery(13)),
+      makeFlatVector<double>(
+          size,
+          [](auto row) {
+            switch (row % 6) {
+              case 0:
+                return std::numeric_limits<double>::quiet_NaN();
+              case 1:
+                return -0.0;
+              case 2:
+                return 0.0;
+              case 3:
+                return -std::numeric_limits<double>::infinity();
+              default:
+                return row * 0.5 - 250;
+            }
+          },
+          nullEvery(17)),
+  }));
+  testSort(makeRowVector({
+      makeFlatVector<bool>(
+          size, [](auto row) { return row % 3 == 0; }, nullEvery(7)),
+      makeFlatVector<int8_t>(
+          size, [](auto row) { return row % 256 - 128; }, nullEvery(5)),
+      makeFlatVector<int16_t>(size, [](auto row) { return -row; }),
+      makeFlatVector<float>(
+          size, [](auto row) { return (row % 9) - 4.5; }, nullEvery(3)),
+  }));
+}
+
+TEST_F(PrefixSortTest, stringKeys) {
+  const vector_size_t size = 1'000;
+  const std::vector<std::string> values = {
+      "",
+      "a",
+      std::string("a\0b", 3),
+      "ab",
+      "abcd",
+      "abcde",
+      "abcdefghijklmnop",
+      "b",
+      "\xff"};
+  testSort(makeRowVector({
+      makeFlatVector<StringView>(
+          size,
+          [&](auto row) { return StringView(values[row % values.size()]); },
+          nullEvery(10)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 4; }),
+  }));
+}
+
+TEST_F(PrefixSortTest, tieBreak) {
+  const vector_size_t size = 1'000;
+  // The third key doesn't fit in the prefix.
+  testSort(makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 3; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 5; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row % 7; }, nullEvery(9)),
+  }));
+  // No prefix for a complex type key.
+  testSort(makeRowVector({
+      makeArrayVector<int64_t>(
+          size,
+          [](vector_size_t row) { return row % 3; },
+          [](vector_size_t index) { return index % 4; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 7; }),
+  }));
+}
@@ -174,7 +174,9 @@ TEST_F(PrintPlanWithStatsTest, innerJoinWithTableScan) {
        {"          numPrefetch               sum: .+, count: 1, min: .+, max: .+"},
        {"          numRamRead                sum: 0, count: 1, min: 0, max: 0"},
        {"          numStorageRead            sum: .+, count: 1, min: .+, max: .+"},
+       {"          overreadBytes             sum: .+, count: 1, min: .+, max: .+"},
        {"          prefetchBytes             sum: .+, count: 1, min: .+, max: .+"},
+       {"          prefetchUnusedBytes       sum: .+, count: 1, min: .+, max: .+"},
        {"          ramReadBytes              sum: 0B, count: 1, min: 0B, max: 0B"},
        {"          skippedSplitBytes         sum: 0B, count: 1, min: 0B, max: 0B"},
        {"          skippedSplits             sum: 0, count: 1, min: 0, max: 0"},
@@ -231,7 +233,9 @@ TEST_F(PrintPlanWithStatsTest, partialAggregateWithTableScan) {
        {"        numPrefetch            sum: .+, count: .+, min: .+, max: .+"},
        {"        numRamRead             sum: 0, count: 1, min: 0, max: 0"},
        {"        numStorageRead         sum: .+, count: 1, min: .+, max: .+"},
+       {"        overreadBytes          sum: .+, count: 1, min: .+, max: .+"},
        {"        prefetchBytes          sum: .+, count: 1, min: .+, max: .+"},
+       {"        prefetchUnusedBytes    sum: .+, count: 1, min: .+, max: .+"},
        {"        ramReadBytes           sum: 0B, count: 1, min: 0B, max: 0B"},
        {"        skippedSplitBytes      sum: 0B, count: 1, min: 0B, max: 0B"},
        {"        skippedSplits          sum: 0, count: 1, min: 0, max: 0"},
@@ -655,6 +655,64 @@ TEST_F(RowContainerTest, erase) {
   data->checkConsistency();
 }
 
+TEST_F(RowContainerTest, rowBlocks) {
+  constexpr int32_t kNumRows = 1'000;
+  auto batch = makeRowVector({
+      makeFlatVector<int64_t>(kNumRows, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          kNumRows,
+          [](auto row) {
+            return StringView(std::string(row % 40, 'a' + row % 26));
+          },
+          nullEvery(7)),
+      makeArrayVector<StringView>(
+          kNumRows,
+          [](auto row) { return row % 3; },
+          [](auto row) { return StringView(std::string(20, 'x' + row % 3)); },
+          nullEvery(11)),
+  });
+  auto data = makeRowContainer(
+      {BIGINT(), VARCHAR()}, {ARRAY(VARCHAR())}, false /*isJoinBuild*/);
+  std::vector<char*> rows(kNumRows);
+  SelectivityVector allRows(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    rows[i] = data->newRow();
+  }
+  for (auto column = 0; column < batch->childrenSize(); ++column) {
+    DecodedVector decoded(*batch->childAt(column), allRows);
+    for (auto i = 0; i < kNumRows; ++i) {
+      data->store(decoded, i, rows[i], column);
+    }
+  }
+
+  // Writes the rows in two blocks.
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  const auto path = tempDirectory->path + "/rowBlocks";
+  uint64_t fileSize = 0;
+  {
+    LocalWriteFile file(path);
+    const auto half = kNumRows / 2;
+    fileSize += data->writeRowBlock(folly::Range(rows.data(), half), file);
+    fileSize += data->writeRowBlock(
+        folly::Range(rows.data() + half, kNumRows - half), file);
+  }
+
+  MappedSpillFile mapped(path);
+  ASSERT_EQ(fileSize, mapped.size());
+  std::vector<char*> restored;
+  data->readRowBlocks(mapped.data(), mapped.size(), restored);
+  ASSERT_EQ(kNumRows, restored.size());
+  for (auto column = 0; column < batch->childrenSize(); ++column) {
+    auto result =
+        BaseVector::create(batch->childAt(column)->type(), kNumRows, pool());
+    data->extractColumn(restored.data(), kNumRows, column, result);
+    assertEqualVectors(batch->childAt(column), result);
+  }
+  for (auto i = 0; i < kNumRows; ++i) {
+    ASSERT_EQ(0, data->compareRows(rows[i], restored[i]));
+  }
+}
+
 TEST_F(RowContainerTest, initialNulls) {
   std::vector<TypePtr> keys{INTEGER()};
   std::vector<TypePtr> dependent{INTEGER()};
@@ -735,6 +793,47 @@ TEST_F(RowContainerTest, compareDouble) {
   testCompareFloats<double>(DOUBLE(), false, false);
 }
 
+TEST_F(RowContainerTest, compareComplexTypeRows) {
+  facebook::velox::test::VectorMaker vectorMaker{pool_.get()};
+  // Struct keys with repeated values, long and short strings.
+  auto keys = vectorMaker.rowVector(
+      {vectorMaker.arrayVector<int64_t>(
+           100,
+           [](auto row) { return row % 4; },
+           [](auto row) { return row % 7; }),
+       vectorMaker.flatVector<std::string>(100, [](auto row) {
+         return std::string(row % 3 * 10, 'a' + row % 5);
+       })});
+  auto data = makeRowContainer({keys->type()}, {BIGINT()});
+  SelectivityVector allRows(keys->size());
+  DecodedVector decoded(*keys, allRows);
+  std::vector<char*> rows(keys->size());
+  for (auto i = 0; i < keys->size(); ++i) {
+    rows[i] = data->newRow();
+    data->store(decoded, i, rows[i], 0);
+  }
+  for (auto i = 0; i < keys->size(); ++i) {
+    for (auto j = 0; j < keys->size(); ++j) {
+      auto expected = keys->compare(keys.get(), i, j, CompareFlags{});
+      ASSERT_TRUE(expected.has_value());
+      auto result = data->compare(rows[i], rows[j], 0);
+      EXPECT_EQ(expected.value() == 0, result == 0) << i << " " << j;
+    }
+  }
+
+  // NaNs in a complex type do not compare equal, although their bytes are.
+  auto nans = vectorMaker.arrayVector<double>(
+      {{std::numeric_limits<double>::quiet_NaN()},
+       {std::numeric_limits<double>::quiet_NaN()}});
+  data = makeRowContainer({nans->type()}, {BIGINT()});
+  SelectivityVector nanRowsSelected(2);
+  DecodedVector decodedNans(*nans, nanRowsSelected);
+  std::vector<char*> nanRows = {data->newRow(), data->newRow()};
+  data->store(decodedNans, 0, nanRows[0], 0);
+  data->store(decodedNans, 1, nanRows[1], 0);
+  EXPECT_NE(0, data->compare(nanRows[0], nanRows[1], 0));
+}
+
 TEST_F(RowContainerTest, partition) {
   // We assign an arbitrary partition number to each row and iterate
   // over the rows a partition at a time.
@@ -392,6 +392,36 @@ TEST_P(MultiSpillOperatorGroupTest, error) {
   }
 }
 
+TEST_P(MultiSpillOperatorGroupTest, externalSpill) {
+  setupSpillGroup();
+  // Can't request spill before the group starts.
+  ASSERT_FALSE(spillGroup_->requestExternalSpill());
+  startSpillGroup();
+
+  // The spill runs after all the operators reach the spill barrier.
+  ASSERT_TRUE(spillGroup_->requestExternalSpill());
+  ASSERT_TRUE(spillGroup_->needSpill());
+  for (int32_t i = 0; i < spillOps_.size(); ++i) {
+    const bool wait = spillOps_[i]->waitSpill();
+    ASSERT_EQ(wait, i != spillOps_.size() - 1);
+  }
+  ASSERT_FALSE(spillGroup_->needSpill());
+  ++numSpillRuns_;
+  waitSpillOperators();
+  checkSpillOperators();
+
+  // The request is dropped if all the operators stop before reaching the
+  // spill barrier.
+  ASSERT_TRUE(spillGroup_->requestExternalSpill());
+  for (auto& op : spillOps_) {
+    op->stopSpill();
+  }
+  ASSERT_EQ(spillGroup_->state(), SpillOperatorGroup::State::kStopped);
+  ASSERT_FALSE(spillGroup_->needSpill());
+  checkSpillOperators();
+  ASSERT_FALSE(spillGroup_->requestExternalSpill());
+}
+
 TEST_P(MultiSpillOperatorGroupTest, multiThreading) {
   setupSpillGroup();
   startSpillGroup();
@@ -14,10 +14,12 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <memory>
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
@@ -598,3 +600,226 @@ TEST_F(SpillTest, nonExistSpillFileOnDeletion) {
   tempDir_.reset();
   state_.reset();
 }
+
+TEST_F(SpillTest, spillFileReader) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 3; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(100, [i](auto row) { return i * 100 + row; }),
+        makeFlatVector<StringView>(
+            100, [](auto row) { return StringView(std::to_string(row)); }),
+    }));
+  }
+
+  SpillFileList fileList(
+      asRowType(batches[0]->type()),
+      0,
+      {},
+      tempDir_->path + "/reader",
+      kGB,
+      *pool(),
+      *mappedMemory_);
+  for (const auto& batch : batches) {
+    IndexRange range{0, batch->size()};
+    fileList.write(batch, folly::Range<IndexRange*>(&range, 1));
+  }
+  auto files = fileList.files();
+  ASSERT_EQ(1, files.size());
+
+  // Two readers of the same file at the same time see the same content.
+  auto reader = files[0]->createReader(*pool());
+  auto otherReader = files[0]->createReader(*pool());
+  for (const auto& expected : batches) {
+    RowVectorPtr batch;
+    ASSERT_TRUE(reader->nextBatch(batch));
+    facebook::velox::test::assertEqualVectors(expected, batch);
+    RowVectorPtr otherBatch;
+    ASSERT_TRUE(otherReader->nextBatch(otherBatch));
+    facebook::velox::test::assertEqualVectors(expected, otherBatch);
+  }
+  RowVectorPtr batch;
+  ASSERT_FALSE(reader->nextBatch(batch));
+  ASSERT_FALSE(otherReader->nextBatch(batch));
+
+  // The file can be read again from the start.
+  reader = files[0]->createReader(*pool());
+  ASSERT_TRUE(reader->nextBatch(batch));
+  facebook::velox::test::assertEqualVectors(batches[0], batch);
+}
+
+TEST_F(SpillTest, compression) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 3; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [i](auto row) { return i + row / 100; }),
+        makeFlatVector<StringView>(
+            1'000, [](auto /*row*/) { return StringView("compressible"); }),
+    }));
+  }
+
+  for (auto type : {folly::io::CodecType::LZ4, folly::io::CodecType::ZSTD}) {
+    if (!folly::io::hasCodec(type)) {
+      continue;
+    }
+    SCOPED_TRACE(static_cast<int>(type));
+    SpillFileList fileList(
+        asRowType(batches[0]->type()),
+        0,
+        {},
+        fmt::format("{}/compression{}", tempDir_->path, static_cast<int>(type)),
+        kGB,
+        *pool(),
+        *mappedMemory_,
+        type);
+    for (const auto& batch : batches) {
+      IndexRange range{0, batch->size()};
+      fileList.write(batch, folly::Range<IndexRange*>(&range, 1));
+    }
+    auto files = fileList.files();
+    ASSERT_EQ(1, files.size());
+    ASSERT_EQ(type, files[0]->compressionType());
+    ASSERT_LT(fileList.spilledBytes(), fileList.spilledUncompressedBytes());
+
+    auto reader = files[0]->createReader(*pool());
+    for (const auto& expected : batches) {
+      RowVectorPtr batch;
+      ASSERT_TRUE(reader->nextBatch(batch));
+      facebook::velox::test::assertEqualVectors(expected, batch);
+    }
+    RowVectorPtr batch;
+    ASSERT_FALSE(reader->nextBatch(batch));
+  }
+
+  ASSERT_EQ(folly::io::CodecType::NO_COMPRESSION, spillCompressionType("none"));
+  VELOX_ASSERT_THROW(
+      spillCompressionType("brotli"), "Unknown spill compression codec");
+}
+
+TEST_F(SpillTest, memoryTier) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 3; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(100, [i](auto row) { return i * 100 + row; }),
+        makeFlatVector<StringView>(
+            100, [](auto row) { return StringView(std::to_string(row)); }),
+    }));
+  }
+  auto fs = filesystems::getFileSystem(tempDir_->path, nullptr);
+  auto& tier = SpillMemoryTier::instance();
+  FLAGS_spill_memory_tier_mb = 1;
+  const auto initialBytes = tier.usedBytes();
+
+  auto checkContent = [&](const SpillFile& file) {
+    auto reader = file.createReader(*pool());
+    for (const auto& expected : batches) {
+      RowVectorPtr batch;
+      ASSERT_TRUE(reader->nextBatch(batch));
+      facebook::velox::test::assertEqualVectors(expected, batch);
+    }
+    RowVectorPtr batch;
+    ASSERT_FALSE(reader->nextBatch(batch));
+  };
+
+  {
+    SpillFileList fileList(
+        asRowType(batches[0]->type()),
+        0,
+        {},
+        tempDir_->path + "/memory",
+        kGB,
+        *pool(),
+        *mappedMemory_);
+    for (const auto& batch : batches) {
+      IndexRange range{0, batch->size()};
+      fileList.write(batch, folly::Range<IndexRange*>(&range, 1));
+    }
+    auto files = fileList.files();
+    ASSERT_EQ(1, files.size());
+    ASSERT_TRUE(files[0]->inMemory());
+    ASSERT_EQ(initialBytes + files[0]->size(), tier.usedBytes());
+    EXPECT_ANY_THROW(fs->openFileForRead(files[0]->testingFilePath()));
+    checkContent(*files[0]);
+  }
+  ASSERT_EQ(initialBytes, tier.usedBytes());
+
+  {
+    SpillFileList fileList(
+        asRowType(batches[0]->type()),
+        0,
+        {},
+        tempDir_->path + "/demoted",
+        kGB,
+        *pool(),
+        *mappedMemory_);
+    IndexRange range{0, batches[0]->size()};
+    fileList.write(batches[0], folly::Range<IndexRange*>(&range, 1));
+    // Fills the budget, so that the next write moves the file to disk.
+    const auto restBytes = (1 << 20) - tier.usedBytes();
+    ASSERT_TRUE(tier.tryReserve(restBytes));
+    ASSERT_FALSE(tier.tryReserve(1));
+    for (auto i = 1; i < batches.size(); ++i) {
+      range = {0, batches[i]->size()};
+      fileList.write(batches[i], folly::Range<IndexRange*>(&range, 1));
+    }
+    tier.release(restBytes);
+    auto files = fileList.files();
+    ASSERT_EQ(1, files.size());
+    ASSERT_FALSE(files[0]->inMemory());
+    ASSERT_EQ(initialBytes, tier.usedBytes());
+    ASSERT_EQ(
+        files[0]->size(),
+        fs->openFileForRead(files[0]->testingFilePath())->size());
+    checkContent(*files[0]);
+  }
+  FLAGS_spill_memory_tier_mb = 0;
+}
+
+TEST_F(SpillTest, asyncWrite) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return i * 1'000 + row; }),
+        makeFlatVector<StringView>(
+            1'000, [](auto row) { return StringView(std::to_string(row)); }),
+    }));
+  }
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(2);
+  FLAGS_spill_max_pending_write_mb = 1;
+  std::vector<RowVectorPtr> results;
+  {
+    // A small target file size makes a new file for each batch.
+    SpillFileList fileList(
+        asRowType(batches[0]->type()),
+        0,
+        {},
+        tempDir_->path + "/async",
+        1'000,
+        *pool(),
+        *mappedMemory_,
+        folly::io::CodecType::NO_COMPRESSION,
+        executor.get());
+    for (auto i = 0; i < batches.size(); ++i) {
+      IndexRange range{0, batches[i]->size()};
+      fileList.write(batches[i], folly::Range<IndexRange*>(&range, 1));
+      if (i == 4) {
+        fileList.finishFile();
+      }
+    }
+    auto files = fileList.files();
+    ASSERT_EQ(batches.size(), files.size());
+    for (const auto& file : files) {
+      auto reader = file->createReader(*pool());
+      RowVectorPtr batch;
+      while (reader->nextBatch(batch)) {
+        results.push_back(batch);
+        batch = nullptr;
+      }
+    }
+  }
+  FLAGS_spill_max_pending_write_mb = 0;
+  ASSERT_EQ(batches.size(), results.size());
+  for (auto i = 0; i < batches.size(); ++i) {
+    facebook::velox::test::assertEqualVectors(batches[i], results[i]);
+  }
+}
@@ -109,7 +109,11 @@ class SpillerTest : public exec::test::RowContainerTestBase {
       : param_(param),
         type_(param.type),
         executorPoolSize_(param.poolSize),
-        hashBits_(0, type_ == Spiller::Type::kOrderBy ? 0 : 2),
+        hashBits_(
+            0,
+            type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kTopN
+                ? 0
+                : 2),
         numPartitions_(hashBits_.numPartitions()),
         statWriter_(std::make_unique<TestRuntimeStatWriter>(stats_)) {
     setThreadLocalRunTimeStatWriter(statWriter_.get());
@@ -403,9 +407,10 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           minSpillRunSize,
           *pool_,
           executor());
-    } else if (type_ == Spiller::Type::kOrderBy) {
-      // We spill 'data' in one partition in type of kOrderBy, otherwise in 4
-      // partitions.
+    } else if (
+        type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kTopN) {
+      // We spill 'data' in one partition in type of kOrderBy and kTopN,
+      // otherwise in 4 partitions.
       spiller_ = std::make_unique<Spiller>(
           type_,
           rowContainer_.get(),
@@ -418,6 +423,23 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           minSpillRunSize,
           *pool_,
           executor());
+    } else if (type_ == Spiller::Type::kWindow) {
+      // Hash partitions on all the keys to get the same spill partitions as
+      // the other sorted spiller types.
+      spiller_ = std::make_unique<Spiller>(
+          type_,
+          rowContainer_.get(),
+          [&](folly::Range<char**> rows) { rowContainer_->eraseRows(rows); },
+          rowType_,
+          hashBits_,
+          rowContainer_->keyTypes().size(),
+          rowContainer_->keyTypes().size(),
+          compareFlags_,
+          makeError ? "/bad/path" : tempDirPath_->path,
+          targetFileSize,
+          minSpillRunSize,
+          *pool_,
+          executor());
     } else {
       spiller_ = std::make_unique<Spiller>(
           type_,
@@ -433,7 +455,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           *pool_,
           executor());
     }
-    if (type_ == Spiller::Type::kOrderBy) {
+    if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kTopN) {
       ASSERT_EQ(spiller_->state().maxPartitions(), 1);
     } else {
       ASSERT_EQ(spiller_->state().maxPartitions(), numPartitions_);
@@ -830,7 +852,8 @@ class NoHashJoinNoOrderBy : public SpillerTest,
         .typesToExclude =
             {Spiller::Type::kHashJoinProbe,
              Spiller::Type::kHashJoinBuild,
-             Spiller::Type::kOrderBy}}
+             Spiller::Type::kOrderBy,
+             Spiller::Type::kTopN}}
         .getTestParams();
   }
 };
@@ -880,8 +903,8 @@ TEST_P(NoHashJoin, error) {
 }
 
 TEST_P(NoHashJoinNoOrderBy, spillWithEmptyPartitions) {
-  // kOrderBy type which has only one partition which is not relevant for this
-  // test.
+  // kOrderBy and kTopN types which have only one partition are not relevant
+  // for this test.
   rowType_ = ROW({{"long_val", BIGINT()}, {"string_val", VARCHAR()}});
   struct {
     std::vector<int> rowsPerPartition;
@@ -951,7 +974,8 @@ TEST_P(NoHashJoinNoOrderBy, spillWithEmptyPartitions) {
 }
 
 TEST_P(NoHashJoinNoOrderBy, spillWithNonSpillingPartitions) {
-  // kOrderBy type which has only one partition, is irrelevant for this test.
+  // kOrderBy and kTopN types which have only one partition, are irrelevant for
+  // this test.
   rowType_ = ROW({{"long_val", BIGINT()}, {"string_val", VARCHAR()}});
   struct {
     std::vector<int> rowsPerPartition;
@@ -1014,7 +1038,8 @@ TEST_P(NoHashJoinNoOrderBy, spillWithNonSpillingPartitions) {
 }
 
 TEST_P(AllTypes, nonSortedSpillFunctions) {
-  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kAggregate) {
+  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kAggregate ||
+      type_ == Spiller::Type::kWindow || type_ == Spiller::Type::kTopN) {
     setupSpillData(rowType_, numKeys_, 1'000, 1, nullptr, {});
     sortSpillData();
     setupSpiller(100'000, 0, false);
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/tests/utils/SqlQueryBuilder.h"
+#include "velox/common/base/Fs.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+class SqlQueryBuilderTest : public HiveConnectorTestBase {
+ protected:
+  void SetUp() override {
+    HiveConnectorTestBase::SetUp();
+    std::vector<RowVectorPtr> t;
+    for (auto i = 0; i < 2; ++i) {
+      t.push_back(makeRowVector(
+          {"t_key", "t_value", "t_name", "t_price"},
+          {makeFlatVector<int64_t>(
+               1'000, [&](auto row) { return i * 1'000 + row; }),
+           makeFlatVector<int32_t>(1'000, [](auto row) { return row % 17; }),
+           makeFlatVector<StringView>(
+               1'000,
+               [](auto row) {
+                 return StringView(fmt::format("n{}", row % 5));
+               }),
+           makeFlatVector<double>(
+               1'000, [](auto row) { return row * 0.5; })}));
+    }
+    std::vector<RowVectorPtr> u = {makeRowVector(
+        {"u_key", "u_group"},
+        {makeFlatVector<int64_t>(300, [](auto row) { return row * 3; }),
+         makeFlatVector<StringView>(300, [](auto row) {
+           return StringView(fmt::format("g{}", row % 4));
+         })})};
+
+    fs::create_directory(directory_->path + "/t");
+    fs::create_directory(directory_->path + "/u");
+    writeToFile(directory_->path + "/t/1.dwrf", t[0]);
+    writeToFile(directory_->path + "/t/2.dwrf", t[1]);
+    writeToFile(directory_->path + "/u/1.dwrf", u);
+    createDuckDbTable("t", t);
+    createDuckDbTable("u", u);
+
+    queryBuilder_.initialize(directory_->path);
+  }
+
+  // Runs 'sql' with 4 drivers and compares the result with DuckDB. Checks the
+  // order of the rows on 'sortingKeys' if given.
+  void assertSql(
+      const std::string& sql,
+      const std::optional<std::vector<uint32_t>>& sortingKeys = std::nullopt) {
+    SCOPED_TRACE(sql);
+    const auto plan = queryBuilder_.getQueryPlan(sql);
+    AssertQueryBuilder query(plan.plan, duckDbQueryRunner_);
+    query.maxDrivers(4);
+    for (const auto& [planNodeId, files] : plan.dataFiles) {
+      std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+      for (const auto& file : files) {
+        splits.push_back(makeHiveConnectorSplit(file));
+      }
+      query.splits(planNodeId, splits);
+    }
+    query.assertResults(sql, sortingKeys);
+  }
+
+  const std::shared_ptr<TempDirectoryPath> directory_{
+      TempDirectoryPath::create()};
+  SqlQueryBuilder queryBuilder_{dwio::common::FileFormat::DWRF};
+};
+
+TEST_F(SqlQueryBuilderTest, scan) {
+  EXPECT_EQ(4, queryBuilder_.tableType("t")->size());
+  assertSql("SELECT * FROM t");
+  assertSql(
+      "SELECT t_key, t_value * 2 AS v FROM t "
+      "WHERE t_value < 5 AND t_name = 'n1' AND t_key % 3 = 0");
+  assertSql("SELECT count(*) FROM t");
+  assertSql("SELECT DISTINCT t_name FROM t WHERE t_key % 2 = 0");
+}
+
+TEST_F(SqlQueryBuilderTest, aggregation) {
+  assertSql(
+      "SELECT t_name, count(*), sum(t_price), max(t_value + 1) "
+      "FROM t GROUP BY t_name");
+  assertSql(
+      "SELECT t_value % 3 AS m, sum(t_price) / count(*) FROM t "
+      "GROUP BY m HAVING min(t_key) < 10");
+  assertSql(
+      "SELECT t_name, sum(t_price) AS total FROM t GROUP BY 1 "
+      "ORDER BY total DESC LIMIT 3",
+      std::vector<uint32_t>{1});
+}
+
+TEST_F(SqlQueryBuilderTest, join) {
+  const auto sql =
+      "SELECT u_group, sum(t_price) AS revenue FROM t, u "
+      "WHERE t_key = u_key AND t_value > 3 GROUP BY 1 HAVING count(*) > 10";
+  EXPECT_EQ(2, queryBuilder_.getQueryPlan(sql).dataFiles.size());
+  assertSql(sql);
+  assertSql(
+      "SELECT t.t_key, u.u_group FROM t JOIN u ON t.t_key = u.u_key "
+      "WHERE u_group <> 'g1' ORDER BY t_key DESC LIMIT 10 OFFSET 5",
+      std::vector<uint32_t>{0});
+  assertSql(
+      "SELECT u_group, t_key FROM t, u WHERE t_key < 3 AND u_key < 9 "
+      "ORDER BY t_price, u_key");
+}
+
+TEST_F(SqlQueryBuilderTest, unsupported) {
+  VELOX_ASSERT_THROW(
+      queryBuilder_.getQueryPlan("SELECT * FROM v"), "Table not found: v");
+  VELOX_ASSERT_THROW(
+      queryBuilder_.getQueryPlan(
+          "SELECT * FROM t WHERE t_key IN (SELECT u_key FROM u)"),
+      "Subqueries are not supported");
+  VELOX_ASSERT_THROW(
+      queryBuilder_.getQueryPlan("SELECT t_key, count(*) FROM t"),
+      "Column t_key must be in GROUP BY or in an aggregate");
+  VELOX_ASSERT_THROW(
+      queryBuilder_.getQueryPlan(
+          "SELECT * FROM t LEFT JOIN u ON t_key = u_key"),
+      "Only inner joins with ON are supported");
+}
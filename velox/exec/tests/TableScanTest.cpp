@@ -21,6 +21,7 @@
 #include "velox/dwio/common/tests/utils/DataFiles.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -257,6 +258,59 @@ TEST_F(TableScanTest, partitionKeyAlias) {
   assertQuery(op, split, "SELECT c0, '2021-12-02' FROM tmp");
 }
 
+TEST_F(TableScanTest, prunePartitionedSplits) {
+  auto vectors = makeVectors(1, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  ColumnHandleMap assignments = {
+      {"a", regularColumn("c0", BIGINT())},
+      {"ds_alias", partitionKey("ds", VARCHAR())}};
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  for (const auto& ds : {"2021-12-01", "2021-12-02", "2021-12-03"}) {
+    splits.push_back(HiveConnectorSplitBuilder(filePath->path)
+                         .partitionKey("ds", ds)
+                         .build());
+  }
+  splits.push_back(HiveConnectorSplitBuilder(filePath->path)
+                       .partitionKey("ds", std::nullopt)
+                       .build());
+
+  auto outputType = ROW({"a", "ds_alias"}, {BIGINT(), VARCHAR()});
+  auto plan = [&](SubfieldFilters filters) {
+    return PlanBuilder()
+        .tableScan(
+            outputType, makeTableHandle(std::move(filters)), assignments)
+        .planNode();
+  };
+
+  // Only the split of the matching partition is queued and read.
+  auto task = AssertQueryBuilder(
+                  plan(SubfieldFiltersBuilder()
+                           .add("ds", equal("2021-12-02"))
+                           .build()),
+                  duckDbQueryRunner_)
+                  .splits(splits)
+                  .assertResults("SELECT c0, '2021-12-02' FROM tmp");
+  EXPECT_EQ(3, task->taskStats().numPrunedSplits);
+  EXPECT_EQ(1, task->taskStats().numFinishedSplits);
+
+  // A filter on a regular column does not prune partitions.
+  task = AssertQueryBuilder(
+             plan(SubfieldFiltersBuilder()
+                      .add("c0", greaterThanOrEqual(0))
+                      .build()),
+             duckDbQueryRunner_)
+             .splits(splits)
+             .assertResults(
+                 "SELECT c0, ds FROM tmp, "
+                 "(VALUES ('2021-12-01'), ('2021-12-02'), ('2021-12-03'), "
+                 "(null)) t(ds) WHERE c0 >= 0");
+  EXPECT_EQ(0, task->taskStats().numPrunedSplits);
+  EXPECT_EQ(4, task->taskStats().numFinishedSplits);
+}
+
 TEST_F(TableScanTest, columnPruning) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -326,6 +380,17 @@ TEST_F(TableScanTest, missingColumns) {
 
   op = PlanBuilder().tableScan(outputType, tableHandle, assignments).planNode();
   assertQuery(op, filePaths, "SELECT * FROM tmp");
+
+  // Consecutive files with the same schema read with the same column selector.
+  // The schema changes twice in between.
+  auto moreFilePaths = makeFilePaths(2);
+  writeToFile(moreFilePaths[0]->path, {oldData});
+  writeToFile(moreFilePaths[1]->path, {oldData});
+  createDuckDbTable(
+      {oldDataWithNull, newData, oldDataWithNull, oldDataWithNull});
+  filePaths.insert(filePaths.end(), moreFilePaths.begin(), moreFilePaths.end());
+  op = PlanBuilder().tableScan(outputType, tableHandle, assignments).planNode();
+  assertQuery(op, filePaths, "SELECT * FROM tmp");
 }
 
 // Tests queries that use Lazy vectors with multiple layers of wrapping.
@@ -518,6 +583,110 @@ TEST_F(TableScanTest, waitForSplit) {
       duckDbQueryRunner_);
 }
 
+TEST_F(TableScanTest, splitPreload) {
+  auto filePaths = makeFilePaths(10);
+  auto vectors = makeVectors(10, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  // All splits are queued before the scan starts, so the splits after the
+  // first are opened while the previous ones are read.
+  auto task = assertQuery(tableScanNode(), filePaths, "SELECT * FROM tmp");
+  EXPECT_LT(0, getTableScanRuntimeStats(task)["preloadedSplits"].sum);
+
+  // The filters apply to the preloaded splits.
+  task = assertQuery(
+      PlanBuilder().tableScan(rowType_, {"c1 > 0"}).planNode(),
+      filePaths,
+      "SELECT * FROM tmp WHERE c1 > 0");
+  EXPECT_LT(0, getTableScanRuntimeStats(task)["preloadedSplits"].sum);
+}
+
+TEST_F(TableScanTest, asyncLoad) {
+  auto filePaths = makeFilePaths(5);
+  auto vectors = makeVectors(5, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  // The batches and their lazy vectors are read on the IO executor.
+  AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+      .config(core::QueryConfig::kTableScanAsyncLoad, "true")
+      .splits(makeHiveConnectorSplits(filePaths))
+      .assertResults("SELECT * FROM tmp");
+
+  AssertQueryBuilder(
+      PlanBuilder()
+          .tableScan(rowType_, {"c1 > 0"})
+          .filter("c0 % 3 = 0")
+          .project({"c0", "c2"})
+          .planNode(),
+      duckDbQueryRunner_)
+      .config(core::QueryConfig::kTableScanAsyncLoad, "true")
+      .splits(makeHiveConnectorSplits(filePaths))
+      .assertResults("SELECT c0, c2 FROM tmp WHERE c1 > 0 AND c0 % 3 = 0");
+}
+
+TEST_F(TableScanTest, maxActiveDrivers) {
+  auto filePaths = makeFilePaths(10);
+  auto vectors = makeVectors(10, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId scanNodeId;
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .tableScan(rowType_)
+                        .capturePlanNodeId(scanNodeId)
+                        .planNode();
+  params.maxDrivers = 4;
+
+  // One Driver reads the splits until the limit is raised, the others wait.
+  int32_t numCalls = 0;
+  auto task = ::assertQuery(
+      params,
+      [&](Task* task) {
+        if (numCalls == 0) {
+          task->setMaxActiveDrivers(scanNodeId, 1);
+          for (const auto& filePath : filePaths) {
+            task->addSplit(scanNodeId, makeHiveSplit(filePath->path));
+          }
+          task->noMoreSplits(scanNodeId);
+        } else if (numCalls == 3) {
+          task->setMaxActiveDrivers(scanNodeId, 4);
+        }
+        ++numCalls;
+      },
+      "SELECT * FROM tmp",
+      duckDbQueryRunner_);
+  EXPECT_EQ(10, task->taskStats().numFinishedSplits);
+
+  // The Drivers above the limit finish when there are no splits left.
+  numCalls = 0;
+  task = ::assertQuery(
+      params,
+      [&](Task* task) {
+        if (numCalls++ == 0) {
+          task->setMaxActiveDrivers(scanNodeId, 2);
+          for (const auto& filePath : filePaths) {
+            task->addSplit(scanNodeId, makeHiveSplit(filePath->path));
+          }
+          task->noMoreSplits(scanNodeId);
+        }
+      },
+      "SELECT * FROM tmp",
+      duckDbQueryRunner_);
+  EXPECT_EQ(10, task->taskStats().numFinishedSplits);
+  VELOX_ASSERT_THROW(
+      task->setMaxActiveDrivers(scanNodeId, 0),
+      "At least one Driver must read splits");
+}
+
 TEST_F(TableScanTest, splitOffsetAndLength) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -2135,3 +2304,79 @@ TEST_F(TableScanTest, errorInLoadLazy) {
     EXPECT_TRUE(ex.context().find(filePath->path, 0) != std::string::npos);
   }
 }
+
+TEST_F(TableScanTest, aggregateFromMetadata) {
+  std::vector<RowVectorPtr> vectors;
+  int64_t count = 0;
+  int64_t sum = 0;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (i * 1'000 + row) * 3 - 1'000; }),
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row % 100; }, nullEvery(7)),
+    }));
+    for (auto row = 0; row < 1'000; ++row) {
+      if (row % 7 != 0) {
+        ++count;
+        sum += row % 100;
+      }
+    }
+  }
+  auto rowType = asRowType(vectors[0]->type());
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+
+  core::MemConfig config;
+  connector::ConnectorQueryCtx queryCtx(
+      pool_.get(), &config, nullptr, mappedMemory(), "task", "0", 0);
+  auto hiveConnector = connector::getConnector(kHiveConnectorId);
+  using Kind = connector::MetadataAggregate::Kind;
+  std::vector<connector::MetadataAggregate> aggregates = {
+      {Kind::kCount, std::nullopt},
+      {Kind::kCount, 1},
+      {Kind::kMin, 0},
+      {Kind::kMax, 1},
+      {Kind::kSum, 1}};
+
+  auto aggregate = [&](SubfieldFilters filters, bool covered) {
+    auto dataSource = hiveConnector->createDataSource(
+        rowType,
+        makeTableHandle(std::move(filters)),
+        allRegularColumns(rowType),
+        &queryCtx);
+    dataSource->addSplit(makeHiveConnectorSplit(filePath->path));
+    auto result = dataSource->aggregateFromMetadata(aggregates);
+    ASSERT_NE(nullptr, result);
+    ASSERT_EQ(1, result->size());
+    auto valueAt = [&](auto index) {
+      return result->childAt(index)->as<SimpleVector<int64_t>>()->valueAt(0);
+    };
+    ContinueFuture future;
+    if (covered) {
+      EXPECT_EQ(3'000, valueAt(0));
+      EXPECT_EQ(count, valueAt(1));
+      EXPECT_EQ(-1'000, valueAt(2));
+      auto max = result->childAt(3)->as<SimpleVector<int32_t>>();
+      EXPECT_EQ(99, max->valueAt(0));
+      EXPECT_EQ(sum, valueAt(4));
+      // The file statistics cover all rows, so no rows are left to read.
+      EXPECT_EQ(nullptr, dataSource->next(1'000, future).value());
+    } else {
+      EXPECT_EQ(0, valueAt(0));
+      EXPECT_EQ(0, valueAt(1));
+      EXPECT_TRUE(result->childAt(2)->isNullAt(0));
+      EXPECT_TRUE(result->childAt(4)->isNullAt(0));
+      auto batch = dataSource->next(1'000, future).value();
+      ASSERT_NE(nullptr, batch);
+      EXPECT_LT(0, batch->size());
+    }
+  };
+
+  aggregate({}, true);
+  // All values of c0 pass the range.
+  aggregate(singleSubfieldFilter("c0", between(-1'000, 10'000)), true);
+  // Some rows of c0 fail the range and c1 has nulls, so the rows are read.
+  aggregate(singleSubfieldFilter("c0", lessThanOrEqual(0)), false);
+  aggregate(singleSubfieldFilter("c1", isNotNull()), false);
+}
@@ -16,6 +16,7 @@
 #include "velox/common/base/Fs.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/connectors/WriteProtocol.h"
+#include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveWriteProtocol.h"
 #include "velox/dwio/common/DataSink.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
@@ -274,6 +275,146 @@ TEST_F(TableWriteTest, TestASecondCommitStrategy) {
       "SELECT * FROM tmp");
 }
 
+// Writes a file per partition with at most 2 files open at a time.
+TEST_F(TableWriteTest, partitionedWrite) {
+  auto filePaths = makeFilePaths(5);
+  auto vectors = makeVectors(rowType_, filePaths.size(), 1'000);
+  for (int i = 0; i < filePaths.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto outputDirectory = TempDirectoryPath::create();
+  std::vector<std::string> columnNames = {"c0", "c5", "p"};
+  auto plan = PlanBuilder()
+                  .tableScan(rowType_)
+                  .project({"c0", "c5", "c1 % 4"})
+                  .tableWrite(
+                      columnNames,
+                      std::make_shared<core::InsertTableHandle>(
+                          kHiveConnectorId,
+                          makeHiveInsertTableHandle(
+                              columnNames,
+                              {BIGINT(), VARCHAR(), INTEGER()},
+                              {"p"},
+                              makeLocationHandle(outputDirectory->path))),
+                      WriteProtocol::CommitStrategy::kNoCommit,
+                      "rows")
+                  .planNode();
+
+  CursorParameters params;
+  params.planNode = plan;
+  params.queryCtx = std::make_shared<core::QueryCtx>(
+      executor_.get(),
+      std::make_shared<core::MemConfig>(),
+      std::unordered_map<std::string, std::shared_ptr<Config>>{
+          {kHiveConnectorId,
+           std::make_shared<core::MemConfig>(
+               std::unordered_map<std::string, std::string>{
+                   {HiveConfig::kMaxOpenPartitionWriters, "2"}})}});
+  readCursor(params, [&](Task* task) {
+    for (const auto& filePath : filePaths) {
+      task->addSplit("0", exec::Split(makeHiveConnectorSplit(filePath->path)));
+    }
+    task->noMoreSplits("0");
+  });
+
+  // The files of each partition hold the rows of the partition without the
+  // partition key.
+  auto dataType = ROW({"c0", "c5"}, {BIGINT(), VARCHAR()});
+  int32_t numPartitions = 0;
+  for (auto& partition : fs::directory_iterator(outputDirectory->path)) {
+    const auto name = partition.path().filename().string();
+    ASSERT_EQ("p=", name.substr(0, 2));
+    const auto value = name.substr(2);
+    const auto predicate = value == "__HIVE_DEFAULT_PARTITION__"
+        ? std::string("c1 IS NULL")
+        : fmt::format("c1 % 4 = {}", value);
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+    for (auto& file : fs::directory_iterator(partition.path())) {
+      splits.push_back(makeHiveConnectorSplit(file.path().string()));
+    }
+    assertQuery(
+        PlanBuilder().tableScan(dataType).planNode(),
+        splits,
+        fmt::format("SELECT c0, c5 FROM tmp WHERE {}", predicate));
+    ++numPartitions;
+  }
+  // -3 to 3 and possibly null.
+  ASSERT_LE(7, numPartitions);
+}
+
+TEST_F(TableWriteTest, scaleWriters) {
+  auto filePaths = makeFilePaths(5);
+  auto vectors = makeVectors(rowType_, filePaths.size(), 1'000);
+  for (int i = 0; i < filePaths.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  // Writes the scanned rows with 4 writer drivers and returns the number of
+  // files.
+  auto write = [&](uint64_t minBytesPerWriter,
+                   const std::unordered_map<std::string, std::string>&
+                       hiveConfig) {
+    auto outputDirectory = TempDirectoryPath::create();
+    auto plan = PlanBuilder()
+                    .tableScan(rowType_)
+                    .localPartitionScaleWriters(minBytesPerWriter)
+                    .tableWrite(
+                        rowType_->names(),
+                        std::make_shared<core::InsertTableHandle>(
+                            kHiveConnectorId,
+                            makeHiveInsertTableHandle(
+                                rowType_->names(),
+                                rowType_->children(),
+                                {},
+                                makeLocationHandle(outputDirectory->path))),
+                        WriteProtocol::CommitStrategy::kNoCommit,
+                        "rows")
+                    .planNode();
+
+    CursorParameters params;
+    params.planNode = plan;
+    params.maxDrivers = 4;
+    params.queryCtx = std::make_shared<core::QueryCtx>(
+        executor_.get(),
+        std::make_shared<core::MemConfig>(),
+        std::unordered_map<std::string, std::shared_ptr<Config>>{
+            {kHiveConnectorId,
+             std::make_shared<core::MemConfig>(hiveConfig)}});
+    readCursor(params, [&](Task* task) {
+      for (const auto& filePath : filePaths) {
+        task->addSplit(
+            "0", exec::Split(makeHiveConnectorSplit(filePath->path)));
+      }
+      task->noMoreSplits("0");
+    });
+
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+    for (auto& file : fs::directory_iterator(outputDirectory->path)) {
+      splits.push_back(makeHiveConnectorSplit(file.path().string()));
+    }
+    assertQuery(
+        PlanBuilder().tableScan(rowType_).planNode(),
+        splits,
+        "SELECT * FROM tmp");
+    return splits.size();
+  };
+
+  // A small write uses a single writer.
+  ASSERT_EQ(1, write(1L << 40, {}));
+
+  // Some scan driver reads 2 of the 5 splits and sends the second to another
+  // writer.
+  ASSERT_LT(1, write(1, {}));
+
+  // Each write to a file goes over the target size and closes the file.
+  ASSERT_EQ(
+      filePaths.size(),
+      write(1L << 40, {{HiveConfig::kMaxTargetFileSize, "1"}}));
+}
+
 // Test TableWriter does not create a file if input is empty.
 TEST_F(TableWriteTest, writeNoFile) {
   auto outputDirectory = TempDirectoryPath::create();
@@ -527,6 +527,46 @@ TEST_F(TaskTest, singleThreadedExecution) {
   VELOX_ASSERT_THROW(executeSingleThreaded(plan), "division by zero");
 }
 
+TEST_F(TaskTest, memorySnapshot) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          1'000,
+          [](auto row) { return StringView(std::string(32 + row % 16, 'x')); }),
+  });
+  auto plan = PlanBuilder()
+                  .values({data, data, data, data})
+                  .orderBy({"c0"}, false)
+                  .planFragment();
+  auto task = std::make_shared<exec::Task>(
+      "single.execution.task.0", plan, 0, std::make_shared<core::QueryCtx>());
+
+  // The driver is alive until all the sorted rows are returned.
+  ASSERT_NE(nullptr, task->next());
+  auto snapshot = task->memorySnapshot();
+  ASSERT_EQ(task->taskId(), snapshot.taskId);
+  ASSERT_EQ(1, snapshot.pipelines.size());
+  ASSERT_EQ(1, snapshot.pipelines[0].drivers.size());
+  const auto& driver = snapshot.pipelines[0].drivers[0];
+  ASSERT_EQ(2, driver.operators.size());
+  const auto& orderBy = driver.operators[1];
+  ASSERT_EQ("OrderBy", orderBy.operatorType);
+  ASSERT_GT(orderBy.currentBytes, 0);
+  ASSERT_GE(orderBy.peakBytes, orderBy.currentBytes);
+  ASSERT_GT(orderBy.breakdown.at("rowContainer"), 0);
+  ASSERT_GT(orderBy.breakdown.at("hashStringAllocator"), 0);
+  ASSERT_EQ(driver.currentBytes, snapshot.pipelines[0].currentBytes);
+  ASSERT_GE(snapshot.currentBytes, driver.currentBytes);
+  ASSERT_NE(std::string::npos, snapshot.toString().find("OrderBy"));
+
+  while (task->next() != nullptr) {
+  }
+  ASSERT_TRUE(waitForTaskCompletion(task.get()));
+  // Finished drivers are not included.
+  snapshot = task->memorySnapshot();
+  ASSERT_TRUE(snapshot.pipelines[0].drivers.empty());
+}
+
 TEST_F(TaskTest, singleThreadedHashJoin) {
   auto left = makeRowVector(
       {"t_c0", "t_c1"},
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/core/QueryConfig.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+class TopNRowNumberTest : public OperatorTestBase {
+ protected:
+  // Makes vectors with the partition key c0 having 'numPartitions' values
+  // and nulls, the sort key c1 having unique values that are not ordered
+  // across batches and the string payload c2.
+  std::vector<RowVectorPtr> makeVectors(int32_t numPartitions) {
+    std::vector<RowVectorPtr> vectors;
+    for (int32_t i = 0; i < 5; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int32_t>(
+              1'000,
+              [&](auto row) { return (i + row) % numPartitions; },
+              nullEvery(17)),
+          makeFlatVector<int64_t>(
+              1'000, [&](auto row) { return (i * 1'000 + row) * 7 % 5'003; }),
+          makeFlatVector<StringView>(
+              1'000,
+              [](auto row) { return StringView(std::to_string(row)); },
+              nullEvery(11)),
+      }));
+    }
+    return vectors;
+  }
+
+  // Returns the DuckDB query for 'partitionBy' and 'orderBy' clauses of
+  // row_number() over the rows of 'tmp' with row numbers up to 'limit'.
+  static std::string rowNumberSql(
+      const std::string& partitionBy,
+      const std::string& orderBy,
+      int32_t limit,
+      bool generateRowNumber) {
+    return fmt::format(
+        "SELECT c0, c1, c2{} FROM (SELECT *, row_number() OVER ({} ORDER BY "
+        "{}) AS rn FROM tmp) WHERE rn <= {}",
+        generateRowNumber ? ", rn" : "",
+        partitionBy,
+        orderBy,
+        limit);
+  }
+};
+
+TEST_F(TopNRowNumberTest, basic) {
+  auto vectors = makeVectors(10);
+  createDuckDbTable(vectors);
+
+  for (auto limit : {1, 3, 200, 2'000}) {
+    for (auto generateRowNumber : {false, true}) {
+      SCOPED_TRACE(fmt::format(
+          "limit {} generateRowNumber {}", limit, generateRowNumber));
+      auto plan = PlanBuilder()
+                      .values(vectors)
+                      .topNRowNumber({"c0"}, {"c1"}, limit, generateRowNumber)
+                      .planNode();
+      assertQuery(
+          plan,
+          rowNumberSql("PARTITION BY c0", "c1", limit, generateRowNumber));
+
+      plan = PlanBuilder()
+                 .values(vectors)
+                 .topNRowNumber({"c0"}, {"c1 DESC"}, limit, generateRowNumber)
+                 .planNode();
+      assertQuery(
+          plan,
+          rowNumberSql("PARTITION BY c0", "c1 DESC", limit, generateRowNumber));
+    }
+  }
+}
+
+TEST_F(TopNRowNumberTest, multipleKeys) {
+  auto vectors = makeVectors(7);
+  createDuckDbTable(vectors);
+
+  // The string partition key has many small partitions. The sort key which is
+  // also a partition key is left out.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .topNRowNumber({"c2", "c0"}, {"c0", "c1 DESC"}, 2, true)
+                  .planNode();
+  assertQuery(plan, rowNumberSql("PARTITION BY c2, c0", "c1 DESC", 2, true));
+}
+
+TEST_F(TopNRowNumberTest, noPartitionKeys) {
+  auto vectors = makeVectors(10);
+  createDuckDbTable(vectors);
+
+  for (auto limit : {1, 10, 1'000}) {
+    SCOPED_TRACE(fmt::format("limit {}", limit));
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .topNRowNumber({}, {"c1 DESC"}, limit, true)
+                    .planNode();
+    assertQuery(plan, rowNumberSql("", "c1 DESC", limit, true));
+  }
+}
+
+TEST_F(TopNRowNumberTest, empty) {
+  auto vectors = makeVectors(10);
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .filter("c1 < 0")
+                  .topNRowNumber({"c0"}, {"c1"}, 3, true)
+                  .planNode();
+  assertQuery(plan, "SELECT c0, c1, c2, 1::BIGINT FROM tmp WHERE c1 < 0");
+}
+
+TEST_F(TopNRowNumberTest, spill) {
+  auto vectors = makeVectors(10);
+  createDuckDbTable(vectors);
+
+  for (auto limit : {3, 2'000}) {
+    SCOPED_TRACE(fmt::format("limit {}", limit));
+    auto spillDirectory = TempDirectoryPath::create();
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .topNRowNumber({"c0"}, {"c1 DESC"}, limit, true)
+                    .planNode();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .spillDirectory(spillDirectory->path)
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kTopNSpillEnabled, "true")
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .assertResults(
+                rowNumberSql("PARTITION BY c0", "c1 DESC", limit, true));
+    auto stats = task->taskStats().pipelineStats;
+    EXPECT_LT(0, stats[0].operatorStats[1].spilledRows);
+    EXPECT_LT(0, stats[0].operatorStats[1].spilledBytes);
+    EXPECT_EQ(1, stats[0].operatorStats[1].spilledPartitions);
+  }
+}
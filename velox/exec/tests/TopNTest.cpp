@@ -13,8 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/core/QueryConfig.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
@@ -245,3 +247,48 @@ TEST_F(TopNTest, empty) {
 
   testSingleKey(vectors, "c0", "c0 < 0");
 }
+
+TEST_F(TopNTest, spill) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    auto c0 = makeFlatVector<StringView>(batchSize, [](vector_size_t row) {
+      return StringView(std::to_string(row));
+    });
+    // c1 values are unique and not ordered across batches. The sorting key is
+    // not the first column to exercise the reordering of the stored columns.
+    auto c1 = makeFlatVector<int64_t>(batchSize, [&](vector_size_t row) {
+      return (batchSize * i + row) * 7 % 5'003;
+    });
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  createDuckDbTable(vectors);
+
+  // A limit of 300 spills full heaps and drops rows by the spilled threshold.
+  // A limit of 2'500 spills partial heaps.
+  for (const auto limit : {300, 2'500}) {
+    SCOPED_TRACE(fmt::format("limit {}", limit));
+    auto spillDirectory = exec::test::TempDirectoryPath::create();
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kTestingSpillPct, "100"},
+        {core::QueryConfig::kSpillEnabled, "true"},
+        {core::QueryConfig::kTopNSpillEnabled, "true"},
+    });
+    CursorParameters params;
+    params.planNode = PlanBuilder()
+                          .values(vectors)
+                          .topN({"c1 DESC"}, limit, false)
+                          .planNode();
+    params.queryCtx = queryCtx;
+    params.spillDirectory = spillDirectory->path;
+    auto task = assertQueryOrdered(
+        params,
+        fmt::format("SELECT * FROM tmp ORDER BY c1 DESC LIMIT {}", limit),
+        {1});
+    auto stats = task->taskStats().pipelineStats;
+    EXPECT_LT(0, stats[0].operatorStats[1].spilledRows);
+    EXPECT_LT(0, stats[0].operatorStats[1].spilledBytes);
+    EXPECT_EQ(1, stats[0].operatorStats[1].spilledPartitions);
+  }
+}
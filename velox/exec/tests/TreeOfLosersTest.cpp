@@ -241,3 +241,38 @@ TEST_F(TreeOfLosersTest, randomWithDuplicates) {
     }
   }
 }
+
+TEST_F(TreeOfLosersTest, runnerUp) {
+  constexpr int32_t kNumValues = 100'000;
+  for (auto numStreams : {1, 2, 7, 33}) {
+    SCOPED_TRACE(fmt::format("numStreams: {}", numStreams));
+    // Runs of up to 100 consecutive values go to the same stream.
+    std::vector<std::vector<uint32_t>> streams(numStreams);
+    for (auto value = kNumValues; value > 0;) {
+      auto& stream = streams[folly::Random::rand32(numStreams, rng_)];
+      const auto runSize = 1 + folly::Random::rand32(100, rng_);
+      for (auto i = 0; i < runSize && value > 0; ++i) {
+        stream.push_back(value--);
+      }
+    }
+    std::vector<std::unique_ptr<TestingStream>> mergeStreams;
+    for (auto& stream : streams) {
+      mergeStreams.push_back(
+          std::make_unique<TestingStream>(std::move(stream)));
+    }
+    TreeOfLosers<TestingStream> merge(std::move(mergeStreams));
+    uint32_t expected = 1;
+    int32_t numNext = 0;
+    while (auto stream = merge.next()) {
+      ++numNext;
+      auto runnerUp = merge.runnerUp();
+      do {
+        ASSERT_EQ(expected++, stream->current()->value());
+        stream->pop();
+      } while (stream->hasData() && (!runnerUp || !(*runnerUp < *stream)));
+    }
+    ASSERT_EQ(kNumValues + 1, expected);
+    // Each run takes one call to next().
+    ASSERT_GT(kNumValues / 10, numNext);
+  }
+}
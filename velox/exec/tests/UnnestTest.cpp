@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -403,3 +404,37 @@ TEST_F(UnnestTest, allEmptyOrNullMaps) {
            .planNode();
   assertQueryReturnsEmptyResult(op);
 }
+
+TEST_F(UnnestTest, outputBatchSize) {
+  // Large arrays are split across output batches.
+  auto vector = makeRowVector(
+      {makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+       makeArrayVector<int32_t>(
+           100,
+           [](auto row) { return row * 13 % 50; },
+           [](auto row, auto index) { return row * 100 + index; },
+           nullEvery(9)),
+       makeArrayVector<int32_t>(
+           100,
+           [](auto row) { return row % 3; },
+           [](auto row, auto index) { return row + index; })});
+  createDuckDbTable({vector});
+
+  for (auto batchSize : {1, 10, 37, 10'000}) {
+    SCOPED_TRACE(batchSize);
+    auto op = PlanBuilder()
+                  .values({vector})
+                  .unnest({"c0"}, {"c1", "c2"})
+                  .planNode();
+    auto task = AssertQueryBuilder(op, duckDbQueryRunner_)
+                    .config(
+                        core::QueryConfig::kPreferredOutputBatchSize,
+                        std::to_string(batchSize))
+                    .assertResults(
+                        "SELECT c0, UNNEST(c1), UNNEST(c2) FROM tmp");
+
+    const auto& stats = task->taskStats().pipelineStats[0].operatorStats[1];
+    EXPECT_EQ(
+        folly::divCeil(stats.outputPositions, batchSize), stats.outputVectors);
+  }
+}
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/VectorHasher.h"
 #include <gtest/gtest.h>
+#include <unordered_set>
 #include "velox/type/Type.h"
 #include "velox/vector/tests/utils/VectorMaker.h"
 
@@ -503,6 +504,40 @@ TEST_F(VectorHasherTest, dateIds) {
   EXPECT_EQ(numDistinct, VectorHasher::kRangeTooLarge);
 }
 
+TEST_F(VectorHasherTest, timestampIds) {
+  auto vector = BaseVector::create(TIMESTAMP(), 100, pool_.get());
+  auto* timestamps = vector->as<FlatVector<Timestamp>>();
+  timestamps->setNull(0, true);
+  for (auto i = 0; i < 99; ++i) {
+    timestamps->set(i + 1, Timestamp(1'600'000'000 + i / 10, i % 10));
+  }
+  auto hasher = exec::VectorHasher::create(TIMESTAMP(), 1);
+  raw_vector<uint64_t> hashes(timestamps->size());
+  SelectivityVector rows(timestamps->size());
+  hasher->decode(*vector, rows);
+  EXPECT_FALSE(hasher->computeValueIds(rows, hashes));
+  uint64_t numRange;
+  uint64_t numDistinct;
+  hasher->cardinality(0, numRange, numDistinct);
+  EXPECT_EQ(numDistinct, 100);
+
+  hasher->enableValueIds(1, 0);
+  hasher->decode(*vector, rows);
+  EXPECT_TRUE(hasher->computeValueIds(rows, hashes));
+  // Hash of null is always 0.
+  EXPECT_EQ(hashes[0], 0);
+  std::unordered_set<uint64_t> ids(hashes.begin() + 1, hashes.end());
+  EXPECT_EQ(ids.size(), 99);
+
+  // A timestamp out of the range of int64_t nanoseconds has no id.
+  timestamps->set(10, Timestamp(std::numeric_limits<int64_t>::max() / 10, 0));
+  hasher->decode(*vector, rows);
+  EXPECT_FALSE(hasher->computeValueIds(rows, hashes));
+  hasher->cardinality(0, numRange, numDistinct);
+  EXPECT_EQ(numRange, VectorHasher::kRangeTooLarge);
+  EXPECT_EQ(numDistinct, VectorHasher::kRangeTooLarge);
+}
+
 TEST_F(VectorHasherTest, boolNoNulls) {
   auto vector = BaseVector::create(BOOLEAN(), 100, pool_.get());
   auto bools = vector->as<FlatVector<bool>>();
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/WorkStealingExecutor.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class WorkStealingExecutorTest : public OperatorTestBase {};
+
+TEST_F(WorkStealingExecutorTest, runsAll) {
+  std::atomic<int32_t> count{0};
+  {
+    WorkStealingExecutor executor(4);
+    for (auto i = 0; i < 10'000; ++i) {
+      executor.add([&]() { ++count; });
+    }
+  }
+  EXPECT_EQ(10'000, count);
+}
+
+TEST_F(WorkStealingExecutorTest, localAndStolen) {
+  WorkStealingExecutor executor(4);
+  std::atomic<int32_t> numDone{0};
+  std::atomic<int32_t> numOnOtherThread{0};
+
+  // A function that re-adds itself, like a yielding Driver, keeps its thread
+  // while the other threads have nothing to steal.
+  std::thread::id firstThread;
+  uint64_t numStolenAtStart;
+  std::function<void(int32_t)> chain = [&](int32_t remaining) {
+    if (remaining == 100) {
+      // The thread woken up for the first function may take it from another
+      // queue.
+      firstThread = std::this_thread::get_id();
+      numStolenAtStart = executor.numStolen();
+    } else if (std::this_thread::get_id() != firstThread) {
+      ++numOnOtherThread;
+    }
+    if (remaining > 0) {
+      executor.add([&, remaining]() { chain(remaining - 1); });
+    } else {
+      ++numDone;
+    }
+  };
+  executor.add([&]() { chain(100); });
+  while (numDone < 1) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(0, numOnOtherThread);
+  EXPECT_EQ(numStolenAtStart, executor.numStolen());
+
+  // Slow functions added from one thread are stolen by the others.
+  executor.add([&]() {
+    for (auto i = 0; i < 100; ++i) {
+      executor.add([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++numDone;
+      });
+    }
+  });
+  while (numDone < 101) {
+    std::this_thread::yield();
+  }
+  EXPECT_LT(0, executor.numStolen());
+}
+
+TEST_F(WorkStealingExecutorTest, query) {
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  auto executor = std::make_shared<WorkStealingExecutor>(4);
+
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .values({data}, true)
+                        .project({"c0 * 2 AS c1"})
+                        .planNode();
+  params.maxDrivers = 4;
+  params.queryCtx = std::make_shared<core::QueryCtx>(executor.get());
+
+  int64_t numRows = 0;
+  {
+    TaskCursor cursor(params);
+    while (cursor.moveNext()) {
+      numRows += cursor.current()->size();
+    }
+    ASSERT_TRUE(waitForTaskCompletion(cursor.task().get()));
+  }
+  EXPECT_EQ(4'000, numRows);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// This file contains the definitions of the parsed SELECT query node extracted
+// from the duckdb-internal.hpp file. It is not possible to include
+// duckdb-internal.hpp directly because it contains an incompatible / outdated
+// copy of fmt/format.h.
+
+/*
+Copyright 2018-2022 Stichting DuckDB Foundation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "velox/external/duckdb/duckdb.hpp"
+
+namespace duckdb {
+
+using GroupingSet = set<idx_t>;
+
+class GroupByNode {
+ public:
+  //! The total set of all group expressions
+  vector<unique_ptr<ParsedExpression>> group_expressions;
+  //! The different grouping sets as they map to the group expressions
+  vector<GroupingSet> grouping_sets;
+};
+
+enum class AggregateHandling : uint8_t {
+  STANDARD_HANDLING, // standard handling as in the SELECT clause
+  NO_AGGREGATES_ALLOWED, // no aggregates allowed: any aggregates in this node
+                         // will result in an error
+  FORCE_AGGREGATES // force aggregates: any non-aggregate select list entry will
+                   // become a GROUP
+};
+
+//! SelectNode represents a standard SELECT statement
+class SelectNode : public QueryNode {
+ public:
+  SelectNode();
+
+  //! The projection list
+  vector<unique_ptr<ParsedExpression>> select_list;
+  //! The FROM clause
+  unique_ptr<TableRef> from_table;
+  //! The WHERE clause
+  unique_ptr<ParsedExpression> where_clause;
+  //! list of groups
+  GroupByNode groups;
+  //! HAVING clause
+  unique_ptr<ParsedExpression> having;
+  //! QUALIFY clause
+  unique_ptr<ParsedExpression> qualify;
+  //! Aggregate handling during binding
+  AggregateHandling aggregate_handling;
+  //! The SAMPLE clause
+  unique_ptr<SampleOptions> sample;
+
+  const vector<unique_ptr<ParsedExpression>>& GetSelectList() const override {
+    return select_list;
+  }
+
+ public:
+  //! Convert the query node to a string
+  string ToString() const override;
+
+  bool Equals(const QueryNode* other) const override;
+  //! Create a copy of this SelectNode
+  unique_ptr<QueryNode> Copy() const override;
+
+  //! Serializes a QueryNode to a stand-alone binary blob
+  void Serialize(FieldWriter& writer) const override;
+  //! Deserializes a blob back into a QueryNode
+  static unique_ptr<QueryNode> Deserialize(FieldReader& reader);
+};
+
+class ParsedExpressionIterator {
+ public:
+  static void EnumerateChildren(
+      const ParsedExpression& expression,
+      const std::function<void(const ParsedExpression& child)>& callback);
+  static void EnumerateChildren(
+      ParsedExpression& expr,
+      const std::function<void(ParsedExpression& child)>& callback);
+  static void EnumerateChildren(
+      ParsedExpression& expr,
+      const std::function<void(unique_ptr<ParsedExpression>& child)>&
+          callback);
+};
+} // namespace duckdb
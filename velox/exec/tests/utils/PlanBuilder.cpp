@@ -23,6 +23,7 @@
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/RoundRobinPartitionFunction.h"
+#include "velox/exec/ScaleWriterPartitionFunction.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/expression/SignatureBinder.h"
@@ -480,6 +481,59 @@ core::PlanNodePtr PlanBuilder::createIntermediateOrFinalAggregation(
 }
 
 namespace {
+/// Removes the DISTINCT keyword from an aggregate expression like
+/// "count(DISTINCT c0) AS cnt". Returns true if the keyword was found.
+bool stripDistinct(std::string& aggregate) {
+  static const std::string kDistinct = "distinct ";
+  auto open = aggregate.find('(');
+  if (open == std::string::npos) {
+    return false;
+  }
+  auto start = aggregate.find_first_not_of(' ', open + 1);
+  if (start == std::string::npos ||
+      aggregate.size() - start <= kDistinct.size()) {
+    return false;
+  }
+  for (auto i = 0; i < kDistinct.size(); ++i) {
+    if (std::tolower(aggregate[start + i]) != kDistinct[i]) {
+      return false;
+    }
+  }
+  aggregate.erase(open + 1, start + kDistinct.size() - open - 1);
+  return true;
+}
+
+/// Removes the ORDER BY clause from an aggregate expression like
+/// "array_agg(c0 ORDER BY c1 DESC) AS a". Returns the sorting keys, e.g.
+/// "c1 DESC", or an empty list if there is no ORDER BY clause.
+std::vector<std::string> stripOrderBy(std::string& aggregate) {
+  static const std::string kOrderBy = " order by ";
+  std::string lower = aggregate;
+  std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+  const auto start = lower.find(kOrderBy);
+  if (start == std::string::npos) {
+    return {};
+  }
+  // The clause ends at the parenthesis that closes the aggregate call.
+  auto end = start + kOrderBy.size();
+  for (auto depth = 0; end < aggregate.size(); ++end) {
+    if (aggregate[end] == '(') {
+      ++depth;
+    } else if (aggregate[end] == ')' && depth-- == 0) {
+      break;
+    }
+  }
+  VELOX_CHECK_LT(end, aggregate.size(), "Unterminated ORDER BY: {}", aggregate);
+  std::vector<std::string> keys;
+  for (auto begin = start + kOrderBy.size(); begin < end;) {
+    auto comma = std::min(aggregate.find(',', begin), end);
+    keys.push_back(aggregate.substr(begin, comma - begin));
+    begin = comma + 1;
+  }
+  aggregate.erase(start, end - start);
+  return keys;
+}
+
 /// Checks that specified plan node is a partial or intermediate aggregation or
 /// local exchange over the same. Returns a pointer to core::AggregationNode.
 const core::AggregationNode* findPartialAggregation(
@@ -543,14 +597,25 @@ PlanBuilder::createAggregateExpressionsAndNames(
   AggregateTypeResolver resolver(step);
   std::vector<std::shared_ptr<const core::CallTypedExpr>> exprs;
   std::vector<std::string> names;
+  std::vector<bool> distinct;
+  std::vector<std::vector<core::FieldAccessTypedExprPtr>> sortingKeys;
+  std::vector<std::vector<core::SortOrder>> sortingOrders;
   exprs.reserve(aggregates.size());
   names.reserve(aggregates.size());
+  distinct.reserve(aggregates.size());
+  sortingKeys.reserve(aggregates.size());
+  sortingOrders.reserve(aggregates.size());
   for (auto i = 0; i < aggregates.size(); i++) {
-    auto& agg = aggregates[i];
+    auto agg = aggregates[i];
     if (i < resultTypes.size()) {
       resolver.setResultType(resultTypes[i]);
     }
 
+    distinct.push_back(stripDistinct(agg));
+    auto [keys, orders] = parseOrderByClauses(
+        stripOrderBy(agg), planNode_->outputType(), pool_);
+    sortingKeys.push_back(std::move(keys));
+    sortingOrders.push_back(std::move(orders));
     auto untypedExpr = parse::parseExpr(agg, options_);
 
     auto expr = std::dynamic_pointer_cast<const core::CallTypedExpr>(
@@ -564,7 +629,7 @@ PlanBuilder::createAggregateExpressionsAndNames(
     }
   }
 
-  return {exprs, names};
+  return {exprs, names, distinct, sortingKeys, sortingOrders};
 }
 
 std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>
@@ -606,6 +671,9 @@ PlanBuilder& PlanBuilder::aggregation(
       aggregatesAndNames.names,
       aggregatesAndNames.expressions,
       createAggregateMasks(numAggregates, masks),
+      aggregatesAndNames.distinct,
+      aggregatesAndNames.sortingKeys,
+      aggregatesAndNames.sortingOrders,
       ignoreNullKeys,
       planNode_);
   return *this;
@@ -629,6 +697,9 @@ PlanBuilder& PlanBuilder::streamingAggregation(
       aggregatesAndNames.names,
       aggregatesAndNames.expressions,
       createAggregateMasks(numAggregates, masks),
+      aggregatesAndNames.distinct,
+      aggregatesAndNames.sortingKeys,
+      aggregatesAndNames.sortingOrders,
       ignoreNullKeys,
       planNode_);
   return *this;
@@ -715,6 +786,28 @@ PlanBuilder& PlanBuilder::topN(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::topNRowNumber(
+    const std::vector<std::string>& partitionKeys,
+    const std::vector<std::string>& sortingKeys,
+    int32_t limit,
+    bool generateRowNumber) {
+  auto [sortingFields, sortingOrders] =
+      parseOrderByClauses(sortingKeys, planNode_->outputType(), pool_);
+  std::optional<std::string> rowNumberColumnName;
+  if (generateRowNumber) {
+    rowNumberColumnName = "row_number";
+  }
+  planNode_ = std::make_shared<core::TopNRowNumberNode>(
+      nextPlanNodeId(),
+      fields(partitionKeys),
+      sortingFields,
+      sortingOrders,
+      rowNumberColumnName,
+      limit,
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::limit(int32_t offset, int32_t count, bool isPartial) {
   planNode_ = std::make_shared<core::LimitNode>(
       nextPlanNodeId(), offset, count, isPartial, planNode_);
@@ -836,6 +929,28 @@ PlanBuilder& PlanBuilder::partitionedOutput(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::partitionedOutputRebalanced(
+    const std::vector<std::string>& keys,
+    int numPartitions,
+    const std::vector<std::string>& outputLayout) {
+  auto outputType = outputLayout.empty()
+      ? planNode_->outputType()
+      : extract(planNode_->outputType(), outputLayout);
+  auto partitionFunctionFactory =
+      createPartitionFunctionFactory(planNode_->outputType(), keys);
+  planNode_ = std::make_shared<core::PartitionedOutputNode>(
+      nextPlanNodeId(),
+      exprs(keys),
+      numPartitions,
+      false,
+      false,
+      std::move(partitionFunctionFactory),
+      outputType,
+      planNode_,
+      true);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::partitionedOutputBroadcast(
     const std::vector<std::string>& outputLayout) {
   auto outputType = outputLayout.empty()
@@ -889,13 +1004,28 @@ PlanBuilder& PlanBuilder::localPartitionRoundRobin() {
   return *this;
 }
 
+PlanBuilder& PlanBuilder::localPartitionScaleWriters(
+    uint64_t minBytesPerWriter) {
+  auto partitionFunctionFactory = [minBytesPerWriter](auto numPartitions) {
+    return std::make_unique<velox::exec::ScaleWriterPartitionFunction>(
+        numPartitions, minBytesPerWriter);
+  };
+  planNode_ = std::make_shared<core::LocalPartitionNode>(
+      nextPlanNodeId(),
+      core::LocalPartitionNode::Type::kRepartition,
+      partitionFunctionFactory,
+      std::vector<core::PlanNodePtr>{planNode_});
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::hashJoin(
     const std::vector<std::string>& leftKeys,
     const std::vector<std::string>& rightKeys,
     const core::PlanNodePtr& build,
     const std::string& filter,
     const std::vector<std::string>& outputLayout,
-    core::JoinType joinType) {
+    core::JoinType joinType,
+    bool shareBuild) {
   VELOX_CHECK_EQ(leftKeys.size(), rightKeys.size());
 
   auto leftType = planNode_->outputType();
@@ -934,7 +1064,8 @@ PlanBuilder& PlanBuilder::hashJoin(
       std::move(filterExpr),
       std::move(planNode_),
       build,
-      outputType);
+      outputType,
+      shareBuild);
   return *this;
 }
 
@@ -973,11 +1104,26 @@ PlanBuilder& PlanBuilder::mergeJoin(
 PlanBuilder& PlanBuilder::crossJoin(
     const core::PlanNodePtr& right,
     const std::vector<std::string>& outputLayout) {
+  return crossJoin(right, "", outputLayout);
+}
+
+PlanBuilder& PlanBuilder::crossJoin(
+    const core::PlanNodePtr& right,
+    const std::string& filter,
+    const std::vector<std::string>& outputLayout) {
   auto resultType = concat(planNode_->outputType(), right->outputType());
+  core::TypedExprPtr filterExpr;
+  if (!filter.empty()) {
+    filterExpr = parseExpr(filter, resultType, options_, pool_);
+  }
   auto outputType = extract(resultType, outputLayout);
 
   planNode_ = std::make_shared<core::CrossJoinNode>(
-      nextPlanNodeId(), std::move(planNode_), right, outputType);
+      nextPlanNodeId(),
+      std::move(filterExpr),
+      std::move(planNode_),
+      right,
+      outputType);
   return *this;
 }
 
@@ -1226,7 +1372,8 @@ bool equalSortOrderList(
 } // namespace
 
 PlanBuilder& PlanBuilder::window(
-    const std::vector<std::string>& windowFunctions) {
+    const std::vector<std::string>& windowFunctions,
+    bool inputsSorted) {
   VELOX_CHECK_GT(
       windowFunctions.size(),
       0,
@@ -1305,6 +1452,7 @@ PlanBuilder& PlanBuilder::window(
       sortingOrders,
       windowNames,
       windowNodeFunctions,
+      inputsSorted,
       planNode_);
   return *this;
 }
@@ -359,7 +359,10 @@ class PlanBuilder {
   /// @param groupingKeys A list of grouping keys. Can be empty for global
   /// aggregations.
   /// @param aggregates A list of aggregate expressions. Must contain at least
-  /// one expression.
+  /// one expression. A single aggregation can apply an aggregate to the
+  /// distinct values of its argument, e.g. "count(DISTINCT c1)", or to the
+  /// input rows of each group in a given order, e.g.
+  /// "array_agg(c1 ORDER BY c2 DESC)".
   /// @param masks An optional list of boolean input columns to use as masks for
   /// the aggregates. Can be empty or have fewer elements than 'aggregates' or
   /// have some elements being empty strings. Non-empty elements must refer to a
@@ -530,6 +533,14 @@ class PlanBuilder {
       int numPartitions,
       const std::vector<std::string>& outputLayout = {});
 
+  /// Same as above, but spreads the rows of partitions that receive much more
+  /// data than the others over several destinations. See
+  /// PartitionedOutputNode::isRebalanceSkew().
+  PlanBuilder& partitionedOutputRebalanced(
+      const std::vector<std::string>& keys,
+      int numPartitions,
+      const std::vector<std::string>& outputLayout = {});
+
   /// Add a PartitionedOutputNode to broadcast the input data.
   ///
   /// @param outputLayout Optional output layout in case it is different then
@@ -566,6 +577,12 @@ class PlanBuilder {
   /// current plan node).
   PlanBuilder& localPartitionRoundRobin();
 
+  /// Add a LocalPartitionNode with a single source (the current plan node) to
+  /// feed scaled writers. Sends whole batches round-robin to a number of
+  /// downstream drivers that grows by one for every 'minBytesPerWriter' bytes
+  /// of input.
+  PlanBuilder& localPartitionScaleWriters(uint64_t minBytesPerWriter);
+
   /// Add a HashJoinNode to join two inputs using one or more join keys and an
   /// optional filter.
   ///
@@ -581,13 +598,16 @@ class PlanBuilder {
   /// @param outputLayout Output layout consisting of columns from probe and
   /// build sides.
   /// @param joinType Type of the join: inner, left, right, full, semi, or anti.
+  /// @param shareBuild If true, the Tasks of the query on the worker share the
+  /// hash table of the build side. See core::HashJoinNode::isShareBuild().
   PlanBuilder& hashJoin(
       const std::vector<std::string>& leftKeys,
       const std::vector<std::string>& rightKeys,
       const core::PlanNodePtr& build,
       const std::string& filter,
       const std::vector<std::string>& outputLayout,
-      core::JoinType joinType = core::JoinType::kInner);
+      core::JoinType joinType = core::JoinType::kInner,
+      bool shareBuild = false);
 
   /// Add a MergeJoinNode to join two inputs using one or more join keys and an
   /// optional filter. The caller is responsible to ensure that inputs are
@@ -615,6 +635,16 @@ class PlanBuilder {
       const core::PlanNodePtr& right,
       const std::vector<std::string>& outputLayout);
 
+  /// Same as above, but applies 'filter' to the cross product of the inputs.
+  ///
+  /// @param filter SQL expression for the filter, e.g. a range condition.
+  /// Can refer to columns from both sides of the join. Empty string means no
+  /// filter.
+  PlanBuilder& crossJoin(
+      const core::PlanNodePtr& right,
+      const std::string& filter,
+      const std::vector<std::string>& outputLayout);
+
   /// Add an UnnestNode to unnest one or more columns of type array or map.
   ///
   /// The output will contain 'replicatedColumns' followed by unnested columns,
@@ -658,7 +688,36 @@ class PlanBuilder {
   /// "row_number() over (order by b) as a"
   /// "row_number() over (partition by a order by b
   ///  rows between a + 10 preceding and 10 following)"
-  PlanBuilder& window(const std::vector<std::string>& windowFunctions);
+  PlanBuilder& window(const std::vector<std::string>& windowFunctions) {
+    return window(windowFunctions, false);
+  }
+
+  /// Same as above, but assumes the input is already sorted on the partition
+  /// keys followed by the sorting keys. Each partition is computed as soon as
+  /// the first row of the next partition arrives and only one partition is
+  /// kept in memory. The caller is responsible that input data is indeed
+  /// sorted. If that's not the case, the query may return incorrect results.
+  PlanBuilder& streamingWindow(
+      const std::vector<std::string>& windowFunctions) {
+    return window(windowFunctions, true);
+  }
+
+  /// Add a TopNRowNumberNode which keeps the first 'limit' rows of each
+  /// partition in the order of the sorting keys. Equivalent to a window with
+  /// "row_number() over (partition by <partitionKeys> order by <sortingKeys>)"
+  /// followed by a filter on the row number being at most 'limit'.
+  ///
+  /// For example,
+  ///
+  ///     .topNRowNumber({"a"}, {"b DESC", "c ASC NULLS FIRST"}, 3, true)
+  ///
+  /// @param generateRowNumber If true, the row number of each row in its
+  /// partition is output in the "row_number" column.
+  PlanBuilder& topNRowNumber(
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      int32_t limit,
+      bool generateRowNumber);
 
   /// Stores the latest plan node ID into the specified variable. Useful for
   /// capturing IDs of the leaf plan nodes (table scans, exchanges, etc.) to use
@@ -750,6 +809,11 @@ class PlanBuilder {
   struct ExpressionsAndNames {
     std::vector<std::shared_ptr<const core::CallTypedExpr>> expressions;
     std::vector<std::string> names;
+    // True for the aggregates written as name(DISTINCT arg).
+    std::vector<bool> distinct;
+    // The keys in name(args ORDER BY keys) for each aggregate.
+    std::vector<std::vector<core::FieldAccessTypedExprPtr>> sortingKeys;
+    std::vector<std::vector<core::SortOrder>> sortingOrders;
   };
 
   ExpressionsAndNames createAggregateExpressionsAndNames(
@@ -762,6 +826,10 @@ class PlanBuilder {
       size_t numAggregates,
       const std::vector<std::string>& masks);
 
+  PlanBuilder& window(
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted);
+
  protected:
   core::PlanNodePtr planNode_;
   parse::ParseOptions options_;
@@ -0,0 +1,987 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/tests/utils/SqlQueryBuilder.h"
+
+#include <folly/String.h>
+
+#include "velox/common/base/Fs.h"
+#include "velox/dwio/common/ReaderFactory.h"
+#include "velox/exec/Aggregate.h"
+#include "velox/exec/tests/utils/DuckSelectNode.h"
+#include "velox/expression/ExprToSubfieldFilter.h"
+#include "velox/parse/Expressions.h"
+#include "velox/parse/ExpressionsParser.h"
+
+namespace facebook::velox::exec::test {
+
+namespace {
+using ::duckdb::ExpressionClass;
+using ::duckdb::ParsedExpression;
+using ExprPtr = std::unique_ptr<ParsedExpression>;
+
+// Calls 'func' on 'expr' and on its children, recursively.
+void visit(
+    const ParsedExpression& expr,
+    const std::function<void(const ParsedExpression&)>& func) {
+  func(expr);
+  ::duckdb::ParsedExpressionIterator::EnumerateChildren(
+      expr, [&](const ParsedExpression& child) { visit(child, func); });
+}
+
+// Calls 'func' on 'expr' and, unless 'func' returns true, on the children of
+// 'expr', recursively. 'func' may replace the expression it is given.
+void rewrite(ExprPtr& expr, const std::function<bool(ExprPtr&)>& func) {
+  if (func(expr)) {
+    return;
+  }
+  ::duckdb::ParsedExpressionIterator::EnumerateChildren(
+      *expr, [&](ExprPtr& child) { rewrite(child, func); });
+}
+
+bool isColumn(const ParsedExpression& expr) {
+  return expr.GetExpressionClass() == ExpressionClass::COLUMN_REF;
+}
+
+const std::string& columnName(const ParsedExpression& expr) {
+  return static_cast<const ::duckdb::ColumnRefExpression&>(expr)
+      .GetColumnName();
+}
+
+ExprPtr makeColumn(const std::string& name) {
+  return std::make_unique<::duckdb::ColumnRefExpression>(name);
+}
+
+// Returns the value of an integer literal, e.g. the 1 of ORDER BY 1 or of
+// LIMIT 1.
+std::optional<int64_t> toInteger(const ParsedExpression& expr) {
+  if (expr.GetExpressionClass() != ExpressionClass::CONSTANT) {
+    return std::nullopt;
+  }
+  const auto& value =
+      static_cast<const ::duckdb::ConstantExpression&>(expr).value;
+  if (!value.type().IsIntegral()) {
+    return std::nullopt;
+  }
+  return value.GetValue<int64_t>();
+}
+
+int32_t toCount(const ParsedExpression& expr) {
+  auto value = toInteger(expr);
+  VELOX_USER_CHECK(
+      value.has_value() && value.value() >= 0 &&
+          value.value() <= std::numeric_limits<int32_t>::max(),
+      "LIMIT and OFFSET must be non-negative integer literals: {}",
+      expr.ToString());
+  return value.value();
+}
+
+bool isAggregate(const ParsedExpression& expr) {
+  if (expr.GetExpressionClass() != ExpressionClass::FUNCTION) {
+    return false;
+  }
+  const auto& name =
+      static_cast<const ::duckdb::FunctionExpression&>(expr).function_name;
+  return name == "count_star" || aggregateFunctions().count(name) > 0;
+}
+
+bool hasAggregate(const ParsedExpression& expr) {
+  bool found = false;
+  visit(expr, [&](const ParsedExpression& child) {
+    found |= isAggregate(child);
+  });
+  return found;
+}
+
+std::string toSql(
+    const ParsedExpression& expr,
+    const std::optional<std::string>& name = std::nullopt) {
+  auto sql = expr.ToString();
+  if (!name.has_value() || (isColumn(expr) && columnName(expr) == name)) {
+    return sql;
+  }
+  return fmt::format("{} AS {}", sql, name.value());
+}
+
+std::string conjunction(const std::vector<std::string>& conjuncts) {
+  std::string result;
+  for (const auto& conjunct : conjuncts) {
+    if (!result.empty()) {
+      result += " AND ";
+    }
+    result += fmt::format("({})", conjunct);
+  }
+  return result;
+}
+
+// Translates one parsed SELECT into a plan. The translation is a single pass
+// over the clauses of the query in the order in which they are evaluated.
+class QueryTranslator {
+ public:
+  QueryTranslator(
+      const std::unordered_map<std::string, TpchTableMetadata>& tableMetadata,
+      dwio::common::FileFormat format,
+      memory::MemoryPool* pool)
+      : tableMetadata_(tableMetadata), pool_(pool) {
+    plan_.dataFileFormat = format;
+  }
+
+  SqlPlan translate(::duckdb::SelectNode& query);
+
+ private:
+  struct Table {
+    std::string name;
+    const TpchTableMetadata* metadata;
+    // The columns read from the table, in the order of the table's columns.
+    std::vector<std::string> columns;
+    std::vector<std::string> subfieldFilters;
+    std::vector<std::string> remainingFilters;
+    // The columns with a subfield filter. A column can have one.
+    std::unordered_set<std::string> filteredColumns;
+  };
+
+  // An equality between the columns of two tables.
+  struct JoinEdge {
+    std::string leftColumn;
+    std::string rightColumn;
+    int32_t leftTable;
+    int32_t rightTable;
+  };
+
+  // A condition evaluated after the tables in 'tables' are joined.
+  struct Residual {
+    std::string sql;
+    std::set<int32_t> tables;
+  };
+
+  // Adds the tables of 'ref' to 'tables_' and the conditions of its joins to
+  // 'conjuncts_'.
+  void addTables(::duckdb::TableRef& ref);
+
+  // Adds the conjuncts of 'expr' to 'conjuncts_'.
+  void addConjuncts(ExprPtr expr);
+
+  // Calls 'func' on all the expressions of 'query' and 'conjuncts_'.
+  void forEachExpression(
+      ::duckdb::SelectNode& query,
+      const std::function<void(ExprPtr&)>& func);
+
+  std::set<int32_t> tablesOf(const ParsedExpression& expr) const;
+
+  // Sorts 'conjuncts_' into scan filters, join edges and residuals.
+  void classifyConjuncts();
+
+  // Adds 'sql' to the filters of the scan of 'table'.
+  void addScanFilter(Table& table, const std::string& sql);
+
+  PlanBuilder scan(int32_t table);
+
+  // Returns the scans of the tables joined in the order of FROM.
+  PlanBuilder joinTables();
+
+  // Returns the residuals that can be evaluated on 'tables' and removes them
+  // from 'residuals_'.
+  std::string takeResiduals(const std::set<int32_t>& tables);
+
+  // Sets the names of the output columns and the sorting keys, DISTINCT,
+  // LIMIT and OFFSET of 'query'. The ORDER BY expressions that are not in the
+  // select list are moved to 'orderItems_'.
+  void resolveOutput(::duckdb::SelectNode& query);
+
+  // Adds the aggregation of 'query' to 'builder_' and rewrites the select
+  // list, HAVING and 'orderItems_' to use the aggregation's output.
+  void aggregate(::duckdb::SelectNode& query);
+
+  // Replaces the grouping keys and aggregates in 'expr' with the output
+  // columns of the aggregation.
+  void rewriteAggregates(ExprPtr& expr);
+
+  // Returns the name of the output column of 'call' in the aggregation and
+  // adds the aggregate and the projections of its inputs if new.
+  std::string addAggregate(const ::duckdb::FunctionExpression& call);
+
+  // Adds the projection of 'sql' as 'name' below the aggregation unless
+  // already added.
+  void addPreProjection(
+      const std::string& name,
+      const std::optional<std::string>& sql = std::nullopt);
+
+  // Adds window nodes for the window functions of the select list and
+  // 'orderItems_' and replaces these with the output columns of the windows.
+  void addWindows(::duckdb::SelectNode& query);
+
+  // Adds the select list, DISTINCT, ORDER BY and LIMIT of 'query'.
+  void addOutput(::duckdb::SelectNode& query);
+
+  const std::unordered_map<std::string, TpchTableMetadata>& tableMetadata_;
+  memory::MemoryPool* const pool_;
+  const std::shared_ptr<core::PlanNodeIdGenerator> planNodeIdGenerator_{
+      std::make_shared<core::PlanNodeIdGenerator>()};
+  SqlPlan plan_;
+  PlanBuilder builder_{planNodeIdGenerator_};
+
+  std::vector<Table> tables_;
+  std::unordered_map<std::string, int32_t> columnToTable_;
+  std::vector<ExprPtr> conjuncts_;
+  std::vector<JoinEdge> joinEdges_;
+  std::vector<Residual> residuals_;
+
+  // The output columns of 'builder_'.
+  std::vector<std::string> columns_;
+
+  // The output column names of the select list.
+  std::vector<std::string> outputNames_;
+
+  // The ORDER BY expressions that are not in the select list and their
+  // output column names. These are projected out after ORDER BY.
+  std::vector<ExprPtr> orderItems_;
+  std::vector<std::string> orderNames_;
+
+  std::vector<std::string> sortingKeys_;
+  bool distinct_{false};
+  std::optional<int32_t> limit_;
+  int32_t offset_{0};
+
+  // The grouping keys, aggregates and the projections below the aggregation.
+  std::unordered_map<std::string, std::string> groupingKeyNames_;
+  std::unordered_map<std::string, std::string> aggregateNames_;
+  std::vector<std::string> aggregates_;
+  std::vector<std::string> aggregateColumns_;
+  std::vector<std::string> preProjections_;
+  std::unordered_set<std::string> preProjectedNames_;
+  bool isAggregation_{false};
+};
+
+SqlPlan QueryTranslator::translate(::duckdb::SelectNode& query) {
+  VELOX_USER_CHECK(
+      query.cte_map.map.empty(), "Common table expressions are not supported");
+  VELOX_USER_CHECK_NULL(query.qualify, "QUALIFY is not supported");
+  VELOX_USER_CHECK_NULL(query.sample, "SAMPLE is not supported");
+  VELOX_USER_CHECK_NOT_NULL(query.from_table, "SELECT needs a FROM clause");
+  VELOX_USER_CHECK(
+      query.groups.grouping_sets.size() <= 1,
+      "Grouping sets are not supported");
+
+  addTables(*query.from_table);
+  addConjuncts(std::move(query.where_clause));
+
+  forEachExpression(query, [](ExprPtr& expr) {
+    rewrite(expr, [](ExprPtr& child) {
+      VELOX_USER_CHECK(
+          child->GetExpressionClass() != ExpressionClass::SUBQUERY,
+          "Subqueries are not supported");
+      if (isColumn(*child)) {
+        // Column names are unique across the tables of the query.
+        auto& names =
+            static_cast<::duckdb::ColumnRefExpression&>(*child).column_names;
+        names = {names.back()};
+      }
+      return false;
+    });
+  });
+
+  // Expands * in the select list.
+  std::vector<ExprPtr> selectList;
+  for (auto& item : query.select_list) {
+    if (item->GetExpressionClass() != ExpressionClass::STAR) {
+      selectList.push_back(std::move(item));
+      continue;
+    }
+    const auto& star = static_cast<::duckdb::StarExpression&>(*item);
+    VELOX_USER_CHECK(
+        star.relation_name.empty() && star.exclude_list.empty() &&
+            star.replace_list.empty(),
+        "Only a plain * is supported: {}",
+        star.ToString());
+    for (const auto& table : tables_) {
+      for (const auto& name : table.metadata->type->names()) {
+        selectList.push_back(makeColumn(name));
+      }
+    }
+  }
+  query.select_list = std::move(selectList);
+
+  // Reads the columns used anywhere in the query. Names that are not columns
+  // of the tables are aliases of the select list.
+  std::unordered_set<std::string> usedColumns;
+  forEachExpression(query, [&](ExprPtr& expr) {
+    visit(*expr, [&](const ParsedExpression& child) {
+      if (isColumn(child)) {
+        usedColumns.insert(columnName(child));
+      }
+    });
+  });
+  for (auto& table : tables_) {
+    for (const auto& name : table.metadata->type->names()) {
+      if (usedColumns.count(name)) {
+        table.columns.push_back(name);
+      }
+    }
+    if (table.columns.empty()) {
+      // A scan needs a column, e.g. for SELECT count(*).
+      table.columns.push_back(table.metadata->type->nameOf(0));
+    }
+  }
+
+  classifyConjuncts();
+  builder_ = joinTables();
+  resolveOutput(query);
+
+  isAggregation_ = !query.groups.group_expressions.empty() ||
+      (query.having && hasAggregate(*query.having));
+  for (const auto& item : query.select_list) {
+    isAggregation_ |= hasAggregate(*item);
+  }
+  if (isAggregation_) {
+    aggregate(query);
+  } else {
+    VELOX_USER_CHECK_NULL(query.having, "HAVING needs an aggregation");
+  }
+  addWindows(query);
+  addOutput(query);
+
+  plan_.plan = builder_.planNode();
+  return std::move(plan_);
+}
+
+void QueryTranslator::addTables(::duckdb::TableRef& ref) {
+  switch (ref.type) {
+    case ::duckdb::TableReferenceType::BASE_TABLE: {
+      const auto& name =
+          static_cast<const ::duckdb::BaseTableRef&>(ref).table_name;
+      auto it = tableMetadata_.find(name);
+      VELOX_USER_CHECK(it != tableMetadata_.end(), "Table not found: {}", name);
+      const int32_t index = tables_.size();
+      for (const auto& column : it->second.type->names()) {
+        VELOX_USER_CHECK(
+            columnToTable_.emplace(column, index).second,
+            "Column {} of table {} is also in table {}",
+            column,
+            name,
+            tables_[columnToTable_[column]].name);
+      }
+      tables_.push_back({name, &it->second});
+      break;
+    }
+    case ::duckdb::TableReferenceType::CROSS_PRODUCT: {
+      auto& crossProduct = static_cast<::duckdb::CrossProductRef&>(ref);
+      addTables(*crossProduct.left);
+      addTables(*crossProduct.right);
+      break;
+    }
+    case ::duckdb::TableReferenceType::JOIN: {
+      auto& join = static_cast<::duckdb::JoinRef&>(ref);
+      VELOX_USER_CHECK(
+          join.type == ::duckdb::JoinType::INNER && !join.is_natural &&
+              join.using_columns.empty(),
+          "Only inner joins with ON are supported: {}",
+          join.ToString());
+      addTables(*join.left);
+      addTables(*join.right);
+      addConjuncts(std::move(join.condition));
+      break;
+    }
+    default:
+      VELOX_UNSUPPORTED("Unsupported FROM clause: {}", ref.ToString());
+  }
+}
+
+void QueryTranslator::addConjuncts(ExprPtr expr) {
+  if (!expr) {
+    return;
+  }
+  if (expr->GetExpressionType() == ::duckdb::ExpressionType::CONJUNCTION_AND) {
+    for (auto& child :
+         static_cast<::duckdb::ConjunctionExpression&>(*expr).children) {
+      addConjuncts(std::move(child));
+    }
+    return;
+  }
+  conjuncts_.push_back(std::move(expr));
+}
+
+void QueryTranslator::forEachExpression(
+    ::duckdb::SelectNode& query,
+    const std::function<void(ExprPtr&)>& func) {
+  for (auto& conjunct : conjuncts_) {
+    func(conjunct);
+  }
+  for (auto& item : query.select_list) {
+    func(item);
+  }
+  for (auto& key : query.groups.group_expressions) {
+    func(key);
+  }
+  if (query.having) {
+    func(query.having);
+  }
+  for (auto& modifier : query.modifiers) {
+    if (modifier->type == ::duckdb::ResultModifierType::ORDER_MODIFIER) {
+      for (auto& order :
+           static_cast<::duckdb::OrderModifier&>(*modifier).orders) {
+        func(order.expression);
+      }
+    }
+  }
+}
+
+std::set<int32_t> QueryTranslator::tablesOf(
+    const ParsedExpression& expr) const {
+  std::set<int32_t> tables;
+  visit(expr, [&](const ParsedExpression& child) {
+    if (isColumn(child)) {
+      auto it = columnToTable_.find(columnName(child));
+      VELOX_USER_CHECK(
+          it != columnToTable_.end(), "Column not found: {}", child.ToString());
+      tables.insert(it->second);
+    }
+  });
+  return tables;
+}
+
+void QueryTranslator::classifyConjuncts() {
+  for (const auto& conjunct : conjuncts_) {
+    const auto tables = tablesOf(*conjunct);
+    if (tables.size() == 1) {
+      addScanFilter(tables_[*tables.begin()], conjunct->ToString());
+      continue;
+    }
+    if (tables.size() == 2 &&
+        conjunct->GetExpressionType() ==
+            ::duckdb::ExpressionType::COMPARE_EQUAL) {
+      const auto& comparison =
+          static_cast<const ::duckdb::ComparisonExpression&>(*conjunct);
+      if (isColumn(*comparison.left) && isColumn(*comparison.right)) {
+        const auto& left = columnName(*comparison.left);
+        const auto& right = columnName(*comparison.right);
+        joinEdges_.push_back(
+            {left, right, columnToTable_.at(left), columnToTable_.at(right)});
+        continue;
+      }
+    }
+    residuals_.push_back({conjunct->ToString(), tables});
+  }
+}
+
+void QueryTranslator::addScanFilter(Table& table, const std::string& sql) {
+  // Filters on a single column that the reader can evaluate are pushed into
+  // the reader. Others are evaluated on the rows read.
+  try {
+    auto expr = core::Expressions::inferTypes(
+        parse::parseExpr(sql, {}), table.metadata->type, pool_);
+    auto subfield = exec::toSubfieldFilter(expr).first.toString();
+    if (table.filteredColumns.insert(subfield).second) {
+      table.subfieldFilters.push_back(sql);
+      return;
+    }
+  } catch (const VeloxException&) {
+  }
+  table.remainingFilters.push_back(sql);
+}
+
+PlanBuilder QueryTranslator::scan(int32_t table) {
+  const auto& info = tables_[table];
+  std::vector<TypePtr> types;
+  for (const auto& column : info.columns) {
+    types.push_back(info.metadata->type->findChild(column));
+  }
+  core::PlanNodeId scanId;
+  auto builder = PlanBuilder(planNodeIdGenerator_)
+                     .tableScan(
+                         info.name,
+                         ROW(std::vector<std::string>(info.columns),
+                             std::move(types)),
+                         {},
+                         info.subfieldFilters,
+                         conjunction(info.remainingFilters))
+                     .capturePlanNodeId(scanId);
+  plan_.dataFiles[scanId] = info.metadata->dataFiles;
+  return builder;
+}
+
+PlanBuilder QueryTranslator::joinTables() {
+  auto builder = scan(0);
+  std::set<int32_t> joined = {0};
+  columns_ = tables_[0].columns;
+  while (joined.size() < tables_.size()) {
+    // The first table in FROM that has an equality with the tables joined so
+    // far, or the first table not joined if there is none.
+    std::optional<int32_t> next;
+    for (auto i = 0; i < tables_.size() && !next.has_value(); ++i) {
+      if (joined.count(i)) {
+        continue;
+      }
+      for (const auto& edge : joinEdges_) {
+        if ((edge.leftTable == i && joined.count(edge.rightTable)) ||
+            (edge.rightTable == i && joined.count(edge.leftTable))) {
+          next = i;
+          break;
+        }
+      }
+    }
+    const bool isCrossJoin = !next.has_value();
+    int32_t table = next.value_or(0);
+    while (isCrossJoin && joined.count(table)) {
+      ++table;
+    }
+
+    std::vector<std::string> leftKeys;
+    std::vector<std::string> rightKeys;
+    for (const auto& edge : joinEdges_) {
+      if (edge.leftTable == table && joined.count(edge.rightTable)) {
+        leftKeys.push_back(edge.rightColumn);
+        rightKeys.push_back(edge.leftColumn);
+      } else if (edge.rightTable == table && joined.count(edge.leftTable)) {
+        leftKeys.push_back(edge.leftColumn);
+        rightKeys.push_back(edge.rightColumn);
+      }
+    }
+    joined.insert(table);
+    columns_.insert(
+        columns_.end(),
+        tables_[table].columns.begin(),
+        tables_[table].columns.end());
+    const auto filter = takeResiduals(joined);
+    if (isCrossJoin) {
+      builder.crossJoin(scan(table).planNode(), filter, columns_);
+    } else {
+      builder.hashJoin(
+          leftKeys, rightKeys, scan(table).planNode(), filter, columns_);
+    }
+  }
+  const auto filter = takeResiduals(joined);
+  if (!filter.empty()) {
+    builder.filter(filter);
+  }
+  return builder;
+}
+
+std::string QueryTranslator::takeResiduals(const std::set<int32_t>& tables) {
+  std::vector<std::string> conjuncts;
+  auto it = residuals_.begin();
+  while (it != residuals_.end()) {
+    if (std::includes(
+            tables.begin(),
+            tables.end(),
+            it->tables.begin(),
+            it->tables.end())) {
+      conjuncts.push_back(it->sql);
+      it = residuals_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return conjunction(conjuncts);
+}
+
+void QueryTranslator::aggregate(::duckdb::SelectNode& query) {
+  std::vector<std::string> groupingKeys;
+  for (auto i = 0; i < query.groups.group_expressions.size(); ++i) {
+    auto& key = query.groups.group_expressions[i];
+    // GROUP BY 1 and GROUP BY alias refer to the select list.
+    if (auto position = toInteger(*key)) {
+      VELOX_USER_CHECK(
+          position.value() >= 1 &&
+              position.value() <= query.select_list.size(),
+          "GROUP BY position is not in the select list: {}",
+          position.value());
+      key = query.select_list[position.value() - 1]->Copy();
+    } else if (isColumn(*key) && !columnToTable_.count(columnName(*key))) {
+      for (const auto& item : query.select_list) {
+        if (item->alias == columnName(*key)) {
+          key = item->Copy();
+          break;
+        }
+      }
+    }
+    const auto sql = key->ToString();
+    if (groupingKeyNames_.count(sql)) {
+      continue;
+    }
+    std::string name;
+    if (isColumn(*key)) {
+      name = columnName(*key);
+      addPreProjection(name);
+    } else {
+      name = fmt::format("_g{}", i);
+      addPreProjection(name, sql);
+    }
+    groupingKeyNames_[sql] = name;
+    groupingKeys.push_back(name);
+  }
+
+  for (auto& item : query.select_list) {
+    rewriteAggregates(item);
+  }
+  for (auto& item : orderItems_) {
+    rewriteAggregates(item);
+  }
+  if (query.having) {
+    rewriteAggregates(query.having);
+  }
+
+  if (!preProjections_.empty()) {
+    builder_.project(preProjections_);
+  }
+  builder_.partialAggregation(groupingKeys, aggregates_)
+      .localPartition(groupingKeys)
+      .finalAggregation();
+  if (query.having) {
+    builder_.filter(query.having->ToString());
+  }
+  columns_ = std::move(groupingKeys);
+  columns_.insert(
+      columns_.end(), aggregateColumns_.begin(), aggregateColumns_.end());
+}
+
+void QueryTranslator::rewriteAggregates(ExprPtr& expr) {
+  rewrite(expr, [&](ExprPtr& child) {
+    auto it = groupingKeyNames_.find(child->ToString());
+    if (it != groupingKeyNames_.end()) {
+      child = makeColumn(it->second);
+      return true;
+    }
+    if (isAggregate(*child)) {
+      child = makeColumn(addAggregate(
+          static_cast<const ::duckdb::FunctionExpression&>(*child)));
+      return true;
+    }
+    VELOX_USER_CHECK(
+        !isColumn(*child),
+        "Column {} must be in GROUP BY or in an aggregate",
+        child->ToString());
+    return false;
+  });
+}
+
+std::string QueryTranslator::addAggregate(
+    const ::duckdb::FunctionExpression& call) {
+  const auto sql = call.ToString();
+  auto it = aggregateNames_.find(sql);
+  if (it != aggregateNames_.end()) {
+    return it->second;
+  }
+  VELOX_USER_CHECK(
+      !call.distinct, "DISTINCT aggregates are not supported: {}", sql);
+  VELOX_USER_CHECK(
+      !call.filter && (!call.order_bys || call.order_bys->orders.empty()),
+      "FILTER and ORDER BY of aggregates are not supported: {}",
+      sql);
+  std::vector<std::string> inputs;
+  for (const auto& arg : call.children) {
+    VELOX_USER_CHECK(
+        !hasAggregate(*arg), "Nested aggregates are not supported: {}", sql);
+    if (isColumn(*arg)) {
+      addPreProjection(columnName(*arg));
+      inputs.push_back(columnName(*arg));
+    } else if (arg->GetExpressionClass() == ExpressionClass::CONSTANT) {
+      inputs.push_back(arg->ToString());
+    } else {
+      const auto name = fmt::format("_p{}", preProjections_.size());
+      addPreProjection(name, arg->ToString());
+      inputs.push_back(name);
+    }
+  }
+  const auto name = fmt::format("_a{}", aggregates_.size());
+  aggregates_.push_back(fmt::format(
+      "{}({}) AS {}",
+      call.function_name == "count_star" ? "count" : call.function_name,
+      folly::join(", ", inputs),
+      name));
+  aggregateColumns_.push_back(name);
+  aggregateNames_[sql] = name;
+  return name;
+}
+
+void QueryTranslator::addPreProjection(
+    const std::string& name,
+    const std::optional<std::string>& sql) {
+  if (preProjectedNames_.insert(name).second) {
+    preProjections_.push_back(
+        sql.has_value() ? fmt::format("{} AS {}", sql.value(), name) : name);
+  }
+}
+
+void QueryTranslator::resolveOutput(::duckdb::SelectNode& query) {
+  std::unordered_set<std::string> usedNames;
+  for (auto i = 0; i < query.select_list.size(); ++i) {
+    const auto& item = *query.select_list[i];
+    auto name = !item.alias.empty() ? item.alias
+        : isColumn(item)            ? columnName(item)
+                                    : fmt::format("_col{}", i);
+    if (!usedNames.insert(name).second) {
+      name = fmt::format("_col{}", i);
+    }
+    outputNames_.push_back(name);
+  }
+
+  for (auto& modifier : query.modifiers) {
+    switch (modifier->type) {
+      case ::duckdb::ResultModifierType::DISTINCT_MODIFIER:
+        VELOX_USER_CHECK(
+            static_cast<::duckdb::DistinctModifier&>(*modifier)
+                .distinct_on_targets.empty(),
+            "DISTINCT ON is not supported");
+        distinct_ = true;
+        break;
+      case ::duckdb::ResultModifierType::ORDER_MODIFIER:
+        for (auto& order :
+             static_cast<::duckdb::OrderModifier&>(*modifier).orders) {
+          // ORDER BY 1, ORDER BY alias and ORDER BY an expression of the
+          // select list use the output column.
+          std::optional<std::string> name;
+          if (auto position = toInteger(*order.expression)) {
+            VELOX_USER_CHECK(
+                position.value() >= 1 &&
+                    position.value() <= outputNames_.size(),
+                "ORDER BY position is not in the select list: {}",
+                position.value());
+            name = outputNames_[position.value() - 1];
+          } else {
+            const auto sql = order.expression->ToString();
+            for (auto i = 0; i < outputNames_.size() && !name; ++i) {
+              if ((isColumn(*order.expression) &&
+                   columnName(*order.expression) == outputNames_[i]) ||
+                  query.select_list[i]->ToString() == sql) {
+                name = outputNames_[i];
+              }
+            }
+          }
+          if (!name.has_value()) {
+            name = fmt::format("_o{}", orderItems_.size());
+            orderItems_.push_back(std::move(order.expression));
+            orderNames_.push_back(name.value());
+          }
+          auto key = name.value();
+          if (order.type == ::duckdb::OrderType::DESCENDING) {
+            key += " DESC";
+          }
+          if (order.null_order == ::duckdb::OrderByNullType::NULLS_FIRST) {
+            key += " NULLS FIRST";
+          } else if (
+              order.null_order == ::duckdb::OrderByNullType::NULLS_LAST) {
+            key += " NULLS LAST";
+          }
+          sortingKeys_.push_back(key);
+        }
+        break;
+      case ::duckdb::ResultModifierType::LIMIT_MODIFIER: {
+        const auto& limit = static_cast<::duckdb::LimitModifier&>(*modifier);
+        if (limit.limit) {
+          limit_ = toCount(*limit.limit);
+        }
+        if (limit.offset) {
+          offset_ = toCount(*limit.offset);
+        }
+        break;
+      }
+      default:
+        VELOX_UNSUPPORTED("Unsupported result modifier");
+    }
+  }
+  VELOX_USER_CHECK(
+      !distinct_ || orderItems_.empty(),
+      "ORDER BY of SELECT DISTINCT must use columns of the select list");
+}
+
+void QueryTranslator::addWindows(::duckdb::SelectNode& query) {
+  // The window functions by their PARTITION BY keys. The rows are partitioned
+  // on these keys before each window node.
+  std::vector<std::pair<std::vector<std::string>, std::vector<std::string>>>
+      windows;
+  std::vector<std::string> projections;
+  std::vector<std::string> projectedNames;
+  auto toColumn = [&](ExprPtr& expr) {
+    if (isColumn(*expr) ||
+        expr->GetExpressionClass() == ExpressionClass::CONSTANT) {
+      return;
+    }
+    const auto name = fmt::format("_x{}", projections.size());
+    projections.push_back(toSql(*expr, name));
+    projectedNames.push_back(name);
+    expr = makeColumn(name);
+  };
+  int32_t numWindows = 0;
+  auto rewriteWindows = [&](ExprPtr& expr) {
+    rewrite(expr, [&](ExprPtr& child) {
+      if (child->GetExpressionClass() != ExpressionClass::WINDOW) {
+        return false;
+      }
+      auto& window = static_cast<::duckdb::WindowExpression&>(*child);
+      for (auto& arg : window.children) {
+        toColumn(arg);
+      }
+      std::vector<std::string> partitionKeys;
+      for (auto& key : window.partitions) {
+        toColumn(key);
+        VELOX_USER_CHECK(
+            isColumn(*key),
+            "PARTITION BY keys must not be constants: {}",
+            key->ToString());
+        partitionKeys.push_back(columnName(*key));
+      }
+      for (auto& order : window.orders) {
+        toColumn(order.expression);
+      }
+      const auto name = fmt::format("_w{}", numWindows++);
+      auto it = std::find_if(windows.begin(), windows.end(), [&](auto& entry) {
+        return entry.first == partitionKeys;
+      });
+      if (it == windows.end()) {
+        windows.push_back({partitionKeys, {}});
+        it = windows.end() - 1;
+      }
+      it->second.push_back(toSql(window, name));
+      child = makeColumn(name);
+      return true;
+    });
+  };
+  for (auto& item : query.select_list) {
+    const auto alias = item->alias;
+    rewriteWindows(item);
+    item->alias = alias;
+  }
+  for (auto& item : orderItems_) {
+    rewriteWindows(item);
+  }
+  if (windows.empty()) {
+    return;
+  }
+
+  if (!projections.empty()) {
+    auto inputs = columns_;
+    inputs.insert(inputs.end(), projections.begin(), projections.end());
+    builder_.project(inputs);
+    columns_.insert(
+        columns_.end(), projectedNames.begin(), projectedNames.end());
+  }
+  for (const auto& [partitionKeys, functions] : windows) {
+    builder_.localPartition(partitionKeys).window(functions);
+  }
+}
+
+void QueryTranslator::addOutput(::duckdb::SelectNode& query) {
+  std::vector<std::string> projections;
+  for (auto i = 0; i < query.select_list.size(); ++i) {
+    projections.push_back(toSql(*query.select_list[i], outputNames_[i]));
+  }
+  for (auto i = 0; i < orderItems_.size(); ++i) {
+    projections.push_back(toSql(*orderItems_[i], orderNames_[i]));
+  }
+  builder_.project(projections);
+
+  if (distinct_) {
+    builder_.partialAggregation(outputNames_, {})
+        .localPartition(outputNames_)
+        .finalAggregation();
+  }
+
+  // Each driver sorts or limits its rows before the rows of all drivers are
+  // merged and limited.
+  const auto count = limit_.value_or(std::numeric_limits<int32_t>::max());
+  const int32_t partialCount = std::min<int64_t>(
+      static_cast<int64_t>(offset_) + count,
+      std::numeric_limits<int32_t>::max());
+  const bool hasLimit = limit_.has_value() || offset_ > 0;
+  if (!sortingKeys_.empty()) {
+    if (limit_.has_value()) {
+      builder_.topN(sortingKeys_, partialCount, true);
+    } else {
+      builder_.orderBy(sortingKeys_, true);
+    }
+    builder_ = PlanBuilder(planNodeIdGenerator_)
+                   .localMerge(sortingKeys_, {builder_.planNode()});
+    if (hasLimit) {
+      builder_.limit(offset_, count, false);
+    }
+  } else if (hasLimit) {
+    if (limit_.has_value()) {
+      builder_.limit(0, partialCount, true);
+    }
+    builder_.localPartition({}).limit(offset_, count, false);
+  }
+
+  if (!orderItems_.empty()) {
+    builder_.project(outputNames_);
+  }
+}
+} // namespace
+
+void SqlQueryBuilder::initialize(const std::string& dataPath) {
+  for (auto const& tableEntry : fs::directory_iterator{dataPath}) {
+    if (!tableEntry.is_directory()) {
+      continue;
+    }
+    std::vector<std::string> dataFiles;
+    for (auto const& dirEntry : fs::directory_iterator{tableEntry.path()}) {
+      // Ignore hidden files.
+      if (!dirEntry.is_regular_file() ||
+          dirEntry.path().filename().c_str()[0] == '.') {
+        continue;
+      }
+      dataFiles.push_back(dirEntry.path());
+    }
+    if (!dataFiles.empty()) {
+      std::sort(dataFiles.begin(), dataFiles.end());
+      addTable(tableEntry.path().filename(), dataFiles);
+    }
+  }
+}
+
+void SqlQueryBuilder::addTable(
+    const std::string& tableName,
+    const std::vector<std::string>& dataFiles) {
+  VELOX_CHECK(!dataFiles.empty(), "Table {} has no files", tableName);
+  dwio::common::ReaderOptions readerOptions;
+  readerOptions.setFileFormat(format_);
+  auto input = std::make_unique<dwio::common::BufferedInput>(
+      std::make_shared<LocalReadFile>(dataFiles[0]),
+      readerOptions.getMemoryPool());
+  auto reader = dwio::common::getReaderFactory(readerOptions.getFileFormat())
+                    ->createReader(std::move(input), readerOptions);
+  auto& metadata = tableMetadata_[tableName];
+  metadata.type = reader->rowType();
+  metadata.dataFiles = dataFiles;
+}
+
+SqlPlan SqlQueryBuilder::getQueryPlan(const std::string& sql) const {
+  ::duckdb::Parser parser;
+  parser.ParseQuery(sql);
+  VELOX_USER_CHECK_EQ(
+      parser.statements.size(), 1, "Expected one SQL statement: {}", sql);
+  auto& statement = *parser.statements[0];
+  VELOX_USER_CHECK(
+      statement.type == ::duckdb::StatementType::SELECT_STATEMENT,
+      "Only SELECT statements are supported: {}",
+      sql);
+  auto& node = *static_cast<::duckdb::SelectStatement&>(statement).node;
+  VELOX_USER_CHECK(
+      node.type == ::duckdb::QueryNodeType::SELECT_NODE,
+      "Set operations are not supported: {}",
+      sql);
+  return QueryTranslator(tableMetadata_, format_, pool_.get())
+      .translate(static_cast<::duckdb::SelectNode&>(node));
+}
+
+const RowTypePtr& SqlQueryBuilder::tableType(
+    const std::string& tableName) const {
+  auto it = tableMetadata_.find(tableName);
+  VELOX_USER_CHECK(
+      it != tableMetadata_.end(), "Table not found: {}", tableName);
+  return it->second.type;
+}
+
+} // namespace facebook::velox::exec::test
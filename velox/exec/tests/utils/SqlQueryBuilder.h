@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/tests/utils/TpchQueryBuilder.h"
+
+namespace facebook::velox::exec::test {
+
+/// The plan and input data files of a SQL query. Same as for TPC-H.
+using SqlPlan = TpchPlan;
+
+/// Builds Velox plans for SQL queries over data files. The SQL text is parsed
+/// with DuckDB's parser and the parsed query is translated into PlanBuilder
+/// calls; DuckDB's binder and optimizer are not used. The data is laid out as
+/// for TpchQueryBuilder: a sub-directory per table holding the files of the
+/// table. The columns of a table are the columns of its first file.
+///
+/// The supported queries are SELECT statements over one or more tables joined
+/// by inner joins, either written as JOIN ... ON or as a list of tables in
+/// FROM with the join conditions in WHERE. The query may have WHERE, GROUP BY,
+/// HAVING, window functions in the select list, DISTINCT, ORDER BY, LIMIT and
+/// OFFSET. Subqueries, common table expressions, set operations, outer joins,
+/// grouping sets and DISTINCT aggregates are not supported.
+///
+/// The names of the columns must be unique across the tables of a query, as
+/// in TPC-H. Table qualifiers of column names are ignored. The tables are
+/// joined in the order of FROM. Each table is joined on all equalities
+/// between its columns and the columns of the tables joined before it, or
+/// cross joined if there are none. The other conditions of WHERE that use one
+/// table are pushed into the scan of the table and the rest are evaluated as
+/// soon as all the tables they use are joined.
+///
+/// The plans run with multiple drivers per pipeline. Aggregations are split
+/// into partial and final steps, ORDER BY sorts each driver's rows and merges
+/// the sorted runs and LIMIT is applied per driver before the final LIMIT.
+class SqlQueryBuilder {
+ public:
+  explicit SqlQueryBuilder(dwio::common::FileFormat format) : format_(format) {}
+
+  /// Adds each sub-directory of 'dataPath' as a table of the same name.
+  /// @param dataPath path to the data files
+  void initialize(const std::string& dataPath);
+
+  /// Adds table 'tableName' with the data in 'dataFiles'. The columns of the
+  /// table are read from the first file.
+  void addTable(
+      const std::string& tableName,
+      const std::vector<std::string>& dataFiles);
+
+  /// Returns the plan for the SELECT statement in 'sql'. Throws a user error
+  /// if the statement uses unknown tables or columns or features that are not
+  /// supported.
+  SqlPlan getQueryPlan(const std::string& sql) const;
+
+  /// Returns the type of table 'tableName'.
+  const RowTypePtr& tableType(const std::string& tableName) const;
+
+ private:
+  std::unordered_map<std::string, TpchTableMetadata> tableMetadata_;
+  const dwio::common::FileFormat format_;
+  std::shared_ptr<memory::MemoryPool> pool_ = memory::getDefaultMemoryPool();
+};
+
+} // namespace facebook::velox::exec::test
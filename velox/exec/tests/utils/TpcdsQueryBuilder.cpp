@@ -0,0 +1,1021 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/tests/utils/TpcdsQueryBuilder.h"
+
+#include "velox/common/base/Fs.h"
+#include "velox/dwio/common/ReaderFactory.h"
+
+namespace facebook::velox::exec::test {
+
+namespace {
+// The store_sales measures averaged by queries 7 and 27.
+const std::vector<std::string> kAverages = {
+    "avg(ss_quantity) as agg1",
+    "avg(ss_list_price) as agg2",
+    "avg(ss_coupon_amt) as agg3",
+    "avg(ss_sales_price) as agg4"};
+
+// Returns the grouping sets of ROLLUP('keys').
+std::vector<std::vector<std::string>> rollup(
+    const std::vector<std::string>& keys) {
+  std::vector<std::vector<std::string>> groupingSets;
+  for (auto i = keys.size() + 1; i > 0; --i) {
+    groupingSets.emplace_back(keys.begin(), keys.begin() + i - 1);
+  }
+  return groupingSets;
+}
+} // namespace
+
+void TpcdsQueryBuilder::initialize(const std::string& dataPath) {
+  for (const auto& [tableName, columns] : kTables_) {
+    const fs::path tablePath{dataPath + "/" + tableName};
+    for (auto const& dirEntry : fs::directory_iterator{tablePath}) {
+      if (!dirEntry.is_regular_file()) {
+        continue;
+      }
+      // Ignore hidden files.
+      if (dirEntry.path().filename().c_str()[0] == '.') {
+        continue;
+      }
+      if (tableMetadata_[tableName].dataFiles.empty()) {
+        dwio::common::ReaderOptions readerOptions;
+        readerOptions.setFileFormat(format_);
+        auto input = std::make_unique<dwio::common::BufferedInput>(
+            std::make_shared<LocalReadFile>(dirEntry.path().string()),
+            readerOptions.getMemoryPool());
+        std::unique_ptr<dwio::common::Reader> reader =
+            dwio::common::getReaderFactory(readerOptions.getFileFormat())
+                ->createReader(std::move(input), readerOptions);
+        const auto fileType = reader->rowType();
+        const auto fileColumnNames = fileType->names();
+        // There can be extra columns in the file towards the end.
+        VELOX_CHECK_GE(fileColumnNames.size(), columns.size());
+        std::unordered_map<std::string, std::string> fileColumnNamesMap(
+            columns.size());
+        std::transform(
+            columns.begin(),
+            columns.end(),
+            fileColumnNames.begin(),
+            std::inserter(fileColumnNamesMap, fileColumnNamesMap.begin()),
+            [](std::string a, std::string b) { return std::make_pair(a, b); });
+        auto columnNames = columns;
+        auto types = fileType->children();
+        types.resize(columnNames.size());
+        tableMetadata_[tableName].type =
+            std::make_shared<RowType>(std::move(columnNames), std::move(types));
+        tableMetadata_[tableName].fileColumnNames =
+            std::move(fileColumnNamesMap);
+      }
+      tableMetadata_[tableName].dataFiles.push_back(dirEntry.path());
+    }
+  }
+}
+
+const std::vector<int>& TpcdsQueryBuilder::getQueryIds() {
+  static const std::vector<int> kQueryIds = {3, 7, 19, 27, 42, 55, 67, 89};
+  return kQueryIds;
+}
+
+const std::vector<std::string>& TpcdsQueryBuilder::getTableNames() {
+  return kTableNames_;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQueryPlan(int queryId) const {
+  switch (queryId) {
+    case 3:
+      return getQ3Plan();
+    case 7:
+      return getQ7Plan();
+    case 19:
+      return getQ19Plan();
+    case 27:
+      return getQ27Plan();
+    case 42:
+      return getQ42Plan();
+    case 55:
+      return getQ55Plan();
+    case 67:
+      return getQ67Plan();
+    case 89:
+      return getQ89Plan();
+    default:
+      VELOX_NYI("TPC-DS query {} is not supported yet", queryId);
+  }
+}
+
+PlanBuilder TpcdsQueryBuilder::tableScan(
+    const std::shared_ptr<core::PlanNodeIdGenerator>& planNodeIdGenerator,
+    const std::string& tableName,
+    const std::vector<std::string>& columns,
+    TpcdsPlan& plan,
+    const std::vector<std::string>& subfieldFilters,
+    const std::string& remainingFilter) const {
+  const auto& metadata = tableMetadata_.at(tableName);
+  auto columnSelector =
+      std::make_shared<dwio::common::ColumnSelector>(metadata.type, columns);
+  core::PlanNodeId scanNodeId;
+  PlanBuilder builder(planNodeIdGenerator);
+  builder
+      .tableScan(
+          tableName,
+          columnSelector->buildSelectedReordered(),
+          metadata.fileColumnNames,
+          subfieldFilters,
+          remainingFilter)
+      .capturePlanNodeId(scanNodeId);
+  plan.dataFiles[scanNodeId] = metadata.dataFiles;
+  return builder;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQ3Plan() const {
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpcdsPlan context;
+
+  auto dates = tableScan(
+                   planNodeIdGenerator,
+                   kDateDim,
+                   {"d_date_sk", "d_year", "d_moy"},
+                   context,
+                   {"d_moy = 11"})
+                   .planNode();
+  auto items = tableScan(
+                   planNodeIdGenerator,
+                   kItem,
+                   {"i_item_sk", "i_brand_id", "i_brand", "i_manufact_id"},
+                   context,
+                   {"i_manufact_id = 128"})
+                   .planNode();
+
+  context.plan =
+      tableScan(
+          planNodeIdGenerator,
+          kStoreSales,
+          {"ss_sold_date_sk", "ss_item_sk", "ss_ext_sales_price"},
+          context)
+          .hashJoin(
+              {"ss_item_sk"},
+              {"i_item_sk"},
+              items,
+              "",
+              {"ss_sold_date_sk",
+               "ss_ext_sales_price",
+               "i_brand_id",
+               "i_brand"})
+          .hashJoin(
+              {"ss_sold_date_sk"},
+              {"d_date_sk"},
+              dates,
+              "",
+              {"d_year", "i_brand_id", "i_brand", "ss_ext_sales_price"})
+          .partialAggregation(
+              {"d_year", "i_brand", "i_brand_id"},
+              {"sum(ss_ext_sales_price) as sum_agg"})
+          .localPartition({})
+          .finalAggregation()
+          .project(
+              {"d_year",
+               "i_brand_id as brand_id",
+               "i_brand as brand",
+               "sum_agg"})
+          .orderBy({"d_year", "sum_agg DESC", "brand_id"}, false)
+          .limit(0, 100, false)
+          .planNode();
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQ7Plan() const {
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpcdsPlan context;
+
+  auto demographics = tableScan(
+                          planNodeIdGenerator,
+                          kCustomerDemographics,
+                          {"cd_demo_sk",
+                           "cd_gender",
+                           "cd_marital_status",
+                           "cd_education_status"},
+                          context,
+                          {"cd_gender = 'M'",
+                           "cd_marital_status = 'S'",
+                           "cd_education_status = 'College'"})
+                          .planNode();
+  auto dates = tableScan(
+                   planNodeIdGenerator,
+                   kDateDim,
+                   {"d_date_sk", "d_year"},
+                   context,
+                   {"d_year = 2000"})
+                   .planNode();
+  auto promotions =
+      tableScan(
+          planNodeIdGenerator,
+          kPromotion,
+          {"p_promo_sk", "p_channel_email", "p_channel_event"},
+          context,
+          {},
+          "p_channel_email = 'N' or p_channel_event = 'N'")
+          .planNode();
+  auto items =
+      tableScan(planNodeIdGenerator, kItem, {"i_item_sk", "i_item_id"}, context)
+          .planNode();
+
+  context.plan = tableScan(
+                     planNodeIdGenerator,
+                     kStoreSales,
+                     {"ss_sold_date_sk",
+                      "ss_item_sk",
+                      "ss_cdemo_sk",
+                      "ss_promo_sk",
+                      "ss_quantity",
+                      "ss_list_price",
+                      "ss_coupon_amt",
+                      "ss_sales_price"},
+                     context)
+                     .hashJoin(
+                         {"ss_cdemo_sk"},
+                         {"cd_demo_sk"},
+                         demographics,
+                         "",
+                         {"ss_sold_date_sk",
+                          "ss_item_sk",
+                          "ss_promo_sk",
+                          "ss_quantity",
+                          "ss_list_price",
+                          "ss_coupon_amt",
+                          "ss_sales_price"})
+                     .hashJoin(
+                         {"ss_sold_date_sk"},
+                         {"d_date_sk"},
+                         dates,
+                         "",
+                         {"ss_item_sk",
+                          "ss_promo_sk",
+                          "ss_quantity",
+                          "ss_list_price",
+                          "ss_coupon_amt",
+                          "ss_sales_price"})
+                     .hashJoin(
+                         {"ss_promo_sk"},
+                         {"p_promo_sk"},
+                         promotions,
+                         "",
+                         {"ss_item_sk",
+                          "ss_quantity",
+                          "ss_list_price",
+                          "ss_coupon_amt",
+                          "ss_sales_price"})
+                     .hashJoin(
+                         {"ss_item_sk"},
+                         {"i_item_sk"},
+                         items,
+                         "",
+                         {"i_item_id",
+                          "ss_quantity",
+                          "ss_list_price",
+                          "ss_coupon_amt",
+                          "ss_sales_price"})
+                     .partialAggregation({"i_item_id"}, kAverages)
+                     .localPartition({"i_item_id"})
+                     .finalAggregation()
+                     .localPartition({})
+                     .orderBy({"i_item_id"}, false)
+                     .limit(0, 100, false)
+                     .planNode();
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQ19Plan() const {
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpcdsPlan context;
+
+  auto dates = tableScan(
+                   planNodeIdGenerator,
+                   kDateDim,
+                   {"d_date_sk", "d_year", "d_moy"},
+                   context,
+                   {"d_moy = 11", "d_year = 1998"})
+                   .planNode();
+  auto items = tableScan(
+                   planNodeIdGenerator,
+                   kItem,
+                   {"i_item_sk",
+                    "i_brand_id",
+                    "i_brand",
+                    "i_manufact_id",
+                    "i_manufact",
+                    "i_manager_id"},
+                   context,
+                   {"i_manager_id = 8"})
+                   .planNode();
+  auto customers = tableScan(
+                       planNodeIdGenerator,
+                       kCustomer,
+                       {"c_customer_sk", "c_current_addr_sk"},
+                       context)
+                       .planNode();
+  auto addresses = tableScan(
+                       planNodeIdGenerator,
+                       kCustomerAddress,
+                       {"ca_address_sk", "ca_zip"},
+                       context)
+                       .planNode();
+  auto stores = tableScan(
+                    planNodeIdGenerator,
+                    kStore,
+                    {"s_store_sk", "s_zip"},
+                    context)
+                    .planNode();
+
+  const std::vector<std::string> itemColumns = {
+      "i_brand_id", "i_brand", "i_manufact_id", "i_manufact"};
+  auto withItemColumns = [&](std::vector<std::string> columns) {
+    columns.insert(columns.end(), itemColumns.begin(), itemColumns.end());
+    return columns;
+  };
+
+  context.plan =
+      tableScan(
+          planNodeIdGenerator,
+          kStoreSales,
+          {"ss_sold_date_sk",
+           "ss_item_sk",
+           "ss_customer_sk",
+           "ss_store_sk",
+           "ss_ext_sales_price"},
+          context)
+          .hashJoin(
+              {"ss_sold_date_sk"},
+              {"d_date_sk"},
+              dates,
+              "",
+              {"ss_item_sk",
+               "ss_customer_sk",
+               "ss_store_sk",
+               "ss_ext_sales_price"})
+          .hashJoin(
+              {"ss_item_sk"},
+              {"i_item_sk"},
+              items,
+              "",
+              withItemColumns(
+                  {"ss_customer_sk", "ss_store_sk", "ss_ext_sales_price"}))
+          .hashJoin(
+              {"ss_customer_sk"},
+              {"c_customer_sk"},
+              customers,
+              "",
+              withItemColumns(
+                  {"c_current_addr_sk", "ss_store_sk", "ss_ext_sales_price"}))
+          .hashJoin(
+              {"c_current_addr_sk"},
+              {"ca_address_sk"},
+              addresses,
+              "",
+              withItemColumns({"ca_zip", "ss_store_sk", "ss_ext_sales_price"}))
+          .hashJoin(
+              {"ss_store_sk"},
+              {"s_store_sk"},
+              stores,
+              "substr(ca_zip, 1, 5) <> substr(s_zip, 1, 5)",
+              withItemColumns({"ss_ext_sales_price"}))
+          .partialAggregation(
+              {"i_brand", "i_brand_id", "i_manufact_id", "i_manufact"},
+              {"sum(ss_ext_sales_price) as ext_price"})
+          .localPartition({})
+          .finalAggregation()
+          .project(
+              {"i_brand_id as brand_id",
+               "i_brand as brand",
+               "i_manufact_id",
+               "i_manufact",
+               "ext_price"})
+          .orderBy(
+              {"ext_price DESC",
+               "brand",
+               "brand_id",
+               "i_manufact_id",
+               "i_manufact"},
+              false)
+          .limit(0, 100, false)
+          .planNode();
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQ27Plan() const {
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpcdsPlan context;
+
+  auto demographics = tableScan(
+                          planNodeIdGenerator,
+                          kCustomerDemographics,
+                          {"cd_demo_sk",
+                           "cd_gender",
+                           "cd_marital_status",
+                           "cd_education_status"},
+                          context,
+                          {"cd_gender = 'M'",
+                           "cd_marital_status = 'S'",
+                           "cd_education_status = 'College'"})
+                          .planNode();
+  auto dates = tableScan(
+                   planNodeIdGenerator,
+                   kDateDim,
+                   {"d_date_sk", "d_year"},
+                   context,
+                   {"d_year = 2002"})
+                   .planNode();
+  auto stores = tableScan(
+                    planNodeIdGenerator,
+                    kStore,
+                    {"s_store_sk", "s_state"},
+                    context,
+                    {"s_state = 'TN'"})
+                    .planNode();
+  auto items =
+      tableScan(planNodeIdGenerator, kItem, {"i_item_sk", "i_item_id"}, context)
+          .planNode();
+
+  const std::vector<std::string> measures = {
+      "ss_quantity", "ss_list_price", "ss_coupon_amt", "ss_sales_price"};
+  auto withMeasures = [&](std::vector<std::string> columns) {
+    columns.insert(columns.end(), measures.begin(), measures.end());
+    return columns;
+  };
+
+  // GROUP BY ROLLUP(i_item_id, s_state). grouping(s_state) is 0 only for the
+  // grouping set that has s_state.
+  context.plan =
+      tableScan(
+          planNodeIdGenerator,
+          kStoreSales,
+          withMeasures(
+              {"ss_sold_date_sk", "ss_item_sk", "ss_cdemo_sk", "ss_store_sk"}),
+          context)
+          .hashJoin(
+              {"ss_cdemo_sk"},
+              {"cd_demo_sk"},
+              demographics,
+              "",
+              withMeasures({"ss_sold_date_sk", "ss_item_sk", "ss_store_sk"}))
+          .hashJoin(
+              {"ss_sold_date_sk"},
+              {"d_date_sk"},
+              dates,
+              "",
+              withMeasures({"ss_item_sk", "ss_store_sk"}))
+          .hashJoin(
+              {"ss_store_sk"},
+              {"s_store_sk"},
+              stores,
+              "",
+              withMeasures({"ss_item_sk", "s_state"}))
+          .hashJoin(
+              {"ss_item_sk"},
+              {"i_item_sk"},
+              items,
+              "",
+              withMeasures({"i_item_id", "s_state"}))
+          .groupId(rollup({"i_item_id", "s_state"}), measures)
+          .partialAggregation({"i_item_id", "s_state", "group_id"}, kAverages)
+          .localPartition({"i_item_id", "s_state", "group_id"})
+          .finalAggregation()
+          .project(
+              {"i_item_id",
+               "s_state",
+               "if(group_id = 0, 0, 1) as g_state",
+               "agg1",
+               "agg2",
+               "agg3",
+               "agg4"})
+          .localPartition({})
+          .orderBy({"i_item_id", "s_state"}, false)
+          .limit(0, 100, false)
+          .planNode();
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQ42Plan() const {
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpcdsPlan context;
+
+  auto dates = tableScan(
+                   planNodeIdGenerator,
+                   kDateDim,
+                   {"d_date_sk", "d_year", "d_moy"},
+                   context,
+                   {"d_moy = 11", "d_year = 2000"})
+                   .planNode();
+  auto items = tableScan(
+                   planNodeIdGenerator,
+                   kItem,
+                   {"i_item_sk", "i_category_id", "i_category", "i_manager_id"},
+                   context,
+                   {"i_manager_id = 1"})
+                   .planNode();
+
+  context.plan =
+      tableScan(
+          planNodeIdGenerator,
+          kStoreSales,
+          {"ss_sold_date_sk", "ss_item_sk", "ss_ext_sales_price"},
+          context)
+          .hashJoin(
+              {"ss_item_sk"},
+              {"i_item_sk"},
+              items,
+              "",
+              {"ss_sold_date_sk",
+               "ss_ext_sales_price",
+               "i_category_id",
+               "i_category"})
+          .hashJoin(
+              {"ss_sold_date_sk"},
+              {"d_date_sk"},
+              dates,
+              "",
+              {"d_year", "i_category_id", "i_category", "ss_ext_sales_price"})
+          .partialAggregation(
+              {"d_year", "i_category_id", "i_category"},
+              {"sum(ss_ext_sales_price) as total_sales"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy(
+              {"total_sales DESC", "d_year", "i_category_id", "i_category"},
+              false)
+          .limit(0, 100, false)
+          .planNode();
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQ55Plan() const {
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpcdsPlan context;
+
+  auto dates = tableScan(
+                   planNodeIdGenerator,
+                   kDateDim,
+                   {"d_date_sk", "d_year", "d_moy"},
+                   context,
+                   {"d_moy = 11", "d_year = 1999"})
+                   .planNode();
+  auto items = tableScan(
+                   planNodeIdGenerator,
+                   kItem,
+                   {"i_item_sk", "i_brand_id", "i_brand", "i_manager_id"},
+                   context,
+                   {"i_manager_id = 28"})
+                   .planNode();
+
+  context.plan =
+      tableScan(
+          planNodeIdGenerator,
+          kStoreSales,
+          {"ss_sold_date_sk", "ss_item_sk", "ss_ext_sales_price"},
+          context)
+          .hashJoin(
+              {"ss_item_sk"},
+              {"i_item_sk"},
+              items,
+              "",
+              {"ss_sold_date_sk",
+               "ss_ext_sales_price",
+               "i_brand_id",
+               "i_brand"})
+          .hashJoin(
+              {"ss_sold_date_sk"},
+              {"d_date_sk"},
+              dates,
+              "",
+              {"i_brand_id", "i_brand", "ss_ext_sales_price"})
+          .partialAggregation(
+              {"i_brand", "i_brand_id"},
+              {"sum(ss_ext_sales_price) as ext_price"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"i_brand_id as brand_id", "i_brand as brand", "ext_price"})
+          .orderBy({"ext_price DESC", "brand_id"}, false)
+          .limit(0, 100, false)
+          .planNode();
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQ67Plan() const {
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpcdsPlan context;
+
+  auto dates = tableScan(
+                   planNodeIdGenerator,
+                   kDateDim,
+                   {"d_date_sk", "d_month_seq", "d_year", "d_qoy", "d_moy"},
+                   context,
+                   {"d_month_seq between 1200 and 1211"})
+                   .planNode();
+  auto stores = tableScan(
+                    planNodeIdGenerator,
+                    kStore,
+                    {"s_store_sk", "s_store_id"},
+                    context)
+                    .planNode();
+  auto items = tableScan(
+                   planNodeIdGenerator,
+                   kItem,
+                   {"i_item_sk",
+                    "i_category",
+                    "i_class",
+                    "i_brand",
+                    "i_product_name"},
+                   context)
+                   .planNode();
+
+  const std::vector<std::string> groupingKeys = {
+      "i_category",
+      "i_class",
+      "i_brand",
+      "i_product_name",
+      "d_year",
+      "d_qoy",
+      "d_moy",
+      "s_store_id"};
+  auto withGroupingKeys = [&](std::vector<std::string> columns) {
+    columns.insert(columns.begin(), groupingKeys.begin(), groupingKeys.end());
+    return columns;
+  };
+
+  // Ranks the rows of all 9 grouping sets of the rollup by category. The
+  // highest 100 per category are sorted.
+  context.plan =
+      tableScan(
+          planNodeIdGenerator,
+          kStoreSales,
+          {"ss_sold_date_sk",
+           "ss_item_sk",
+           "ss_store_sk",
+           "ss_sales_price",
+           "ss_quantity"},
+          context)
+          .project(
+              {"ss_sold_date_sk",
+               "ss_item_sk",
+               "ss_store_sk",
+               "coalesce(ss_sales_price * ss_quantity, 0.0) as sales"})
+          .hashJoin(
+              {"ss_sold_date_sk"},
+              {"d_date_sk"},
+              dates,
+              "",
+              {"ss_item_sk",
+               "ss_store_sk",
+               "d_year",
+               "d_qoy",
+               "d_moy",
+               "sales"})
+          .hashJoin(
+              {"ss_store_sk"},
+              {"s_store_sk"},
+              stores,
+              "",
+              {"ss_item_sk", "d_year", "d_qoy", "d_moy", "s_store_id", "sales"})
+          .hashJoin(
+              {"ss_item_sk"},
+              {"i_item_sk"},
+              items,
+              "",
+              withGroupingKeys({"sales"}))
+          .groupId(rollup(groupingKeys), {"sales"})
+          .partialAggregation(
+              withGroupingKeys({"group_id"}), {"sum(sales) as sumsales"})
+          .localPartition(withGroupingKeys({"group_id"}))
+          .finalAggregation()
+          .localPartition({"i_category"})
+          .window(
+              {"rank() over (partition by i_category order by sumsales desc) "
+               "as rk"})
+          .filter("rk <= 100")
+          .project(withGroupingKeys({"sumsales", "rk"}))
+          .localPartition({})
+          .orderBy(withGroupingKeys({"sumsales", "rk"}), false)
+          .limit(0, 100, false)
+          .planNode();
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpcdsPlan TpcdsQueryBuilder::getQ89Plan() const {
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpcdsPlan context;
+
+  auto items = tableScan(
+                   planNodeIdGenerator,
+                   kItem,
+                   {"i_item_sk", "i_category", "i_class", "i_brand"},
+                   context,
+                   {},
+                   "(i_category in ('Books', 'Electronics', 'Sports') and "
+                   "i_class in ('computers', 'stereo', 'football')) or "
+                   "(i_category in ('Men', 'Jewelry', 'Women') and "
+                   "i_class in ('shirts', 'birdal', 'dresses'))")
+                   .planNode();
+  auto dates = tableScan(
+                   planNodeIdGenerator,
+                   kDateDim,
+                   {"d_date_sk", "d_year", "d_moy"},
+                   context,
+                   {"d_year = 1999"})
+                   .planNode();
+  auto stores = tableScan(
+                    planNodeIdGenerator,
+                    kStore,
+                    {"s_store_sk", "s_store_name", "s_company_name"},
+                    context)
+                    .planNode();
+
+  // The monthly sales that deviate by more than 10% from the average monthly
+  // sales of the same brand and store.
+  context.plan =
+      tableScan(
+          planNodeIdGenerator,
+          kStoreSales,
+          {"ss_sold_date_sk", "ss_item_sk", "ss_store_sk", "ss_sales_price"},
+          context)
+          .hashJoin(
+              {"ss_item_sk"},
+              {"i_item_sk"},
+              items,
+              "",
+              {"ss_sold_date_sk",
+               "ss_store_sk",
+               "ss_sales_price",
+               "i_category",
+               "i_class",
+               "i_brand"})
+          .hashJoin(
+              {"ss_sold_date_sk"},
+              {"d_date_sk"},
+              dates,
+              "",
+              {"ss_store_sk",
+               "ss_sales_price",
+               "i_category",
+               "i_class",
+               "i_brand",
+               "d_moy"})
+          .hashJoin(
+              {"ss_store_sk"},
+              {"s_store_sk"},
+              stores,
+              "",
+              {"i_category",
+               "i_class",
+               "i_brand",
+               "s_store_name",
+               "s_company_name",
+               "d_moy",
+               "ss_sales_price"})
+          .partialAggregation(
+              {"i_category",
+               "i_class",
+               "i_brand",
+               "s_store_name",
+               "s_company_name",
+               "d_moy"},
+              {"sum(ss_sales_price) as sum_sales"})
+          .localPartition(
+              {"i_category", "i_brand", "s_store_name", "s_company_name"})
+          .finalAggregation()
+          .window(
+              {"avg(sum_sales) over (partition by i_category, i_brand, "
+               "s_store_name, s_company_name) as avg_monthly_sales"})
+          .filter(
+              "avg_monthly_sales <> 0 and "
+              "abs(sum_sales - avg_monthly_sales) / avg_monthly_sales > 0.1")
+          .project(
+              {"i_category",
+               "i_class",
+               "i_brand",
+               "s_store_name",
+               "s_company_name",
+               "d_moy",
+               "sum_sales",
+               "avg_monthly_sales",
+               "sum_sales - avg_monthly_sales as deviation"})
+          .localPartition({})
+          .orderBy({"deviation", "s_store_name"}, false)
+          .limit(0, 100, false)
+          .project(
+              {"i_category",
+               "i_class",
+               "i_brand",
+               "s_store_name",
+               "s_company_name",
+               "d_moy",
+               "sum_sales",
+               "avg_monthly_sales"})
+          .planNode();
+  context.dataFileFormat = format_;
+  return context;
+}
+
+const std::vector<std::string> TpcdsQueryBuilder::kTableNames_ = {
+    kStoreSales,
+    kDateDim,
+    kItem,
+    kCustomer,
+    kCustomerAddress,
+    kCustomerDemographics,
+    kPromotion,
+    kStore};
+
+// The columns of the tables in the order of the TPC-DS standard.
+const std::unordered_map<std::string, std::vector<std::string>>
+    TpcdsQueryBuilder::kTables_ = {
+        {"store_sales",
+         {"ss_sold_date_sk",
+          "ss_sold_time_sk",
+          "ss_item_sk",
+          "ss_customer_sk",
+          "ss_cdemo_sk",
+          "ss_hdemo_sk",
+          "ss_addr_sk",
+          "ss_store_sk",
+          "ss_promo_sk",
+          "ss_ticket_number",
+          "ss_quantity",
+          "ss_wholesale_cost",
+          "ss_list_price",
+          "ss_sales_price",
+          "ss_ext_discount_amt",
+          "ss_ext_sales_price",
+          "ss_ext_wholesale_cost",
+          "ss_ext_list_price",
+          "ss_ext_tax",
+          "ss_coupon_amt",
+          "ss_net_paid",
+          "ss_net_paid_inc_tax",
+          "ss_net_profit"}},
+        {"date_dim",
+         {"d_date_sk",
+          "d_date_id",
+          "d_date",
+          "d_month_seq",
+          "d_week_seq",
+          "d_quarter_seq",
+          "d_year",
+          "d_dow",
+          "d_moy",
+          "d_dom",
+          "d_qoy",
+          "d_fy_year",
+          "d_fy_quarter_seq",
+          "d_fy_week_seq",
+          "d_day_name",
+          "d_quarter_name",
+          "d_holiday",
+          "d_weekend",
+          "d_following_holiday",
+          "d_first_dom",
+          "d_last_dom",
+          "d_same_day_ly",
+          "d_same_day_lq",
+          "d_current_day",
+          "d_current_week",
+          "d_current_month",
+          "d_current_quarter",
+          "d_current_year"}},
+        {"item",
+         {"i_item_sk",
+          "i_item_id",
+          "i_rec_start_date",
+          "i_rec_end_date",
+          "i_item_desc",
+          "i_current_price",
+          "i_wholesale_cost",
+          "i_brand_id",
+          "i_brand",
+          "i_class_id",
+          "i_class",
+          "i_category_id",
+          "i_category",
+          "i_manufact_id",
+          "i_manufact",
+          "i_size",
+          "i_formulation",
+          "i_color",
+          "i_units",
+          "i_container",
+          "i_manager_id",
+          "i_product_name"}},
+        {"customer",
+         {"c_customer_sk",
+          "c_customer_id",
+          "c_current_cdemo_sk",
+          "c_current_hdemo_sk",
+          "c_current_addr_sk",
+          "c_first_shipto_date_sk",
+          "c_first_sales_date_sk",
+          "c_salutation",
+          "c_first_name",
+          "c_last_name",
+          "c_preferred_cust_flag",
+          "c_birth_day",
+          "c_birth_month",
+          "c_birth_year",
+          "c_birth_country",
+          "c_login",
+          "c_email_address",
+          "c_last_review_date_sk"}},
+        {"customer_address",
+         {"ca_address_sk",
+          "ca_address_id",
+          "ca_street_number",
+          "ca_street_name",
+          "ca_street_type",
+          "ca_suite_number",
+          "ca_city",
+          "ca_county",
+          "ca_state",
+          "ca_zip",
+          "ca_country",
+          "ca_gmt_offset",
+          "ca_location_type"}},
+        {"customer_demographics",
+         {"cd_demo_sk",
+          "cd_gender",
+          "cd_marital_status",
+          "cd_education_status",
+          "cd_purchase_estimate",
+          "cd_credit_rating",
+          "cd_dep_count",
+          "cd_dep_employed_count",
+          "cd_dep_college_count"}},
+        {"promotion",
+         {"p_promo_sk",
+          "p_promo_id",
+          "p_start_date_sk",
+          "p_end_date_sk",
+          "p_item_sk",
+          "p_cost",
+          "p_response_target",
+          "p_promo_name",
+          "p_channel_dmail",
+          "p_channel_email",
+          "p_channel_catalog",
+          "p_channel_tv",
+          "p_channel_radio",
+          "p_channel_press",
+          "p_channel_event",
+          "p_channel_demo",
+          "p_channel_details",
+          "p_purpose",
+          "p_discount_active"}},
+        {"store",
+         {"s_store_sk",
+          "s_store_id",
+          "s_rec_start_date",
+          "s_rec_end_date",
+          "s_closed_date_sk",
+          "s_store_name",
+          "s_number_employees",
+          "s_floor_space",
+          "s_hours",
+          "s_manager",
+          "s_market_id",
+          "s_geography_class",
+          "s_market_desc",
+          "s_market_manager",
+          "s_division_id",
+          "s_division_name",
+          "s_company_id",
+          "s_company_name",
+          "s_street_number",
+          "s_street_name",
+          "s_street_type",
+          "s_suite_number",
+          "s_city",
+          "s_county",
+          "s_state",
+          "s_zip",
+          "s_country",
+          "s_gmt_offset",
+          "s_tax_precentage"}}};
+
+} // namespace facebook::velox::exec::test
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/tests/utils/TpchQueryBuilder.h"
+
+namespace facebook::velox::exec::test {
+
+/// The plan and input data files of a TPC-DS query. Same as for TPC-H.
+using TpcdsPlan = TpchPlan;
+
+/// Builds TPC-DS queries using TPC-DS data files located in the specified
+/// directory. The layout of the data is the same as for TpchQueryBuilder: a
+/// sub-directory per table name holding the files of the table. The columns
+/// of the files are expected in the order of the TPC-DS standard and are
+/// mapped to the standard names, e.g. ss_sold_date_sk. Only the tables used
+/// by the supported queries are read.
+///
+/// The supported queries cover multi-way joins of the store_sales fact table
+/// with its dimensions (3, 7, 19, 42, 55), rollups (27, 67) and window
+/// functions (67, 89).
+class TpcdsQueryBuilder {
+ public:
+  explicit TpcdsQueryBuilder(dwio::common::FileFormat format)
+      : format_(format) {}
+
+  /// Read each data file, initialize row types, and determine data paths for
+  /// each table.
+  /// @param dataPath path to the data files
+  void initialize(const std::string& dataPath);
+
+  /// Get the query plan for a given TPC-DS query number.
+  /// @param queryId TPC-DS query number
+  TpcdsPlan getQueryPlan(int queryId) const;
+
+  /// The numbers of the supported queries.
+  static const std::vector<int>& getQueryIds();
+
+  /// Get the TPC-DS table names used by the supported queries.
+  static const std::vector<std::string>& getTableNames();
+
+ private:
+  TpcdsPlan getQ3Plan() const;
+  TpcdsPlan getQ7Plan() const;
+  TpcdsPlan getQ19Plan() const;
+  TpcdsPlan getQ27Plan() const;
+  TpcdsPlan getQ42Plan() const;
+  TpcdsPlan getQ55Plan() const;
+  TpcdsPlan getQ67Plan() const;
+  TpcdsPlan getQ89Plan() const;
+
+  // Returns a PlanBuilder with a scan of 'columns' of 'tableName' and adds
+  // the files of the table for the scan to 'plan'.
+  PlanBuilder tableScan(
+      const std::shared_ptr<core::PlanNodeIdGenerator>& planNodeIdGenerator,
+      const std::string& tableName,
+      const std::vector<std::string>& columns,
+      TpcdsPlan& plan,
+      const std::vector<std::string>& subfieldFilters = {},
+      const std::string& remainingFilter = "") const;
+
+  std::unordered_map<std::string, TpchTableMetadata> tableMetadata_;
+  const dwio::common::FileFormat format_;
+  static const std::unordered_map<std::string, std::vector<std::string>>
+      kTables_;
+  static const std::vector<std::string> kTableNames_;
+
+  static constexpr const char* kStoreSales = "store_sales";
+  static constexpr const char* kDateDim = "date_dim";
+  static constexpr const char* kItem = "item";
+  static constexpr const char* kCustomer = "customer";
+  static constexpr const char* kCustomerAddress = "customer_address";
+  static constexpr const char* kCustomerDemographics = "customer_demographics";
+  static constexpr const char* kPromotion = "promotion";
+  static constexpr const char* kStore = "store";
+};
+
+} // namespace facebook::velox::exec::test
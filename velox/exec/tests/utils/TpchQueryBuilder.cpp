@@ -121,8 +121,12 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
   switch (queryId) {
     case 1:
       return getQ1Plan();
+    case 2:
+      return getQ2Plan();
     case 3:
       return getQ3Plan();
+    case 4:
+      return getQ4Plan();
     case 5:
       return getQ5Plan();
     case 6:
@@ -135,6 +139,8 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
       return getQ9Plan();
     case 10:
       return getQ10Plan();
+    case 11:
+      return getQ11Plan();
     case 12:
       return getQ12Plan();
     case 13:
@@ -151,6 +157,8 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
       return getQ18Plan();
     case 19:
       return getQ19Plan();
+    case 20:
+      return getQ20Plan();
     case 21:
       return getQ21Plan();
     case 22:
@@ -213,6 +221,186 @@ TpchPlan TpchQueryBuilder::getQ1Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ2Plan() const {
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_mfgr", "p_size", "p_type"};
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey",
+      "s_name",
+      "s_address",
+      "s_nationkey",
+      "s_phone",
+      "s_acctbal",
+      "s_comment"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_supplycost"};
+  std::vector<std::string> nationColumns = {
+      "n_nationkey", "n_name", "n_regionkey"};
+  std::vector<std::string> regionColumns = {"r_regionkey", "r_name"};
+
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  auto regionSelectedRowType = getRowType(kRegion, regionColumns);
+  const auto& regionFileColumns = getFileColumnNames(kRegion);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId supplierScanNodeIdSubQuery;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partsuppScanNodeIdSubQuery;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId nationScanNodeIdSubQuery;
+  core::PlanNodeId regionScanNodeId;
+  core::PlanNodeId regionScanNodeIdSubQuery;
+
+  // The suppliers in EUROPE. Used by the query and by the subquery.
+  auto europeSuppliers = [&](core::PlanNodeId& supplierScanId,
+                             core::PlanNodeId& nationScanId,
+                             core::PlanNodeId& regionScanId) {
+    auto region = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(
+                          kRegion,
+                          regionSelectedRowType,
+                          regionFileColumns,
+                          {"r_name = 'EUROPE'"})
+                      .capturePlanNodeId(regionScanId)
+                      .planNode();
+    auto nation =
+        PlanBuilder(planNodeIdGenerator)
+            .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+            .capturePlanNodeId(nationScanId)
+            .hashJoin(
+                {"n_regionkey"},
+                {"r_regionkey"},
+                region,
+                "",
+                {"n_nationkey", "n_name"})
+            .planNode();
+    return PlanBuilder(planNodeIdGenerator)
+        .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+        .capturePlanNodeId(supplierScanId)
+        .hashJoin(
+            {"s_nationkey"},
+            {"n_nationkey"},
+            nation,
+            "",
+            {"s_suppkey",
+             "s_name",
+             "s_address",
+             "s_phone",
+             "s_acctbal",
+             "s_comment",
+             "n_name"})
+        .planNode();
+  };
+
+  auto minSupplyCost =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeIdSubQuery)
+          .project(
+              {"ps_partkey as min_partkey",
+               "ps_suppkey as min_suppkey",
+               "ps_supplycost as min_cost"})
+          .hashJoin(
+              {"min_suppkey"},
+              {"s_suppkey"},
+              europeSuppliers(
+                  supplierScanNodeIdSubQuery,
+                  nationScanNodeIdSubQuery,
+                  regionScanNodeIdSubQuery),
+              "",
+              {"min_partkey", "min_cost"})
+          .partialAggregation(
+              {"min_partkey"}, {"min(min_cost) as min_supplycost"})
+          .localPartition({"min_partkey"})
+          .finalAggregation()
+          .planNode();
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_size = 15"},
+                      "p_type like '%BRASS'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_supplycost", "p_mfgr"})
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeSuppliers(
+                  supplierScanNodeId, nationScanNodeId, regionScanNodeId),
+              "",
+              {"ps_partkey",
+               "ps_supplycost",
+               "p_mfgr",
+               "s_name",
+               "s_address",
+               "s_phone",
+               "s_acctbal",
+               "s_comment",
+               "n_name"})
+          .hashJoin(
+              {"ps_partkey", "ps_supplycost"},
+              {"min_partkey", "min_supplycost"},
+              minSupplyCost,
+              "",
+              {"s_acctbal",
+               "s_name",
+               "n_name",
+               "ps_partkey",
+               "p_mfgr",
+               "s_address",
+               "s_phone",
+               "s_comment"})
+          .project(
+              {"s_acctbal",
+               "s_name",
+               "n_name",
+               "ps_partkey as p_partkey",
+               "p_mfgr",
+               "s_address",
+               "s_phone",
+               "s_comment"})
+          .localPartition({})
+          .orderBy({"s_acctbal DESC", "n_name", "s_name", "p_partkey"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[supplierScanNodeIdSubQuery] = getTableFilePaths(kSupplier);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partsuppScanNodeIdSubQuery] = getTableFilePaths(kPartsupp);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[nationScanNodeIdSubQuery] = getTableFilePaths(kNation);
+  context.dataFiles[regionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFiles[regionScanNodeIdSubQuery] = getTableFilePaths(kRegion);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ3Plan() const {
   std::vector<std::string> lineitemColumns = {
       "l_shipdate", "l_orderkey", "l_extendedprice", "l_discount"};
@@ -301,6 +489,65 @@ TpchPlan TpchQueryBuilder::getQ3Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ4Plan() const {
+  std::vector<std::string> ordersColumns = {
+      "o_orderkey", "o_orderdate", "o_orderpriority"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_commitdate", "l_receiptdate"};
+
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const std::string orderDateFilter = formatDateFilter(
+      "o_orderdate", ordersSelectedRowType, "'1993-07-01'", "'1993-09-30'");
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto orders = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kOrders,
+                        ordersSelectedRowType,
+                        ordersFileColumns,
+                        {orderDateFilter})
+                    .capturePlanNodeId(ordersScanNodeId)
+                    .planNode();
+
+  // The orders are the smaller side, so they are the build side of the
+  // EXISTS.
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kLineitem,
+                      lineitemSelectedRowType,
+                      lineitemFileColumns,
+                      {},
+                      "l_commitdate < l_receiptdate")
+                  .capturePlanNodeId(lineitemScanNodeId)
+                  .hashJoin(
+                      {"l_orderkey"},
+                      {"o_orderkey"},
+                      orders,
+                      "",
+                      {"o_orderpriority"},
+                      core::JoinType::kRightSemiFilter)
+                  .partialAggregation(
+                      {"o_orderpriority"}, {"count(0) as order_count"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .orderBy({"o_orderpriority"}, false)
+                  .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ5Plan() const {
   std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
   std::vector<std::string> ordersColumns = {
@@ -1034,6 +1281,94 @@ TpchPlan TpchQueryBuilder::getQ10Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ11Plan() const {
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty", "ps_supplycost"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partsuppScanNodeIdSubQuery;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId supplierScanNodeIdSubQuery;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId nationScanNodeIdSubQuery;
+
+  // The value of each part supplied from GERMANY. Used by the query and by
+  // the subquery.
+  auto germanPartValues = [&](core::PlanNodeId& partsuppScanId,
+                              core::PlanNodeId& supplierScanId,
+                              core::PlanNodeId& nationScanId) {
+    auto nation = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(
+                          kNation,
+                          nationSelectedRowType,
+                          nationFileColumns,
+                          {"n_name = 'GERMANY'"})
+                      .capturePlanNodeId(nationScanId)
+                      .planNode();
+    auto supplier =
+        PlanBuilder(planNodeIdGenerator)
+            .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+            .capturePlanNodeId(supplierScanId)
+            .hashJoin(
+                {"s_nationkey"}, {"n_nationkey"}, nation, "", {"s_suppkey"})
+            .planNode();
+    return PlanBuilder(planNodeIdGenerator)
+        .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+        .capturePlanNodeId(partsuppScanId)
+        .hashJoin(
+            {"ps_suppkey"},
+            {"s_suppkey"},
+            supplier,
+            "",
+            {"ps_partkey", "ps_availqty", "ps_supplycost"})
+        .project({"ps_partkey", "ps_supplycost * ps_availqty as part_value"});
+  };
+
+  auto threshold =
+      germanPartValues(
+          partsuppScanNodeIdSubQuery,
+          supplierScanNodeIdSubQuery,
+          nationScanNodeIdSubQuery)
+          .partialAggregation({}, {"sum(part_value) as total_value"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"total_value * 0.0001 as threshold"})
+          .planNode();
+
+  auto plan =
+      germanPartValues(partsuppScanNodeId, supplierScanNodeId, nationScanNodeId)
+          .partialAggregation({"ps_partkey"}, {"sum(part_value) as value"})
+          .localPartition({"ps_partkey"})
+          .finalAggregation()
+          .crossJoin(threshold, {"ps_partkey", "value", "threshold"})
+          .filter("value > threshold")
+          .localPartition({})
+          .orderBy({"value DESC"}, false)
+          .project({"ps_partkey", "value"})
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partsuppScanNodeIdSubQuery] = getTableFilePaths(kPartsupp);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[supplierScanNodeIdSubQuery] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[nationScanNodeIdSubQuery] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ12Plan() const {
   std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderpriority"};
   std::vector<std::string> lineitemColumns = {
@@ -1613,6 +1948,124 @@ TpchPlan TpchQueryBuilder::getQ19Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ20Plan() const {
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_address", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty"};
+  std::vector<std::string> partColumns = {"p_partkey", "p_name"};
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey", "l_suppkey", "l_quantity", "l_shipdate"};
+
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const std::string shipDateFilter = formatDateFilter(
+      "l_shipdate", lineitemSelectedRowType, "'1994-01-01'", "'1994-12-31'");
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {},
+                      "p_name like 'forest%'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto shippedQuantity =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .partialAggregation(
+              {"l_partkey", "l_suppkey"}, {"sum(l_quantity) as sum_quantity"})
+          .localPartition({"l_partkey", "l_suppkey"})
+          .finalAggregation()
+          .planNode();
+
+  // The suppliers with more than half of the quantity shipped in 1994 of a
+  // forest part available. A part without shipments has no row in
+  // 'shippedQuantity', matching the null comparison in the query.
+  auto partsupp =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_availqty"},
+              core::JoinType::kLeftSemiFilter)
+          .hashJoin(
+              {"ps_partkey", "ps_suppkey"},
+              {"l_partkey", "l_suppkey"},
+              shippedQuantity,
+              "ps_availqty > 0.5 * sum_quantity",
+              {"ps_suppkey"})
+          .planNode();
+
+  auto nation = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kNation,
+                        nationSelectedRowType,
+                        nationFileColumns,
+                        {"n_name = 'CANADA'"})
+                    .capturePlanNodeId(nationScanNodeId)
+                    .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              {"s_suppkey", "s_name", "s_address"})
+          .hashJoin(
+              {"s_suppkey"},
+              {"ps_suppkey"},
+              partsupp,
+              "",
+              {"s_name", "s_address"},
+              core::JoinType::kLeftSemiFilter)
+          .localPartition({})
+          .orderBy({"s_name"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ21Plan() const {
   std::vector<std::string> supplierColumns = {
       "s_nationkey", "s_name", "s_suppkey"};
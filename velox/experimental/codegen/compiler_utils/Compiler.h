@@ -17,6 +17,7 @@
 #include "glog/logging.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/experimental/codegen/compiler_utils/CompilerOptions.h"
+#include "velox/experimental/codegen/compiler_utils/LibraryCache.h"
 #include "velox/experimental/codegen/external_process/Command.h"
 #include "velox/experimental/codegen/external_process/subprocess.h"
 #include "velox/experimental/codegen/utils/timer/NestedScopedTimer.h"
@@ -31,6 +32,7 @@ class Compiler {
   std::vector<std::string> defaultLinkingArgs_;
   filesystem::PathGenerator pathGenerator_;
   DefaultScopedTimer::EventSequence& eventSequence_;
+  std::optional<LibraryCache> libraryCache_;
 
  public:
   explicit Compiler(
@@ -50,6 +52,9 @@ class Compiler {
     defaultLinkingArgs_.push_back(
         compilerOptions_
             .optimizationLevel); // Important when we start doing lto
+    if (compilerOptions_.libraryCacheDirectory.has_value()) {
+      libraryCache_.emplace(*compilerOptions_.libraryCacheDirectory);
+    }
   }
 
   explicit Compiler(DefaultScopedTimer::EventSequence& eventSequence)
@@ -67,6 +72,9 @@ class Compiler {
     defaultLinkingArgs_.push_back(
         compilerOptions_
             .optimizationLevel); // Important when we start doing lto
+    if (compilerOptions_.libraryCacheDirectory.has_value()) {
+      libraryCache_.emplace(*compilerOptions_.libraryCacheDirectory);
+    }
   }
 
   CompilerOptions& compilerOptions() {
@@ -177,6 +185,39 @@ class Compiler {
     return;
   }
 
+  /// Compiles and links a given c++ string into a dynamic library, or copies
+  /// the library from the library cache if the same string was compiled with
+  /// the same options before.
+  /// \param additionalLibraries
+  /// \param cppContent  c++ file content
+  /// \return path the generated .so
+  std::filesystem::path compileAndLink(
+      const std::vector<LibraryDescriptor>& additionalLibraries,
+      const std::string& cppContent) {
+    if (!libraryCache_.has_value()) {
+      auto objectPath = compileString(additionalLibraries, cppContent);
+      return link(additionalLibraries, {objectPath});
+    }
+    auto key = libraryCacheKey(additionalLibraries, cppContent);
+    auto dynamicLibPath = pathGenerator_.tempPath("dyn", ".so");
+    {
+      DefaultScopedTimer timer("LibraryCacheGet", eventSequence_);
+      if (libraryCache_->get(key, dynamicLibPath)) {
+        return dynamicLibPath;
+      }
+    }
+    link(
+        additionalLibraries,
+        {compileString(additionalLibraries, cppContent)},
+        dynamicLibPath);
+    libraryCache_->put(key, dynamicLibPath);
+    return dynamicLibPath;
+  }
+
+  const std::optional<LibraryCache>& libraryCache() const {
+    return libraryCache_;
+  }
+
   /// link multiple binary files
   /// \param additionalLibraries
   /// \param binaryFiles
@@ -267,6 +308,21 @@ class Compiler {
   }
 
  private:
+  // The options that do not affect the library are left out of the key.
+  std::string libraryCacheKey(
+      const std::vector<LibraryDescriptor>& additionalLibraries,
+      const std::string& cppContent) const {
+    auto options = compilerOptions_;
+    options.tempDirectory.clear();
+    options.libraryCacheDirectory.reset();
+    options.defaultLibraries.insert(
+        options.defaultLibraries.end(),
+        additionalLibraries.begin(),
+        additionalLibraries.end());
+    return LibraryCache::makeKey(
+        cppContent, CompilerOptions::formatAsJson(options));
+  }
+
   void includePathArgs(
       const LibraryDescriptor& library,
       std::vector<std::string>& args) {
@@ -39,6 +39,10 @@ struct CompilerOptions {
   std::optional<std::filesystem::path> linker;
   std::optional<std::filesystem::path> formatterPath;
   std::filesystem::path tempDirectory;
+  /// If set, linked libraries are kept in this directory and reused by later
+  /// compilations of the same code with the same options, also by other
+  /// processes. See LibraryCache.
+  std::optional<std::filesystem::path> libraryCacheDirectory;
 
   /// Converts a CompilerOptionsProto to a CompilerOptions
   static CompilerOptions fromProto(
@@ -74,6 +78,10 @@ struct CompilerOptions {
     if (!compilerOptionsProto.formatterpath().empty()) {
       compilerOptions.withFormatterPath(compilerOptionsProto.formatterpath());
     }
+    if (!compilerOptionsProto.librarycachedirectory().empty()) {
+      compilerOptions.withLibraryCacheDirectory(
+          compilerOptionsProto.librarycachedirectory());
+    }
     return compilerOptions;
   }
 
@@ -135,6 +143,8 @@ struct CompilerOptions {
     compilerOptionsProto.set_formatterpath(
         compilerOptions.formatterPath.value_or(""));
     compilerOptionsProto.set_tempdirectory(compilerOptions.tempDirectory);
+    compilerOptionsProto.set_librarycachedirectory(
+        compilerOptions.libraryCacheDirectory.value_or(""));
 
     return compilerOptionsProto;
   }
@@ -202,5 +212,11 @@ struct CompilerOptions {
     formatterPath = path;
     return *this;
   }
+
+  CompilerOptions& withLibraryCacheDirectory(
+      const std::filesystem::path& path) {
+    libraryCacheDirectory = path;
+    return *this;
+  }
 };
 } // namespace facebook::velox::codegen::compiler_utils
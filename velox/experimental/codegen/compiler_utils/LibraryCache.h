@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include "fmt/format.h"
+
+namespace facebook::velox::codegen::compiler_utils {
+
+/// On disk cache of the dynamic libraries linked from generated code. A
+/// library is keyed by its source and the compiler options it was built with,
+/// so that a process that generates the same code as an earlier process with
+/// the same options loads the earlier library instead of compiling it again.
+/// The directory may be shared by concurrent processes: entries are written
+/// under temporary names and renamed into place.
+class LibraryCache {
+ public:
+  explicit LibraryCache(std::filesystem::path directory)
+      : directory_(std::move(directory)) {
+    std::filesystem::create_directories(directory_);
+  }
+
+  /// Returns the key for a library built from 'source' with 'options', which
+  /// is the Json representation of the compiler options.
+  static std::string makeKey(
+      const std::string& source,
+      const std::string& options) {
+    return fmt::format("{}\n{}", options, source);
+  }
+
+  /// Copies the library for 'key' to 'target' and returns true if there is
+  /// one. The copy gets its own path, so that loading it does not clash with
+  /// other loads of the same library in the process.
+  bool get(const std::string& key, const std::filesystem::path& target) {
+    const auto name = fileName(key);
+    const auto libraryPath = directory_ / (name + ".so");
+    std::error_code error;
+    if (!std::filesystem::exists(libraryPath, error)) {
+      ++numMisses_;
+      return false;
+    }
+    // Different keys with the same hash replace each other.
+    std::ifstream keyFile(directory_ / (name + ".key"));
+    std::stringstream storedKey;
+    storedKey << keyFile.rdbuf();
+    if (storedKey.str() != key ||
+        !std::filesystem::copy_file(
+            libraryPath,
+            target,
+            std::filesystem::copy_options::overwrite_existing,
+            error)) {
+      ++numMisses_;
+      return false;
+    }
+    ++numHits_;
+    return true;
+  }
+
+  /// Adds the library at 'library' for 'key'.
+  void put(const std::string& key, const std::filesystem::path& library) {
+    const auto name = fileName(key);
+    const auto temp = directory_ /
+        fmt::format("{}.{}.tmp", name, reinterpret_cast<uintptr_t>(this));
+    std::error_code error;
+    {
+      std::ofstream keyFile(temp);
+      keyFile << key;
+      if (!keyFile) {
+        std::filesystem::remove(temp, error);
+        return;
+      }
+    }
+    // The key is renamed into place before the library, so that a reader
+    // never sees a library with the key of another.
+    std::filesystem::rename(temp, directory_ / (name + ".key"), error);
+    if (error ||
+        !std::filesystem::copy_file(
+            library,
+            temp,
+            std::filesystem::copy_options::overwrite_existing,
+            error)) {
+      return;
+    }
+    std::filesystem::rename(temp, directory_ / (name + ".so"), error);
+  }
+
+  const std::filesystem::path& directory() const {
+    return directory_;
+  }
+
+  int64_t numHits() const {
+    return numHits_;
+  }
+
+  int64_t numMisses() const {
+    return numMisses_;
+  }
+
+ private:
+  static std::string fileName(const std::string& key) {
+    return fmt::format("{:016x}", std::hash<std::string>{}(key));
+  }
+
+  const std::filesystem::path directory_;
+  int64_t numHits_{0};
+  int64_t numMisses_{0};
+};
+
+} // namespace facebook::velox::codegen::compiler_utils
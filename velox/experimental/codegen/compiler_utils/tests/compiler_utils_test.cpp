@@ -290,4 +290,49 @@ TEST(Compiler, CompileAndLink) {
   ASSERT_EQ(dlerror(), nullptr);
   ASSERT_EQ(f(), 24);
 };
+
+TEST(Compiler, LibraryCache) {
+  auto sourceCode = R"a(
+  extern "C" {
+  int h() {
+    return 42;
+  };
+  }
+  )a";
+
+  auto cacheDirectory = boost::filesystem::unique_path(
+                            fmt::format(
+                                "{}/%%%%-%%%%",
+                                boost::filesystem::temp_directory_path()
+                                    .string()))
+                            .string();
+  auto options = testCompilerOptions().withLibraryCacheDirectory(
+      std::filesystem::path(cacheDirectory));
+
+  DefaultScopedTimer::EventSequence eventSequence;
+  Compiler compiler(options, eventSequence);
+  auto sharedObject = compiler.compileAndLink({}, sourceCode);
+  ASSERT_EQ(compiler.libraryCache()->numMisses(), 1);
+
+  // A second compiler, as in a later process, finds the library.
+  Compiler secondCompiler(options, eventSequence);
+  auto cachedObject = secondCompiler.compileAndLink({}, sourceCode);
+  ASSERT_EQ(secondCompiler.libraryCache()->numHits(), 1);
+  ASSERT_NE(sharedObject, cachedObject);
+
+  auto libraryPtr =
+      native_loader::NativeLibraryLoader::loadLibraryInternal(cachedObject);
+  auto h = (int (*)())dlsym(libraryPtr, "h");
+  ASSERT_EQ(h(), 42);
+
+  // Other options or other code are compiled.
+  options.withOptimizationLevel("-O1");
+  Compiler otherOptions(options, eventSequence);
+  otherOptions.compileAndLink({}, sourceCode);
+  ASSERT_EQ(otherOptions.libraryCache()->numMisses(), 1);
+  secondCompiler.compileAndLink({}, std::string(sourceCode) + "\n");
+  ASSERT_EQ(secondCompiler.libraryCache()->numMisses(), 1);
+
+  std::filesystem::remove_all(cacheDirectory);
+}
 } // namespace facebook::velox::codegen::compiler_utils::test
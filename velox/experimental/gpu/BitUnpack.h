@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "velox/experimental/gpu/Common.h"
+
+namespace facebook::velox::gpu {
+
+/// A run of 'numValues' bit fields of 'bitWidth' bits at 'inputOffset' in the
+/// input of a GpuBitUnpacker, unpacked to 'outputOffset' in its output.
+struct BitUnpackRun {
+  uint64_t inputOffset;
+  uint64_t outputOffset;
+  uint32_t numValues;
+  uint8_t bitWidth;
+  /// True for the bit packing of ORC RLEv2, where the first field starts at
+  /// the most significant bit of the first byte. False for Parquet and DWRF
+  /// RLEv1, where the first field starts at the least significant bit.
+  bool bigEndian;
+};
+
+namespace detail {
+
+__device__ inline uint64_t
+unpackLittleEndian(const uint8_t* input, uint64_t bit, uint8_t bitWidth) {
+  uint64_t value = 0;
+  int shift = -static_cast<int>(bit % 8);
+  for (auto byte = bit / 8; shift < bitWidth; ++byte, shift += 8) {
+    uint64_t bits = input[byte];
+    value |= shift < 0 ? bits >> -shift : bits << shift;
+  }
+  return bitWidth == 64 ? value : value & ((1ULL << bitWidth) - 1);
+}
+
+// Accumulates the 'bitWidth' bits from the first byte on, so that a field of
+// 64 bits over 9 bytes does not overflow 'value'.
+__device__ inline uint64_t
+unpackBigEndian(const uint8_t* input, uint64_t bit, uint8_t bitWidth) {
+  auto byte = bit / 8;
+  const int skip = bit % 8;
+  uint64_t value = input[byte++] & (0xff >> skip);
+  int remaining = static_cast<int>(bitWidth) - (8 - skip);
+  if (remaining <= 0) {
+    return value >> -remaining;
+  }
+  for (; remaining >= 8; remaining -= 8) {
+    value = (value << 8) | input[byte++];
+  }
+  if (remaining > 0) {
+    value = (value << remaining) | (input[byte] >> (8 - remaining));
+  }
+  return value;
+}
+
+// One block row per run in 'runs'.
+template <typename T>
+__global__ void
+unpackKernel(const uint8_t* input, const BitUnpackRun* runs, T* output) {
+  const auto& run = runs[blockIdx.y];
+  for (uint32_t i = threadIdx.x + blockIdx.x * blockDim.x; i < run.numValues;
+       i += blockDim.x * gridDim.x) {
+    const uint64_t bit = static_cast<uint64_t>(i) * run.bitWidth;
+    const auto* runInput = input + run.inputOffset;
+    output[run.outputOffset + i] = static_cast<T>(
+        run.bigEndian ? unpackBigEndian(runInput, bit, run.bitWidth)
+                      : unpackLittleEndian(runInput, bit, run.bitWidth));
+  }
+}
+
+} // namespace detail
+
+/// Unpacks bit packed integers of many runs, e.g. the streams of the column
+/// chunks of a coalesced load, on the GPU. The runs added between flushes are
+/// copied to the device together with their descriptors in a single transfer
+/// from pinned memory, unpacked by one kernel launch and copied back in a
+/// single transfer. A reader decodes the runs the unpacker does not take
+/// (add() returns false) on the CPU.
+template <typename T>
+class GpuBitUnpacker {
+ public:
+  /// 'maxInputBytes' and 'maxValues' bound the packed bytes and unpacked
+  /// values between flushes. 'maxRuns' bounds the number of runs.
+  GpuBitUnpacker(uint64_t maxInputBytes, uint64_t maxValues, int32_t maxRuns)
+      : maxInputBytes_(maxInputBytes),
+        maxValues_(maxValues),
+        maxRuns_(maxRuns),
+        stream_(createCudaStream()) {
+    CUDA_CHECK_FATAL(cudaMallocHost(&hostInput_, maxInputBytes));
+    CUDA_CHECK_FATAL(cudaMallocHost(&hostRuns_, maxRuns * sizeof(*hostRuns_)));
+    CUDA_CHECK_FATAL(cudaMallocHost(&hostOutput_, maxValues * sizeof(T)));
+    CUDA_CHECK_FATAL(cudaMalloc(&deviceInput_, maxInputBytes));
+    CUDA_CHECK_FATAL(cudaMalloc(&deviceRuns_, maxRuns * sizeof(*hostRuns_)));
+    CUDA_CHECK_FATAL(cudaMalloc(&deviceOutput_, maxValues * sizeof(T)));
+  }
+
+  ~GpuBitUnpacker() {
+    CUDA_CHECK_LOG(cudaFree(deviceOutput_));
+    CUDA_CHECK_LOG(cudaFree(deviceRuns_));
+    CUDA_CHECK_LOG(cudaFree(deviceInput_));
+    CUDA_CHECK_LOG(cudaFreeHost(hostOutput_));
+    CUDA_CHECK_LOG(cudaFreeHost(hostRuns_));
+    CUDA_CHECK_LOG(cudaFreeHost(hostInput_));
+  }
+
+  GpuBitUnpacker(const GpuBitUnpacker&) = delete;
+  GpuBitUnpacker& operator=(const GpuBitUnpacker&) = delete;
+
+  /// Adds 'numValues' fields of 'bitWidth' bits at 'input' to be unpacked into
+  /// 'result' by the next flush(). 'input' is copied and 'result' must stay
+  /// valid until the flush. Returns false if the run does not fit before the
+  /// next flush or 'bitWidth' is not between 1 and the width of T.
+  bool add(
+      const uint8_t* input,
+      uint32_t numValues,
+      uint8_t bitWidth,
+      bool bigEndian,
+      T* result) {
+    if (bitWidth == 0 || bitWidth > sizeof(T) * 8) {
+      return false;
+    }
+    const auto inputBytes =
+        (static_cast<uint64_t>(numValues) * bitWidth + 7) / 8;
+    if (numRuns_ == maxRuns_ || inputBytes_ + inputBytes > maxInputBytes_ ||
+        numValues_ + numValues > maxValues_) {
+      return false;
+    }
+    memcpy(hostInput_ + inputBytes_, input, inputBytes);
+    hostRuns_[numRuns_++] = {
+        inputBytes_, numValues_, numValues, bitWidth, bigEndian};
+    results_.push_back(result);
+    inputBytes_ += inputBytes;
+    numValues_ += numValues;
+    maxRunValues_ = std::max(maxRunValues_, numValues);
+    return true;
+  }
+
+  /// Unpacks the runs added since the last flush into their results.
+  void flush() {
+    if (numRuns_ == 0) {
+      return;
+    }
+    auto stream = stream_.get();
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        deviceInput_,
+        hostInput_,
+        inputBytes_,
+        cudaMemcpyHostToDevice,
+        stream));
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        deviceRuns_,
+        hostRuns_,
+        numRuns_ * sizeof(*hostRuns_),
+        cudaMemcpyHostToDevice,
+        stream));
+    constexpr int kBlockSize = 256;
+    const dim3 numBlocks(
+        std::min<uint32_t>(1024, (maxRunValues_ + kBlockSize - 1) / kBlockSize),
+        numRuns_);
+    detail::unpackKernel<<<numBlocks, kBlockSize, 0, stream>>>(
+        deviceInput_, deviceRuns_, deviceOutput_);
+    CUDA_CHECK_FATAL(cudaGetLastError());
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        hostOutput_,
+        deviceOutput_,
+        numValues_ * sizeof(T),
+        cudaMemcpyDeviceToHost,
+        stream));
+    CUDA_CHECK_FATAL(cudaStreamSynchronize(stream));
+    for (int32_t i = 0; i < numRuns_; ++i) {
+      const auto& run = hostRuns_[i];
+      memcpy(
+          results_[i],
+          hostOutput_ + run.outputOffset,
+          run.numValues * sizeof(T));
+    }
+    results_.clear();
+    numRuns_ = 0;
+    inputBytes_ = 0;
+    numValues_ = 0;
+    maxRunValues_ = 0;
+  }
+
+ private:
+  const uint64_t maxInputBytes_;
+  const uint64_t maxValues_;
+  const int32_t maxRuns_;
+  CudaStream stream_;
+  uint8_t* hostInput_;
+  BitUnpackRun* hostRuns_;
+  T* hostOutput_;
+  uint8_t* deviceInput_;
+  BitUnpackRun* deviceRuns_;
+  T* deviceOutput_;
+  std::vector<T*> results_;
+  int32_t numRuns_{0};
+  uint64_t inputBytes_{0};
+  uint64_t numValues_{0};
+  uint32_t maxRunValues_{0};
+};
+
+} // namespace facebook::velox::gpu
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "velox/experimental/gpu/HashTable.h"
+
+namespace facebook::velox::gpu {
+
+namespace detail {
+
+constexpr int kBlockSize = 256;
+constexpr int kMaxBlocks = 1024;
+
+inline int numBlocks(int32_t numRows) {
+  return std::max(
+      1, std::min(kMaxBlocks, (numRows + kBlockSize - 1) / kBlockSize));
+}
+
+/// Per group accumulators of GpuHashAggregation, one element per slot of the
+/// hash table. Sums wrap around on overflow like int64_t addition.
+struct Accumulators {
+  unsigned long long* counts;
+  unsigned long long* sums;
+  long long* mins;
+  long long* maxs;
+};
+
+__global__ void aggregateKernel(
+    HashTableView table,
+    const int64_t* keys,
+    const int64_t* values,
+    int32_t numRows,
+    Accumulators accumulators) {
+  for (int32_t row = threadIdx.x + blockIdx.x * blockDim.x; row < numRows;
+       row += blockDim.x * gridDim.x) {
+    const auto slot = table.findOrInsert(keys[row]);
+    if (slot == HashTableView::kNotFound) {
+      return;
+    }
+    const auto value = values[row];
+    atomicAdd(accumulators.counts + slot, 1ULL);
+    atomicAdd(
+        accumulators.sums + slot, static_cast<unsigned long long>(value));
+    atomicMin(accumulators.mins + slot, static_cast<long long>(value));
+    atomicMax(accumulators.maxs + slot, static_cast<long long>(value));
+  }
+}
+
+__global__ void buildKernel(
+    HashTableView table,
+    const int64_t* keys,
+    int32_t numRows,
+    int32_t* buildRows,
+    int32_t* duplicate) {
+  for (int32_t row = threadIdx.x + blockIdx.x * blockDim.x; row < numRows;
+       row += blockDim.x * gridDim.x) {
+    const auto slot = table.findOrInsert(keys[row]);
+    if (slot == HashTableView::kNotFound) {
+      return;
+    }
+    if (atomicCAS(buildRows + slot, -1, row) != -1) {
+      atomicExch(duplicate, 1);
+    }
+  }
+}
+
+__global__ void probeKernel(
+    HashTableView table,
+    const int32_t* buildRows,
+    const int64_t* keys,
+    int32_t numRows,
+    int32_t* matches) {
+  for (int32_t row = threadIdx.x + blockIdx.x * blockDim.x; row < numRows;
+       row += blockDim.x * gridDim.x) {
+    const auto slot = table.find(keys[row]);
+    matches[row] = slot == HashTableView::kNotFound ? -1 : buildRows[slot];
+  }
+}
+
+template <typename T>
+CudaPtr<T[]> deviceArray(size_t size) {
+  T* data;
+  CUDA_CHECK_FATAL(cudaMalloc(&data, size * sizeof(T)));
+  return CudaPtr<T[]>(data);
+}
+
+// Pinned host memory, which the copies to and from the device can read and
+// write without staging.
+template <typename T>
+struct PinnedArray {
+  explicit PinnedArray(size_t size) {
+    CUDA_CHECK_FATAL(cudaMallocHost(&data, size * sizeof(T)));
+  }
+
+  ~PinnedArray() {
+    CUDA_CHECK_LOG(cudaFreeHost(data));
+  }
+
+  PinnedArray(const PinnedArray&) = delete;
+  PinnedArray& operator=(const PinnedArray&) = delete;
+
+  T* data;
+};
+
+inline bool readFlag(const int32_t* deviceFlag) {
+  int32_t flag;
+  CUDA_CHECK_FATAL(
+      cudaMemcpy(&flag, deviceFlag, sizeof(int32_t), cudaMemcpyDeviceToHost));
+  return flag != 0;
+}
+
+} // namespace detail
+
+/// Computes count, sum, min and max of 64 bit values grouped on 64 bit keys
+/// on the GPU. Each batch is copied to one of two pinned host buffers and
+/// from there to one of two device buffers on its own stream, so that the
+/// copy of a batch overlaps the aggregation of the previous batch, as in
+/// DoubleBufferProcessTest. The keys and values must not be null. Callers
+/// with other types or with nulls aggregate on the CPU, as do callers for
+/// which finish() returns std::nullopt.
+class GpuHashAggregation {
+ public:
+  struct Result {
+    std::vector<int64_t> keys;
+    std::vector<int64_t> counts;
+    std::vector<int64_t> sums;
+    std::vector<int64_t> mins;
+    std::vector<int64_t> maxs;
+  };
+
+  /// 'maxGroups' is the number of distinct keys that fit. The table has at
+  /// least twice as many slots. 'maxBatchRows' is the largest batch that can
+  /// be added.
+  GpuHashAggregation(int32_t maxGroups, int32_t maxBatchRows)
+      : maxBatchRows_(maxBatchRows),
+        streams_{createCudaStream(), createCudaStream()},
+        batchDone_{createCudaEvent(), createCudaEvent()},
+        table_(2 * maxGroups, streams_[0].get()) {
+    const auto numSlots = table_.view().numSlots();
+    counts_ = detail::deviceArray<unsigned long long>(numSlots);
+    sums_ = detail::deviceArray<unsigned long long>(numSlots);
+    mins_ = detail::deviceArray<long long>(numSlots);
+    maxs_ = detail::deviceArray<long long>(numSlots);
+    auto stream = streams_[0].get();
+    CUDA_CHECK_FATAL(cudaMemsetAsync(
+        counts_.get(), 0, numSlots * sizeof(unsigned long long), stream));
+    CUDA_CHECK_FATAL(cudaMemsetAsync(
+        sums_.get(), 0, numSlots * sizeof(unsigned long long), stream));
+    detail::fill(
+        mins_.get(), numSlots, std::numeric_limits<long long>::max(), stream);
+    detail::fill(
+        maxs_.get(), numSlots, std::numeric_limits<long long>::min(), stream);
+    for (auto i = 0; i < 2; ++i) {
+      hostBuffers_.emplace_back(2 * maxBatchRows);
+      deviceBuffers_.push_back(detail::deviceArray<int64_t>(2 * maxBatchRows));
+    }
+    // The batches on the second stream run after the initialization.
+    CUDA_CHECK_FATAL(cudaEventRecord(batchDone_[1].get(), stream));
+    CUDA_CHECK_FATAL(
+        cudaStreamWaitEvent(streams_[1].get(), batchDone_[1].get(), 0));
+  }
+
+  /// Adds 'numRows' keys and values. Returns after these are copied to pinned
+  /// memory, the aggregation runs asynchronously.
+  void addInput(const int64_t* keys, const int64_t* values, int32_t numRows) {
+    assert(numRows <= maxBatchRows_);
+    const auto buffer = numBatches_++ % 2;
+    auto stream = streams_[buffer].get();
+    // The previous batch in 'buffer' must be done before it is overwritten.
+    CUDA_CHECK_FATAL(cudaEventSynchronize(batchDone_[buffer].get()));
+    auto* host = hostBuffers_[buffer].data;
+    memcpy(host, keys, numRows * sizeof(int64_t));
+    memcpy(host + numRows, values, numRows * sizeof(int64_t));
+    auto* device = deviceBuffers_[buffer].get();
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        device,
+        host,
+        2 * numRows * sizeof(int64_t),
+        cudaMemcpyHostToDevice,
+        stream));
+    detail::aggregateKernel<<<
+        detail::numBlocks(numRows),
+        detail::kBlockSize,
+        0,
+        stream>>>(
+        table_.view(),
+        device,
+        device + numRows,
+        numRows,
+        {counts_.get(), sums_.get(), mins_.get(), maxs_.get()});
+    CUDA_CHECK_FATAL(cudaGetLastError());
+    CUDA_CHECK_FATAL(cudaEventRecord(batchDone_[buffer].get(), stream));
+  }
+
+  /// Waits for the added batches and returns the groups in no particular
+  /// order. Returns std::nullopt if there were more than 'maxGroups' distinct
+  /// keys.
+  std::optional<Result> finish() {
+    for (auto& stream : streams_) {
+      CUDA_CHECK_FATAL(cudaStreamSynchronize(stream.get()));
+    }
+    const auto& view = table_.view();
+    if (detail::readFlag(view.overflow)) {
+      return std::nullopt;
+    }
+    const auto numSlots = view.numSlots();
+    std::vector<int64_t> keys(numSlots);
+    std::vector<int64_t> counts(numSlots);
+    std::vector<int64_t> sums(numSlots);
+    std::vector<int64_t> mins(numSlots);
+    std::vector<int64_t> maxs(numSlots);
+    auto copy = [&](std::vector<int64_t>& out, const void* device) {
+      CUDA_CHECK_FATAL(cudaMemcpy(
+          out.data(),
+          device,
+          numSlots * sizeof(int64_t),
+          cudaMemcpyDeviceToHost));
+    };
+    copy(keys, view.keys);
+    copy(counts, counts_.get());
+    copy(sums, sums_.get());
+    copy(mins, mins_.get());
+    copy(maxs, maxs_.get());
+    // A slot is used if it has rows, which also covers kEmptyKey.
+    Result result;
+    for (uint32_t slot = 0; slot < numSlots; ++slot) {
+      if (counts[slot] == 0) {
+        continue;
+      }
+      result.keys.push_back(keys[slot]);
+      result.counts.push_back(counts[slot]);
+      result.sums.push_back(sums[slot]);
+      result.mins.push_back(mins[slot]);
+      result.maxs.push_back(maxs[slot]);
+    }
+    return result;
+  }
+
+ private:
+  const int32_t maxBatchRows_;
+  CudaStream streams_[2];
+  CudaEvent batchDone_[2];
+  DeviceHashTable table_;
+  CudaPtr<unsigned long long[]> counts_;
+  CudaPtr<unsigned long long[]> sums_;
+  CudaPtr<long long[]> mins_;
+  CudaPtr<long long[]> maxs_;
+  // Keys followed by values of a batch.
+  std::vector<detail::PinnedArray<int64_t>> hostBuffers_;
+  std::vector<CudaPtr<int64_t[]>> deviceBuffers_;
+  int64_t numBatches_{0};
+};
+
+/// Probes 64 bit keys against a build side with unique 64 bit keys on the
+/// GPU and returns the matching build row of each probe row. The keys must
+/// not be null. A build side with duplicate keys or more keys than fit is
+/// rejected by build(), the caller then joins on the CPU.
+class GpuHashProbe {
+ public:
+  /// 'maxBuildRows' is the number of build keys that fit. 'maxBatchRows' is
+  /// the largest probe batch.
+  GpuHashProbe(int32_t maxBuildRows, int32_t maxBatchRows)
+      : maxBuildRows_(maxBuildRows),
+        maxBatchRows_(maxBatchRows),
+        stream_(createCudaStream()),
+        table_(2 * maxBuildRows, stream_.get()),
+        buildRows_(detail::deviceArray<int32_t>(table_.view().numSlots())),
+        flags_(detail::deviceArray<int32_t>(1)),
+        hostKeys_(std::max(maxBuildRows, maxBatchRows)),
+        hostMatches_(maxBatchRows),
+        deviceKeys_(
+            detail::deviceArray<int64_t>(std::max(maxBuildRows, maxBatchRows))),
+        deviceMatches_(detail::deviceArray<int32_t>(maxBatchRows)) {
+    detail::fill(
+        buildRows_.get(), table_.view().numSlots(), -1, stream_.get());
+    CUDA_CHECK_FATAL(
+        cudaMemsetAsync(flags_.get(), 0, sizeof(int32_t), stream_.get()));
+  }
+
+  /// Inserts 'numRows' build keys. Row i of the build side is keys[i]. Returns
+  /// false if the keys are not unique or do not fit.
+  bool build(const int64_t* keys, int32_t numRows) {
+    assert(numRows <= maxBuildRows_);
+    copyKeys(keys, numRows);
+    detail::buildKernel<<<
+        detail::numBlocks(numRows),
+        detail::kBlockSize,
+        0,
+        stream_.get()>>>(
+        table_.view(),
+        deviceKeys_.get(),
+        numRows,
+        buildRows_.get(),
+        flags_.get());
+    CUDA_CHECK_FATAL(cudaGetLastError());
+    CUDA_CHECK_FATAL(cudaStreamSynchronize(stream_.get()));
+    return !detail::readFlag(table_.view().overflow) &&
+        !detail::readFlag(flags_.get());
+  }
+
+  /// Sets 'matches[i]' to the build row with key 'keys[i]' or -1 if there is
+  /// none.
+  void probe(const int64_t* keys, int32_t numRows, int32_t* matches) {
+    assert(numRows <= maxBatchRows_);
+    copyKeys(keys, numRows);
+    detail::probeKernel<<<
+        detail::numBlocks(numRows),
+        detail::kBlockSize,
+        0,
+        stream_.get()>>>(
+        table_.view(),
+        buildRows_.get(),
+        deviceKeys_.get(),
+        numRows,
+        deviceMatches_.get());
+    CUDA_CHECK_FATAL(cudaGetLastError());
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        hostMatches_.data,
+        deviceMatches_.get(),
+        numRows * sizeof(int32_t),
+        cudaMemcpyDeviceToHost,
+        stream_.get()));
+    CUDA_CHECK_FATAL(cudaStreamSynchronize(stream_.get()));
+    memcpy(matches, hostMatches_.data, numRows * sizeof(int32_t));
+  }
+
+ private:
+  void copyKeys(const int64_t* keys, int32_t numRows) {
+    memcpy(hostKeys_.data, keys, numRows * sizeof(int64_t));
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        deviceKeys_.get(),
+        hostKeys_.data,
+        numRows * sizeof(int64_t),
+        cudaMemcpyHostToDevice,
+        stream_.get()));
+  }
+
+  const int32_t maxBuildRows_;
+  const int32_t maxBatchRows_;
+  CudaStream stream_;
+  DeviceHashTable table_;
+  // The build row of each slot of 'table_' or -1.
+  CudaPtr<int32_t[]> buildRows_;
+  // Set if the build keys have duplicates.
+  CudaPtr<int32_t[]> flags_;
+  detail::PinnedArray<int64_t> hostKeys_;
+  detail::PinnedArray<int32_t> hostMatches_;
+  CudaPtr<int64_t[]> deviceKeys_;
+  CudaPtr<int32_t[]> deviceMatches_;
+};
+
+} // namespace facebook::velox::gpu
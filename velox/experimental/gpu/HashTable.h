@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "velox/experimental/gpu/Common.h"
+
+namespace facebook::velox::gpu {
+
+/// Open addressing hash table of 64 bit keys in device memory that the
+/// threads of a kernel fill concurrently. A slot is claimed by a compare and
+/// swap of its key from kEmptyKey. kEmptyKey itself is kept in an extra slot
+/// after the others. The table does not grow: if all slots are taken, an
+/// insert sets 'overflow' and the caller has to redo the work with a larger
+/// table or on the CPU.
+struct HashTableView {
+  static constexpr int64_t kEmptyKey = std::numeric_limits<int64_t>::min();
+  static constexpr int32_t kNotFound = -1;
+
+  /// numSlots() keys. The last slot is for kEmptyKey.
+  int64_t* keys;
+  /// Set to 1 once kEmptyKey is inserted.
+  int32_t* emptyKeyUsed;
+  /// Set to 1 if an insert found no free slot.
+  int32_t* overflow;
+  /// The number of slots for keys other than kEmptyKey minus 1. The number of
+  /// slots is a power of 2.
+  uint32_t capacityMask;
+
+  __host__ __device__ uint32_t numSlots() const {
+    return capacityMask + 2;
+  }
+
+  __device__ static uint64_t hash(int64_t key) {
+    auto h = static_cast<uint64_t>(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /// Returns the slot of 'key', inserting it if needed, or kNotFound if the
+  /// table is full.
+  __device__ int32_t findOrInsert(int64_t key) {
+    const uint32_t capacity = capacityMask + 1;
+    if (key == kEmptyKey) {
+      atomicExch(emptyKeyUsed, 1);
+      return capacity;
+    }
+    uint32_t slot = hash(key) & capacityMask;
+    for (uint32_t i = 0; i < capacity; ++i) {
+      auto previous = static_cast<int64_t>(atomicCAS(
+          reinterpret_cast<unsigned long long*>(keys + slot),
+          static_cast<unsigned long long>(kEmptyKey),
+          static_cast<unsigned long long>(key)));
+      if (previous == kEmptyKey || previous == key) {
+        return slot;
+      }
+      slot = (slot + 1) & capacityMask;
+    }
+    atomicExch(overflow, 1);
+    return kNotFound;
+  }
+
+  /// Returns the slot of 'key' or kNotFound. Must not run concurrently with
+  /// inserts.
+  __device__ int32_t find(int64_t key) const {
+    const uint32_t capacity = capacityMask + 1;
+    if (key == kEmptyKey) {
+      return *emptyKeyUsed ? capacity : kNotFound;
+    }
+    uint32_t slot = hash(key) & capacityMask;
+    for (uint32_t i = 0; i < capacity; ++i) {
+      const auto slotKey = keys[slot];
+      if (slotKey == key) {
+        return slot;
+      }
+      if (slotKey == kEmptyKey) {
+        return kNotFound;
+      }
+      slot = (slot + 1) & capacityMask;
+    }
+    return kNotFound;
+  }
+};
+
+namespace detail {
+
+template <typename T>
+__global__ void fillKernel(T* data, uint32_t size, T value) {
+  for (uint32_t i = threadIdx.x + blockIdx.x * blockDim.x; i < size;
+       i += blockDim.x * gridDim.x) {
+    data[i] = value;
+  }
+}
+
+template <typename T>
+void fill(T* data, uint32_t size, T value, cudaStream_t stream) {
+  constexpr int kBlockSize = 256;
+  const int numBlocks = std::min<uint32_t>(
+      1024, (size + kBlockSize - 1) / kBlockSize);
+  fillKernel<<<numBlocks, kBlockSize, 0, stream>>>(data, size, value);
+  CUDA_CHECK_FATAL(cudaGetLastError());
+}
+
+} // namespace detail
+
+/// Owns the device memory of a HashTableView.
+class DeviceHashTable {
+ public:
+  /// Makes a table with at least 'minCapacity' slots. 'stream' is used for
+  /// initializing the slots.
+  DeviceHashTable(uint32_t minCapacity, cudaStream_t stream) {
+    uint32_t capacity = 1;
+    while (capacity < minCapacity) {
+      capacity *= 2;
+    }
+    view_.capacityMask = capacity - 1;
+    int64_t* keys;
+    CUDA_CHECK_FATAL(cudaMalloc(&keys, view_.numSlots() * sizeof(int64_t)));
+    keys_.reset(keys);
+    int32_t* flags;
+    CUDA_CHECK_FATAL(cudaMalloc(&flags, 2 * sizeof(int32_t)));
+    flags_.reset(flags);
+    view_.keys = keys;
+    view_.emptyKeyUsed = flags;
+    view_.overflow = flags + 1;
+    detail::fill(keys, view_.numSlots(), HashTableView::kEmptyKey, stream);
+    CUDA_CHECK_FATAL(cudaMemsetAsync(flags, 0, 2 * sizeof(int32_t), stream));
+  }
+
+  const HashTableView& view() const {
+    return view_;
+  }
+
+ private:
+  CudaPtr<int64_t[]> keys_;
+  CudaPtr<int32_t[]> flags_;
+  HashTableView view_;
+};
+
+} // namespace facebook::velox::gpu
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include "velox/experimental/gpu/BitUnpack.h"
+
+DEFINE_int32(num_runs, 64, "");
+DEFINE_int32(run_values, 100'000, "");
+
+namespace facebook::velox::gpu {
+namespace {
+
+// Packs 'values' of 'bitWidth' bits one bit at a time.
+std::vector<uint8_t> pack(
+    const std::vector<uint64_t>& values,
+    uint8_t bitWidth,
+    bool bigEndian) {
+  std::vector<uint8_t> packed((values.size() * bitWidth + 7) / 8);
+  uint64_t position = 0;
+  for (auto value : values) {
+    for (int bit = 0; bit < bitWidth; ++bit, ++position) {
+      const auto valueBit = bigEndian ? bitWidth - 1 - bit : bit;
+      if (value >> valueBit & 1) {
+        packed[position / 8] |=
+            bigEndian ? 0x80 >> (position % 8) : 1 << (position % 8);
+      }
+    }
+  }
+  return packed;
+}
+
+void testUnpack() {
+  GpuBitUnpacker<uint64_t> unpacker(
+      FLAGS_num_runs * FLAGS_run_values * sizeof(uint64_t),
+      FLAGS_num_runs * FLAGS_run_values,
+      FLAGS_num_runs);
+  std::vector<std::vector<uint64_t>> expected(FLAGS_num_runs);
+  std::vector<std::vector<uint64_t>> results(FLAGS_num_runs);
+  uint64_t totalBytes = 0;
+  for (int i = 0; i < FLAGS_num_runs; ++i) {
+    const uint8_t bitWidth = 1 + i % 64;
+    const bool bigEndian = i % 2;
+    const auto mask = bitWidth == 64 ? ~0ULL : (1ULL << bitWidth) - 1;
+    // Odd counts leave a partial last byte.
+    const auto numValues = FLAGS_run_values - i % 7;
+    expected[i].resize(numValues);
+    for (auto& value : expected[i]) {
+      value = folly::Random::rand64() & mask;
+    }
+    results[i].resize(numValues);
+    auto packed = pack(expected[i], bitWidth, bigEndian);
+    totalBytes += packed.size();
+    if (!unpacker.add(
+            packed.data(),
+            numValues,
+            bitWidth,
+            bigEndian,
+            results[i].data())) {
+      fprintf(stderr, "Run %d not added\n", i);
+      abort();
+    }
+  }
+  auto startEvent = createCudaEvent();
+  auto stopEvent = createCudaEvent();
+  CUDA_CHECK_FATAL(cudaEventRecord(startEvent.get()));
+  unpacker.flush();
+  CUDA_CHECK_FATAL(cudaEventRecord(stopEvent.get()));
+  CUDA_CHECK_FATAL(cudaEventSynchronize(stopEvent.get()));
+  float time;
+  CUDA_CHECK_FATAL(
+      cudaEventElapsedTime(&time, startEvent.get(), stopEvent.get()));
+  printf(
+      "Unpacked %d runs, %lu packed bytes: %.2f GB/s\n",
+      FLAGS_num_runs,
+      totalBytes,
+      totalBytes * 1e-6 / time);
+  for (int i = 0; i < FLAGS_num_runs; ++i) {
+    if (results[i] != expected[i]) {
+      fprintf(stderr, "Wrong values in run %d\n", i);
+      abort();
+    }
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::gpu
+
+int main(int argc, char** argv) {
+  using namespace facebook::velox::gpu;
+  folly::init(&argc, &argv);
+  testUnpack();
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <unordered_map>
+#include "velox/experimental/gpu/HashOperators.h"
+
+DEFINE_int32(num_rows, 10'000'000, "");
+DEFINE_int32(batch_rows, 1 << 20, "");
+DEFINE_int32(num_groups, 100'000, "");
+DEFINE_int32(num_build_rows, 1 << 20, "");
+
+namespace facebook::velox::gpu {
+namespace {
+
+struct Group {
+  int64_t count{0};
+  int64_t sum{0};
+  int64_t min{std::numeric_limits<int64_t>::max()};
+  int64_t max{std::numeric_limits<int64_t>::min()};
+};
+
+void check(bool condition, const char* message) {
+  if (!condition) {
+    fprintf(stderr, "%s\n", message);
+    abort();
+  }
+}
+
+void testAggregation() {
+  std::vector<int64_t> keys(FLAGS_num_rows);
+  std::vector<int64_t> values(FLAGS_num_rows);
+  std::unordered_map<int64_t, Group> expected;
+  for (int i = 0; i < FLAGS_num_rows; ++i) {
+    // kEmptyKey is a valid key.
+    keys[i] = i % 1000 == 0
+        ? HashTableView::kEmptyKey
+        : static_cast<int64_t>(folly::Random::rand64() % FLAGS_num_groups);
+    values[i] = static_cast<int64_t>(folly::Random::rand64());
+    auto& group = expected[keys[i]];
+    ++group.count;
+    group.sum = static_cast<uint64_t>(group.sum) + values[i];
+    group.min = std::min(group.min, values[i]);
+    group.max = std::max(group.max, values[i]);
+  }
+  GpuHashAggregation aggregation(FLAGS_num_groups + 1, FLAGS_batch_rows);
+  auto startEvent = createCudaEvent();
+  auto stopEvent = createCudaEvent();
+  CUDA_CHECK_FATAL(cudaEventRecord(startEvent.get()));
+  for (int i = 0; i < FLAGS_num_rows; i += FLAGS_batch_rows) {
+    aggregation.addInput(
+        keys.data() + i,
+        values.data() + i,
+        std::min(FLAGS_batch_rows, FLAGS_num_rows - i));
+  }
+  auto result = aggregation.finish();
+  CUDA_CHECK_FATAL(cudaEventRecord(stopEvent.get()));
+  CUDA_CHECK_FATAL(cudaEventSynchronize(stopEvent.get()));
+  float time;
+  CUDA_CHECK_FATAL(
+      cudaEventElapsedTime(&time, startEvent.get(), stopEvent.get()));
+  printf(
+      "Aggregation of %d rows into %zu groups: %.2f M rows/s\n",
+      FLAGS_num_rows,
+      expected.size(),
+      FLAGS_num_rows * 1e-3 / time);
+
+  check(result.has_value(), "Unexpected overflow");
+  check(result->keys.size() == expected.size(), "Wrong number of groups");
+  for (int i = 0; i < result->keys.size(); ++i) {
+    auto it = expected.find(result->keys[i]);
+    check(it != expected.end(), "Unexpected group");
+    check(result->counts[i] == it->second.count, "Wrong count");
+    check(result->sums[i] == it->second.sum, "Wrong sum");
+    check(result->mins[i] == it->second.min, "Wrong min");
+    check(result->maxs[i] == it->second.max, "Wrong max");
+  }
+
+  // More groups than fit are reported for the caller to fall back.
+  GpuHashAggregation small(FLAGS_num_groups / 4, FLAGS_batch_rows);
+  const auto numRows = std::min(FLAGS_batch_rows, FLAGS_num_rows);
+  small.addInput(keys.data(), values.data(), numRows);
+  check(!small.finish().has_value(), "Overflow not reported");
+}
+
+void testProbe() {
+  std::vector<int64_t> buildKeys(FLAGS_num_build_rows);
+  std::unordered_map<int64_t, int32_t> expected;
+  for (int32_t i = 0; i < FLAGS_num_build_rows; ++i) {
+    do {
+      buildKeys[i] = static_cast<int64_t>(folly::Random::rand64());
+    } while (!expected.emplace(buildKeys[i], i).second);
+  }
+  GpuHashProbe probe(FLAGS_num_build_rows, FLAGS_batch_rows);
+  check(probe.build(buildKeys.data(), buildKeys.size()), "Build failed");
+
+  // Half of the probe keys hit.
+  std::vector<int64_t> probeKeys(FLAGS_batch_rows);
+  for (auto& key : probeKeys) {
+    key = folly::Random::oneIn(2)
+        ? buildKeys[folly::Random::rand32(FLAGS_num_build_rows)]
+        : static_cast<int64_t>(folly::Random::rand64());
+  }
+  std::vector<int32_t> matches(probeKeys.size());
+  auto startEvent = createCudaEvent();
+  auto stopEvent = createCudaEvent();
+  CUDA_CHECK_FATAL(cudaEventRecord(startEvent.get()));
+  probe.probe(probeKeys.data(), probeKeys.size(), matches.data());
+  CUDA_CHECK_FATAL(cudaEventRecord(stopEvent.get()));
+  CUDA_CHECK_FATAL(cudaEventSynchronize(stopEvent.get()));
+  float time;
+  CUDA_CHECK_FATAL(
+      cudaEventElapsedTime(&time, startEvent.get(), stopEvent.get()));
+  printf(
+      "Probe of %zu rows against %d build rows: %.2f M rows/s\n",
+      probeKeys.size(),
+      FLAGS_num_build_rows,
+      probeKeys.size() * 1e-3 / time);
+  for (int i = 0; i < probeKeys.size(); ++i) {
+    auto it = expected.find(probeKeys[i]);
+    check(
+        matches[i] == (it == expected.end() ? -1 : it->second),
+        "Wrong match");
+  }
+
+  // Duplicate build keys are reported for the caller to fall back.
+  GpuHashProbe duplicates(2, FLAGS_batch_rows);
+  const int64_t duplicateKeys[] = {5, 5};
+  check(!duplicates.build(duplicateKeys, 2), "Duplicates not reported");
+}
+
+} // namespace
+} // namespace facebook::velox::gpu
+
+int main(int argc, char** argv) {
+  using namespace facebook::velox::gpu;
+  folly::init(&argc, &argv);
+  testAggregation();
+  testProbe();
+  printf("OK\n");
+  return 0;
+}
@@ -77,6 +77,57 @@ void applyCastKernel(
   }
 }
 
+// Casts the rows of 'input' of the form -?[0-9]+ for integer results or
+// -?[0-9]+(.[0-9]+)? with at most 15 digits for floating point results
+// without folly::to, which needs to check for the other forms it accepts.
+// Sets 'remainingRows' to the other rows.
+template <typename To>
+void castStringsToNumbers(
+    const SelectivityVector& rows,
+    const FlatVector<StringView>& input,
+    FlatVector<To>* resultFlatVector,
+    SelectivityVector& remainingRows) {
+  const auto* rawStrings = input.rawValues();
+  auto* rawResults = resultFlatVector->mutableRawValues();
+  remainingRows.resizeFill(rows.end(), false);
+  rows.applyToSelected([&](auto row) {
+    const auto& value = rawStrings[row];
+    bool parsed;
+    if constexpr (std::is_floating_point_v<To>) {
+      parsed =
+          util::tryParseDecimal(value.data(), value.size(), rawResults[row]);
+    } else {
+      parsed =
+          util::tryParseInteger(value.data(), value.size(), rawResults[row]);
+    }
+    if (!parsed) {
+      remainingRows.setValid(row, true);
+    }
+  });
+  remainingRows.updateBounds();
+}
+
+// Casts the numbers in 'input' to VARCHAR. Formats each number into a reused
+// string and copies it into the string buffer of 'resultFlatVector', which is
+// allocated with space for all rows up front.
+template <typename From, bool Truncate>
+void castNumbersToStrings(
+    const SelectivityVector& rows,
+    const FlatVector<From>& input,
+    FlatVector<StringView>* resultFlatVector) {
+  // Longest text of a BIGINT or a DOUBLE in shortest form.
+  constexpr int32_t kMaxNumberSize = 24;
+  resultFlatVector->getBufferWithSpace(rows.countSelected() * kMaxNumberSize);
+  const auto* rawValues = input.rawValues();
+  std::string text;
+  rows.applyToSelected([&](auto row) {
+    text.clear();
+    util::Converter<TypeKind::VARCHAR, void, Truncate>::append(
+        rawValues[row], text);
+    resultFlatVector->set(row, StringView(text));
+  });
+}
+
 std::string makeErrorMessage(
     const BaseVector& input,
     vector_size_t row,
@@ -88,6 +139,50 @@ std::string makeErrorMessage(
       input.toString(row));
 }
 
+// Casts the strings in 'rows' of 'input' that castStringsToNumbers left
+// unparsed without throwing for the malformed ones. These are null for
+// TRY_CAST. For CAST, the error is recorded through EvalCtx::setStatus, which
+// throws only if errors are not captured, e.g. outside of TRY. TRY_CAST and
+// TRY over dirty data then cost about as much as over clean data.
+template <typename To, bool Truncate>
+void castRemainingStringsToNumbers(
+    const SelectivityVector& rows,
+    const FlatVector<StringView>& input,
+    exec::EvalCtx& context,
+    FlatVector<To>* resultFlatVector,
+    bool nullOnFailure) {
+  auto* rawResults = resultFlatVector->mutableRawValues();
+  rows.applyToSelected([&](auto row) {
+    const folly::StringPiece value(input.valueAt(row));
+    std::string error;
+    if constexpr (Truncate && std::is_integral_v<To>) {
+      bool nullOutput = false;
+      auto result = util::Converter<CppToType<To>::typeKind, void, true>::
+          convertStringToInt(value, nullOutput);
+      if (!nullOutput) {
+        rawResults[row] = result;
+        return;
+      }
+    } else {
+      auto result = folly::tryTo<To>(value);
+      if (result.hasValue()) {
+        rawResults[row] = result.value();
+        return;
+      }
+      error = folly::makeConversionError(result.error(), value).what();
+    }
+    if (nullOnFailure) {
+      resultFlatVector->setNull(row, true);
+    } else {
+      context.setStatus(
+          row,
+          Status::userError(
+              makeErrorMessage(input, row, resultFlatVector->type()) + " " +
+              error));
+    }
+  });
+}
+
 template <typename TInput, typename TOutput>
 void applyDecimalCastKernel(
     const SelectivityVector& rows,
@@ -154,6 +249,53 @@ void CastExpr::applyCastWithTry(
   const auto& queryConfig = context.execCtx()->queryCtx()->queryConfig();
   auto isCastIntByTruncate = queryConfig.isCastIntByTruncate();
 
+  // Flat strings cast to numbers and flat numbers cast to VARCHAR are done in
+  // batches instead of the per-row kernels below.
+  if (input.encoding() == VectorEncoding::Simple::FLAT) {
+    if constexpr (
+        std::is_same_v<From, StringView> && std::is_arithmetic_v<To> &&
+        !std::is_same_v<To, bool>) {
+      LocalSelectivityVector remainingRows(context);
+      castStringsToNumbers(
+          rows,
+          *input.asUnchecked<FlatVector<StringView>>(),
+          resultFlatVector,
+          *remainingRows.get(rows.end(), false));
+      if (remainingRows->hasSelections()) {
+        if (isCastIntByTruncate) {
+          castRemainingStringsToNumbers<To, true>(
+              *remainingRows,
+              *input.asUnchecked<FlatVector<StringView>>(),
+              context,
+              resultFlatVector,
+              nullOnFailure_);
+        } else {
+          castRemainingStringsToNumbers<To, false>(
+              *remainingRows,
+              *input.asUnchecked<FlatVector<StringView>>(),
+              context,
+              resultFlatVector,
+              nullOnFailure_);
+        }
+      }
+      return;
+    }
+    if constexpr (
+        std::is_same_v<To, StringView> && std::is_arithmetic_v<From> &&
+        !std::is_same_v<From, bool>) {
+      if (resultFlatVector->typeKind() == TypeKind::VARCHAR) {
+        if (isCastIntByTruncate) {
+          castNumbersToStrings<From, true>(
+              rows, *input.asUnchecked<FlatVector<From>>(), resultFlatVector);
+        } else {
+          castNumbersToStrings<From, false>(
+              rows, *input.asUnchecked<FlatVector<From>>(), resultFlatVector);
+        }
+        return;
+      }
+    }
+  }
+
   if (!nullOnFailure_) {
     if (!isCastIntByTruncate) {
       context.applyToSelectedNoThrow(rows, [&](int row) {
@@ -329,11 +471,12 @@ VectorPtr CastExpr::applyMap(
   auto mapKeys = input->mapKeys();
   auto mapValues = input->mapValues();
 
-  SelectivityVector nestedRows;
+  LocalSelectivityVector nestedRowsHolder(context);
+  auto& nestedRows = *nestedRowsHolder.get(0);
   BufferPtr elementToTopLevelRows;
   if (fromType.keyType() != toType.keyType() ||
       fromType.valueType() != toType.valueType()) {
-    nestedRows = functions::toElementRows(mapKeys->size(), rows, input);
+    functions::toElementRows(mapKeys->size(), rows, input, nestedRows);
     elementToTopLevelRows = functions::getElementToTopLevelRows(
         mapKeys->size(), rows, input, context.pool());
   }
@@ -395,8 +538,9 @@ VectorPtr CastExpr::applyArray(
   // using their linear selectivity vector
   auto arrayElements = input->elements();
 
-  auto nestedRows =
-      functions::toElementRows(arrayElements->size(), rows, input);
+  LocalSelectivityVector nestedRowsHolder(context);
+  auto& nestedRows = *nestedRowsHolder.get(0);
+  functions::toElementRows(arrayElements->size(), rows, input, nestedRows);
   auto elementToTopLevelRows = functions::getElementToTopLevelRows(
       arrayElements->size(), rows, input, context.pool());
 
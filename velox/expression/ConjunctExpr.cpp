@@ -15,6 +15,7 @@
  */
 #include "velox/expression/ConjunctExpr.h"
 #include "velox/expression/BooleanMix.h"
+#include "velox/expression/FieldReference.h"
 #include "velox/expression/ScopedVarSetter.h"
 
 namespace facebook::velox::exec {
@@ -132,6 +133,11 @@ void ConjunctExpr::evalSpecialForm(
     }
 
     SelectivityTimer timer(selectivity_[inputOrder_[i]], numActive);
+    if (!preloadFields_.empty()) {
+      for (auto* field : preloadFields_[inputOrder_[i]]) {
+        context.ensureFieldLoaded(field->index(context), *activeRows);
+      }
+    }
     inputs_[inputOrder_[i]]->eval(*activeRows, context, inputResult);
     if (context.errors()) {
       handleErrors = true;
@@ -166,10 +172,30 @@ void ConjunctExpr::evalSpecialForm(
     reorderEnabledChecked_ = true;
   }
   if (reorderEnabled_) {
+    if (++numEvalsSinceDecay_ == kStatsDecayInterval) {
+      for (auto& selectivity : selectivity_) {
+        selectivity.decay();
+      }
+      numEvalsSinceDecay_ = 0;
+    }
     maybeReorderInputs();
   }
 }
 
+void ConjunctExpr::setPreloadFields(
+    const std::unordered_set<std::string>& names) {
+  VELOX_CHECK(isAnd_);
+  preloadFields_.clear();
+  preloadFields_.resize(inputs_.size());
+  for (auto i = 0; i < inputs_.size(); ++i) {
+    for (auto* field : inputs_[i]->distinctFields()) {
+      if (names.count(field->field())) {
+        preloadFields_[i].push_back(field);
+      }
+    }
+  }
+}
+
 void ConjunctExpr::maybeReorderInputs() {
   bool reorder = false;
   for (auto i = 1; i < inputs_.size(); ++i) {
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <unordered_set>
+
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/expression/FunctionCallToSpecialForm.h"
 #include "velox/expression/SpecialForm.h"
@@ -68,6 +70,26 @@ class ConjunctExpr : public SpecialForm {
     return selectivity_[inputOrder_[index]];
   }
 
+  /// Indices of the inputs in evaluation order.
+  const std::vector<int32_t>& inputOrder() const {
+    return inputOrder_;
+  }
+
+  /// Number of evaluations after which the selectivity and time of the inputs
+  /// are decayed, so that the order follows changes in the data.
+  static constexpr int32_t kStatsDecayInterval = 32;
+
+  bool isAnd() const {
+    return isAnd_;
+  }
+
+  /// Makes an AND load the fields named in 'names' for all its active rows
+  /// before evaluating the first input that references them. The rows that
+  /// pass the AND are a subset of these, so the fields are loaded for all the
+  /// rows that the consumers of the AND may need, even if an input reads them
+  /// only inside a conditional.
+  void setPreloadFields(const std::unordered_set<std::string>& names);
+
   std::string toSql(
       std::vector<VectorPtr>* complexConstants = nullptr) const override;
 
@@ -84,6 +106,10 @@ class ConjunctExpr : public SpecialForm {
   // true if conjunction (and), false if disjunction (or).
   const bool isAnd_;
 
+  // For each input, the fields to load for the active rows before evaluating
+  // it. Empty if not set by setPreloadFields().
+  std::vector<std::vector<FieldReference*>> preloadFields_;
+
   // Errors encountered before processing the current input.
   FlatVectorPtr<StringView> errors_;
   // temp space for nulls and values of inputs
@@ -93,6 +119,8 @@ class ConjunctExpr : public SpecialForm {
   bool reorderEnabled_;
   std::vector<SelectivityInfo> selectivity_;
   std::vector<int32_t> inputOrder_;
+  // Number of evaluations since the last decay of 'selectivity_'.
+  int32_t numEvalsSinceDecay_{0};
 
   friend class ConjunctCallToSpecialForm;
 };
@@ -240,6 +240,26 @@ void EvalCtx::setError(
   addError(index, toVeloxException(exceptionPtr), errors_);
 }
 
+void EvalCtx::setStatus(vector_size_t index, const Status& status) {
+  VELOX_DCHECK(!status.ok());
+  if (throwOnError_) {
+    VELOX_USER_FAIL("{}", status.message());
+  }
+
+  addError(
+      index,
+      std::make_exception_ptr(VeloxUserError(
+          __FILE__,
+          __LINE__,
+          __FUNCTION__,
+          "",
+          status.message(),
+          error_source::kErrorSourceUser,
+          error_code::kInvalidArgument,
+          /* isRetriable */ false)),
+      errors_);
+}
+
 void EvalCtx::setErrors(
     const SelectivityVector& rows,
     const std::exception_ptr& exceptionPtr) {
@@ -17,8 +17,11 @@
 #pragma once
 
 #include <functional>
+#include <map>
+#include <typeindex>
 
 #include "velox/common/base/Portability.h"
+#include "velox/common/base/Status.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FlatVector.h"
@@ -87,6 +90,12 @@ class EvalCtx {
       const SelectivityVector& rows,
       const std::exception_ptr& exceptionPtr);
 
+  /// Records the failed 'status' as the error of row 'index' without throwing
+  /// and catching an exception, so that failing rows under TRY cost about as
+  /// much as the ones that succeed. Throws the status as a VeloxUserError if
+  /// errors are not captured, like setError.
+  void setStatus(vector_size_t index, const Status& status);
+
   /// Invokes a function on each selected row. Records per-row exceptions by
   /// calling 'setError'. The function must take a single "row" argument of type
   /// vector_size_t and return void.
@@ -266,6 +275,34 @@ class EvalCtx {
   /// new elements to null.
   void ensureErrorsVectorSize(ErrorVectorPtr& vector, vector_size_t size) const;
 
+  /// State that a function derives from one of its input vectors, e.g. an
+  /// index over the keys of a map vector. Kept for the lifetime of 'this',
+  /// which is usually one batch, so that all calls evaluated with 'this' over
+  /// the same vector share it. Subclasses must hold a reference to the
+  /// vector, so that its address is not reused while the memo exists.
+  class VectorMemo {
+   public:
+    virtual ~VectorMemo() = default;
+  };
+
+  /// Returns the memo of type T for 'vector', or nullptr if there is none.
+  template <typename T>
+  T* FOLLY_NULLABLE findVectorMemo(const BaseVector* FOLLY_NONNULL vector) {
+    auto it = vectorMemos_.find({vector, std::type_index(typeid(T))});
+    return it == vectorMemos_.end() ? nullptr
+                                    : static_cast<T*>(it->second.get());
+  }
+
+  /// Adds 'memo' as the memo of type T for 'vector' and returns it.
+  template <typename T>
+  T& addVectorMemo(
+      const BaseVector* FOLLY_NONNULL vector,
+      std::shared_ptr<T> memo) {
+    auto& entry = vectorMemos_[{vector, std::type_index(typeid(T))}];
+    entry = std::move(memo);
+    return *static_cast<T*>(entry.get());
+  }
+
  private:
   core::ExecCtx* const FOLLY_NONNULL execCtx_;
   ExprSet* FOLLY_NULLABLE const exprSet_;
@@ -297,6 +334,13 @@ class EvalCtx {
   // in a opaque flat vector, which will translate to a
   // std::shared_ptr<std::exception_ptr>.
   ErrorVectorPtr errors_;
+
+  // Memos of functions over input vectors, keyed by the vector and the type of
+  // the memo.
+  std::map<
+      std::pair<const BaseVector*, std::type_index>,
+      std::shared_ptr<VectorMemo>>
+      vectorMemos_;
 };
 
 /// Utility wrapper struct that is used to temporarily reset the value of the an
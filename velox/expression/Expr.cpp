@@ -18,6 +18,8 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <fstream>
 
+#include <folly/container/F14Map.h>
+
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/Fs.h"
 #include "velox/common/base/SuccinctPrinter.h"
@@ -488,7 +490,12 @@ void Expr::evalFlatNoNulls(
     }
   }
 
-  applyFunction(rows, context, result);
+  stats_.numFlatNoNullsRows += rows.countSelected();
+  if (valueCache_) {
+    applyFunctionWithCache(rows, context, result);
+  } else {
+    applyFunction(rows, context, result);
+  }
 
   // Move constant values back to constantInputs_.
   for (int32_t i = 0; i < inputs_.size(); ++i) {
@@ -1255,8 +1262,13 @@ void Expr::evalAll(
     }
   }
 
-  if (!tryPeelArgs ||
-      !applyFunctionWithPeeling(rows, *remainingRows, context, result)) {
+  if (valueCache_) {
+    applyFunctionWithCache(*remainingRows, context, result);
+  } else if (
+      !tryPeelArgs ||
+      (!applyFunctionWithPeeling(rows, *remainingRows, context, result) &&
+       !applyFunctionOnDistinctIndices(
+           rows, *remainingRows, context, result))) {
     applyFunction(*remainingRows, context, result);
   }
 
@@ -1420,12 +1432,138 @@ bool Expr::applyFunctionWithPeeling(
   return true;
 }
 
+bool Expr::applyFunctionOnDistinctIndices(
+    const SelectivityVector& rows,
+    const SelectivityVector& applyRows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  if (context.wrapEncoding() == VectorEncoding::Simple::CONSTANT) {
+    return false;
+  }
+  const auto numArgs = inputValues_.size();
+  // The dictionary indices of each non-constant argument and the multiplier
+  // that makes the sum of index * multiplier unique for each combination of
+  // indices.
+  std::vector<const vector_size_t*> argIndices(numArgs, nullptr);
+  std::vector<uint64_t> multipliers(numArgs, 0);
+  uint64_t numCombinations = 1;
+  int32_t numDictionaries = 0;
+  for (auto i = 0; i < numArgs; ++i) {
+    const auto& arg = inputValues_[i];
+    if (arg->isConstantEncoding()) {
+      continue;
+    }
+    if (arg->encoding() != VectorEncoding::Simple::DICTIONARY) {
+      return false;
+    }
+    if (!vectorFunction_->isDefaultNullBehavior() && arg->rawNulls()) {
+      // The indices of the rows a dictionary sets to null are not defined.
+      return false;
+    }
+    multipliers[i] = numCombinations;
+    if (__builtin_mul_overflow(
+            numCombinations,
+            static_cast<uint64_t>(arg->valueVector()->size()),
+            &numCombinations)) {
+      return false;
+    }
+    argIndices[i] = arg->wrapInfo()->as<vector_size_t>();
+    ++numDictionaries;
+  }
+  // A single dictionary is left only if peeling failed for another reason.
+  if (numDictionaries < 2) {
+    return false;
+  }
+
+  const auto numRows = applyRows.countSelected();
+  const vector_size_t maxDistinct = numRows / 2;
+  auto* pool = context.pool();
+  std::vector<BufferPtr> distinctIndices(numArgs);
+  std::vector<vector_size_t*> rawDistinctIndices(numArgs, nullptr);
+  for (auto i = 0; i < numArgs; ++i) {
+    if (argIndices[i]) {
+      distinctIndices[i] = allocateIndices(maxDistinct + 1, pool);
+      rawDistinctIndices[i] = distinctIndices[i]->asMutable<vector_size_t>();
+    }
+  }
+  auto combinations = allocateIndices(applyRows.end(), pool);
+  auto* rawCombinations = combinations->asMutable<vector_size_t>();
+  vector_size_t numDistinct = 0;
+
+  // Assigns the next combination number to the first row with a new
+  // combination of indices. Returns false if there are too many combinations.
+  auto assignCombinations = [&](auto findOrInsert) {
+    return applyRows.testSelected([&](auto row) {
+      uint64_t key = 0;
+      for (auto i = 0; i < numArgs; ++i) {
+        if (argIndices[i]) {
+          key += argIndices[i][row] * multipliers[i];
+        }
+      }
+      auto& combination = findOrInsert(key);
+      if (combination < 0) {
+        if (numDistinct == maxDistinct) {
+          return false;
+        }
+        combination = numDistinct++;
+        for (auto i = 0; i < numArgs; ++i) {
+          if (argIndices[i]) {
+            rawDistinctIndices[i][combination] = argIndices[i][row];
+          }
+        }
+      }
+      rawCombinations[row] = combination;
+      return true;
+    });
+  };
+  if (numCombinations <= applyRows.end()) {
+    // Small dictionaries have a slot for every combination of indices.
+    std::vector<vector_size_t> lookup(numCombinations, -1);
+    if (!assignCombinations(
+            [&](uint64_t key) -> vector_size_t& { return lookup[key]; })) {
+      return false;
+    }
+  } else {
+    folly::F14FastMap<uint64_t, vector_size_t> lookup;
+    if (!assignCombinations([&](uint64_t key) -> vector_size_t& {
+          return lookup.try_emplace(key, -1).first->second;
+        })) {
+      return false;
+    }
+  }
+
+  ScopedContextSaver saver;
+  context.saveAndReset(saver, rows);
+  context.setDictionaryWrap(std::move(combinations), nullptr);
+  for (auto i = 0; i < numArgs; ++i) {
+    auto& arg = inputValues_[i];
+    arg = argIndices[i] ? BaseVector::wrapInDictionary(
+                              nullptr,
+                              std::move(distinctIndices[i]),
+                              numDistinct,
+                              arg->valueVector())
+                        : BaseVector::wrapInConstant(numDistinct, 0, arg);
+  }
+  LocalSelectivityVector distinctRowsHolder(context);
+  auto& distinctRows = *distinctRowsHolder.get(numDistinct, true);
+  VectorPtr distinctResult;
+  applyFunction(distinctRows, context, distinctResult);
+  VectorPtr wrappedResult =
+      context.applyWrapToPeeledResult(this->type(), distinctResult, applyRows);
+  context.moveOrCopyResult(wrappedResult, rows, result);
+  return true;
+}
+
 void Expr::applyFunction(
     const SelectivityVector& rows,
     EvalCtx& context,
     VectorPtr& result) {
+  const auto numRows = rows.countSelected();
   stats_.numProcessedVectors += 1;
-  stats_.numProcessedRows += rows.countSelected();
+  stats_.numProcessedRows += numRows;
+  if (context.wrapEncoding() != VectorEncoding::Simple::FLAT) {
+    stats_.numPeeledRows += numRows;
+  }
   auto timer = cpuWallTimer();
 
   computeIsAsciiForInputs(vectorFunction_.get(), inputValues_, rows);
@@ -1468,6 +1606,52 @@ void Expr::applyFunction(
     result->asUnchecked<SimpleVector<StringView>>()->setIsAscii(
         isAscii.value(), rows);
   }
+
+  if (trackCpuUsage_) {
+    stats_.numOutputBytes += result->estimateFlatSize();
+  }
+}
+
+void Expr::enableValueCache(int32_t maxEntries, memory::MemoryPool* pool) {
+  VELOX_CHECK_NOT_NULL(vectorFunction_);
+  VELOX_CHECK(vectorFunction_->isDeterministic());
+  std::vector<TypePtr> argTypes;
+  for (const auto& input : inputs_) {
+    VELOX_CHECK(ExprValueCache::isCacheable(input->type()));
+    argTypes.push_back(input->type());
+  }
+  VELOX_CHECK(ExprValueCache::isCacheable(type()));
+  valueCache_ =
+      std::make_unique<ExprValueCache>(argTypes, type(), maxEntries, pool);
+}
+
+void Expr::applyFunctionWithCache(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  LocalSelectivityVector missesHolder(context, rows);
+  auto* misses = missesHolder.get();
+  cachedIndices_.resize(rows.end());
+  valueCache_->lookup(rows, inputValues_, *misses, cachedIndices_.data());
+  if (misses->hasSelections()) {
+    applyFunction(*misses, context, result);
+  }
+
+  LocalSelectivityVector hitsHolder(context, rows);
+  auto* hits = hitsHolder.get();
+  hits->deselect(*misses);
+  if (hits->hasSelections()) {
+    context.ensureWritable(*hits, type(), result);
+    result->copy(valueCache_->results().get(), *hits, cachedIndices_.data());
+    if (type()->isVarchar()) {
+      result->asUnchecked<SimpleVector<StringView>>()->invalidateIsAscii();
+    }
+  }
+
+  // Adding may empty the cache, so the hits are copied first.
+  if (misses->hasSelections()) {
+    valueCache_->add(*misses, inputValues_, *result, context.errors());
+  }
 }
 
 void Expr::evalSpecialFormWithStats(
@@ -1609,23 +1793,30 @@ std::string makeUuid() {
 ExprSet::~ExprSet() {
   exprSetListeners().withRLock([&](auto& listeners) {
     if (!listeners.empty()) {
-      std::unordered_map<std::string, exec::ExprStats> stats;
-      std::unordered_set<const exec::Expr*> uniqueExprs;
       std::vector<std::string> sqls;
       for (const auto& expr : exprs()) {
         sqls.emplace_back(expr->toSql());
-        addStats(*expr, stats, uniqueExprs);
       }
+      auto exprStats = stats();
 
       auto uuid = makeUuid();
       for (const auto& listener : listeners) {
         listener->onCompletion(
-            uuid, {stats, sqls, execCtx()->queryCtx()->queryId()});
+            uuid, {exprStats, sqls, execCtx()->queryCtx()->queryId()});
       }
     }
   });
 }
 
+std::unordered_map<std::string, exec::ExprStats> ExprSet::stats() const {
+  std::unordered_map<std::string, exec::ExprStats> stats;
+  std::unordered_set<const exec::Expr*> uniqueExprs;
+  for (const auto& expr : exprs()) {
+    addStats(*expr, stats, uniqueExprs);
+  }
+  return stats;
+}
+
 std::string ExprSet::toString(bool compact) const {
   std::unordered_map<const exec::Expr*, uint32_t> uniqueExprs;
   std::stringstream out;
@@ -1661,8 +1852,10 @@ void ExprSet::eval(
   // If b is a LazyVector and f(a) AND g(b) expression is evaluated first, it
   // will load b only for rows where f(a) is true. However, h(b) projection
   // needs all rows for "b".
-  for (const auto& field : multiplyReferencedFields_) {
-    context.ensureFieldLoaded(field->index(context), rows);
+  if (preloadMultiplyReferencedFields_) {
+    for (const auto& field : multiplyReferencedFields_) {
+      context.ensureFieldLoaded(field->index(context), rows);
+    }
   }
 
   for (int32_t i = begin; i < end; ++i) {
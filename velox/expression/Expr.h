@@ -24,6 +24,7 @@
 #include "velox/core/Expressions.h"
 #include "velox/expression/DecodedArgs.h"
 #include "velox/expression/EvalCtx.h"
+#include "velox/expression/ExprValueCache.h"
 #include "velox/vector/SimpleVector.h"
 
 /// GFlag used to enable saving input vector and expression SQL on disk in case
@@ -56,18 +57,37 @@ struct ExprStats {
   /// size.
   uint64_t numProcessedVectors{0};
 
+  /// Number of processed rows that were evaluated on the flat no-nulls fast
+  /// path. Not counted for special forms.
+  uint64_t numFlatNoNullsRows{0};
+
+  /// Number of processed rows that were evaluated after peeling off
+  /// dictionary or constant encodings, i.e. once per distinct base row.
+  uint64_t numPeeledRows{0};
+
+  /// Estimated flat size in bytes of the produced results. Requires
+  /// QueryConfig.exprTrackCpuUsage() to be 'true'.
+  uint64_t numOutputBytes{0};
+
   void add(const ExprStats& other) {
     timing.add(other.timing);
     numProcessedRows += other.numProcessedRows;
     numProcessedVectors += other.numProcessedVectors;
+    numFlatNoNullsRows += other.numFlatNoNullsRows;
+    numPeeledRows += other.numPeeledRows;
+    numOutputBytes += other.numOutputBytes;
   }
 
   std::string toString() const {
     return fmt::format(
-        "timing: {}, numProcessedRows: {}, numProcessedVectors: {}",
+        "timing: {}, numProcessedRows: {}, numProcessedVectors: {}, "
+        "numFlatNoNullsRows: {}, numPeeledRows: {}, numOutputBytes: {}",
         timing.toString(),
         numProcessedRows,
-        numProcessedVectors);
+        numProcessedVectors,
+        numFlatNoNullsRows,
+        numPeeledRows,
+        numOutputBytes);
   }
 };
 
@@ -277,6 +297,16 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result) const;
 
+  /// Caches the results of the function of 'this' for up to 'maxEntries'
+  /// distinct argument values across batches. The function must be
+  /// deterministic and the arguments and result must be of types for which
+  /// ExprValueCache::isCacheable() is true.
+  void enableValueCache(int32_t maxEntries, memory::MemoryPool* pool);
+
+  const ExprValueCache* valueCache() const {
+    return valueCache_.get();
+  }
+
  private:
   struct PeelEncodingsResult {
     SelectivityVector* FOLLY_NULLABLE newRows;
@@ -326,6 +356,20 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Handles the case where 'inputValues_' are dictionaries over
+  // different indices and constants, which cannot be peeled. Applies
+  // the function of 'this' once for each distinct combination of
+  // dictionary indices in 'applyRows' and wraps the result in a
+  // dictionary over the combinations. Returns true if the function
+  // was called. Returns false if the inputs are not such
+  // dictionaries or if there are more than half as many combinations
+  // as rows.
+  bool applyFunctionOnDistinctIndices(
+      const SelectivityVector& rows,
+      const SelectivityVector& applyRows,
+      EvalCtx& context,
+      VectorPtr& result);
+
   // Calls the function of 'this' on arguments in
   // 'inputValues_'. Handles cases of VectorFunction and SimpleFunction.
   void applyFunction(
@@ -333,6 +377,13 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Looks up the arguments in 'inputValues_' in 'valueCache_' and calls the
+  // function for the rows that are not cached.
+  void applyFunctionWithCache(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
   // Returns true if values in 'distinctFields_' have nulls that are
   // worth skipping. If so, the rows in 'rows' with at least one sure
   // null are deselected in 'nullHolder->get()'.
@@ -443,6 +494,13 @@ class Expr {
 
   /// Runtime statistics. CPU time, wall time and number of processed rows.
   ExprStats stats_;
+
+  // Results of the function by argument values across batches. Null unless
+  // enabled by enableValueCache().
+  std::unique_ptr<ExprValueCache> valueCache_;
+
+  // Position in 'valueCache_' of the result of each row of a batch.
+  std::vector<vector_size_t> cachedIndices_;
 };
 
 /// Translates row number of the outer vector into row number of the inner
@@ -516,6 +574,19 @@ class ExprSet {
     return distinctFields_;
   }
 
+  const std::unordered_set<FieldReference * FOLLY_NONNULL>&
+  multiplyReferencedFields() const {
+    return multiplyReferencedFields_;
+  }
+
+  /// If false, eval() does not load the fields referenced by multiple
+  /// expressions for all rows before evaluating the expressions. The caller
+  /// then makes sure that each expression finds these loaded for the rows it
+  /// needs. True by default.
+  void setPreloadMultiplyReferencedFields(bool preload) {
+    preloadMultiplyReferencedFields_ = preload;
+  }
+
   // Flags a shared subexpression which needs to be reset (e.g. previously
   // computed results must be deleted) when evaluating new batch of data.
   void addToReset(const std::shared_ptr<Expr>& expr) {
@@ -532,6 +603,12 @@ class ExprSet {
   /// Otherwise, prints a tree of expressions one node per line.
   std::string toString(bool compact = true) const;
 
+  /// Returns the runtime stats of the expressions aggregated by expression
+  /// name, e.g. a function name or a special form like and, or, switch.
+  /// Common sub-expressions are counted once. Expressions that processed no
+  /// rows are left out.
+  std::unordered_map<std::string, exec::ExprStats> stats() const;
+
  protected:
   void clearSharedSubexprs();
 
@@ -543,6 +620,8 @@ class ExprSet {
   // Fields referenced by multiple expressions in ExprSet.
   std::unordered_set<FieldReference * FOLLY_NONNULL> multiplyReferencedFields_;
 
+  bool preloadMultiplyReferencedFields_{true};
+
   // Distinct Exprs reachable from 'exprs_' for which reset() needs to
   // be called at the start of eval().
   std::vector<std::shared_ptr<Expr>> toReset_;
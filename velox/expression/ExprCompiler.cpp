@@ -20,7 +20,9 @@
 #include "velox/expression/ConjunctExpr.h"
 #include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/ExprRewriter.h"
 #include "velox/expression/FieldReference.h"
+#include "velox/expression/FusedExpr.h"
 #include "velox/expression/LambdaExpr.h"
 #include "velox/expression/SimpleFunctionRegistry.h"
 #include "velox/expression/SwitchExpr.h"
@@ -295,6 +297,34 @@ std::shared_ptr<Expr> compileLambda(
       config.exprTrackCpuUsage());
 }
 
+// Enables the value cache of 'expr' if its function is deterministic and
+// listed in QueryConfig::kExprCachedFunctions.
+void maybeEnableValueCache(
+    Expr& expr,
+    const core::QueryConfig& config,
+    memory::MemoryPool* pool) {
+  const auto names = config.exprCachedFunctions();
+  if (names.empty() || expr.inputs().empty() ||
+      !expr.vectorFunction()->isDeterministic() ||
+      !ExprValueCache::isCacheable(expr.type())) {
+    return;
+  }
+  std::vector<folly::StringPiece> cachedNames;
+  folly::split(',', names, cachedNames, true);
+  if (std::find(
+          cachedNames.begin(),
+          cachedNames.end(),
+          folly::StringPiece(expr.name())) == cachedNames.end()) {
+    return;
+  }
+  for (const auto& input : expr.inputs()) {
+    if (!ExprValueCache::isCacheable(input->type())) {
+      return;
+    }
+  }
+  expr.enableValueCache(config.exprValueCacheMaxEntries(), pool);
+}
+
 ExprPtr tryFoldIfConstant(const ExprPtr& expr, Scope* scope) {
   if (expr->isDeterministic() && !expr->inputs().empty() &&
       scope->exprSet->execCtx()) {
@@ -490,6 +520,9 @@ ExprPtr compileExpression(
     VELOX_UNSUPPORTED("Unknown typed expression");
   }
 
+  if (!result->isSpecialForm() && result->vectorFunction()) {
+    maybeEnableValueCache(*result, config, pool);
+  }
   result->computeMetadata();
 
   auto folded =
@@ -537,13 +570,18 @@ std::unordered_set<std::string> collectFlatteningCandidates(
 } // namespace
 
 std::vector<std::shared_ptr<Expr>> compileExpressions(
-    const std::vector<TypedExprPtr>& sources,
+    const std::vector<TypedExprPtr>& originalSources,
     core::ExecCtx* execCtx,
     ExprSet* exprSet,
     bool enableConstantFolding) {
   Scope scope({}, nullptr, exprSet);
   std::vector<std::shared_ptr<Expr>> exprs;
-  exprs.reserve(sources.size());
+  exprs.reserve(originalSources.size());
+
+  const auto& config = execCtx->queryCtx()->queryConfig();
+  const auto sources = config.exprRewriteEnabled()
+      ? ExprRewriter::instance().rewrite(originalSources)
+      : originalSources;
 
   // Precompute a set of function calls that support flattening. This allows to
   // lock function registry once vs. locking for each function call.
@@ -553,12 +591,89 @@ std::vector<std::shared_ptr<Expr>> compileExpressions(
     exprs.push_back(compileExpression(
         source,
         &scope,
-        execCtx->queryCtx()->queryConfig(),
+        config,
         execCtx->pool(),
         flatteningCandidates,
         enableConstantFolding));
+    if (config.exprFusedEvalEnabled()) {
+      if (auto fused = FusedExpr::tryCreate(exprs.back())) {
+        exprs.back() = std::move(fused);
+      }
+    }
   }
   return exprs;
 }
 
+namespace {
+
+// Returns a copy of 'expr' with 'inputs' or nullptr if 'expr' is of a kind
+// that is not rewritten.
+TypedExprPtr withInputs(
+    const TypedExprPtr& expr,
+    std::vector<TypedExprPtr> inputs) {
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CallTypedExpr>(
+        call->type(), std::move(inputs), call->name());
+  }
+  if (auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CastTypedExpr>(
+        cast->type(), inputs, cast->nullOnFailure());
+  }
+  if (auto field =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    return std::make_shared<core::FieldAccessTypedExpr>(
+        field->type(), std::move(inputs[0]), field->name());
+  }
+  if (auto concat = dynamic_cast<const core::ConcatTypedExpr*>(expr.get())) {
+    return std::make_shared<core::ConcatTypedExpr>(
+        asRowType(concat->type())->names(), inputs);
+  }
+  return nullptr;
+}
+
+TypedExprPtr foldConstants(const TypedExprPtr& expr, core::ExecCtx* execCtx) {
+  if (expr->inputs().empty()) {
+    return expr;
+  }
+  std::vector<TypedExprPtr> inputs;
+  inputs.reserve(expr->inputs().size());
+  bool changed = false;
+  bool allConstant = true;
+  for (const auto& input : expr->inputs()) {
+    inputs.push_back(foldConstants(input, execCtx));
+    changed |= inputs.back() != input;
+    allConstant &= dynamic_cast<const core::ConstantTypedExpr*>(
+                       inputs.back().get()) != nullptr;
+  }
+  auto folded = changed ? withInputs(expr, std::move(inputs)) : expr;
+  if (folded == nullptr) {
+    return expr;
+  }
+  if (!allConstant ||
+      (!dynamic_cast<const core::CallTypedExpr*>(folded.get()) &&
+       !dynamic_cast<const core::CastTypedExpr*>(folded.get()))) {
+    return folded;
+  }
+  // Compiling folds the call if it is deterministic and does not throw.
+  ExprSet exprSet({folded}, execCtx);
+  auto constant = std::dynamic_pointer_cast<ConstantExpr>(exprSet.exprs()[0]);
+  if (constant != nullptr && constant->value() != nullptr) {
+    return std::make_shared<core::ConstantTypedExpr>(constant->value());
+  }
+  return folded;
+}
+
+} // namespace
+
+std::vector<TypedExprPtr> foldConstants(
+    const std::vector<TypedExprPtr>& sources,
+    core::ExecCtx* execCtx) {
+  std::vector<TypedExprPtr> folded;
+  folded.reserve(sources.size());
+  for (const auto& source : sources) {
+    folded.push_back(foldConstants(source, execCtx));
+  }
+  return folded;
+}
+
 } // namespace facebook::velox::exec
@@ -31,4 +31,15 @@ std::vector<std::shared_ptr<Expr>> compileExpressions(
     ExprSet* exprSet,
     bool enableConstantFolding = true);
 
+/// Returns 'sources' with the deterministic function calls and casts whose
+/// inputs are all constant replaced by their values, evaluated with
+/// 'execCtx'. This is the constant folding of compileExpressions() at the
+/// level of typed expressions: ExprSets compiled from the result do not
+/// evaluate these again, so that operators of the same plan node can share
+/// one folding. Calls that fail to evaluate are kept and fail at execution
+/// time only if they are reached.
+std::vector<core::TypedExprPtr> foldConstants(
+    const std::vector<core::TypedExprPtr>& sources,
+    core::ExecCtx* execCtx);
+
 } // namespace facebook::velox::exec
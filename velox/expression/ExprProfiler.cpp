@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/expression/ExprProfiler.h"
+
+namespace facebook::velox::exec {
+
+void ExprProfiler::onCompletion(
+    const std::string& /*uuid*/,
+    const ExprSetCompletionEvent& event) {
+  queries_.withWLock([&](auto& queries) {
+    auto& queryStats = queries[event.queryId];
+    for (const auto& [name, stats] : event.stats) {
+      queryStats[name].add(stats);
+    }
+  });
+}
+
+std::unordered_map<std::string, ExprStats> ExprProfiler::queryStats(
+    const std::string& queryId) const {
+  return queries_.withRLock(
+      [&](const auto& queries) -> std::unordered_map<std::string, ExprStats> {
+        auto it = queries.find(queryId);
+        if (it == queries.end()) {
+          return {};
+        }
+        return it->second;
+      });
+}
+
+void ExprProfiler::clear(const std::string& queryId) {
+  queries_.wlock()->erase(queryId);
+}
+
+// static
+std::vector<std::pair<std::string, RuntimeCounter>>
+ExprProfiler::toRuntimeStats(
+    const std::unordered_map<std::string, ExprStats>& stats) {
+  std::vector<std::pair<std::string, RuntimeCounter>> runtimeStats;
+  for (const auto& entry : stats) {
+    const auto& exprStats = entry.second;
+    auto add = [&](
+                   const char* counter,
+                   uint64_t value,
+                   RuntimeCounter::Unit unit = RuntimeCounter::Unit::kNone) {
+      runtimeStats.emplace_back(
+          fmt::format("expr.{}.{}", entry.first, counter),
+          RuntimeCounter(value, unit));
+    };
+    add("processedRows", exprStats.numProcessedRows);
+    add("flatNoNullsRows", exprStats.numFlatNoNullsRows);
+    add("peeledRows", exprStats.numPeeledRows);
+    if (exprStats.timing.count) {
+      add("cpuNanos",
+          exprStats.timing.cpuNanos,
+          RuntimeCounter::Unit::kNanos);
+      add("outputBytes",
+          exprStats.numOutputBytes,
+          RuntimeCounter::Unit::kBytes);
+    }
+  }
+  return runtimeStats;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+
+#include "velox/common/base/RuntimeMetrics.h"
+#include "velox/expression/Expr.h"
+
+namespace facebook::velox::exec {
+
+/// ExprSetListener that aggregates the runtime stats of the expression sets of
+/// each query by function name: processed rows, rows evaluated on the flat
+/// no-nulls fast path and after peeling, and, if
+/// QueryConfig.exprTrackCpuUsage() is true, cpu time and produced bytes.
+/// Register with registerExprSetListener() to find the functions that are
+/// worth optimizing.
+class ExprProfiler : public ExprSetListener {
+ public:
+  void onCompletion(
+      const std::string& uuid,
+      const ExprSetCompletionEvent& event) override;
+
+  void onError(
+      const SelectivityVector& /*rows*/,
+      const EvalCtx::ErrorVector& /*errors*/) override {}
+
+  /// Returns the stats of the completed expression sets of 'queryId' keyed
+  /// on function name.
+  std::unordered_map<std::string, ExprStats> queryStats(
+      const std::string& queryId) const;
+
+  /// Drops the stats of 'queryId'.
+  void clear(const std::string& queryId);
+
+  /// Returns 'stats' as runtime stats named expr.<function>.<counter>, e.g.
+  /// expr.plus.processedRows. Used to report expression stats in
+  /// OperatorStats and PlanNodeStats.
+  static std::vector<std::pair<std::string, RuntimeCounter>> toRuntimeStats(
+      const std::unordered_map<std::string, ExprStats>& stats);
+
+ private:
+  folly::Synchronized<std::unordered_map<
+      std::string,
+      std::unordered_map<std::string, ExprStats>>>
+      queries_;
+};
+
+} // namespace facebook::velox::exec
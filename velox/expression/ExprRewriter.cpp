@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/expression/ExprRewriter.h"
+
+#include "velox/expression/SimpleFunctionRegistry.h"
+#include "velox/expression/VectorFunction.h"
+#include "velox/vector/ConstantVector.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+
+const core::CallTypedExpr* asCall(
+    const core::TypedExprPtr& expr,
+    const std::string& name) {
+  auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  return call && call->name() == name ? call : nullptr;
+}
+
+bool isNullConstant(const core::TypedExprPtr& expr) {
+  auto constant = dynamic_cast<const core::ConstantTypedExpr*>(expr.get());
+  if (!constant) {
+    return false;
+  }
+  return constant->hasValueVector() ? constant->valueVector()->isNullAt(0)
+                                    : constant->value().isNull();
+}
+
+// Returns the value of a non-null BOOLEAN constant.
+std::optional<bool> booleanConstant(const core::TypedExprPtr& expr) {
+  auto constant = dynamic_cast<const core::ConstantTypedExpr*>(expr.get());
+  if (!constant || !expr->type()->isBoolean() || isNullConstant(expr)) {
+    return std::nullopt;
+  }
+  if (constant->hasValueVector()) {
+    return constant->valueVector()->as<SimpleVector<bool>>()->valueAt(0);
+  }
+  return constant->value().value<bool>();
+}
+
+core::TypedExprPtr makeBooleanConstant(std::optional<bool> value) {
+  if (!value.has_value()) {
+    return std::make_shared<core::ConstantTypedExpr>(
+        BOOLEAN(), variant::null(TypeKind::BOOLEAN));
+  }
+  return std::make_shared<core::ConstantTypedExpr>(variant(value.value()));
+}
+
+// Returns true for expressions that give the same result each time they are
+// evaluated and are cheap to compare.
+bool isColumnExpr(const core::TypedExprPtr& expr) {
+  if (dynamic_cast<const core::ConstantTypedExpr*>(expr.get())) {
+    return true;
+  }
+  if (dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get()) ||
+      dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    for (const auto& input : expr->inputs()) {
+      if (!dynamic_cast<const core::InputTypedExpr*>(input.get()) &&
+          !isColumnExpr(input)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+// Returns true if 'expr' is a column expression equal to one in 'exprs'.
+bool containsColumnExpr(
+    const std::vector<core::TypedExprPtr>& exprs,
+    const core::TypedExprPtr& expr) {
+  if (!isColumnExpr(expr)) {
+    return false;
+  }
+  for (const auto& other : exprs) {
+    if (*other == *expr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool isFunction(const std::string& name, const std::vector<TypePtr>& types) {
+  return resolveVectorFunction(name, types) != nullptr ||
+      SimpleFunctions().resolveFunction(name, types) != nullptr;
+}
+
+// AND and OR: 'identity' is the value that does not change the result and the
+// opposite value decides the result.
+core::TypedExprPtr
+simplifyConjunct(const core::TypedExprPtr& expr, bool isAnd, bool duplicates) {
+  auto call = asCall(expr, isAnd ? "and" : "or");
+  if (!call) {
+    return nullptr;
+  }
+  const bool identity = isAnd;
+  std::vector<core::TypedExprPtr> inputs;
+  for (const auto& input : call->inputs()) {
+    if (duplicates) {
+      if (!containsColumnExpr(inputs, input)) {
+        inputs.push_back(input);
+      }
+      continue;
+    }
+    auto value = booleanConstant(input);
+    if (value.has_value()) {
+      if (value.value() != identity) {
+        return makeBooleanConstant(!identity);
+      }
+      continue;
+    }
+    inputs.push_back(input);
+  }
+  if (inputs.size() == call->inputs().size()) {
+    return nullptr;
+  }
+  if (inputs.empty()) {
+    return makeBooleanConstant(identity);
+  }
+  if (inputs.size() == 1) {
+    return inputs[0];
+  }
+  return std::make_shared<core::CallTypedExpr>(
+      call->type(), std::move(inputs), call->name());
+}
+
+core::TypedExprPtr simplifyDoubleNegation(const core::TypedExprPtr& expr) {
+  auto call = asCall(expr, "not");
+  if (!call || call->inputs().size() != 1) {
+    return nullptr;
+  }
+  auto inner = asCall(call->inputs()[0], "not");
+  if (!inner || inner->inputs().size() != 1) {
+    return nullptr;
+  }
+  return inner->inputs()[0];
+}
+
+core::TypedExprPtr simplifyCoalesce(const core::TypedExprPtr& expr) {
+  auto call = asCall(expr, "coalesce");
+  if (!call) {
+    return nullptr;
+  }
+  std::vector<core::TypedExprPtr> inputs;
+  for (const auto& input : call->inputs()) {
+    if (containsColumnExpr(inputs, input)) {
+      continue;
+    }
+    inputs.push_back(input);
+    if (dynamic_cast<const core::ConstantTypedExpr*>(input.get()) &&
+        !isNullConstant(input)) {
+      break;
+    }
+  }
+  if (inputs.size() == call->inputs().size()) {
+    return nullptr;
+  }
+  if (inputs.size() == 1 && *inputs[0]->type() == *call->type()) {
+    return inputs[0];
+  }
+  return std::make_shared<core::CallTypedExpr>(
+      call->type(), std::move(inputs), call->name());
+}
+
+core::TypedExprPtr simplifyCast(const core::TypedExprPtr& expr) {
+  auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get());
+  if (!cast || cast->inputs().size() != 1) {
+    return nullptr;
+  }
+  const auto& input = cast->inputs()[0];
+  if (*input->type() != *cast->type()) {
+    return nullptr;
+  }
+  return input;
+}
+
+core::TypedExprPtr simplifyInList(const core::TypedExprPtr& expr) {
+  auto call = asCall(expr, "in");
+  if (!call || call->inputs().size() != 2) {
+    return nullptr;
+  }
+  auto list =
+      dynamic_cast<const core::ConstantTypedExpr*>(call->inputs()[1].get());
+  if (!list || list->hasValueVector() || list->value().isNull() ||
+      list->value().kind() != TypeKind::ARRAY) {
+    return nullptr;
+  }
+  const auto& values = list->value().array();
+  std::vector<variant> distinctValues;
+  struct VariantHasher {
+    size_t operator()(const variant& value) const {
+      return value.hash();
+    }
+  };
+  std::unordered_set<variant, VariantHasher> seen;
+  for (const auto& value : values) {
+    if (seen.insert(value).second) {
+      distinctValues.push_back(value);
+    }
+  }
+  if (distinctValues.size() == values.size()) {
+    return nullptr;
+  }
+  return std::make_shared<core::CallTypedExpr>(
+      call->type(),
+      std::vector<core::TypedExprPtr>{
+          call->inputs()[0],
+          std::make_shared<core::ConstantTypedExpr>(
+              list->type(), variant::array(std::move(distinctValues)))},
+      call->name());
+}
+
+core::TypedExprPtr simplifySelfComparison(const core::TypedExprPtr& expr) {
+  static const std::unordered_map<std::string, bool> kComparisons = {
+      {"eq", true},
+      {"lte", true},
+      {"gte", true},
+      {"neq", false},
+      {"lt", false},
+      {"gt", false},
+  };
+  auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (!call || call->inputs().size() != 2) {
+    return nullptr;
+  }
+  auto it = kComparisons.find(call->name());
+  if (it == kComparisons.end()) {
+    return nullptr;
+  }
+  const auto& input = call->inputs()[0];
+  const auto& type = input->type();
+  // NaN is not equal to itself and complex values with null elements compare
+  // as null.
+  if (!type->isPrimitiveType() || type->kind() == TypeKind::REAL ||
+      type->kind() == TypeKind::DOUBLE || !isColumnExpr(input) ||
+      !(*input == *call->inputs()[1])) {
+    return nullptr;
+  }
+  if (!isFunction("is_null", {type}) || !isFunction("not", {BOOLEAN()})) {
+    return nullptr;
+  }
+  core::TypedExprPtr isNull = std::make_shared<core::CallTypedExpr>(
+      BOOLEAN(), std::vector<core::TypedExprPtr>{input}, "is_null");
+  // 'x = x' is 'not(is_null(x)) or null' and 'x < x' is 'is_null(x) and
+  // null', which are null if x is null.
+  if (it->second) {
+    return std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<core::TypedExprPtr>{
+            std::make_shared<core::CallTypedExpr>(
+                BOOLEAN(), std::vector<core::TypedExprPtr>{isNull}, "not"),
+            makeBooleanConstant(std::nullopt)},
+        "or");
+  }
+  return std::make_shared<core::CallTypedExpr>(
+      BOOLEAN(),
+      std::vector<core::TypedExprPtr>{
+          isNull, makeBooleanConstant(std::nullopt)},
+      "and");
+}
+
+// Returns 'expr' with 'inputs' instead of its inputs.
+core::TypedExprPtr replaceInputs(
+    const core::TypedExprPtr& expr,
+    std::vector<core::TypedExprPtr> inputs) {
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CallTypedExpr>(
+        call->type(), std::move(inputs), call->name());
+  }
+  auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get());
+  VELOX_CHECK_NOT_NULL(cast);
+  return std::make_shared<core::CastTypedExpr>(
+      cast->type(), std::move(inputs), cast->nullOnFailure());
+}
+} // namespace
+
+// static
+ExprRewriter& ExprRewriter::instance() {
+  static ExprRewriter* rewriter = [] {
+    auto* rewriter = new ExprRewriter();
+    addDefaultRules(*rewriter);
+    return rewriter;
+  }();
+  return *rewriter;
+}
+
+// static
+void ExprRewriter::addDefaultRules(ExprRewriter& rewriter) {
+  rewriter.addRule("and_or_constants", [](const auto& expr) {
+    auto result = simplifyConjunct(expr, true, false);
+    return result ? result : simplifyConjunct(expr, false, false);
+  });
+  rewriter.addRule("and_or_duplicates", [](const auto& expr) {
+    auto result = simplifyConjunct(expr, true, true);
+    return result ? result : simplifyConjunct(expr, false, true);
+  });
+  rewriter.addRule("double_negation", simplifyDoubleNegation);
+  rewriter.addRule("coalesce", simplifyCoalesce);
+  rewriter.addRule("redundant_cast", simplifyCast);
+  rewriter.addRule("in_list_duplicates", simplifyInList);
+  rewriter.addRule("self_comparison", simplifySelfComparison);
+}
+
+void ExprRewriter::addRule(const std::string& name, Rule rule) {
+  rules_.withWLock([&](auto& rules) {
+    for (const auto& entry : rules) {
+      VELOX_CHECK_NE(entry->name, name, "Duplicate rewrite rule");
+    }
+    rules.push_back(std::make_unique<RuleEntry>(name, std::move(rule)));
+  });
+}
+
+std::vector<core::TypedExprPtr> ExprRewriter::rewrite(
+    const std::vector<core::TypedExprPtr>& exprs) {
+  return rules_.withRLock([&](const auto& rules) {
+    std::unordered_map<const core::ITypedExpr*, core::TypedExprPtr> done;
+    std::vector<core::TypedExprPtr> result;
+    result.reserve(exprs.size());
+    for (const auto& expr : exprs) {
+      result.push_back(rewriteNode(expr, rules, done));
+    }
+    return result;
+  });
+}
+
+core::TypedExprPtr ExprRewriter::rewriteNode(
+    const core::TypedExprPtr& expr,
+    const std::vector<std::unique_ptr<RuleEntry>>& rules,
+    std::unordered_map<const core::ITypedExpr*, core::TypedExprPtr>& done)
+    const {
+  auto it = done.find(expr.get());
+  if (it != done.end()) {
+    return it->second;
+  }
+  // Lambdas, field accesses and the like are not rewritten.
+  if (!dynamic_cast<const core::CallTypedExpr*>(expr.get()) &&
+      !dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    done[expr.get()] = expr;
+    return expr;
+  }
+
+  auto result = expr;
+  std::vector<core::TypedExprPtr> inputs;
+  bool inputsChanged = false;
+  for (const auto& input : expr->inputs()) {
+    inputs.push_back(rewriteNode(input, rules, done));
+    inputsChanged |= inputs.back() != input;
+  }
+  if (inputsChanged) {
+    result = replaceInputs(expr, std::move(inputs));
+  }
+
+  for (auto numRewrites = 0; numRewrites < kMaxRewritesPerNode;
+       ++numRewrites) {
+    core::TypedExprPtr rewritten;
+    for (const auto& entry : rules) {
+      if ((rewritten = entry->rule(result))) {
+        ++entry->numHits;
+        break;
+      }
+    }
+    if (!rewritten) {
+      break;
+    }
+    result = std::move(rewritten);
+  }
+  done[expr.get()] = result;
+  return result;
+}
+
+std::unordered_map<std::string, int64_t> ExprRewriter::ruleHits() const {
+  std::unordered_map<std::string, int64_t> hits;
+  rules_.withRLock([&](const auto& rules) {
+    for (const auto& entry : rules) {
+      hits[entry->name] = entry->numHits;
+    }
+  });
+  return hits;
+}
+
+void ExprRewriter::resetRuleHits() {
+  rules_.withRLock([&](const auto& rules) {
+    for (const auto& entry : rules) {
+      entry->numHits = 0;
+    }
+  });
+}
+
+} // namespace facebook::velox::exec
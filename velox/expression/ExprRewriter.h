@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+
+#include "velox/core/Expressions.h"
+
+namespace facebook::velox::exec {
+
+/// Rewrites typed expressions into equivalent expressions that are cheaper to
+/// evaluate before they are compiled, e.g. 'not(not(a))' into 'a' or
+/// 'and(a, true)' into 'a'. The rewrites are done by rules, which are tried in
+/// the order they were added on each call and cast, after its inputs are
+/// rewritten. A node is rewritten until no rule applies. Counts the rewrites
+/// done by each rule. Thread-safe.
+class ExprRewriter {
+ public:
+  /// Returns a replacement for 'expr' or nullptr if the rule does not apply.
+  /// The inputs of 'expr' are already rewritten.
+  using Rule = std::function<core::TypedExprPtr(const core::TypedExprPtr&)>;
+
+  /// Returns the rewriter used by compileExpressions if
+  /// QueryConfig::kExprRewriteEnabled is set. Has the rules of
+  /// addDefaultRules().
+  static ExprRewriter& instance();
+
+  /// Adds the built-in rules:
+  ///
+  /// - and_or_constants: drops true inputs of AND and false inputs of OR and
+  ///   replaces those with a false or true input by the constant.
+  /// - and_or_duplicates: drops repeated column expressions from AND and OR.
+  /// - double_negation: not(not(a)) is a.
+  /// - coalesce: drops repeated column expressions and the inputs after a
+  ///   non-null constant.
+  /// - redundant_cast: drops casts to the type of their input, which also
+  ///   removes the outer of two casts to the same type.
+  /// - in_list_duplicates: drops repeated values from a constant IN list.
+  /// - self_comparison: a column expression compared with itself is true or
+  ///   false unless it is null.
+  ///
+  /// A column expression is a field access, a constant, or a cast of one.
+  static void addDefaultRules(ExprRewriter& rewriter);
+
+  /// Adds 'rule' under 'name'. 'name' must be unique.
+  void addRule(const std::string& name, Rule rule);
+
+  /// Returns 'exprs' rewritten. A subtree that is shared between expressions
+  /// is rewritten into a single subtree. Unchanged subtrees are returned as
+  /// is.
+  std::vector<core::TypedExprPtr> rewrite(
+      const std::vector<core::TypedExprPtr>& exprs);
+
+  core::TypedExprPtr rewrite(const core::TypedExprPtr& expr) {
+    return rewrite(std::vector<core::TypedExprPtr>{expr})[0];
+  }
+
+  /// Returns the number of rewrites made by each rule.
+  std::unordered_map<std::string, int64_t> ruleHits() const;
+
+  void resetRuleHits();
+
+  /// Maximum number of rewrites of a single node, in case added rules undo
+  /// each other.
+  static constexpr int32_t kMaxRewritesPerNode = 100;
+
+ private:
+  struct RuleEntry {
+    RuleEntry(std::string _name, Rule _rule)
+        : name(std::move(_name)), rule(std::move(_rule)) {}
+
+    const std::string name;
+    const Rule rule;
+    std::atomic<int64_t> numHits{0};
+  };
+
+  core::TypedExprPtr rewriteNode(
+      const core::TypedExprPtr& expr,
+      const std::vector<std::unique_ptr<RuleEntry>>& rules,
+      std::unordered_map<const core::ITypedExpr*, core::TypedExprPtr>& done)
+      const;
+
+  folly::Synchronized<std::vector<std::unique_ptr<RuleEntry>>> rules_;
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/expression/ExprValueCache.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+// Copies the value at 'row' of 'source' to 'index' of 'target'. Strings are
+// copied into the buffers of 'target'.
+template <TypeKind Kind>
+void copyValue(
+    const BaseVector& source,
+    vector_size_t row,
+    BaseVector& target,
+    vector_size_t index) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  auto* flat = target.asUnchecked<FlatVector<T>>();
+  if (source.isNullAt(row)) {
+    flat->setNull(index, true);
+    return;
+  }
+  flat->set(index, source.asUnchecked<SimpleVector<T>>()->valueAt(row));
+}
+} // namespace
+
+ExprValueCache::ExprValueCache(
+    const std::vector<TypePtr>& argTypes,
+    TypePtr resultType,
+    int32_t maxEntries,
+    memory::MemoryPool* pool)
+    : argTypes_(argTypes),
+      resultType_(std::move(resultType)),
+      maxEntries_(maxEntries),
+      pool_(pool) {
+  VELOX_CHECK_GT(maxEntries_, 0);
+  clear();
+}
+
+// static
+bool ExprValueCache::isCacheable(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ExprValueCache::clear() {
+  args_.clear();
+  for (const auto& type : argTypes_) {
+    args_.push_back(BaseVector::create(type, 0, pool_));
+  }
+  results_ = BaseVector::create(resultType_, 0, pool_);
+  size_ = 0;
+  entries_.clear();
+}
+
+uint64_t ExprValueCache::hashRow(
+    const std::vector<VectorPtr>& args,
+    vector_size_t row) const {
+  uint64_t hash = 0;
+  for (const auto& arg : args) {
+    hash = bits::hashMix(hash, arg->hashValueAt(row));
+  }
+  return hash;
+}
+
+bool ExprValueCache::equalsEntry(
+    const std::vector<VectorPtr>& args,
+    vector_size_t row,
+    vector_size_t index) const {
+  for (auto i = 0; i < args.size(); ++i) {
+    if (!args_[i]->equalValueAt(args[i].get(), index, row)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ExprValueCache::lookup(
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args,
+    SelectivityVector& misses,
+    vector_size_t* indices) {
+  rows.applyToSelected([&](auto row) {
+    auto it = entries_.find(hashRow(args, row));
+    if (it != entries_.end() && equalsEntry(args, row, it->second)) {
+      indices[row] = it->second;
+      misses.setValid(row, false);
+      ++numHits_;
+    } else {
+      ++numMisses_;
+    }
+  });
+  misses.updateBounds();
+}
+
+void ExprValueCache::add(
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args,
+    const BaseVector& result,
+    const BaseVector* errors) {
+  rows.applyToSelected([&](auto row) {
+    if (errors && row < errors->size() && !errors->isNullAt(row)) {
+      return;
+    }
+    const auto hash = hashRow(args, row);
+    if (entries_.count(hash)) {
+      return;
+    }
+    if (size_ == maxEntries_) {
+      clear();
+    }
+    if (size_ == results_->size()) {
+      const auto capacity = std::min(maxEntries_, std::max(16, size_ * 2));
+      for (auto& arg : args_) {
+        arg->resize(capacity);
+      }
+      results_->resize(capacity);
+    }
+    for (auto i = 0; i < args.size(); ++i) {
+      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+          copyValue, argTypes_[i]->kind(), *args[i], row, *args_[i], size_);
+    }
+    VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        copyValue, resultType_->kind(), result, row, *results_, size_);
+    entries_[hash] = size_++;
+  });
+}
+
+} // namespace facebook::velox::exec
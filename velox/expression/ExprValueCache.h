@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include "velox/vector/BaseVector.h"
+#include "velox/vector/SelectivityVector.h"
+
+namespace facebook::velox::exec {
+
+/// Caches the results of a deterministic function call for distinct
+/// combinations of argument values across batches. Used for expensive
+/// functions whose arguments have few distinct values, e.g. parsing user
+/// agents or URLs. The arguments and results are copied into flat vectors
+/// owned by the cache, so that the cache does not hold on to the buffers of
+/// the batches. The cache is emptied when it has 'maxEntries' entries.
+class ExprValueCache {
+ public:
+  ExprValueCache(
+      const std::vector<TypePtr>& argTypes,
+      TypePtr resultType,
+      int32_t maxEntries,
+      memory::MemoryPool* pool);
+
+  /// Returns true if arguments and results of 'type' can be cached.
+  static bool isCacheable(const TypePtr& type);
+
+  /// For each row of 'rows' with cached arguments, sets 'indices[row]' to the
+  /// position of its result in results() and deselects the row in 'misses'.
+  /// 'misses' must be a copy of 'rows'.
+  void lookup(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      SelectivityVector& misses,
+      vector_size_t* indices);
+
+  /// Adds the arguments and results of 'rows'. A row is not added if its
+  /// arguments are already in the cache or if it has an error in 'errors'.
+  void add(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      const BaseVector& result,
+      const BaseVector* errors);
+
+  const VectorPtr& results() const {
+    return results_;
+  }
+
+  int32_t size() const {
+    return size_;
+  }
+
+  int64_t numHits() const {
+    return numHits_;
+  }
+
+  int64_t numMisses() const {
+    return numMisses_;
+  }
+
+ private:
+  uint64_t hashRow(const std::vector<VectorPtr>& args, vector_size_t row)
+      const;
+
+  bool equalsEntry(
+      const std::vector<VectorPtr>& args,
+      vector_size_t row,
+      vector_size_t index) const;
+
+  // Makes empty vectors for the cached arguments and results.
+  void clear();
+
+  const std::vector<TypePtr> argTypes_;
+  const TypePtr resultType_;
+  const int32_t maxEntries_;
+  memory::MemoryPool* const pool_;
+
+  // Arguments and result of each entry.
+  std::vector<VectorPtr> args_;
+  VectorPtr results_;
+  int32_t size_{0};
+
+  // Index of the entry for a hash of the arguments. Entries whose arguments
+  // have the hash of an existing entry are not added.
+  folly::F14FastMap<uint64_t, vector_size_t> entries_;
+
+  int64_t numHits_{0};
+  int64_t numMisses_{0};
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,646 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/expression/FusedExpr.h"
+#include "velox/expression/CastExpr.h"
+#include "velox/expression/ConjunctExpr.h"
+#include "velox/expression/ConstantExpr.h"
+#include "velox/expression/FieldReference.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+
+using Op = FusedExpr::Op;
+using Instruction = FusedExpr::Instruction;
+
+bool isFusedKind(TypeKind kind) {
+  return kind == TypeKind::BIGINT || kind == TypeKind::INTEGER ||
+      kind == TypeKind::DOUBLE || kind == TypeKind::BOOLEAN;
+}
+
+const std::unordered_map<std::string, Op>& arithmeticOps() {
+  static const std::unordered_map<std::string, Op> ops = {
+      {"plus", Op::kPlus},
+      {"minus", Op::kMinus},
+      {"multiply", Op::kMultiply},
+      {"divide", Op::kDivide},
+      {"negate", Op::kNegate},
+  };
+  return ops;
+}
+
+const std::unordered_map<std::string, Op>& comparisonOps() {
+  static const std::unordered_map<std::string, Op> ops = {
+      {"eq", Op::kEq},
+      {"neq", Op::kNeq},
+      {"lt", Op::kLt},
+      {"lte", Op::kLte},
+      {"gt", Op::kGt},
+      {"gte", Op::kGte},
+  };
+  return ops;
+}
+
+template <typename T>
+int64_t constantBits(const BaseVector& value) {
+  int64_t bits = 0;
+  const T typedValue = value.asUnchecked<SimpleVector<T>>()->valueAt(0);
+  memcpy(&bits, &typedValue, sizeof(T));
+  return bits;
+}
+
+// Translates an Expr tree into instructions. Each column, constant and
+// operation gets its own register.
+class ProgramBuilder {
+ public:
+  // Returns the register with the value of 'expr' or -1 if 'expr' cannot be
+  // fused.
+  int32_t add(const ExprPtr& expr);
+
+  std::vector<ExprPtr> fields;
+  std::vector<int32_t> fieldRegisters;
+  std::vector<Instruction> constants;
+  std::vector<Instruction> operations;
+  int32_t numRegisters{0};
+
+ private:
+  int32_t addOperation(
+      Op op,
+      TypeKind kind,
+      TypeKind resultKind,
+      int32_t left,
+      int32_t right = -1) {
+    operations.push_back({op, kind, resultKind, numRegisters, left, right});
+    return numRegisters++;
+  }
+
+  int32_t addField(const FieldReference& field);
+
+  int32_t addConstant(const ConstantExpr& constant);
+
+  int32_t addCast(TypeKind fromKind, TypeKind toKind, int32_t input);
+
+  // Register of each column by name.
+  std::unordered_map<std::string, int32_t> fieldRegisters_;
+};
+
+int32_t ProgramBuilder::add(const ExprPtr& expr) {
+  const auto kind = expr->type()->kind();
+  if (expr->isMultiplyReferenced() || !isFusedKind(kind)) {
+    return -1;
+  }
+  if (auto* field = dynamic_cast<const FieldReference*>(expr.get())) {
+    return addField(*field);
+  }
+  if (auto* constant = dynamic_cast<const ConstantExpr*>(expr.get())) {
+    return addConstant(*constant);
+  }
+
+  std::vector<int32_t> inputs;
+  for (const auto& input : expr->inputs()) {
+    auto inputRegister = add(input);
+    if (inputRegister < 0) {
+      return -1;
+    }
+    inputs.push_back(inputRegister);
+  }
+  if (inputs.empty()) {
+    return -1;
+  }
+
+  if (dynamic_cast<const ConjunctExpr*>(expr.get())) {
+    const auto op = expr->name() == "and" ? Op::kAnd : Op::kOr;
+    auto result = inputs[0];
+    for (auto i = 1; i < inputs.size(); ++i) {
+      result = addOperation(op, kind, kind, result, inputs[i]);
+    }
+    return result;
+  }
+  if (dynamic_cast<const CastExpr*>(expr.get())) {
+    return addCast(expr->inputs()[0]->type()->kind(), kind, inputs[0]);
+  }
+  if (expr->isSpecialForm() || !expr->vectorFunction()) {
+    return -1;
+  }
+
+  std::vector<TypeKind> inputKinds;
+  for (const auto& input : expr->inputs()) {
+    inputKinds.push_back(input->type()->kind());
+  }
+  const auto& name = expr->name();
+  if (name == "not") {
+    if (inputKinds.size() != 1 || inputKinds[0] != TypeKind::BOOLEAN) {
+      return -1;
+    }
+    return addOperation(Op::kNot, kind, kind, inputs[0]);
+  }
+  auto it = arithmeticOps().find(name);
+  if (it != arithmeticOps().end()) {
+    const auto arity = it->second == Op::kNegate ? 1 : 2;
+    if (kind == TypeKind::BOOLEAN || inputs.size() != arity ||
+        inputKinds[0] != kind || inputKinds.back() != kind) {
+      return -1;
+    }
+    return addOperation(it->second, kind, kind, inputs[0], inputs.back());
+  }
+  it = comparisonOps().find(name);
+  if (it != comparisonOps().end()) {
+    if (inputs.size() != 2 || inputKinds[0] != inputKinds[1] ||
+        inputKinds[0] == TypeKind::BOOLEAN) {
+      return -1;
+    }
+    return addOperation(it->second, inputKinds[0], kind, inputs[0], inputs[1]);
+  }
+  return -1;
+}
+
+int32_t ProgramBuilder::addField(const FieldReference& field) {
+  if (!field.inputs().empty()) {
+    // A field of a struct.
+    return -1;
+  }
+  auto it = fieldRegisters_.find(field.field());
+  if (it != fieldRegisters_.end()) {
+    return it->second;
+  }
+  fields.push_back(std::make_shared<FieldReference>(
+      field.type(), std::vector<ExprPtr>{}, field.field()));
+  fieldRegisters.push_back(numRegisters);
+  fieldRegisters_[field.field()] = numRegisters;
+  return numRegisters++;
+}
+
+int32_t ProgramBuilder::addConstant(const ConstantExpr& constant) {
+  const auto& value = constant.value();
+  if (!value || value->isNullAt(0)) {
+    return -1;
+  }
+  const auto kind = value->typeKind();
+  Instruction instruction{Op::kConstant, kind, kind, numRegisters};
+  switch (kind) {
+    case TypeKind::BIGINT:
+      instruction.constant = constantBits<int64_t>(*value);
+      break;
+    case TypeKind::INTEGER:
+      instruction.constant = constantBits<int32_t>(*value);
+      break;
+    case TypeKind::DOUBLE:
+      instruction.constant = constantBits<double>(*value);
+      break;
+    case TypeKind::BOOLEAN:
+      instruction.constant = constantBits<bool>(*value);
+      break;
+    default:
+      return -1;
+  }
+  constants.push_back(instruction);
+  return numRegisters++;
+}
+
+int32_t
+ProgramBuilder::addCast(TypeKind fromKind, TypeKind toKind, int32_t input) {
+  if (fromKind == toKind) {
+    return input;
+  }
+  // Only casts that cannot fail.
+  const bool widening =
+      (fromKind == TypeKind::INTEGER &&
+       (toKind == TypeKind::BIGINT || toKind == TypeKind::DOUBLE)) ||
+      (fromKind == TypeKind::BIGINT && toKind == TypeKind::DOUBLE);
+  if (!widening) {
+    return -1;
+  }
+  return addOperation(Op::kCast, fromKind, toKind, input);
+}
+
+template <typename T, typename R, typename Func>
+void applyBinary(
+    void* const* registers,
+    const Instruction& instruction,
+    int32_t numRows,
+    Func func) {
+  auto* left = static_cast<const T*>(registers[instruction.left]);
+  auto* right = static_cast<const T*>(registers[instruction.right]);
+  auto* result = static_cast<R*>(registers[instruction.result]);
+  for (auto i = 0; i < numRows; ++i) {
+    result[i] = func(left[i], right[i]);
+  }
+}
+
+template <typename T, typename R>
+void applyCast(
+    void* const* registers,
+    const Instruction& instruction,
+    int32_t numRows) {
+  auto* input = static_cast<const T*>(registers[instruction.left]);
+  auto* result = static_cast<R*>(registers[instruction.result]);
+  for (auto i = 0; i < numRows; ++i) {
+    result[i] = input[i];
+  }
+}
+
+// Runs an arithmetic operation with checked integer semantics. Returns false
+// if a row overflows or divides by zero.
+template <typename T>
+bool applyArithmetic(
+    void* const* registers,
+    const Instruction& instruction,
+    int32_t numRows) {
+  auto* left = static_cast<const T*>(registers[instruction.left]);
+  auto* right = static_cast<const T*>(registers[instruction.right]);
+  auto* result = static_cast<T*>(registers[instruction.result]);
+  bool overflow = false;
+  if constexpr (std::is_integral_v<T>) {
+    switch (instruction.op) {
+      case Op::kPlus:
+        for (auto i = 0; i < numRows; ++i) {
+          overflow |= __builtin_add_overflow(left[i], right[i], &result[i]);
+        }
+        break;
+      case Op::kMinus:
+        for (auto i = 0; i < numRows; ++i) {
+          overflow |= __builtin_sub_overflow(left[i], right[i], &result[i]);
+        }
+        break;
+      case Op::kMultiply:
+        for (auto i = 0; i < numRows; ++i) {
+          overflow |= __builtin_mul_overflow(left[i], right[i], &result[i]);
+        }
+        break;
+      case Op::kDivide:
+        for (auto i = 0; i < numRows; ++i) {
+          const bool invalid = right[i] == 0 ||
+              (right[i] == -1 && left[i] == std::numeric_limits<T>::min());
+          overflow |= invalid;
+          result[i] = left[i] / (invalid ? 1 : right[i]);
+        }
+        break;
+      case Op::kNegate:
+        for (auto i = 0; i < numRows; ++i) {
+          overflow |= __builtin_sub_overflow(T(0), left[i], &result[i]);
+        }
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  } else {
+    switch (instruction.op) {
+      case Op::kPlus:
+        applyBinary<T, T>(
+            registers, instruction, numRows, [](T a, T b) { return a + b; });
+        break;
+      case Op::kMinus:
+        applyBinary<T, T>(
+            registers, instruction, numRows, [](T a, T b) { return a - b; });
+        break;
+      case Op::kMultiply:
+        applyBinary<T, T>(
+            registers, instruction, numRows, [](T a, T b) { return a * b; });
+        break;
+      case Op::kDivide:
+        applyBinary<T, T>(
+            registers, instruction, numRows, [](T a, T b) { return a / b; });
+        break;
+      case Op::kNegate:
+        for (auto i = 0; i < numRows; ++i) {
+          result[i] = -left[i];
+        }
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+  return !overflow;
+}
+
+template <typename T>
+bool applyNumeric(
+    void* const* registers,
+    const Instruction& instruction,
+    int32_t numRows) {
+  switch (instruction.op) {
+    case Op::kCast:
+      if (instruction.resultKind == TypeKind::DOUBLE) {
+        applyCast<T, double>(registers, instruction, numRows);
+      } else {
+        applyCast<T, int64_t>(registers, instruction, numRows);
+      }
+      return true;
+    case Op::kEq:
+      applyBinary<T, bool>(
+          registers, instruction, numRows, [](T a, T b) { return a == b; });
+      return true;
+    case Op::kNeq:
+      applyBinary<T, bool>(
+          registers, instruction, numRows, [](T a, T b) { return a != b; });
+      return true;
+    case Op::kLt:
+      applyBinary<T, bool>(
+          registers, instruction, numRows, [](T a, T b) { return a < b; });
+      return true;
+    case Op::kLte:
+      applyBinary<T, bool>(
+          registers, instruction, numRows, [](T a, T b) { return a <= b; });
+      return true;
+    case Op::kGt:
+      applyBinary<T, bool>(
+          registers, instruction, numRows, [](T a, T b) { return a > b; });
+      return true;
+    case Op::kGte:
+      applyBinary<T, bool>(
+          registers, instruction, numRows, [](T a, T b) { return a >= b; });
+      return true;
+    default:
+      return applyArithmetic<T>(registers, instruction, numRows);
+  }
+}
+
+void applyLogical(
+    void* const* registers,
+    const Instruction& instruction,
+    int32_t numRows) {
+  switch (instruction.op) {
+    case Op::kAnd:
+      applyBinary<bool, bool>(
+          registers, instruction, numRows, [](bool a, bool b) {
+            return a & b;
+          });
+      break;
+    case Op::kOr:
+      applyBinary<bool, bool>(
+          registers, instruction, numRows, [](bool a, bool b) {
+            return a | b;
+          });
+      break;
+    case Op::kNot: {
+      auto* input = static_cast<const bool*>(registers[instruction.left]);
+      auto* result = static_cast<bool*>(registers[instruction.result]);
+      for (auto i = 0; i < numRows; ++i) {
+        result[i] = !input[i];
+      }
+      break;
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+template <typename T>
+void fillConstant(void* values, int64_t bits) {
+  T value;
+  memcpy(&value, &bits, sizeof(T));
+  std::fill_n(static_cast<T*>(values), FusedExpr::kBlockSize, value);
+}
+
+// Returns true if 'vector' is flat and has no nulls in 'rows'.
+bool isFlatNoNulls(const BaseVector& vector, const SelectivityVector& rows) {
+  if (vector.encoding() != VectorEncoding::Simple::FLAT) {
+    return false;
+  }
+  auto* rawNulls = vector.rawNulls();
+  return !rawNulls || rows.testSelected([&](auto row) {
+    return !bits::isBitNull(rawNulls, row);
+  });
+}
+
+// Points 'values' at the values of 'begin' and the next rows of the
+// column 'vector'. BOOLEAN values are copied into 'values'.
+template <typename T>
+void loadField(const BaseVector& vector, vector_size_t begin, void*& values) {
+  values = const_cast<T*>(vector.asUnchecked<FlatVector<T>>()->rawValues()) +
+      begin;
+}
+
+void loadBooleans(
+    const BaseVector& vector,
+    vector_size_t begin,
+    int32_t numRows,
+    void* values) {
+  auto* rawValues =
+      vector.asUnchecked<FlatVector<bool>>()->rawValues<uint64_t>();
+  auto* booleans = static_cast<bool*>(values);
+  for (auto i = 0; i < numRows; ++i) {
+    booleans[i] = bits::isBitSet(rawValues, begin + i);
+  }
+}
+
+// Copies the values of the rows of 'rows' in the block at 'begin' to
+// 'result'.
+template <typename T>
+void storeResult(
+    const SelectivityVector& rows,
+    const void* values,
+    vector_size_t begin,
+    int32_t numRows,
+    BaseVector& result) {
+  auto* typedValues = static_cast<const T*>(values);
+  if constexpr (std::is_same_v<T, bool>) {
+    auto* rawValues =
+        result.asUnchecked<FlatVector<bool>>()->mutableRawValues<uint64_t>();
+    for (auto i = 0; i < numRows; ++i) {
+      if (rows.isValid(begin + i)) {
+        bits::setBit(rawValues, begin + i, typedValues[i]);
+      }
+    }
+  } else {
+    auto* rawValues = result.asUnchecked<FlatVector<T>>()->mutableRawValues();
+    if (rows.isAllSelected()) {
+      std::copy(typedValues, typedValues + numRows, rawValues + begin);
+      return;
+    }
+    for (auto i = 0; i < numRows; ++i) {
+      if (rows.isValid(begin + i)) {
+        rawValues[begin + i] = typedValues[i];
+      }
+    }
+  }
+}
+} // namespace
+
+FusedExpr::FusedExpr(
+    ExprPtr original,
+    std::vector<ExprPtr>&& fields,
+    std::vector<int32_t> fieldRegisters,
+    std::vector<Instruction> instructions,
+    int32_t numRegisters)
+    : SpecialForm(
+          original->type(),
+          std::move(fields),
+          "fused",
+          false /* supportsFlatNoNullsFastPath */,
+          false /* trackCpuUsage */),
+      original_(std::move(original)),
+      fieldRegisters_(std::move(fieldRegisters)),
+      instructions_(std::move(instructions)),
+      registers_(numRegisters),
+      registerValues_(numRegisters * kBlockSize) {
+  for (auto i = 0; i < numRegisters; ++i) {
+    registers_[i] = registerValues_.data() + i * kBlockSize;
+  }
+}
+
+// static
+ExprPtr FusedExpr::tryCreate(const ExprPtr& expr) {
+  ProgramBuilder builder;
+  const auto result = builder.add(expr);
+  if (result < 0 || builder.operations.empty()) {
+    return nullptr;
+  }
+  VELOX_CHECK_EQ(result, builder.operations.back().result);
+  auto instructions = std::move(builder.constants);
+  instructions.insert(
+      instructions.end(),
+      builder.operations.begin(),
+      builder.operations.end());
+  std::shared_ptr<FusedExpr> fused(new FusedExpr(
+      expr,
+      std::move(builder.fields),
+      std::move(builder.fieldRegisters),
+      std::move(instructions),
+      builder.numRegisters));
+  fused->computeMetadata();
+  return fused;
+}
+
+void FusedExpr::evalSpecialForm(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  if (evalFused(rows, context, result)) {
+    ++numFusedBatches_;
+    return;
+  }
+  ++numInterpretedBatches_;
+  original_->eval(rows, context, result);
+}
+
+bool FusedExpr::evalFused(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  inputValues_.resize(inputs_.size());
+  for (auto i = 0; i < inputs_.size(); ++i) {
+    inputs_[i]->eval(rows, context, inputValues_[i]);
+    if (!isFlatNoNulls(*inputValues_[i], rows)) {
+      releaseInputValues(context);
+      return false;
+    }
+  }
+  context.ensureWritable(rows, type(), result);
+  if (result->encoding() != VectorEncoding::Simple::FLAT) {
+    releaseInputValues(context);
+    return false;
+  }
+  result->clearNulls(rows);
+
+  for (const auto& instruction : instructions_) {
+    if (instruction.op != Op::kConstant) {
+      break;
+    }
+    auto* values = registers_[instruction.result];
+    switch (instruction.kind) {
+      case TypeKind::BIGINT:
+        fillConstant<int64_t>(values, instruction.constant);
+        break;
+      case TypeKind::INTEGER:
+        fillConstant<int32_t>(values, instruction.constant);
+        break;
+      case TypeKind::DOUBLE:
+        fillConstant<double>(values, instruction.constant);
+        break;
+      default:
+        fillConstant<bool>(values, instruction.constant);
+        break;
+    }
+  }
+
+  const auto& resultInstruction = instructions_.back();
+  bool success = true;
+  for (auto begin = rows.begin(); begin < rows.end(); begin += kBlockSize) {
+    const auto numRows = std::min<int32_t>(kBlockSize, rows.end() - begin);
+    for (auto i = 0; i < inputs_.size(); ++i) {
+      const auto& input = *inputValues_[i];
+      auto& values = registers_[fieldRegisters_[i]];
+      switch (input.typeKind()) {
+        case TypeKind::BIGINT:
+          loadField<int64_t>(input, begin, values);
+          break;
+        case TypeKind::INTEGER:
+          loadField<int32_t>(input, begin, values);
+          break;
+        case TypeKind::DOUBLE:
+          loadField<double>(input, begin, values);
+          break;
+        default:
+          loadBooleans(input, begin, numRows, values);
+          break;
+      }
+    }
+    if (!runBlock(numRows)) {
+      success = false;
+      break;
+    }
+    const auto* values = registers_[resultInstruction.result];
+    switch (resultInstruction.resultKind) {
+      case TypeKind::BIGINT:
+        storeResult<int64_t>(rows, values, begin, numRows, *result);
+        break;
+      case TypeKind::INTEGER:
+        storeResult<int32_t>(rows, values, begin, numRows, *result);
+        break;
+      case TypeKind::DOUBLE:
+        storeResult<double>(rows, values, begin, numRows, *result);
+        break;
+      default:
+        storeResult<bool>(rows, values, begin, numRows, *result);
+        break;
+    }
+  }
+  releaseInputValues(context);
+  return success;
+}
+
+bool FusedExpr::runBlock(int32_t numRows) {
+  auto* registers = registers_.data();
+  for (const auto& instruction : instructions_) {
+    if (instruction.op == Op::kConstant) {
+      continue;
+    }
+    bool success = true;
+    switch (instruction.kind) {
+      case TypeKind::BIGINT:
+        success = applyNumeric<int64_t>(registers, instruction, numRows);
+        break;
+      case TypeKind::INTEGER:
+        success = applyNumeric<int32_t>(registers, instruction, numRows);
+        break;
+      case TypeKind::DOUBLE:
+        success = applyNumeric<double>(registers, instruction, numRows);
+        break;
+      default:
+        applyLogical(registers, instruction, numRows);
+        break;
+    }
+    if (!success) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace facebook::velox::exec
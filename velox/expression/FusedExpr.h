@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/expression/SpecialForm.h"
+
+namespace facebook::velox::exec {
+
+/// Evaluates a tree of arithmetic, comparison and logical functions over
+/// BIGINT, INTEGER, DOUBLE and BOOLEAN columns and constants with a single
+/// loop over blocks of rows. The tree is compiled into a program of typed
+/// instructions when the ExprSet is made. Each instruction runs over a block
+/// of kBlockSize rows at a time, so that intermediate results stay in the
+/// cache and there are no intermediate vectors, null checks or function calls
+/// per row.
+///
+/// The fused functions are plus, minus, multiply, divide, negate, eq, neq,
+/// lt, lte, gt, gte, not, widening casts, AND and OR with the semantics of the
+/// Presto functions of these names. If the tree propagates nulls, rows with a
+/// null input are removed before evaluation. If an input column of a batch is
+/// not flat or has nulls in the evaluated rows, or if a row overflows or
+/// divides by zero, the batch is evaluated by the interpreted tree instead, so
+/// that results and errors are the same as without fusion.
+class FusedExpr : public SpecialForm {
+ public:
+  static constexpr int32_t kBlockSize = 256;
+
+  enum class Op : uint8_t {
+    kConstant,
+    kCast,
+    kPlus,
+    kMinus,
+    kMultiply,
+    kDivide,
+    kNegate,
+    kEq,
+    kNeq,
+    kLt,
+    kLte,
+    kGt,
+    kGte,
+    kNot,
+    kAnd,
+    kOr,
+  };
+
+  /// Computes register 'result' of type 'resultKind' from registers 'left'
+  /// and 'right' of type 'kind'. A kConstant sets 'result' to 'constant',
+  /// which holds the bits of a value of 'kind'.
+  struct Instruction {
+    Op op;
+    TypeKind kind;
+    TypeKind resultKind;
+    int32_t result;
+    int32_t left{-1};
+    int32_t right{-1};
+    int64_t constant{0};
+  };
+
+  /// Returns an Expr that evaluates 'expr' with a fused program or nullptr if
+  /// 'expr' has parts that cannot be fused or is a single column or constant.
+  static ExprPtr tryCreate(const ExprPtr& expr);
+
+  void evalSpecialForm(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result) override;
+
+  bool propagatesNulls() const override {
+    return original_->propagatesNulls();
+  }
+
+  std::string toString(bool recursive = true) const override {
+    return original_->toString(recursive);
+  }
+
+  std::string toSql(
+      std::vector<VectorPtr>* complexConstants = nullptr) const override {
+    return original_->toSql(complexConstants);
+  }
+
+  const std::vector<Instruction>& instructions() const {
+    return instructions_;
+  }
+
+  /// Number of batches evaluated by the fused program.
+  int64_t numFusedBatches() const {
+    return numFusedBatches_;
+  }
+
+  /// Number of batches evaluated by the interpreted tree.
+  int64_t numInterpretedBatches() const {
+    return numInterpretedBatches_;
+  }
+
+ private:
+  FusedExpr(
+      ExprPtr original,
+      std::vector<ExprPtr>&& fields,
+      std::vector<int32_t> fieldRegisters,
+      std::vector<Instruction> instructions,
+      int32_t numRegisters);
+
+  // Evaluates 'rows' with the program. Returns false if the batch must be
+  // evaluated by 'original_'.
+  bool evalFused(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
+  // Runs 'instructions_' on 'numRows' rows of the current block. Returns
+  // false on overflow or division by zero.
+  bool runBlock(int32_t numRows);
+
+  // The interpreted tree.
+  const ExprPtr original_;
+
+  // The register of each of 'inputs_'.
+  const std::vector<int32_t> fieldRegisters_;
+
+  // The constants first, then the operations in evaluation order. The result
+  // is in the register of the last instruction.
+  const std::vector<Instruction> instructions_;
+
+  // Values of each register for the current block. Registers of columns other
+  // than BOOLEAN point into the input vectors.
+  std::vector<void*> registers_;
+
+  // Storage for the registers with kBlockSize values each.
+  std::vector<int64_t> registerValues_;
+
+  int64_t numFusedBatches_{0};
+  int64_t numInterpretedBatches_{0};
+};
+
+} // namespace facebook::velox::exec
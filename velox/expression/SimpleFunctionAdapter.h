@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <optional>
+#include <tuple>
 
 #include "velox/common/base/Portability.h"
 #include "velox/expression/ComplexWriterTypes.h"
@@ -52,6 +54,64 @@ struct IsMapWriter<MapWriter<K, V>> {
   static constexpr bool value = true;
 };
 
+template <typename TReader>
+struct IsBatchReader {
+  static constexpr bool value = false;
+};
+
+template <typename T>
+struct IsBatchReader<FlatVectorReader<T>> {
+  static constexpr bool value = true;
+};
+
+template <typename T>
+struct IsBatchReader<ConstantVectorReader<T>> {
+  static constexpr bool value = true;
+};
+
+/// Number of rows passed to a single callBatch() of a simple function.
+constexpr int32_t kSimpleFunctionBatchSize = 64;
+
+/// Values of one argument for callBatch(). at(row) points to the values of a
+/// flat argument starting at 'row' or to kSimpleFunctionBatchSize copies of
+/// a constant argument.
+template <typename TReader>
+class BatchArgument;
+
+template <typename T>
+class BatchArgument<FlatVectorReader<T>> {
+ public:
+  using value_t = typename FlatVectorReader<T>::exec_in_t;
+
+  explicit BatchArgument(const FlatVectorReader<T>& reader)
+      : values_(reader.values) {}
+
+  const value_t* at(vector_size_t row) const {
+    return values_ + row;
+  }
+
+ private:
+  const value_t* const values_;
+};
+
+template <typename T>
+class BatchArgument<ConstantVectorReader<T>> {
+ public:
+  using value_t = typename ConstantVectorReader<T>::exec_in_t;
+
+  // A null constant leaves no rows to evaluate for default null behavior.
+  explicit BatchArgument(const ConstantVectorReader<T>& reader) {
+    values_.fill(reader.value.value_or(value_t{}));
+  }
+
+  const value_t* at(vector_size_t /*row*/) const {
+    return values_.data();
+  }
+
+ private:
+  std::array<value_t, kSimpleFunctionBatchSize> values_;
+};
+
 template <class T, class = void>
 struct udf_reuse_strings_from_arg : std::integral_constant<int32_t, -1> {};
 
@@ -79,6 +139,13 @@ class SimpleFunctionAdapter : public VectorFunction {
   static constexpr bool fastPathIteration =
       return_type_traits::isPrimitiveType && return_type_traits::isFixedWidth;
 
+  // Whether the UDF provides callBatch() and it can be used for the rows that
+  // are left after removing the rows with null arguments. Requires flat or
+  // constant arguments, see IsBatchReader.
+  static constexpr bool batchIteration = FUNC::udf_has_callBatch &&
+      FUNC::udf_has_call && FUNC::is_default_null_behavior &&
+      fastPathIteration && return_type_traits::typeKind != TypeKind::BOOLEAN;
+
   // Check that the argument at POSITION is a primitive type, that is not
   // boolean.
   template <int32_t POSITION>
@@ -513,6 +580,11 @@ class SimpleFunctionAdapter : public VectorFunction {
 
   template <typename... TReader>
   void iterate(ApplyContext& applyContext, TReader&... readers) const {
+    if constexpr (batchIteration && (IsBatchReader<TReader>::value && ...)) {
+      applyBatch(applyContext, readers...);
+      return;
+    }
+
     // If udf_has_callNullFree is true compute mayHaveNullsRecursive.
     if constexpr (FUNC::udf_has_callNullFree) {
       (
@@ -557,7 +629,7 @@ class SimpleFunctionAdapter : public VectorFunction {
       };
 
       auto* data = getRawData();
-      auto writeResult = [&applyContext, &nullBuffer, &data](
+      auto writeResult = [this, &applyContext, &nullBuffer, &data](
                              auto row, bool notNull, auto out) INLINE_LAMBDA {
         // For fast path iteration, all active rows were already set as
         // non-null beforehand, so we only need to update the null buffer if
@@ -573,6 +645,7 @@ class SimpleFunctionAdapter : public VectorFunction {
             nullBuffer = applyContext.result->mutableRawNulls();
           }
           bits::setNull(nullBuffer, row);
+          setFailedStatus(applyContext, row);
         }
       };
       if (callNullFree) {
@@ -656,6 +729,66 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
   }
 
+  // Calls callBatch() for the runs of consecutive selected rows, at most
+  // kSimpleFunctionBatchSize rows at a time. Unlike the row by row loops
+  // above, there is no exception handling per row, so the UDF can process
+  // the values with SIMD instructions. If a batch throws, its rows are
+  // evaluated again one by one to set the errors of the failing rows.
+  template <typename... TReader>
+  void applyBatch(ApplyContext& applyContext, TReader&... readers) const {
+    auto* data = applyContext.resultWriter.data_;
+    const std::tuple<BatchArgument<TReader>...> args{
+        BatchArgument<TReader>(readers)...};
+    auto applyRange = [&](vector_size_t begin, vector_size_t end) {
+      std::apply(
+          [&](const auto&... batchArgs) {
+            try {
+              (*fn_).callBatch(
+                  end - begin, data + begin, batchArgs.at(begin)...);
+              return;
+            } catch (const std::exception&) {
+            }
+            for (auto row = begin; row < end; ++row) {
+              try {
+                typename return_type_traits::NativeType out{};
+                if (doApplyNotNull<0>(row, out, readers...)) {
+                  data[row] = out;
+                } else {
+                  bits::setNull(applyContext.result->mutableRawNulls(), row);
+                  setFailedStatus(applyContext, row);
+                }
+              } catch (const std::exception&) {
+                applyContext.context.setError(row, std::current_exception());
+              }
+            }
+          },
+          args);
+    };
+
+    const auto& rows = *applyContext.rows;
+    if (rows.isAllSelected()) {
+      for (auto begin = rows.begin(); begin < rows.end();
+           begin += kSimpleFunctionBatchSize) {
+        applyRange(
+            begin, std::min(begin + kSimpleFunctionBatchSize, rows.end()));
+      }
+      return;
+    }
+    const auto* selected = rows.asRange().bits();
+    bits::forEachWord(
+        rows.begin(), rows.end(), [&](int32_t index, uint64_t mask) {
+          auto word = selected[index] & mask;
+          while (word) {
+            const int32_t first = __builtin_ctzll(word);
+            const uint64_t unselected = ~(word >> first);
+            const int32_t last =
+                unselected ? first + __builtin_ctzll(unselected) : 64;
+            applyRange(index * 64 + first, index * 64 + last);
+            word = last == 64 ? 0 : word & ~bits::lowMask(last);
+          }
+        });
+  }
+
   template <typename Func>
   void applyUdf(ApplyContext& applyContext, Func func) const {
     if constexpr (IsArrayWriter<T>::value || IsMapWriter<T>::value) {
@@ -670,17 +803,36 @@ class SimpleFunctionAdapter : public VectorFunction {
         auto notNull = func(localWriter, row);
         currentWriter = localWriter;
         applyContext.resultWriter.commit(notNull);
+        if (!notNull) {
+          setFailedStatus(applyContext, row);
+        }
       });
       applyContext.resultWriter.finish();
     } else {
       applyContext.applyToSelectedNoThrow([&](auto row) INLINE_LAMBDA {
         applyContext.resultWriter.setOffset(row);
-        applyContext.resultWriter.commit(
-            func(applyContext.resultWriter.current(), row));
+        const bool notNull = func(applyContext.resultWriter.current(), row);
+        applyContext.resultWriter.commit(notNull);
+        if (!notNull) {
+          setFailedStatus(applyContext, row);
+        }
       });
     }
   }
 
+  // Records the failed Status returned by call() for 'row' as the error of
+  // the row. Throws it if errors are not captured. No-op for UDFs whose call()
+  // does not return Status.
+  FOLLY_ALWAYS_INLINE void setFailedStatus(
+      ApplyContext& applyContext,
+      vector_size_t row) const {
+    if constexpr (FUNC::udf_has_call_return_status) {
+      if (UNLIKELY((*fn_).hasFailedStatus())) {
+        applyContext.context.setStatus(row, (*fn_).takeStatus());
+      }
+    }
+  }
+
   // == NULLABLE VARIANTS ==
 
   // For default null behavior, assume everything is not null.
@@ -28,20 +28,26 @@ class CastBenchmark : public functions::test::FunctionBenchmarkBase {
   CastBenchmark() : FunctionBenchmarkBase() {}
 
   size_t doRun(const TypePtr& inputType, const TypePtr& outputType) {
+    folly::BenchmarkSuspender suspender;
+    facebook::velox::VectorFuzzer fuzzer({}, pool());
+    // With encodings, evalMemo can get invoked which does a copy and adds a lot
+    // of overhead.
+    auto input = fuzzer.fuzzFlatNotNull(inputType);
+    suspender.dismiss();
+
+    return doRun(input, outputType);
+  }
+
+  size_t doRun(const VectorPtr& input, const TypePtr& outputType) {
     folly::BenchmarkSuspender suspender;
     std::string colName = "c0";
     std::vector<facebook::velox::core::TypedExprPtr> inputs{
         std::make_shared<facebook::velox::core::FieldAccessTypedExpr>(
-            inputType, colName)};
+            input->type(), colName)};
     std::vector<facebook::velox::core::TypedExprPtr> expr{
         std::make_shared<facebook::velox::core::CastTypedExpr>(
             outputType, inputs, false)};
     exec::ExprSet exprSet(expr, &execCtx_);
-
-    facebook::velox::VectorFuzzer fuzzer({}, pool());
-    // With encodings, evalMemo can get invoked which does a copy and adds a lot
-    // of overhead.
-    auto input = fuzzer.fuzzFlatNotNull(inputType);
     auto rowVector = vectorMaker_.rowVector({colName}, {input});
     suspender.dismiss();
 
@@ -69,6 +75,55 @@ BENCHMARK_MULTI(scalar) {
   return benchmark.doRun(INTEGER(), BIGINT());
 }
 
+// Strings of numbers as read from CSV.
+VectorPtr makeNumberStrings(
+    CastBenchmark& benchmark,
+    std::function<std::string(vector_size_t)> valueAt) {
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 10'000; ++i) {
+    strings.push_back(valueAt(i));
+  }
+  return benchmark.maker().flatVector(strings);
+}
+
+BENCHMARK_MULTI(varcharToBigint) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  auto input = makeNumberStrings(benchmark, [](auto row) {
+    return std::to_string(row * 1'234'567L - 1'000'000'000L);
+  });
+  suspender.dismiss();
+
+  return benchmark.doRun(input, BIGINT());
+}
+
+BENCHMARK_MULTI(varcharToDouble) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  auto input = makeNumberStrings(benchmark, [](auto row) {
+    return fmt::format("{}.{:02}", row * 1'237 % 100'000, row % 100);
+  });
+  suspender.dismiss();
+
+  return benchmark.doRun(input, DOUBLE());
+}
+
+BENCHMARK_MULTI(bigintToVarchar) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRun(BIGINT(), VARCHAR());
+}
+
+BENCHMARK_MULTI(doubleToVarchar) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRun(DOUBLE(), VARCHAR());
+}
+
 BENCHMARK_MULTI(renameSmallStruct) {
   folly::BenchmarkSuspender suspender;
   CastBenchmark benchmark;
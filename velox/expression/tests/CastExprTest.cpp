@@ -202,6 +202,129 @@ TEST_F(CastExprTest, basics) {
   testCast<bool, std::string>("string", {true, false}, {"true", "false"});
 }
 
+TEST_F(CastExprTest, stringsToNumbers) {
+  // Plain numbers are parsed in a batch, the other forms by folly::to.
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"0",
+       "-0",
+       "007",
+       "12345678",
+       "-123456789012345678",
+       "9223372036854775807",
+       "-9223372036854775808",
+       std::nullopt},
+      {0,
+       0,
+       7,
+       12345678,
+       -123456789012345678,
+       std::numeric_limits<int64_t>::max(),
+       std::numeric_limits<int64_t>::min(),
+       std::nullopt});
+  testCast<std::string, int8_t>(
+      "tinyint", {"127", "-128", "-0012"}, {127, -128, -12});
+  testCast<std::string, int8_t>("tinyint", {"1", "128"}, {}, true);
+  testCast<std::string, int32_t>("integer", {"12", "1.5"}, {}, true);
+  testCast<std::string, int32_t>("integer", {"12", "-"}, {}, true);
+  testCast<std::string, int16_t>(
+      "smallint",
+      {"1", "x2", "", "-32768"},
+      {1, std::nullopt, std::nullopt, -32768},
+      false,
+      true);
+
+  testCast<std::string, double>(
+      "double",
+      {"1.5",
+       "-0.25",
+       "0.1",
+       "123456789012345",
+       "1234567890.12345",
+       "1e3",
+       "12345678901234567890"},
+      {1.5,
+       -0.25,
+       0.1,
+       123456789012345,
+       1234567890.12345,
+       1000,
+       12345678901234567890.0});
+  testCast<std::string, float>(
+      "real", {"1.5", "0.1", "-3", "2.5e1"}, {1.5, 0.1, -3, 25});
+
+  // Batches of many digits match folly::to.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 1'000; ++i) {
+    const int64_t value = (i * 7'919'811'111L) ^ (i << 11);
+    strings.push_back(i % 2 ? std::to_string(value) : std::to_string(-value));
+    strings.push_back(fmt::format("{}.{:03}", value % 1'000'000'000, i));
+  }
+  auto data = makeRowVector({makeFlatVector(strings)});
+  auto result = evaluate("try_cast(c0 as double)", data);
+  auto expected = makeFlatVector<double>(strings.size(), [&](auto row) {
+    return folly::to<double>(strings[row]);
+  });
+  assertEqualVectors(expected, result);
+  result = evaluate("try_cast(c0 as bigint)", data);
+  auto expectedIntegers = makeFlatVector<int64_t>(
+      strings.size(),
+      [&](auto row) {
+        return row % 2 == 1 ? 0 : folly::to<int64_t>(strings[row]);
+      },
+      [](auto row) { return row % 2 == 1; });
+  assertEqualVectors(expectedIntegers, result);
+}
+
+TEST_F(CastExprTest, malformedStringsToNumbers) {
+  // The rows that fail are nulls under TRY_CAST and errors that TRY turns
+  // into nulls.
+  auto data = makeRowVector({makeFlatVector<std::string>(
+      {"1", "abc", "2.5", "", "-7", "99999999999999999999"})});
+  auto expected = makeNullableFlatVector<int64_t>(
+      {1, std::nullopt, std::nullopt, std::nullopt, -7, std::nullopt});
+  assertEqualVectors(expected, evaluate("try_cast(c0 as bigint)", data));
+  assertEqualVectors(expected, evaluate("try(cast(c0 as bigint))", data));
+  VELOX_ASSERT_THROW(
+      evaluate("cast(c0 as bigint)", data),
+      "Failed to cast from VARCHAR to BIGINT: abc.");
+
+  auto expectedDoubles = makeNullableFlatVector<double>(
+      {1, std::nullopt, 2.5, std::nullopt, -7, 99999999999999999999.0});
+  assertEqualVectors(
+      expectedDoubles, evaluate("try(cast(c0 as double))", data));
+
+  setCastIntByTruncate(true);
+  assertEqualVectors(expected, evaluate("try(cast(c0 as bigint))", data));
+  setCastIntByTruncate(false);
+}
+
+TEST_F(CastExprTest, numbersToStrings) {
+  testCast<int64_t, std::string>(
+      "varchar",
+      {0,
+       -1,
+       1'234'567'890'123,
+       std::numeric_limits<int64_t>::max(),
+       std::numeric_limits<int64_t>::min(),
+       std::nullopt},
+      {"0",
+       "-1",
+       "1234567890123",
+       "9223372036854775807",
+       "-9223372036854775808",
+       std::nullopt});
+  testCast<int8_t, std::string>("varchar", {-128, 5}, {"-128", "5"});
+  testCast<float, std::string>("varchar", {1.5, -0.25}, {"1.5", "-0.25"});
+
+  setCastIntByTruncate(true);
+  testCast<double, std::string>(
+      "varchar", {1.0, 2.5, -3.0}, {"1.0", "2.5", "-3.0"});
+  setCastIntByTruncate(false);
+  testCast<double, std::string>(
+      "varchar", {1.0, 2.5, -3.0}, {"1", "2.5", "-3"});
+}
+
 TEST_F(CastExprTest, timestamp) {
   testCast<std::string, Timestamp>(
       "timestamp",
@@ -16,6 +16,7 @@
 #include "gtest/gtest.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/ExprCompiler.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/parse/TypeResolver.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
@@ -102,6 +103,30 @@ TEST_F(ExprCompilerTest, constantFolding) {
       "plus(plus(a, 1:BIGINT), 5:BIGINT)", compile(expression)->toString());
 }
 
+TEST_F(ExprCompilerTest, foldConstants) {
+  auto rowType = ROW({"a"}, {BIGINT()});
+  auto field = makeField(rowType);
+
+  // a + (1 + 5) => a + 6 at the level of typed expressions.
+  auto folded = foldConstants(
+      {call("plus", {field("a"), call("plus", {bigint(1), bigint(5)})}),
+       field("a")},
+      execCtx_.get());
+  ASSERT_EQ(2, folded.size());
+  ASSERT_EQ("plus(\"a\",6)", folded[0]->toString());
+  ASSERT_EQ("plus(a, 6:BIGINT)", compile(folded[0])->toString());
+
+  // Unchanged expressions are returned as is.
+  auto expression = call("plus", {field("a"), bigint(1)});
+  ASSERT_EQ(expression, foldConstants({expression}, execCtx_.get())[0]);
+
+  // A call that fails is not folded.
+  expression = call("divide", {bigint(1), bigint(0)});
+  ASSERT_EQ(
+      "divide(1,0)",
+      foldConstants({expression}, execCtx_.get())[0]->toString());
+}
+
 TEST_F(ExprCompilerTest, andFlattening) {
   auto rowType =
       ROW({"a", "b", "c", "d"}, {BOOLEAN(), BOOLEAN(), BOOLEAN(), BOOLEAN()});
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/ExprRewriter.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+class ExprRewriterTest : public functions::test::FunctionBaseTest {
+ protected:
+  void SetUp() override {
+    exec::ExprRewriter::addDefaultRules(rewriter_);
+  }
+
+  // Checks that 'expression' is rewritten into 'expected'.
+  void assertRewrite(
+      const std::string& expression,
+      const std::string& expected) {
+    auto original = makeTypedExpr(expression, rowType_);
+    auto rewritten = rewriter_.rewrite(original);
+    auto expectedExpr = makeTypedExpr(expected, rowType_);
+    EXPECT_EQ(*expectedExpr, *rewritten)
+        << expression << " rewritten to " << rewritten->toString();
+  }
+
+  void assertNoRewrite(const std::string& expression) {
+    auto original = makeTypedExpr(expression, rowType_);
+    EXPECT_EQ(original, rewriter_.rewrite(original)) << expression;
+  }
+
+  // Checks that 'expression' gives the same result on 'data' with and
+  // without the rewrites in compileExpressions.
+  void assertSameResult(
+      const std::string& expression,
+      const RowVectorPtr& data) {
+    setRewrite(false);
+    auto expected = evaluate(*compileExpression(expression, rowType_), data);
+    setRewrite(true);
+    auto result = evaluate(*compileExpression(expression, rowType_), data);
+    setRewrite(false);
+    assertEqualVectors(expected, result);
+  }
+
+  void setRewrite(bool enabled) {
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kExprRewriteEnabled, enabled ? "true" : "false"},
+    });
+  }
+
+  VectorPtr evaluate(exec::ExprSet& exprSet, const RowVectorPtr& data) {
+    exec::EvalCtx context(&execCtx_, &exprSet, data.get());
+    SelectivityVector rows(data->size());
+    std::vector<VectorPtr> result(1);
+    exprSet.eval(rows, context, result);
+    return result[0];
+  }
+
+  const RowTypePtr rowType_{ROW(
+      {"c0", "c1", "c2", "c3"},
+      {BIGINT(), INTEGER(), BOOLEAN(), DOUBLE()})};
+  exec::ExprRewriter rewriter_;
+};
+
+TEST_F(ExprRewriterTest, rules) {
+  assertRewrite("not (not (c0 > 1))", "c0 > 1");
+  assertRewrite("c0 > 1 and true", "c0 > 1");
+  assertRewrite("c0 > 1 and false", "false");
+  assertRewrite("c0 > 1 or false", "c0 > 1");
+  assertRewrite("c0 > 1 or true", "true");
+  assertRewrite("c2 and c2", "c2");
+  assertRewrite("coalesce(c0, c0)", "c0");
+  assertRewrite("cast(cast(c1 as bigint) as bigint)", "cast(c1 as bigint)");
+  assertRewrite("c0 in (1, 2, 1, 3, 2)", "c0 in (1, 2, 3)");
+
+  // Inputs are rewritten before the node that uses them.
+  assertRewrite("not (not (c2 and true))", "c2");
+
+  auto hits = rewriter_.ruleHits();
+  EXPECT_EQ(2, hits["double_negation"]);
+  EXPECT_EQ(5, hits["and_or_constants"]);
+  EXPECT_EQ(1, hits["and_or_duplicates"]);
+  EXPECT_EQ(1, hits["coalesce"]);
+  EXPECT_EQ(1, hits["redundant_cast"]);
+  EXPECT_EQ(1, hits["in_list_duplicates"]);
+  rewriter_.resetRuleHits();
+  EXPECT_EQ(0, rewriter_.ruleHits()["double_negation"]);
+
+  // Calls are not deduplicated since they are not known to be deterministic.
+  assertNoRewrite("c0 > 1 and c0 > 1");
+  assertNoRewrite("coalesce(c0 + 1, c0 + 1)");
+  // Comparing a floating point value with itself is false for NaN.
+  assertNoRewrite("c3 = c3");
+  assertNoRewrite("c0 in (1, 2, 3)");
+}
+
+TEST_F(ExprRewriterTest, sharedSubtrees) {
+  auto shared = makeTypedExpr("not (not (c0 > 1))", rowType_);
+  auto rewritten = rewriter_.rewrite({shared, shared});
+  ASSERT_EQ(2, rewritten.size());
+  EXPECT_EQ(rewritten[0], rewritten[1]);
+  EXPECT_EQ(1, rewriter_.ruleHits()["double_negation"]);
+}
+
+TEST_F(ExprRewriterTest, addRule) {
+  rewriter_.addRule(
+      "plus_zero", [](const core::TypedExprPtr& expr) -> core::TypedExprPtr {
+        auto call = std::dynamic_pointer_cast<const core::CallTypedExpr>(expr);
+        if (!call || call->name() != "plus") {
+          return nullptr;
+        }
+        auto constant =
+            std::dynamic_pointer_cast<const core::ConstantTypedExpr>(
+                call->inputs()[1]);
+        if (constant && constant->value() == variant(0L)) {
+          return call->inputs()[0];
+        }
+        return nullptr;
+      });
+  assertRewrite("(c0 + 0) + 0", "c0");
+  EXPECT_EQ(2, rewriter_.ruleHits()["plus_zero"]);
+
+  VELOX_ASSERT_THROW(
+      rewriter_.addRule("plus_zero", nullptr), "Duplicate rewrite rule");
+}
+
+TEST_F(ExprRewriterTest, results) {
+  auto data = makeRowVector({
+      makeNullableFlatVector<int64_t>({1, 2, std::nullopt, 4, 5}),
+      makeNullableFlatVector<int32_t>({std::nullopt, 2, 3, 4, 5}),
+      makeNullableFlatVector<bool>({true, std::nullopt, false, true, false}),
+      makeNullableFlatVector<double>({1.0, std::nullopt, 3.0, 4.0, 5.0}),
+  });
+  for (const auto& expression :
+       {"not (not (c0 > 1))",
+        "c0 > 1 and true",
+        "c0 > 1 or true",
+        "c2 and c2",
+        "coalesce(c0, c0)",
+        "coalesce(c0, cast(c1 as bigint), c0)",
+        "cast(cast(c1 as bigint) as bigint)",
+        "c0 in (1, 1, 2, 5)",
+        "c0 = c0",
+        "c0 <> c0",
+        "c0 < c0",
+        "c1 >= c1",
+        "c0 = c0 or c2"}) {
+    SCOPED_TRACE(expression);
+    assertSameResult(expression, data);
+  }
+}
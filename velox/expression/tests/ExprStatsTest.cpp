@@ -18,6 +18,7 @@
 #include "velox/core/Expressions.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/ExprProfiler.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 #include "velox/parse/Expressions.h"
@@ -430,3 +431,59 @@ TEST_F(ExprStatsTest, errorLog) {
 
   ASSERT_TRUE(exec::unregisterExprSetListener(listener));
 }
+
+TEST_F(ExprStatsTest, profiler) {
+  auto profiler = std::make_shared<exec::ExprProfiler>();
+  ASSERT_TRUE(exec::registerExprSetListener(profiler));
+
+  const vector_size_t size = 100;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 7; }),
+  });
+  // Repeats each row 5 times.
+  auto indices = makeIndices(size, [](auto row) { return row / 5; });
+  auto dictionaryData = makeRowVector({
+      wrapInDictionary(indices, size, data->childAt(0)),
+      wrapInDictionary(indices, size, data->childAt(1)),
+  });
+
+  auto rowType = asRowType(data->type());
+  {
+    // The flat batch takes the flat no-nulls fast path. The dictionary batch
+    // is evaluated on the 20 distinct rows.
+    auto exprSet = compileExpressions({"c0 + c1"}, rowType);
+    evaluate(*exprSet, data);
+    evaluate(*exprSet, dictionaryData);
+  }
+  {
+    auto exprSet = compileExpressions({"c0 * c1"}, rowType);
+    evaluate(*exprSet, data);
+  }
+
+  auto stats = profiler->queryStats(queryCtx_->queryId());
+  ASSERT_EQ(2, stats.size());
+  const auto& plus = stats.at("plus");
+  ASSERT_EQ(2, plus.numProcessedVectors);
+  ASSERT_EQ(size + 20, plus.numProcessedRows);
+  ASSERT_EQ(size, plus.numFlatNoNullsRows);
+  ASSERT_EQ(20, plus.numPeeledRows);
+  ASSERT_GT(plus.numOutputBytes, 0);
+  ASSERT_GT(plus.timing.cpuNanos, 0);
+  ASSERT_EQ(size, stats.at("multiply").numProcessedRows);
+
+  std::unordered_map<std::string, int64_t> runtimeStats;
+  for (const auto& [name, counter] :
+       exec::ExprProfiler::toRuntimeStats(stats)) {
+    runtimeStats[name] = counter.value;
+  }
+  ASSERT_EQ(size + 20, runtimeStats.at("expr.plus.processedRows"));
+  ASSERT_EQ(size, runtimeStats.at("expr.plus.flatNoNullsRows"));
+  ASSERT_EQ(20, runtimeStats.at("expr.plus.peeledRows"));
+  ASSERT_EQ(plus.numOutputBytes, runtimeStats.at("expr.plus.outputBytes"));
+  ASSERT_EQ(size, runtimeStats.at("expr.multiply.processedRows"));
+
+  profiler->clear(queryCtx_->queryId());
+  ASSERT_TRUE(profiler->queryStats(queryCtx_->queryId()).empty());
+  ASSERT_TRUE(exec::unregisterExprSetListener(profiler));
+}
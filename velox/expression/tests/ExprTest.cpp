@@ -344,6 +344,98 @@ TEST_F(ExprTest, reorder) {
   }
 }
 
+TEST_F(ExprTest, reorderAfterChange) {
+  auto makeData = [&](int64_t a, int64_t b) {
+    return makeRowVector({
+        makeFlatVector<int64_t>(1'000, [&](auto /*row*/) { return a; }),
+        makeFlatVector<int64_t>(1'000, [&](auto /*row*/) { return b; }),
+    });
+  };
+  auto first = makeData(0, 1);
+  auto second = makeData(1, 0);
+  auto exprSet = compileExpression(
+      "c0 * 3 + 1 = 4 and c1 * 3 + 1 = 4", asRowType(first->type()));
+  auto condition =
+      std::dynamic_pointer_cast<exec::ConjunctExpr>(exprSet->expr(0));
+  ASSERT_TRUE(condition != nullptr);
+
+  // The first input drops all rows.
+  for (auto i = 0; i < 100; ++i) {
+    evaluate(exprSet.get(), first);
+  }
+  EXPECT_EQ(0, condition->inputOrder()[0]);
+
+  // Now the second input drops all rows. The measurements of the first
+  // batches decay and the second input moves first.
+  for (auto i = 0; i < 10 * exec::ConjunctExpr::kStatsDecayInterval; ++i) {
+    evaluate(exprSet.get(), second);
+  }
+  EXPECT_EQ(1, condition->inputOrder()[0]);
+}
+
+TEST_F(ExprTest, distinctDictionaryIndices) {
+  const vector_size_t size = 1'000;
+  auto makeInput = [&](vector_size_t aSize,
+                       vector_size_t bSize,
+                       std::function<vector_size_t(vector_size_t)> aIndex,
+                       std::function<vector_size_t(vector_size_t)> bIndex) {
+    auto a = makeFlatVector<int64_t>(aSize, [](auto row) { return row + 1; });
+    auto b = makeFlatVector<int64_t>(
+        bSize, [](auto row) { return row % 4 == 1 ? 0 : row * 10; });
+    return makeRowVector({
+        wrapInDictionary(makeIndices(size, aIndex), size, a),
+        wrapInDictionary(makeIndices(size, bIndex), size, b),
+    });
+  };
+  auto test = [&](const RowVectorPtr& input, int64_t expectedNumRows) {
+    auto exprSet =
+        compileExpression("try(c0 / c1) + c0", asRowType(input->type()));
+    auto result = evaluate(exprSet.get(), input);
+    auto a = input->childAt(0)->as<SimpleVector<int64_t>>();
+    auto b = input->childAt(1)->as<SimpleVector<int64_t>>();
+    assertEqualVectors(
+        makeFlatVector<int64_t>(
+            size,
+            [&](auto row) {
+              auto divisor = b->valueAt(row);
+              return divisor == 0 ? 0
+                                  : a->valueAt(row) / divisor + a->valueAt(row);
+            },
+            [&](auto row) { return b->valueAt(row) == 0; }),
+        result);
+    // The division runs once for each distinct pair of indices.
+    auto divide = exprSet->expr(0)->inputs()[0]->inputs()[0];
+    EXPECT_EQ(expectedNumRows, divide->stats().numProcessedRows);
+  };
+
+  // Small dictionaries have 12 combinations of indices.
+  test(
+      makeInput(
+          3,
+          4,
+          [](auto row) { return row % 3; },
+          [](auto row) { return row % 4; }),
+      12);
+
+  // Large dictionaries with 5 * 8 combinations of indices in use.
+  test(
+      makeInput(
+          size,
+          size,
+          [](auto row) { return row % 5; },
+          [](auto row) { return row % 8; }),
+      40);
+
+  // Distinct indices in every row are evaluated row by row.
+  test(
+      makeInput(
+          size,
+          size,
+          [](auto row) { return row; },
+          [](auto row) { return size - 1 - row; }),
+      size);
+}
+
 TEST_F(ExprTest, constant) {
   auto exprSet = compileExpression("1 + 2 + 3 + 4", ROW({}));
   auto constExpr = dynamic_cast<exec::ConstantExpr*>(exprSet->expr(0).get());
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/expression/ExprValueCache.h"
+#include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+class ExprValueCacheTest : public functions::test::FunctionBaseTest {
+ protected:
+  void setCachedFunctions(
+      const std::string& names,
+      int32_t maxEntries = 10'000) {
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kExprCachedFunctions, names},
+        {core::QueryConfig::kExprValueCacheMaxEntries,
+         std::to_string(maxEntries)},
+    });
+  }
+
+  // Evaluates 'expression' over 'batches' with and without caching the
+  // function at the root. Returns the cache.
+  const exec::ExprValueCache* testCache(
+      const std::string& expression,
+      const std::vector<RowVectorPtr>& batches,
+      int32_t maxEntries = 10'000) {
+    auto rowType = asRowType(batches[0]->type());
+    setCachedFunctions("");
+    auto exprSet = compileExpression(expression, rowType);
+    EXPECT_EQ(nullptr, exprSet->expr(0)->valueCache());
+    setCachedFunctions("length,upper, divide", maxEntries);
+    cachedSet_ = compileExpression(expression, rowType);
+    for (const auto& batch : batches) {
+      assertEqualVectors(
+          evaluate(*exprSet, batch), evaluate(*cachedSet_, batch));
+    }
+    return cachedSet_->expr(0)->valueCache();
+  }
+
+  std::unique_ptr<exec::ExprSet> cachedSet_;
+};
+
+TEST_F(ExprValueCacheTest, strings) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 3; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<std::string>(
+        1'000, [&](auto row) {
+          return fmt::format("Mozilla/5.0 user agent number {}", row % 10);
+        })}));
+  }
+  auto* cache = testCache("upper(c0)", batches);
+  ASSERT_TRUE(cache != nullptr);
+  EXPECT_EQ(10, cache->size());
+  // The rows of the first batch are looked up before its results are added.
+  EXPECT_EQ(1'000, cache->numMisses());
+  EXPECT_EQ(2'000, cache->numHits());
+
+  // The cache is emptied when full.
+  cache = testCache("upper(c0)", batches, 4);
+  EXPECT_GE(4, cache->size());
+  EXPECT_EQ(3'000, cache->numMisses() + cache->numHits());
+
+  // Dictionary encoded and null arguments.
+  auto indices = makeIndices(500, [](auto row) { return 999 - row * 2; });
+  auto dictionary = makeRowVector({BaseVector::wrapInDictionary(
+      makeNulls(500, nullEvery(7)), indices, 500, batches[0]->childAt(0))});
+  cache = testCache("length(c0)", {dictionary, batches[1]});
+  EXPECT_EQ(10, cache->size());
+}
+
+TEST_F(ExprValueCacheTest, errors) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row % 5; }),
+      makeFlatVector<int64_t>(100, [](auto row) { return row % 3; }),
+  });
+  auto* cache = testCache("try(c0 / c1)", {data, data});
+  EXPECT_EQ(nullptr, cache);
+
+  auto exprSet = cachedSet_.get();
+  auto* divide = exprSet->expr(0)->inputs()[0].get();
+  cache = divide->valueCache();
+  ASSERT_TRUE(cache != nullptr);
+  // Rows dividing by zero are not cached.
+  EXPECT_EQ(10, cache->size());
+  EXPECT_EQ(100 + 34, cache->numMisses());
+}
+
+TEST_F(ExprValueCacheTest, notCached) {
+  auto rowType = ROW({"c0", "c1"}, {VARCHAR(), ARRAY(BIGINT())});
+  setCachedFunctions("upper,cardinality,rand");
+  for (const auto& expression : {"cardinality(c1)", "rand()", "lower(c0)"}) {
+    auto exprSet = compileExpression(expression, rowType);
+    EXPECT_EQ(nullptr, exprSet->expr(0)->valueCache()) << expression;
+  }
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/expression/FusedExpr.h"
+#include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+class FusedExprTest : public functions::test::FunctionBaseTest {
+ protected:
+  void setFused(bool enabled) {
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kExprFusedEvalEnabled,
+         enabled ? "true" : "false"},
+    });
+  }
+
+  // Returns the FusedExpr for 'expression' or nullptr if it is not fused.
+  std::shared_ptr<exec::FusedExpr> fused(exec::ExprSet& exprSet) {
+    return std::dynamic_pointer_cast<exec::FusedExpr>(exprSet.expr(0));
+  }
+
+  // Checks that 'expression' is fused and gives the same result as the
+  // interpreter on 'data'. Returns the number of batches evaluated by the
+  // fused program.
+  int64_t assertFused(
+      const std::string& expression,
+      const RowVectorPtr& data,
+      const SelectivityVector& rows) {
+    auto rowType = asRowType(data->type());
+    setFused(false);
+    auto exprSet = compileExpression(expression, rowType);
+    EXPECT_EQ(nullptr, fused(*exprSet));
+    auto expected = evaluate(*exprSet, data, rows);
+
+    setFused(true);
+    auto fusedSet = compileExpression(expression, rowType);
+    auto fusedExpr = fused(*fusedSet);
+    EXPECT_TRUE(fusedExpr != nullptr) << expression;
+    if (!fusedExpr) {
+      return 0;
+    }
+    EXPECT_EQ(exprSet->toString(), fusedSet->toString());
+    auto result = evaluate(*fusedSet, data, rows);
+    rows.applyToSelected([&](auto row) {
+      ASSERT_TRUE(expected->equalValueAt(result.get(), row, row))
+          << expression << " at " << row << ": " << expected->toString(row)
+          << " vs " << result->toString(row);
+    });
+    return fusedExpr->numFusedBatches();
+  }
+
+  int64_t assertFused(const std::string& expression, const RowVectorPtr& data) {
+    return assertFused(expression, data, SelectivityVector(data->size()));
+  }
+
+  VectorPtr evaluate(
+      exec::ExprSet& exprSet,
+      const RowVectorPtr& data,
+      const SelectivityVector& rows) {
+    exec::EvalCtx context(&execCtx_, &exprSet, data.get());
+    std::vector<VectorPtr> result(1);
+    exprSet.eval(rows, context, result);
+    return result[0];
+  }
+
+  RowVectorPtr makeData(vector_size_t size) {
+    return makeRowVector({
+        makeFlatVector<int64_t>(size, [](auto row) { return row * 7 - 500; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row % 11; }),
+        makeFlatVector<double>(size, [](auto row) { return row * 0.25; }),
+        makeFlatVector<bool>(size, [](auto row) { return row % 3 == 0; }),
+        makeFlatVector<std::string>(
+            size, [](auto row) { return std::to_string(row); }),
+    });
+  }
+};
+
+TEST_F(FusedExprTest, arithmetic) {
+  auto data = makeData(1'000);
+  EXPECT_EQ(1, assertFused("c0 * 3 + c1 - c0 / (c1 + 1)", data));
+  EXPECT_EQ(1, assertFused("(c2 + c0) * 1.5 - c1 / 2.0", data));
+  EXPECT_EQ(1, assertFused("-c1 + c1 * c1", data));
+  EXPECT_EQ(1, assertFused("c2 / (c1 - c1)", data));
+}
+
+TEST_F(FusedExprTest, comparisonsAndConjuncts) {
+  auto data = makeData(1'000);
+  EXPECT_EQ(1, assertFused("c0 > 100 and c1 < 5", data));
+  EXPECT_EQ(1, assertFused("c3 or (c2 >= 10.0 and not (c1 = 2))", data));
+  EXPECT_EQ(1, assertFused("c0 + c1 <> c1 * 2 or c3", data));
+}
+
+TEST_F(FusedExprTest, selectedRows) {
+  auto data = makeData(1'000);
+  SelectivityVector rows(data->size(), false);
+  rows.setValidRange(300, 700, true);
+  rows.setValid(305, false);
+  rows.updateBounds();
+  EXPECT_EQ(1, assertFused("c0 * 2 + c1", data, rows));
+  EXPECT_EQ(1, assertFused("c2 < 100.0 and c3", data, rows));
+}
+
+TEST_F(FusedExprTest, notFused) {
+  auto rowType = asRowType(makeData(1)->type());
+  setFused(true);
+  for (const auto& expression :
+       {"c0", "c0 + length(c4)", "c4 = '1'", "c3 and c4 = '1'"}) {
+    auto exprSet = compileExpression(expression, rowType);
+    EXPECT_EQ(nullptr, fused(*exprSet)) << expression;
+  }
+  // Both results share the plus.
+  auto exprSet = compileExpressions({"c0 + c1", "(c0 + c1) * 2"}, rowType);
+  EXPECT_EQ(nullptr, std::dynamic_pointer_cast<exec::FusedExpr>(
+                         exprSet->expr(1)));
+}
+
+TEST_F(FusedExprTest, fallback) {
+  auto data = makeData(1'000);
+  setFused(true);
+
+  // Rows with nulls are not evaluated if the tree propagates nulls. Otherwise
+  // a batch with nulls is evaluated by the interpreter.
+  auto withNulls = makeRowVector({
+      makeFlatVector<int64_t>(
+          100, [](auto row) { return row; }, nullEvery(5)),
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+  });
+  auto exprSet =
+      compileExpression("c0 + c1 > 10", asRowType(withNulls->type()));
+  auto result = evaluate(*exprSet, withNulls);
+  assertEqualVectors(
+      makeFlatVector<bool>(
+          100, [](auto row) { return row * 2 > 10; }, nullEvery(5)),
+      result);
+  EXPECT_EQ(1, fused(*exprSet)->numFusedBatches());
+
+  exprSet =
+      compileExpression("c0 > 10 or c1 > 50", asRowType(withNulls->type()));
+  result = evaluate(*exprSet, withNulls);
+  assertEqualVectors(
+      makeFlatVector<bool>(
+          100,
+          [](auto row) { return row > 10; },
+          [](auto row) { return row % 5 == 0 && row <= 50; }),
+      result);
+  EXPECT_EQ(0, fused(*exprSet)->numFusedBatches());
+  EXPECT_EQ(1, fused(*exprSet)->numInterpretedBatches());
+
+  // Dictionary encoded input.
+  auto indices = makeIndices(data->size(), [](auto row) { return row / 2; });
+  auto dictionary = makeRowVector(
+      {wrapInDictionary(indices, data->childAt(0)),
+       wrapInDictionary(indices, data->childAt(1))});
+  exprSet = compileExpression("c0 * 2 - c1", asRowType(dictionary->type()));
+  result = evaluate(*exprSet, dictionary);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          data->size(),
+          [](auto row) { return (row / 2 * 7 - 500) * 2 - row / 2 % 11; }),
+      result);
+
+  // Overflow and division by zero give the errors of the interpreter.
+  auto large = makeRowVector({
+      makeFlatVector<int64_t>(
+          {1, 2, std::numeric_limits<int64_t>::max()}),
+      makeFlatVector<int64_t>({1, 0, 1}),
+  });
+  exprSet = compileExpression("c0 + c1", asRowType(large->type()));
+  VELOX_ASSERT_THROW(evaluate(*exprSet, large), "integer overflow");
+  exprSet = compileExpression("c0 / c1", asRowType(large->type()));
+  VELOX_ASSERT_THROW(evaluate(*exprSet, large), "division by zero");
+  EXPECT_EQ(1, fused(*exprSet)->instructions().size());
+  EXPECT_EQ(1, fused(*exprSet)->numInterpretedBatches());
+}
@@ -20,6 +20,7 @@
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/Expr.h"
 #include "velox/functions/Udf.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
@@ -1045,6 +1046,161 @@ struct StringInputFunction {
   }
 };
 
+int64_t numBatchCalls = 0;
+int64_t numRowCalls = 0;
+
+// Integer division with a batch path. callBatch() fails the whole batch if any
+// divisor is 0, call() fails only the row with the 0 divisor.
+template <typename T>
+struct BatchDivideFunction {
+  void call(int64_t& result, const int64_t& a, const int64_t& b) {
+    ++numRowCalls;
+    VELOX_USER_CHECK_NE(b, 0, "division by zero");
+    result = a / b;
+  }
+
+  void callBatch(
+      int32_t size,
+      int64_t* result,
+      const int64_t* a,
+      const int64_t* b) {
+    ++numBatchCalls;
+    bool divideByZero = false;
+    for (auto i = 0; i < size; ++i) {
+      divideByZero |= b[i] == 0;
+      result[i] = a[i] / (b[i] == 0 ? 1 : b[i]);
+    }
+    VELOX_USER_CHECK(!divideByZero, "division by zero");
+  }
+};
+
+TEST_F(SimpleFunctionTest, callBatch) {
+  registerFunction<BatchDivideFunction, int64_t, int64_t, int64_t>(
+      {"batch_divide"});
+  const vector_size_t size = 1'000;
+  auto dividends = makeFlatVector<int64_t>(size, [](auto row) { return row; });
+  auto divisors =
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 7 + 1; });
+  numBatchCalls = 0;
+  numRowCalls = 0;
+  auto result = evaluate<SimpleVector<int64_t>>(
+      "batch_divide(c0, c1)", makeRowVector({dividends, divisors}));
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row / (row % 7 + 1); }),
+      result);
+  EXPECT_EQ(bits::roundUp(size, 64) / 64, numBatchCalls);
+  EXPECT_EQ(0, numRowCalls);
+
+  // Constant divisor.
+  numBatchCalls = 0;
+  result = evaluate<SimpleVector<int64_t>>(
+      "batch_divide(c0, cast(3 as bigint))", makeRowVector({dividends}));
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto row) { return row / 3; }), result);
+  EXPECT_EQ(bits::roundUp(size, 64) / 64, numBatchCalls);
+  EXPECT_EQ(0, numRowCalls);
+
+  // The rows with null dividends leave runs of 9 rows to evaluate.
+  auto nullableDividends = makeFlatVector<int64_t>(
+      size, [](auto row) { return row; }, nullEvery(10));
+  numBatchCalls = 0;
+  result = evaluate<SimpleVector<int64_t>>(
+      "batch_divide(c0, c1)", makeRowVector({nullableDividends, divisors}));
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row / (row % 7 + 1); },
+          nullEvery(10)),
+      result);
+  EXPECT_LT(bits::roundUp(size, 64) / 64, numBatchCalls);
+  EXPECT_EQ(0, numRowCalls);
+
+  // A 0 divisor at row 100 makes the batch of rows 64 to 127 fall back to
+  // call() for each row, which sets the error for row 100 only.
+  auto zeroDivisors = makeFlatVector<int64_t>(
+      size, [](auto row) { return row == 100 ? 0 : row % 7 + 1; });
+  result = evaluate<SimpleVector<int64_t>>(
+      "try(batch_divide(c0, c1))", makeRowVector({dividends, zeroDivisors}));
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row / (row % 7 + 1); },
+          [](auto row) { return row == 100; }),
+      result);
+  EXPECT_EQ(64, numRowCalls);
+}
+
+// Integer division that returns a failed Status for a 0 divisor.
+template <typename T>
+struct StatusDivideFunction {
+  Status call(int64_t& result, const int64_t& a, const int64_t& b) {
+    if (b == 0) {
+      return Status::userError("division by zero");
+    }
+    result = a / b;
+    return Status::OK();
+  }
+};
+
+// Repeats a string 'n' times. Returns a failed Status for a negative 'n'.
+template <typename T>
+struct StatusRepeatFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  Status call(
+      out_type<Varchar>& result,
+      const arg_type<Varchar>& input,
+      const int64_t& n) {
+    if (n < 0) {
+      return Status::userError(fmt::format("negative count: {}", n));
+    }
+    for (auto i = 0; i < n; ++i) {
+      result.append(input);
+    }
+    return Status::OK();
+  }
+};
+
+TEST_F(SimpleFunctionTest, callReturningStatus) {
+  registerFunction<StatusDivideFunction, int64_t, int64_t, int64_t>(
+      {"status_divide"});
+  registerFunction<StatusRepeatFunction, Varchar, Varchar, int64_t>(
+      {"status_repeat"});
+
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>({10, 20, 30, 40}),
+      makeFlatVector<int64_t>({2, 0, 3, 0}),
+      makeFlatVector<std::string>({"a", "b", "c", "d"}),
+      makeFlatVector<int64_t>({1, -1, 3, 0}),
+  });
+
+  // Without TRY, the first failing row throws.
+  VELOX_ASSERT_THROW(
+      evaluate("status_divide(c0, c1)", data), "division by zero");
+  VELOX_ASSERT_THROW(
+      evaluate("status_repeat(c2, c3)", data), "negative count: -1");
+
+  // Under TRY, the failing rows are null.
+  auto result = evaluate("try(status_divide(c0, c1))", data);
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>({5, std::nullopt, 10, std::nullopt}),
+      result);
+  result = evaluate("try(status_repeat(c2, c3))", data);
+  assertEqualVectors(
+      makeNullableFlatVector<std::string>({"a", std::nullopt, "ccc", ""}),
+      result);
+
+  // The rows without errors are unaffected.
+  result = evaluate(
+      "status_divide(c0, c1)",
+      makeRowVector({
+          makeFlatVector<int64_t>({10, 20}),
+          makeFlatVector<int64_t>({2, 5}),
+      }));
+  assertEqualVectors(makeFlatVector<int64_t>({5, 4}), result);
+}
+
 TEST_F(SimpleFunctionTest, isAsciiArgs) {
   VectorPtr input = vectorMaker_.flatVector<StringView>({"ab"_sv, "cd"_sv});
   SelectivityVector rows(2);
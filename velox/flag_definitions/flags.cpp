@@ -77,6 +77,11 @@ DEFINE_bool(avx2, true, "Enables use of AVX2 when available");
 
 DEFINE_bool(bmi2, true, "Enables use of BMI2 when available");
 
+DEFINE_bool(
+    avx512vbmi,
+    true,
+    "Enables use of AVX-512 VBMI when available");
+
 // Used in exec/Expr.cpp
 
 DEFINE_string(
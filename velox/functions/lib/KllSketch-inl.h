@@ -294,6 +294,12 @@ void KllSketch<T, A, C>::doInsert(T value) {
   if (items_.size() < k_ && numLevels() == 1) {
     // Do not allocate all k elements in the beginning because in some group-by
     // aggregation most of the group size is small and won't use all k spaces.
+    // Grow by half instead of doubling and never beyond k, the first level
+    // then wastes at most a third of its capacity.
+    if (items_.size() == items_.capacity()) {
+      items_.reserve(std::min<size_t>(
+          k_, std::max<size_t>(kMinItemsCapacity, items_.size() * 3 / 2)));
+    }
     items_.push_back(value);
     ++levels_[1];
   } else {
@@ -412,13 +418,23 @@ void KllSketch<T, A, C>::addEmptyTopLevelToCompletelyFullSketch() {
 template <typename T, typename A, typename C>
 void KllSketch<T, A, C>::shiftItems(uint32_t delta) {
   auto oldTotal = items_.size();
-  items_.resize(items_.size() + delta);
+  resizeItems(items_.size() + delta);
   std::move_backward(items_.begin(), items_.begin() + oldTotal, items_.end());
   for (auto& lvl : levels_) {
     lvl += delta;
   }
 }
 
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::resizeItems(size_t size) {
+  // The capacity of the sketch only grows by one level at a time, reserve
+  // exactly to not double the allocation when adding a level.
+  if (size > items_.capacity()) {
+    items_.reserve(size);
+  }
+  items_.resize(size);
+}
+
 template <typename T, typename A, typename C>
 void KllSketch<T, A, C>::compact() {
   finish();
@@ -650,7 +666,7 @@ void KllSketch<T, A, C>::mergeViews(const folly::Range<const View*>& others) {
         randomBit_);
     VELOX_DCHECK_LE(result.finalNumLevels, ub);
     // Now we need to transfer the results back into "this" sketch.
-    items_.resize(result.finalCapacity);
+    resizeItems(result.finalCapacity);
     const auto freeSpaceAtBottom = result.finalCapacity - result.finalNumItems;
     std::move(
         workbuf.data() + outlevels[0],
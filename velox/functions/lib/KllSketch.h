@@ -104,6 +104,13 @@ struct KllSketch {
     return n_;
   }
 
+  /// Bytes allocated from the allocator for the items and levels of the sketch,
+  /// not counting the sketch itself.
+  size_t memoryUsage() const {
+    return items_.capacity() * sizeof(T) +
+        levels_.capacity() * sizeof(uint32_t);
+  }
+
   /// Calculate the size needed for serialization.
   size_t serializedByteSize() const;
 
@@ -170,6 +177,7 @@ struct KllSketch {
   int findLevelToCompact() const;
   void addEmptyTopLevelToCompletelyFullSketch();
   void shiftItems(uint32_t delta);
+  void resizeItems(size_t size);
 
   uint8_t numLevels() const {
     return levels_.size() - 1;
@@ -189,6 +197,9 @@ struct KllSketch {
   using AllocU32 = typename std::allocator_traits<
       Allocator>::template rebind_alloc<uint32_t>;
 
+  // Initial capacity of 'items_'.
+  static constexpr size_t kMinItemsCapacity = 8;
+
   uint32_t k_;
   Allocator allocator_;
 
@@ -16,14 +16,18 @@
 #include "velox/functions/lib/Re2Functions.h"
 
 #include <re2/re2.h>
+#include <re2/set.h>
 #include <optional>
 #include <string>
 
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/ExprRewriter.h"
 #include "velox/functions/lib/ArrayBuilder.h"
+#include "velox/functions/lib/string/StringCore.h"
 #include "velox/type/StringView.h"
 #include "velox/vector/FlatVector.h"
+#include "velox/vector/VariantToVector.h"
 
 namespace facebook::velox::functions {
 namespace {
@@ -424,6 +428,12 @@ class OptimizedLikeWithMemcmp final : public VectorFunction {
         return matchPrefixPattern(input, pattern_, reducedPatternLength_);
       case PatternKind::kSuffix:
         return matchSuffixPattern(input, pattern_, reducedPatternLength_);
+      case PatternKind::kSubstring:
+        return stringCore::findSubstring(
+                   std::string_view(input.data(), input.size()),
+                   std::string_view(
+                       pattern_.data(), reducedPatternLength_)) !=
+            std::string_view::npos;
     }
   }
 
@@ -692,6 +702,158 @@ std::shared_ptr<VectorFunction> makeRe2MatchImpl(
   return kMatchExpr;
 }
 
+// Searches each string for all the patterns at once with a single RE2::Set
+// instead of one RE2 per pattern.
+class Re2MatchAny final : public VectorFunction {
+ public:
+  explicit Re2MatchAny(const std::vector<std::string>& patterns)
+      : set_(RE2::Quiet, RE2::UNANCHORED) {
+    for (const auto& pattern : patterns) {
+      std::string error;
+      VELOX_USER_CHECK_GE(
+          set_.Add(pattern, &error),
+          0,
+          "Invalid regular expression {}: {}.",
+          pattern,
+          error);
+    }
+    VELOX_CHECK(set_.Compile(), "Failed to compile regular expression set");
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      EvalCtx& context,
+      VectorPtr& resultRef) const final {
+    VELOX_CHECK_EQ(args.size(), 2);
+    FlatVector<bool>& result = ensureWritableBool(rows, context, resultRef);
+    exec::LocalDecodedVector toSearch(context, *args[0], rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      result.set(
+          row,
+          set_.Match(
+              toStringPiece(toSearch->valueAt<StringView>(row)), nullptr));
+    });
+  }
+
+ private:
+  re2::RE2::Set set_;
+};
+
+// Returns the value of a non-null VARCHAR constant.
+std::optional<std::string> varcharConstant(const core::TypedExprPtr& expr) {
+  auto constant = dynamic_cast<const core::ConstantTypedExpr*>(expr.get());
+  if (!constant || !expr->type()->isVarchar()) {
+    return std::nullopt;
+  }
+  if (constant->hasValueVector()) {
+    auto vector = constant->valueVector()->as<SimpleVector<StringView>>();
+    if (vector->isNullAt(0)) {
+      return std::nullopt;
+    }
+    return std::string(vector->valueAt(0));
+  }
+  if (constant->value().isNull()) {
+    return std::nullopt;
+  }
+  return constant->value().value<std::string>();
+}
+
+// Returns the strings of a constant ARRAY(VARCHAR) vector or std::nullopt if
+// 'vector' is not constant or the array or one of its elements is null.
+std::optional<std::vector<std::string>> constantPatterns(
+    const BaseVector* vector) {
+  auto constant = dynamic_cast<const ConstantVector<ComplexType>*>(vector);
+  if (!constant || constant->isNullAt(0)) {
+    return std::nullopt;
+  }
+  auto arrayVector = constant->valueVector()->as<ArrayVector>();
+  auto elements = arrayVector->elements()->as<SimpleVector<StringView>>();
+  auto offset = arrayVector->offsetAt(constant->index());
+  auto size = arrayVector->sizeAt(constant->index());
+  std::vector<std::string> patterns;
+  patterns.reserve(size);
+  for (auto i = offset; i < offset + size; ++i) {
+    if (elements->isNullAt(i)) {
+      return std::nullopt;
+    }
+    patterns.emplace_back(elements->valueAt(i));
+  }
+  return patterns;
+}
+
+// A regular expression searched for in 'input'.
+struct PatternLeaf {
+  core::TypedExprPtr input;
+  std::vector<std::string> patterns;
+};
+
+// Returns the patterns of 'expr' if it is a LIKE without escape character, a
+// regexp_like or a match-any call with a constant pattern on a column.
+std::optional<PatternLeaf> toPatternLeaf(
+    const core::TypedExprPtr& expr,
+    const std::string& likeName,
+    const std::string& searchName,
+    const std::string& matchAnyName) {
+  auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (!call || call->inputs().size() != 2 ||
+      !dynamic_cast<const core::FieldAccessTypedExpr*>(
+          call->inputs()[0].get())) {
+    return std::nullopt;
+  }
+  PatternLeaf leaf{call->inputs()[0], {}};
+  if (call->name() == matchAnyName) {
+    auto constant =
+        dynamic_cast<const core::ConstantTypedExpr*>(call->inputs()[1].get());
+    if (!constant || !constant->hasValueVector()) {
+      return std::nullopt;
+    }
+    auto patterns = constantPatterns(constant->valueVector().get());
+    if (!patterns.has_value()) {
+      return std::nullopt;
+    }
+    leaf.patterns = std::move(patterns.value());
+    return leaf;
+  }
+  auto pattern = varcharConstant(call->inputs()[1]);
+  if (!pattern.has_value()) {
+    return std::nullopt;
+  }
+  if (call->name() == likeName) {
+    bool validPattern;
+    auto regex = likePatternToRe2(
+        StringView(pattern.value()), std::nullopt, validPattern);
+    if (!validPattern) {
+      return std::nullopt;
+    }
+    // LIKE matches the whole string, including new lines.
+    pattern = "(?s:" + regex + ")";
+  } else if (call->name() != searchName) {
+    return std::nullopt;
+  }
+  if (!RE2(pattern.value(), RE2::Quiet).ok()) {
+    // The error is raised when the function is evaluated.
+    return std::nullopt;
+  }
+  leaf.patterns.push_back(std::move(pattern.value()));
+  return leaf;
+}
+
+// Adds the inputs of 'expr' to 'inputs', looking through nested ORs.
+void flattenOr(
+    const core::TypedExprPtr& expr,
+    std::vector<core::TypedExprPtr>& inputs) {
+  auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (call && call->name() == "or") {
+    for (const auto& input : call->inputs()) {
+      flattenOr(input, inputs);
+    }
+    return;
+  }
+  inputs.push_back(expr);
+}
+
 } // namespace
 
 std::shared_ptr<VectorFunction> makeRe2Match(
@@ -724,6 +886,114 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> re2SearchSignatures() {
               .build()};
 }
 
+std::shared_ptr<exec::VectorFunction> makeRe2MatchAny(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+  if (inputArgs.size() != 2 || !inputArgs[0].type->isVarchar() ||
+      !inputArgs[1].type->equivalent(*ARRAY(VARCHAR()))) {
+    VELOX_UNSUPPORTED(
+        "{} expected (VARCHAR, ARRAY(VARCHAR)) but got ({})",
+        name,
+        printTypesCsv(inputArgs));
+  }
+  auto patterns = constantPatterns(inputArgs[1].constantValue.get());
+  VELOX_USER_CHECK(
+      patterns.has_value(),
+      "{} requires a constant list of non-null patterns",
+      name);
+  VELOX_USER_CHECK(
+      !patterns->empty(), "{} requires at least one pattern", name);
+  return std::make_shared<Re2MatchAny>(patterns.value());
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>> re2MatchAnySignatures() {
+  // varchar, array(varchar) -> boolean
+  return {exec::FunctionSignatureBuilder()
+              .returnType("boolean")
+              .argumentType("varchar")
+              .argumentType("array(varchar)")
+              .build()};
+}
+
+exec::ExprRewriter::Rule makeMatchAnyRewrite(
+    const std::string& likeName,
+    const std::string& searchName,
+    const std::string& matchAnyName,
+    memory::MemoryPool* pool) {
+  return [likeName, searchName, matchAnyName, pool](
+             const core::TypedExprPtr& expr) -> core::TypedExprPtr {
+    auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+    if (!call || call->name() != "or") {
+      return nullptr;
+    }
+    std::vector<core::TypedExprPtr> inputs;
+    flattenOr(expr, inputs);
+
+    // Groups the pattern leaves by their input. 'inputGroups' has the group
+    // of each input or -1 if the input is not a pattern leaf.
+    std::vector<PatternLeaf> groups;
+    std::vector<int32_t> groupSizes;
+    std::vector<int32_t> inputGroups;
+    for (const auto& input : inputs) {
+      auto leaf = toPatternLeaf(input, likeName, searchName, matchAnyName);
+      if (!leaf.has_value()) {
+        inputGroups.push_back(-1);
+        continue;
+      }
+      auto it = std::find_if(groups.begin(), groups.end(), [&](auto& group) {
+        return *group.input == *leaf->input;
+      });
+      inputGroups.push_back(it - groups.begin());
+      if (it == groups.end()) {
+        groups.push_back(std::move(leaf.value()));
+        groupSizes.push_back(1);
+        continue;
+      }
+      it->patterns.insert(
+          it->patterns.end(), leaf->patterns.begin(), leaf->patterns.end());
+      ++groupSizes[inputGroups.back()];
+    }
+    if (std::none_of(groupSizes.begin(), groupSizes.end(), [](auto size) {
+          return size > 1;
+        })) {
+      return nullptr;
+    }
+
+    // Each group of several leaves is replaced by one match-any call at the
+    // position of its first leaf.
+    std::vector<core::TypedExprPtr> newInputs;
+    std::vector<bool> merged(groups.size(), false);
+    for (auto i = 0; i < inputs.size(); ++i) {
+      const auto group = inputGroups[i];
+      if (group == -1 || groupSizes[group] == 1) {
+        newInputs.push_back(inputs[i]);
+        continue;
+      }
+      if (merged[group]) {
+        continue;
+      }
+      merged[group] = true;
+      std::vector<variant> patterns;
+      for (const auto& pattern : groups[group].patterns) {
+        patterns.emplace_back(pattern);
+      }
+      auto patternsVector = std::make_shared<ConstantVector<ComplexType>>(
+          pool, 1, 0, core::variantArrayToVector(patterns, pool));
+      newInputs.push_back(std::make_shared<core::CallTypedExpr>(
+          BOOLEAN(),
+          std::vector<core::TypedExprPtr>{
+              groups[group].input,
+              std::make_shared<core::ConstantTypedExpr>(patternsVector)},
+          matchAnyName));
+    }
+    if (newInputs.size() == 1) {
+      return newInputs[0];
+    }
+    return std::make_shared<core::CallTypedExpr>(
+        call->type(), std::move(newInputs), "or");
+  };
+}
+
 std::shared_ptr<VectorFunction> makeRe2Extract(
     const std::string& name,
     const std::vector<VectorFunctionArg>& inputArgs,
@@ -814,6 +1084,9 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   vector_size_t i = 0;
   // Index of the first % or _ character.
   vector_size_t wildcardStart = -1;
+  // Index of the first % or _ character after the fixed pattern if the
+  // pattern starts with wildcard characters.
+  vector_size_t secondWildcardStart = -1;
   // Index of the first character that is not % and not _.
   vector_size_t fixedPatternStart = -1;
   // Total number of % characters.
@@ -825,13 +1098,17 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   while (i < patternLength) {
     if (patternStr[i] == '%' || patternStr[i] == '_') {
       // Ensures that pattern has a single contiguous stream of wildcard
-      // characters.
+      // characters, or one on each side of the fixed pattern.
       if (wildcardStart != -1) {
-        return std::make_pair(PatternKind::kGeneric, 0);
+        if (secondWildcardStart != -1 || fixedPatternStart < wildcardStart) {
+          return std::make_pair(PatternKind::kGeneric, 0);
+        }
+        secondWildcardStart = i;
+      } else {
+        wildcardStart = i;
       }
       // Look till the last contiguous wildcard character, starting from this
       // index, is found, or the end of pattern is reached.
-      wildcardStart = i;
       while (i < patternLength &&
              (patternStr[i] == '%' || patternStr[i] == '_')) {
         singleCharacterWildcardCount += (patternStr[i] == '_');
@@ -868,6 +1145,9 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   if (singleCharacterWildcardCount) {
     return {PatternKind::kGeneric, 0};
   }
+  if (secondWildcardStart != -1) {
+    return {PatternKind::kSubstring, secondWildcardStart - fixedPatternStart};
+  }
   // Classify pattern as prefix pattern or suffix pattern based on the
   // positions of the fixed pattern and contiguous wildcard character stream.
   if (fixedPatternStart < wildcardStart) {
@@ -950,6 +1230,15 @@ std::shared_ptr<exec::VectorFunction> makeLike(
       case PatternKind::kSuffix:
         return std::make_shared<OptimizedLikeWithMemcmp<PatternKind::kSuffix>>(
             pattern, reducedLength);
+      case PatternKind::kSubstring: {
+        // The fixed pattern starts after the leading '%' characters.
+        auto start = std::string_view(pattern.data(), pattern.size())
+                         .find_first_not_of('%');
+        return std::make_shared<
+            OptimizedLikeWithMemcmp<PatternKind::kSubstring>>(
+            StringView(pattern.data() + start, pattern.size() - start),
+            reducedLength);
+      }
       default:
         return std::make_shared<LikeWithRe2>(pattern, escapeChar);
     }
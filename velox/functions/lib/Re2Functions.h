@@ -20,6 +20,7 @@
 
 #include <re2/re2.h>
 
+#include "velox/expression/ExprRewriter.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/Udf.h"
 #include "velox/vector/BaseVector.h"
@@ -39,6 +40,9 @@ enum class PatternKind {
   kPrefix,
   /// Fixed pattern preceded by one or more '%', such as '%foo', '%%%hello'.
   kSuffix,
+  /// Fixed pattern preceded and followed by one or more '%', such as '%foo%',
+  /// '%%hello%'.
+  kSubstring,
   /// Patterns which do not fit any of the above types, such as 'hello_world',
   /// '_presto%'.
   kGeneric,
@@ -71,6 +75,29 @@ std::shared_ptr<exec::VectorFunction> makeRe2Search(
 
 std::vector<std::shared_ptr<exec::FunctionSignature>> re2SearchSignatures();
 
+/// re2MatchAny(string, patterns) → bool
+///
+/// Returns whether str has a substr that matches any of the regex patterns.
+/// patterns must be a constant array. All the patterns are searched for in a
+/// single pass over the string using RE2::Set. If a pattern is invalid,
+/// throws an exception.
+std::shared_ptr<exec::VectorFunction> makeRe2MatchAny(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs);
+
+std::vector<std::shared_ptr<exec::FunctionSignature>> re2MatchAnySignatures();
+
+/// Returns an ExprRewriter rule that replaces the LIKE ('likeName') and
+/// re2Search ('searchName') calls with a constant pattern over the same column
+/// inside an OR by a single re2MatchAny ('matchAnyName') call. LIKE calls with
+/// an escape character are left as is. The pattern lists of the new calls are
+/// allocated from 'pool', which must outlive the rewritten expressions.
+exec::ExprRewriter::Rule makeMatchAnyRewrite(
+    const std::string& likeName,
+    const std::string& searchName,
+    const std::string& matchAnyName,
+    memory::MemoryPool* pool);
+
 /// re2Extract(string, pattern, group_id) → string
 /// re2Extract(string, pattern) → string
 ///
@@ -96,9 +123,9 @@ std::shared_ptr<exec::VectorFunction> makeRe2Extract(
 std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures();
 
 /// Return the pair {pattern kind, length of the fixed pattern} for fixed,
-/// prefix, and suffix patterns. Return the pair {pattern kind, number of '_'
-/// characters} for patterns with wildcard characters only. Return
-/// {kGenericPattern, 0} for generic patterns).
+/// prefix, suffix and substring patterns. Return the pair {pattern kind,
+/// number of '_' characters} for patterns with wildcard characters only.
+/// Return {kGenericPattern, 0} for generic patterns).
 std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern);
 
 std::shared_ptr<exec::VectorFunction> makeLike(
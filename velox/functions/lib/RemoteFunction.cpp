@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/lib/RemoteFunction.h"
+
+#include <deque>
+
+#include "velox/expression/EvalCtx.h"
+#include "velox/serializers/PrestoSerializer.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+// Returns the rows in positions ['begin', 'end') of 'rowNumbers' as ranges of
+// consecutive rows.
+std::vector<IndexRange> toRanges(
+    const std::vector<vector_size_t>& rowNumbers,
+    vector_size_t begin,
+    vector_size_t end) {
+  std::vector<IndexRange> ranges;
+  for (auto i = begin; i < end; ++i) {
+    if (!ranges.empty() &&
+        ranges.back().begin + ranges.back().size == rowNumbers[i]) {
+      ++ranges.back().size;
+    } else {
+      ranges.push_back({rowNumbers[i], 1});
+    }
+  }
+  return ranges;
+}
+
+class RemoteVectorFunction : public exec::VectorFunction {
+ public:
+  RemoteVectorFunction(
+      const std::string& name,
+      const std::vector<exec::VectorFunctionArg>& inputArgs,
+      const RemoteFunctionOptions& options)
+      : name_(name), options_(options) {
+    VELOX_CHECK_NOT_NULL(
+        options_.client, "Remote function {} has no client", name_);
+    VELOX_CHECK_GT(options_.rowsPerRequest, 0);
+    VELOX_CHECK_GT(options_.maxRequestsInFlight, 0);
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < inputArgs.size(); ++i) {
+      names.push_back(fmt::format("c{}", i));
+      types.push_back(inputArgs[i].type);
+    }
+    inputType_ = ROW(std::move(names), std::move(types));
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    auto input = std::make_shared<RowVector>(
+        context.pool(), inputType_, nullptr, rows.end(), args);
+    std::vector<vector_size_t> rowNumbers;
+    rowNumbers.reserve(rows.countSelected());
+    rows.applyToSelected([&](auto row) { rowNumbers.push_back(row); });
+
+    context.ensureWritable(rows, outputType, result);
+    const auto resultType = ROW({"c0"}, {outputType});
+
+    struct Request {
+      // Positions in 'rowNumbers' of the rows of the request.
+      vector_size_t begin;
+      vector_size_t end;
+      folly::SemiFuture<std::unique_ptr<folly::IOBuf>> response;
+    };
+    std::deque<Request> inFlight;
+    std::vector<vector_size_t> toSourceRow(rows.end());
+    SelectivityVector requestRows(rows.end(), false);
+
+    // Waits for the response to 'request' and copies the results to
+    // 'result'. A failed request is the error of all its rows.
+    auto receive = [&](Request& request) {
+      requestRows.clearAll();
+      for (auto i = request.begin; i < request.end; ++i) {
+        requestRows.setValid(rowNumbers[i], true);
+        toSourceRow[rowNumbers[i]] = i - request.begin;
+      }
+      requestRows.updateBounds();
+      try {
+        auto page = std::move(request.response).get();
+        auto results = deserializeRemotePage(*page, resultType, context.pool());
+        VELOX_CHECK_EQ(
+            results->size(),
+            request.end - request.begin,
+            "Remote function {} returned a wrong number of rows",
+            name_);
+        result->copy(
+            results->childAt(0).get(), requestRows, toSourceRow.data());
+      } catch (const std::exception&) {
+        context.setErrors(requestRows, std::current_exception());
+      }
+    };
+
+    const vector_size_t numRows = rowNumbers.size();
+    for (vector_size_t begin = 0; begin < numRows;
+         begin += options_.rowsPerRequest) {
+      if (inFlight.size() >= options_.maxRequestsInFlight) {
+        receive(inFlight.front());
+        inFlight.pop_front();
+      }
+      const auto end =
+          std::min<vector_size_t>(begin + options_.rowsPerRequest, numRows);
+      inFlight.push_back(
+          {begin,
+           end,
+           options_.client->invoke(
+               name_,
+               serializeRemotePage(input, toRanges(rowNumbers, begin, end)))});
+    }
+    while (!inFlight.empty()) {
+      receive(inFlight.front());
+      inFlight.pop_front();
+    }
+  }
+
+  bool isDeterministic() const override {
+    return options_.deterministic;
+  }
+
+  bool isDefaultNullBehavior() const override {
+    return options_.defaultNullBehavior;
+  }
+
+ private:
+  const std::string name_;
+  const RemoteFunctionOptions options_;
+  RowTypePtr inputType_;
+};
+} // namespace
+
+void registerRemoteFunction(
+    const std::string& name,
+    std::vector<exec::FunctionSignaturePtr> signatures,
+    RemoteFunctionOptions options) {
+  exec::registerStatefulVectorFunction(
+      name,
+      std::move(signatures),
+      [options = std::move(options)](
+          const std::string& name,
+          const std::vector<exec::VectorFunctionArg>& inputArgs) {
+        return std::make_shared<RemoteVectorFunction>(
+            name, inputArgs, options);
+      });
+}
+
+std::unique_ptr<folly::IOBuf> serializeRemotePage(
+    const RowVectorPtr& data,
+    const std::vector<IndexRange>& rows) {
+  std::vector<IndexRange> allRows;
+  if (rows.empty()) {
+    allRows.push_back({0, data->size()});
+  }
+  const auto& ranges = rows.empty() ? allRows : rows;
+  int32_t numRows = 0;
+  for (const auto& range : ranges) {
+    numRows += range.size;
+  }
+
+  auto& mappedMemory = *memory::MappedMemory::getInstance();
+  StreamArena arena(&mappedMemory);
+  serializer::presto::PrestoVectorSerde serde;
+  auto serializer =
+      serde.createSerializer(asRowType(data->type()), numRows, &arena, nullptr);
+  serializer->append(data, folly::Range(ranges.data(), ranges.size()));
+  IOBufOutputStream out(mappedMemory);
+  serializer->flush(&out);
+  return out.getIOBuf();
+}
+
+RowVectorPtr deserializeRemotePage(
+    const folly::IOBuf& page,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) {
+  std::vector<ByteRange> ranges;
+  for (const auto& range : page) {
+    ranges.push_back(
+        {const_cast<uint8_t*>(range.data()),
+         static_cast<int32_t>(range.size()),
+         0});
+  }
+  VELOX_CHECK(!ranges.empty(), "Empty remote function page");
+  ByteStream input;
+  input.resetInput(std::move(ranges));
+  RowVectorPtr result;
+  serializer::presto::PrestoVectorSerde().deserialize(
+      &input, pool, type, &result, nullptr);
+  return result;
+}
+
+} // namespace facebook::velox::functions
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/futures/Future.h>
+#include <folly/io/IOBuf.h>
+
+#include "velox/expression/VectorFunction.h"
+
+namespace facebook::velox::functions {
+
+/// Sends the batches of a remote function to the service executing it. The
+/// same client can be used by all drivers and must be thread safe.
+class RemoteFunctionClient {
+ public:
+  virtual ~RemoteFunctionClient() = default;
+
+  /// Starts the evaluation of 'functionName' on a batch of rows. 'input' is a
+  /// page in the Presto wire format, see serializeRemotePage, whose columns
+  /// are the arguments. The result is a page of the same number of rows with
+  /// the results as its only column. The request should not block the
+  /// calling thread until the result is needed.
+  virtual folly::SemiFuture<std::unique_ptr<folly::IOBuf>> invoke(
+      const std::string& functionName,
+      std::unique_ptr<folly::IOBuf> input) = 0;
+};
+
+struct RemoteFunctionOptions {
+  std::shared_ptr<RemoteFunctionClient> client;
+
+  /// The rows of a batch are sent in requests of at most this many rows.
+  vector_size_t rowsPerRequest{1'024};
+
+  /// Maximum number of requests a batch has in flight. The requests of a
+  /// batch are sent before waiting for the first result, so that their round
+  /// trips overlap.
+  int32_t maxRequestsInFlight{8};
+
+  bool deterministic{true};
+
+  /// If true, rows with a null argument are null without being sent.
+  bool defaultNullBehavior{true};
+};
+
+/// Registers 'name' as a function that is evaluated by 'options.client'.
+/// Each call sends the selected rows of a batch and waits for the results
+/// before returning.
+void registerRemoteFunction(
+    const std::string& name,
+    std::vector<exec::FunctionSignaturePtr> signatures,
+    RemoteFunctionOptions options);
+
+/// Returns 'rows' of 'data' in the Presto wire format. Empty 'rows' means all
+/// rows. Used for the requests and by the services for the results.
+std::unique_ptr<folly::IOBuf> serializeRemotePage(
+    const RowVectorPtr& data,
+    const std::vector<IndexRange>& rows = {});
+
+/// Reads a page of 'type' written by serializeRemotePage.
+RowVectorPtr deserializeRemotePage(
+    const folly::IOBuf& page,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool);
+
+} // namespace facebook::velox::functions
@@ -19,21 +19,23 @@
 
 namespace facebook::velox::functions {
 
-/// Returns SelectivityVector for the nested vector with all rows corresponding
-/// to specified top-level rows selected. The optional topLevelRowMapping is
+/// Sets 'elementRows' to the rows of the nested vector corresponding to the
+/// specified top-level rows. Reuses the memory of 'elementRows', so that a
+/// pooled SelectivityVector can be passed. The optional topLevelRowMapping is
 /// used to pass the dictionary indices if the topLevelVector is dictionary
 /// encoded.
 template <typename T>
-SelectivityVector toElementRows(
+void toElementRows(
     vector_size_t size,
     const SelectivityVector& topLevelRows,
     const T* topLevelVector,
+    SelectivityVector& elementRows,
     const vector_size_t* topLevelRowMapping = nullptr) {
   auto rawNulls = topLevelVector->rawNulls();
   auto rawSizes = topLevelVector->rawSizes();
   auto rawOffsets = topLevelVector->rawOffsets();
 
-  SelectivityVector elementRows(size, false);
+  elementRows.resizeFill(size, false);
   topLevelRows.applyToSelected([&](vector_size_t row) {
     auto index = topLevelRowMapping ? topLevelRowMapping[row] : row;
     if (rawNulls && bits::isBitNull(rawNulls, index)) {
@@ -44,6 +46,21 @@ SelectivityVector toElementRows(
     elementRows.setValidRange(offset, offset + size, true);
   });
   elementRows.updateBounds();
+}
+
+/// Returns SelectivityVector for the nested vector with all rows corresponding
+/// to specified top-level rows selected. The optional topLevelRowMapping is
+/// used to pass the dictionary indices if the topLevelVector is dictionary
+/// encoded.
+template <typename T>
+SelectivityVector toElementRows(
+    vector_size_t size,
+    const SelectivityVector& topLevelRows,
+    const T* topLevelVector,
+    const vector_size_t* topLevelRowMapping = nullptr) {
+  SelectivityVector elementRows;
+  toElementRows(
+      size, topLevelRows, topLevelVector, elementRows, topLevelRowMapping);
   return elementRows;
 }
 
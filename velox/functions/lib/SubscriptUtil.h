@@ -16,12 +16,71 @@
 
 #pragma once
 
+#include <algorithm>
+#include <numeric>
+
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Type.h"
 #include "velox/vector/NullsBuilder.h"
 
 namespace facebook::velox::functions {
 
+/// Index over the keys of the maps of a MapVector: the positions of the keys
+/// of each map sorted by key. Kept as a memo of the EvalCtx, so that all
+/// subscripts into the same map vector in a batch share it. The index is built
+/// by the second subscript into a vector and used for binary search from then
+/// on. A single subscript scans the keys, which is cheaper than sorting them.
+template <typename TKey>
+class MapKeyIndex : public exec::EvalCtx::VectorMemo {
+ public:
+  explicit MapKeyIndex(VectorPtr map) : map_(std::move(map)) {}
+
+  bool hasIndex() const {
+    return !sortedPositions_.empty();
+  }
+
+  /// Returns the positions of the keys of the map at 'mapIndex' sorted by
+  /// key. Valid only if hasIndex() is true.
+  const vector_size_t* sortedPositions(vector_size_t mapIndex) const {
+    return sortedPositions_.data() + starts_[mapIndex];
+  }
+
+  /// Sorts the positions of the keys of each map by key and, for equal keys,
+  /// by position. 'keys' are the decoded keys of the map.
+  void build(const DecodedVector& keys) {
+    const auto* map = map_->asUnchecked<MapVector>();
+    const auto* rawOffsets = map->rawOffsets();
+    const auto* rawSizes = map->rawSizes();
+    starts_.resize(map->size());
+    vector_size_t numPositions = 0;
+    for (auto i = 0; i < map->size(); ++i) {
+      starts_[i] = numPositions;
+      numPositions += rawSizes[i];
+    }
+    sortedPositions_.resize(numPositions);
+    for (auto i = 0; i < map->size(); ++i) {
+      auto* begin = sortedPositions_.data() + starts_[i];
+      auto* end = begin + rawSizes[i];
+      std::iota(begin, end, rawOffsets[i]);
+      std::sort(begin, end, [&](vector_size_t left, vector_size_t right) {
+        const auto leftKey = keys.valueAt<TKey>(left);
+        const auto rightKey = keys.valueAt<TKey>(right);
+        return leftKey < rightKey || (leftKey == rightKey && left < right);
+      });
+    }
+  }
+
+  /// Number of subscripts into the map vector so far.
+  int32_t numLookups{0};
+
+ private:
+  const VectorPtr map_;
+
+  // Start of the positions of each map in 'sortedPositions_'.
+  std::vector<vector_size_t> starts_;
+  std::vector<vector_size_t> sortedPositions_;
+};
+
 /// Generic subscript/element_at implementation for both array and map data
 /// types.
 ///
@@ -326,6 +385,35 @@ class SubscriptImpl : public exec::VectorFunction {
     auto rawSizes = baseMap->rawSizes();
     auto rawOffsets = baseMap->rawOffsets();
 
+    // Large maps are searched by binary search over the sorted keys, either
+    // those of a map vector with sorted keys or those of a MapKeyIndex.
+    const bool largeMaps =
+        mapKeys->size() >= kMinAverageMapSizeForIndex * baseMap->size();
+    const bool sortedKeys = largeMaps && baseMap->hasSortedKeys();
+    const MapKeyIndex<TKey>* keyIndex =
+        largeMaps && !sortedKeys
+        ? findOrBuildKeyIndex<TKey>(mapArg, baseMap, *decodedMapKeys, context)
+        : nullptr;
+
+    // Returns the position of the first key >= 'searchKey' among the
+    // 'positions' of the keys of a map, where the keys at 'positions' are
+    // sorted.
+    auto lowerBound = [&](auto positions,
+                          vector_size_t size,
+                          TKey searchKey) -> vector_size_t {
+      vector_size_t low = 0;
+      vector_size_t high = size;
+      while (low < high) {
+        const auto mid = low + (high - low) / 2;
+        if (decodedMapKeys->valueAt<TKey>(positions(mid)) < searchKey) {
+          low = mid + 1;
+        } else {
+          high = mid;
+        }
+      }
+      return low;
+    };
+
     // Lambda that does the search for a key, for each row.
     auto processRow = [&](vector_size_t row, TKey searchKey) {
       size_t mapIndex = mapIndices[row];
@@ -333,16 +421,27 @@ class SubscriptImpl : public exec::VectorFunction {
       size_t offsetEnd = offsetStart + rawSizes[mapIndex];
       bool found = false;
 
-      // Sequentially check each key on this map for a match. We use a
-      // sequential scan over the keys because it's easier to express (and
-      // likely has good memory locality), but if we find that this is slow
-      // for large maps we could try to canonicalize the whole vector and binary
-      // search `searchKey`.
-      for (size_t offset = offsetStart; offset < offsetEnd; ++offset) {
-        if (decodedMapKeys->valueAt<TKey>(offset) == searchKey) {
-          rawIndices[row] = offset;
+      if (sortedKeys || keyIndex) {
+        const auto size = rawSizes[mapIndex];
+        const auto* sortedPositions =
+            keyIndex ? keyIndex->sortedPositions(mapIndex) : nullptr;
+        auto positions = [&](vector_size_t i) -> vector_size_t {
+          return sortedPositions ? sortedPositions[i] : offsetStart + i;
+        };
+        const auto i = lowerBound(positions, size, searchKey);
+        if (i < size &&
+            decodedMapKeys->valueAt<TKey>(positions(i)) == searchKey) {
+          rawIndices[row] = positions(i);
           found = true;
-          break;
+        }
+      } else {
+        // Sequentially check each key on this map for a match.
+        for (size_t offset = offsetStart; offset < offsetEnd; ++offset) {
+          if (decodedMapKeys->valueAt<TKey>(offset) == searchKey) {
+            rawIndices[row] = offset;
+            found = true;
+            break;
+          }
         }
       }
 
@@ -371,6 +470,40 @@ class SubscriptImpl : public exec::VectorFunction {
     return BaseVector::wrapInDictionary(
         nullsBuilder.build(), indices, rows.size(), baseMap->mapValues());
   }
+
+  // Minimum average number of keys per map for which the keys are searched by
+  // binary search.
+  static constexpr int32_t kMinAverageMapSizeForIndex = 16;
+
+  // Returns the MapKeyIndex of 'baseMap', the base of 'mapArg', if this is
+  // the second or later subscript into 'baseMap' evaluated with 'context'.
+  // Builds the index on the second subscript. Returns nullptr otherwise.
+  template <typename TKey>
+  static const MapKeyIndex<TKey>* findOrBuildKeyIndex(
+      const VectorPtr& mapArg,
+      const MapVector* baseMap,
+      const DecodedVector& decodedMapKeys,
+      exec::EvalCtx& context) {
+    auto* keyIndex = context.findVectorMemo<MapKeyIndex<TKey>>(baseMap);
+    if (!keyIndex) {
+      // Finds the shared pointer to 'baseMap' for the memo to hold.
+      VectorPtr map = mapArg;
+      while (map && map.get() != baseMap) {
+        map = map->encoding() == VectorEncoding::Simple::LAZY
+            ? map->asUnchecked<LazyVector>()->loadedVectorShared()
+            : map->valueVector();
+      }
+      if (!map) {
+        return nullptr;
+      }
+      keyIndex = &context.addVectorMemo(
+          baseMap, std::make_shared<MapKeyIndex<TKey>>(std::move(map)));
+    }
+    if (++keyIndex->numLookups == 2) {
+      keyIndex->build(decodedMapKeys);
+    }
+    return keyIndex->hasIndex() ? keyIndex : nullptr;
+  }
 };
 
 } // namespace facebook::velox::functions
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::functions::tdigest {
+
+constexpr double kDefaultCompression = 100;
+
+/// Merging t-digest for estimating quantiles of double values. The values are
+/// summarized by at most about 'compression' centroids, each a mean and a
+/// weight. Centroids near the ends of the distribution hold fewer values than
+/// centroids near the median, so that the relative error of tail quantiles is
+/// small. Inserted values are buffered and merged into the centroids in
+/// batches of 5 * 'compression'. Two digests merge by merging their centroids,
+/// which makes this an alternative to KllSketch for partial aggregation where
+/// the merged results are larger than the inputs.
+///
+/// The buffer and the centroids are allocated from 'Allocator' and grow with
+/// the number of values, so a digest of a few values takes a few bytes.
+///
+/// See https://arxiv.org/abs/1902.04023 for more details.
+template <typename Allocator = std::allocator<double>>
+class TDigest {
+ public:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  using AllocCentroid = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Centroid>;
+
+  explicit TDigest(
+      double compression = kDefaultCompression,
+      const Allocator& allocator = Allocator())
+      : compression_(compression),
+        centroids_(AllocCentroid(allocator)),
+        buffer_(AllocCentroid(allocator)) {
+    VELOX_CHECK_GE(compression_, 10);
+  }
+
+  /// Cannot be called after insert().
+  void setCompression(double compression) {
+    VELOX_CHECK_EQ(totalWeight_, 0);
+    VELOX_CHECK_GE(compression, 10);
+    compression_ = compression;
+  }
+
+  /// Adds 'value' with 'weight'.
+  void insert(double value, double weight = 1) {
+    VELOX_DCHECK(!std::isnan(value));
+    VELOX_DCHECK_GT(weight, 0);
+    updateMinMax(value, value);
+    addToBuffer({value, weight});
+  }
+
+  /// Merges the values of 'other' into 'this'.
+  void merge(const TDigest& other) {
+    if (other.totalWeight_ == 0) {
+      return;
+    }
+    updateMinMax(other.min_, other.max_);
+    for (auto& centroid : other.centroids_) {
+      addToBuffer(centroid);
+    }
+    for (auto& centroid : other.buffer_) {
+      addToBuffer(centroid);
+    }
+  }
+
+  /// Merges the buffered values into the centroids. Must be called before
+  /// estimateQuantile() and serialize().
+  void compress();
+
+  /// Estimates the value of 'quantile', which must be in [0, 1].
+  double estimateQuantile(double quantile) const;
+
+  /// The total weight of the values added to the digest.
+  double totalWeight() const {
+    return totalWeight_;
+  }
+
+  /// The merged centroids, sorted by mean.
+  const std::vector<Centroid, AllocCentroid>& centroids() const {
+    return centroids_;
+  }
+
+  /// Bytes allocated from the allocator for the centroids and the buffer, not
+  /// counting the digest itself.
+  size_t memoryUsage() const {
+    return (centroids_.capacity() + buffer_.capacity()) * sizeof(Centroid);
+  }
+
+  /// Calculates the size needed for serialization.
+  size_t serializedByteSize() const {
+    return 4 * sizeof(double) + sizeof(int32_t) +
+        centroids_.size() * sizeof(Centroid);
+  }
+
+  /// Serializes the digest into bytes. compress() must be called first.
+  /// @param out Pre-allocated memory at least serializedByteSize() in size
+  void serialize(char* out) const;
+
+  /// Merges a digest serialized by serialize() into 'this'. This is more
+  /// efficient than deserialize then merge.
+  void mergeDeserialized(const char* data);
+
+  /// Deserializes a digest from bytes.
+  static TDigest deserialize(
+      const char* data,
+      const Allocator& allocator = Allocator()) {
+    TDigest digest(readCompression(data), allocator);
+    digest.mergeDeserialized(data);
+    digest.compress();
+    return digest;
+  }
+
+ private:
+  // Number of buffered values per unit of compression before compress() is
+  // called.
+  static constexpr int32_t kBufferFactor = 5;
+
+  static double readCompression(const char* data) {
+    double compression;
+    memcpy(&compression, data, sizeof(double));
+    return compression;
+  }
+
+  void updateMinMax(double min, double max) {
+    if (totalWeight_ == 0) {
+      min_ = min;
+      max_ = max;
+    } else {
+      min_ = std::min(min_, min);
+      max_ = std::max(max_, max);
+    }
+  }
+
+  void addToBuffer(const Centroid& centroid) {
+    buffer_.push_back(centroid);
+    totalWeight_ += centroid.weight;
+    if (buffer_.size() >= kBufferFactor * compression_) {
+      compress();
+    }
+  }
+
+  // The k1 scale function maps a quantile to the index of its centroid. Each
+  // centroid spans at most one unit of k.
+  double kFromQ(double q) const {
+    return compression_ / (2 * M_PI) * std::asin(2 * q - 1);
+  }
+
+  double qFromK(double k) const {
+    if (k >= compression_ / 4) {
+      return 1;
+    }
+    return (std::sin(k * 2 * M_PI / compression_) + 1) / 2;
+  }
+
+  double compression_;
+  double totalWeight_{0};
+  double min_{0};
+  double max_{0};
+
+  // Sorted by mean.
+  std::vector<Centroid, AllocCentroid> centroids_;
+
+  // Centroids that are not merged into 'centroids_' yet. Inserted values are
+  // centroids of their own.
+  std::vector<Centroid, AllocCentroid> buffer_;
+};
+
+template <typename A>
+void TDigest<A>::compress() {
+  if (buffer_.empty()) {
+    return;
+  }
+  auto byMean = [](const Centroid& left, const Centroid& right) {
+    return left.mean < right.mean;
+  };
+  std::sort(buffer_.begin(), buffer_.end(), byMean);
+  std::vector<Centroid, AllocCentroid> merged(centroids_.get_allocator());
+  merged.reserve(centroids_.size() + buffer_.size());
+  std::merge(
+      centroids_.begin(),
+      centroids_.end(),
+      buffer_.begin(),
+      buffer_.end(),
+      std::back_inserter(merged),
+      byMean);
+  buffer_.clear();
+
+  // Merges neighbors in place while the merged centroid spans less than one
+  // unit of k.
+  double weightSoFar = 0;
+  double weightLimit = totalWeight_ * qFromK(kFromQ(0) + 1);
+  size_t numMerged = 0;
+  for (size_t i = 1; i < merged.size(); ++i) {
+    auto& current = merged[numMerged];
+    const auto& next = merged[i];
+    if (weightSoFar + current.weight + next.weight <= weightLimit) {
+      current.weight += next.weight;
+      current.mean += (next.mean - current.mean) * next.weight / current.weight;
+    } else {
+      weightSoFar += current.weight;
+      weightLimit =
+          totalWeight_ * qFromK(kFromQ(weightSoFar / totalWeight_) + 1);
+      merged[++numMerged] = next;
+    }
+  }
+  merged.resize(numMerged + 1);
+  centroids_.swap(merged);
+}
+
+template <typename A>
+double TDigest<A>::estimateQuantile(double quantile) const {
+  VELOX_USER_CHECK(
+      buffer_.empty(), "compress() must be called before estimating quantiles");
+  VELOX_CHECK_GT(totalWeight_, 0);
+  VELOX_CHECK(0 <= quantile && quantile <= 1);
+  if (centroids_.size() == 1) {
+    return centroids_[0].mean;
+  }
+  // The values of a centroid are assumed to be spread evenly around its mean,
+  // the estimate interpolates between the means of neighboring centroids and
+  // between the first and last means and the min and max.
+  const double index = quantile * totalWeight_;
+  double weightSoFar = centroids_[0].weight / 2;
+  if (index < weightSoFar) {
+    return min_ + index / weightSoFar * (centroids_[0].mean - min_);
+  }
+  for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+    const double delta = (centroids_[i].weight + centroids_[i + 1].weight) / 2;
+    if (weightSoFar + delta > index) {
+      const double t = (index - weightSoFar) / delta;
+      return centroids_[i].mean +
+          t * (centroids_[i + 1].mean - centroids_[i].mean);
+    }
+    weightSoFar += delta;
+  }
+  const auto& last = centroids_.back();
+  const double t = std::min(1.0, (index - weightSoFar) / (last.weight / 2));
+  return last.mean + t * (max_ - last.mean);
+}
+
+template <typename A>
+void TDigest<A>::serialize(char* out) const {
+  VELOX_CHECK(buffer_.empty(), "compress() must be called before serialize()");
+  const double header[] = {compression_, totalWeight_, min_, max_};
+  memcpy(out, header, sizeof(header));
+  out += sizeof(header);
+  const int32_t numCentroids = centroids_.size();
+  memcpy(out, &numCentroids, sizeof(int32_t));
+  out += sizeof(int32_t);
+  memcpy(out, centroids_.data(), numCentroids * sizeof(Centroid));
+}
+
+template <typename A>
+void TDigest<A>::mergeDeserialized(const char* data) {
+  double header[4];
+  memcpy(header, data, sizeof(header));
+  data += sizeof(header);
+  int32_t numCentroids;
+  memcpy(&numCentroids, data, sizeof(int32_t));
+  data += sizeof(int32_t);
+  if (header[1] == 0) {
+    return;
+  }
+  updateMinMax(header[2], header[3]);
+  for (int32_t i = 0; i < numCentroids; ++i) {
+    Centroid centroid;
+    memcpy(&centroid, data + i * sizeof(Centroid), sizeof(Centroid));
+    addToBuffer(centroid);
+  }
+}
+
+} // namespace facebook::velox::functions::tdigest
@@ -23,7 +23,9 @@
 #include <folly/portability/GFlags.h>
 #include <folly/stats/TDigest.h>
 
+#include "velox/common/memory/HashStringAllocator.h"
 #include "velox/functions/lib/KllSketch.h"
+#include "velox/functions/lib/TDigest.h"
 
 namespace facebook::velox::functions::kll::test {
 namespace {
@@ -121,6 +123,71 @@ void mergeKllSketch(int iters, int maxSize, int count) {
   }
 }
 
+// Number of groups for the per group memory benchmarks.
+constexpr int kNumGroups = 10'000;
+
+// Inserts 'groupSize' values into each of kNumGroups sketches allocated from a
+// HashStringAllocator, like in a group by, and reports the bytes per group.
+template <typename Sketch, typename MakeSketch>
+void groupMemory(
+    unsigned iters,
+    folly::UserCounters& counters,
+    int groupSize,
+    MakeSketch makeSketch) {
+  std::vector<double> values;
+  BENCHMARK_SUSPEND {
+    populateValues(kNumGroups * groupSize, values);
+  }
+  for (unsigned iter = 0; iter < iters; ++iter) {
+    HashStringAllocator allocator(memory::MappedMemory::getInstance());
+    std::vector<Sketch> sketches;
+    sketches.reserve(kNumGroups);
+    for (int i = 0; i < kNumGroups; ++i) {
+      sketches.push_back(makeSketch(allocator));
+    }
+    for (int i = 0; i < values.size(); ++i) {
+      sketches[i % kNumGroups].insert(values[i]);
+    }
+    counters["bytesPerGroup"] = sizeof(Sketch) +
+        (allocator.retainedSize() - allocator.freeSpace()) / kNumGroups;
+  }
+}
+
+void groupMemoryKllSketch(
+    unsigned iters,
+    folly::UserCounters& counters,
+    int groupSize) {
+  using Sketch = KllSketch<double, StlAllocator<double>>;
+  groupMemory<Sketch>(iters, counters, groupSize, [](auto& allocator) {
+    return Sketch(kDefaultK, StlAllocator<double>(&allocator));
+  });
+}
+
+void groupMemoryTDigest(
+    unsigned iters,
+    folly::UserCounters& counters,
+    int groupSize) {
+  using Digest = tdigest::TDigest<StlAllocator<double>>;
+  groupMemory<Digest>(iters, counters, groupSize, [](auto& allocator) {
+    return Digest(
+        tdigest::kDefaultCompression, StlAllocator<double>(&allocator));
+  });
+}
+
+#define DEFINE_GROUP_MEMORY(name, groupSize)                  \
+  BENCHMARK_COUNTERS(name##_##groupSize, counters, iters) { \
+    name(iters, counters, groupSize);                       \
+  }
+
+DEFINE_GROUP_MEMORY(groupMemoryKllSketch, 10);
+DEFINE_GROUP_MEMORY(groupMemoryTDigest, 10);
+DEFINE_GROUP_MEMORY(groupMemoryKllSketch, 100);
+DEFINE_GROUP_MEMORY(groupMemoryTDigest, 100);
+DEFINE_GROUP_MEMORY(groupMemoryKllSketch, 1000);
+DEFINE_GROUP_MEMORY(groupMemoryTDigest, 1000);
+
+#undef DEFINE_GROUP_MEMORY
+
 #define DEFINE_WITH_TYPE(name, type)  \
   int name##_##type(int, int iters) { \
     return name<type>(iters);         \
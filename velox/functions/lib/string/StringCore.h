@@ -20,6 +20,7 @@
 #include <string_view>
 #include "folly/CPortability.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/external/utf8proc/utf8procImpl.h"
 
 #if (ENABLE_VECTORIZATION > 0) && !defined(_DEBUG) && !defined(DEBUG)
@@ -48,7 +49,24 @@ namespace stringCore {
 static bool isAscii(const char* str, size_t length);
 
 FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
-  for (auto i = 0; i < length; i++) {
+  // Tests a SIMD register of bytes, then 8 bytes, at a time for a set high bit.
+  constexpr auto kBatchSize = xsimd::batch<int8_t>::size;
+  size_t i = 0;
+  for (; i + kBatchSize <= length; i += kBatchSize) {
+    auto bytes = xsimd::batch<int8_t>::load_unaligned(
+        reinterpret_cast<const int8_t*>(str + i));
+    if (simd::toBitMask(bytes < xsimd::batch<int8_t>(0))) {
+      return false;
+    }
+  }
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, str + i, sizeof(word));
+    if (word & 0x8080808080808080ULL) {
+      return false;
+    }
+  }
+  for (; i < length; i++) {
     if (str[i] & 0x80) {
       return false;
     }
@@ -86,27 +104,22 @@ reverseUnicode(char* output, const char* input, size_t length) {
   }
 }
 
-/// Perform upper for ascii string input
+/// Perform upper for ascii string input. Branch free, so that the loop is
+/// vectorized.
 FOLLY_ALWAYS_INLINE static void
 upperAscii(char* output, const char* input, size_t length) {
   VECTORIZE_LOOP_IF_POSSIBLE for (auto i = 0; i < length; i++) {
-    if (input[i] >= 'a' && input[i] <= 'z') {
-      output[i] = input[i] - 32;
-    } else {
-      output[i] = input[i];
-    }
+    const uint8_t c = input[i];
+    output[i] = c - (static_cast<uint8_t>(c - 'a') < 26 ? 32 : 0);
   }
 }
 
-/// Perform lower for ascii string input
+/// Perform lower for ascii string input. See upperAscii.
 FOLLY_ALWAYS_INLINE static void
 lowerAscii(char* output, const char* input, size_t length) {
   VECTORIZE_LOOP_IF_POSSIBLE for (auto i = 0; i < length; i++) {
-    if (input[i] >= 'A' && input[i] <= 'Z') {
-      output[i] = input[i] + 32;
-    } else {
-      output[i] = input[i];
-    }
+    const uint8_t c = input[i];
+    output[i] = c + (static_cast<uint8_t>(c - 'A') < 26 ? 32 : 0);
   }
 }
 
@@ -225,6 +238,43 @@ lengthUnicode(const char* inputBuffer, size_t bufferLength) {
   return size;
 }
 
+/// Returns the byte index of the first instance of 'subString' in 'string' at
+/// or after 'startPosition', or std::string_view::npos. Compares the first and
+/// the last byte of 'subString' with a SIMD register of positions at a time
+/// and compares the other bytes only at the positions where both match.
+FOLLY_ALWAYS_INLINE size_t findSubstring(
+    std::string_view string,
+    std::string_view subString,
+    size_t startPosition = 0) {
+  using Batch = xsimd::batch<uint8_t>;
+  constexpr auto kBatchSize = Batch::size;
+  using MaskType = std::conditional_t<(kBatchSize > 32), uint64_t, uint32_t>;
+  const auto size = subString.size();
+  if (size < 2 || string.size() < startPosition + size) {
+    return string.find(subString, startPosition);
+  }
+  const auto* data = reinterpret_cast<const uint8_t*>(string.data());
+  const Batch first(static_cast<uint8_t>(subString[0]));
+  const Batch last(static_cast<uint8_t>(subString[size - 1]));
+  auto i = startPosition;
+  for (; i + size - 1 + kBatchSize <= string.size(); i += kBatchSize) {
+    MaskType candidates = simd::toBitMask(
+        (Batch::load_unaligned(data + i) == first) &
+        (Batch::load_unaligned(data + i + size - 1) == last));
+    while (candidates) {
+      const auto offset = __builtin_ctzll(candidates);
+      if (std::memcmp(
+              string.data() + i + offset + 1,
+              subString.data() + 1,
+              size - 2) == 0) {
+        return i + offset;
+      }
+      candidates &= candidates - 1;
+    }
+  }
+  return string.find(subString, i);
+}
+
 /// Returns the start byte index of the Nth instance of subString in
 /// string. Search starts from startPosition. Positions start with 0. If not
 /// found, -1 is returned.
@@ -243,7 +293,7 @@ static int64_t findNthInstanceByteIndexFromStart(
     return -1;
   }
 
-  auto byteIndex = string.find(subString, startPosition);
+  auto byteIndex = findSubstring(string, subString, startPosition);
   // Not found
   if (byteIndex == std::string_view::npos) {
     return -1;
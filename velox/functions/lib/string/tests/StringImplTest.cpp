@@ -91,6 +91,40 @@ TEST_F(StringImplTest, lowerAscii) {
   }
 }
 
+TEST_F(StringImplTest, allAsciiCharacters) {
+  std::string ascii;
+  for (auto c = 0; c < 128; ++c) {
+    ascii.push_back(c);
+  }
+  // Repeat to cover the vectorized loops and their tails.
+  ascii += ascii + ascii.substr(0, 37);
+  std::string expectedUpper;
+  std::string expectedLower;
+  for (auto c : ascii) {
+    expectedUpper.push_back(std::toupper(c));
+    expectedLower.push_back(std::tolower(c));
+  }
+
+  std::string output(ascii.size(), '\0');
+  upperAscii(output.data(), ascii.data(), ascii.size());
+  EXPECT_EQ(expectedUpper, output);
+  lowerAscii(output.data(), ascii.data(), ascii.size());
+  EXPECT_EQ(expectedLower, output);
+}
+
+TEST_F(StringImplTest, isAscii) {
+  for (auto length = 0; length < 100; ++length) {
+    std::string string(length, 'a');
+    ASSERT_TRUE(isAscii(string.data(), string.size())) << length;
+    for (auto i = 0; i < length; ++i) {
+      string[i] = '\x80';
+      ASSERT_FALSE(isAscii(string.data(), string.size())) << length << " " << i;
+      string[i] = '\x7f';
+    }
+  }
+  EXPECT_FALSE(isAscii("abcdefghijklmnopqrstuvwxyzéabcdefghij", 38));
+}
+
 TEST_F(StringImplTest, upperUnicode) {
   for (auto& testCase : getUpperUnicodeTestData()) {
     auto input = StringView(std::get<0>(testCase));
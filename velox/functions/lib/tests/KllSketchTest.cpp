@@ -328,6 +328,25 @@ TEST(KllSketchTest, memoryUsage) {
     kll.insert(i);
   }
   EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 28000);
+  EXPECT_LE(kll.memoryUsage(), alloc.retainedSize() - alloc.freeSpace());
+}
+
+// Small sketches, e.g. in a group by with many groups, grow their items by
+// half at a time.
+TEST(KllSketchTest, memoryUsageSmall) {
+  for (int n : {1, 10, 100, 1000}) {
+    SCOPED_TRACE(n);
+    HashStringAllocator alloc(memory::MappedMemory::getInstance());
+    KllSketch<int64_t, StlAllocator<int64_t>> kll(
+        kDefaultK, StlAllocator<int64_t>(&alloc));
+    for (int i = 0; i < n; ++i) {
+      kll.insert(i);
+    }
+    EXPECT_LE(
+        kll.memoryUsage(),
+        std::min<size_t>(n * 3 / 2 + 8, 3 * kDefaultK) * sizeof(int64_t) +
+            64);
+  }
 }
 
 } // namespace
@@ -22,6 +22,7 @@
 #include <string>
 
 #include "velox/common/base/VeloxException.h"
+#include "velox/expression/ExprRewriter.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 #include "velox/parse/TypeResolver.h"
 #include "velox/type/StringView.h"
@@ -53,6 +54,8 @@ class Re2FunctionsTest : public test::FunctionBaseTest {
     exec::registerStatefulVectorFunction(
         "re2_extract_all", re2ExtractAllSignatures(), makeRe2ExtractAll);
     exec::registerStatefulVectorFunction("like", likeSignatures(), makeLike);
+    exec::registerStatefulVectorFunction(
+        "re2_match_any", re2MatchAnySignatures(), makeRe2MatchAny);
   }
 
  protected:
@@ -438,6 +441,12 @@ TEST_F(Re2FunctionsTest, likeDeterminePatternKind) {
   testPattern("%%_%aBcD", PatternKind::kGeneric, 0);
   testPattern("%%a%%BcD", PatternKind::kGeneric, 0);
   testPattern("foo%bar", PatternKind::kGeneric, 0);
+
+  testPattern("%presto%", PatternKind::kSubstring, 6);
+  testPattern("%%hello%%", PatternKind::kSubstring, 5);
+  testPattern("%a%", PatternKind::kSubstring, 1);
+  testPattern("%a_%", PatternKind::kGeneric, 0);
+  testPattern("%a%b%", PatternKind::kGeneric, 0);
 }
 
 TEST_F(Re2FunctionsTest, likePatternWildcard) {
@@ -591,6 +600,97 @@ TEST_F(Re2FunctionsTest, likePatternSuffix) {
   EXPECT_TRUE(like(input, generateString(kAnyWildcardCharacter) + input));
 }
 
+TEST_F(Re2FunctionsTest, likePatternSubstring) {
+  auto like = [&](std::string str, std::string pattern) {
+    auto likeResult = evaluateOnce<bool>(
+        fmt::format("like(c0, '{}')", pattern), std::make_optional(str));
+    VELOX_CHECK(likeResult, "Like operator evaluation failed");
+    return *likeResult;
+  };
+
+  EXPECT_TRUE(like("abcde", "%bcd%"));
+  EXPECT_TRUE(like("abcde", "%%abcde%%"));
+  EXPECT_TRUE(like("abcde", "%e%"));
+  EXPECT_TRUE(like("aaab", "%aab%"));
+  EXPECT_TRUE(like("\nab\ncd\n", "%b\nc%"));
+  EXPECT_FALSE(like("", "%a%"));
+  EXPECT_FALSE(like("abcde", "%bce%"));
+  EXPECT_FALSE(like("abcde", "%abcdef%"));
+  EXPECT_FALSE(like("ABCDE", "%bcd%"));
+
+  // Longer strings are searched in batches of bytes. The match may be in the
+  // middle or the tail of the string.
+  std::string input = generateString(kLikePatternCharacterSet, 200);
+  EXPECT_TRUE(like(input, "%" + input.substr(70, 20) + "%"));
+  EXPECT_TRUE(like(input, "%" + input.substr(190) + "%"));
+  EXPECT_FALSE(like(input, "%" + input.substr(70, 20) + "!%"));
+}
+
+TEST_F(Re2FunctionsTest, regexMatchAny) {
+  auto data = makeRowVector({makeNullableFlatVector<std::string>(
+      {"apple pie", "banana split", "cherry", "", std::nullopt, "pineapple"})});
+  auto matchAny = [&](const std::vector<std::string>& patterns) {
+    std::vector<StringView> views;
+    for (const auto& pattern : patterns) {
+      views.emplace_back(pattern);
+    }
+    auto patternsVector =
+        BaseVector::wrapInConstant(1, 0, makeArrayVector<StringView>({views}));
+    auto typedExpr = std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<core::TypedExprPtr>{
+            std::make_shared<core::FieldAccessTypedExpr>(VARCHAR(), "c0"),
+            std::make_shared<core::ConstantTypedExpr>(patternsVector)},
+        "re2_match_any");
+    return evaluate<SimpleVector<bool>>(typedExpr, data);
+  };
+
+  assertEqualVectors(
+      makeNullableFlatVector<bool>(
+          {true, true, false, false, std::nullopt, true}),
+      matchAny({"^apple", "split$", "nea"}));
+  assertEqualVectors(
+      makeNullableFlatVector<bool>(
+          {false, false, true, false, std::nullopt, false}),
+      matchAny({"^c.*y$"}));
+  EXPECT_THROW(matchAny({"a", "*"}), VeloxUserError);
+  EXPECT_THROW(matchAny({}), VeloxUserError);
+}
+
+TEST_F(Re2FunctionsTest, matchAnyRewrite) {
+  exec::ExprRewriter rewriter;
+  rewriter.addRule(
+      "or_of_patterns",
+      makeMatchAnyRewrite("like", "re2_search", "re2_match_any", pool()));
+  auto data = makeRowVector({
+      makeNullableFlatVector<std::string>(
+          {"abc", "xyz", "a\nb", "foo", std::nullopt, "zzyy"}),
+      makeFlatVector<bool>({false, false, false, true, false, false}),
+  });
+  auto rowType = asRowType(data->type());
+
+  auto expr = makeTypedExpr(
+      "like(c0, '%b%') or re2_search(c0, 'y+$') or c1 or like(c0, 'x%')",
+      rowType);
+  auto rewritten = rewriter.rewrite(expr);
+  EXPECT_EQ(2, rewriter.ruleHits()["or_of_patterns"]);
+  auto call = std::dynamic_pointer_cast<const core::CallTypedExpr>(rewritten);
+  ASSERT_NE(call, nullptr);
+  ASSERT_EQ("or", call->name());
+  ASSERT_EQ(2, call->inputs().size());
+  auto matchAny =
+      std::dynamic_pointer_cast<const core::CallTypedExpr>(call->inputs()[0]);
+  ASSERT_NE(matchAny, nullptr);
+  EXPECT_EQ("re2_match_any", matchAny->name());
+  assertEqualVectors(evaluate(expr, data), evaluate(rewritten, data));
+
+  // LIKE with an escape character is not merged, which leaves a single
+  // pattern on c0.
+  expr = makeTypedExpr(
+      "like(c0, '%b%', '#') or re2_search(c0, 'y+$') or c1", rowType);
+  EXPECT_EQ(expr, rewriter.rewrite(expr));
+}
+
 TEST_F(Re2FunctionsTest, likePatternAndEscape) {
   auto like = ([&](std::optional<std::string> str,
                    std::optional<std::string> pattern,
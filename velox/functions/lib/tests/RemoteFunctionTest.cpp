@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/lib/RemoteFunction.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+namespace {
+// Adds two BIGINT arguments on its own threads, like a service would.
+class AddClient : public functions::RemoteFunctionClient {
+ public:
+  folly::SemiFuture<std::unique_ptr<folly::IOBuf>> invoke(
+      const std::string& /*functionName*/,
+      std::unique_ptr<folly::IOBuf> input) override {
+    ++numRequests_;
+    return folly::via(
+               &executor_,
+               [this, input = std::move(input)]() {
+                 const auto inFlight = ++numInFlight_;
+                 auto max = maxInFlight_.load();
+                 while (inFlight > max &&
+                        !maxInFlight_.compare_exchange_weak(max, inFlight)) {
+                 }
+                 auto result = add(*input);
+                 --numInFlight_;
+                 return result;
+               })
+        .semi();
+  }
+
+  int32_t numRequests() const {
+    return numRequests_;
+  }
+
+  int32_t maxInFlight() const {
+    return maxInFlight_;
+  }
+
+  void setFail(bool fail) {
+    fail_ = fail;
+  }
+
+ private:
+  std::unique_ptr<folly::IOBuf> add(const folly::IOBuf& input) {
+    if (fail_) {
+      VELOX_USER_FAIL("Scoring service unavailable");
+    }
+    auto args = functions::deserializeRemotePage(
+        input, ROW({"c0", "c1"}, {BIGINT(), BIGINT()}), pool_.get());
+    auto left = args->childAt(0)->asFlatVector<int64_t>();
+    auto right = args->childAt(1)->asFlatVector<int64_t>();
+    auto sums = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), args->size(), pool_.get());
+    for (auto i = 0; i < args->size(); ++i) {
+      if (left->isNullAt(i) || right->isNullAt(i)) {
+        sums->setNull(i, true);
+      } else {
+        sums->set(i, left->valueAt(i) + right->valueAt(i));
+      }
+    }
+    return functions::serializeRemotePage(std::make_shared<RowVector>(
+        pool_.get(),
+        ROW({"c0"}, {BIGINT()}),
+        nullptr,
+        args->size(),
+        std::vector<VectorPtr>{sums}));
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  folly::CPUThreadPoolExecutor executor_{4};
+  std::atomic<int32_t> numRequests_{0};
+  std::atomic<int32_t> numInFlight_{0};
+  std::atomic<int32_t> maxInFlight_{0};
+  std::atomic<bool> fail_{false};
+};
+} // namespace
+
+class RemoteFunctionTest : public functions::test::FunctionBaseTest {
+ protected:
+  void SetUp() override {
+    client_ = std::make_shared<AddClient>();
+    functions::RemoteFunctionOptions options;
+    options.client = client_;
+    options.rowsPerRequest = 10;
+    options.maxRequestsInFlight = 3;
+    functions::registerRemoteFunction(
+        "remote_add",
+        {exec::FunctionSignatureBuilder()
+             .returnType("bigint")
+             .argumentType("bigint")
+             .argumentType("bigint")
+             .build()},
+        options);
+  }
+
+  std::shared_ptr<AddClient> client_;
+};
+
+TEST_F(RemoteFunctionTest, batches) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(100, [](auto row) { return row * 1'000; }),
+  });
+  auto result = evaluate("remote_add(c0, c1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(100, [](auto row) { return row * 1'001; }),
+      result);
+  EXPECT_EQ(10, client_->numRequests());
+  EXPECT_LE(client_->maxInFlight(), 3);
+}
+
+TEST_F(RemoteFunctionTest, nulls) {
+  // The null rows are not sent, so that the requests have rows that are not
+  // consecutive.
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }, nullEvery(5)),
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+  });
+  auto result = evaluate("remote_add(c0, c1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          100, [](auto row) { return row * 2; }, nullEvery(5)),
+      result);
+  EXPECT_EQ(8, client_->numRequests());
+
+  // A filter sends only the passing rows.
+  result = evaluate(
+      "if(c1 % 3 = 0, remote_add(c0, c1), cast(0 as bigint))", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          100,
+          [](auto row) { return row % 3 == 0 ? row * 2 : 0; },
+          [](auto row) { return row % 3 == 0 && row % 5 == 0; }),
+      result);
+}
+
+TEST_F(RemoteFunctionTest, errors) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(30, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(30, [](auto row) { return row; }),
+  });
+  client_->setFail(true);
+  VELOX_ASSERT_THROW(
+      evaluate("remote_add(c0, c1)", data), "Scoring service unavailable");
+
+  auto result = evaluate("try(remote_add(c0, c1))", data);
+  assertEqualVectors(makeAllNullFlatVector<int64_t>(30), result);
+}
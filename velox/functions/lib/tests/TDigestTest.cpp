@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/functions/lib/TDigest.h"
+
+namespace facebook::velox::functions::tdigest::test {
+namespace {
+
+// Error bound on the rank of the estimates for compression 100.
+constexpr double kEpsilon = 0.01;
+
+std::vector<double> shuffledValues(int n) {
+  std::vector<double> values(n);
+  for (int i = 0; i < n; ++i) {
+    values[i] = i;
+  }
+  std::shuffle(values.begin(), values.end(), std::default_random_engine(0));
+  return values;
+}
+
+template <typename A>
+void checkQuantiles(const TDigest<A>& digest, int n) {
+  for (int i = 0; i <= 1000; ++i) {
+    double q = i / 1000.0;
+    EXPECT_NEAR(digest.estimateQuantile(q) / (n - 1), q, kEpsilon) << q;
+  }
+}
+
+TEST(TDigestTest, oneValue) {
+  TDigest<> digest;
+  EXPECT_EQ(digest.totalWeight(), 0);
+  digest.insert(1.0);
+  EXPECT_EQ(digest.totalWeight(), 1);
+  digest.compress();
+  EXPECT_EQ(digest.estimateQuantile(0.0), 1.0);
+  EXPECT_EQ(digest.estimateQuantile(0.5), 1.0);
+  EXPECT_EQ(digest.estimateQuantile(1.0), 1.0);
+}
+
+TEST(TDigestTest, exact) {
+  TDigest<> digest;
+  for (int i = 1; i <= 5; ++i) {
+    digest.insert(i);
+  }
+  digest.compress();
+  EXPECT_EQ(digest.centroids().size(), 5);
+  EXPECT_EQ(digest.estimateQuantile(0.0), 1);
+  EXPECT_EQ(digest.estimateQuantile(0.5), 3);
+  EXPECT_EQ(digest.estimateQuantile(1.0), 5);
+}
+
+TEST(TDigestTest, estimate) {
+  constexpr int N = 1e5;
+  TDigest<> digest;
+  for (auto value : shuffledValues(N)) {
+    digest.insert(value);
+  }
+  EXPECT_EQ(digest.totalWeight(), N);
+  VELOX_ASSERT_THROW(digest.estimateQuantile(0.5), "compress()");
+  digest.compress();
+  EXPECT_LE(digest.centroids().size(), kDefaultCompression);
+  EXPECT_EQ(digest.estimateQuantile(0.0), 0);
+  EXPECT_EQ(digest.estimateQuantile(1.0), N - 1);
+  checkQuantiles(digest, N);
+}
+
+TEST(TDigestTest, weighted) {
+  TDigest<> digest;
+  digest.insert(1, 9);
+  digest.insert(2, 1);
+  digest.compress();
+  EXPECT_EQ(digest.totalWeight(), 10);
+  EXPECT_EQ(digest.estimateQuantile(0.3), 1);
+  EXPECT_EQ(digest.estimateQuantile(1.0), 2);
+}
+
+TEST(TDigestTest, merge) {
+  constexpr int N = 1e5;
+  constexpr int kDigestCount = 10;
+  std::vector<TDigest<>> digests(kDigestCount);
+  auto values = shuffledValues(N);
+  for (int i = 0; i < N; ++i) {
+    digests[i % kDigestCount].insert(values[i]);
+  }
+  TDigest<> merged;
+  merged.merge(TDigest<>());
+  for (auto& digest : digests) {
+    digest.compress();
+    merged.merge(digest);
+  }
+  merged.compress();
+  EXPECT_EQ(merged.totalWeight(), N);
+  EXPECT_LE(merged.centroids().size(), kDefaultCompression);
+  checkQuantiles(merged, N);
+}
+
+TEST(TDigestTest, serialize) {
+  constexpr int N = 1e4;
+  constexpr int kDigestCount = 4;
+  auto values = shuffledValues(N);
+  TDigest<> merged;
+  for (int j = 0; j < kDigestCount; ++j) {
+    TDigest<> digest;
+    for (int i = j; i < N; i += kDigestCount) {
+      digest.insert(values[i]);
+    }
+    digest.compress();
+    std::vector<char> data(digest.serializedByteSize());
+    digest.serialize(data.data());
+    auto copy = TDigest<>::deserialize(data.data());
+    EXPECT_EQ(copy.totalWeight(), digest.totalWeight());
+    for (int i = 0; i <= 100; ++i) {
+      double q = i / 100.0;
+      EXPECT_EQ(copy.estimateQuantile(q), digest.estimateQuantile(q));
+    }
+    merged.mergeDeserialized(data.data());
+  }
+  merged.compress();
+  EXPECT_EQ(merged.totalWeight(), N);
+  checkQuantiles(merged, N);
+}
+
+// A digest of a few values takes a few bytes.
+TEST(TDigestTest, memoryUsage) {
+  HashStringAllocator alloc(memory::MappedMemory::getInstance());
+  TDigest<StlAllocator<double>> digest(
+      kDefaultCompression, StlAllocator<double>(&alloc));
+  EXPECT_EQ(digest.memoryUsage(), 0);
+  for (int i = 0; i < 10; ++i) {
+    digest.insert(i);
+  }
+  digest.compress();
+  EXPECT_LE(digest.memoryUsage(), 32 * sizeof(TDigest<>::Centroid));
+  for (auto value : shuffledValues(1e5)) {
+    digest.insert(value);
+  }
+  digest.compress();
+  EXPECT_LE(
+      digest.memoryUsage(),
+      12 * kDefaultCompression * sizeof(TDigest<>::Centroid));
+  EXPECT_LE(digest.memoryUsage(), alloc.retainedSize() - alloc.freeSpace());
+  checkQuantiles(digest, 1e5);
+}
+
+} // namespace
+} // namespace facebook::velox::functions::tdigest::test
@@ -99,9 +99,20 @@ class ArrayDistinctFunction : public exec::VectorFunction {
     auto* rawSizes = newLengths->asMutable<vector_size_t>();
     auto* rawOffsets = newOffsets->asMutable<vector_size_t>();
 
-    // Process the rows: store unique values in the hash table.
+    // Process the rows: store unique values in the hash table. The set keeps
+    // its memory across rows.
     folly::F14FastSet<T> uniqueSet;
 
+    // Flat elements are read straight from their values. Flat bool values
+    // are bits and go through valueAt.
+    const T* rawValues = nullptr;
+    if constexpr (!std::is_same_v<T, bool>) {
+      if (elements->isIdentityMapping()) {
+        rawValues = elements->data<T>();
+      }
+    }
+    const bool mayHaveNulls = elements->mayHaveNulls();
+
     rows.applyToSelected([&](vector_size_t row) {
       auto size = arrayVector->sizeAt(row);
       auto offset = arrayVector->offsetAt(row);
@@ -109,13 +120,13 @@ class ArrayDistinctFunction : public exec::VectorFunction {
       rawOffsets[row] = indicesCursor;
       bool hasNulls = false;
       for (vector_size_t i = offset; i < offset + size; ++i) {
-        if (elements->isNullAt(i)) {
+        if (mayHaveNulls && elements->isNullAt(i)) {
           if (!hasNulls) {
             hasNulls = true;
             rawNewIndices[indicesCursor++] = i;
           }
         } else {
-          auto value = elements->valueAt<T>(i);
+          auto value = rawValues ? rawValues[i] : elements->valueAt<T>(i);
 
           if (uniqueSet.insert(value).second) {
             rawNewIndices[indicesCursor++] = i;
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <folly/container/F14Set.h>
+
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
 #include "velox/functions/lib/RowsTranslationUtil.h"
@@ -31,7 +33,9 @@ struct SetWithNull {
     hasNull = false;
   }
 
-  std::unordered_set<T> set;
+  // Unlike std::unordered_set, clear() keeps the memory of the set and
+  // inserts do not allocate a node per element.
+  folly::F14FastSet<T> set;
   bool hasNull{false};
   static constexpr vector_size_t kInitialSetSize{128};
 };
@@ -112,19 +112,23 @@ void applyScalarType(
       inputElements.get(), inputElementRows, /*toSourceRow=*/nullptr);
 
   auto flatResults = resultElements->asFlatVector<T>();
+  const bool mayHaveNulls = flatResults->mayHaveNulls();
 
   auto processRow = [&](vector_size_t row) {
     const auto size = inputArray->sizeAt(row);
     const auto offset = inputArray->offsetAt(row);
-    if (size == 0) {
+    if (size <= 1) {
       return;
     }
     vector_size_t numNulls = 0;
     // Move nulls to end of array.
-    for (vector_size_t i = size - 1; i >= 0; --i) {
-      if (flatResults->isNullAt(offset + i)) {
-        swapWithNull<T>(flatResults, offset + size - numNulls - 1, offset + i);
-        ++numNulls;
+    if (mayHaveNulls) {
+      for (vector_size_t i = size - 1; i >= 0; --i) {
+        if (flatResults->isNullAt(offset + i)) {
+          swapWithNull<T>(
+              flatResults, offset + size - numNulls - 1, offset + i);
+          ++numNulls;
+        }
       }
     }
     // Exclude null values while sorting.
@@ -25,6 +25,14 @@ struct BitwiseAndFunction {
     result = a & b;
     return true;
   }
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(int32_t size, int64_t* result, const TInput* a, const TInput* b) {
+    for (auto i = 0; i < size; ++i) {
+      result[i] = a[i] & b[i];
+    }
+  }
 };
 
 template <typename T>
@@ -66,6 +74,14 @@ struct BitwiseOrFunction {
     result = a | b;
     return true;
   }
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(int32_t size, int64_t* result, const TInput* a, const TInput* b) {
+    for (auto i = 0; i < size; ++i) {
+      result[i] = a[i] | b[i];
+    }
+  }
 };
 
 template <typename T>
@@ -75,6 +91,14 @@ struct BitwiseXorFunction {
     result = a ^ b;
     return true;
   }
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(int32_t size, int64_t* result, const TInput* a, const TInput* b) {
+    for (auto i = 0; i < size; ++i) {
+      result[i] = a[i] ^ b[i];
+    }
+  }
 };
 
 template <typename T>
@@ -94,6 +94,49 @@ std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
   return dateTime;
 }
 
+// Caches the offset of a time zone between two of its transitions. Timestamps
+// that fall in the same range, like the rows of a batch for the same day, are
+// then converted to local time with a compare and an add instead of a lookup
+// in the time zone rules.
+class TimeZoneOffsetCache {
+ public:
+  // Returns the local time in 'zone' corresponding to 'seconds' since the
+  // epoch in GMT. Same as Timestamp::toTimezone.
+  FOLLY_ALWAYS_INLINE int64_t
+  toLocalSeconds(const date::time_zone& zone, int64_t seconds) {
+    if (seconds < begin_ || seconds >= end_ || &zone != zone_) {
+      auto info =
+          zone.get_info(date::sys_seconds(std::chrono::seconds(seconds)));
+      zone_ = &zone;
+      begin_ = info.begin.time_since_epoch().count();
+      end_ = info.end.time_since_epoch().count();
+      offset_ = info.offset.count();
+    }
+    return seconds + offset_;
+  }
+
+ private:
+  const date::time_zone* zone_{nullptr};
+  // Range of GMT seconds with 'offset_' in 'zone_'. Empty if nothing is
+  // cached.
+  int64_t begin_{0};
+  int64_t end_{0};
+  int64_t offset_{0};
+};
+
+FOLLY_ALWAYS_INLINE
+std::tm getDateTime(
+    Timestamp timestamp,
+    const date::time_zone* timeZone,
+    TimeZoneOffsetCache& offsets) {
+  int64_t seconds = timeZone == nullptr
+      ? timestamp.getSeconds()
+      : offsets.toLocalSeconds(*timeZone, timestamp.getSeconds());
+  std::tm dateTime;
+  gmtime_r((const time_t*)&seconds, &dateTime);
+  return dateTime;
+}
+
 FOLLY_ALWAYS_INLINE
 std::tm getDateTime(Date date) {
   int64_t seconds = date.days() * kSecondsInDay;
@@ -106,12 +149,19 @@ template <typename T>
 struct InitSessionTimezone {
   VELOX_DEFINE_FUNCTION_TYPES(T);
   const date::time_zone* timeZone_{nullptr};
+  TimeZoneOffsetCache timeZoneOffsets_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
       const arg_type<Timestamp>* /*timestamp*/) {
     timeZone_ = getTimeZoneFromConfig(config);
   }
+
+  // Returns the date and time of 'timestamp' in the session time zone, if
+  // timestamps are adjusted to it, and in GMT otherwise.
+  FOLLY_ALWAYS_INLINE std::tm getLocalDateTime(Timestamp timestamp) {
+    return getDateTime(timestamp, timeZone_, timeZoneOffsets_);
+  }
 };
 
 template <typename T>
@@ -145,7 +195,7 @@ struct YearFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getYear(getDateTime(timestamp, this->timeZone_));
+    result = getYear(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -172,7 +222,7 @@ struct QuarterFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getQuarter(getDateTime(timestamp, this->timeZone_));
+    result = getQuarter(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -199,7 +249,7 @@ struct MonthFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getMonth(getDateTime(timestamp, this->timeZone_));
+    result = getMonth(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -222,7 +272,7 @@ struct DayFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_mday;
+    result = this->getLocalDateTime(timestamp).tm_mday;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -281,7 +331,7 @@ struct DayOfWeekFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDayOfWeek(getDateTime(timestamp, this->timeZone_));
+    result = getDayOfWeek(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -308,7 +358,7 @@ struct DayOfYearFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDayOfYear(getDateTime(timestamp, this->timeZone_));
+    result = getDayOfYear(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -352,7 +402,7 @@ struct YearOfWeekFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = computeYearOfWeek(getDateTime(timestamp, this->timeZone_));
+    result = computeYearOfWeek(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -375,7 +425,7 @@ struct HourFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_hour;
+    result = this->getLocalDateTime(timestamp).tm_hour;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -398,7 +448,7 @@ struct MinuteFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_min;
+    result = this->getLocalDateTime(timestamp).tm_min;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -547,6 +597,7 @@ struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
   const date::time_zone* timeZone_ = nullptr;
+  TimeZoneOffsetCache timeZoneOffsets_;
   std::optional<DateTimeUnit> unit_;
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -622,7 +673,7 @@ struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
       return;
     }
 
-    auto dateTime = getDateTime(timestamp, timeZone_);
+    auto dateTime = getDateTime(timestamp, timeZone_, timeZoneOffsets_);
     adjustDateTime(dateTime, unit);
 
     result = Timestamp(timegm(&dateTime), 0);
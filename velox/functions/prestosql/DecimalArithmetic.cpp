@@ -21,6 +21,17 @@
 namespace facebook::velox::functions {
 namespace {
 
+// Sets 'result' to 'value' * 10^'rescale'. Returns true on overflow. Skips the
+// 128-bit multiplication for the common case of arguments of the same scale.
+inline bool rescale(int128_t value, uint8_t rescale, int128_t& result) {
+  if (rescale == 0) {
+    result = value;
+    return false;
+  }
+  return __builtin_mul_overflow(
+      value, DecimalUtil::kPowersOfTen[rescale], &result);
+}
+
 template <
     typename R /* Result Type */,
     typename A /* Argument1 */,
@@ -38,6 +49,15 @@ class DecimalBaseFunction : public exec::VectorFunction {
       exec::EvalCtx& context,
       VectorPtr& result) const override {
     auto rawResults = prepareResults(rows, resultType, context, result);
+    if constexpr (
+        Operation::kHasShortKernel &&
+        std::is_same_v<R, UnscaledShortDecimal> &&
+        std::is_same_v<A, UnscaledShortDecimal> &&
+        std::is_same_v<B, UnscaledShortDecimal>) {
+      if (applyShortFlat(rows, args, rawResults)) {
+        return;
+      }
+    }
     if (args[0]->isConstantEncoding() && args[1]->isFlatEncoding()) {
       // Fast path for (const, flat).
       auto constant = args[0]->asUnchecked<SimpleVector<A>>()->valueAt(0);
@@ -83,6 +103,36 @@ class DecimalBaseFunction : public exec::VectorFunction {
   }
 
  private:
+  // Computes the results for flat short decimal arguments in a loop over
+  // int64_t values without per-row error handling. Overflows are or'ed
+  // together and checked once. Returns false if the arguments are not flat or
+  // some row overflows. The caller then computes the rows one by one, which
+  // reports the error.
+  bool applyShortFlat(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      UnscaledShortDecimal* rawResults) const {
+    if (!args[0]->isFlatEncoding() || !args[1]->isFlatEncoding()) {
+      return false;
+    }
+    static_assert(sizeof(UnscaledShortDecimal) == sizeof(int64_t));
+    auto rawA = reinterpret_cast<const int64_t*>(
+        args[0]->asUnchecked<FlatVector<A>>()->rawValues());
+    auto rawB = reinterpret_cast<const int64_t*>(
+        args[1]->asUnchecked<FlatVector<B>>()->rawValues());
+    auto rawR = reinterpret_cast<int64_t*>(rawResults);
+    // The results are short decimals, so the rescale factors fit in 64 bits.
+    const int64_t aFactor = DecimalUtil::kPowersOfTen[aRescale_];
+    const int64_t bFactor = DecimalUtil::kPowersOfTen[bRescale_];
+    bool overflow = false;
+    rows.applyToSelected([&](auto row) {
+      overflow |= Operation::applyShort(
+          rawR[row], rawA[row], rawB[row], aFactor, bFactor);
+      overflow |= !UnscaledShortDecimal::valueInRange(rawR[row]);
+    });
+    return !overflow;
+  }
+
   R* prepareResults(
       const SelectivityVector& rows,
       const TypePtr& resultType,
@@ -99,6 +149,23 @@ class DecimalBaseFunction : public exec::VectorFunction {
 
 class Addition {
  public:
+  static constexpr bool kHasShortKernel = true;
+
+  // Sets 'r' to 'a' * 'aFactor' + 'b' * 'bFactor'. Returns true on overflow.
+  inline static bool applyShort(
+      int64_t& r,
+      int64_t a,
+      int64_t b,
+      int64_t aFactor,
+      int64_t bFactor) {
+    int64_t aRescaled;
+    int64_t bRescaled;
+    bool overflow = __builtin_mul_overflow(a, aFactor, &aRescaled);
+    overflow |= __builtin_mul_overflow(b, bFactor, &bRescaled);
+    overflow |= __builtin_add_overflow(aRescaled, bRescaled, &r);
+    return overflow;
+  }
+
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale)
@@ -110,14 +177,8 @@ class Addition {
   {
     int128_t aRescaled;
     int128_t bRescaled;
-    if (__builtin_mul_overflow(
-            a.unscaledValue(),
-            DecimalUtil::kPowersOfTen[aRescale],
-            &aRescaled) ||
-        __builtin_mul_overflow(
-            b.unscaledValue(),
-            DecimalUtil::kPowersOfTen[bRescale],
-            &bRescaled)) {
+    if (rescale(a.unscaledValue(), aRescale, aRescaled) ||
+        rescale(b.unscaledValue(), bRescale, bRescaled)) {
       VELOX_ARITHMETIC_ERROR(
           "Decimal overflow: {} + {}", a.unscaledValue(), b.unscaledValue());
     }
@@ -145,6 +206,22 @@ class Addition {
 
 class Subtraction {
  public:
+  static constexpr bool kHasShortKernel = true;
+
+  inline static bool applyShort(
+      int64_t& r,
+      int64_t a,
+      int64_t b,
+      int64_t aFactor,
+      int64_t bFactor) {
+    int64_t aRescaled;
+    int64_t bRescaled;
+    bool overflow = __builtin_mul_overflow(a, aFactor, &aRescaled);
+    overflow |= __builtin_mul_overflow(b, bFactor, &bRescaled);
+    overflow |= __builtin_sub_overflow(aRescaled, bRescaled, &r);
+    return overflow;
+  }
+
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale)
@@ -156,14 +233,8 @@ class Subtraction {
   {
     int128_t aRescaled;
     int128_t bRescaled;
-    if (__builtin_mul_overflow(
-            a.unscaledValue(),
-            DecimalUtil::kPowersOfTen[aRescale],
-            &aRescaled) ||
-        __builtin_mul_overflow(
-            b.unscaledValue(),
-            DecimalUtil::kPowersOfTen[bRescale],
-            &bRescaled)) {
+    if (rescale(a.unscaledValue(), aRescale, aRescaled) ||
+        rescale(b.unscaledValue(), bRescale, bRescaled)) {
       VELOX_ARITHMETIC_ERROR(
           "Decimal overflow: {} - {}", a.unscaledValue(), b.unscaledValue());
     }
@@ -187,6 +258,18 @@ class Subtraction {
 
 class Multiply {
  public:
+  static constexpr bool kHasShortKernel = true;
+
+  // The rescale factors of a multiplication are always 1.
+  inline static bool applyShort(
+      int64_t& r,
+      int64_t a,
+      int64_t b,
+      int64_t /*aFactor*/,
+      int64_t /*bFactor*/) {
+    return __builtin_mul_overflow(a, b, &r);
+  }
+
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale) {
@@ -211,6 +294,8 @@ class Multiply {
 
 class Divide {
  public:
+  static constexpr bool kHasShortKernel = false;
+
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t /*bRescale*/) {
@@ -13,12 +13,64 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <folly/container/F14Set.h>
+
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Filter.h"
 
 namespace facebook::velox::functions {
 namespace {
 
+// Integer IN lists of up to this many values are tested by comparing a batch
+// of inputs with each value. String IN lists of up to this many values are
+// scanned instead of looked up in a hash set.
+constexpr int32_t kMaxSmallInListSize = 16;
+
+// IN list of strings. Tests values without copying them.
+class StringValues {
+ public:
+  explicit StringValues(std::vector<std::string> values)
+      : values_(std::move(values)) {
+    VELOX_CHECK(!values_.empty());
+    views_.reserve(values_.size());
+    for (const auto& value : values_) {
+      views_.emplace_back(value);
+      minLength_ = std::min<int32_t>(minLength_, value.size());
+      maxLength_ = std::max<int32_t>(maxLength_, value.size());
+    }
+    if (views_.size() > kMaxSmallInListSize) {
+      set_.insert(views_.begin(), views_.end());
+    }
+  }
+
+  StringValues(const StringValues&) = delete;
+  StringValues& operator=(const StringValues&) = delete;
+
+  bool contains(StringView value) const {
+    if (value.size() < minLength_ || value.size() > maxLength_) {
+      return false;
+    }
+    if (set_.empty()) {
+      for (const auto& view : views_) {
+        if (view == value) {
+          return true;
+        }
+      }
+      return false;
+    }
+    return set_.contains(value);
+  }
+
+ private:
+  // Owns the data of the long strings in 'views_'.
+  const std::vector<std::string> values_;
+  std::vector<StringView> views_;
+  folly::F14FastSet<StringView> set_;
+  int32_t minLength_{std::numeric_limits<int32_t>::max()};
+  int32_t maxLength_{0};
+};
+
 template <typename T, typename U = T>
 std::optional<std::pair<std::vector<T>, bool>> toValues(
     const std::vector<exec::VectorFunctionArg>& inputArgs) {
@@ -58,10 +110,12 @@ std::optional<std::pair<std::vector<T>, bool>> toValues(
 
 // Creates a filter for constant values. A null filter means either
 // no values or only null values. The boolean is true if the list is
-// non-empty and consists of nulls only.
+// non-empty and consists of nulls only. Sets 'smallValues' to the values if
+// there are at most kMaxSmallInListSize of them.
 template <typename T>
 std::pair<std::unique_ptr<common::Filter>, bool> createBigintValuesFilter(
-    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    std::vector<int64_t>& smallValues) {
   auto valuesPair = toValues<int64_t, T>(inputArgs);
   if (!valuesPair.has_value()) {
     return {nullptr, false};
@@ -76,6 +130,9 @@ std::pair<std::unique_ptr<common::Filter>, bool> createBigintValuesFilter(
   VELOX_USER_CHECK(
       !values.empty(),
       "IN predicate expects at least one non-null value in the in-list");
+  if (values.size() <= kMaxSmallInListSize) {
+    smallValues = values;
+  }
   if (values.size() == 1) {
     return {
         std::make_unique<common::BigintRange>(
@@ -86,9 +143,10 @@ std::pair<std::unique_ptr<common::Filter>, bool> createBigintValuesFilter(
   return {common::createBigintValues(values, nullAllowed), false};
 }
 
-// See createBigintValuesFilter.
+// See createBigintValuesFilter. Sets 'stringValues' to the values.
 std::pair<std::unique_ptr<common::Filter>, bool> createBytesValuesFilter(
-    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    std::unique_ptr<StringValues>& stringValues) {
   auto valuesPair = toValues<std::string, StringView>(inputArgs);
   if (!valuesPair.has_value()) {
     return {nullptr, false};
@@ -103,6 +161,7 @@ std::pair<std::unique_ptr<common::Filter>, bool> createBytesValuesFilter(
   VELOX_USER_CHECK(
       !values.empty(),
       "IN predicate expects at least one value in the in-list");
+  stringValues = std::make_unique<StringValues>(values);
   if (values.size() == 1) {
     return {
         std::make_unique<common::BytesRange>(
@@ -115,8 +174,15 @@ std::pair<std::unique_ptr<common::Filter>, bool> createBytesValuesFilter(
 
 class InPredicate : public exec::VectorFunction {
  public:
-  explicit InPredicate(std::unique_ptr<common::Filter> filter, bool alwaysNull)
-      : filter_{std::move(filter)}, alwaysNull_(alwaysNull) {}
+  InPredicate(
+      std::unique_ptr<common::Filter> filter,
+      bool alwaysNull,
+      std::vector<int64_t> smallValues,
+      std::unique_ptr<StringValues> stringValues)
+      : filter_{std::move(filter)},
+        alwaysNull_(alwaysNull),
+        smallValues_(std::move(smallValues)),
+        stringValues_(std::move(stringValues)) {}
 
   static std::shared_ptr<InPredicate> create(
       const std::string& /*name*/,
@@ -125,23 +191,25 @@ class InPredicate : public exec::VectorFunction {
     auto inListType = inputArgs[1].type;
     VELOX_CHECK_EQ(inListType->kind(), TypeKind::ARRAY);
     std::pair<std::unique_ptr<common::Filter>, bool> filter;
+    std::vector<int64_t> smallValues;
+    std::unique_ptr<StringValues> stringValues;
 
     switch (inListType->childAt(0)->kind()) {
       case TypeKind::BIGINT:
-        filter = createBigintValuesFilter<int64_t>(inputArgs);
+        filter = createBigintValuesFilter<int64_t>(inputArgs, smallValues);
         break;
       case TypeKind::INTEGER:
-        filter = createBigintValuesFilter<int32_t>(inputArgs);
+        filter = createBigintValuesFilter<int32_t>(inputArgs, smallValues);
         break;
       case TypeKind::SMALLINT:
-        filter = createBigintValuesFilter<int16_t>(inputArgs);
+        filter = createBigintValuesFilter<int16_t>(inputArgs, smallValues);
         break;
       case TypeKind::TINYINT:
-        filter = createBigintValuesFilter<int8_t>(inputArgs);
+        filter = createBigintValuesFilter<int8_t>(inputArgs, smallValues);
         break;
       case TypeKind::VARCHAR:
       case TypeKind::VARBINARY:
-        filter = createBytesValuesFilter(inputArgs);
+        filter = createBytesValuesFilter(inputArgs, stringValues);
         break;
       case TypeKind::UNKNOWN:
         filter = {nullptr, true};
@@ -152,7 +220,10 @@ class InPredicate : public exec::VectorFunction {
             inListType->toString());
     }
     return std::make_shared<InPredicate>(
-        std::move(filter.first), filter.second);
+        std::move(filter.first),
+        filter.second,
+        std::move(smallValues),
+        std::move(stringValues));
   }
 
   // x IN (2, null) returns null when x != 2 and true when x == 2.
@@ -193,7 +264,7 @@ class InPredicate : public exec::VectorFunction {
       case TypeKind::VARBINARY:
         applyTyped<StringView>(
             rows, input, context, result, [&](StringView value) {
-              return filter_->testBytes(value.data(), value.size());
+              return stringValues_->contains(value);
             });
         break;
       default:
@@ -280,6 +351,13 @@ class InPredicate : public exec::VectorFunction {
 
     auto* rawResults = boolResult->mutableRawValues<uint64_t>();
 
+    if constexpr (std::is_integral_v<T>) {
+      if (!smallValues_.empty() || sizeof(T) > 1) {
+        applyBatches(rows, *flatArg, passOrNull, testFunction, *boolResult);
+        return;
+      }
+    }
+
     if (flatArg->mayHaveNulls() || passOrNull) {
       rows.applyToSelected([&](auto row) {
         if (flatArg->isNullAt(row)) {
@@ -301,8 +379,95 @@ class InPredicate : public exec::VectorFunction {
     }
   }
 
+  // Returns true for the lanes of 'values' that are in the IN list.
+  template <typename T>
+  xsimd::batch_bool<T> testBatch(xsimd::batch<T> values) const {
+    if (smallValues_.empty()) {
+      if constexpr (sizeof(T) > 1) {
+        return filter_->testValues(values);
+      }
+      VELOX_UNREACHABLE();
+    }
+    auto result = values == xsimd::broadcast<T>(smallValues_[0]);
+    for (auto i = 1; i < smallValues_.size(); ++i) {
+      result = result | (values == xsimd::broadcast<T>(smallValues_[i]));
+    }
+    return result;
+  }
+
+  // Returns the bits for the 64 values starting at 'rawValues' that are in
+  // the IN list.
+  template <typename T>
+  uint64_t testWord(const T* rawValues) const {
+    constexpr int32_t kBatchSize = xsimd::batch<T>::size;
+    uint64_t bits = 0;
+    for (auto i = 0; i < 64; i += kBatchSize) {
+      auto values = xsimd::batch<T>::load_unaligned(rawValues + i);
+      bits |= static_cast<uint64_t>(simd::toBitMask(testBatch(values))) << i;
+    }
+    return bits;
+  }
+
+  // Tests the values of 'arg' for 'rows' a word of rows at a time. The full
+  // words of rows are tested in SIMD batches. Sets the results and nulls of
+  // the word at once.
+  template <typename T, typename F>
+  void applyBatches(
+      const SelectivityVector& rows,
+      const FlatVector<T>& arg,
+      bool passOrNull,
+      F& testFunction,
+      FlatVector<bool>& result) const {
+    const auto* rawValues = arg.rawValues();
+    const auto* rawNulls = arg.rawNulls();
+    const auto* selectedBits = rows.asRange().bits();
+    auto* rawResults = result.template mutableRawValues<uint64_t>();
+    auto* rawResultNulls =
+        rawNulls || passOrNull ? result.mutableRawNulls() : nullptr;
+
+    auto setWord = [&](int32_t index, uint64_t mask, uint64_t pass) {
+      rawResults[index] = (rawResults[index] & ~mask) | (pass & mask);
+      if (rawResultNulls) {
+        auto notNull = mask;
+        if (rawNulls) {
+          notNull &= rawNulls[index];
+        }
+        if (passOrNull) {
+          notNull &= pass;
+        }
+        rawResultNulls[index] &= ~(mask & ~notNull);
+      }
+    };
+
+    bits::forEachWord(
+        rows.begin(),
+        rows.end(),
+        [&](int32_t index, uint64_t mask) {
+          mask &= selectedBits[index];
+          uint64_t pass = 0;
+          bits::forEachSetBit(&mask, 0, 64, [&](auto bit) {
+            if (testFunction(rawValues[index * 64 + bit])) {
+              pass |= 1UL << bit;
+            }
+          });
+          setWord(index, mask, pass);
+        },
+        [&](int32_t index) {
+          auto mask = selectedBits[index];
+          if (mask) {
+            setWord(index, mask, testWord(rawValues + index * 64));
+          }
+        });
+  }
+
   const std::unique_ptr<common::Filter> filter_;
   const bool alwaysNull_;
+
+  // The values of an integer IN list of at most kMaxSmallInListSize values.
+  const std::vector<int64_t> smallValues_;
+
+  // The values of a VARCHAR or VARBINARY IN list.
+  const std::unique_ptr<StringValues> stringValues_;
 };
 } // namespace
 
@@ -53,6 +53,19 @@ struct HllAccumulator {
     }
   }
 
+  // Appends 'numHashes' hashes at once. 'hashes' is used as scratch space.
+  void append(uint64_t* hashes, int32_t numHashes) {
+    if (isSparse_) {
+      if (sparseHll_.insertHashes(hashes, numHashes)) {
+        toDense();
+      }
+    } else {
+      for (auto i = 0; i < numHashes; ++i) {
+        denseHll_.insertHash(hashes[i]);
+      }
+    }
+  }
+
   int64_t cardinality() const {
     return isSparse_ ? sparseHll_.cardinality() : denseHll_.cardinality();
   }
@@ -200,21 +213,28 @@ class ApproxDistinctAggregate : public exec::Aggregate {
     } else {
       decodeArguments(rows, args);
 
+      // The hashes for sparse groups are inserted per group in one batch.
+      sparseHashes_.clear();
       rows.applyToSelected([&](auto row) {
         if (decodedValue_.isNullAt(row)) {
           return;
         }
 
         auto group = groups[row];
-        auto tracker = trackRowSize(group);
         auto accumulator = value<HllAccumulator>(group);
         if (clearNull(group)) {
           accumulator->setIndexBitLength(indexBitLength_);
         }
 
         auto hash = hashOne(decodedValue_.valueAt<T>(row));
-        accumulator->append(hash);
+        if (accumulator->isSparse_) {
+          sparseHashes_.emplace_back(group, hash);
+        } else {
+          auto tracker = trackRowSize(group);
+          accumulator->append(hash);
+        }
       });
+      appendSparseHashes();
     }
   }
 
@@ -252,19 +272,20 @@ class ApproxDistinctAggregate : public exec::Aggregate {
     } else {
       decodeArguments(rows, args);
 
+      hashes_.clear();
       rows.applyToSelected([&](auto row) {
         if (decodedValue_.isNullAt(row)) {
           return;
         }
-
+        hashes_.push_back(hashOne(decodedValue_.valueAt<T>(row)));
+      });
+      if (!hashes_.empty()) {
         auto accumulator = value<HllAccumulator>(group);
         if (clearNull(group)) {
           accumulator->setIndexBitLength(indexBitLength_);
         }
-
-        auto hash = hashOne(decodedValue_.valueAt<T>(row));
-        accumulator->append(hash);
-      });
+        accumulator->append(hashes_.data(), hashes_.size());
+      }
     }
   }
 
@@ -291,6 +312,20 @@ class ApproxDistinctAggregate : public exec::Aggregate {
   }
 
  private:
+  // Appends 'sparseHashes_' to their groups, one batch per group.
+  void appendSparseHashes() {
+    std::sort(sparseHashes_.begin(), sparseHashes_.end());
+    for (auto i = 0; i < sparseHashes_.size();) {
+      auto group = sparseHashes_[i].first;
+      hashes_.clear();
+      for (; i < sparseHashes_.size() && sparseHashes_[i].first == group; ++i) {
+        hashes_.push_back(sparseHashes_[i].second);
+      }
+      auto tracker = trackRowSize(group);
+      value<HllAccumulator>(group)->append(hashes_.data(), hashes_.size());
+    }
+  }
+
   template <
       bool convertNullToZero,
       typename ExtractResult,
@@ -378,6 +413,11 @@ class ApproxDistinctAggregate : public exec::Aggregate {
   DecodedVector decodedValue_;
   DecodedVector decodedMaxStandardError_;
   DecodedVector decodedHll_;
+
+  // Groups and hashes of the raw input rows for sparse groups and the hashes
+  // of one group.
+  std::vector<std::pair<char*, uint64_t>> sparseHashes_;
+  std::vector<uint64_t> hashes_;
 };
 
 template <TypeKind kind>
@@ -56,7 +56,8 @@ class ArbitraryAggregate : public SimpleNumericAggregate<T, T, T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*unused*/) override {
-    DecodedVector decoded(*args[0], rows);
+    auto& decoded = this->decodedRaw_;
+    decoded.decode(*args[0], rows);
 
     if (decoded.isConstantMapping()) {
       if (decoded.isNullAt(0)) {
@@ -96,7 +97,8 @@ class ArbitraryAggregate : public SimpleNumericAggregate<T, T, T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*unused*/) override {
-    DecodedVector decoded(*args[0], rows);
+    auto& decoded = this->decodedRaw_;
+    decoded.decode(*args[0], rows);
 
     if (decoded.isConstantMapping()) {
       if (decoded.isNullAt(0)) {
@@ -134,24 +136,27 @@ class ArbitraryAggregate : public SimpleNumericAggregate<T, T, T> {
 
 // Arbitrary for non-numeric types. We always keep the first (non-NULL) element
 // seen. Arbitrary (x) will produce partial and final aggregations of type x.
+// TAccumulator is SingleStringAccumulator for VARCHAR and
+// SingleValueAccumulator for the other types.
+template <typename TAccumulator>
 class NonNumericArbitrary : public exec::Aggregate {
  public:
   explicit NonNumericArbitrary(const TypePtr& resultType)
       : exec::Aggregate(resultType) {}
 
-  // We use singleValueAccumulator to save the results for each group. This
+  // We use TAccumulator to save the results for each group. This
   // struct will allow us to save variable-width value.
   int32_t accumulatorFixedWidthSize() const override {
-    return sizeof(SingleValueAccumulator);
+    return sizeof(TAccumulator);
   }
 
   // Initialize each group, we will not use the null flags because
-  // SingleValueAccumulator has its own flag.
+  // TAccumulator has its own flag.
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
     for (auto i : indices) {
-      new (groups[i] + offset_) SingleValueAccumulator();
+      new (groups[i] + offset_) TAccumulator();
     }
   }
 
@@ -164,7 +169,7 @@ class NonNumericArbitrary : public exec::Aggregate {
 
     for (int32_t i = 0; i < numGroups; ++i) {
       char* group = groups[i];
-      auto accumulator = value<SingleValueAccumulator>(group);
+      auto accumulator = value<TAccumulator>(group);
       if (!accumulator->hasValue()) {
         (*result)->setNull(i, true);
       } else {
@@ -181,7 +186,7 @@ class NonNumericArbitrary : public exec::Aggregate {
 
   void destroy(folly::Range<char**> groups) override {
     for (auto group : groups) {
-      value<SingleValueAccumulator>(group)->destroy(allocator_);
+      value<TAccumulator>(group)->destroy(allocator_);
     }
   }
 
@@ -190,7 +195,8 @@ class NonNumericArbitrary : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*unused*/) override {
-    DecodedVector decoded(*args[0], rows, true);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*args[0], rows, true);
     if (decoded.isConstantMapping() && decoded.isNullAt(0)) {
       // nothing to do; all values are nulls
       return;
@@ -202,7 +208,7 @@ class NonNumericArbitrary : public exec::Aggregate {
       if (decoded.isNullAt(i)) {
         return;
       }
-      auto* accumulator = value<SingleValueAccumulator>(groups[i]);
+      auto* accumulator = value<TAccumulator>(groups[i]);
       if (!accumulator->hasValue()) {
         accumulator->write(baseVector, indices[i], allocator_);
       }
@@ -222,7 +228,8 @@ class NonNumericArbitrary : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*unused*/) override {
-    DecodedVector decoded(*args[0], rows, true);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*args[0], rows, true);
     if (decoded.isConstantMapping() && decoded.isNullAt(0)) {
       // nothing to do; all values are nulls
       return;
@@ -230,7 +237,7 @@ class NonNumericArbitrary : public exec::Aggregate {
 
     const auto* indices = decoded.indices();
     const auto* baseVector = decoded.base();
-    auto* accumulator = value<SingleValueAccumulator>(group);
+    auto* accumulator = value<TAccumulator>(group);
     // Find the first non-null value.
     rows.testSelected([&](vector_size_t i) {
       if (!decoded.isNullAt(i)) {
@@ -248,6 +255,10 @@ class NonNumericArbitrary : public exec::Aggregate {
       bool mayPushdown) override {
     addSingleGroupRawInput(group, rows, args, mayPushdown);
   }
+
+ private:
+  // Reused across batches so that its buffers keep their capacity.
+  DecodedVector decodedRaw_;
 };
 
 bool registerArbitraryAggregate(const std::string& name) {
@@ -292,10 +303,13 @@ bool registerArbitraryAggregate(const std::string& name) {
             return std::make_unique<ArbitraryAggregate<IntervalDayTime>>(
                 inputType);
           case TypeKind::VARCHAR:
+            return std::make_unique<
+                NonNumericArbitrary<SingleStringAccumulator>>(inputType);
           case TypeKind::ARRAY:
           case TypeKind::MAP:
           case TypeKind::ROW:
-            return std::make_unique<NonNumericArbitrary>(inputType);
+            return std::make_unique<
+                NonNumericArbitrary<SingleValueAccumulator>>(inputType);
           default:
             VELOX_FAIL(
                 "Unknown input type for {} aggregation {}",
@@ -80,6 +80,35 @@ class ArrayAggAggregate : public exec::Aggregate {
     extractValues(groups, numGroups, result);
   }
 
+  bool supportsSpillState() const override {
+    return true;
+  }
+
+  void extractSpillState(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto vector = (*result)->asFlatVector<StringView>();
+    VELOX_CHECK(vector);
+    vector->resize(numGroups);
+    for (int32_t i = 0; i < numGroups; ++i) {
+      auto& values = value<ArrayAccumulator>(groups[i])->elements;
+      setSerialized(*vector, i, values.serializedSize(), [&](char* data) {
+        values.serialize(data);
+      });
+    }
+  }
+
+  void addSingleGroupSpillState(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& state) override {
+    decodedIntermediate_.decode(*state, rows);
+    auto& values = value<ArrayAccumulator>(group)->elements;
+    rows.applyToSelected([&](vector_size_t row) {
+      values.appendSerialized(
+          decodedIntermediate_.valueAt<StringView>(row).data(), allocator_);
+    });
+  }
+
   void addRawInput(
       char** groups,
       const SelectivityVector& rows,
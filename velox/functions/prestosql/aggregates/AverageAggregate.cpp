@@ -240,6 +240,37 @@ class AverageAggregate : public exec::Aggregate {
     }
   }
 
+  bool supportsRemoveRawInput() const override {
+    return true;
+  }
+
+  void removeSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    decodedRaw_.decode(*args[0], rows);
+
+    if (decodedRaw_.isConstantMapping()) {
+      if (!decodedRaw_.isNullAt(0)) {
+        const TInput value = decodedRaw_.valueAt<TInput>(0);
+        const auto numRows = rows.countSelected();
+        removeNonNullValue(group, numRows, TAccumulator(value) * numRows);
+      }
+    } else if (decodedRaw_.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decodedRaw_.isNullAt(i)) {
+          removeNonNullValue(
+              group, 1, TAccumulator(decodedRaw_.valueAt<TInput>(i)));
+        }
+      });
+    } else {
+      TAccumulator totalSum(0);
+      rows.applyToSelected(
+          [&](vector_size_t i) { totalSum += decodedRaw_.valueAt<TInput>(i); });
+      removeNonNullValue(group, rows.countSelected(), totalSum);
+    }
+  }
+
  private:
   // partial
   template <bool tableHasNulls = true>
@@ -260,6 +291,11 @@ class AverageAggregate : public exec::Aggregate {
     accumulator(group)->count += count;
   }
 
+  inline void removeNonNullValue(char* group, int64_t count, TAccumulator sum) {
+    accumulator(group)->sum -= sum;
+    accumulator(group)->count -= count;
+  }
+
   inline SumCount<TAccumulator>* accumulator(char* group) {
     return exec::Aggregate::value<SumCount<TAccumulator>>(group);
   }
@@ -63,7 +63,8 @@ class CountIfAggregate : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
-    DecodedVector decoded(*args[0], rows);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*args[0], rows);
 
     if (decoded.isConstantMapping()) {
       if (decoded.isNullAt(0)) {
@@ -96,7 +97,8 @@ class CountIfAggregate : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
-    DecodedVector decoded(*args[0], rows);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*args[0], rows);
 
     if (decoded.isConstantMapping()) {
       auto numTrue = decoded.valueAt<int64_t>(0);
@@ -116,7 +118,8 @@ class CountIfAggregate : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
-    DecodedVector decoded(*args[0], rows);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*args[0], rows);
 
     // Constant mapping - check once and add number of selected rows if true.
     if (decoded.isConstantMapping()) {
@@ -166,6 +169,9 @@ class CountIfAggregate : public exec::Aggregate {
   inline void addToGroup(char* group, int64_t numTrue) {
     *value<int64_t>(group) += numTrue;
   }
+
+  // Reused across batches so that its buffers keep their capacity.
+  DecodedVector decodedRaw_;
 };
 
 bool registerCountIfAggregate(const std::string& name) {
@@ -69,6 +69,49 @@ void MapAggregateBase::extractValues(
   *result = removeDuplicates(mapVectorPtr);
 }
 
+void MapAggregateBase::extractSpillState(
+    char** groups,
+    int32_t numGroups,
+    VectorPtr* result) {
+  auto vector = (*result)->asFlatVector<StringView>();
+  VELOX_CHECK(vector);
+  vector->resize(numGroups);
+  for (int32_t i = 0; i < numGroups; ++i) {
+    char* group = groups[i];
+    if (isNull(group)) {
+      vector->setNull(i, true);
+      continue;
+    }
+    auto accumulator = value<MapAccumulator>(group);
+    auto& keys = accumulator->keys;
+    auto& values = accumulator->values;
+    setSerialized(
+        *vector,
+        i,
+        keys.serializedSize() + values.serializedSize(),
+        [&](char* data) {
+          keys.serialize(data);
+          values.serialize(data + keys.serializedSize());
+        });
+  }
+}
+
+void MapAggregateBase::addSingleGroupSpillState(
+    char* group,
+    const SelectivityVector& rows,
+    const VectorPtr& state) {
+  decodedMaps_.decode(*state, rows);
+  auto accumulator = value<MapAccumulator>(group);
+  rows.applyToSelected([&](vector_size_t row) {
+    if (!decodedMaps_.isNullAt(row)) {
+      clearNull(group);
+      auto data = decodedMaps_.valueAt<StringView>(row).data();
+      data = accumulator->keys.appendSerialized(data, allocator_);
+      accumulator->values.appendSerialized(data, allocator_);
+    }
+  });
+}
+
 VectorPtr MapAggregateBase::removeDuplicates(MapVectorPtr& mapVector) const {
   MapVector::canonicalize(mapVector);
 
@@ -55,6 +55,20 @@ class MapAggregateBase : public exec::Aggregate {
     extractValues(groups, numGroups, result);
   }
 
+  bool supportsSpillState() const override {
+    return true;
+  }
+
+  // The state of a group is the serialized keys followed by the serialized
+  // values or null if the group is null.
+  void extractSpillState(char** groups, int32_t numGroups, VectorPtr* result)
+      override;
+
+  void addSingleGroupSpillState(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& state) override;
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
@@ -73,6 +73,10 @@ class MinMaxAggregate : public SimpleNumericAggregate<T, T, T> {
     return sizeof(T);
   }
 
+  bool supportsColumnarInput() const override {
+    return kSupportsColumnar;
+  }
+
   void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     BaseAggregate::template doExtractValues<T>(
@@ -88,6 +92,12 @@ class MinMaxAggregate : public SimpleNumericAggregate<T, T, T> {
           return *BaseAggregate::Aggregate::template value<T>(group);
         });
   }
+
+ protected:
+  // Timestamp, Date and IntervalDayTime are not arithmetic. A vector of
+  // bool accumulators would be bit packed.
+  static constexpr bool kSupportsColumnar =
+      std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
 };
 
 // Truncate timestamps to milliseconds precision.
@@ -130,15 +140,31 @@ class MaxAggregate : public MinMaxAggregate<T> {
       return;
     }
     BaseAggregate::template updateGroups<true, T>(
-        groups,
-        rows,
-        args[0],
-        [](T& result, T value) {
-          if (result < value) {
-            result = value;
-          }
-        },
-        mayPushdown);
+        groups, rows, args[0], &updateValue, mayPushdown);
+  }
+
+  void addRawInputColumnar(
+      const uint64_t* ordinals,
+      int32_t numOrdinals,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (MinMaxAggregate<T>::kSupportsColumnar) {
+      BaseAggregate::updateColumnar(
+          ordinals,
+          numOrdinals,
+          rows,
+          args[0].get(),
+          kInitialValue_,
+          &updateValue);
+    } else {
+      exec::Aggregate::addRawInputColumnar(ordinals, numOrdinals, rows, args);
+    }
+  }
+
+  void flushColumnar(char* const* groups) override {
+    if constexpr (MinMaxAggregate<T>::kSupportsColumnar) {
+      BaseAggregate::flushColumnarValues(groups, kInitialValue_, &updateValue);
+    }
   }
 
   void addIntermediateResults(
@@ -154,7 +180,7 @@ class MaxAggregate : public MinMaxAggregate<T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    BaseAggregate::updateOneGroup(
+    BaseAggregate::template updateOneGroupSimd<SimdReduction::kMax, T, T>(
         group,
         rows,
         args[0],
@@ -177,6 +203,12 @@ class MaxAggregate : public MinMaxAggregate<T> {
   }
 
  private:
+  static void updateValue(T& result, T value) {
+    if (result < value) {
+      result = value;
+    }
+  }
+
   static constexpr T kInitialValue_{MinMaxTrait<T>::min()};
 };
 
@@ -207,15 +239,31 @@ class MinAggregate : public MinMaxAggregate<T> {
       return;
     }
     BaseAggregate::template updateGroups<true, T>(
-        groups,
-        rows,
-        args[0],
-        [](T& result, T value) {
-          if (result > value) {
-            result = value;
-          }
-        },
-        mayPushdown);
+        groups, rows, args[0], &updateValue, mayPushdown);
+  }
+
+  void addRawInputColumnar(
+      const uint64_t* ordinals,
+      int32_t numOrdinals,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (MinMaxAggregate<T>::kSupportsColumnar) {
+      BaseAggregate::updateColumnar(
+          ordinals,
+          numOrdinals,
+          rows,
+          args[0].get(),
+          kInitialValue_,
+          &updateValue);
+    } else {
+      exec::Aggregate::addRawInputColumnar(ordinals, numOrdinals, rows, args);
+    }
+  }
+
+  void flushColumnar(char* const* groups) override {
+    if constexpr (MinMaxAggregate<T>::kSupportsColumnar) {
+      BaseAggregate::flushColumnarValues(groups, kInitialValue_, &updateValue);
+    }
   }
 
   void addIntermediateResults(
@@ -231,7 +279,7 @@ class MinAggregate : public MinMaxAggregate<T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    BaseAggregate::updateOneGroup(
+    BaseAggregate::template updateOneGroupSimd<SimdReduction::kMin, T, T>(
         group,
         rows,
         args[0],
@@ -250,6 +298,12 @@ class MinAggregate : public MinMaxAggregate<T> {
   }
 
  private:
+  static void updateValue(T& result, T value) {
+    if (result > value) {
+      result = value;
+    }
+  }
+
   static constexpr T kInitialValue_{MinMaxTrait<T>::max()};
 };
 
@@ -315,7 +369,8 @@ class NonNumericMinMaxAggregateBase : public exec::Aggregate {
       const SelectivityVector& rows,
       const VectorPtr& arg,
       TCompareTest compareTest) {
-    DecodedVector decoded(*arg, rows, true);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*arg, rows, true);
     auto indices = decoded.indices();
     auto baseVector = decoded.base();
 
@@ -342,7 +397,8 @@ class NonNumericMinMaxAggregateBase : public exec::Aggregate {
       const SelectivityVector& rows,
       const VectorPtr& arg,
       TCompareTest compareTest) {
-    DecodedVector decoded(*arg, rows, true);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*arg, rows, true);
     auto indices = decoded.indices();
     auto baseVector = decoded.base();
 
@@ -371,6 +427,9 @@ class NonNumericMinMaxAggregateBase : public exec::Aggregate {
       }
     });
   }
+
+  // Reused across batches so that its buffers keep their capacity.
+  DecodedVector decodedRaw_;
 };
 
 class NonNumericMaxAggregate : public NonNumericMinMaxAggregateBase {
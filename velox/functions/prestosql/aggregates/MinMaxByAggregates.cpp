@@ -54,6 +54,8 @@ void store(
     HashStringAllocator* allocator) {
   if constexpr (isNumericOrDate<T>()) {
     *accumulator = decodedVector.valueAt<T>(index);
+  } else if constexpr (std::is_same_v<T, StringView>) {
+    accumulator->write(decodedVector.valueAt<T>(index), allocator);
   } else {
     accumulator->write(
         decodedVector.base(), decodedVector.index(index), allocator);
@@ -107,6 +109,13 @@ struct AccumulatorTypeTraits<T, std::enable_if_t<!isNumericOrDate<T>(), void>> {
   using AccumulatorType = SingleValueAccumulator;
 };
 
+/// Strings are kept inline in the accumulator if they are short and compared
+/// without deserializing them.
+template <>
+struct AccumulatorTypeTraits<StringView, void> {
+  using AccumulatorType = SingleStringAccumulator;
+};
+
 template <typename T>
 struct MinMaxTrait : public std::numeric_limits<T> {};
 
@@ -154,7 +163,7 @@ class MinMaxByAggregate : public exec::Aggregate {
       valueIsNull(group) = true;
 
       if constexpr (!isNumericOrDate<T>()) {
-        new (group + offset_) SingleValueAccumulator();
+        new (group + offset_) ValueAccumulatorType();
       }
 
       if constexpr (isNumericOrDate<U>()) {
@@ -163,7 +172,7 @@ class MinMaxByAggregate : public exec::Aggregate {
         new (
             group + offset_ +
             (isNumericOrDate<T>() ? sizeof(T) : sizeof(ValueAccumulatorType)))
-            SingleValueAccumulator();
+            ComparisonAccumulatorType();
       }
     }
   }
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/AggregationHook.h"
 #include "velox/vector/DecodedVector.h"
@@ -23,6 +24,135 @@
 
 namespace facebook::velox::aggregate {
 
+// Reductions with a vectorized path for global aggregation, see
+// SimpleNumericAggregate::updateOneGroupSimd().
+enum class SimdReduction { kSum, kMin, kMax };
+
+namespace detail {
+
+// Partial sum, min or max of the non-null values of a flat vector. Words of
+// 64 selected non-null values are reduced with SIMD into 'lanes_' and the
+// other values into 'scalar_'. Integer sums wrap around and remember if a
+// lane or 'scalar_' overflowed, so that the caller can redo the sum with
+// checked arithmetic. Min and max are only vectorized for integers because
+// the SIMD instructions do not order NaN like the scalar comparisons.
+template <SimdReduction kReduction, typename TData, typename TValue>
+class SimdReducer {
+ public:
+  using Batch = xsimd::batch<TData>;
+
+  SimdReducer()
+      : lanes_(xsimd::broadcast<TData>(identity())),
+        overflowLanes_(xsimd::broadcast<TData>(0)),
+        scalar_(identity()) {}
+
+  // Adds 64 consecutive non-null values starting at 'values'.
+  void addWord(const TValue* values) {
+    constexpr bool kSameType = std::is_same_v<TData, TValue>;
+    if constexpr (
+        kReduction == SimdReduction::kSum && kSameType &&
+        std::is_integral_v<TData>) {
+      for (auto i = 0; i < 64; i += Batch::size) {
+        auto value = Batch::load_unaligned(values + i);
+        auto sum = lanes_ + value;
+        // The sign of a sum overflows if it differs from both operands.
+        overflowLanes_ = overflowLanes_ | ((lanes_ ^ sum) & (value ^ sum));
+        lanes_ = sum;
+      }
+    } else if constexpr (
+        kReduction == SimdReduction::kSum && std::is_same_v<TData, int64_t> &&
+        std::is_same_v<TValue, int32_t>) {
+      // Sums of widened 32 bit values do not overflow 64 bit lanes.
+      using ValueBatch = xsimd::batch<int32_t>;
+      for (auto i = 0; i < 64; i += ValueBatch::size) {
+        auto value = ValueBatch::load_unaligned(values + i);
+        lanes_ = lanes_ + simd::getHalf<int64_t, false>(value) +
+            simd::getHalf<int64_t, true>(value);
+      }
+    } else if constexpr (kReduction == SimdReduction::kSum && kSameType) {
+      for (auto i = 0; i < 64; i += Batch::size) {
+        lanes_ = lanes_ + Batch::load_unaligned(values + i);
+      }
+    } else if constexpr (
+        kReduction == SimdReduction::kMin && kSameType &&
+        std::is_integral_v<TData>) {
+      for (auto i = 0; i < 64; i += Batch::size) {
+        lanes_ = xsimd::min(lanes_, Batch::load_unaligned(values + i));
+      }
+    } else if constexpr (
+        kReduction == SimdReduction::kMax && kSameType &&
+        std::is_integral_v<TData>) {
+      for (auto i = 0; i < 64; i += Batch::size) {
+        lanes_ = xsimd::max(lanes_, Batch::load_unaligned(values + i));
+      }
+    } else {
+      for (auto i = 0; i < 64; ++i) {
+        addValue(values[i]);
+      }
+    }
+  }
+
+  void addValue(TValue value) {
+    add(scalar_, TData(value));
+  }
+
+  // Sets 'result' to the reduction of the added values. Returns false if an
+  // integer sum overflowed.
+  bool finish(TData& result) {
+    TData lanes[Batch::size];
+    lanes_.store_unaligned(lanes);
+    for (auto i = 0; i < Batch::size; ++i) {
+      add(scalar_, lanes[i]);
+    }
+    if constexpr (
+        kReduction == SimdReduction::kSum && std::is_integral_v<TData>) {
+      TData overflowLanes[Batch::size];
+      overflowLanes_.store_unaligned(overflowLanes);
+      for (auto i = 0; i < Batch::size; ++i) {
+        overflow_ |= overflowLanes[i] < 0;
+      }
+    }
+    result = scalar_;
+    return !overflow_;
+  }
+
+ private:
+  static constexpr TData identity() {
+    if constexpr (kReduction == SimdReduction::kSum) {
+      return 0;
+    } else if constexpr (kReduction == SimdReduction::kMin) {
+      return std::numeric_limits<TData>::max();
+    } else {
+      return std::numeric_limits<TData>::lowest();
+    }
+  }
+
+  void add(TData& result, TData value) {
+    if constexpr (kReduction == SimdReduction::kSum) {
+      if constexpr (std::is_integral_v<TData>) {
+        overflow_ |= __builtin_add_overflow(result, value, &result);
+      } else {
+        result += value;
+      }
+    } else if constexpr (kReduction == SimdReduction::kMin) {
+      if (result > value) {
+        result = value;
+      }
+    } else {
+      if (result < value) {
+        result = value;
+      }
+    }
+  }
+
+  Batch lanes_;
+  Batch overflowLanes_;
+  TData scalar_;
+  bool overflow_{false};
+};
+
+} // namespace detail
+
 template <typename TInput, typename TAccumulator, typename TResult>
 class SimpleNumericAggregate : public exec::Aggregate {
  protected:
@@ -93,7 +223,8 @@ class SimpleNumericAggregate : public exec::Aggregate {
       const VectorPtr& arg,
       UpdateSingleValue updateSingleValue,
       bool mayPushdown) {
-    DecodedVector decoded(*arg, rows, !mayPushdown);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*arg, rows, !mayPushdown);
     auto encoding = decoded.base()->encoding();
     if (encoding == VectorEncoding::Simple::LAZY) {
       SimpleCallableHook<TValue, TData, UpdateSingleValue> hook(
@@ -158,7 +289,8 @@ class SimpleNumericAggregate : public exec::Aggregate {
       UpdateDuplicate updateDuplicateValues,
       bool /*mayPushdown*/,
       TData initialValue) {
-    DecodedVector decoded(*arg, rows);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*arg, rows);
 
     // Do row by row if not all rows are selected.
     if (decoded.isConstantMapping()) {
@@ -191,10 +323,155 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
   }
 
+  // Updates the columnar accumulators of the groups with ordinals
+  // 'ordinals' from the non-null values of 'arg' in 'rows', see
+  // exec::Aggregate::addRawInputColumnar(). 'updateSingleValue' adds a value
+  // of TValue converted to TAccumulator. If TValue is void, the values are
+  // not read and 'initialValue' is added instead, e.g. for count. The
+  // accumulators start at 'initialValue' after each flush. A nullptr 'arg'
+  // updates all 'rows'.
+  template <typename TValue = TInput, typename UpdateSingleValue>
+  void updateColumnar(
+      const uint64_t* ordinals,
+      int32_t numOrdinals,
+      const SelectivityVector& rows,
+      const BaseVector* arg,
+      TAccumulator initialValue,
+      UpdateSingleValue updateSingleValue) {
+    if (columnarValues_.size() < numOrdinals) {
+      columnarValues_.resize(numOrdinals, initialValue);
+      columnarUpdated_.resize(bits::nwords(numOrdinals), 0);
+    }
+    auto* values = columnarValues_.data();
+    auto* updated = columnarUpdated_.data();
+    auto update = [&](vector_size_t i, TAccumulator value) {
+      const auto ordinal = ordinals[i];
+      updateSingleValue(values[ordinal], value);
+      bits::setBit(updated, ordinal);
+    };
+    if (!arg) {
+      rows.applyToSelected([&](vector_size_t i) { update(i, initialValue); });
+      return;
+    }
+    auto& decoded = decodedRaw_;
+    decoded.decode(*arg, rows);
+    auto valueAt = [&](vector_size_t i) {
+      if constexpr (std::is_void_v<TValue>) {
+        return initialValue;
+      } else {
+        return TAccumulator(decoded.valueAt<TValue>(i));
+      }
+    };
+    if (decoded.isConstantMapping()) {
+      if (!decoded.isNullAt(0)) {
+        const auto value = valueAt(0);
+        rows.applyToSelected([&](vector_size_t i) { update(i, value); });
+      }
+    } else if (decoded.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded.isNullAt(i)) {
+          update(i, valueAt(i));
+        }
+      });
+    } else if constexpr (
+        !std::is_void_v<TValue> && !std::is_same_v<TValue, bool>) {
+      if (decoded.isIdentityMapping()) {
+        auto data = decoded.data<TValue>();
+        rows.applyToSelected(
+            [&](vector_size_t i) { update(i, TAccumulator(data[i])); });
+      } else {
+        rows.applyToSelected([&](vector_size_t i) { update(i, valueAt(i)); });
+      }
+    } else {
+      rows.applyToSelected([&](vector_size_t i) { update(i, valueAt(i)); });
+    }
+  }
+
+  // Combines the columnar accumulators updated since the last flush into
+  // the accumulators of 'groups' with 'combine' and resets them to
+  // 'initialValue', see exec::Aggregate::flushColumnar().
+  template <typename Combine>
+  void flushColumnarValues(
+      char* const* groups,
+      TAccumulator initialValue,
+      Combine combine) {
+    bits::forEachSetBit(
+        columnarUpdated_.data(),
+        0,
+        columnarValues_.size(),
+        [&](vector_size_t ordinal) {
+          char* group = groups[ordinal];
+          VELOX_DCHECK_NOT_NULL(group);
+          updateNonNullValue<true, TAccumulator>(
+              group, columnarValues_[ordinal], combine);
+          columnarValues_[ordinal] = initialValue;
+        });
+    std::fill(columnarUpdated_.begin(), columnarUpdated_.end(), 0);
+  }
+
+  // Same as updateOneGroup() for sum, min and max with 'kReduction' telling
+  // which. Flat input of arithmetic types is reduced with SIMD where 64
+  // consecutive rows are selected and not null. Min and max of floating point
+  // types are not vectorized. Dictionary input over fewer flat values than
+  // selected rows is reduced once per referenced value, using
+  // 'updateDuplicateValues' for sums.
+  template <
+      SimdReduction kReduction,
+      typename TData = TResult,
+      typename TValue = TInput,
+      typename UpdateSingle,
+      typename UpdateDuplicate>
+  void updateOneGroupSimd(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      UpdateSingle updateSingleValue,
+      UpdateDuplicate updateDuplicateValues,
+      bool mayPushdown,
+      TData initialValue) {
+    constexpr bool kSupported = std::is_arithmetic_v<TValue> &&
+        !std::is_same_v<TValue, bool> && std::is_arithmetic_v<TData> &&
+        (kReduction == SimdReduction::kSum || std::is_integral_v<TValue>);
+    if constexpr (kSupported) {
+      if (arg->isFlatEncoding()) {
+        TData result;
+        bool hasValue;
+        if (reduceFlat<kReduction, TData>(
+                rows,
+                *arg->template asUnchecked<FlatVector<TValue>>(),
+                hasValue,
+                result)) {
+          if (hasValue) {
+            updateNonNullValue<true, TData>(group, result, updateSingleValue);
+          }
+          return;
+        }
+      } else if (
+          arg->encoding() == VectorEncoding::Simple::DICTIONARY &&
+          arg->valueVector()->isFlatEncoding() &&
+          arg->valueVector()->size() < rows.countSelected()) {
+        auto& decoded = decodedRaw_;
+        decoded.decode(*arg, rows);
+        reduceDictionary<kReduction, TData, TValue>(
+            group, rows, decoded, updateSingleValue, updateDuplicateValues);
+        return;
+      }
+    }
+    updateOneGroup<TData, TValue>(
+        group,
+        rows,
+        arg,
+        updateSingleValue,
+        updateDuplicateValues,
+        mayPushdown,
+        initialValue);
+  }
+
   template <typename THook>
   void
   pushdown(char** groups, const SelectivityVector& rows, const VectorPtr& arg) {
-    DecodedVector decoded(*arg, rows, false);
+    auto& decoded = decodedRaw_;
+    decoded.decode(*arg, rows, false);
     const vector_size_t* indices = decoded.indices();
     THook hook(
         exec::Aggregate::offset_,
@@ -224,6 +501,11 @@ class SimpleNumericAggregate : public exec::Aggregate {
         RowSet(indices, numIndices), &hook);
   }
 
+  // Decodes the input of the update helpers and of subclasses. Reused across
+  // batches so that its buffers keep their capacity. A helper that decodes
+  // into it must not be called while a caller still uses it.
+  DecodedVector decodedRaw_;
+
  private:
   // TData is either TAccumulator or TResult, which in most cases are the same,
   // but for sum(real) can differ.
@@ -238,6 +520,95 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
     updateValue(*exec::Aggregate::value<TDataType>(group), value);
   }
+
+  // Reduces the non-null values of 'vector' in 'rows' into 'result'. Sets
+  // 'hasValue' to false if there are none. Returns false if an integer sum
+  // overflowed.
+  template <SimdReduction kReduction, typename TData, typename TValue>
+  static bool reduceFlat(
+      const SelectivityVector& rows,
+      const FlatVector<TValue>& vector,
+      bool& hasValue,
+      TData& result) {
+    const auto* values = vector.rawValues();
+    const auto* nulls = vector.rawNulls();
+    const auto* selected = rows.asRange().bits();
+    detail::SimdReducer<kReduction, TData, TValue> reducer;
+    hasValue = false;
+    bits::forEachWord(
+        rows.begin(), rows.end(), [&](int32_t index, uint64_t mask) {
+          auto word = selected[index] & mask;
+          if (nulls) {
+            word &= nulls[index];
+          }
+          if (word == 0) {
+            return;
+          }
+          hasValue = true;
+          if (word == ~0UL) {
+            reducer.addWord(values + index * 64);
+            return;
+          }
+          do {
+            reducer.addValue(values[index * 64 + __builtin_ctzll(word)]);
+            word &= word - 1;
+          } while (word);
+        });
+    return reducer.finish(result);
+  }
+
+  // Reduces the values of 'decoded', a dictionary over a flat base, once per
+  // referenced base value. Sums add each value times its number of
+  // references with 'updateDuplicateValues'.
+  template <
+      SimdReduction kReduction,
+      typename TData,
+      typename TValue,
+      typename UpdateSingle,
+      typename UpdateDuplicate>
+  void reduceDictionary(
+      char* group,
+      const SelectivityVector& rows,
+      const DecodedVector& decoded,
+      UpdateSingle updateSingleValue,
+      UpdateDuplicate updateDuplicateValues) {
+    const auto* indices = decoded.indices();
+    const auto* values = decoded.data<TValue>();
+    referenceCounts_.assign(decoded.base()->size(), 0);
+    if (decoded.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded.isNullAt(i)) {
+          ++referenceCounts_[indices[i]];
+        }
+      });
+    } else {
+      rows.applyToSelected(
+          [&](vector_size_t i) { ++referenceCounts_[indices[i]]; });
+    }
+    for (auto index = 0; index < referenceCounts_.size(); ++index) {
+      const auto count = referenceCounts_[index];
+      if (count == 0) {
+        continue;
+      }
+      if constexpr (kReduction == SimdReduction::kSum) {
+        exec::Aggregate::clearNull(group);
+        updateDuplicateValues(
+            *exec::Aggregate::value<TData>(group), TData(values[index]), count);
+      } else {
+        updateNonNullValue<true, TData>(
+            group, TData(values[index]), updateSingleValue);
+      }
+    }
+  }
+
+  // Number of selected rows referencing each base value in
+  // reduceDictionary().
+  std::vector<vector_size_t> referenceCounts_;
+
+  // Columnar accumulators by group ordinal and a bit per ordinal that is set
+  // if the accumulator was updated since the last flush.
+  std::vector<TAccumulator> columnarValues_;
+  std::vector<uint64_t> columnarUpdated_;
 };
 
 } // namespace facebook::velox::aggregate
@@ -15,6 +15,7 @@
  */
 
 #include "velox/functions/prestosql/aggregates/SingleValueAccumulator.h"
+#include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::aggregate {
 
@@ -67,4 +68,38 @@ void SingleValueAccumulator::destroy(HashStringAllocator* allocator) {
   }
 }
 
+void SingleStringAccumulator::write(
+    StringView value,
+    HashStringAllocator* allocator) {
+  hasValue_ = true;
+  if (value.isInline()) {
+    value_ = value;
+    return;
+  }
+  const int32_t size = value.size();
+  if (data_ && data_->size() < size) {
+    allocator->free(data_);
+    data_ = nullptr;
+  }
+  if (!data_) {
+    data_ = allocator->allocate(size);
+  }
+  memcpy(data_->begin(), value.data(), size);
+  value_ = StringView(data_->begin(), size);
+}
+
+void SingleStringAccumulator::read(
+    const VectorPtr& vector,
+    vector_size_t index) const {
+  VELOX_CHECK(hasValue_);
+  vector->asUnchecked<FlatVector<StringView>>()->set(index, value_);
+}
+
+void SingleStringAccumulator::destroy(HashStringAllocator* allocator) {
+  if (data_) {
+    allocator->free(data_);
+    data_ = nullptr;
+  }
+}
+
 } // namespace facebook::velox::aggregate
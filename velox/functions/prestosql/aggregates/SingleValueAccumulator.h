@@ -17,6 +17,8 @@
 #pragma once
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/SimpleVector.h"
 
 namespace facebook::velox::aggregate {
 
@@ -44,4 +46,53 @@ struct SingleValueAccumulator {
   HashStringAllocator::Header* begin_{nullptr};
 };
 
+// An accumulator for a single VARCHAR or VARBINARY value. Has the interface of
+// SingleValueAccumulator. Strings of up to StringView::kInlineSize bytes are
+// kept inline in 'value_' without allocating. Longer strings are copied into a
+// block from the HashStringAllocator, which is reused by the next write if it
+// is large enough. Comparisons are made directly on StringViews.
+struct SingleStringAccumulator {
+  void write(StringView value, HashStringAllocator* allocator);
+
+  void write(
+      const BaseVector* vector,
+      vector_size_t index,
+      HashStringAllocator* allocator) {
+    write(
+        vector->asUnchecked<SimpleVector<StringView>>()->valueAt(index),
+        allocator);
+  }
+
+  void read(const VectorPtr& vector, vector_size_t index) const;
+
+  StringView value() const {
+    return value_;
+  }
+
+  bool hasValue() const {
+    return hasValue_;
+  }
+
+  // Returns 0 if stored and new values are equal; <0 if stored value is less
+  // then new value; >0 if stored value is greated than new value
+  int32_t compare(StringView value) const {
+    VELOX_DCHECK(hasValue_);
+    return value_.compare(value);
+  }
+
+  int32_t compare(const DecodedVector& decoded, vector_size_t index) const {
+    return compare(decoded.valueAt<StringView>(index));
+  }
+
+  void destroy(HashStringAllocator* allocator);
+
+ private:
+  StringView value_;
+
+  // Holds the bytes of 'value_' if it is not inline.
+  HashStringAllocator::Header* data_{nullptr};
+
+  bool hasValue_{false};
+};
+
 } // namespace facebook::velox::aggregate
@@ -87,7 +87,9 @@ class SumAggregate
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    BaseAggregate::template updateOneGroup<TAccumulator>(
+    BaseAggregate::template updateOneGroupSimd<
+        SimdReduction::kSum,
+        TAccumulator>(
         group,
         rows,
         args[0],
@@ -102,7 +104,10 @@ class SumAggregate
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    BaseAggregate::template updateOneGroup<TAccumulator, TAccumulator>(
+    BaseAggregate::template updateOneGroupSimd<
+        SimdReduction::kSum,
+        TAccumulator,
+        TAccumulator>(
         group,
         rows,
         args[0],
@@ -112,6 +117,59 @@ class SumAggregate
         TAccumulator(0));
   }
 
+  bool supportsRemoveRawInput() const override {
+    return !std::is_same_v<TAccumulator, UnscaledLongDecimal>;
+  }
+
+  void removeSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (std::is_same_v<TAccumulator, UnscaledLongDecimal>) {
+      exec::Aggregate::removeSingleGroupRawInput(group, rows, args);
+    } else {
+      // The repeated values of a constant input are summed up before being
+      // subtracted from the accumulator.
+      BaseAggregate::template updateOneGroup<TAccumulator>(
+          group,
+          rows,
+          args[0],
+          &removeSingleValue<TAccumulator>,
+          &updateDuplicateValues<TAccumulator>,
+          false,
+          TAccumulator(0));
+    }
+  }
+
+  bool supportsColumnarInput() const override {
+    return std::is_arithmetic_v<TAccumulator>;
+  }
+
+  void addRawInputColumnar(
+      const uint64_t* ordinals,
+      int32_t numOrdinals,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (std::is_arithmetic_v<TAccumulator>) {
+      BaseAggregate::updateColumnar(
+          ordinals,
+          numOrdinals,
+          rows,
+          args[0].get(),
+          TAccumulator(0),
+          &updateSingleValue<TAccumulator>);
+    } else {
+      exec::Aggregate::addRawInputColumnar(ordinals, numOrdinals, rows, args);
+    }
+  }
+
+  void flushColumnar(char* const* groups) override {
+    if constexpr (std::is_arithmetic_v<TAccumulator>) {
+      BaseAggregate::flushColumnarValues(
+          groups, TAccumulator(0), &updateSingleValue<TAccumulator>);
+    }
+  }
+
  protected:
   // TData is used to store the updated sum state. It can be either
   // TAccumulator or TResult, which in most cases are the same, but for
@@ -155,6 +213,16 @@ class SumAggregate
     }
   }
 
+  template <typename TData>
+  static void removeSingleValue(TData& result, TData value) {
+    if constexpr (
+        std::is_same_v<TData, double> || std::is_same_v<TData, float>) {
+      result -= value;
+    } else {
+      result = functions::checkedMinus<TData>(result, value);
+    }
+  }
+
   template <typename TData>
   static void updateDuplicateValues(TData& result, TData value, int n) {
     if constexpr (
@@ -98,6 +98,57 @@ void ValueList::appendRange(
   }
 }
 
+void ValueList::serialize(char* out) const {
+  const uint32_t header[] = {size_, static_cast<uint32_t>(dataBytes())};
+  memcpy(out, header, sizeof(header));
+  out += sizeof(header);
+  if (size_ == 0) {
+    return;
+  }
+  const auto numNullsBytes = (bits::nwords(size_) - 1) * sizeof(uint64_t);
+  ByteStream nullsStream;
+  HashStringAllocator::prepareRead(nullsBegin_, nullsStream);
+  nullsStream.readBytes(out, numNullsBytes);
+  out += numNullsBytes;
+  memcpy(out, &lastNulls_, sizeof(uint64_t));
+  out += sizeof(uint64_t);
+  ByteStream dataStream;
+  HashStringAllocator::prepareRead(dataBegin_, dataStream);
+  dataStream.readBytes(out, header[1]);
+}
+
+const char* ValueList::appendSerialized(
+    const char* data,
+    HashStringAllocator* allocator) {
+  uint32_t header[2];
+  memcpy(header, data, sizeof(header));
+  data += sizeof(header);
+  const auto numValues = header[0];
+  const auto numBytes = header[1];
+  if (numValues == 0) {
+    return data;
+  }
+  auto nulls = reinterpret_cast<const uint8_t*>(data);
+  for (auto i = 0; i < numValues; ++i) {
+    prepareAppend(allocator);
+    if (bits::isBitSet(nulls, i)) {
+      lastNulls_ |= 1UL << (size_ % 64);
+    }
+    ++size_;
+  }
+  data += bits::nwords(numValues) * sizeof(uint64_t);
+
+  // The serialized values are self-delimiting and are appended as is.
+  if (numBytes > 0) {
+    ByteStream stream(allocator);
+    allocator->extendWrite(dataCurrent_, stream);
+    stream.appendStringPiece(folly::StringPiece(data, numBytes));
+    totalBytes_ += numBytes;
+    dataCurrent_ = allocator->finishWrite(stream, kInitialSize);
+  }
+  return data + numBytes;
+}
+
 ValueListReader::ValueListReader(ValueList& values)
     : size_{values.size()},
       lastNullsStart_{size_ % 64 == 0 ? size_ - 64 : size_ - size_ % 64},
@@ -43,6 +43,23 @@ class ValueList {
     return size_;
   }
 
+  // Returns the number of bytes written by serialize().
+  int32_t serializedSize() const {
+    return 2 * sizeof(uint32_t) + bits::nwords(size_) * sizeof(uint64_t) +
+        dataBytes();
+  }
+
+  // Writes the number of values, the null flags and the serialized non-null
+  // values to 'out', which has serializedSize() bytes. This is used to spill
+  // the list without reading the values into a vector.
+  void serialize(char* out) const;
+
+  // Appends the values of a list written by serialize() at 'data'. Returns the
+  // first byte after the serialized list.
+  const char* appendSerialized(
+      const char* data,
+      HashStringAllocator* allocator);
+
   // Called after 'finalize()' to get access to 'data' allocation.
   HashStringAllocator::Header* dataBegin() {
     return dataBegin_;
@@ -81,6 +98,12 @@ class ValueList {
 
   void prepareAppend(HashStringAllocator* allocator);
 
+  // Bytes of serialized non-null values. 'totalBytes_' also counts the null
+  // words except 'lastNulls_'.
+  uint64_t dataBytes() const {
+    return size_ == 0 ? 0 : totalBytes_ - sizeof(uint64_t) * ((size_ - 1) / 64);
+  }
+
   // Writes lastNulls_ word to the 'nulls' block.
   void writeLastNulls(HashStringAllocator* allocator);
 
@@ -102,6 +125,22 @@ class ValueList {
   uint64_t lastNulls_{0};
 };
 
+// Sets the value at 'index' of 'result' to 'size' bytes written by
+// 'serialize(char*)' into the string buffers of 'result'. Used for spilling
+// accumulators that consist of ValueLists.
+template <typename Serialize>
+void setSerialized(
+    FlatVector<StringView>& result,
+    vector_size_t index,
+    int32_t size,
+    Serialize serialize) {
+  Buffer* buffer = result.getBufferWithSpace(size);
+  auto data = buffer->asMutable<char>() + buffer->size();
+  serialize(data);
+  buffer->setSize(buffer->size() + size);
+  result.setNoCopy(index, StringView(data, size));
+}
+
 // Extracts values from the ValueList into provided vector.
 class ValueListReader {
  public:
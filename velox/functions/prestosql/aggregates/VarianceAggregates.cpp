@@ -57,6 +57,20 @@ struct VarianceAccumulator {
     m2_ += delta * (value - mean());
   }
 
+  // Reverts update() for a 'value' which was previously added.
+  void remove(double value) {
+    if (count_ == 1) {
+      count_ = 0;
+      mean_ = 0;
+      m2_ = 0;
+      return;
+    }
+    double delta = value - mean();
+    count_ -= 1;
+    mean_ -= delta / count();
+    m2_ -= delta * (value - mean());
+  }
+
   inline void merge(const VarianceAccumulator& other) {
     merge(other.count(), other.mean(), other.m2());
   }
@@ -342,6 +356,34 @@ class VarianceAggregate : public exec::Aggregate {
     }
   }
 
+  bool supportsRemoveRawInput() const override {
+    return true;
+  }
+
+  void removeSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    decodedRaw_.decode(*args[0], rows);
+    VarianceAccumulator* accData = accumulator(group);
+    if (decodedRaw_.isConstantMapping()) {
+      if (!decodedRaw_.isNullAt(0)) {
+        const double value = decodedRaw_.valueAt<T>(0);
+        rows.applyToSelected(
+            [&](vector_size_t /*i*/) { accData->remove(value); });
+      }
+    } else if (decodedRaw_.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decodedRaw_.isNullAt(i)) {
+          accData->remove(decodedRaw_.valueAt<T>(i));
+        }
+      });
+    } else {
+      rows.applyToSelected(
+          [&](vector_size_t i) { accData->remove(decodedRaw_.valueAt<T>(i)); });
+    }
+  }
+
   void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     auto vector = (*result)->as<FlatVector<double>>();
@@ -360,5 +360,29 @@ TEST_F(ArbitraryTest, interval) {
   testAggregations({data}, {}, {"arbitrary(c2)"}, "SELECT null");
 }
 
+TEST_F(ArbitraryTest, shortAndLongStrings) {
+  // Strings of up to 12 bytes are kept inline in the accumulator, longer ones
+  // are copied into the HashStringAllocator. All rows of a group have the same
+  // value so that the result does not depend on the order of the input.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 10; ++i) {
+    strings.push_back(std::string(i * 3, 'a' + i));
+  }
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 10; }),
+      makeFlatVector<StringView>(
+          1'000,
+          [&](auto row) { return StringView(strings[row % 10]); },
+          [](auto row) { return row < 100 && row % 3 == 0; }),
+  });
+
+  std::vector<RowVectorPtr> expected = {makeRowVector({
+      makeFlatVector<int32_t>(10, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          10, [&](auto row) { return StringView(strings[row]); }),
+  })};
+  testAggregations({data}, {"c0"}, {"arbitrary(c1)"}, expected);
+}
+
 } // namespace
 } // namespace facebook::velox::aggregate::test
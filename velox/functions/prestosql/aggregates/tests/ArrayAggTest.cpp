@@ -60,6 +60,32 @@ TEST_F(ArrayAggTest, groupBy) {
       "SELECT c0, array_agg(a) FROM tmp GROUP BY c0");
 }
 
+// Groups of more than 64 values with nulls span multiple null words of the
+// spilled ValueLists.
+TEST_F(ArrayAggTest, groupByLargeGroups) {
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 20; ++i) {
+    strings.push_back(std::string(i, 'a' + i));
+  }
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 4; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int32_t>(100, [](auto row) { return row % 3; }),
+        makeFlatVector<StringView>(
+            100,
+            [&](auto row) { return StringView(strings[(row + i) % 20]); },
+            nullEvery(7)),
+    }));
+  }
+
+  createDuckDbTable(batches);
+  testAggregations(
+      batches,
+      {"c0"},
+      {"array_agg(c1)"},
+      "SELECT c0, array_agg(c1) FROM tmp GROUP BY c0");
+}
+
 TEST_F(ArrayAggTest, global) {
   vector_size_t size = 10;
 
@@ -972,5 +972,50 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
     MinMaxByGroupByAggregationTest,
     testing::ValuesIn(getTestParams()));
 
+class MinMaxByVarcharTest : public AggregationTestBase {};
+
+TEST_F(MinMaxByVarcharTest, shortAndLongStrings) {
+  // Values and comparison values alternate between strings kept inline in the
+  // accumulator and longer ones, so that the accumulators go back and forth
+  // between inline and allocated storage and reuse or grow their allocations.
+  const int32_t size = 3'000;
+  std::vector<std::string> values(size);
+  std::vector<std::string> comparisons(size);
+  for (auto i = 0; i < size; ++i) {
+    values[i] = fmt::format("{}-{}", std::string(i % 37, 'v'), i);
+    comparisons[i] =
+        fmt::format("{}{:05}", std::string((i * 7) % 23, 'c'), (i * 13) % size);
+  }
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 11; }),
+      makeFlatVector<StringView>(
+          size, [&](auto row) { return StringView(values[row]); }),
+      makeFlatVector<StringView>(
+          size, [&](auto row) { return StringView(comparisons[row]); }),
+  });
+
+  std::vector<int32_t> minRows(11, -1);
+  std::vector<int32_t> maxRows(11, -1);
+  for (auto i = 0; i < size; ++i) {
+    auto& minRow = minRows[i % 11];
+    auto& maxRow = maxRows[i % 11];
+    if (minRow < 0 || comparisons[i] < comparisons[minRow]) {
+      minRow = i;
+    }
+    if (maxRow < 0 || comparisons[i] > comparisons[maxRow]) {
+      maxRow = i;
+    }
+  }
+  std::vector<RowVectorPtr> expected = {makeRowVector({
+      makeFlatVector<int32_t>(11, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          11, [&](auto row) { return StringView(values[minRows[row]]); }),
+      makeFlatVector<StringView>(
+          11, [&](auto row) { return StringView(values[maxRows[row]]); }),
+  })};
+  testAggregations(
+      {data}, {"c0"}, {"min_by(c1, c2)", "max_by(c1, c2)"}, expected);
+}
+
 } // namespace
 } // namespace facebook::velox::aggregate::test
@@ -218,6 +218,32 @@ TEST_F(MinMaxTest, minMaxDate) {
       "SELECT c0 % 17, min(c1), max(c1) FROM tmp GROUP BY 1");
 }
 
+TEST_F(MinMaxTest, globalVectorized) {
+  // Flat inputs are reduced 64 rows at a time where all rows are selected
+  // and not null. The dictionary over 10 values is reduced over the
+  // referenced values.
+  const vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            size, [&](auto row) { return (row * 7919 + i) % 1'001 - 500; }),
+        makeFlatVector<int8_t>(
+            size, [&](auto row) { return row * 13 + i; }, nullEvery(7)),
+        wrapInDictionary(
+            makeIndices(size, [](auto row) { return row % 5 + 2; }),
+            size,
+            makeFlatVector<int32_t>(10, [&](auto row) { return row * i; }))}));
+  }
+  createDuckDbTable(vectors);
+
+  testAggregations(
+      vectors,
+      {},
+      {"min(c0)", "max(c0)", "min(c1)", "max(c1)", "min(c2)", "max(c2)"},
+      "SELECT min(c0), max(c0), min(c1), max(c1), min(c2), max(c2) FROM tmp");
+}
+
 TEST_F(MinMaxTest, initialValue) {
   // Ensures that no groups are default initialized (to 0) in
   // aggregate::SimpleNumericAggregate.
@@ -411,6 +411,65 @@ TEST_F(SumTest, nulls) {
       "SELECT c0, sum(c1) as sum_c1 FROM tmp GROUP BY 1");
 }
 
+TEST_F(SumTest, globalVectorized) {
+  // Flat inputs with and without nulls are summed 64 rows at a time. The
+  // dictionary over 10 values is summed once per distinct index.
+  const vector_size_t size = 10'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    auto base = makeFlatVector<int64_t>(10, [&](auto row) { return row * i; });
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(size, [](auto row) { return row - 3'000; }),
+        makeFlatVector<int64_t>(
+            size, [&](auto row) { return row * 1'000 + i; }, nullEvery(97)),
+        makeFlatVector<double>(
+            size, [](auto row) { return row * 0.5; }, nullEvery(5)),
+        makeFlatVector<int16_t>(
+            size, [](auto row) { return row % 300; }, nullEvery(3)),
+        wrapInDictionary(
+            makeIndices(size, [](auto row) { return (row * 7) % 10; }),
+            size,
+            base),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  testAggregations(
+      vectors,
+      {},
+      {"sum(c0)", "sum(c1)", "sum(c2)", "sum(c3)", "sum(c4)", "count(c1)"},
+      "SELECT sum(c0), sum(c1), sum(c2), sum(c3), sum(c4), count(c1) FROM tmp");
+
+  // Filtered rows are not contiguous.
+  testAggregations(
+      [&](auto& builder) { builder.values(vectors).filter("c0 % 3 <> 0"); },
+      {},
+      {"sum(c0)", "sum(c1)", "sum(c2)", "sum(c3)", "count(c3)"},
+      "SELECT sum(c0), sum(c1), sum(c2), sum(c3), count(c3) FROM tmp "
+      "WHERE c0 % 3 <> 0");
+
+  // An overflow of a SIMD lane is detected and the sum is redone with
+  // checked arithmetic.
+  auto data = makeRowVector({makeFlatVector<int64_t>(
+      1'000,
+      [](auto /*row*/) { return std::numeric_limits<int64_t>::max(); })});
+  VELOX_ASSERT_THROW(
+      readSingleValue(PlanBuilder()
+                          .values({data})
+                          .singleAggregation({}, {"sum(c0)"})
+                          .planNode()),
+      "overflow");
+  data = makeRowVector({makeFlatVector<int64_t>(1'000, [](auto row) {
+    return row % 2 == 0 ? std::numeric_limits<int64_t>::max() : -1'000;
+  })});
+  VELOX_ASSERT_THROW(
+      readSingleValue(PlanBuilder()
+                          .values({data})
+                          .singleAggregation({}, {"sum(c0)"})
+                          .planNode()),
+      "overflow");
+}
+
 template <typename Type>
 struct SumRow {
   char nulls;
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+namespace {
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+constexpr vector_size_t kVectorSize = 10'000;
+
+class DecimalArithmeticBenchmark
+    : public functions::test::FunctionBenchmarkBase {
+ public:
+  DecimalArithmeticBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerArithmeticFunctions();
+
+    std::vector<int64_t> shortValues(kVectorSize);
+    std::vector<int128_t> longValues(kVectorSize);
+    std::vector<double> doubleValues(kVectorSize);
+    for (auto i = 0; i < kVectorSize; ++i) {
+      shortValues[i] = (i * 7'919) % 1'000'000 - 500'000;
+      longValues[i] = static_cast<int128_t>(shortValues[i]) * 1'000'000'000;
+      doubleValues[i] = shortValues[i] / 100.0;
+    }
+    rowVector_ = vectorMaker_.rowVector({
+        vectorMaker_.shortDecimalFlatVector(shortValues, DECIMAL(9, 2)),
+        vectorMaker_.shortDecimalFlatVector(shortValues, DECIMAL(9, 2)),
+        vectorMaker_.shortDecimalFlatVector(shortValues, DECIMAL(10, 4)),
+        vectorMaker_.longDecimalFlatVector(longValues, DECIMAL(30, 2)),
+        vectorMaker_.longDecimalFlatVector(longValues, DECIMAL(30, 2)),
+        vectorMaker_.flatVector(doubleValues),
+        vectorMaker_.flatVector(doubleValues),
+    });
+  }
+
+  size_t run(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    auto exprSet = compileExpression(expression, rowVector_->type());
+    suspender.dismiss();
+
+    size_t count = 0;
+    for (auto i = 0; i < 100; ++i) {
+      count += evaluate(exprSet, rowVector_)->size();
+    }
+    return count;
+  }
+
+ private:
+  RowVectorPtr rowVector_;
+};
+
+std::unique_ptr<DecimalArithmeticBenchmark> benchmark;
+
+BENCHMARK_MULTI(doubleAdd) {
+  return benchmark->run("c5 + c6");
+}
+
+BENCHMARK_RELATIVE_MULTI(shortDecimalAdd) {
+  return benchmark->run("c0 + c1");
+}
+
+BENCHMARK_RELATIVE_MULTI(shortDecimalAddRescale) {
+  return benchmark->run("c0 + c2");
+}
+
+BENCHMARK_RELATIVE_MULTI(shortDecimalSubtract) {
+  return benchmark->run("c0 - c1");
+}
+
+BENCHMARK_RELATIVE_MULTI(shortDecimalMultiply) {
+  return benchmark->run("c0 * c1");
+}
+
+BENCHMARK_RELATIVE_MULTI(longDecimalAdd) {
+  return benchmark->run("c3 + c4");
+}
+
+BENCHMARK_RELATIVE_MULTI(longDecimalAddShort) {
+  return benchmark->run("c3 + c0");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<DecimalArithmeticBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
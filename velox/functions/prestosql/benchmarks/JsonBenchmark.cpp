@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+
+#include "velox/functions/Macros.h"
+#include "velox/functions/Registerer.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/json/JsonExtractor.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/functions/prestosql/types/JsonType.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::functions;
+
+namespace {
+
+// json_extract_scalar that parses the whole document into a folly::dynamic
+// before walking the path.
+template <typename T>
+struct FollyJsonExtractScalarFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      out_type<Varchar>& result,
+      const arg_type<Json>& json,
+      const arg_type<Varchar>& jsonPath) {
+    folly::Optional<folly::dynamic> value;
+    try {
+      value = jsonExtract(folly::parseJson(json), jsonPath);
+    } catch (const folly::json::parse_error&) {
+      return false;
+    }
+    if (!value.has_value() || value->isObject() || value->isArray() ||
+        value->isNull()) {
+      return false;
+    }
+    UDFOutputString::assign(
+        result,
+        value->isBool() ? (value->asBool() ? "true" : "false")
+                        : value->asString());
+    return true;
+  }
+};
+
+// json_size that parses the whole document into a folly::dynamic before
+// walking the path.
+template <typename T>
+struct FollyJsonSizeFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      int64_t& result,
+      const arg_type<Json>& json,
+      const arg_type<Varchar>& jsonPath) {
+    folly::Optional<folly::dynamic> value;
+    try {
+      value = jsonExtract(folly::parseJson(json), jsonPath);
+    } catch (const folly::json::parse_error&) {
+      return false;
+    }
+    if (!value.has_value()) {
+      return false;
+    }
+    result = value->isArray() || value->isObject() ? value->size() : 0;
+    return true;
+  }
+};
+
+class JsonBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  JsonBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerJsonFunctions();
+    registerFunction<FollyJsonExtractScalarFunction, Varchar, Json, Varchar>(
+        {"folly_json_extract_scalar"});
+    registerFunction<FollyJsonSizeFunction, int64_t, Json, Varchar>(
+        {"folly_json_size"});
+  }
+
+  // Evaluates 'fnName' on event-like documents with a few dozen fields.
+  void run(const std::string& fnName, const std::string& path) {
+    folly::BenchmarkSuspender suspender;
+
+    std::vector<std::string> events;
+    for (auto row = 0; row < 1'000; ++row) {
+      auto event = fmt::format(
+          "{{\"id\": {}, \"type\": \"click\", \"user\": {{\"name\": "
+          "\"user{}\", \"tags\": [\"a\", \"b\", \"c\"]}}",
+          row,
+          row % 100);
+      for (auto i = 0; i < 30; ++i) {
+        event += fmt::format(
+            ", \"field{}\": {{\"value\": {}, \"label\": \"label {}\"}}",
+            i,
+            row * i,
+            i);
+      }
+      events.push_back(
+          event + ", \"session\": {\"id\": \"s1\", \"length\": 12.5}}");
+    }
+    auto rowVector = vectorMaker_.rowVector({vectorMaker_.flatVector(events)});
+    auto exprSet = compileExpression(
+        fmt::format("{}(c0, '{}')", fnName, path), rowVector->type());
+
+    suspender.dismiss();
+
+    uint32_t cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      cnt += evaluate(exprSet, rowVector)->size();
+    }
+    folly::doNotOptimizeAway(cnt);
+  }
+};
+
+BENCHMARK(folly_json_extract_scalar_first) {
+  JsonBenchmark benchmark;
+  benchmark.run("folly_json_extract_scalar", "$.type");
+}
+
+BENCHMARK_RELATIVE(velox_json_extract_scalar_first) {
+  JsonBenchmark benchmark;
+  benchmark.run("json_extract_scalar", "$.type");
+}
+
+BENCHMARK(folly_json_extract_scalar_last) {
+  JsonBenchmark benchmark;
+  benchmark.run("folly_json_extract_scalar", "$.session.length");
+}
+
+BENCHMARK_RELATIVE(velox_json_extract_scalar_last) {
+  JsonBenchmark benchmark;
+  benchmark.run("json_extract_scalar", "$.session.length");
+}
+
+BENCHMARK(folly_json_size) {
+  JsonBenchmark benchmark;
+  benchmark.run("folly_json_size", "$.user.tags");
+}
+
+BENCHMARK_RELATIVE(velox_json_size) {
+  JsonBenchmark benchmark;
+  benchmark.run("json_size", "$.user.tags");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  folly::runBenchmarks();
+  return 0;
+}
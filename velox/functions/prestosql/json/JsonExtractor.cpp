@@ -32,6 +32,328 @@ namespace {
 
 using JsonVector = std::vector<const folly::dynamic*>;
 
+// Finds the value at a path in a JSON document without parsing the document
+// into a folly::dynamic and without allocating. Accepts a subset of the
+// documents accepted by folly::parseJson and gives up on the others, e.g. on
+// escaped keys on the path, escaped surrogates, leading zeros, integers that
+// may not fit in 64 bits or deep nesting. The value found in a document
+// that is accepted is the value folly::parseJson would give, including the last
+// value for repeated keys.
+class JsonPathScanner {
+ public:
+  enum class Result { kFound, kNotFound, kUnsupported };
+
+  // The token at a path level is never an array index.
+  static constexpr int32_t kNoIndex = -1;
+  // The token may be converted to an array index in ways the scanner does not
+  // reproduce.
+  static constexpr int32_t kUnsupportedIndex = -2;
+
+  // 'indices' has the array index for each of 'tokens' or one of the above.
+  JsonPathScanner(
+      const std::vector<std::string>& tokens,
+      const std::vector<int32_t>& indices)
+      : tokens_(tokens), numTokens_(tokens.size()), indices_(indices) {}
+
+  // Sets 'value' to the bytes of the value at the path in 'json' if the
+  // result is kFound.
+  Result scan(folly::StringPiece json, folly::StringPiece& value) {
+    pos_ = json.begin();
+    end_ = json.end();
+    skipWhitespace();
+    if (!scanValue(0)) {
+      return Result::kUnsupported;
+    }
+    skipWhitespace();
+    if (pos_ != end_) {
+      return Result::kUnsupported;
+    }
+    if (!found_) {
+      return Result::kNotFound;
+    }
+    value = value_;
+    return Result::kFound;
+  }
+
+ private:
+  // Nesting of objects and arrays beyond which the scanner gives up. Below
+  // the recursion limit of folly::parseJson.
+  static constexpr int32_t kMaxNesting = 64;
+
+  // 'level' is the number of path tokens that match the value at 'pos_' or
+  // kOffPath.
+  static constexpr int32_t kOffPath = -1;
+
+  // Moves past the value at 'pos_'. Returns false if the value is not
+  // accepted.
+  bool scanValue(int32_t level) {
+    if (pos_ == end_) {
+      return false;
+    }
+    const char* start = pos_;
+    bool ok;
+    switch (*pos_) {
+      case '{':
+        ok = scanObject(level);
+        break;
+      case '[':
+        ok = scanArray(level);
+        break;
+      case '"': {
+        folly::StringPiece content;
+        bool hasEscapes;
+        ok = scanString(content, hasEscapes);
+        break;
+      }
+      case 't':
+        ok = scanLiteral("true");
+        break;
+      case 'f':
+        ok = scanLiteral("false");
+        break;
+      case 'n':
+        ok = scanLiteral("null");
+        break;
+      default:
+        ok = scanNumber();
+    }
+    if (ok && level == numTokens_) {
+      found_ = true;
+      value_ = folly::StringPiece(start, pos_);
+    }
+    return ok;
+  }
+
+  bool scanObject(int32_t level) {
+    if (++nesting_ > kMaxNesting) {
+      return false;
+    }
+    const bool onPath = level != kOffPath && level < numTokens_;
+    ++pos_;
+    skipWhitespace();
+    if (pos_ < end_ && *pos_ == '}') {
+      ++pos_;
+      --nesting_;
+      return true;
+    }
+    while (true) {
+      folly::StringPiece key;
+      bool hasEscapes;
+      if (pos_ == end_ || *pos_ != '"' || !scanString(key, hasEscapes)) {
+        return false;
+      }
+      int32_t memberLevel = kOffPath;
+      if (onPath) {
+        if (hasEscapes) {
+          return false;
+        }
+        if (key == tokens_[level]) {
+          // A repeated key replaces the value found under the earlier one.
+          found_ = false;
+          memberLevel = level + 1;
+        }
+      }
+      skipWhitespace();
+      if (pos_ == end_ || *pos_ != ':') {
+        return false;
+      }
+      ++pos_;
+      skipWhitespace();
+      if (!scanValue(memberLevel)) {
+        return false;
+      }
+      skipWhitespace();
+      if (pos_ == end_) {
+        return false;
+      }
+      if (*pos_ == '}') {
+        ++pos_;
+        --nesting_;
+        return true;
+      }
+      if (*pos_ != ',') {
+        return false;
+      }
+      ++pos_;
+      skipWhitespace();
+    }
+  }
+
+  bool scanArray(int32_t level) {
+    if (++nesting_ > kMaxNesting) {
+      return false;
+    }
+    int32_t index = kNoIndex;
+    if (level != kOffPath && level < numTokens_) {
+      index = indices_[level];
+      if (index == kUnsupportedIndex) {
+        return false;
+      }
+    }
+    ++pos_;
+    skipWhitespace();
+    if (pos_ < end_ && *pos_ == ']') {
+      ++pos_;
+      --nesting_;
+      return true;
+    }
+    for (int32_t i = 0;; ++i) {
+      if (!scanValue(i == index ? level + 1 : kOffPath)) {
+        return false;
+      }
+      skipWhitespace();
+      if (pos_ == end_) {
+        return false;
+      }
+      if (*pos_ == ']') {
+        ++pos_;
+        --nesting_;
+        return true;
+      }
+      if (*pos_ != ',') {
+        return false;
+      }
+      ++pos_;
+      skipWhitespace();
+    }
+  }
+
+  // Moves past the string starting with the quote at 'pos_'. Sets 'content'
+  // to the bytes between the quotes and 'hasEscapes' to whether any of these
+  // are escaped.
+  bool scanString(folly::StringPiece& content, bool& hasEscapes) {
+    const char* start = ++pos_;
+    hasEscapes = false;
+    for (; pos_ < end_; ++pos_) {
+      const auto c = static_cast<uint8_t>(*pos_);
+      if (c == '"') {
+        content = folly::StringPiece(start, pos_);
+        ++pos_;
+        return true;
+      }
+      if (c < 0x20) {
+        return false;
+      }
+      if (c != '\\') {
+        continue;
+      }
+      hasEscapes = true;
+      if (++pos_ == end_) {
+        return false;
+      }
+      switch (*pos_) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          break;
+        case 'u':
+          if (end_ - pos_ < 5 || !isHexDigit(pos_[1]) ||
+              !isHexDigit(pos_[2]) || !isHexDigit(pos_[3]) ||
+              !isHexDigit(pos_[4])) {
+            return false;
+          }
+          // Surrogates are left to folly::parseJson, which checks the pairs.
+          if ((pos_[1] == 'd' || pos_[1] == 'D') &&
+              (pos_[2] < '0' || pos_[2] > '7')) {
+            return false;
+          }
+          pos_ += 4;
+          break;
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  bool scanNumber() {
+    const char* start = pos_;
+    if (pos_ < end_ && *pos_ == '-') {
+      ++pos_;
+    }
+    if (pos_ == end_ || !isDigit(*pos_)) {
+      return false;
+    }
+    if (*pos_ == '0') {
+      ++pos_;
+      if (pos_ < end_ && isDigit(*pos_)) {
+        return false;
+      }
+    } else {
+      skipDigits();
+    }
+    bool integral = true;
+    if (pos_ < end_ && *pos_ == '.') {
+      integral = false;
+      ++pos_;
+      if (skipDigits() == 0) {
+        return false;
+      }
+    }
+    if (pos_ < end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+      integral = false;
+      ++pos_;
+      if (pos_ < end_ && (*pos_ == '+' || *pos_ == '-')) {
+        ++pos_;
+      }
+      // Large exponents may overflow.
+      const auto numDigits = skipDigits();
+      if (numDigits == 0 || numDigits > 2) {
+        return false;
+      }
+    }
+    // Integers that do not fit in 64 bits fail to convert in folly.
+    return !integral || pos_ - start <= 18;
+  }
+
+  int32_t skipDigits() {
+    const char* start = pos_;
+    while (pos_ < end_ && isDigit(*pos_)) {
+      ++pos_;
+    }
+    return pos_ - start;
+  }
+
+  bool scanLiteral(folly::StringPiece literal) {
+    if (end_ - pos_ < literal.size() ||
+        memcmp(pos_, literal.data(), literal.size()) != 0) {
+      return false;
+    }
+    pos_ += literal.size();
+    return true;
+  }
+
+  void skipWhitespace() {
+    while (pos_ < end_ &&
+           (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\t' ||
+            *pos_ == '\r')) {
+      ++pos_;
+    }
+  }
+
+  static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  static bool isHexDigit(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+  }
+
+  const std::vector<std::string>& tokens_;
+  const int32_t numTokens_;
+  const std::vector<int32_t>& indices_;
+  const char* pos_;
+  const char* end_;
+  int32_t nesting_{0};
+  bool found_{false};
+  folly::StringPiece value_;
+};
+
 class JsonExtractor {
  public:
   // Use this method to get an instance of JsonExtractor given a json path.
@@ -55,14 +377,57 @@ class JsonExtractor {
 
   folly::Optional<folly::dynamic> extract(const folly::dynamic& json);
 
+  // Scans 'json' for the value at the path and parses only that value, unless
+  // the path has a wildcard or the scanner gives up, in which case the whole
+  // document is parsed.
+  folly::Optional<folly::dynamic> extract(folly::StringPiece json);
+
+  // Returns the scalar value at the path as a string. Strings without escapes
+  // and booleans are returned without parsing.
+  folly::Optional<std::string> extractScalar(folly::StringPiece json);
+
   // Shouldn't instantiate directly - use getInstance().
   explicit JsonExtractor(const std::string& path) {
     if (!tokenize(path)) {
       VELOX_USER_FAIL("Invalid JSON path: {}", path);
     }
+    for (const auto& token : tokens_) {
+      hasWildcard_ |= token == "*";
+      indices_.push_back(toIndex(token));
+    }
   }
 
  private:
+  // Returns the index of the array element 'token' selects. The extraction
+  // from a folly::dynamic converts the token with folly::tryTo<int32_t>,
+  // which fails if the token has other characters than digits, signs and
+  // whitespace.
+  static int32_t toIndex(const std::string& token) {
+    bool allDigits = true;
+    for (const unsigned char c : token) {
+      if (std::isdigit(c)) {
+        continue;
+      }
+      if (c != '+' && c != '-' && !std::isspace(c)) {
+        return JsonPathScanner::kNoIndex;
+      }
+      allDigits = false;
+    }
+    if (allDigits && token.size() <= 9) {
+      return folly::to<int32_t>(token);
+    }
+    return JsonPathScanner::kUnsupportedIndex;
+  }
+
+  JsonPathScanner::Result scan(
+      folly::StringPiece json,
+      folly::StringPiece& value) const {
+    if (hasWildcard_) {
+      return JsonPathScanner::Result::kUnsupported;
+    }
+    return JsonPathScanner(tokens_, indices_).scan(json, value);
+  }
+
   bool tokenize(const std::string& path) {
     if (path.empty()) {
       return false;
@@ -93,6 +458,14 @@ class JsonExtractor {
   static const uint32_t kMaxCacheNum{32};
 
   std::vector<std::string> tokens_;
+
+  // The array index for each of 'tokens_' or JsonPathScanner::kNoIndex or
+  // kUnsupportedIndex.
+  std::vector<int32_t> indices_;
+
+  // True if a token is '*'. Wildcards may select many values, which the
+  // scanner does not do.
+  bool hasWildcard_{false};
 };
 
 thread_local std::unordered_map<std::string, std::shared_ptr<JsonExtractor>>
@@ -171,6 +544,64 @@ bool isScalarType(const folly::Optional<folly::dynamic>& json) {
       !json->isNull();
 }
 
+folly::Optional<std::string> toScalarString(
+    const folly::Optional<folly::dynamic>& json) {
+  // Not a scalar value
+  if (isScalarType(json)) {
+    if (json->isBool()) {
+      return json->asBool() ? std::string{"true"} : std::string{"false"};
+    } else {
+      return json->asString();
+    }
+  }
+  return folly::none;
+}
+
+folly::Optional<folly::dynamic> JsonExtractor::extract(
+    folly::StringPiece json) {
+  folly::StringPiece value;
+  switch (scan(json, value)) {
+    case JsonPathScanner::Result::kFound:
+      return folly::parseJson(value);
+    case JsonPathScanner::Result::kNotFound:
+      return folly::none;
+    case JsonPathScanner::Result::kUnsupported:
+      break;
+  }
+  return extract(folly::parseJson(json));
+}
+
+folly::Optional<std::string> JsonExtractor::extractScalar(
+    folly::StringPiece json) {
+  folly::StringPiece value;
+  switch (scan(json, value)) {
+    case JsonPathScanner::Result::kFound:
+      break;
+    case JsonPathScanner::Result::kNotFound:
+      return folly::none;
+    case JsonPathScanner::Result::kUnsupported:
+      return toScalarString(extract(folly::parseJson(json)));
+  }
+  switch (value.front()) {
+    case '{':
+    case '[':
+    case 'n':
+      return folly::none;
+    case 't':
+      return std::string{"true"};
+    case 'f':
+      return std::string{"false"};
+    case '"':
+      if (value.find('\\') == folly::StringPiece::npos) {
+        return value.subpiece(1, value.size() - 2).str();
+      }
+      break;
+    default:
+      break;
+  }
+  return toScalarString(folly::parseJson(value));
+}
+
 } // namespace
 
 folly::Optional<folly::dynamic> jsonExtract(
@@ -182,7 +613,7 @@ folly::Optional<folly::dynamic> jsonExtract(
     // json parsing failures (in which cases we return folly::none instead of
     // throw).
     auto& extractor = JsonExtractor::getInstance(path);
-    return extractor.extract(folly::parseJson(json));
+    return extractor.extract(json);
   } catch (const folly::json::parse_error&) {
   } catch (const folly::ConversionError&) {
     // Folly might throw a conversion error while parsing the input json. In
@@ -210,14 +641,12 @@ folly::Optional<folly::dynamic> jsonExtract(
 folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path) {
-  auto res = jsonExtract(json, path);
-  // Not a scalar value
-  if (isScalarType(res)) {
-    if (res->isBool()) {
-      return res->asBool() ? std::string{"true"} : std::string{"false"};
-    } else {
-      return res->asString();
-    }
+  try {
+    // Path errors are raised as in jsonExtract().
+    auto& extractor = JsonExtractor::getInstance(path);
+    return extractor.extractScalar(json);
+  } catch (const folly::json::parse_error&) {
+  } catch (const folly::ConversionError&) {
   }
   return folly::none;
 }
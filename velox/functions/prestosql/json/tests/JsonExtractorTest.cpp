@@ -501,3 +501,97 @@ TEST(JsonExtractorTest, jsonMultipleExtractsTest) {
   ASSERT_TRUE(extract2.hasValue());
   EXPECT_EQ(jsonExtract(json, "$.store.fruit").value(), extract2.value());
 }
+
+// Documents are scanned for the value at the path unless they are invalid or
+// have structures the scanner leaves to folly::parseJson. Either way, the
+// result must be the one of the parsed document.
+TEST(JsonExtractorTest, scanMatchesParsedDocument) {
+  auto expectSameAsParsed = [](const std::string& json,
+                               const std::string& path) {
+    SCOPED_TRACE(json + " " + path);
+    folly::Optional<folly::dynamic> expected;
+    try {
+      expected = jsonExtract(folly::parseJson(json), path);
+    } catch (const parse_error&) {
+    } catch (const folly::ConversionError&) {
+    }
+    EXPECT_EQ(json_format(expected), json_format(jsonExtract(json, path)));
+
+    folly::Optional<std::string> expectedScalar;
+    if (expected.has_value() && !expected->isObject() &&
+        !expected->isArray() && !expected->isNull()) {
+      expectedScalar = expected->isBool()
+          ? std::string(expected->asBool() ? "true" : "false")
+          : expected->asString();
+    }
+    EXPECT_EQ(expectedScalar, jsonExtractScalar(json, path));
+  };
+
+  std::string json = R"DELIM(
+      {"a": 1, "b": {"c": [10, 20.5, {"d": "x"}, true, null]}, "e": "f"})DELIM";
+  for (const auto& path :
+       {"$",
+        "$.a",
+        "$.b",
+        "$.b.c",
+        "$.b.c[0]",
+        "$.b.c[1]",
+        "$.b.c[2].d",
+        "$.b.c[3]",
+        "$.b.c[4]",
+        "$.b.c[5]",
+        "$[\"b\"][\"c\"][01]",
+        "$.b.x",
+        "$.a.b",
+        "$.e",
+        "$.e[0]",
+        "$.b.c[*]"}) {
+    expectSameAsParsed(json, path);
+  }
+
+  // Repeated keys keep the last value.
+  expectSameAsParsed("{\"a\": {\"b\": 1}, \"a\": {\"c\": 2}}", "$.a.b");
+  expectSameAsParsed("{\"a\": {\"b\": 1}, \"a\": {\"c\": 2}}", "$.a.c");
+  expectSameAsParsed("{\"a\": 1, \"a\": 2}", "$.a");
+
+  // Escaped keys and strings.
+  expectSameAsParsed("{\"a\\\"b\": 1, \"c\": 2}", "$.c");
+  expectSameAsParsed("{\"a\\\"b\": 1, \"c\": 2}", "$[\"a\\\"b\"]");
+  expectSameAsParsed("{\"a\": \"x\\\"y\\\\z\\n\\u00e9\"}", "$.a");
+  expectSameAsParsed("{\"a\": \"\\ud83d\\ude00\"}", "$.a");
+  expectSameAsParsed("{\"a\": \"\\ud83d\"}", "$.a");
+
+  // Numbers.
+  for (const auto& path : {"$[0]", "$[1]", "$[2]", "$[3]", "$[4]", "$[5]"}) {
+    expectSameAsParsed(
+        "[-0, 1.50, 1e10, 2E-3, 12345678901234567890, 123456789012345678]",
+        path);
+  }
+
+  // Invalid documents.
+  for (const auto& invalid :
+       {"",
+        "{\"a\": 1,}",
+        "{\"a\": 1} x",
+        "{\"a\": 01}",
+        "[1, 2",
+        "{\"a\": tru}",
+        "{\"a\" 1}",
+        "{\"a\": \"b\tc\"}",
+        "{\"a\": \"b}",
+        "{\"a\": 1, \"b\": [1, 2,]}"}) {
+    expectSameAsParsed(invalid, "$.a");
+  }
+
+  // Index tokens that are not plain numbers.
+  expectSameAsParsed("[1, 2]", "$[\"+1\"]");
+  expectSameAsParsed("[1, 2]", "$[\" 1\"]");
+  expectSameAsParsed("[1, 2]", "$[\"a\"]");
+  expectSameAsParsed("[1, 2]", "$[1234567890123]");
+
+  // Deep nesting is left to folly::parseJson.
+  std::string nested = std::string(100, '[') + "1" + std::string(100, ']');
+  expectSameAsParsed(nested, "$[0][0]");
+  nested = std::string(20, '[') + "1" + std::string(20, ']');
+  expectSameAsParsed(nested, "$[0][0]");
+}
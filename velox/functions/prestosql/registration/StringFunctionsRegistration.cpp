@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <mutex>
+
 #include "velox/functions/Registerer.h"
 #include "velox/functions/lib/Re2Functions.h"
 #include "velox/functions/prestosql/RegexpReplace.h"
@@ -98,6 +100,20 @@ void registerStringFunctions() {
       "regexp_extract_all", re2ExtractAllSignatures(), makeRe2ExtractAll);
   exec::registerStatefulVectorFunction(
       "regexp_like", re2SearchSignatures(), makeRe2Search);
+  exec::registerStatefulVectorFunction(
+      "regexp_like_any", re2MatchAnySignatures(), makeRe2MatchAny);
+
+  // ORs of LIKE and regexp_like over the same column are evaluated with one
+  // regexp_like_any if expression rewrites are enabled. Registering the
+  // functions again must not add the rule twice.
+  static std::once_flag addRewriteOnce;
+  std::call_once(addRewriteOnce, [] {
+    static auto pool = memory::getDefaultMemoryPool();
+    exec::ExprRewriter::instance().addRule(
+        "or_of_patterns",
+        makeMatchAnyRewrite(
+            "like", "regexp_like", "regexp_like_any", pool.get()));
+  });
 
   registerFunction<StrLPosFunction, int64_t, Varchar, Varchar>({"strpos"});
   registerFunction<StrLPosFunction, int64_t, Varchar, Varchar, int64_t>(
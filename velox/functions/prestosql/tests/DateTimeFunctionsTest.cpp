@@ -639,6 +639,27 @@ TEST_F(DateTimeFunctionsTest, hour) {
   EXPECT_EQ(8, hour(Timestamp(998423705, 321000000)));
 }
 
+TEST_F(DateTimeFunctionsTest, hourAcrossDaylightSavingTransition) {
+  setQueryTimeZone("America/Los_Angeles");
+  // Clocks moved forward at 2021-03-14 10:00:00 GMT. The rows go past the
+  // transition and then back before it.
+  constexpr int64_t kTransition = 1'615'716'000;
+  std::vector<int64_t> seconds;
+  for (auto i = -6; i < 12; ++i) {
+    seconds.push_back(kTransition + i * 1'200);
+  }
+  seconds.push_back(kTransition - 1);
+  seconds.push_back(kTransition);
+  auto input = makeFlatVector<Timestamp>(
+      seconds.size(), [&](auto row) { return Timestamp(seconds[row], 0); });
+  auto result = evaluate<SimpleVector<int64_t>>(
+      "hour(c0)", makeRowVector({input}));
+  for (auto i = 0; i < seconds.size(); ++i) {
+    const int64_t offset = seconds[i] < kTransition ? -8 * 3'600 : -7 * 3'600;
+    EXPECT_EQ((seconds[i] + offset) / 3'600 % 24, result->valueAt(i)) << i;
+  }
+}
+
 TEST_F(DateTimeFunctionsTest, hourTimestampWithTimezone) {
   EXPECT_EQ(
       20,
@@ -115,6 +115,22 @@ TEST_F(DecimalArithmeticTest, add) {
        makeNullableShortDecimalFlatVector(
            {1, 2, 5, std::nullopt, std::nullopt}, DECIMAL(10, 3))});
 
+  // Add short and short of different scales, returning short.
+  testDecimalExpr<TypeKind::SHORT_DECIMAL>(
+      makeShortDecimalFlatVector({2000, 4000}, DECIMAL(13, 3)),
+      "c0 + c1",
+      {shortFlat, makeShortDecimalFlatVector({10, 20}, DECIMAL(10, 1))});
+
+  // Short addition overflow.
+  constexpr int64_t kMax = 999'999'999'999'999'999;
+  VELOX_ASSERT_THROW(
+      testDecimalExpr<TypeKind::SHORT_DECIMAL>(
+          {},
+          "c0 + c1",
+          {makeShortDecimalFlatVector({1, kMax}, DECIMAL(10, 0)),
+           makeShortDecimalFlatVector({1, kMax}, DECIMAL(10, 0))}),
+      "Decimal overflow: 999999999999999999 + 999999999999999999");
+
   // Addition overflow.
   VELOX_ASSERT_THROW(
       testDecimalExpr<TypeKind::LONG_DECIMAL>(
@@ -428,6 +428,36 @@ TEST_F(ElementAtTest, variableInputMap) {
   testVariableInputMap<StringView>(); // VARCHAR
 }
 
+TEST_F(ElementAtTest, multipleLookupsInLargeMaps) {
+  // Maps of 50 keys in no particular order. The second and later subscripts
+  // into the same map vector search an index of the sorted keys.
+  constexpr vector_size_t kMapSize = 50;
+  auto keyAt = [](vector_size_t idx) -> int64_t {
+    return (idx % kMapSize) * 17 % kMapSize;
+  };
+  auto mapVector = makeMapVector<int64_t, int64_t>(
+      kVectorSize,
+      [](auto /*row*/) { return kMapSize; },
+      keyAt,
+      [&](auto idx) { return keyAt(idx) * 1'000 + idx / kMapSize; });
+  auto keys = makeFlatVector<int64_t>(
+      kVectorSize, [](auto row) { return row % kMapSize; });
+
+  testElementAt<int64_t>(
+      "element_at(c0, c1) + element_at(c0, (c1 + 7) % 50) + element_at(c0, 3)",
+      {mapVector, keys},
+      [](auto row) {
+        const int64_t key = row % kMapSize;
+        return (key + (key + 7) % kMapSize + 3) * 1'000 + 3 * row;
+      });
+
+  // Keys missing from all maps return null.
+  testElementAt<int64_t>(
+      "coalesce(element_at(c0, c1 + 50), element_at(c0, c1) - 1)",
+      {mapVector, keys},
+      [](auto row) { return (row % kMapSize) * 1'000 + row - 1; });
+}
+
 TEST_F(ElementAtTest, variableInputArray) {
   {
     auto indicesVector = makeFlatVector<int64_t>(
@@ -166,6 +166,54 @@ class InPredicateTest : public FunctionBaseTest {
     result = evaluate<SimpleVector<bool>>("c1 IN (1, 3, 5)", rowVector);
     assertEqualVectors(constNull, result);
   }
+
+  // Tests IN lists of 'numValues' values on rows that do not fill whole words
+  // and on a subset of rows.
+  template <typename T>
+  void testLists(int32_t numValues) {
+    SCOPED_TRACE(fmt::format("{} values", numValues));
+    const vector_size_t size = 1'000;
+    auto valueAt = [](auto row) { return static_cast<T>(row % 113); };
+    auto rowVector = makeRowVector({
+        makeFlatVector<T>(size, valueAt),
+        makeFlatVector<T>(size, valueAt, nullEvery(7)),
+        makeFlatVector<bool>(size, [](auto row) { return row % 3 == 0; }),
+    });
+
+    std::unordered_set<T> values;
+    std::vector<std::string> literals;
+    for (auto i = 0; i < numValues; ++i) {
+      values.insert(valueAt(i * 7));
+      literals.push_back(std::to_string(valueAt(i * 7)));
+    }
+    auto inList = folly::join(", ", literals);
+    auto isIn = [&](auto row) { return values.count(valueAt(row)) > 0; };
+
+    auto result = evaluate<SimpleVector<bool>>(
+        fmt::format("c0 IN ({})", inList), rowVector);
+    assertEqualVectors(makeFlatVector<bool>(size, isIn), result);
+
+    result = evaluate<SimpleVector<bool>>(
+        fmt::format("c1 IN ({})", inList), rowVector);
+    assertEqualVectors(makeFlatVector<bool>(size, isIn, nullEvery(7)), result);
+
+    result = evaluate<SimpleVector<bool>>(
+        fmt::format("c0 IN ({}, null)", inList), rowVector);
+    assertEqualVectors(
+        makeFlatVector<bool>(
+            size,
+            [](auto /*row*/) { return true; },
+            [&](auto row) { return !isIn(row); }),
+        result);
+
+    // The IN predicate is evaluated on every third row.
+    result = evaluate<SimpleVector<bool>>(
+        fmt::format("if(c2, c0 IN ({}), false)", inList), rowVector);
+    assertEqualVectors(
+        makeFlatVector<bool>(
+            size, [&](auto row) { return row % 3 == 0 && isIn(row); }),
+        result);
+  }
 };
 
 TEST_F(InPredicateTest, bigint) {
@@ -188,6 +236,48 @@ TEST_F(InPredicateTest, tinyint) {
   testsIntegerConstant<int8_t>();
 }
 
+TEST_F(InPredicateTest, lists) {
+  for (auto numValues : {1, 5, 16, 17, 100}) {
+    testLists<int64_t>(numValues);
+    testLists<int32_t>(numValues);
+    testLists<int16_t>(numValues);
+    testLists<int8_t>(numValues);
+  }
+}
+
+TEST_F(InPredicateTest, varcharLists) {
+  const vector_size_t size = 1'000;
+  auto valueAt = [](auto row) {
+    return fmt::format("id-{}-0123456789", row % 311);
+  };
+  std::vector<std::string> strings;
+  for (auto i = 0; i < size; ++i) {
+    strings.push_back(valueAt(i));
+  }
+  auto rowVector = makeRowVector({makeFlatVector<StringView>(
+      size,
+      [&](auto row) { return StringView(strings[row]); },
+      nullEvery(11))});
+  for (auto numValues : {3, 16, 17, 1'000}) {
+    SCOPED_TRACE(fmt::format("{} values", numValues));
+    std::unordered_set<std::string> values;
+    std::vector<std::string> literals;
+    for (auto i = 0; i < numValues; ++i) {
+      // Every other value is not in the input.
+      auto value = i % 2 == 0 ? valueAt(i * 3) : fmt::format("other-{}", i);
+      values.insert(value);
+      literals.push_back(fmt::format("'{}'", value));
+    }
+    auto result = evaluate<SimpleVector<bool>>(
+        fmt::format("c0 IN ({})", folly::join(", ", literals)), rowVector);
+    auto expected = makeFlatVector<bool>(
+        size,
+        [&](auto row) { return values.count(valueAt(row)) > 0; },
+        nullEvery(11));
+    assertEqualVectors(expected, result);
+  }
+}
+
 TEST_F(InPredicateTest, varchar) {
   const vector_size_t size = 1'000;
 
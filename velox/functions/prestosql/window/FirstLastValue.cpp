@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/exec/WindowFunction.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/functions/prestosql/window/NonNullRows.h"
+
+namespace facebook::velox::window::prestosql {
+
+namespace {
+
+// Computes first_value(x) if 'isFirst' and last_value(x) otherwise. The value
+// of a row is copied from the first or last row of its frame. With IGNORE
+// NULLS, the value is copied from the first or last row of the frame with a
+// non-null value. The result is null for an empty frame.
+template <bool isFirst>
+class FirstLastValueFunction : public exec::WindowFunction {
+ public:
+  explicit FirstLastValueFunction(
+      const std::vector<exec::WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      bool ignoreNulls,
+      velox::memory::MemoryPool* pool)
+      : WindowFunction(resultType, pool, nullptr), ignoreNulls_(ignoreNulls) {
+    VELOX_CHECK_EQ(args.size(), 1);
+    VELOX_CHECK_NULL(args[0].constantValue);
+    valueIndex_ = args[0].index.value();
+  }
+
+  void resetPartition(const exec::WindowPartition* partition) override {
+    partition_ = partition;
+    if (ignoreNulls_) {
+      nonNullRows_.reset(*partition, valueIndex_, pool_);
+    }
+  }
+
+  void apply(
+      const BufferPtr& /*peerGroupStarts*/,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& frameStarts,
+      const BufferPtr& frameEnds,
+      int32_t resultOffset,
+      const VectorPtr& result) override {
+    auto numRows = frameStarts->size() / sizeof(vector_size_t);
+    auto frameStartsPtr = frameStarts->as<vector_size_t>();
+    auto frameEndsPtr = frameEnds->as<vector_size_t>();
+
+    rowNumbers_.resize(numRows);
+    for (auto i = 0; i < numRows; ++i) {
+      rowNumbers_[i] = rowNumberInFrame(frameStartsPtr[i], frameEndsPtr[i]);
+    }
+
+    auto rowNumbersRange = folly::Range(rowNumbers_.data(), numRows);
+    partition_->extractColumn(
+        valueIndex_, rowNumbersRange, resultOffset, result);
+  }
+
+ private:
+  // Returns the row number (relative to the start of the partition) to copy
+  // the value from for the frame from 'frameStart' to 'frameEnd'. Returns -1
+  // for a null result.
+  vector_size_t rowNumberInFrame(
+      vector_size_t frameStart,
+      vector_size_t frameEnd) const {
+    if (frameStart > frameEnd) {
+      return -1;
+    }
+    if (!ignoreNulls_) {
+      return isFirst ? frameStart : frameEnd;
+    }
+    if constexpr (isFirst) {
+      const auto index = nonNullRows_.countBefore(frameStart);
+      return index < nonNullRows_.size() && nonNullRows_[index] <= frameEnd
+          ? nonNullRows_[index]
+          : -1;
+    } else {
+      const auto index = nonNullRows_.countBefore(frameEnd + 1) - 1;
+      return index >= 0 && nonNullRows_[index] >= frameStart
+          ? nonNullRows_[index]
+          : -1;
+    }
+  }
+
+  const bool ignoreNulls_;
+
+  // The argument index of the value column in the input row vector.
+  column_index_t valueIndex_;
+
+  const exec::WindowPartition* partition_;
+
+  // Positions of the rows with a non-null value in the partition. Only set
+  // with IGNORE NULLS.
+  NonNullRows nonNullRows_;
+
+  // Row numbers in the partition to copy the values from. Reused across
+  // apply() calls.
+  std::vector<vector_size_t> rowNumbers_;
+};
+
+template <bool isFirst>
+void registerFirstLastValueInternal(const std::string& name) {
+  std::vector<exec::FunctionSignaturePtr> signatures{
+      // (T) -> T.
+      exec::FunctionSignatureBuilder()
+          .typeVariable("T")
+          .returnType("T")
+          .argumentType("T")
+          .build(),
+  };
+
+  exec::registerWindowFunction(
+      name,
+      std::move(signatures),
+      [name](
+          const std::vector<exec::WindowFunctionArg>& args,
+          const TypePtr& resultType,
+          bool ignoreNulls,
+          velox::memory::MemoryPool* pool,
+          HashStringAllocator* /*stringAllocator*/)
+          -> std::unique_ptr<exec::WindowFunction> {
+        return std::make_unique<FirstLastValueFunction<isFirst>>(
+            args, resultType, ignoreNulls, pool);
+      });
+}
+} // namespace
+
+void registerFirstValue(const std::string& name) {
+  registerFirstLastValueInternal<true>(name);
+}
+
+void registerLastValue(const std::string& name) {
+  registerFirstLastValueInternal<false>(name);
+}
+} // namespace facebook::velox::window::prestosql
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/exec/WindowFunction.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/functions/prestosql/window/NonNullRows.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::window::prestosql {
+
+namespace {
+
+// Computes lag(x[, offset[, default]]) if 'isLag' and lead(...) otherwise.
+// The functions ignore the window frame. The value of a row is copied from
+// the row 'offset' rows before (lag) or after (lead) it in the partition.
+// With IGNORE NULLS, the offset counts the rows with a non-null value.
+template <bool isLag>
+class LeadLagFunction : public exec::WindowFunction {
+ public:
+  explicit LeadLagFunction(
+      const std::vector<exec::WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      bool ignoreNulls,
+      velox::memory::MemoryPool* pool)
+      : WindowFunction(resultType, pool, nullptr), ignoreNulls_(ignoreNulls) {
+    VELOX_CHECK_GE(args.size(), 1);
+    VELOX_CHECK_LE(args.size(), 3);
+    VELOX_CHECK_NULL(args[0].constantValue);
+    valueIndex_ = args[0].index.value();
+    if (args.size() > 1) {
+      initializeOffset(args[1]);
+    }
+    if (args.size() > 2) {
+      initializeDefault(args[2]);
+    }
+  }
+
+  void resetPartition(const exec::WindowPartition* partition) override {
+    partition_ = partition;
+    partitionOffset_ = 0;
+    if (ignoreNulls_) {
+      nonNullRows_.reset(*partition, valueIndex_, pool_);
+    }
+  }
+
+  void apply(
+      const BufferPtr& /*peerGroupStarts*/,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& frameStarts,
+      const BufferPtr& /*frameEnds*/,
+      int32_t resultOffset,
+      const VectorPtr& result) override {
+    auto numRows = frameStarts->size() / sizeof(vector_size_t);
+    rowNumbers_.resize(numRows);
+    defaultRows_.clear();
+
+    if (constantOffset_.has_value() || isConstantOffsetNull_) {
+      setRowNumbersForConstantOffset(numRows);
+    } else {
+      setRowNumbers(numRows);
+    }
+
+    auto rowNumbersRange = folly::Range(rowNumbers_.data(), numRows);
+    partition_->extractColumn(
+        valueIndex_, rowNumbersRange, resultOffset, result);
+    setDefaults(numRows, resultOffset, result);
+
+    partitionOffset_ += numRows;
+  }
+
+ private:
+  // Marks a row whose offset is past the end of the partition in
+  // 'rowNumbers_'. The result of such a row is the default value.
+  static constexpr vector_size_t kDefaultRow = -2;
+
+  void initializeOffset(const exec::WindowFunctionArg& arg) {
+    if (arg.constantValue) {
+      if (arg.constantValue->isNullAt(0)) {
+        isConstantOffsetNull_ = true;
+        return;
+      }
+      constantOffset_ =
+          arg.constantValue->template as<ConstantVector<int64_t>>()->valueAt(
+              0);
+      VELOX_USER_CHECK_GE(
+          constantOffset_.value(), 0, "Offset must be at least 0");
+      return;
+    }
+    constantOffset_.reset();
+    offsetIndex_ = arg.index.value();
+    offsets_ = std::dynamic_pointer_cast<FlatVector<int64_t>>(
+        BaseVector::create(BIGINT(), 0, pool_));
+  }
+
+  void initializeDefault(const exec::WindowFunctionArg& arg) {
+    if (arg.constantValue) {
+      constantDefault_ = arg.constantValue;
+      return;
+    }
+    defaultIndex_ = arg.index.value();
+    defaults_ = BaseVector::create(arg.type, 0, pool_);
+  }
+
+  // The below 2 functions build the rowNumbers for column extraction. The
+  // rowNumbers map each output row to the rowNumber (relative to the start
+  // of the partition) from which the value is copied. A rowNumber of -1 is
+  // for a null result and kDefaultRow for the default value.
+  void setRowNumbersForConstantOffset(vector_size_t numRows) {
+    if (isConstantOffsetNull_) {
+      std::fill(rowNumbers_.begin(), rowNumbers_.end(), -1);
+      return;
+    }
+
+    auto constantOffsetValue = constantOffset_.value();
+    for (auto i = 0; i < numRows; ++i) {
+      setRowNumber(i, constantOffsetValue);
+    }
+  }
+
+  void setRowNumbers(vector_size_t numRows) {
+    offsets_->resize(numRows);
+    partition_->extractColumn(
+        offsetIndex_, partitionOffset_, numRows, 0, offsets_);
+    for (auto i = 0; i < numRows; ++i) {
+      if (offsets_->isNullAt(i)) {
+        rowNumbers_[i] = -1;
+      } else {
+        auto offset = offsets_->valueAt(i);
+        VELOX_USER_CHECK_GE(offset, 0, "Offset must be at least 0");
+        setRowNumber(i, offset);
+      }
+    }
+  }
+
+  inline void setRowNumber(vector_size_t i, int64_t offset) {
+    const vector_size_t position = partitionOffset_ + i;
+    const auto rowNumber = rowNumberAt(position, offset);
+    rowNumbers_[i] = rowNumber;
+    if (rowNumber == kDefaultRow) {
+      defaultRows_.push_back(i);
+    }
+  }
+
+  // Returns the position of the row 'offset' rows before or after the row at
+  // 'position', or kDefaultRow if this is outside of the partition.
+  vector_size_t rowNumberAt(vector_size_t position, int64_t offset) const {
+    if (offset == 0) {
+      return position;
+    }
+    if (ignoreNulls_) {
+      // Index in 'nonNullRows_' of the row that is 'offset' non-null rows
+      // before or after 'position'.
+      const int64_t index = isLag
+          ? nonNullRows_.countBefore(position) - offset
+          : nonNullRows_.countBefore(position + 1) + offset - 1;
+      return index >= 0 && index < nonNullRows_.size() ? nonNullRows_[index]
+                                                       : kDefaultRow;
+    }
+    const int64_t rowNumber = isLag ? position - offset : position + offset;
+    return rowNumber >= 0 && rowNumber < partition_->numRows() ? rowNumber
+                                                               : kDefaultRow;
+  }
+
+  // Copies the default value into the result for rows in 'defaultRows_'. The
+  // result is null for these rows if there is no default value.
+  void setDefaults(
+      vector_size_t numRows,
+      int32_t resultOffset,
+      const VectorPtr& result) {
+    if (defaultRows_.empty()) {
+      return;
+    }
+    if (constantDefault_) {
+      for (auto row : defaultRows_) {
+        result->copy(constantDefault_.get(), resultOffset + row, 0, 1);
+      }
+      return;
+    }
+    if (!defaultIndex_.has_value()) {
+      return;
+    }
+    defaults_->resize(numRows);
+    partition_->extractColumn(
+        defaultIndex_.value(), partitionOffset_, numRows, 0, defaults_);
+    for (auto row : defaultRows_) {
+      result->copy(defaults_.get(), resultOffset + row, row, 1);
+    }
+  }
+
+  const bool ignoreNulls_;
+
+  // These are the argument indices of the value, offset and default columns
+  // in the input row vector.
+  column_index_t valueIndex_;
+  column_index_t offsetIndex_;
+  std::optional<column_index_t> defaultIndex_;
+
+  const exec::WindowPartition* partition_;
+
+  // The offset is 1 if the function call has no offset argument.
+  std::optional<int64_t> constantOffset_{1};
+  bool isConstantOffsetNull_ = false;
+
+  // Set if the default argument is a constant value.
+  VectorPtr constantDefault_;
+
+  // These vectors are used to extract values of the offset and default
+  // argument columns for the rows of the current apply().
+  FlatVectorPtr<int64_t> offsets_;
+  VectorPtr defaults_;
+
+  // Positions of the rows with a non-null value in the partition. Only set
+  // with IGNORE NULLS.
+  NonNullRows nonNullRows_;
+
+  // This offset tracks how far along the partition rows have been output.
+  vector_size_t partitionOffset_;
+
+  // Row numbers in the partition to copy the values from. Reused across
+  // apply() calls.
+  std::vector<vector_size_t> rowNumbers_;
+
+  // Offsets in the current apply() of the rows that get the default value.
+  std::vector<vector_size_t> defaultRows_;
+};
+
+template <bool isLag>
+void registerLeadLagInternal(const std::string& name) {
+  std::vector<exec::FunctionSignaturePtr> signatures{
+      // (T) -> T.
+      exec::FunctionSignatureBuilder()
+          .typeVariable("T")
+          .returnType("T")
+          .argumentType("T")
+          .build(),
+      // (T, bigint) -> T.
+      exec::FunctionSignatureBuilder()
+          .typeVariable("T")
+          .returnType("T")
+          .argumentType("T")
+          .argumentType("bigint")
+          .build(),
+      // (T, bigint, T) -> T.
+      exec::FunctionSignatureBuilder()
+          .typeVariable("T")
+          .returnType("T")
+          .argumentType("T")
+          .argumentType("bigint")
+          .argumentType("T")
+          .build(),
+  };
+
+  exec::registerWindowFunction(
+      name,
+      std::move(signatures),
+      [name](
+          const std::vector<exec::WindowFunctionArg>& args,
+          const TypePtr& resultType,
+          bool ignoreNulls,
+          velox::memory::MemoryPool* pool,
+          HashStringAllocator* /*stringAllocator*/)
+          -> std::unique_ptr<exec::WindowFunction> {
+        return std::make_unique<LeadLagFunction<isLag>>(
+            args, resultType, ignoreNulls, pool);
+      });
+}
+} // namespace
+
+void registerLag(const std::string& name) {
+  registerLeadLagInternal<true>(name);
+}
+
+void registerLead(const std::string& name) {
+  registerLeadLagInternal<false>(name);
+}
+} // namespace facebook::velox::window::prestosql
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/WindowPartition.h"
+
+namespace facebook::velox::window::prestosql {
+
+/// The positions of the rows of a window partition that have a non-null value
+/// in a column. Value functions with IGNORE NULLS use these to find the n-th
+/// non-null value before or after a row without scanning the rows in between.
+class NonNullRows {
+ public:
+  /// Computes the positions for the column at 'columnIndex' of 'partition'.
+  void reset(
+      const exec::WindowPartition& partition,
+      column_index_t columnIndex,
+      memory::MemoryPool* pool) {
+    const auto numRows = partition.numRows();
+    if (!nulls_ || nulls_->capacity() < bits::nbytes(numRows)) {
+      nulls_ = AlignedBuffer::allocate<bool>(numRows, pool);
+    }
+    nulls_->setSize(bits::nbytes(numRows));
+    partition.extractNulls(columnIndex, 0, numRows, nulls_);
+
+    const auto* rawNulls = nulls_->as<uint64_t>();
+    rows_.clear();
+    countBefore_.resize(numRows + 1);
+    for (auto i = 0; i < numRows; ++i) {
+      countBefore_[i] = rows_.size();
+      if (!bits::isBitSet(rawNulls, i)) {
+        rows_.push_back(i);
+      }
+    }
+    countBefore_[numRows] = rows_.size();
+  }
+
+  /// Returns the number of non-null rows before the row at 'position'.
+  /// 'position' can be the number of rows of the partition.
+  vector_size_t countBefore(vector_size_t position) const {
+    return countBefore_[position];
+  }
+
+  /// Returns the number of non-null rows.
+  vector_size_t size() const {
+    return rows_.size();
+  }
+
+  /// Returns the position of the 'index'-th non-null row.
+  vector_size_t operator[](vector_size_t index) const {
+    return rows_[index];
+  }
+
+ private:
+  // Bits set for the rows with a null value.
+  BufferPtr nulls_;
+
+  // Positions of the non-null rows in partition order.
+  std::vector<vector_size_t> rows_;
+
+  // Number of the non-null rows before each position. Has one more element
+  // than the number of rows.
+  std::vector<vector_size_t> countBefore_;
+};
+
+} // namespace facebook::velox::window::prestosql
@@ -17,6 +17,7 @@
 #include "velox/common/base/Exceptions.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/expression/FunctionSignature.h"
+#include "velox/functions/prestosql/window/NonNullRows.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::window::prestosql {
@@ -29,8 +30,9 @@ class NthValueFunction : public exec::WindowFunction {
   explicit NthValueFunction(
       const std::vector<exec::WindowFunctionArg>& args,
       const TypePtr& resultType,
+      bool ignoreNulls,
       velox::memory::MemoryPool* pool)
-      : WindowFunction(resultType, pool, nullptr) {
+      : WindowFunction(resultType, pool, nullptr), ignoreNulls_(ignoreNulls) {
     VELOX_CHECK_EQ(args.size(), 2);
     VELOX_CHECK_NULL(args[0].constantValue);
     valueIndex_ = args[0].index.value();
@@ -55,6 +57,9 @@ class NthValueFunction : public exec::WindowFunction {
   void resetPartition(const exec::WindowPartition* partition) override {
     partition_ = partition;
     partitionOffset_ = 0;
+    if (ignoreNulls_) {
+      nonNullRows_.reset(*partition, valueIndex_, pool_);
+    }
   }
 
   void apply(
@@ -130,10 +135,25 @@ class NthValueFunction : public exec::WindowFunction {
       vector_size_t offset) {
     auto frameStart = frameStarts[i];
     auto frameEnd = frameEnds[i];
+    if (ignoreNulls_) {
+      // The offset counts the rows of the frame with a non-null value.
+      if (frameStart > frameEnd) {
+        rowNumbers_[i] = -1;
+        return;
+      }
+      const int64_t index = nonNullRows_.countBefore(frameStart) + offset - 1;
+      rowNumbers_[i] =
+          index < nonNullRows_.size() && nonNullRows_[index] <= frameEnd
+          ? nonNullRows_[index]
+          : -1;
+      return;
+    }
     auto rowNumber = frameStart + offset - 1;
     rowNumbers_[i] = rowNumber <= frameEnd ? rowNumber : -1;
   }
 
+  const bool ignoreNulls_;
+
   // These are the argument indices of the nth_value value and offset columns
   // in the input row vector. These are needed to retrieve column values
   // from the partition data.
@@ -155,6 +175,10 @@ class NthValueFunction : public exec::WindowFunction {
   // to the present row set in getOutput.
   vector_size_t partitionOffset_;
 
+  // Positions of the rows with a non-null value in the partition. Only set
+  // with IGNORE NULLS.
+  NonNullRows nonNullRows_;
+
   // The NthValue function directly writes from the input column to the
   // resultVector using the extractColumn API specifying the rowNumber mapping
   // to copy between the 2 vectors. This variable is used for the rowNumber
@@ -166,9 +190,11 @@ template <TypeKind kind>
 std::unique_ptr<exec::WindowFunction> createNthValueFunction(
     const std::vector<exec::WindowFunctionArg>& args,
     const TypePtr& resultType,
+    bool ignoreNulls,
     velox::memory::MemoryPool* pool) {
   using T = typename TypeTraits<kind>::NativeType;
-  return std::make_unique<NthValueFunction<T>>(args, resultType, pool);
+  return std::make_unique<NthValueFunction<T>>(
+      args, resultType, ignoreNulls, pool);
 }
 
 } // namespace
@@ -190,12 +216,18 @@ void registerNthValue(const std::string& name) {
       [name](
           const std::vector<exec::WindowFunctionArg>& args,
           const TypePtr& resultType,
+          bool ignoreNulls,
           velox::memory::MemoryPool* pool,
           HashStringAllocator* /*stringAllocator*/)
           -> std::unique_ptr<exec::WindowFunction> {
         auto typeKind = args[0].type->kind();
         return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
-            createNthValueFunction, typeKind, args, resultType, pool);
+            createNthValueFunction,
+            typeKind,
+            args,
+            resultType,
+            ignoreNulls,
+            pool);
       });
 }
 } // namespace facebook::velox::window::prestosql
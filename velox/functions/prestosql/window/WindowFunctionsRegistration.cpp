@@ -26,6 +26,10 @@ extern void registerPercentRank(const std::string& name);
 extern void registerCumeDist(const std::string& name);
 extern void registerNtile(const std::string& name);
 extern void registerNthValue(const std::string& name);
+extern void registerFirstValue(const std::string& name);
+extern void registerLastValue(const std::string& name);
+extern void registerLag(const std::string& name);
+extern void registerLead(const std::string& name);
 
 void registerAllWindowFunctions() {
   registerRowNumber("row_number");
@@ -35,6 +39,10 @@ void registerAllWindowFunctions() {
   registerCumeDist("cume_dist");
   registerNtile("ntile");
   registerNthValue("nth_value");
+  registerFirstValue("first_value");
+  registerLastValue("last_value");
+  registerLag("lag");
+  registerLead("lead");
 }
 
 } // namespace prestosql
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/prestosql/window/tests/WindowTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::window::test {
+
+namespace {
+
+// Frames that are empty for some rows or hold only some of the preceding and
+// following rows.
+static std::vector<std::string> kSlidingFrameClauses = {
+    "rows between 2 preceding and 1 preceding",
+    "rows between 1 following and 3 following",
+    "rows between 3 preceding and 2 following",
+};
+
+class FirstLastValueTest : public WindowTestBase {
+ protected:
+  // The rows ordered on c0, c1 and c2 are totally ordered up to rows with
+  // the same values, so that the function results are deterministic.
+  RowVectorPtr makeVectors(vector_size_t size, int32_t numPartitions) {
+    return makeRowVector({
+        makeFlatVector<int32_t>(
+            size, [&](auto row) { return row % numPartitions; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row % 7; }),
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row % 11; }, nullEvery(4)),
+    });
+  }
+
+  void testFunctions(const std::vector<RowVectorPtr>& input) {
+    for (const auto& function :
+         {"first_value(c2)",
+          "last_value(c2)",
+          "first_value(c2 IGNORE NULLS)",
+          "last_value(c2 IGNORE NULLS)"}) {
+      testWindowFunction(input, function, kFrameOverClauses);
+      testWindowFunction(
+          input, function, kFrameOverClauses, kRangeFrameClauses);
+      testWindowFunction(input, function, kFrameOverClauses, kRowsFrameClauses);
+      testWindowFunction(
+          input, function, kFrameOverClauses, kSlidingFrameClauses);
+    }
+  }
+};
+
+TEST_F(FirstLastValueTest, basic) {
+  testFunctions({makeVectors(50, 5)});
+}
+
+TEST_F(FirstLastValueTest, singlePartition) {
+  testFunctions({makeVectors(400, 1)});
+}
+
+TEST_F(FirstLastValueTest, multiInput) {
+  auto vectors = makeVectors(200, 3);
+  testFunctions({vectors, vectors});
+}
+
+TEST_F(FirstLastValueTest, allNulls) {
+  // With IGNORE NULLS, the result is null if all the rows of the frame are
+  // null.
+  auto vectors = makeRowVector({
+      makeFlatVector<int32_t>(30, [](auto row) { return row % 3; }),
+      makeFlatVector<int32_t>(30, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          30, [](auto row) { return row; }, [](auto row) { return row < 20; }),
+  });
+  testWindowFunction(
+      {vectors},
+      "first_value(c2 IGNORE NULLS)",
+      {"partition by c0 order by c1"},
+      kSlidingFrameClauses);
+  testWindowFunction(
+      {vectors},
+      "last_value(c2 IGNORE NULLS)",
+      {"partition by c0 order by c1"},
+      kSlidingFrameClauses);
+}
+
+}; // namespace
+}; // namespace facebook::velox::window::test
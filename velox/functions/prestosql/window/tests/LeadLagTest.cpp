@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/window/tests/WindowTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::window::test {
+
+namespace {
+
+// lead and lag depend on the order of the rows in the partition, so these
+// over clauses order the rows by the unique column c1.
+static std::vector<std::string> kOrderedOverClauses = {
+    "partition by c0 order by c1",
+    "partition by c0 order by c1 desc",
+    "order by c1",
+    "order by c1 desc",
+    "partition by c0 order by c1 rows between 1 preceding and current row",
+};
+
+class LeadLagTest : public WindowTestBase {
+ protected:
+  // c0 is the partition key, c1 the unique sorting key, c2 the value with
+  // nulls, c3 the offset and c4 the default value.
+  RowVectorPtr makeVectors(vector_size_t size, int32_t numPartitions) {
+    return makeRowVector({
+        makeFlatVector<int32_t>(
+            size, [&](auto row) { return row % numPartitions; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row * 10; }, nullEvery(3)),
+        makeFlatVector<int64_t>(size, [](auto row) { return row % 4; }),
+        makeFlatVector<int64_t>(size, [](auto row) { return -row; }),
+    });
+  }
+
+  void testFunction(const std::vector<RowVectorPtr>& input, bool ignoreNulls) {
+    const std::string ignoreNullsClause = ignoreNulls ? " IGNORE NULLS" : "";
+    for (const auto& name : {"lag", "lead"}) {
+      for (const auto& args :
+           {"c2", "c2, 3", "c2, c3", "c2, 2, 100", "c2, c3, c4"}) {
+        testWindowFunction(
+            input,
+            fmt::format("{}({}{})", name, args, ignoreNullsClause),
+            kOrderedOverClauses);
+      }
+    }
+  }
+};
+
+TEST_F(LeadLagTest, basic) {
+  auto vectors = makeVectors(100, 5);
+  testFunction({vectors}, false);
+  testWindowFunction({vectors}, "lag(c2, 0)", kOrderedOverClauses);
+}
+
+TEST_F(LeadLagTest, ignoreNulls) {
+  auto vectors = makeVectors(100, 5);
+  testFunction({vectors}, true);
+}
+
+TEST_F(LeadLagTest, singlePartition) {
+  auto vectors = makeVectors(500, 1);
+  testFunction({vectors}, false);
+  testFunction({vectors}, true);
+}
+
+TEST_F(LeadLagTest, multiInput) {
+  auto vectors = makeVectors(250, 3);
+  testFunction({vectors, vectors}, true);
+}
+
+TEST_F(LeadLagTest, nullOffsets) {
+  // The result is null for a null offset, not the default value.
+  auto vectors = makeRowVector({
+      makeFlatVector<int32_t>({1, 1, 1, 1}),
+      makeFlatVector<int32_t>({1, 2, 3, 4}),
+      makeFlatVector<int64_t>({10, 20, 30, 40}),
+      makeNullableFlatVector<int64_t>({1, std::nullopt, 1, 5}),
+  });
+  auto expected = makeRowVector({
+      makeFlatVector<int32_t>({1, 1, 1, 1}),
+      makeFlatVector<int32_t>({1, 2, 3, 4}),
+      makeFlatVector<int64_t>({10, 20, 30, 40}),
+      makeNullableFlatVector<int64_t>({1, std::nullopt, 1, 5}),
+      makeNullableFlatVector<int64_t>({0, std::nullopt, 20, 0}),
+  });
+  auto plan = PlanBuilder()
+                  .values({vectors})
+                  .window({"lag(c2, c3, 0) over (order by c1)"})
+                  .planNode();
+  assertQuery(plan, expected);
+}
+
+TEST_F(LeadLagTest, invalidOffsets) {
+  auto vectors = makeRowVector({
+      makeFlatVector<int32_t>(20, [](auto row) { return row % 2; }),
+      makeFlatVector<int32_t>(20, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(20, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(20, [](auto row) { return row - 5; }),
+  });
+  std::string overClause = "partition by c0 order by c1";
+  std::string offsetError = "Offset must be at least 0";
+  assertWindowFunctionError({vectors}, "lag(c2, -1)", overClause, offsetError);
+  assertWindowFunctionError({vectors}, "lead(c2, c3)", overClause, offsetError);
+}
+
+}; // namespace
+}; // namespace facebook::velox::window::test
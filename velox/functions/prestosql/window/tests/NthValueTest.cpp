@@ -180,6 +180,26 @@ TEST_F(NthValueTest, nullOffsets) {
       {vectors}, "nth_value(c0, c2)", kSortOrderBasedOverClauses);
 }
 
+TEST_F(NthValueTest, ignoreNulls) {
+  vector_size_t size = 100;
+
+  auto vectors = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 5; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 7; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 3 + 1; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row % 11; }, nullEvery(3)),
+  });
+
+  testWindowFunction(
+      {vectors}, "nth_value(c3, c2 IGNORE NULLS)", kFrameOverClauses);
+  testWindowFunction(
+      {vectors},
+      "nth_value(c3, 2 IGNORE NULLS)",
+      kFrameOverClauses,
+      kRowsFrameClauses);
+}
+
 TEST_F(NthValueTest, offsetValues) {
   // Test values for offset < 1.
   vector_size_t size = 20;
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/functions/prestosql/window/tests/WindowTestBase.h"
 
 using namespace facebook::velox::exec::test;
@@ -89,5 +91,78 @@ TEST_F(RowNumberTest, randomInput) {
   testWindowFunction(vectors, "row_number()", overClauses);
 }
 
+TEST_F(RowNumberTest, streaming) {
+  // The sort keys are unique so that the row numbers are deterministic.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            100, [](auto row) { return row % 7; }, nullEvery(11)),
+        makeFlatVector<int64_t>(100, [&](auto row) { return i * 100 + row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  struct {
+    std::vector<std::string> sortingKeys;
+    std::string overClause;
+  } testSettings[] = {
+      {{"c0", "c1"}, "partition by c0 order by c1"},
+      {{"c0 DESC NULLS FIRST", "c1 DESC"}, "partition by c0 order by c1 desc"},
+      {{"c0", "c1"}, "partition by c0, c1"},
+      {{"c0", "c1"}, "order by c0, c1"},
+  };
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.overClause);
+    const auto functionSql =
+        fmt::format("row_number() over ({})", testData.overClause);
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .orderBy(testData.sortingKeys, false)
+                    .streamingWindow({functionSql})
+                    .planNode();
+    assertQuery(plan, fmt::format("SELECT c0, c1, {} FROM tmp", functionSql));
+  }
+}
+
+TEST_F(RowNumberTest, spill) {
+  // The sort keys are unique so that the row numbers are deterministic.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row % 17; }, nullEvery(13)),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> overClauses = {
+      "partition by c0 order by c1",
+      "partition by c0 order by c1 desc nulls first",
+      "partition by c0, c1",
+      "partition by c0 order by c0, c1",
+  };
+  for (const auto& overClause : overClauses) {
+    SCOPED_TRACE(overClause);
+    const auto functionSql = fmt::format("row_number() over ({})", overClause);
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(
+            PlanBuilder().values(vectors).window({functionSql}).planNode(),
+            duckDbQueryRunner_)
+            .spillDirectory(spillDirectory->path)
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kWindowSpillEnabled, "true")
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .assertResults(
+                fmt::format("SELECT c0, c1, {} FROM tmp", functionSql));
+    auto stats = task->taskStats().pipelineStats;
+    ASSERT_LT(0, stats[0].operatorStats[1].spilledBytes);
+    ASSERT_LT(1, stats[0].operatorStats[1].spilledPartitions);
+  }
+}
+
 }; // namespace
 }; // namespace facebook::velox::window::test
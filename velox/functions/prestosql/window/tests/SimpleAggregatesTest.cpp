@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/functions/prestosql/window/tests/WindowTestBase.h"
 
 using namespace facebook::velox::exec::test;
@@ -44,6 +46,38 @@ class SimpleAggregatesTest : public WindowTestBase {
     });
   }
 
+  // Makes vectors with the unique sort key c1, null values in c2 and the
+  // frame offset columns c3, c4 and c5 for k PRECEDING and k FOLLOWING
+  // frames. c5 has a different offset on each row.
+  RowVectorPtr makeFrameOffsetVectors(vector_size_t size, int32_t c0Modulus) {
+    return makeRowVector({
+        makeFlatVector<int32_t>(
+            size, [&](auto row) -> int32_t { return row % c0Modulus; }),
+        makeFlatVector<int32_t>(size, [](auto row) -> int32_t { return row; }),
+        makeFlatVector<int32_t>(
+            size, [](auto row) -> int32_t { return row % 13; }, nullEvery(5)),
+        makeFlatVector<int64_t>(size, [](auto /*row*/) { return 2; }),
+        makeFlatVector<int64_t>(size, [](auto /*row*/) { return 40; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row % 30; }),
+    });
+  }
+
+  // Makes vectors like makeFrameOffsetVectors() but with the sort key c1
+  // having duplicate and null values for RANGE frames.
+  RowVectorPtr makeRangeOffsetVectors(vector_size_t size, int32_t c0Modulus) {
+    return makeRowVector({
+        makeFlatVector<int32_t>(
+            size, [&](auto row) -> int32_t { return row % c0Modulus; }),
+        makeFlatVector<int32_t>(
+            size, [](auto row) -> int32_t { return row / 3; }, nullEvery(11)),
+        makeFlatVector<int32_t>(
+            size, [](auto row) -> int32_t { return row % 13; }, nullEvery(5)),
+        makeFlatVector<int64_t>(size, [](auto /*row*/) { return 2; }),
+        makeFlatVector<int64_t>(size, [](auto /*row*/) { return 40; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row % 30; }),
+    });
+  }
+
   void testWindowFunction(
       const std::vector<RowVectorPtr>& vectors,
       const std::vector<std::string>& overClauses,
@@ -134,6 +168,100 @@ TEST_P(MultiAggregatesTest, singlePartitionRowFrames) {
       {makeSinglePartitionVector(100)}, kFrameOverClauses, kRowsFrameClauses);
 }
 
+TEST_P(MultiAggregatesTest, kRowFrames) {
+  // The frames slide for constant offsets, and have varying sizes for c5.
+  // Empty frames are at the start or end of partitions for the frames
+  // between 2 offsets on the same side of the current row.
+  static const std::vector<std::string> kFrameClauses = {
+      "rows between c3 preceding and current row",
+      "rows between c4 preceding and current row",
+      "rows between c3 preceding and c3 following",
+      "rows between current row and c4 following",
+      "rows between c4 preceding and c3 preceding",
+      "rows between c3 following and c4 following",
+      "rows between unbounded preceding and c3 following",
+      "rows between c5 preceding and c3 following",
+      "rows between c3 preceding and c5 following",
+  };
+  SimpleAggregatesTest::testWindowFunction(
+      {makeFrameOffsetVectors(100, 2)},
+      {"partition by c0 order by c1",
+       "partition by c0 order by c1 desc",
+       "order by c1"},
+      kFrameClauses);
+
+  // A large partition is output in multiple blocks.
+  SimpleAggregatesTest::testWindowFunction(
+      {makeFrameOffsetVectors(5'000, 1)},
+      {"partition by c0 order by c1"},
+      kFrameClauses);
+}
+
+TEST_P(MultiAggregatesTest, kRangeFrames) {
+  static const std::vector<std::string> kFrameClauses = {
+      "range between c3 preceding and current row",
+      "range between c4 preceding and current row",
+      "range between c3 preceding and c3 following",
+      "range between current row and c4 following",
+      "range between c4 preceding and c3 preceding",
+      "range between c3 following and c4 following",
+      "range between unbounded preceding and c3 following",
+      "range between c5 preceding and c3 following",
+      "range between c3 preceding and c5 following",
+  };
+  SimpleAggregatesTest::testWindowFunction(
+      {makeRangeOffsetVectors(100, 2)},
+      {"partition by c0 order by c1",
+       "partition by c0 order by c1 desc",
+       "partition by c0 order by c1 nulls first",
+       "order by c1 desc nulls first"},
+      kFrameClauses);
+
+  // A large partition is output in multiple blocks.
+  SimpleAggregatesTest::testWindowFunction(
+      {makeRangeOffsetVectors(5'000, 1)},
+      {"partition by c0 order by c1"},
+      kFrameClauses);
+
+  assertWindowFunctionError(
+      {makeRangeOffsetVectors(10, 2)},
+      function_,
+      "partition by c0 order by c1, c2 range between c3 preceding and "
+      "current row",
+      "k PRECEDING and k FOLLOWING in RANGE mode require a single ORDER BY "
+      "key");
+}
+
+TEST_P(MultiAggregatesTest, parallelPartitions) {
+  // The partitions are split between the threads in small output batches so
+  // that each thread computes several batches and partitions.
+  const std::vector<std::string> functionSqls = {
+      fmt::format("{} over (partition by c0 order by c1)", function_),
+      fmt::format(
+          "{} over (partition by c0 order by c1 desc "
+          "range between c3 preceding and c4 following)",
+          function_),
+      fmt::format("{} over (partition by c0)", function_),
+      fmt::format("{} over (order by c1, c2)", function_),
+  };
+  for (auto numPartitions : {1, 2, 7, 100}) {
+    SCOPED_TRACE(numPartitions);
+    std::vector<RowVectorPtr> vectors = {
+        makeRangeOffsetVectors(5'000, numPartitions)};
+    createDuckDbTable(vectors);
+    for (const auto& functionSql : functionSqls) {
+      SCOPED_TRACE(functionSql);
+      AssertQueryBuilder(
+          PlanBuilder().values(vectors).window({functionSql}).planNode(),
+          duckDbQueryRunner_)
+          .config(core::QueryConfig::kWindowParallelism, "4")
+          .config(core::QueryConfig::kPreferredOutputBatchSize, "100")
+          .assertResults(fmt::format(
+              "SELECT c0, c1, c2, c3, c4, c5, {} FROM tmp", functionSql));
+    }
+  }
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     SimpleAggregatesTest,
     MultiAggregatesTest,
@@ -143,6 +271,7 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
          std::string("max(c2)"),
          std::string("count(c2)"),
          std::string("avg(c2)"),
+         std::string("var_samp(c2)"),
          std::string("sum(1)")}));
 
 class StringAggregatesTest : public WindowTestBase {};
@@ -15,6 +15,8 @@
  */
 #include "velox/functions/sparksql/Hash.h"
 
+#include <type_traits>
+
 #include <folly/CPortability.h>
 
 #include "velox/common/base/BitUtil.h"
@@ -24,6 +26,44 @@
 namespace facebook::velox::functions::sparksql {
 namespace {
 
+// Updates 'rawResults' with the hash of the 'selected' rows of one input
+// column, using the current results as seeds. Flat columns are read straight
+// from their values in a loop without indirection and constant columns read
+// their value once.
+template <typename InputType, typename ReturnType, typename HashFn>
+void hashColumn(
+    const SelectivityVector& selected,
+    const DecodedVector& decoded,
+    ReturnType* rawResults,
+    HashFn hashFn) {
+  // Flat bool values are bits and go through valueAt.
+  if constexpr (!std::is_same_v<InputType, bool>) {
+    if (decoded.isIdentityMapping()) {
+      const auto* rawValues = decoded.data<InputType>();
+      if (selected.isAllSelected()) {
+        for (auto row = selected.begin(); row < selected.end(); ++row) {
+          rawResults[row] = hashFn(rawValues[row], rawResults[row]);
+        }
+      } else {
+        selected.applyToSelected([&](auto row) {
+          rawResults[row] = hashFn(rawValues[row], rawResults[row]);
+        });
+      }
+      return;
+    }
+  }
+  if (decoded.isConstantMapping()) {
+    const auto value = decoded.valueAt<InputType>(selected.begin());
+    selected.applyToSelected(
+        [&](auto row) { rawResults[row] = hashFn(value, rawResults[row]); });
+    return;
+  }
+  selected.applyToSelected([&](auto row) {
+    rawResults[row] =
+        hashFn(decoded.valueAt<InputType>(row), rawResults[row]);
+  });
+}
+
 // ReturnType can be either int32_t or int64_t
 // HashClass contains the function like hashInt32
 template <typename ReturnType, typename HashClass, typename SeedType>
@@ -37,6 +77,7 @@ void applyWithType(
 
   auto& result = *resultRef->as<FlatVector<ReturnType>>();
   rows.applyToSelected([&](int row) { result.set(row, kSeed); });
+  auto* rawResults = result.mutableRawValues();
 
   exec::LocalSelectivityVector selectedMinusNulls(context);
 
@@ -55,10 +96,10 @@ void applyWithType(
 // https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
 #define CASE(typeEnum, hashFn, inputType)                                      \
   case TypeKind::typeEnum:                                                     \
-    selected->applyToSelected([&](int row) {                                   \
-      result.set(                                                              \
-          row, hashFn(decoded->valueAt<inputType>(row), result.valueAt(row))); \
-    });                                                                        \
+    hashColumn<inputType>(                                                     \
+        *selected, *decoded, rawResults, [&](auto value, auto seed) {          \
+          return static_cast<ReturnType>(hashFn(value, seed));                 \
+        });                                                                    \
     break;
       CASE(BOOLEAN, hash.hashInt32, bool);
       CASE(TINYINT, hash.hashInt32, int8_t);
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/sparksql/Register.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+namespace facebook::velox::functions::sparksql {
+namespace {
+
+// Evaluates 'functionName' over 'numColumns' flat columns of 'type' with 10%
+// nulls.
+int hashColumns(
+    int iters,
+    const std::string& functionName,
+    const TypePtr& type,
+    int numColumns) {
+  folly::BenchmarkSuspender kSuspender;
+  test::FunctionBenchmarkBase benchmarkBase;
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 10'000;
+  opts.nullRatio = 0.1;
+  VectorFuzzer fuzzer(opts, benchmarkBase.pool());
+  std::vector<VectorPtr> columns;
+  std::string exprStr = functionName + "(";
+  for (auto i = 0; i < numColumns; ++i) {
+    columns.push_back(fuzzer.fuzzFlat(type));
+    exprStr += fmt::format("{}c{}", i > 0 ? ", " : "", i);
+  }
+  exprStr += ")";
+  const auto data = benchmarkBase.maker().rowVector(columns);
+  exec::ExprSet expr = benchmarkBase.compileExpression(exprStr, data->type());
+  kSuspender.dismiss();
+  for (auto i = 0; i != iters; ++i) {
+    benchmarkBase.evaluate(expr, data);
+  }
+  return iters * opts.vectorSize;
+}
+
+BENCHMARK_NAMED_PARAM_MULTI(hashColumns, hash_bigint, "hash", BIGINT(), 1);
+BENCHMARK_NAMED_PARAM_MULTI(hashColumns, hash_4_bigints, "hash", BIGINT(), 4);
+BENCHMARK_NAMED_PARAM_MULTI(hashColumns, hash_4_integers, "hash", INTEGER(), 4);
+BENCHMARK_NAMED_PARAM_MULTI(hashColumns, hash_varchar, "hash", VARCHAR(), 1);
+BENCHMARK_NAMED_PARAM_MULTI(
+    hashColumns,
+    xxhash64_bigint,
+    "xxhash64",
+    BIGINT(),
+    1);
+BENCHMARK_NAMED_PARAM_MULTI(
+    hashColumns,
+    xxhash64_4_bigints,
+    "xxhash64",
+    BIGINT(),
+    4);
+BENCHMARK_NAMED_PARAM_MULTI(
+    hashColumns,
+    xxhash64_varchar,
+    "xxhash64",
+    VARCHAR(),
+    1);
+
+} // namespace
+} // namespace facebook::velox::functions::sparksql
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  facebook::velox::functions::sparksql::registerFunctions("");
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/row/UnsafeRowBatchSerializer.h"
+#include "velox/row/UnsafeRow.h"
+#include "velox/row/UnsafeRowDynamicSerializer.h"
+
+namespace facebook::velox::row {
+namespace {
+
+size_t fixedRowSize(const RowVector& data) {
+  const auto numFields = data.childrenSize();
+  return UnsafeRow::getNullLength(numFields) +
+      numFields * UnsafeRow::kFieldWidthBytes;
+}
+
+FOLLY_ALWAYS_INLINE void
+writeOffsetAndSize(char* field, size_t offset, size_t size) {
+  *reinterpret_cast<uint64_t*>(field) = offset << 32 | size;
+}
+
+template <TypeKind Kind, typename T>
+FOLLY_ALWAYS_INLINE void writeField(char* field, const T& value) {
+  if constexpr (Kind == TypeKind::TIMESTAMP) {
+    *reinterpret_cast<int64_t*>(field) = value.toMicros();
+  } else {
+    *reinterpret_cast<T*>(field) = value;
+  }
+}
+} // namespace
+
+UnsafeRowBatchSerializer::UnsafeRowBatchSerializer(RowVectorPtr data)
+    : data_(std::move(data)),
+      fixedSize_(fixedRowSize(*data_)),
+      decoded_(data_->childrenSize()) {
+  const auto numRows = data_->size();
+  // Null rows have size 0. All other rows have at least 'fixedSize_' bytes.
+  rowSizes_.resize(numRows, fixedSize_);
+  if (data_->mayHaveNulls()) {
+    for (auto row = 0; row < numRows; ++row) {
+      if (data_->isNullAt(row)) {
+        rowSizes_[row] = 0;
+      }
+    }
+  }
+
+  const SelectivityVector allRows(numRows);
+  const auto& rowType = data_->type();
+  for (column_index_t column = 0; column < data_->childrenSize(); ++column) {
+    const auto& type = rowType->childAt(column);
+    const auto& child = data_->childAt(column);
+    auto& decoded = decoded_[column];
+    decoded.decode(*child, allRows);
+    if (type->isFixedWidth()) {
+      continue;
+    }
+    if (type->kind() == TypeKind::VARCHAR ||
+        type->kind() == TypeKind::VARBINARY) {
+      for (auto row = 0; row < numRows; ++row) {
+        if (rowSizes_[row] && !decoded.isNullAt(row)) {
+          rowSizes_[row] += UnsafeRow::alignToFieldWidth(
+              decoded.valueAt<StringView>(row).size());
+        }
+      }
+      continue;
+    }
+    UnsafeRowDynamicSerializer::preloadVector(child);
+    for (auto row = 0; row < numRows; ++row) {
+      if (rowSizes_[row] && !decoded.isNullAt(row)) {
+        rowSizes_[row] += UnsafeRow::alignToFieldWidth(
+            UnsafeRowDynamicSerializer::getSize(type, child, row));
+      }
+    }
+  }
+}
+
+template <TypeKind Kind>
+void UnsafeRowBatchSerializer::writeFixedWidth(
+    column_index_t column,
+    folly::Range<const vector_size_t*> rows,
+    folly::Range<char* const*> buffers) const {
+  using T = typename TypeTraits<Kind>::NativeType;
+  const auto& decoded = decoded_[column];
+  const auto fieldOffset = UnsafeRow::getNullLength(decoded_.size()) +
+      column * UnsafeRow::kFieldWidthBytes;
+  if constexpr (Kind != TypeKind::BOOLEAN) {
+    // Flat columns without nulls are copied from their values in a loop
+    // without branches.
+    if (decoded.isIdentityMapping() && !decoded.mayHaveNulls() &&
+        !data_->mayHaveNulls()) {
+      const auto* values = decoded.data<T>();
+      for (auto i = 0; i < rows.size(); ++i) {
+        writeField<Kind>(buffers[i] + fieldOffset, values[rows[i]]);
+      }
+      return;
+    }
+  }
+  for (auto i = 0; i < rows.size(); ++i) {
+    const auto row = rows[i];
+    if (rowSizes_[row] && !decoded.isNullAt(row)) {
+      writeField<Kind>(buffers[i] + fieldOffset, decoded.valueAt<T>(row));
+    }
+  }
+}
+
+void UnsafeRowBatchSerializer::serialize(
+    folly::Range<const vector_size_t*> rows,
+    folly::Range<char* const*> buffers) const {
+  VELOX_CHECK_EQ(rows.size(), buffers.size());
+  const auto numColumns = decoded_.size();
+  const auto nullLength = UnsafeRow::getNullLength(numColumns);
+
+  // Clears the null bits and the field slots, then sets the null bits.
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (rowSizes_[rows[i]]) {
+      memset(buffers[i], 0, fixedSize_);
+    }
+  }
+  for (column_index_t column = 0; column < numColumns; ++column) {
+    const auto& decoded = decoded_[column];
+    if (!decoded.mayHaveNulls()) {
+      continue;
+    }
+    for (auto i = 0; i < rows.size(); ++i) {
+      const auto row = rows[i];
+      if (rowSizes_[row] && decoded.isNullAt(row)) {
+        bits::setBit(buffers[i], column);
+      }
+    }
+  }
+
+  // Offset of the next variable width value in each row.
+  std::vector<size_t> variableOffsets(rows.size(), fixedSize_);
+  const auto& rowType = data_->type();
+  for (column_index_t column = 0; column < numColumns; ++column) {
+    const auto& type = rowType->childAt(column);
+    const auto& decoded = decoded_[column];
+    const auto fieldOffset = nullLength + column * UnsafeRow::kFieldWidthBytes;
+    switch (type->kind()) {
+#define FIXED_WIDTH(kind)                                   \
+  case TypeKind::kind:                                      \
+    writeFixedWidth<TypeKind::kind>(column, rows, buffers); \
+    break
+      FIXED_WIDTH(BOOLEAN);
+      FIXED_WIDTH(TINYINT);
+      FIXED_WIDTH(SMALLINT);
+      FIXED_WIDTH(INTEGER);
+      FIXED_WIDTH(BIGINT);
+      FIXED_WIDTH(REAL);
+      FIXED_WIDTH(DOUBLE);
+      FIXED_WIDTH(TIMESTAMP);
+      FIXED_WIDTH(DATE);
+#undef FIXED_WIDTH
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        for (auto i = 0; i < rows.size(); ++i) {
+          const auto row = rows[i];
+          if (!rowSizes_[row] || decoded.isNullAt(row)) {
+            continue;
+          }
+          const auto value = decoded.valueAt<StringView>(row);
+          const auto size = value.size();
+          const auto paddedSize = UnsafeRow::alignToFieldWidth(size);
+          auto& offset = variableOffsets[i];
+          char* buffer = buffers[i];
+          writeOffsetAndSize(buffer + fieldOffset, offset, size);
+          if (paddedSize > size) {
+            // Zeros the padding. The value overwrites the rest of the word.
+            *reinterpret_cast<uint64_t*>(
+                buffer + offset + paddedSize - UnsafeRow::kFieldWidthBytes) =
+                0;
+          }
+          memcpy(buffer + offset, value.data(), size);
+          offset += paddedSize;
+        }
+        break;
+      case TypeKind::ARRAY:
+      case TypeKind::MAP:
+      case TypeKind::ROW: {
+        const auto& child = data_->childAt(column);
+        for (auto i = 0; i < rows.size(); ++i) {
+          const auto row = rows[i];
+          if (!rowSizes_[row] || decoded.isNullAt(row)) {
+            continue;
+          }
+          const auto paddedSize = UnsafeRow::alignToFieldWidth(
+              UnsafeRowDynamicSerializer::getSize(type, child, row));
+          auto& offset = variableOffsets[i];
+          char* buffer = buffers[i];
+          memset(buffer + offset, 0, paddedSize);
+          const auto size = UnsafeRowDynamicSerializer::serialize(
+              type, child, buffer + offset, row);
+          VELOX_DCHECK(size.has_value());
+          VELOX_DCHECK_LE(size.value(), paddedSize);
+          writeOffsetAndSize(buffer + fieldOffset, offset, size.value());
+          offset += paddedSize;
+        }
+        break;
+      }
+      default:
+        VELOX_UNSUPPORTED("Unsupported type: {}", type->toString());
+    }
+  }
+}
+
+} // namespace facebook::velox::row
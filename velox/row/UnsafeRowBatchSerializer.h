@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::row {
+
+/// Serializes the rows of a RowVector into UnsafeRows a column at a time. The
+/// constructor computes the sizes of all rows in one pass over each column.
+/// serialize() then writes each top level column into all the rows before
+/// moving on to the next column, so that the vectors are decoded and the type
+/// is dispatched once per column and not once per value. Fixed width and
+/// string columns are written directly from their DecodedVectors. ARRAY, MAP
+/// and ROW columns are written value by value with UnsafeRowDynamicSerializer.
+/// The output is the same as that of UnsafeRowDynamicSerializer, except that
+/// the unused bytes of fixed width fields and the padding of variable width
+/// values are always zero.
+class UnsafeRowBatchSerializer {
+ public:
+  explicit UnsafeRowBatchSerializer(RowVectorPtr data);
+
+  /// Returns the size in bytes of the UnsafeRow for 'row'. This is 0 if the
+  /// row is null.
+  size_t rowSize(vector_size_t row) const {
+    return rowSizes_[row];
+  }
+
+  /// Writes the UnsafeRow for rows[i] at buffers[i] for all i. Each buffer
+  /// must have at least rowSize(rows[i]) bytes.
+  void serialize(
+      folly::Range<const vector_size_t*> rows,
+      folly::Range<char* const*> buffers) const;
+
+ private:
+  // Writes the values of the fixed width column 'column' into its field slot
+  // in each of 'buffers'.
+  template <TypeKind Kind>
+  void writeFixedWidth(
+      column_index_t column,
+      folly::Range<const vector_size_t*> rows,
+      folly::Range<char* const*> buffers) const;
+
+  const RowVectorPtr data_;
+
+  // Size of the null bits and the field slots of each row.
+  const size_t fixedSize_;
+
+  std::vector<DecodedVector> decoded_;
+
+  std::vector<size_t> rowSizes_;
+};
+
+} // namespace facebook::velox::row
@@ -18,7 +18,9 @@
 #include <folly/init/Init.h>
 #include <random>
 
+#include "velox/row/UnsafeRow24Deserializer.h"
 #include "velox/row/UnsafeRowBatchDeserializer.h"
+#include "velox/row/UnsafeRowBatchSerializer.h"
 #include "velox/row/UnsafeRowDeserializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
 #include "velox/type/Type.h"
@@ -69,10 +71,76 @@ class UnsaferowBatchDeserializer : public Deserializer {
   std::shared_ptr<memory::MemoryPool> pool_ = memory::getDefaultMemoryPool();
 };
 
+// Deserializes a column at a time.
+class Unsaferow24Deserializer : public Deserializer {
+ public:
+  void deserialize(
+      const std::vector<std::optional<std::string_view>>& data,
+      const TypePtr& type) override {
+    std::vector<const char*> rows(data.size());
+    for (auto i = 0; i < data.size(); ++i) {
+      rows[i] = data[i].has_value() ? data[i]->data() : nullptr;
+    }
+    UnsafeRow24Deserializer::Create(asRowType(type))
+        ->DeserializeRows(pool_.get(), rows);
+  }
+
+ private:
+  std::shared_ptr<memory::MemoryPool> pool_ = memory::getDefaultMemoryPool();
+};
+
+class Serializer {
+ public:
+  virtual ~Serializer() = default;
+
+  // Serializes all rows of 'data' into consecutive UnsafeRows in 'buffer'.
+  virtual void serialize(const RowVectorPtr& data, std::string& buffer) = 0;
+};
+
+// Serializes a row at a time.
+class UnsaferowSerializer : public Serializer {
+ public:
+  void serialize(const RowVectorPtr& data, std::string& buffer) override {
+    const auto& type = data->type();
+    size_t totalSize = 0;
+    for (auto i = 0; i < data->size(); ++i) {
+      totalSize += UnsafeRowDynamicSerializer::getSizeRow(type, data.get(), i);
+    }
+    buffer.resize(totalSize);
+    size_t offset = 0;
+    for (auto i = 0; i < data->size(); ++i) {
+      offset += UnsafeRowDynamicSerializer::serialize(
+                    type, data, buffer.data() + offset, i)
+                    .value_or(0);
+    }
+  }
+};
+
+// Serializes a column at a time.
+class UnsaferowBatchSerializer : public Serializer {
+ public:
+  void serialize(const RowVectorPtr& data, std::string& buffer) override {
+    UnsafeRowBatchSerializer serializer(data);
+    std::vector<vector_size_t> rows(data->size());
+    std::vector<char*> buffers(data->size());
+    size_t totalSize = 0;
+    for (auto i = 0; i < data->size(); ++i) {
+      totalSize += serializer.rowSize(i);
+    }
+    buffer.resize(totalSize);
+    size_t offset = 0;
+    for (auto i = 0; i < data->size(); ++i) {
+      rows[i] = i;
+      buffers[i] = buffer.data() + offset;
+      offset += serializer.rowSize(i);
+    }
+    serializer.serialize(rows, buffers);
+  }
+};
+
 class BenchmarkHelper {
  public:
-  std::tuple<std::vector<std::optional<std::string_view>>, TypePtr>
-  randomUnsaferows(int nFields, int nRows, bool stringOnly) {
+  RowTypePtr randomRowType(int nFields, bool stringOnly) {
     RowTypePtr rowType;
     std::vector<std::string> names;
     std::vector<TypePtr> types;
@@ -89,17 +157,21 @@ class BenchmarkHelper {
     }
     rowType =
         TypeFactory<TypeKind::ROW>::create(std::move(names), std::move(types));
+    return rowType;
+  }
 
-    VectorFuzzer::Options opts;
-    opts.vectorSize = 1;
-    opts.nullRatio = 0.1;
-    opts.stringVariableLength = true;
-    opts.stringLength = 20;
-    // Spark uses microseconds to store timestamp
-    opts.useMicrosecondPrecisionTimestamp = true;
+  RowVectorPtr randomRowVector(int nFields, int nRows, bool stringOnly) {
+    auto rowType = randomRowType(nFields, stringOnly);
+    VectorFuzzer fuzzer(
+        fuzzerOptions(nRows), pool_.get(), folly::Random::rand32());
+    return fuzzer.fuzzRow(rowType);
+  }
 
+  std::tuple<std::vector<std::optional<std::string_view>>, TypePtr>
+  randomUnsaferows(int nFields, int nRows, bool stringOnly) {
+    auto rowType = randomRowType(nFields, stringOnly);
     auto seed = folly::Random::rand32();
-    VectorFuzzer fuzzer(opts, pool_.get(), seed);
+    VectorFuzzer fuzzer(fuzzerOptions(1), pool_.get(), seed);
     const auto& inputVector = fuzzer.fuzzRow(rowType);
     std::vector<std::optional<std::string_view>> results;
     results.reserve(nRows);
@@ -111,11 +183,23 @@ class BenchmarkHelper {
       auto rowSize = UnsafeRowDynamicSerializer::serialize(
           rowType, inputVector, buffer, /*idx=*/0);
       results.push_back(std::string_view(buffer, rowSize.value()));
+      buffers_.push_back(std::move(bufferPtr));
     }
     return {results, rowType};
   }
 
  private:
+  static VectorFuzzer::Options fuzzerOptions(int nRows) {
+    VectorFuzzer::Options opts;
+    opts.vectorSize = nRows;
+    opts.nullRatio = 0.1;
+    opts.stringVariableLength = true;
+    opts.stringLength = 20;
+    // Spark uses microseconds to store timestamp
+    opts.useMicrosecondPrecisionTimestamp = true;
+    return opts;
+  }
+
   std::vector<TypePtr> allTypes_{
       BOOLEAN(),
       TINYINT(),
@@ -131,6 +215,9 @@ class BenchmarkHelper {
       ROW({INTEGER()})};
 
   std::shared_ptr<memory::MemoryPool> pool_ = memory::getDefaultMemoryPool();
+
+  // Holds the rows returned by randomUnsaferows().
+  std::vector<BufferPtr> buffers_;
 };
 
 int deserialize(
@@ -151,6 +238,26 @@ int deserialize(
   return nIters * nFields * nRows;
 }
 
+int serialize(
+    int nIters,
+    int nFields,
+    int nRows,
+    bool stringOnly,
+    std::unique_ptr<Serializer> serializer) {
+  folly::BenchmarkSuspender suspender;
+  BenchmarkHelper helper;
+  auto data = helper.randomRowVector(nFields, nRows, stringOnly);
+  UnsafeRowDynamicSerializer::preloadVector(data);
+  std::string buffer;
+  suspender.dismiss();
+
+  for (int i = 0; i < nIters; i++) {
+    serializer->serialize(data, buffer);
+  }
+
+  return nIters * nFields * nRows;
+}
+
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
     row_10_100k_string_only,
@@ -165,6 +272,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     true,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_10_100k_string_only,
+    10,
+    100000,
+    true,
+    std::make_unique<Unsaferow24Deserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -180,6 +294,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     true,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_100_100k_string_only,
+    100,
+    100000,
+    true,
+    std::make_unique<Unsaferow24Deserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -195,6 +316,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     false,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_10_100k_all_types,
+    10,
+    100000,
+    false,
+    std::make_unique<Unsaferow24Deserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -210,6 +338,58 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     false,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_100_100k_all_types,
+    100,
+    100000,
+    false,
+    std::make_unique<Unsaferow24Deserializer>());
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_10_100k_string_only,
+    10,
+    100000,
+    true,
+    std::make_unique<UnsaferowSerializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    batch_10_100k_string_only,
+    10,
+    100000,
+    true,
+    std::make_unique<UnsaferowBatchSerializer>());
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_10_100k_all_types,
+    10,
+    100000,
+    false,
+    std::make_unique<UnsaferowSerializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    batch_10_100k_all_types,
+    10,
+    100000,
+    false,
+    std::make_unique<UnsaferowBatchSerializer>());
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_100_100k_all_types,
+    100,
+    100000,
+    false,
+    std::make_unique<UnsaferowSerializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    batch_100_100k_all_types,
+    100,
+    100000,
+    false,
+    std::make_unique<UnsaferowBatchSerializer>());
 
 } // namespace
 } // namespace facebook::spark::benchmarks
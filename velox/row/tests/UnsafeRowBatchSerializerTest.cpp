@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/row/UnsafeRowBatchSerializer.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/row/UnsafeRow24Deserializer.h"
+#include "velox/row/UnsafeRowDynamicSerializer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+namespace facebook::velox::row {
+namespace {
+
+using namespace facebook::velox::test;
+
+class UnsafeRowBatchSerializerTest : public ::testing::Test,
+                                     public VectorTestBase {
+ protected:
+  // Serializes all rows of 'data' into one buffer and returns it. Fills
+  // 'rowPointers' with the start of each row.
+  std::string serializeBatch(
+      const RowVectorPtr& data,
+      const UnsafeRowBatchSerializer& serializer,
+      std::vector<const char*>& rowPointers) {
+    std::vector<vector_size_t> rows(data->size());
+    std::vector<size_t> offsets(data->size());
+    size_t totalSize = 0;
+    for (auto i = 0; i < data->size(); ++i) {
+      rows[i] = i;
+      offsets[i] = totalSize;
+      totalSize += serializer.rowSize(i);
+    }
+    // Garbage in the buffer checks that all bytes of the rows are written.
+    std::string buffer(totalSize, '\xff');
+    std::vector<char*> buffers(data->size());
+    rowPointers.resize(data->size());
+    for (auto i = 0; i < data->size(); ++i) {
+      buffers[i] = buffer.data() + offsets[i];
+      rowPointers[i] = serializer.rowSize(i) == 0 ? nullptr : buffers[i];
+    }
+    serializer.serialize(rows, buffers);
+    return buffer;
+  }
+};
+
+TEST_F(UnsafeRowBatchSerializerTest, fuzzer) {
+  auto rowType = ROW(
+      {BOOLEAN(),
+       TINYINT(),
+       SMALLINT(),
+       INTEGER(),
+       BIGINT(),
+       REAL(),
+       DOUBLE(),
+       VARCHAR(),
+       TIMESTAMP(),
+       DATE(),
+       ROW({VARCHAR(), INTEGER()}),
+       ARRAY(INTEGER()),
+       MAP(VARCHAR(), ARRAY(INTEGER()))});
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 100;
+  opts.nullRatio = 0.1;
+  opts.containerHasNulls = false;
+  opts.dictionaryHasNulls = false;
+  opts.stringVariableLength = true;
+  opts.stringLength = 20;
+  // Spark uses microseconds to store timestamp
+  opts.useMicrosecondPrecisionTimestamp = true;
+  opts.containerLength = 10;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  SCOPED_TRACE(fmt::format("seed: {}", seed));
+  VectorFuzzer fuzzer(opts, pool_.get(), seed);
+
+  for (auto iteration = 0; iteration < 10; ++iteration) {
+    auto data = fuzzer.fuzzRow(rowType);
+    UnsafeRowBatchSerializer serializer(data);
+    std::vector<const char*> rowPointers;
+    auto buffer = serializeBatch(data, serializer, rowPointers);
+
+    // Each row must be the same as the row serialized on its own.
+    UnsafeRowDynamicSerializer::preloadVector(data);
+    for (auto i = 0; i < data->size(); ++i) {
+      const auto rowSize = serializer.rowSize(i);
+      ASSERT_EQ(
+          UnsafeRowDynamicSerializer::getSizeRow(rowType, data.get(), i),
+          rowSize);
+      std::string expected(rowSize, '\0');
+      UnsafeRowDynamicSerializer::serialize(rowType, data, expected.data(), i);
+      ASSERT_EQ(expected, std::string(rowPointers[i], rowSize)) << "at " << i;
+    }
+
+    auto result = UnsafeRow24Deserializer::Create(rowType)->DeserializeRows(
+        pool_.get(), rowPointers);
+    assertEqualVectors(data, result);
+  }
+}
+
+TEST_F(UnsafeRowBatchSerializerTest, nullsAndPadding) {
+  auto data = makeRowVector(
+      {makeNullableFlatVector<int64_t>({1, std::nullopt, 3, 4}),
+       makeNullableFlatVector<StringView>(
+           {"a"_sv,
+            "a string longer than a word"_sv,
+            std::nullopt,
+            "eightchr"_sv}),
+       makeNullableFlatVector<bool>({true, false, std::nullopt, true})},
+      [](auto row) { return row == 3; });
+  UnsafeRowBatchSerializer serializer(data);
+
+  // 8 bytes of null bits and 3 fields of 8 bytes each.
+  EXPECT_EQ(32 + 8, serializer.rowSize(0));
+  EXPECT_EQ(32 + 32, serializer.rowSize(1));
+  EXPECT_EQ(32, serializer.rowSize(2));
+  EXPECT_EQ(0, serializer.rowSize(3));
+
+  std::vector<const char*> rowPointers;
+  auto buffer = serializeBatch(data, serializer, rowPointers);
+  EXPECT_EQ(nullptr, rowPointers[3]);
+
+  // The padding after "a" is zero.
+  EXPECT_EQ(
+      std::string("a\0\0\0\0\0\0\0", 8), std::string(rowPointers[0] + 32, 8));
+  EXPECT_EQ(0b0001, *reinterpret_cast<const uint64_t*>(rowPointers[1]));
+  EXPECT_EQ(0b0110, *reinterpret_cast<const uint64_t*>(rowPointers[2]));
+
+  auto result = UnsafeRow24Deserializer::Create(asRowType(data->type()))
+                    ->DeserializeRows(pool_.get(), rowPointers);
+  assertEqualVectors(data, result);
+
+  // A subset of the rows in a different order.
+  std::vector<vector_size_t> rows = {2, 0};
+  std::string subset(serializer.rowSize(2) + serializer.rowSize(0), '\xff');
+  std::vector<char*> buffers = {
+      subset.data(), subset.data() + serializer.rowSize(2)};
+  serializer.serialize(rows, buffers);
+  EXPECT_EQ(
+      std::string(rowPointers[2], serializer.rowSize(2)),
+      subset.substr(0, serializer.rowSize(2)));
+  EXPECT_EQ(
+      std::string(rowPointers[0], serializer.rowSize(0)),
+      subset.substr(serializer.rowSize(2)));
+}
+
+} // namespace
+} // namespace facebook::velox::row
@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/serializers/ColumnarSerializer.h"
+
+#include "velox/common/base/SimdUtil.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::serializer::columnar {
+namespace {
+constexpr int32_t kAlignment = ColumnarVectorSerde::kAlignment;
+
+// Number of bytes of nulls or booleans written for 'size' rows. Whole words
+// are written, since bits are read a word at a time.
+int64_t bitsBytes(vector_size_t size) {
+  return bits::nwords(size) * sizeof(uint64_t);
+}
+
+int64_t paddingAt(int64_t offset) {
+  return bits::roundUp(offset, kAlignment) - offset;
+}
+
+struct IOBufReleaser {
+  void addRef() const {}
+  void release() const {}
+
+  const std::shared_ptr<folly::IOBuf> iobuf;
+};
+
+class ColumnarVectorSerializer : public VectorSerializer {
+ public:
+  explicit ColumnarVectorSerializer(RowTypePtr type) : type_(std::move(type)) {}
+
+  void append(
+      RowVectorPtr vector,
+      const folly::Range<const IndexRange*>& ranges) override {
+    if (!rows_) {
+      rows_ = std::static_pointer_cast<RowVector>(
+          BaseVector::create(type_, 0, vector->pool()));
+    }
+    auto numRows = rows_->size();
+    std::vector<BaseVector::CopyRange> copyRanges;
+    copyRanges.reserve(ranges.size());
+    for (const auto& range : ranges) {
+      copyRanges.push_back({range.begin, numRows, range.size});
+      numRows += range.size;
+    }
+    rows_->resize(numRows);
+    rows_->copyRanges(vector.get(), copyRanges);
+  }
+
+  // Writes the number of rows and columns followed by the columns. Each
+  // column is its size, a null flag, the nulls if the flag is set and the
+  // data of its type.
+  void flush(OutputStream* out) override {
+    start_ = out->tellp();
+    const int32_t numRows = rows_ ? rows_->size() : 0;
+    writeInt32(numRows, out);
+    writeInt32(type_->size(), out);
+    if (numRows > 0) {
+      for (auto& child : rows_->children()) {
+        writeVector(*child, out);
+      }
+    }
+    // Space for reading the last buffer in SIMD batches.
+    writeZeros(simd::kPadding, out);
+  }
+
+ private:
+  void writeVector(const BaseVector& vector, OutputStream* out) {
+    const auto size = vector.size();
+    writeInt32(size, out);
+    const bool hasNulls = vector.rawNulls() != nullptr;
+    const char nullFlag = hasNulls;
+    out->write(&nullFlag, 1);
+    if (hasNulls) {
+      writeBuffer(vector.rawNulls(), bitsBytes(size), out);
+    }
+    switch (vector.typeKind()) {
+      case TypeKind::ROW: {
+        auto row = vector.as<RowVector>();
+        for (auto& child : row->children()) {
+          writeVector(*child, out);
+        }
+        break;
+      }
+      case TypeKind::ARRAY: {
+        auto array = vector.as<ArrayVector>();
+        writeBuffer(array->rawOffsets(), size * sizeof(vector_size_t), out);
+        writeBuffer(array->rawSizes(), size * sizeof(vector_size_t), out);
+        writeVector(*array->elements(), out);
+        break;
+      }
+      case TypeKind::MAP: {
+        auto map = vector.as<MapVector>();
+        writeBuffer(map->rawOffsets(), size * sizeof(vector_size_t), out);
+        writeBuffer(map->rawSizes(), size * sizeof(vector_size_t), out);
+        writeVector(*map->mapKeys(), out);
+        writeVector(*map->mapValues(), out);
+        break;
+      }
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        writeStrings(*vector.asFlatVector<StringView>(), out);
+        break;
+      case TypeKind::UNKNOWN:
+        break;
+      case TypeKind::BOOLEAN:
+        VELOX_CHECK_EQ(vector.encoding(), VectorEncoding::Simple::FLAT);
+        writeBuffer(vector.valuesAsVoid(), bitsBytes(size), out);
+        break;
+      default:
+        VELOX_CHECK_EQ(vector.encoding(), VectorEncoding::Simple::FLAT);
+        writeBuffer(
+            vector.valuesAsVoid(), size * vector.type()->cppSizeInBytes(), out);
+    }
+  }
+
+  // Writes the lengths of the strings, zero for nulls, and their total
+  // followed by the concatenated bytes.
+  void writeStrings(const FlatVector<StringView>& vector, OutputStream* out) {
+    const auto size = vector.size();
+    auto rawValues = vector.rawValues();
+    std::vector<int32_t> lengths(size);
+    int64_t totalLength = 0;
+    for (auto i = 0; i < size; ++i) {
+      lengths[i] = vector.isNullAt(i) ? 0 : rawValues[i].size();
+      totalLength += lengths[i];
+    }
+    writeBuffer(lengths.data(), size * sizeof(int32_t), out);
+    writeInt64(totalLength, out);
+    writeZeros(paddingAt(out->tellp() - start_), out);
+    for (auto i = 0; i < size; ++i) {
+      out->write(rawValues[i].data(), lengths[i]);
+    }
+  }
+
+  void writeBuffer(const void* data, int64_t size, OutputStream* out) {
+    writeZeros(paddingAt(out->tellp() - start_), out);
+    out->write(reinterpret_cast<const char*>(data), size);
+  }
+
+  static void writeInt32(int32_t value, OutputStream* out) {
+    out->write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  static void writeInt64(int64_t value, OutputStream* out) {
+    out->write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  static void writeZeros(int32_t size, OutputStream* out) {
+    static const char kZeros[simd::kPadding]{};
+    VELOX_DCHECK_LE(size, simd::kPadding);
+    out->write(kZeros, size);
+  }
+
+  const RowTypePtr type_;
+
+  // The appended rows. Created from the pool of the first appended vector.
+  RowVectorPtr rows_;
+
+  // Position of the page in the output stream of flush().
+  int64_t start_{0};
+};
+
+// Reads the page written by ColumnarVectorSerializer from 'source'.
+class PageReader {
+ public:
+  PageReader(ByteStream* source, memory::MemoryPool* pool)
+      : source_(source), pool_(pool), owner_(source->inputOwner()) {}
+
+  RowVectorPtr read(const RowTypePtr& type) {
+    const auto numRows = readValue<int32_t>();
+    const auto numColumns = readValue<int32_t>();
+    VELOX_CHECK_EQ(
+        numColumns, type->size(), "Page has the wrong number of columns");
+    std::vector<VectorPtr> children(numColumns);
+    for (auto i = 0; i < numColumns; ++i) {
+      if (numRows == 0) {
+        children[i] = BaseVector::create(type->childAt(i), 0, pool_);
+      } else {
+        children[i] = readVector(type->childAt(i));
+        VELOX_CHECK_EQ(children[i]->size(), numRows);
+      }
+    }
+    source_->skip(simd::kPadding);
+    return std::make_shared<RowVector>(
+        pool_, type, nullptr, numRows, std::move(children));
+  }
+
+ private:
+  VectorPtr readVector(const TypePtr& type) {
+    const auto size = readValue<int32_t>();
+    VELOX_CHECK_GE(size, 0);
+    BufferPtr nulls;
+    if (readValue<int8_t>()) {
+      nulls = readBuffer(bitsBytes(size));
+    }
+    switch (type->kind()) {
+      case TypeKind::ROW: {
+        std::vector<VectorPtr> children(type->size());
+        for (auto i = 0; i < type->size(); ++i) {
+          children[i] = readVector(type->childAt(i));
+          VELOX_CHECK_GE(children[i]->size(), size);
+        }
+        return std::make_shared<RowVector>(
+            pool_, type, nulls, size, std::move(children));
+      }
+      case TypeKind::ARRAY: {
+        auto offsets = readBuffer(size * sizeof(vector_size_t));
+        auto sizes = readBuffer(size * sizeof(vector_size_t));
+        auto elements = readVector(type->childAt(0));
+        checkRanges(size, nulls, offsets, sizes, elements->size());
+        return std::make_shared<ArrayVector>(
+            pool_, type, nulls, size, offsets, sizes, elements);
+      }
+      case TypeKind::MAP: {
+        auto offsets = readBuffer(size * sizeof(vector_size_t));
+        auto sizes = readBuffer(size * sizeof(vector_size_t));
+        auto keys = readVector(type->childAt(0));
+        auto values = readVector(type->childAt(1));
+        checkRanges(
+            size,
+            nulls,
+            offsets,
+            sizes,
+            std::min(keys->size(), values->size()));
+        return std::make_shared<MapVector>(
+            pool_, type, nulls, size, offsets, sizes, keys, values);
+      }
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        return readStrings(type, size, nulls);
+      case TypeKind::UNKNOWN: {
+        auto vector = BaseVector::create(type, size, pool_);
+        if (nulls) {
+          vector->setNulls(nulls);
+        }
+        return vector;
+      }
+      case TypeKind::BOOLEAN:
+        return std::make_shared<FlatVector<bool>>(
+            pool_,
+            type,
+            nulls,
+            size,
+            readBuffer(bitsBytes(size)),
+            std::vector<BufferPtr>{});
+      default:
+        return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+            makeFlat,
+            type->kind(),
+            type,
+            size,
+            nulls,
+            readBuffer(size * type->cppSizeInBytes()));
+    }
+  }
+
+  template <TypeKind Kind>
+  VectorPtr makeFlat(
+      const TypePtr& type,
+      vector_size_t size,
+      BufferPtr nulls,
+      BufferPtr values) {
+    using T = typename TypeTraits<Kind>::NativeType;
+    return std::make_shared<FlatVector<T>>(
+        pool_, type, nulls, size, values, std::vector<BufferPtr>{});
+  }
+
+  VectorPtr
+  readStrings(const TypePtr& type, vector_size_t size, BufferPtr nulls) {
+    auto lengths = readBuffer(size * sizeof(int32_t));
+    const auto totalLength = readValue<int64_t>();
+    auto chars = readBuffer(totalLength);
+    auto values = AlignedBuffer::allocate<StringView>(size, pool_);
+    auto rawLengths = lengths->as<int32_t>();
+    auto rawChars = chars->as<char>();
+    auto rawValues = values->asMutable<StringView>();
+    int64_t offset = 0;
+    for (auto i = 0; i < size; ++i) {
+      VELOX_CHECK(
+          rawLengths[i] >= 0 && offset + rawLengths[i] <= totalLength,
+          "Bad string length in page");
+      rawValues[i] = StringView(rawChars + offset, rawLengths[i]);
+      offset += rawLengths[i];
+    }
+    return std::make_shared<FlatVector<StringView>>(
+        pool_, type, nulls, size, values, std::vector<BufferPtr>{chars});
+  }
+
+  // Checks that the non-null rows of an array or map are within 'numChildren'.
+  static void checkRanges(
+      vector_size_t size,
+      const BufferPtr& nulls,
+      const BufferPtr& offsets,
+      const BufferPtr& sizes,
+      vector_size_t numChildren) {
+    auto rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+    auto rawOffsets = offsets->as<vector_size_t>();
+    auto rawSizes = sizes->as<vector_size_t>();
+    for (auto i = 0; i < size; ++i) {
+      if (rawNulls && bits::isBitNull(rawNulls, i)) {
+        continue;
+      }
+      VELOX_CHECK(
+          rawOffsets[i] >= 0 && rawSizes[i] >= 0 &&
+              static_cast<int64_t>(rawOffsets[i]) + rawSizes[i] <= numChildren,
+          "Bad array or map offsets in page");
+    }
+  }
+
+  template <typename T>
+  T readValue() {
+    offset_ += sizeof(T);
+    return source_->read<T>();
+  }
+
+  // Returns the 'size' bytes of the next buffer. The buffer refers to the
+  // memory of 'source_' if that has an owner and the bytes are contiguous and
+  // aligned. Otherwise copies them.
+  BufferPtr readBuffer(int64_t size) {
+    const auto padding = paddingAt(offset_);
+    source_->skip(padding);
+    offset_ += padding + size;
+    VELOX_CHECK_LE(
+        size, std::numeric_limits<int32_t>::max(), "Buffer too large in page");
+    if (size == 0) {
+      return AlignedBuffer::allocate<char>(0, pool_);
+    }
+    auto view = source_->nextView(size);
+    if (owner_ && view.size() == size &&
+        reinterpret_cast<uintptr_t>(view.data()) % kAlignment == 0) {
+      return BufferView<IOBufReleaser>::create(
+          reinterpret_cast<const uint8_t*>(view.data()),
+          size,
+          IOBufReleaser{owner_});
+    }
+    auto buffer = AlignedBuffer::allocate<char>(size, pool_);
+    auto rawBuffer = buffer->asMutable<char>();
+    memcpy(rawBuffer, view.data(), view.size());
+    source_->readBytes(rawBuffer + view.size(), size - view.size());
+    return buffer;
+  }
+
+  ByteStream* const source_;
+  memory::MemoryPool* const pool_;
+  const std::shared_ptr<folly::IOBuf> owner_;
+
+  // Number of bytes read from the start of the page.
+  int64_t offset_{0};
+};
+} // namespace
+
+void ColumnarVectorSerde::estimateSerializedSize(
+    VectorPtr vector,
+    const folly::Range<const IndexRange*>& ranges,
+    vector_size_t** sizes) {
+  presto::PrestoVectorSerde().estimateSerializedSize(vector, ranges, sizes);
+}
+
+std::unique_ptr<VectorSerializer> ColumnarVectorSerde::createSerializer(
+    RowTypePtr type,
+    int32_t /*numRows*/,
+    StreamArena* /*streamArena*/,
+    const Options* /*options*/) {
+  return std::make_unique<ColumnarVectorSerializer>(std::move(type));
+}
+
+void ColumnarVectorSerde::deserialize(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    RowTypePtr type,
+    RowVectorPtr* result,
+    const Options* /*options*/) {
+  *result = PageReader(source, pool).read(type);
+}
+
+// static
+void ColumnarVectorSerde::registerVectorSerde() {
+  velox::registerVectorSerde(std::make_unique<ColumnarVectorSerde>());
+}
+
+} // namespace facebook::velox::serializer::columnar
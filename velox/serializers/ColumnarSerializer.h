@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/VectorStream.h"
+
+namespace facebook::velox::serializer::columnar {
+
+/// Serde for exchanges between Velox workers. A page holds the buffers of
+/// the flattened rows, i.e. the nulls, values, offsets and sizes, as they are
+/// laid out in memory, each starting at a multiple of kAlignment bytes from
+/// the start of the page. If the ByteStream has an owner of its memory, the
+/// deserializer wraps the buffers that are contiguous and aligned in place
+/// instead of copying them. Strings are sent as lengths and concatenated
+/// bytes, so that only their StringViews are rebuilt. Not compatible with
+/// the Presto wire format. Options are not used.
+class ColumnarVectorSerde : public VectorSerde {
+ public:
+  static constexpr int32_t kAlignment = 16;
+
+  /// Returns the size of the rows in the Presto format, which has the same
+  /// values, nulls and lengths.
+  void estimateSerializedSize(
+      VectorPtr vector,
+      const folly::Range<const IndexRange*>& ranges,
+      vector_size_t** sizes) override;
+
+  /// The serializer copies the appended rows into flat vectors from the pool
+  /// of the first appended vector and writes their buffers on flush.
+  std::unique_ptr<VectorSerializer> createSerializer(
+      RowTypePtr type,
+      int32_t numRows,
+      StreamArena* streamArena,
+      const Options* options) override;
+
+  void deserialize(
+      ByteStream* source,
+      velox::memory::MemoryPool* pool,
+      RowTypePtr type,
+      RowVectorPtr* result,
+      const Options* options) override;
+
+  static void registerVectorSerde();
+};
+
+} // namespace facebook::velox::serializer::columnar
@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 #include "velox/serializers/PrestoSerializer.h"
+
+#include <folly/Random.h>
+#include <sstream>
+
 #include "velox/common/base/Crc.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
@@ -30,6 +34,10 @@ constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
 constexpr folly::StringPiece kRLE{"RLE"};
+constexpr folly::StringPiece kDictionary{"DICTIONARY"};
+
+// Size of the instance id that follows the ids of a DICTIONARY block.
+constexpr int32_t kDictionaryIdSize = 3 * sizeof(int64_t);
 
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
@@ -47,11 +55,12 @@ int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   bits::Crc32 crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -68,6 +77,37 @@ int64_t computeChecksum(
   return checksum;
 }
 
+// Reads the 'sizeInBytes' bytes of compressed columns from 'source' and
+// returns them uncompressed in a single buffer.
+std::unique_ptr<folly::IOBuf> uncompressPage(
+    ByteStream* source,
+    folly::io::CodecType compressionKind,
+    int32_t uncompressedSize,
+    int32_t sizeInBytes) {
+  std::unique_ptr<folly::IOBuf> compressed;
+  auto remainingBytes = sizeInBytes;
+  while (remainingBytes > 0) {
+    auto data = source->nextView(remainingBytes);
+    VELOX_CHECK_GT(data.size(), 0, "Truncated compressed serialized page");
+    auto buffer = folly::IOBuf::wrapBuffer(data.data(), data.size());
+    if (compressed) {
+      compressed->prependChain(std::move(buffer));
+    } else {
+      compressed = std::move(buffer);
+    }
+    remainingBytes -= data.size();
+  }
+  VELOX_CHECK_NOT_NULL(compressed, "Received empty compressed page");
+  auto uncompressed = folly::io::getCodec(compressionKind)
+                          ->uncompress(compressed.get(), uncompressedSize);
+  uncompressed->coalesce();
+  VELOX_CHECK_EQ(
+      uncompressed->length(),
+      uncompressedSize,
+      "Bad uncompressed size of serialized page");
+  return uncompressed;
+}
+
 char getCodecMarker() {
   char marker = 0;
   marker |= kCheckSumBitMask;
@@ -464,6 +504,32 @@ void readConstantVector(
   *result = BaseVector::wrapInConstant(size, 0, children[0]);
 }
 
+void readDictionaryVector(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result,
+    bool useLosslessTimestamp) {
+  auto size = source->read<int32_t>();
+  std::vector<TypePtr> childTypes = {type};
+  std::vector<VectorPtr> children(1);
+  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+
+  BufferPtr indices = allocateIndices(size, pool);
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  source->readBytes(rawIndices, size * sizeof(vector_size_t));
+  const auto dictionarySize = children[0]->size();
+  for (auto i = 0; i < size; ++i) {
+    VELOX_CHECK(
+        rawIndices[i] >= 0 && rawIndices[i] < dictionarySize,
+        "Dictionary index {} out of range for dictionary of size {}",
+        rawIndices[i],
+        dictionarySize);
+  }
+  source->skip(kDictionaryIdSize);
+  *result = BaseVector::wrapInDictionary(nullptr, indices, size, children[0]);
+}
+
 void readArrayVector(
     ByteStream* source,
     std::shared_ptr<const Type> type,
@@ -754,8 +820,19 @@ void readColumns(
     if (encoding == kRLE) {
       readConstantVector(
           source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+    } else if (encoding == kDictionary) {
+      readDictionaryVector(
+          source, types[i], pool, &(*result)[i], useLosslessTimestamp);
     } else {
       checkTypeEncoding(encoding, types[i]);
+      // A vector read from an RLE or DICTIONARY block of a previous page
+      // cannot be reused for flat data.
+      auto& previous = (*result)[i];
+      if (previous &&
+          (previous->isConstantEncoding() ||
+           previous->encoding() == VectorEncoding::Simple::DICTIONARY)) {
+        previous.reset();
+      }
       auto it = readers.find(types[i]->kind());
       VELOX_CHECK(
           it != readers.end(),
@@ -1627,7 +1704,15 @@ class PrestoVectorSerializer : public VectorSerializer {
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
       StreamArena* streamArena,
-      bool useLosslessTimestamp) {
+      bool useLosslessTimestamp,
+      const PrestoVectorSerde::PrestoOptions* options)
+      : options_(options),
+        streamArena_(streamArena),
+        useLosslessTimestamp_(useLosslessTimestamp) {
+    if (options_ &&
+        options_->compressionKind != folly::io::CodecType::NO_COMPRESSION) {
+      codec_ = folly::io::getCodec(options_->compressionKind);
+    }
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
@@ -1635,6 +1720,9 @@ class PrestoVectorSerializer : public VectorSerializer {
       streams_[i] = std::make_unique<VectorStream>(
           types[i], streamArena, numRows, useLosslessTimestamp);
     }
+    if (options_ && options_->preserveEncodings) {
+      encodedColumns_.resize(numTypes);
+    }
   }
 
   void append(
@@ -1642,8 +1730,13 @@ class PrestoVectorSerializer : public VectorSerializer {
       const folly::Range<const IndexRange*>& ranges) override {
     auto newRows = rangesTotalSize(ranges);
     if (newRows > 0) {
+      const bool firstRows = numRows_ == 0;
       numRows_ += newRows;
       for (int32_t i = 0; i < vector->childrenSize(); ++i) {
+        if (!encodedColumns_.empty() &&
+            appendEncoded(i, vector->childAt(i), ranges, firstRows)) {
+          continue;
+        }
         serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
       }
     }
@@ -1659,6 +1752,8 @@ class PrestoVectorSerializer : public VectorSerializer {
       VELOX_CHECK(child->isConstantEncoding());
     }
 
+    // The page is a single RLE block of the values.
+    encodedColumns_.clear();
     std::vector<IndexRange> ranges{{0, 1}};
     append(vector, folly::Range(ranges.data(), ranges.size()));
 
@@ -1697,18 +1792,12 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
-    writeInt32(out, streams_.size());
-
-    if (rle) {
-      // Write RLE encoding marker.
-      writeInt32(out, kRLE.size());
-      out->write(kRLE.data(), kRLE.size());
-      // Write number of RLE values.
-      writeInt32(out, numRows);
-    }
-
-    for (auto& stream : streams_) {
-      stream->flush(out);
+    int32_t uncompressedSize;
+    if (shouldCompress()) {
+      uncompressedSize = writeCompressedColumns(numRows, rle, out, codec);
+    } else {
+      writeColumns(numRows, rle, out);
+      uncompressedSize = (int32_t)out->tellp() - offset - kHeaderSize;
     }
 
     // Pause CRC computation
@@ -1716,27 +1805,241 @@ class PrestoVectorSerializer : public VectorSerializer {
       listener->pause();
     }
 
-    // Fill in uncompressedSizeInBytes & sizeInBytes
+    // Fill in the codec marker, uncompressedSizeInBytes & sizeInBytes
     int32_t size = (int32_t)out->tellp() - offset;
-    int32_t uncompressedSize = size - kHeaderSize;
+    int32_t sizeInBytes = size - kHeaderSize;
     int64_t crc = 0;
     if (listener) {
       crc = computeChecksum(listener, codec, numRows, uncompressedSize);
     }
 
-    out->seekp(offset + kSizeInBytesOffset);
-    writeInt32(out, uncompressedSize);
+    out->seekp(offset + kCodecOffset);
+    out->write(&codec, 1);
     writeInt32(out, uncompressedSize);
+    writeInt32(out, sizeInBytes);
     writeInt64(out, crc);
     out->seekp(offset + size);
   }
 
  private:
-  static const int32_t kSizeInBytesOffset{4 + 1};
+  static const int32_t kCodecOffset{4};
+  static const int32_t kSizeInBytesOffset{kCodecOffset + 1};
   static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
 
+  // Writes the number of columns and the column data to 'out'.
+  void writeColumns(int32_t numRows, bool rle, OutputStream* out) {
+    writeInt32(out, streams_.size());
+
+    if (rle) {
+      // Write RLE encoding marker.
+      writeInt32(out, kRLE.size());
+      out->write(kRLE.data(), kRLE.size());
+      // Write number of RLE values.
+      writeInt32(out, numRows);
+    }
+
+    for (auto i = 0; i < streams_.size(); ++i) {
+      if (!encodedColumns_.empty() && encodedColumns_[i].vector) {
+        writeEncoded(encodedColumns_[i], out);
+      } else {
+        streams_[i]->flush(out);
+      }
+    }
+  }
+
+  // The rows of a column that are written as an RLE or DICTIONARY block.
+  struct EncodedColumn {
+    // The constant vector or the dictionary vector the rows come from. Null
+    // if the rows are in the VectorStream of the column.
+    VectorPtr vector;
+
+    // The number of rows of a constant 'vector'.
+    vector_size_t numRows{0};
+
+    // The indices into the base of a dictionary 'vector'.
+    std::vector<vector_size_t> indices;
+  };
+
+  // Adds the rows of 'column' in 'ranges' to the RLE or DICTIONARY block of
+  // column 'index'. 'firstRows' is true for the first rows of the page. If
+  // the rows do not fit the block, moves the rows of the block to the
+  // VectorStream of the column and returns false.
+  bool appendEncoded(
+      int32_t index,
+      const VectorPtr& column,
+      const folly::Range<const IndexRange*>& ranges,
+      bool firstRows) {
+    auto& encoded = encodedColumns_[index];
+    auto vector = BaseVector::loadedVectorShared(column);
+    if (vector->isConstantEncoding()) {
+      if (firstRows ||
+          (encoded.vector && encoded.vector->isConstantEncoding() &&
+           vector->equalValueAt(encoded.vector.get(), 0, 0))) {
+        if (firstRows) {
+          encoded.vector = vector;
+        }
+        encoded.numRows += rangesTotalSize(ranges);
+        return true;
+      }
+    } else if (
+        vector->encoding() == VectorEncoding::Simple::DICTIONARY &&
+        !vector->nulls()) {
+      // Nulls added by the dictionary have no representation in a
+      // DICTIONARY block.
+      if (firstRows ||
+          (encoded.vector &&
+           encoded.vector->encoding() == VectorEncoding::Simple::DICTIONARY &&
+           encoded.vector->valueVector() == vector->valueVector())) {
+        if (firstRows) {
+          encoded.vector = vector;
+        }
+        auto rawIndices = vector->wrapInfo()->as<vector_size_t>();
+        for (const auto& range : ranges) {
+          encoded.indices.insert(
+              encoded.indices.end(),
+              rawIndices + range.begin,
+              rawIndices + range.begin + range.size);
+        }
+        return true;
+      }
+    }
+    if (encoded.vector) {
+      serializeEncodedRows(encoded, streams_[index].get());
+      encoded = EncodedColumn{};
+    }
+    return false;
+  }
+
+  // Appends the rows of 'encoded' to 'stream' as individual values.
+  static void serializeEncodedRows(
+      const EncodedColumn& encoded,
+      VectorStream* stream) {
+    std::vector<IndexRange> ranges;
+    if (encoded.vector->isConstantEncoding()) {
+      // The ranges stay within the size of the constant vector.
+      const auto size = encoded.vector->size();
+      for (auto begin = 0; begin < encoded.numRows; begin += size) {
+        ranges.push_back(
+            IndexRange{0, std::min(size, encoded.numRows - begin)});
+      }
+      serializeColumn(encoded.vector.get(), ranges, stream);
+      return;
+    }
+    ranges.reserve(encoded.indices.size());
+    for (auto index : encoded.indices) {
+      ranges.push_back(IndexRange{index, 1});
+    }
+    serializeColumn(encoded.vector->valueVector().get(), ranges, stream);
+  }
+
+  // Writes 'encoded' to 'out' as an RLE block or as a DICTIONARY block of
+  // the referenced base values. Writes a flat block if most of the rows
+  // reference distinct base values.
+  void writeEncoded(const EncodedColumn& encoded, OutputStream* out) {
+    const auto& type = encoded.vector->type();
+    if (encoded.vector->isConstantEncoding()) {
+      writeInt32(out, kRLE.size());
+      out->write(kRLE.data(), kRLE.size());
+      writeInt32(out, encoded.numRows);
+      VectorStream value(type, streamArena_, 1, useLosslessTimestamp_);
+      IndexRange range{0, 1};
+      serializeColumn(encoded.vector.get(), folly::Range(&range, 1), &value);
+      value.flush(out);
+      return;
+    }
+
+    // The base values are renumbered in the order of their first reference.
+    const auto& base = encoded.vector->valueVector();
+    std::vector<vector_size_t> newIndices(base->size(), -1);
+    std::vector<IndexRange> entries;
+    std::vector<vector_size_t> ids(encoded.indices.size());
+    for (auto i = 0; i < encoded.indices.size(); ++i) {
+      auto& newIndex = newIndices[encoded.indices[i]];
+      if (newIndex < 0) {
+        newIndex = entries.size();
+        entries.push_back(IndexRange{encoded.indices[i], 1});
+      }
+      ids[i] = newIndex;
+    }
+    if (entries.size() * 2 > ids.size()) {
+      VectorStream values(
+          type, streamArena_, ids.size(), useLosslessTimestamp_);
+      serializeEncodedRows(encoded, &values);
+      values.flush(out);
+      return;
+    }
+
+    writeInt32(out, kDictionary.size());
+    out->write(kDictionary.data(), kDictionary.size());
+    writeInt32(out, ids.size());
+    VectorStream values(
+        type, streamArena_, entries.size(), useLosslessTimestamp_);
+    serializeColumn(base.get(), entries, &values);
+    values.flush(out);
+    out->write(
+        reinterpret_cast<const char*>(ids.data()),
+        ids.size() * sizeof(vector_size_t));
+    // Presto takes blocks with the same instance id to share the dictionary,
+    // so each block gets a random one.
+    writeInt64(out, folly::Random::rand64());
+    writeInt64(out, folly::Random::rand64());
+    writeInt64(out, 0);
+  }
+
+  // Returns false while the pages after a poorly compressing page are written
+  // uncompressed.
+  bool shouldCompress() {
+    if (!codec_) {
+      return false;
+    }
+    if (options_->numPagesToSkip > 0) {
+      --options_->numPagesToSkip;
+      return false;
+    }
+    return true;
+  }
+
+  // Writes the columns to 'out' compressed with 'codec_' and sets the
+  // compressed bit in 'codec'. Writes them uncompressed if this does not save
+  // enough. Returns the uncompressed size.
+  int32_t writeCompressedColumns(
+      int32_t numRows,
+      bool rle,
+      OutputStream* out,
+      char& codec) {
+    std::ostringstream columns;
+    OStreamOutputStream columnsOut(&columns);
+    writeColumns(numRows, rle, &columnsOut);
+    const auto uncompressed = columns.str();
+    auto compressed = codec_->compress(
+        folly::IOBuf::wrapBuffer(uncompressed.data(), uncompressed.size())
+            .get());
+    const auto compressedSize = compressed->computeChainDataLength();
+    if (compressedSize > uncompressed.size() * options_->minCompressionRatio) {
+      options_->lastPagesToSkip = std::min(
+          PrestoVectorSerde::PrestoOptions::kMaxPagesToSkip,
+          std::max(1, options_->lastPagesToSkip * 2));
+      options_->numPagesToSkip = options_->lastPagesToSkip;
+      out->write(uncompressed.data(), uncompressed.size());
+    } else {
+      options_->lastPagesToSkip = 0;
+      codec |= kCompressedBitMask;
+      for (auto range : *compressed) {
+        out->write(reinterpret_cast<const char*>(range.data()), range.size());
+      }
+    }
+    return uncompressed.size();
+  }
+
+  const PrestoVectorSerde::PrestoOptions* const options_;
+  StreamArena* const streamArena_;
+  const bool useLosslessTimestamp_;
+  std::unique_ptr<folly::io::Codec> codec_;
   int32_t numRows_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
+
+  // One per column if the options ask to preserve encodings, else empty.
+  std::vector<EncodedColumn> encodedColumns_;
 };
 } // namespace
 
@@ -1752,11 +2055,11 @@ std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
     int32_t numRows,
     StreamArena* streamArena,
     const Options* options) {
-  bool useLosslessTimestamp = options != nullptr
-      ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
-      : false;
+  auto prestoOptions = static_cast<const PrestoOptions*>(options);
+  bool useLosslessTimestamp =
+      prestoOptions != nullptr ? prestoOptions->useLosslessTimestamp : false;
   return std::make_unique<PrestoVectorSerializer>(
-      type, numRows, streamArena, useLosslessTimestamp);
+      type, numRows, streamArena, useLosslessTimestamp, prestoOptions);
 }
 
 void PrestoVectorSerde::serializeConstants(
@@ -1776,9 +2079,9 @@ void PrestoVectorSerde::deserialize(
     std::shared_ptr<const RowType> type,
     std::shared_ptr<RowVector>* result,
     const Options* options) {
-  bool useLosslessTimestamp = options != nullptr
-      ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
-      : false;
+  auto prestoOptions = static_cast<const PrestoOptions*>(options);
+  bool useLosslessTimestamp =
+      prestoOptions != nullptr ? prestoOptions->useLosslessTimestamp : false;
   auto numRows = source->read<int32_t>();
   if (!(*result) || !result->unique() || (*result)->type() != type) {
     *result = std::dynamic_pointer_cast<RowVector>(
@@ -1789,19 +2092,39 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
+  // The columns of a compressed page are read from its uncompressed copy.
+  std::unique_ptr<folly::IOBuf> uncompressed;
+  ByteStream uncompressedSource;
+  if (isCompressedBitSet(pageCodecMarker)) {
+    VELOX_CHECK(
+        prestoOptions != nullptr &&
+            prestoOptions->compressionKind !=
+                folly::io::CodecType::NO_COMPRESSION,
+        "Received compressed serialized page without a codec");
+    uncompressed = uncompressPage(
+        source,
+        prestoOptions->compressionKind,
+        uncompressedSize,
+        sizeInBytes);
+    uncompressedSource.resetInput({ByteRange{
+        uncompressed->writableData(),
+        static_cast<int32_t>(uncompressed->length()),
+        0}});
+    source = &uncompressedSource;
+  }
+
   // skip number of columns
   source->skip(4);
 
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/compression/Compression.h>
+
 #include "velox/common/base/Crc.h"
 #include "velox/vector/VectorStream.h"
 
@@ -22,13 +24,46 @@ class PrestoVectorSerde : public VectorSerde {
  public:
   // Input options that the serializer recognizes.
   struct PrestoOptions : VectorSerde::Options {
-    explicit PrestoOptions(bool useLosslessTimestamp)
-        : useLosslessTimestamp(useLosslessTimestamp) {}
+    PrestoOptions() = default;
+
+    explicit PrestoOptions(
+        bool useLosslessTimestamp,
+        folly::io::CodecType compressionKind =
+            folly::io::CodecType::NO_COMPRESSION)
+        : useLosslessTimestamp(useLosslessTimestamp),
+          compressionKind(compressionKind) {}
+
     // Currently presto only supports millisecond precision and the serializer
     // converts velox native timestamp to that resulting in loss of precision.
     // This option allows it to serialize with nanosecond precision and is
     // currently used for spilling. Is false by default.
     bool useLosslessTimestamp{false};
+
+    // Codec for the column data of the pages. Compressed pages have the
+    // compressed bit of the page codec marker set. The deserializer must be
+    // given the same codec.
+    folly::io::CodecType compressionKind{folly::io::CodecType::NO_COMPRESSION};
+
+    // A page is written uncompressed if compression does not shrink it below
+    // this fraction of its size. The next pages written with the same options
+    // are then not compressed, for twice as many pages after each such page,
+    // up to kMaxPagesToSkip.
+    double minCompressionRatio{0.8};
+
+    static constexpr int32_t kMaxPagesToSkip = 64;
+
+    // Number of pages to write uncompressed before trying compression again
+    // and the length of the last such run. Updated by the serializers.
+    mutable int32_t numPagesToSkip{0};
+    mutable int32_t lastPagesToSkip{0};
+
+    // If true, a column whose rows in a page all come from the same constant
+    // vector is written as an RLE block and a column whose rows all come from
+    // dictionary vectors over the same base is written as a DICTIONARY block
+    // of the referenced base values, if these are at most half of the rows.
+    // Other columns are flattened. The deserializer reads both blocks
+    // regardless of this option.
+    bool preserveEncodings{false};
   };
 
   void estimateSerializedSize(
@@ -14,8 +14,8 @@
  * limitations under the License.
  */
 #include "velox/serializers/UnsafeRowSerializer.h"
-#include "velox/row/UnsafeRowDeserializer.h"
-#include "velox/row/UnsafeRowDynamicSerializer.h"
+#include "velox/row/UnsafeRow24Deserializer.h"
+#include "velox/row/UnsafeRowBatchSerializer.h"
 
 namespace facebook::velox::serializer::spark {
 
@@ -35,12 +35,13 @@ class UnsafeRowVectorSerializer : public VectorSerializer {
   void append(
       RowVectorPtr vector,
       const folly::Range<const IndexRange*>& ranges) override {
+    // Computes the sizes of all rows and then writes the rows a column at a
+    // time.
+    velox::row::UnsafeRowBatchSerializer batchSerializer(vector);
     size_t totalSize = 0;
     for (auto& range : ranges) {
       for (auto i = range.begin; i < range.begin + range.size; ++i) {
-        auto rowSize = velox::row::UnsafeRowDynamicSerializer::getSizeRow(
-            vector->type(), vector.get(), i);
-        totalSize += rowSize + sizeof(size_t);
+        totalSize += batchSerializer.rowSize(i) + sizeof(size_t);
       }
     }
 
@@ -52,27 +53,21 @@ class UnsafeRowVectorSerializer : public VectorSerializer {
     buffers_.push_back(
         ByteRange{(uint8_t*)buffer, (int32_t)totalSize, (int32_t)totalSize});
 
+    std::vector<vector_size_t> rows;
+    std::vector<char*> rowBuffers;
     size_t offset = 0;
     for (auto& range : ranges) {
       for (auto i = range.begin; i < range.begin + range.size; ++i) {
-        // Write row data.
-        auto rowSize = velox::row::UnsafeRowDynamicSerializer::getSizeRow(
-            vector->type(), vector.get(), i);
-
-        auto size =
-            velox::row::UnsafeRowDynamicSerializer::serialize(
-                vector->type(), vector, buffer + offset + sizeof(size_t), i)
-                .value_or(0);
-
-        // Sanity check.
-        VELOX_CHECK_EQ(rowSize, size);
-
         // Write raw size.
-        *(size_t*)(buffer + offset) = size;
+        const auto rowSize = batchSerializer.rowSize(i);
+        *(size_t*)(buffer + offset) = rowSize;
 
-        offset += sizeof(size_t) + size;
+        rows.push_back(i);
+        rowBuffers.push_back(buffer + offset + sizeof(size_t));
+        offset += sizeof(size_t) + rowSize;
       }
     }
+    batchSerializer.serialize(rows, rowBuffers);
   }
 
   void flush(OutputStream* stream) override {
@@ -103,12 +98,13 @@ void UnsafeRowVectorSerde::deserialize(
     RowTypePtr type,
     RowVectorPtr* result,
     const Options* /* options */) {
-  std::vector<std::optional<std::string_view>> serializedRows;
+  // Null rows are serialized with size 0.
+  std::vector<const char*> serializedRows;
   while (!source->atEnd()) {
     auto rowSize = source->read<size_t>();
     auto row = source->nextView(rowSize);
     VELOX_CHECK_EQ(row.size(), rowSize);
-    serializedRows.push_back(row);
+    serializedRows.push_back(rowSize == 0 ? nullptr : row.data());
   }
 
   if (serializedRows.empty()) {
@@ -117,9 +113,9 @@ void UnsafeRowVectorSerde::deserialize(
     return;
   }
 
-  *result = std::dynamic_pointer_cast<RowVector>(
-      velox::row::UnsafeRowDynamicVectorDeserializer::deserializeComplex(
-          serializedRows, type, pool));
+  // Reads the rows a column at a time.
+  *result = velox::row::UnsafeRow24Deserializer::Create(type)->DeserializeRows(
+      pool, serializedRows);
 }
 
 // static
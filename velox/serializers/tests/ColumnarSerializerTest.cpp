@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/serializers/ColumnarSerializer.h"
+#include <gtest/gtest.h>
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+using serializer::columnar::ColumnarVectorSerde;
+
+class ColumnarSerializerTest : public ::testing::Test,
+                               public test::VectorTestBase {
+ protected:
+  void SetUp() override {
+    serde_ = std::make_unique<ColumnarVectorSerde>();
+  }
+
+  // Serializes 'ranges' of each of 'batches' into one page.
+  std::string serialize(
+      const std::vector<RowVectorPtr>& batches,
+      const std::vector<std::vector<IndexRange>>& ranges) {
+    auto arena =
+        std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+    auto serializer = serde_->createSerializer(
+        asRowType(batches[0]->type()), 100, arena.get(), nullptr);
+    for (auto i = 0; i < batches.size(); ++i) {
+      serializer->append(
+          batches[i], folly::Range(ranges[i].data(), ranges[i].size()));
+    }
+    std::ostringstream output;
+    OStreamOutputStream out(&output);
+    serializer->flush(&out);
+    return output.str();
+  }
+
+  // Returns an IOBuf with a copy of 'page' at an aligned address.
+  static std::shared_ptr<folly::IOBuf> toAlignedIOBuf(const std::string& page) {
+    constexpr auto kAlignment = ColumnarVectorSerde::kAlignment;
+    auto iobuf = folly::IOBuf::create(page.size() + kAlignment);
+    auto address = reinterpret_cast<uintptr_t>(iobuf->data());
+    iobuf->advance(bits::roundUp(address, kAlignment) - address);
+    memcpy(iobuf->writableData(), page.data(), page.size());
+    iobuf->append(page.size());
+    return iobuf;
+  }
+
+  RowVectorPtr deserialize(
+      const RowTypePtr& rowType,
+      const std::string& page,
+      std::shared_ptr<folly::IOBuf> owner = nullptr) {
+    ByteStream input;
+    auto data = owner ? owner->writableData()
+                      : reinterpret_cast<uint8_t*>(
+                            const_cast<char*>(page.data()));
+    input.resetInput(
+        {ByteRange{data, static_cast<int32_t>(page.size()), 0}},
+        std::move(owner));
+    RowVectorPtr result;
+    serde_->deserialize(&input, pool(), rowType, &result, nullptr);
+    EXPECT_TRUE(input.atEnd());
+    return result;
+  }
+
+  std::unique_ptr<VectorSerde> serde_;
+};
+
+TEST_F(ColumnarSerializerTest, roundTrip) {
+  auto rowType = ROW({
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      VARCHAR(),
+      VARBINARY(),
+      TIMESTAMP(),
+      DATE(),
+      INTERVAL_DAY_TIME(),
+      ROW({VARCHAR(), INTEGER()}),
+      ARRAY(INTEGER()),
+      MAP(VARCHAR(), ARRAY(BIGINT())),
+  });
+  VectorFuzzer::Options options;
+  options.vectorSize = 100;
+  options.nullRatio = 0.1;
+  options.stringVariableLength = true;
+  options.containerVariableLength = true;
+  VectorFuzzer fuzzer(options, pool());
+  std::vector<RowVectorPtr> batches = {
+      fuzzer.fuzzRow(rowType), fuzzer.fuzzRow(rowType)};
+  std::vector<std::vector<IndexRange>> ranges = {
+      {{0, 10}, {25, 1}, {50, 30}}, {{0, 100}}};
+  auto page = serialize(batches, ranges);
+
+  auto expected = std::static_pointer_cast<RowVector>(
+      BaseVector::create(rowType, 141, pool()));
+  std::vector<BaseVector::CopyRange> copyRanges = {
+      {0, 0, 10}, {25, 10, 1}, {50, 11, 30}};
+  expected->copyRanges(batches[0].get(), copyRanges);
+  expected->copy(batches[1].get(), 41, 0, 100);
+
+  test::assertEqualVectors(expected, deserialize(rowType, page));
+  test::assertEqualVectors(
+      expected, deserialize(rowType, page, toAlignedIOBuf(page)));
+
+  // An empty page has the columns and no rows.
+  auto empty = serialize({batches[0]}, {{}});
+  auto result = deserialize(rowType, empty);
+  EXPECT_EQ(0, result->size());
+  EXPECT_EQ(rowType->size(), result->childrenSize());
+}
+
+TEST_F(ColumnarSerializerTest, inPlace) {
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 1'000; ++i) {
+    strings.push_back(fmt::format("string value {}", i));
+  }
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+      makeFlatVector(strings),
+  });
+  auto rowType = asRowType(data->type());
+  auto page = serialize({data}, {{{0, 1'000}}});
+
+  // Without an owner of the page, the buffers are copied.
+  auto copied = deserialize(rowType, page);
+  EXPECT_FALSE(copied->childAt(0)->values()->isView());
+  test::assertEqualVectors(data, copied);
+
+  // With an owner, the buffers refer to its memory and keep it alive.
+  auto iobuf = toAlignedIOBuf(page);
+  auto inPlace = deserialize(rowType, page, iobuf);
+  auto stringVector = inPlace->childAt(1)->asFlatVector<StringView>();
+  EXPECT_TRUE(inPlace->childAt(0)->values()->isView());
+  ASSERT_EQ(1, stringVector->stringBuffers().size());
+  EXPECT_TRUE(stringVector->stringBuffers()[0]->isView());
+  EXPECT_GT(iobuf.use_count(), 1);
+  iobuf.reset();
+  test::assertEqualVectors(data, inPlace);
+}
+
+TEST_F(ColumnarSerializerTest, truncated) {
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>(100, [](auto row) { return row; })});
+  auto page = serialize({data}, {{{0, 100}}});
+  EXPECT_ANY_THROW(
+      deserialize(asRowType(data->type()), page.substr(0, page.size() / 2)));
+}
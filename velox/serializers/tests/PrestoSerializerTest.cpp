@@ -72,6 +72,25 @@ class PrestoSerializerTest : public ::testing::Test {
     serializer->flush(&out);
   }
 
+  // Serializes 'batches' into a single page.
+  void serializeBatches(
+      const std::vector<RowVectorPtr>& batches,
+      std::ostream* output,
+      const VectorSerde::Options* serdeOptions) {
+    auto arena =
+        std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+    auto rowType = asRowType(batches[0]->type());
+    auto serializer =
+        serde_->createSerializer(rowType, 100, arena.get(), serdeOptions);
+    for (const auto& batch : batches) {
+      IndexRange range{0, batch->size()};
+      serializer->append(batch, folly::Range(&range, 1));
+    }
+    facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+    OStreamOutputStream out(output, &listener);
+    serializer->flush(&out);
+  }
+
   void serializeRle(
       const RowVectorPtr& rowVector,
       std::ostream* output,
@@ -105,6 +124,17 @@ class PrestoSerializerTest : public ::testing::Test {
     return result;
   }
 
+  BufferPtr makeIndices(
+      vector_size_t size,
+      std::function<vector_size_t(vector_size_t)> indexAt) {
+    auto indices = allocateIndices(size, pool_.get());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < size; ++i) {
+      rawIndices[i] = indexAt(i);
+    }
+    return indices;
+  }
+
   RowVectorPtr makeTestVector(vector_size_t size) {
     auto a = vectorMaker_->flatVector<int64_t>(
         size, [](vector_size_t row) { return row; });
@@ -292,6 +322,126 @@ TEST_F(PrestoSerializerTest, multiPage) {
   ASSERT_TRUE(byteStream->atEnd());
 }
 
+TEST_F(PrestoSerializerTest, compression) {
+  for (auto kind : {folly::io::CodecType::LZ4, folly::io::CodecType::ZSTD}) {
+    if (!folly::io::hasCodec(kind)) {
+      continue;
+    }
+    SCOPED_TRACE(static_cast<int>(kind));
+    serializer::presto::PrestoVectorSerde::PrestoOptions options(false, kind);
+    auto data = makeTestVector(10'000);
+    auto rowType = asRowType(data->type());
+
+    std::ostringstream plain;
+    serialize(data, &plain, nullptr);
+    std::ostringstream compressed;
+    serialize(data, &compressed, &options);
+    // The compressed bit of the page codec marker is set.
+    EXPECT_EQ(1, compressed.str()[4] & 1);
+    EXPECT_LT(compressed.str().size(), plain.str().size() / 2);
+    assertEqualVectors(deserialize(rowType, compressed.str(), &options), data);
+    EXPECT_THROW(
+        deserialize(rowType, compressed.str(), nullptr), VeloxRuntimeError);
+
+    // Random values do not compress. The page is written uncompressed and
+    // so is the next one.
+    auto random = vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+        10'000, [](auto /*row*/) { return folly::Random::rand64(); })});
+    for (auto i = 0; i < 2; ++i) {
+      std::ostringstream out;
+      serialize(random, &out, &options);
+      EXPECT_EQ(0, out.str()[4] & 1);
+      assertEqualVectors(
+          deserialize(asRowType(random->type()), out.str(), &options), random);
+    }
+    EXPECT_EQ(0, options.numPagesToSkip);
+    EXPECT_EQ(1, options.lastPagesToSkip);
+
+    // Compression is tried again on the third page.
+    std::ostringstream out;
+    serialize(data, &out, &options);
+    EXPECT_EQ(1, out.str()[4] & 1);
+    EXPECT_EQ(0, options.lastPagesToSkip);
+  }
+}
+
+TEST_F(PrestoSerializerTest, preserveEncodings) {
+  serializer::presto::PrestoVectorSerde::PrestoOptions options;
+  options.preserveEncodings = true;
+  const vector_size_t size = 1'000;
+  std::vector<std::string> values;
+  for (auto i = 0; i < 10; ++i) {
+    values.push_back(fmt::format("a long dimension value {}", i));
+  }
+  auto strings = vectorMaker_->flatVector(values);
+  auto lowCardinality = BaseVector::wrapInDictionary(
+      nullptr,
+      makeIndices(size, [](auto row) { return row % 10; }),
+      size,
+      strings);
+  auto distinct = vectorMaker_->flatVector<int64_t>(
+      size, [](auto row) { return row * 3; });
+  auto highCardinality = BaseVector::wrapInDictionary(
+      nullptr,
+      makeIndices(size, [](auto row) { return size - 1 - row; }),
+      size,
+      distinct);
+  auto data = vectorMaker_->rowVector(
+      {lowCardinality,
+       BaseVector::createConstant("constant", size, pool_.get()),
+       highCardinality});
+  auto rowType = asRowType(data->type());
+
+  std::ostringstream plain;
+  serialize(data, &plain, nullptr);
+  std::ostringstream encoded;
+  serialize(data, &encoded, &options);
+  EXPECT_LT(encoded.str().size(), plain.str().size() / 2);
+
+  auto result = deserialize(rowType, encoded.str(), nullptr);
+  assertEqualVectors(data, result);
+  EXPECT_EQ(
+      VectorEncoding::Simple::DICTIONARY, result->childAt(0)->encoding());
+  EXPECT_EQ(10, result->childAt(0)->valueVector()->size());
+  EXPECT_TRUE(result->childAt(1)->isConstantEncoding());
+  EXPECT_EQ(VectorEncoding::Simple::FLAT, result->childAt(2)->encoding());
+
+  // A flat page read into the same result replaces the encoded children.
+  auto byteStream = toByteStream(plain.str());
+  serde_->deserialize(byteStream.get(), pool_.get(), rowType, &result, nullptr);
+  assertEqualVectors(data, result);
+
+  // Batches over the same constant value or dictionary base stay encoded.
+  // The second constant differs, so that column is flattened.
+  auto otherIndices = makeIndices(size, [](auto row) { return row % 3; });
+  std::vector<RowVectorPtr> batches = {
+      vectorMaker_->rowVector(
+          {lowCardinality,
+           BaseVector::createConstant(1, size, pool_.get()),
+           BaseVector::createConstant(1, size, pool_.get())}),
+      vectorMaker_->rowVector(
+          {BaseVector::wrapInDictionary(nullptr, otherIndices, size, strings),
+           BaseVector::createConstant(1, size, pool_.get()),
+           BaseVector::createConstant(2, size, pool_.get())})};
+  std::ostringstream batchesOut;
+  serializeBatches(batches, &batchesOut, &options);
+  result = deserialize(
+      asRowType(batches[0]->type()), batchesOut.str(), nullptr);
+  ASSERT_EQ(2 * size, result->size());
+  EXPECT_EQ(
+      VectorEncoding::Simple::DICTIONARY, result->childAt(0)->encoding());
+  EXPECT_TRUE(result->childAt(1)->isConstantEncoding());
+  EXPECT_EQ(VectorEncoding::Simple::FLAT, result->childAt(2)->encoding());
+  for (auto i = 0; i < 2 * size; ++i) {
+    auto batch = batches[i / size];
+    for (auto column = 0; column < 3; ++column) {
+      ASSERT_TRUE(result->childAt(column)->equalValueAt(
+          batch->childAt(column).get(), i, i % size))
+          << "at " << i << " column " << column;
+    }
+  }
+}
+
 TEST_F(PrestoSerializerTest, timestampWithNanosecondPrecision) {
   // Verify that nanosecond precision is preserved when the right options are
   // passed to the serde.
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/substrait/SubstraitPlanCache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace facebook::velox::substrait {
+namespace {
+
+// Returns the ReadRel under 'rel' or nullptr if there is none. Sets
+// 'multiple' if there is more than one.
+::substrait::ReadRel* findReadRel(::substrait::Rel& rel, bool& multiple) {
+  switch (rel.rel_type_case()) {
+    case ::substrait::Rel::kRead:
+      return rel.mutable_read();
+    case ::substrait::Rel::kFilter:
+      return findReadRel(*rel.mutable_filter()->mutable_input(), multiple);
+    case ::substrait::Rel::kFetch:
+      return findReadRel(*rel.mutable_fetch()->mutable_input(), multiple);
+    case ::substrait::Rel::kAggregate:
+      return findReadRel(*rel.mutable_aggregate()->mutable_input(), multiple);
+    case ::substrait::Rel::kSort:
+      return findReadRel(*rel.mutable_sort()->mutable_input(), multiple);
+    case ::substrait::Rel::kProject:
+      return findReadRel(*rel.mutable_project()->mutable_input(), multiple);
+    default:
+      // Rels with several inputs are not converted and are not cached.
+      multiple = true;
+      return nullptr;
+  }
+}
+
+::substrait::ReadRel* findReadRel(::substrait::Plan& plan, bool& multiple) {
+  if (plan.relations_size() != 1) {
+    multiple = true;
+    return nullptr;
+  }
+  auto& rel = *plan.mutable_relations(0);
+  if (rel.has_root()) {
+    return findReadRel(*rel.mutable_root()->mutable_input(), multiple);
+  }
+  return findReadRel(*rel.mutable_rel(), multiple);
+}
+
+std::string serializeDeterministic(const ::substrait::Plan& plan) {
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded(&stream);
+    coded.SetSerializationDeterministic(true);
+    plan.SerializeToCodedStream(&coded);
+  }
+  return serialized;
+}
+
+} // namespace
+
+SubstraitPlanCache::PreparedPlan SubstraitPlanCache::toVeloxPlan(
+    const ::substrait::Plan& substraitPlan) {
+  // The key is the plan without the files to scan.
+  ::substrait::Plan keyPlan = substraitPlan;
+  bool multiple = false;
+  auto* readRel = findReadRel(keyPlan, multiple);
+  std::shared_ptr<SplitInfo> splitInfo;
+  if (readRel != nullptr) {
+    splitInfo = std::make_shared<SplitInfo>();
+    SubstraitVeloxPlanConverter::parseLocalFiles(*readRel, *splitInfo);
+    readRel->clear_local_files();
+  }
+  std::string key;
+  if (!multiple) {
+    key = serializeDeterministic(keyPlan);
+    std::shared_ptr<const Entry> entry;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (auto* cached = cache_.get(key)) {
+        entry = *cached;
+        cache_.release(key);
+      }
+    }
+    if (entry != nullptr) {
+      ++numHits_;
+      PreparedPlan prepared{entry->plan, {}};
+      if (entry->readNodeId.has_value()) {
+        prepared.splitInfos[*entry->readNodeId] = std::move(splitInfo);
+      }
+      return prepared;
+    }
+  }
+  ++numMisses_;
+  SubstraitVeloxPlanConverter converter(pool_);
+  PreparedPlan prepared{converter.toVeloxPlan(substraitPlan),
+                        converter.splitInfos()};
+  if (multiple || prepared.splitInfos.size() > 1) {
+    return prepared;
+  }
+  auto entry = std::make_shared<Entry>();
+  entry->plan = prepared.plan;
+  if (!prepared.splitInfos.empty()) {
+    entry->readNodeId = prepared.splitInfos.begin()->first;
+  }
+  auto value = std::make_unique<std::shared_ptr<const Entry>>(std::move(entry));
+  std::lock_guard<std::mutex> l(mutex_);
+  // Fails if another thread added the plan first.
+  if (cache_.add(std::move(key), value.get(), 1)) {
+    value.release();
+  }
+  return prepared;
+}
+
+} // namespace facebook::velox::substrait
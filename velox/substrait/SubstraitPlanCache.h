@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/substrait/SubstraitToVeloxPlan.h"
+
+namespace facebook::velox::substrait {
+
+/// Caches the Velox plans converted from Substrait plans, so that a plan
+/// that is executed repeatedly is converted once. The files to scan are the
+/// parameters of a plan: two plans that differ only in the local files of
+/// their ReadRel share the cached PlanNode tree and get their own split
+/// infos. The cached plans are immutable and may be executed concurrently.
+/// Plans with more than one ReadRel are converted but not cached. Thread
+/// safe.
+class SubstraitPlanCache {
+ public:
+  using SplitInfo = SubstraitVeloxPlanConverter::SplitInfo;
+
+  struct PreparedPlan {
+    core::PlanNodePtr plan;
+
+    /// The splits of the plan by the id of its leaf.
+    std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>
+        splitInfos;
+  };
+
+  /// 'pool' holds the vectors of the ValuesNodes of the cached plans and must
+  /// outlive 'this'. At most 'maxEntries' plans are kept.
+  SubstraitPlanCache(memory::MemoryPool* pool, int32_t maxEntries)
+      : pool_(pool), cache_(maxEntries) {}
+
+  /// Returns the Velox plan for 'substraitPlan', converting it if it is not
+  /// cached.
+  PreparedPlan toVeloxPlan(const ::substrait::Plan& substraitPlan);
+
+  int64_t numHits() const {
+    return numHits_;
+  }
+
+  int64_t numMisses() const {
+    return numMisses_;
+  }
+
+ private:
+  struct Entry {
+    core::PlanNodePtr plan;
+
+    // The id of the leaf that scans the ReadRel, if there is one.
+    std::optional<core::PlanNodeId> readNodeId;
+  };
+
+  memory::MemoryPool* const pool_;
+  std::mutex mutex_;
+  SimpleLRUCache<std::string, std::shared_ptr<const Entry>> cache_;
+  std::atomic<int64_t> numHits_{0};
+  std::atomic<int64_t> numMisses_{0};
+};
+
+} // namespace facebook::velox::substrait
@@ -61,6 +61,12 @@ class SubstraitVeloxPlanConverter {
       const ::substrait::ReadRel& readRel,
       std::shared_ptr<SplitInfo>& splitInfo);
 
+  /// Fills the paths, starts, lengths and format of 'splitInfo' from the
+  /// local files of 'readRel', if it has any.
+  static void parseLocalFiles(
+      const ::substrait::ReadRel& readRel,
+      SplitInfo& splitInfo);
+
   /// Convert Substrait FetchRel into Velox LimitNode or TopNNode according the
   /// different input of fetchRel.
   core::PlanNodePtr toVeloxPlan(const ::substrait::FetchRel& fetchRel);
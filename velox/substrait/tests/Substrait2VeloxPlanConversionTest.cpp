@@ -22,6 +22,7 @@
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/substrait/SubstraitPlanCache.h"
 #include "velox/substrait/SubstraitToVeloxPlan.h"
 #include "velox/type/Type.h"
 
@@ -37,7 +38,17 @@ class Substrait2VeloxPlanConversionTest
   makeSplits(
       const facebook::velox::substrait::SubstraitVeloxPlanConverter& converter,
       std::shared_ptr<const core::PlanNode> planNode) {
-    const auto& splitInfos = converter.splitInfos();
+    return makeSplits(converter.splitInfos(), planNode);
+  }
+
+  std::vector<std::shared_ptr<facebook::velox::connector::ConnectorSplit>>
+  makeSplits(
+      const std::unordered_map<
+          core::PlanNodeId,
+          std::shared_ptr<facebook::velox::substrait::
+                              SubstraitVeloxPlanConverter::SplitInfo>>&
+          splitInfos,
+      std::shared_ptr<const core::PlanNode> planNode) {
     auto leafPlanNodeIds = planNode->leafPlanNodeIds();
     // Only one leaf node is expected here.
     EXPECT_EQ(1, leafPlanNodeIds.size());
@@ -286,3 +297,52 @@ TEST_F(Substrait2VeloxPlanConversionTest, q6) {
       .splits(makeSplits(planConverter, planNode))
       .assertResults(expectedResult);
 }
+
+TEST_F(Substrait2VeloxPlanConversionTest, planCache) {
+  std::string planPath =
+      getDataFilePath("velox/substrait/tests", "data/q6_first_stage.json");
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(planPath, substraitPlan);
+
+  // Returns the ReadRel at the bottom of 'plan'.
+  auto readRel = [](::substrait::Plan& plan) {
+    auto* rel = plan.mutable_relations(0)->mutable_root()->mutable_input();
+    while (!rel->has_read()) {
+      if (rel->has_aggregate()) {
+        rel = rel->mutable_aggregate()->mutable_input();
+      } else if (rel->has_project()) {
+        rel = rel->mutable_project()->mutable_input();
+      } else {
+        rel = rel->mutable_filter()->mutable_input();
+      }
+    }
+    return rel->mutable_read();
+  };
+  auto first = substraitPlan;
+  readRel(first)->mutable_local_files()->add_items()->set_uri_file("/a.orc");
+  auto second = substraitPlan;
+  readRel(second)->mutable_local_files()->add_items()->set_uri_file("/b.orc");
+
+  facebook::velox::substrait::SubstraitPlanCache cache(pool_.get(), 10);
+  auto firstPlan = cache.toVeloxPlan(first);
+  EXPECT_EQ(0, cache.numHits());
+
+  // Plans that differ in their files share the PlanNode tree.
+  auto secondPlan = cache.toVeloxPlan(second);
+  EXPECT_EQ(1, cache.numHits());
+  EXPECT_EQ(firstPlan.plan, secondPlan.plan);
+  auto leafId = *firstPlan.plan->leafPlanNodeIds().begin();
+  EXPECT_EQ(
+      std::vector<std::string>{"/a.orc"},
+      firstPlan.splitInfos.at(leafId)->paths);
+  EXPECT_EQ(
+      std::vector<std::string>{"/b.orc"},
+      secondPlan.splitInfos.at(leafId)->paths);
+
+  // A plan that differs elsewhere is converted.
+  auto other = first;
+  other.mutable_relations(0)->mutable_root()->add_names("extra");
+  auto otherPlan = cache.toVeloxPlan(other);
+  EXPECT_EQ(2, cache.numMisses());
+  EXPECT_NE(firstPlan.plan, otherPlan.plan);
+}
@@ -18,6 +18,7 @@
 
 #include <folly/Conv.h>
 #include <cctype>
+#include <cstring>
 #include <string>
 #include <type_traits>
 #include "velox/common/base/Exceptions.h"
@@ -26,6 +27,125 @@
 
 namespace facebook::velox::util {
 
+namespace detail {
+// Returns true if the 8 bytes of 'chunk' are all ASCII digits.
+inline bool isEightDigits(uint64_t chunk) {
+  return (((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) &
+          0x8080808080808080) == 0;
+}
+
+// Returns the value of the 8 ASCII digits in 'chunk', the first digit in the
+// lowest byte. Combines pairs of digits, then pairs of those, then pairs of
+// those, with one multiplication each.
+inline uint32_t parseEightDigits(uint64_t chunk) {
+  constexpr uint64_t kMask = 0x000000FF000000FF;
+  constexpr uint64_t kMul1 = 100 + (1000000ULL << 32);
+  constexpr uint64_t kMul2 = 1 + (10000ULL << 32);
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & kMask) * kMul1) + (((chunk >> 16) & kMask) * kMul2)) >>
+      32;
+}
+
+// Parses the digits in [data, end) into 'value'. Returns false if there is a
+// non-digit. Does not check for overflow.
+inline bool parseDigits(const char* data, const char* end, uint64_t& value) {
+  if constexpr (folly::kIsLittleEndian) {
+    for (; data + 8 <= end; data += 8) {
+      uint64_t chunk;
+      std::memcpy(&chunk, data, sizeof(chunk));
+      if (!isEightDigits(chunk)) {
+        return false;
+      }
+      value = value * 100'000'000 + parseEightDigits(chunk);
+    }
+  }
+  for (; data < end; ++data) {
+    const uint8_t digit = *data - '0';
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  return true;
+}
+} // namespace detail
+
+/// Parses the 'size' bytes at 'data' as an integer of the form -?[0-9]+ that
+/// fits in T and sets 'result'. Returns false for any other text, including
+/// forms that folly::to accepts, e.g. with a plus sign, with surrounding
+/// whitespace or with more than 18 digits. Callers fall back to folly::to in
+/// that case, so that the results are the same.
+template <typename T>
+bool tryParseInteger(const char* data, size_t size, T& result) {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+  const char* end = data + size;
+  const bool negative = size > 0 && data[0] == '-';
+  if (negative) {
+    ++data;
+  }
+  if (data == end || end - data > 18) {
+    return false;
+  }
+  uint64_t value = 0;
+  if (!detail::parseDigits(data, end, value)) {
+    return false;
+  }
+  const auto max = static_cast<uint64_t>(std::numeric_limits<T>::max());
+  if (negative) {
+    if (value > max + 1) {
+      return false;
+    }
+    result = static_cast<T>(-static_cast<int64_t>(value));
+  } else {
+    if (value > max) {
+      return false;
+    }
+    result = static_cast<T>(value);
+  }
+  return true;
+}
+
+/// Parses the 'size' bytes at 'data' as a number of the form
+/// -?[0-9]+(\.[0-9]+)? with at most 15 digits and sets 'result'. The digits
+/// and the power of ten they are divided by are exact in a double, so that
+/// the division gives the correctly rounded result. Returns false for any
+/// other text. See tryParseInteger.
+template <typename T>
+bool tryParseDecimal(const char* data, size_t size, T& result) {
+  static_assert(std::is_floating_point_v<T>);
+  static constexpr double kPowersOfTen[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15};
+  const char* end = data + size;
+  const bool negative = size > 0 && data[0] == '-';
+  if (negative) {
+    ++data;
+  }
+  if (data == end || end - data > 16) {
+    return false;
+  }
+  const char* point = static_cast<const char*>(
+      std::memchr(data, '.', end - data));
+  uint64_t value = 0;
+  int32_t scale = 0;
+  if (point == nullptr) {
+    if (end - data > 15 || !detail::parseDigits(data, end, value)) {
+      return false;
+    }
+  } else {
+    if (point == data || point + 1 == end ||
+        !detail::parseDigits(data, point, value) ||
+        !detail::parseDigits(point + 1, end, value)) {
+      return false;
+    }
+    scale = end - point - 1;
+  }
+  const double number = static_cast<double>(value) / kPowersOfTen[scale];
+  result = static_cast<T>(negative ? -number : number);
+  return true;
+}
+
 template <TypeKind KIND, typename = void, bool TRUNCATE = false>
 struct Converter {
   template <typename T>
@@ -362,18 +482,28 @@ template <bool TRUNCATE>
 struct Converter<TypeKind::VARCHAR, void, TRUNCATE> {
   template <typename T>
   static std::string cast(const T& val, bool& nullOutput) {
-    if constexpr (
-        TRUNCATE && (std::is_same_v<T, double> || std::is_same_v<T, double>)) {
-      auto stringValue = folly::to<std::string>(val);
-      if (stringValue.find(".") == std::string::npos &&
-          isdigit(stringValue[stringValue.length() - 1])) {
-        stringValue += ".0";
-      }
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      std::string stringValue;
+      append(val, stringValue);
       return stringValue;
     }
     return folly::to<std::string>(val);
   }
 
+  /// Appends the text of the number 'val' to 'out'. Lets callers reuse 'out'
+  /// instead of allocating a string per value.
+  template <typename T>
+  static void append(const T& val, std::string& out) {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+    const auto begin = out.size();
+    folly::toAppend(val, &out);
+    if constexpr (TRUNCATE && std::is_same_v<T, double>) {
+      if (out.find('.', begin) == std::string::npos && isdigit(out.back())) {
+        out += ".0";
+      }
+    }
+  }
+
   static std::string cast(const bool& val, bool& nullOutput) {
     return val ? "true" : "false";
   }
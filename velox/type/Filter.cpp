@@ -15,6 +15,7 @@
  */
 
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -56,6 +57,9 @@ std::string Filter::toString() const {
     case FilterKind::kBigintValuesUsingBitmask:
       strKind = "BigintValuesUsingBitmask";
       break;
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      strKind = "BigintValuesUsingBloomFilter";
+      break;
     case FilterKind::kNegatedBigintValuesUsingHashTable:
       strKind = "NegatedBigintValuesUsingHashTable";
       break;
@@ -300,6 +304,21 @@ bool BigintValuesUsingHashTable::testInt64Range(
   return max >= *it;
 }
 
+bool BigintValuesUsingBloomFilter::testInt64Range(
+    int64_t min,
+    int64_t max,
+    bool hasNull) const {
+  if (hasNull && nullAllowed_) {
+    return true;
+  }
+
+  if (min == max) {
+    return testInt64(min);
+  }
+
+  return !(min > max_ || max < min_);
+}
+
 NegatedBigintValuesUsingBitmask::NegatedBigintValuesUsingBitmask(
     int64_t min,
     int64_t max,
@@ -487,8 +506,79 @@ int compareRanges(const char* lhs, size_t length, const std::string& rhs) {
   }
   return length - rhs.size();
 }
+
+// Returns the first 8 bytes of 'value', i.e. its length in the low and its
+// first 4 bytes in the high half. The bytes past the end of a string shorter
+// than 4 are 0.
+inline int64_t sizeAndPrefix(const StringView& value) {
+  int64_t word;
+  memcpy(&word, &value, sizeof(word));
+  return word;
+}
+
+// Returns the first 4 bytes of 'value' as a number that orders like the bytes
+// compare. Strings with different keys compare like their keys. Strings with
+// the same key need a full comparison.
+inline int64_t prefixKey(const StringView& value) {
+  return __builtin_bswap32(
+      static_cast<uint32_t>(static_cast<uint64_t>(sizeAndPrefix(value)) >> 32));
+}
+
+// Sets the bits of the values in 'values' that pass in 'passed'. 'makeKey'
+// gives a 64 bit key for each value. 'decide' takes a batch of keys and sets
+// 'pass' to the lanes that surely pass and 'maybe' to the lanes that may pass.
+// The values that may pass and do not surely pass are tested with 'test', as
+// are the values after the last full batch.
+template <typename MakeKey, typename Decide, typename Test>
+void testStringViewsByKey(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed,
+    MakeKey makeKey,
+    Decide decide,
+    Test test) {
+  using Batch = xsimd::batch<int64_t>;
+  constexpr int32_t kWidth = Batch::size;
+  static_assert(64 % kWidth == 0);
+  std::fill(passed, passed + bits::nwords(numValues), 0);
+  alignas(sizeof(Batch)) int64_t keys[kWidth];
+  int32_t i = 0;
+  for (; i + kWidth <= numValues; i += kWidth) {
+    for (auto j = 0; j < kWidth; ++j) {
+      keys[j] = makeKey(values[i + j]);
+    }
+    uint16_t pass;
+    uint16_t maybe;
+    decide(Batch::load_aligned(keys), pass, maybe);
+    maybe &= ~pass;
+    while (maybe) {
+      auto j = bits::getAndClearLastSetBit(maybe);
+      if (test(values[i + j])) {
+        pass |= 1 << j;
+      }
+    }
+    passed[i / 64] |= static_cast<uint64_t>(pass) << (i % 64);
+  }
+  for (; i < numValues; ++i) {
+    if (test(values[i])) {
+      bits::setBit(passed, i);
+    }
+  }
+}
 } // namespace
 
+void Filter::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  std::fill(passed, passed + bits::nwords(numValues), 0);
+  for (auto i = 0; i < numValues; ++i) {
+    if (testBytes(values[i].data(), values[i].size())) {
+      bits::setBit(passed, i);
+    }
+  }
+}
+
 bool BytesRange::testBytes(const char* value, int32_t length) const {
   if (length == 0) {
     // Empty string. value is null. This is the smallest possible string.
@@ -520,6 +610,51 @@ bool BytesRange::testBytes(const char* value, int32_t length) const {
   return true;
 }
 
+void BytesRange::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  using Batch = xsimd::batch<int64_t>;
+  auto test = [&](const StringView& value) {
+    return testBytes(value.data(), value.size());
+  };
+  if (singleValue_) {
+    // A value with the length and first 4 bytes of 'lower_' passes if it is
+    // not longer than 4.
+    const auto wanted = xsimd::broadcast<int64_t>(
+        sizeAndPrefix(StringView(lower_.data(), lower_.size())));
+    const bool decidedByPrefix = lower_.size() <= StringView::kPrefixSize;
+    testStringViewsByKey(
+        values,
+        numValues,
+        passed,
+        sizeAndPrefix,
+        [&](Batch keys, uint16_t& pass, uint16_t& maybe) {
+          maybe = simd::toBitMask(keys == wanted);
+          pass = decidedByPrefix ? maybe : 0;
+        },
+        test);
+    return;
+  }
+  // Keys are in [0, 2^32). An unbounded end is outside of this range.
+  const auto lower = xsimd::broadcast<int64_t>(
+      lowerUnbounded_ ? -1
+                      : prefixKey(StringView(lower_.data(), lower_.size())));
+  const auto upper = xsimd::broadcast<int64_t>(
+      upperUnbounded_ ? 1L << 32
+                      : prefixKey(StringView(upper_.data(), upper_.size())));
+  testStringViewsByKey(
+      values,
+      numValues,
+      passed,
+      prefixKey,
+      [&](Batch keys, uint16_t& pass, uint16_t& maybe) {
+        pass = simd::toBitMask((lower < keys) & (keys < upper));
+        maybe = simd::toBitMask((lower <= keys) & (keys <= upper));
+      },
+      test);
+}
+
 bool BytesRange::testBytesRange(
     std::optional<std::string_view> min,
     std::optional<std::string_view> max,
@@ -558,6 +693,70 @@ bool BytesRange::testBytesRange(
   return true;
 }
 
+void BytesValues::initSizeAndPrefixes() {
+  for (const auto& value : values_) {
+    sizeAndPrefixes_.push_back(
+        sizeAndPrefix(StringView(value.data(), value.size())));
+  }
+  std::sort(sizeAndPrefixes_.begin(), sizeAndPrefixes_.end());
+  sizeAndPrefixes_.erase(
+      std::unique(sizeAndPrefixes_.begin(), sizeAndPrefixes_.end()),
+      sizeAndPrefixes_.end());
+}
+
+void BytesValues::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  using Batch = xsimd::batch<int64_t>;
+  // Up to this many keys are compared to each batch of values. Above this the
+  // batch is compared to the range of keys and the keys in range are searched.
+  constexpr int32_t kMaxBroadcastKeys = 8;
+  const auto maxPrefixLength =
+      xsimd::broadcast<int64_t>(StringView::kPrefixSize);
+  const auto sizeMask = xsimd::broadcast<int64_t>(0xffffffff);
+  auto test = [&](const StringView& value) {
+    return testBytes(value.data(), value.size());
+  };
+  if (sizeAndPrefixes_.size() <= kMaxBroadcastKeys) {
+    testStringViewsByKey(
+        values,
+        numValues,
+        passed,
+        sizeAndPrefix,
+        [&](Batch keys, uint16_t& pass, uint16_t& maybe) {
+          auto hits = keys == xsimd::broadcast<int64_t>(sizeAndPrefixes_[0]);
+          for (auto i = 1; i < sizeAndPrefixes_.size(); ++i) {
+            hits =
+                hits | (keys == xsimd::broadcast<int64_t>(sizeAndPrefixes_[i]));
+          }
+          maybe = simd::toBitMask(hits);
+          // A hit with a length of at most 4 is a value in the list.
+          pass = simd::toBitMask(hits & ((keys & sizeMask) <= maxPrefixLength));
+        },
+        test);
+    return;
+  }
+  const auto lowest = xsimd::broadcast<int64_t>(sizeAndPrefixes_.front());
+  const auto highest = xsimd::broadcast<int64_t>(sizeAndPrefixes_.back());
+  testStringViewsByKey(
+      values,
+      numValues,
+      passed,
+      sizeAndPrefix,
+      [&](Batch keys, uint16_t& pass, uint16_t& maybe) {
+        pass = 0;
+        maybe = simd::toBitMask((lowest <= keys) & (keys <= highest));
+      },
+      [&](const StringView& value) {
+        return std::binary_search(
+                   sizeAndPrefixes_.begin(),
+                   sizeAndPrefixes_.end(),
+                   sizeAndPrefix(value)) &&
+            test(value);
+      });
+}
+
 bool BytesValues::testBytesRange(
     std::optional<std::string_view> min,
     std::optional<std::string_view> max,
@@ -1151,6 +1350,8 @@ std::unique_ptr<Filter> BigintRange::mergeWith(const Filter* other) const {
           std::make_unique<common::BigintRange>(lower_, upper_, false));
       return combineRangesAndNegatedValues(rangeList, vals, bothNullAllowed);
     }
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     default:
       VELOX_UNREACHABLE();
   }
@@ -1244,6 +1445,8 @@ std::unique_ptr<Filter> NegatedBigintRange::mergeWith(
           negatedValuesToRanges(rejectedValues),
           bothNullAllowed);
     }
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     default:
       VELOX_UNREACHABLE();
   }
@@ -1302,6 +1505,8 @@ std::unique_ptr<Filter> BigintValuesUsingHashTable::mergeWith(
     case FilterKind::kNegatedBigintValuesUsingHashTable: {
       return mergeWith(min_, max_, other);
     }
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     default:
       VELOX_UNREACHABLE();
   }
@@ -1395,6 +1600,8 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
     case FilterKind::kNegatedBigintValuesUsingHashTable: {
       return mergeWith(min_, max_, other);
     }
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     default:
       VELOX_UNREACHABLE();
   }
@@ -1415,6 +1622,68 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
   return createBigintValues(valuesToKeep, bothNullAllowed);
 }
 
+std::unique_ptr<Filter> BigintValuesUsingBloomFilter::mergeWith(
+    const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this, false);
+    case FilterKind::kBigintRange: {
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+      auto otherRange = static_cast<const BigintRange*>(other);
+      auto min = std::max(min_, otherRange->lower());
+      auto max = std::min(max_, otherRange->upper());
+      if (min > max) {
+        return nullOrFalse(bothNullAllowed);
+      }
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          min, max, bloomFilter_, bothNullAllowed);
+    }
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBitmask: {
+      // Keep the values of the exact IN-list that may pass 'this'.
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+      std::vector<int64_t> values;
+      if (other->kind() == FilterKind::kBigintValuesUsingHashTable) {
+        values =
+            static_cast<const BigintValuesUsingHashTable*>(other)->values();
+      } else {
+        values = static_cast<const BigintValuesUsingBitmask*>(other)->values();
+      }
+      std::vector<int64_t> valuesToKeep;
+      valuesToKeep.reserve(values.size());
+      for (auto value : values) {
+        if (testInt64(value)) {
+          valuesToKeep.push_back(value);
+        }
+      }
+      return createBigintValues(valuesToKeep, bothNullAllowed);
+    }
+    case FilterKind::kBigintValuesUsingBloomFilter: {
+      // Only the Bloom filter of 'this' is kept.
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+      auto otherBloom = static_cast<const BigintValuesUsingBloomFilter*>(other);
+      auto min = std::max(min_, otherBloom->min());
+      auto max = std::min(max_, otherBloom->max());
+      if (min > max) {
+        return nullOrFalse(bothNullAllowed);
+      }
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          min, max, bloomFilter_, bothNullAllowed);
+    }
+    case FilterKind::kNegatedBigintRange:
+    case FilterKind::kNegatedBigintValuesUsingBitmask:
+    case FilterKind::kNegatedBigintValuesUsingHashTable:
+    case FilterKind::kBigintMultiRange:
+      return other->clone();
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
 std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
     const Filter* other) const {
   // Rules of NegatedBigintValuesUsingHashTable with IsNull/IsNotNull
@@ -1449,6 +1718,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
     case FilterKind::kNegatedBigintValuesUsingBitmask: {
       return other->mergeWith(this);
     }
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     default:
       VELOX_UNREACHABLE();
   }
@@ -1493,6 +1764,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingBitmask::mergeWith(
       return combineNegatedBigintLists(
           values(), otherBitmask->values(), bothNullAllowed);
     }
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     default:
       VELOX_UNREACHABLE();
   }
@@ -1566,6 +1839,8 @@ std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
       bool bothNullAllowed = nullAllowed_ && other->testNull();
       return combineRangesAndNegatedValues(ranges_, rejects, bothNullAllowed);
     }
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     default:
       VELOX_UNREACHABLE();
   }
@@ -25,6 +25,7 @@
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/type/StringView.h"
@@ -41,6 +42,7 @@ enum class FilterKind {
   kBigintRange,
   kBigintValuesUsingHashTable,
   kBigintValuesUsingBitmask,
+  kBigintValuesUsingBloomFilter,
   kNegatedBigintRange,
   kNegatedBigintValuesUsingHashTable,
   kNegatedBigintValuesUsingBitmask,
@@ -171,6 +173,15 @@ class Filter {
     VELOX_UNSUPPORTED("{}: testBytes() is not supported.", toString());
   }
 
+  /// Tests 'numValues' non-null strings in 'values'. Sets the bits of the
+  /// passing values in 'passed' and clears the others. 'passed' must have
+  /// space for bits::nwords(numValues) words. The default calls testBytes()
+  /// for each value.
+  virtual void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const;
+
   // Returns true if it is useful to call testLength before other
   // tests. This should be true for string IN and equals because it is
   // possible to fail these based on the length alone. This would
@@ -836,6 +847,84 @@ class BigintValuesUsingBitmask final : public Filter {
   const int64_t max_;
 };
 
+/// Approximate IN-list filter for integral data types backed by a Bloom
+/// filter. Passes all values in the set and a small fraction of values that
+/// are not in it. Used for dynamic filters produced by a hash join build side
+/// whose keys are too many for an exact IN-list. Because of the false
+/// positives this must only be used where the consumer re-applies the exact
+/// condition, e.g. on the probe side of a join.
+class BigintValuesUsingBloomFilter final : public Filter {
+ public:
+  /// @param min Minimum value.
+  /// @param max Maximum value.
+  /// @param bloomFilter Bloom filter populated with all values that pass the
+  /// filter. Shared between copies of the filter.
+  /// @param nullAllowed Null values are passing the filter if true.
+  BigintValuesUsingBloomFilter(
+      int64_t min,
+      int64_t max,
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(min),
+        max_(max),
+        bloomFilter_(std::move(bloomFilter)) {
+    VELOX_CHECK_LE(min_, max_);
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+  }
+
+  BigintValuesUsingBloomFilter(
+      const BigintValuesUsingBloomFilter& other,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(other.min_),
+        max_(other.max_),
+        bloomFilter_(other.bloomFilter_) {}
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    if (nullAllowed) {
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          *this, nullAllowed.value());
+    } else {
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this);
+    }
+  }
+
+  bool testInt64(int64_t value) const final {
+    return value >= min_ && value <= max_ && bloomFilter_->mayContain(value);
+  }
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
+
+  /// Merges with 'other'. If 'other' cannot be combined with a Bloom filter,
+  /// e.g. a NOT IN-list, returns a copy of 'other'. The result is then less
+  /// selective than the conjunction of the two, which is acceptable for an
+  /// approximate filter.
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  int64_t min() const {
+    return min_;
+  }
+
+  int64_t max() const {
+    return max_;
+  }
+
+  std::string toString() const final {
+    return fmt::format(
+        "BigintValuesUsingBloomFilter: [{}, {}] {}",
+        min_,
+        max_,
+        nullAllowed_ ? "with nulls" : "no nulls");
+  }
+
+ private:
+  const int64_t min_;
+  const int64_t max_;
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+};
+
 // NOT IN-list filter for integral data types. Implemented as a hash table. Good
 // for large number of rejected values that do not fit within a small range.
 class NegatedBigintValuesUsingHashTable final : public Filter {
@@ -1331,6 +1420,13 @@ class BytesRange final : public AbstractRange {
 
   bool testBytes(const char* value, int32_t length) const final;
 
+  /// Decides values by their length and first 4 bytes, a batch at a time, and
+  /// calls testBytes() only for the values these do not decide.
+  void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const final;
+
   bool testBytesRange(
       std::optional<std::string_view> min,
       std::optional<std::string_view> max,
@@ -1485,6 +1581,7 @@ class BytesValues final : public Filter {
 
     lower_ = *std::min_element(values_.begin(), values_.end());
     upper_ = *std::max_element(values_.begin(), values_.end());
+    initSizeAndPrefixes();
   }
 
   BytesValues(const BytesValues& other, bool nullAllowed)
@@ -1492,7 +1589,8 @@ class BytesValues final : public Filter {
         lower_(other.lower_),
         upper_(other.upper_),
         values_(other.values_),
-        lengths_(other.lengths_) {}
+        lengths_(other.lengths_),
+        sizeAndPrefixes_(other.sizeAndPrefixes_) {}
 
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
@@ -1512,6 +1610,13 @@ class BytesValues final : public Filter {
         values_.contains(std::string(value, length));
   }
 
+  /// Rejects values whose length and first 4 bytes are not those of any value
+  /// in the list, a batch at a time, before looking the rest up in 'values_'.
+  void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const final;
+
   bool testBytesRange(
       std::optional<std::string_view> min,
       std::optional<std::string_view> max,
@@ -1526,8 +1631,15 @@ class BytesValues final : public Filter {
  private:
   std::string lower_;
   std::string upper_;
+  // Fills 'sizeAndPrefixes_' from 'values_'.
+  void initSizeAndPrefixes();
+
   folly::F14FastSet<std::string> values_;
   folly::F14FastSet<uint32_t> lengths_;
+
+  // The distinct first 8 bytes of the StringViews of 'values_', i.e. the
+  // length and the zero padded first 4 bytes, in ascending order.
+  std::vector<int64_t> sizeAndPrefixes_;
 };
 
 /// Represents a combination of two of more range filters on integral types with
@@ -442,6 +442,57 @@ TEST(FilterTest, bigintValuesUsingBitmask) {
   EXPECT_FALSE(filter->testInt64Range(1234, 2000, false));
 }
 
+TEST(FilterTest, bigintValuesUsingBloomFilter) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(1'000);
+  for (int64_t i = 0; i < 1'000; ++i) {
+    bloomFilter->insert(i * 1'000);
+  }
+  auto filter = std::make_unique<BigintValuesUsingBloomFilter>(
+      0, 999'000, bloomFilter, false);
+
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 1'000; ++i) {
+    EXPECT_TRUE(filter->testInt64(i * 1'000));
+    numFalsePositives += filter->testInt64(i * 1'000 + 1);
+  }
+  EXPECT_LT(numFalsePositives, 100);
+
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testInt64(-1'000));
+  EXPECT_FALSE(filter->testInt64(1'000'000));
+
+  EXPECT_TRUE(filter->testInt64Range(5, 50'000, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -5, false));
+  EXPECT_FALSE(filter->testInt64Range(1'000'000, 2'000'000, false));
+  EXPECT_FALSE(filter->testInt64Range(1'000'000, 2'000'000, true));
+
+  auto withNulls = filter->clone(true);
+  EXPECT_TRUE(withNulls->testNull());
+  EXPECT_TRUE(withNulls->testInt64(5'000));
+
+  // Merge with a range narrows the bounds.
+  auto range = std::make_unique<BigintRange>(0, 10'000, false);
+  auto merged = filter->mergeWith(range.get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  EXPECT_TRUE(merged->testInt64(10'000));
+  EXPECT_FALSE(merged->testInt64(11'000));
+  merged = range->mergeWith(filter.get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  EXPECT_FALSE(merged->testInt64(11'000));
+
+  // Merge with an IN-list makes an exact IN-list.
+  auto values = createBigintValues({1'000, 2'000, 2'001, 5'000'000}, false);
+  merged = values->mergeWith(filter.get());
+  EXPECT_TRUE(merged->testInt64(1'000));
+  EXPECT_TRUE(merged->testInt64(2'000));
+  EXPECT_FALSE(merged->testInt64(5'000'000));
+  EXPECT_FALSE(merged->testInt64(3'000));
+
+  merged = filter->mergeWith(std::make_unique<IsNull>().get());
+  EXPECT_EQ(merged->kind(), FilterKind::kAlwaysFalse);
+}
+
 TEST(FilterTest, negatedBigintValuesUsingBitmask) {
   auto filter = createNegatedBigintValues({1, 6, 1000, 8, 9, 100, 10}, false);
   auto castedFilter =
@@ -934,6 +985,77 @@ TEST(FilterTest, bytesValues) {
   EXPECT_FALSE(filter->testBytesRange(std::nullopt, "Banana", false));
 }
 
+TEST(FilterTest, testStringViews) {
+  std::vector<std::string> strings = {
+      "",
+      "a",
+      std::string("a\0", 2),
+      "ab",
+      "abc",
+      "abcd",
+      "abcde",
+      "abcdefghijklmn",
+      "abd",
+      "b",
+      "Igne",
+      "natura",
+      "natural",
+      "renovitur",
+      "integra.",
+      "zzzzzzzzzzzzzzzz",
+      std::string("\xff\xff\xff\xff\xff", 5)};
+  // Repeats the strings in a different order so that each is tested in
+  // different positions of a batch and in the tail.
+  auto numStrings = strings.size();
+  for (auto i = 0; i < 3 * numStrings; ++i) {
+    strings.push_back(strings[(i * 7) % numStrings]);
+  }
+  std::vector<StringView> views;
+  for (const auto& string : strings) {
+    views.emplace_back(string.data(), string.size());
+  }
+
+  auto check = [&](const Filter& filter) {
+    for (auto numValues : {0, 1, 5, 16, (int32_t)views.size()}) {
+      std::vector<uint64_t> passed(bits::nwords(numValues), ~0UL);
+      filter.testStringViews(views.data(), numValues, passed.data());
+      for (auto i = 0; i < numValues; ++i) {
+        ASSERT_EQ(
+            filter.testBytes(views[i].data(), views[i].size()),
+            bits::isBitSet(passed.data(), i))
+            << filter.toString() << " " << strings[i];
+      }
+      for (auto i = numValues; i < passed.size() * 64; ++i) {
+        ASSERT_FALSE(bits::isBitSet(passed.data(), i));
+      }
+    }
+  };
+
+  check(*between("abc", "abcde"));
+  check(*between("ab", "ab"));
+  check(*between("abcdefghijklmn", "abcdefghijklmn"));
+  check(*between("", ""));
+  check(*betweenExclusive("a", "natura"));
+  check(*lessThan("abd"));
+  check(*lessThanOrEqual(""));
+  check(*greaterThan("abcd"));
+  check(*greaterThanOrEqual(std::string("a\0", 2)));
+  check(*in(std::vector<std::string>{"abc", "natura", ""}));
+  check(*in(std::vector<std::string>{
+      "a",
+      "ab",
+      "abcd",
+      "abcdefghijklmn",
+      "b",
+      "Igne",
+      "renovitur",
+      "integra.",
+      "zzzzzzzzzzzzzzzz",
+      "abcdefghijklmx"}));
+  // The default implementation.
+  check(*notBetween("abc", "b"));
+}
+
 TEST(FilterTest, negatedBytesValues) {
   // create a filter
   std::vector<std::string> values(
@@ -15,6 +15,9 @@
  */
 
 #include "velox/vector/BaseVector.h"
+
+#include <folly/container/F14Set.h>
+
 #include "velox/type/StringView.h"
 #include "velox/type/Type.h"
 #include "velox/type/Variant.h"
@@ -728,6 +731,116 @@ bool isLazyNotLoaded(const BaseVector& vector) {
   }
 }
 
+namespace {
+void addUniqueBuffer(
+    const Buffer* buffer,
+    folly::F14FastSet<const Buffer*>& buffers,
+    uint64_t& size) {
+  if (buffer && buffers.insert(buffer).second) {
+    size += buffer->capacity();
+  }
+}
+
+void addUniqueRetainedSize(
+    const BaseVector& vector,
+    folly::F14FastSet<const BaseVector*>& vectors,
+    folly::F14FastSet<const Buffer*>& buffers,
+    uint64_t& size) {
+  if (!vectors.insert(&vector).second) {
+    return;
+  }
+  auto addVector = [&](const VectorPtr& child) {
+    if (child) {
+      addUniqueRetainedSize(*child, vectors, buffers, size);
+    }
+  };
+  switch (vector.encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      addUniqueBuffer(vector.values().get(), buffers, size);
+      if (vector.typeKind() == TypeKind::VARCHAR ||
+          vector.typeKind() == TypeKind::VARBINARY) {
+        for (const auto& buffer :
+             vector.asUnchecked<FlatVector<StringView>>()->stringBuffers()) {
+          addUniqueBuffer(buffer.get(), buffers, size);
+        }
+      }
+      break;
+    case VectorEncoding::Simple::CONSTANT:
+      if (!vector.valueVector()) {
+        size += vector.retainedSize();
+        return;
+      }
+      addVector(vector.valueVector());
+      return;
+    case VectorEncoding::Simple::DICTIONARY:
+    case VectorEncoding::Simple::SEQUENCE:
+      addUniqueBuffer(vector.wrapInfo().get(), buffers, size);
+      addVector(vector.valueVector());
+      break;
+    case VectorEncoding::Simple::ROW:
+      for (const auto& child : vector.asUnchecked<RowVector>()->children()) {
+        addVector(child);
+      }
+      break;
+    case VectorEncoding::Simple::ARRAY: {
+      auto* arrays = vector.asUnchecked<ArrayVector>();
+      addUniqueBuffer(arrays->offsets().get(), buffers, size);
+      addUniqueBuffer(arrays->sizes().get(), buffers, size);
+      addVector(arrays->elements());
+      break;
+    }
+    case VectorEncoding::Simple::MAP: {
+      auto* maps = vector.asUnchecked<MapVector>();
+      addUniqueBuffer(maps->offsets().get(), buffers, size);
+      addUniqueBuffer(maps->sizes().get(), buffers, size);
+      addVector(maps->mapKeys());
+      addVector(maps->mapValues());
+      break;
+    }
+    case VectorEncoding::Simple::LAZY:
+      // The nulls of a loaded lazy vector are those of the loaded vector.
+      if (vector.asUnchecked<LazyVector>()->isLoaded()) {
+        addUniqueRetainedSize(*vector.loadedVector(), vectors, buffers, size);
+      }
+      return;
+    default:
+      size += vector.retainedSize();
+      return;
+  }
+  addUniqueBuffer(vector.nulls().get(), buffers, size);
+}
+} // namespace
+
+uint64_t BaseVector::uniqueRetainedSize() const {
+  folly::F14FastSet<const BaseVector*> vectors;
+  folly::F14FastSet<const Buffer*> buffers;
+  uint64_t size = 0;
+  addUniqueRetainedSize(*this, vectors, buffers, size);
+  return size;
+}
+
+void BaseVector::copy(
+    const BaseVector* source,
+    const SelectivityVector& rows,
+    const vector_size_t* toSourceRow) {
+  std::vector<CopyRange> ranges;
+  rows.applyToSelected([&](vector_size_t row) {
+    auto sourceRow = toSourceRow ? toSourceRow[row] : row;
+    if (!ranges.empty()) {
+      auto& last = ranges.back();
+      if (last.targetIndex + last.count == row &&
+          last.sourceIndex + last.count == sourceRow) {
+        ++last.count;
+        return;
+      }
+    }
+    ranges.push_back({sourceRow, row, 1});
+  });
+  if (!ranges.empty()) {
+    copyRanges(source, ranges);
+  }
+}
+
 uint64_t BaseVector::estimateFlatSize() const {
   if (length_ == 0) {
     return 0;
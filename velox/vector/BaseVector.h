@@ -375,20 +375,12 @@ class BaseVector {
 
   // Sets the rows of 'this' given by 'rows' to
   // 'source.valueAt(toSourceRow ? toSourceRow[row] : row)', where
-  // 'row' iterates over 'rows'.
+  // 'row' iterates over 'rows'. Consecutive rows that come from consecutive
+  // source rows are copied as a single range by copyRanges().
   virtual void copy(
       const BaseVector* source,
       const SelectivityVector& rows,
-      const vector_size_t* toSourceRow) {
-    rows.applyToSelected([&](vector_size_t row) {
-      auto sourceRow = toSourceRow ? toSourceRow[row] : row;
-      if (source->isNullAt(sourceRow)) {
-        setNull(row, true);
-      } else {
-        copy(source, row, sourceRow, 1);
-      }
-    });
-  }
+      const vector_size_t* toSourceRow);
 
   // Utility for making a deep copy of a whole vector.
   static std::shared_ptr<BaseVector> copy(const BaseVector& vector) {
@@ -635,6 +627,13 @@ class BaseVector {
     return nulls_ ? nulls_->capacity() : 0;
   }
 
+  /// Returns the byte size of the distinct buffers kept live through 'this'.
+  /// Unlike retainedSize(), a buffer or vector that is referenced more than
+  /// once, e.g. a string buffer shared by several vectors or the base of
+  /// dictionaries wrapping several columns, is counted once. Loaded lazy
+  /// vectors count their loaded values, unloaded ones count zero.
+  uint64_t uniqueRetainedSize() const;
+
   /// Returns an estimate of the 'retainedSize' of a flat representation of the
   /// data stored in this vector. Returns zero if this is a lazy vector that
   /// hasn't been loaded yet.
@@ -16,6 +16,7 @@
 #include "velox/vector/DecodedVector.h"
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/vector/BaseVector.h"
 #include "velox/vector/BiasVector.h"
 #include "velox/vector/LazyVector.h"
@@ -151,10 +152,28 @@ void DecodedVector::combineWrappers(
     vector_size_t lastIndex = 0;
     values = vector->valueVector().get();
 
-    applyToRows(rows, [&](vector_size_t row) {
-      copiedIndices_[row] =
-          offsetOfIndex(sizes, row, &lastBegin, &lastEnd, &lastIndex);
-    });
+    if (!rows || rows->isAllSelected()) {
+      // All the rows of a run map to the index of the run, so that the
+      // indices are filled a run at a time.
+      auto row = rows ? rows->begin() : 0;
+      const auto endRow = end(rows);
+      while (row < endRow) {
+        while (lastEnd <= row) {
+          lastEnd += sizes[++lastIndex];
+        }
+        const auto runEnd = std::min(lastEnd, endRow);
+        std::fill(
+            copiedIndices_.begin() + row,
+            copiedIndices_.begin() + runEnd,
+            lastIndex);
+        row = runEnd;
+      }
+    } else {
+      applyToRows(rows, [&](vector_size_t row) {
+        copiedIndices_[row] =
+            offsetOfIndex(sizes, row, &lastBegin, &lastEnd, &lastIndex);
+      });
+    }
 
   } else {
     VELOX_FAIL(
@@ -345,12 +364,24 @@ void DecodedVector::setFlatNulls(
     }
     auto leafNulls = vector.rawNulls();
     auto copiedNulls = &copiedNulls_[0];
-    applyToRows(rows, [&](vector_size_t row) {
-      if (!bits::isBitNull(nulls_, row) &&
-          (leafNulls && bits::isBitNull(leafNulls, indices_[row]))) {
-        bits::setNull(copiedNulls, row);
+    if (leafNulls && (!rows || rows->isAllSelected())) {
+      // All rows have an index, so the leaf nulls are gathered and combined
+      // a word at a time.
+      const auto numRows = end(rows);
+      std::vector<uint64_t> leafRowNulls(bits::nwords(numRows));
+      simd::gatherBits(
+          leafNulls, folly::Range(indices_, numRows), leafRowNulls.data());
+      for (auto i = 0; i < leafRowNulls.size(); ++i) {
+        copiedNulls[i] &= leafRowNulls[i];
       }
-    });
+    } else if (leafNulls) {
+      applyToRows(rows, [&](vector_size_t row) {
+        if (!bits::isBitNull(nulls_, row) &&
+            bits::isBitNull(leafNulls, indices_[row])) {
+          bits::setNull(copiedNulls, row);
+        }
+      });
+    }
     nulls_ = &copiedNulls_[0];
   } else {
     nulls_ = vector.rawNulls();
@@ -551,10 +582,8 @@ const uint64_t* DecodedVector::nulls() {
     } else {
       // Copy base nulls.
       copiedNulls_.resize(bits::nwords(size_));
-      auto* rawCopiedNulls = copiedNulls_.data();
-      for (auto i = 0; i < size_; ++i) {
-        bits::setNull(rawCopiedNulls, i, bits::isBitNull(nulls_, indices_[i]));
-      }
+      simd::gatherBits(
+          nulls_, folly::Range(indices_, size_), copiedNulls_.data());
       allNulls_ = copiedNulls_.data();
     }
   }
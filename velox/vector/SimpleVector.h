@@ -240,13 +240,13 @@ class SimpleVector : public BaseVector {
       return isAllAscii_;
     }
     ensureIsAsciiCapacity(rows.end());
-    bool isAllAscii = true;
-    rows.template applyToSelected([&](auto row) {
-      if (!isNullAt(row)) {
-        auto string = valueAt(row);
-        isAllAscii &=
-            functions::stringCore::isAscii(string.data(), string.size());
+    // Stops at the first string that is not ASCII.
+    const bool isAllAscii = rows.template testSelected([&](auto row) {
+      if (isNullAt(row)) {
+        return true;
       }
+      auto string = valueAt(row);
+      return functions::stringCore::isAscii(string.data(), string.size());
     });
 
     // Set isAllAscii flag, it will unset if we encounter any utf.
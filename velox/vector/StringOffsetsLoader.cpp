@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/vector/StringOffsetsLoader.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox {
+
+StringOffsetsLoader::StringOffsetsLoader(
+    memory::MemoryPool* pool,
+    TypePtr type,
+    vector_size_t size,
+    BufferPtr nulls,
+    BufferPtr offsets,
+    BufferPtr data)
+    : pool_(pool),
+      type_(std::move(type)),
+      size_(size),
+      nulls_(std::move(nulls)),
+      offsets_(std::move(offsets)),
+      data_(std::move(data)) {
+  VELOX_CHECK(
+      type_->kind() == TypeKind::VARCHAR ||
+          type_->kind() == TypeKind::VARBINARY,
+      "StringOffsetsLoader needs a VARCHAR or VARBINARY type, got {}",
+      type_->toString());
+  VELOX_CHECK_GE(offsets_->size(), (size_ + 1) * sizeof(int32_t));
+  VELOX_CHECK_GE(data_->size(), offsets_->as<int32_t>()[size_]);
+  VELOX_CHECK(!nulls_ || nulls_->size() >= bits::nbytes(size_));
+}
+
+// static
+VectorPtr StringOffsetsLoader::makeLazy(
+    memory::MemoryPool* pool,
+    TypePtr type,
+    vector_size_t size,
+    BufferPtr nulls,
+    BufferPtr offsets,
+    BufferPtr data) {
+  return std::make_shared<LazyVector>(
+      pool,
+      type,
+      size,
+      std::make_unique<StringOffsetsLoader>(
+          pool,
+          type,
+          size,
+          std::move(nulls),
+          std::move(offsets),
+          std::move(data)));
+}
+
+void StringOffsetsLoader::loadInternal(
+    RowSet rows,
+    ValueHook* hook,
+    VectorPtr* result) {
+  if (hook) {
+    for (auto row : rows) {
+      if (isNullAt(row)) {
+        if (hook->acceptsNulls()) {
+          hook->addNull(row);
+        }
+        continue;
+      }
+      auto value = valueAt(row);
+      hook->addValue(row, &value);
+    }
+    return;
+  }
+  auto values = AlignedBuffer::allocate<StringView>(size_, pool_);
+  auto rawValues = values->asMutable<StringView>();
+  if (rows.size() < size_) {
+    // Rows that are not loaded must still hold valid StringViews.
+    std::fill(rawValues, rawValues + size_, StringView());
+  }
+  for (auto row : rows) {
+    rawValues[row] = isNullAt(row) ? StringView() : valueAt(row);
+  }
+  *result = std::make_shared<FlatVector<StringView>>(
+      pool_,
+      type_,
+      nulls_,
+      size_,
+      std::move(values),
+      std::vector<BufferPtr>{data_});
+}
+
+} // namespace facebook::velox
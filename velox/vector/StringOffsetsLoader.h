@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/LazyVector.h"
+
+namespace facebook::velox {
+
+/// Produces a FlatVector<StringView> from VARCHAR or VARBINARY values kept as
+/// contiguous bytes and an offsets buffer, the layout of Arrow and of the
+/// Presto wire format. This takes 4 bytes per value until loaded instead of
+/// the 16 of a StringView, and the StringViews are made for the loaded rows
+/// only. The bytes are not copied, the loaded vector references 'data' as its
+/// string buffer.
+class StringOffsetsLoader : public VectorLoader {
+ public:
+  /// 'offsets' has 'size + 1' entries. The value of row i is the bytes in
+  /// [offsets[i], offsets[i + 1]) of 'data'. 'nulls' may be nullptr.
+  StringOffsetsLoader(
+      memory::MemoryPool* pool,
+      TypePtr type,
+      vector_size_t size,
+      BufferPtr nulls,
+      BufferPtr offsets,
+      BufferPtr data);
+
+  /// Returns a LazyVector of 'size' rows loaded by a StringOffsetsLoader over
+  /// the given buffers.
+  static VectorPtr makeLazy(
+      memory::MemoryPool* pool,
+      TypePtr type,
+      vector_size_t size,
+      BufferPtr nulls,
+      BufferPtr offsets,
+      BufferPtr data);
+
+ protected:
+  void loadInternal(RowSet rows, ValueHook* hook, VectorPtr* result) override;
+
+ private:
+  bool isNullAt(vector_size_t row) const {
+    return nulls_ && bits::isBitNull(nulls_->as<uint64_t>(), row);
+  }
+
+  StringView valueAt(vector_size_t row) const {
+    auto offsets = offsets_->as<int32_t>();
+    return StringView(
+        data_->as<char>() + offsets[row], offsets[row + 1] - offsets[row]);
+  }
+
+  memory::MemoryPool* const pool_;
+  const TypePtr type_;
+  const vector_size_t size_;
+  const BufferPtr nulls_;
+  const BufferPtr offsets_;
+  const BufferPtr data_;
+};
+
+} // namespace facebook::velox
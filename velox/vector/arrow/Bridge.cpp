@@ -448,14 +448,16 @@ void exportBase(
     const BaseVector&,
     const Selection&,
     ArrowArray&,
-    memory::MemoryPool*);
+    memory::MemoryPool*,
+    const ArrowOptions&);
 
 void exportRows(
     const RowVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   out.n_buffers = 1;
   holder.resizeChildren(vec.childrenSize());
   out.n_children = vec.childrenSize();
@@ -466,7 +468,8 @@ void exportRows(
           *vec.childAt(i)->loadedVector(),
           rows,
           *holder.allocateChild(i),
-          pool);
+          pool,
+          options);
     } catch (const VeloxException&) {
       for (column_index_t j = 0; j < i; ++j) {
         // When exception is thrown, i th child is guaranteed unset.
@@ -527,7 +530,8 @@ void exportArrays(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   Selection childRows(vec.elements()->size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
   holder.resizeChildren(1);
@@ -535,7 +539,8 @@ void exportArrays(
       *vec.elements()->loadedVector(),
       childRows,
       *holder.allocateChild(0),
-      pool);
+      pool,
+      options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -545,7 +550,8 @@ void exportMaps(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   RowVector child(
       pool,
       ROW({"key", "value"}, {vec.mapKeys()->type(), vec.mapValues()->type()}),
@@ -555,7 +561,7 @@ void exportMaps(
   Selection childRows(child.size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
   holder.resizeChildren(1);
-  exportBase(child, childRows, *holder.allocateChild(0), pool);
+  exportBase(child, childRows, *holder.allocateChild(0), pool, options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -565,7 +571,8 @@ void exportDictionary(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   out.n_buffers = 2;
   out.n_children = 0;
   if (rows.changed()) {
@@ -577,35 +584,84 @@ void exportDictionary(
   }
   auto& values = *vec.valueVector()->loadedVector();
   out.dictionary = holder.allocateDictionary();
-  exportBase(values, Selection(values.size()), *out.dictionary, pool);
+  exportBase(values, Selection(values.size()), *out.dictionary, pool, options);
+}
+
+// Exports a constant vector as a dictionary array with a single entry that all
+// the indices refer to. A null constant has all its indices null.
+void exportConstant(
+    const BaseVector& vec,
+    ArrowArray& out,
+    memory::MemoryPool* pool,
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
+  out.n_buffers = 2;
+  out.n_children = 0;
+  if (vec.isNullAt(0)) {
+    holder.setBuffer(
+        0, AlignedBuffer::allocate<bool>(out.length, pool, bits::kNull));
+    out.null_count = out.length;
+  } else {
+    out.null_count = 0;
+  }
+  holder.setBuffer(
+      1, AlignedBuffer::allocate<vector_size_t>(out.length, pool, 0));
+  auto values = BaseVector::create(vec.type(), 1, pool);
+  values->copy(&vec, 0, 0, 1);
+  out.dictionary = holder.allocateDictionary();
+  exportBase(*values, Selection(1), *out.dictionary, pool, options);
+}
+
+// Whether 'vec' is exported as flat data although its encoding maps to an
+// Arrow dictionary array.
+bool isFlattened(const BaseVector& vec, const ArrowOptions& options) {
+  return options.flattenDictionary &&
+      (vec.encoding() == VectorEncoding::Simple::DICTIONARY ||
+       vec.encoding() == VectorEncoding::Simple::CONSTANT);
 }
 
 void exportBase(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
+  if (isFlattened(vec, options)) {
+    auto flat = BaseVector::create(vec.type(), vec.size(), pool);
+    flat->copy(&vec, 0, 0, vec.size());
+    exportBase(*flat, rows, out, pool, options);
+    return;
+  }
   auto holder = std::make_unique<VeloxToArrowBridgeHolder>();
   out.buffers = holder->getArrowBuffers();
   out.length = rows.count();
   out.offset = 0;
   out.dictionary = nullptr;
+  if (vec.encoding() == VectorEncoding::Simple::CONSTANT) {
+    exportConstant(vec, out, pool, *holder, options);
+    out.private_data = holder.release();
+    out.release = bridgeRelease;
+    return;
+  }
   exportNulls(vec, rows, out, pool, *holder);
   switch (vec.encoding()) {
     case VectorEncoding::Simple::FLAT:
       exportFlat(vec, rows, out, pool, *holder);
       break;
     case VectorEncoding::Simple::ROW:
-      exportRows(*vec.asUnchecked<RowVector>(), rows, out, pool, *holder);
+      exportRows(
+          *vec.asUnchecked<RowVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::ARRAY:
-      exportArrays(*vec.asUnchecked<ArrayVector>(), rows, out, pool, *holder);
+      exportArrays(
+          *vec.asUnchecked<ArrayVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::MAP:
-      exportMaps(*vec.asUnchecked<MapVector>(), rows, out, pool, *holder);
+      exportMaps(
+          *vec.asUnchecked<MapVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::DICTIONARY:
-      exportDictionary(vec, rows, out, pool, *holder);
+      exportDictionary(vec, rows, out, pool, *holder, options);
       break;
     default:
       VELOX_NYI("{} cannot be exported to Arrow yet.", vec.encoding());
@@ -619,12 +675,22 @@ void exportBase(
 void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
-    memory::MemoryPool* pool) {
-  exportBase(*vector, Selection(vector->size()), arrowArray, pool);
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
+  exportBase(*vector, Selection(vector->size()), arrowArray, pool, options);
 }
 
-void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
+void exportToArrow(
+    const VectorPtr& vec,
+    ArrowSchema& arrowSchema,
+    const ArrowOptions& options) {
   auto& type = vec->type();
+  if (isFlattened(*vec, options)) {
+    // The data is exported as flat at all levels below, like the schema of a
+    // newly created vector.
+    exportToArrow(BaseVector::create(type, 0, vec->pool()), arrowSchema);
+    return;
+  }
 
   arrowSchema.name = nullptr;
 
@@ -643,7 +709,17 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
     arrowSchema.format = "i";
     bridgeHolder->dictionary = std::make_unique<ArrowSchema>();
     arrowSchema.dictionary = bridgeHolder->dictionary.get();
-    exportToArrow(vec->valueVector(), *arrowSchema.dictionary);
+    exportToArrow(vec->valueVector(), *arrowSchema.dictionary, options);
+
+  } else if (vec->encoding() == VectorEncoding::Simple::CONSTANT) {
+    // The single dictionary entry is copied into a flat vector on export.
+    arrowSchema.n_children = 0;
+    arrowSchema.children = nullptr;
+    arrowSchema.format = "i";
+    bridgeHolder->dictionary = std::make_unique<ArrowSchema>();
+    arrowSchema.dictionary = bridgeHolder->dictionary.get();
+    exportToArrow(
+        BaseVector::create(type, 0, vec->pool()), *arrowSchema.dictionary);
 
   } else {
     arrowSchema.format = exportArrowFormatStr(type, bridgeHolder->formatBuffer);
@@ -661,14 +737,14 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
           0,
           std::vector<VectorPtr>{maps.mapKeys(), maps.mapValues()},
           maps.getNullCount());
-      exportToArrow(rows, *child);
+      exportToArrow(rows, *child, options);
       child->name = "entries";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
 
     } else if (type->kind() == TypeKind::ARRAY) {
       auto child = std::make_unique<ArrowSchema>();
       auto& arrays = *vec->asUnchecked<ArrayVector>();
-      exportToArrow(arrays.elements(), *child);
+      exportToArrow(arrays.elements(), *child, options);
       // Name is required, and "item" is the default name used in arrow itself.
       child->name = "item";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
@@ -701,7 +777,7 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
         try {
           auto& currentSchema = bridgeHolder->childrenOwned[i];
           currentSchema = std::make_unique<ArrowSchema>();
-          exportToArrow(rows.childAt(i), *currentSchema);
+          exportToArrow(rows.childAt(i), *currentSchema, options);
           currentSchema->name = bridgeHolder->rowType->nameOf(i).data();
           arrowSchema.children[i] = currentSchema.get();
         } catch (const VeloxException& e) {
@@ -909,6 +985,26 @@ VectorPtr createFlatVector(
 using WrapInBufferViewFunc =
     std::function<BufferPtr(const void* buffer, size_t length)>;
 
+// Returns the 'length' bits starting at bit 'offset' of 'bits'. These are
+// wrapped without copying if 'offset' is a multiple of 8 and copied otherwise.
+BufferPtr wrapBits(
+    const void* bits,
+    int64_t offset,
+    int64_t length,
+    memory::MemoryPool* pool,
+    const WrapInBufferViewFunc& wrapInBufferView) {
+  const auto* rawBits = static_cast<const uint8_t*>(bits);
+  if (offset % 8 == 0) {
+    return wrapInBufferView(rawBits + offset / 8, bits::nbytes(length));
+  }
+  auto copy = AlignedBuffer::allocate<bool>(length, pool);
+  auto* rawCopy = copy->asMutable<uint64_t>();
+  for (int64_t i = 0; i < length; ++i) {
+    bits::setBit(rawCopy, i, bits::isBitSet(rawBits, offset + i));
+  }
+  return copy;
+}
+
 template <typename TOffset>
 VectorPtr createStringFlatVector(
     memory::MemoryPool* pool,
@@ -929,10 +1025,11 @@ VectorPtr createStringFlatVector(
     shouldAcquireStringBuffer |= !rawStringViews[i].isInline();
   }
 
+  // The string bytes are not copied. All offsets are relative to 'values',
+  // also if the array is a slice.
   std::vector<BufferPtr> stringViewBuffers;
   if (shouldAcquireStringBuffer) {
-    stringViewBuffers.emplace_back(
-        wrapInBufferView(values, offsets[length + 1]));
+    stringViewBuffers.emplace_back(wrapInBufferView(values, offsets[length]));
   }
 
   return std::make_shared<FlatVector<StringView>>(
@@ -966,9 +1063,14 @@ RowVectorPtr createRowVector(
   std::vector<VectorPtr> childrenVector;
   childrenVector.reserve(arrowArray.n_children);
 
+  // The offset of a struct applies to its children as well.
   for (size_t i = 0; i < arrowArray.n_children; ++i) {
-    childrenVector.push_back(importFromArrowImpl(
-        *arrowSchema.children[i], *arrowArray.children[i], pool, isViewer));
+    auto child = importFromArrowImpl(
+        *arrowSchema.children[i], *arrowArray.children[i], pool, isViewer);
+    if (arrowArray.offset != 0) {
+      child = child->slice(arrowArray.offset, arrowArray.length);
+    }
+    childrenVector.push_back(std::move(child));
   }
   return std::make_shared<RowVector>(
       pool,
@@ -1004,7 +1106,9 @@ ArrayVectorPtr createArrayVector(
   VELOX_CHECK_EQ(arrowArray.n_buffers, 2);
   VELOX_CHECK_EQ(arrowArray.n_children, 1);
   auto offsets = wrapInBufferView(
-      arrowArray.buffers[1], (arrowArray.length + 1) * sizeof(vector_size_t));
+      static_cast<const vector_size_t*>(arrowArray.buffers[1]) +
+          arrowArray.offset,
+      (arrowArray.length + 1) * sizeof(vector_size_t));
   auto sizes =
       computeSizes(offsets->as<vector_size_t>(), arrowArray.length, pool);
   auto elements = importFromArrowImpl(
@@ -1031,7 +1135,9 @@ MapVectorPtr createMapVector(
   VELOX_CHECK_EQ(arrowArray.n_buffers, 2);
   VELOX_CHECK_EQ(arrowArray.n_children, 1);
   auto offsets = wrapInBufferView(
-      arrowArray.buffers[1], (arrowArray.length + 1) * sizeof(vector_size_t));
+      static_cast<const vector_size_t*>(arrowArray.buffers[1]) +
+          arrowArray.offset,
+      (arrowArray.length + 1) * sizeof(vector_size_t));
   auto sizes =
       computeSizes(offsets->as<vector_size_t>(), arrowArray.length, pool);
   // Arrow wraps keys and values into a struct.
@@ -1068,7 +1174,9 @@ VectorPtr createDictionaryVector(
       TypeKind::INTEGER,
       "Only int32 indices are supported for arrow conversion");
   auto indices = wrapInBufferView(
-      arrowArray.buffers[1], arrowArray.length * sizeof(vector_size_t));
+      static_cast<const vector_size_t*>(arrowArray.buffers[1]) +
+          arrowArray.offset,
+      arrowArray.length * sizeof(vector_size_t));
   auto type = importFromArrow(*arrowSchema.dictionary);
   auto wrapped = importFromArrowImpl(
       *arrowSchema.dictionary, *arrowArray.dictionary, pool, isViewer);
@@ -1087,10 +1195,8 @@ VectorPtr importFromArrowImpl(
     WrapInBufferViewFunc wrapInBufferView) {
   VELOX_USER_CHECK_NOT_NULL(arrowSchema.release, "arrowSchema was released.");
   VELOX_USER_CHECK_NOT_NULL(arrowArray.release, "arrowArray was released.");
-  VELOX_USER_CHECK_EQ(
-      arrowArray.offset,
-      0,
-      "Offsets are not supported during arrow conversion yet.");
+  VELOX_USER_CHECK_GE(
+      arrowArray.offset, 0, "Array offset needs to be non-negative.");
   VELOX_CHECK_GE(
       arrowArray.length, 0, "Array length needs to be non-negative.");
 
@@ -1110,8 +1216,12 @@ VectorPtr importFromArrowImpl(
     VELOX_USER_CHECK_NOT_NULL(
         arrowArray.buffers[0],
         "Nulls buffer can't be null unless null_count is zero.");
-    nulls = wrapInBufferView(
-        arrowArray.buffers[0], bits::nbytes(arrowArray.length));
+    nulls = wrapBits(
+        arrowArray.buffers[0],
+        arrowArray.offset,
+        arrowArray.length,
+        pool,
+        wrapInBufferView);
   }
 
   if (arrowSchema.dictionary) {
@@ -1119,18 +1229,34 @@ VectorPtr importFromArrowImpl(
         pool, type, nulls, arrowSchema, arrowArray, isViewer, wrapInBufferView);
   }
 
-  // String data types (VARCHAR and VARBINARY).
+  // String data types (VARCHAR and VARBINARY). Large strings and binaries
+  // have 64 bit offsets.
   if (type->isVarchar() || type->isVarbinary()) {
     VELOX_USER_CHECK_EQ(
         arrowArray.n_buffers,
         3,
         "Expecting three buffers as input for string types.");
+    const bool isLarge =
+        arrowSchema.format[0] == 'U' || arrowSchema.format[0] == 'Z';
+    if (isLarge) {
+      return createStringFlatVector(
+          pool,
+          type,
+          nulls,
+          arrowArray.length,
+          static_cast<const int64_t*>(arrowArray.buffers[1]) +
+              arrowArray.offset, // offsets
+          static_cast<const char*>(arrowArray.buffers[2]), // values
+          arrowArray.null_count,
+          wrapInBufferView);
+    }
     return createStringFlatVector(
         pool,
         type,
         nulls,
         arrowArray.length,
-        static_cast<const int32_t*>(arrowArray.buffers[1]), // offsets
+        static_cast<const int32_t*>(arrowArray.buffers[1]) +
+            arrowArray.offset, // offsets
         static_cast<const char*>(arrowArray.buffers[2]), // values
         arrowArray.null_count,
         wrapInBufferView);
@@ -1159,11 +1285,24 @@ VectorPtr importFromArrowImpl(
       "Conversion of '{}' from Arrow not supported yet.",
       type->toString());
 
-  // Wrap the values buffer into a Velox BufferView - zero-copy.
+  // Wrap the values buffer into a Velox BufferView - zero-copy. Booleans are
+  // copied if the array starts inside a byte.
   VELOX_USER_CHECK_EQ(
       arrowArray.n_buffers, 2, "Primitive types expect two buffers as input.");
-  auto values = wrapInBufferView(
-      arrowArray.buffers[1], arrowArray.length * type->cppSizeInBytes());
+  BufferPtr values;
+  if (type->kind() == TypeKind::BOOLEAN) {
+    values = wrapBits(
+        arrowArray.buffers[1],
+        arrowArray.offset,
+        arrowArray.length,
+        pool,
+        wrapInBufferView);
+  } else {
+    values = wrapInBufferView(
+        static_cast<const uint8_t*>(arrowArray.buffers[1]) +
+            arrowArray.offset * type->cppSizeInBytes(),
+        arrowArray.length * type->cppSizeInBytes());
+  }
 
   return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
       createFlatVector,
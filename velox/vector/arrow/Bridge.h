@@ -27,6 +27,14 @@ struct ArrowSchema;
 
 namespace facebook::velox {
 
+struct ArrowOptions {
+  /// Dictionary vectors are exported as Arrow dictionary arrays and constant
+  /// vectors as dictionary arrays with a single entry. If true, both are
+  /// exported as flat arrays instead, for consumers that do not handle
+  /// dictionary arrays. The schema must be exported with the same options.
+  bool flattenDictionary{false};
+};
+
 /// Export a generic Velox Vector to an ArrowArray, as defined by Arrow's C data
 /// interface:
 ///
@@ -42,7 +50,8 @@ namespace facebook::velox {
 ///
 /// The function takes a memory pool where allocations will be made (in cases
 /// where the conversion is not zero-copy, e.g. for strings) and throws in case
-/// the conversion is not implemented yet.
+/// the conversion is not implemented yet. Dictionary and constant encodings are
+/// preserved unless 'options' asks for flattening.
 ///
 /// Example usage:
 ///
@@ -58,7 +67,8 @@ void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const ArrowOptions& options = {});
 
 /// Export the type of a Velox vector to an ArrowSchema.
 ///
@@ -79,7 +89,10 @@ void exportToArrow(
 ///
 /// NOTE: Since Arrow couples type and encoding, we need both Velox type and
 /// actual data (containing encoding) to create an ArrowSchema.
-void exportToArrow(const VectorPtr&, ArrowSchema&);
+void exportToArrow(
+    const VectorPtr&,
+    ArrowSchema&,
+    const ArrowOptions& options = {});
 
 /// Import an ArrowSchema into a Velox Type object.
 ///
@@ -108,7 +121,10 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema);
 /// carry a pointer to it, but not really used in most cases - unless the
 /// conversion itself requires a new allocation. In most cases no new
 /// allocations are required, unless for arrays of varchars (or varbinaries) and
-/// complex types written out of order.
+/// complex types written out of order. The bytes of varchars and varbinaries
+/// are never copied, only StringViews pointing to them are allocated. Arrays
+/// with an offset, e.g. slices, are imported without copying, except for nulls
+/// and booleans that do not start at a byte boundary.
 ///
 /// The new Velox vector returned contains only references to the underlying
 /// buffers, so it's the client's responsibility to ensure the buffer's
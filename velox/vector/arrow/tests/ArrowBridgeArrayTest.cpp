@@ -413,11 +413,12 @@ TEST_F(ArrowBridgeArrayExportTest, rowVectorEmpty) {
 
 std::shared_ptr<arrow::Array> toArrow(
     const VectorPtr& vec,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const ArrowOptions& options = {}) {
   ArrowSchema schema;
   ArrowArray array;
-  exportToArrow(vec, schema);
-  exportToArrow(vec, array, pool);
+  exportToArrow(vec, schema, options);
+  exportToArrow(vec, array, pool, options);
   EXPECT_OK_AND_ASSIGN(auto type, arrow::ImportType(&schema));
   EXPECT_OK_AND_ASSIGN(auto ans, arrow::ImportArray(&array, type));
   return ans;
@@ -641,6 +642,76 @@ TEST_F(ArrowBridgeArrayExportTest, dictionaryNested) {
   EXPECT_EQ(values.Value(2), 3);
 }
 
+TEST_F(ArrowBridgeArrayExportTest, constant) {
+  auto vec = BaseVector::createConstant(variant(int64_t(10)), 5, pool_.get());
+  auto array = toArrow(vec, pool_.get());
+  ASSERT_OK(array->ValidateFull());
+  ASSERT_EQ(*array->type(), *arrow::dictionary(arrow::int32(), arrow::int64()));
+  EXPECT_EQ(array->null_count(), 0);
+  auto& dict = static_cast<const arrow::DictionaryArray&>(*array);
+  auto& indices = static_cast<const arrow::Int32Array&>(*dict.indices());
+  ASSERT_EQ(indices.length(), 5);
+  for (auto i = 0; i < indices.length(); ++i) {
+    EXPECT_EQ(indices.Value(i), 0);
+  }
+  auto& values = static_cast<const arrow::Int64Array&>(*dict.dictionary());
+  ASSERT_EQ(values.length(), 1);
+  EXPECT_EQ(values.Value(0), 10);
+
+  // Null constant.
+  vec = BaseVector::createNullConstant(BIGINT(), 3, pool_.get());
+  array = toArrow(vec, pool_.get());
+  ASSERT_OK(array->ValidateFull());
+  ASSERT_EQ(array->length(), 3);
+  EXPECT_EQ(array->null_count(), 3);
+
+  // Constant wrapping a complex value.
+  auto elements = vectorMaker_.arrayVector<int32_t>({{1, 2}, {3, 4, 5}});
+  vec = BaseVector::wrapInConstant(4, 1, elements);
+  array = toArrow(vec, pool_.get());
+  ASSERT_OK(array->ValidateFull());
+  ASSERT_EQ(
+      *array->type(),
+      *arrow::dictionary(arrow::int32(), arrow::list(arrow::int32())));
+  auto& arrayDict = static_cast<const arrow::DictionaryArray&>(*array);
+  ASSERT_EQ(arrayDict.length(), 4);
+  auto& list = static_cast<const arrow::ListArray&>(*arrayDict.dictionary());
+  validateOffsets(list, {0, 3});
+}
+
+TEST_F(ArrowBridgeArrayExportTest, flattenDictionary) {
+  ArrowOptions options;
+  options.flattenDictionary = true;
+  auto vec = BaseVector::wrapInDictionary(
+      nullptr,
+      makeBuffer<vector_size_t>({2, 0, 2}),
+      3,
+      vectorMaker_.flatVector<int64_t>({1, 2, 3}));
+  auto array = toArrow(vec, pool_.get(), options);
+  ASSERT_OK(array->ValidateFull());
+  ASSERT_EQ(*array->type(), *arrow::int64());
+  auto& flat = static_cast<const arrow::Int64Array&>(*array);
+  ASSERT_EQ(flat.length(), 3);
+  EXPECT_EQ(flat.Value(0), 3);
+  EXPECT_EQ(flat.Value(1), 1);
+  EXPECT_EQ(flat.Value(2), 3);
+
+  // Constant and dictionary children of a row are flattened as well.
+  auto row = vectorMaker_.rowVector(
+      {BaseVector::createConstant(variant(int64_t(7)), 3, pool_.get()), vec});
+  array = toArrow(row, pool_.get(), options);
+  ASSERT_OK(array->ValidateFull());
+  ASSERT_EQ(
+      *array->type(),
+      *arrow::struct_(
+          {arrow::field("c0", arrow::int64()),
+           arrow::field("c1", arrow::int64())}));
+  auto& child = static_cast<const arrow::Int64Array&>(
+      *static_cast<const arrow::StructArray&>(*array).field(0));
+  ASSERT_EQ(child.length(), 3);
+  EXPECT_EQ(child.Value(2), 7);
+}
+
 TEST_F(ArrowBridgeArrayExportTest, unsupported) {
   ArrowArray arrowArray;
   VectorPtr vector;
@@ -652,10 +723,6 @@ TEST_F(ArrowBridgeArrayExportTest, unsupported) {
   // Dates.
   vector = vectorMaker_.flatVectorNullable<Date>({});
   EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
-
-  // Constant encoding.
-  vector = BaseVector::createConstant(variant(10), 10, pool_.get());
-  EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
 }
 
 class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
@@ -1066,6 +1133,83 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
     });
   }
 
+  // Arrays with an offset are imported without copying the values.
+  void testImportSlices() {
+    arrow::Int64Builder ib;
+    arrow::BooleanBuilder bb;
+    arrow::StringBuilder sb;
+    for (int i = 0; i < 20; ++i) {
+      if (i % 5 == 0) {
+        ASSERT_OK(ib.AppendNull());
+        ASSERT_OK(bb.AppendNull());
+        ASSERT_OK(sb.AppendNull());
+      } else {
+        ASSERT_OK(ib.Append(i));
+        ASSERT_OK(bb.Append(i % 3 == 0));
+        ASSERT_OK(sb.Append(std::string(i, 'a' + i)));
+      }
+    }
+    ASSERT_OK_AND_ASSIGN(auto ints, ib.Finish());
+    ASSERT_OK_AND_ASSIGN(auto bools, bb.Finish());
+    ASSERT_OK_AND_ASSIGN(auto strings, sb.Finish());
+    auto checkSize = [](vector_size_t size) {
+      return [size](const BaseVector& vec) { EXPECT_EQ(vec.size(), size); };
+    };
+
+    // Offsets inside and at the start of a byte of the nulls.
+    testArrowRoundTrip(*ints->Slice(3, 10), checkSize(10));
+    testArrowRoundTrip(*ints->Slice(8, 5), checkSize(5));
+    testArrowRoundTrip(*bools->Slice(3, 10), checkSize(10));
+    testArrowRoundTrip(*strings->Slice(3, 10), checkSize(10));
+
+    // The offset of a struct applies to its children.
+    ASSERT_OK_AND_ASSIGN(
+        auto structs,
+        arrow::StructArray::Make({ints, strings}, {"ints", "strings"}));
+    testArrowRoundTrip(*structs->Slice(2, 15), checkSize(15));
+
+    auto vb = std::make_shared<arrow::Int32Builder>();
+    arrow::ListBuilder lb(arrow::default_memory_pool(), vb);
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_OK(lb.Append());
+      for (int j = 0; j < i; ++j) {
+        ASSERT_OK(vb->Append(j));
+      }
+    }
+    ASSERT_OK_AND_ASSIGN(auto lists, lb.Finish());
+    testArrowRoundTrip(*lists->Slice(4, 5), checkSize(5));
+
+    arrow::Dictionary32Builder<arrow::Int64Type> db;
+    for (int i = 0; i < 60; ++i) {
+      ASSERT_OK(db.Append(i % 11));
+    }
+    ASSERT_OK_AND_ASSIGN(auto dictionary, db.Finish());
+    testArrowRoundTrip(*dictionary->Slice(7, 30), checkSize(30));
+  }
+
+  // Large strings have 64 bit offsets.
+  void testImportLargeString() {
+    arrow::LargeStringBuilder builder;
+    ASSERT_OK(builder.Append("short"));
+    ASSERT_OK(builder.AppendNull());
+    ASSERT_OK(builder.Append("a string that is not inlined"));
+    ASSERT_OK(builder.Append("end"));
+    ASSERT_OK_AND_ASSIGN(auto array, builder.Finish());
+
+    ArrowSchema schema;
+    ArrowArray data;
+    ASSERT_OK(arrow::ExportType(*array->type(), &schema));
+    ASSERT_OK(arrow::ExportArray(*array->Slice(1, 3), &data));
+    auto vec = importFromArrow(schema, data, pool_.get());
+    ASSERT_EQ(*vec->type(), *VARCHAR());
+    assertVectorContent<std::string>(
+        {std::nullopt, "a string that is not inlined", "end"}, vec, 1);
+    if (isViewer()) {
+      schema.release(&schema);
+      data.release(&data);
+    }
+  }
+
   void testImportFailures() {
     ArrowSchema arrowSchema;
     ArrowArray arrowArray;
@@ -1073,17 +1217,15 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
     const int32_t values[] = {1, 2, 3, 4};
     const void* buffers[] = {nullptr, values};
 
-    // Unsupported:
+    // Broken input.
 
-    // Offset not yet supported.
+    // Negative offset.
     arrowSchema = makeArrowSchema("i");
     arrowArray = makeArrowArray(buffers, 2, 4, 0);
-    arrowArray.offset = 1;
+    arrowArray.offset = -1;
     EXPECT_THROW(
         importFromArrow(arrowSchema, arrowArray, pool_.get()), VeloxUserError);
 
-    // Broken input.
-
     // Null release callback indicates a released structure and should be
     // error-ed out
     arrowSchema = makeArrowSchema("i");
@@ -1169,6 +1311,14 @@ TEST_F(ArrowBridgeArrayImportAsViewerTest, dictionary) {
   testImportDictionary();
 }
 
+TEST_F(ArrowBridgeArrayImportAsViewerTest, slices) {
+  testImportSlices();
+}
+
+TEST_F(ArrowBridgeArrayImportAsViewerTest, largeString) {
+  testImportLargeString();
+}
+
 TEST_F(ArrowBridgeArrayImportAsViewerTest, failures) {
   testImportFailures();
 }
@@ -1216,6 +1366,14 @@ TEST_F(ArrowBridgeArrayImportAsOwnerTest, dictionary) {
   testImportDictionary();
 }
 
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, slices) {
+  testImportSlices();
+}
+
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, largeString) {
+  testImportLargeString();
+}
+
 TEST_F(ArrowBridgeArrayImportAsOwnerTest, failures) {
   testImportFailures();
 }
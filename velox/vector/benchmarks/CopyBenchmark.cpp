@@ -347,6 +347,36 @@ BENCHMARK_MULTI(copyStructNonContiguous) {
   return kIter * kSize;
 }
 
+BENCHMARK_MULTI(copyArrayRows) {
+  folly::BenchmarkSuspender suspender;
+  std::shared_ptr<memory::MemoryPool> pool{memory::getDefaultMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  // Copies runs of 16 rows out of every 32, as when assembling the output of
+  // a merge from interleaved sources.
+  const vector_size_t size = 10'000;
+  auto arrayVector = vectorMaker.arrayVector<int32_t>(
+      size,
+      [](auto row) { return row % 10; },
+      [](auto row) { return row % 23; });
+  SelectivityVector rows(size, false);
+  for (auto i = 0; i < size; i += 32) {
+    rows.setValidRange(i, std::min(i + 16, size), true);
+  }
+  rows.updateBounds();
+  VectorPtr result;
+  BaseVector::ensureWritable(
+      SelectivityVector(size), ARRAY(INTEGER()), pool.get(), result);
+  suspender.dismiss();
+
+  constexpr int kIter = 100;
+  for (auto i = 0; i < kIter; ++i) {
+    BaseVector::prepareForReuse(result, size);
+    result->copy(arrayVector.get(), rows, nullptr);
+  }
+  return kIter * rows.countSelected();
+}
+
 } // namespace
 } // namespace facebook::velox
 
@@ -1095,3 +1095,27 @@ TEST_F(DecodedVectorTest, dictionaryWrapping) {
 }
 
 } // namespace facebook::velox::test
+
+TEST_F(DecodedVectorTest, sequence) {
+  // Runs of 3, 0, 1 and 4 rows, empty runs included.
+  auto lengths = makeIndices({3, 0, 1, 4});
+  auto values = makeFlatVector<int32_t>({10, 20, 30, 40});
+  auto sequence = BaseVector::wrapInSequence(lengths, 8, values);
+  const std::vector<int32_t> expected = {10, 10, 10, 30, 40, 40, 40, 40};
+
+  SelectivityVector all(8);
+  SelectivityVector tail(8);
+  tail.setValidRange(0, 2, false);
+  tail.updateBounds();
+  SelectivityVector sparse(8, false);
+  sparse.setValid(1, true);
+  sparse.setValid(6, true);
+  sparse.updateBounds();
+  for (const auto* rows : {&all, &tail, &sparse}) {
+    DecodedVector decoded(*sequence, *rows);
+    EXPECT_EQ(decoded.base(), values.get());
+    rows->applyToSelected([&](auto row) {
+      EXPECT_EQ(decoded.valueAt<int32_t>(row), expected[row]) << row;
+    });
+  }
+}
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include "velox/vector/StringOffsetsLoader.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
 using namespace facebook::velox;
@@ -243,3 +244,50 @@ TEST_F(LazyVectorTest, lazyInDictionaryNoRowsToLoad) {
   auto expected = makeFlatVector<int32_t>(0);
   assertEqualVectors(expected, wrapped);
 }
+
+TEST_F(LazyVectorTest, stringOffsets) {
+  std::vector<std::optional<std::string>> strings = {
+      "short", std::nullopt, "", "a string longer than inline", "tail"};
+  std::string data;
+  auto offsets =
+      AlignedBuffer::allocate<int32_t>(strings.size() + 1, pool_.get());
+  auto rawOffsets = offsets->asMutable<int32_t>();
+  auto nulls = allocateNulls(strings.size(), pool_.get());
+  for (auto i = 0; i < strings.size(); ++i) {
+    rawOffsets[i] = data.size();
+    if (strings[i].has_value()) {
+      data += strings[i].value();
+    } else {
+      bits::setNull(nulls->asMutable<uint64_t>(), i);
+    }
+  }
+  rawOffsets[strings.size()] = data.size();
+  auto dataBuffer = AlignedBuffer::allocate<char>(data.size(), pool_.get());
+  memcpy(dataBuffer->asMutable<char>(), data.data(), data.size());
+
+  auto expected = makeNullableFlatVector<std::string>(strings);
+  auto lazy = StringOffsetsLoader::makeLazy(
+      pool_.get(), VARCHAR(), strings.size(), nulls, offsets, dataBuffer);
+  assertEqualVectors(expected, lazy);
+  // The bytes are referenced, not copied.
+  auto flat = lazy->loadedVector()->asFlatVector<StringView>();
+  EXPECT_EQ(flat->valueAt(3).data(), dataBuffer->as<char>() + 5);
+
+  // Only the selected rows are loaded.
+  VectorPtr partial = StringOffsetsLoader::makeLazy(
+      pool_.get(), VARCHAR(), strings.size(), nulls, offsets, dataBuffer);
+  SelectivityVector rows(strings.size(), false);
+  rows.setValid(3, true);
+  rows.updateBounds();
+  LazyVector::ensureLoadedRows(partial, rows);
+  EXPECT_EQ(
+      partial->loadedVector()->asFlatVector<StringView>()->valueAt(3),
+      StringView("a string longer than inline"));
+
+  // Offsets past the data are an error.
+  rawOffsets[strings.size()] = data.size() + 1;
+  VELOX_ASSERT_THROW(
+      StringOffsetsLoader::makeLazy(
+          pool_.get(), VARCHAR(), strings.size(), nulls, offsets, dataBuffer),
+      "(36 vs. 37)");
+}
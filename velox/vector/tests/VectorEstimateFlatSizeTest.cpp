@@ -529,3 +529,38 @@ TEST_F(VectorEstimateFlatSizeTest, structs) {
   EXPECT_EQ(2837, row->estimateFlatSize());
   EXPECT_EQ(3295, flatten(row)->estimateFlatSize());
 }
+
+TEST_F(VectorEstimateFlatSizeTest, uniqueRetainedSize) {
+  auto ints = makeFlatVector<int64_t>(1'000, int64At);
+  auto strings = makeFlatVector<std::string>(
+      1'000, [&](auto row) { return longStrings_[row % 3]; });
+  EXPECT_EQ(ints->retainedSize(), ints->uniqueRetainedSize());
+  EXPECT_EQ(strings->retainedSize(), strings->uniqueRetainedSize());
+
+  // Two columns over the same dictionary and base are counted once.
+  auto indices = makeIndices(100, [](auto row) { return row * 2; });
+  auto dict = wrapInDictionary(indices, 100, ints);
+  auto row = makeRowVector({dict, dict});
+  EXPECT_EQ(2 * dict->retainedSize(), row->retainedSize());
+  EXPECT_EQ(dict->retainedSize(), row->uniqueRetainedSize());
+
+  // Different dictionaries over the same base count the base once.
+  auto otherIndices = makeIndices(100, [](auto row) { return row; });
+  row = makeRowVector(
+      {wrapInDictionary(indices, 100, strings),
+       wrapInDictionary(otherIndices, 100, strings)});
+  EXPECT_EQ(
+      strings->retainedSize() + indices->capacity() + otherIndices->capacity(),
+      row->uniqueRetainedSize());
+
+  // A flat vector sharing the string buffers of another one.
+  auto sharing = std::make_shared<FlatVector<StringView>>(
+      pool(),
+      VARCHAR(),
+      nullptr,
+      strings->size(),
+      strings->values(),
+      std::vector<BufferPtr>(strings->stringBuffers()));
+  row = makeRowVector({strings, sharing});
+  EXPECT_EQ(strings->retainedSize(), row->uniqueRetainedSize());
+}
@@ -1391,6 +1391,38 @@ TEST_F(VectorTest, copyNoRows) {
   }
 }
 
+TEST_F(VectorTest, copyRowsOfArrays) {
+  // Arrays and maps copy the selected rows as ranges of consecutive rows.
+  auto maker = std::make_unique<test::VectorMaker>(pool_.get());
+  auto source = maker->arrayVector<int32_t>(
+      100,
+      [](auto row) { return row % 5; },
+      [](auto row) { return row; },
+      test::VectorMaker::nullEvery(7));
+  auto map = maker->mapVector<int32_t, int64_t>(
+      100,
+      [](auto row) { return row % 3; },
+      [](auto row) { return row; },
+      [](auto row) { return row * 2; },
+      test::VectorMaker::nullEvery(11));
+  SelectivityVector rows(50);
+  rows.setValidRange(10, 20, false);
+  rows.updateBounds();
+  // Runs of consecutive source rows with gaps and a reversed tail.
+  std::vector<vector_size_t> toSourceRow(50);
+  for (auto i = 0; i < 50; ++i) {
+    toSourceRow[i] = i < 40 ? i + i / 8 : 99 - i;
+  }
+  for (const auto& vector : std::vector<VectorPtr>{source, map}) {
+    auto target = BaseVector::create(vector->type(), 50, pool_.get());
+    target->copy(vector.get(), rows, toSourceRow.data());
+    rows.applyToSelected([&](auto row) {
+      EXPECT_TRUE(target->equalValueAt(vector.get(), row, toSourceRow[row]))
+          << row;
+    });
+  }
+}
+
 TEST_F(VectorTest, copyAscii) {
   auto maker = std::make_unique<test::VectorMaker>(pool_.get());
   std::vector<std::string> stringData = {"a", "b", "c"};